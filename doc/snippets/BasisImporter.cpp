@@ -63,13 +63,13 @@ Containers::Pointer<Trade::AbstractImporter> importer =
     manager.instantiate("BasisImporter");
 importer->openFile("mytexture.basis");
 
-/* Transcode the image to BC5 */
-importer->configuration().setValue("format", "Bc5");
+/* Transcode the image to BC7 */
+importer->configuration().setValue("format", "Bc7RGBA");
 image = importer->image2D(0);
 // ...
 
-/* Transcode the same image, but to ETC2 now */
-importer->configuration().setValue("format", "Etc2");
+/* Transcode the same image, but to ASTC now. The file isn't parsed again. */
+importer->configuration().setValue("format", "Astc4x4RGBA");
 image = importer->image2D(0);
 // ...
 /* [target-format-config] */
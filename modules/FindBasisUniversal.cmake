@@ -22,7 +22,8 @@
 # You can supply their location via an ``BASIS_UNIVERSAL_DIR`` variable. Once
 # found, the ``BasisUniversal::Encoder`` target is set up to compile the
 # sources of the encoder and ``BasisUniversal::Transcoder`` the sources of the
-# transcoder as static libraries.
+# transcoder as static libraries. On x86 the encoder is compiled with its SSE
+# 4.1 kernels enabled, which are used only if the CPU supports them.
 #
 
 #
@@ -185,6 +186,23 @@ foreach(_component ${BasisUniversal_FIND_COMPONENTS})
                     _basis_setup_source_file(${_file})
                 endforeach()
 
+                # Enable the SSE 4.1 encoder kernels on x86. The encoder
+                # checks for SSE 4.1 support in basisu_encoder_init() and uses
+                # the scalar code if the CPU doesn't have it, so only the file
+                # with the kernels is compiled with the instruction set
+                # enabled. MSVC doesn't need any flag for that.
+                if(CMAKE_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64|amd64|i[3-6]86|x86)$" AND NOT CORRADE_TARGET_EMSCRIPTEN)
+                    set(_BASIS_SUPPORT_SSE 1)
+                    if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU" OR (CMAKE_CXX_COMPILER_ID MATCHES "(Apple)?Clang" AND NOT CMAKE_CXX_SIMULATE_ID STREQUAL "MSVC"))
+                        # COMPILE_OPTIONS is supported on source files only
+                        # since CMake 3.11
+                        set_property(SOURCE ${BasisUniversalEncoder_DIR}/basisu_kernels_sse.cpp APPEND_STRING PROPERTY COMPILE_FLAGS
+                            " -msse4.1")
+                    endif()
+                else()
+                    set(_BASIS_SUPPORT_SSE 0)
+                endif()
+
                 # Disable the find root path here, it overrides the
                 # CMAKE_FIND_ROOT_PATH_MODE_INCLUDE setting potentially set in
                 # toolchains.
@@ -215,7 +233,7 @@ foreach(_component ${BasisUniversal_FIND_COMPONENTS})
                 set_property(TARGET BasisUniversal::Encoder APPEND PROPERTY
                     INTERFACE_LINK_LIBRARIES BasisUniversal::Transcoder)
                 set_property(TARGET BasisUniversal::Encoder APPEND PROPERTY
-                    INTERFACE_COMPILE_DEFINITIONS "BASISU_NO_ITERATOR_DEBUG_LEVEL")
+                    INTERFACE_COMPILE_DEFINITIONS "BASISU_NO_ITERATOR_DEBUG_LEVEL" "BASISU_SUPPORT_SSE=${_BASIS_SUPPORT_SSE}")
             endif()
         else()
             set(BasisUniversal_Encoder_FOUND TRUE)
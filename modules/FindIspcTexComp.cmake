@@ -0,0 +1,59 @@
+#.rst:
+# Find IspcTexComp
+# ----------------
+#
+# Finds the ISPC Texture Compressor library. This module defines:
+#
+#  IspcTexComp_FOUND        - True if ISPC Texture Compressor library is found
+#  IspcTexComp::IspcTexComp - ISPC Texture Compressor imported target
+#
+# Additionally these variables are defined for internal usage:
+#
+#  IspcTexComp_LIBRARY      - ISPC Texture Compressor library
+#  IspcTexComp_INCLUDE_DIR  - Include dir
+#
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+# The upstream repository doesn't have any install step, the library is named
+# ispc_texcomp on all platforms
+find_library(IspcTexComp_LIBRARY NAMES ispc_texcomp)
+find_path(IspcTexComp_INCLUDE_DIR NAMES ispc_texcomp.h)
+
+if(IspcTexComp_LIBRARY AND IspcTexComp_INCLUDE_DIR AND NOT TARGET IspcTexComp::IspcTexComp)
+    add_library(IspcTexComp::IspcTexComp UNKNOWN IMPORTED)
+    set_property(TARGET IspcTexComp::IspcTexComp PROPERTY
+        IMPORTED_LOCATION ${IspcTexComp_LIBRARY})
+    set_property(TARGET IspcTexComp::IspcTexComp PROPERTY
+        INTERFACE_INCLUDE_DIRECTORIES ${IspcTexComp_INCLUDE_DIR})
+endif()
+
+mark_as_advanced(IspcTexComp_LIBRARY IspcTexComp_INCLUDE_DIR)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(IspcTexComp DEFAULT_MSG
+    IspcTexComp_LIBRARY
+    IspcTexComp_INCLUDE_DIR)
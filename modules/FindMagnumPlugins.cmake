@@ -30,16 +30,21 @@
 #  GltfSceneConverter           - glTF converter
 #  HarfBuzzFont                 - HarfBuzz font
 #  IcoImporter                  - ICO importer
+#  IspcTexCompImageConverter    - BC6H/BC7 image compressor using ISPC Texture
+#                                 Compressor
 #  JpegImageConverter           - JPEG image converter
 #  JpegImporter                 - JPEG importer
 #  KtxImageConverter            - KTX image converter
 #  KtxImporter                  - KTX importer
+#  MeshOptimizerImporter        - MeshOptimizer importer
 #  MeshOptimizerSceneConverter  - MeshOptimizer scene converter
 #  MiniExrImageConverter        - OpenEXR image converter using miniexr
 #  OpenGexImporter              - OpenGEX importer
 #  PngImageConverter            - PNG image converter
 #  PngImporter                  - PNG importer
 #  PrimitiveImporter            - Primitive importer
+#  ScenePackImporter            - Scene pack importer
+#  ScenePackSceneConverter      - Scene pack converter
 #  SpirvToolsShaderConverter    - SPIR-V Tools shader converter
 #  SpngImporter                 - PNG importer using libspng
 #  StanfordImporter             - Stanford PLY importer
@@ -52,6 +57,7 @@
 #  StbVorbisAudioImporter       - OGG audio importer using stb_vorbis
 #  StlImporter                  - STL importer
 #  UfbxImporter                 - FBX and OBJ importer using ufbx
+#  WebPImageConverter           - WebP image converter
 #  WebPImporter                 - WebP importer
 #
 # If Magnum is built with MAGNUM_BUILD_DEPRECATED enabled, these additional
@@ -128,7 +134,7 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
     endif()
 
     if(_component STREQUAL AssimpImporter)
-        list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES AnyImageImporter)
+        list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES AnyImageImporter MeshTools)
     elseif(_component STREQUAL CgltfImporter)
         # TODO remove when the deprecated plugin is gone
         list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES AnyImageImporter)
@@ -139,7 +145,7 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
     elseif(_component STREQUAL OpenGexImporter)
         list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES AnyImageImporter)
     elseif(_component STREQUAL PrimitiveImporter)
-        list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES Primitives)
+        list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES MeshTools Primitives)
     elseif(_component STREQUAL StanfordImporter)
         list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES MeshTools)
     elseif(_component STREQUAL StanfordSceneConverter)
@@ -168,14 +174,16 @@ set(_MAGNUMPLUGINS_PLUGIN_COMPONENTS
     BcDecImageConverter DdsImporter DevIlImageImporter DrFlacAudioImporter
     DrMp3AudioImporter DrWavAudioImporter EtcDecImageConverter
     Faad2AudioImporter FreeTypeFont GlslangShaderConverter GltfImporter
-    GltfSceneConverter HarfBuzzFont IcoImporter JpegImageConverter JpegImporter
-    KtxImageConverter KtxImporter MeshOptimizerSceneConverter
-    MiniExrImageConverter OpenExrImageConverter OpenExrImporter
-    OpenGexImporter PngImageConverter PngImporter PrimitiveImporter
+    GltfSceneConverter HarfBuzzFont IcoImporter IspcTexCompImageConverter
+    JpegImageConverter JpegImporter KtxImageConverter KtxImporter
+    MeshOptimizerImporter MeshOptimizerSceneConverter MiniExrImageConverter
+    OpenExrImageConverter OpenExrImporter OpenGexImporter PngImageConverter
+    PngImporter PrimitiveImporter ScenePackImporter ScenePackSceneConverter
     SpirvToolsShaderConverter SpngImporter StanfordImporter
     StanfordSceneConverter StbDxtImageConverter StbImageConverter
     StbImageImporter StbResizeImageConverter StbTrueTypeFont
-    StbVorbisAudioImporter StlImporter UfbxImporter WebPImporter)
+    StbVorbisAudioImporter StlImporter UfbxImporter WebPImageConverter
+    WebPImporter)
 # Nothing is enabled by default right now
 set(_MAGNUMPLUGINS_IMPLICITLY_ENABLED_COMPONENTS )
 
@@ -406,7 +414,15 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
             set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
                 INTERFACE_LINK_LIBRARIES Glslang::Glslang)
 
-        # GltfImporter has no dependencies
+        # GltfImporter optionally depends on Draco. Include it if present,
+        # otherwise assume it's compiled without.
+        elseif(_component STREQUAL GltfImporter)
+            find_package(draco CONFIG QUIET)
+            if(draco_FOUND)
+                set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                    INTERFACE_LINK_LIBRARIES draco::draco)
+            endif()
+
         # GltfSceneConverter has no dependencies
 
         # HarfBuzzFont plugin dependencies
@@ -428,6 +444,12 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
 
         # IcoImporter has no dependencies
 
+        # IspcTexCompImageConverter plugin dependencies
+        elseif(_component STREQUAL IspcTexCompImageConverter)
+            find_package(IspcTexComp REQUIRED)
+            set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                INTERFACE_LINK_LIBRARIES IspcTexComp::IspcTexComp)
+
         # JpegImporter / JpegImageConverter plugin dependencies
         elseif(_component STREQUAL JpegImageConverter OR _component STREQUAL JpegImporter)
             find_package(JPEG)
@@ -442,11 +464,32 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
                     INTERFACE_LINK_LIBRARIES ${JPEG_LIBRARIES})
             endif()
 
-        # KtxImageConverter has no dependencies
-        # KtxImporter has no dependencies
+        # KtxImageConverter optionally depends on Zstd. Include it if
+        # present, otherwise assume it's compiled without.
+        elseif(_component STREQUAL KtxImageConverter)
+            find_package(Zstd)
+            if(Zstd_FOUND)
+                set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                    INTERFACE_LINK_LIBRARIES Zstd::Zstd)
+            endif()
+
+        # KtxImporter optionally depends on Zstd and ZLIB. Include them if
+        # present, otherwise assume it's compiled without.
+        elseif(_component STREQUAL KtxImporter)
+            find_package(Zstd)
+            if(Zstd_FOUND)
+                set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                    INTERFACE_LINK_LIBRARIES Zstd::Zstd)
+            endif()
+            find_package(ZLIB)
+            if(ZLIB_FOUND)
+                set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                    INTERFACE_LINK_LIBRARIES ZLIB::ZLIB)
+            endif()
 
-        # MeshOptimizerSceneConverter plugin dependencies
-        elseif(_component STREQUAL MeshOptimizerSceneConverter)
+        # MeshOptimizerImporter and MeshOptimizerSceneConverter plugin
+        # dependencies
+        elseif(_component STREQUAL MeshOptimizerImporter OR _component STREQUAL MeshOptimizerSceneConverter)
             if(NOT TARGET meshoptimizer)
                 find_package(meshoptimizer REQUIRED CONFIG)
                 set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
@@ -498,6 +541,8 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
             endif()
 
         # PrimitiveImporter has no dependencies
+        # ScenePackImporter has no dependencies
+        # ScenePackSceneConverter has no dependencies
 
         # SpirvToolsShaderConverter plugin dependencies
         elseif(_component STREQUAL SpirvToolsShaderConverter)
@@ -545,12 +590,18 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
         # UfbxImporter has no dependencies
         # TinyGltfImporter has no dependencies
 
-        # WebPImporter plugin dependencies
-        elseif(_component STREQUAL WebPImporter)
+        # WebPImageConverter plugin dependencies
+        elseif(_component STREQUAL WebPImageConverter)
             find_package(WebP REQUIRED)
             set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
                 INTERFACE_LINK_LIBRARIES WebP::WebP)
 
+        # WebPImporter plugin dependencies
+        elseif(_component STREQUAL WebPImporter)
+            find_package(WebP REQUIRED Demux)
+            set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                INTERFACE_LINK_LIBRARIES WebP::WebP WebP::Demux)
+
         endif()
 
         # Find plugin/library includes
@@ -574,6 +625,15 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
             if(NOT _magnumPlugins${_component}_BUILD_STATIC EQUAL -1)
                 set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
                     INTERFACE_SOURCES ${_MAGNUMPLUGINS_${_COMPONENT}_INCLUDE_DIR}/importStaticPlugin.cpp)
+
+                # A static plugin built with MAGNUM_WITH_TRACY_ZONES references
+                # Tracy symbols, so the final executable has to link to it
+                string(FIND "${_magnumPlugins${_component}Configure}" "#define MAGNUM_${_COMPONENT}_WITH_TRACY_ZONES" _magnumPlugins${_component}_WITH_TRACY_ZONES)
+                if(NOT _magnumPlugins${_component}_WITH_TRACY_ZONES EQUAL -1)
+                    find_package(Tracy CONFIG REQUIRED)
+                    set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                        INTERFACE_LINK_LIBRARIES Tracy::TracyClient)
+                endif()
             endif()
         endif()
 
@@ -6,10 +6,13 @@
 #
 #  WebP_FOUND           - True if WebP library is found
 #  WebP::WebP           - WebP imported target
+#  WebP::Demux          - WebP demux library imported target, defined if the
+#   Demux component is requested and found
 #
 # Additionally these variables are defined for internal usage:
 #
 #  WebP_LIBRARY         - WebP library
+#  WebP_DEMUX_LIBRARY   - WebP demux library
 #  WebP_INCLUDE_DIR     - Include dir
 #
 
@@ -44,18 +47,27 @@ find_library(WebP_LIBRARY NAMES webp
     # shouldn't, sigh: https://developers.google.com/speed/webp/download
     libwebp)
 
+# Demux library, needed for animated files
+if(Demux IN_LIST WebP_FIND_COMPONENTS)
+    find_library(WebP_DEMUX_LIBRARY NAMES webpdemux libwebpdemux)
+    if(WebP_DEMUX_LIBRARY)
+        set(WebP_Demux_FOUND TRUE)
+    endif()
+endif()
+
 # Include dir
 find_path(WebP_INCLUDE_DIR
     NAMES webp/decode.h)
 
 include(FindPackageHandleStandardArgs)
-find_package_handle_standard_args(WebP DEFAULT_MSG
-    WebP_LIBRARY
-    WebP_INCLUDE_DIR)
+find_package_handle_standard_args(WebP
+    REQUIRED_VARS WebP_LIBRARY WebP_INCLUDE_DIR
+    HANDLE_COMPONENTS)
 
 mark_as_advanced(FORCE
     WebP_INCLUDE_DIR
-    WebP_LIBRARY)
+    WebP_LIBRARY
+    WebP_DEMUX_LIBRARY)
 
 if(NOT TARGET WebP::WebP)
     add_library(WebP::WebP UNKNOWN IMPORTED)
@@ -63,3 +75,10 @@ if(NOT TARGET WebP::WebP)
         IMPORTED_LOCATION ${WebP_LIBRARY}
         INTERFACE_INCLUDE_DIRECTORIES ${WebP_INCLUDE_DIR})
 endif()
+
+if(WebP_Demux_FOUND AND NOT TARGET WebP::Demux)
+    add_library(WebP::Demux UNKNOWN IMPORTED)
+    set_target_properties(WebP::Demux PROPERTIES
+        IMPORTED_LOCATION ${WebP_DEMUX_LIBRARY}
+        INTERFACE_LINK_LIBRARIES WebP::WebP)
+endif()
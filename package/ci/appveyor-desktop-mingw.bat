@@ -118,10 +118,12 @@ cmake .. ^
     -DMAGNUM_WITH_GLTFSCENECONVERTER=ON ^
     -DMAGNUM_WITH_HARFBUZZFONT=OFF ^
     -DMAGNUM_WITH_ICOIMPORTER=ON ^
+    -DMAGNUM_WITH_ISPCTEXCOMPIMAGECONVERTER=OFF ^
     -DMAGNUM_WITH_JPEGIMAGECONVERTER=ON ^
     -DMAGNUM_WITH_JPEGIMPORTER=ON ^
     -DMAGNUM_WITH_KTXIMAGECONVERTER=ON ^
     -DMAGNUM_WITH_KTXIMPORTER=ON ^
+    -DMAGNUM_WITH_MESHOPTIMIZERIMPORTER=ON ^
     -DMAGNUM_WITH_MESHOPTIMIZERSCENECONVERTER=ON ^
     -DMAGNUM_WITH_MINIEXRIMAGECONVERTER=ON ^
     -DMAGNUM_WITH_OPENEXRIMAGECONVERTER=ON ^
@@ -130,6 +132,8 @@ cmake .. ^
     -DMAGNUM_WITH_PNGIMAGECONVERTER=OFF ^
     -DMAGNUM_WITH_PNGIMPORTER=OFF ^
     -DMAGNUM_WITH_PRIMITIVEIMPORTER=ON ^
+    -DMAGNUM_WITH_SCENEPACKIMPORTER=ON ^
+    -DMAGNUM_WITH_SCENEPACKSCENECONVERTER=ON ^
     -DMAGNUM_WITH_SPIRVTOOLSSHADERCONVERTER=OFF ^
     -DMAGNUM_WITH_SPNGIMPORTER=ON ^
     -DMAGNUM_WITH_STANFORDIMPORTER=ON ^
@@ -143,6 +147,7 @@ cmake .. ^
     -DMAGNUM_WITH_STLIMPORTER=ON ^
     -DMAGNUM_WITH_TINYGLTFIMPORTER=ON ^
     -DMAGNUM_WITH_UFBXIMPORTER=ON ^
+    -DMAGNUM_WITH_WEBPIMAGECONVERTER=OFF ^
     -DMAGNUM_WITH_WEBPIMPORTER=OFF ^
     -DMAGNUM_BUILD_TESTS=ON ^
     -DMAGNUM_BUILD_GL_TESTS=ON ^
@@ -88,10 +88,12 @@ cmake .. ^
     -DMAGNUM_WITH_GLTFSCENECONVERTER=ON ^
     -DMAGNUM_WITH_HARFBUZZFONT=OFF ^
     -DMAGNUM_WITH_ICOIMPORTER=ON ^
+    -DMAGNUM_WITH_ISPCTEXCOMPIMAGECONVERTER=OFF ^
     -DMAGNUM_WITH_JPEGIMAGECONVERTER=%EXCEPT_MSVC2015% ^
     -DMAGNUM_WITH_JPEGIMPORTER=%EXCEPT_MSVC2015% ^
     -DMAGNUM_WITH_KTXIMAGECONVERTER=ON ^
     -DMAGNUM_WITH_KTXIMPORTER=ON ^
+    -DMAGNUM_WITH_MESHOPTIMIZERIMPORTER=%EXCEPT_MSVC2017% ^
     -DMAGNUM_WITH_MESHOPTIMIZERSCENECONVERTER=%EXCEPT_MSVC2017% ^
     -DMAGNUM_WITH_MINIEXRIMAGECONVERTER=ON ^
     -DMAGNUM_WITH_OPENEXRIMAGECONVERTER=%EXCEPT_MSVC2015% ^
@@ -100,6 +102,8 @@ cmake .. ^
     -DMAGNUM_WITH_PNGIMAGECONVERTER=%EXCEPT_MSVC2015% ^
     -DMAGNUM_WITH_PNGIMPORTER=%EXCEPT_MSVC2015% ^
     -DMAGNUM_WITH_PRIMITIVEIMPORTER=ON ^
+    -DMAGNUM_WITH_SCENEPACKIMPORTER=ON ^
+    -DMAGNUM_WITH_SCENEPACKSCENECONVERTER=ON ^
     -DMAGNUM_WITH_SPIRVTOOLSSHADERCONVERTER=%EXCEPT_MSVC2015% ^
     -DMAGNUM_WITH_SPNGIMPORTER=%EXCEPT_MSVC2015% ^
     -DMAGNUM_WITH_STANFORDIMPORTER=ON ^
@@ -113,6 +117,7 @@ cmake .. ^
     -DMAGNUM_WITH_STLIMPORTER=ON ^
     -DMAGNUM_WITH_TINYGLTFIMPORTER=ON ^
     -DMAGNUM_WITH_UFBXIMPORTER=ON ^
+    -DMAGNUM_WITH_WEBPIMAGECONVERTER=ON ^
     -DMAGNUM_WITH_WEBPIMPORTER=ON ^
     -DMAGNUM_BUILD_TESTS=ON ^
     -DMAGNUM_BUILD_GL_TESTS=ON ^
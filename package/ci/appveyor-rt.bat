@@ -85,10 +85,12 @@ cmake .. ^
     -DMAGNUM_WITH_GLTFSCENECONVERTER=ON ^
     -DMAGNUM_WITH_HARFBUZZFONT=OFF ^
     -DMAGNUM_WITH_ICOIMPORTER=ON ^
+    -DMAGNUM_WITH_ISPCTEXCOMPIMAGECONVERTER=OFF ^
     -DMAGNUM_WITH_JPEGIMAGECONVERTER=OFF ^
     -DMAGNUM_WITH_JPEGIMPORTER=OFF ^
     -DMAGNUM_WITH_KTXIMAGECONVERTER=ON ^
     -DMAGNUM_WITH_KTXIMPORTER=ON ^
+    -DMAGNUM_WITH_MESHOPTIMIZERIMPORTER=OFF ^
     -DMAGNUM_WITH_MESHOPTIMIZERSCENECONVERTER=OFF ^
     -DMAGNUM_WITH_MINIEXRIMAGECONVERTER=ON ^
     -DMAGNUM_WITH_OPENEXRIMAGECONVERTER=OFF ^
@@ -97,6 +99,8 @@ cmake .. ^
     -DMAGNUM_WITH_PNGIMAGECONVERTER=OFF ^
     -DMAGNUM_WITH_PNGIMPORTER=OFF ^
     -DMAGNUM_WITH_PRIMITIVEIMPORTER=ON ^
+    -DMAGNUM_WITH_SCENEPACKIMPORTER=ON ^
+    -DMAGNUM_WITH_SCENEPACKSCENECONVERTER=ON ^
     -DMAGNUM_WITH_SPIRVTOOLSSHADERCONVERTER=OFF ^
     -DMAGNUM_WITH_SPNGIMPORTER=OFF ^
     -DMAGNUM_WITH_STANFORDIMPORTER=ON ^
@@ -110,6 +114,7 @@ cmake .. ^
     -DMAGNUM_WITH_STLIMPORTER=ON ^
     -DMAGNUM_WITH_TINYGLTFIMPORTER=ON ^
     -DMAGNUM_WITH_UFBXIMPORTER=ON ^
+    -DMAGNUM_WITH_WEBPIMAGECONVERTER=OFF ^
     -DMAGNUM_WITH_WEBPIMPORTER=OFF ^
     -DMAGNUM_BUILD_STATIC=ON ^
     -G "%GENERATOR%" -A x64 || exit /b
@@ -153,10 +153,12 @@ cmake .. \
     -DMAGNUM_WITH_GLTFSCENECONVERTER=ON \
     -DMAGNUM_WITH_HARFBUZZFONT=OFF \
     -DMAGNUM_WITH_ICOIMPORTER=ON \
+    -DMAGNUM_WITH_ISPCTEXCOMPIMAGECONVERTER=OFF \
     -DMAGNUM_WITH_JPEGIMAGECONVERTER=OFF \
     -DMAGNUM_WITH_JPEGIMPORTER=OFF \
     -DMAGNUM_WITH_KTXIMAGECONVERTER=ON \
     -DMAGNUM_WITH_KTXIMPORTER=ON \
+    -DMAGNUM_WITH_MESHOPTIMIZERIMPORTER=OFF \
     -DMAGNUM_WITH_MESHOPTIMIZERSCENECONVERTER=OFF \
     -DMAGNUM_WITH_MINIEXRIMAGECONVERTER=ON \
     -DMAGNUM_WITH_OPENEXRIMAGECONVERTER=ON \
@@ -165,6 +167,8 @@ cmake .. \
     -DMAGNUM_WITH_PNGIMAGECONVERTER=OFF \
     -DMAGNUM_WITH_PNGIMPORTER=OFF \
     -DMAGNUM_WITH_PRIMITIVEIMPORTER=ON \
+    -DMAGNUM_WITH_SCENEPACKIMPORTER=ON \
+    -DMAGNUM_WITH_SCENEPACKSCENECONVERTER=ON \
     -DMAGNUM_WITH_SPIRVTOOLSSHADERCONVERTER=OFF \
     -DMAGNUM_WITH_SPNGIMPORTER=OFF \
     -DMAGNUM_WITH_STANFORDIMPORTER=ON \
@@ -178,6 +182,7 @@ cmake .. \
     -DMAGNUM_WITH_STLIMPORTER=ON \
     -DMAGNUM_WITH_TINYGLTFIMPORTER=ON \
     -DMAGNUM_WITH_UFBXIMPORTER=ON \
+    -DMAGNUM_WITH_WEBPIMAGECONVERTER=OFF \
     -DMAGNUM_WITH_WEBPIMPORTER=OFF \
     -DMAGNUM_BUILD_TESTS=ON \
     -DMAGNUM_BUILD_GL_TESTS=ON \
@@ -74,10 +74,12 @@ cmake .. \
     -DMAGNUM_WITH_GLTFSCENECONVERTER=ON \
     -DMAGNUM_WITH_HARFBUZZFONT=ON \
     -DMAGNUM_WITH_ICOIMPORTER=ON \
+    -DMAGNUM_WITH_ISPCTEXCOMPIMAGECONVERTER=OFF \
     -DMAGNUM_WITH_JPEGIMAGECONVERTER=ON \
     -DMAGNUM_WITH_JPEGIMPORTER=ON \
     -DMAGNUM_WITH_KTXIMAGECONVERTER=ON \
     -DMAGNUM_WITH_KTXIMPORTER=ON \
+    -DMAGNUM_WITH_MESHOPTIMIZERIMPORTER=ON \
     -DMAGNUM_WITH_MESHOPTIMIZERSCENECONVERTER=ON \
     -DMAGNUM_WITH_MINIEXRIMAGECONVERTER=ON \
     -DMAGNUM_WITH_OPENEXRIMAGECONVERTER=ON \
@@ -86,6 +88,8 @@ cmake .. \
     -DMAGNUM_WITH_PNGIMAGECONVERTER=ON \
     -DMAGNUM_WITH_PNGIMPORTER=ON \
     -DMAGNUM_WITH_PRIMITIVEIMPORTER=ON \
+    -DMAGNUM_WITH_SCENEPACKIMPORTER=ON \
+    -DMAGNUM_WITH_SCENEPACKSCENECONVERTER=ON \
     -DMAGNUM_WITH_SPIRVTOOLSSHADERCONVERTER=ON \
     -DMAGNUM_WITH_SPNGIMPORTER=ON \
     -DMAGNUM_WITH_STANFORDIMPORTER=ON \
@@ -99,6 +103,7 @@ cmake .. \
     -DMAGNUM_WITH_STLIMPORTER=ON \
     -DMAGNUM_WITH_TINYGLTFIMPORTER=$BUILD_DEPRECATED \
     -DMAGNUM_WITH_UFBXIMPORTER=ON \
+    -DMAGNUM_WITH_WEBPIMAGECONVERTER=ON \
     -DMAGNUM_WITH_WEBPIMPORTER=ON \
     -DMAGNUM_BUILD_TESTS=ON \
     -DMAGNUM_BUILD_GL_TESTS=ON \
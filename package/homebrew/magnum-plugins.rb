@@ -93,6 +93,7 @@ class MagnumPlugins < Formula
         "-D#{option_prefix}WITH_JPEGIMPORTER=#{(build.with? 'jpeg') ? 'ON' : 'OFF'}",
         "-DMAGNUM_WITH_KTXIMAGECONVERTER=ON",
         "-DMAGNUM_WITH_KTXIMAGEIMPORTER=ON",
+        "-DMAGNUM_WITH_MESHOPTIMIZERIMPORTER=ON",
         "-DMAGNUM_WITH_MESHOPTIMIZERSCENECONVERTER=ON",
         "-DMAGNUM_WITH_MINIEXRIMAGECONVERTER=ON",
         "-DMAGNUM_WITH_OPENEXRIMAGECONVERTER=#{(build.with? 'openexr') ? 'ON' : 'OFF'}",
@@ -101,6 +102,8 @@ class MagnumPlugins < Formula
         "-D#{option_prefix}WITH_PNGIMAGECONVERTER=#{(build.with? 'libpng') ? 'ON' : 'OFF'}",
         "-D#{option_prefix}WITH_PNGIMPORTER=#{(build.with? 'libpng') ? 'ON' : 'OFF'}",
         "-D#{option_prefix}WITH_PRIMITIVEIMPORTER=ON",
+        "-D#{option_prefix}WITH_SCENEPACKIMPORTER=ON",
+        "-D#{option_prefix}WITH_SCENEPACKSCENECONVERTER=ON",
         "-DMAGNUM_WITH_SPIRVTOOLSSHADERCONVERTER=#{(build.with? 'spirv-tools') ? 'ON' : 'OFF'}",
         "-DMAGNUM_WITH_SPNGIMPORTER=#{(build.with? 'libspng') ? 'ON' : 'OFF'}",
         "-D#{option_prefix}WITH_STANFORDIMPORTER=ON",
@@ -114,6 +117,7 @@ class MagnumPlugins < Formula
         "-D#{option_prefix}WITH_STLIMPORTER=ON",
         "-D#{option_prefix}WITH_TINYGLTFIMPORTER=ON",
         "-DMAGNUM_WITH_UFBXIMPORTER=ON",
+        "-DMAGNUM_WITH_WEBPIMAGECONVERTER=#{(build.with? 'webp') ? 'ON' : 'OFF'}",
         "-DMAGNUM_WITH_WEBPIMPORTER=#{(build.with? 'webp') ? 'ON' : 'OFF'}",
         ".."
       system "cmake", "--build", "."
@@ -0,0 +1,143 @@
+#ifndef Magnum_Implementation_asyncImageImport_h
+#define Magnum_Implementation_asyncImageImport_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <condition_variable>
+#include <mutex>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/Move.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+/* Asynchronous image2D() shared by image importers that expose an
+   image2DAsync() API. The decode runs on whatever thread the user-provided
+   executor runs the job on, calling the importer's regular image2D() there.
+   All asynchronous imports on one importer instance are serialized with an
+   internal mutex so the plugin state needs no further synchronization, and
+   only one import per image and level can be in flight at a time. The
+   importer is expected to call wait() in its doClose() and destructor, as
+   the jobs reference it. */
+
+namespace Magnum { namespace Implementation { namespace {
+
+class AsyncImageImport {
+    public:
+        typedef void(*Executor)(void(*)(void*), void*, void*);
+        typedef void(*Callback)(UnsignedInt, UnsignedInt, Containers::Optional<Trade::ImageData2D>&&, void*);
+
+        ~AsyncImageImport() { wait(); }
+
+        /* Validates the ID and level on the calling thread, marks the image
+           as in flight and passes the job to the executor. The counts are
+           queried without locking, which relies on them being immutable for
+           as long as the file is opened. */
+        bool schedule(const char* const messagePrefix, Trade::AbstractImporter& importer, const UnsignedInt id, const UnsignedInt level, const Executor executor, const Callback callback, void* const userData) {
+            if(!importer.isOpened()) {
+                Error{} << messagePrefix << "no file opened";
+                return false;
+            }
+            if(id >= importer.image2DCount()) {
+                Error{} << messagePrefix << "index" << id << "out of range for" << importer.image2DCount() << "entries";
+                return false;
+            }
+            if(level >= importer.image2DLevelCount(id)) {
+                Error{} << messagePrefix << "level" << level << "out of range for" << importer.image2DLevelCount(id) << "entries";
+                return false;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                for(const Containers::Pair<UnsignedInt, UnsignedInt>& i: _inFlight) {
+                    if(i.first() == id && i.second() == level) {
+                        Error{} << messagePrefix << "image" << id << "level" << level << "is already being imported";
+                        return false;
+                    }
+                }
+                arrayAppend(_inFlight, InPlaceInit, id, level);
+            }
+
+            executor(run, new Job{*this, importer, id, level, callback, userData}, userData);
+            return true;
+        }
+
+        /* Blocks until all scheduled imports finish */
+        void wait() {
+            std::unique_lock<std::mutex> lock{_mutex};
+            _condition.wait(lock, [this]{ return _inFlight.isEmpty(); });
+        }
+
+    private:
+        struct Job {
+            AsyncImageImport& async;
+            Trade::AbstractImporter& importer;
+            UnsignedInt id, level;
+            Callback callback;
+            void* userData;
+        };
+
+        static void run(void* const data) {
+            Containers::Pointer<Job> job{static_cast<Job*>(data)};
+
+            Containers::Optional<Trade::ImageData2D> image;
+            {
+                std::lock_guard<std::mutex> lock{job->async._importMutex};
+                image = job->importer.image2D(job->id, job->level);
+            }
+
+            /* Mark the image as done before calling the callback, so the
+               callback can schedule it again or close the importer */
+            job->async.finish(job->id, job->level);
+            job->callback(job->id, job->level, Utility::move(image), job->userData);
+        }
+
+        /* The notification has to happen with the mutex still locked. Once
+           it's released, wait() may return and the owner destroy this
+           instance together with the condition variable. For the same
+           reason run() doesn't touch job->async after calling this. */
+        void finish(const UnsignedInt id, const UnsignedInt level) {
+            std::lock_guard<std::mutex> lock{_mutex};
+            for(std::size_t i = 0; i != _inFlight.size(); ++i) {
+                if(_inFlight[i].first() == id && _inFlight[i].second() == level) {
+                    arrayRemoveUnordered(_inFlight, i);
+                    break;
+                }
+            }
+            _condition.notify_all();
+        }
+
+        std::mutex _mutex, _importMutex;
+        std::condition_variable _condition;
+        Containers::Array<Containers::Pair<UnsignedInt, UnsignedInt>> _inFlight;
+};
+
+}}}
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef Magnum_Implementation_glyphCacheFile_h
+#define Magnum_Implementation_glyphCacheFile_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Text/AbstractGlyphCache.h>
+
+/* Common code used by FreeTypeFont and StbTrueTypeFont (and thus HarfBuzzFont
+   as well) to save contents of a filled glyph cache to a file and load it
+   back without rasterizing anything. The file name is a hash of everything
+   that affects the output, calculated by the plugins themselves. The file is
+   only ever meant to be read back by the same build on the same machine, so
+   there's no endian conversion and any mismatch is treated as a cache miss.
+
+   The layout is a GlyphCacheFileHeader, followed by glyphCount
+   GlyphCacheFileGlyph entries and then single-channel pixels of the header
+   rectangle, bottom to top, with rows tightly packed. */
+namespace Magnum { namespace Implementation { namespace {
+
+struct GlyphCacheFileHeader {
+    char magic[4];
+    UnsignedInt version;
+    UnsignedInt glyphCount;
+    Range2Di rectangle;
+};
+
+struct GlyphCacheFileGlyph {
+    UnsignedInt id;
+    Vector2i offset;
+    Range2Di rectangle;
+};
+
+constexpr const char GlyphCacheFileMagic[4]{'M', 'g', 'G', 'c'};
+constexpr UnsignedInt GlyphCacheFileVersion = 1;
+
+/* Fills an empty cache with the file contents, returns false if the file
+   doesn't exist or doesn't match the cache */
+bool loadGlyphCacheFile(Text::AbstractGlyphCache& cache, const Containers::StringView filename) {
+    if(!Utility::Path::exists(filename))
+        return false;
+    const Containers::Optional<Containers::Array<char>> data = Utility::Path::read(filename);
+    if(!data || data->size() < sizeof(GlyphCacheFileHeader))
+        return false;
+
+    const auto& header = *reinterpret_cast<const GlyphCacheFileHeader*>(data->data());
+    if(std::memcmp(header.magic, GlyphCacheFileMagic, 4) != 0 ||
+       header.version != GlyphCacheFileVersion ||
+       header.rectangle.min().min() < 0 ||
+       (header.rectangle.max() > cache.textureSize()).any() ||
+       (header.rectangle.size() < Vector2i{}).any() ||
+       data->size() != sizeof(GlyphCacheFileHeader) + header.glyphCount*sizeof(GlyphCacheFileGlyph) + header.rectangle.size().product())
+        return false;
+
+    const auto glyphs = Containers::arrayCast<const GlyphCacheFileGlyph>(data->sliceSize(sizeof(GlyphCacheFileHeader), header.glyphCount*sizeof(GlyphCacheFileGlyph)));
+    for(const GlyphCacheFileGlyph& glyph: glyphs)
+        cache.insert(glyph.id, glyph.offset, glyph.rectangle);
+
+    cache.setImage(header.rectangle.min(), ImageView2D{
+        PixelStorage{}.setAlignment(1), PixelFormat::R8Unorm,
+        header.rectangle.size(),
+        data->exceptPrefix(sizeof(GlyphCacheFileHeader) + glyphs.size()*sizeof(GlyphCacheFileGlyph))});
+    return true;
+}
+
+/* Returns false if the directory can't be created or the file written */
+bool saveGlyphCacheFile(const Containers::StringView directory, const Containers::StringView filename, const Containers::ArrayView<const GlyphCacheFileGlyph> glyphs, const Range2Di& rectangle, const Containers::ArrayView<const char> pixels) {
+    CORRADE_INTERNAL_ASSERT(pixels.size() == std::size_t(rectangle.size().product()));
+
+    Containers::Array<char> data{NoInit, sizeof(GlyphCacheFileHeader) + glyphs.size()*sizeof(GlyphCacheFileGlyph) + pixels.size()};
+    GlyphCacheFileHeader header;
+    std::memcpy(header.magic, GlyphCacheFileMagic, 4);
+    header.version = GlyphCacheFileVersion;
+    header.glyphCount = glyphs.size();
+    header.rectangle = rectangle;
+    std::memcpy(data.data(), &header, sizeof(GlyphCacheFileHeader));
+    std::memcpy(data.data() + sizeof(GlyphCacheFileHeader), glyphs.data(), glyphs.size()*sizeof(GlyphCacheFileGlyph));
+    std::memcpy(data.data() + sizeof(GlyphCacheFileHeader) + glyphs.size()*sizeof(GlyphCacheFileGlyph), pixels.data(), pixels.size());
+
+    return Utility::Path::make(directory) && Utility::Path::write(filename, data);
+}
+
+}}}
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef Magnum_Implementation_imageImporterPool_h
+#define Magnum_Implementation_imageImporterPool_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <mutex>
+#include <utility> /* std::declval() */
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <MagnumPlugins/AnyImageImporter/AnyImageImporter.h>
+
+/* Opened image importers shared by all instances of a scene importer plugin
+   that use the same plugin manager, enabled with the imageImporterPoolSize
+   option. Opening the same image file from a different scene file, or again
+   after the scene file got closed and reopened, then doesn't need to open and
+   parse the image file again. Only images loaded from files are pooled, keyed
+   by the file path, importer flags and file callback, as neither can be
+   changed on an opened importer, and each pooled importer is given out
+   to just one user at a time, so the pool can be used from multiple threads.
+   The file contents are assumed to not change while an importer opened from
+   them is in the pool. */
+
+namespace Magnum { namespace Implementation { namespace {
+
+typedef decltype(std::declval<const Trade::AbstractImporter&>().fileCallback()) ImageImporterPoolFileCallback;
+
+class ImageImporterPool {
+    public:
+        /* Called from scene importer constructors, paired with removeUser()
+           in the destructor. Once there are no users of given manager left,
+           all its pooled importers are destroyed, as they may hold plugin
+           instances coming from it. A null manager is ignored. */
+        void addUser(const void* const manager) {
+            if(!manager) return;
+            std::lock_guard<std::mutex> lock{_mutex};
+            for(User& user: _users) if(user.manager == manager) {
+                ++user.count;
+                return;
+            }
+            arrayAppend(_users, InPlaceInit, manager, std::size_t{1});
+        }
+
+        void removeUser(const void* const manager) {
+            if(!manager) return;
+            std::lock_guard<std::mutex> lock{_mutex};
+            for(std::size_t i = 0; i != _users.size(); ++i) {
+                if(_users[i].manager != manager || --_users[i].count)
+                    continue;
+
+                _users[i] = _users.back();
+                arrayRemoveSuffix(_users, 1);
+                for(std::size_t j = 0; j != _entries.size(); ) {
+                    if(_entries[j].manager == manager)
+                        removeEntry(j);
+                    else ++j;
+                }
+                return;
+            }
+        }
+
+        /* Takes an opened importer out of the pool if there's one for given
+           manager, file path, flags and file callback, returns
+           Containers::NullOpt otherwise */
+        Containers::Optional<Trade::AnyImageImporter> acquire(const void* const manager, const Containers::StringView filename, const Trade::ImporterFlags flags, const ImageImporterPoolFileCallback fileCallback, const void* const fileCallbackUserData) {
+            std::lock_guard<std::mutex> lock{_mutex};
+            for(std::size_t i = 0; i != _entries.size(); ++i) {
+                Entry& entry = _entries[i];
+                if(entry.manager != manager || entry.flags != flags || entry.fileCallback != fileCallback || entry.fileCallbackUserData != fileCallbackUserData || entry.filename != filename)
+                    continue;
+
+                Containers::Optional<Trade::AnyImageImporter> out{InPlaceInit, Utility::move(*entry.importer)};
+                removeEntry(i);
+                return out;
+            }
+
+            return {};
+        }
+
+        /* Puts an opened importer to the pool. If there's more than
+           `capacity` importers for given manager afterwards, the least
+           recently released one is destroyed. */
+        void release(const void* const manager, const Containers::StringView filename, const Trade::ImporterFlags flags, const ImageImporterPoolFileCallback fileCallback, const void* const fileCallbackUserData, Trade::AnyImageImporter&& importer, const std::size_t capacity) {
+            if(!capacity) return;
+
+            std::lock_guard<std::mutex> lock{_mutex};
+            arrayAppend(_entries, InPlaceInit, manager, Containers::String{filename}, flags, fileCallback, fileCallbackUserData, ++_releaseCounter, Containers::Pointer<Trade::AnyImageImporter>{new Trade::AnyImageImporter{Utility::move(importer)}});
+
+            std::size_t count = 0;
+            std::size_t oldest = ~std::size_t{};
+            for(std::size_t i = 0; i != _entries.size(); ++i) {
+                if(_entries[i].manager != manager) continue;
+                ++count;
+                if(oldest == ~std::size_t{} || _entries[i].lastReleased < _entries[oldest].lastReleased)
+                    oldest = i;
+            }
+            if(count > capacity) removeEntry(oldest);
+        }
+
+    private:
+        struct User {
+            const void* manager;
+            std::size_t count;
+        };
+
+        struct Entry {
+            const void* manager;
+            Containers::String filename;
+            Trade::ImporterFlags flags;
+            ImageImporterPoolFileCallback fileCallback;
+            const void* fileCallbackUserData;
+            std::size_t lastReleased;
+            Containers::Pointer<Trade::AnyImageImporter> importer;
+        };
+
+        /* Order doesn't matter, so swap with the last and drop that */
+        void removeEntry(const std::size_t i) {
+            if(i != _entries.size() - 1)
+                _entries[i] = Utility::move(_entries.back());
+            arrayRemoveSuffix(_entries, 1);
+        }
+
+        std::mutex _mutex;
+        Containers::Array<User> _users;
+        Containers::Array<Entry> _entries;
+        std::size_t _releaseCounter = 0;
+};
+
+/* As this is in an anonymous namespace, each plugin gets its own pool */
+ImageImporterPool& imageImporterPool() {
+    static ImageImporterPool pool;
+    return pool;
+}
+
+}}}
+
+#endif
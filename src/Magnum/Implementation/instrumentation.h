@@ -0,0 +1,136 @@
+#ifndef Magnum_Implementation_instrumentation_h
+#define Magnum_Implementation_instrumentation_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <ctime>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/Magnum.h>
+
+#if defined(CORRADE_TARGET_UNIX) && !defined(CORRADE_TARGET_EMSCRIPTEN)
+#include <time.h>
+#endif
+
+/* Opt-in instrumentation of the heavy importer and converter entry points,
+   enabled with the instrumentation option in the plugin configuration. Each
+   instrumented call then adds a [instrumentationRecords/call] group to the
+   plugin configuration with the function name, file name or ID if known,
+   wall and CPU time in seconds and, if the application provides the counters
+   below, count and size of allocations done during the call. When disabled,
+   the overhead is a single configuration value lookup per call.
+
+   The CPU time is measured only for the calling thread on Unix platforms, so
+   it isn't skewed by other imports running concurrently, but it also doesn't
+   include work the plugin offloads to worker threads. Elsewhere it falls back
+   to std::clock(), which measures the whole process.
+
+   The records are never removed by the plugin, each call adds a new group.
+   Long-running applications are expected to process them and then clear them
+   with configuration().removeGroup("instrumentationRecords").
+
+   Allocations can't be tracked from within a plugin, so the application is
+   expected to count them, for example in a replacement of the global
+   operator new, and expose the totals through an extern "C" function of the
+   following signature. It's referenced weakly, so if the application doesn't
+   define it, no allocation data are recorded. For dynamic plugins the
+   executable has to export the symbol (ENABLE_EXPORTS in CMake). Not
+   available with MSVC or on Emscripten. */
+#if defined(CORRADE_TARGET_GCC) && !defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_EMSCRIPTEN)
+#define MAGNUM_IMPLEMENTATION_INSTRUMENTATION_ALLOCATIONS
+extern "C" __attribute__((weak)) void magnumPluginsInstrumentationAllocations(std::size_t* count, std::size_t* bytes);
+#endif
+
+namespace Magnum { namespace Implementation { namespace {
+
+inline Double instrumentationCpuTime() {
+    #if defined(CORRADE_TARGET_UNIX) && !defined(CORRADE_TARGET_EMSCRIPTEN)
+    timespec time;
+    if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) == 0)
+        return Double(time.tv_sec) + Double(time.tv_nsec)*1.0e-9;
+    #endif
+    return Double(std::clock())/CLOCKS_PER_SEC;
+}
+
+class InstrumentationScope {
+    public:
+        explicit InstrumentationScope(Utility::ConfigurationGroup& configuration, const char* function, Containers::StringView filename = {}, UnsignedInt id = ~UnsignedInt{}): _configuration{configuration.value<bool>("instrumentation") ? &configuration : nullptr}, _function{function}, _filename{filename}, _id{id} {
+            if(!_configuration) return;
+
+            #ifdef MAGNUM_IMPLEMENTATION_INSTRUMENTATION_ALLOCATIONS
+            if(magnumPluginsInstrumentationAllocations)
+                magnumPluginsInstrumentationAllocations(&_allocationCount, &_allocatedBytes);
+            #endif
+            _cpuTime = instrumentationCpuTime();
+            _wallTime = std::chrono::steady_clock::now();
+        }
+
+        /* Non-copyable, non-movable */
+        InstrumentationScope(const InstrumentationScope&) = delete;
+        InstrumentationScope& operator=(const InstrumentationScope&) = delete;
+
+        ~InstrumentationScope() {
+            if(!_configuration) return;
+
+            const auto wallTime = std::chrono::steady_clock::now() - _wallTime;
+            const Double cpuTime = instrumentationCpuTime() - _cpuTime;
+
+            Utility::ConfigurationGroup* records = _configuration->group("instrumentationRecords");
+            if(!records) records = _configuration->addGroup("instrumentationRecords");
+            Utility::ConfigurationGroup& call = *records->addGroup("call");
+            call.setValue("function", Containers::StringView{_function});
+            if(!_filename.isEmpty())
+                call.setValue("filename", _filename);
+            if(_id != ~UnsignedInt{})
+                call.setValue("id", _id);
+            call.setValue("wallTime", std::chrono::duration<Double>(wallTime).count());
+            call.setValue("cpuTime", cpuTime);
+
+            #ifdef MAGNUM_IMPLEMENTATION_INSTRUMENTATION_ALLOCATIONS
+            if(magnumPluginsInstrumentationAllocations) {
+                std::size_t allocationCount, allocatedBytes;
+                magnumPluginsInstrumentationAllocations(&allocationCount, &allocatedBytes);
+                call.setValue<UnsignedLong>("allocationCount", allocationCount - _allocationCount);
+                call.setValue<UnsignedLong>("allocatedBytes", allocatedBytes - _allocatedBytes);
+            }
+            #endif
+        }
+
+    private:
+        Utility::ConfigurationGroup* _configuration;
+        const char* _function;
+        Containers::StringView _filename;
+        UnsignedInt _id;
+        std::chrono::steady_clock::time_point _wallTime;
+        Double _cpuTime;
+        #ifdef MAGNUM_IMPLEMENTATION_INSTRUMENTATION_ALLOCATIONS
+        std::size_t _allocationCount, _allocatedBytes;
+        #endif
+};
+
+}}}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef Magnum_Implementation_mapFile_h
+#define Magnum_Implementation_mapFile_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/Trade/Data.h>
+
+/* Memory-mapped openFile() shared by importers that can operate directly on
+   memory passed to doOpenData() with DataFlag::ExternallyOwned, enabled with
+   the mapFile option. Available only on platforms where
+   Utility::Path::mapRead() is. */
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+#define MAGNUM_IMPLEMENTATION_MAP_FILE
+
+namespace Magnum { namespace Implementation { namespace {
+
+typedef Containers::Array<const char, Utility::Path::MapDeleter> MappedFile;
+
+/* Maps the file and passes a non-owning view on it to openData(), which is
+   expected to forward to the importer's doOpenData(). The returned mapping
+   has to be kept alive for as long as the file stays opened. If the file
+   can't be mapped, prints a message and returns Containers::NullOpt without
+   calling openData(). */
+template<class F> Containers::Optional<MappedFile> openMappedFile(const char* const messagePrefix, const Containers::StringView filename, F&& openData) {
+    Containers::Optional<MappedFile> mapped = Utility::Path::mapRead(filename);
+    if(!mapped) {
+        Error{} << messagePrefix << "cannot open file" << filename;
+        return {};
+    }
+
+    openData(Containers::Array<char>{const_cast<char*>(mapped->data()), mapped->size(), [](char*, std::size_t){}}, Trade::DataFlag::ExternallyOwned);
+    return mapped;
+}
+
+}}}
+#endif
+
+#endif
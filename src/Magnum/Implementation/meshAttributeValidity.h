@@ -0,0 +1,69 @@
+#ifndef Magnum_Implementation_meshAttributeValidity_h
+#define Magnum_Implementation_meshAttributeValidity_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+#include <Magnum/VertexFormat.h>
+#include <Magnum/Trade/MeshData.h>
+
+/* Checks for mesh attribute names and vertex formats coming from a file,
+   which would otherwise be passed directly to vertexFormatSize() and
+   MeshAttributeData that assert on invalid values. */
+
+namespace Magnum { namespace Implementation { namespace {
+
+/** @todo This needs to be extended when new formats are added to
+    VertexFormat. Ideally Magnum itself should provide some kind of a "vertex
+    format count" constant. */
+constexpr VertexFormat LastVertexFormat = VertexFormat::Matrix4x4sNormalized;
+
+/* Implementation-specific formats are treated as valid, it's up to the caller
+   to decide whether to accept them */
+inline bool isVertexFormatValid(const UnsignedInt format) {
+    return format && (isVertexFormatImplementationSpecific(VertexFormat(format)) || format <= UnsignedInt(LastVertexFormat));
+}
+
+inline bool isMeshAttributeValid(const UnsignedInt name) {
+    if(!name || name > 0xffff) return false;
+
+    switch(Trade::MeshAttribute(name)) {
+        case Trade::MeshAttribute::Position:
+        case Trade::MeshAttribute::Tangent:
+        case Trade::MeshAttribute::Bitangent:
+        case Trade::MeshAttribute::Normal:
+        case Trade::MeshAttribute::TextureCoordinates:
+        case Trade::MeshAttribute::Color:
+        case Trade::MeshAttribute::JointIds:
+        case Trade::MeshAttribute::Weights:
+        case Trade::MeshAttribute::ObjectId:
+        case Trade::MeshAttribute::Custom:
+            return true;
+    }
+
+    return Trade::isMeshAttributeCustom(Trade::MeshAttribute(name));
+}
+
+}}}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef Magnum_Implementation_meshConverter_h
+#define Magnum_Implementation_meshConverter_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/Move.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
+#include <Magnum/Trade/MeshData.h>
+
+/* In-place conversion of imported meshes with a scene converter plugin named
+   in a meshConverter option, such as MeshOptimizerSceneConverter. It operates
+   directly on the freshly allocated importer output, so there's no extra
+   allocation and copy compared to running the converter on the returned
+   mesh. The converter plugin is taken from a scene converter manager
+   registered as an external manager to the importer plugin manager. */
+
+namespace Magnum { namespace Implementation { namespace {
+
+/* The converter instance is kept in the passed pointer and reused for
+   subsequent meshes, it's instantiated again only if the plugin name
+   changes. Importer flags are propagated to it, options for the converter
+   are meant to be set globally through the scene converter manager. The mesh
+   has to have mutable index and vertex data. Prints a message and returns
+   false if the plugin can't be loaded, doesn't support in-place mesh
+   conversion or the conversion fails. */
+inline bool convertMeshInPlace(const char* const messagePrefix, PluginManager::Manager<Trade::AbstractImporter>* const manager, const Trade::ImporterFlags flags, Containers::Pointer<Trade::AbstractSceneConverter>& converter, const Containers::StringView plugin, Trade::MeshData& mesh) {
+    if(!converter || converter->plugin() != plugin) {
+        converter = nullptr;
+
+        PluginManager::Manager<Trade::AbstractSceneConverter>* converterManager;
+        if(!manager || !(converterManager = manager->externalManager<Trade::AbstractSceneConverter>())) {
+            Error{} << messagePrefix << "the plugin must be instantiated with access to plugin manager that has a registered scene converter manager in order to use a mesh converter";
+            return false;
+        }
+
+        Containers::Pointer<Trade::AbstractSceneConverter> instance = converterManager->loadAndInstantiate(plugin);
+        if(!instance) {
+            Error{} << messagePrefix << "can't load" << plugin << "for mesh conversion";
+            return false;
+        }
+
+        if(!(instance->features() & Trade::SceneConverterFeature::ConvertMeshInPlace)) {
+            Error{} << messagePrefix << plugin << "doesn't support" << Trade::SceneConverterFeature::ConvertMeshInPlace;
+            return false;
+        }
+
+        /* Propagate flags that are common between importers and scene
+           converters */
+        if(flags & Trade::ImporterFlag::Verbose)
+            instance->addFlags(Trade::SceneConverterFlag::Verbose);
+        if(flags & Trade::ImporterFlag::Quiet)
+            instance->addFlags(Trade::SceneConverterFlag::Quiet);
+
+        converter = Utility::move(instance);
+    }
+
+    if(!converter->convertInPlace(mesh)) {
+        Error{} << messagePrefix << "in-place conversion with" << plugin << "failed";
+        return false;
+    }
+
+    return true;
+}
+
+}}}
+
+#endif
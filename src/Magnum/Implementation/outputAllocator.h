@@ -0,0 +1,62 @@
+#ifndef Magnum_Implementation_outputAllocator_h
+#define Magnum_Implementation_outputAllocator_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/Magnum.h>
+
+/* Allocation of imported image and mesh data with an application-provided
+   allocator, set through a plugin-specific setOutputAllocator(). Because
+   importers aren't allowed to return arrays with custom deleters, memory
+   coming from the allocator is returned as a non-owning view with
+   DataFlag::Mutable and its lifetime is fully up to the application. */
+
+namespace Magnum { namespace Implementation { namespace {
+
+typedef char*(*OutputAllocator)(std::size_t, void*);
+
+/* If allocator is null, returns a newly allocated uninitialized array.
+   Otherwise returns a non-owning view on memory returned by the allocator,
+   which the caller should pass to the output as DataFlag::Mutable instead of
+   transferring the ownership. If the allocator returns null, prints a message
+   and returns Containers::NullOpt. */
+inline Containers::Optional<Containers::Array<char>> allocateOutput(const char* const messagePrefix, const OutputAllocator allocator, void* const userData, const std::size_t size) {
+    if(!allocator)
+        return Containers::Array<char>{NoInit, size};
+
+    char* const data = allocator(size, userData);
+    if(!data) {
+        Error{} << messagePrefix << "output allocator failed to allocate" << size << "bytes";
+        return {};
+    }
+    return Containers::Array<char>{data, size, [](char*, std::size_t){}};
+}
+
+}}}
+
+#endif
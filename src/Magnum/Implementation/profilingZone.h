@@ -0,0 +1,45 @@
+#ifndef Magnum_Implementation_profilingZone_h
+#define Magnum_Implementation_profilingZone_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Profiler zones in the heavy code paths of selected plugins, so a hitch
+   inside e.g. AbstractImporter::image2D() shows a breakdown of what the
+   plugin was doing. Enabled with the MAGNUM_WITH_TRACY_ZONES CMake option,
+   which links the affected plugins to the Tracy client library. The
+   TRACY_ENABLE define comes from there as well, so if the option is off or
+   Tracy itself is built with zones disabled, the macro expands to nothing.
+
+   Each zone lasts until the end of the enclosing scope and there can be only
+   one per scope. Name has to be a string literal. */
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+
+#define MAGNUM_PROFILING_ZONE(name) ZoneScopedN(name)
+#else
+#define MAGNUM_PROFILING_ZONE(name) do {} while(false)
+#endif
+
+#endif
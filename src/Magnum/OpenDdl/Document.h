@@ -31,6 +31,7 @@
 
 #include <string>
 #include <vector>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
 
@@ -321,8 +322,127 @@ class MAGNUM_OPENDDL_EXPORT Document {
         /** @todo some sane way to ensure that the initializer lists are valid for whole Document lifetime */
         bool parse(Containers::ArrayView<const char> data, std::initializer_list<CharacterLiteral> structureIdentifiers, std::initializer_list<CharacterLiteral> propertyIdentifiers);
 
+        /**
+         * @brief Parse data on multiple threads
+         * @param data                      Document data
+         * @param structureIdentifiers      Structure identifiers
+         * @param propertyIdentifiers       Property identifiers
+         * @param threadCount               Thread count. If @cpp 0 @ce,
+         *      @ref std::thread::hardware_concurrency() is used.
+         * @return Whether the parsing succeeded
+         * @m_since_latest_{plugins}
+         *
+         * Like @ref parse(Containers::ArrayView<const char>, std::initializer_list<CharacterLiteral>, std::initializer_list<CharacterLiteral>),
+         * but if @p threadCount is larger than @cpp 1 @ce, the top-level
+         * structures are first located by quickly scanning the brace nesting,
+         * split into several consecutive groups of roughly the same size and
+         * each group is parsed on a separate thread. The results are then
+         * merged into the document, which is exactly the same as if it was
+         * parsed serially. If parsing of any group fails, the whole data are
+         * parsed again serially in order to produce the same diagnostic.
+         *
+         * This is worth doing only for large documents with many top-level
+         * structures, such as a mesh-heavy OpenGEX file. On Emscripten
+         * without pthreads enabled, the parsing is always serial. Note that
+         * in order to use multiple threads, the application has to link to
+         * a threading library, such as `Threads::Threads` in CMake.
+         */
+        bool parse(Containers::ArrayView<const char> data, std::initializer_list<CharacterLiteral> structureIdentifiers, std::initializer_list<CharacterLiteral> propertyIdentifiers, UnsignedInt threadCount);
+
+        /**
+         * @brief Set structures with lazily parsed data
+         * @m_since_latest_{plugins}
+         *
+         * Data lists of primitive structures that are direct children of
+         * custom structures with given identifiers are only skipped over in
+         * subsequent @ref parse() calls, remembering just where they start.
+         * Their type, name and sub-array size is available right after
+         * parsing, but @ref Structure::arraySize() is @cpp 0 @ce and
+         * @ref Structure::asArray() is empty until the data are parsed with
+         * @ref parseLazyData(). Primitive structures of @ref Type::Reference
+         * are always parsed immediately. Errors inside the skipped data lists
+         * are reported only by @ref parseLazyData(). The data passed to
+         * @ref parse() are expected to stay in scope until all lazy data are
+         * parsed.
+         *
+         * Note that @ref validate() isn't able to check the array size of
+         * structures with data that weren't parsed yet. By default no
+         * structures are parsed lazily.
+         */
+        void setLazyStructures(Containers::ArrayView<const Int> identifiers);
+
+        /** @overload */
+        void setLazyStructures(std::initializer_list<Int> identifiers);
+
+        /**
+         * @brief Parse lazy data of given structure and its children
+         * @return Whether the parsing succeeded
+         * @m_since_latest_{plugins}
+         *
+         * Parses all data lists skipped by @ref parse() in given structure
+         * and all its children. Data that were already parsed are not parsed
+         * again, if there's nothing to parse, returns @cpp true @ce. If the
+         * parsing results in error, detailed info is printed on error output.
+         *
+         * Parsing new data may cause views returned from
+         * @ref Structure::asArray() to get invalidated, similarly to
+         * @ref parse().
+         * @see @ref setLazyStructures()
+         */
+        bool parseLazyData(Structure structure);
+
+        /**
+         * @brief Parse all lazy data
+         * @m_since_latest_{plugins}
+         *
+         * Like @ref parseLazyData(Structure), but for the whole document.
+         */
+        bool parseLazyData();
+
+        /**
+         * @brief Serialize the parsed document into a binary blob
+         * @m_since_latest_{plugins}
+         *
+         * Saves all structures, properties, data arrays and resolved
+         * references together with names of the structure and property
+         * identifiers passed to the last @ref parse() call. The result can be
+         * loaded back with @ref deserialize() way faster than parsing the
+         * textual representation again. Expects that all lazy data were
+         * parsed, see @ref parseLazyData().
+         *
+         * The format is a direct copy of the internal representation and is
+         * thus specific to given platform --- the blob can be loaded back only
+         * by the same version of this library built for a platform with the
+         * same endianness and type sizes. It's meant to be used as a cache
+         * and not for data interchange.
+         */
+        Containers::Array<char> serialize() const;
+
+        /**
+         * @brief Deserialize a document from a binary blob
+         * @param data                      Data produced by @ref serialize()
+         * @param structureIdentifiers      Structure identifiers
+         * @param propertyIdentifiers       Property identifiers
+         * @return Whether the deserialization succeeded
+         * @m_since_latest_{plugins}
+         *
+         * Expects that the document is empty. The identifier lists are
+         * expected to be the same as the ones used when parsing the
+         * serialized document, if they differ or the data were produced by
+         * an incompatible platform or library version, prints a message to
+         * error output and returns @cpp false @ce. Apart from the header, the
+         * contents aren't validated in any way.
+         *
+         * If @p data are suitably aligned, the data arrays, structures and
+         * properties reference @p data directly instead of being copied, so
+         * @p data are expected to stay in scope for the whole document
+         * lifetime. This makes it possible to load a memory-mapped file
+         * without any upfront processing apart from creating the strings.
+         */
+        bool deserialize(Containers::ArrayView<const char> data, std::initializer_list<CharacterLiteral> structureIdentifiers, std::initializer_list<CharacterLiteral> propertyIdentifiers);
+
         /** @brief Whether the document is empty */
-        bool isEmpty() { return _structures.empty(); }
+        bool isEmpty() { return _structures.isEmpty(); }
 
         /**
          * @brief Find first top-level structure in the document
@@ -435,40 +555,53 @@ class MAGNUM_OPENDDL_EXPORT Document {
 
         MAGNUM_OPENDDL_LOCAL const char* parseProperty(Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, Int position, Implementation::ParseError& error);
         MAGNUM_OPENDDL_LOCAL std::pair<const char*, std::size_t> parseStructure(std::size_t parent, Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, Implementation::ParseError& error);
+        MAGNUM_OPENDDL_LOCAL const char* parseDataList(Type type, std::size_t subArraySize, Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, std::size_t& dataBegin, std::size_t& dataSize, Implementation::ParseError& error);
+        MAGNUM_OPENDDL_LOCAL bool parseLazyDataRange(std::size_t begin, std::size_t end);
+        MAGNUM_OPENDDL_LOCAL bool parseParallel(Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, UnsignedInt threadCount);
         MAGNUM_OPENDDL_LOCAL const char* parseStructureList(std::size_t parent, Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, Implementation::ParseError& error);
 
         MAGNUM_OPENDDL_LOCAL std::size_t dereference(std::size_t originatingStructure, Containers::ArrayView<const char> reference) const;
 
-        MAGNUM_OPENDDL_LOCAL bool validateLevel(const Containers::Optional<Structure>& first, Containers::ArrayView<const std::pair<Int, std::pair<Int, Int>>> allowedStructures, Containers::ArrayView<const Validation::Structure> structures, std::vector<Int>& counts) const;
-        MAGNUM_OPENDDL_LOCAL bool validateStructure(Structure structure, const Validation::Structure& validation, Containers::ArrayView<const Validation::Structure> structures, std::vector<Int>& counts) const;
+        MAGNUM_OPENDDL_LOCAL bool validateLevel(const Containers::Optional<Structure>& first, Containers::ArrayView<const std::pair<Int, std::pair<Int, Int>>> allowedStructures, Containers::ArrayView<Int> counts) const;
+        MAGNUM_OPENDDL_LOCAL bool validateStructure(Structure structure, const Validation::Structure& validation, Containers::ArrayView<Int> counts) const;
 
         MAGNUM_OPENDDL_LOCAL const char* structureName(Int identifier) const;
         MAGNUM_OPENDDL_LOCAL const char* propertyName(Int identifier) const;
 
-        template<class T> std::vector<T>& data();
-        template<class T> const std::vector<T>& data() const;
+        template<class T> Containers::Array<T>& data();
+        template<class T> const Containers::Array<T>& data() const;
         template<Type> std::size_t dataPosition() const;
 
-        std::vector<bool> _bools;
-        std::vector<Byte> _bytes;
-        std::vector<UnsignedByte> _unsignedBytes;
-        std::vector<Short> _shorts;
-        std::vector<UnsignedShort> _unsignedShorts;
-        std::vector<Int> _ints;
-        std::vector<UnsignedInt> _unsignedInts;
+        /* All growable arrays, with data lists reserved upfront based on a
+           pre-scan of each list in parseStructure() */
+        Containers::Array<bool> _bools;
+        Containers::Array<Byte> _bytes;
+        Containers::Array<UnsignedByte> _unsignedBytes;
+        Containers::Array<Short> _shorts;
+        Containers::Array<UnsignedShort> _unsignedShorts;
+        Containers::Array<Int> _ints;
+        Containers::Array<UnsignedInt> _unsignedInts;
         #ifndef CORRADE_TARGET_EMSCRIPTEN
-        std::vector<Long> _longs;
-        std::vector<UnsignedLong> _unsignedLongs;
+        Containers::Array<Long> _longs;
+        Containers::Array<UnsignedLong> _unsignedLongs;
         #endif
         /** @todo Half */
-        std::vector<Float> _floats;
-        std::vector<Double> _doubles;
-        std::vector<std::string> _strings;
-        std::vector<std::size_t> _references;
-        std::vector<Type> _types;
-
-        std::vector<PropertyData> _properties;
-        std::vector<StructureData> _structures;
+        Containers::Array<Float> _floats;
+        Containers::Array<Double> _doubles;
+        Containers::Array<std::string> _strings;
+        Containers::Array<std::size_t> _references;
+        Containers::Array<Type> _types;
+
+        Containers::Array<PropertyData> _properties;
+        Containers::Array<StructureData> _structures;
+
+        /* Identifiers of structures with lazily parsed primitive children,
+           data passed to the last parse() and structure index + start of the
+           data list for each lazy data list that wasn't parsed yet. Parsed
+           items have the pointer set to null. */
+        Containers::Array<Int> _lazyStructureIdentifiers;
+        Containers::ArrayView<const char> _lazySource;
+        Containers::Array<std::pair<std::size_t, const char*>> _lazyData;
 
         Containers::ArrayView<const CharacterLiteral> _structureIdentifiers;
         Containers::ArrayView<const CharacterLiteral> _propertyIdentifiers;
@@ -476,8 +609,8 @@ class MAGNUM_OPENDDL_EXPORT Document {
 
 #ifndef DOXYGEN_GENERATING_OUTPUT
 #define _c(T, member) \
-    template<> inline std::vector<T>& Document::data() { return member; } \
-    template<> inline const std::vector<T>& Document::data() const { return member; }
+    template<> inline Containers::Array<T>& Document::data() { return member; } \
+    template<> inline const Containers::Array<T>& Document::data() const { return member; }
 _c(bool, _bools)
 _c(UnsignedByte, _unsignedBytes)
 _c(Byte, _bytes)
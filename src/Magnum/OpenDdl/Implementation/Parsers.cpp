@@ -25,6 +25,7 @@
 
 #include "Parsers.h"
 
+#include <cstdlib>
 #include <cstring>
 #include <limits>
 #include <tuple>
@@ -117,9 +118,12 @@ template<std::size_t n> inline const char* prefix(const Containers::ArrayView<co
     return equalsPrefix(data.prefix(end), compare) ? end : nullptr;
 }
 
-void extractWithoutUnderscore(const Containers::ArrayView<const char> data, std::string& buffer) {
-    buffer.clear();
-    for(char c: data) if(c != '_') buffer += c;
+/* Value of a digit that was already verified with isBaseN() */
+template<Int base> inline UnsignedInt digitValue(char c) {
+    return UnsignedInt(c - '0');
+}
+template<> inline UnsignedInt digitValue<16>(char c) {
+    return c <= '9' ? UnsignedInt(c - '0') : UnsignedInt((c | 0x20) - 'a' + 10);
 }
 
 }
@@ -133,25 +137,54 @@ const char* whitespace(const Containers::ArrayView<const char> data) {
     if(!data) return nullptr;
 
     const char* i = data;
-    while(i != data.end()) {
+    const char* const end = data.end();
+    while(i != end) {
         /* Whitespace */
-        if(*i <= 32) ++i;
+        if(*i <= 32) {
+            ++i;
 
-        /* Comment */
-        else if(*i == '/' && i + 1 < data.end() && (i[1] == '*' || i[1] == '/'))
-        {
-            /* Single-line comment */
-            if(i[1] == '/') for(const char* j = i + 2; j != data.end(); ++j) {
-                if(*j == '\n') {
-                    i = j + 1;
+            /* Long whitespace runs such as indentation of deeply nested
+               structures are skipped eight bytes at a time. All bytes in the
+               word are between 0x00 and 0x20 only if none of them has the top
+               bit set and adding 0x5f to any of them doesn't set it either.
+               The addition can carry between bytes only if the top bit is
+               already set somewhere, in which case the check fails
+               regardless. */
+            while(end - i >= 8) {
+                UnsignedLong word;
+                std::memcpy(&word, i, 8);
+                if((word | (word + 0x5f5f5f5f5f5f5f5full)) & 0x8080808080808080ull)
                     break;
-                }
+                i += 8;
+            }
+        }
 
-            /* Multi-line comment */
-            } else for(const char* j = i + 2; j != data.end(); ++j) {
-                if(*j == '*' && j + 1 != data.end() && *(j + 1) == '/') {
-                    i = j + 2;
-                    break;
+        /* Comment */
+        else if(*i == '/' && i + 1 < end && (i[1] == '*' || i[1] == '/')) {
+            /* Single-line comment, delegating the search to memchr() which is
+               usually vectorized. An unterminated comment consumes the rest of
+               the input. */
+            if(i[1] == '/') {
+                const char* const newline = static_cast<const char*>(std::memchr(i + 2, '\n', end - i - 2));
+                i = newline ? newline + 1 : end;
+
+            /* Multi-line comment, again skipping to the next candidate * with
+               memchr() */
+            } else {
+                const char* j = i + 2;
+                for(;;) {
+                    j = static_cast<const char*>(std::memchr(j, '*', end - j));
+                    if(!j || j + 1 == end) {
+                        i = end;
+                        break;
+                    }
+
+                    if(j[1] == '/') {
+                        i = j + 2;
+                        break;
+                    }
+
+                    ++j;
                 }
             }
         }
@@ -293,57 +326,44 @@ template<> struct IntegralType<Double> {
 };
 template<class T> using IntegralTypeFor = typename IntegralType<T>::Type;
 
-template<class> struct ExtractToType;
+/* Widest type integral literals are accumulated in before checking the
+   range of the actual type */
 /** @todo isn't there something better for extracting to unsigned int on webgl? */
 #ifndef CORRADE_TARGET_EMSCRIPTEN
-template<> struct ExtractToType<UnsignedLong> {
-    typedef UnsignedLong Type;
-    static UnsignedLong extract(const std::string& buffer, Int base) {
-        return std::stoul(buffer, nullptr, base);
-    }
-};
-template<> struct ExtractToType<UnsignedByte>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<Byte>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<UnsignedShort>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<Short>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<UnsignedInt>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<Int>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<Long>: ExtractToType<UnsignedLong> {};
-#ifdef CORRADE_TARGET_APPLE
-template<> struct ExtractToType<unsigned long>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<long>: ExtractToType<UnsignedLong> {};
-#endif
+typedef UnsignedLong ExtractedType;
 #else
-template<> struct ExtractToType<UnsignedInt> {
-    typedef UnsignedInt Type;
-    static UnsignedInt extract(const std::string& buffer, Int base) {
-        return std::stoi(buffer, nullptr, base);
-    }
-};
-template<> struct ExtractToType<UnsignedByte>: ExtractToType<UnsignedInt> {};
-template<> struct ExtractToType<Byte>: ExtractToType<UnsignedInt> {};
-template<> struct ExtractToType<UnsignedShort>: ExtractToType<UnsignedInt> {};
-template<> struct ExtractToType<Short>: ExtractToType<UnsignedInt> {};
-template<> struct ExtractToType<Int>: ExtractToType<UnsignedInt> {};
-/* Emscripten 1.38.10 and newer has std::size_t defined as unsigned long, while
-   it was unsigned int before. We should support both cases,
-   integralLiteral<std::size_t>() is used in some places in the parsers. */
-static_assert(sizeof(unsigned long) == 4, "unsigned long is not four bytes on Emscripten");
-template<> struct ExtractToType<unsigned long>: ExtractToType<UnsignedInt> {};
+typedef UnsignedInt ExtractedType;
 #endif
-template<class T> using ExtractedType = typename ExtractToType<T>::Type;
 
-template<> struct ExtractToType<Float> {
-    static Float extract(const std::string& buffer) {
-        return std::stof(buffer);
+/* Floating-point literals that have at most MaxExactMantissa in the
+   significand and at most MaxExactExponent in the decimal exponent can be
+   calculated exactly with a single multiplication or division of two
+   exactly representable values, which is correctly rounded. For Float the
+   calculation is done in doubles and then rounded to a float, which is still
+   exact, as a double has more than twice the float precision. Everything
+   else goes through strtof() / strtod(). */
+template<class> struct FloatingPointTraits;
+template<> struct FloatingPointTraits<Float> {
+    enum: UnsignedLong { MaxExactMantissa = 1ull << 24 };
+    enum: Int { MaxExactExponent = 10 };
+    static Float extract(const char* string) {
+        return std::strtof(string, nullptr);
     }
 };
-template<> struct ExtractToType<Double> {
-    static Double extract(const std::string& buffer) {
-        return std::stod(buffer);
+template<> struct FloatingPointTraits<Double> {
+    enum: UnsignedLong { MaxExactMantissa = 1ull << 53 };
+    enum: Int { MaxExactExponent = 22 };
+    static Double extract(const char* string) {
+        return std::strtod(string, nullptr);
     }
 };
 
+constexpr Double PowersOfTen[]{
+    1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9,
+    1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18,
+    1.0e19, 1.0e20, 1.0e21, 1.0e22
+};
+
 template<class> constexpr Type typeFor();
 #define _c(T) template<> constexpr Type typeFor<T>() { return Type::T; }
 _c(UnsignedByte)
@@ -404,7 +424,7 @@ template<Int base, class T> const char* numericCharacters(const Containers::Arra
     return i;
 }
 
-template<Int base, class T> std::pair<const char*, T> baseNLiteral(const Containers::ArrayView<const char> data, std::string& buffer, ParseError& error) {
+template<Int base, class T> std::pair<const char*, T> baseNLiteral(const Containers::ArrayView<const char> data, ParseError& error) {
     /* Propagate errors */
     if(!data) return {};
 
@@ -413,9 +433,20 @@ template<Int base, class T> std::pair<const char*, T> baseNLiteral(const Contain
     /* Propagate errors */
     if(!i) return {};
 
-    extractWithoutUnderscore(data.prefix(i), buffer);
-    const ExtractedType<T> out = ExtractToType<T>::extract(buffer, base);
-    if(out > ExtractedType<T>(std::numeric_limits<T>::max())) {
+    /* Accumulate the value directly, skipping underscores. Overflowing even
+       the widest type is treated the same as not fitting into T. */
+    ExtractedType out = 0;
+    bool overflow = false;
+    for(const char* j = data; j != i; ++j) {
+        if(*j == '_') continue;
+
+        const UnsignedInt digit = digitValue<base>(*j);
+        if(out > (std::numeric_limits<ExtractedType>::max() - digit)/base)
+            overflow = true;
+        out = out*base + digit;
+    }
+
+    if(overflow || out > ExtractedType(std::numeric_limits<T>::max())) {
         error = {ParseErrorType::LiteralOutOfRange, typeFor<T>(), data};
         return {};
     }
@@ -425,7 +456,7 @@ template<Int base, class T> std::pair<const char*, T> baseNLiteral(const Contain
 
 }
 
-template<class T> std::tuple<const char*, T, Int> integralLiteral(const Containers::ArrayView<const char> data, std::string& buffer, ParseError& error) {
+template<class T> std::tuple<const char*, T, Int> integralLiteral(const Containers::ArrayView<const char> data, std::string&, ParseError& error) {
     /* Propagate errors */
     if(!data) return {};
 
@@ -462,19 +493,19 @@ template<class T> std::tuple<const char*, T, Int> integralLiteral(const Containe
         case 'x':
         case 'X': {
             base = 16;
-            std::tie(i, value) = baseNLiteral<16, T>(data.suffix(i + 2), buffer, error);
+            std::tie(i, value) = baseNLiteral<16, T>(data.suffix(i + 2), error);
             break;
         }
         case 'o':
         case 'O': {
             base = 8;
-            std::tie(i, value) = baseNLiteral<8, T>(data.suffix(i + 2), buffer, error);
+            std::tie(i, value) = baseNLiteral<8, T>(data.suffix(i + 2), error);
             break;
         }
         case 'b':
         case 'B': {
             base = 2;
-            std::tie(i, value) = baseNLiteral<2, T>(data.suffix(i + 2), buffer, error);
+            std::tie(i, value) = baseNLiteral<2, T>(data.suffix(i + 2), error);
             break;
         }
 
@@ -483,7 +514,7 @@ template<class T> std::tuple<const char*, T, Int> integralLiteral(const Containe
     /* Decimal literal  */
     } else {
         base = 10;
-        std::tie(i, value) = baseNLiteral<10, T>(data.suffix(i), buffer, error);
+        std::tie(i, value) = baseNLiteral<10, T>(data.suffix(i), error);
     }
 
     /** @todo C++14: use {} */
@@ -536,17 +567,17 @@ template<class T> std::pair<const char*, T> floatingPointLiteral(const Container
         switch(i[1]) {
             case 'x':
             case 'X': {
-                std::tie(i, integralValue) = baseNLiteral<16, IntegralTypeFor<T>>(data.suffix(i + 2), buffer, error);
+                std::tie(i, integralValue) = baseNLiteral<16, IntegralTypeFor<T>>(data.suffix(i + 2), error);
                 break;
             }
             case 'o':
             case 'O': {
-                std::tie(i, integralValue) = baseNLiteral<8, IntegralTypeFor<T>>(data.suffix(i + 2), buffer, error);
+                std::tie(i, integralValue) = baseNLiteral<8, IntegralTypeFor<T>>(data.suffix(i + 2), error);
                 break;
             }
             case 'b':
             case 'B': {
-                std::tie(i, integralValue) = baseNLiteral<2, IntegralTypeFor<T>>(data.suffix(i + 2), buffer, error);
+                std::tie(i, integralValue) = baseNLiteral<2, IntegralTypeFor<T>>(data.suffix(i + 2), error);
                 break;
             }
 
@@ -592,8 +623,72 @@ template<class T> std::pair<const char*, T> floatingPointLiteral(const Container
 
     /** @todo verifying out-of-range */
 
-    extractWithoutUnderscore(data.prefix(i), buffer);
-    return {i, ExtractToType<T>::extract(buffer)};
+    /* Try to calculate the value directly, skipping underscores. If the
+       significand gets too large, it's not exact anymore and the fallback
+       below is used. */
+    UnsignedLong significand = 0;
+    Int exponent = 0;
+    bool exact = true;
+    bool afterDot = false;
+    const char* j = before;
+    for(; j != i; ++j) {
+        const char c = *j;
+        if(c == '_') continue;
+        if(c == '.') {
+            afterDot = true;
+            continue;
+        }
+        if(c == 'e' || c == 'E') break;
+
+        if(significand >= 100000000000000000ull) {
+            exact = false;
+            break;
+        }
+        significand = significand*10 + UnsignedInt(c - '0');
+        if(afterDot) --exponent;
+    }
+
+    /* Exponent, which is already verified to contain at least one digit. Too
+       large exponents are clamped, they're out of the exact range either
+       way. */
+    if(exact && j != i) {
+        ++j;
+        Int exponentSign = 1;
+        if(*j == '+') ++j;
+        else if(*j == '-') {
+            exponentSign = -1;
+            ++j;
+        }
+
+        Int explicitExponent = 0;
+        for(; j != i; ++j) {
+            if(*j == '_') continue;
+            if(explicitExponent < 10000)
+                explicitExponent = explicitExponent*10 + (*j - '0');
+        }
+        exponent += exponentSign*explicitExponent;
+    }
+
+    if(exact && significand <= FloatingPointTraits<T>::MaxExactMantissa && exponent >= -FloatingPointTraits<T>::MaxExactExponent && exponent <= FloatingPointTraits<T>::MaxExactExponent) {
+        const Double value = exponent < 0 ?
+            Double(significand)/PowersOfTen[-exponent] :
+            Double(significand)*PowersOfTen[exponent];
+        return {i, sign*T(value)};
+    }
+
+    /* Otherwise copy the literal without underscores to a null-terminated
+       buffer, which is on stack unless the literal is extremely long */
+    char stackBuffer[128];
+    char* string = stackBuffer;
+    if(std::size_t(i - data) >= sizeof(stackBuffer)) {
+        buffer.assign(data, i - data);
+        string = &buffer[0];
+    }
+    char* out = string;
+    for(const char* k = data; k != i; ++k) if(*k != '_') *out++ = *k;
+    *out = '\0';
+
+    return {i, FloatingPointTraits<T>::extract(string)};
 }
 
 template std::pair<const char*, Float> floatingPointLiteral<Float>(Containers::ArrayView<const char>, std::string&, ParseError&);
@@ -24,9 +24,17 @@
 */
 
 #include <algorithm> /* std::find(), std::find_if() */
+#include <cstring>
 #include <tuple>
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <atomic>
+#include <thread>
+#endif
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Math.h>
 
 #include "Magnum/OpenDdl/Document.h"
 #include "Magnum/OpenDdl/Property.h"
@@ -117,7 +125,7 @@ namespace Implementation {
 
 Document::Document() {
     /* First string is reserved for empty names */
-    _strings.emplace_back();
+    arrayAppend(_strings, InPlaceInit);
 }
 
 Document::~Document() = default;
@@ -185,115 +193,365 @@ std::size_t Document::dereference(const std::size_t originatingStructure, const
     return NullReference;
 }
 
-bool Document::parse(Containers::ArrayView<const char> data, const std::initializer_list<CharacterLiteral> structureIdentifiers, const std::initializer_list<CharacterLiteral> propertyIdentifiers) {
-    _structureIdentifiers = {structureIdentifiers.begin(), structureIdentifiers.size()};
-    _propertyIdentifiers = {propertyIdentifiers.begin(), propertyIdentifiers.size()};
+namespace {
 
-    Implementation::ParseError error;
-    std::string buffer;
+void printParseError(const char* const prefix, const Containers::ArrayView<const char> data, const Implementation::ParseError& error) {
+    /* Calculate line number */
+    std::size_t line = 1;
+    for(char c: data.prefix(error.position)) if(c == '\n') ++line;
 
-    const char* i = Implementation::whitespace(data);
-    std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>> references;
-    i = parseStructureList(NoParent, data.suffix(i), references, buffer, error);
+    Error e;
+    e << prefix;
 
-    if(!i) {
-        /* Calculate line number */
-        std::size_t line = 1;
-        for(char c: data.prefix(error.position)) if(c == '\n') ++line;
-
-        Error e;
-        e << "OpenDdl::Document::parse():";
-
-        switch(error.error) {
-            case Implementation::ParseErrorType::InvalidEscapeSequence:
-                e << "invalid escape sequence";
-                break;
-            case Implementation::ParseErrorType::InvalidIdentifier:
-                e << "invalid identifier";
-                break;
-            case Implementation::ParseErrorType::InvalidName:
-                e << "invalid name";
-                break;
-            case Implementation::ParseErrorType::InvalidCharacterLiteral:
-                e << "invalid character literal";
-                break;
-            case Implementation::ParseErrorType::InvalidPropertyValue:
-                e << "invalid property value";
-                break;
-            case Implementation::ParseErrorType::InvalidSubArraySize:
-                e << "invalid subarray size";
-                break;
-            case Implementation::ParseErrorType::LiteralOutOfRange:
-                e << (error.type == Type::String ? "unterminated string literal" : "numeric literal out of range");
-                break;
-            case Implementation::ParseErrorType::ExpectedIdentifier:
-                e << "expected identifier";
-                break;
-            case Implementation::ParseErrorType::ExpectedName:
-                e << "expected name";
-                break;
-            case Implementation::ParseErrorType::ExpectedSeparator:
-                e << "expected , character";
-                break;
-            case Implementation::ParseErrorType::ExpectedListStart:
-                e << "expected { character";
-                break;
-            case Implementation::ParseErrorType::ExpectedListEnd:
-                e << "expected } character";
-                break;
-            case Implementation::ParseErrorType::ExpectedArraySizeEnd:
-                e << "expected ] character";
-                break;
-            case Implementation::ParseErrorType::ExpectedPropertyValue:
-                e << "expected property value";
-                break;
-            case Implementation::ParseErrorType::ExpectedPropertyAssignment:
-                e << "expected = character";
-                break;
-            case Implementation::ParseErrorType::ExpectedPropertyListEnd:
-                e << "expected ) character";
-                break;
-
-            case Implementation::ParseErrorType::InvalidLiteral:
-            case Implementation::ParseErrorType::ExpectedLiteral: {
-                e << (error.error == Implementation::ParseErrorType::InvalidLiteral ? "invalid" : "expected");
-
-                switch(error.type) {
-                    #define _c(type, identifier) \
-                        case Type::type: e << #identifier; break;
-                    _c(Bool, bool)
-                    _c(Byte, int8)
-                    _c(UnsignedByte, unsigned_int8)
-                    _c(Short, int16)
-                    _c(UnsignedShort, unsigned_int16)
-                    _c(Int, int32)
-                    _c(UnsignedInt, unsigned_int32)
-                    #ifndef CORRADE_TARGET_EMSCRIPTEN
-                    _c(Long, int64)
-                    _c(UnsignedLong, unsigned_int64)
-                    #endif
-                    /** @todo Half */
-                    _c(Float, float)
-                    _c(Double, double)
-                    _c(String, string)
-                    _c(Reference, ref)
-                    _c(Type, type)
-                    #undef _c
-                    case Type::Custom:
-                        CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-                }
+    switch(error.error) {
+        case Implementation::ParseErrorType::InvalidEscapeSequence:
+            e << "invalid escape sequence";
+            break;
+        case Implementation::ParseErrorType::InvalidIdentifier:
+            e << "invalid identifier";
+            break;
+        case Implementation::ParseErrorType::InvalidName:
+            e << "invalid name";
+            break;
+        case Implementation::ParseErrorType::InvalidCharacterLiteral:
+            e << "invalid character literal";
+            break;
+        case Implementation::ParseErrorType::InvalidPropertyValue:
+            e << "invalid property value";
+            break;
+        case Implementation::ParseErrorType::InvalidSubArraySize:
+            e << "invalid subarray size";
+            break;
+        case Implementation::ParseErrorType::LiteralOutOfRange:
+            e << (error.type == Type::String ? "unterminated string literal" : "numeric literal out of range");
+            break;
+        case Implementation::ParseErrorType::ExpectedIdentifier:
+            e << "expected identifier";
+            break;
+        case Implementation::ParseErrorType::ExpectedName:
+            e << "expected name";
+            break;
+        case Implementation::ParseErrorType::ExpectedSeparator:
+            e << "expected , character";
+            break;
+        case Implementation::ParseErrorType::ExpectedListStart:
+            e << "expected { character";
+            break;
+        case Implementation::ParseErrorType::ExpectedListEnd:
+            e << "expected } character";
+            break;
+        case Implementation::ParseErrorType::ExpectedArraySizeEnd:
+            e << "expected ] character";
+            break;
+        case Implementation::ParseErrorType::ExpectedPropertyValue:
+            e << "expected property value";
+            break;
+        case Implementation::ParseErrorType::ExpectedPropertyAssignment:
+            e << "expected = character";
+            break;
+        case Implementation::ParseErrorType::ExpectedPropertyListEnd:
+            e << "expected ) character";
+            break;
+
+        case Implementation::ParseErrorType::InvalidLiteral:
+        case Implementation::ParseErrorType::ExpectedLiteral: {
+            e << (error.error == Implementation::ParseErrorType::InvalidLiteral ? "invalid" : "expected");
+
+            switch(error.type) {
+                #define _c(type, identifier) \
+                    case Type::type: e << #identifier; break;
+                _c(Bool, bool)
+                _c(Byte, int8)
+                _c(UnsignedByte, unsigned_int8)
+                _c(Short, int16)
+                _c(UnsignedShort, unsigned_int16)
+                _c(Int, int32)
+                _c(UnsignedInt, unsigned_int32)
+                #ifndef CORRADE_TARGET_EMSCRIPTEN
+                _c(Long, int64)
+                _c(UnsignedLong, unsigned_int64)
+                #endif
+                /** @todo Half */
+                _c(Float, float)
+                _c(Double, double)
+                _c(String, string)
+                _c(Reference, ref)
+                _c(Type, type)
+                #undef _c
+                case Type::Custom:
+                    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+            }
+
+            e << "literal";
 
-                e << "literal";
+            break;
+        }
+
+        case Implementation::ParseErrorType::NoError:
+            CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+
+    e << "on line" << line;
+}
+
+/* If i points to a start of a comment or a string or character literal,
+   returns a pointer to its last character, otherwise returns i. Returns
+   nullptr if it's not terminated. */
+const char* skipCommentOrLiteral(const char* i, const char* const end) {
+    const char c = *i;
+
+    /* String and character literals, skip to the matching unescaped quote */
+    if(c == '"' || c == '\'') {
+        for(++i; i != end && *i != c; ++i)
+            if(*i == '\\' && i + 1 != end) ++i;
+        return i == end ? nullptr : i;
+    }
+
+    /* Comments */
+    if(c == '/' && i + 1 != end) {
+        if(i[1] == '/')
+            return static_cast<const char*>(std::memchr(i + 2, '\n', end - i - 2));
+        if(i[1] == '*') {
+            for(const char* j = i + 2; (j = static_cast<const char*>(std::memchr(j, '*', end - j))) && j + 1 != end; ++j)
+                if(j[1] == '/') return j + 1;
+            return nullptr;
+        }
+    }
+
+    return i;
+}
+
+/* Finds the closing brace of a data list without parsing it, tracking only
+   sub-array braces and skipping over comments and literals */
+const char* dataListEnd(const Containers::ArrayView<const char> data, Implementation::ParseError& error) {
+    std::size_t depth = 0;
+    for(const char* i = data.begin(), *end = data.end(); i != end; ++i) {
+        if(*i == '{') ++depth;
+        else if(*i == '}') {
+            if(!depth) return i;
+            --depth;
+        } else if(!(i = skipCommentOrLiteral(i, end))) break;
+    }
+
+    error = {Implementation::ParseErrorType::ExpectedListEnd, data.end()};
+    return nullptr;
+}
+
+/* Splits the data into at most chunkCount pieces of roughly the same size,
+   each containing a sequence of complete top-level structures. Only the brace
+   nesting is tracked, skipping over comments and string and character
+   literals. Validity of the data is checked by the parser later. */
+Containers::Array<Containers::ArrayView<const char>> splitTopLevelStructures(const Containers::ArrayView<const char> data, const std::size_t chunkCount) {
+    Containers::Array<Containers::ArrayView<const char>> chunks;
+    const std::size_t targetSize = data.size()/chunkCount;
+    const char* chunkBegin = data.begin();
+    const char* const end = data.end();
+    std::size_t depth = 0;
+    for(const char* i = data.begin(); i != end; ++i) {
+        const char c = *i;
+        if(c == '{') ++depth;
+        else if(c == '}') {
+            /* Unbalanced brace, leave it to the parser to deal with */
+            if(!depth) break;
+
+            if(--depth == 0 && std::size_t(i + 1 - chunkBegin) >= targetSize && chunks.size() + 1 < chunkCount) {
+                arrayAppend(chunks, data.slice(chunkBegin, i + 1));
+                chunkBegin = i + 1;
+            }
+        } else if(!(i = skipCommentOrLiteral(i, end))) break;
+    }
+
+    /* The rest, which is possibly just whitespace */
+    arrayAppend(chunks, data.slice(chunkBegin, end));
+    return chunks;
+}
+
+template<class T> std::size_t mergeData(Containers::Array<T>& to, const Containers::Array<T>& from) {
+    const std::size_t offset = to.size();
+    arrayAppend(to, Containers::arrayView(from));
+    return offset;
+}
+
+std::size_t mergeData(Containers::Array<std::string>& to, Containers::Array<std::string>& from) {
+    const std::size_t offset = to.size();
+    for(std::string& string: from) arrayAppend(to, std::move(string));
+    return offset;
+}
+
+}
 
-                break;
+bool Document::parseParallel(const Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, const UnsignedInt threadCount) {
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    /* Split to more chunks than there is threads, as the structures can have
+       vastly different parsing complexity */
+    const Containers::Array<Containers::ArrayView<const char>> chunks = splitTopLevelStructures(data, std::size_t{threadCount}*4);
+    if(chunks.size() < 2) return false;
+
+    struct Chunk {
+        Document document;
+        std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>> references;
+        bool parsed;
+    };
+    Containers::Array<Chunk> parsedChunks{chunks.size()};
+
+    /* Each thread picks the next unparsed chunk; the calling thread is one of
+       the workers */
+    std::atomic<std::size_t> next{0};
+    const auto process = [&]() {
+        Implementation::ParseError error;
+        std::string buffer;
+        for(std::size_t i; (i = next++) < chunks.size(); ) {
+            Chunk& chunk = parsedChunks[i];
+            chunk.document._structureIdentifiers = _structureIdentifiers;
+            chunk.document._propertyIdentifiers = _propertyIdentifiers;
+            chunk.document.setLazyStructures(_lazyStructureIdentifiers);
+
+            /* Unlike in a serial parse, the chunk has to be consumed whole,
+               otherwise the serial parse is done to handle the error */
+            const char* j = Implementation::whitespace(chunks[i]);
+            j = chunk.document.parseStructureList(NoParent, chunks[i].suffix(j), chunk.references, buffer, error);
+            chunk.parsed = j && Implementation::whitespace(chunks[i].suffix(j)) == chunks[i].end();
+        }
+    };
+
+    Containers::Array<std::thread> threads{Utility::min(std::size_t{threadCount}, chunks.size()) - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{process};
+    process();
+    for(std::thread& thread: threads)
+        thread.join();
+
+    for(const Chunk& chunk: parsedChunks)
+        if(!chunk.parsed) return false;
+
+    /* Merge the chunks into the document, offsetting all indices */
+    std::size_t lastTopLevel = NoParent;
+    for(Chunk& chunk: parsedChunks) {
+        Document& d = chunk.document;
+
+        std::size_t dataOffsets[UnsignedInt(Type::Custom)];
+        #define _c(type, T) \
+            dataOffsets[UnsignedInt(Type::type)] = mergeData(this->data<T>(), d.data<T>());
+        _c(Bool, bool)
+        _c(UnsignedByte, UnsignedByte)
+        _c(Byte, Byte)
+        _c(UnsignedShort, UnsignedShort)
+        _c(Short, Short)
+        _c(UnsignedInt, UnsignedInt)
+        _c(Int, Int)
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        _c(UnsignedLong, UnsignedLong)
+        _c(Long, Long)
+        #endif
+        /** @todo Half */
+        _c(Float, Float)
+        _c(Double, Double)
+        _c(String, std::string)
+        _c(Type, Type)
+        #undef _c
+        dataOffsets[UnsignedInt(Type::Reference)] = references.size();
+
+        const std::size_t propertyOffset = _properties.size();
+        for(PropertyData property: d._properties) {
+            switch(property.type) {
+                case Implementation::InternalPropertyType::Bool:
+                    property.position += dataOffsets[UnsignedInt(Type::Bool)];
+                    break;
+                case Implementation::InternalPropertyType::Binary:
+                case Implementation::InternalPropertyType::Character:
+                case Implementation::InternalPropertyType::Integral:
+                    property.position += dataOffsets[UnsignedInt(Type::Int)];
+                    break;
+                case Implementation::InternalPropertyType::Float:
+                    property.position += dataOffsets[UnsignedInt(Type::Float)];
+                    break;
+                case Implementation::InternalPropertyType::String:
+                    property.position += dataOffsets[UnsignedInt(Type::String)];
+                    break;
+                case Implementation::InternalPropertyType::Reference:
+                    property.position += dataOffsets[UnsignedInt(Type::Reference)];
+                    break;
+                case Implementation::InternalPropertyType::Type:
+                    property.position += dataOffsets[UnsignedInt(Type::Type)];
+                    break;
             }
+            arrayAppend(_properties, property);
+        }
 
-            case Implementation::ParseErrorType::NoError:
-                CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        /* Name 0 is the empty name and first child or next sibling 0 means
+           there's none, those stay unchanged */
+        const std::size_t structureOffset = _structures.size();
+        for(StructureData structure: d._structures) {
+            if(structure.name)
+                structure.name += dataOffsets[UnsignedInt(Type::String)];
+            if(structure.primitive.type >= Type::Custom) {
+                structure.custom.propertiesBegin += propertyOffset;
+                if(structure.custom.firstChild)
+                    structure.custom.firstChild += structureOffset;
+            } else structure.primitive.begin += dataOffsets[UnsignedInt(structure.primitive.type)];
+            if(structure.parent != NoParent)
+                structure.parent += structureOffset;
+            if(structure.next)
+                structure.next += structureOffset;
+            arrayAppend(_structures, structure);
         }
 
-        e << "on line" << line;
+        for(const std::pair<std::size_t, Containers::ArrayView<const char>>& reference: chunk.references)
+            references.emplace_back(reference.first + structureOffset, reference.second);
+
+        /* Lazy data point directly to the source data, only the structure
+           index needs to be offset */
+        for(const std::pair<std::size_t, const char*>& lazy: d._lazyData)
+            arrayAppend(_lazyData, InPlaceInit, lazy.first + structureOffset, lazy.second);
+
+        /* Link the last top-level structure of the previous chunk to the
+           first top-level structure of this one */
+        if(!d._structures.isEmpty()) {
+            if(lastTopLevel != NoParent)
+                _structures[lastTopLevel].next = structureOffset;
+            lastTopLevel = structureOffset;
+            while(_structures[lastTopLevel].next)
+                lastTopLevel = _structures[lastTopLevel].next;
+        }
+    }
+
+    return true;
+    #else
+    static_cast<void>(data);
+    static_cast<void>(references);
+    static_cast<void>(threadCount);
+    return false;
+    #endif
+}
+
+bool Document::parse(const Containers::ArrayView<const char> data, const std::initializer_list<CharacterLiteral> structureIdentifiers, const std::initializer_list<CharacterLiteral> propertyIdentifiers) {
+    return parse(data, structureIdentifiers, propertyIdentifiers, 1);
+}
 
+bool Document::parse(Containers::ArrayView<const char> data, const std::initializer_list<CharacterLiteral> structureIdentifiers, const std::initializer_list<CharacterLiteral> propertyIdentifiers, UnsignedInt threadCount) {
+    _structureIdentifiers = {structureIdentifiers.begin(), structureIdentifiers.size()};
+    _propertyIdentifiers = {propertyIdentifiers.begin(), propertyIdentifiers.size()};
+
+    _lazySource = data;
+
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    if(!threadCount)
+        threadCount = Utility::max(std::thread::hardware_concurrency(), 1u);
+    #endif
+
+    Implementation::ParseError error;
+
+    const char* i = Implementation::whitespace(data);
+    std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>> references;
+
+    /* If the parallel parse isn't possible or fails, parse serially */
+    if(threadCount <= 1 || !parseParallel(data.suffix(i), references, threadCount)) {
+        std::string buffer;
+        i = parseStructureList(NoParent, data.suffix(i), references, buffer, error);
+    }
+
+    if(!i) {
+        printParseError("OpenDdl::Document::parse():", data, error);
         return false;
     }
 
@@ -301,7 +559,7 @@ bool Document::parse(Containers::ArrayView<const char> data, const std::initiali
     for(const std::pair<std::size_t, Containers::ArrayView<const char>>& reference: references) {
         /* Null reference */
         if(reference.second.isEmpty())
-            _references.push_back(NullReference);
+            arrayAppend(_references, std::size_t(NullReference));
 
         /* Non-null, try to dereference */
         else {
@@ -310,13 +568,336 @@ bool Document::parse(Containers::ArrayView<const char> data, const std::initiali
                 Error() << "OpenDdl::Document::parse(): reference" << std::string{reference.second, reference.second.size()} << "was not found";
                 return false;
             }
-            _references.push_back(r);
+            arrayAppend(_references, r);
         }
     }
 
     return true;
 }
 
+void Document::setLazyStructures(const Containers::ArrayView<const Int> identifiers) {
+    _lazyStructureIdentifiers = Containers::Array<Int>{NoInit, identifiers.size()};
+    Utility::copy(identifiers, _lazyStructureIdentifiers);
+}
+
+void Document::setLazyStructures(const std::initializer_list<Int> identifiers) {
+    setLazyStructures(Containers::arrayView(identifiers));
+}
+
+bool Document::parseLazyData(const Structure structure) {
+    CORRADE_ASSERT(&structure._document.get() == this,
+        "OpenDdl::Document::parseLazyData(): structure is from another document", {});
+
+    /* The structures are stored depth-first, so the structure with all its
+       children is a contiguous range ending at the next sibling of the
+       structure or of its closest ancestor that has one */
+    const std::size_t begin = &structure._data.get() - _structures.data();
+    std::size_t end = begin;
+    while(end != NoParent && !_structures[end].next)
+        end = _structures[end].parent;
+
+    return parseLazyDataRange(begin, end == NoParent ? _structures.size() : _structures[end].next);
+}
+
+bool Document::parseLazyData() {
+    return parseLazyDataRange(0, _structures.size());
+}
+
+bool Document::parseLazyDataRange(const std::size_t begin, const std::size_t end) {
+    Implementation::ParseError error;
+    std::string buffer;
+    /* Unused, as references are never parsed lazily */
+    std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>> references;
+
+    /* The lazy data are sorted by structure index */
+    for(std::pair<std::size_t, const char*>* lazy = std::lower_bound(_lazyData.begin(), _lazyData.end(), begin, [](const std::pair<std::size_t, const char*>& a, const std::size_t b) {
+        return a.first < b;
+    }); lazy != _lazyData.end() && lazy->first < end; ++lazy) {
+        /* Already parsed */
+        if(!lazy->second) continue;
+
+        StructureData::Primitive& primitive = _structures[lazy->first].primitive;
+        if(!parseDataList(primitive.type, primitive.subArraySize, _lazySource.suffix(lazy->second), references, buffer, primitive.begin, primitive.size, error)) {
+            /* Don't leave the structure with a partially filled data list */
+            primitive.begin = primitive.size = 0;
+            printParseError("OpenDdl::Document::parseLazyData():", _lazySource, error);
+            return false;
+        }
+
+        lazy->second = nullptr;
+    }
+
+    return true;
+}
+
+namespace {
+
+/* Bump every time the serialized layout or any of the internal structures
+   change */
+constexpr UnsignedInt SerializedVersion = 1;
+
+enum: std::size_t {
+    SerializedBools,
+    SerializedBytes,
+    SerializedUnsignedBytes,
+    SerializedShorts,
+    SerializedUnsignedShorts,
+    SerializedInts,
+    SerializedUnsignedInts,
+    SerializedLongs,
+    SerializedUnsignedLongs,
+    SerializedFloats,
+    SerializedDoubles,
+    SerializedReferences,
+    SerializedTypes,
+    SerializedProperties,
+    SerializedStructures,
+    SerializedStrings,
+    SerializedStringData,
+    SerializedArrayCount
+};
+
+enum: UnsignedByte {
+    SerializedFlagBigEndian = 1 << 0,
+    SerializedFlagLongs = 1 << 1
+};
+
+struct SerializedHeader {
+    char magic[8];
+    UnsignedInt version;
+    UnsignedByte sizeofSizeT;
+    UnsignedByte flags;
+    UnsignedShort:16;
+    UnsignedInt structureIdentifierCount;
+    UnsignedInt propertyIdentifierCount;
+    UnsignedLong identifierSize;
+    UnsignedLong sizes[SerializedArrayCount];
+};
+
+static_assert(sizeof(SerializedHeader) % 8 == 0, "serialized header not padded to 8 bytes");
+
+constexpr const char SerializedMagic[]{'O', 'D', 'D', 'L', 'B', 'L', 'O', 'B'};
+
+constexpr UnsignedByte serializedFlags() {
+    return
+        #ifdef CORRADE_TARGET_BIG_ENDIAN
+        SerializedFlagBigEndian|
+        #endif
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        SerializedFlagLongs|
+        #endif
+        0;
+}
+
+/* All sections are padded to 8 bytes so the arrays stay aligned if the
+   whole blob is */
+std::size_t serializedPadding(const std::size_t size) {
+    return (8 - size % 8) % 8;
+}
+
+/* Names of all identifiers, null-terminated, so a blob created with a
+   different identifier list can be detected */
+void serializeIdentifiers(Containers::Array<char>& out, const Containers::ArrayView<const CharacterLiteral> identifiers) {
+    for(const CharacterLiteral& identifier: identifiers) {
+        arrayAppend(out, Containers::ArrayView<const char>{identifier});
+        arrayAppend(out, '\0');
+    }
+}
+
+template<class T> void serializeArray(Containers::Array<char>& out, const Containers::ArrayView<const T> data) {
+    arrayAppend(out, Containers::arrayCast<const char>(data));
+    arrayAppend(out, ValueInit, serializedPadding(data.size()*sizeof(T)));
+}
+
+/* If the data are aligned, reference them directly, otherwise copy */
+template<class T> void deserializeArray(Containers::Array<T>& out, const char*& data, const std::size_t size) {
+    if(reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0)
+        out = Containers::Array<T>{const_cast<T*>(reinterpret_cast<const T*>(data)), size, [](T*, std::size_t) {}};
+    else {
+        out = Containers::Array<T>{NoInit, size};
+        std::memcpy(out.data(), data, size*sizeof(T));
+    }
+    data += size*sizeof(T) + serializedPadding(size*sizeof(T));
+}
+
+}
+
+Containers::Array<char> Document::serialize() const {
+    #ifndef CORRADE_NO_ASSERT
+    for(const std::pair<std::size_t, const char*>& lazy: _lazyData)
+        CORRADE_ASSERT(!lazy.second,
+            "OpenDdl::Document::serialize(): lazy data of structure" << lazy.first << "not parsed", {});
+    #endif
+
+    Containers::Array<char> identifiers;
+    serializeIdentifiers(identifiers, _structureIdentifiers);
+    serializeIdentifiers(identifiers, _propertyIdentifiers);
+
+    /* Strings are saved as an array of sizes followed by all characters */
+    std::size_t stringDataSize = 0;
+    for(const std::string& string: _strings)
+        stringDataSize += string.size();
+
+    SerializedHeader header{};
+    std::memcpy(header.magic, SerializedMagic, sizeof(SerializedMagic));
+    header.version = SerializedVersion;
+    header.sizeofSizeT = sizeof(std::size_t);
+    header.flags = serializedFlags();
+    header.structureIdentifierCount = _structureIdentifiers.size();
+    header.propertyIdentifierCount = _propertyIdentifiers.size();
+    header.identifierSize = identifiers.size();
+    header.sizes[SerializedBools] = _bools.size();
+    header.sizes[SerializedBytes] = _bytes.size();
+    header.sizes[SerializedUnsignedBytes] = _unsignedBytes.size();
+    header.sizes[SerializedShorts] = _shorts.size();
+    header.sizes[SerializedUnsignedShorts] = _unsignedShorts.size();
+    header.sizes[SerializedInts] = _ints.size();
+    header.sizes[SerializedUnsignedInts] = _unsignedInts.size();
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    header.sizes[SerializedLongs] = _longs.size();
+    header.sizes[SerializedUnsignedLongs] = _unsignedLongs.size();
+    #endif
+    header.sizes[SerializedFloats] = _floats.size();
+    header.sizes[SerializedDoubles] = _doubles.size();
+    header.sizes[SerializedReferences] = _references.size();
+    header.sizes[SerializedTypes] = _types.size();
+    header.sizes[SerializedProperties] = _properties.size();
+    header.sizes[SerializedStructures] = _structures.size();
+    header.sizes[SerializedStrings] = _strings.size();
+    header.sizes[SerializedStringData] = stringDataSize;
+
+    Containers::Array<char> out;
+    arrayAppend(out, Containers::arrayView(reinterpret_cast<const char*>(&header), sizeof(SerializedHeader)));
+    serializeArray<char>(out, identifiers);
+    serializeArray<bool>(out, _bools);
+    serializeArray<Byte>(out, _bytes);
+    serializeArray<UnsignedByte>(out, _unsignedBytes);
+    serializeArray<Short>(out, _shorts);
+    serializeArray<UnsignedShort>(out, _unsignedShorts);
+    serializeArray<Int>(out, _ints);
+    serializeArray<UnsignedInt>(out, _unsignedInts);
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    serializeArray<Long>(out, _longs);
+    serializeArray<UnsignedLong>(out, _unsignedLongs);
+    #endif
+    serializeArray<Float>(out, _floats);
+    serializeArray<Double>(out, _doubles);
+    serializeArray<std::size_t>(out, _references);
+    serializeArray<Type>(out, _types);
+    serializeArray<PropertyData>(out, _properties);
+    serializeArray<StructureData>(out, _structures);
+
+    Containers::Array<std::size_t> stringSizes{NoInit, _strings.size()};
+    for(std::size_t i = 0; i != _strings.size(); ++i)
+        stringSizes[i] = _strings[i].size();
+    serializeArray<std::size_t>(out, stringSizes);
+    for(const std::string& string: _strings)
+        arrayAppend(out, Containers::arrayView(string.data(), string.size()));
+    arrayAppend(out, ValueInit, serializedPadding(stringDataSize));
+
+    /* Convert back to a default deleter so the array can be used
+       anywhere */
+    arrayShrink(out, DefaultInit);
+    return out;
+}
+
+bool Document::deserialize(const Containers::ArrayView<const char> data, const std::initializer_list<CharacterLiteral> structureIdentifiers, const std::initializer_list<CharacterLiteral> propertyIdentifiers) {
+    CORRADE_ASSERT(_structures.isEmpty() && _strings.size() == 1,
+        "OpenDdl::Document::deserialize(): the document is not empty", {});
+
+    if(data.size() < sizeof(SerializedHeader)) {
+        Error() << "OpenDdl::Document::deserialize(): expected at least" << sizeof(SerializedHeader) << "bytes but got" << data.size();
+        return false;
+    }
+
+    /* The data may not be aligned, copy the header out. Empty arrays in
+       Emscripten builds are saved with zero sizes, the flags take care of
+       a mismatch. */
+    SerializedHeader header;
+    std::memcpy(&header, data.data(), sizeof(SerializedHeader));
+    if(std::memcmp(header.magic, SerializedMagic, sizeof(SerializedMagic)) != 0 || header.version != SerializedVersion || header.sizeofSizeT != sizeof(std::size_t) || header.flags != serializedFlags()) {
+        Error() << "OpenDdl::Document::deserialize(): invalid or incompatible header";
+        return false;
+    }
+
+    /* Check that the identifiers are the same as the blob was created
+       with */
+    Containers::Array<char> identifiers;
+    serializeIdentifiers(identifiers, {structureIdentifiers.begin(), structureIdentifiers.size()});
+    serializeIdentifiers(identifiers, {propertyIdentifiers.begin(), propertyIdentifiers.size()});
+    if(header.structureIdentifierCount != structureIdentifiers.size() || header.propertyIdentifierCount != propertyIdentifiers.size() || header.identifierSize != identifiers.size() || data.size() < sizeof(SerializedHeader) + identifiers.size() || std::memcmp(data.data() + sizeof(SerializedHeader), identifiers.data(), identifiers.size()) != 0) {
+        Error() << "OpenDdl::Document::deserialize(): structure or property identifiers don't match";
+        return false;
+    }
+
+    const std::size_t elementSizes[]{
+        sizeof(bool),
+        sizeof(Byte),
+        sizeof(UnsignedByte),
+        sizeof(Short),
+        sizeof(UnsignedShort),
+        sizeof(Int),
+        sizeof(UnsignedInt),
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        sizeof(Long),
+        sizeof(UnsignedLong),
+        #else
+        0, 0,
+        #endif
+        sizeof(Float),
+        sizeof(Double),
+        sizeof(std::size_t),
+        sizeof(Type),
+        sizeof(PropertyData),
+        sizeof(StructureData),
+        sizeof(std::size_t),
+        1
+    };
+    static_assert(Containers::arraySize(elementSizes) == SerializedArrayCount, "");
+    std::size_t expectedSize = sizeof(SerializedHeader) + identifiers.size() + serializedPadding(identifiers.size());
+    for(std::size_t i = 0; i != SerializedArrayCount; ++i) {
+        const std::size_t size = header.sizes[i]*elementSizes[i];
+        expectedSize += size + serializedPadding(size);
+    }
+    if(data.size() != expectedSize) {
+        Error() << "OpenDdl::Document::deserialize(): expected" << expectedSize << "bytes but got" << data.size();
+        return false;
+    }
+
+    const char* i = data.data() + sizeof(SerializedHeader) + identifiers.size() + serializedPadding(identifiers.size());
+    deserializeArray(_bools, i, header.sizes[SerializedBools]);
+    deserializeArray(_bytes, i, header.sizes[SerializedBytes]);
+    deserializeArray(_unsignedBytes, i, header.sizes[SerializedUnsignedBytes]);
+    deserializeArray(_shorts, i, header.sizes[SerializedShorts]);
+    deserializeArray(_unsignedShorts, i, header.sizes[SerializedUnsignedShorts]);
+    deserializeArray(_ints, i, header.sizes[SerializedInts]);
+    deserializeArray(_unsignedInts, i, header.sizes[SerializedUnsignedInts]);
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    deserializeArray(_longs, i, header.sizes[SerializedLongs]);
+    deserializeArray(_unsignedLongs, i, header.sizes[SerializedUnsignedLongs]);
+    #endif
+    deserializeArray(_floats, i, header.sizes[SerializedFloats]);
+    deserializeArray(_doubles, i, header.sizes[SerializedDoubles]);
+    deserializeArray(_references, i, header.sizes[SerializedReferences]);
+    deserializeArray(_types, i, header.sizes[SerializedTypes]);
+    deserializeArray(_properties, i, header.sizes[SerializedProperties]);
+    deserializeArray(_structures, i, header.sizes[SerializedStructures]);
+
+    /* Strings have to be always copied */
+    Containers::Array<std::size_t> stringSizes;
+    deserializeArray(stringSizes, i, header.sizes[SerializedStrings]);
+    _strings = Containers::Array<std::string>{header.sizes[SerializedStrings]};
+    for(std::size_t j = 0; j != stringSizes.size(); ++j) {
+        _strings[j].assign(i, stringSizes[j]);
+        i += stringSizes[j];
+    }
+
+    _structureIdentifiers = {structureIdentifiers.begin(), structureIdentifiers.size()};
+    _propertyIdentifiers = {propertyIdentifiers.begin(), propertyIdentifiers.size()};
+
+    return true;
+}
+
 const char* Document::parseProperty(const Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, const Int identifier, Implementation::ParseError& error) {
     bool boolValue;
     Int integerValue;
@@ -335,21 +916,21 @@ const char* Document::parseProperty(const Containers::ArrayView<const char> data
     switch(type) {
         case Implementation::InternalPropertyType::Bool:
             position = _bools.size();
-            _bools.push_back(boolValue);
+            arrayAppend(_bools, boolValue);
             break;
         case Implementation::InternalPropertyType::Binary:
         case Implementation::InternalPropertyType::Character:
         case Implementation::InternalPropertyType::Integral:
             position = _ints.size();
-            _ints.push_back(integerValue);
+            arrayAppend(_ints, integerValue);
             break;
         case Implementation::InternalPropertyType::Float:
             position = _floats.size();
-            _floats.push_back(floatValue);
+            arrayAppend(_floats, floatValue);
             break;
         case Implementation::InternalPropertyType::String:
             position = _strings.size();
-            _strings.push_back(stringValue);
+            arrayAppend(_strings, stringValue);
             break;
         case Implementation::InternalPropertyType::Reference:
             position = references.size();
@@ -359,11 +940,11 @@ const char* Document::parseProperty(const Containers::ArrayView<const char> data
             break;
         case Implementation::InternalPropertyType::Type:
             position = _types.size();
-            _types.push_back(typeValue);
+            arrayAppend(_types, typeValue);
             break;
     }
 
-    _properties.emplace_back(identifier, type, position);
+    arrayAppend(_properties, InPlaceInit, identifier, type, position);
     return i;
 }
 
@@ -374,7 +955,7 @@ template<> struct ExtractDataListItem<Type::Bool> {
         const char* i;
         bool value;
         std::tie(i, value) = Implementation::boolLiteral(data, error);
-        document.data<bool>().push_back(value);
+        arrayAppend(document.data<bool>(), value);
         return i;
     }
 };
@@ -384,7 +965,7 @@ template<class T> struct ExtractIntegralDataListItem {
         const char* i;
         T value;
         std::tie(i, value, std::ignore) = Implementation::integralLiteral<T>(data, buffer, error);
-        document.data<T>().push_back(value);
+        arrayAppend(document.data<T>(), value);
         return i;
     }
 };
@@ -407,7 +988,7 @@ template<class T> struct ExtractFloatingPointDataListItem {
         const char* i;
         T value;
         std::tie(i, value) = Implementation::floatingPointLiteral<T>(data, buffer, error);
-        document.data<T>().push_back(value);
+        arrayAppend(document.data<T>(), value);
         return i;
     }
 };
@@ -423,7 +1004,7 @@ template<> struct ExtractDataListItem<Type::String> {
         const char* i;
         std::string value;
         std::tie(i, value) = Implementation::stringLiteral(data, error);
-        document.data<std::string>().push_back(std::move(value));
+        arrayAppend(document.data<std::string>(), std::move(value));
         return i;
     }
 };
@@ -445,7 +1026,7 @@ template<> struct ExtractDataListItem<Type::Type> {
         const char* i;
         Type value;
         std::tie(i, value) = Implementation::typeLiteral(data, error);
-        document.data<Type>().push_back(value);
+        arrayAppend(document.data<Type>(), value);
         return i;
     }
 };
@@ -529,6 +1110,36 @@ template<Type type> std::pair<const char*, std::size_t> dataArrayList(const Cont
     return {i, j*subArraySize};
 }
 
+/* Counts elements of a data list by counting separators until the end of the
+   list. The count is exact for lists without comments, but since it's only
+   used as an allocation hint, a comment containing a , or a } doesn't break
+   anything. Not used for strings, where the separators could be inside the
+   literals. */
+std::size_t dataListSizeHint(const Containers::ArrayView<const char> data) {
+    std::size_t depth = 0;
+    std::size_t count = 1;
+    for(const char c: data) {
+        if(c == ',') ++count;
+        else if(c == '{') ++depth;
+        else if(c == '}') {
+            if(!depth) break;
+            --depth;
+        }
+    }
+
+    return count;
+}
+
+/* Reserves space for `count` more items, growing at least twice the current
+   capacity so many short lists of the same type don't reallocate on every
+   list */
+template<class T> void reserveDataList(Containers::Array<T>& array, const std::size_t count) {
+    const std::size_t desired = array.size() + count;
+    const std::size_t capacity = arrayCapacity(array);
+    if(desired > capacity)
+        arrayReserve(array, desired > 2*capacity ? desired : 2*capacity);
+}
+
 Int identifierId(const Containers::ArrayView<const char> data, Containers::ArrayView<const CharacterLiteral> identifiers) {
     Int i = 0;
     for(const Containers::ArrayView<const char> identifier: identifiers) {
@@ -541,6 +1152,55 @@ Int identifierId(const Containers::ArrayView<const char> data, Containers::Array
 
 }
 
+const char* Document::parseDataList(const Type type, const std::size_t subArraySize, const Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, std::size_t& dataBegin, std::size_t& dataSize, Implementation::ParseError& error) {
+    const char* i = nullptr;
+    switch(type) {
+        #define _c(type, T) \
+        case Type::type: \
+            dataBegin = dataPosition<Type::type>(); \
+            reserveDataList(this->data<T>(), dataListSizeHint(data)); \
+            std::tie(i, dataSize) = dataArrayList<Type::type>(data, *this, references, buffer, subArraySize, error); break;
+        _c(Bool, bool)
+        _c(UnsignedByte, UnsignedByte)
+        _c(Byte, Byte)
+        _c(UnsignedShort, UnsignedShort)
+        _c(Short, Short)
+        _c(UnsignedInt, UnsignedInt)
+        _c(Int, Int)
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        _c(UnsignedLong, UnsignedLong)
+        _c(Long, Long)
+        #endif
+        /** @todo Half */
+        _c(Float, Float)
+        _c(Double, Double)
+        _c(Type, Type)
+        #undef _c
+        case Type::String:
+            dataBegin = dataPosition<Type::String>();
+            std::tie(i, dataSize) = dataArrayList<Type::String>(data, *this, references, buffer, subArraySize, error);
+            break;
+        case Type::Reference:
+            dataBegin = references.size();
+            std::tie(i, dataSize) = dataArrayList<Type::Reference>(data, *this, references, buffer, subArraySize, error);
+            break;
+        case Type::Custom:
+            CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+
+    /* Propagate errors */
+    if(!i) return {};
+
+    i = Implementation::whitespace(data.suffix(i));
+
+    if(i == data.end() || *i != '}') {
+        error = {Implementation::ParseErrorType::ExpectedListEnd, i};
+        return {};
+    }
+
+    return i;
+}
+
 std::pair<const char*, std::size_t> Document::parseStructure(const std::size_t parent, const Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, Implementation::ParseError& error) {
     /* Identifier */
     const char* const structureIdentifier = Implementation::identifier(data, error);
@@ -585,7 +1245,7 @@ std::pair<const char*, std::size_t> Document::parseStructure(const std::size_t p
             std::string s;
             std::tie(i, s) = Implementation::nameLiteral(data.suffix(i), error);
             name = _strings.size();
-            _strings.push_back(std::move(s));
+            arrayAppend(_strings, std::move(s));
 
             i = Implementation::whitespace(data.suffix(i));
         }
@@ -601,48 +1261,20 @@ std::pair<const char*, std::size_t> Document::parseStructure(const std::size_t p
 
         i = Implementation::whitespace(data.suffix(i + 1));
 
+        /* If the parent structure has lazily parsed data, only skip to the
+           end of the data list and remember where it starts. References
+           are always parsed immediately, as they get resolved right after
+           the parse. */
         std::size_t dataBegin = 0, dataSize = 0;
-        switch(type) {
-            #define _c(type) \
-            case Type::type: \
-                dataBegin = dataPosition<Type::type>(); \
-                std::tie(i, dataSize) = dataArrayList<Type::type>(data.suffix(i), *this, references, buffer, subArraySize, error); break;
-            _c(Bool)
-            _c(UnsignedByte)
-            _c(Byte)
-            _c(UnsignedShort)
-            _c(Short)
-            _c(UnsignedInt)
-            _c(Int)
-            #ifndef CORRADE_TARGET_EMSCRIPTEN
-            _c(UnsignedLong)
-            _c(Long)
-            #endif
-            /** @todo Half */
-            _c(Float)
-            _c(Double)
-            _c(String)
-            _c(Type)
-            #undef _c
-            case Type::Reference:
-                dataBegin = references.size();
-                std::tie(i, dataSize) = dataArrayList<Type::Reference>(data.suffix(i), *this, references, buffer, subArraySize, error);
-                break;
-            case Type::Custom:
-                CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-        }
+        if(type != Type::Reference && parent != NoParent && std::find(_lazyStructureIdentifiers.begin(), _lazyStructureIdentifiers.end(), _structures[parent].custom.identifier - Int(Type::Custom)) != _lazyStructureIdentifiers.end()) {
+            arrayAppend(_lazyData, InPlaceInit, _structures.size(), i);
+            i = dataListEnd(data.suffix(i), error);
+        } else i = parseDataList(type, subArraySize, data.suffix(i), references, buffer, dataBegin, dataSize, error);
 
         /* Propagate errors */
         if(!i) return {};
 
-        i = Implementation::whitespace(data.suffix(i));
-
-        if(i == data.end() || *i != '}') {
-            error = {Implementation::ParseErrorType::ExpectedListEnd, i};
-            return {};
-        }
-
-        _structures.emplace_back(type, name, subArraySize, dataBegin, dataSize, parent, _structures.size() + 1);
+        arrayAppend(_structures, InPlaceInit, type, name, subArraySize, dataBegin, dataSize, parent, _structures.size() + 1);
         return {i + 1, _structures.size() - 1};
 
     /* Custom structure */
@@ -657,7 +1289,7 @@ std::pair<const char*, std::size_t> Document::parseStructure(const std::size_t p
             std::string s;
             std::tie(i, s) = Implementation::nameLiteral(data.suffix(i), error);
             name = _strings.size();
-            _strings.push_back(std::move(s));
+            arrayAppend(_strings, std::move(s));
 
             i = Implementation::whitespace(data.suffix(i));
         }
@@ -722,8 +1354,11 @@ std::pair<const char*, std::size_t> Document::parseStructure(const std::size_t p
 
         i = Implementation::whitespace(data.suffix(i + 1));
 
+        /* The placeholder has the identifier set already so primitive
+           children can check if their data should be parsed lazily */
         const std::size_t position = _structures.size();
-        _structures.emplace_back();
+        arrayAppend(_structures, InPlaceInit);
+        _structures[position].custom.identifier = Int(Type::Custom) + structureIdentifierId;
 
         /* Substructure */
         i = parseStructureList(position, data.suffix(i), references, buffer, error);
@@ -781,9 +1416,28 @@ const char* Document::parseStructureList(const std::size_t parent, const Contain
     return i;
 }
 
+namespace {
+
+/* Returns given structure or the first structure after it that's custom and
+   has a known identifier, as only those are validated */
+Containers::Optional<Structure> findValidated(Containers::Optional<Structure> it) {
+    while(it && (!it->isCustom() || it->identifier() == UnknownIdentifier))
+        it = it->findNext();
+    return it;
+}
+
+}
+
 bool Document::validate(const Validation::Structures allowedRootStructures, const std::initializer_list<Validation::Structure> structures) const {
-    std::vector<Int> countsBuffer;
-    countsBuffer.reserve(structures.size());
+    const Containers::ArrayView<const Validation::Structure> structureViews{structures.begin(), structures.size()};
+
+    /* A single buffer for counting properties and sub-structures, large
+       enough for any structure in the spec. It's only needed while checking
+       a single structure or level, so it can be shared by all of them. */
+    std::size_t countsSize = allowedRootStructures.size();
+    for(const Validation::Structure& structure: structureViews)
+        countsSize = Utility::max(countsSize, Utility::max(structure.properties().size(), structure.structures().size()));
+    Containers::Array<Int> counts{NoInit, countsSize};
 
     /* Check that there are no primitive structures in root */
     for(const Structure s: children()) if(!s.isCustom()) {
@@ -791,12 +1445,38 @@ bool Document::validate(const Validation::Structures allowedRootStructures, cons
         return false;
     }
 
-    /* Check custom structures */
-    return validateLevel(findFirstChild(), {allowedRootStructures.begin(), allowedRootStructures.size()}, {structures.begin(), structures.size()}, countsBuffer);
+    /* Check custom structures in root */
+    if(!validateLevel(findFirstChild(), {allowedRootStructures.begin(), allowedRootStructures.size()}, counts))
+        return false;
+
+    /* Go through all structures depth-first without recursion, checking each
+       structure and then counts of custom structures in it before descending
+       into them. That's the same order in which the checks would be done by
+       a recursive implementation. Unknown structures are skipped including
+       their children. */
+    Containers::Optional<Structure> it = findValidated(findFirstChild());
+    while(it) {
+        const Structure s = *it;
+
+        auto found = std::find_if(structureViews.begin(), structureViews.end(), [s](const Validation::Structure& v){ return v.identifier() == s.identifier(); });
+        CORRADE_ASSERT(found != structureViews.end(), "OpenDdl::Document::validate(): missing specification for structure" << structureName(s.identifier()), false);
+        if(!validateStructure(s, *found, counts) ||
+           !validateLevel(s.findFirstChild(), found->structures(), counts))
+            return false;
+
+        /* Descend into the first validated child, if there's none, go to the
+           next sibling or the next sibling of the nearest parent that has
+           one. Parents of validated structures are validated as well. */
+        if((it = findValidated(s.findFirstChild()))) continue;
+        for(Containers::Optional<Structure> parent = s; parent; parent = parent->parent())
+            if((it = findValidated(parent->findNext()))) break;
+    }
+
+    return true;
 }
 
-bool Document::validateLevel(const Containers::Optional<Structure>& first, const Containers::ArrayView<const std::pair<Int, std::pair<Int, Int>>> allowedStructures, const Containers::ArrayView<const Validation::Structure> structures, std::vector<Int>& counts) const {
-    counts.assign(allowedStructures.size(), 0);
+bool Document::validateLevel(const Containers::Optional<Structure>& first, const Containers::ArrayView<const std::pair<Int, std::pair<Int, Int>>> allowedStructures, const Containers::ArrayView<Int> counts) const {
+    std::fill_n(counts.begin(), allowedStructures.size(), 0);
 
     /* Count number of custom structures in this level */
     for(Containers::Optional<Structure> it = first; it; it = it->findNext()) {
@@ -834,23 +1514,11 @@ bool Document::validateLevel(const Containers::Optional<Structure>& first, const
         }
     }
 
-    /* Descend into substructures (breadth-first) */
-    for(Containers::Optional<Structure> it = first; it; it = it->findNext()) {
-        const Structure s = *it;
-
-        if(!s.isCustom() || s.identifier() == UnknownIdentifier) continue;
-
-        auto found = std::find_if(structures.begin(), structures.end(), [s](const Validation::Structure& v){ return v.identifier() == s.identifier(); });
-        CORRADE_ASSERT(found != structures.end(), "OpenDdl::Document::validate(): missing specification for structure" << structureName(s.identifier()), false);
-        if(!validateStructure(s, *found, structures, counts))
-            return false;
-    }
-
     return true;
 }
 
-bool Document::validateStructure(const Structure structure, const Validation::Structure& validation, const Containers::ArrayView<const Validation::Structure> structures, std::vector<Int>& counts) const {
-    counts.assign(validation.properties().size(), 0);
+bool Document::validateStructure(const Structure structure, const Validation::Structure& validation, const Containers::ArrayView<Int> counts) const {
+    std::fill_n(counts.begin(), validation.properties().size(), 0);
 
     /* Verify that there is no unexpected property (ignoring unknown ones) */
     for(const Property p: structure.properties()) {
@@ -913,8 +1581,7 @@ bool Document::validateStructure(const Structure structure, const Validation::St
         return false;
     }
 
-    /* Check also custom substructures */
-    return validateLevel(structure.findFirstChild(), validation.structures(), structures, counts);
+    return true;
 }
 
 const char* Document::structureName(const Int identifier) const {
@@ -940,7 +1607,7 @@ Document::StructureData::StructureData(const Int type, const std::size_t name, c
 #endif
 
 Containers::Optional<Structure> Document::findFirstChild() const {
-    return _structures.empty() ? Containers::NullOpt : Containers::optional(Structure{*this, _structures.front()});
+    return _structures.isEmpty() ? Containers::NullOpt : Containers::optional(Structure{*this, _structures.front()});
 }
 
 Structure Document::firstChild() const {
@@ -0,0 +1,173 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstdio>
+#include <string>
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+
+#include "Magnum/OpenDdl/Document.h"
+#include "Magnum/OpenDdl/Structure.h"
+#include "Magnum/OpenDdl/Validation.h"
+
+namespace Magnum { namespace OpenDdl { namespace Test { namespace {
+
+/* Parses synthetic documents that resemble mesh-heavy OpenGEX exports, with
+   large float and index arrays, deep indentation and comments, to measure the
+   literal parsing and whitespace skipping throughput. Validation is measured
+   on a document with many small nested structures, resembling a large scene
+   hierarchy. */
+struct DocumentBenchmark: TestSuite::Tester {
+    explicit DocumentBenchmark();
+
+    void parse();
+    void validate();
+
+    private:
+        std::string _documents[4];
+        std::string _hierarchyDocument;
+};
+
+enum: std::size_t {
+    FloatDocument,
+    IntegerDocument,
+    ExponentDocument,
+    CommentDocument
+};
+
+constexpr std::size_t VertexCount = 100000;
+constexpr std::size_t NodeCount = 20000;
+
+enum: Int {
+    NodeStructure,
+    NameStructure
+};
+
+enum: Int {
+    IdProperty
+};
+
+const struct {
+    const char* name;
+    std::size_t document;
+} ParseData[]{
+    {"float[3] positions", FloatDocument},
+    {"unsigned_int32[3] indices", IntegerDocument},
+    {"float[3] positions with exponents", ExponentDocument},
+    {"float[3] positions with comments and indentation", CommentDocument},
+};
+
+DocumentBenchmark::DocumentBenchmark() {
+    addInstancedBenchmarks({&DocumentBenchmark::parse}, 5,
+        Containers::arraySize(ParseData));
+
+    addBenchmarks({&DocumentBenchmark::validate}, 5);
+
+    char value[128];
+    for(std::size_t document = 0; document != Containers::arraySize(_documents); ++document) {
+        std::string& out = _documents[document];
+        out.reserve(VertexCount*64);
+        out += document == IntegerDocument ?
+            "unsigned_int32[3]\n{\n" :
+            "float[3]\n{\n";
+
+        for(std::size_t i = 0; i != VertexCount; ++i) {
+            if(document == CommentDocument) {
+                if(i % 16 == 0) {
+                    std::snprintf(value, sizeof(value), "\t\t\t\t\t\t// vertex %zu\n", i);
+                    out += value;
+                }
+                out += "\t\t\t\t\t\t";
+            }
+
+            const Float a = Float(i)*0.001f;
+            switch(document) {
+                case FloatDocument:
+                case CommentDocument:
+                    std::snprintf(value, sizeof(value), "{%.6f, %.6f, %.6f}", a, -a*0.5f, a*2.0f);
+                    break;
+                case IntegerDocument:
+                    std::snprintf(value, sizeof(value), "{%zu, %zu, %zu}", i, i + 1, i + 2);
+                    break;
+                case ExponentDocument:
+                    std::snprintf(value, sizeof(value), "{%.7e, %.7e, %.7e}", a, -a*0.5f, a*2.0f);
+                    break;
+            }
+            out += value;
+            out += i + 1 == VertexCount ? "\n" : ",\n";
+        }
+
+        out += "}\n";
+    }
+
+    _hierarchyDocument.reserve(NodeCount*64);
+    for(std::size_t i = 0; i != NodeCount; ++i) {
+        std::snprintf(value, sizeof(value), "Node (id = %zu) {\n\tName { string { \"node\" } }\n\tNode (id = %zu) {}\n}\n", i, i + NodeCount);
+        _hierarchyDocument += value;
+    }
+}
+
+void DocumentBenchmark::parse() {
+    auto&& data = ParseData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string& document = _documents[data.document];
+
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        Document d;
+        CORRADE_VERIFY(d.parse({document.data(), document.size()}, {}, {}));
+        size += d.firstChild().arraySize();
+    }
+
+    CORRADE_COMPARE(size, VertexCount*3);
+}
+
+void DocumentBenchmark::validate() {
+    using namespace Validation;
+
+    Document d;
+    CORRADE_VERIFY(d.parse({_hierarchyDocument.data(), _hierarchyDocument.size()}, {"Node", "Name"}, {"id"}));
+
+    bool valid = true;
+    CORRADE_BENCHMARK(1) {
+        valid = valid && d.validate(
+            Structures{{NodeStructure, {}}},
+            {
+                {NodeStructure,
+                    Properties{{IdProperty, PropertyType::UnsignedInt, RequiredProperty}},
+                    Structures{{NameStructure, {0, 1}},
+                               {NodeStructure, {}}}},
+                {NameStructure,
+                    Primitives{Type::String}, 1, 1}
+            });
+    }
+
+    CORRADE_VERIFY(valid);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::OpenDdl::Test::DocumentBenchmark)
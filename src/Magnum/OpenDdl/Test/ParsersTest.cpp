@@ -67,6 +67,7 @@ struct ParsersTest: TestSuite::Tester {
 
     void floatLiteralInvalid();
     void floatLiteral();
+    void floatLiteralNotExact();
     void floatLiteralBinary();
 
     void stringLiteralInvalid();
@@ -129,6 +130,7 @@ ParsersTest::ParsersTest() {
 
               &ParsersTest::floatLiteralInvalid,
               &ParsersTest::floatLiteral,
+              &ParsersTest::floatLiteralNotExact,
               &ParsersTest::floatLiteralBinary,
 
               &ParsersTest::stringLiteralInvalid,
@@ -203,6 +205,12 @@ void ParsersTest::whitespace() {
     CharacterLiteral c{" \b \t \n  X"};
     auto ci = Implementation::whitespace(c);
     VERIFY_PARSED(Implementation::ParseError{}, c, ci, " \b \t \n  ");
+
+    /* Long runs that are processed several bytes at a time, with the end in
+       the middle of such block */
+    CharacterLiteral d{"\n\t\t\t\t\t\t\t\t\t\t                   X            "};
+    auto di = Implementation::whitespace(d);
+    VERIFY_PARSED(Implementation::ParseError{}, d, di, "\n\t\t\t\t\t\t\t\t\t\t                   ");
 }
 
 void ParsersTest::onelineComment() {
@@ -213,6 +221,11 @@ void ParsersTest::onelineComment() {
     CharacterLiteral b{" \b \t // comment /* other comment \n*/ \nX"};
     auto bi = Implementation::whitespace(b);
     VERIFY_PARSED(Implementation::ParseError{}, b, bi, " \b \t // comment /* other comment \n");
+
+    /* Unterminated comment consumes everything */
+    CharacterLiteral c{" // comment"};
+    auto ci = Implementation::whitespace(c);
+    VERIFY_PARSED(Implementation::ParseError{}, c, ci, " // comment");
 }
 
 void ParsersTest::multilineComment() {
@@ -223,6 +236,16 @@ void ParsersTest::multilineComment() {
     CharacterLiteral b{" \b \t /* comment \n // bla \n comment */X"};
     auto bi = Implementation::whitespace(b);
     VERIFY_PARSED(Implementation::ParseError{}, b, bi, " \b \t /* comment \n // bla \n comment */");
+
+    /* Stray asterisks inside */
+    CharacterLiteral c{"/* * comment **/X"};
+    auto ci = Implementation::whitespace(c);
+    VERIFY_PARSED(Implementation::ParseError{}, c, ci, "/* * comment **/");
+
+    /* Unterminated comment consumes everything */
+    CharacterLiteral d{" /* comment *"};
+    auto di = Implementation::whitespace(d);
+    VERIFY_PARSED(Implementation::ParseError{}, d, di, " /* comment *");
 }
 
 void ParsersTest::escapedCharInvalid() {
@@ -394,6 +417,18 @@ void ParsersTest::integerLiteralInvalid() {
 
     CORRADE_VERIFY(!std::get<0>(Implementation::integralLiteral<UnsignedShort>(CharacterLiteral{"-1"}, buffer, error)));
     CORRADE_COMPARE(error.error, Implementation::ParseErrorType::LiteralOutOfRange);
+
+    /* Overflowing even the widest type */
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    CORRADE_VERIFY(!std::get<0>(Implementation::integralLiteral<UnsignedLong>(CharacterLiteral{"18446744073709551616"}, buffer, error)));
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::LiteralOutOfRange);
+
+    CORRADE_VERIFY(!std::get<0>(Implementation::integralLiteral<UnsignedLong>(CharacterLiteral{"0x1_0000_0000_0000_0000"}, buffer, error)));
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::LiteralOutOfRange);
+    #else
+    CORRADE_VERIFY(!std::get<0>(Implementation::integralLiteral<UnsignedInt>(CharacterLiteral{"4294967296"}, buffer, error)));
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::LiteralOutOfRange);
+    #endif
 }
 
 void ParsersTest::integerLiteral() {
@@ -473,6 +508,40 @@ void ParsersTest::floatLiteral() {
     CORRADE_COMPARE(value, -1.0e+5);
 }
 
+void ParsersTest::floatLiteralNotExact() {
+    /* These can't be calculated exactly from the significand and exponent
+       and thus go through strtof() / strtod() */
+    Implementation::ParseError error;
+    std::string buffer;
+    const char* i;
+    Float floatValue;
+    Double doubleValue;
+
+    /* Too many significant digits */
+    CharacterLiteral a{"3.141_592_653_589_793_238X"};
+    std::tie(i, doubleValue) = Implementation::floatingPointLiteral<Double>(a, buffer, error);
+    VERIFY_PARSED(error, a, i, "3.141_592_653_589_793_238");
+    CORRADE_COMPARE(doubleValue, 3.141592653589793238);
+
+    /* Exponent out of the exact range */
+    CharacterLiteral b{"-1.5e30X"};
+    std::tie(i, floatValue) = Implementation::floatingPointLiteral<Float>(b, buffer, error);
+    VERIFY_PARSED(error, b, i, "-1.5e30");
+    CORRADE_COMPARE(floatValue, -1.5e30f);
+
+    CharacterLiteral c{"2.5e-1_5X"};
+    std::tie(i, doubleValue) = Implementation::floatingPointLiteral<Double>(c, buffer, error);
+    VERIFY_PARSED(error, c, i, "2.5e-1_5");
+    CORRADE_COMPARE(doubleValue, 2.5e-15);
+
+    /* Too long to fit into the stack buffer */
+    std::string d = "1." + std::string(150, '0') + "5X";
+    std::tie(i, floatValue) = Implementation::floatingPointLiteral<Float>({d.data(), d.size()}, buffer, error);
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::NoError);
+    CORRADE_COMPARE(i, d.data() + d.size() - 1);
+    CORRADE_COMPARE(floatValue, 1.0f);
+}
+
 void ParsersTest::floatLiteralBinary() {
     CharacterLiteral a{"-0xbad_cafe_X"};
 
@@ -26,7 +26,9 @@
 #include <sstream>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Format.h>
 
 #include "Magnum/OpenDdl/Document.h"
 #include "Magnum/OpenDdl/Property.h"
@@ -45,6 +47,7 @@ struct Test: TestSuite::Tester {
     void primitiveExpectedListEnd();
     void primitiveExpectedSeparator();
     void primitiveExpectedNext();
+    void primitiveMultiple();
 
     void primitiveSubArray();
     void primitiveSubArrayEmpty();
@@ -94,6 +97,7 @@ struct Test: TestSuite::Tester {
     void validateTooManyStructures();
     void validateTooLittleStructures();
     void validateUnknownStructure();
+    void validateNested();
 
     void validateExpectedProperty();
     void validateUnexpectedProperty();
@@ -105,6 +109,24 @@ struct Test: TestSuite::Tester {
     void referenceNull();
     void referenceChain();
     void referenceInvalid();
+
+    void parseParallel();
+    void parseParallelError();
+
+    void lazyData();
+    void lazyDataParseError();
+
+    void serialize();
+    void serializeUnaligned();
+    void deserializeInvalid();
+};
+
+const struct {
+    const char* name;
+    UnsignedInt threadCount;
+} LazyDataData[]{
+    {"", 1},
+    {"multithreaded", 4},
 };
 
 Test::Test() {
@@ -115,6 +137,7 @@ Test::Test() {
               &Test::primitiveExpectedListEnd,
               &Test::primitiveExpectedSeparator,
               &Test::primitiveExpectedNext,
+              &Test::primitiveMultiple,
 
               &Test::primitiveSubArray,
               &Test::primitiveSubArrayEmpty,
@@ -164,6 +187,7 @@ Test::Test() {
               &Test::validateTooManyStructures,
               &Test::validateTooLittleStructures,
               &Test::validateUnknownStructure,
+              &Test::validateNested,
 
               &Test::validateExpectedProperty,
               &Test::validateUnexpectedProperty,
@@ -174,7 +198,19 @@ Test::Test() {
               &Test::referenceInProperty,
               &Test::referenceNull,
               &Test::referenceChain,
-              &Test::referenceInvalid});
+              &Test::referenceInvalid,
+
+              &Test::parseParallel,
+              &Test::parseParallelError});
+
+    addInstancedTests({&Test::lazyData},
+        Containers::arraySize(LazyDataData));
+
+    addTests({&Test::lazyDataParseError,
+
+              &Test::serialize,
+              &Test::serializeUnaligned,
+              &Test::deserializeInvalid});
 }
 
 void Test::primitive() {
@@ -249,6 +285,49 @@ void Test::primitiveExpectedNext() {
     CORRADE_COMPARE(out.str(), "OpenDdl::Document::parse(): expected float literal on line 1\n");
 }
 
+void Test::primitiveMultiple() {
+    /* The data lists are reserved upfront based on a scan for separators,
+       comments containing them shouldn't cause any problems */
+    Document d;
+    CORRADE_VERIFY(d.parse(CharacterLiteral{
+        "float { 1.0, 2.0 }\n"
+        "bool { true, false, true }\n"
+        "float[2] { {3.0, 4.0}, /* }, { */ {5.0, 6.0} }\n"
+        "float { 7.0 // , , , } }\n"
+        ", 8.0 }\n"
+        "bool { false }"}, {}, {}));
+
+    Structure a = d.firstChild();
+    CORRADE_COMPARE(a.type(), Type::Float);
+    CORRADE_COMPARE_AS(a.asArray<Float>(),
+        (Containers::Array<Float>{InPlaceInit, {1.0f, 2.0f}}),
+        TestSuite::Compare::Container);
+
+    Structure b = *a.findNext();
+    CORRADE_COMPARE(b.type(), Type::Bool);
+    CORRADE_COMPARE_AS(b.asArray<bool>(),
+        (Containers::Array<bool>{InPlaceInit, {true, false, true}}),
+        TestSuite::Compare::Container);
+
+    Structure c = *b.findNext();
+    CORRADE_COMPARE(c.type(), Type::Float);
+    CORRADE_COMPARE(c.subArraySize(), 2);
+    CORRADE_COMPARE_AS(c.asArray<Float>(),
+        (Containers::Array<Float>{InPlaceInit, {3.0f, 4.0f, 5.0f, 6.0f}}),
+        TestSuite::Compare::Container);
+
+    Structure e = *c.findNext();
+    CORRADE_COMPARE(e.type(), Type::Float);
+    CORRADE_COMPARE_AS(e.asArray<Float>(),
+        (Containers::Array<Float>{InPlaceInit, {7.0f, 8.0f}}),
+        TestSuite::Compare::Container);
+
+    Structure f = *e.findNext();
+    CORRADE_COMPARE(f.type(), Type::Bool);
+    CORRADE_COMPARE(f.as<bool>(), false);
+    CORRADE_VERIFY(!f.findNext());
+}
+
 void Test::primitiveSubArray() {
     Document d;
     CORRADE_VERIFY(d.parse(CharacterLiteral{"unsigned_int8[2] { {0xca, 0xfe}, {0xba, 0xbe} }"}, {}, {}));
@@ -1011,6 +1090,68 @@ Unknown { Root { int32 {} } }
         }));
 }
 
+void Test::validateNested() {
+    using namespace Validation;
+
+    Document d;
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = CharacterLiteral{
+R"oddl(
+Hierarchic (boolean = true) {
+    Hierarchic (boolean = true) {
+        Hierarchic (boolean = true) {
+            Hierarchic (boolean = true) {}
+        }
+        Unknown { Hierarchic {} }
+    }
+    Hierarchic (boolean = true) {}
+}
+
+Hierarchic (boolean = true) {
+    Hierarchic (boolean = true) {}
+    Hierarchic {}
+}
+    )oddl"};
+    CORRADE_VERIFY(d.parse(s, structureIdentifiers, propertyIdentifiers));
+
+    /* The traversal has to correctly get back from the deepest structures to
+       reach the last one, skipping the unknown one including its children */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!d.validate(
+        Structures{{HierarchicStructure, {}}},
+        {
+            {HierarchicStructure,
+                 Properties{{BooleanProperty, PropertyType::Bool, RequiredProperty}},
+                 Structures{{HierarchicStructure, {}}}}
+        }));
+    CORRADE_COMPARE(out.str(), "OpenDdl::Document::validate(): expected property boolean in structure Hierarchic\n");
+
+    /* The document is valid if the last structure has the property */
+    Document d2;
+    auto s2 = CharacterLiteral{
+R"oddl(
+Hierarchic (boolean = true) {
+    Hierarchic (boolean = true) {
+        Hierarchic (boolean = true) {
+            Hierarchic (boolean = true) {}
+        }
+        Unknown { Hierarchic {} }
+    }
+}
+
+Hierarchic (boolean = true) {}
+    )oddl"};
+    CORRADE_VERIFY(d2.parse(s2, structureIdentifiers, propertyIdentifiers));
+    CORRADE_VERIFY(d2.validate(
+        Structures{{HierarchicStructure, {}}},
+        {
+            {HierarchicStructure,
+                 Properties{{BooleanProperty, PropertyType::Bool, RequiredProperty}},
+                 Structures{{HierarchicStructure, {}}}}
+        }));
+}
+
 void Test::validateExpectedProperty() {
     using namespace Validation;
 
@@ -1271,6 +1412,263 @@ Root %root {
         "OpenDdl::Document::parse(): reference %local1%local2 was not found\n");
 }
 
+void Test::parseParallel() {
+    /* Braces in comments and literals shouldn't affect the split, references
+       across the split boundaries should get resolved */
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = CharacterLiteral{
+R"oddl(
+float %a { 1.0, 2.0 }
+Root %root (some = "hello", reference = %b) {
+    string { "a}b", "{\"}" }
+    Hierarchic %child (boolean = true, some = '}') {}
+}
+/* an unmatched { brace */
+ref { %root%child, $c, %a, null }
+bool %b { true } // and another }
+Hierarchic $c (reference = %root) { int8 { '{' } }
+    )oddl"};
+
+    Document serial;
+    CORRADE_VERIFY(serial.parse(s, structureIdentifiers, propertyIdentifiers));
+
+    Document d;
+    CORRADE_VERIFY(d.parse(s, structureIdentifiers, propertyIdentifiers, 4));
+
+    std::vector<std::string> serialNames, names;
+    for(Structure structure: serial.children()) serialNames.push_back(structure.name());
+    for(Structure structure: d.children()) names.push_back(structure.name());
+    CORRADE_COMPARE_AS(names, serialNames, TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(names, (std::vector<std::string>{
+        "%a", "%root", "", "%b", "$c"
+    }), TestSuite::Compare::Container);
+
+    Structure a = d.firstChild();
+    CORRADE_COMPARE_AS(a.asArray<Float>(),
+        (Containers::Array<Float>{InPlaceInit, {1.0f, 2.0f}}),
+        TestSuite::Compare::Container);
+
+    Structure root = d.firstChildOf(RootStructure);
+    CORRADE_COMPARE(root.propertyOf(SomeProperty).as<std::string>(), "hello");
+    Containers::Optional<Structure> b = root.propertyOf(ReferenceProperty).asReference();
+    CORRADE_VERIFY(b);
+    CORRADE_COMPARE(b->name(), "%b");
+    CORRADE_COMPARE(b->as<bool>(), true);
+    CORRADE_COMPARE_AS(root.firstChildOf(Type::String).asArray<std::string>(),
+        (Containers::Array<std::string>{InPlaceInit, {"a}b", "{\"}"}}),
+        TestSuite::Compare::Container);
+
+    Structure child = root.firstChildOf(HierarchicStructure);
+    CORRADE_COMPARE(child.name(), "%child");
+    CORRADE_VERIFY(child.parent());
+    CORRADE_COMPARE(child.parent()->name(), "%root");
+    CORRADE_COMPARE(child.propertyOf(BooleanProperty).as<bool>(), true);
+    CORRADE_COMPARE(child.propertyOf(SomeProperty).as<Int>(), '}');
+    CORRADE_VERIFY(!child.findNext());
+
+    Containers::Array<Containers::Optional<Structure>> references =
+        d.firstChildOf(Type::Reference).asReferenceArray();
+    CORRADE_COMPARE(references.size(), 4);
+    CORRADE_VERIFY(references[0]);
+    CORRADE_VERIFY(*references[0] == child);
+    CORRADE_VERIFY(references[1]);
+    CORRADE_COMPARE(references[1]->name(), "$c");
+    CORRADE_VERIFY(references[2]);
+    CORRADE_VERIFY(*references[2] == a);
+    CORRADE_VERIFY(!references[3]);
+
+    Structure c = *references[1];
+    CORRADE_VERIFY(!c.parent());
+    Containers::Optional<Structure> cRoot = c.propertyOf(ReferenceProperty).asReference();
+    CORRADE_VERIFY(cRoot);
+    CORRADE_VERIFY(*cRoot == root);
+    CORRADE_COMPARE(c.firstChild().as<Byte>(), '{');
+    CORRADE_VERIFY(!c.findNext());
+}
+
+void Test::parseParallelError() {
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = CharacterLiteral{
+R"oddl(
+Root { float { 1.0 } }
+Root { float { 2.0 } }
+
+Root { float { 3.0 ; } }
+Root { float { 4.0 } }
+    )oddl"};
+
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        Document serial;
+        CORRADE_VERIFY(!serial.parse(s, structureIdentifiers, propertyIdentifiers));
+        Document d;
+        CORRADE_VERIFY(!d.parse(s, structureIdentifiers, propertyIdentifiers, 4));
+    }
+    /* The error is the same as when parsing serially, including the line */
+    CORRADE_COMPARE(out.str(),
+        "OpenDdl::Document::parse(): expected , character on line 5\n"
+        "OpenDdl::Document::parse(): expected , character on line 5\n");
+}
+
+void Test::lazyData() {
+    auto&& data = LazyDataData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = CharacterLiteral{
+R"oddl(
+Root %a {
+    float[2] { {1.0, 2.0}, /* } */ {3.0, 4.0} }
+    string { "}" }
+    ref { %b }
+    Hierarchic { int32 { 5 } }
+}
+Hierarchic %b { float { 6.0 } }
+Root { int16 { 7, 8 } }
+    )oddl"};
+
+    Document d;
+    d.setLazyStructures({RootStructure});
+    CORRADE_VERIFY(d.parse(s, structureIdentifiers, propertyIdentifiers, data.threadCount));
+
+    /* Data lists directly in Root aren't parsed yet, except for references.
+       Nested structures and other structures are parsed. */
+    Structure a = d.firstChildOf(RootStructure);
+    Structure floats = a.firstChildOf(Type::Float);
+    CORRADE_COMPARE(floats.subArraySize(), 2);
+    CORRADE_COMPARE(floats.arraySize(), 0);
+    Structure strings = a.firstChildOf(Type::String);
+    CORRADE_COMPARE(strings.arraySize(), 0);
+    Containers::Optional<Structure> b = a.firstChildOf(Type::Reference).asReference();
+    CORRADE_VERIFY(b);
+    CORRADE_COMPARE(b->name(), "%b");
+    CORRADE_COMPARE(b->firstChild().as<Float>(), 6.0f);
+    CORRADE_COMPARE(a.firstChildOf(HierarchicStructure).firstChild().as<Int>(), 5);
+    Structure shorts = a.findNextOf(RootStructure)->firstChild();
+    CORRADE_COMPARE(shorts.arraySize(), 0);
+
+    /* Parsing just the first structure */
+    CORRADE_VERIFY(d.parseLazyData(a));
+    CORRADE_COMPARE_AS(floats.asArray<Float>(),
+        (Containers::Array<Float>{InPlaceInit, {1.0f, 2.0f, 3.0f, 4.0f}}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(strings.as<std::string>(), "}");
+    CORRADE_COMPARE(shorts.arraySize(), 0);
+
+    /* Parsing the rest */
+    CORRADE_VERIFY(d.parseLazyData());
+    CORRADE_COMPARE_AS(shorts.asArray<Short>(),
+        (Containers::Array<Short>{InPlaceInit, {7, 8}}),
+        TestSuite::Compare::Container);
+
+    /* Nothing left to parse */
+    CORRADE_VERIFY(d.parseLazyData());
+    CORRADE_COMPARE(floats.arraySize(), 4);
+}
+
+void Test::lazyDataParseError() {
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    /* The errors inside the data list are found only when parsing it */
+    Document d1;
+    d1.setLazyStructures({RootStructure});
+    CORRADE_VERIFY(d1.parse(CharacterLiteral{"Root {\n float { 1.0 2.0 } }"}, structureIdentifiers, {}));
+    CORRADE_VERIFY(!d1.parseLazyData());
+
+    /* An unterminated data list is found right away */
+    Document d2;
+    d2.setLazyStructures({RootStructure});
+    CORRADE_VERIFY(!d2.parse(CharacterLiteral{"Root { float { 1.0, /* } */"}, structureIdentifiers, {}));
+
+    CORRADE_COMPARE(out.str(),
+        "OpenDdl::Document::parseLazyData(): expected , character on line 2\n"
+        "OpenDdl::Document::parse(): expected } character on line 1\n");
+}
+
+void Test::serialize() {
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = CharacterLiteral{
+R"oddl(
+Root %a (some = "hello") {
+    float[2] { {1.0, 2.0}, {3.0, 4.0} }
+    string { "yes", "no" }
+    ref { %b }
+}
+Hierarchic %b { int32 { 5 } }
+    )oddl"};
+
+    Document d;
+    CORRADE_VERIFY(d.parse(s, structureIdentifiers, propertyIdentifiers));
+
+    Containers::Array<char> blob = d.serialize();
+    CORRADE_COMPARE(blob.size() % 8, 0);
+
+    Document out;
+    CORRADE_VERIFY(out.deserialize(blob, structureIdentifiers, propertyIdentifiers));
+
+    Structure a = out.firstChildOf(RootStructure);
+    CORRADE_COMPARE(a.name(), "%a");
+    CORRADE_COMPARE(a.propertyOf(SomeProperty).as<std::string>(), "hello");
+    Structure floats = a.firstChildOf(Type::Float);
+    CORRADE_COMPARE(floats.subArraySize(), 2);
+    CORRADE_COMPARE_AS(floats.asArray<Float>(),
+        (Containers::Array<Float>{InPlaceInit, {1.0f, 2.0f, 3.0f, 4.0f}}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(a.firstChildOf(Type::String).asArray<std::string>()[1], "no");
+    Containers::Optional<Structure> b = a.firstChildOf(Type::Reference).asReference();
+    CORRADE_VERIFY(b);
+    CORRADE_COMPARE(b->name(), "%b");
+    CORRADE_COMPARE(b->firstChild().as<Int>(), 5);
+
+    /* The blob is aligned, so the data are referenced directly */
+    CORRADE_VERIFY(floats.asArray<Float>().data() >= reinterpret_cast<const void*>(blob.begin()));
+    CORRADE_VERIFY(floats.asArray<Float>().data() < reinterpret_cast<const void*>(blob.end()));
+}
+
+void Test::serializeUnaligned() {
+    Document d;
+    CORRADE_VERIFY(d.parse(CharacterLiteral{"Root { float { 1.0, 2.0 } }"}, structureIdentifiers, propertyIdentifiers));
+
+    Containers::Array<char> blob = d.serialize();
+    Containers::Array<char> unaligned{NoInit, blob.size() + 1};
+    Utility::copy(blob, unaligned.exceptPrefix(1));
+
+    /* The data get copied if not aligned */
+    Document out;
+    CORRADE_VERIFY(out.deserialize(unaligned.exceptPrefix(1), structureIdentifiers, propertyIdentifiers));
+    Structure floats = out.firstChildOf(RootStructure).firstChild();
+    CORRADE_COMPARE_AS(floats.asArray<Float>(),
+        (Containers::Array<Float>{InPlaceInit, {1.0f, 2.0f}}),
+        TestSuite::Compare::Container);
+    CORRADE_VERIFY(floats.asArray<Float>().data() < reinterpret_cast<const void*>(unaligned.begin()) || floats.asArray<Float>().data() >= reinterpret_cast<const void*>(unaligned.end()));
+}
+
+void Test::deserializeInvalid() {
+    Document d;
+    CORRADE_VERIFY(d.parse(CharacterLiteral{"Root { float { 1.0 } }"}, structureIdentifiers, propertyIdentifiers));
+    Containers::Array<char> blob = d.serialize();
+
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    Document d1, d2, d3, d4;
+    CORRADE_VERIFY(!d1.deserialize(blob.prefix(12), structureIdentifiers, propertyIdentifiers));
+    CORRADE_VERIFY(!d2.deserialize(blob.exceptSuffix(8), structureIdentifiers, propertyIdentifiers));
+    CORRADE_VERIFY(!d3.deserialize(blob, {"Some", "Root"}, propertyIdentifiers));
+
+    blob[0] = 'X';
+    CORRADE_VERIFY(!d4.deserialize(blob, structureIdentifiers, propertyIdentifiers));
+
+    CORRADE_COMPARE(out.str(), Utility::formatString(
+        "OpenDdl::Document::deserialize(): expected at least 168 bytes but got 12\n"
+        "OpenDdl::Document::deserialize(): expected {} bytes but got {}\n"
+        "OpenDdl::Document::deserialize(): structure or property identifiers don't match\n"
+        "OpenDdl::Document::deserialize(): invalid or incompatible header\n",
+        blob.size(), blob.size() - 8));
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::OpenDdl::Test::Test)
@@ -31,6 +31,9 @@
 
 #include <cctype>
 #include <unordered_map>
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <thread>
+#endif
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayTuple.h>
 #include <Corrade/Containers/ArrayView.h>
@@ -53,6 +56,10 @@
 #include <Magnum/Math/Matrix4.h>
 #include <Magnum/Math/Quaternion.h>
 #include <Magnum/Math/Vector.h>
+#include <Magnum/MeshTools/Duplicate.h>
+#include <Magnum/MeshTools/GenerateNormals.h>
+#include <Magnum/MeshTools/Interleave.h>
+#include <Magnum/MeshTools/RemoveDuplicates.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/PixelStorage.h>
 #include <Magnum/Trade/AnimationData.h>
@@ -67,6 +74,9 @@
 #include <Magnum/Trade/TextureData.h>
 #include <MagnumPlugins/AnyImageImporter/AnyImageImporter.h>
 
+#include "Magnum/Implementation/imageImporterPool.h"
+#include "Magnum/Implementation/instrumentation.h"
+
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/Importer.hpp>
 #include <assimp/importerdesc.h>
@@ -124,6 +134,9 @@ using namespace Containers::Literals;
 struct AssimpImporter::File {
     Containers::Optional<Containers::String> filePath;
     UnsignedInt assimpVersion = 0;
+    /* aiProcess_* steps that were not applied when opening the file and are
+       instead applied to each mesh in doMesh() */
+    UnsignedInt lazyPostprocessFlags = 0;
     bool importerIsGltf = false;
     const aiScene* scene = nullptr;
     /* Index -> pointer, pointer -> index conversion for nodes as they're
@@ -163,8 +176,33 @@ struct AssimpImporter::File {
 
     UnsignedInt imageImporterId = ~UnsignedInt{};
     Containers::Optional<AnyImageImporter> imageImporter;
+    /* Set if the image importer was opened from a file and the
+       imageImporterPoolSize option was non-zero at that point, in which case
+       it's put back into the shared pool once replaced */
+    Containers::String imageImporterFilename;
 
     Matrix4 rootTransformation;
+
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    /* Embedded images decoded in the background if the decodeEmbeddedImages
+       option is enabled. The threads have to be joined before decodedImages
+       is accessed. Each entry is either empty, in which case the image is
+       imported on demand, or contains all its levels, which are moved out on
+       first access. */
+    Containers::Array<std::thread> imageDecodeThreads;
+    /* Image ID and an importer with the image data opened */
+    Containers::Array<Containers::Pair<UnsignedInt, Containers::Pointer<AbstractImporter>>> imageDecodeJobs;
+    Containers::Array<Containers::Array<Containers::Optional<ImageData2D>>> decodedImages;
+
+    ~File() { joinImageDecodeThreads(); }
+
+    void joinImageDecodeThreads() {
+        for(std::thread& thread: imageDecodeThreads)
+            thread.join();
+        imageDecodeThreads = {};
+        imageDecodeJobs = {};
+    }
+    #endif
 };
 
 namespace {
@@ -190,6 +228,12 @@ void fillDefaultConfiguration(Utility::ConfigurationGroup& conf) {
     conf.setValue("ImportColladaIgnoreUpDirection", false);
     conf.setValue("ignoreUnrecognizedMaterialData", false);
     conf.setValue("forceRawMaterialData", false);
+    conf.setValue("decodeEmbeddedImages", false);
+    conf.setValue("threads", 1);
+    conf.setValue("mapFiles", false);
+    conf.setValue("interleaveMeshes", true);
+    conf.setValue("lazyPostprocess", false);
+    conf.setValue("removeComponents", "");
 
     Utility::ConfigurationGroup& postprocess = *conf.addGroup("postprocess");
     postprocess.setValue("JoinIdenticalVertices", true);
@@ -239,11 +283,16 @@ AssimpImporter::AssimpImporter() {
 AssimpImporter::AssimpImporter(PluginManager::Manager<AbstractImporter>& manager): AbstractImporter(manager) {
     /** @todo horrible workaround, fix this properly */
     fillDefaultConfiguration(configuration());
+    Magnum::Implementation::imageImporterPool().addUser(this->manager());
 }
 
-AssimpImporter::AssimpImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter(manager, plugin) {}
+AssimpImporter::AssimpImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter(manager, plugin) {
+    Magnum::Implementation::imageImporterPool().addUser(this->manager());
+}
 
 AssimpImporter::~AssimpImporter() {
+    Magnum::Implementation::imageImporterPool().removeUser(manager());
+
     /* Because we are dealing with a crappy singleton here, we need to make
        sure to clean up everything that might have been set earlier */
     /** @todo wait how does this work with multiple simultaenous instances?! */
@@ -314,19 +363,77 @@ struct IoSystem: Assimp::IOSystem {
         #ifdef CORRADE_NO_ASSERT
         static_cast<void>(mode);
         #endif
+
+        /* Assimp opens the same file several times during a single import,
+           for example first to check the file header and then again to parse
+           it. Reuse the data if the file is still loaded. */
+        const auto found = _files.find(file);
+        if(found != _files.end()) {
+            ++found->second.second();
+            return new IoStream{file, found->second.first()};
+        }
+
         const Containers::Optional<Containers::ArrayView<const char>> data = _callback(file, InputFileCallbackPolicy::LoadTemporary, _userData);
         if(!data) return {};
+        _files.emplace(file, Containers::pair(*data, 1u));
         return new IoStream{file, *data};
     }
 
     void Close(Assimp::IOStream* file) override {
-        _callback(static_cast<IoStream*>(file)->filename, InputFileCallbackPolicy::Close, _userData);
+        const auto found = _files.find(static_cast<IoStream*>(file)->filename);
+        if(found != _files.end() && !--found->second.second() && !_retain) {
+            _callback(found->first, InputFileCallbackPolicy::Close, _userData);
+            _files.erase(found);
+        }
         delete file;
     }
 
+    /* Called around ReadFile(), keeps all files loaded until the import is
+       done so repeated opens of the same file don't load it again. On
+       release, all files are closed, including ones for which Assimp deleted
+       the stream directly without calling Close(). */
+    void retain() { _retain = true; }
+    void release() {
+        _retain = false;
+        for(const auto& file: _files)
+            _callback(file.first, InputFileCallbackPolicy::Close, _userData);
+        _files.clear();
+    }
+
     Containers::Optional<Containers::ArrayView<const char>>(*_callback)(const std::string&, InputFileCallbackPolicy, void*);
     void* _userData;
+
+    private:
+        std::unordered_map<std::string, Containers::Pair<Containers::ArrayView<const char>, UnsignedInt>> _files;
+        bool _retain = false;
+};
+
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+/* Used for files opened from the filesystem if the mapFiles option is
+   enabled and no file callback is set */
+struct MappedIoSystem: IoSystem {
+    explicit MappedIoSystem(): IoSystem{callback, &_mapped} {}
+
+    bool Exists(const char* file) const override {
+        return Utility::Path::exists(file);
+    }
+
+    private:
+        static Containers::Optional<Containers::ArrayView<const char>> callback(const std::string& filename, InputFileCallbackPolicy policy, void* userData) {
+            auto& mapped = *static_cast<std::unordered_map<std::string, Containers::Array<const char, Utility::Path::MapDeleter>>*>(userData);
+            if(policy == InputFileCallbackPolicy::Close) {
+                mapped.erase(filename);
+                return {};
+            }
+
+            Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> data = Utility::Path::mapRead(filename);
+            if(!data) return {};
+            return Containers::ArrayView<const char>{mapped.emplace(filename, *Utility::move(data)).first->second};
+        }
+
+        std::unordered_map<std::string, Containers::Array<const char, Utility::Path::MapDeleter>> _mapped;
 };
+#endif
 
 }
 
@@ -402,6 +509,70 @@ UnsignedInt flagsFromConfiguration(Utility::ConfigurationGroup& conf) {
     return flags;
 }
 
+/* Postprocess steps that affect only individual meshes and can be done by
+   MeshTools on import instead. Everything else, such as SortByPType or
+   PreTransformVertices, changes the scene structure and has to be done by
+   Assimp upfront. */
+constexpr UnsignedInt LazyPostprocessFlags = aiProcess_JoinIdenticalVertices|aiProcess_Triangulate|aiProcess_GenNormals|aiProcess_GenSmoothNormals;
+
+UnsignedInt flagsFromConfiguration(Utility::ConfigurationGroup& conf, UnsignedInt& lazyFlags, const UnsignedInt removeComponents) {
+    UnsignedInt flags = flagsFromConfiguration(conf);
+    if(removeComponents)
+        flags |= aiProcess_RemoveComponent;
+    lazyFlags = conf.value<bool>("lazyPostprocess") ? flags & LazyPostprocessFlags : 0;
+    return flags & ~lazyFlags;
+}
+
+/* Translates the removeComponents option to aiComponent bits for
+   AI_CONFIG_PP_RVC_FLAGS. Colors and texture coordinates can be removed
+   either all or by set index, the index limits are given by how many bits
+   are left for aiComponent_COLORSn() and aiComponent_TEXCOORDSn(). */
+Containers::Optional<UnsignedInt> removeComponentsFromConfiguration(Utility::ConfigurationGroup& conf, const char* const messagePrefix) {
+    const struct {
+        Containers::StringView name;
+        UnsignedInt component;
+    } components[]{
+        {"normals"_s, aiComponent_NORMALS},
+        {"tangents"_s, aiComponent_TANGENTS_AND_BITANGENTS},
+        {"colors"_s, aiComponent_COLORS},
+        {"textureCoordinates"_s, aiComponent_TEXCOORDS},
+        {"jointWeights"_s, aiComponent_BONEWEIGHTS},
+        {"animations"_s, aiComponent_ANIMATIONS},
+        {"textures"_s, aiComponent_TEXTURES},
+        {"lights"_s, aiComponent_LIGHTS},
+        {"cameras"_s, aiComponent_CAMERAS},
+        {"materials"_s, aiComponent_MATERIALS},
+    };
+
+    UnsignedInt out = 0;
+    for(const Containers::StringView entry: conf.value<Containers::StringView>("removeComponents").splitOnWhitespaceWithoutEmptyParts()) {
+        bool found = false;
+        for(const auto& component: components) {
+            if(entry == component.name) {
+                out |= component.component;
+                found = true;
+                break;
+            }
+        }
+        if(found) continue;
+
+        /* Indexed color and texture coordinate sets, a single digit */
+        const Containers::StringView digit = entry.exceptPrefix(entry.hasPrefix("colors"_s) ? 6 : entry.hasPrefix("textureCoordinates"_s) ? 18 : 0);
+        const UnsignedInt index = digit.size() == 1 && std::isdigit(static_cast<unsigned char>(digit[0])) ? digit[0] - '0' : ~UnsignedInt{};
+
+        if(entry.hasPrefix("colors"_s) && index < 5) {
+            out |= aiComponent_COLORSn(index);
+        } else if(entry.hasPrefix("textureCoordinates"_s) && index < 7) {
+            out |= aiComponent_TEXCOORDSn(index);
+        } else {
+            Error{} << messagePrefix << "invalid removeComponents entry" << entry;
+            return {};
+        }
+    }
+
+    return out;
+}
+
 /* Assimp doesn't implement any getters directly on a material property (only a
    lookup via key on aiMaterial), so here's a copy of aiGetMaterialString()
    internals: https://github.com/assimp/assimp/blob/e845988c22d449b3fe45c1e96d51ae2fa6b59979/code/Material/MaterialSystem.cpp#L299-L306 */
@@ -419,15 +590,24 @@ Containers::StringView materialPropertyString(const aiMaterialProperty& property
 }
 
 void AssimpImporter::doOpenData(Containers::Array<char>&& data, DataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     /* If we already have the file, we got delegated from doOpenFile() or
        doOpenState(). If we got called from doOpenState(), we don't even have
        the _importer. No need to create it. */
     if(!_f) {
+        const Containers::Optional<UnsignedInt> removeComponents = removeComponentsFromConfiguration(configuration(), "Trade::AssimpImporter::openData():");
+        if(!removeComponents) return;
+
         if(!_importer) _importer = createImporter(configuration());
+        _importer->SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, *removeComponents);
 
         _f.reset(new File);
         /* File callbacks are set up in doSetFileCallbacks() */
-        if(!(_f->scene = _importer->ReadFileFromMemory(data.data(), data.size(), flagsFromConfiguration(configuration())))) {
+        IoSystem* const ioSystem = _ourFileCallback && _importer->GetIOHandler() == _ourFileCallback ? static_cast<IoSystem*>(_ourFileCallback) : nullptr;
+        if(ioSystem) ioSystem->retain();
+        _f->scene = _importer->ReadFileFromMemory(data.data(), data.size(), flagsFromConfiguration(configuration(), _f->lazyPostprocessFlags, *removeComponents));
+        if(ioSystem) ioSystem->release();
+        if(!_f->scene) {
             Error{} << "Trade::AssimpImporter::openData(): loading failed:" << _importer->GetErrorString();
             return;
         }
@@ -620,6 +800,11 @@ void AssimpImporter::doOpenData(Containers::Array<char>&& data, DataFlags) {
             }
         }
     }
+
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    if(manager() && configuration().value<bool>("decodeEmbeddedImages"))
+        startEmbeddedImageDecoding();
+    #endif
 }
 
 void AssimpImporter::doOpenState(const void* state, const Containers::StringView filePath) {
@@ -631,15 +816,40 @@ void AssimpImporter::doOpenState(const void* state, const Containers::StringView
 }
 
 void AssimpImporter::doOpenFile(const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenFile", filename};
+    const Containers::Optional<UnsignedInt> removeComponents = removeComponentsFromConfiguration(configuration(), "Trade::AssimpImporter::openFile():");
+    if(!removeComponents) return;
+
     if(!_importer) _importer = createImporter(configuration());
+    _importer->SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, *removeComponents);
 
     _f.reset(new File);
     /* Since the slice won't be null terminated, nullTerminatedGlobalView()
        won't help anything here */
     _f->filePath.emplace(Utility::Path::split(filename).first());
 
-    /* File callbacks are set up in doSetFileCallback() */
-    if(!(_f->scene = _importer->ReadFile(filename, flagsFromConfiguration(configuration())))) {
+    /* File callbacks are set up in doSetFileCallback(). If there's none,
+       files can be memory-mapped instead of read through Assimp's default
+       IOSystem. */
+    #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    if(!fileCallback()) {
+        const bool mapFiles = configuration().value<bool>("mapFiles");
+        if(mapFiles && !_ourFileCallback) {
+            _importer->SetIOHandler(_ourFileCallback = new MappedIoSystem);
+        } else if(!mapFiles && _ourFileCallback) {
+            /* See doSetFileCallback() for why it's deleted manually */
+            delete _ourFileCallback;
+            _importer->SetIOHandler(nullptr);
+            _ourFileCallback = nullptr;
+        }
+    }
+    #endif
+
+    IoSystem* const ioSystem = _ourFileCallback && _importer->GetIOHandler() == _ourFileCallback ? static_cast<IoSystem*>(_ourFileCallback) : nullptr;
+    if(ioSystem) ioSystem->retain();
+    _f->scene = _importer->ReadFile(filename, flagsFromConfiguration(configuration(), _f->lazyPostprocessFlags, *removeComponents));
+    if(ioSystem) ioSystem->release();
+    if(!_f->scene) {
         Error{} << "Trade::AssimpImporter::openFile(): failed to open" << filename << Debug::nospace << ":" << _importer->GetErrorString();
         return;
     }
@@ -648,6 +858,13 @@ void AssimpImporter::doOpenFile(const Containers::StringView filename) {
 }
 
 void AssimpImporter::doClose() {
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    _f->joinImageDecodeThreads();
+    #endif
+
+    /* Put the image importer back to the shared pool, if enabled */
+    releaseImageImporter();
+
     /* In case of doOpenState(), the _importer isn't populated at all and
        the scene is owned by the caller */
     if(_importer) _importer->FreeScene();
@@ -677,6 +894,7 @@ Containers::String AssimpImporter::doSceneName(UnsignedInt) {
 }
 
 Containers::Optional<SceneData> AssimpImporter::doScene(UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doScene"};
     /* Count how many meshes and skins we're referencing. Materials have to use
        the same object mapping as meshes and Assimp has no way to not assign a
        material which means there will either be both the mesh and material
@@ -1003,6 +1221,7 @@ Containers::String AssimpImporter::doMeshName(const UnsignedInt id) {
 }
 
 Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMesh", {}, id};
     const aiMesh* mesh = _f->scene->mMeshes[id];
 
     /* Primitive. mPrimitiveTypes is a mask but aiProcess_SortByPType (enabled
@@ -1014,11 +1233,19 @@ Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, Unsi
     /** @todo aiPrimitiveType_NGONEncodingFlag is related to FB_ngon_encoding
         from https://github.com/KhronosGroup/glTF/pull/1620, consider support
         here and in GltfImporter if/when it gets approved */
+    /* If triangulation is done lazily, meshes can contain polygons, possibly
+       together with triangles if SortByPType isn't enabled. Those get
+       triangulated below. */
+    const bool triangulate = _f->lazyPostprocessFlags & aiProcess_Triangulate;
     MeshPrimitive primitive;
     UnsignedInt expectedFaceSize;
     const aiPrimitiveType primitiveType = aiPrimitiveType(mesh->mPrimitiveTypes &
-        (aiPrimitiveType_POINT|aiPrimitiveType_LINE|aiPrimitiveType_TRIANGLE));
-    if(primitiveType == aiPrimitiveType_POINT) {
+        (aiPrimitiveType_POINT|aiPrimitiveType_LINE|aiPrimitiveType_TRIANGLE|aiPrimitiveType_POLYGON));
+    if(triangulate && (primitiveType & aiPrimitiveType_POLYGON) && !(primitiveType & ~(aiPrimitiveType_TRIANGLE|aiPrimitiveType_POLYGON))) {
+        primitive = MeshPrimitive::Triangles;
+        /* Faces have a varying size */
+        expectedFaceSize = 0;
+    } else if(primitiveType == aiPrimitiveType_POINT) {
         primitive = MeshPrimitive::Points;
         expectedFaceSize = 1;
     } else if(primitiveType == aiPrimitiveType_LINE) {
@@ -1032,6 +1259,13 @@ Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, Unsi
         return Containers::NullOpt;
     }
 
+    /* With interleaved layout all attributes of a vertex are next to each
+       other, with the stride being a sum of all attribute sizes. Otherwise
+       each attribute occupies a contiguous block and is copied from the
+       corresponding aiMesh array with a single memcpy(), texture coordinates
+       then keep the three-component layout Assimp uses. */
+    const bool interleave = configuration().value<bool>("interleaveMeshes");
+
     /* Gather all attributes. Position is there always, others are optional */
     const UnsignedInt vertexCount = mesh->mNumVertices;
     std::size_t attributeCount = 1;
@@ -1055,7 +1289,7 @@ Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, Unsi
         }
 
         ++attributeCount;
-        stride += sizeof(Vector2);
+        stride += interleave ? sizeof(Vector2) : sizeof(Vector3);
     }
 
     attributeCount += mesh->GetNumColorChannels();
@@ -1116,51 +1350,50 @@ Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, Unsi
     Containers::Array<MeshAttributeData> attributeData{attributeCount};
     std::size_t attributeIndex = 0;
     std::size_t attributeOffset = 0;
+    const auto nextAttribute = [&](const std::size_t size) {
+        const Containers::StridedArrayView2D<char> out = interleave ?
+            Containers::StridedArrayView2D<char>{vertexData,
+                vertexData + attributeOffset,
+                {vertexCount, size}, {stride, 1}} :
+            Containers::StridedArrayView2D<char>{vertexData,
+                vertexData + attributeOffset*vertexCount,
+                {vertexCount, size}, {std::ptrdiff_t(size), 1}};
+        attributeOffset += size;
+        return out;
+    };
 
     /* Positions */
     {
-        Containers::StridedArrayView1D<Vector3> positions{vertexData,
-            reinterpret_cast<Vector3*>(vertexData + attributeOffset),
-            vertexCount, stride};
+        const Containers::StridedArrayView1D<Vector3> positions = Containers::arrayCast<1, Vector3>(nextAttribute(sizeof(Vector3)));
         Utility::copy(Containers::arrayView(reinterpret_cast<Vector3*>(mesh->mVertices), mesh->mNumVertices), positions);
 
         attributeData[attributeIndex++] = MeshAttributeData{
             MeshAttribute::Position, positions};
-        attributeOffset += sizeof(Vector3);
     }
 
     /* Normals, if any */
     if(mesh->HasNormals()) {
-        Containers::StridedArrayView1D<Vector3> normals{vertexData,
-            reinterpret_cast<Vector3*>(vertexData + attributeOffset),
-            vertexCount, stride};
+        const Containers::StridedArrayView1D<Vector3> normals = Containers::arrayCast<1, Vector3>(nextAttribute(sizeof(Vector3)));
         Utility::copy(Containers::arrayView(reinterpret_cast<Vector3*>(mesh->mNormals), mesh->mNumVertices), normals);
 
         attributeData[attributeIndex++] = MeshAttributeData{
             MeshAttribute::Normal, normals};
-        attributeOffset += sizeof(Vector3);
     }
 
     /* Tangents + bitangents, if any. Assimp always provides either none or
        both, never just one of these. */
     if(mesh->HasTangentsAndBitangents()) {
-        Containers::StridedArrayView1D<Vector3> tangents{vertexData,
-            reinterpret_cast<Vector3*>(vertexData + attributeOffset),
-            vertexCount, stride};
+        const Containers::StridedArrayView1D<Vector3> tangents = Containers::arrayCast<1, Vector3>(nextAttribute(sizeof(Vector3)));
         Utility::copy(Containers::arrayView(reinterpret_cast<Vector3*>(mesh->mTangents), mesh->mNumVertices), tangents);
 
         attributeData[attributeIndex++] = MeshAttributeData{
             MeshAttribute::Tangent, tangents};
-        attributeOffset += sizeof(Vector3);
 
-        Containers::StridedArrayView1D<Vector3> bitangents{vertexData,
-            reinterpret_cast<Vector3*>(vertexData + attributeOffset),
-            vertexCount, stride};
+        const Containers::StridedArrayView1D<Vector3> bitangents = Containers::arrayCast<1, Vector3>(nextAttribute(sizeof(Vector3)));
         Utility::copy(Containers::arrayView(reinterpret_cast<Vector3*>(mesh->mBitangents), mesh->mNumVertices), bitangents);
 
         attributeData[attributeIndex++] = MeshAttributeData{
             MeshAttribute::Bitangent, bitangents};
-        attributeOffset += sizeof(Vector3);
     }
 
     /* Texture coordinates */
@@ -1169,42 +1402,41 @@ Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, Unsi
         /* Warning already printed above */
         if(mesh->mNumUVComponents[layer] != 2) continue;
 
-        Containers::StridedArrayView1D<Vector2> textureCoordinates{vertexData,
-            reinterpret_cast<Vector2*>(vertexData + attributeOffset),
-            vertexCount, stride};
-        Utility::copy(
-            /* Converting to a strided array view to take just the first 2
-               component of the 3D coordinate */
+        /* Converting to a strided array view to take just the first 2
+           component of the 3D coordinate */
+        const Containers::StridedArrayView1D<const Vector2> input =
             Containers::arrayCast<Vector2>(Containers::stridedArrayView(
-                Containers::arrayView(mesh->mTextureCoords[layer], mesh->mNumVertices))),
-            textureCoordinates);
+                Containers::arrayView(reinterpret_cast<const Vector3*>(mesh->mTextureCoords[layer]), mesh->mNumVertices)));
+
+        Containers::StridedArrayView1D<Vector2> textureCoordinates;
+        if(interleave) {
+            textureCoordinates = Containers::arrayCast<1, Vector2>(nextAttribute(sizeof(Vector2)));
+            Utility::copy(input, textureCoordinates);
+        } else {
+            const Containers::StridedArrayView1D<Vector3> textureCoordinates3D = Containers::arrayCast<1, Vector3>(nextAttribute(sizeof(Vector3)));
+            Utility::copy(Containers::arrayView(reinterpret_cast<const Vector3*>(mesh->mTextureCoords[layer]), mesh->mNumVertices), textureCoordinates3D);
+            textureCoordinates = Containers::arrayCast<Vector2>(textureCoordinates3D);
+        }
 
         attributeData[attributeIndex++] = MeshAttributeData{
             MeshAttribute::TextureCoordinates, textureCoordinates};
-        attributeOffset += sizeof(Vector2);
     }
 
     /* Colors */
     for(std::size_t layer = 0; layer < mesh->GetNumColorChannels(); ++layer) {
-        Containers::StridedArrayView1D<Color4> colors{vertexData,
-            reinterpret_cast<Color4*>(vertexData + attributeOffset),
-            vertexCount, stride};
+        const Containers::StridedArrayView1D<Color4> colors = Containers::arrayCast<1, Color4>(nextAttribute(sizeof(Color4)));
         Utility::copy(Containers::arrayView(reinterpret_cast<Color4*>(mesh->mColors[layer]), mesh->mNumVertices), colors);
 
         attributeData[attributeIndex++] = MeshAttributeData{
             MeshAttribute::Color, colors};
-        attributeOffset += sizeof(Color4);
     }
 
     /* Joints and joint weights */
     if(mesh->HasBones()) {
-        Containers::StridedArrayView2D<UnsignedInt> jointIds{vertexData,
-            reinterpret_cast<UnsignedInt*>(vertexData + attributeOffset),
-            {vertexCount, roundedJointCount}, {stride, sizeof(UnsignedInt)}};
+        const Containers::StridedArrayView2D<UnsignedInt> jointIds = Containers::arrayCast<2, UnsignedInt>(nextAttribute(sizeof(UnsignedInt)*roundedJointCount));
         attributeData[attributeIndex++] = MeshAttributeData{MeshAttribute::JointIds,
             /** @todo drop the prefix() once roundedJointCount is gone */
             jointIds.prefix({vertexCount, maxJointCount})};
-        attributeOffset += sizeof(UnsignedInt)*roundedJointCount;
         #ifdef MAGNUM_BUILD_DEPRECATED
         if(configuration().value<bool>("compatibilitySkinningAttributes")) {
             for(std::size_t layer = 0; layer != roundedJointCount; layer += 4)
@@ -1212,13 +1444,10 @@ Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, Unsi
         }
         #endif
 
-        Containers::StridedArrayView2D<Float> weights{vertexData,
-            reinterpret_cast<Float*>(vertexData + attributeOffset),
-            {vertexCount, roundedJointCount}, {stride, sizeof(Float)}};
+        const Containers::StridedArrayView2D<Float> weights = Containers::arrayCast<2, Float>(nextAttribute(sizeof(Float)*roundedJointCount));
         attributeData[attributeIndex++] = MeshAttributeData{MeshAttribute::Weights,
             /** @todo drop the prefix() once roundedJointCount is gone */
             weights.prefix({vertexCount, maxJointCount})};
-        attributeOffset += sizeof(Float)*roundedJointCount;
         #ifdef MAGNUM_BUILD_DEPRECATED
         if(configuration().value<bool>("compatibilitySkinningAttributes")) {
             for(std::size_t layer = 0; layer != roundedJointCount; layer += 4)
@@ -1291,22 +1520,89 @@ Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, Unsi
 
     /* Import indices. There doesn't seem to be any shortcut to just copy all
        index data in a single go, so having to iterate over faces. Ugh. */
-    Containers::Array<char> indexData{NoInit, mesh->mNumFaces*expectedFaceSize*sizeof(UnsignedInt)};
-    Containers::ArrayView<UnsignedInt> indices = Containers::arrayCast<UnsignedInt>(indexData);
-    for(std::size_t faceIndex = 0; faceIndex < mesh->mNumFaces; ++faceIndex) {
-        const aiFace& face = mesh->mFaces[faceIndex];
-        /* For polygons triangulation should have ensured that each face is a
-           triangle. */
-        CORRADE_ASSERT(face.mNumIndices == expectedFaceSize, "Trade::AssimpImporter::mesh(): expected" << expectedFaceSize << "indices per face for" << primitive << "but got" << face.mNumIndices << "indices for face" << faceIndex, {});
+    Containers::Array<char> indexData;
+    Containers::ArrayView<UnsignedInt> indices;
+    if(!expectedFaceSize) {
+        /* Triangulating polygons as fans. Unlike Assimp's Triangulate step
+           this doesn't handle concave polygons. */
+        std::size_t indexCount = 0;
+        for(std::size_t faceIndex = 0; faceIndex < mesh->mNumFaces; ++faceIndex) {
+            const aiFace& face = mesh->mFaces[faceIndex];
+            CORRADE_ASSERT(face.mNumIndices >= 3, "Trade::AssimpImporter::mesh(): expected at least 3 indices per face for" << primitive << "but got" << face.mNumIndices << "indices for face" << faceIndex, {});
+            indexCount += (face.mNumIndices - 2)*3;
+        }
 
-        for(std::size_t i = 0; i != face.mNumIndices; ++i)
-            indices[faceIndex*expectedFaceSize + i] = face.mIndices[i];
+        indexData = Containers::Array<char>{NoInit, indexCount*sizeof(UnsignedInt)};
+        indices = Containers::arrayCast<UnsignedInt>(indexData);
+        std::size_t index = 0;
+        for(std::size_t faceIndex = 0; faceIndex < mesh->mNumFaces; ++faceIndex) {
+            const aiFace& face = mesh->mFaces[faceIndex];
+            for(std::size_t i = 2; i != face.mNumIndices; ++i) {
+                indices[index++] = face.mIndices[0];
+                indices[index++] = face.mIndices[i - 1];
+                indices[index++] = face.mIndices[i];
+            }
+        }
+        CORRADE_INTERNAL_ASSERT(index == indexCount);
+    } else {
+        indexData = Containers::Array<char>{NoInit, mesh->mNumFaces*expectedFaceSize*sizeof(UnsignedInt)};
+        indices = Containers::arrayCast<UnsignedInt>(indexData);
+        for(std::size_t faceIndex = 0; faceIndex < mesh->mNumFaces; ++faceIndex) {
+            const aiFace& face = mesh->mFaces[faceIndex];
+            /* For polygons triangulation should have ensured that each face
+               is a triangle. */
+            CORRADE_ASSERT(face.mNumIndices == expectedFaceSize, "Trade::AssimpImporter::mesh(): expected" << expectedFaceSize << "indices per face for" << primitive << "but got" << face.mNumIndices << "indices for face" << faceIndex, {});
+
+            for(std::size_t i = 0; i != face.mNumIndices; ++i)
+                indices[faceIndex*expectedFaceSize + i] = face.mIndices[i];
+        }
     }
 
-    return MeshData{primitive,
+    MeshData out{primitive,
         Utility::move(indexData), MeshIndexData{indices},
         Utility::move(vertexData), Utility::move(attributeData),
         MeshData::ImplicitVertexCount, mesh};
+
+    /* Postprocess steps that were deferred from opening the file, apart from
+       triangulation that's done above already. Same as Assimp, normals are
+       generated only for triangle meshes that don't have any yet. */
+    const bool generateNormals = primitive == MeshPrimitive::Triangles && !mesh->HasNormals();
+    const bool generateFlatNormals = generateNormals && (_f->lazyPostprocessFlags & aiProcess_GenNormals);
+    const bool generateSmoothNormals = generateNormals && !generateFlatNormals && (_f->lazyPostprocessFlags & aiProcess_GenSmoothNormals);
+    if(!generateFlatNormals && !generateSmoothNormals && !(_f->lazyPostprocessFlags & aiProcess_JoinIdenticalVertices))
+        return out;
+
+    /* Flat normals need each triangle to have its own vertices, identical
+       vertices get joined back below */
+    if(generateFlatNormals) {
+        out = MeshTools::duplicate(out);
+        const Containers::Array<Vector3> normals = MeshTools::generateFlatNormals(out.attribute<Vector3>(MeshAttribute::Position));
+        out = MeshTools::interleave(Utility::move(out), {
+            MeshAttributeData{MeshAttribute::Normal, Containers::arrayView(normals)}
+        });
+    }
+
+    /* Without JoinIdenticalVertices Assimp gives back each face with its own
+       vertices, smooth normals need the faces to share them */
+    if((_f->lazyPostprocessFlags & aiProcess_JoinIdenticalVertices) || generateSmoothNormals)
+        out = MeshTools::removeDuplicates(out);
+
+    if(generateSmoothNormals) {
+        const Containers::Array<Vector3> normals = MeshTools::generateSmoothNormals(out.indicesAsArray(), out.attribute<Vector3>(MeshAttribute::Position));
+        out = MeshTools::interleave(Utility::move(out), {
+            MeshAttributeData{MeshAttribute::Normal, Containers::arrayView(normals)}
+        });
+    }
+
+    /* MeshTools don't preserve the importer state, put it back */
+    const MeshIndexData outIndices{out.indices()};
+    const UnsignedInt outVertexCount = out.vertexCount();
+    Containers::Array<char> outIndexData = out.releaseIndexData();
+    Containers::Array<MeshAttributeData> outAttributeData = out.releaseAttributeData();
+    return MeshData{primitive,
+        Utility::move(outIndexData), outIndices,
+        out.releaseVertexData(), Utility::move(outAttributeData),
+        outVertexCount, mesh};
 }
 
 #ifdef MAGNUM_BUILD_DEPRECATED
@@ -1469,6 +1765,7 @@ template<std::size_t size> constexpr Containers::StringView extractMaterialKey(c
 }
 
 Containers::Optional<MaterialData> AssimpImporter::doMaterial(const UnsignedInt id) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMaterial", {}, id};
     const bool forceRaw = configuration().value<bool>("forceRawMaterialData");
     const bool unrecognizedAsRaw = forceRaw || !configuration().value<bool>("ignoreUnrecognizedMaterialData");
 
@@ -1872,7 +2169,7 @@ AbstractImporter* AssimpImporter::setupOrReuseImporterForImage(const UnsignedInt
        fails, the importer will stay unset, but the ID will be updated so the
        next round can again just return nullptr above instead of going through
        the doomed-to-fail process again. */
-    _f->imageImporter = Containers::NullOpt;
+    releaseImageImporter();
     _f->imageImporterId = id;
 
     aiString texturePath;
@@ -1886,6 +2183,8 @@ AbstractImporter* AssimpImporter::setupOrReuseImporterForImage(const UnsignedInt
     if(fileCallback()) importer.setFileCallback(fileCallback(), fileCallbackUserData());
 
     const Containers::StringView path = texturePath;
+    Containers::Optional<AnyImageImporter> pooledImporter;
+    Containers::String pooledFilename;
 
     /* Loading of embedded textures was changed to a lookup using the full path
        embedded with the scene file rather than an index prefixed with '*' in
@@ -1936,21 +2235,127 @@ AbstractImporter* AssimpImporter::setupOrReuseImporterForImage(const UnsignedInt
         std::replace(normalized.begin(), normalized.end(), '\\', '/');
         /* Assimp doesn't trim spaces from the end of image paths in OBJ
            materials so we have to. See the image-filename-space.mtl test. */
-        if(!importer.openFile(Utility::Path::join(_f->filePath ? *_f->filePath : "", normalized).trimmed()))
+        const Containers::String filename = Utility::Path::join(_f->filePath ? *_f->filePath : "", normalized).trimmed();
+
+        /* If there's an importer already opened for the same file in the
+           shared pool, take it from there instead of opening the file
+           again */
+        if(configuration().value<std::size_t>("imageImporterPoolSize")) {
+            pooledFilename = filename;
+            pooledImporter = Magnum::Implementation::imageImporterPool().acquire(manager(), pooledFilename, flags(), fileCallback(), fileCallbackUserData());
+        }
+        if(!pooledImporter && !importer.openFile(filename))
             return nullptr;
     }
+    AnyImageImporter& opened = pooledImporter ? *pooledImporter : importer;
 
-    if(importer.image2DCount() != 1) {
-        Error{} << errorPrefix << "expected exactly one 2D image in an image file but got" << importer.image2DCount();
+    if(opened.image2DCount() != 1) {
+        Error{} << errorPrefix << "expected exactly one 2D image in an image file but got" << opened.image2DCount();
         return nullptr;
     }
 
-    return &_f->imageImporter.emplace(Utility::move(importer));
+    _f->imageImporterFilename = Utility::move(pooledFilename);
+    return &_f->imageImporter.emplace(Utility::move(opened));
+}
+
+void AssimpImporter::releaseImageImporter() {
+    if(_f->imageImporter && _f->imageImporterFilename)
+        Magnum::Implementation::imageImporterPool().release(manager(), _f->imageImporterFilename, flags(), fileCallback(), fileCallbackUserData(), Utility::move(*_f->imageImporter), configuration().value<std::size_t>("imageImporterPoolSize"));
+    _f->imageImporter = Containers::NullOpt;
+    _f->imageImporterFilename = {};
+}
+
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+namespace {
+
+/* Like the embedded texture lookup in setupOrReuseImporterForImage(), but
+   without reporting errors. Those get reported when the image is imported on
+   demand. */
+const aiTexture* embeddedTexture(const aiScene& scene, const Containers::StringView path) {
+    #if ASSIMP_IS_VERSION_5_OR_GREATER
+    return scene.GetEmbeddedTexture(path.data());
+    #else
+    if(!path.hasPrefix('*')) return nullptr;
+    char* err;
+    const char* str = path.data() + 1;
+    const Int index = Int(std::strtol(str, &err, 10));
+    if(err == nullptr || err == str || index < 0 || UnsignedInt(index) >= scene.mNumTextures)
+        return nullptr;
+    return scene.mTextures[index];
+    #endif
 }
 
+}
+
+void AssimpImporter::startEmbeddedImageDecoding() {
+    /* Opening the data has to be done on the main thread, as it involves
+       loading plugins through the (not thread-safe) plugin manager. What's
+       left for the threads is just the actual decoding in image2D(). */
+    for(UnsignedInt id = 0; id != _f->images.size(); ++id) {
+        /* Same path lookup as in setupOrReuseImporterForImage() */
+        const aiMaterial* mat = _f->images[id].first();
+        const aiTextureType type = aiTextureType(mat->mProperties[_f->images[id].second()]->mSemantic);
+        aiString texturePath;
+        if(mat->Get(AI_MATKEY_TEXTURE(type, 0), texturePath) != AI_SUCCESS)
+            continue;
+
+        const aiTexture* texture = embeddedTexture(*_f->scene, texturePath);
+        if(!texture || texture->mHeight != 0) continue;
+
+        Containers::Pointer<AbstractImporter> importer{new AnyImageImporter{*manager()}};
+        importer->setFlags(flags());
+        {
+            Error silenceError{nullptr};
+            if(!importer->openData(Containers::ArrayView<const char>(reinterpret_cast<const char*>(texture->pcData), texture->mWidth)) || importer->image2DCount() != 1)
+                continue;
+        }
+
+        arrayAppend(_f->imageDecodeJobs, InPlaceInit, id, Utility::move(importer));
+    }
+
+    if(_f->imageDecodeJobs.isEmpty()) return;
+
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount)
+        threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = UnsignedInt(Math::min(std::size_t{threadCount}, _f->imageDecodeJobs.size()));
+
+    const auto decode = [](const Containers::ArrayView<const Containers::Pair<UnsignedInt, Containers::Pointer<AbstractImporter>>> jobs, const Containers::ArrayView<Containers::Array<Containers::Optional<ImageData2D>>> decodedImages, const std::size_t offset, const std::size_t step) {
+        /* Errors get reported again when the image is imported on demand.
+           Output redirection is thread-local only in multithreaded builds. */
+        #ifdef CORRADE_BUILD_MULTITHREADED
+        Error silenceError{nullptr};
+        #endif
+        for(std::size_t i = offset; i < jobs.size(); i += step) {
+            AbstractImporter& importer = *jobs[i].second();
+            Containers::Array<Containers::Optional<ImageData2D>> levels{importer.image2DLevelCount(0)};
+            bool failed = false;
+            for(UnsignedInt level = 0; level != levels.size() && !failed; ++level)
+                failed = !(levels[level] = importer.image2D(0, level));
+            if(!failed) decodedImages[jobs[i].first()] = Utility::move(levels);
+        }
+    };
+
+    /* Each thread takes every threadCount-th job. The decoded image array is
+       sized upfront so the threads only write to distinct existing items. */
+    _f->decodedImages = Containers::Array<Containers::Array<Containers::Optional<ImageData2D>>>{_f->images.size()};
+    _f->imageDecodeThreads = Containers::Array<std::thread>{threadCount};
+    for(UnsignedInt i = 0; i != threadCount; ++i)
+        _f->imageDecodeThreads[i] = std::thread{decode, Containers::arrayView(_f->imageDecodeJobs), Containers::arrayView(_f->decodedImages), std::size_t{i}, std::size_t{threadCount}};
+}
+#endif
+
 UnsignedInt AssimpImporter::doImage2DLevelCount(const UnsignedInt id) {
     CORRADE_ASSERT(manager(), "Trade::AssimpImporter::image2DLevelCount(): the plugin must be instantiated with access to plugin manager in order to open image files", {});
 
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    if(!_f->decodedImages.isEmpty()) {
+        _f->joinImageDecodeThreads();
+        if(!_f->decodedImages[id].isEmpty())
+            return _f->decodedImages[id].size();
+    }
+    #endif
+
     AbstractImporter* importer = setupOrReuseImporterForImage(id, "Trade::AssimpImporter::image2DLevelCount():");
     /* image2DLevelCount() isn't supposed to fail (image2D() is, instead), so
        report 1 on failure and expect image2D() to fail later */
@@ -1960,8 +2365,22 @@ UnsignedInt AssimpImporter::doImage2DLevelCount(const UnsignedInt id) {
 }
 
 Containers::Optional<ImageData2D> AssimpImporter::doImage2D(const UnsignedInt id, const UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D", {}, id};
     CORRADE_ASSERT(manager(), "Trade::AssimpImporter::image2D(): the plugin must be instantiated with access to plugin manager in order to open image files", {});
 
+    /* If the image was decoded in the background, give away the result. Any
+       further import of the same image goes through the importer again. */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    if(!_f->decodedImages.isEmpty()) {
+        _f->joinImageDecodeThreads();
+        if(level < _f->decodedImages[id].size() && _f->decodedImages[id][level]) {
+            Containers::Optional<ImageData2D> out = Utility::move(_f->decodedImages[id][level]);
+            _f->decodedImages[id][level] = Containers::NullOpt;
+            return out;
+        }
+    }
+    #endif
+
     AbstractImporter* importer = setupOrReuseImporterForImage(id, "Trade::AssimpImporter::image2D():");
     if(!importer) return Containers::NullOpt;
 
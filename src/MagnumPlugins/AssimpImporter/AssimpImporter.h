@@ -141,8 +141,8 @@ This plugin provides `3dsImporter`, `3mfImporter`, `Ac3dImporter`,
     through the base @ref AbstractImporter interface. See its documentation for
     introduction and usage examples.
 
-This plugin depends on the @ref Trade and [Assimp](http://assimp.org) libraries
-and the @ref AnyImageImporter plugin and is built if `MAGNUM_WITH_ASSIMPIMPORTER`
+This plugin depends on the @ref Trade, @ref MeshTools and
+[Assimp](http://assimp.org) libraries and the @ref AnyImageImporter plugin and is built if `MAGNUM_WITH_ASSIMPIMPORTER`
 is enabled when building Magnum Plugins. To use as a dynamic plugin, load
 @cpp "AssimpImporter" @ce via @ref Corrade::PluginManager::Manager.
 
@@ -199,9 +199,17 @@ The plugin supports @ref ImporterFeature::OpenData, @relativeref{ImporterFeature
 everything during initial import, meaning all external file loading callbacks
 are called with @ref InputFileCallbackPolicy::LoadTemporary and the resources
 can be safely freed right after the @ref openData() / @ref openFile() function
-exits. In some cases, Assimp will explicitly call
-@ref InputFileCallbackPolicy::Close on the opened file and then open it again.
-In case of images, the files are loaded on-demand inside @ref image2D() calls
+exits. Assimp often opens the same file several times during an import, the
+importer however keeps each file loaded until the import finishes, so the
+callback is called with @ref InputFileCallbackPolicy::LoadTemporary only once
+for each file and with @ref InputFileCallbackPolicy::Close once the import is
+done. If no file callback is set and the @cb{.ini} mapFiles @ce
+@ref Trade-AssimpImporter-configuration "configuration option" is enabled,
+files opened with @ref openFile() and all files referenced from them are
+memory-mapped using @relativeref{Corrade,Utility::Path::mapRead()} instead of
+being read by Assimp. This is available only on platforms where
+@relativeref{Corrade,Utility::Path::mapRead()} is implemented. Assimp itself
+doesn't load files in parallel. In case of images, the files are loaded on-demand inside @ref image2D() calls
 with @ref InputFileCallbackPolicy::LoadTemporary and
 @ref InputFileCallbackPolicy::Close is emitted right after the file is fully
 read.
@@ -384,6 +392,33 @@ are also propagated to image importer plugins the importer delegates to.
 
 -   Only point, triangle, and line meshes are loaded (quad and poly meshes
     are triangularized by Assimp)
+-   With the @cb{.ini} lazyPostprocess @ce
+    @ref Trade-AssimpImporter-configuration "configuration option" enabled,
+    the @cb{.ini} JoinIdenticalVertices @ce, @cb{.ini} Triangulate @ce,
+    @cb{.ini} GenNormals @ce and @cb{.ini} GenSmoothNormals @ce
+    postprocess steps aren't applied to the whole scene on opening but only
+    to meshes that are actually imported. Polygons are then triangulated as
+    fans, which doesn't handle concave polygons, vertices are joined using
+    @ref MeshTools::removeDuplicates(const MeshData&) and normals are
+    generated using @ref MeshTools::generateFlatNormals() and
+    @ref MeshTools::generateSmoothNormals(). Unlike with Assimp, smooth
+    normals aren't shared across vertices that differ in other attributes
+    such as texture coordinates. If @cb{.ini} SortByPType @ce is enabled,
+    polygons and triangles are put into separate meshes by Assimp, so the
+    mesh count may differ from the non-lazy case.
+-   The @cb{.ini} removeComponents @ce
+    @ref Trade-AssimpImporter-configuration "configuration option" strips
+    given vertex attributes, such as @cb{.ini} colors @ce,
+    @cb{.ini} textureCoordinates @ce, @cb{.ini} tangents @ce or
+    @cb{.ini} jointWeights @ce, and optionally also animations, textures,
+    lights, cameras and materials from the scene using Assimp's
+    `aiProcess_RemoveComponent` step. The file is still fully parsed by
+    Assimp, but the removed data don't go through the remaining postprocess
+    steps and aren't copied on import. Individual color and texture
+    coordinate sets can be removed by appending the set index to the name,
+    e.g. @cb{.ini} textureCoordinates1 @ce. Removing normals with
+    @cb{.ini} GenNormals @ce or @cb{.ini} GenSmoothNormals @ce enabled causes
+    them to be regenerated.
 -   Custom mesh attributes (such as `object_id` in Stanford PLY files) are
     not imported.
 -   Texture coordinate layers with other than two components are skipped
@@ -396,6 +431,17 @@ are also propagated to image importer plugins the importer delegates to.
     coordinates as @ref VertexFormat::Vector2 and colors as
     @ref VertexFormat::Vector4. In other words, everything gets expanded by
     Assimp to floats, even if the original file might be using different types.
+-   Vertex data are interleaved by default. Assimp stores each attribute in a
+    separate array, and since @ref MeshData needs all attributes in a single
+    vertex buffer, they can't be referenced directly. With the
+    @cb{.ini} interleaveMeshes @ce
+    @ref Trade-AssimpImporter-configuration "configuration option" disabled,
+    attributes are instead placed one after another, each copied from Assimp
+    with a single @ref std::memcpy(), which is faster for large meshes that
+    get processed further anyway. Texture coordinates then keep the
+    three-component storage Assimp uses, resulting in a non-default stride.
+    Meshes that get processed by @ref MeshTools due to the
+    @cb{.ini} lazyPostprocess @ce option are interleaved again.
 -   The imported model always has either both @ref MeshAttribute::Tangent
     @ref MeshAttribute::Bitangent or neither of them, tangents are always
     three-component with binormals separate.
@@ -432,6 +478,29 @@ texture coordinates are optional.
     with @ref SamplerWrapping::ClampToEdge
 -   Assimp does not appear to load any filtering information
 -   Raw embedded image data is not supported
+-   Embedded images are decoded on demand in @ref image2D() by default. With
+    the @cb{.ini} decodeEmbeddedImages @ce
+    @ref Trade-AssimpImporter-configuration "configuration option" enabled,
+    the importer starts decoding them on @cb{.ini} threads @ce background
+    threads right after a file is opened, so the decoding can overlap with
+    for example mesh import. The first @ref image2D() or
+    @ref image2DLevelCount() call then waits for all of them to finish. Each
+    decoded image level is returned just once, further imports of the same
+    level decode it again. Images that failed to decode in the background
+    are imported on demand, which reports the error.
+-   The importer opened for the most recently accessed image is kept around
+    so importing its other levels doesn't open the file again. Setting the
+    @cb{.ini} imageImporterPoolSize @ce @ref Trade-AssimpImporter-configuration "configuration option"
+    to a non-zero value puts importers of external image files into a pool
+    shared by all @ref AssimpImporter instances created from the same plugin
+    manager once another image is accessed or the file is closed. Importing
+    the same image file from another scene file, or again after the file was
+    closed and reopened, then takes the already opened importer from the pool
+    instead of opening the image file again. The pool is thread-safe, each
+    pooled importer is used by just one importer instance at a time. It's
+    assumed the image files don't change while they're in the pool. The pool
+    is emptied once the last @ref AssimpImporter instance created from given
+    plugin manager is destroyed.
 
 @section Trade-AssimpImporter-configuration Plugin-specific configuration
 
@@ -561,6 +630,10 @@ class MAGNUM_ASSIMPIMPORTER_EXPORT AssimpImporter: public AbstractImporter {
         MAGNUM_ASSIMPIMPORTER_LOCAL Containers::Optional<TextureData> doTexture(UnsignedInt id) override;
 
         MAGNUM_ASSIMPIMPORTER_LOCAL AbstractImporter* setupOrReuseImporterForImage(UnsignedInt id, const char* errorPrefix);
+        MAGNUM_ASSIMPIMPORTER_LOCAL void releaseImageImporter();
+        #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+        MAGNUM_ASSIMPIMPORTER_LOCAL void startEmbeddedImageDecoding();
+        #endif
 
         MAGNUM_ASSIMPIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_ASSIMPIMPORTER_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
@@ -579,7 +652,7 @@ class MAGNUM_ASSIMPIMPORTER_EXPORT AssimpImporter: public AbstractImporter {
         MAGNUM_ASSIMPIMPORTER_LOCAL const void* doImporterState() const override;
 
         Containers::Pointer<Assimp::Importer> _importer;
-        Assimp::IOSystem* _ourFileCallback;
+        Assimp::IOSystem* _ourFileCallback{};
         Containers::Pointer<File> _f;
 };
 
@@ -126,9 +126,13 @@ struct AssimpImporterTest: TestSuite::Tester {
     void materialRawTextureLayers();
 
     void mesh();
+    void meshNonInterleaved();
+    void meshRemoveComponents();
+    void meshRemoveComponentsInvalid();
     void pointMesh();
     void lineMesh();
     void polygonMesh();
+    void polygonMeshLazyPostprocess();
     #ifdef MAGNUM_BUILD_DEPRECATED
     /* For JOINTS and WEIGHTS, which are included only for backwards
        compatibility. All other attributes are builtin. */
@@ -152,6 +156,7 @@ struct AssimpImporterTest: TestSuite::Tester {
 
     void imageEmbedded();
     void imageEmbeddedWithPath();
+    void imageEmbeddedDecodeInBackground();
     void imageExternal();
     void imageExternalNotFound();
     void imageExternalNoPathNoCallback();
@@ -172,8 +177,10 @@ struct AssimpImporterTest: TestSuite::Tester {
     void fileCallbackNotFound();
     void fileCallbackEmptyFile();
     void fileCallbackReset();
+    void fileCallbackLoadOnce();
     void fileCallbackImage();
     void fileCallbackImageNotFound();
+    void openFileMapped();
 
     void openTwice();
     void importTwice();
@@ -218,6 +225,32 @@ const struct {
 /* Like ExportedFileData, but with compatibilitySkinningAttributes added */
 /** @todo go back to ExportedFileData once the compatibilitySkinningAttributes
     option is gone */
+const struct {
+    const char* name;
+    const char* removeComponents;
+    bool normals, tangents, textureCoordinates, colors;
+} MeshRemoveComponentsData[]{
+    {"positions only", "normals  tangents colors textureCoordinates",
+        false, false, false, false},
+    {"tangents", "tangents",
+        true, false, true, true},
+    {"first color and texture coordinate set", "colors0 textureCoordinates0",
+        true, true, false, false},
+    {"second texture coordinate set", "textureCoordinates1",
+        true, true, true, true},
+};
+
+const struct {
+    const char* name;
+    const char* removeComponents;
+    const char* message;
+} MeshRemoveComponentsInvalidData[]{
+    {"unknown", "normals bones", "bones"},
+    {"color set out of range", "colors5", "colors5"},
+    {"texture coordinate set out of range", "textureCoordinates7", "textureCoordinates7"},
+    {"multi-digit set", "textureCoordinates01", "textureCoordinates01"},
+};
+
 const struct {
     const char* name;
     const char* suffix;
@@ -351,9 +384,18 @@ AssimpImporterTest::AssimpImporterTest() {
     addTests({&AssimpImporterTest::materialRawTextureLayers,
 
               &AssimpImporterTest::mesh,
-              &AssimpImporterTest::pointMesh,
+              &AssimpImporterTest::meshNonInterleaved});
+
+    addInstancedTests({&AssimpImporterTest::meshRemoveComponents},
+        Containers::arraySize(MeshRemoveComponentsData));
+
+    addInstancedTests({&AssimpImporterTest::meshRemoveComponentsInvalid},
+        Containers::arraySize(MeshRemoveComponentsInvalidData));
+
+    addTests({&AssimpImporterTest::pointMesh,
               &AssimpImporterTest::lineMesh,
               &AssimpImporterTest::polygonMesh,
+              &AssimpImporterTest::polygonMeshLazyPostprocess,
               #ifdef MAGNUM_BUILD_DEPRECATED
               &AssimpImporterTest::meshCustomAttributes
               #endif
@@ -386,6 +428,7 @@ AssimpImporterTest::AssimpImporterTest() {
 
     addTests({&AssimpImporterTest::imageEmbedded,
               &AssimpImporterTest::imageEmbeddedWithPath,
+              &AssimpImporterTest::imageEmbeddedDecodeInBackground,
               &AssimpImporterTest::imageExternal,
               &AssimpImporterTest::imageExternalNotFound,
               &AssimpImporterTest::imageExternalNoPathNoCallback,
@@ -406,8 +449,10 @@ AssimpImporterTest::AssimpImporterTest() {
               &AssimpImporterTest::fileCallbackNotFound,
               &AssimpImporterTest::fileCallbackEmptyFile,
               &AssimpImporterTest::fileCallbackReset,
+              &AssimpImporterTest::fileCallbackLoadOnce,
               &AssimpImporterTest::fileCallbackImage,
               &AssimpImporterTest::fileCallbackImageNotFound,
+              &AssimpImporterTest::openFileMapped,
 
               &AssimpImporterTest::openTwice,
               &AssimpImporterTest::importTwice});
@@ -2789,6 +2834,112 @@ void AssimpImporterTest::mesh() {
     }), TestSuite::Compare::Container);
 }
 
+void AssimpImporterTest::meshNonInterleaved() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("interleaveMeshes", false);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->attributeCount(), 6);
+    CORRADE_COMPARE(mesh->vertexCount(), 3);
+
+    /* Each attribute is in its own block, texture coordinates keep the
+       three-component layout Assimp uses */
+    CORRADE_COMPARE(mesh->vertexData().size(), 3*(5*12 + 16));
+    CORRADE_COMPARE(mesh->attributeOffset(MeshAttribute::Position), 0);
+    CORRADE_COMPARE(mesh->attributeStride(MeshAttribute::Position), 12);
+    CORRADE_COMPARE(mesh->attributeOffset(MeshAttribute::Normal), 3*12);
+    CORRADE_COMPARE(mesh->attributeStride(MeshAttribute::Normal), 12);
+    CORRADE_COMPARE(mesh->attributeOffset(MeshAttribute::Tangent), 3*2*12);
+    CORRADE_COMPARE(mesh->attributeStride(MeshAttribute::Tangent), 12);
+    CORRADE_COMPARE(mesh->attributeOffset(MeshAttribute::Bitangent), 3*3*12);
+    CORRADE_COMPARE(mesh->attributeStride(MeshAttribute::Bitangent), 12);
+    CORRADE_COMPARE(mesh->attributeOffset(MeshAttribute::TextureCoordinates), 3*4*12);
+    CORRADE_COMPARE(mesh->attributeStride(MeshAttribute::TextureCoordinates), 12);
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2);
+    CORRADE_COMPARE(mesh->attributeOffset(MeshAttribute::Color), 3*5*12);
+    CORRADE_COMPARE(mesh->attributeStride(MeshAttribute::Color), 16);
+
+    /* The data are the same as in mesh() */
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedInt>(),
+        Containers::arrayView<UnsignedInt>({0, 1, 2}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {-1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Tangent),
+        Containers::arrayView<Vector3>({
+            {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f},
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Bitangent),
+        Containers::arrayView<Vector3>({
+            {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+        Containers::arrayView<Vector2>({
+            {0.5f, 1.0f}, {0.75f, 0.5f}, {0.5f, 0.9f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector4>(MeshAttribute::Color),
+        Containers::arrayView<Vector4>({
+            {1.0f, 0.25f, 0.24f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {0.1f, 0.2f, 0.3f, 1.0f}
+        }), TestSuite::Compare::Container);
+}
+
+void AssimpImporterTest::meshRemoveComponents() {
+    auto&& data = MeshRemoveComponentsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("removeComponents", data.removeComponents);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexCount(), 3);
+    CORRADE_COMPARE(mesh->attributeCount(MeshAttribute::Position), 1);
+    CORRADE_COMPARE(mesh->attributeCount(MeshAttribute::Normal), data.normals ? 1 : 0);
+    CORRADE_COMPARE(mesh->attributeCount(MeshAttribute::Tangent), data.tangents ? 1 : 0);
+    CORRADE_COMPARE(mesh->attributeCount(MeshAttribute::Bitangent), data.tangents ? 1 : 0);
+    CORRADE_COMPARE(mesh->attributeCount(MeshAttribute::TextureCoordinates), data.textureCoordinates ? 1 : 0);
+    CORRADE_COMPARE(mesh->attributeCount(MeshAttribute::Color), data.colors ? 1 : 0);
+
+    /* Positions are the same as in mesh() */
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {-1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+
+    /* The option is applied to each opened file, so clearing it brings all
+       attributes back */
+    importer->configuration().setValue("removeComponents", "");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+    mesh = importer->mesh(1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->attributeCount(), 6);
+}
+
+void AssimpImporterTest::meshRemoveComponentsInvalid() {
+    auto&& data = MeshRemoveComponentsInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("removeComponents", data.removeComponents);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openFile(Utility::Path::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+    CORRADE_VERIFY(!importer->openData(*Utility::Path::read(Utility::Path::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae"))));
+    CORRADE_COMPARE(out.str(), Utility::formatString(
+        "Trade::AssimpImporter::openFile(): invalid removeComponents entry {0}\n"
+        "Trade::AssimpImporter::openData(): invalid removeComponents entry {0}\n", data.message));
+}
+
 void AssimpImporterTest::pointMesh() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASSIMPIMPORTER_TEST_DIR, "points.obj")));
@@ -2858,6 +3009,45 @@ void AssimpImporterTest::polygonMesh() {
         }), TestSuite::Compare::Container);
 }
 
+void AssimpImporterTest::polygonMeshLazyPostprocess() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("lazyPostprocess", true);
+    importer->configuration().group("postprocess")->setValue("GenSmoothNormals", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASSIMPIMPORTER_TEST_DIR, "polygon.obj")));
+
+    CORRADE_COMPARE(importer->meshCount(), 1);
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+
+    /* Assimp didn't triangulate the mesh on opening */
+    const aiMesh* state = static_cast<const aiMesh*>(mesh->importerState());
+    CORRADE_VERIFY(state);
+    CORRADE_COMPARE(state->mNumFaces, 1);
+    CORRADE_COMPARE(state->mFaces[0].mNumIndices, 4);
+    CORRADE_VERIFY(!state->HasNormals());
+
+    /* But the imported mesh is the same as in polygonMesh(), with normals
+       generated on import */
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedInt>(),
+        Containers::arrayView<UnsignedInt>({0, 1, 2, 0, 2, 3}),
+        TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(mesh->attributeCount(), 2);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {-1.0f,  1.0f, 0.0f}, { 1.0f,  1.0f, 0.0f},
+            { 1.0f, -1.0f, 0.0f}, {-1.0f, -1.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f},
+            {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f}
+        }), TestSuite::Compare::Container);
+}
+
 #ifdef MAGNUM_BUILD_DEPRECATED
 void AssimpImporterTest::meshCustomAttributes() {
     /* Testing JOINTS and WEIGHTS, which are included only for backwards
@@ -3796,6 +3986,45 @@ void AssimpImporterTest::imageEmbeddedWithPath() {
     CORRADE_COMPARE_AS(image->data(), Containers::arrayView(pixels), TestSuite::Compare::Container);
 }
 
+void AssimpImporterTest::imageEmbeddedDecodeInBackground() {
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("decodeEmbeddedImages", true);
+    importer->configuration().setValue("threads", 0);
+
+    Containers::Optional<Containers::Array<char>> data = Utility::Path::read(Utility::Path::join(ASSIMPIMPORTER_TEST_DIR, "embedded-texture.blend"));
+    CORRADE_VERIFY(data);
+    CORRADE_VERIFY(importer->openData(*data));
+
+    /* Mesh import can happen while the image is being decoded */
+    for(UnsignedInt i = 0; i != importer->meshCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(importer->mesh(i));
+    }
+
+    /* Same as in imageEmbedded() */
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 1);
+    constexpr char pixels[] = { '\xb3', '\x69', '\x00', '\xff' };
+    Containers::Optional<ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i{1});
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayView(pixels), TestSuite::Compare::Container);
+
+    /* A second import goes through the importer again and gives back the
+       same */
+    Containers::Optional<ImageData2D> image2 = importer->image2D(0);
+    CORRADE_VERIFY(image2);
+    CORRADE_COMPARE_AS(image2->data(), Containers::arrayView(pixels), TestSuite::Compare::Container);
+
+    /* Closing while decoding is still in progress doesn't crash */
+    CORRADE_VERIFY(importer->openData(*data));
+    importer->close();
+    CORRADE_VERIFY(!importer->isOpened());
+}
+
 void AssimpImporterTest::imageExternal() {
     if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
         CORRADE_SKIP("PngImporter plugin not found, cannot test");
@@ -4251,6 +4480,33 @@ void AssimpImporterTest::fileCallbackReset() {
     CORRADE_VERIFY(true);
 }
 
+void AssimpImporterTest::fileCallbackLoadOnce() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+
+    Containers::Optional<Containers::Array<char>> dae = Utility::Path::read(Utility::Path::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae"));
+    CORRADE_VERIFY(dae);
+
+    struct File {
+        Containers::Array<char> data;
+        UnsignedInt loaded, closed;
+    } file{*Utility::move(dae), 0, 0};
+    importer->setFileCallback([](const std::string&, InputFileCallbackPolicy policy, File& file) {
+            if(policy == InputFileCallbackPolicy::Close) {
+                ++file.closed;
+                return Containers::Optional<Containers::ArrayView<const char>>{};
+            }
+            ++file.loaded;
+            return Containers::optional(Containers::ArrayView<const char>(file.data));
+        }, file);
+
+    /* Assimp opens the file more than once, but it gets loaded just once and
+       closed after the import is done */
+    CORRADE_VERIFY(importer->openFile("not/a/path/mesh.dae"));
+    CORRADE_COMPARE(importer->meshCount(), 2);
+    CORRADE_COMPARE(file.loaded, 1);
+    CORRADE_COMPARE(file.closed, 1);
+}
+
 void AssimpImporterTest::fileCallbackImage() {
     if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
         CORRADE_SKIP("PngImporter plugin not found, cannot test");
@@ -4304,6 +4560,41 @@ void AssimpImporterTest::fileCallbackImageNotFound() {
     CORRADE_COMPARE(out.str(), "Trade::AbstractImporter::openFile(): cannot open file diffuse_texture.png\n");
 }
 
+void AssimpImporterTest::openFileMapped() {
+    #if !defined(CORRADE_TARGET_UNIX) && (!defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_SKIP("Memory mapping not available on this platform.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("mapFiles", true);
+
+    /* Same as in mesh(), testing just the basics */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+    CORRADE_COMPARE(importer->meshCount(), 2);
+    Containers::Optional<MeshData> mesh = importer->mesh(1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {-1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+
+    /* Files referenced from the opened file go through the mapping too. Same
+       as in materialColorTexture(), Assimp adds a useless first material. */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASSIMPIMPORTER_TEST_DIR, "material-color-texture.obj")));
+    CORRADE_COMPARE(importer->materialCount(), 2);
+
+    /* A nonexistent file fails */
+    {
+        Error silenceError{nullptr};
+        CORRADE_VERIFY(!importer->openFile("nonexistent.dae"));
+    }
+
+    /* Disabling the option goes back to Assimp's own file loading */
+    importer->configuration().setValue("mapFiles", false);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+    CORRADE_COMPARE(importer->meshCount(), 2);
+    #endif
+}
+
 void AssimpImporterTest::openTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
 
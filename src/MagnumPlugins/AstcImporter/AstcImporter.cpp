@@ -25,15 +25,22 @@
 
 #include "AstcImporter.h"
 
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringStl.h> /** @todo remove once file callbacks are <string>-free */
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+#include "Magnum/Implementation/mapFile.h"
+
 namespace Magnum { namespace Trade {
 
 using namespace Containers::Literals;
@@ -61,6 +68,74 @@ static_assert(sizeof(AstcHeader) == 16, "Invalid AstcHeader size");
 /* All ASTC formats are 128-bit blocks */
 constexpr Int AstcBlockDataSize = 128/8;
 
+/* Appends block data of given layer to the output, which contains the
+   header of the first layer with the Z size being the sum of all layers so
+   far. Whether the block size is one of the known ASTC formats is checked in
+   doOpenData() afterwards, here it's just checked that all layers match. */
+bool appendLayer(Containers::Array<char>& out, const UnsignedInt id, const bool last, const Containers::ArrayView<const char> data) {
+    if(data.size() < sizeof(AstcHeader)) {
+        Error{} << "Trade::AstcImporter::openFile(): layer" << id << "header too short, expected at least" << sizeof(AstcHeader) << "bytes but got" << data.size();
+        return false;
+    }
+
+    const AstcHeader& header = *reinterpret_cast<const AstcHeader*>(data.data());
+    if(Containers::StringView{header.magic, 4} != "\x13\xAB\xA1\x5C"_s) {
+        Error{} << "Trade::AstcImporter::openFile(): invalid file magic 0x" << Debug::nospace << Utility::format("{:.8X}", header.magicNumber) << "in layer" << id;
+        return false;
+    }
+
+    const Vector3i blockSize{header.blockSize};
+    const Vector3i size{
+        header.sizeX[0] | header.sizeX[1] << 8 | header.sizeX[2] << 16,
+        header.sizeY[0] | header.sizeY[1] << 8 | header.sizeY[2] << 16,
+        header.sizeZ[0] | header.sizeZ[1] << 8 | header.sizeZ[2] << 16
+    };
+    if(!blockSize.product()) {
+        Error{} << "Trade::AstcImporter::openFile(): invalid block size" << Debug::packed << blockSize << "in layer" << id;
+        return false;
+    }
+
+    Int sizeZ = size.z();
+    if(!id) {
+        arrayAppend(out, data.prefix(sizeof(AstcHeader)));
+    } else {
+        const AstcHeader& firstHeader = *reinterpret_cast<const AstcHeader*>(out.data());
+        const Vector2i firstSize{
+            firstHeader.sizeX[0] | firstHeader.sizeX[1] << 8 | firstHeader.sizeX[2] << 16,
+            firstHeader.sizeY[0] | firstHeader.sizeY[1] << 8 | firstHeader.sizeY[2] << 16
+        };
+        if(blockSize != Vector3i{firstHeader.blockSize} || size.xy() != firstSize) {
+            Error{} << "Trade::AstcImporter::openFile(): expected a" << Debug::packed << firstSize << "image with" << Debug::packed << Vector3i{firstHeader.blockSize} << "blocks in layer" << id << "but got" << Debug::packed << size.xy() << "with" << Debug::packed << blockSize;
+            return false;
+        }
+
+        sizeZ += firstHeader.sizeZ[0] | firstHeader.sizeZ[1] << 8 | firstHeader.sizeZ[2] << 16;
+    }
+
+    /* With 3D blocks, only the last layer can have incomplete blocks in the Z
+       direction, otherwise the blocks couldn't be simply concatenated */
+    if(!last && size.z() % blockSize.z()) {
+        Error{} << "Trade::AstcImporter::openFile(): Z size" << size.z() << "of layer" << id << "is not whole" << Debug::packed << blockSize << "blocks";
+        return false;
+    }
+
+    const std::size_t dataSize = AstcBlockDataSize*((size + blockSize - Vector3i{1})/blockSize).product();
+    if(sizeof(AstcHeader) + dataSize > data.size()) {
+        Error{} << "Trade::AstcImporter::openFile(): layer" << id << "too short, expected" << sizeof(AstcHeader) + dataSize << "bytes but got" << data.size();
+        return false;
+    }
+
+    arrayAppend(out, data.sliceSize(sizeof(AstcHeader), dataSize));
+
+    /* Update the total Z size in the header. The output array may have been
+       reallocated, so fetch the header again. */
+    AstcHeader& outHeader = *reinterpret_cast<AstcHeader*>(out.data());
+    outHeader.sizeZ[0] = sizeZ & 0xff;
+    outHeader.sizeZ[1] = (sizeZ >> 8) & 0xff;
+    outHeader.sizeZ[2] = (sizeZ >> 16) & 0xff;
+    return true;
+}
+
 }
 
 struct AstcImporter::State {
@@ -76,19 +151,98 @@ struct AstcImporter::State {
     /* Needed because the data might be longer */
     std::size_t dataSize;
     Containers::Array<char> data;
+
+    /* Memory-mapped input file, if the mapFile option was enabled. The `data`
+       array is a non-owning view on it in that case. */
+    #ifdef MAGNUM_IMPLEMENTATION_MAP_FILE
+    Magnum::Implementation::MappedFile mapped;
+    #endif
 };
 
 AstcImporter::AstcImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin) : AbstractImporter{manager, plugin} {}
 
 AstcImporter::~AstcImporter() = default;
 
-ImporterFeatures AstcImporter::doFeatures() const { return ImporterFeature::OpenData; }
+ImporterFeatures AstcImporter::doFeatures() const { return ImporterFeature::OpenData|ImporterFeature::FileCallback; }
 
 bool AstcImporter::doIsOpened() const { return !!_state; }
 
 void AstcImporter::doClose() { _state = nullptr; }
 
+void AstcImporter::doOpenFile(const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenFile", filename};
+    /* Multiple files concatenated into a single image. Each of them is loaded
+       and validated just enough to be able to concatenate the block data,
+       the rest of the checks is done in doOpenData() on the result. */
+    if(const UnsignedInt layerCount = configuration().value<UnsignedInt>("layerCount")) {
+        if(!filename.contains("{}"_s)) {
+            Error{} << "Trade::AstcImporter::openFile(): expected a {} placeholder in the filename with layerCount set, got" << filename;
+            return;
+        }
+
+        const Containers::String filenamePattern = Containers::String::nullTerminatedView(filename);
+        Containers::Array<char> out;
+        for(UnsignedInt i = 0; i != layerCount; ++i) {
+            const Containers::String layerFilename = Utility::format(filenamePattern.data(), i);
+
+            /* Load the layer either through the file callback or from the
+               filesystem. The data is copied to the output right away, so
+               it's enough to load it temporarily. */
+            bool appended = false;
+            if(fileCallback()) {
+                if(const Containers::Optional<Containers::ArrayView<const char>> view = fileCallback()(layerFilename, InputFileCallbackPolicy::LoadTemporary, fileCallbackUserData())) {
+                    appended = appendLayer(out, i, i + 1 == layerCount, *view);
+                    fileCallback()(layerFilename, InputFileCallbackPolicy::Close, fileCallbackUserData());
+                    if(!appended) return;
+                }
+            } else if(const Containers::Optional<Containers::Array<char>> read = Utility::Path::read(layerFilename)) {
+                if(!(appended = appendLayer(out, i, i + 1 == layerCount, *read)))
+                    return;
+            }
+            if(!appended) {
+                Error{} << "Trade::AstcImporter::openFile(): cannot open file" << layerFilename;
+                return;
+            }
+        }
+
+        /* Convert the growable array back to a default deleter so we can
+           take it over without a copy */
+        arrayShrink(out, DefaultInit);
+        doOpenData(Utility::move(out), DataFlag::Owned|DataFlag::Mutable);
+        return;
+    }
+
+    /* The file is kept referenced for the whole time it's opened, load it
+       permanently and reference the returned view instead of copying it */
+    if(fileCallback()) {
+        const Containers::Optional<Containers::ArrayView<const char>> view = fileCallback()(filename, InputFileCallbackPolicy::LoadPermanent, fileCallbackUserData());
+        if(!view) {
+            Error{} << "Trade::AstcImporter::openFile(): cannot open file" << filename;
+            return;
+        }
+
+        doOpenData(Containers::Array<char>{const_cast<char*>(view->data()), view->size(), [](char*, std::size_t){}}, DataFlag::ExternallyOwned);
+        return;
+    }
+
+    /* Same as above, but with the file mapped by us */
+    #ifdef MAGNUM_IMPLEMENTATION_MAP_FILE
+    if(configuration().value<bool>("mapFile")) {
+        Containers::Optional<Magnum::Implementation::MappedFile> mapped = Magnum::Implementation::openMappedFile("Trade::AstcImporter::openFile():", filename, [this](Containers::Array<char>&& data, const DataFlags dataFlags) {
+            doOpenData(Utility::move(data), dataFlags);
+        });
+
+        /* Keep the mapping alive for as long as the file is opened */
+        if(mapped && _state) _state->mapped = Utility::move(*mapped);
+        return;
+    }
+    #endif
+
+    AbstractImporter::doOpenFile(filename);
+}
+
 void AstcImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     /* Unlike with e.g. TgaImporter, where doOpenData() only takes over the
        data array, here we need to parse the format to decide whether it's a
        2D or a 3D image. And while at it, why not do also all other checks. */
@@ -218,6 +372,12 @@ UnsignedInt AstcImporter::doImage2DCount() const {
 }
 
 Containers::Optional<ImageData2D> AstcImporter::doImage2D(UnsignedInt, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D"};
+    /* The data are never processed in any way, so a view can be returned
+       directly if requested */
+    if(configuration().value<bool>("zeroCopy"))
+        return ImageData2D{_state->format, _state->size.xy(), DataFlags{}, _state->data.sliceSize(sizeof(AstcHeader), _state->dataSize), ImageFlag2D(UnsignedShort(_state->flags))};
+
     Containers::Array<char> data{NoInit, _state->dataSize};
     Utility::copy(_state->data.slice(sizeof(AstcHeader), sizeof(AstcHeader) + _state->dataSize), data);
     return ImageData2D{_state->format, _state->size.xy(), Utility::move(data), ImageFlag2D(UnsignedShort(_state->flags))};
@@ -228,6 +388,10 @@ UnsignedInt AstcImporter::doImage3DCount() const {
 }
 
 Containers::Optional<ImageData3D> AstcImporter::doImage3D(UnsignedInt, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage3D"};
+    if(configuration().value<bool>("zeroCopy"))
+        return ImageData3D{_state->format, _state->size, DataFlags{}, _state->data.sliceSize(sizeof(AstcHeader), _state->dataSize), _state->flags};
+
     Containers::Array<char> data{NoInit, _state->dataSize};
     Utility::copy(_state->data.slice(sizeof(AstcHeader), sizeof(AstcHeader) + _state->dataSize), data);
     return ImageData3D{_state->format, _state->size, Utility::move(data), _state->flags};
@@ -136,6 +136,42 @@ option enforces use of a 3D ASTC format), but other tools might.
 The plugin recognizes @ref ImporterFlag::Quiet, which will cause all import
 warnings to be suppressed.
 
+@subsection Trade-AstcImporter-behavior-zero-copy Zero-copy import and file callbacks
+
+As the block data are always passed through unchanged, if the
+@cb{.ini} zeroCopy @ce @ref Trade-AstcImporter-configuration "configuration option"
+is enabled, @ref image2D() and @ref image3D() return a non-owning view on the
+opened data instead of a copy, with empty @ref ImageData::dataFlags(). Such
+view is valid only until the importer is closed or another file is opened.
+Combined with @ref openMemory(), with a file callback returning a
+memory-mapped file or with the @cb{.ini} mapFile @ce option, which makes
+@ref openFile() memory-map the file with
+@relativeref{Corrade,Utility::Path::mapRead()} on platforms that support it,
+the block data aren't copied at all.
+
+The plugin supports @ref ImporterFeature::OpenData and
+@ref ImporterFeature::FileCallback features. As the file data are referenced
+for the whole time the file is opened, file callbacks are called with
+@ref InputFileCallbackPolicy::LoadPermanent and the returned view is used
+directly without making a copy. Resources returned from file callbacks can only
+be safely freed after closing the importer instance.
+
+@subsection Trade-AstcImporter-behavior-layers Importing multiple files as a single image
+
+Tools such as the ARM ASTC encoder process 2D array textures and volumes one
+slice at a time and produce a file for each. If the @cb{.ini} layerCount @ce
+@ref Trade-AstcImporter-configuration "configuration option" is set to a
+non-zero value, @ref openFile() expects the filename to contain a `{}`
+placeholder, which is replaced with numbers from @cpp 0 @ce to
+@cpp layerCount - 1 @ce, and all files are
+concatenated along Z into a single 3D image. The files have to have the same
+block size and the same X and Y size. Files with 2D blocks result in an image
+with @ref ImageFlag3D::Array set, files with 3D blocks in a 3D image, in
+which case the Z size of all files except the last has to be whole blocks.
+The layers are loaded through a file callback, if set, with
+@ref InputFileCallbackPolicy::LoadTemporary, and copied into a single
+allocation.
+
 @section Trade-AstcImporter-configuration Plugin-specific configuration
 
 It's possible to tune various import options through @ref configuration(). See
@@ -157,6 +193,7 @@ class MAGNUM_ASTCIMPORTER_EXPORT AstcImporter: public AbstractImporter {
         MAGNUM_ASTCIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_ASTCIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_ASTCIMPORTER_LOCAL void doClose() override;
+        MAGNUM_ASTCIMPORTER_LOCAL void doOpenFile(Containers::StringView filename) override;
         MAGNUM_ASTCIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
 
         MAGNUM_ASTCIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
@@ -65,6 +65,15 @@ struct AstcImporterTest: TestSuite::Tester {
     void fileTooLong3D();
 
     void openMemory();
+    void zeroCopy();
+    void fileCallback();
+    void fileCallbackNotFound();
+    void mapFile();
+
+    void layers();
+    void layersNoPlaceholder();
+    void layersInvalid();
+
     void openTwice();
     void importTwice();
 
@@ -169,6 +178,67 @@ const struct {
     }},
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+    UnsignedInt layerCount;
+    Vector3i expectedSize;
+    ImageFlags3D expectedFlags;
+    std::size_t expectedLayerDataSize;
+} LayersData[]{
+    {"2D blocks", "8x8.astc", 3, {64, 32, 3}, ImageFlag3D::Array, 8*4*128/8},
+    {"2D blocks, arrays", "12x12-array-incomplete-blocks.astc", 2, {27, 27, 4}, ImageFlag3D::Array, 3*3*2*128/8},
+    {"3D blocks", "3x3x3.astc", 2, {27, 27, 6}, {}, 9*9*1*128/8},
+};
+
+const struct {
+    const char* name;
+    Containers::StringView layers[2];
+    const char* message;
+} LayersInvalidData[]{
+    {"header too short",
+        {"\x13\xAB\xA1\x5C" "\x8\x8\x1" "\x1\0\0" "\x1\0\0" "\x1\0\0"
+         "0123456789abcdef"_s,
+         "\x13\xAB\xA1\x5C" "\x8\x8\x1" "\x1\0\0" "\x1\0\0"_s},
+        "layer 1 header too short, expected at least 16 bytes but got 13"},
+    {"bad magic",
+        {"\x13\xAB\xA1\x5C" "\x8\x8\x1" "\x1\0\0" "\x1\0\0" "\x1\0\0"
+         "0123456789abcdef"_s,
+         "\x1E\xAB\xA1\x5C" "\x8\x8\x1" "\x1\0\0" "\x1\0\0" "\x1\0\0"
+         "0123456789abcdef"_s},
+        "invalid file magic 0x5CA1AB1E in layer 1"},
+    {"zero block size",
+        {"\x13\xAB\xA1\x5C" "\x8\x0\x1" "\x1\0\0" "\x1\0\0" "\x1\0\0"
+         "0123456789abcdef"_s,
+         "\x13\xAB\xA1\x5C" "\x8\x8\x1" "\x1\0\0" "\x1\0\0" "\x1\0\0"
+         "0123456789abcdef"_s},
+        "invalid block size {8, 0, 1} in layer 0"},
+    {"different block size",
+        {"\x13\xAB\xA1\x5C" "\x8\x8\x1" "\x1\0\0" "\x1\0\0" "\x1\0\0"
+         "0123456789abcdef"_s,
+         "\x13\xAB\xA1\x5C" "\x6\x6\x1" "\x1\0\0" "\x1\0\0" "\x1\0\0"
+         "0123456789abcdef"_s},
+        "expected a {1, 1} image with {8, 8, 1} blocks in layer 1 but got {1, 1} with {6, 6, 1}"},
+    {"different size",
+        {"\x13\xAB\xA1\x5C" "\x8\x8\x1" "\x1\0\0" "\x1\0\0" "\x1\0\0"
+         "0123456789abcdef"_s,
+         "\x13\xAB\xA1\x5C" "\x8\x8\x1" "\x1\0\0" "\x2\0\0" "\x1\0\0"
+         "0123456789abcdef"_s},
+        "expected a {1, 1} image with {8, 8, 1} blocks in layer 1 but got {1, 2} with {8, 8, 1}"},
+    {"incomplete Z blocks", /* 1x1x1 3D blocks */
+        {"\x13\xAB\xA1\x5C" "\x3\x3\x3" "\x1\0\0" "\x1\0\0" "\x2\0\0"
+         "0123456789abcdef"_s,
+         "\x13\xAB\xA1\x5C" "\x3\x3\x3" "\x1\0\0" "\x1\0\0" "\x3\0\0"
+         "0123456789abcdef"_s},
+        "Z size 2 of layer 0 is not whole {3, 3, 3} blocks"},
+    {"layer too short",
+        {"\x13\xAB\xA1\x5C" "\x8\x8\x1" "\x1\0\0" "\x1\0\0" "\x1\0\0"
+         "0123456789abcdef"_s,
+         "\x13\xAB\xA1\x5C" "\x8\x8\x1" "\x1\0\0" "\x1\0\0" "\x1\0\0"
+         "0123456789abcde"_s},
+        "layer 1 too short, expected 32 bytes but got 31"},
+};
+
 AstcImporterTest::AstcImporterTest() {
     addTests({&AstcImporterTest::empty2D,
               &AstcImporterTest::empty3D,
@@ -199,6 +269,19 @@ AstcImporterTest::AstcImporterTest() {
     addInstancedTests({&AstcImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
+    addTests({&AstcImporterTest::zeroCopy,
+              &AstcImporterTest::fileCallback,
+              &AstcImporterTest::fileCallbackNotFound,
+              &AstcImporterTest::mapFile});
+
+    addInstancedTests({&AstcImporterTest::layers},
+        Containers::arraySize(LayersData));
+
+    addTests({&AstcImporterTest::layersNoPlaceholder});
+
+    addInstancedTests({&AstcImporterTest::layersInvalid},
+        Containers::arraySize(LayersInvalidData));
+
     addTests({&AstcImporterTest::openTwice,
               &AstcImporterTest::importTwice});
 
@@ -562,6 +645,172 @@ void AstcImporterTest::openMemory() {
     CORRADE_COMPARE(image->data()[1], '\x84');
 }
 
+void AstcImporterTest::zeroCopy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    importer->configuration().setValue("zeroCopy", true);
+
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(ASTCIMPORTER_TEST_DIR, "3x3x3.astc"));
+    CORRADE_VERIFY(memory);
+    CORRADE_VERIFY(importer->openMemory(*memory));
+
+    /* The data points directly into the passed memory, right after the
+       header */
+    Containers::Optional<Trade::ImageData3D> image = importer->image3D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Astc3x3x3RGBAUnorm);
+    CORRADE_COMPARE(image->size(), (Vector3i{27, 27, 3}));
+    CORRADE_COMPARE(static_cast<const void*>(image->data().data()), static_cast<const void*>(memory->data() + 16));
+    CORRADE_COMPARE(image->data().size(), 9*9*1*128/8);
+}
+
+void AstcImporterTest::fileCallback() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    CORRADE_VERIFY(importer->features() & ImporterFeature::FileCallback);
+    importer->configuration().setValue("zeroCopy", true);
+
+    struct CallbackData {
+        Containers::Optional<Containers::Array<char>> data;
+        std::string filename;
+        std::size_t count;
+        InputFileCallbackPolicy policy;
+    } callbackData{Utility::Path::read(Utility::Path::join(ASTCIMPORTER_TEST_DIR, "8x8.astc")), {}, 0, InputFileCallbackPolicy::Close};
+    CORRADE_VERIFY(callbackData.data);
+
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy policy, CallbackData& callbackData)
+            -> Containers::Optional<Containers::ArrayView<const char>>
+        {
+            callbackData.filename = filename;
+            ++callbackData.count;
+            callbackData.policy = policy;
+            return Containers::arrayView(*callbackData.data);
+        }, callbackData);
+
+    CORRADE_VERIFY(importer->openFile("some/path/8x8.astc"));
+
+    /* The file is loaded permanently and never closed */
+    CORRADE_COMPARE(callbackData.filename, "some/path/8x8.astc");
+    CORRADE_COMPARE(callbackData.count, 1);
+    CORRADE_COMPARE(callbackData.policy, InputFileCallbackPolicy::LoadPermanent);
+
+    /* The data is referenced directly, without any copy */
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+    CORRADE_COMPARE(static_cast<const void*>(image->data().data()), static_cast<const void*>(callbackData.data->data() + 16));
+    CORRADE_COMPARE(image->size(), (Vector2i{64, 32}));
+
+    importer->close();
+    CORRADE_COMPARE(callbackData.count, 1);
+}
+
+void AstcImporterTest::fileCallbackNotFound() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    importer->setFileCallback([](const std::string&, InputFileCallbackPolicy, void*)
+        -> Containers::Optional<Containers::ArrayView<const char>> { return {}; });
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openFile("some-file.astc"));
+    CORRADE_COMPARE(out.str(), "Trade::AstcImporter::openFile(): cannot open file some-file.astc\n");
+}
+
+void AstcImporterTest::mapFile() {
+    #if !defined(CORRADE_TARGET_UNIX) && (!defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_SKIP("Memory mapping not available on this platform.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    importer->configuration().setValue("mapFile", true);
+    /* Reference the mapped memory directly to verify it stays valid */
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASTCIMPORTER_TEST_DIR, "8x8.astc")));
+
+    Containers::Optional<Containers::Array<char>> expected = Utility::Path::read(Utility::Path::join(ASTCIMPORTER_TEST_DIR, "8x8.astc"));
+    CORRADE_VERIFY(expected);
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+    CORRADE_COMPARE(image->size(), (Vector2i{64, 32}));
+    CORRADE_COMPARE_AS(image->data(), expected->exceptPrefix(16), TestSuite::Compare::Container);
+    #endif
+}
+
+void AstcImporterTest::layers() {
+    auto&& data = LayersData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    importer->configuration().setValue("layerCount", data.layerCount);
+
+    /* Supply the same file for every layer, remember which were requested */
+    struct CallbackData {
+        Containers::Optional<Containers::Array<char>> data;
+        std::string filenames;
+    } callbackData{Utility::Path::read(Utility::Path::join(ASTCIMPORTER_TEST_DIR, data.filename)), {}};
+    CORRADE_VERIFY(callbackData.data);
+
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy policy, CallbackData& callbackData)
+            -> Containers::Optional<Containers::ArrayView<const char>>
+        {
+            if(policy == InputFileCallbackPolicy::LoadTemporary)
+                callbackData.filenames += filename + ";";
+            else if(policy == InputFileCallbackPolicy::Close)
+                callbackData.filenames += "close;";
+            return Containers::arrayView(*callbackData.data);
+        }, callbackData);
+
+    CORRADE_VERIFY(importer->openFile("layer-{}.astc"));
+    CORRADE_COMPARE(callbackData.filenames, data.layerCount == 3 ?
+        "layer-0.astc;close;layer-1.astc;close;layer-2.astc;close;" :
+        "layer-0.astc;close;layer-1.astc;close;");
+    CORRADE_COMPARE(importer->image2DCount(), 0);
+    CORRADE_COMPARE(importer->image3DCount(), 1);
+
+    Containers::Optional<Trade::ImageData3D> image = importer->image3D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), data.expectedSize);
+    CORRADE_COMPARE(image->flags(), data.expectedFlags);
+    CORRADE_COMPARE(image->data().size(), data.layerCount*data.expectedLayerDataSize);
+
+    /* Each layer is the same data */
+    for(UnsignedInt i = 0; i != data.layerCount; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE_AS(image->data().sliceSize(i*data.expectedLayerDataSize, data.expectedLayerDataSize),
+            callbackData.data->sliceSize(16, data.expectedLayerDataSize),
+            TestSuite::Compare::Container);
+    }
+}
+
+void AstcImporterTest::layersNoPlaceholder() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    importer->configuration().setValue("layerCount", 2);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openFile("layer.astc"));
+    CORRADE_COMPARE(out.str(), "Trade::AstcImporter::openFile(): expected a {} placeholder in the filename with layerCount set, got layer.astc\n");
+}
+
+void AstcImporterTest::layersInvalid() {
+    auto&& data = LayersInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    importer->configuration().setValue("layerCount", 2);
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy, void* userData)
+            -> Containers::Optional<Containers::ArrayView<const char>>
+        {
+            const Containers::StringView layer = static_cast<const Containers::StringView*>(userData)[filename == "1.astc" ? 1 : 0];
+            return Containers::arrayView(layer.data(), layer.size());
+        }, const_cast<Containers::StringView*>(data.layers));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openFile("{}.astc"));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::AstcImporter::openFile(): {}\n", data.message));
+}
+
 void AstcImporterTest::openTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
 
@@ -27,22 +27,31 @@
 
 #include "BasisImageConverter.h"
 
+#include <cmath>
 #include <thread>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/Sha1.h>
 #include <Corrade/Utility/String.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/Math/Color.h>
+#include <Magnum/Math/Constants.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Swizzle.h>
 #include <Magnum/PixelFormat.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
 #include <basisu_enc.h>
 #include <basisu_comp.h>
 #include <basisu_file_headers.h>
@@ -53,7 +62,7 @@ using namespace Containers::Literals;
 
 namespace {
 
-template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> convertLevelsToData(Containers::ArrayView<const BasicImageView<dimensions>> imageLevels, const Utility::ConfigurationGroup& configuration, ImageConverterFlags flags, BasisImageConverter::Format fileFormat) {
+template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> convertLevelsToData(Containers::ArrayView<const BasicImageView<dimensions>> imageLevels, const Utility::ConfigurationGroup& configuration, ImageConverterFlags flags, BasisImageConverter::Format fileFormat, Containers::Pointer<basisu::job_pool>& jobPool) {
     /* Check input */
     const PixelFormat pixelFormat = imageLevels.front().format();
     bool isSrgb;
@@ -184,8 +193,11 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
     if(threadCount == 0) threadCount = std::thread::hardware_concurrency();
     const bool multithreading = threadCount > 1;
     params.m_multithreading = multithreading;
-    basisu::job_pool jpool{threadCount};
-    params.m_pJob_pool = &jpool;
+    /* Creating the pool spawns the worker threads, so it's kept across
+       conversions and recreated only if the thread count changes */
+    if(!jobPool || jobPool->get_total_threads() != threadCount)
+        jobPool.emplace(threadCount);
+    params.m_pJob_pool = jobPool.get();
 
     PARAM_CONFIG(disable_hierarchical_endpoint_codebooks, bool);
 
@@ -224,6 +236,27 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
     PARAM_CONFIG(rdo_uastc_favor_simpler_modes_in_rdo_mode, bool);
     params.m_rdo_uastc_multithreading = multithreading;
 
+    /* Rate control, overrides quality_level or rdo_uastc_quality_scalar if
+       enabled */
+    const UnsignedLong targetSize = configuration.value<UnsignedLong>("targetSize");
+    const Float targetPsnr = configuration.value<Float>("targetPsnr");
+    if(targetSize && targetPsnr) {
+        Error{} << "Trade::BasisImageConverter::convertToData(): the targetSize and targetPsnr options are mutually exclusive";
+        return {};
+    }
+    if((targetSize || targetPsnr) && params.m_uastc && !params.m_rdo_uastc) {
+        Error{} << "Trade::BasisImageConverter::convertToData(): rate control for UASTC requires rdo_uastc to be enabled";
+        return {};
+    }
+    const UnsignedInt rateControlMaxTrials = configuration.value<UnsignedInt>("rateControlMaxTrials");
+    if((targetSize || targetPsnr) && !rateControlMaxTrials) {
+        Error{} << "Trade::BasisImageConverter::convertToData(): rateControlMaxTrials has to be at least 1";
+        return {};
+    }
+    /* PSNR of the encoded images is only calculated if stats are enabled */
+    if(targetPsnr)
+        params.m_compute_stats = true;
+
     /* KTX2 options */
     params.m_ktx2_uastc_supercompression =
         configuration.value<bool>("ktx2_uastc_supercompression") ? basist::KTX2_SS_ZSTANDARD : basist::KTX2_SS_NONE;
@@ -259,7 +292,8 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
     params.m_read_source_images = false;
     params.m_write_output_basis_files = false;
     /* One image per slice. The base mip is in m_source_images, mip 1 and
-       higher go into m_source_mipmap_images. */
+       higher go into m_source_mipmap_images. All of them are then encoded in
+       a single process() call, sharing the codebooks. */
     const UnsignedInt numImages = Vector3i::pad(baseSize, 1).z();
     params.m_source_images.resize(numImages);
     if(numMipmaps > 1) {
@@ -339,54 +373,156 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
         }
     }
 
+    /* The compressor and the source images in params are set up just once
+       and reused for all trial encodes if rate control is enabled */
     basisu::basis_compressor basis;
-    basis.init(params);
+    const auto encode = [&]() -> bool {
+        basis.init(params);
+
+        const basisu::basis_compressor::error_code errorCode = basis.process();
+        if(errorCode != basisu::basis_compressor::error_code::cECSuccess) switch(errorCode) {
+            case basisu::basis_compressor::error_code::cECFailedReadingSourceImages:
+                /* Emitted e.g. when source image is 0-size */
+                Error{} << "Trade::BasisImageConverter::convertToData(): source image is invalid";
+                return false;
+            case basisu::basis_compressor::error_code::cECFailedValidating:
+                /* process() will have printed additional error information to stderr */
+                Error{} << "Trade::BasisImageConverter::convertToData(): type constraint validation failed";
+                return false;
+            case basisu::basis_compressor::error_code::cECFailedEncodeUASTC:
+                Error{} << "Trade::BasisImageConverter::convertToData(): UASTC encoding failed";
+                return false;
+            case basisu::basis_compressor::error_code::cECFailedFrontEnd:
+                /* process() will have printed additional error information to stderr */
+                Error{} << "Trade::BasisImageConverter::convertToData(): frontend processing failed";
+                return false;
+            case basisu::basis_compressor::error_code::cECFailedBackend:
+                Error{} << "Trade::BasisImageConverter::convertToData(): encoding failed";
+                return false;
+            case basisu::basis_compressor::error_code::cECFailedCreateBasisFile:
+                /* process() will have printed additional error information to stderr */
+                Error{} << "Trade::BasisImageConverter::convertToData(): assembling basis file data or transcoding failed";
+                return false;
+            case basisu::basis_compressor::error_code::cECFailedUASTCRDOPostProcess:
+                Error{} << "Trade::BasisImageConverter::convertToData(): UASTC RDO postprocessing failed";
+                return false;
+            case basisu::basis_compressor::error_code::cECFailedCreateKTX2File:
+                Error{} << "Trade::BasisImageConverter::convertToData(): assembling KTX2 file failed";
+                return false;
+
+            /* LCOV_EXCL_START */
+            case basisu::basis_compressor::error_code::cECFailedFontendExtract:
+                /* This error will actually never be raised from basis_universal code */
+            case basisu::basis_compressor::error_code::cECFailedWritingOutput:
+                /* We do not write any files, just data */
+            default:
+                CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+            /* LCOV_EXCL_STOP */
+        }
 
-    const basisu::basis_compressor::error_code errorCode = basis.process();
-    if(errorCode != basisu::basis_compressor::error_code::cECSuccess) switch(errorCode) {
-        case basisu::basis_compressor::error_code::cECFailedReadingSourceImages:
-            /* Emitted e.g. when source image is 0-size */
-            Error{} << "Trade::BasisImageConverter::convertToData(): source image is invalid";
-            return {};
-        case basisu::basis_compressor::error_code::cECFailedValidating:
-            /* process() will have printed additional error information to stderr */
-            Error{} << "Trade::BasisImageConverter::convertToData(): type constraint validation failed";
-            return {};
-        case basisu::basis_compressor::error_code::cECFailedEncodeUASTC:
-            Error{} << "Trade::BasisImageConverter::convertToData(): UASTC encoding failed";
-            return {};
-        case basisu::basis_compressor::error_code::cECFailedFrontEnd:
-            /* process() will have printed additional error information to stderr */
-            Error{} << "Trade::BasisImageConverter::convertToData(): frontend processing failed";
-            return {};
-        case basisu::basis_compressor::error_code::cECFailedBackend:
-            Error{} << "Trade::BasisImageConverter::convertToData(): encoding failed";
-            return {};
-        case basisu::basis_compressor::error_code::cECFailedCreateBasisFile:
-            /* process() will have printed additional error information to stderr */
-            Error{} << "Trade::BasisImageConverter::convertToData(): assembling basis file data or transcoding failed";
-            return {};
-        case basisu::basis_compressor::error_code::cECFailedUASTCRDOPostProcess:
-            Error{} << "Trade::BasisImageConverter::convertToData(): UASTC RDO postprocessing failed";
-            return {};
-        case basisu::basis_compressor::error_code::cECFailedCreateKTX2File:
-            Error{} << "Trade::BasisImageConverter::convertToData(): assembling KTX2 file failed";
-            return {};
+        return true;
+    };
+    const auto output = [&]() {
+        const basisu::uint8_vec& out = params.m_create_ktx2_file ? basis.get_output_ktx2_file() : basis.get_output_basis_file();
+        Containers::Array<char> data{NoInit, out.size()};
+        Utility::copy(Containers::arrayCast<const char>(Containers::arrayView(out.data(), out.size())), data);
+        return data;
+    };
+
+    Containers::Array<char> fileData;
+    if(!targetSize && !targetPsnr) {
+        if(!encode()) return {};
+        fileData = output();
+
+    /* Search for the quality that reaches the target. The quality is
+       parametrized with an index where a higher value means a higher quality
+       and a larger output -- directly the quality level for ETC1S and a
+       logarithmic scale from 10.0 to 0.1 for the UASTC RDO quality scalar.
+       Both the output size and PSNR are assumed to grow with the index, the
+       search then keeps the nearest encoded indices below and above the
+       target and interpolates between them to estimate where the target is,
+       which usually converges much faster than a plain bisection. */
+    } else {
+        const Int indexCount = params.m_uastc ? 64 : 255;
+        const Double target = targetSize ? Double(targetSize) : Double(targetPsnr);
+        /* Alpha is significant for four-component images and for
+           two-component images implicitly swizzled to RRRG */
+        const bool hasAlpha = channelCount == 4 || (channelCount == 2 && !swizzle);
+
+        Int belowIndex = -1, aboveIndex = indexCount;
+        Double belowValue{}, aboveValue{};
+        Containers::Array<char> belowData, aboveData;
+        for(UnsignedInt trial = 0; trial != rateControlMaxTrials && aboveIndex - belowIndex > 1; ++trial) {
+            Int index;
+            if(belowIndex != -1 && aboveIndex != indexCount)
+                index = belowIndex + Int(Math::round((target - belowValue)/(aboveValue - belowValue)*(aboveIndex - belowIndex)));
+            else
+                index = (belowIndex + aboveIndex)/2;
+            index = Math::clamp(index, belowIndex + 1, aboveIndex - 1);
+
+            if(params.m_uastc)
+                params.m_rdo_uastc_quality_scalar = std::pow(10.0f, 1.0f - 2.0f*index/(indexCount - 1));
+            else
+                params.m_quality_level = index + 1;
+
+            if(!encode()) return {};
+
+            Double value;
+            if(targetSize) {
+                value = params.m_create_ktx2_file ? basis.get_output_ktx2_file().size() : basis.get_output_basis_file().size();
+            } else {
+                /* Take the worst of all encoded slices and levels */
+                value = Constantsd::inf();
+                for(const basisu::image_stats& stats: basis.get_stats())
+                    value = Math::min(value, Double(hasAlpha ? stats.m_basis_rgba_avg_psnr : stats.m_basis_rgb_avg_psnr));
+            }
 
-        /* LCOV_EXCL_START */
-        case basisu::basis_compressor::error_code::cECFailedFontendExtract:
-            /* This error will actually never be raised from basis_universal code */
-        case basisu::basis_compressor::error_code::cECFailedWritingOutput:
-            /* We do not write any files, just data */
-        default:
-            CORRADE_INTERNAL_ASSERT_UNREACHABLE();
-        /* LCOV_EXCL_STOP */
-    }
+            if(flags & ImageConverterFlag::Verbose) {
+                Debug out;
+                out << "Trade::BasisImageConverter::convertToData(): rate control trial" << trial << "with";
+                if(params.m_uastc)
+                    out << "rdo_uastc_quality_scalar" << params.m_rdo_uastc_quality_scalar;
+                else
+                    out << "quality_level" << params.m_quality_level;
+                if(targetSize)
+                    out << "produced" << UnsignedLong(value) << "bytes";
+                else
+                    out << "has PSNR" << value;
+            }
 
-    const basisu::uint8_vec& out = params.m_create_ktx2_file ? basis.get_output_ktx2_file() : basis.get_output_basis_file();
+            /* The target size is an upper bound, the target PSNR a lower
+               bound. Stop early if close enough to the target. */
+            if(targetSize ? value <= target : value < target) {
+                belowIndex = index;
+                belowValue = value;
+                belowData = output();
+                if(targetSize && value >= target*0.97) break;
+            } else {
+                aboveIndex = index;
+                aboveValue = value;
+                aboveData = output();
+                if(targetPsnr && value <= target + 0.25) break;
+            }
+        }
 
-    Containers::Array<char> fileData{NoInit, out.size()};
-    Utility::copy(Containers::arrayCast<const char>(Containers::arrayView(out.data(), out.size())), fileData);
+        /* Pick the highest quality that fits the size or the lowest quality
+           that reaches the PSNR. If there's none, use the nearest and warn. */
+        if(targetSize) {
+            if(belowData) fileData = Utility::move(belowData);
+            else {
+                fileData = Utility::move(aboveData);
+                if(!(flags & ImageConverterFlag::Quiet))
+                    Warning{} << "Trade::BasisImageConverter::convertToData(): can't reach target size of" << targetSize << "bytes, smallest output has" << UnsignedLong(aboveValue) << "bytes";
+            }
+        } else {
+            if(aboveData) fileData = Utility::move(aboveData);
+            else {
+                fileData = Utility::move(belowData);
+                if(!(flags & ImageConverterFlag::Quiet))
+                    Warning{} << "Trade::BasisImageConverter::convertToData(): can't reach target PSNR of" << targetPsnr << "dB, best output has" << belowValue << "dB";
+            }
+        }
+    }
 
     /* UASTC output in a Basis container has the sRGB flag set always, patch it
        away if the data is not sRGB. Doesn't happen with ETC1S and doesn't
@@ -423,6 +559,8 @@ BasisImageConverter::BasisImageConverter(PluginManager::AbstractManager& manager
         _format = {}; /* Overridable by openFile() */
 }
 
+BasisImageConverter::~BasisImageConverter() = default;
+
 ImageConverterFeatures BasisImageConverter::doFeatures() const {
     return ImageConverterFeature::Convert2DToData|
            ImageConverterFeature::Convert3DToData|
@@ -441,12 +579,80 @@ Containers::String BasisImageConverter::doMimeType() const {
     return {};
 }
 
+template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> BasisImageConverter::convertLevelsToDataCached(const Containers::ArrayView<const BasicImageView<dimensions>> imageLevels) {
+    const Containers::StringView cacheDirectory = configuration().value<Containers::StringView>("cacheDirectory");
+    if(!cacheDirectory)
+        return convertLevelsToData(imageLevels, configuration(), flags(), _format, _jobPool);
+
+    /* Hash everything that affects the output -- file format, basisu version,
+       image properties, all pixel data without padding and all encoder
+       options. Keep the option list in sync with the conf file. The thread
+       count doesn't affect the output so it's not included. */
+    Utility::Sha1 sha1;
+    const auto hash = [&sha1](const Containers::StringView string) {
+        sha1 << Containers::ArrayView<const char>{string.data(), string.size()} << Containers::ArrayView<const char>{"\n", 1};
+    };
+    const bool isKtx = _format == Format::Ktx;
+    hash(isKtx ? "ktx2"_s : "basis"_s);
+    #ifdef BASISU_LIB_VERSION
+    hash(Utility::format("{}", BASISU_LIB_VERSION));
+    #endif
+    for(const BasicImageView<dimensions>& image: imageLevels) {
+        const ImageView3D image3D{image};
+        hash(Utility::format("{} {} {} {} {} {}", dimensions, UnsignedInt(image3D.format()), image3D.size().x(), image3D.size().y(), image3D.size().z(), UnsignedShort(image.flags())));
+        const Containers::StridedArrayView4D<const char> pixels = image3D.pixels();
+        for(std::size_t z = 0; z != pixels.size()[0]; ++z)
+            for(std::size_t y = 0; y != pixels.size()[1]; ++y)
+                sha1 << pixels[z][y].asContiguous();
+    }
+    for(const char* name: {
+        "quality_level", "perceptual", "debug", "validate", "debug_images",
+        "compute_stats", "compression_level",
+        "max_endpoint_clusters", "max_selector_clusters", "y_flip",
+        "check_for_alpha", "force_alpha", "swizzle", "renormalize",
+        "resample_width", "resample_height", "resample_factor",
+        "disable_hierarchical_endpoint_codebooks",
+        "mip_gen", "mip_srgb", "mip_scale", "mip_filter", "mip_renormalize",
+        "mip_wrapping", "mip_fast", "mip_smallest_dimension",
+        "no_selector_rdo", "selector_rdo_threshold", "no_endpoint_rdo",
+        "endpoint_rdo_threshold",
+        "uastc", "pack_uastc_level", "pack_uastc_flags", "rdo_uastc",
+        "rdo_uastc_quality_scalar", "rdo_uastc_dict_size",
+        "rdo_uastc_max_smooth_block_error_scale",
+        "rdo_uastc_smooth_block_max_std_dev",
+        "rdo_uastc_max_allowed_rms_increase_ratio",
+        "rdo_uastc_skip_block_rms_threshold",
+        "rdo_uastc_favor_simpler_modes_in_rdo_mode",
+        "ktx2_uastc_supercompression", "ktx2_zstd_supercompression_level",
+        "userdata0", "userdata1",
+        "targetSize", "targetPsnr", "rateControlMaxTrials"})
+        hash(Utility::format("{}={}", name, configuration().value<Containers::StringView>(name)));
+
+    const Containers::String filename = Utility::Path::join(cacheDirectory, Utility::format("{}.{}", sha1.digest().hexString(), isKtx ? "ktx2" : "basis"));
+    if(Utility::Path::exists(filename)) {
+        if(Containers::Optional<Containers::Array<char>> cached = Utility::Path::read(filename)) {
+            if(flags() & ImageConverterFlag::Verbose)
+                Debug{} << "Trade::BasisImageConverter::convertToData(): using cached" << filename;
+            return cached;
+        }
+    }
+
+    Containers::Optional<Containers::Array<char>> out = convertLevelsToData(imageLevels, configuration(), flags(), _format, _jobPool);
+    /* Failing to save to the cache isn't fatal, the output is still valid */
+    if(out && (!Utility::Path::make(cacheDirectory) || !Utility::Path::write(filename, *out)))
+        Warning{} << "Trade::BasisImageConverter::convertToData(): can't save the output to cache directory" << cacheDirectory;
+
+    return out;
+}
+
 Containers::Optional<Containers::Array<char>> BasisImageConverter::doConvertToData(Containers::ArrayView<const ImageView2D> imageLevels) {
-    return convertLevelsToData(imageLevels, configuration(), flags(), _format);
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
+    return convertLevelsToDataCached(imageLevels);
 }
 
 Containers::Optional<Containers::Array<char>> BasisImageConverter::doConvertToData(Containers::ArrayView<const ImageView3D> imageLevels) {
-    return convertLevelsToData(imageLevels, configuration(), flags(), _format);
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
+    return convertLevelsToDataCached(imageLevels);
 }
 
 template<UnsignedInt dimensions> bool BasisImageConverter::convertLevelsToFile(const Containers::ArrayView<const BasicImageView<dimensions>> imageLevels, const Containers::StringView filename) {
@@ -471,10 +677,12 @@ template<UnsignedInt dimensions> bool BasisImageConverter::convertLevelsToFile(c
 }
 
 bool BasisImageConverter::doConvertToFile(Containers::ArrayView<const ImageView2D> imageLevels, const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToFile", filename};
     return convertLevelsToFile(imageLevels, filename);
 }
 
 bool BasisImageConverter::doConvertToFile(Containers::ArrayView<const ImageView3D> imageLevels, const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToFile", filename};
     return convertLevelsToFile(imageLevels, filename);
 }
 
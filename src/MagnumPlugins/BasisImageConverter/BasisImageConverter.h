@@ -32,6 +32,7 @@
  * @m_since_{plugins,2019,10}
  */
 
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractImageConverter.h>
 
 #include "MagnumPlugins/BasisImageConverter/configure.h"
@@ -52,6 +53,10 @@
 #define MAGNUM_BASISIMAGECONVERTER_LOCAL
 #endif
 
+#ifndef DOXYGEN_GENERATING_OUTPUT
+namespace basisu { class job_pool; }
+#endif
+
 namespace Magnum { namespace Trade {
 
 /**
@@ -173,6 +178,11 @@ first, with each following level having width and height divided by two,
 rounded down. Because only 2D array images are supported, depth has to have the
 same size in all levels. Incomplete mip chains are supported.
 
+All supplied levels of all slices are encoded together in a single
+`basis_compressor` run, not one by one, so the ETC1S endpoint and selector
+codebooks are shared across the whole mip chain. The
+@cb{.ini} mip_gen @ce option is ignored with a warning in this case.
+
 To generate mip levels from a single top-level image instead, you can use the
 @cb{.ini} mip_gen @ce @ref Trade-BasisImageConverter-configuration "configuration option".
 
@@ -233,6 +243,59 @@ manager) is populating global safe in a non-thread-safe way. Thus you have to
 ensure that the plugin isn't loaded from multiple threads at the same time, or
 loaded while being already used from another thread.
 
+If the @cb{.ini} threads @ce
+@ref Trade-BasisImageConverter-configuration "configuration option" is set to
+something else than @cpp 1 @ce, the worker thread pool is created on the first
+conversion and then kept for all following conversions done with the same
+converter instance, until the thread count changes or the instance is
+destroyed. Converting many small images with a single instance thus doesn't
+pay the cost of spawning and joining the threads every time. The pool is not
+meant to be shared across instances --- in order to convert several images
+concurrently, use a dedicated converter instance on each thread.
+
+@subsection Trade-BasisImageConverter-behavior-simd SIMD-accelerated encoding
+
+If Basis Universal is built from sources supplied via `BASIS_UNIVERSAL_DIR`
+on x86, its SSE 4.1 encoder kernels are compiled in. Whether they're used is
+decided at runtime in @ref initialize() based on what the CPU supports, with
+a fallback to the scalar implementation, so there's no configuration option
+for it. A Basis Universal installation found through its CMake config, such as
+from Vcpkg, is used with whatever it was built with.
+
+@subsection Trade-BasisImageConverter-behavior-cache Output cache
+
+If the @cb{.ini} cacheDirectory @ce
+@ref Trade-BasisImageConverter-configuration "configuration option" is set,
+encoded output is saved to given directory, named after a SHA-1 hash of the
+output file format, Basis Universal version, size, format and flags of all
+input levels, their pixel data and all encoder options. On subsequent
+conversions with the same input and options the cached file is returned
+without encoding anything, which makes repeated asset builds with slow
+settings such as UASTC RDO significantly faster. Warnings printed during
+encoding aren't repeated on a cache hit. The cache is never cleaned up by the
+plugin, and a failure to write to it only prints a warning.
+
+@subsection Trade-BasisImageConverter-behavior-rate-control Rate control
+
+Instead of picking the @cb{.ini} quality_level @ce or
+@cb{.ini} rdo_uastc_quality_scalar @ce manually, the @cb{.ini} targetSize @ce
+@ref Trade-BasisImageConverter-configuration "configuration option" can be set
+to a maximum output size in bytes, or @cb{.ini} targetPsnr @ce to a minimum
+PSNR in dB. The plugin then searches for the highest quality that fits into
+given size or the lowest quality that reaches given PSNR, respectively. The
+PSNR is the worst across all slices and levels, calculated by Basis Universal
+itself on RGB or RGBA channels depending on whether the input has an alpha
+channel. For UASTC, the @cb{.ini} rdo_uastc @ce option has to be enabled.
+
+The source images and the `basis_compressor` instance are prepared only once
+and reused for all trial encodes. The search interpolates between the nearest
+trials that are below and above the target to estimate the next trial, and
+stops once the output is within 3% of the target size or 0.25 dB above the
+target PSNR, or after @cb{.ini} rateControlMaxTrials @ce encodes. If the target
+can't be reached, the smallest or the highest-quality output found is used and
+a warning is printed. With @ref ImageConverterFlag::Verbose, parameters and
+results of each trial are printed.
+
 @section Trade-BasisImageConverter-configuration Plugin-specific configuration
 
 Basis compression can be configured to produce better quality or reduce
@@ -284,6 +347,8 @@ class MAGNUM_BASISIMAGECONVERTER_EXPORT BasisImageConverter: public AbstractImag
         /** @brief Plugin manager constructor */
         explicit BasisImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
+        ~BasisImageConverter();
+
     private:
         MAGNUM_BASISIMAGECONVERTER_LOCAL ImageConverterFeatures doFeatures() const override;
         MAGNUM_BASISIMAGECONVERTER_LOCAL Containers::String doExtension() const override;
@@ -292,12 +357,16 @@ class MAGNUM_BASISIMAGECONVERTER_EXPORT BasisImageConverter: public AbstractImag
         MAGNUM_BASISIMAGECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(Containers::ArrayView<const ImageView2D> imageLevels) override;
         MAGNUM_BASISIMAGECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(Containers::ArrayView<const ImageView3D> imageLevels) override;
 
+        template<UnsignedInt dimensions> MAGNUM_BASISIMAGECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> convertLevelsToDataCached(Containers::ArrayView<const BasicImageView<dimensions>> imageLevels);
+
         template<UnsignedInt dimensions> MAGNUM_BASISIMAGECONVERTER_LOCAL bool convertLevelsToFile(const Containers::ArrayView<const BasicImageView<dimensions>> imageLevels, const Containers::StringView filename);
 
         MAGNUM_BASISIMAGECONVERTER_LOCAL bool doConvertToFile(const Containers::ArrayView<const ImageView2D> imageLevels, const Containers::StringView filename) override;
         MAGNUM_BASISIMAGECONVERTER_LOCAL bool doConvertToFile(const Containers::ArrayView<const ImageView3D> imageLevels, const Containers::StringView filename) override;
 
         Format _format;
+        /* Kept across conversions, see Trade-BasisImageConverter-behavior-multithreading */
+        Containers::Pointer<basisu::job_pool> _jobPool;
 };
 
 }}
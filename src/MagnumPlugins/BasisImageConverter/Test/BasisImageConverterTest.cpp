@@ -29,6 +29,7 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
@@ -61,6 +62,7 @@ struct BasisImageConverterTest: TestSuite::Tester {
     void unknownOutputFormatData();
     void unknownOutputFormatFile();
     void invalidSwizzle();
+    void invalidRateControl();
     void tooManyLevels();
     void levelWrongSize();
     void processError();
@@ -87,6 +89,11 @@ struct BasisImageConverterTest: TestSuite::Tester {
     void convertToFile3D();
 
     void threads();
+    void threadsReusedPool();
+    void cache();
+    void rateControlSize();
+    void rateControlPsnr();
+    void rateControlUnreachable();
     void ktx();
     void swizzle();
 
@@ -273,6 +280,14 @@ constexpr struct {
     {"no y-flip", false}
 };
 
+constexpr struct {
+    const char* name;
+    const bool uastc;
+} RateControlData[]{
+    {"ETC1S", false},
+    {"UASTC", true}
+};
+
 constexpr struct {
     const char* name;
     const PixelFormat format;
@@ -290,7 +305,8 @@ BasisImageConverterTest::BasisImageConverterTest() {
     addTests({&BasisImageConverterTest::wrongFormat,
               &BasisImageConverterTest::unknownOutputFormatData,
               &BasisImageConverterTest::unknownOutputFormatFile,
-              &BasisImageConverterTest::invalidSwizzle});
+              &BasisImageConverterTest::invalidSwizzle,
+              &BasisImageConverterTest::invalidRateControl});
 
     addInstancedTests({&BasisImageConverterTest::tooManyLevels},
         Containers::arraySize(TooManyLevelsData));
@@ -337,6 +353,15 @@ BasisImageConverterTest::BasisImageConverterTest() {
     addInstancedTests({&BasisImageConverterTest::threads},
         Containers::arraySize(ThreadsData));
 
+    addTests({&BasisImageConverterTest::threadsReusedPool,
+              &BasisImageConverterTest::cache});
+
+    addInstancedTests({&BasisImageConverterTest::rateControlSize,
+                       &BasisImageConverterTest::rateControlPsnr},
+        Containers::arraySize(RateControlData));
+
+    addTests({&BasisImageConverterTest::rateControlUnreachable});
+
     addInstancedTests({&BasisImageConverterTest::ktx},
         Containers::arraySize(FlippedData));
 
@@ -430,6 +455,31 @@ void BasisImageConverterTest::invalidSwizzle() {
         "Trade::BasisImageConverter::convertToData(): invalid characters in swizzle xaaa\n");
 }
 
+void BasisImageConverterTest::invalidRateControl() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+
+    const char data[8]{};
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    converter->configuration().setValue("targetSize", 1000);
+    converter->configuration().setValue("targetPsnr", 30.0f);
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, data}));
+
+    converter->configuration().setValue("targetPsnr", "");
+    converter->configuration().setValue("uastc", true);
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, data}));
+
+    converter->configuration().setValue("uastc", false);
+    converter->configuration().setValue("rateControlMaxTrials", 0);
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, data}));
+
+    CORRADE_COMPARE(out.str(),
+        "Trade::BasisImageConverter::convertToData(): the targetSize and targetPsnr options are mutually exclusive\n"
+        "Trade::BasisImageConverter::convertToData(): rate control for UASTC requires rdo_uastc to be enabled\n"
+        "Trade::BasisImageConverter::convertToData(): rateControlMaxTrials has to be at least 1\n");
+}
+
 void BasisImageConverterTest::tooManyLevels() {
     auto&& data = TooManyLevelsData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -1345,6 +1395,239 @@ void BasisImageConverterTest::threads() {
         (DebugTools::CompareImageToFile{_manager, 97.25f, 7.914f}));
 }
 
+void BasisImageConverterTest::threadsReusedPool() {
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test contents");
+    if(_manager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BasisImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> pngImporter = _manager.instantiate("PngImporter");
+    CORRADE_VERIFY(pngImporter->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-63x27.png")));
+    Containers::Optional<Trade::ImageData2D> originalImage = pngImporter->image2D(0);
+    CORRADE_VERIFY(originalImage);
+
+    /* The thread pool is created on the first conversion, reused on the
+       second and recreated on the third. All should produce a valid file. */
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    for(const char* threads: {"2", "2", "3"}) {
+        CORRADE_ITERATION(threads);
+        converter->configuration().setValue("threads", threads);
+        Containers::Optional<Containers::Array<char>> compressedData = converter->convertToData(*originalImage);
+        CORRADE_VERIFY(compressedData);
+
+        CORRADE_VERIFY(importer->openData(*compressedData));
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE_WITH(image->pixels<Color4ub>(),
+            Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-63x27.png"),
+            /* Same as in threads() above */
+            (DebugTools::CompareImageToFile{_manager, 97.25f, 7.914f}));
+    }
+}
+
+void BasisImageConverterTest::cache() {
+    const Containers::String cacheDirectory = Utility::Path::join(BASISIMAGECONVERTER_TEST_OUTPUT_DIR, "cache");
+    if(Utility::Path::exists(cacheDirectory)) {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot);
+        CORRADE_VERIFY(files);
+        for(const Containers::String& file: *files)
+            CORRADE_VERIFY(Utility::Path::remove(Utility::Path::join(cacheDirectory, file)));
+    }
+
+    Color4ub pixels[16*16];
+    for(std::size_t i = 0; i != Containers::arraySize(pixels); ++i)
+        pixels[i] = Color4ub{UnsignedByte(i), UnsignedByte(i*3), UnsignedByte(255 - i), 255};
+    const ImageView2D image{PixelFormat::RGBA8Unorm, {16, 16}, pixels};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    converter->configuration().setValue("cacheDirectory", cacheDirectory);
+
+    /* First conversion creates the cache directory and saves a file there */
+    Containers::Optional<Containers::Array<char>> first = converter->convertToData(image);
+    CORRADE_VERIFY(first);
+    {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot);
+        CORRADE_VERIFY(files);
+        CORRADE_COMPARE(files->size(), 1);
+        CORRADE_VERIFY(files->front().hasSuffix(".basis"_s));
+    }
+
+    /* Second conversion returns the cached output */
+    converter->addFlags(ImageConverterFlag::Verbose);
+    std::ostringstream out;
+    Containers::Optional<Containers::Array<char>> second;
+    {
+        Debug redirectOutput{&out};
+        second = converter->convertToData(image);
+    }
+    CORRADE_VERIFY(second);
+    CORRADE_COMPARE_AS(out.str(),
+        "Trade::BasisImageConverter::convertToData(): using cached",
+        TestSuite::Compare::StringHasPrefix);
+    CORRADE_COMPARE_AS(*second, *first,
+        TestSuite::Compare::Container);
+    converter->clearFlags(ImageConverterFlag::Verbose);
+
+    /* Changing the thread count doesn't affect the output, so it's still a
+       cache hit. Changing an encoder option or the file format isn't. */
+    converter->configuration().setValue("threads", 2);
+    CORRADE_VERIFY(converter->convertToData(image));
+    converter->configuration().setValue("quality_level", 64);
+    CORRADE_VERIFY(converter->convertToData(image));
+    Containers::Pointer<AbstractImageConverter> ktxConverter = _converterManager.instantiate("BasisKtxImageConverter");
+    ktxConverter->configuration().setValue("cacheDirectory", cacheDirectory);
+    CORRADE_VERIFY(ktxConverter->convertToData(image));
+    {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot);
+        CORRADE_VERIFY(files);
+        CORRADE_COMPARE(files->size(), 3);
+    }
+}
+
+/* A smooth gradient with a bit of noise, so the output size and quality
+   depend on the encoder settings */
+Image2D rateControlImage() {
+    Image2D image{PixelFormat::RGBA8Unorm, {64, 64}, Containers::Array<char>{NoInit, 64*64*4}};
+    const Containers::StridedArrayView2D<Color4ub> pixels = image.pixels<Color4ub>();
+    for(std::size_t y = 0; y != 64; ++y)
+        for(std::size_t x = 0; x != 64; ++x)
+            pixels[y][x] = Color4ub{UnsignedByte(x*4), UnsignedByte(y*4), UnsignedByte((x*7 + y*13)*37 % 64), 255};
+    return image;
+}
+
+void BasisImageConverterTest::rateControlSize() {
+    auto&& data = RateControlData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Image2D image = rateControlImage();
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    if(data.uastc) {
+        converter->configuration().setValue("uastc", true);
+        converter->configuration().setValue("rdo_uastc", true);
+    }
+
+    /* Pick a target size that's between the lowest and highest quality */
+    if(data.uastc)
+        converter->configuration().setValue("rdo_uastc_quality_scalar", 10.0f);
+    else
+        converter->configuration().setValue("quality_level", 1);
+    Containers::Optional<Containers::Array<char>> smallest = converter->convertToData(image);
+    CORRADE_VERIFY(smallest);
+    if(data.uastc)
+        converter->configuration().setValue("rdo_uastc_quality_scalar", 0.1f);
+    else
+        converter->configuration().setValue("quality_level", 255);
+    Containers::Optional<Containers::Array<char>> largest = converter->convertToData(image);
+    CORRADE_VERIFY(largest);
+    CORRADE_COMPARE_AS(largest->size(), smallest->size(),
+        TestSuite::Compare::Greater);
+    const std::size_t targetSize = (smallest->size() + largest->size())/2;
+
+    converter->configuration().setValue("targetSize", targetSize);
+    converter->addFlags(ImageConverterFlag::Verbose);
+    std::ostringstream out;
+    Containers::Optional<Containers::Array<char>> compressedData;
+    {
+        Debug redirectOutput{&out};
+        Warning redirectWarning{&out};
+        compressedData = converter->convertToData(image);
+    }
+    CORRADE_VERIFY(compressedData);
+    CORRADE_COMPARE_AS(compressedData->size(), targetSize,
+        TestSuite::Compare::LessOrEqual);
+    CORRADE_COMPARE_AS(out.str(),
+        data.uastc ?
+            "Trade::BasisImageConverter::convertToData(): rate control trial 0 with rdo_uastc_quality_scalar" :
+            "Trade::BasisImageConverter::convertToData(): rate control trial 0 with quality_level",
+        TestSuite::Compare::StringHasPrefix);
+    CORRADE_COMPARE_AS(out.str(),
+        "can't reach",
+        TestSuite::Compare::StringNotContains);
+
+    if(_manager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BasisImporter plugin not found, cannot test");
+
+    /* The output should be a valid file */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    CORRADE_VERIFY(importer->openData(*compressedData));
+    Containers::Optional<Trade::ImageData2D> imported = importer->image2D(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->size(), (Vector2i{64, 64}));
+}
+
+void BasisImageConverterTest::rateControlPsnr() {
+    auto&& data = RateControlData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Image2D image = rateControlImage();
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    if(data.uastc) {
+        converter->configuration().setValue("uastc", true);
+        converter->configuration().setValue("rdo_uastc", true);
+    }
+    converter->configuration().setValue("targetPsnr", 30.0f);
+    converter->addFlags(ImageConverterFlag::Verbose);
+    std::ostringstream out;
+    Containers::Optional<Containers::Array<char>> compressedData;
+    {
+        Debug redirectOutput{&out};
+        Warning redirectWarning{&out};
+        compressedData = converter->convertToData(image);
+    }
+    CORRADE_VERIFY(compressedData);
+    CORRADE_COMPARE_AS(out.str(),
+        "has PSNR",
+        TestSuite::Compare::StringContains);
+    CORRADE_COMPARE_AS(out.str(),
+        "can't reach",
+        TestSuite::Compare::StringNotContains);
+
+    if(_manager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BasisImporter plugin not found, cannot test");
+
+    /* The output should be close to the original, with the max difference
+       roughly corresponding to the target PSNR */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    CORRADE_VERIFY(importer->openData(*compressedData));
+    Containers::Optional<Trade::ImageData2D> imported = importer->image2D(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE_WITH(imported->pixels<Color4ub>(), image,
+        (DebugTools::CompareImage{48.0f, 12.0f}));
+}
+
+void BasisImageConverterTest::rateControlUnreachable() {
+    const Image2D image = rateControlImage();
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    converter->configuration().setValue("targetSize", 1);
+    /* Just two trials to not waste time */
+    converter->configuration().setValue("rateControlMaxTrials", 2);
+
+    std::ostringstream out;
+    Containers::Optional<Containers::Array<char>> compressedData;
+    {
+        Warning redirectWarning{&out};
+        compressedData = converter->convertToData(image);
+    }
+    /* The smallest output found is used */
+    CORRADE_VERIFY(compressedData);
+    CORRADE_COMPARE_AS(out.str(),
+        "Trade::BasisImageConverter::convertToData(): can't reach target size of 1 bytes, smallest output has",
+        TestSuite::Compare::StringHasPrefix);
+
+    /* No warning with the Quiet flag */
+    converter->addFlags(ImageConverterFlag::Quiet);
+    out.str({});
+    {
+        Warning redirectWarning{&out};
+        CORRADE_VERIFY(converter->convertToData(image));
+    }
+    CORRADE_COMPARE(out.str(), "");
+}
+
 void BasisImageConverterTest::ktx() {
     auto&& data = FlippedData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
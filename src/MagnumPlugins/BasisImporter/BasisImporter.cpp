@@ -27,15 +27,24 @@
 
 #include "BasisImporter.h"
 
+#include <atomic>
+#include <thread>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Assert.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/ConfigurationValue.h>
 #include <Corrade/Utility/Debug.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/ColorBatch.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/asyncImageImport.h"
+#include "Magnum/Implementation/instrumentation.h"
+#include "Magnum/Implementation/outputAllocator.h"
+#include "Magnum/Implementation/profilingZone.h"
+
 #include <basisu_transcoder.h>
 
 #ifdef MAGNUM_BUILD_DEPRECATED
@@ -172,6 +181,9 @@ struct BasisImporter::State {
     bool noTranscodeFormatWarningPrinted = false;
     bool yFlipNotPossibleWarningPrinted = false;
 
+    /* Grown as needed and reused if the reuseImageMemory option is enabled */
+    Containers::Array<char> reusedImageData;
+
     explicit State(): codebook(basist::g_global_selector_cb_size,
         basist::g_global_selector_cb) {}
 };
@@ -198,7 +210,21 @@ BasisImporter::BasisImporter(PluginManager::AbstractManager& manager, const Cont
     }
 }
 
-BasisImporter::~BasisImporter() = default;
+struct BasisImporter::AsyncState: Magnum::Implementation::AsyncImageImport {};
+
+BasisImporter::~BasisImporter() {
+    if(_async) _async->wait();
+}
+
+bool BasisImporter::image2DAsync(const UnsignedInt id, const UnsignedInt level, void(*const executor)(void(*)(void*), void*, void*), void(*const callback)(UnsignedInt, UnsignedInt, Containers::Optional<ImageData2D>&&, void*), void* const userData) {
+    if(!_async) _async.emplace();
+    return _async->schedule("Trade::BasisImporter::image2DAsync():", *this, id, level, executor, callback, userData);
+}
+
+void BasisImporter::setOutputAllocator(char*(*const allocator)(std::size_t, void*), void* const userData) {
+    _outputAllocator = allocator;
+    _outputAllocatorUserData = userData;
+}
 
 ImporterFeatures BasisImporter::doFeatures() const { return ImporterFeature::OpenData; }
 
@@ -214,14 +240,18 @@ bool BasisImporter::doIsOpened() const {
 }
 
 void BasisImporter::doClose() {
+    /* In-flight asynchronous imports reference the file, wait for them */
+    if(_async) _async->wait();
     _state->basisTranscoder = Containers::NullOpt;
     #if BASISD_SUPPORT_KTX2
     _state->ktx2Transcoder = Containers::NullOpt;
     #endif
     _state->in = nullptr;
+    _state->reusedImageData = nullptr;
 }
 
 void BasisImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     /* Because here we're copying the data and using the _in to check if file
        is opened, having them nullptr would mean openData() would fail without
        any error message. It's not possible to do this check on the importer
@@ -493,10 +523,8 @@ void BasisImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFla
     _state = Utility::move(state);
 }
 
-template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> BasisImporter::doImage(const UnsignedInt id, const UnsignedInt level) {
+template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> BasisImporter::doImage(const char* const prefix, const UnsignedInt id, const UnsignedInt level, const Containers::ArrayView<char>* const output) {
     static_assert(dimensions >= 2 && dimensions <= 3, "Only 2D and 3D images are supported");
-    constexpr const char* prefixes[2]{"Trade::BasisImporter::image2D():", "Trade::BasisImporter::image3D():"};
-    constexpr const char* prefix = prefixes[dimensions - 2];
 
     const auto targetFormatStr = configuration().value<Containers::StringView>("format");
     Containers::Optional<TargetFormat> targetFormat;
@@ -584,18 +612,6 @@ template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> Bas
 
     const UnsignedInt numLayers = _state->numSlices/numFaces;
 
-    /* basisu doesn't allow seeking to arbitrary video frames. If this isn't an
-       I-frame, only allow transcoding the frame following the last P-frame. */
-    if(_state->isVideo) {
-        const UnsignedInt expectedImageId = _state->lastTranscodedImageId + 1;
-        if(!isIFrame && id != expectedImageId) {
-            Error{} << prefix << "video frames must be transcoded sequentially, expected frame"
-                << expectedImageId << (expectedImageId == 0 ? "but got" : "or 0 but got") << id;
-            return Containers::NullOpt;
-        }
-        _state->lastTranscodedImageId = id;
-    }
-
     const Vector3ui size{origWidth, origHeight, _state->numSlices};
     UnsignedInt rowStride, outputRowsInPixels, outputSizeInBlocksOrPixels;
     if(isUncompressed) {
@@ -610,7 +626,43 @@ template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> Bas
 
     const UnsignedInt sliceSize = basis_get_bytes_per_block_or_pixel(format)*outputSizeInBlocksOrPixels;
     const UnsignedInt dataSize = sliceSize*size.z();
-    Containers::Array<char> dest{DefaultInit, dataSize};
+
+    /* Either transcode into the memory supplied by the caller, reuse the
+       internal array, growing it if not large enough, or allocate a new one
+       for the output, either with the output allocator or owned by the
+       image */
+    const bool reuseImageMemory = configuration().value<bool>("reuseImageMemory");
+    const bool isOwned = !output && !reuseImageMemory && !_outputAllocator;
+    Containers::Array<char> destData;
+    Containers::ArrayView<char> dest;
+    if(output) {
+        if(output->size() < dataSize) {
+            Error{} << prefix << "expected at least" << dataSize << "bytes for a" << Debug::packed << Math::Vector<dimensions, Int>::pad(Vector3i{size}) << "image but got" << output->size();
+            return Containers::NullOpt;
+        }
+        dest = output->prefix(dataSize);
+    } else if(reuseImageMemory) {
+        if(_state->reusedImageData.size() < dataSize)
+            _state->reusedImageData = Containers::Array<char>{DefaultInit, dataSize};
+        dest = _state->reusedImageData.prefix(dataSize);
+    } else {
+        Containers::Optional<Containers::Array<char>> allocated = Magnum::Implementation::allocateOutput(prefix, _outputAllocator, _outputAllocatorUserData, dataSize);
+        if(!allocated) return Containers::NullOpt;
+        destData = Utility::move(*allocated);
+        dest = destData;
+    }
+
+    /* basisu doesn't allow seeking to arbitrary video frames. If this isn't an
+       I-frame, only allow transcoding the frame following the last P-frame. */
+    if(_state->isVideo) {
+        const UnsignedInt expectedImageId = _state->lastTranscodedImageId + 1;
+        if(!isIFrame && id != expectedImageId) {
+            Error{} << prefix << "video frames must be transcoded sequentially, expected frame"
+                << expectedImageId << (expectedImageId == 0 ? "but got" : "or 0 but got") << id;
+            return Containers::NullOpt;
+        }
+        _state->lastTranscodedImageId = id;
+    }
 
     /* There's no function for transcoding the entire level, so loop over all
        layers and faces and transcode each one. This matches the image layout
@@ -619,31 +671,76 @@ template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> Bas
 
        If the user is requesting id > 0, there can't be any layers or faces,
        this is already asserted in doOpenData(). This allows us to calculate
-       the layer (KTX2) or image id to transcode with a simple addition. */
-    for(UnsignedInt l = 0; l != numLayers; ++l) {
-        for(UnsignedInt f = 0; f != numFaces; ++f) {
-            const UnsignedInt offset = (l*numFaces + f)*sliceSize;
+       the layer (KTX2) or image id to transcode with a simple addition.
+
+       The slices are independent and each goes to a different part of the
+       output, so they can be transcoded on multiple threads, each with its
+       own transcoder state. Videos however have just a single slice and rely
+       on the default transcoder state persisting the previous frame, so
+       those are always transcoded on the calling thread with no explicit
+       state. */
+    const UnsignedInt sliceCount = numLayers*numFaces;
+    std::size_t threadCount = 1;
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    if(!_state->isVideo) {
+        threadCount = configuration().value<UnsignedInt>("threads");
+        if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+        threadCount = Math::min(threadCount, std::size_t(sliceCount));
+    }
+    #endif
+    std::atomic<UnsignedInt> next{0};
+    std::atomic<bool> failed{false};
+    const auto transcode = [&]() {
+        MAGNUM_PROFILING_ZONE("BasisImporter transcoding");
+        #if BASISD_SUPPORT_KTX2
+        basist::ktx2_transcoder_state ktx2State;
+        basist::ktx2_transcoder_state* const ktx2StatePointer = threadCount == 1 ? nullptr : &ktx2State;
+        #endif
+        basist::basisu_transcoder_state basisState;
+        basist::basisu_transcoder_state* const basisStatePointer = threadCount == 1 ? nullptr : &basisState;
+        for(UnsignedInt i; (i = next++) < sliceCount; ) {
+            const UnsignedInt l = i/numFaces;
+            const UnsignedInt f = i%numFaces;
+            const UnsignedInt offset = i*sliceSize;
             #if BASISD_SUPPORT_KTX2
             if(_state->ktx2Transcoder) {
                 const UnsignedInt currentLayer = id + l;
-                if(!_state->ktx2Transcoder->transcode_image_level(level, currentLayer, f, dest.data() + offset, outputSizeInBlocksOrPixels, format, 0, rowStride, outputRowsInPixels)) {
-                    Error{} << prefix << "transcoding failed";
-                    return Containers::NullOpt;
-                }
+                if(!_state->ktx2Transcoder->transcode_image_level(level, currentLayer, f, dest.data() + offset, outputSizeInBlocksOrPixels, format, 0, rowStride, outputRowsInPixels, -1, -1, ktx2StatePointer))
+                    failed = true;
             } else
             #endif
             {
-                const UnsignedInt currentId = id + (l*numFaces + f);
-                if(!_state->basisTranscoder->transcode_image_level(_state->in.data(), _state->in.size(), currentId, level, dest.data() + offset, outputSizeInBlocksOrPixels, format, 0, rowStride, nullptr, outputRowsInPixels)) {
-                    Error{} << prefix << "transcoding failed";
-                    return Containers::NullOpt;
-                }
+                const UnsignedInt currentId = id + i;
+                if(!_state->basisTranscoder->transcode_image_level(_state->in.data(), _state->in.size(), currentId, level, dest.data() + offset, outputSizeInBlocksOrPixels, format, 0, rowStride, basisStatePointer, outputRowsInPixels))
+                    failed = true;
             }
         }
+    };
+
+    /* The calling thread is one of the workers */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{transcode};
+    transcode();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    transcode();
+    #endif
+
+    if(failed) {
+        Error{} << prefix << "transcoding failed";
+        return Containers::NullOpt;
     }
 
     if(isUncompressed) {
-        Trade::ImageData<dimensions> out{pixelFormat(*targetFormat, _state->isSrgb), Math::Vector<dimensions, Int>::pad(Vector3i{size}), Utility::move(dest), ImageFlag<dimensions>(UnsignedShort(_state->imageFlags))};
+        const PixelFormat format = pixelFormat(*targetFormat, _state->isSrgb);
+        const Math::Vector<dimensions, Int> imageSize = Math::Vector<dimensions, Int>::pad(Vector3i{size});
+        const ImageFlags<dimensions> imageFlags = ImageFlag<dimensions>(UnsignedShort(_state->imageFlags));
+        Trade::ImageData<dimensions> out = isOwned ?
+            Trade::ImageData<dimensions>{format, imageSize, Utility::move(destData), imageFlags} :
+            Trade::ImageData<dimensions>{format, imageSize, DataFlag::Mutable, dest, imageFlags};
 
         /* Flip if needed */
         if(!_state->isYFlipped)
@@ -710,7 +807,11 @@ template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> Bas
                 Warning{} << prefix << "Y-flipping a compressed image that's not whole blocks, the result will be shifted by" << (blockSize.y() - (size.y() % blockSize.y())) << "pixels";
         }
 
-        return Trade::ImageData<dimensions>{format, Math::Vector<dimensions, Int>::pad(Vector3i{size}), Utility::move(dest), ImageFlag<dimensions>(UnsignedShort(_state->imageFlags))};
+        const Math::Vector<dimensions, Int> imageSize = Math::Vector<dimensions, Int>::pad(Vector3i{size});
+        const ImageFlags<dimensions> imageFlags = ImageFlag<dimensions>(UnsignedShort(_state->imageFlags));
+        if(!isOwned)
+            return Trade::ImageData<dimensions>{format, imageSize, DataFlag::Mutable, dest, imageFlags};
+        return Trade::ImageData<dimensions>{format, imageSize, Utility::move(destData), imageFlags};
     }
 }
 
@@ -723,7 +824,8 @@ UnsignedInt BasisImporter::doImage2DLevelCount(const UnsignedInt id) {
 }
 
 Containers::Optional<ImageData2D> BasisImporter::doImage2D(const UnsignedInt id, const UnsignedInt level) {
-    return doImage<2>(id, level);
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D", {}, id};
+    return doImage<2>("Trade::BasisImporter::image2D():", id, level, nullptr);
 }
 
 UnsignedInt BasisImporter::doImage3DCount() const {
@@ -735,7 +837,8 @@ UnsignedInt BasisImporter::doImage3DLevelCount(const UnsignedInt id) {
 }
 
 Containers::Optional<ImageData3D> BasisImporter::doImage3D(const UnsignedInt id, const UnsignedInt level) {
-    return doImage<3>(id, level);
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage3D", {}, id};
+    return doImage<3>("Trade::BasisImporter::image3D():", id, level, nullptr);
 }
 
 #ifdef MAGNUM_BUILD_DEPRECATED
@@ -767,6 +870,26 @@ BasisImporter::TargetFormat BasisImporter::targetFormat() const {
     return configuration().value<TargetFormat>("format");
 }
 
+Containers::Optional<ImageData2D> BasisImporter::image2DInto(const UnsignedInt id, const UnsignedInt level, const Containers::ArrayView<char> data) {
+    CORRADE_ASSERT(isOpened(),
+        "Trade::BasisImporter::image2DInto(): no file opened", {});
+    CORRADE_ASSERT(id < image2DCount(),
+        "Trade::BasisImporter::image2DInto(): index" << id << "out of range for" << image2DCount() << "entries", {});
+    CORRADE_ASSERT(level < image2DLevelCount(id),
+        "Trade::BasisImporter::image2DInto(): level" << level << "out of range for" << image2DLevelCount(id) << "entries", {});
+    return doImage<2>("Trade::BasisImporter::image2DInto():", id, level, &data);
+}
+
+Containers::Optional<ImageData3D> BasisImporter::image3DInto(const UnsignedInt id, const UnsignedInt level, const Containers::ArrayView<char> data) {
+    CORRADE_ASSERT(isOpened(),
+        "Trade::BasisImporter::image3DInto(): no file opened", {});
+    CORRADE_ASSERT(id < image3DCount(),
+        "Trade::BasisImporter::image3DInto(): index" << id << "out of range for" << image3DCount() << "entries", {});
+    CORRADE_ASSERT(level < image3DLevelCount(id),
+        "Trade::BasisImporter::image3DInto(): level" << level << "out of range for" << image3DLevelCount(id) << "entries", {});
+    return doImage<3>("Trade::BasisImporter::image3DInto():", id, level, &data);
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(BasisImporter, Magnum::Trade::BasisImporter,
@@ -200,6 +200,15 @@ frames is not allowed. If you call @ref image2D() with non-sequential frame
 indices and that frame is not an I-frame, it will print an error and fail.
 Restarting from frame 0 is always allowed.
 
+To stream video frames without allocating for each of them, enable the
+@cb{.ini} reuseImageMemory @ce
+@ref Trade-BasisImporter-configuration "configuration option". The frames are
+then transcoded into an internal allocation that's kept for all subsequent
+imports, and the returned images are non-owning mutable views on it with
+@ref DataFlag::Mutable set, valid only until the next image import or until the
+importer is closed. Copy the data out or upload them to a texture before
+importing the next frame.
+
 @subsection Trade-BasisImporter-behavior-multilevel Multilevel images
 
 Files with multiple mip levels are imported with the largest level first, with
@@ -219,6 +228,27 @@ left-handed coordinate system (+X is right, +Y is up, +Z is forward). Layered
 cube maps are stored as multiple sets of faces, ie. all faces +X through -Z for
 the first layer, then all faces of the second layer, etc.
 
+@subsection Trade-BasisImporter-behavior-threads Multithreaded transcoding
+
+By default, all layers and cube map faces of an imported level are transcoded
+on the calling thread. Setting the @cb{.ini} threads @ce
+@ref Trade-BasisImporter-configuration "configuration option" to a value other
+than @cpp 1 @ce distributes them across given number of threads, each with its
+own transcoder state, writing directly to the output image. The number of
+threads is clamped to the total count of layers and faces, so plain 2D images
+are always transcoded on the calling thread. Video files are always transcoded
+serially as each frame may depend on the previous one. Similarly to
+@ref BasisImageConverter, if the option is set, the *application* is required
+to link to `pthread` on Linux, see
+@ref Trade-BasisImageConverter-behavior-loading for details. On Emscripten the
+option has an effect only if built with `-pthread`.
+
+Independently of that, the importer is thread-safe if Corrade and Magnum is
+compiled with @ref CORRADE_BUILD_MULTITHREADED enabled. The global transcoder
+tables are initialized just once when the plugin is loaded and are only read
+from afterwards, so separate importer instances can be used from different
+threads at the same time and scale with the number of threads.
+
 @subsection Trade-BasisImporter-behavior-ktx KTX2 files
 
 Basis Universal supports only the Basis-encoded subset of the KTX2 format. It
@@ -228,6 +258,24 @@ Instead, if you're dealing with generic KTX2 files, you're encouraged to use
 @ref KtxImporter directly --- it will then delegate to @ref BasisImporter for
 Basis-encoded files.
 
+@subsection Trade-BasisImporter-behavior-async Asynchronous import
+
+The @ref image2DAsync() function schedules an import of given 2D image level
+on an executor supplied by the application and calls a callback with the
+result once done, so for example a render thread doesn't need to block on
+decoding. The executor gets a job function, a pointer to pass to it and the
+user data pointer, and is expected to call the job exactly once, either
+directly or from any other thread. The job imports the image using
+@ref image2D() and then calls the callback on the same thread, with
+@relativeref{Corrade,Containers::NullOpt} if the import failed.
+
+Asynchronous imports on a single importer instance are executed one after
+another and only one import of a particular image and level can be in flight
+at a time. While any of them are in flight, the importer shouldn't be used
+from other threads except for calling @ref image2DAsync() again. Calling
+@ref close(), opening another file or destroying the importer waits until all
+of them finish.
+
 @section Trade-BasisImporter-configuration Plugin-specific configuration
 
 Basis allows configuration of the format of loaded compressed data.
@@ -253,6 +301,13 @@ you may also use @ref setTargetFormat().
 
 @snippet BasisImporter.cpp target-format-config
 
+The format is read on every @ref image2D() / @ref image3D() call. The file
+header, the slice descriptors and the global codebooks are decoded just once
+in @ref openData() and kept for as long as the file is opened, so producing
+a single image in several target formats is only a matter of changing the
+option between the calls. Warnings about a missing target format or an
+impossible Y flip are printed again after the format is changed.
+
 There are many options and you should generally be striving for the
 highest-quality format available on a given platform. A detailed description of
 the choices can be found in the [Basis Universal Wiki](https://github.com/BinomialLLC/basis_universal/wiki/How-to-Deploy-ETC1S-Texture-Content-Using-Basis-Universal).
@@ -262,6 +317,40 @@ OpenGL, OpenGL ES and WebGL extensions, in its full ugly glory:
 
 @snippet BasisImporter.cpp gl-extension-checks
 
+@subsection Trade-BasisImporter-caller-memory Transcoding into caller-provided memory
+
+If you instantiate this class directly, either without a plugin manager or with
+the plugin linked statically, you can use @ref image2DInto() and
+@ref image3DInto() to transcode directly into memory you provide, such as a
+persistently mapped GPU staging buffer, avoiding an allocation and a copy. If
+the memory isn't large enough, the import fails with a message containing the
+required size. As with @cb{.ini} reuseImageMemory @ce, the Y flip, if needed,
+is done in the provided memory as well.
+
+@code{.cpp}
+Trade::BasisImporter importer;
+importer.setTargetFormat(Trade::BasisImporter::TargetFormat::Bc7RGBA);
+importer.openFile("texture.ktx2");
+
+Containers::ArrayView<char> staging = mappedStagingBuffer();
+Containers::Optional<Trade::ImageData2D> image = importer.image2DInto(0, 0, staging);
+@endcode
+
+@subsection Trade-BasisImporter-output-allocator Custom output allocator
+
+By default, imported image data are allocated with the default array allocator
+and owned by the returned @ref ImageData. With @ref setOutputAllocator() it's
+possible to supply a custom allocator instead, for example one suballocating
+from an arena or from a persistently mapped GPU staging buffer, which avoids a
+copy when uploading. The allocator gets the size in bytes and the user data
+pointer and returns a pointer to memory of at least given size aligned to at
+least four bytes, or @cpp nullptr @ce on failure, in which case the import
+fails with an error. The returned image then only references the memory, with
+@ref DataFlag::Mutable set, and it's up to the application to keep it alive for
+as long as the image is used. Memory passed to @ref image2DInto() and @ref
+image3DInto() and the internal memory used with @cb{.ini} reuseImageMemory @ce
+take precedence over the allocator.
+
 @subsection Trade-BasisImporter-binary-size Reducing binary size
 
 To reduce the binary size of the transcoder, Basis Universal supports a set of
@@ -407,6 +496,25 @@ class MAGNUM_BASISIMPORTER_EXPORT BasisImporter: public AbstractImporter {
 
         ~BasisImporter();
 
+        /**
+         * @brief Import a 2D image asynchronously
+         * @param id        Image ID, from range [0, @ref image2DCount())
+         * @param level     Mip level, from range
+         *      [0, @ref image2DLevelCount())
+         * @param executor  Function running the import job
+         * @param callback  Function called with the imported image
+         * @param userData  User data passed to @p executor and @p callback
+         * @return Whether the import was scheduled
+         * @m_since_latest_{plugins}
+         *
+         * If no file is opened, @p id or @p level is out of range or the
+         * same image and level is already being imported, prints a message
+         * to @relativeref{Magnum,Error} and returns @cpp false @ce without
+         * calling @p executor. See @ref Trade-BasisImporter-behavior-async
+         * for more information.
+         */
+        virtual bool image2DAsync(UnsignedInt id, UnsignedInt level, void(*executor)(void(*)(void*), void*, void*), void(*callback)(UnsignedInt, UnsignedInt, Containers::Optional<ImageData2D>&&, void*), void* userData = nullptr);
+
         /** @brief Target format */
         TargetFormat targetFormat() const;
 
@@ -417,13 +525,47 @@ class MAGNUM_BASISIMPORTER_EXPORT BasisImporter: public AbstractImporter {
         */
         void setTargetFormat(TargetFormat format);
 
+        /**
+         * @brief Transcode a 2D image into a caller-provided memory
+         * @m_since_latest
+         *
+         * Like @ref image2D(), but instead of allocating a new array, the
+         * transcoded data are written into @p data. Expects that a file is
+         * opened and @p id and @p level are in range. If @p data is smaller
+         * than what the image needs, prints a message to
+         * @relativeref{Magnum,Error} and returns @relativeref{Corrade,Containers::NullOpt}.
+         * On success the returned image is a non-owning view on the leading
+         * part of @p data with @ref DataFlag::Mutable set. See
+         * @ref Trade-BasisImporter-caller-memory for more information.
+         */
+        Containers::Optional<ImageData2D> image2DInto(UnsignedInt id, UnsignedInt level, Containers::ArrayView<char> data);
+
+        /**
+         * @brief Transcode a 3D image into a caller-provided memory
+         * @m_since_latest
+         *
+         * Like @ref image2DInto(), but for @ref image3D().
+         */
+        Containers::Optional<ImageData3D> image3DInto(UnsignedInt id, UnsignedInt level, Containers::ArrayView<char> data);
+
+        /**
+         * @brief Set an output allocator
+         * @m_since_latest_{plugins}
+         *
+         * If set, imported image data are allocated using @p allocator, which
+         * gets the size in bytes and @p userData. Passing @cpp nullptr @ce
+         * restores the default. The setting is kept across opened files. See
+         * @ref Trade-BasisImporter-output-allocator for more information.
+         */
+        virtual void setOutputAllocator(char*(*allocator)(std::size_t, void*), void* userData = nullptr);
+
     private:
         MAGNUM_BASISIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_BASISIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_BASISIMPORTER_LOCAL void doClose() override;
         MAGNUM_BASISIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
 
-        template<UnsignedInt dimensions> MAGNUM_BASISIMPORTER_LOCAL Containers::Optional<ImageData<dimensions>> doImage(UnsignedInt id, UnsignedInt level);
+        template<UnsignedInt dimensions> MAGNUM_BASISIMPORTER_LOCAL Containers::Optional<ImageData<dimensions>> doImage(const char* prefix, UnsignedInt id, UnsignedInt level, const Containers::ArrayView<char>* output);
 
         MAGNUM_BASISIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_BASISIMPORTER_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
@@ -440,6 +582,10 @@ class MAGNUM_BASISIMPORTER_EXPORT BasisImporter: public AbstractImporter {
 
         struct State;
         Containers::Pointer<State> _state;
+        char*(*_outputAllocator)(std::size_t, void*){};
+        void* _outputAllocatorUserData{};
+        struct AsyncState;
+        Containers::Pointer<AsyncState> _async;
 };
 
 }}
@@ -26,9 +26,14 @@
 */
 
 #include <sstream>
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+#include <thread>
+#endif
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
@@ -49,6 +54,11 @@
 
 #include "configure.h"
 
+/* The plugin-specific API can be called only if linked statically */
+#ifndef BASISIMPORTER_PLUGIN_FILENAME
+#include "MagnumPlugins/BasisImporter/BasisImporter.h"
+#endif
+
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
 struct BasisImporterTest: TestSuite::Tester {
@@ -83,10 +93,14 @@ struct BasisImporterTest: TestSuite::Tester {
     void array2D();
     void array2DMipmaps();
     void video();
+    void videoReuseImageMemory();
+    void imageInto();
+    void imageIntoTooSmall();
     void image3D();
     void image3DMipmaps();
     void cubeMap();
     void cubeMapArray();
+    void cubeMapArrayThreads();
 
     void videoSeeking();
     void videoVerbose();
@@ -101,6 +115,10 @@ struct BasisImporterTest: TestSuite::Tester {
     void openDifferent();
     void importMultipleFormats();
 
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    void multithreaded();
+    #endif
+
     /* Needs to load AnyImageImporter from system-wide location */
     PluginManager::Manager<AbstractImporter> _manager;
     /* For testing Y-flip of block-compressed formats */
@@ -538,15 +556,20 @@ BasisImporterTest::BasisImporterTest() {
 
     addInstancedTests({&BasisImporterTest::array2D,
                        &BasisImporterTest::array2DMipmaps,
-                       &BasisImporterTest::video},
+                       &BasisImporterTest::video,
+                       &BasisImporterTest::videoReuseImageMemory},
                       Containers::arraySize(FileTypeData));
 
+    addTests({&BasisImporterTest::imageInto,
+              &BasisImporterTest::imageIntoTooSmall});
+
     addInstancedTests({&BasisImporterTest::image3D,
                        &BasisImporterTest::image3DMipmaps},
         Containers::arraySize(Image3DData));
 
     addInstancedTests({&BasisImporterTest::cubeMap,
-                       &BasisImporterTest::cubeMapArray},
+                       &BasisImporterTest::cubeMapArray,
+                       &BasisImporterTest::cubeMapArrayThreads},
                       Containers::arraySize(FileTypeData));
 
     addInstancedTests({&BasisImporterTest::videoSeeking},
@@ -571,6 +594,10 @@ BasisImporterTest::BasisImporterTest() {
               &BasisImporterTest::openDifferent,
               &BasisImporterTest::importMultipleFormats});
 
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    addRepeatedTests({&BasisImporterTest::multithreaded}, 10);
+    #endif
+
     /* Pull in the AnyImageImporter dependency for image comparison */
     _manager.load("AnyImageImporter");
     /* Reset the plugin dir after so it doesn't load anything else from the
@@ -1269,6 +1296,46 @@ void BasisImporterTest::video() {
         (DebugTools::CompareImageToFile{_manager, 76.0f, 8.311f}));
 }
 
+void BasisImporterTest::videoReuseImageMemory() {
+    auto& data = FileTypeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    /* See the comment above FileTypeData for more details */
+    if(data.hasMissingOrientationMetadata)
+        importer->configuration().setValue("assumeYUp", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-video"_s + data.extension)));
+
+    /* Import all frames the usual way first to have something to compare
+       to */
+    Containers::Optional<Trade::ImageData2D> expected[3];
+    CORRADE_COMPARE(importer->image2DCount(), Containers::arraySize(expected));
+    for(UnsignedInt i = 0; i != Containers::arraySize(expected); ++i) {
+        expected[i] = importer->image2D(i);
+        CORRADE_VERIFY(expected[i]);
+        CORRADE_COMPARE(expected[i]->dataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    }
+
+    /* Then again with memory reuse, restarting from the first frame. All
+       frames should be transcoded to the same memory. */
+    importer->configuration().setValue("reuseImageMemory", true);
+    const void* firstFrameData = nullptr;
+    for(UnsignedInt i = 0; i != Containers::arraySize(expected); ++i) {
+        CORRADE_ITERATION(i);
+
+        Containers::Optional<Trade::ImageData2D> frame = importer->image2D(i);
+        CORRADE_VERIFY(frame);
+        CORRADE_COMPARE(frame->dataFlags(), DataFlag::Mutable);
+        CORRADE_COMPARE(frame->format(), PixelFormat::RGBA8Srgb);
+        CORRADE_COMPARE(frame->size(), (Vector2i{63, 27}));
+        if(i == 0) firstFrameData = frame->data().data();
+        else CORRADE_COMPARE(frame->data().data(), firstFrameData);
+        CORRADE_COMPARE_AS(frame->data(),
+            expected[i]->data(),
+            TestSuite::Compare::Container);
+    }
+}
+
 void BasisImporterTest::image3D() {
     auto& data = Image3DData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -1486,6 +1553,78 @@ void BasisImporterTest::cubeMapArray() {
         (DebugTools::CompareImageToFile{_manager, 88.0f, 10.591f}));
 }
 
+void BasisImporterTest::cubeMapArrayThreads() {
+    auto& data = FileTypeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Import the same image once serially and once on a thread count that
+       doesn't evenly divide the 12 slices, and with both an uncompressed and
+       a compressed target format. The output should be exactly the same. */
+    for(const char* format: {"RGBA8", "Etc2RGBA"}) {
+        CORRADE_ITERATION(format);
+
+        Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporter");
+        importer->configuration().setValue("format", format);
+        /* See the comment above FileTypeData for more details */
+        if(data.hasMissingOrientationMetadata)
+            importer->configuration().setValue("assumeYUp", true);
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-cubemap-array"_s + data.extension)));
+
+        Containers::Optional<Trade::ImageData3D> serial = importer->image3D(0);
+        CORRADE_VERIFY(serial);
+
+        importer->configuration().setValue("threads", 5);
+        Containers::Optional<Trade::ImageData3D> threaded = importer->image3D(0);
+        CORRADE_VERIFY(threaded);
+        CORRADE_COMPARE(threaded->isCompressed(), serial->isCompressed());
+        CORRADE_COMPARE(threaded->size(), serial->size());
+        CORRADE_COMPARE_AS(Containers::arrayView(threaded->data()),
+            Containers::arrayView(serial->data()),
+            TestSuite::Compare::Container);
+    }
+}
+
+void BasisImporterTest::imageInto() {
+    #ifdef BASISIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterEtc2RGBA");
+    importer->configuration().setValue("assumeYUp", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-cubemap-array.basis")));
+
+    Containers::Optional<Trade::ImageData3D> expected = importer->image3D(0);
+    CORRADE_VERIFY(expected);
+
+    /* Larger than needed, only the prefix should get used */
+    Containers::Array<char> memory{ValueInit, expected->data().size() + 13};
+    Containers::Optional<Trade::ImageData3D> image = static_cast<BasisImporter&>(*importer).image3DInto(0, 0, memory);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->dataFlags(), DataFlag::Mutable);
+    CORRADE_COMPARE(image->data().data(), memory.data());
+    CORRADE_COMPARE(image->compressedFormat(), expected->compressedFormat());
+    CORRADE_COMPARE(image->size(), expected->size());
+    CORRADE_COMPARE(image->flags(), expected->flags());
+    CORRADE_COMPARE_AS(image->data(),
+        expected->data(),
+        TestSuite::Compare::Container);
+    #endif
+}
+
+void BasisImporterTest::imageIntoTooSmall() {
+    #ifdef BASISIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgb.basis")));
+
+    char memory[63*27*4 - 1];
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!static_cast<BasisImporter&>(*importer).image2DInto(0, 0, memory));
+    CORRADE_COMPARE(out.str(), "Trade::BasisImporter::image2DInto(): expected at least 6804 bytes for a {63, 27} image but got 6803\n");
+    #endif
+}
+
 void BasisImporterTest::videoSeeking() {
     auto& data = VideoSeekingData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -1967,6 +2106,55 @@ void BasisImporterTest::importMultipleFormats() {
     }
 }
 
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+void BasisImporterTest::multithreaded() {
+    #ifndef CORRADE_BUILD_MULTITHREADED
+    CORRADE_SKIP("CORRADE_BUILD_MULTITHREADED is not enabled.");
+    #endif
+
+    /* The transcoder tables are global, but initialized just once when the
+       plugin is loaded, after that they're only read from. Each importer
+       should thus be able to transcode on its own thread without affecting
+       the others. Half of the threads import a .basis file, half a .ktx2
+       file, to exercise both code paths at the same time. */
+    Containers::Pointer<AbstractImporter> importers[4];
+    Containers::Array<char> expected[Containers::arraySize(importers)];
+    for(std::size_t i = 0; i != Containers::arraySize(importers); ++i) {
+        CORRADE_ITERATION(i);
+        importers[i] = _manager.instantiate("BasisImporterRGBA8");
+
+        /* Reference output imported on the main thread */
+        CORRADE_VERIFY(importers[i]->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, i % 2 ? "rgba.ktx2" : "rgba.basis")));
+        Containers::Optional<Trade::ImageData2D> image = importers[i]->image2D(0);
+        CORRADE_VERIFY(image);
+        expected[i] = image->release();
+    }
+
+    int counters[Containers::arraySize(importers)]{};
+    {
+        auto fn = [](AbstractImporter& importer, const Containers::String& filename, const Containers::Array<char>& expected, int& counter) {
+            for(std::size_t i = 0; i != 25; ++i) {
+                if(!importer.openFile(filename)) continue;
+                Containers::Optional<Trade::ImageData2D> image = importer.image2D(0);
+                if(image && Containers::StringView{image->data()} == Containers::StringView{expected})
+                    ++counter;
+            }
+        };
+
+        std::thread threads[Containers::arraySize(importers)];
+        for(std::size_t i = 0; i != Containers::arraySize(threads); ++i)
+            threads[i] = std::thread{fn, std::ref(*importers[i]), Utility::Path::join(BASISIMPORTER_TEST_DIR, i % 2 ? "rgba.ktx2" : "rgba.basis"), std::cref(expected[i]), std::ref(counters[i])};
+        for(std::thread& thread: threads)
+            thread.join();
+    }
+
+    for(std::size_t i = 0; i != Containers::arraySize(counters); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(counters[i], 25);
+    }
+}
+#endif
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::BasisImporterTest)
@@ -25,13 +25,33 @@
 
 #include "BcDecImageConverter.h"
 
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Endianness.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector4.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <atomic>
+#endif
+
+#if defined(CORRADE_TARGET_SSE2)
+#include <emmintrin.h>
+#elif defined(CORRADE_TARGET_NEON)
+#include <arm_neon.h>
+#endif
+
 #define BCDEC_IMPLEMENTATION
 #include "bcdec.h"
 
@@ -45,29 +65,344 @@ ImageConverterFeatures BcDecImageConverter::doFeatures() const { return ImageCon
 
 namespace {
 
-template<void(*decodeBlock)(const void*, void*, int)> void decodeBlocks(const Containers::StridedArrayView2D<const char>& src, const Containers::StridedArrayView2D<char>& dst) {
+template<void(*decodeBlock)(const void*, void*, int)> void decodeBlocks(const Containers::StridedArrayView2D<const char>& src, const Containers::StridedArrayView2D<char>& dst, const std::size_t threadCount) {
     const std::size_t yBlocks = src.size()[0];
     const std::size_t xBlocks = src.size()[1];
     CORRADE_INTERNAL_ASSERT(dst.size()[0] == yBlocks*4 &&
                             dst.size()[1] == xBlocks*4);
     const std::size_t dstRowStride = dst.stride()[0];
-    for(std::size_t y = 0; y != yBlocks; ++y)
-        for(std::size_t x = 0; x != xBlocks; ++x)
-            decodeBlock(&src[{y, x}], &dst[{y*4, x*4}], dstRowStride);
+
+    /* Each row of blocks is independent, so the rows can be decoded on
+       multiple threads, each picking the next undecoded one */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    std::atomic<std::size_t> next{0};
+    #else
+    std::size_t next = 0;
+    #endif
+    const auto decode = [&]() {
+        for(std::size_t y; (y = next++) < yBlocks; )
+            for(std::size_t x = 0; x != xBlocks; ++x)
+                decodeBlock(&src[{y, x}], &dst[{y*4, x*4}], dstRowStride);
+    };
+
+    /* The calling thread is one of the workers */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{decode};
+    decode();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    static_cast<void>(threadCount);
+    decode();
+    #endif
 }
 
-/* To make bcdec_bc6h_float() / bcdec_bc6h_half() the same signature as the
-   others to use in decodeBlocks() above */
-template<void(*decodeBlock)(const void*, void*, int, int), bool isSigned, int typeSize> inline void decodeBc6hBlock(const void* src, void* dst, int rowStride) {
-    /* The destinationPitch is apparently not bytes but rather depending on
-       type size, so here it has to be divided by 2 or 4 */
-    decodeBlock(src, dst, rowStride/typeSize, isSigned);
+/* bcdec_bc6h_half() writes three halves per pixel, with the destination
+   pitch being in halves as well. For other output types the block is decoded
+   to the start of each destination row first and then expanded in place,
+   going from the last pixel so nothing gets overwritten before it's read.
+   Unlike bcdec_bc6h_float(), this doesn't need any temporary block. */
+inline UnsignedShort bc6hValue(UnsignedShort half, UnsignedShort) { return half; }
+inline Float bc6hValue(UnsignedShort half, Float) { return bcdec__half_to_float_quick(half); }
+inline UnsignedShort bc6hOne(UnsignedShort) { return 0x3c00; }
+inline Float bc6hOne(Float) { return 1.0f; }
+
+template<bool isSigned, class T, UnsignedInt channelCount> void decodeBc6hBlock(const void* const src, void* const dst, const int rowStride) {
+    bcdec_bc6h_half(src, dst, rowStride/2, isSigned);
+    if(std::is_same<T, UnsignedShort>::value && channelCount == 3) return;
+
+    for(std::size_t y = 0; y != 4; ++y) {
+        char* const row = static_cast<char*>(dst) + y*rowStride;
+        for(std::size_t x = 4; x != 0; --x) {
+            UnsignedShort in[3];
+            std::memcpy(in, row + (x - 1)*sizeof(in), sizeof(in));
+            T out[channelCount];
+            for(UnsignedInt i = 0; i != 3; ++i)
+                out[i] = bc6hValue(in[i], T{});
+            for(UnsignedInt i = 3; i < channelCount; ++i)
+                out[i] = bc6hOne(T{});
+            std::memcpy(row + (x - 1)*sizeof(out), out, sizeof(out));
+        }
+    }
 }
 
+template<bool isSigned> void decodeBc6hBlocks(const Containers::StridedArrayView2D<const char>& src, const Containers::StridedArrayView2D<char>& dst, const std::size_t threadCount, const bool toFloat, const bool toRgba) {
+    if(toFloat) toRgba ?
+        decodeBlocks<decodeBc6hBlock<isSigned, Float, 4>>(src, dst, threadCount) :
+        decodeBlocks<decodeBc6hBlock<isSigned, Float, 3>>(src, dst, threadCount);
+    else toRgba ?
+        decodeBlocks<decodeBc6hBlock<isSigned, UnsignedShort, 4>>(src, dst, threadCount) :
+        decodeBlocks<decodeBc6hBlock<isSigned, UnsignedShort, 3>>(src, dst, threadCount);
+}
+
+/* Partitions of two- and three-subset BC7 blocks, with one or two bits per
+   pixel in row-major order, and anchor pixels of the second and third subset.
+   The anchor of the first subset is always pixel 0. */
+constexpr UnsignedShort Bc7Partitions2[64]{
+    0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80,
+    0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+    0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce,
+    0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+    0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a,
+    0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+    0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c,
+    0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22,
+};
+constexpr UnsignedByte Bc7Anchors2[64]{
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+};
+constexpr UnsignedInt Bc7Partitions3[64]{
+    0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8,
+    0xa5a50000, 0xa0a05050, 0x5555a0a0, 0x5a5a5050,
+    0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090,
+    0x94949494, 0xa4a4a4a4, 0xa9a59450, 0x2a0a4250,
+    0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0,
+    0xa8a85454, 0x6a6a4040, 0xa4a45000, 0x1a1a0500,
+    0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400,
+    0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200,
+    0xa9a58000, 0x5090a0a8, 0xa8a09050, 0x24242424,
+    0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50,
+    0x500aa550, 0xaaaa4444, 0x66660000, 0xa5a0a5a0,
+    0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600,
+    0xaa444444, 0x54a854a8, 0x95809580, 0x96969600,
+    0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+    0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000,
+    0x40804080, 0xa9a8a9a8, 0xaaaaaa44, 0x2a4a5254,
+};
+constexpr UnsignedByte Bc7Anchors3[2][64]{{
+     3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+     3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+     8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+     3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3,
+}, {
+    15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+    15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+    15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+    15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8,
+}};
+
+constexpr UnsignedByte Bc7Weights2[4]{0, 21, 43, 64};
+constexpr UnsignedByte Bc7Weights3[8]{0, 9, 18, 27, 37, 46, 55, 64};
+constexpr UnsignedByte Bc7Weights4[16]{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+constexpr const UnsignedByte* Bc7Weights[5]{nullptr, nullptr, Bc7Weights2, Bc7Weights3, Bc7Weights4};
+
+enum class Bc7PBits: UnsignedByte { None, Unique, Shared };
+
+constexpr struct {
+    UnsignedByte subsetCount;
+    UnsignedByte partitionBits;
+    UnsignedByte rotationBits;
+    UnsignedByte indexSelectionBits;
+    UnsignedByte colorBits;
+    UnsignedByte alphaBits;
+    Bc7PBits pBits;
+    UnsignedByte indexBits;
+    UnsignedByte index2Bits;
+} Bc7Modes[8]{
+    {3, 4, 0, 0, 4, 0, Bc7PBits::Unique, 3, 0},
+    {2, 6, 0, 0, 6, 0, Bc7PBits::Shared, 3, 0},
+    {3, 6, 0, 0, 5, 0, Bc7PBits::None, 2, 0},
+    {2, 6, 0, 0, 7, 0, Bc7PBits::Unique, 2, 0},
+    {1, 0, 2, 1, 5, 6, Bc7PBits::None, 2, 3},
+    {1, 0, 2, 0, 7, 8, Bc7PBits::None, 2, 2},
+    {1, 0, 0, 0, 7, 7, Bc7PBits::Unique, 4, 0},
+    {2, 6, 0, 0, 5, 5, Bc7PBits::Unique, 2, 0},
+};
+
+/* Reads the 128-bit block LSB first */
+struct Bc7Bits {
+    UnsignedInt read(UnsignedInt count) {
+        if(!count) return 0;
+        const UnsignedInt out = low & ((1ull << count) - 1);
+        low = (low >> count)|(high << (64 - count));
+        high >>= count;
+        return out;
+    }
+
+    UnsignedLong low, high;
+};
+
+/* Calculates (a*(64 - w) + b*w + 32)/64 for all four channels of the two
+   endpoints and each of the weights. The count is always even, which allows
+   the SIMD variants to process two palette entries at once. */
+inline void interpolateBc7(const UnsignedByte(&a)[4], const UnsignedByte(&b)[4], const UnsignedByte* const weights, const UnsignedInt count, UnsignedByte(*const out)[4]) {
+    #if defined(CORRADE_TARGET_SSE2)
+    Int a32, b32;
+    std::memcpy(&a32, a, 4);
+    std::memcpy(&b32, b, 4);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i a16 = _mm_unpacklo_epi8(_mm_set1_epi32(a32), zero);
+    const __m128i b16 = _mm_unpacklo_epi8(_mm_set1_epi32(b32), zero);
+    const __m128i sixtyFour = _mm_set1_epi16(64);
+    const __m128i half = _mm_set1_epi16(32);
+    for(UnsignedInt i = 0; i != count; i += 2) {
+        const __m128i w = _mm_unpacklo_epi64(_mm_set1_epi16(weights[i]), _mm_set1_epi16(weights[i + 1]));
+        const __m128i v = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(
+            _mm_mullo_epi16(a16, _mm_sub_epi16(sixtyFour, w)),
+            _mm_mullo_epi16(b16, w)), half), 6);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(v, v));
+    }
+    #elif defined(CORRADE_TARGET_NEON)
+    UnsignedInt a32, b32;
+    std::memcpy(&a32, a, 4);
+    std::memcpy(&b32, b, 4);
+    const uint16x8_t a16 = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(a32)));
+    const uint16x8_t b16 = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(b32)));
+    const uint16x8_t sixtyFour = vdupq_n_u16(64);
+    for(UnsignedInt i = 0; i != count; i += 2) {
+        const uint16x8_t w = vcombine_u16(vdup_n_u16(weights[i]), vdup_n_u16(weights[i + 1]));
+        /* The rounding shift adds the 32 */
+        vst1_u8(out[i], vrshrn_n_u16(vmlaq_u16(vmulq_u16(a16, vsubq_u16(sixtyFour, w)), b16, w), 6));
+    }
+    #else
+    for(UnsignedInt i = 0; i != count; ++i)
+        for(UnsignedInt c = 0; c != 4; ++c)
+            out[i][c] = (a[c]*(64 - weights[i]) + b[c]*weights[i] + 32) >> 6;
+    #endif
+}
+
+/* Unlike bcdec_bc7(), which interpolates each pixel separately, this first
+   calculates a palette of all values for each subset and then only picks
+   from it. The palette calculation is done with SSE2 or NEON where
+   available, producing the same output as bcdec_bc7(). */
+void decodeBc7Block(const void* const src, void* const dst, const int rowStride) {
+    Bc7Bits bits;
+    std::memcpy(&bits.low, src, 8);
+    std::memcpy(&bits.high, static_cast<const char*>(src) + 8, 8);
+    Utility::Endianness::littleEndianInPlace(bits.low, bits.high);
+    char* const out = static_cast<char*>(dst);
+
+    /* Mode is the position of the first set bit. Blocks with no bit set in the
+       first byte are invalid and decoded as transparent black. */
+    UnsignedInt mode = 0;
+    while(mode != 8 && !bits.read(1)) ++mode;
+    if(mode == 8) {
+        for(std::size_t y = 0; y != 4; ++y)
+            std::memset(out + y*rowStride, 0, 16);
+        return;
+    }
+
+    const auto& info = Bc7Modes[mode];
+    const UnsignedInt partition = bits.read(info.partitionBits);
+    const UnsignedInt rotation = bits.read(info.rotationBits);
+    const UnsignedInt indexSelection = bits.read(info.indexSelectionBits);
+
+    /* Endpoints, first all red values, then green, blue and alpha */
+    const UnsignedInt endpointCount = info.subsetCount*2;
+    UnsignedByte endpoints[6][4];
+    for(UnsignedInt c = 0; c != 3; ++c)
+        for(UnsignedInt i = 0; i != endpointCount; ++i)
+            endpoints[i][c] = bits.read(info.colorBits);
+    for(UnsignedInt i = 0; i != endpointCount; ++i)
+        endpoints[i][3] = bits.read(info.alphaBits);
+
+    /* P-bits, either one per endpoint or one per subset, extending the
+       endpoint precision by one bit */
+    UnsignedInt colorBits = info.colorBits;
+    UnsignedInt alphaBits = info.alphaBits;
+    if(info.pBits != Bc7PBits::None) {
+        UnsignedInt pBits[6];
+        if(info.pBits == Bc7PBits::Unique) {
+            for(UnsignedInt i = 0; i != endpointCount; ++i)
+                pBits[i] = bits.read(1);
+        } else {
+            pBits[0] = pBits[1] = bits.read(1);
+            pBits[2] = pBits[3] = bits.read(1);
+        }
+        for(UnsignedInt i = 0; i != endpointCount; ++i)
+            for(UnsignedInt c = 0; c != 4; ++c)
+                endpoints[i][c] = (endpoints[i][c] << 1)|pBits[i];
+        ++colorBits;
+        if(alphaBits) ++alphaBits;
+    }
+
+    /* Expand the endpoints to 8 bits by replicating the high bits. Modes
+       without alpha have it set to 255. */
+    for(UnsignedInt i = 0; i != endpointCount; ++i) {
+        for(UnsignedInt c = 0; c != 3; ++c) {
+            const UnsignedInt value = endpoints[i][c] << (8 - colorBits);
+            endpoints[i][c] = value|(value >> colorBits);
+        }
+        if(alphaBits) {
+            const UnsignedInt value = endpoints[i][3] << (8 - alphaBits);
+            endpoints[i][3] = value|(value >> alphaBits);
+        } else endpoints[i][3] = 255;
+    }
+
+    /* The rotation swaps alpha with one of the color channels after the
+       interpolation. As the interpolation is per-channel, the endpoints can
+       be swapped right away. The scalar channel is then what gets
+       interpolated with the second index in modes that have it. */
+    const UnsignedInt scalarChannel = rotation ? rotation - 1 : 3;
+    if(rotation) for(UnsignedInt i = 0; i != endpointCount; ++i)
+        std::swap(endpoints[i][3], endpoints[i][scalarChannel]);
+
+    /* Subset and anchor of each pixel. Anchor pixels have the index stored
+       with one bit less. */
+    UnsignedByte subsets[16];
+    UnsignedInt anchors = 1;
+    if(info.subsetCount == 1) {
+        for(UnsignedInt i = 0; i != 16; ++i) subsets[i] = 0;
+    } else if(info.subsetCount == 2) {
+        for(UnsignedInt i = 0; i != 16; ++i)
+            subsets[i] = (Bc7Partitions2[partition] >> i) & 1;
+        anchors |= 1 << Bc7Anchors2[partition];
+    } else {
+        for(UnsignedInt i = 0; i != 16; ++i)
+            subsets[i] = (Bc7Partitions3[partition] >> 2*i) & 3;
+        anchors |= 1 << Bc7Anchors3[0][partition];
+        anchors |= 1 << Bc7Anchors3[1][partition];
+    }
+
+    /* Primary indices for all pixels, followed by secondary indices in modes
+       that have them. The second index has only the first pixel as an
+       anchor, as those modes have just one subset. */
+    UnsignedByte indices[16];
+    for(UnsignedInt i = 0; i != 16; ++i)
+        indices[i] = bits.read(info.indexBits - ((anchors >> i) & 1));
+    UnsignedByte indices2[16];
+    if(info.index2Bits) for(UnsignedInt i = 0; i != 16; ++i)
+        indices2[i] = bits.read(info.index2Bits - (i == 0));
+
+    /* Palette for each subset, used for all channels. In modes with two
+       indices, the vector channels use the primary indices and the scalar
+       channel the secondary unless the index selection bit swaps them. */
+    UnsignedByte palette[3][16][4];
+    UnsignedByte scalarPalette[8][4];
+    const UnsignedByte* vectorIndices = indices;
+    const UnsignedByte* scalarIndices = indices2;
+    UnsignedInt vectorBits = info.indexBits;
+    UnsignedInt scalarBits = info.index2Bits;
+    if(indexSelection) {
+        std::swap(vectorIndices, scalarIndices);
+        std::swap(vectorBits, scalarBits);
+    }
+    for(UnsignedInt i = 0; i != info.subsetCount; ++i)
+        interpolateBc7(endpoints[2*i], endpoints[2*i + 1], Bc7Weights[vectorBits], 1 << vectorBits, palette[i]);
+    if(scalarBits)
+        interpolateBc7(endpoints[0], endpoints[1], Bc7Weights[scalarBits], 1 << scalarBits, scalarPalette);
+
+    for(std::size_t y = 0; y != 4; ++y) {
+        char* const row = out + y*rowStride;
+        for(std::size_t x = 0; x != 4; ++x) {
+            const std::size_t i = y*4 + x;
+            std::memcpy(row + x*4, palette[subsets[i]][vectorIndices[i]], 4);
+            if(scalarBits)
+                row[x*4 + scalarChannel] = scalarPalette[scalarIndices[i]][scalarChannel];
+        }
+    }
+}
 }
 
 Containers::Optional<ImageData2D> BcDecImageConverter::doConvert(const CompressedImageView2D& image) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvert"};
     const bool bc6hToFloat = configuration().value<bool>("bc6hToFloat");
+    const bool bc6hToRgba = configuration().value<bool>("bc6hToRgba");
 
     /* Decide on target pixel format */
     PixelFormat format;
@@ -100,8 +435,11 @@ Containers::Optional<ImageData2D> BcDecImageConverter::doConvert(const Compresse
             break;
         case CompressedPixelFormat::Bc6hRGBUfloat:
         case CompressedPixelFormat::Bc6hRGBSfloat:
-            format = bc6hToFloat ?
-                PixelFormat::RGB32F :
+            if(bc6hToFloat) format = bc6hToRgba ?
+                PixelFormat::RGBA32F :
+                PixelFormat::RGB32F;
+            else format = bc6hToRgba ?
+                PixelFormat::RGBA16F :
                 PixelFormat::RGB16F;
             break;
         default:
@@ -114,12 +452,31 @@ Containers::Optional<ImageData2D> BcDecImageConverter::doConvert(const Compresse
     constexpr Vector2i blockSize{4};
     CORRADE_INTERNAL_ASSERT(compressedPixelFormatBlockSize(image.format()) == (Vector3i{blockSize, 1}));
 
+    /* Decode only a region, if requested. The offset has to be whole blocks,
+       the size can end in the middle of a block same as the image itself. */
+    const Vector4i region = configuration().value<Vector4i>("region");
+    Vector2i offset;
+    Vector2i size = image.size();
+    if(region.z() || region.w()) {
+        if((region < Vector4i{0}).any() || region.x() + region.z() > image.size().x() || region.y() + region.w() > image.size().y() || !region.z() || !region.w()) {
+            Error{} << "Trade::BcDecImageConverter::convert(): region" << Debug::packed << region << "out of range for a" << Debug::packed << image.size() << "image";
+            return {};
+        }
+        if(!(region.xy() % blockSize).isZero()) {
+            Error{} << "Trade::BcDecImageConverter::convert(): region offset" << Debug::packed << region.xy() << "isn't aligned to 4x4 blocks";
+            return {};
+        }
+
+        offset = region.xy();
+        size = Vector2i{region.z(), region.w()};
+    }
+
     /* Allocate output data. For simplicity make them contain the full 4x4
        blocks with an appropriate row length set. That way, if the actual used
        size isn't whole blocks, the extra unused pixels at the end of each row
        and at/or the end of the image are treated as padding without having
        to do a lot of special casing in the decoding loop. */
-    const Vector2i blockCount = ((image.size() + blockSize - Vector2i{1})/blockSize);
+    const Vector2i blockCount = ((size + blockSize - Vector2i{1})/blockSize);
     const Vector2i sizeInWholeBlocks = blockSize*blockCount;
     const UnsignedInt pixelSize = pixelFormatSize(format);
     Trade::ImageData2D out{
@@ -127,7 +484,7 @@ Containers::Optional<ImageData2D> BcDecImageConverter::doConvert(const Compresse
            default of 4 */
         PixelStorage{}.setRowLength(sizeInWholeBlocks.x()),
         format,
-        image.size(),
+        size,
         Containers::Array<char>{NoInit, std::size_t(pixelSize*sizeInWholeBlocks.product())},
         image.flags()};
 
@@ -138,11 +495,14 @@ Containers::Optional<ImageData2D> BcDecImageConverter::doConvert(const Compresse
         return {};
     }
     const UnsignedInt blockDataSize = compressedPixelFormatBlockDataSize(image.format());
-    const Containers::StridedArrayView2D<const char> src{
+    const Vector2i imageBlockCount = ((image.size() + blockSize - Vector2i{1})/blockSize);
+    const Containers::StridedArrayView2D<const char> src = Containers::StridedArrayView2D<const char>{
         image.data(),
-        {std::size_t(blockCount.y()), std::size_t(blockCount.x())},
-        {std::ptrdiff_t(blockCount.x()*blockDataSize), std::ptrdiff_t(blockDataSize)}
-    };
+        {std::size_t(imageBlockCount.y()), std::size_t(imageBlockCount.x())},
+        {std::ptrdiff_t(imageBlockCount.x()*blockDataSize), std::ptrdiff_t(blockDataSize)}
+    }.sliceSize(
+        {std::size_t(offset.y()/blockSize.y()), std::size_t(offset.x()/blockSize.x())},
+        {std::size_t(blockCount.y()), std::size_t(blockCount.x())});
     /* Can't use pixels() here because the pixel view may not be whole
        blocks */
     const Containers::StridedArrayView2D<char> dst{
@@ -153,43 +513,46 @@ Containers::Optional<ImageData2D> BcDecImageConverter::doConvert(const Compresse
          std::ptrdiff_t(pixelSize)}
     };
 
+    std::size_t threadCount = 1;
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = Math::max(Math::min(threadCount, std::size_t(blockCount.y())), std::size_t{1});
+    #endif
+
     /* Decode block-by-block */
     switch(image.format()) {
         case CompressedPixelFormat::Bc1RGBUnorm:
         case CompressedPixelFormat::Bc1RGBAUnorm:
         case CompressedPixelFormat::Bc1RGBSrgb:
         case CompressedPixelFormat::Bc1RGBASrgb:
-            decodeBlocks<bcdec_bc1>(src, dst);
+            decodeBlocks<bcdec_bc1>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Bc2RGBAUnorm:
         case CompressedPixelFormat::Bc2RGBASrgb:
-            decodeBlocks<bcdec_bc2>(src, dst);
+            decodeBlocks<bcdec_bc2>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Bc3RGBAUnorm:
         case CompressedPixelFormat::Bc3RGBASrgb:
-            decodeBlocks<bcdec_bc3>(src, dst);
+            decodeBlocks<bcdec_bc3>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Bc4RUnorm:
         case CompressedPixelFormat::Bc4RSnorm:
-            decodeBlocks<bcdec_bc4>(src, dst);
+            decodeBlocks<bcdec_bc4>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Bc5RGUnorm:
         case CompressedPixelFormat::Bc5RGSnorm:
-            decodeBlocks<bcdec_bc5>(src, dst);
+            decodeBlocks<bcdec_bc5>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Bc6hRGBUfloat:
-            bc6hToFloat ?
-                decodeBlocks<decodeBc6hBlock<bcdec_bc6h_float, false, 4>>(src, dst) :
-                decodeBlocks<decodeBc6hBlock<bcdec_bc6h_half, false, 2>>(src, dst);
+            decodeBc6hBlocks<false>(src, dst, threadCount, bc6hToFloat, bc6hToRgba);
             break;
         case CompressedPixelFormat::Bc6hRGBSfloat:
-            bc6hToFloat ?
-                decodeBlocks<decodeBc6hBlock<bcdec_bc6h_float, true, 4>>(src, dst) :
-                decodeBlocks<decodeBc6hBlock<bcdec_bc6h_half, true, 2>>(src, dst);
+            decodeBc6hBlocks<true>(src, dst, threadCount, bc6hToFloat, bc6hToRgba);
             break;
         case CompressedPixelFormat::Bc7RGBAUnorm:
         case CompressedPixelFormat::Bc7RGBASrgb:
-            decodeBlocks<bcdec_bc7>(src, dst);
+            decodeBlocks<decodeBc7Block>(src, dst, threadCount);
             break;
         /* Unsupported formats already handled above */
         default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
@@ -139,7 +139,9 @@ The following formats are supported:
     @relativeref{CompressedPixelFormat,Bc6hRGBSfloat} is decoded to
     @ref PixelFormat::RGB16F by default, and to @ref PixelFormat::RGB32F if the
     @cb{.ini} bc6hToFloat @ce @ref Trade-BcDecImageConverter-configuration "configuration option"
-    is enabled
+    is enabled. With the @cb{.ini} bc6hToRgba @ce option enabled, it's
+    decoded to @ref PixelFormat::RGBA16F / @relativeref{PixelFormat,RGBA32F}
+    instead, with alpha set to @cpp 1.0f @ce.
 
 The output image always has data for whole 4x4 blocks, if the actual size isn't
 whole blocks, @ref PixelStorage::setRowLength() is set to treat the extra
@@ -147,7 +149,31 @@ pixels at the end of each row as padding. Non-default @ref CompressedPixelStorag
 isn't supported in input images.
 
 Only 2D image conversion is supported at the moment. Image flags, if any, are
-passed through unchanged.
+passed through unchanged. To decode a particular mip level or layer, pass just
+the corresponding image to the converter.
+
+Setting the @cb{.ini} region @ce option decodes only a rectangle of the image,
+given as an offset and size in pixels. The offset is counted from the start of
+the data, in the same orientation as the input as the image isn't Y-flipped,
+and has to be aligned to whole 4x4 blocks. Only blocks covering the region are
+decoded and the output image has the size of the region. Same as with the whole
+image, if the region size isn't whole blocks, the extra pixels are treated as
+padding.
+
+BC7 is decoded with a custom implementation instead of the one in bcdec,
+which calculates a palette of all endpoint interpolations for each subset
+first and then only picks the pixels from it, with the palette calculation
+done using SSE2 or NEON instructions if @ref CORRADE_TARGET_SSE2 or
+@ref CORRADE_TARGET_NEON is defined. The output is the same as with bcdec.
+BC6H is decoded directly into the output image without any intermediate
+per-block copy, including the conversion to 32-bit floats and the
+four-component output.
+
+Each row of 4x4 blocks is decoded independently. Setting the
+@cb{.ini} threads @ce option to a value other than @cpp 1 @ce decodes the rows
+on multiple threads. The output is the same regardless of the thread count.
+Same as with @ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter",
+the application has to be linked to `pthread` on Linux for this to work.
 
 @section Trade-BcDecImageConverter-configuration Plugin-specific configuration
 
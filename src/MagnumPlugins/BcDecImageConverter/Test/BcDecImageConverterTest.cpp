@@ -27,18 +27,27 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/DebugTools/CompareImage.h>
+#include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Half.h>
+#include <Magnum/Math/Vector4.h>
 #include <Magnum/Trade/AbstractImageConverter.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
 #include "configure.h"
 
+/* For comparing the output of the custom BC7 decoder */
+#define BCDEC_IMPLEMENTATION
+#include "bcdec.h"
+
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
 struct BcDecImageConverterTest: TestSuite::Tester {
@@ -46,10 +55,16 @@ struct BcDecImageConverterTest: TestSuite::Tester {
 
     void test();
     void preserveFlags();
+    template<class T> void bc6hToRgba();
+    void bc7();
 
     void unsupportedFormat();
     void unsupportedStorage();
 
+    void region();
+    void regionInvalid();
+    void threads();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _manager{"nonexistent"};
     PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
@@ -160,15 +175,78 @@ const struct {
         {}, {}, 3.5f, 0.41f},
 };
 
+const struct {
+    const char* name;
+    const char* file;
+} Bc6hToRgbaData[]{
+    {"unsigned", "bc6h.dds"},
+    {"signed", "bc6hs.dds"},
+};
+
+const struct {
+    const char* name;
+    Vector4i region;
+} RegionData[]{
+    {"one block", {8, 4, 4, 4}},
+    {"whole blocks", {8, 12, 16, 20}},
+    {"last block", {60, 28, 4, 4}},
+    {"incomplete blocks", {4, 8, 13, 7}},
+    {"whole image", {0, 0, 64, 32}},
+};
+
+const struct {
+    const char* name;
+    Vector4i region;
+    const char* message;
+} RegionInvalidData[]{
+    {"negative offset", {-4, 0, 4, 4},
+        "region {-4, 0, 4, 4} out of range for a {64, 32} image"},
+    {"too wide", {4, 0, 64, 4},
+        "region {4, 0, 64, 4} out of range for a {64, 32} image"},
+    {"too high", {0, 8, 4, 28},
+        "region {0, 8, 4, 28} out of range for a {64, 32} image"},
+    {"zero width", {0, 0, 0, 4},
+        "region {0, 0, 0, 4} out of range for a {64, 32} image"},
+    {"unaligned offset", {2, 4, 4, 4},
+        "region offset {2, 4} isn't aligned to 4x4 blocks"},
+};
+
+const struct {
+    const char* name;
+    UnsignedInt threads;
+    Vector4i region;
+} ThreadsData[]{
+    {"two threads", 2, {}},
+    {"all threads", 0, {}},
+    {"more threads than block rows", 64, {}},
+    {"three threads, region", 3, {4, 8, 13, 17}},
+};
+
 BcDecImageConverterTest::BcDecImageConverterTest() {
     addInstancedTests({&BcDecImageConverterTest::test},
         Containers::arraySize(TestData));
 
-    addTests({&BcDecImageConverterTest::preserveFlags,
+    addTests({&BcDecImageConverterTest::preserveFlags});
+
+    addInstancedTests<BcDecImageConverterTest>({
+        &BcDecImageConverterTest::bc6hToRgba<Half>,
+        &BcDecImageConverterTest::bc6hToRgba<Float>},
+        Containers::arraySize(Bc6hToRgbaData));
+
+    addTests({&BcDecImageConverterTest::bc7,
 
               &BcDecImageConverterTest::unsupportedFormat,
               &BcDecImageConverterTest::unsupportedStorage});
 
+    addInstancedTests({&BcDecImageConverterTest::region},
+        Containers::arraySize(RegionData));
+
+    addInstancedTests({&BcDecImageConverterTest::regionInvalid},
+        Containers::arraySize(RegionInvalidData));
+
+    addInstancedTests({&BcDecImageConverterTest::threads},
+        Containers::arraySize(ThreadsData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef BCDECIMAGECONVERTER_PLUGIN_FILENAME
@@ -268,6 +346,73 @@ void BcDecImageConverterTest::preserveFlags() {
     CORRADE_COMPARE(converted->flags(), ImageFlag2D::Array);
 }
 
+template<class T> void BcDecImageConverterTest::bc6hToRgba() {
+    auto&& data = Bc6hToRgbaData[testCaseInstanceId()];
+    setTestCaseTemplateName(std::is_same<T, Float>::value ? "Float" : "Half");
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("DdsImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("DdsImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("DdsImporter");
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(BCDECIMAGECONVERTER_TEST_DIR, data.file)));
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("BcDecImageConverter");
+    converter->configuration().setValue("bc6hToFloat", std::is_same<T, Float>::value);
+    Containers::Optional<Trade::ImageData2D> expected = converter->convert(*image);
+    CORRADE_VERIFY(expected);
+
+    converter->configuration().setValue("bc6hToRgba", true);
+    Containers::Optional<Trade::ImageData2D> converted = converter->convert(*image);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->format(), std::is_same<T, Float>::value ? PixelFormat::RGBA32F : PixelFormat::RGBA16F);
+    CORRADE_COMPARE(converted->size(), expected->size());
+
+    /* The RGB channels should be exactly the same as in the three-component
+       output, alpha is 1 */
+    const Containers::StridedArrayView2D<const Math::Vector3<T>> rgb = expected->pixels<Math::Vector3<T>>();
+    Containers::Array<Math::Vector4<T>> expectedRgba{NoInit, rgb.size()[0]*rgb.size()[1]};
+    for(std::size_t y = 0; y != rgb.size()[0]; ++y)
+        for(std::size_t x = 0; x != rgb.size()[1]; ++x)
+            expectedRgba[y*rgb.size()[1] + x] = Math::Vector4<T>{rgb[y][x], T(1.0f)};
+    Containers::Array<Math::Vector4<T>> rgba{NoInit, expectedRgba.size()};
+    Utility::copy(converted->pixels<Math::Vector4<T>>(), Containers::StridedArrayView2D<Math::Vector4<T>>{rgba, rgb.size()});
+    CORRADE_COMPARE_AS(rgba, expectedRgba, TestSuite::Compare::Container);
+}
+
+void BcDecImageConverterTest::bc7() {
+    /* Pseudo-random blocks with the mode bits set to have all eight modes as
+       well as the invalid mode represented */
+    Containers::Array<char> blocks{NoInit, 32*32*16};
+    UnsignedInt state = 1;
+    for(char& i: blocks) {
+        state = state*1103515245u + 12345u;
+        i = state >> 16;
+    }
+    for(std::size_t i = 0; i != 32*32; ++i) {
+        const UnsignedInt mode = i % 9;
+        UnsignedByte& first = reinterpret_cast<UnsignedByte&>(blocks[i*16]);
+        first = mode == 8 ? 0 : (first & ~((2 << mode) - 1))|(1 << mode);
+    }
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("BcDecImageConverter");
+    Containers::Optional<Trade::ImageData2D> converted = converter->convert(CompressedImageView2D{CompressedPixelFormat::Bc7RGBAUnorm, {128, 128}, blocks});
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->format(), PixelFormat::RGBA8Unorm);
+
+    /* The output should be exactly the same as with the reference bcdec
+       implementation */
+    Containers::Array<char> expected{NoInit, 128*128*4};
+    for(std::size_t y = 0; y != 32; ++y)
+        for(std::size_t x = 0; x != 32; ++x)
+            bcdec_bc7(blocks + (y*32 + x)*16, expected + (y*4*128 + x*4)*4, 128*4);
+    CORRADE_COMPARE_AS(converted->data(), expected,
+        TestSuite::Compare::Container);
+}
+
 void BcDecImageConverterTest::unsupportedFormat() {
     Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("BcDecImageConverter");
 
@@ -286,6 +431,82 @@ void BcDecImageConverterTest::unsupportedStorage() {
     CORRADE_COMPARE(out.str(), "Trade::BcDecImageConverter::convert(): non-default compressed storage is not supported\n");
 }
 
+void BcDecImageConverterTest::region() {
+    auto&& data = RegionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("DdsImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("DdsImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("DdsImporter");
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "dxt10-bc7.dds")));
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), (Vector2i{64, 32}));
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("BcDecImageConverter");
+    Containers::Optional<Trade::ImageData2D> full = converter->convert(*image);
+    CORRADE_VERIFY(full);
+
+    converter->configuration().setValue("region", data.region);
+    Containers::Optional<Trade::ImageData2D> converted = converter->convert(*image);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(converted->size(), (Vector2i{data.region.z(), data.region.w()}));
+
+    /* The region should be exactly the same as the corresponding part of the
+       fully decoded image, as the blocks are decoded independently */
+    CORRADE_COMPARE_WITH(*converted,
+        (ImageView2D{PixelStorage{}.setRowLength(64).setSkip({data.region.x(), data.region.y(), 0}), full->format(), converted->size(), full->data()}),
+        (DebugTools::CompareImage{0.0f, 0.0f}));
+}
+
+void BcDecImageConverterTest::regionInvalid() {
+    auto&& data = RegionInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("BcDecImageConverter");
+    converter->configuration().setValue("region", data.region);
+
+    /* The data aren't accessed before the region is checked, the size is
+       64x32 whole blocks anyway */
+    char blockData[16*8*16]{};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(CompressedImageView2D{CompressedPixelFormat::Bc7RGBAUnorm, {64, 32}, blockData}));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::BcDecImageConverter::convert(): {}\n", data.message));
+}
+
+void BcDecImageConverterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("DdsImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("DdsImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("DdsImporter");
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "dxt10-bc7.dds")));
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("BcDecImageConverter");
+    converter->configuration().setValue("region", data.region);
+    Containers::Optional<Trade::ImageData2D> expected = converter->convert(*image);
+    CORRADE_VERIFY(expected);
+
+    /* The output should be the same regardless of the thread count */
+    converter->configuration().setValue("threads", data.threads);
+    Containers::Optional<Trade::ImageData2D> converted = converter->convert(*image);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->size(), expected->size());
+    CORRADE_COMPARE_AS(converted->data(),
+        expected->data(),
+        TestSuite::Compare::Container);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::BcDecImageConverterTest)
@@ -0,0 +1,355 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cmath>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/Path.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Vector2.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+/* Measures throughput and quality of the block compressors, decompressors
+   and Basis transcoding in the repository on a fixed corpus, so formats and
+   plugins can be picked by measured numbers and regressions caught across
+   library updates. Each benchmark iteration processes the whole corpus image
+   of CorpusSize pixels, throughput in MPix/s is thus CorpusSize.product()
+   divided by the reported time in microseconds. The quality is calculated
+   as PSNR of the decoded output against the uncompressed corpus, printed and
+   checked against a minimum.
+
+   The corpus is ship.jpg for RGB and rgba-64x32.png for RGBA formats, both
+   tiled to CorpusSize. Everything except BcDecImageConverter itself is
+   optional and the cases are skipped if the plugins aren't available. */
+struct BlockCompressionBenchmark: TestSuite::Tester {
+    explicit BlockCompressionBenchmark();
+
+    void compress();
+    void decompress();
+    void transcode();
+
+    private:
+        Containers::Optional<ImageData2D> corpus(Int channelCount);
+        Containers::Optional<ImageData2D> decode(const char* plugin, const ImageData2D& compressed);
+        Containers::Optional<ImageData2D> basisTranscode(const ImageData2D& corpus, const char* format);
+
+        /* Explicitly forbid system-wide plugin dependencies */
+        PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
+        PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
+};
+
+constexpr Vector2i CorpusSize{640, 480};
+
+const struct {
+    const char* name;
+    const char* plugin;
+    Int channelCount;
+    const char* option;
+    const char* value;
+    Float minPsnr;
+} CompressData[]{
+    {"StbDxt BC1", "StbDxtImageConverter", 3, nullptr, nullptr, 28.0f},
+    {"StbDxt BC1, high quality", "StbDxtImageConverter", 3, "highQuality", "true", 28.0f},
+    {"StbDxt BC1, all threads", "StbDxtImageConverter", 3, "threads", "0", 28.0f},
+    {"StbDxt BC3", "StbDxtImageConverter", 4, nullptr, nullptr, 28.0f},
+    {"StbDxt BC3, high quality", "StbDxtImageConverter", 4, "highQuality", "true", 28.0f},
+    {"IspcTexComp BC7, ultrafast", "IspcTexCompImageConverter", 4, "quality", "ultrafast", 32.0f},
+    {"IspcTexComp BC7, basic", "IspcTexCompImageConverter", 4, "quality", "basic", 34.0f},
+    {"IspcTexComp BC7, basic, all threads", "IspcTexCompImageConverter", 4, "threads", "0", 34.0f},
+    {"IspcTexComp BC7, slow", "IspcTexCompImageConverter", 4, "quality", "slow", 34.0f},
+};
+
+const struct {
+    const char* name;
+    const char* decoder;
+    Int channelCount;
+    /* Either a compressor plugin or a Basis transcoding target format to
+       produce the input with */
+    const char* compressor;
+    const char* basisFormat;
+    UnsignedInt threads;
+} DecompressData[]{
+    {"BcDec BC1", "BcDecImageConverter", 3, "StbDxtImageConverter", nullptr, 1},
+    {"BcDec BC1, all threads", "BcDecImageConverter", 3, "StbDxtImageConverter", nullptr, 0},
+    {"BcDec BC3", "BcDecImageConverter", 4, "StbDxtImageConverter", nullptr, 1},
+    {"BcDec BC7", "BcDecImageConverter", 4, "IspcTexCompImageConverter", nullptr, 1},
+    {"BcDec BC7, all threads", "BcDecImageConverter", 4, "IspcTexCompImageConverter", nullptr, 0},
+    {"EtcDec ETC2 RGB8", "EtcDecImageConverter", 3, nullptr, "Etc1RGB", 1},
+    {"EtcDec ETC2 RGB8, all threads", "EtcDecImageConverter", 3, nullptr, "Etc1RGB", 0},
+    {"EtcDec ETC2 RGBA8", "EtcDecImageConverter", 4, nullptr, "Etc2RGBA", 1},
+};
+
+const struct {
+    const char* name;
+    const char* format;
+    Int channelCount;
+    /* Decoder used to calculate the PSNR, nullptr if the output is
+       uncompressed */
+    const char* decoder;
+    Float minPsnr;
+} TranscodeData[]{
+    {"BC1", "Bc1RGB", 3, "BcDecImageConverter", 24.0f},
+    {"BC3", "Bc3RGBA", 4, "BcDecImageConverter", 24.0f},
+    {"BC7", "Bc7RGBA", 4, "BcDecImageConverter", 24.0f},
+    {"ETC1", "Etc1RGB", 3, "EtcDecImageConverter", 24.0f},
+    {"ETC2 RGBA", "Etc2RGBA", 4, "EtcDecImageConverter", 24.0f},
+    {"RGBA8", "RGBA8", 4, nullptr, 24.0f},
+};
+
+BlockCompressionBenchmark::BlockCompressionBenchmark() {
+    addInstancedBenchmarks({&BlockCompressionBenchmark::compress}, 5,
+        Containers::arraySize(CompressData));
+
+    addInstancedBenchmarks({&BlockCompressionBenchmark::decompress}, 10,
+        Containers::arraySize(DecompressData));
+
+    addInstancedBenchmarks({&BlockCompressionBenchmark::transcode}, 10,
+        Containers::arraySize(TranscodeData));
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef BCDECIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(BCDECIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    /* All other plugins are optional */
+    #ifdef BASISIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(BASISIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef ETCDECIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(ETCDECIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef ISPCTEXCOMPIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(ISPCTEXCOMPIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef STBDXTIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(STBDXTIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef BASISIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(BASISIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef STBIMAGEIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(STBIMAGEIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+Float psnr(const ImageView2D& expected, const ImageView2D& actual) {
+    /* Compare only the channels present in the original, the decoded output
+       may have an extra alpha channel. Both are expected to be 8-bit. */
+    CORRADE_INTERNAL_ASSERT(expected.size() == actual.size());
+    const std::size_t channelCount = pixelFormatChannelCount(expected.format());
+    const Containers::StridedArrayView3D<const UnsignedByte> a = Containers::arrayCast<const UnsignedByte>(expected.pixels());
+    const Containers::StridedArrayView3D<const UnsignedByte> b = Containers::arrayCast<const UnsignedByte>(actual.pixels());
+    CORRADE_INTERNAL_ASSERT(a.size()[2] == channelCount && b.size()[2] >= channelCount);
+
+    Double sum = 0.0;
+    for(std::size_t y = 0; y != a.size()[0]; ++y)
+        for(std::size_t x = 0; x != a.size()[1]; ++x)
+            for(std::size_t c = 0; c != channelCount; ++c) {
+                const Double difference = Double(a[y][x][c]) - Double(b[y][x][c]);
+                sum += difference*difference;
+            }
+
+    const Double mse = sum/Double(a.size()[0]*a.size()[1]*channelCount);
+    /* Lossless output would give an infinity, report it as a large but
+       finite value instead to not have the comparison fail */
+    if(mse == 0.0) return 100.0f;
+    return Float(10.0*std::log10(255.0*255.0/mse));
+}
+
+Containers::Optional<ImageData2D> BlockCompressionBenchmark::corpus(const Int channelCount) {
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StbImageImporter");
+    CORRADE_INTERNAL_ASSERT(channelCount == 3 || channelCount == 4);
+    if(!importer->openFile(channelCount == 3 ?
+        Utility::Path::join(STBDXTIMAGECONVERTER_TEST_DIR, "ship.jpg") :
+        Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-64x32.png")))
+        return {};
+    Containers::Optional<ImageData2D> tile = importer->image2D(0);
+    if(!tile) return {};
+    CORRADE_INTERNAL_ASSERT(pixelFormatChannelCount(tile->format()) == UnsignedInt(channelCount));
+    CORRADE_INTERNAL_ASSERT((CorpusSize % tile->size()).isZero());
+
+    /* The tile sizes are multiples of four, so the rows are tightly packed in
+       both the tile and the output */
+    const std::size_t pixelSize = tile->pixelSize();
+    ImageData2D out{tile->format(), CorpusSize, Containers::Array<char>{NoInit, std::size_t(CorpusSize.product())*pixelSize}};
+    const Containers::StridedArrayView3D<const char> src = tile->pixels();
+    const Containers::StridedArrayView3D<char> dst = out.mutablePixels();
+    for(std::size_t y = 0; y < dst.size()[0]; y += src.size()[0])
+        for(std::size_t x = 0; x < dst.size()[1]; x += src.size()[1])
+            Utility::copy(src, dst.sliceSize({y, x, 0}, src.size()));
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(out));
+}
+
+Containers::Optional<ImageData2D> BlockCompressionBenchmark::decode(const char* const plugin, const ImageData2D& compressed) {
+    if(_converterManager.loadState(plugin) == PluginManager::LoadState::NotFound)
+        return {};
+    return _converterManager.instantiate(plugin)->convert(compressed);
+}
+
+Containers::Optional<ImageData2D> BlockCompressionBenchmark::basisTranscode(const ImageData2D& corpus, const char* const format) {
+    /* Not flipping on either side, so the compressed output has the same
+       orientation as the corpus */
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    converter->configuration().setValue("y_flip", false);
+    Containers::Optional<Containers::Array<char>> file = converter->convertToData(corpus);
+    if(!file) return {};
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("BasisImporter");
+    importer->configuration().setValue("format", format);
+    importer->configuration().setValue("assumeYUp", true);
+    if(!importer->openData(*file)) return {};
+    return importer->image2D(0);
+}
+
+void BlockCompressionBenchmark::compress() {
+    auto&& data = CompressData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot benchmark");
+    if(_converterManager.loadState(data.plugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.plugin << "plugin not found, cannot benchmark");
+
+    Containers::Optional<ImageData2D> image = corpus(data.channelCount);
+    CORRADE_VERIFY(image);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate(data.plugin);
+    if(data.option)
+        converter->configuration().setValue(data.option, data.value);
+
+    Containers::Optional<ImageData2D> compressed;
+    CORRADE_BENCHMARK(5)
+        compressed = converter->convert(*image);
+
+    CORRADE_VERIFY(compressed);
+    CORRADE_VERIFY(compressed->isCompressed());
+
+    Containers::Optional<ImageData2D> decoded = decode("BcDecImageConverter", *compressed);
+    CORRADE_VERIFY(decoded);
+    const Float quality = psnr(*image, *decoded);
+    CORRADE_INFO("PSNR:" << quality << "dB");
+    CORRADE_COMPARE_AS(quality, data.minPsnr, TestSuite::Compare::GreaterOrEqual);
+}
+
+void BlockCompressionBenchmark::decompress() {
+    auto&& data = DecompressData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot benchmark");
+    if(_converterManager.loadState(data.decoder) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.decoder << "plugin not found, cannot benchmark");
+
+    Containers::Optional<ImageData2D> image = corpus(data.channelCount);
+    CORRADE_VERIFY(image);
+
+    /* Produce the compressed input */
+    Containers::Optional<ImageData2D> compressed;
+    if(data.compressor) {
+        if(_converterManager.loadState(data.compressor) == PluginManager::LoadState::NotFound)
+            CORRADE_SKIP(data.compressor << "plugin not found, cannot benchmark");
+        compressed = _converterManager.instantiate(data.compressor)->convert(*image);
+    } else {
+        if(_converterManager.loadState("BasisImageConverter") == PluginManager::LoadState::NotFound ||
+           _importerManager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
+            CORRADE_SKIP("BasisImageConverter / BasisImporter plugin not found, cannot benchmark");
+        compressed = basisTranscode(*image, data.basisFormat);
+    }
+    CORRADE_VERIFY(compressed);
+    CORRADE_VERIFY(compressed->isCompressed());
+
+    Containers::Pointer<AbstractImageConverter> decoder = _converterManager.instantiate(data.decoder);
+    decoder->configuration().setValue("threads", data.threads);
+
+    Containers::Optional<ImageData2D> decoded;
+    CORRADE_BENCHMARK(10)
+        decoded = decoder->convert(*compressed);
+
+    CORRADE_VERIFY(decoded);
+    CORRADE_COMPARE(decoded->size(), CorpusSize);
+}
+
+void BlockCompressionBenchmark::transcode() {
+    auto&& data = TranscodeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot benchmark");
+    if(_converterManager.loadState("BasisImageConverter") == PluginManager::LoadState::NotFound ||
+       _importerManager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BasisImageConverter / BasisImporter plugin not found, cannot benchmark");
+
+    Containers::Optional<ImageData2D> image = corpus(data.channelCount);
+    CORRADE_VERIFY(image);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    converter->configuration().setValue("y_flip", false);
+    Containers::Optional<Containers::Array<char>> file = converter->convertToData(*image);
+    CORRADE_VERIFY(file);
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("BasisImporter");
+    importer->configuration().setValue("format", data.format);
+    importer->configuration().setValue("assumeYUp", true);
+    CORRADE_VERIFY(importer->openData(*file));
+
+    Containers::Optional<ImageData2D> transcoded;
+    CORRADE_BENCHMARK(10)
+        transcoded = importer->image2D(0);
+
+    CORRADE_VERIFY(transcoded);
+    CORRADE_COMPARE(transcoded->size(), CorpusSize);
+
+    Containers::Optional<ImageData2D> decoded;
+    if(data.decoder) {
+        if(_converterManager.loadState(data.decoder) == PluginManager::LoadState::NotFound)
+            CORRADE_SKIP(data.decoder << "plugin not found, cannot calculate PSNR");
+        decoded = decode(data.decoder, *transcoded);
+    } else decoded = Utility::move(transcoded);
+    CORRADE_VERIFY(decoded);
+    const Float quality = psnr(*image, *decoded);
+    CORRADE_INFO("PSNR:" << quality << "dB");
+    CORRADE_COMPARE_AS(quality, data.minPsnr, TestSuite::Compare::GreaterOrEqual);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::BlockCompressionBenchmark)
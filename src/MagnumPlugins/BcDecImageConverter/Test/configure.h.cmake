@@ -24,12 +24,18 @@
 */
 
 #cmakedefine BCDECIMAGECONVERTER_PLUGIN_FILENAME "${BCDECIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine BASISIMAGECONVERTER_PLUGIN_FILENAME "${BASISIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine BASISIMPORTER_PLUGIN_FILENAME "${BASISIMPORTER_PLUGIN_FILENAME}"
 #cmakedefine DDSIMPORTER_PLUGIN_FILENAME "${DDSIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine ETCDECIMAGECONVERTER_PLUGIN_FILENAME "${ETCDECIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine ISPCTEXCOMPIMAGECONVERTER_PLUGIN_FILENAME "${ISPCTEXCOMPIMAGECONVERTER_PLUGIN_FILENAME}"
 #cmakedefine KTXIMPORTER_PLUGIN_FILENAME "${KTXIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine STBDXTIMAGECONVERTER_PLUGIN_FILENAME "${STBDXTIMAGECONVERTER_PLUGIN_FILENAME}"
 #cmakedefine STBIMAGEIMPORTER_PLUGIN_FILENAME "${STBIMAGEIMPORTER_PLUGIN_FILENAME}"
 #define BCDECIMAGECONVERTER_TEST_DIR "${BCDECIMAGECONVERTER_TEST_DIR}"
 #define BASISIMPORTER_TEST_DIR "${BASISIMPORTER_TEST_DIR}"
 #define DDSIMPORTER_TEST_DIR "${DDSIMPORTER_TEST_DIR}"
 #define KTXIMPORTER_TEST_DIR "${KTXIMPORTER_TEST_DIR}"
 #define PNGIMPORTER_TEST_DIR "${PNGIMPORTER_TEST_DIR}"
+#define STBDXTIMAGECONVERTER_TEST_DIR "${STBDXTIMAGECONVERTER_TEST_DIR}"
 #define STBIMAGEIMPORTER_TEST_DIR "${STBIMAGEIMPORTER_TEST_DIR}"
@@ -52,6 +52,15 @@ namespace Magnum { namespace Trade {
 @m_keywords{GltfImporter}
 
 This plugins provides the `GltfImporter` plugin.
+
+The plugin no longer uses cgltf for loading buffers, all file access goes
+through the @ref GltfImporter implementation, including file callbacks. Its
+configuration file is kept frozen, so options added to @ref GltfImporter
+later, such as @cb{.ini} mapExternalBuffers @ce or
+@cb{.ini} zeroCopyMeshes @ce for memory-mapping external buffers and
+importing meshes as views on them, aren't listed in it. They can still be
+enabled by setting them explicitly, but it's recommended to switch to
+@ref GltfImporter directly instead.
 */
 #ifdef DOXYGEN_GENERATING_OUTPUT
 class CgltfImporter: public GltfImporter {};
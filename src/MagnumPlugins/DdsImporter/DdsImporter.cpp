@@ -39,9 +39,12 @@
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/Math/Vector4.h>
-#include <Magnum/Math/Swizzle.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/asyncImageImport.h"
+#include "Magnum/Implementation/instrumentation.h"
+#include "Magnum/Implementation/mapFile.h"
+
 #ifdef MAGNUM_BUILD_DEPRECATED
 #include <Magnum/Trade/TextureData.h>
 #endif
@@ -233,6 +236,12 @@ constexpr struct {
 struct DdsImporter::File {
     Containers::Array<char> in;
 
+    /* Memory-mapped input file, if the mapFile option was enabled. The `in`
+       array is a non-owning view on it in that case. */
+    #ifdef MAGNUM_IMPLEMENTATION_MAP_FILE
+    Magnum::Implementation::MappedFile mapped;
+    #endif
+
     /* Size of one top-level slice. As it's used as an input for level size
        calculation, it doesn't take sliceCount into account. */
     Vector3i topLevelSliceSize{NoInit};
@@ -247,7 +256,11 @@ struct DdsImporter::File {
     std::size_t sliceSize; /* Size of one slice including all mip levels */
 
     bool compressed;
+    /* Axes along which the data get flipped on import, and axes along which
+       the data would need to be flipped but aren't, exposed through image
+       importer state */
     BitVector2 yzFlip{NoInit};
+    BitVector2 yzFlipDeferred{NoInit};
     union Properties {
         /* Yeah fuck off C++, this is unhelpful, this is not the point where I
            want to initialize anything, THIS IS NOT, the parent struct is */
@@ -269,13 +282,47 @@ struct DdsImporter::File {
 
 DdsImporter::DdsImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
 
-DdsImporter::~DdsImporter() = default;
+struct DdsImporter::AsyncState: Magnum::Implementation::AsyncImageImport {};
+
+DdsImporter::~DdsImporter() {
+    if(_async) _async->wait();
+}
+
+bool DdsImporter::image2DAsync(const UnsignedInt id, const UnsignedInt level, void(*const executor)(void(*)(void*), void*, void*), void(*const callback)(UnsignedInt, UnsignedInt, Containers::Optional<ImageData2D>&&, void*), void* const userData) {
+    if(!_async) _async.emplace();
+    return _async->schedule("Trade::DdsImporter::image2DAsync():", *this, id, level, executor, callback, userData);
+}
 
 ImporterFeatures DdsImporter::doFeatures() const { return ImporterFeature::OpenData; }
 
 bool DdsImporter::doIsOpened() const { return !!_f; }
 
-void DdsImporter::doClose() { _f = nullptr; }
+void DdsImporter::doClose() {
+    /* In-flight asynchronous imports reference the file, wait for them */
+    if(_async) _async->wait();
+    _f = nullptr;
+}
+
+void DdsImporter::doOpenFile(const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenFile", filename};
+    /* If enabled, memory-map the file instead of reading it into memory. The
+       data are referenced for the whole time the file is opened, so with
+       zeroCopy enabled as well the pixel data are paged in from the disk only
+       once they're actually accessed. */
+    #ifdef MAGNUM_IMPLEMENTATION_MAP_FILE
+    if(configuration().value<bool>("mapFile")) {
+        Containers::Optional<Magnum::Implementation::MappedFile> mapped = Magnum::Implementation::openMappedFile("Trade::DdsImporter::openFile():", filename, [this](Containers::Array<char>&& data, const DataFlags dataFlags) {
+            doOpenData(Utility::move(data), dataFlags);
+        });
+
+        /* Keep the mapping alive for as long as the file is opened */
+        if(mapped && _f) _f->mapped = Utility::move(*mapped);
+        return;
+    }
+    #endif
+
+    AbstractImporter::doOpenFile(filename);
+}
 
 namespace {
 
@@ -306,6 +353,7 @@ Containers::Triple<std::size_t, std::size_t, Vector3i> levelOffsetSize(Vector3i
 }
 
 void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     Containers::Pointer<File> f{new File};
 
     /* Take over the existing array or copy the data if we can't */
@@ -663,6 +711,7 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
     /* Decide about data flipping. Unlike KTX or Basis, the file format doesn't
        contain any orientation metadata, so we have to rely on an
        externally-provided hint. */
+    f->yzFlipDeferred = BitVector2{0x0};
     if(configuration().value<bool>("assumeYUpZBackward")) {
         /* No flipping if Y up / Z backward is assumed */
         f->yzFlip = BitVector2{0x0};
@@ -675,9 +724,15 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
         if(f->dimensions == 3 || (f->dimensions == 2 && !(f->imageFlags & ImageFlag3D::Array)))
             f->yzFlip.set(0);
 
+        /* If the flip is deferred to the application, just remember which
+           axes would need it. No format limitations apply in that case. */
+        if(configuration().value<bool>("deferFlip")) {
+            f->yzFlipDeferred = f->yzFlip;
+            f->yzFlip = BitVector2{0x0};
+
         /* Only some compressed formats can be Y-flipped right now. Print a
            warning for the others and reset the flip bit. */
-        if(f->yzFlip[0] && f->compressed &&
+        } else if(f->yzFlip[0] && f->compressed &&
             f->properties.compressed.format != CompressedPixelFormat::Bc1RGBAUnorm &&
             f->properties.compressed.format != CompressedPixelFormat::Bc1RGBASrgb &&
             f->properties.compressed.format != CompressedPixelFormat::Bc2RGBAUnorm &&
@@ -704,6 +759,14 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
             Debug{} << "Trade::DdsImporter::openData(): image will be flipped along" << " and "_s.joinWithoutEmptyParts(axes);
         }
 
+        if(f->yzFlipDeferred.any()) {
+            const Containers::StringView axes[3]{
+                f->yzFlipDeferred[0] ? "Y"_s : ""_s,
+                f->yzFlipDeferred[1] ? "Z"_s : ""_s
+            };
+            Debug{} << "Trade::DdsImporter::openData(): image needs to be flipped along" << " and "_s.joinWithoutEmptyParts(axes) << Debug::nospace << ", deferring to the application";
+        }
+
         if(!f->compressed && f->properties.uncompressed.needsSwizzle) {
             if(f->properties.uncompressed.format == PixelFormat::RGB8Unorm)
                 Debug{} << "Trade::DdsImporter::openData(): format requires conversion from BGR to RGB";
@@ -720,27 +783,31 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
 namespace {
 
 void swizzlePixels(const PixelFormat format, const Containers::ArrayView<char> data) {
+    /* Both variants are written as plain loops over bytes or 32-bit words
+       without any cross-iteration dependencies so the compiler can vectorize
+       them, which the Math::gather() calls on individual pixels didn't allow
+       in practice. The data are tightly packed, so it's all one loop. */
     if(format == PixelFormat::RGB8Unorm) {
-        for(Vector3ub& pixel: Containers::arrayCast<Vector3ub>(data))
-            pixel = Math::gather<'b', 'g', 'r'>(pixel);
+        for(char *i = data.begin(), *end = data.end(); i != end; i += 3) {
+            const char b = i[0];
+            i[0] = i[2];
+            i[2] = b;
+        }
     } else if(format == PixelFormat::RGBA8Unorm) {
-        for(Vector4ub& pixel: Containers::arrayCast<Vector4ub>(data))
-            pixel = Math::gather<'b', 'g', 'r', 'a'>(pixel);
+        /* Swapping the first and third byte, keeping the second and fourth */
+        for(UnsignedInt& pixel: Containers::arrayCast<UnsignedInt>(data)) {
+            #ifndef CORRADE_TARGET_BIG_ENDIAN
+            pixel = (pixel & 0xff00ff00u)|((pixel >> 16) & 0x000000ffu)|((pixel & 0x000000ffu) << 16);
+            #else
+            pixel = (pixel & 0x00ff00ffu)|((pixel >> 16) & 0x0000ff00u)|((pixel & 0x0000ff00u) << 16);
+            #endif
+        }
     } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 }
 
-void flipPixels(const BitVector2 yzFlip, const UnsignedInt pixelSize, const Vector3i& size, const Containers::ArrayView<char> data) {
-    const Containers::StridedArrayView4D<char> view{data, {
-        std::size_t(size.z()),
-        std::size_t(size.y()),
-        std::size_t(size.x()),
-        pixelSize
-    }};
-    if(yzFlip[0]) Utility::flipInPlace<1>(view);
-    if(yzFlip[1]) Utility::flipInPlace<0>(view);
-}
-
-void flipBlocks(const Vector3i& size, const ImporterFlags flags, const char* messagePrefix, const BitVector2 yzFlip, const CompressedPixelFormat format, const Vector3i& blockSize, const UnsignedInt blockDataSize, const Containers::ArrayView<char> data) {
+/* Z flip is done directly when copying the data in doImage(), this handles
+   just the Y flip which has to flip also the block contents */
+void yFlipBlocks(const Vector3i& size, const ImporterFlags flags, const char* messagePrefix, const CompressedPixelFormat format, const Vector3i& blockSize, const UnsignedInt blockDataSize, const Containers::ArrayView<char> data) {
     const Vector3i blockCount = (size + blockSize - Vector3i{1})/blockSize;
     const Containers::StridedArrayView4D<char> view{data, {
         std::size_t(blockCount.z()),
@@ -749,31 +816,27 @@ void flipBlocks(const Vector3i& size, const ImporterFlags flags, const char* mes
         blockDataSize
     }};
 
-    if(yzFlip[0]) {
-        if(!(flags & ImporterFlag::Quiet) && size.y() % blockSize.y() != 0)
-            Warning{} << messagePrefix << "Y-flipping a compressed image that's not whole blocks, the result will be shifted by" << (blockSize.y() - (size.y() % blockSize.y())) << "pixels";
-
-        if(format == CompressedPixelFormat::Bc1RGBAUnorm ||
-           format == CompressedPixelFormat::Bc1RGBASrgb)
-            Math::yFlipBc1InPlace(view);
-        else if(format == CompressedPixelFormat::Bc2RGBAUnorm ||
-                format == CompressedPixelFormat::Bc2RGBASrgb)
-            Math::yFlipBc2InPlace(view);
-        else if(format == CompressedPixelFormat::Bc3RGBAUnorm ||
-                format == CompressedPixelFormat::Bc3RGBASrgb)
-            Math::yFlipBc3InPlace(view);
-        else if(format == CompressedPixelFormat::Bc4RUnorm ||
-                format == CompressedPixelFormat::Bc4RSnorm)
-            Math::yFlipBc4InPlace(view);
-        else if(format == CompressedPixelFormat::Bc5RGUnorm ||
-                format == CompressedPixelFormat::Bc5RGSnorm)
-            Math::yFlipBc5InPlace(view);
-        /* For all other -- not yet supported -- formats the yzFlip[0] bit was
-           reset so it shouldn't get here */
-        else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-    }
-    if(yzFlip[1])
-        Utility::flipInPlace<0>(view);
+    if(!(flags & ImporterFlag::Quiet) && size.y() % blockSize.y() != 0)
+        Warning{} << messagePrefix << "Y-flipping a compressed image that's not whole blocks, the result will be shifted by" << (blockSize.y() - (size.y() % blockSize.y())) << "pixels";
+
+    if(format == CompressedPixelFormat::Bc1RGBAUnorm ||
+       format == CompressedPixelFormat::Bc1RGBASrgb)
+        Math::yFlipBc1InPlace(view);
+    else if(format == CompressedPixelFormat::Bc2RGBAUnorm ||
+            format == CompressedPixelFormat::Bc2RGBASrgb)
+        Math::yFlipBc2InPlace(view);
+    else if(format == CompressedPixelFormat::Bc3RGBAUnorm ||
+            format == CompressedPixelFormat::Bc3RGBASrgb)
+        Math::yFlipBc3InPlace(view);
+    else if(format == CompressedPixelFormat::Bc4RUnorm ||
+            format == CompressedPixelFormat::Bc4RSnorm)
+        Math::yFlipBc4InPlace(view);
+    else if(format == CompressedPixelFormat::Bc5RGUnorm ||
+            format == CompressedPixelFormat::Bc5RGSnorm)
+        Math::yFlipBc5InPlace(view);
+    /* For all other -- not yet supported -- formats the yzFlip[0] bit was
+       reset so it shouldn't get here */
+    else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 }
 
 }
@@ -784,35 +847,102 @@ template<UnsignedInt dimensions> ImageData<dimensions> DdsImporter::doImage(cons
         levelOffsetSize(_f->topLevelSliceSize, _f->properties.compressed.blockSize, _f->properties.compressed.blockDataSize, level) :
         levelOffsetSize(_f->topLevelSliceSize, _f->properties.uncompressed.pixelSize, level);
 
+    /* Range of slices to import. If just a single array layer or cube map
+       face is requested, it's imported as a single-layer array image. */
+    std::size_t firstSlice = 0;
+    std::size_t sliceCount = _f->sliceCount;
+    ImageFlags3D imageFlags = _f->imageFlags;
+    if(const Containers::StringView layer = configuration().value<Containers::StringView>("layer")) {
+        if(!(imageFlags & (ImageFlag3D::Array|ImageFlag3D::CubeMap))) {
+            Error{} << messagePrefix << "the layer option can be used only with array and cube map images";
+            return {};
+        }
+
+        const UnsignedInt slice = configuration().value<UnsignedInt>("layer");
+        if(slice >= _f->sliceCount) {
+            Error{} << messagePrefix << "layer" << layer << "out of range for" << _f->sliceCount << "layers";
+            return {};
+        }
+
+        firstSlice = slice;
+        sliceCount = 1;
+        if(imageFlags & ImageFlag3D::CubeMap)
+            imageFlags = (imageFlags & ~ImageFlag3D::CubeMap)|ImageFlag3D::Array;
+    }
+
     /* Image size is slice size combined with slice count */
     Vector3i imageSize = offsetSize.third();
     if(_f->sliceCount != 1) {
         CORRADE_INTERNAL_ASSERT(imageSize[dimensions - 1] == 1);
-        imageSize[dimensions - 1] = _f->sliceCount;
+        imageSize[dimensions - 1] = sliceCount;
+    }
+
+    /* If no pixel processing is needed and the data for all slices are next
+       to each other in the file, return a view on the input data if
+       requested. Slices of array and cube map images have all their levels
+       stored together, so the slices are contiguous only if there's just a
+       single level or a single slice is imported. */
+    if(configuration().value<bool>("zeroCopy") && !_f->yzFlip.any() &&
+       (_f->compressed || !_f->properties.uncompressed.needsSwizzle) &&
+       (sliceCount == 1 || _f->levelCount == 1))
+    {
+        const Containers::ArrayView<const char> view = _f->in.sliceSize(_f->dataOffset + firstSlice*_f->sliceSize + offsetSize.first(), offsetSize.second()*sliceCount);
+        if(_f->compressed)
+            return ImageData<dimensions>{_f->properties.compressed.format, Math::Vector<dimensions, Int>::pad(imageSize), DataFlags{}, view, ImageFlag<dimensions>(UnsignedShort(imageFlags)), &_f->yzFlipDeferred};
+
+        PixelStorage storage;
+        if((imageSize.x()*_f->properties.uncompressed.pixelSize % 4 != 0))
+            storage.setAlignment(1);
+        return ImageData<dimensions>{storage, _f->properties.uncompressed.format, Math::Vector<dimensions, Int>::pad(imageSize), DataFlags{}, view, ImageFlag<dimensions>(UnsignedShort(imageFlags)), &_f->yzFlipDeferred};
     }
 
     /* Allocate image data */
-    Containers::Array<char> data{NoInit, offsetSize.second()*_f->sliceCount};
+    Containers::Array<char> data{NoInit, offsetSize.second()*sliceCount};
 
-    /* Copy all slices */
-    for(std::size_t i = 0; i != _f->sliceCount; ++i) {
-        const std::size_t inputOffset = _f->dataOffset + i*_f->sliceSize + offsetSize.first();
+    /* Size of a single slice in pixels or blocks, and size of a single pixel
+       or block. The slices are tightly packed so this is all that's needed
+       to make a view on them. */
+    Vector3i sliceSize;
+    std::size_t elementSize;
+    if(_f->compressed) {
+        const Vector3i& blockSize = _f->properties.compressed.blockSize;
+        sliceSize = (offsetSize.third() + blockSize - Vector3i{1})/blockSize;
+        elementSize = _f->properties.compressed.blockDataSize;
+    } else {
+        sliceSize = offsetSize.third();
+        elementSize = _f->properties.uncompressed.pixelSize;
+    }
+
+    /* Copy all slices. Instead of copying as-is and then flipping in place in
+       a second pass, the flip is done by copying from a flipped view, which
+       touches the data just once. Blocks of compressed formats additionally
+       need their contents flipped for Y, which is done below. */
+    for(std::size_t i = 0; i != sliceCount; ++i) {
+        const std::size_t inputOffset = _f->dataOffset + (firstSlice + i)*_f->sliceSize + offsetSize.first();
         const std::size_t outputOffset = i*offsetSize.second();
-        Utility::copy(_f->in.slice(inputOffset, inputOffset + offsetSize.second()),
-            data.slice(outputOffset, outputOffset + offsetSize.second()));
+        const Containers::Size4D viewSize{
+            std::size_t(sliceSize.z()),
+            std::size_t(sliceSize.y()),
+            std::size_t(sliceSize.x()),
+            elementSize
+        };
+        Containers::StridedArrayView4D<const char> src{_f->in.slice(inputOffset, inputOffset + offsetSize.second()), viewSize};
+        if(_f->yzFlip[0] && !_f->compressed) src = src.flipped<1>();
+        if(_f->yzFlip[1]) src = src.flipped<0>();
+        Utility::copy(src, Containers::StridedArrayView4D<char>{data.slice(outputOffset, outputOffset + offsetSize.second()), viewSize});
     }
 
-    /* Compressed image. Flip if needed. */
+    /* Compressed image. Flip block contents if needed. */
     if(_f->compressed) {
-        flipBlocks(imageSize, flags(), messagePrefix, _f->yzFlip, _f->properties.compressed.format, _f->properties.compressed.blockSize, _f->properties.compressed.blockDataSize, data);
+        if(_f->yzFlip[0])
+            yFlipBlocks(imageSize, flags(), messagePrefix, _f->properties.compressed.format, _f->properties.compressed.blockSize, _f->properties.compressed.blockDataSize, data);
 
-        return ImageData<dimensions>{_f->properties.compressed.format, Math::Vector<dimensions, Int>::pad(imageSize), Utility::move(data), ImageFlag<dimensions>(UnsignedShort(_f->imageFlags))};
+        return ImageData<dimensions>{_f->properties.compressed.format, Math::Vector<dimensions, Int>::pad(imageSize), Utility::move(data), ImageFlag<dimensions>(UnsignedShort(imageFlags)), &_f->yzFlipDeferred};
     }
 
-    /* Uncompressed. Swizzle and flip if needed. */
+    /* Uncompressed. Swizzle if needed. */
     if(_f->properties.uncompressed.needsSwizzle)
         swizzlePixels(_f->properties.uncompressed.format, data);
-    flipPixels(_f->yzFlip, _f->properties.uncompressed.pixelSize, imageSize, data);
 
     /* Adjust pixel storage if row size is not four byte aligned */
     PixelStorage storage;
@@ -821,7 +951,7 @@ template<UnsignedInt dimensions> ImageData<dimensions> DdsImporter::doImage(cons
 
     /** @todo expose DdsAlphaMode::Premultiplied through ImageFlags once it has
         such flag */
-    return ImageData<dimensions>{storage, _f->properties.uncompressed.format, Math::Vector<dimensions, Int>::pad(imageSize), Utility::move(data), ImageFlag<dimensions>(UnsignedShort(_f->imageFlags))};
+    return ImageData<dimensions>{storage, _f->properties.uncompressed.format, Math::Vector<dimensions, Int>::pad(imageSize), Utility::move(data), ImageFlag<dimensions>(UnsignedShort(imageFlags)), &_f->yzFlipDeferred};
 }
 
 UnsignedInt DdsImporter::doImage1DCount() const {
@@ -833,6 +963,7 @@ UnsignedInt DdsImporter::doImage1DLevelCount(UnsignedInt) {
 }
 
 Containers::Optional<ImageData1D> DdsImporter::doImage1D(const UnsignedInt id, const UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage1D", {}, id};
     return doImage<1>("Trade::DdsImporter::image1D():", id, level);
 }
 
@@ -845,6 +976,7 @@ UnsignedInt DdsImporter::doImage2DLevelCount(UnsignedInt) {
 }
 
 Containers::Optional<ImageData2D> DdsImporter::doImage2D(const UnsignedInt id, const UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D", {}, id};
     return doImage<2>("Trade::DdsImporter::image2D():", id, level);
 }
 
@@ -857,6 +989,7 @@ UnsignedInt DdsImporter::doImage3DLevelCount(UnsignedInt) {
 }
 
 Containers::Optional<ImageData3D> DdsImporter::doImage3D(const UnsignedInt id, const UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage3D", {}, id};
     return doImage<3>("Trade::DdsImporter::image3D():", id, level);
 }
 
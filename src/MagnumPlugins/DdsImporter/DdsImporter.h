@@ -119,11 +119,59 @@ See @ref building-plugins, @ref cmake-plugins, @ref plugins and
     Set the @cb{.ini} assumeYUpZBackward @ce
     @ref Trade-DdsImporter-configuration "configuration option" to assume the
     OpenGL coordinate system and perform no flipping.
+@par
+    Alternatively, enable the @cb{.ini} deferFlip @ce option to keep the data
+    as they are in the file and let the application perform the flip, for
+    example in texture coordinates. In that case,
+    @ref ImageData::importerState() of every imported image is a pointer to a
+    @ref Magnum::BitVector2 "BitVector2", with the first bit set if the image
+    needs to be flipped along Y and the second bit set if it needs to be
+    flipped along Z. This works for all compressed formats, including those for
+    which the Y flip isn't implemented, and no warning is printed for them.
 
 The importer recognizes @ref ImporterFlag::Verbose, printing additional info
 when the flag is enabled. @ref ImporterFlag::Quiet is recognized as well and
 causes all import warnings to be suppressed.
 
+@subsection Trade-DdsImporter-behavior-zero-copy Zero-copy import
+
+By default, image data are copied out of the file on every @ref image1D() /
+@ref image2D() / @ref image3D() call. If the @cb{.ini} zeroCopy @ce
+@ref Trade-DdsImporter-configuration "configuration option" is enabled and the
+image doesn't need to be flipped or swizzled, the returned @ref ImageData is
+instead a non-owning view on the data passed to @ref openData() or
+@ref openMemory(), with empty @ref ImageData::dataFlags(). Such view is valid
+only until the importer is closed or another file is opened. As DDS files are
+Y down, this in practice means either the @cb{.ini} assumeYUpZBackward @ce or
+the @cb{.ini} deferFlip @ce option has to be enabled as well.
+
+Array and cube map images with multiple mip levels store all levels of a slice
+or face together, so a particular level of all slices isn't contiguous in the
+file and is always copied. Array and cube map images with just a single level,
+single layers imported with the @cb{.ini} layer @ce option described in
+@ref Trade-DdsImporter-behavior-layer as well as all 1D, 2D and 3D images
+fulfilling the above conditions are imported without a copy.
+
+As @ref openData() copies the data unless their ownership is transferred and
+@ref openFile() reads the whole file into memory, enabling the
+@cb{.ini} mapFile @ce option makes @ref openFile() memory-map the file with
+@relativeref{Corrade,Utility::Path::mapRead()} instead, which together with
+@cb{.ini} zeroCopy @ce avoids any copy of the pixel data whatsoever. This is
+available only on platforms where memory-mapping is supported. The same can be
+achieved by passing a memory-mapped file to @ref openMemory():
+
+@code{.cpp}
+Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> mapped = Utility::Path::mapRead("texture.dds");
+
+importer->configuration().setValue("assumeYUpZBackward", true);
+importer->configuration().setValue("zeroCopy", true);
+if(!mapped || !importer->openMemory(*mapped))
+    Fatal{} << "Can't open the file";
+
+Containers::Optional<Trade::ImageData3D> image = importer->image3D(0);
+// upload image->data() to the GPU, then close the importer and unmap
+@endcode
+
 @subsection Trade-DdsImporter-behavior-types Image types
 
 All image types supported by DDS are imported, including 1D, 1D array, 2D, 2D
@@ -140,6 +188,19 @@ dimension. 1D array textures import @ref ImageData2D with n y-slices, 2D array
 textures import @ref ImageData3D with n z-slices and (layered) cube maps import
 @ref ImageData3D with 6*n z-slices.
 
+@subsection Trade-DdsImporter-behavior-layer Single layer import
+
+By default, each level of an array or cube map image is imported with all its
+layers and faces. Setting the @cb{.ini} layer @ce
+@ref Trade-DdsImporter-configuration "configuration option" to a particular
+index makes @ref image2D() / @ref image3D() import just given 1D array layer,
+2D array layer or cube map face, with faces of cube map arrays counted together
+with layers, i.e. the index being @cpp 6*layer + face @ce. Only the data of
+given slice are read from the file. The result is a single-layer image with
+@ref ImageFlag2D::Array / @ref ImageFlag3D::Array set, as a single cube map
+face isn't a cube map anymore. An index out of range or setting the option for
+an image that's neither an array nor a cube map makes the import fail.
+
 @subsection Trade-DdsImporter-behavior-multilevel Multilevel images
 
 Files with multiple mip levels are imported with the largest level first, with
@@ -239,6 +300,24 @@ Packed formats, (planar) YUV / YCbCr video formats,
 and @m_class{m-doc-external} [R10G10B10_XR_BIAS_A2_UNORM](https://docs.microsoft.com/en-us/windows/win32/api/dxgiformat/ne-dxgiformat-dxgi_format)
 are not supported.
 
+@subsection Trade-DdsImporter-behavior-async Asynchronous import
+
+The @ref image2DAsync() function schedules an import of given 2D image level
+on an executor supplied by the application and calls a callback with the
+result once done, so for example a render thread doesn't need to block on
+decoding. The executor gets a job function, a pointer to pass to it and the
+user data pointer, and is expected to call the job exactly once, either
+directly or from any other thread. The job imports the image using
+@ref image2D() and then calls the callback on the same thread, with
+@relativeref{Corrade,Containers::NullOpt} if the import failed.
+
+Asynchronous imports on a single importer instance are executed one after
+another and only one import of a particular image and level can be in flight
+at a time. While any of them are in flight, the importer shouldn't be used
+from other threads except for calling @ref image2DAsync() again. Calling
+@ref close(), opening another file or destroying the importer waits until all
+of them finish.
+
 @section Trade-DdsImporter-configuration Plugin-specific configuration
 
 It's possible to tune various import options through @ref configuration(). See
@@ -256,10 +335,30 @@ class MAGNUM_DDSIMPORTER_EXPORT DdsImporter: public AbstractImporter {
 
         ~DdsImporter();
 
+        /**
+         * @brief Import a 2D image asynchronously
+         * @param id        Image ID, from range [0, @ref image2DCount())
+         * @param level     Mip level, from range
+         *      [0, @ref image2DLevelCount())
+         * @param executor  Function running the import job
+         * @param callback  Function called with the imported image
+         * @param userData  User data passed to @p executor and @p callback
+         * @return Whether the import was scheduled
+         * @m_since_latest_{plugins}
+         *
+         * If no file is opened, @p id or @p level is out of range or the
+         * same image and level is already being imported, prints a message
+         * to @relativeref{Magnum,Error} and returns @cpp false @ce without
+         * calling @p executor. See @ref Trade-DdsImporter-behavior-async
+         * for more information.
+         */
+        virtual bool image2DAsync(UnsignedInt id, UnsignedInt level, void(*executor)(void(*)(void*), void*, void*), void(*callback)(UnsignedInt, UnsignedInt, Containers::Optional<ImageData2D>&&, void*), void* userData = nullptr);
+
     private:
         MAGNUM_DDSIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_DDSIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_DDSIMPORTER_LOCAL void doClose() override;
+        MAGNUM_DDSIMPORTER_LOCAL void doOpenFile(Containers::StringView filename) override;
         MAGNUM_DDSIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
 
         template<UnsignedInt dimensions> MAGNUM_DDSIMPORTER_LOCAL ImageData<dimensions> doImage(const char* messagePrefix, UnsignedInt id, UnsignedInt level);
@@ -283,6 +382,8 @@ class MAGNUM_DDSIMPORTER_EXPORT DdsImporter: public AbstractImporter {
 
         struct File;
         Containers::Pointer<File> _f;
+        struct AsyncState;
+        Containers::Pointer<AsyncState> _async;
 };
 
 }}
@@ -0,0 +1,140 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+    Copyright © 2015 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Magnum/Math/Vector2.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+/* Measures the copy, swizzle and flip done in DdsImporter::image2D() on a
+   large synthetic file. The files are generated in memory as there's no
+   point in bloating the repository with megabytes of zeros. */
+struct DdsImporterBenchmark: TestSuite::Tester {
+    explicit DdsImporterBenchmark();
+
+    void image();
+
+    private:
+        /* Explicitly forbid system-wide plugin dependencies */
+        PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+};
+
+constexpr Vector2i ImageSize{2048, 2048};
+
+const struct {
+    const char* name;
+    /* If non-zero, it's a compressed BC1 file and the other fields are
+       ignored */
+    bool bc1;
+    UnsignedInt bitCount;
+    UnsignedInt rMask, bMask, aMask;
+    bool assumeYUpZBackward;
+} ImageFormatData[]{
+    {"RGB8, copy", false, 24, 0x000000ff, 0x00ff0000, 0, true},
+    {"RGB8, Y flip", false, 24, 0x000000ff, 0x00ff0000, 0, false},
+    {"BGR8, swizzle", false, 24, 0x00ff0000, 0x000000ff, 0, true},
+    {"BGR8, swizzle + Y flip", false, 24, 0x00ff0000, 0x000000ff, 0, false},
+    {"RGBA8, copy", false, 32, 0x000000ff, 0x00ff0000, 0xff000000, true},
+    {"RGBA8, Y flip", false, 32, 0x000000ff, 0x00ff0000, 0xff000000, false},
+    {"BGRA8, swizzle", false, 32, 0x00ff0000, 0x000000ff, 0xff000000, true},
+    {"BGRA8, swizzle + Y flip", false, 32, 0x00ff0000, 0x000000ff, 0xff000000, false},
+    {"BC1, copy", true, 0, 0, 0, 0, true},
+    {"BC1, Y flip", true, 0, 0, 0, 0, false},
+};
+
+DdsImporterBenchmark::DdsImporterBenchmark() {
+    addInstancedBenchmarks({&DdsImporterBenchmark::image}, 10,
+        Containers::arraySize(ImageFormatData));
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef DDSIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(DDSIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void DdsImporterBenchmark::image() {
+    auto&& data = ImageFormatData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::size_t dataSize = data.bc1 ?
+        std::size_t(ImageSize.product())/2 :
+        std::size_t(ImageSize.product())*data.bitCount/8;
+
+    /* The header is 32 four-byte words, see DdsHeader in DdsImporter.cpp for
+       what each of them means. Everything not set is zero. */
+    Containers::Array<char> file{ValueInit, 128 + dataSize};
+    Containers::ArrayView<UnsignedInt> header = Containers::arrayCast<UnsignedInt>(file.prefix(128));
+    header[0] = 0x20534444; /* "DDS " */
+    header[1] = 124;
+    header[2] = 0x00001007; /* Caps|Height|Width|PixelFormat */
+    header[3] = ImageSize.y();
+    header[4] = ImageSize.x();
+    header[19] = 32;
+    if(data.bc1) {
+        header[20] = 0x00000004; /* FourCC */
+        header[21] = 0x31545844; /* "DXT1" */
+    } else {
+        header[20] = data.aMask ? 0x00000041 : 0x00000040; /* RGBA or RGB */
+        header[22] = data.bitCount;
+        header[23] = data.rMask;
+        header[24] = 0x0000ff00;
+        header[25] = data.bMask;
+        header[26] = data.aMask;
+    }
+    header[27] = 0x00001000; /* Texture */
+    Utility::Endianness::littleEndianInPlace(header);
+
+    /* Fill the data with something non-trivial */
+    for(std::size_t i = 0; i != dataSize; ++i)
+        file[128 + i] = char(i*7);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("assumeYUpZBackward", data.assumeYUpZBackward);
+    CORRADE_VERIFY(importer->openData(file));
+
+    std::size_t imported = 0;
+    CORRADE_BENCHMARK(10) {
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+        imported += image ? image->data().size() : 0;
+    }
+
+    CORRADE_COMPARE(imported, 10*dataSize);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::DdsImporterBenchmark)
@@ -31,6 +31,7 @@
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
@@ -38,6 +39,7 @@
 #include <Corrade/Utility/Path.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/BitVector.h>
 #include <Magnum/Math/Vector4.h>
 #include <Magnum/DebugTools/CompareImage.h>
 #include <Magnum/Trade/AbstractImageConverter.h>
@@ -98,6 +100,12 @@ struct DdsImporterTest: TestSuite::Tester {
     void compressedFormatFlip3D();
 
     void openMemory();
+    void zeroCopy();
+    void mapFile();
+    void deferFlip();
+    void layer();
+    void layerNotArray();
+    void layerOutOfRange();
     void openTwice();
     void importTwice();
 
@@ -537,6 +545,52 @@ const struct {
     }},
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+    bool assumeYUpZBackward;
+    bool expectZeroCopy;
+} ZeroCopyData[]{
+    {"2D, mips", "dxt10-r32i-mips.dds", true, true},
+    {"2D, compressed", "dxt5.dds", true, true},
+    {"2D array", "dxt10-rgba8unorm-array.dds", true, true},
+    {"3D", "rgba8unorm-3d.dds", true, true},
+    {"3D, compressed", "dxt1-3d.dds", true, true},
+    {"2D, flip needed", "dxt10-r32i-mips.dds", false, false},
+    {"3D, swizzle needed", "bgra8unorm-3d.dds", true, false},
+    {"cube map, mip levels not contiguous", "rgba8unorm-cube-mips.dds", true, false},
+};
+
+const struct {
+    const char* name;
+    const char* filename;
+    bool assumeYUpZBackward;
+    BitVector2 expected;
+} DeferFlipData[]{
+    {"2D", "rgb8unorm.dds", false, BitVector2{0x1}},
+    {"2D array", "dxt10-rgba8unorm-array.dds", false, BitVector2{0x1}},
+    {"3D", "rgba8unorm-3d.dds", false, BitVector2{0x3}},
+    {"3D, compressed with Y flip not implemented", "dxt10-bc7-3d.dds", false, BitVector2{0x3}},
+    {"assume Y up and Z backward", "rgba8unorm-3d.dds", true, BitVector2{0x0}},
+};
+
+const struct {
+    const char* name;
+    const char* filename;
+    UnsignedInt layer;
+    bool zeroCopy;
+    ImageFlags3D expectedFlags;
+} LayerData[]{
+    {"1D array, mips", "dxt10-rg16f-1d-array-mips.dds", 1, false, ImageFlag3D::Array},
+    {"2D array", "dxt10-rgba8unorm-array.dds", 1, false, ImageFlag3D::Array},
+    {"cube map face", "rgba8unorm-cube.dds", 3, false, ImageFlag3D::Array},
+    {"cube map face, compressed, mips", "dxt10-bc7-cube-mips.dds", 5, false, ImageFlag3D::Array},
+    {"cube map array face", "dxt10-r8snorm-cube-array.dds", 7, false, ImageFlag3D::Array},
+    /* Unlike when importing all faces, the mip levels of a single face are
+       contiguous and thus imported without a copy */
+    {"cube map face, mips, zero copy", "rgba8unorm-cube-mips.dds", 4, true, ImageFlag3D::Array},
+};
+
 DdsImporterTest::DdsImporterTest() {
     addRepeatedTests({&DdsImporterTest::enumValueMatching},
         Containers::arraySize(DxgiFormatData));
@@ -593,6 +647,20 @@ DdsImporterTest::DdsImporterTest() {
     addInstancedTests({&DdsImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
+    addInstancedTests({&DdsImporterTest::zeroCopy},
+        Containers::arraySize(ZeroCopyData));
+
+    addTests({&DdsImporterTest::mapFile});
+
+    addInstancedTests({&DdsImporterTest::deferFlip},
+        Containers::arraySize(DeferFlipData));
+
+    addInstancedTests({&DdsImporterTest::layer},
+        Containers::arraySize(LayerData));
+
+    addTests({&DdsImporterTest::layerNotArray,
+              &DdsImporterTest::layerOutOfRange});
+
     addTests({&DdsImporterTest::openTwice,
               &DdsImporterTest::importTwice});
 
@@ -1708,6 +1776,237 @@ void DdsImporterTest::openMemory() {
     }), TestSuite::Compare::Container);
 }
 
+void DdsImporterTest::zeroCopy() {
+    auto&& data = ZeroCopyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    Containers::Pointer<AbstractImporter> expectedImporter = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("assumeYUpZBackward", data.assumeYUpZBackward);
+    importer->configuration().setValue("zeroCopy", true);
+    expectedImporter->configuration().setValue("assumeYUpZBackward", data.assumeYUpZBackward);
+    /* Only the warnings about flipped compressed images would be printed, not
+       interesting here */
+    importer->addFlags(ImporterFlag::Quiet);
+    expectedImporter->addFlags(ImporterFlag::Quiet);
+
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(DDSIMPORTER_TEST_DIR, data.filename));
+    CORRADE_VERIFY(memory);
+    CORRADE_VERIFY(importer->openMemory(*memory));
+    CORRADE_VERIFY(expectedImporter->openMemory(*memory));
+
+    /* All files used here are either 2D or 3D */
+    const bool is3D = importer->image3DCount();
+    const UnsignedInt levelCount = is3D ? importer->image3DLevelCount(0) : importer->image2DLevelCount(0);
+    for(UnsignedInt i = 0; i != levelCount; ++i) {
+        CORRADE_ITERATION(i);
+
+        DataFlags dataFlags;
+        Containers::ArrayView<const char> imageData, expectedData;
+        Containers::Optional<ImageData2D> image2D, expected2D;
+        Containers::Optional<ImageData3D> image3D, expected3D;
+        if(is3D) {
+            image3D = importer->image3D(0, i);
+            expected3D = expectedImporter->image3D(0, i);
+            CORRADE_VERIFY(image3D);
+            CORRADE_VERIFY(expected3D);
+            CORRADE_COMPARE(image3D->size(), expected3D->size());
+            dataFlags = image3D->dataFlags();
+            imageData = image3D->data();
+            expectedData = expected3D->data();
+        } else {
+            image2D = importer->image2D(0, i);
+            expected2D = expectedImporter->image2D(0, i);
+            CORRADE_VERIFY(image2D);
+            CORRADE_VERIFY(expected2D);
+            CORRADE_COMPARE(image2D->size(), expected2D->size());
+            dataFlags = image2D->dataFlags();
+            imageData = image2D->data();
+            expectedData = expected2D->data();
+        }
+
+        if(data.expectZeroCopy) {
+            /* The data points directly into the passed memory */
+            CORRADE_COMPARE(dataFlags, DataFlags{});
+            CORRADE_VERIFY(imageData.data() >= memory->data());
+            CORRADE_VERIFY(imageData.data() + imageData.size() <= memory->end());
+        } else {
+            CORRADE_COMPARE(dataFlags, DataFlag::Owned|DataFlag::Mutable);
+        }
+
+        CORRADE_COMPARE_AS(imageData, expectedData, TestSuite::Compare::Container);
+    }
+}
+
+void DdsImporterTest::mapFile() {
+    #if !defined(CORRADE_TARGET_UNIX) && (!defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_SKIP("Memory mapping not available on this platform.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    Containers::Pointer<AbstractImporter> expectedImporter = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    importer->configuration().setValue("mapFile", true);
+    /* Reference the mapped memory directly to verify it stays valid */
+    importer->configuration().setValue("zeroCopy", true);
+    expectedImporter->configuration().setValue("assumeYUpZBackward", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "rgba8unorm-3d.dds")));
+    CORRADE_VERIFY(expectedImporter->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "rgba8unorm-3d.dds")));
+
+    Containers::Optional<ImageData3D> image = importer->image3D(0);
+    Containers::Optional<ImageData3D> expected = expectedImporter->image3D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(expected);
+    CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+    CORRADE_COMPARE(image->size(), expected->size());
+    CORRADE_COMPARE_AS(image->data(), expected->data(),
+        TestSuite::Compare::Container);
+
+    /* Opening a nonexistent file fails gracefully */
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->openFile("nonexistent.dds"));
+    }
+    CORRADE_VERIFY(!importer->isOpened());
+    CORRADE_COMPARE_AS(out.str(),
+        "Trade::DdsImporter::openFile(): cannot open file nonexistent.dds\n",
+        TestSuite::Compare::StringHasSuffix);
+    #endif
+}
+
+void DdsImporterTest::deferFlip() {
+    auto&& data = DeferFlipData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    Containers::Pointer<AbstractImporter> expectedImporter = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("assumeYUpZBackward", data.assumeYUpZBackward);
+    importer->configuration().setValue("deferFlip", true);
+    /* The data should be exactly as in the file */
+    expectedImporter->configuration().setValue("assumeYUpZBackward", true);
+
+    /* No warning about the flip not being implemented for BC7 */
+    std::ostringstream out;
+    {
+        Warning redirectWarning{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, data.filename)));
+    }
+    CORRADE_COMPARE(out.str(), "");
+    CORRADE_VERIFY(expectedImporter->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, data.filename)));
+
+    /* All files used here are either 2D or 3D */
+    const void* importerState;
+    Containers::Optional<Containers::Array<char>> imageData, expectedData;
+    if(importer->image3DCount()) {
+        Containers::Optional<ImageData3D> image = importer->image3D(0);
+        Containers::Optional<ImageData3D> expected = expectedImporter->image3D(0);
+        CORRADE_VERIFY(image);
+        CORRADE_VERIFY(expected);
+        importerState = image->importerState();
+        imageData = image->release();
+        expectedData = expected->release();
+    } else {
+        Containers::Optional<ImageData2D> image = importer->image2D(0);
+        Containers::Optional<ImageData2D> expected = expectedImporter->image2D(0);
+        CORRADE_VERIFY(image);
+        CORRADE_VERIFY(expected);
+        importerState = image->importerState();
+        imageData = image->release();
+        expectedData = expected->release();
+    }
+
+    CORRADE_VERIFY(importerState);
+    CORRADE_COMPARE(*static_cast<const BitVector2*>(importerState), data.expected);
+    CORRADE_COMPARE_AS(*imageData, *expectedData, TestSuite::Compare::Container);
+}
+
+void DdsImporterTest::layer() {
+    auto&& data = LayerData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    Containers::Pointer<AbstractImporter> expectedImporter = _manager.instantiate("DdsImporter");
+    /* Assume Y up orientation to get the data exactly as in the file without
+       any flipping, which would prevent the zero-copy import */
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    importer->configuration().setValue("layer", data.layer);
+    importer->configuration().setValue("zeroCopy", data.zeroCopy);
+    expectedImporter->configuration().setValue("assumeYUpZBackward", true);
+
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(DDSIMPORTER_TEST_DIR, data.filename));
+    CORRADE_VERIFY(memory);
+    CORRADE_VERIFY(importer->openMemory(*memory));
+    CORRADE_VERIFY(expectedImporter->openMemory(*memory));
+
+    /* 1D arrays are imported as 2D images, everything else as 3D */
+    const bool is3D = importer->image3DCount();
+    const UnsignedInt levelCount = is3D ? importer->image3DLevelCount(0) : importer->image2DLevelCount(0);
+    for(UnsignedInt i = 0; i != levelCount; ++i) {
+        CORRADE_ITERATION(i);
+
+        DataFlags dataFlags;
+        Containers::ArrayView<const char> imageData, expectedData;
+        Containers::Optional<ImageData2D> image2D, expected2D;
+        Containers::Optional<ImageData3D> image3D, expected3D;
+        if(is3D) {
+            image3D = importer->image3D(0, i);
+            expected3D = expectedImporter->image3D(0, i);
+            CORRADE_VERIFY(image3D);
+            CORRADE_VERIFY(expected3D);
+            CORRADE_COMPARE(image3D->flags(), data.expectedFlags);
+            CORRADE_COMPARE(image3D->size(), (Vector3i{expected3D->size().xy(), 1}));
+            dataFlags = image3D->dataFlags();
+            imageData = image3D->data();
+            expectedData = expected3D->data();
+        } else {
+            image2D = importer->image2D(0, i);
+            expected2D = expectedImporter->image2D(0, i);
+            CORRADE_VERIFY(image2D);
+            CORRADE_VERIFY(expected2D);
+            CORRADE_COMPARE(image2D->flags(), ImageFlag2D(UnsignedShort(data.expectedFlags)));
+            CORRADE_COMPARE(image2D->size(), (Vector2i{expected2D->size().x(), 1}));
+            dataFlags = image2D->dataFlags();
+            imageData = image2D->data();
+            expectedData = expected2D->data();
+        }
+
+        if(data.zeroCopy) {
+            /* The data points directly into the passed memory */
+            CORRADE_COMPARE(dataFlags, DataFlags{});
+            CORRADE_VERIFY(imageData.data() >= memory->data());
+            CORRADE_VERIFY(imageData.data() + imageData.size() <= memory->end());
+        } else {
+            CORRADE_COMPARE(dataFlags, DataFlag::Owned|DataFlag::Mutable);
+        }
+
+        /* The slices are tightly packed in the full image, so the layer is
+           just a subrange of its data */
+        CORRADE_COMPARE_AS(imageData, expectedData.sliceSize(data.layer*imageData.size(), imageData.size()), TestSuite::Compare::Container);
+    }
+}
+
+void DdsImporterTest::layerNotArray() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("layer", 0);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "rgba8unorm-3d.dds")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image3D(0));
+    CORRADE_COMPARE(out.str(), "Trade::DdsImporter::image3D(): the layer option can be used only with array and cube map images\n");
+}
+
+void DdsImporterTest::layerOutOfRange() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("layer", 12);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "dxt10-r8snorm-cube-array.dds")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image3D(0));
+    CORRADE_COMPARE(out.str(), "Trade::DdsImporter::image3D(): layer 12 out of range for 12 layers\n");
+}
+
 void DdsImporterTest::openTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
     /* Assume Y up orientation to get the data exactly as in the file without
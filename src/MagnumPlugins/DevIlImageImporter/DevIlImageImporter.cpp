@@ -33,15 +33,35 @@
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
 #include <IL/il.h>
 #include <IL/ilu.h>
 
+#ifdef CORRADE_BUILD_MULTITHREADED
+#include <mutex>
+#endif
+
 #ifdef CORRADE_TARGET_WINDOWS
 #include <Corrade/Utility/Unicode.h>
 #endif
 
 namespace Magnum { namespace Trade {
 
+#ifdef CORRADE_BUILD_MULTITHREADED
+namespace {
+
+/* DevIL has a single global image binding and error state, so all calls into
+   it are serialized across all instances. Verified in
+   DevIlImageImporterTest::multithreaded(). */
+std::mutex& devIlMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+}
+#endif
+
 void DevIlImageImporter::initialize() {
     /* You are a funny devil, DevIL. No tutorials or docs mention this function
        (except for a tiny note at http://openil.sourceforge.net/tuts/tut_step/)
@@ -58,6 +78,9 @@ ImporterFeatures DevIlImageImporter::doFeatures() const { return ImporterFeature
 bool DevIlImageImporter::doIsOpened() const { return _image; }
 
 void DevIlImageImporter::doClose() {
+    #ifdef CORRADE_BUILD_MULTITHREADED
+    std::lock_guard<std::mutex> lock{devIlMutex()};
+    #endif
     ilDeleteImages(1, &_image);
     _image = 0;
 }
@@ -66,6 +89,10 @@ void DevIlImageImporter::doClose() {
 static_assert(!IL_FALSE, "IL_FALSE doesn't have a zero value");
 
 void DevIlImageImporter::doOpenData(Containers::Array<char>&& data, DataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
+    #ifdef CORRADE_BUILD_MULTITHREADED
+    std::lock_guard<std::mutex> lock{devIlMutex()};
+    #endif
     UnsignedInt image;
     ilGenImages(1, &image);
     ilBindImage(image);
@@ -84,6 +111,10 @@ void DevIlImageImporter::doOpenData(Containers::Array<char>&& data, DataFlags) {
 }
 
 void DevIlImageImporter::doOpenFile(const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenFile", filename};
+    #ifdef CORRADE_BUILD_MULTITHREADED
+    std::lock_guard<std::mutex> lock{devIlMutex()};
+    #endif
     UnsignedInt image;
     ilGenImages(1, &image);
     ilBindImage(image);
@@ -106,6 +137,10 @@ void DevIlImageImporter::doOpenFile(const Containers::StringView filename) {
 }
 
 UnsignedInt DevIlImageImporter::doImage2DCount() const {
+    #ifdef CORRADE_BUILD_MULTITHREADED
+    std::lock_guard<std::mutex> lock{devIlMutex()};
+    #endif
+
     /* Bind the image. This was done above already, but since it's a global
        state, this avoids a mismatch in case there's more than one importer
        active at a time. */
@@ -114,6 +149,11 @@ UnsignedInt DevIlImageImporter::doImage2DCount() const {
 }
 
 Containers::Optional<ImageData2D> DevIlImageImporter::doImage2D(UnsignedInt id, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D", {}, id};
+    #ifdef CORRADE_BUILD_MULTITHREADED
+    std::lock_guard<std::mutex> lock{devIlMutex()};
+    #endif
+
     /* Bind the image. This was done above already, but since it's a global
        state, this avoids a mismatch in case there's more than one importer
        active at a time. */
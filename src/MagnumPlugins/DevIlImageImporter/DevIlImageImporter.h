@@ -181,6 +181,14 @@ to @ref PixelFormat::RGBA8Unorm. Images are imported with default
 @ref PixelStorage parameters except for alignment, which may be changed to `1`
 if the data require it.
 
+DevIL has a single global state for all loaded images and errors. If Corrade
+and Magnum is compiled with @ref CORRADE_BUILD_MULTITHREADED enabled, all
+access to it from the importer is serialized, which makes it safe to use
+multiple importer instances from multiple threads. The actual decoding isn't
+parallelized however, so for concurrent loading it's better to use one of the
+format-specific importers. Any other code in the application using DevIL
+directly is not synchronized with the importer.
+
 @subsection Trade-DevIlImageImporter-behavior-dds Compressed DDS files
 
 DDS files with BCn compression are always decompressed to RGBA on input.
@@ -25,6 +25,9 @@
 */
 
 #include <sstream>
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+#include <thread>
+#endif
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
@@ -65,6 +68,9 @@ struct DevIlImageImporterTest: TestSuite::Tester {
     void openTwice();
     void importTwice();
     void twoImporters();
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    void multithreaded();
+    #endif
 
     void utf8Filename();
 
@@ -115,6 +121,10 @@ DevIlImageImporterTest::DevIlImageImporterTest() {
 
               &DevIlImageImporterTest::utf8Filename});
 
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    addRepeatedTests({&DevIlImageImporterTest::multithreaded}, 10);
+    #endif
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef DEVILIMAGEIMPORTER_PLUGIN_FILENAME
@@ -458,6 +468,42 @@ void DevIlImageImporterTest::twoImporters() {
     CORRADE_COMPARE(imageB->pixels<Color4ub>()[0][0], 0x87ceeb_rgb);
 }
 
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+void DevIlImageImporterTest::multithreaded() {
+    #ifndef CORRADE_BUILD_MULTITHREADED
+    CORRADE_SKIP("CORRADE_BUILD_MULTITHREADED is not enabled.");
+    #endif
+
+    Containers::Pointer<AbstractImporter> a = _manager.instantiate("DevIlImageImporter");
+    Containers::Pointer<AbstractImporter> b = _manager.instantiate("DevIlImageImporter");
+
+    /* Similar to twoImporters(), but with each importer opening and importing
+       a different file in its own thread. Without serialization the image
+       binding done by one would get overwritten by the other, resulting in
+       wrong sizes or formats being imported or even crashes. */
+    int counterA = 0, counterB = 0;
+    {
+        auto fn = [](AbstractImporter& importer, const Containers::String& filename, const Vector2i& size, const PixelFormat format, int& counter) {
+            for(std::size_t i = 0; i != 100; ++i) {
+                if(!importer.openFile(filename)) continue;
+                Containers::Optional<Trade::ImageData2D> image = importer.image2D(0);
+                if(image && image->size() == size && image->format() == format)
+                    ++counter;
+            }
+        };
+
+        std::thread threadA{fn, std::ref(*a), Utility::Path::join(JPEGIMPORTER_TEST_DIR, "rgb.jpg"), Vector2i{3, 2}, PixelFormat::RGB8Unorm, std::ref(counterA)};
+        std::thread threadB{fn, std::ref(*b), Utility::Path::join(STBIMAGEIMPORTER_TEST_DIR, "dispose_bgnd.gif"), Vector2i{100, 100}, PixelFormat::RGBA8Unorm, std::ref(counterB)};
+
+        threadA.join();
+        threadB.join();
+    }
+
+    CORRADE_COMPARE(counterA, 100);
+    CORRADE_COMPARE(counterB, 100);
+}
+#endif
+
 void DevIlImageImporterTest::utf8Filename() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DevIlImageImporter");
 
@@ -26,12 +26,16 @@
 
 #include "DrFlacImporter.h"
 
+#include <cstdint>
+#include <cstring>
 #include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Assert.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/Endianness.h>
 
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Packing.h>
 
 #define DR_FLAC_IMPLEMENTATION
@@ -56,35 +60,102 @@ const BufferFormat flacFormatTable[8][3] = {
 };
 #undef _v
 
-/* Converts 32-bit PCM into lower bit levels by skipping bytes */
-Containers::Array<char> convert32PCM(const Containers::Array<char>& container, const UnsignedInt samples, const UnsignedInt size) {
-    Containers::Array<char> convertData{NoInit, samples*size};
+/* Converts 32-bit PCM into lower bit levels by taking the most significant
+   bytes. 8-bit needs to become unsigned, 24-bit needs to become float. The
+   loops are separate for each size so the compiler can vectorize them. The
+   24-bit conversion can be done in place, as the input and output sample
+   sizes are the same. */
+void convert32PCM(const Containers::ArrayView<const Int> samples, const UnsignedInt size, char* const out) {
+    if(size == 1) {
+        for(std::size_t i = 0; i != samples.size(); ++i)
+            out[i] = char((samples[i] >> 24) - 128);
+    } else if(size == 2) {
+        for(std::size_t i = 0; i != samples.size(); ++i) {
+            const Short sample = Short(samples[i] >> 16);
+            std::memcpy(out + i*2, &sample, 2);
+        }
+    } else if(size == 3) {
+        for(std::size_t i = 0; i != samples.size(); ++i) {
+            /* The bytes are deliberately converted through char to keep the
+               output consistent with previous versions */
+            const Int sample = samples[i];
+            const UnsignedInt s0 = char(sample >> 8);
+            const UnsignedInt s1 = char(sample >> 16);
+            const UnsignedInt s2 = char(sample >> 24);
 
-    UnsignedInt skip = -1, index = 0;
-    for(char item: container) {
-        ++skip;
+            const Int intData = Int((s0 << 8) | (s1 << 16) | (s2 << 24));
+            const Float floatData = Math::unpack<Float>(intData);
+            std::memcpy(out + i*4, &floatData, 4);
+        }
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
 
-        if(skip > 3) skip = 0;
-        if(skip < 4 - size) continue;
+/* Size of a single output sample, 24-bit samples are converted to floats */
+UnsignedInt outputSampleSize(const UnsignedInt size) {
+    return size == 3 ? 4 : size;
+}
 
-        convertData[index] = item;
-        ++index;
+/* Decodes at most given count of interleaved samples to given output,
+   returns the count of samples actually decoded. As the output for 24-bit
+   samples is as large as the 32-bit samples dr_flac produces, those are
+   decoded directly to the output and converted in place if it's suitably
+   aligned. Otherwise it goes in fixed-size chunks through a small
+   temporary buffer, so there's never a 32-bit copy of the whole track
+   allocated in addition to the output. */
+std::size_t decode(drflac* const handle, const UnsignedInt size, const std::size_t sampleCount, char* const out) {
+    if(size == 3 && reinterpret_cast<std::uintptr_t>(out) % alignof(Int) == 0) {
+        Int* const samples = reinterpret_cast<Int*>(out);
+        const std::size_t read = drflac_read_s32(handle, sampleCount, samples);
+        convert32PCM({samples, read}, size, out);
+        return read;
     }
 
-    return convertData;
+    Int samples[4096];
+    std::size_t sampleOffset = 0;
+    while(sampleOffset < sampleCount) {
+        const std::size_t read = drflac_read_s32(handle, Math::min(sampleCount - sampleOffset, Containers::arraySize(samples)), samples);
+        if(!read) break;
+        convert32PCM(Containers::arrayView(samples).prefix(read), size, out + sampleOffset*outputSampleSize(size));
+        sampleOffset += read;
+    }
+    return sampleOffset;
 }
 
 }
 
+struct DrFlacImporter::State {
+    explicit State(Containers::Array<char>&& data, drflac* handle): data{Utility::move(data)}, handle{handle} {}
+
+    ~State() { drflac_close(handle); }
+
+    /* The handle references the data, so it has to be kept for the whole
+       handle lifetime */
+    Containers::Array<char> data;
+    drflac* handle;
+    UnsignedLong position = 0;
+};
+
 DrFlacImporter::DrFlacImporter() = default;
 
 DrFlacImporter::DrFlacImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
 
+DrFlacImporter::~DrFlacImporter() = default;
+
 ImporterFeatures DrFlacImporter::doFeatures() const { return ImporterFeature::OpenData; }
 
-bool DrFlacImporter::doIsOpened() const { return !!_data; }
+bool DrFlacImporter::doIsOpened() const { return _data || _state; }
 
 void DrFlacImporter::doOpenData(Containers::ArrayView<const char> data) {
+    /* In the streaming mode the data is decoded from directly, so it has to
+       be copied first */
+    const bool streaming = configuration().value<bool>("streaming");
+    Containers::Array<char> dataCopy;
+    if(streaming) {
+        dataCopy = Containers::Array<char>{NoInit, data.size()};
+        Utility::copy(data, dataCopy);
+        data = dataCopy;
+    }
+
     drflac* const handle = drflac_open_memory(data.data(), data.size());
     if(!handle) {
         Error() << "Audio::DrFlacImporter::openData(): failed to open and decode FLAC data";
@@ -120,46 +191,90 @@ void DrFlacImporter::doOpenData(Containers::ArrayView<const char> data) {
     _frequency = handle->sampleRate;
     _format = flacFormatTable[numChannels-1][normalizedBytesPerSample-1];
     CORRADE_INTERNAL_ASSERT(_format != BufferFormat{});
-
-    Containers::Array<char> tempData{NoInit, std::size_t(samples*sizeof(Int))};
-    drflac_read_s32(handle, samples, reinterpret_cast<Int*>(tempData.begin()));
-
-    _data = convert32PCM(tempData, samples, normalizedBytesPerSample);
-
-    /* 8-bit needs to become unsigned */
-    if(normalizedBytesPerSample == 1) {
-        for(char& item: *_data) item = item - 128;
-
-    /* 24-bit needs to become float */
-    } else if(normalizedBytesPerSample == 3) {
-        Containers::Array<char> floatData{NoInit, std::size_t(samples*sizeof(Float))};
-
-        const Containers::ArrayView<Float> floats = Containers::arrayCast<Float>(floatData);
-        for(std::size_t i = 0; i != samples; ++i) {
-            const UnsignedInt s0 = (*_data)[i*3 + 0];
-            const UnsignedInt s1 = (*_data)[i*3 + 1];
-            const UnsignedInt s2 = (*_data)[i*3 + 2];
-
-            const Int intData = Int((s0 << 8) | (s1 << 16) | (s2 << 24));
-            floats[i] = Math::unpack<Float>(intData);
-        }
-
-        _data = Utility::move(floatData);
+    _channelCount = numChannels;
+    _sampleSize = normalizedBytesPerSample;
+    _frameCount = samples/numChannels;
+
+    /* In the streaming mode keep the handle open and decode only in read() */
+    if(streaming) {
+        drflacClose.release();
+        _state.emplace(Utility::move(dataCopy), handle);
+        return;
     }
+
+    Containers::Array<char> out{NoInit, std::size_t(samples*outputSampleSize(normalizedBytesPerSample))};
+    decode(handle, normalizedBytesPerSample, samples, out);
+    _data = Utility::move(out);
 }
 
-void DrFlacImporter::doClose() { _data = Containers::NullOpt; }
+void DrFlacImporter::doClose() {
+    _data = Containers::NullOpt;
+    _state = nullptr;
+}
 
 BufferFormat DrFlacImporter::doFormat() const { return _format; }
 
 UnsignedInt DrFlacImporter::doFrequency() const { return _frequency; }
 
 Containers::Array<char> DrFlacImporter::doData() {
+    /* In the streaming mode decode everything using a new handle on the
+       same data, to not affect the position of read() */
+    if(_state) {
+        drflac* const handle = drflac_open_memory(_state->data.data(), _state->data.size());
+        CORRADE_INTERNAL_ASSERT(handle);
+        Containers::ScopeGuard drflacClose{handle, drflac_close};
+
+        const std::size_t samples = _frameCount*_channelCount;
+        Containers::Array<char> out{NoInit, samples*outputSampleSize(_sampleSize)};
+        decode(handle, _sampleSize, samples, out);
+        return out;
+    }
+
     Containers::Array<char> copy{NoInit, _data->size()};
     Utility::copy(*_data, copy);
     return copy;
 }
 
+UnsignedLong DrFlacImporter::frameCount() const {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::DrFlacImporter::frameCount(): no file opened", {});
+    return _frameCount;
+}
+
+std::size_t DrFlacImporter::read(const Containers::ArrayView<char>& data) {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::DrFlacImporter::read(): no file opened", {});
+    CORRADE_ASSERT(_state,
+        "Audio::DrFlacImporter::read(): the file wasn't opened with streaming enabled", {});
+    const std::size_t frameSize = _channelCount*outputSampleSize(_sampleSize);
+    CORRADE_ASSERT(data.size() % frameSize == 0,
+        "Audio::DrFlacImporter::read(): expected size to be a multiple of" << frameSize << "bytes but got" << data.size(), {});
+
+    const std::size_t frames = Math::min(data.size()/frameSize, std::size_t(_frameCount - _state->position));
+    const std::size_t decodedFrames = decode(_state->handle, _sampleSize, frames*_channelCount, data)/_channelCount;
+    _state->position += decodedFrames;
+    return decodedFrames;
+}
+
+bool DrFlacImporter::seek(const UnsignedLong frame) {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::DrFlacImporter::seek(): no file opened", {});
+    CORRADE_ASSERT(_state,
+        "Audio::DrFlacImporter::seek(): the file wasn't opened with streaming enabled", {});
+    CORRADE_ASSERT(frame <= _frameCount,
+        "Audio::DrFlacImporter::seek(): frame" << frame << "out of range for" << _frameCount << "frames", {});
+
+    /* dr_flac clamps the index to the last sample, seeking to the end is
+       handled by just not decoding anything further in read() */
+    if(frame != _frameCount && !drflac_seek_to_sample(_state->handle, frame*_channelCount)) {
+        Error{} << "Audio::DrFlacImporter::seek(): can't seek to frame" << frame;
+        return false;
+    }
+
+    _state->position = frame;
+    return true;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(DrFlacAudioImporter, Magnum::Audio::DrFlacImporter,
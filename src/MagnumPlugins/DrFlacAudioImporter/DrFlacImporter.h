@@ -32,6 +32,7 @@
 
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
 #include "MagnumPlugins/DrFlacAudioImporter/configure.h"
@@ -132,6 +133,50 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::DrFlacAudioImporter)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Audio-DrFlacImporter-behavior Behavior and limitations
+
+By default the whole file is decoded on @ref openData() and @ref data()
+returns a copy of the decoded samples. The decoding is done in fixed-size
+chunks so no temporary copy of the whole track is allocated in addition to the
+output.
+
+@subsection Audio-DrFlacImporter-behavior-streaming Streaming decoding
+
+If the @cb{.ini} streaming @ce
+@ref Audio-DrFlacImporter-configuration "configuration option" is enabled,
+@ref openData() only parses the stream metadata and keeps a copy of the file
+data, without decoding anything. Samples are then decoded on demand with
+@ref read() into a caller-provided buffer, and the position can be changed
+with @ref seek(), which makes it possible to play long tracks without having
+the whole decoded track in memory:
+
+@code{.cpp}
+Containers::Pointer<Audio::AbstractImporter> importer = manager.instantiate("DrFlacAudioImporter");
+importer->configuration().setValue("streaming", true);
+importer->openFile("music.flac");
+
+auto& flacImporter = static_cast<Audio::DrFlacImporter&>(*importer);
+Containers::Array<char> chunk{NoInit, 16384};
+while(std::size_t frames = flacImporter.read(chunk)) {
+    // queue the first frames*frameSize bytes of the chunk for playback
+}
+@endcode
+
+The @ref frameCount(), @ref read() and @ref seek() APIs are virtual, so they
+can be called without linking to the plugin. @ref data() works in the
+streaming mode as well, decoding the whole file without affecting the
+@ref read() position.
+
+@section Audio-DrFlacImporter-configuration Plugin-specific configuration
+
+It's possible to tune various options through @ref configuration(). See below
+for all options and their default values:
+
+@snippet MagnumPlugins/DrFlacAudioImporter/DrFlacImporter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_DRFLACAUDIOIMPORTER_EXPORT DrFlacImporter: public AbstractImporter {
     public:
@@ -141,7 +186,49 @@ class MAGNUM_DRFLACAUDIOIMPORTER_EXPORT DrFlacImporter: public AbstractImporter
         /** @brief Plugin manager constructor */
         explicit DrFlacImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
+        ~DrFlacImporter();
+
+        /**
+         * @brief Frame count
+         * @m_since_latest_{plugins}
+         *
+         * Count of samples in each channel. Expects that a file is opened.
+         * Available regardless of whether the @cb{.ini} streaming @ce
+         * option is enabled.
+         */
+        virtual UnsignedLong frameCount() const;
+
+        /**
+         * @brief Decode next frames
+         * @return Count of frames decoded
+         * @m_since_latest_{plugins}
+         *
+         * Decodes as many frames from the current position as fit into
+         * @p data, converted to @ref format(), and advances the position by
+         * them. Returns less frames than fit at the end of the stream and
+         * @cpp 0 @ce once the end is reached. Expects that a file is opened
+         * with the @cb{.ini} streaming @ce option enabled and that size of
+         * @p data is a multiple of the frame size, which is the channel count
+         * multiplied by sample size of @ref format(). See
+         * @ref Audio-DrFlacImporter-behavior-streaming for more information.
+         */
+        virtual std::size_t read(const Containers::ArrayView<char>& data);
+
+        /**
+         * @brief Seek to given frame
+         * @m_since_latest_{plugins}
+         *
+         * Sets the position from which @ref read() decodes next. Expects that
+         * a file is opened with the @cb{.ini} streaming @ce option enabled
+         * and that @p frame is not larger than @ref frameCount(). If seeking
+         * fails, prints a message to @relativeref{Magnum,Error} and returns
+         * @cpp false @ce.
+         */
+        virtual bool seek(UnsignedLong frame);
+
     private:
+        struct State;
+
         MAGNUM_DRFLACAUDIOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_DRFLACAUDIOIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_DRFLACAUDIOIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
@@ -152,8 +239,12 @@ class MAGNUM_DRFLACAUDIOIMPORTER_EXPORT DrFlacImporter: public AbstractImporter
         MAGNUM_DRFLACAUDIOIMPORTER_LOCAL Containers::Array<char> doData() override;
 
         Containers::Optional<Containers::Array<char>> _data;
+        Containers::Pointer<State> _state;
         BufferFormat _format;
         UnsignedInt _frequency;
+        UnsignedInt _channelCount;
+        UnsignedInt _sampleSize;
+        UnsignedLong _frameCount;
 };
 
 }}
@@ -29,11 +29,16 @@
 #include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringStl.h> /** @todo remove once AbstractImporter is <string>-free */
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
+#include "MagnumPlugins/DrFlacAudioImporter/DrFlacImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Audio { namespace Test { namespace {
@@ -62,6 +67,12 @@ struct DrFlacImporterTest: TestSuite::Tester {
 
     void surround71Channel24();
 
+    void streaming();
+    void streamingSeek();
+    void streamingZeroSamples();
+    void streamingNotEnabled();
+    void streamingInvalidSize();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -86,7 +97,13 @@ DrFlacImporterTest::DrFlacImporterTest() {
               &DrFlacImporterTest::surround51Channel16,
               &DrFlacImporterTest::surround51Channel24,
 
-              &DrFlacImporterTest::surround71Channel24});
+              &DrFlacImporterTest::surround71Channel24,
+
+              &DrFlacImporterTest::streaming,
+              &DrFlacImporterTest::streamingSeek,
+              &DrFlacImporterTest::streamingZeroSamples,
+              &DrFlacImporterTest::streamingNotEnabled,
+              &DrFlacImporterTest::streamingInvalidSize});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -252,6 +269,125 @@ void DrFlacImporterTest::surround71Channel24() {
     CORRADE_COMPARE(importer->frequency(), 48000);
 }
 
+void DrFlacImporterTest::streaming() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRFLACAUDIOIMPORTER_TEST_DIR, "mono24.flac")));
+    Containers::Array<char> expected = importer->data();
+    CORRADE_COMPARE(static_cast<DrFlacImporter&>(*importer).frameCount(), 924);
+
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRFLACAUDIOIMPORTER_TEST_DIR, "mono24.flac")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::MonoFloat);
+    CORRADE_COMPARE(importer->frequency(), 48000);
+
+    DrFlacImporter& flacImporter = static_cast<DrFlacImporter&>(*importer);
+    CORRADE_COMPARE(flacImporter.frameCount(), 924);
+
+    /* Decode in chunks that don't divide the frame count evenly, the last
+       one is shorter and then it returns 0 */
+    Containers::Array<char> actual{NoInit, expected.size()};
+    Float chunk[100];
+    std::size_t offset = 0;
+    std::size_t chunkCount = 0;
+    while(const std::size_t frames = flacImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk)))) {
+        CORRADE_ITERATION(chunkCount);
+        CORRADE_COMPARE_AS(offset + frames*4, actual.size(),
+            TestSuite::Compare::LessOrEqual);
+        Utility::copy(Containers::arrayCast<char>(Containers::arrayView(chunk)).prefix(frames*4), actual.sliceSize(offset, frames*4));
+        offset += frames*4;
+        ++chunkCount;
+    }
+    CORRADE_COMPARE(chunkCount, 10);
+    CORRADE_COMPARE(offset, expected.size());
+    CORRADE_COMPARE_AS(actual, expected,
+        TestSuite::Compare::Container);
+
+    /* data() decodes the whole file again, independently of the read
+       position */
+    CORRADE_COMPARE_AS(importer->data(), expected,
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(flacImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 0);
+}
+
+void DrFlacImporterTest::streamingSeek() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRFLACAUDIOIMPORTER_TEST_DIR, "mono8.flac")));
+    Containers::Array<char> expected = importer->data();
+
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRFLACAUDIOIMPORTER_TEST_DIR, "mono8.flac")));
+    DrFlacImporter& flacImporter = static_cast<DrFlacImporter&>(*importer);
+
+    char chunk[16];
+    CORRADE_VERIFY(flacImporter.seek(1000));
+    CORRADE_COMPARE(flacImporter.read(chunk), 16);
+    CORRADE_COMPARE_AS(Containers::arrayView(chunk), expected.sliceSize(1000, 16),
+        TestSuite::Compare::Container);
+
+    /* Seeking back works as well */
+    CORRADE_VERIFY(flacImporter.seek(0));
+    CORRADE_COMPARE(flacImporter.read(chunk), 16);
+    CORRADE_COMPARE_AS(Containers::arrayView(chunk), expected.prefix(16),
+        TestSuite::Compare::Container);
+
+    /* Seeking to the end makes read() return nothing */
+    CORRADE_VERIFY(flacImporter.seek(flacImporter.frameCount()));
+    CORRADE_COMPARE(flacImporter.read(chunk), 0);
+}
+
+void DrFlacImporterTest::streamingZeroSamples() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRFLACAUDIOIMPORTER_TEST_DIR, "zeroSamples.flac")));
+    DrFlacImporter& flacImporter = static_cast<DrFlacImporter&>(*importer);
+
+    char chunk[16];
+    CORRADE_COMPARE(flacImporter.frameCount(), 0);
+    CORRADE_COMPARE(flacImporter.read(chunk), 0);
+    CORRADE_VERIFY(importer->data().isEmpty());
+}
+
+void DrFlacImporterTest::streamingNotEnabled() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+    DrFlacImporter& flacImporter = static_cast<DrFlacImporter&>(*importer);
+
+    char chunk[16];
+    std::ostringstream out;
+    Error redirectError{&out};
+    flacImporter.frameCount();
+    flacImporter.read(chunk);
+    flacImporter.seek(0);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRFLACAUDIOIMPORTER_TEST_DIR, "mono8.flac")));
+    flacImporter.read(chunk);
+    flacImporter.seek(0);
+    CORRADE_COMPARE(out.str(),
+        "Audio::DrFlacImporter::frameCount(): no file opened\n"
+        "Audio::DrFlacImporter::read(): no file opened\n"
+        "Audio::DrFlacImporter::seek(): no file opened\n"
+        "Audio::DrFlacImporter::read(): the file wasn't opened with streaming enabled\n"
+        "Audio::DrFlacImporter::seek(): the file wasn't opened with streaming enabled\n");
+}
+
+void DrFlacImporterTest::streamingInvalidSize() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRFLACAUDIOIMPORTER_TEST_DIR, "stereo16.flac")));
+    DrFlacImporter& flacImporter = static_cast<DrFlacImporter&>(*importer);
+
+    char chunk[6];
+    std::ostringstream out;
+    Error redirectError{&out};
+    flacImporter.read(chunk);
+    flacImporter.seek(2);
+    CORRADE_COMPARE(out.str(),
+        "Audio::DrFlacImporter::read(): expected size to be a multiple of 4 bytes but got 6\n"
+        "Audio::DrFlacImporter::seek(): frame 2 out of range for 1 frames\n");
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Audio::Test::DrFlacImporterTest)
@@ -26,8 +26,11 @@
 
 #include "DrMp3Importer.h"
 
+#include <cstdint>
+#include <Corrade/Containers/ScopeGuard.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/Endianness.h>
 
@@ -56,15 +59,74 @@ constexpr BufferFormat Mp3FormatTable[8]{
 
 }
 
+struct DrMp3Importer::State {
+    explicit State(Containers::Array<char>&& data): data{Utility::move(data)} {}
+
+    ~State() { if(initialized) drmp3_uninit(&mp3); }
+
+    /* The decoder references the data and the seek table, so they have to
+       be kept for the whole decoder lifetime */
+    Containers::Array<char> data;
+    Containers::Array<drmp3_seek_point> seekPoints;
+    drmp3 mp3;
+    bool initialized = false;
+    UnsignedLong frameCount;
+};
+
 DrMp3Importer::DrMp3Importer() = default;
 
 DrMp3Importer::DrMp3Importer(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
 
+DrMp3Importer::~DrMp3Importer() = default;
+
 ImporterFeatures DrMp3Importer::doFeatures() const { return ImporterFeature::OpenData; }
 
-bool DrMp3Importer::doIsOpened() const { return !!_data; }
+bool DrMp3Importer::doIsOpened() const { return _data || _state; }
 
 void DrMp3Importer::doOpenData(Containers::ArrayView<const char> data) {
+    /* In the streaming mode the data is decoded from directly, so it has to
+       be copied first. The whole file isn't decoded, only the frame count
+       and the seek table is calculated. */
+    if(configuration().value<bool>("streaming")) {
+        Containers::Array<char> dataCopy{NoInit, data.size()};
+        Utility::copy(data, dataCopy);
+        Containers::Pointer<State> state{InPlaceInit, Utility::move(dataCopy)};
+
+        drmp3_config config;
+        config.outputChannels = config.outputSampleRate = 0;
+        if(!drmp3_init_memory(&state->mp3, state->data.data(), state->data.size(), &config)) {
+            Error() << "Audio::DrMp3Importer::openData(): failed to open and decode MP3 data";
+            return;
+        }
+        state->initialized = true;
+
+        const std::uint32_t numChannels = state->mp3.channels;
+        if(numChannels == 0 || numChannels == 3 || numChannels == 5 || numChannels > 8) {
+            Error() << "Audio::DrMp3Importer::openData(): unsupported channel count"
+                    << numChannels;
+            return;
+        }
+
+        /* Both of these scan through the whole file, but only once, and
+           reset the position back to the start */
+        state->frameCount = drmp3_get_pcm_frame_count(&state->mp3);
+        if(drmp3_uint32 seekPointCount = configuration().value<UnsignedInt>("seekPoints")) {
+            state->seekPoints = Containers::Array<drmp3_seek_point>{NoInit, seekPointCount};
+            if(!drmp3_calculate_seek_points(&state->mp3, &seekPointCount, state->seekPoints) ||
+               !drmp3_bind_seek_table(&state->mp3, seekPointCount, state->seekPoints)) {
+                Error() << "Audio::DrMp3Importer::openData(): failed to calculate a seek table";
+                return;
+            }
+        }
+
+        _frequency = state->mp3.sampleRate;
+        _format = Mp3FormatTable[numChannels - 1];
+        CORRADE_INTERNAL_ASSERT(_format != BufferFormat{});
+        _channelCount = numChannels;
+        _state = Utility::move(state);
+        return;
+    }
+
     drmp3_config config;
     config.outputChannels = config.outputSampleRate = 0;
     drmp3_uint64 frameCount;
@@ -89,23 +151,78 @@ void DrMp3Importer::doOpenData(Containers::ArrayView<const char> data) {
     _frequency = config.outputSampleRate;
     _format = Mp3FormatTable[numChannels - 1];
     CORRADE_INTERNAL_ASSERT(_format != BufferFormat{});
+    _channelCount = numChannels;
 
     /* All good, save the data */
     _data = Utility::move(decodedData);
 }
 
-void DrMp3Importer::doClose() { _data = Containers::NullOpt; }
+void DrMp3Importer::doClose() {
+    _data = Containers::NullOpt;
+    _state = nullptr;
+}
 
 BufferFormat DrMp3Importer::doFormat() const { return _format; }
 
 UnsignedInt DrMp3Importer::doFrequency() const { return _frequency; }
 
 Containers::Array<char> DrMp3Importer::doData() {
+    /* In the streaming mode decode everything using a new decoder on the
+       same data, to not affect the position of read() */
+    if(_state) {
+        drmp3 mp3;
+        drmp3_config config;
+        config.outputChannels = config.outputSampleRate = 0;
+        CORRADE_INTERNAL_ASSERT_OUTPUT(drmp3_init_memory(&mp3, _state->data.data(), _state->data.size(), &config));
+        Containers::ScopeGuard mp3Uninit{&mp3, drmp3_uninit};
+
+        Containers::Array<char> out{NoInit, std::size_t(_state->frameCount*_channelCount*sizeof(Short))};
+        const std::size_t frames = drmp3_read_pcm_frames_s16(&mp3, _state->frameCount, reinterpret_cast<drmp3_int16*>(out.data()));
+        CORRADE_INTERNAL_ASSERT(frames == _state->frameCount);
+        return out;
+    }
+
     Containers::Array<char> copy{NoInit, _data->size()};
     Utility::copy(*_data, copy);
     return copy;
 }
 
+UnsignedLong DrMp3Importer::frameCount() const {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::DrMp3Importer::frameCount(): no file opened", {});
+    return _state ? _state->frameCount : _data->size()/(_channelCount*sizeof(Short));
+}
+
+std::size_t DrMp3Importer::read(const Containers::ArrayView<char>& data) {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::DrMp3Importer::read(): no file opened", {});
+    CORRADE_ASSERT(_state,
+        "Audio::DrMp3Importer::read(): the file wasn't opened with streaming enabled", {});
+    const std::size_t frameSize = _channelCount*sizeof(Short);
+    CORRADE_ASSERT(data.size() % frameSize == 0,
+        "Audio::DrMp3Importer::read(): expected size to be a multiple of" << frameSize << "bytes but got" << data.size(), {});
+    CORRADE_ASSERT(reinterpret_cast<std::uintptr_t>(data.data()) % alignof(Short) == 0,
+        "Audio::DrMp3Importer::read(): expected the data to be aligned to" << alignof(Short) << "bytes", {});
+
+    return drmp3_read_pcm_frames_s16(&_state->mp3, data.size()/frameSize, reinterpret_cast<drmp3_int16*>(data.data()));
+}
+
+bool DrMp3Importer::seek(const UnsignedLong frame) {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::DrMp3Importer::seek(): no file opened", {});
+    CORRADE_ASSERT(_state,
+        "Audio::DrMp3Importer::seek(): the file wasn't opened with streaming enabled", {});
+    CORRADE_ASSERT(frame <= _state->frameCount,
+        "Audio::DrMp3Importer::seek(): frame" << frame << "out of range for" << _state->frameCount << "frames", {});
+
+    if(!drmp3_seek_to_pcm_frame(&_state->mp3, frame)) {
+        Error{} << "Audio::DrMp3Importer::seek(): can't seek to frame" << frame;
+        return false;
+    }
+
+    return true;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(DrMp3AudioImporter, Magnum::Audio::DrMp3Importer,
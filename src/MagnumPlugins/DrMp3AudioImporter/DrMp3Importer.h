@@ -33,6 +33,7 @@
 
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
 #include "MagnumPlugins/DrMp3AudioImporter/configure.h"
@@ -123,6 +124,37 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::DrMp3AudioImporter)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Audio-DrMp3Importer-behavior Behavior and limitations
+
+By default the whole file is decoded on @ref openData() and @ref data()
+returns a copy of the decoded samples.
+
+@subsection Audio-DrMp3Importer-behavior-streaming Streaming decoding
+
+If the @cb{.ini} streaming @ce
+@ref Audio-DrMp3Importer-configuration "configuration option" is enabled,
+@ref openData() keeps a copy of the file data and only scans it once to
+calculate the frame count and a seek table with at most
+@cb{.ini} seekPoints @ce entries, without decoding anything. Samples are
+then decoded on demand with @ref read() into a caller-provided buffer, and
+@ref seek() uses the seek table to jump to an arbitrary position without
+decoding everything before it. Same as with
+@ref Audio-DrFlacImporter-behavior-streaming "DrFlacAudioImporter", the
+@ref frameCount(), @ref read() and @ref seek() APIs are virtual, so they
+can be called without linking to the plugin. @ref data() works in the
+streaming mode as well, decoding the whole file without affecting the
+@ref read() position.
+
+@section Audio-DrMp3Importer-configuration Plugin-specific configuration
+
+It's possible to tune various options through @ref configuration(). See below
+for all options and their default values:
+
+@snippet MagnumPlugins/DrMp3AudioImporter/DrMp3Importer.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_DRMP3AUDIOIMPORTER_EXPORT DrMp3Importer: public AbstractImporter {
     public:
@@ -132,7 +164,50 @@ class MAGNUM_DRMP3AUDIOIMPORTER_EXPORT DrMp3Importer: public AbstractImporter {
         /** @brief Plugin manager constructor */
         explicit DrMp3Importer(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
+        ~DrMp3Importer();
+
+        /**
+         * @brief Frame count
+         * @m_since_latest_{plugins}
+         *
+         * Count of samples in each channel. Expects that a file is opened.
+         * Available regardless of whether the @cb{.ini} streaming @ce
+         * option is enabled.
+         */
+        virtual UnsignedLong frameCount() const;
+
+        /**
+         * @brief Decode next frames
+         * @return Count of frames decoded
+         * @m_since_latest_{plugins}
+         *
+         * Decodes as many frames from the current position as fit into
+         * @p data and advances the position by them. Returns less frames
+         * than fit at the end of the stream and @cpp 0 @ce once the end is
+         * reached. Expects that a file is opened with the
+         * @cb{.ini} streaming @ce option enabled and that @p data is aligned
+         * for @relativeref{Magnum,Short} and its size is a multiple of the
+         * frame size, which is the channel count multiplied by
+         * @cpp 2 @ce. See @ref Audio-DrMp3Importer-behavior-streaming for
+         * more information.
+         */
+        virtual std::size_t read(const Containers::ArrayView<char>& data);
+
+        /**
+         * @brief Seek to given frame
+         * @m_since_latest_{plugins}
+         *
+         * Sets the position from which @ref read() decodes next, using the
+         * seek table calculated on opening. Expects that a file is opened
+         * with the @cb{.ini} streaming @ce option enabled and that @p frame
+         * is not larger than @ref frameCount(). If seeking fails, prints a
+         * message to @relativeref{Magnum,Error} and returns @cpp false @ce.
+         */
+        virtual bool seek(UnsignedLong frame);
+
     private:
+        struct State;
+
         MAGNUM_DRMP3AUDIOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_DRMP3AUDIOIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_DRMP3AUDIOIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
@@ -143,8 +218,10 @@ class MAGNUM_DRMP3AUDIOIMPORTER_EXPORT DrMp3Importer: public AbstractImporter {
         MAGNUM_DRMP3AUDIOIMPORTER_LOCAL Containers::Array<char> doData() override;
 
         Containers::Optional<Containers::Array<char>> _data;
+        Containers::Pointer<State> _state;
         BufferFormat _format;
         UnsignedInt _frequency;
+        UnsignedInt _channelCount;
 };
 
 }}
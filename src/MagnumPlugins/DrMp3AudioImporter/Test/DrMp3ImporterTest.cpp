@@ -31,10 +31,14 @@
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
+#include "MagnumPlugins/DrMp3AudioImporter/DrMp3Importer.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Audio { namespace Test { namespace {
@@ -49,17 +53,39 @@ struct DrMp3ImporterTest: TestSuite::Tester {
     void mono16();
     void stereo16();
 
+    void streaming();
+    void streamingSeek();
+    void streamingNotEnabled();
+    void streamingInvalidSize();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
 
+const struct {
+    const char* name;
+    UnsignedInt seekPoints;
+} StreamingSeekData[]{
+    {"", 256},
+    {"no seek table", 0},
+    {"seek table smaller than frame count", 3}
+};
+
 DrMp3ImporterTest::DrMp3ImporterTest() {
     addTests({&DrMp3ImporterTest::empty,
 
               &DrMp3ImporterTest::zeroSamples,
 
               &DrMp3ImporterTest::mono16,
-              &DrMp3ImporterTest::stereo16});
+              &DrMp3ImporterTest::stereo16,
+
+              &DrMp3ImporterTest::streaming});
+
+    addInstancedTests({&DrMp3ImporterTest::streamingSeek},
+        Containers::arraySize(StreamingSeekData));
+
+    addTests({&DrMp3ImporterTest::streamingNotEnabled,
+              &DrMp3ImporterTest::streamingInvalidSize});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -119,6 +145,119 @@ void DrMp3ImporterTest::stereo16() {
         }), TestSuite::Compare::Container);
 }
 
+void DrMp3ImporterTest::streaming() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRMP3AUDIOIMPORTER_TEST_DIR, "stereo16.mp3")));
+    Containers::Array<char> expected = importer->data();
+    CORRADE_COMPARE(static_cast<DrMp3Importer&>(*importer).frameCount(), 6912);
+
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRMP3AUDIOIMPORTER_TEST_DIR, "stereo16.mp3")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Stereo16);
+    CORRADE_COMPARE(importer->frequency(), 44100);
+
+    DrMp3Importer& mp3Importer = static_cast<DrMp3Importer&>(*importer);
+    CORRADE_COMPARE(mp3Importer.frameCount(), 6912);
+
+    /* Decode in chunks that don't divide the frame count evenly, the last
+       one is shorter and then it returns 0 */
+    Containers::Array<char> actual{NoInit, expected.size()};
+    Short chunk[1000*2];
+    std::size_t offset = 0;
+    std::size_t chunkCount = 0;
+    while(const std::size_t frames = mp3Importer.read(Containers::arrayCast<char>(Containers::arrayView(chunk)))) {
+        CORRADE_ITERATION(chunkCount);
+        CORRADE_COMPARE_AS(offset + frames*4, actual.size(),
+            TestSuite::Compare::LessOrEqual);
+        Utility::copy(Containers::arrayCast<char>(Containers::arrayView(chunk)).prefix(frames*4), actual.sliceSize(offset, frames*4));
+        offset += frames*4;
+        ++chunkCount;
+    }
+    CORRADE_COMPARE(chunkCount, 7);
+    CORRADE_COMPARE(offset, expected.size());
+    CORRADE_COMPARE_AS(actual, expected,
+        TestSuite::Compare::Container);
+
+    /* data() decodes the whole file again, independently of the read
+       position */
+    CORRADE_COMPARE_AS(importer->data(), expected,
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(mp3Importer.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 0);
+}
+
+void DrMp3ImporterTest::streamingSeek() {
+    auto&& data = StreamingSeekData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRMP3AUDIOIMPORTER_TEST_DIR, "mono16.mp3")));
+    Containers::Array<char> expected = importer->data();
+
+    importer->configuration().setValue("streaming", true);
+    importer->configuration().setValue("seekPoints", data.seekPoints);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRMP3AUDIOIMPORTER_TEST_DIR, "mono16.mp3")));
+    DrMp3Importer& mp3Importer = static_cast<DrMp3Importer&>(*importer);
+
+    Short chunk[16];
+    CORRADE_VERIFY(mp3Importer.seek(5000));
+    CORRADE_COMPARE(mp3Importer.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 16);
+    CORRADE_COMPARE_AS(Containers::arrayCast<const char>(Containers::arrayView(chunk)), expected.sliceSize(5000*2, 16*2),
+        TestSuite::Compare::Container);
+
+    /* Seeking back works as well */
+    CORRADE_VERIFY(mp3Importer.seek(1000));
+    CORRADE_COMPARE(mp3Importer.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 16);
+    CORRADE_COMPARE_AS(Containers::arrayCast<const char>(Containers::arrayView(chunk)), expected.sliceSize(1000*2, 16*2),
+        TestSuite::Compare::Container);
+
+    /* Seeking to the end makes read() return nothing */
+    CORRADE_VERIFY(mp3Importer.seek(mp3Importer.frameCount()));
+    CORRADE_COMPARE(mp3Importer.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 0);
+}
+
+void DrMp3ImporterTest::streamingNotEnabled() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    DrMp3Importer& mp3Importer = static_cast<DrMp3Importer&>(*importer);
+
+    Short chunk[16];
+    std::ostringstream out;
+    Error redirectError{&out};
+    mp3Importer.frameCount();
+    mp3Importer.read(Containers::arrayCast<char>(Containers::arrayView(chunk)));
+    mp3Importer.seek(0);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRMP3AUDIOIMPORTER_TEST_DIR, "mono16.mp3")));
+    mp3Importer.read(Containers::arrayCast<char>(Containers::arrayView(chunk)));
+    mp3Importer.seek(0);
+    CORRADE_COMPARE(out.str(),
+        "Audio::DrMp3Importer::frameCount(): no file opened\n"
+        "Audio::DrMp3Importer::read(): no file opened\n"
+        "Audio::DrMp3Importer::seek(): no file opened\n"
+        "Audio::DrMp3Importer::read(): the file wasn't opened with streaming enabled\n"
+        "Audio::DrMp3Importer::seek(): the file wasn't opened with streaming enabled\n");
+}
+
+void DrMp3ImporterTest::streamingInvalidSize() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRMP3AUDIOIMPORTER_TEST_DIR, "stereo16.mp3")));
+    DrMp3Importer& mp3Importer = static_cast<DrMp3Importer&>(*importer);
+
+    Short chunk[4];
+    std::ostringstream out;
+    Error redirectError{&out};
+    mp3Importer.read(Containers::arrayCast<char>(Containers::arrayView(chunk)).prefix(6));
+    mp3Importer.read(Containers::arrayCast<char>(Containers::arrayView(chunk)).sliceSize(1, 4));
+    mp3Importer.seek(6913);
+    CORRADE_COMPARE(out.str(),
+        "Audio::DrMp3Importer::read(): expected size to be a multiple of 4 bytes but got 6\n"
+        "Audio::DrMp3Importer::read(): expected the data to be aligned to 2 bytes\n"
+        "Audio::DrMp3Importer::seek(): frame 6913 out of range for 6912 frames\n");
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Audio::Test::DrMp3ImporterTest)
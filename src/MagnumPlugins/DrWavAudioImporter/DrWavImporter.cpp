@@ -26,11 +26,14 @@
 
 #include "DrWavImporter.h"
 
+#include <cstdint>
+#include <cstring>
 #include <Corrade/Containers/ScopeGuard.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Assert.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/Endianness.h>
+#include <Magnum/Math/Functions.h>
 
 #define DR_WAV_IMPLEMENTATION
 #include "dr_wav.h"
@@ -105,12 +108,20 @@ Containers::Array<char> read32fPcm(drwav* const handle, const UnsignedInt sample
     return tempData;
 }
 
-/* Reads raw data; be sure size is exact! */
-Containers::Array<char> readRaw(drwav* const handle, const UnsignedInt samples, const UnsignedInt size) {
-    Containers::Array<char> tempData(samples*size);
-    drwav_read_raw(handle, samples*size, reinterpret_cast<void*>(tempData.begin()));
+/* Copies raw data directly from the input, without going through the dr_wav
+   stream callbacks and without zero-initializing the output first; be sure
+   size is exact! If the data chunk is truncated, the rest is zero-filled,
+   same as with drwav_read_raw() into a zero-initialized array. */
+Containers::Array<char> readRaw(const drwav* const handle, const Containers::ArrayView<const char> data, const UnsignedInt samples, const UnsignedInt size) {
+    const std::size_t byteCount = std::size_t(samples)*size;
+    Containers::Array<char> out{NoInit, byteCount};
 
-    return tempData;
+    const std::size_t offset = Math::min(std::size_t(handle->dataChunkDataPos), data.size());
+    const std::size_t available = Math::min(Math::min(byteCount, std::size_t(handle->dataChunkDataSize)), data.size() - offset);
+    Utility::copy(data.sliceSize(offset, available), out.prefix(available));
+    std::memset(out.data() + available, 0, byteCount - available);
+
+    return out;
 }
 
 }
@@ -151,6 +162,11 @@ void DrWavImporter::doOpenData(const Containers::ArrayView<const char> data) {
     }
 
     _frequency = frequency;
+    _channelCount = numChannels;
+    _frameCount = samples/numChannels;
+    _position = 0;
+    /* Overriden below for formats decoded to floats */
+    _bytesPerSample = normalizedBytesPerSample;
 
     /* PCM has a lot of special cases, as we can read many formats directly */
     if(handle->translatedFormatTag == DR_WAVE_FORMAT_PCM) {
@@ -159,12 +175,13 @@ void DrWavImporter::doOpenData(const Containers::ArrayView<const char> data) {
 
         /* If the data is exactly 8 or 16 bits, we can read it raw */
         if(!notExactBitsPerSample && normalizedBytesPerSample < 3) {
-            _data = readRaw(handle, samples, normalizedBytesPerSample);
+            _data = readRaw(handle, data, samples, normalizedBytesPerSample);
             return;
 
         /* If the data is approximately 24 bits or has many channels, a float is more than enough */
         } else if(normalizedBytesPerSample == 3 || (normalizedBytesPerSample > 3 && numChannels > 3)) {
             _data = read32fPcm(handle, samples, numChannels, _format);
+            _bytesPerSample = sizeof(Float);
             return;
 
         /* If the data is close to 8 or 16 bits, we can convert it from 32-bit PCM */
@@ -187,7 +204,7 @@ void DrWavImporter::doOpenData(const Containers::ArrayView<const char> data) {
     } else if(handle->translatedFormatTag == DR_WAVE_FORMAT_ALAW) {
         if(numChannels < 3 && !notExactBitsPerSample && (bitsPerSample == 8 || bitsPerSample == 16) ) {
             _format = ALawFormatTable[numChannels-1][normalizedBytesPerSample-1];
-            _data = readRaw(handle, samples, normalizedBytesPerSample);
+            _data = readRaw(handle, data, samples, normalizedBytesPerSample);
             return;
         }
 
@@ -195,7 +212,7 @@ void DrWavImporter::doOpenData(const Containers::ArrayView<const char> data) {
     } else if(handle->translatedFormatTag == DR_WAVE_FORMAT_MULAW) {
         if(numChannels < 3 && !notExactBitsPerSample && (bitsPerSample == 8 || bitsPerSample == 16) ) {
             _format = MuLawFormatTable[numChannels-1][normalizedBytesPerSample-1];
-            _data = readRaw(handle, samples, normalizedBytesPerSample);
+            _data = readRaw(handle, data, samples, normalizedBytesPerSample);
             return;
         }
 
@@ -203,13 +220,14 @@ void DrWavImporter::doOpenData(const Containers::ArrayView<const char> data) {
     } else if(handle->translatedFormatTag == DR_WAVE_FORMAT_IEEE_FLOAT) {
         if(!notExactBitsPerSample && (bitsPerSample == 32 || bitsPerSample == 64)) {
             _format = IeeeFormatTable[numChannels-1][(normalizedBytesPerSample / 4)-1];
-            _data = readRaw(handle, samples, normalizedBytesPerSample);
+            _data = readRaw(handle, data, samples, normalizedBytesPerSample);
             return;
         }
     }
 
     /* If we don't know what the format is, read it out as 32 bit float for compatibility */
     _data = read32fPcm(handle, samples, numChannels, _format);
+    _bytesPerSample = sizeof(Float);
 }
 
 void DrWavImporter::doClose() { _data = Containers::NullOpt; }
@@ -224,6 +242,42 @@ Containers::Array<char> DrWavImporter::doData() {
     return copy;
 }
 
+Containers::ArrayView<const char> DrWavImporter::dataView() const {
+    CORRADE_ASSERT(_data,
+        "Audio::DrWavImporter::dataView(): no file opened", {});
+    return *_data;
+}
+
+UnsignedLong DrWavImporter::frameCount() const {
+    CORRADE_ASSERT(_data,
+        "Audio::DrWavImporter::frameCount(): no file opened", {});
+    return _frameCount;
+}
+
+std::size_t DrWavImporter::read(const Containers::ArrayView<char>& data) {
+    CORRADE_ASSERT(_data,
+        "Audio::DrWavImporter::read(): no file opened", {});
+    const std::size_t frameSize = _channelCount*_bytesPerSample;
+    CORRADE_ASSERT(data.size() % frameSize == 0,
+        "Audio::DrWavImporter::read(): expected size to be a multiple of" << frameSize << "bytes but got" << data.size(), {});
+
+    /* The data is already imported, so this is just a copy */
+    const std::size_t frames = Math::min(std::size_t(_frameCount - _position), data.size()/frameSize);
+    Utility::copy(_data->sliceSize(_position*frameSize, frames*frameSize), data.prefix(frames*frameSize));
+    _position += frames;
+    return frames;
+}
+
+bool DrWavImporter::seek(const UnsignedLong frame) {
+    CORRADE_ASSERT(_data,
+        "Audio::DrWavImporter::seek(): no file opened", {});
+    CORRADE_ASSERT(frame <= _frameCount,
+        "Audio::DrWavImporter::seek(): frame" << frame << "out of range for" << _frameCount << "frames", {});
+
+    _position = frame;
+    return true;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(DrWavAudioImporter, Magnum::Audio::DrWavImporter,
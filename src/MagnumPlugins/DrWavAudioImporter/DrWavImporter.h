@@ -133,6 +133,30 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::DrWavAudioImporter)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Audio-DrWavImporter-behavior Behavior and limitations
+
+The whole file is imported on @ref openData(). Files that don't need any
+conversion, which are 8- and 16-bit PCM, A-Law, μ-Law and 32- and 64-bit
+IEEE Float, have the sample data copied directly from the input in a single
+operation, other formats are decoded. The @ref data() function returns a new
+copy of the imported data on every call, as mandated by the
+@ref AbstractImporter interface. To access the data without copying it
+again, for example when loading a lot of short sounds, use @ref dataView()
+instead.
+
+@subsection Audio-DrWavImporter-behavior-streaming Streaming access
+
+For consistency with the streaming decoding in
+@ref Audio-DrFlacImporter-behavior-streaming "DrFlacAudioImporter",
+@ref Audio-DrMp3Importer-behavior-streaming "DrMp3AudioImporter",
+@ref Audio-StbVorbisImporter-behavior-streaming "StbVorbisAudioImporter" and
+@ref Audio-Faad2Importer-behavior-streaming "Faad2AudioImporter", the plugin
+provides the same @ref frameCount(), @ref read() and @ref seek() APIs, which
+allow code reading audio in chunks to treat all of them the same way. As the
+data is already imported in full, these are always available, there's no
+option to enable them, and @ref read() only copies the next chunk of the
+imported data to the caller-provided buffer.
 */
 class MAGNUM_DRWAVAUDIOIMPORTER_EXPORT DrWavImporter: public AbstractImporter {
     public:
@@ -142,6 +166,54 @@ class MAGNUM_DRWAVAUDIOIMPORTER_EXPORT DrWavImporter: public AbstractImporter {
         /** @brief Plugin manager constructor */
         explicit DrWavImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
+        /**
+         * @brief Imported data view
+         * @m_since_latest_{plugins}
+         *
+         * Compared to @ref data(), which returns a new copy on every call,
+         * this returns a view on the data stored in the importer, valid
+         * until the file is closed. Expects that a file is opened. The
+         * function is virtual, so it can be called without linking to the
+         * plugin. See @ref Audio-DrWavImporter-behavior for more
+         * information.
+         */
+        virtual Containers::ArrayView<const char> dataView() const;
+
+        /**
+         * @brief Frame count
+         * @m_since_latest_{plugins}
+         *
+         * Count of samples in each channel. Expects that a file is opened.
+         */
+        virtual UnsignedLong frameCount() const;
+
+        /**
+         * @brief Read next frames
+         * @return Count of frames read
+         * @m_since_latest_{plugins}
+         *
+         * Copies as many frames of the imported data from the current
+         * position as fit into @p data and advances the position by them.
+         * Returns less frames than fit at the end of the data and
+         * @cpp 0 @ce once the end is reached. Expects that a file is opened
+         * and that size of @p data is a multiple of the frame size, which is
+         * the channel count multiplied by the size of a sample in
+         * @ref format(). See @ref Audio-DrWavImporter-behavior-streaming for
+         * more information.
+         */
+        virtual std::size_t read(const Containers::ArrayView<char>& data);
+
+        /**
+         * @brief Seek to given frame
+         * @m_since_latest_{plugins}
+         *
+         * Sets the position from which @ref read() copies next. Expects that
+         * a file is opened and that @p frame is not larger than
+         * @ref frameCount(). Always returns @cpp true @ce, the return value
+         * is there for consistency with other plugins.
+         */
+        virtual bool seek(UnsignedLong frame);
+
     private:
         MAGNUM_DRWAVAUDIOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_DRWAVAUDIOIMPORTER_LOCAL bool doIsOpened() const override;
@@ -155,6 +227,10 @@ class MAGNUM_DRWAVAUDIOIMPORTER_EXPORT DrWavImporter: public AbstractImporter {
         Containers::Optional<Containers::Array<char>> _data;
         BufferFormat _format;
         UnsignedInt _frequency;
+        UnsignedInt _channelCount;
+        UnsignedInt _bytesPerSample;
+        UnsignedLong _frameCount;
+        UnsignedLong _position;
 };
 
 }}
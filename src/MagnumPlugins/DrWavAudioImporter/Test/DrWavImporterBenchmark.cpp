@@ -0,0 +1,182 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+    Copyright © 2016 Alice Margatroid <loveoverwhelming@gmail.com>
+    Copyright © 2019 Guillaume Jacquemin <williamjcm@users.noreply.github.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/Audio/AbstractImporter.h>
+
+#include "MagnumPlugins/DrWavAudioImporter/DrWavImporter.h"
+
+#include "configure.h"
+
+#ifdef MAGNUM_WITH_DRFLACAUDIOIMPORTER
+#include "MagnumPlugins/DrFlacAudioImporter/DrFlacImporter.h"
+#endif
+#ifdef MAGNUM_WITH_DRMP3AUDIOIMPORTER
+#include "MagnumPlugins/DrMp3AudioImporter/DrMp3Importer.h"
+#endif
+#ifdef MAGNUM_WITH_FAAD2AUDIOIMPORTER
+#include "MagnumPlugins/Faad2AudioImporter/Faad2Importer.h"
+#endif
+#ifdef MAGNUM_WITH_STBVORBISAUDIOIMPORTER
+#include "MagnumPlugins/StbVorbisAudioImporter/StbVorbisImporter.h"
+#endif
+
+namespace Magnum { namespace Audio { namespace Test { namespace {
+
+/* Compares decoding cost of all audio importers that implement the
+   frameCount() / read() / seek() streaming APIs, with uncompressed WAV as the
+   baseline. The whole file is decoded either at once with data() or in
+   fixed-size chunks with read(), where the decoded data held by the caller
+   is just the chunk size instead of the whole file. Plugins other than
+   DrWavAudioImporter are optional, the cases get skipped if they're not
+   built. */
+struct DrWavImporterBenchmark: TestSuite::Tester {
+    explicit DrWavImporterBenchmark();
+
+    void data();
+    void streaming();
+
+    private:
+        /* Explicitly forbid system-wide plugin dependencies */
+        PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+};
+
+/* The plugin classes have no common base for the streaming APIs, but they
+   all have the same signatures */
+template<class T> UnsignedLong frameCount(AbstractImporter& importer) {
+    return static_cast<T&>(importer).frameCount();
+}
+
+template<class T> std::size_t read(AbstractImporter& importer, const Containers::ArrayView<char>& data) {
+    return static_cast<T&>(importer).read(data);
+}
+
+const struct {
+    const char* name;
+    const char* plugin;
+    const char* filename;
+    UnsignedLong(*frameCount)(AbstractImporter&);
+    std::size_t(*read)(AbstractImporter&, const Containers::ArrayView<char>&);
+} FileData[]{
+    {"WAV, DrWavAudioImporter", "DrWavAudioImporter", DRWAVAUDIOIMPORTER_TEST_DIR "/surround51Channel16.wav",
+        frameCount<DrWavImporter>, read<DrWavImporter>},
+    #ifdef MAGNUM_WITH_DRFLACAUDIOIMPORTER
+    {"FLAC, DrFlacAudioImporter", "DrFlacAudioImporter", DRFLACAUDIOIMPORTER_TEST_DIR "/surround51Channel16.flac",
+        frameCount<DrFlacImporter>, read<DrFlacImporter>},
+    #endif
+    #ifdef MAGNUM_WITH_DRMP3AUDIOIMPORTER
+    {"MP3, DrMp3AudioImporter", "DrMp3AudioImporter", DRMP3AUDIOIMPORTER_TEST_DIR "/stereo16.mp3",
+        frameCount<DrMp3Importer>, read<DrMp3Importer>},
+    #endif
+    #ifdef MAGNUM_WITH_FAAD2AUDIOIMPORTER
+    {"AAC, Faad2AudioImporter", "Faad2AudioImporter", FAAD2AUDIOIMPORTER_TEST_DIR "/stereo.aac",
+        frameCount<Faad2Importer>, read<Faad2Importer>},
+    #endif
+    #ifdef MAGNUM_WITH_STBVORBISAUDIOIMPORTER
+    {"Vorbis, StbVorbisAudioImporter", "StbVorbisAudioImporter", STBVORBISAUDIOIMPORTER_TEST_DIR "/stereo8.ogg",
+        frameCount<StbVorbisImporter>, read<StbVorbisImporter>},
+    #endif
+};
+
+DrWavImporterBenchmark::DrWavImporterBenchmark() {
+    addInstancedBenchmarks({&DrWavImporterBenchmark::data,
+                            &DrWavImporterBenchmark::streaming}, 10,
+        Containers::arraySize(FileData));
+
+    /* Load the plugins directly from the build tree. Otherwise they're either
+       static and already loaded or not present in the build tree */
+    #ifdef DRWAVAUDIOIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(DRWAVAUDIOIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef DRFLACAUDIOIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(DRFLACAUDIOIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef DRMP3AUDIOIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(DRMP3AUDIOIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef FAAD2AUDIOIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(FAAD2AUDIOIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef STBVORBISAUDIOIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(STBVORBISAUDIOIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void DrWavImporterBenchmark::data() {
+    auto&& data = FileData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate(data.plugin);
+    CORRADE_VERIFY(importer->openFile(data.filename));
+    const std::size_t size = importer->data().size();
+
+    /* Reopening the file in every iteration, as all plugins decode or copy
+       the whole file in openData() when not streaming */
+    std::size_t decoded = 0;
+    CORRADE_BENCHMARK(10) {
+        CORRADE_VERIFY(importer->openFile(data.filename));
+        decoded += importer->data().size();
+    }
+
+    CORRADE_COMPARE(decoded, size*10);
+}
+
+void DrWavImporterBenchmark::streaming() {
+    auto&& data = FileData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate(data.plugin);
+    /* DrWavAudioImporter has no such option, its read() is always
+       available */
+    if(importer->configuration().hasValue("streaming"))
+        importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(data.filename));
+    const UnsignedLong frameCount = data.frameCount(*importer);
+
+    /* 4096 frames of up to 8 channels of up to 8 bytes. Aligned for the
+       largest sample type, as some plugins require that. */
+    Containers::Array<Double> chunk{NoInit, 4096*8};
+    const Containers::ArrayView<char> chunkBytes = Containers::arrayCast<char>(chunk).prefix(4096*importer->data().size()/frameCount);
+
+    UnsignedLong decoded = 0;
+    CORRADE_BENCHMARK(10) {
+        CORRADE_VERIFY(importer->openFile(data.filename));
+        while(const std::size_t frames = data.read(*importer, chunkBytes))
+            decoded += frames;
+    }
+
+    CORRADE_COMPARE(decoded, frameCount*10);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Audio::Test::DrWavImporterBenchmark)
@@ -35,6 +35,8 @@
 #include <Corrade/Utility/Path.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
+#include "MagnumPlugins/DrWavAudioImporter/DrWavImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Audio { namespace Test { namespace {
@@ -85,6 +87,13 @@ struct DrWavImporterTest: TestSuite::Tester {
     void extensions32f();
     void extensions64f();
 
+    void dataView();
+    void dataViewNoFile();
+
+    void streaming();
+    void streamingNoFile();
+    void streamingInvalidSize();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -132,7 +141,14 @@ DrWavImporterTest::DrWavImporterTest() {
               &DrWavImporterTest::extensions32,
 
               &DrWavImporterTest::extensions32f,
-              &DrWavImporterTest::extensions64f});
+              &DrWavImporterTest::extensions64f,
+
+              &DrWavImporterTest::dataView,
+              &DrWavImporterTest::dataViewNoFile,
+
+              &DrWavImporterTest::streaming,
+              &DrWavImporterTest::streamingNoFile,
+              &DrWavImporterTest::streamingInvalidSize});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -580,6 +596,106 @@ void DrWavImporterTest::extensions64f() {
     }), TestSuite::Compare::Container);
 }
 
+void DrWavImporterTest::dataView() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRWAVAUDIOIMPORTER_TEST_DIR, "stereo16.wav")));
+
+    /* The view is the same every time and has the same contents as the
+       copy returned by data() */
+    DrWavImporter& wavImporter = static_cast<DrWavImporter&>(*importer);
+    Containers::ArrayView<const char> view = wavImporter.dataView();
+    CORRADE_COMPARE(wavImporter.dataView().data(), view.data());
+    CORRADE_COMPARE_AS(view, Containers::arrayView({
+        '\x27', '\x4f', '\x27', '\x4f'
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(view, importer->data(),
+        TestSuite::Compare::Container);
+}
+
+void DrWavImporterTest::dataViewNoFile() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    static_cast<DrWavImporter&>(*importer).dataView();
+    CORRADE_COMPARE(out.str(), "Audio::DrWavImporter::dataView(): no file opened\n");
+}
+
+void DrWavImporterTest::streaming() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRWAVAUDIOIMPORTER_TEST_DIR, "mono8.wav")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Mono8);
+
+    DrWavImporter& wavImporter = static_cast<DrWavImporter&>(*importer);
+    const Containers::ArrayView<const char> expected = wavImporter.dataView();
+    CORRADE_COMPARE(wavImporter.frameCount(), 2136);
+
+    /* Read in chunks that don't divide the frame count evenly, the last one
+       is shorter and then it returns 0 */
+    char chunk[1000];
+    CORRADE_COMPARE(wavImporter.read(chunk), 1000);
+    CORRADE_COMPARE_AS(Containers::arrayView(chunk), expected.prefix(1000),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(wavImporter.read(chunk), 1000);
+    CORRADE_COMPARE_AS(Containers::arrayView(chunk), expected.sliceSize(1000, 1000),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(wavImporter.read(chunk), 136);
+    CORRADE_COMPARE_AS(Containers::arrayView(chunk).prefix(136), expected.exceptPrefix(2000),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(wavImporter.read(chunk), 0);
+
+    /* Seeking back */
+    CORRADE_VERIFY(wavImporter.seek(1500));
+    CORRADE_COMPARE(wavImporter.read(Containers::arrayView(chunk).prefix(16)), 16);
+    CORRADE_COMPARE_AS(Containers::arrayView(chunk).prefix(16), expected.sliceSize(1500, 16),
+        TestSuite::Compare::Container);
+
+    /* Seeking to the end makes read() return nothing */
+    CORRADE_VERIFY(wavImporter.seek(wavImporter.frameCount()));
+    CORRADE_COMPARE(wavImporter.read(chunk), 0);
+
+    /* Reopening resets the position */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRWAVAUDIOIMPORTER_TEST_DIR, "mono8.wav")));
+    CORRADE_COMPARE(wavImporter.read(chunk), 1000);
+}
+
+void DrWavImporterTest::streamingNoFile() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    DrWavImporter& wavImporter = static_cast<DrWavImporter&>(*importer);
+
+    char chunk[16];
+    std::ostringstream out;
+    Error redirectError{&out};
+    wavImporter.frameCount();
+    wavImporter.read(chunk);
+    wavImporter.seek(0);
+    CORRADE_COMPARE(out.str(),
+        "Audio::DrWavImporter::frameCount(): no file opened\n"
+        "Audio::DrWavImporter::read(): no file opened\n"
+        "Audio::DrWavImporter::seek(): no file opened\n");
+}
+
+void DrWavImporterTest::streamingInvalidSize() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRWAVAUDIOIMPORTER_TEST_DIR, "stereo16.wav")));
+    DrWavImporter& wavImporter = static_cast<DrWavImporter&>(*importer);
+
+    char chunk[8];
+    std::ostringstream out;
+    Error redirectError{&out};
+    wavImporter.read(Containers::arrayView(chunk).prefix(6));
+    wavImporter.seek(2);
+    CORRADE_COMPARE(out.str(),
+        "Audio::DrWavImporter::read(): expected size to be a multiple of 4 bytes but got 6\n"
+        "Audio::DrWavImporter::seek(): frame 2 out of range for 1 frames\n");
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Audio::Test::DrWavImporterTest)
@@ -24,4 +24,16 @@
 */
 
 #cmakedefine DRWAVAUDIOIMPORTER_PLUGIN_FILENAME "${DRWAVAUDIOIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine DRFLACAUDIOIMPORTER_PLUGIN_FILENAME "${DRFLACAUDIOIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine DRMP3AUDIOIMPORTER_PLUGIN_FILENAME "${DRMP3AUDIOIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine FAAD2AUDIOIMPORTER_PLUGIN_FILENAME "${FAAD2AUDIOIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine STBVORBISAUDIOIMPORTER_PLUGIN_FILENAME "${STBVORBISAUDIOIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine MAGNUM_WITH_DRFLACAUDIOIMPORTER
+#cmakedefine MAGNUM_WITH_DRMP3AUDIOIMPORTER
+#cmakedefine MAGNUM_WITH_FAAD2AUDIOIMPORTER
+#cmakedefine MAGNUM_WITH_STBVORBISAUDIOIMPORTER
 #define DRWAVAUDIOIMPORTER_TEST_DIR "${DRWAVAUDIOIMPORTER_TEST_DIR}"
+#define DRFLACAUDIOIMPORTER_TEST_DIR "${DRFLACAUDIOIMPORTER_TEST_DIR}"
+#define DRMP3AUDIOIMPORTER_TEST_DIR "${DRMP3AUDIOIMPORTER_TEST_DIR}"
+#define FAAD2AUDIOIMPORTER_TEST_DIR "${FAAD2AUDIOIMPORTER_TEST_DIR}"
+#define STBVORBISAUDIOIMPORTER_TEST_DIR "${STBVORBISAUDIOIMPORTER_TEST_DIR}"
@@ -25,13 +25,21 @@
 
 #include "EtcDecImageConverter.h"
 
+#include <thread>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <atomic>
+#endif
+
 #define ETCDEC_IMPLEMENTATION
 #include "etcdec.h"
 
@@ -45,15 +53,39 @@ ImageConverterFeatures EtcDecImageConverter::doFeatures() const { return ImageCo
 
 namespace {
 
-template<void(*decodeBlock)(const void*, void*, int)> void decodeBlocks(const Containers::StridedArrayView2D<const char>& src, const Containers::StridedArrayView2D<char>& dst) {
+template<void(*decodeBlock)(const void*, void*, int)> void decodeBlocks(const Containers::StridedArrayView2D<const char>& src, const Containers::StridedArrayView2D<char>& dst, const std::size_t threadCount) {
     const std::size_t yBlocks = src.size()[0];
     const std::size_t xBlocks = src.size()[1];
     CORRADE_INTERNAL_ASSERT(dst.size()[0] == yBlocks*4 &&
                             dst.size()[1] == xBlocks*4);
     const std::size_t dstRowStride = dst.stride()[0];
-    for(std::size_t y = 0; y != yBlocks; ++y)
-        for(std::size_t x = 0; x != xBlocks; ++x)
-            decodeBlock(&src[{y, x}], &dst[{y*4, x*4}], dstRowStride);
+
+    /* Each row of blocks is independent, so the rows can be decoded on
+       multiple threads, each picking the next undecoded one. The blocks are
+       decoded directly into the output rows, there's no intermediate copy. */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    std::atomic<std::size_t> next{0};
+    #else
+    std::size_t next = 0;
+    #endif
+    const auto decode = [&]() {
+        for(std::size_t y; (y = next++) < yBlocks; )
+            for(std::size_t x = 0; x != xBlocks; ++x)
+                decodeBlock(&src[{y, x}], &dst[{y*4, x*4}], dstRowStride);
+    };
+
+    /* The calling thread is one of the workers */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{decode};
+    decode();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    static_cast<void>(threadCount);
+    decode();
+    #endif
 }
 
 /* To make etcdec_eac_r11_float() / etcdec_eac_rg11_float() the same signature
@@ -67,6 +99,7 @@ template<void(*decodeBlock)(const void*, void*, int, int), bool isSigned> inline
 }
 
 Containers::Optional<ImageData2D> EtcDecImageConverter::doConvert(const CompressedImageView2D& image) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvert"};
     const bool eacToFloat = configuration().value<bool>("eacToFloat");
 
     /* Decide on target pixel format */
@@ -151,39 +184,46 @@ Containers::Optional<ImageData2D> EtcDecImageConverter::doConvert(const Compress
          std::ptrdiff_t(pixelSize)}
     };
 
+    std::size_t threadCount = 1;
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = Math::max(Math::min(threadCount, std::size_t(blockCount.y())), std::size_t{1});
+    #endif
+
     /* Decode block-by-block */
     switch(image.format()) {
         case CompressedPixelFormat::EacR11Unorm:
             eacToFloat ?
-                decodeBlocks<decodeEacFloatBlock<etcdec_eac_r11_float, false>>(src, dst) :
-                decodeBlocks<etcdec_eac_r11_u16>(src, dst);
+                decodeBlocks<decodeEacFloatBlock<etcdec_eac_r11_float, false>>(src, dst, threadCount) :
+                decodeBlocks<etcdec_eac_r11_u16>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::EacR11Snorm:
             eacToFloat ?
-                decodeBlocks<decodeEacFloatBlock<etcdec_eac_r11_float, true>>(src, dst) :
-                decodeBlocks<etcdec_eac_r11_u16>(src, dst);
+                decodeBlocks<decodeEacFloatBlock<etcdec_eac_r11_float, true>>(src, dst, threadCount) :
+                decodeBlocks<etcdec_eac_r11_u16>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::EacRG11Unorm:
             eacToFloat ?
-                decodeBlocks<decodeEacFloatBlock<etcdec_eac_rg11_float, false>>(src, dst) :
-                decodeBlocks<etcdec_eac_rg11_u16>(src, dst);
+                decodeBlocks<decodeEacFloatBlock<etcdec_eac_rg11_float, false>>(src, dst, threadCount) :
+                decodeBlocks<etcdec_eac_rg11_u16>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::EacRG11Snorm:
             eacToFloat ?
-                decodeBlocks<decodeEacFloatBlock<etcdec_eac_rg11_float, true>>(src, dst) :
-                decodeBlocks<etcdec_eac_rg11_u16>(src, dst);
+                decodeBlocks<decodeEacFloatBlock<etcdec_eac_rg11_float, true>>(src, dst, threadCount) :
+                decodeBlocks<etcdec_eac_rg11_u16>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Etc2RGB8Unorm:
         case CompressedPixelFormat::Etc2RGB8Srgb:
-            decodeBlocks<etcdec_etc_rgb>(src, dst);
+            decodeBlocks<etcdec_etc_rgb>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Etc2RGB8A1Unorm:
         case CompressedPixelFormat::Etc2RGB8A1Srgb:
-            decodeBlocks<etcdec_etc_rgb_a1>(src, dst);
+            decodeBlocks<etcdec_etc_rgb_a1>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Etc2RGBA8Unorm:
         case CompressedPixelFormat::Etc2RGBA8Srgb:
-            decodeBlocks<etcdec_eac_rgba>(src, dst);
+            decodeBlocks<etcdec_eac_rgba>(src, dst, threadCount);
             break;
         /* Unsupported formats already handled above */
         default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
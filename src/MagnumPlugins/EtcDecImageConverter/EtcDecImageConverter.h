@@ -145,6 +145,14 @@ isn't supported in input images.
 Only 2D image conversion is supported at the moment. Image flags, if any, are
 passed through unchanged.
 
+The blocks are decoded directly into rows of the output image, with no
+intermediate per-block copies. Each row of 4x4 blocks is decoded
+independently, setting the @cb{.ini} threads @ce option to a value other than
+@cpp 1 @ce decodes the rows on multiple threads. The output is the same
+regardless of the thread count. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+application has to be linked to `pthread` on Linux for this to work.
+
 @section Trade-EtcDecImageConverter-configuration Plugin-specific configuration
 
 It's possible to tune various conversion options through @ref configuration().
@@ -0,0 +1,121 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Vector2.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+/* Measures decoding throughput of EtcDecImageConverter on a large synthetic
+   image, with BcDecImageConverter on a comparably sized BC image as a
+   reference point. The blocks are generated in memory as there's no point in
+   bloating the repository with megabytes of data, any bit pattern is a valid
+   block for all formats tested here. */
+struct EtcDecImageConverterBenchmark: TestSuite::Tester {
+    explicit EtcDecImageConverterBenchmark();
+
+    void decode();
+
+    private:
+        /* Explicitly forbid system-wide plugin dependencies */
+        PluginManager::Manager<AbstractImageConverter> _manager{"nonexistent"};
+};
+
+constexpr Vector2i ImageSize{2048, 2048};
+
+const struct {
+    const char* name;
+    const char* plugin;
+    CompressedPixelFormat format;
+    UnsignedInt threads;
+} DecodeData[]{
+    {"ETC2 RGB8", "EtcDecImageConverter", CompressedPixelFormat::Etc2RGB8Unorm, 1},
+    {"ETC2 RGB8, all threads", "EtcDecImageConverter", CompressedPixelFormat::Etc2RGB8Unorm, 0},
+    {"ETC2 RGBA8", "EtcDecImageConverter", CompressedPixelFormat::Etc2RGBA8Unorm, 1},
+    {"ETC2 RGBA8, all threads", "EtcDecImageConverter", CompressedPixelFormat::Etc2RGBA8Unorm, 0},
+    {"EAC RG11", "EtcDecImageConverter", CompressedPixelFormat::EacRG11Unorm, 1},
+    {"EAC RG11, all threads", "EtcDecImageConverter", CompressedPixelFormat::EacRG11Unorm, 0},
+    {"BC1, BcDec", "BcDecImageConverter", CompressedPixelFormat::Bc1RGBAUnorm, 1},
+    {"BC1, BcDec, all threads", "BcDecImageConverter", CompressedPixelFormat::Bc1RGBAUnorm, 0},
+    {"BC3, BcDec", "BcDecImageConverter", CompressedPixelFormat::Bc3RGBAUnorm, 1},
+    {"BC3, BcDec, all threads", "BcDecImageConverter", CompressedPixelFormat::Bc3RGBAUnorm, 0},
+    {"BC5, BcDec", "BcDecImageConverter", CompressedPixelFormat::Bc5RGUnorm, 1},
+    {"BC5, BcDec, all threads", "BcDecImageConverter", CompressedPixelFormat::Bc5RGUnorm, 0},
+};
+
+EtcDecImageConverterBenchmark::EtcDecImageConverterBenchmark() {
+    addInstancedBenchmarks({&EtcDecImageConverterBenchmark::decode}, 10,
+        Containers::arraySize(DecodeData));
+
+    /* Load the plugins directly from the build tree. Otherwise they're static
+       and already loaded. */
+    #ifdef ETCDECIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(ETCDECIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    /* The BcDecImageConverter is optional */
+    #ifdef BCDECIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(BCDECIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void EtcDecImageConverterBenchmark::decode() {
+    auto&& data = DecodeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState(data.plugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.plugin << "plugin not found, cannot benchmark");
+
+    /* Fill the data with something non-trivial */
+    Containers::Array<char> blocks{NoInit, std::size_t(ImageSize.product()/16*compressedPixelFormatBlockDataSize(data.format))};
+    for(std::size_t i = 0; i != blocks.size(); ++i)
+        blocks[i] = char(i*37 + i/13);
+    const CompressedImageView2D image{data.format, ImageSize, blocks};
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate(data.plugin);
+    converter->configuration().setValue("threads", data.threads);
+
+    std::size_t decoded = 0;
+    CORRADE_BENCHMARK(10) {
+        Containers::Optional<Trade::ImageData2D> out = converter->convert(image);
+        decoded += out ? out->size().product() : 0;
+    }
+
+    CORRADE_COMPARE(decoded, 10*std::size_t(ImageSize.product()));
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::EtcDecImageConverterBenchmark)
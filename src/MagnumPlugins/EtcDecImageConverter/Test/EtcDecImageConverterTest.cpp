@@ -27,6 +27,7 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
@@ -50,6 +51,8 @@ struct EtcDecImageConverterTest: TestSuite::Tester {
     void unsupportedFormat();
     void unsupportedStorage();
 
+    void threads();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _manager{"nonexistent"};
     PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
@@ -119,6 +122,18 @@ const struct {
         true, {}, {}, {}, 17.0f, 1.62f},
 };
 
+const struct {
+    const char* name;
+    CompressedPixelFormat format;
+    UnsignedInt threads;
+    Vector2i size;
+} ThreadsData[]{
+    {"ETC2 RGBA8, two threads", CompressedPixelFormat::Etc2RGBA8Unorm, 2, {64, 32}},
+    {"ETC2 RGB8, all threads", CompressedPixelFormat::Etc2RGB8Unorm, 0, {64, 32}},
+    {"EAC RG11, incomplete blocks, five threads", CompressedPixelFormat::EacRG11Unorm, 5, {63, 27}},
+    {"EAC R11, more threads than block rows", CompressedPixelFormat::EacR11Snorm, 64, {64, 32}},
+};
+
 EtcDecImageConverterTest::EtcDecImageConverterTest() {
     addInstancedTests({&EtcDecImageConverterTest::test},
         Containers::arraySize(TestData));
@@ -128,6 +143,9 @@ EtcDecImageConverterTest::EtcDecImageConverterTest() {
               &EtcDecImageConverterTest::unsupportedFormat,
               &EtcDecImageConverterTest::unsupportedStorage});
 
+    addInstancedTests({&EtcDecImageConverterTest::threads},
+        Containers::arraySize(ThreadsData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef ETCDECIMAGECONVERTER_PLUGIN_FILENAME
@@ -240,6 +258,32 @@ void EtcDecImageConverterTest::unsupportedStorage() {
     CORRADE_COMPARE(out.str(), "Trade::EtcDecImageConverter::convert(): non-default compressed storage is not supported\n");
 }
 
+void EtcDecImageConverterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Any bit pattern is a valid ETC2 / EAC block, so just fill the data with
+       something non-trivial */
+    const Vector2i blockCount = (data.size + Vector2i{3})/4;
+    Containers::Array<char> blocks{NoInit, std::size_t(blockCount.product()*compressedPixelFormatBlockDataSize(data.format))};
+    for(std::size_t i = 0; i != blocks.size(); ++i)
+        blocks[i] = char(i*37 + i/13);
+    CompressedImageView2D image{data.format, data.size, blocks};
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("EtcDecImageConverter");
+    Containers::Optional<Trade::ImageData2D> expected = converter->convert(image);
+    CORRADE_VERIFY(expected);
+
+    /* The output should be the same regardless of the thread count */
+    converter->configuration().setValue("threads", data.threads);
+    Containers::Optional<Trade::ImageData2D> converted = converter->convert(image);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->size(), data.size);
+    CORRADE_COMPARE_AS(converted->data(),
+        expected->data(),
+        TestSuite::Compare::Container);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::EtcDecImageConverterTest)
@@ -24,6 +24,7 @@
 */
 
 #cmakedefine ETCDECIMAGECONVERTER_PLUGIN_FILENAME "${ETCDECIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine BCDECIMAGECONVERTER_PLUGIN_FILENAME "${BCDECIMAGECONVERTER_PLUGIN_FILENAME}"
 #cmakedefine KTXIMPORTER_PLUGIN_FILENAME "${KTXIMPORTER_PLUGIN_FILENAME}"
 #cmakedefine STBIMAGEIMPORTER_PLUGIN_FILENAME "${STBIMAGEIMPORTER_PLUGIN_FILENAME}"
 #define ETCDECIMAGECONVERTER_TEST_DIR "${ETCDECIMAGECONVERTER_TEST_DIR}"
@@ -25,24 +25,102 @@
 
 #include "Faad2Importer.h"
 
+#include <cstdint>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/ScopeGuard.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
+#include <Magnum/Math/Functions.h>
 
 #include <neaacdec.h>
 
 namespace Magnum { namespace Audio {
 
+namespace {
+
+struct Decoder {
+    ~Decoder() { if(handle) NeAACDecClose(handle); }
+
+    /* Decodes the next ADTS frame into `pending`, which is a view on a
+       decoder-owned buffer valid until the next call */
+    bool decode(Containers::ArrayView<const char> data, Containers::ArrayView<const std::size_t> adtsFrameOffsets, const char* messagePrefix);
+
+    /* Reopens the decoder at given ADTS frame and decodes it to prime the
+       overlap, as FAAD2 doesn't output anything for the first decoded frame.
+       Then decodes the next frame into `pending`, making its output
+       bit-identical to when decoding the whole file. */
+    bool start(Containers::ArrayView<const char> data, Containers::ArrayView<const std::size_t> adtsFrameOffsets, std::size_t adtsFrame, const char* messagePrefix);
+
+    NeAACDecHandle handle{};
+    /* Next ADTS frame to decode and samples decoded from the previous one
+       that weren't consumed yet */
+    std::size_t nextAdtsFrame;
+    Containers::ArrayView<const Short> pending;
+};
+
+bool Decoder::decode(const Containers::ArrayView<const char> data, const Containers::ArrayView<const std::size_t> adtsFrameOffsets, const char* const messagePrefix) {
+    const std::size_t offset = adtsFrameOffsets[nextAdtsFrame];
+    NeAACDecFrameInfo info;
+    void* const sampleBuffer = NeAACDecDecode(handle, &info, const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data.data())) + offset, adtsFrameOffsets[nextAdtsFrame + 1] - offset);
+    if(info.error) {
+        Error{} << messagePrefix << "decoding error";
+        return false;
+    }
+
+    pending = {reinterpret_cast<const Short*>(sampleBuffer), info.samples};
+    ++nextAdtsFrame;
+    return true;
+}
+
+bool Decoder::start(const Containers::ArrayView<const char> data, const Containers::ArrayView<const std::size_t> adtsFrameOffsets, const std::size_t adtsFrame, const char* const messagePrefix) {
+    if(handle) NeAACDecClose(handle);
+    handle = NeAACDecOpen();
+    NeAACDecGetCurrentConfiguration(handle)->outputFormat = FAAD_FMT_16BIT;
+
+    const std::size_t offset = adtsFrameOffsets[adtsFrame];
+    unsigned long samplerate = 0;
+    unsigned char channels = 0;
+    if(NeAACDecInit(handle, const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data.data())) + offset, data.size() - offset, &samplerate, &channels) < 0) {
+        Error{} << messagePrefix << "can't read file header";
+        return false;
+    }
+
+    pending = {};
+    nextAdtsFrame = adtsFrame;
+    for(std::size_t i = 0; i != 2 && nextAdtsFrame + 1 < adtsFrameOffsets.size(); ++i)
+        if(!decode(data, adtsFrameOffsets, messagePrefix)) return false;
+
+    return true;
+}
+
+}
+
+struct Faad2Importer::State {
+    explicit State(Containers::Array<char>&& data): data{Utility::move(data)} {}
+
+    /* The decoder references the data, so it has to be kept for the whole
+       decoder lifetime */
+    Containers::Array<char> data;
+    /* Offsets of all ADTS frames, with the data size as the last item */
+    Containers::Array<std::size_t> adtsFrameOffsets;
+    Decoder decoder;
+    /* Output frames produced by decoding one ADTS frame */
+    std::size_t framesPerAdtsFrame;
+    UnsignedLong frameCount;
+};
+
 Faad2Importer::Faad2Importer() = default;
 
 Faad2Importer::Faad2Importer(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
 
+Faad2Importer::~Faad2Importer() = default;
+
 ImporterFeatures Faad2Importer::doFeatures() const { return ImporterFeature::OpenData; }
 
-bool Faad2Importer::doIsOpened() const { return !_samples.isEmpty(); }
+bool Faad2Importer::doIsOpened() const { return !_samples.isEmpty() || _state; }
 
 void Faad2Importer::doOpenData(Containers::ArrayView<const char> data) {
     /* Init the library */
@@ -78,6 +156,42 @@ void Faad2Importer::doOpenData(Containers::ArrayView<const char> data) {
         return;
     }
 
+    /* In the streaming mode only the ADTS frame boundaries are found and the
+       first two frames are decoded to know the output frame count, the rest
+       is decoded on demand in read() */
+    if(configuration().value<bool>("streaming")) {
+        Containers::Array<char> dataCopy{NoInit, data.size()};
+        Utility::copy(data, dataCopy);
+        Containers::Pointer<State> state{InPlaceInit, Utility::move(dataCopy)};
+
+        /* The ADTS header is 7 bytes, starting with a 12-bit syncword and
+           with the 13-bit frame length including the header at bits 30 to
+           42 */
+        const auto* const bytes = reinterpret_cast<const UnsignedByte*>(state->data.data());
+        for(std::size_t pos = result; pos < state->data.size(); ) {
+            const std::size_t length = pos + 7 <= state->data.size() && bytes[pos] == 0xff && (bytes[pos + 1] & 0xf0) == 0xf0 ?
+                (std::size_t(bytes[pos + 3] & 0x03) << 11)|(std::size_t(bytes[pos + 4]) << 3)|(bytes[pos + 5] >> 5) : 0;
+            if(length < 7 || pos + length > state->data.size()) {
+                Error{} << "Audio::Faad2Importer::openData(): invalid ADTS frame at offset" << pos << Debug::nospace << ", streaming is supported only for ADTS streams";
+                return;
+            }
+
+            arrayAppend(state->adtsFrameOffsets, pos);
+            pos += length;
+        }
+        arrayAppend(state->adtsFrameOffsets, state->data.size());
+
+        if(!state->decoder.start(state->data, state->adtsFrameOffsets, 0, "Audio::Faad2Importer::openData():"))
+            return;
+
+        /* Every ADTS frame except the first produces the same amount of
+           output frames, which is what gets decoded into `pending` above */
+        state->framesPerAdtsFrame = state->decoder.pending.size()/2;
+        state->frameCount = (state->adtsFrameOffsets.size() - 2)*state->framesPerAdtsFrame;
+        _state = Utility::move(state);
+        return;
+    }
+
     /** @todo s there any way to get the sample count beforehand? the faad
         fronted does it by manually parsing the headers and NO WAY IN HELL i
         am doing that here: https://github.com/knik0/faad2/blob/7da4a83b230d069a9d731b1e64f6e6b52802576a/frontend/main.c#L613-L630 */
@@ -100,18 +214,100 @@ void Faad2Importer::doOpenData(Containers::ArrayView<const char> data) {
     _samples = Utility::move(samples);
 }
 
-void Faad2Importer::doClose() { _samples = nullptr; }
+void Faad2Importer::doClose() {
+    _samples = nullptr;
+    _state = nullptr;
+}
 
 BufferFormat Faad2Importer::doFormat() const { return _format; }
 
 UnsignedInt Faad2Importer::doFrequency() const { return _frequency; }
 
 Containers::Array<char> Faad2Importer::doData() {
+    /* In the streaming mode decode everything using a new decoder on the
+       same data, to not affect the position of read() */
+    if(_state) {
+        Decoder decoder;
+        Containers::Array<char> out{NoInit, std::size_t(_state->frameCount*4)};
+        const Containers::ArrayView<Short> outShort = Containers::arrayCast<Short>(out);
+        std::size_t offset = 0;
+        CORRADE_INTERNAL_ASSERT_OUTPUT(decoder.start(_state->data, _state->adtsFrameOffsets, 0, "Audio::Faad2Importer::data():"));
+        for(;;) {
+            Utility::copy(decoder.pending, outShort.sliceSize(offset, decoder.pending.size()));
+            offset += decoder.pending.size();
+            if(decoder.nextAdtsFrame + 1 == _state->adtsFrameOffsets.size()) break;
+            CORRADE_INTERNAL_ASSERT_OUTPUT(decoder.decode(_state->data, _state->adtsFrameOffsets, "Audio::Faad2Importer::data():"));
+        }
+        CORRADE_INTERNAL_ASSERT(offset == outShort.size());
+        return out;
+    }
+
     Containers::Array<char> copy{NoInit, _samples.size()*2};
     Utility::copy(Containers::arrayCast<char>(_samples), copy);
     return copy;
 }
 
+UnsignedLong Faad2Importer::frameCount() const {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::Faad2Importer::frameCount(): no file opened", {});
+    return _state ? _state->frameCount : _samples.size()/2;
+}
+
+std::size_t Faad2Importer::read(const Containers::ArrayView<char>& data) {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::Faad2Importer::read(): no file opened", {});
+    CORRADE_ASSERT(_state,
+        "Audio::Faad2Importer::read(): the file wasn't opened with streaming enabled", {});
+    CORRADE_ASSERT(data.size() % 4 == 0,
+        "Audio::Faad2Importer::read(): expected size to be a multiple of 4 bytes but got" << data.size(), {});
+    CORRADE_ASSERT(reinterpret_cast<std::uintptr_t>(data.data()) % alignof(Short) == 0,
+        "Audio::Faad2Importer::read(): expected the data to be aligned to" << alignof(Short) << "bytes", {});
+
+    /* Copy what's left from the previously decoded ADTS frame first, then
+       decode next ones until the output is filled or the stream ends */
+    Decoder& decoder = _state->decoder;
+    const Containers::ArrayView<Short> out = Containers::arrayCast<Short>(data);
+    std::size_t offset = 0;
+    for(;;) {
+        const std::size_t count = Math::min(decoder.pending.size(), out.size() - offset);
+        Utility::copy(decoder.pending.prefix(count), out.sliceSize(offset, count));
+        decoder.pending = decoder.pending.exceptPrefix(count);
+        offset += count;
+        if(offset == out.size() || decoder.nextAdtsFrame + 1 == _state->adtsFrameOffsets.size() || !decoder.decode(_state->data, _state->adtsFrameOffsets, "Audio::Faad2Importer::read():"))
+            break;
+    }
+
+    return offset/2;
+}
+
+bool Faad2Importer::seek(const UnsignedLong frame) {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::Faad2Importer::seek(): no file opened", {});
+    CORRADE_ASSERT(_state,
+        "Audio::Faad2Importer::seek(): the file wasn't opened with streaming enabled", {});
+    CORRADE_ASSERT(frame <= _state->frameCount,
+        "Audio::Faad2Importer::seek(): frame" << frame << "out of range for" << _state->frameCount << "frames", {});
+
+    /* Seeking to the end doesn't need any decoding */
+    Decoder& decoder = _state->decoder;
+    if(frame == _state->frameCount) {
+        decoder.pending = {};
+        decoder.nextAdtsFrame = _state->adtsFrameOffsets.size() - 1;
+        return true;
+    }
+
+    /* Output of ADTS frame N+1 contains output frames starting at
+       N*framesPerAdtsFrame, restart the decoder at frame N and skip the part
+       before the requested frame */
+    if(!decoder.start(_state->data, _state->adtsFrameOffsets, frame/_state->framesPerAdtsFrame, "Audio::Faad2Importer::seek():")) {
+        Error{} << "Audio::Faad2Importer::seek(): can't seek to frame" << frame;
+        return false;
+    }
+    decoder.pending = decoder.pending.exceptPrefix(Math::min(decoder.pending.size(), std::size_t(frame % _state->framesPerAdtsFrame)*2));
+
+    return true;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(Faad2AudioImporter, Magnum::Audio::Faad2Importer,
@@ -30,6 +30,7 @@
  */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
 #include "MagnumPlugins/Faad2AudioImporter/configure.h"
@@ -116,6 +117,43 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::Faad2AudioImporter)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Audio-Faad2Importer-behavior Behavior and limitations
+
+By default the whole file is decoded on @ref openData() and @ref data()
+returns a copy of the decoded samples.
+
+@subsection Audio-Faad2Importer-behavior-streaming Streaming decoding
+
+If the @cb{.ini} streaming @ce
+@ref Audio-Faad2Importer-configuration "configuration option" is enabled,
+@ref openData() keeps a copy of the file data, builds an index of ADTS frame
+boundaries and decodes just the first two frames to know the total frame
+count. Samples are then decoded on demand with @ref read() into a
+caller-provided buffer, one ADTS frame at a time. @ref seek() uses the ADTS
+frame index to restart the decoder right before the requested position,
+decoding at most two ADTS frames. The output is the same as when decoding the
+whole file. Same as with
+@ref Audio-DrMp3Importer-behavior-streaming "DrMp3AudioImporter", the
+@ref frameCount(), @ref read() and @ref seek() APIs are virtual, so they can
+be called without linking to the plugin. @ref data() works in the streaming
+mode as well, decoding the whole file without affecting the @ref read()
+position.
+
+The streaming mode is supported only for ADTS streams, which is what AAC
+files usually contain. It assumes every ADTS frame decodes to the same count
+of samples, which holds for AAC streams with one raw data block per ADTS
+frame.
+
+@section Audio-Faad2Importer-configuration Plugin-specific configuration
+
+It's possible to tune various options through @ref configuration(). See below
+for all options and their default values:
+
+@snippet MagnumPlugins/Faad2AudioImporter/Faad2Importer.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_FAAD2AUDIOIMPORTER_EXPORT Faad2Importer: public AbstractImporter {
     public:
@@ -125,7 +163,50 @@ class MAGNUM_FAAD2AUDIOIMPORTER_EXPORT Faad2Importer: public AbstractImporter {
         /** @brief Plugin manager constructor */
         explicit Faad2Importer(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
+        ~Faad2Importer();
+
+        /**
+         * @brief Frame count
+         * @m_since_latest_{plugins}
+         *
+         * Count of samples in each channel. Expects that a file is opened.
+         * Available regardless of whether the @cb{.ini} streaming @ce
+         * option is enabled.
+         */
+        virtual UnsignedLong frameCount() const;
+
+        /**
+         * @brief Decode next frames
+         * @return Count of frames decoded
+         * @m_since_latest_{plugins}
+         *
+         * Decodes as many frames from the current position as fit into
+         * @p data and advances the position by them. Returns less frames
+         * than fit at the end of the stream or if a decoding error happens,
+         * in which case a message is printed to @relativeref{Magnum,Error},
+         * and @cpp 0 @ce once the end is reached. Expects that a file is
+         * opened with the @cb{.ini} streaming @ce option enabled and that
+         * @p data is aligned for @relativeref{Magnum,Short} and its size is
+         * a multiple of @cpp 4 @ce, as the output is always stereo. See
+         * @ref Audio-Faad2Importer-behavior-streaming for more information.
+         */
+        virtual std::size_t read(const Containers::ArrayView<char>& data);
+
+        /**
+         * @brief Seek to given frame
+         * @m_since_latest_{plugins}
+         *
+         * Sets the position from which @ref read() decodes next, using the
+         * ADTS frame index built on opening. Expects that a file is opened
+         * with the @cb{.ini} streaming @ce option enabled and that @p frame
+         * is not larger than @ref frameCount(). If seeking fails, prints a
+         * message to @relativeref{Magnum,Error} and returns @cpp false @ce.
+         */
+        virtual bool seek(UnsignedLong frame);
+
     private:
+        struct State;
+
         MAGNUM_FAAD2AUDIOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_FAAD2AUDIOIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_FAAD2AUDIOIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
@@ -136,6 +217,7 @@ class MAGNUM_FAAD2AUDIOIMPORTER_EXPORT Faad2Importer: public AbstractImporter {
         MAGNUM_FAAD2AUDIOIMPORTER_LOCAL Containers::Array<char> doData() override;
 
         Containers::Array<UnsignedShort> _samples;
+        Containers::Pointer<State> _state;
         BufferFormat _format;
         UnsignedInt _frequency;
 };
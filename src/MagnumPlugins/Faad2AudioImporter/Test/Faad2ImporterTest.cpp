@@ -27,7 +27,11 @@
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringStl.h> /** @todo remove once AbstractImporter is <string>-free */
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
 #include <Magnum/ImageView.h>
@@ -35,6 +39,8 @@
 #include <Magnum/Audio/AbstractImporter.h>
 #include <Magnum/DebugTools/CompareImage.h>
 
+#include "MagnumPlugins/Faad2AudioImporter/Faad2Importer.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Audio { namespace Test { namespace {
@@ -48,6 +54,12 @@ struct Faad2ImporterTest: TestSuite::Tester {
     void mono();
     void stereo();
 
+    void streaming();
+    void streamingSeek();
+    void streamingNotAdts();
+    void streamingNotEnabled();
+    void streamingInvalidSize();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -57,7 +69,13 @@ Faad2ImporterTest::Faad2ImporterTest() {
 
               &Faad2ImporterTest::error,
               &Faad2ImporterTest::mono,
-              &Faad2ImporterTest::stereo});
+              &Faad2ImporterTest::stereo,
+
+              &Faad2ImporterTest::streaming,
+              &Faad2ImporterTest::streamingSeek,
+              &Faad2ImporterTest::streamingNotAdts,
+              &Faad2ImporterTest::streamingNotEnabled,
+              &Faad2ImporterTest::streamingInvalidSize});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -142,6 +160,125 @@ void Faad2ImporterTest::stereo() {
         (DebugTools::CompareImage{1.0f, 0.625f}));
 }
 
+void Faad2ImporterTest::streaming() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(FAAD2AUDIOIMPORTER_TEST_DIR, "stereo.aac")));
+    Containers::Array<char> expected = importer->data();
+    CORRADE_COMPARE(static_cast<Faad2Importer&>(*importer).frameCount(), 1024);
+
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(FAAD2AUDIOIMPORTER_TEST_DIR, "stereo.aac")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Stereo16);
+    CORRADE_COMPARE(importer->frequency(), 44100);
+
+    Faad2Importer& aacImporter = static_cast<Faad2Importer&>(*importer);
+    CORRADE_COMPARE(aacImporter.frameCount(), 1024);
+
+    /* Decode in chunks that don't divide the frame count evenly, the last
+       one is shorter and then it returns 0 */
+    Containers::Array<char> actual{NoInit, expected.size()};
+    Short chunk[300*2];
+    std::size_t offset = 0;
+    std::size_t chunkCount = 0;
+    while(const std::size_t frames = aacImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk)))) {
+        CORRADE_ITERATION(chunkCount);
+        CORRADE_COMPARE_AS(offset + frames*4, actual.size(),
+            TestSuite::Compare::LessOrEqual);
+        Utility::copy(Containers::arrayCast<char>(Containers::arrayView(chunk)).prefix(frames*4), actual.sliceSize(offset, frames*4));
+        offset += frames*4;
+        ++chunkCount;
+    }
+    CORRADE_COMPARE(chunkCount, 4);
+    CORRADE_COMPARE(offset, expected.size());
+    CORRADE_COMPARE_AS(actual, expected,
+        TestSuite::Compare::Container);
+
+    /* data() decodes the whole file again, independently of the read
+       position */
+    CORRADE_COMPARE_AS(importer->data(), expected,
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(aacImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 0);
+}
+
+void Faad2ImporterTest::streamingSeek() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(FAAD2AUDIOIMPORTER_TEST_DIR, "stereo.aac")));
+    Containers::Array<char> expected = importer->data();
+
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(FAAD2AUDIOIMPORTER_TEST_DIR, "stereo.aac")));
+    Faad2Importer& aacImporter = static_cast<Faad2Importer&>(*importer);
+
+    Short chunk[16*2];
+    CORRADE_VERIFY(aacImporter.seek(500));
+    CORRADE_COMPARE(aacImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 16);
+    CORRADE_COMPARE_AS(Containers::arrayCast<const char>(Containers::arrayView(chunk)), expected.sliceSize(500*4, 16*4),
+        TestSuite::Compare::Container);
+
+    /* Seeking back works as well */
+    CORRADE_VERIFY(aacImporter.seek(0));
+    CORRADE_COMPARE(aacImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 16);
+    CORRADE_COMPARE_AS(Containers::arrayCast<const char>(Containers::arrayView(chunk)), expected.prefix(16*4),
+        TestSuite::Compare::Container);
+
+    /* Seeking to the end makes read() return nothing */
+    CORRADE_VERIFY(aacImporter.seek(aacImporter.frameCount()));
+    CORRADE_COMPARE(aacImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 0);
+}
+
+void Faad2ImporterTest::streamingNotAdts() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+    importer->configuration().setValue("streaming", true);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openFile(Utility::Path::join(FAAD2AUDIOIMPORTER_TEST_DIR, "error.aac")));
+    CORRADE_COMPARE(out.str(), "Audio::Faad2Importer::openData(): invalid ADTS frame at offset 0, streaming is supported only for ADTS streams\n");
+}
+
+void Faad2ImporterTest::streamingNotEnabled() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+    Faad2Importer& aacImporter = static_cast<Faad2Importer&>(*importer);
+
+    Short chunk[16];
+    std::ostringstream out;
+    Error redirectError{&out};
+    aacImporter.frameCount();
+    aacImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk)));
+    aacImporter.seek(0);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(FAAD2AUDIOIMPORTER_TEST_DIR, "stereo.aac")));
+    aacImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk)));
+    aacImporter.seek(0);
+    CORRADE_COMPARE(out.str(),
+        "Audio::Faad2Importer::frameCount(): no file opened\n"
+        "Audio::Faad2Importer::read(): no file opened\n"
+        "Audio::Faad2Importer::seek(): no file opened\n"
+        "Audio::Faad2Importer::read(): the file wasn't opened with streaming enabled\n"
+        "Audio::Faad2Importer::seek(): the file wasn't opened with streaming enabled\n");
+}
+
+void Faad2ImporterTest::streamingInvalidSize() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(FAAD2AUDIOIMPORTER_TEST_DIR, "stereo.aac")));
+    Faad2Importer& aacImporter = static_cast<Faad2Importer&>(*importer);
+
+    Short chunk[4];
+    std::ostringstream out;
+    Error redirectError{&out};
+    aacImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk)).prefix(6));
+    aacImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk)).sliceSize(1, 4));
+    aacImporter.seek(1025);
+    CORRADE_COMPARE(out.str(),
+        "Audio::Faad2Importer::read(): expected size to be a multiple of 4 bytes but got 6\n"
+        "Audio::Faad2Importer::read(): expected the data to be aligned to 2 bytes\n"
+        "Audio::Faad2Importer::seek(): frame 1025 out of range for 1024 frames\n");
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Audio::Test::Faad2ImporterTest)
@@ -26,16 +26,32 @@
 #include "FreeTypeFont.h"
 
 #include <algorithm> /* std::transform(), std::sort(), std::unique() */
+#include <thread>
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include FT_MODULE_H
+#include <Corrade/Containers/String.h>
 #include <Corrade/PluginManager/AbstractManager.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/Sha1.h>
 #include <Corrade/Utility/Unicode.h>
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
 
+#include "Magnum/Implementation/glyphCacheFile.h"
+#include "Magnum/Implementation/profilingZone.h"
+
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <atomic>
+#endif
+
 namespace Magnum { namespace Text {
 
 namespace {
@@ -71,7 +87,11 @@ void FreeTypeFont::finalize() {
     library = nullptr;
 }
 
-FreeTypeFont::FreeTypeFont(): ftFont(nullptr) {}
+FreeTypeFont::FreeTypeFont(): ftFont(nullptr) {
+    /* Without a plugin manager there's no configuration file to take the
+       defaults from */
+    configuration().setValue("threads", 1);
+}
 
 FreeTypeFont::FreeTypeFont(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractFont{manager, plugin}, ftFont(nullptr) {}
 
@@ -115,6 +135,8 @@ Vector2 FreeTypeFont::doGlyphAdvance(const UnsignedInt glyph) {
 }
 
 void FreeTypeFont::doFillGlyphCache(AbstractGlyphCache& cache, const std::u32string& characters) {
+    MAGNUM_PROFILING_ZONE("FreeTypeFont::doFillGlyphCache()");
+
     /** @bug Crash when atlas is too small */
 
     /* Get glyph codes from characters */
@@ -128,43 +150,160 @@ void FreeTypeFont::doFillGlyphCache(AbstractGlyphCache& cache, const std::u32str
     std::sort(charIndices.begin(), charIndices.end());
     charIndices.erase(std::unique(charIndices.begin(), charIndices.end()), charIndices.end());
 
-    /* Sizes of all characters */
-    std::vector<Vector2i> charSizes;
-    charSizes.reserve(charIndices.size());
-    for(FT_UInt c: charIndices) {
-        CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Load_Glyph(ftFont, c, FT_LOAD_DEFAULT) == 0);
-        charSizes.push_back(Vector2i(ftFont->glyph->metrics.width, ftFont->glyph->metrics.height)/64);
+    /* Render distance field glyphs directly, if requested and supported */
+    FT_Render_Mode renderMode = FT_RENDER_MODE_NORMAL;
+    if(configuration().value<bool>("distanceField")) {
+        #if FREETYPE_MAJOR > 2 || (FREETYPE_MAJOR == 2 && FREETYPE_MINOR >= 11)
+        /* The spread is a property of the whole library, set it every time
+           so it's not affected by other instances */
+        const FT_Int spread = configuration().value<Int>("distanceFieldSpread");
+        if(FT_Error error = FT_Property_Set(library, "sdf", "spread", &spread)) {
+            Error{} << "Text::FreeTypeFont::fillGlyphCache(): can't set distance field spread to" << spread << Debug::nospace << ":" << error;
+            return;
+        }
+        renderMode = FT_RENDER_MODE_SDF;
+        #else
+        Warning{} << "Text::FreeTypeFont::fillGlyphCache(): distance field rendering needs FreeType 2.11 or newer, rendering as usual";
+        #endif
+    }
+
+    /* If a cache directory is set, hash everything that affects the glyph
+       cache contents -- FreeType version, the font data and size, the glyph
+       set, cache properties and rendering options -- and reuse the cached
+       result if it's there. The thread count doesn't affect the output so
+       it's not included. */
+    const Containers::StringView cacheDirectory = configuration().value<Containers::StringView>("cacheDirectory");
+    Containers::String cacheFilename;
+    if(cacheDirectory) {
+        Utility::Sha1 sha1;
+        const auto hash = [&sha1](const Containers::StringView string) {
+            sha1 << Containers::ArrayView<const char>{string.data(), string.size()} << Containers::ArrayView<const char>{"\n", 1};
+        };
+        hash(Utility::format("FreeTypeFont {}.{}.{}", FREETYPE_MAJOR, FREETYPE_MINOR, FREETYPE_PATCH));
+        sha1 << Containers::arrayCast<const char>(Containers::arrayView(_data));
+        hash(Utility::format("{} {} {} {} {} {} {}", size(), cache.textureSize().x(), cache.textureSize().y(), cache.padding().x(), cache.padding().y(), UnsignedInt(renderMode), configuration().value<Int>("distanceFieldSpread")));
+        sha1 << Containers::arrayCast<const char>(Containers::arrayView(charIndices.data(), charIndices.size()));
+        cacheFilename = Utility::Path::join(cacheDirectory, Utility::format("{}.glyphcache", sha1.digest().hexString()));
+        if(Implementation::loadGlyphCacheFile(cache, cacheFilename))
+            return;
     }
 
+    /* Load and render each glyph just once, remembering its metrics for
+       reserving space in the atlas and a copy of the rendered bitmap for
+       copying it there afterwards. Glyphs are independent, so they can be
+       rendered on multiple threads, each picking the next unrendered one. */
+    struct RenderedGlyph {
+        Vector2i size;
+        Vector2i offset;
+        Vector2i bitmapSize;
+        Containers::Array<char> bitmap;
+    };
+    Containers::Array<RenderedGlyph> rendered{charIndices.size()};
+
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    std::atomic<std::size_t> next{0};
+    #else
+    std::size_t next = 0;
+    #endif
+    const auto render = [&](FT_Face face) {
+        MAGNUM_PROFILING_ZONE("FreeTypeFont glyph rendering");
+        for(std::size_t i; (i = next++) < charIndices.size(); ) {
+            /** @todo B&W only if radius != 0 */
+            FT_GlyphSlot glyph = face->glyph;
+            CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Load_Glyph(face, charIndices[i], FT_LOAD_DEFAULT) == 0);
+            RenderedGlyph& out = rendered[i];
+            out.size = Vector2i(glyph->metrics.width, glyph->metrics.height)/64;
+            CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Render_Glyph(glyph, renderMode) == 0);
+
+            /* Copy the bitmap flipped to have Y up, tightly packed */
+            const FT_Bitmap& bitmap = glyph->bitmap;
+            out.offset = {glyph->bitmap_left, glyph->bitmap_top};
+            out.bitmapSize = {Int(bitmap.width), Int(bitmap.rows)};
+            /* Distance field bitmaps are larger than the glyph outline by
+               the spread on each side, reserve space for all of it */
+            if(renderMode != FT_RENDER_MODE_NORMAL) out.size = out.bitmapSize;
+            out.bitmap = Containers::Array<char>{NoInit, std::size_t(bitmap.width*bitmap.rows)};
+            for(Int yin = 0, yout = bitmap.rows - 1, ymax = bitmap.rows; yin != ymax; ++yin, --yout)
+                Utility::copy(Containers::arrayView(reinterpret_cast<const char*>(bitmap.buffer) + yin*bitmap.pitch, bitmap.width),
+                    out.bitmap.sliceSize(yout*bitmap.width, bitmap.width));
+        }
+    };
+
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    std::size_t threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = Math::max(Math::min(threadCount, charIndices.size()), std::size_t{1});
+
+    /* A FT_Face can't be used from multiple threads at once, so each
+       additional thread gets its own. Faces sharing a FT_Library have to be
+       created and destroyed serially, so do that here and not in the
+       threads. The calling thread is one of the workers and uses the face
+       opened by doOpenData(). */
+    Containers::Array<FT_Face> faces{ValueInit, threadCount - 1};
+    for(FT_Face& face: faces) {
+        CORRADE_INTERNAL_ASSERT_OUTPUT(FT_New_Memory_Face(library, _data.begin(), _data.size(), 0, &face) == 0);
+        CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Set_Char_Size(face, 0, size()*64, 0, 0) == 0);
+    }
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::size_t i = 0; i != threads.size(); ++i)
+        threads[i] = std::thread{render, faces[i]};
+    render(ftFont);
+    for(std::thread& thread: threads)
+        thread.join();
+    for(FT_Face face: faces)
+        CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Done_Face(face) == 0);
+    #else
+    render(ftFont);
+    #endif
+
     /* Create texture atlas */
+    std::vector<Vector2i> charSizes;
+    charSizes.reserve(rendered.size());
+    for(const RenderedGlyph& glyph: rendered)
+        charSizes.push_back(glyph.size);
     const std::vector<Range2Di> charPositions = cache.reserve(charSizes);
 
-    /* Render all characters to the atlas and create character map */
-    Containers::Array<char> pixmap{ValueInit, std::size_t(cache.textureSize().product())};
+    /* Upload just the rectangle containing the newly added glyphs instead of
+       the whole texture. The rendered bitmaps can be slightly larger than the
+       reserved space, so take their actual sizes into account. */
+    const Range2Di textureRange{{}, cache.textureSize()};
+    Range2Di bounds = charPositions[0];
     for(std::size_t i = 0; i != charPositions.size(); ++i) {
-        /* Load and render glyph */
-        /** @todo B&W only if radius != 0 */
-        FT_GlyphSlot glyph = ftFont->glyph;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Load_Glyph(ftFont, charIndices[i], FT_LOAD_DEFAULT) == 0);
-        CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Render_Glyph(glyph, FT_RENDER_MODE_NORMAL) == 0);
-
-        /* Copy rendered bitmap to texture image */
-        const FT_Bitmap& bitmap = glyph->bitmap;
-        CORRADE_INTERNAL_ASSERT(std::abs(Int(bitmap.width)-charPositions[i].sizeX()) <= 2);
-        CORRADE_INTERNAL_ASSERT(std::abs(Int(bitmap.rows)-charPositions[i].sizeY()) <= 2);
-        for(Int yin = 0, yout = charPositions[i].bottom(), ymax = bitmap.rows; yin != ymax; ++yin, ++yout)
-            for(Int xin = 0, xout = charPositions[i].left(), xmax = bitmap.width; xin != xmax; ++xin, ++xout)
-                pixmap[yout*cache.textureSize().x() + xout] = bitmap.buffer[(bitmap.rows-yin-1)*bitmap.width + xin];
+        bounds = Math::join(bounds, charPositions[i]);
+        bounds = Math::join(bounds, Range2Di::fromSize(charPositions[i].min(), rendered[i].bitmapSize));
+    }
+    bounds = Math::intersect(bounds, textureRange);
+
+    /* Copy rendered bitmaps to the atlas and create character map. The glyph
+       properties are remembered for saving to the cache directory. */
+    Containers::Array<char> pixmap{ValueInit, std::size_t(bounds.size().product())};
+    Containers::Array<Implementation::GlyphCacheFileGlyph> cachedGlyphs{NoInit, cacheDirectory ? charPositions.size() : 0};
+    for(std::size_t i = 0; i != charPositions.size(); ++i) {
+        const RenderedGlyph& glyph = rendered[i];
+        CORRADE_INTERNAL_ASSERT(std::abs(glyph.bitmapSize.x()-charPositions[i].sizeX()) <= 2);
+        CORRADE_INTERNAL_ASSERT(std::abs(glyph.bitmapSize.y()-charPositions[i].sizeY()) <= 2);
+        const Vector2i copySize = Math::intersect(Range2Di::fromSize(charPositions[i].min(), glyph.bitmapSize), bounds).size();
+        const Vector2i offset = charPositions[i].min() - bounds.min();
+        for(Int y = 0; y < copySize.y(); ++y)
+            Utility::copy(glyph.bitmap.sliceSize(y*glyph.bitmapSize.x(), copySize.x()),
+                pixmap.sliceSize((offset.y() + y)*bounds.sizeX() + offset.x(), copySize.x()));
 
         /* Insert glyph parameters into cache */
-        cache.insert(charIndices[i],
-            Vector2i(glyph->bitmap_left, glyph->bitmap_top-charPositions[i].sizeY()),
-            charPositions[i]);
+        const Vector2i glyphOffset{glyph.offset.x(), glyph.offset.y()-charPositions[i].sizeY()};
+        cache.insert(charIndices[i], glyphOffset, charPositions[i]);
+        if(cacheDirectory)
+            cachedGlyphs[i] = {charIndices[i], glyphOffset, charPositions[i]};
     }
 
-    /* Set cache image */
-    Image2D image(PixelFormat::R8Unorm, cache.textureSize(), Utility::move(pixmap));
-    cache.setImage({}, image);
+    /* Set cache image. The rectangle width isn't generally a multiple of four
+       so the rows aren't padded. */
+    Image2D image{PixelStorage{}.setAlignment(1), PixelFormat::R8Unorm, bounds.size(), Utility::move(pixmap)};
+    cache.setImage(bounds.min(), image);
+
+    /* Failing to save to the cache isn't fatal, the glyph cache is filled
+       already */
+    if(cacheDirectory && !Implementation::saveGlyphCacheFile(cacheDirectory, cacheFilename, cachedGlyphs, bounds, image.data()))
+        Warning{} << "Text::FreeTypeFont::fillGlyphCache(): can't save the glyph cache to cache directory" << cacheDirectory;
 }
 
 Containers::Pointer<AbstractLayouter> FreeTypeFont::doLayout(const AbstractGlyphCache& cache, const Float size, const std::string& text) {
@@ -121,6 +121,60 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::FreeTypeFont)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Text-FreeTypeFont-behavior Behavior and limitations
+
+When filling a glyph cache, each glyph is loaded and rasterized just once.
+Glyphs are rendered independently of each other, setting the
+@cb{.ini} threads @ce @ref Text-FreeTypeFont-configuration "configuration option"
+to a value other than @cpp 1 @ce rasterizes them on multiple threads, each
+using its own copy of the font face. The resulting glyph cache is the same
+regardless of the thread count. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+application has to be linked to `pthread` on Linux for this to work.
+
+Only the rectangle containing the newly added glyphs is passed to
+@ref AbstractGlyphCache::setImage(), not the whole texture. The image has
+@ref PixelStorage::alignment() set to @cpp 1 @ce, as the rectangle width
+isn't generally a multiple of four.
+
+If Corrade and Magnum is compiled with @ref CORRADE_BUILD_MULTITHREADED
+enabled, the FreeType library handle is thread-local and gets created by
+@ref initialize() only on the thread that loaded the plugin. Font instances
+thus can't be opened from other threads unless @ref initialize() and
+@ref finalize() is called on each of them as well, which is possible only if
+the plugin is linked statically. The multithreaded glyph rasterization
+described above isn't affected by this.
+
+Enabling the @cb{.ini} distanceField @ce option renders the glyphs as signed
+distance fields directly using @m_class{m-doc-external} [FT_RENDER_MODE_SDF](https://freetype.org/freetype2/docs/reference/ft2-glyph_retrieval.html#ft_render_mode),
+with the distance range given by @cb{.ini} distanceFieldSpread @ce. The glyph
+cache can then be a plain @ref GlyphCache filled with already processed
+glyphs at their final resolution, instead of a @ref DistanceFieldGlyphCache
+processing high-resolution glyph bitmaps. This needs FreeType 2.11 or newer,
+if the plugin is built against an older version, a warning is printed and
+the glyphs are rendered as usual.
+
+If the @cb{.ini} cacheDirectory @ce option is set, the glyph cache contents
+filled by @ref fillGlyphCache() are saved to given directory, named after a
+SHA-1 hash of the FreeType version, font data, font size, the set of glyphs,
+glyph cache texture size and padding and the distance field options. A
+subsequent @ref fillGlyphCache() call with the same input fills the glyph
+cache directly from the saved file without rasterizing anything. The glyph
+cache has to be empty in both cases, same as is required by
+@ref AbstractGlyphCache::reserve(). The files are meant to be read only by
+the same build of the plugin, the cache is never cleaned up by the plugin
+and a failure to write to it only prints a warning.
+
+@section Text-FreeTypeFont-configuration Plugin-specific configuration
+
+It's possible to tune various options through @ref configuration(). See below
+for all options and their default values:
+
+@snippet MagnumPlugins/FreeTypeFont/FreeTypeFont.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_FREETYPEFONT_EXPORT FreeTypeFont: public AbstractFont {
     public:
@@ -24,10 +24,23 @@
 */
 
 #include <sstream>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/PluginManager/Manager.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/Path.h>
+#include <Magnum/Image.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/Text/AbstractFont.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
 
@@ -44,6 +57,10 @@ struct FreeTypeFontTest: TestSuite::Tester {
     void properties();
     void layout();
     void fillGlyphCache();
+    void fillGlyphCacheThreads();
+    void fillGlyphCacheUploadUsedRectangleOnly();
+    void fillGlyphCacheDistanceField();
+    void fillGlyphCacheCacheDirectory();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractFont> _manager{"nonexistent"};
@@ -56,6 +73,31 @@ struct DummyGlyphCache: AbstractGlyphCache {
     void doSetImage(const Vector2i&, const ImageView2D&) override {}
 };
 
+struct ImageGlyphCache: AbstractGlyphCache {
+    using AbstractGlyphCache::AbstractGlyphCache;
+
+    GlyphCacheFeatures doFeatures() const override { return {}; }
+    void doSetImage(const Vector2i& offset, const ImageView2D& image) override {
+        Containers::Array<char> data{NoInit, image.data().size()};
+        Utility::copy(image.data(), data);
+        this->offset = offset;
+        this->image = Image2D{image.storage(), image.format(), image.size(), Utility::move(data)};
+    }
+
+    Vector2i offset;
+    Image2D image{PixelFormat::R8Unorm};
+};
+
+const struct {
+    const char* name;
+    UnsignedInt threads;
+} FillGlyphCacheThreadsData[]{
+    {"2 threads", 2},
+    {"5 threads", 5},
+    {"all threads", 0},
+    {"more threads than glyphs", 100}
+};
+
 FreeTypeFontTest::FreeTypeFontTest() {
     addTests({&FreeTypeFontTest::empty,
               &FreeTypeFontTest::invalid,
@@ -64,6 +106,13 @@ FreeTypeFontTest::FreeTypeFontTest() {
               &FreeTypeFontTest::layout,
               &FreeTypeFontTest::fillGlyphCache});
 
+    addInstancedTests({&FreeTypeFontTest::fillGlyphCacheThreads},
+        Containers::arraySize(FillGlyphCacheThreadsData));
+
+    addTests({&FreeTypeFontTest::fillGlyphCacheUploadUsedRectangleOnly,
+              &FreeTypeFontTest::fillGlyphCacheDistanceField,
+              &FreeTypeFontTest::fillGlyphCacheCacheDirectory});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef FREETYPEFONT_PLUGIN_FILENAME
@@ -157,6 +206,159 @@ void FreeTypeFontTest::fillGlyphCache() {
     /** @todo properly test contents */
 }
 
+void FreeTypeFontTest::fillGlyphCacheThreads() {
+    auto&& data = FillGlyphCacheThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    /* Fill a cache on a single thread for a reference */
+    ImageGlyphCache expected{Vector2i{256}};
+    font->fillGlyphCache(expected, "abcdefghijklmnopqrstuvwxyz");
+
+    font->configuration().setValue("threads", data.threads);
+    ImageGlyphCache actual{Vector2i{256}};
+    font->fillGlyphCache(actual, "abcdefghijklmnopqrstuvwxyz");
+
+    /* The output should be the same regardless of the thread count */
+    CORRADE_COMPARE(actual.glyphCount(), expected.glyphCount());
+    for(const char c: Containers::StringView{"abcdefghijklmnopqrstuvwxyz"}) {
+        CORRADE_ITERATION(c);
+        const UnsignedInt glyph = font->glyphId(c);
+        CORRADE_COMPARE(actual[glyph].first, expected[glyph].first);
+        CORRADE_COMPARE(actual[glyph].second, expected[glyph].second);
+    }
+    CORRADE_COMPARE(actual.image.size(), expected.image.size());
+    CORRADE_COMPARE_AS(actual.image.data(), expected.image.data(),
+        TestSuite::Compare::Container);
+}
+
+void FreeTypeFontTest::fillGlyphCacheUploadUsedRectangleOnly() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    ImageGlyphCache cache{Vector2i{1024}};
+    font->fillGlyphCache(cache, "ab");
+    CORRADE_COMPARE(cache.glyphCount(), 3);
+
+    /* Only the area around the three glyphs is uploaded, not the whole
+       texture */
+    CORRADE_COMPARE(cache.image.format(), PixelFormat::R8Unorm);
+    CORRADE_COMPARE_AS(cache.image.size().x(), 128,
+        TestSuite::Compare::Less);
+    CORRADE_COMPARE_AS(cache.image.size().y(), 128,
+        TestSuite::Compare::Less);
+
+    /* All glyphs are inside the uploaded rectangle */
+    const Range2Di uploaded = Range2Di::fromSize(cache.offset, cache.image.size());
+    for(const char c: Containers::StringView{"ab"}) {
+        CORRADE_ITERATION(c);
+        const Range2Di rectangle = cache[font->glyphId(c)].second;
+        CORRADE_COMPARE(Math::join(uploaded, rectangle), uploaded);
+    }
+}
+
+void FreeTypeFontTest::fillGlyphCacheDistanceField() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    ImageGlyphCache normal{Vector2i{256}};
+    font->fillGlyphCache(normal, "W");
+
+    font->configuration().setValue("distanceField", true);
+    font->configuration().setValue("distanceFieldSpread", 4);
+    ImageGlyphCache distanceField{Vector2i{256}};
+    {
+        std::ostringstream out;
+        Warning redirectWarning{&out};
+        font->fillGlyphCache(distanceField, "W");
+        if(out.str() == "Text::FreeTypeFont::fillGlyphCache(): distance field rendering needs FreeType 2.11 or newer, rendering as usual\n")
+            CORRADE_SKIP("FreeType 2.11+ is needed for distance field rendering.");
+        CORRADE_COMPARE(out.str(), "");
+    }
+
+    /* The glyph is larger by the spread on each side */
+    const UnsignedInt glyph = font->glyphId(U'W');
+    CORRADE_COMPARE_AS(Math::abs(distanceField[glyph].second.size() - normal[glyph].second.size() - Vector2i{8}).max(), 2,
+        TestSuite::Compare::LessOrEqual);
+
+    /* Corners of the glyph rectangle are outside of the outline, so below the
+       edge value */
+    const Range2Di rectangle = distanceField[glyph].second;
+    const Containers::StridedArrayView2D<const UnsignedByte> pixels = distanceField.image.pixels<UnsignedByte>();
+    const Vector2i corner = rectangle.min() - distanceField.offset;
+    CORRADE_COMPARE_AS(Int(pixels[corner.y()][corner.x()]), 128,
+        TestSuite::Compare::Less);
+}
+
+void FreeTypeFontTest::fillGlyphCacheCacheDirectory() {
+    const Containers::String cacheDirectory = Utility::Path::join(FREETYPEFONT_TEST_OUTPUT_DIR, "cache");
+    if(Utility::Path::exists(cacheDirectory)) {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot);
+        CORRADE_VERIFY(files);
+        for(const Containers::String& file: *files)
+            CORRADE_VERIFY(Utility::Path::remove(Utility::Path::join(cacheDirectory, file)));
+    }
+
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    font->configuration().setValue("cacheDirectory", cacheDirectory);
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    /* First fill creates the cache directory and saves a file there */
+    ImageGlyphCache expected{Vector2i{256}};
+    font->fillGlyphCache(expected, "abcdefghijklmnopqrstuvwxyz");
+    Containers::String filename;
+    {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot);
+        CORRADE_VERIFY(files);
+        CORRADE_COMPARE(files->size(), 1);
+        CORRADE_VERIFY(files->front().hasSuffix(".glyphcache"));
+        filename = Utility::Path::join(cacheDirectory, files->front());
+    }
+
+    /* Second fill produces the same output from the saved file */
+    ImageGlyphCache actual{Vector2i{256}};
+    font->fillGlyphCache(actual, "abcdefghijklmnopqrstuvwxyz");
+    CORRADE_COMPARE(actual.glyphCount(), expected.glyphCount());
+    for(const char c: Containers::StringView{"abcdefghijklmnopqrstuvwxyz"}) {
+        CORRADE_ITERATION(c);
+        const UnsignedInt glyph = font->glyphId(c);
+        CORRADE_COMPARE(actual[glyph].first, expected[glyph].first);
+        CORRADE_COMPARE(actual[glyph].second, expected[glyph].second);
+    }
+    CORRADE_COMPARE(actual.offset, expected.offset);
+    CORRADE_COMPARE(actual.image.size(), expected.image.size());
+    CORRADE_COMPARE_AS(actual.image.data(), expected.image.data(),
+        TestSuite::Compare::Container);
+
+    /* To verify it's really taken from the file and not rasterized again,
+       modify the last pixel in the file */
+    Containers::Optional<Containers::Array<char>> file = Utility::Path::read(filename);
+    CORRADE_VERIFY(file);
+    file->back() = ~file->back();
+    CORRADE_VERIFY(Utility::Path::write(filename, *file));
+    ImageGlyphCache modified{Vector2i{256}};
+    font->fillGlyphCache(modified, "abcdefghijklmnopqrstuvwxyz");
+    CORRADE_COMPARE(modified.image.data().back(), char(~expected.image.data().back()));
+
+    /* Changing the thread count doesn't affect the output, so it's still a
+       cache hit. A different glyph set or a rendering option isn't. */
+    font->configuration().setValue("threads", 2);
+    ImageGlyphCache threads{Vector2i{256}};
+    font->fillGlyphCache(threads, "abcdefghijklmnopqrstuvwxyz");
+    ImageGlyphCache differentGlyphs{Vector2i{256}};
+    font->fillGlyphCache(differentGlyphs, "abc");
+    font->configuration().setValue("distanceFieldSpread", 2);
+    ImageGlyphCache differentOptions{Vector2i{256}};
+    font->fillGlyphCache(differentOptions, "abc");
+    {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot);
+        CORRADE_VERIFY(files);
+        CORRADE_COMPARE(files->size(), 3);
+    }
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Text::Test::FreeTypeFontTest)
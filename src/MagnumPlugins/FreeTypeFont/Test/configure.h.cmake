@@ -25,3 +25,4 @@
 
 #cmakedefine FREETYPEFONT_PLUGIN_FILENAME "${FREETYPEFONT_PLUGIN_FILENAME}"
 #define TTF_FILE "${TTF_FILE}"
+#define FREETYPEFONT_TEST_OUTPUT_DIR "${FREETYPEFONT_TEST_OUTPUT_DIR}"
@@ -24,3 +24,4 @@
 */
 
 #cmakedefine MAGNUM_FREETYPEFONT_BUILD_STATIC
+#cmakedefine MAGNUM_FREETYPEFONT_WITH_TRACY_ZONES
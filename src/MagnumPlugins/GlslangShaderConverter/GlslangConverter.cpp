@@ -25,6 +25,12 @@
 
 #include "GlslangConverter.h"
 
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/ArrayViewStl.h>
@@ -35,9 +41,12 @@
 #include <Corrade/Containers/StringIterable.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/Sha1.h>
 #include <Magnum/FileCallback.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/ShaderTools/Stage.h>
 
 #include <glslang/Public/ShaderLang.h> /* Haha what the fuck this name */
@@ -48,6 +57,10 @@
    include path as well. */
 #include <SPIRV/GlslangToSpv.h>
 
+#if defined(CORRADE_BUILD_MULTITHREADED) && (!defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__))
+#include <atomic>
+#endif
+
 /* In version 11-10 (yes, a dash!!) there's a new header containing sane build
    info -- GLSLANG_VERSION_MAJOR, GLSLANG_VERSION_MINOR etc. To avoid CMake
    try_compile() insanities like with SPIR-V Tools, assume that when we have
@@ -71,6 +84,55 @@
 
 namespace Magnum { namespace ShaderTools {
 
+namespace {
+
+/* Contents of included files, kept across compilations if the cacheIncludes
+   option is enabled. The mutex is there as convertDataToDataBatch() may
+   access it from multiple threads. */
+struct IncludeCache {
+    std::unordered_map<std::string, Containers::Array<char>> files;
+    std::mutex mutex;
+};
+
+/* Removes debug instructions from a SPIR-V module in place. None of them is
+   referenced from outside of the debug instructions themselves -- OpString is
+   referenced only by OpSource and OpLine, and the non-semantic debug info that
+   could reference it as well is never enabled here -- so they can be dropped
+   without touching anything else. The ID bound stays the same. */
+void stripDebugInfo(std::vector<UnsignedInt>& spirv) {
+    /* Skip the five-word header */
+    std::size_t out = 5;
+    for(std::size_t i = 5; i < spirv.size(); ) {
+        const UnsignedInt wordCount = spirv[i] >> 16;
+        const UnsignedInt opcode = spirv[i] & 0xffff;
+        /* Should not happen for glslang's own output, but don't loop
+           forever or read out of bounds if it does */
+        CORRADE_INTERNAL_ASSERT(wordCount && i + wordCount <= spirv.size());
+
+        switch(opcode) {
+            case 2:     /* OpSourceContinued */
+            case 3:     /* OpSource */
+            case 4:     /* OpSourceExtension */
+            case 5:     /* OpName */
+            case 6:     /* OpMemberName */
+            case 7:     /* OpString */
+            case 8:     /* OpLine */
+            case 317:   /* OpNoLine */
+            case 330:   /* OpModuleProcessed */
+                break;
+            default:
+                if(out != i) std::copy(spirv.begin() + i, spirv.begin() + i + wordCount, spirv.begin() + out);
+                out += wordCount;
+        }
+
+        i += wordCount;
+    }
+
+    spirv.resize(out);
+}
+
+}
+
 struct GlslangConverter::State {
     Format inputFormat, outputFormat;
     Containers::String inputVersion, outputVersion;
@@ -81,6 +143,15 @@ struct GlslangConverter::State {
     std::string definitions;
 
     Containers::String debugInfo;
+
+    /* Compiled SPIR-V keyed by a hex SHA-1 hash of the preprocessed source
+       and all options, if the memoryCache option is enabled */
+    std::unordered_map<std::string, Containers::Array<char>> spirvCache;
+    /* Guards spirvCache as convertDataToDataBatch() may access it from
+       multiple threads */
+    std::mutex spirvCacheMutex;
+
+    IncludeCache includeCache;
 };
 
 void GlslangConverter::initialize() {
@@ -96,6 +167,10 @@ void GlslangConverter::finalize() {
 
 GlslangConverter::GlslangConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractConverter{manager, plugin}, _state{InPlaceInit} {}
 
+void GlslangConverter::clearIncludeCache() {
+    _state->includeCache.files.clear();
+}
+
 ConverterFeatures GlslangConverter::doFeatures() const {
     return ConverterFeature::ConvertData|ConverterFeature::ValidateData|ConverterFeature::Preprocess|ConverterFeature::DebugInfo|
         /* We actually don't, but without this set the doValidateFile() /
@@ -115,6 +190,12 @@ void GlslangConverter::doSetOutputFormat(const Format format, const Containers::
     _state->outputVersion = Containers::String::nullTerminatedGlobalView(version);
 }
 
+void GlslangConverter::doSetInputFileCallback(Containers::Optional<Containers::ArrayView<const char>>(*)(const std::string&, InputFileCallbackPolicy, void*), void*) {
+    /* Files cached with the previous callback may be different from what the
+       new one would return */
+    _state->includeCache.files.clear();
+}
+
 void GlslangConverter::doSetDefinitions(const Containers::ArrayView<const Containers::Pair<Containers::StringView, Containers::StringView>> definitions) {
     /* Concatenate (un)definitions to a preamble */
     /** @todo rework w/o std::string once we have formatInto() w/ a String */
@@ -302,13 +383,35 @@ OutputVersion parseOutputVersion(const char* const prefix, Format format, const
 }
 
 struct Includer: glslang::TShader::Includer {
-    explicit Includer(Containers::Optional<Containers::ArrayView<const char>>(*const callback)(const std::string&, InputFileCallbackPolicy, void*), void* const userData): _callback{callback}, _userData{userData} {}
+    explicit Includer(Containers::Optional<Containers::ArrayView<const char>>(*const callback)(const std::string&, InputFileCallbackPolicy, void*), void* const userData, IncludeCache* const cache): _callback{callback}, _userData{userData}, _cache{cache} {}
 
     IncludeResult* includeLocal(const char* const headerName, const char* const includerName, std::size_t) override {
         /* If path/to/shader.glsl includes ../definitions.glsl, it should
            resolves to path/to/../definitions.glsl */
         const Containers::String fullPath = Utility::Path::join(Utility::Path::split(includerName).first(), headerName);
 
+        /* If the include cache is enabled, the file is loaded just once and a
+           copy of it kept for all subsequent compilations, which also means no
+           refcounting is needed. The mutex is held during the load so two
+           threads don't load the same file at the same time. */
+        if(_cache) {
+            std::lock_guard<std::mutex> lock{_cache->mutex};
+            auto found = _cache->files.find(fullPath);
+            if(found == _cache->files.end()) {
+                const Containers::Optional<Containers::ArrayView<const char>> data = _callback(fullPath, InputFileCallbackPolicy::LoadTemporary, _userData);
+                if(!data)
+                    return nullptr;
+
+                Containers::Array<char> copy{NoInit, data->size()};
+                Utility::copy(*data, copy);
+                _callback(fullPath, InputFileCallbackPolicy::Close, _userData);
+                found = _cache->files.emplace(fullPath, Utility::move(copy)).first;
+            }
+
+            /* Null userData tells releaseInclude() there's nothing to close */
+            return new IncludeResult{fullPath, found->second.data(), found->second.size(), nullptr};
+        }
+
         /* If one header is included recursively (for whatever reason), glslang
            calls the includer multiple times, followed by calling
            releaseInclude() multiple times. I suppose it's because it can't
@@ -350,6 +453,12 @@ struct Includer: glslang::TShader::Includer {
            from Includer. That's not great. */
         if(!result) return;
 
+        /* Data from the include cache stay there */
+        if(!result->userData) {
+            delete result;
+            return;
+        }
+
         /* Decrease the reference counter, if it goes to zero, close the data */
         auto& reference = *static_cast<Containers::Pair<Containers::ArrayView<const char>, std::size_t>*>(result->userData);
         CORRADE_INTERNAL_ASSERT(reference.second());
@@ -366,61 +475,15 @@ struct Includer: glslang::TShader::Includer {
     private:
         Containers::Optional<Containers::ArrayView<const char>>(*_callback)(const std::string&, InputFileCallbackPolicy, void*);
         void* _userData;
+        IncludeCache* _cache;
 
         std::unordered_map<std::string, Containers::Pair<Containers::ArrayView<const char>, std::size_t>> _references;
 };
 
-Containers::Pair<bool, bool> compileAndLinkShader(glslang::TShader& shader, glslang::TProgram& program, const Utility::ConfigurationGroup& configuration, const ConverterFlags flags, const Containers::Pair<int, EProfile> inputVersion, const OutputVersion outputVersion, const bool versionExplicitlySpecified, const Containers::StringView definitions, const Containers::StringView filename, Containers::Optional<Containers::ArrayView<const char>>(*const fileCallback)(const std::string&, InputFileCallbackPolicy, void*), void* const fileCallbackUserData, const Containers::ArrayView<const char> data, Int messages) {
-    /* Add preprocessor definitions */
-    shader.setPreamble(definitions.data());
-
-    /* Add the actual shader source. We're not making use of the
-       multiple-source inputs here, it would only further complicate the plugin
-       interface. Google's shaderc does the same, and glslangValidator (WHAT A
-       NAME!!) seems to do that also, but its API is too confusing so I can't
-       tell for sure. If we're validating/compiling a file, the name gets used
-       in potential error messages. */
-    const char* string = data.data();
-    int length = data.size();
-    const char* filenames = filename.data();
-    shader.setStringsWithLengthsAndNames(&string, &length, filename.isEmpty() ? nullptr : &filenames, 1);
-
-    /* Set up the includer -- if we have callbacks, simply use those */
-    Containers::Optional<Includer> includer;
-    std::unordered_map<std::string, Containers::Array<char>> files;
-    if(fileCallback) {
-        includer.emplace(fileCallback, fileCallbackUserData);
-
-    /* Otherwise, if we have filename, build an includer from the filesystem */
-    } else if(!filename.isEmpty()) {
-        includer.emplace([](const std::string& filename, InputFileCallbackPolicy policy, void* userData) -> Containers::Optional<Containers::ArrayView<const char>> {
-            auto& files = *static_cast<std::unordered_map<std::string, Containers::Array<char>>*>(userData);
-            auto found = files.find(filename);
-
-            /* Discard the loaded file, if not needed anymore */
-            if(policy == InputFileCallbackPolicy::Close) {
-                CORRADE_INTERNAL_ASSERT(found != files.end());
-                files.erase(found);
-                return {};
-            }
-
-            /* Read if not there yet */
-            if(found == files.end()) {
-                Containers::Optional<Containers::Array<char>> file = Utility::Path::read(filename);
-                if(!file) return {};
-
-                found = files.emplace(filename, *Utility::move(file)).first;
-            }
-
-            return Containers::ArrayView<const char>{found->second};
-        }, &files);
-
-    /* Otherwise we can't load files in any way */
-    }
-
-    /** @todo ability to override entrypoint name (for linking multiple same
-        stages together), for some reason not working in glslang, only for
-        hlsl */
+void populateResources(TBuiltInResource& resources, const Utility::ConfigurationGroup& configuration) {
+    /* Zero-initialize everything including padding, so the whole struct can
+       be hashed for the SPIR-V cache */
+    std::memset(&resources, 0, sizeof(TBuiltInResource));
 
     /* Set up builtin values and resource limits. There's no default
        constructor for that thing so we'd have to populate it either way, even
@@ -430,7 +493,6 @@ Containers::Pair<bool, bool> compileAndLinkShader(glslang::TShader& shader, glsl
 
        Update when neccessary -- the last member is commented out because it's
        not in 8.13.3743 yet */
-    TBuiltInResource resources;
     const Utility::ConfigurationGroup* builtins = configuration.group("builtins");
     CORRADE_INTERNAL_ASSERT(builtins);
     #define _c(name) resources.name = builtins->value<Int>(#name);
@@ -542,6 +604,63 @@ Containers::Pair<bool, bool> compileAndLinkShader(glslang::TShader& shader, glsl
     _c(generalVariableIndexing)
     _c(generalConstantMatrixVectorIndexing)
     #undef _c
+}
+
+Containers::Pair<bool, bool> compileAndLinkShader(glslang::TShader& shader, glslang::TProgram& program, const Utility::ConfigurationGroup& configuration, const ConverterFlags flags, const Containers::Pair<int, EProfile> inputVersion, const OutputVersion outputVersion, const bool versionExplicitlySpecified, const Containers::StringView definitions, const Containers::StringView filename, Containers::Optional<Containers::ArrayView<const char>>(*const fileCallback)(const std::string&, InputFileCallbackPolicy, void*), void* const fileCallbackUserData, const Containers::ArrayView<const char> data, Int messages, IncludeCache* const includeCache, std::string* const preprocessed = nullptr) {
+    /* Add preprocessor definitions */
+    shader.setPreamble(definitions.data());
+
+    /* Add the actual shader source. We're not making use of the
+       multiple-source inputs here, it would only further complicate the plugin
+       interface. Google's shaderc does the same, and glslangValidator (WHAT A
+       NAME!!) seems to do that also, but its API is too confusing so I can't
+       tell for sure. If we're validating/compiling a file, the name gets used
+       in potential error messages. */
+    const char* string = data.data();
+    int length = data.size();
+    const char* filenames = filename.data();
+    shader.setStringsWithLengthsAndNames(&string, &length, filename.isEmpty() ? nullptr : &filenames, 1);
+
+    /* Set up the includer -- if we have callbacks, simply use those */
+    Containers::Optional<Includer> includer;
+    std::unordered_map<std::string, Containers::Array<char>> files;
+    if(fileCallback) {
+        includer.emplace(fileCallback, fileCallbackUserData, includeCache);
+
+    /* Otherwise, if we have filename, build an includer from the filesystem */
+    } else if(!filename.isEmpty()) {
+        includer.emplace([](const std::string& filename, InputFileCallbackPolicy policy, void* userData) -> Containers::Optional<Containers::ArrayView<const char>> {
+            auto& files = *static_cast<std::unordered_map<std::string, Containers::Array<char>>*>(userData);
+            auto found = files.find(filename);
+
+            /* Discard the loaded file, if not needed anymore */
+            if(policy == InputFileCallbackPolicy::Close) {
+                CORRADE_INTERNAL_ASSERT(found != files.end());
+                files.erase(found);
+                return {};
+            }
+
+            /* Read if not there yet */
+            if(found == files.end()) {
+                Containers::Optional<Containers::Array<char>> file = Utility::Path::read(filename);
+                if(!file) return {};
+
+                found = files.emplace(filename, *Utility::move(file)).first;
+            }
+
+            return Containers::ArrayView<const char>{found->second};
+        }, &files, includeCache);
+
+    /* Otherwise we can't load files in any way */
+    }
+
+    /** @todo ability to override entrypoint name (for linking multiple same
+        stages together), for some reason not working in glslang, only for
+        hlsl */
+
+    /* Set up builtin values and resource limits */
+    TBuiltInResource resources;
+    populateResources(resources, configuration);
 
     /* Decide on the client based on output version */
     glslang::EShClient client{};
@@ -638,6 +757,18 @@ Containers::Pair<bool, bool> compileAndLinkShader(glslang::TShader& shader, glsl
     /* Compile. Why the hell is it called "parse" is beyond me. Don't even
        bother going further if compilation didn't succeed. */
     glslang::TShader::ForbidIncluder whyTheHellIsThisNotAPointer;
+
+    /* If only preprocessed output is requested, do just that, with the same
+       options as the actual compilation would use. Used for the SPIR-V cache
+       key, where the output has all includes and definitions resolved. */
+    if(preprocessed)
+        return {shader.preprocess(&resources,
+            inputVersion.first(), inputVersion.second(),
+            versionExplicitlySpecified,
+            configuration.value<bool>("forwardCompatible"),
+            EShMessages(messages), preprocessed,
+            includer ? *includer : static_cast<glslang::TShader::Includer&>(whyTheHellIsThisNotAPointer)), false};
+
     const bool compilingSucceeded = shader.parse(&resources,
         inputVersion.first(), inputVersion.second(),
         /* Force version and profile. If the input version is specified by the
@@ -785,7 +916,8 @@ Containers::Pair<bool, Containers::String> GlslangConverter::doValidateData(cons
        function is shared between doValidateData() and doConvertDataToData()
        and does the same in both. Here we use just the output log. */
     glslang::TProgram program;
-    const Containers::Pair<bool, bool> success = compileAndLinkShader(shader, program, configuration(), flags(), inputVersion, outputVersion, !_state->inputVersion.isEmpty(), _state->definitions, inputFilename, inputFileCallback(), inputFileCallbackUserData(), data, 0);
+    IncludeCache* const includeCache = configuration().value<bool>("cacheIncludes") ? &_state->includeCache : nullptr;
+    const Containers::Pair<bool, bool> success = compileAndLinkShader(shader, program, configuration(), flags(), inputVersion, outputVersion, !_state->inputVersion.isEmpty(), _state->definitions, inputFilename, inputFileCallback(), inputFileCallbackUserData(), data, 0, includeCache);
 
     /* Trim excessive newlines and spaces from the output. What the fuck, did
        nobody ever verify what mess it spits out?! */
@@ -829,6 +961,10 @@ Containers::Optional<Containers::Array<char>> GlslangConverter::doConvertDataToD
     const Containers::String inputFilename = Utility::move(_state->inputFilename);
     _state->inputFilename = {};
 
+    return convertInternal(stage, data, inputFilename, _state->definitions);
+}
+
+Containers::Optional<Containers::Array<char>> GlslangConverter::convertInternal(const Stage stage, const Containers::ArrayView<const char> data, const Containers::StringView inputFilename, const Containers::StringView definitions) {
     /** @todo implement this, should also have EShMsgOnlyPreprocessor set (or
         it's done by default?) */
     if(flags() & ConverterFlag::PreprocessOnly) {
@@ -860,9 +996,12 @@ Containers::Optional<Containers::Array<char>> GlslangConverter::doConvertDataToD
     /* Compilation and SPIR-V options */
     Int messages = 0;
     glslang::SpvOptions spvOptions;
-    /* We'll do these ourselves (and better) on the resulting SPIR-V instead */
-    spvOptions.disableOptimizer = true;
-    spvOptions.optimizeSize = false;
+    /* These are done with SpirvToolsShaderConverter by default, which has
+       far more options, but the size optimization can be done directly in
+       glslang if requested */
+    const bool optimizeSize = configuration().value<bool>("optimizeSize");
+    spvOptions.disableOptimizer = !optimizeSize;
+    spvOptions.optimizeSize = optimizeSize;
     spvOptions.disassemble = false;
     /* We have a dedicated plugin for SPIR-V validation with far more options */
     spvOptions.validate = false;
@@ -932,6 +1071,82 @@ Containers::Optional<Containers::Array<char>> GlslangConverter::doConvertDataToD
         return {};
     }
 
+    /* If any cache is enabled, preprocess the source first, which resolves
+       all includes and definitions, and look for SPIR-V compiled earlier
+       from the same preprocessed source with the same options */
+    IncludeCache* const includeCache = configuration().value<bool>("cacheIncludes") ? &_state->includeCache : nullptr;
+    const Containers::StringView cacheDirectory = configuration().value<Containers::StringView>("cacheDirectory");
+    const bool memoryCache = configuration().value<bool>("memoryCache");
+    std::string cacheKey;
+    if(memoryCache || cacheDirectory) {
+        glslang::TShader preprocessShader{translatedStage};
+        preprocessShader.setEnvTarget(glslang::EShTargetSpv, outputVersion.language);
+        glslang::TProgram preprocessProgram;
+        std::string preprocessed;
+        /* If preprocessing fails, the actual compilation below fails as well
+           and prints a proper message, so just skip the cache in that case */
+        if(compileAndLinkShader(preprocessShader, preprocessProgram, configuration(), flags(), inputVersion, outputVersion, !_state->inputVersion.isEmpty(), definitions, inputFilename, inputFileCallback(), inputFileCallbackUserData(), data, messages, includeCache, &preprocessed).first()) {
+            /* Hash everything that affects the output -- glslang version,
+               stage, versions, debug info level, flags that affect whether
+               the compilation succeeds, all options including the builtins
+               and limits, the filename which gets embedded in debug info, the
+               original source which gets embedded in debug info as well, and
+               the preprocessed source that has all includes resolved. The
+               cache options themselves don't affect the output. */
+            Utility::Sha1 sha1;
+            const auto hash = [&sha1](const Containers::StringView string) {
+                sha1 << Containers::ArrayView<const char>{string.data(), string.size()} << Containers::ArrayView<const char>{"\n", 1};
+            };
+            #ifdef GLSLANG_VERSION_MAJOR
+            hash(Utility::format("{}.{}.{}", GLSLANG_VERSION_MAJOR, GLSLANG_VERSION_MINOR, GLSLANG_VERSION_PATCH));
+            #else
+            hash(Utility::format("{}", GLSLANG_PATCH_LEVEL));
+            #endif
+            hash(Utility::format("{} {} {}", Int(translatedStage), UnsignedInt(flags() & (ConverterFlag::Quiet|ConverterFlag::WarningAsError)), messages));
+            hash(definitions);
+            hash(_state->inputVersion);
+            hash(_state->outputVersion);
+            hash(_state->debugInfo);
+            for(const char* name: {"cascadingErrors", "permissive", "forwardCompatible", "stripDebugInfo", "optimizeSize"})
+                hash(Utility::format("{}={}", name, configuration().value<Containers::StringView>(name)));
+            TBuiltInResource resources;
+            populateResources(resources, configuration());
+            sha1 << Containers::arrayView(reinterpret_cast<const char*>(&resources), sizeof(TBuiltInResource));
+            hash(inputFilename);
+            sha1 << data;
+            sha1 << Containers::ArrayView<const char>{preprocessed.data(), preprocessed.size()};
+            cacheKey = sha1.digest().hexString();
+
+            if(memoryCache) {
+                std::lock_guard<std::mutex> lock{_state->spirvCacheMutex};
+                const auto found = _state->spirvCache.find(cacheKey);
+                if(found != _state->spirvCache.end()) {
+                    Containers::Array<char> out{NoInit, found->second.size()};
+                    Utility::copy(found->second, out);
+                    /* GCC 4.8 needs extra help here */
+                    return Containers::optional(Utility::move(out));
+                }
+            }
+
+            if(cacheDirectory) {
+                const Containers::String filename = Utility::Path::join(cacheDirectory, cacheKey + ".spv");
+                if(Utility::Path::exists(filename)) {
+                    if(Containers::Optional<Containers::Array<char>> cached = Utility::Path::read(filename)) {
+                        if(flags() & ConverterFlag::Verbose)
+                            Debug{} << "ShaderTools::GlslangConverter::convertDataToData(): using cached" << filename;
+                        if(memoryCache) {
+                            Containers::Array<char> copy{NoInit, cached->size()};
+                            Utility::copy(*cached, copy);
+                            std::lock_guard<std::mutex> lock{_state->spirvCacheMutex};
+                            _state->spirvCache.emplace(cacheKey, Utility::move(copy));
+                        }
+                        return cached;
+                    }
+                }
+            }
+        }
+    }
+
     /* Amazing, why some enums have the glslang:: namespace and some don't /
        can't? Why can't you just be consistent, FFS? */
     glslang::TShader shader{translatedStage};
@@ -951,7 +1166,7 @@ Containers::Optional<Containers::Array<char>> GlslangConverter::doConvertDataToD
        enforcing SPIR-V specific rules such as presence of explicit locations
        and bindings. */
     glslang::TProgram program;
-    Containers::Pair<bool, bool> success = compileAndLinkShader(shader, program, configuration(), flags(), inputVersion, outputVersion, !_state->inputVersion.isEmpty(), _state->definitions, inputFilename, inputFileCallback(), inputFileCallbackUserData(), data, messages);
+    Containers::Pair<bool, bool> success = compileAndLinkShader(shader, program, configuration(), flags(), inputVersion, outputVersion, !_state->inputVersion.isEmpty(), definitions, inputFilename, inputFileCallback(), inputFileCallbackUserData(), data, messages, includeCache);
 
     /* Trim excessive newlines and spaces from the output. What the fuck, did
        nobody ever verify what mess it spits out?! */
@@ -991,15 +1206,117 @@ Containers::Optional<Containers::Array<char>> GlslangConverter::doConvertDataToD
     spv::SpvBuildLogger logger;
     glslang::GlslangToSpv(*ir, spirv, &logger, &spvOptions);
 
+    /* Strip debug info, if requested. Done here and not with glslang's own
+       stripDebugInfo option, as that one is only since version 11 and works
+       only if glslang is built with the SPIR-V optimizer. */
+    if(configuration().value<bool>("stripDebugInfo"))
+        stripDebugInfo(spirv);
+
     /* Copy the vector into something sane */
     Containers::ArrayView<const char> spirvBytes = Containers::arrayCast<const char>(Containers::arrayView(spirv));
     Containers::Array<char> out{NoInit, spirvBytes.size()};
     Utility::copy(spirvBytes, out);
 
+    /* Save to the caches, if enabled. Failing to save to the cache directory
+       isn't fatal, the output is still valid. */
+    if(!cacheKey.empty()) {
+        if(memoryCache) {
+            Containers::Array<char> copy{NoInit, out.size()};
+            Utility::copy(out, copy);
+            std::lock_guard<std::mutex> lock{_state->spirvCacheMutex};
+            _state->spirvCache.emplace(cacheKey, Utility::move(copy));
+        }
+        if(cacheDirectory && (!Utility::Path::make(cacheDirectory) || !Utility::Path::write(Utility::Path::join(cacheDirectory, cacheKey + ".spv"), out)))
+            Warning{} << "ShaderTools::GlslangConverter::convertDataToData(): can't save the output to cache directory" << cacheDirectory;
+    }
+
     /* GCC 4.8 needs extra help here */
     return Containers::optional(Utility::move(out));
 }
 
+Containers::Array<Containers::Optional<Containers::Array<char>>> GlslangConverter::convertDataToDataBatch(const Containers::ArrayView<const BatchInput> inputs) {
+    /* Concatenate the per-input (un)definitions after the ones set through
+       setDefinitions(), upfront so the workers only read them */
+    Containers::Array<std::string> definitions{inputs.size()};
+    for(std::size_t i = 0; i != inputs.size(); ++i) {
+        definitions[i] = _state->definitions;
+        for(const Containers::Pair<Containers::StringView, Containers::StringView>& definition: inputs[i].definitions) {
+            if(!definition.second().data())
+                Utility::formatInto(definitions[i], definitions[i].size(), "#undef {}\n", definition.first());
+            else if(definition.second().isEmpty())
+                Utility::formatInto(definitions[i], definitions[i].size(), "#define {}\n", definition.first());
+            else
+                Utility::formatInto(definitions[i], definitions[i].size(), "#define {} {}\n", definition.first(), definition.second());
+        }
+    }
+
+    /* Debug output redirection is thread-local only if Corrade is built with
+       CORRADE_BUILD_MULTITHREADED, and without threads available there's
+       nothing to parallelize on anyway */
+    std::size_t threadCount = 1;
+    #if defined(CORRADE_BUILD_MULTITHREADED) && (!defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__))
+    threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = Math::max(Math::min(threadCount, inputs.size()), std::size_t{1});
+    #endif
+
+    /* Each input is independent, with a separate TShader and TProgram, so
+       they can be compiled on multiple threads, each picking the next
+       unprocessed one. Messages are captured and printed afterwards, in
+       order, to not have the output from multiple threads interleaved and so
+       it goes to wherever the output is redirected on the calling thread. */
+    Containers::Array<Containers::Optional<Containers::Array<char>>> out{inputs.size()};
+    Containers::Array<std::string> messages{inputs.size()};
+    Containers::Array<std::string> warnings{inputs.size()};
+    Containers::Array<std::string> errors{inputs.size()};
+    #if defined(CORRADE_BUILD_MULTITHREADED) && (!defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__))
+    std::atomic<std::size_t> next{0};
+    #else
+    std::size_t next = 0;
+    #endif
+    const auto convert = [&]() {
+        for(std::size_t i; (i = next++) < inputs.size(); ) {
+            const BatchInput& input = inputs[i];
+            std::ostringstream debugOut, warningOut, errorOut;
+            {
+                Debug redirectDebug{&debugOut};
+                Warning redirectWarning{&warningOut};
+                Error redirectError{&errorOut};
+                out[i] = convertInternal(
+                    input.stage == Stage::Unspecified && input.filename ? stageFromFilename(input.filename) : input.stage,
+                    input.data, input.filename, definitions[i]);
+            }
+            messages[i] = debugOut.str();
+            warnings[i] = warningOut.str();
+            errors[i] = errorOut.str();
+        }
+    };
+
+    /* The calling thread is one of the workers */
+    #if defined(CORRADE_BUILD_MULTITHREADED) && (!defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__))
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{convert};
+    convert();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    static_cast<void>(threadCount);
+    convert();
+    #endif
+
+    for(std::size_t i = 0; i != inputs.size(); ++i) {
+        if(!messages[i].empty())
+            Debug{Debug::Flag::NoNewlineAtTheEnd} << Containers::StringView{messages[i]};
+        if(!warnings[i].empty())
+            Warning{Debug::Flag::NoNewlineAtTheEnd} << Containers::StringView{warnings[i]};
+        if(!errors[i].empty())
+            Error{Debug::Flag::NoNewlineAtTheEnd} << Containers::StringView{errors[i]};
+    }
+
+    return out;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(GlslangShaderConverter, Magnum::ShaderTools::GlslangConverter,
@@ -30,7 +30,10 @@
  * @m_since_latest_{plugins}
  */
 
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/StringView.h>
 #include <Magnum/ShaderTools/AbstractConverter.h>
+#include <Magnum/ShaderTools/Stage.h>
 
 #include "MagnumPlugins/GlslangShaderConverter/configure.h"
 
@@ -205,6 +208,19 @@ file without a corresponding @ref InputFileCallbackPolicy::LoadTemporary in
 between. This means the user callbacks don't need to implement any kind of
 reference counting, that's handled on the plugin side.
 
+By default, included files are loaded again for every validation or
+conversion. When compiling many variants of shaders sharing large common
+headers, enable the @cb{.ini} cacheIncludes @ce
+@ref ShaderTools-GlslangConverter-configuration "configuration option". With it,
+each file is loaded just once --- a @ref InputFileCallbackPolicy::LoadTemporary
+is immediately followed by a @ref InputFileCallbackPolicy::Close --- and a copy
+of its contents is kept on the plugin instance for all subsequent validations
+and conversions. The cache is keyed by the full path the file was included
+with and is cleared when a new input file callback gets set or when calling
+@ref clearIncludeCache(). Files are cached before preprocessing, as the
+preprocessed result depends on definitions and other options that can differ
+between compilations.
+
 @section ShaderTools-GlslangConverter-stages Shader stages
 
 When validating or converting files using @ref validateFile(),
@@ -315,6 +331,59 @@ can control this using @ref setDebugInfoLevel():
     providing line info for the instructions and `OpModuleProcessed` describing
     what all processing steps were taken by Glslang
 
+Enabling the @cb{.ini} stripDebugInfo @ce @ref ShaderTools-GlslangConverter-configuration "configuration option"
+removes all debug instructions from the output, including the `OpName` and
+`OpMemberName` instructions that Glslang emits always, regardless of the
+debug info level. The @cb{.ini} optimizeSize @ce option runs Glslang's
+size-optimizing SPIR-V passes, which among other things compact the IDs. It
+has an effect only if Glslang is built with the SPIR-V optimizer, otherwise
+it's silently ignored. Together they produce small output without a separate
+@ref SpirvToolsConverter pass, which however offers far more control over the
+optimization.
+
+@section ShaderTools-GlslangConverter-cache Caching compiled SPIR-V
+
+If the @cb{.ini} memoryCache @ce @ref ShaderTools-GlslangConverter-configuration "configuration option"
+is enabled, compiled SPIR-V is kept in memory for the lifetime of the plugin
+instance. If @cb{.ini} cacheDirectory @ce is set, it's additionally saved to
+a `*.spv` file in given directory, which gets reused across application runs.
+The input is preprocessed first, with all @cpp #include @ce directives and
+definitions resolved, and the cache key is a SHA-1 hash of the preprocessed
+source together with the input and output version, debug info level, flags and
+all other configuration options including builtins and limits. When the
+cached output is used, compilation is skipped entirely --- so warnings
+produced by the original compilation aren't printed again. With
+@ref ConverterFlag::Verbose enabled, the plugin prints a message when a cached
+output gets used.
+
+Caching is done only for @ref convertDataToData() and the other conversion
+APIs delegating to it, validation is always performed from scratch.
+
+@section ShaderTools-GlslangConverter-batch Batch compilation
+
+Compiling many shader permutations one after another uses just a single core.
+The plugin-specific @ref convertDataToDataBatch() API takes a list of sources,
+each with its own stage and additional preprocessor definitions, and compiles
+them on the number of threads specified by the @cb{.ini} threads @ce
+@ref ShaderTools-GlslangConverter-configuration "configuration option",
+defaulting to @ref std::thread::hardware_concurrency(). Each input gets its own
+Glslang shader and program instance, the input and output format, debug info
+level, flags and all other options are shared. Results are returned in the
+same order as the inputs.
+
+The @ref setInputFileCallback() "input file callback", if set, may get called
+from multiple threads at the same time when resolving @cpp #include @ce
+directives and thus has to be thread-safe. If
+@ref ShaderTools-GlslangConverter-cache "caching" is enabled, it's used by the
+batch compilation as well. Parallel compilation is done only if Corrade is
+built with @ref CORRADE_BUILD_MULTITHREADED and on Emscripten only if
+compiled with `-pthread`, otherwise the inputs are compiled serially.
+
+Glslang process-wide state is initialized just once when the plugin is loaded,
+so with @ref CORRADE_BUILD_MULTITHREADED enabled it's also possible to use
+separate converter instances from different threads at the same time, which
+scales the same way as the batch compilation does.
+
 @section ShaderTools-GlslangConverter-configuration Plugin-specific configuration
 
 It's possible to tune various compiler and validator options through
@@ -329,6 +398,42 @@ to edit the configuration values.
 */
 class MAGNUM_GLSLANGSHADERCONVERTER_EXPORT GlslangConverter: public AbstractConverter {
     public:
+        /**
+         * @brief Batch conversion input
+         *
+         * @see @ref convertDataToDataBatch()
+         */
+        struct BatchInput {
+            /**
+             * @brief Shader stage
+             *
+             * If @ref Stage::Unspecified and @ref filename is non-empty, the
+             * stage is detected from the filename the same way as in
+             * @ref convertFileToData().
+             */
+            Stage stage;
+
+            /** @brief Shader source */
+            Containers::ArrayView<const char> data;
+
+            /**
+             * @brief Preprocessor definitions
+             *
+             * Added after definitions set through @ref setDefinitions(), with
+             * the same semantics.
+             */
+            Containers::ArrayView<const Containers::Pair<Containers::StringView, Containers::StringView>> definitions;
+
+            /**
+             * @brief Filename
+             *
+             * Used for stage detection, in error messages and in debug info.
+             * The file isn't opened, @ref data is used instead. Can be
+             * empty.
+             */
+            Containers::StringView filename;
+        };
+
         /** @brief Initialize the Glslang library */
         static void initialize();
 
@@ -338,11 +443,45 @@ class MAGNUM_GLSLANGSHADERCONVERTER_EXPORT GlslangConverter: public AbstractConv
         /** @brief Plugin manager constructor */
         explicit GlslangConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
+        /**
+         * @brief Compile multiple GLSL sources to SPIR-V in parallel
+         *
+         * Equivalent to calling @ref convertDataToData() for each item in
+         * @p inputs, with its @ref BatchInput::definitions appended, but
+         * distributing the work across threads as described in
+         * @ref ShaderTools-GlslangConverter-batch. Returns an array of the
+         * same size as @p inputs, with an empty @relativeref{Corrade,Containers::Optional}
+         * for inputs that failed to compile. Messages are printed in order of
+         * @p inputs once all of them are processed.
+         *
+         * The function is virtual in order to be callable without linking to
+         * the plugin.
+         */
+        virtual Containers::Array<Containers::Optional<Containers::Array<char>>> convertDataToDataBatch(Containers::ArrayView<const BatchInput> inputs);
+
+        /**
+         * @brief Clear the include cache
+         *
+         * Discards contents of included files cached if the
+         * @cb{.ini} cacheIncludes @ce
+         * @ref ShaderTools-GlslangConverter-configuration "configuration option"
+         * is enabled, causing them to be loaded again on next use. Call this
+         * if the files changed since. Setting a new input file callback
+         * clears the cache implicitly. Shouldn't be called while a
+         * @ref convertDataToDataBatch() is in progress on another thread. See
+         * @ref ShaderTools-GlslangConverter-includes for more information.
+         *
+         * The function is virtual in order to be callable without linking to
+         * the plugin.
+         */
+        virtual void clearIncludeCache();
+
     private:
         MAGNUM_GLSLANGSHADERCONVERTER_LOCAL ConverterFeatures doFeatures() const override;
         MAGNUM_GLSLANGSHADERCONVERTER_LOCAL void doSetInputFormat(Format format, Containers::StringView version) override;
         MAGNUM_GLSLANGSHADERCONVERTER_LOCAL void doSetOutputFormat(Format format, Containers::StringView version) override;
 
+        MAGNUM_GLSLANGSHADERCONVERTER_LOCAL void doSetInputFileCallback(Containers::Optional<Containers::ArrayView<const char>>(*callback)(const std::string&, InputFileCallbackPolicy, void*), void* userData) override;
         MAGNUM_GLSLANGSHADERCONVERTER_LOCAL void doSetDefinitions(Containers::ArrayView<const Containers::Pair<Containers::StringView, Containers::StringView>> definitions) override;
         MAGNUM_GLSLANGSHADERCONVERTER_LOCAL void doSetDebugInfoLevel(Containers::StringView level) override;
 
@@ -352,6 +491,8 @@ class MAGNUM_GLSLANGSHADERCONVERTER_EXPORT GlslangConverter: public AbstractConv
         MAGNUM_GLSLANGSHADERCONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertFileToData(Magnum::ShaderTools::Stage stage, Containers::StringView filename) override;
         MAGNUM_GLSLANGSHADERCONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertDataToData(Magnum::ShaderTools::Stage stage, Containers::ArrayView<const char> data) override;
 
+        MAGNUM_GLSLANGSHADERCONVERTER_LOCAL Containers::Optional<Containers::Array<char>> convertInternal(Stage stage, Containers::ArrayView<const char> data, Containers::StringView inputFilename, Containers::StringView definitions);
+
         struct State;
         Containers::Pointer<State> _state;
 };
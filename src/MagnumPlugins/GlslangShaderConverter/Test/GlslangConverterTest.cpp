@@ -25,12 +25,16 @@
 
 #include <sstream>
 #include <unordered_map>
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+#include <thread>
+#endif
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
 #include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
@@ -52,6 +56,8 @@
 #include <glslang/Include/revision.h>
 #endif
 
+#include "MagnumPlugins/GlslangShaderConverter/GlslangConverter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace ShaderTools { namespace Test { namespace {
@@ -62,6 +68,7 @@ struct GlslangConverterTest: TestSuite::Tester {
     void validate();
     void validateIncludes();
     void validateIncludesCallback();
+    void validateIncludesCache();
     void validateWrongInputFormat();
     void validateWrongInputVersion();
     void validateWrongOutputFormat();
@@ -80,6 +87,8 @@ struct GlslangConverterTest: TestSuite::Tester {
        convert-specific code paths */
     void convert();
     void convertIncludes();
+    void convertStripDebugInfo();
+    void convertOptimizeSize();
     void convertPreprocessOnlyNotImplemented();
     void convertWrongInputFormat();
     void convertWrongInputVersion();
@@ -91,6 +100,16 @@ struct GlslangConverterTest: TestSuite::Tester {
     void convertFailWrongStage();
     void convertFailFileWrongStage();
 
+    void convertMemoryCache();
+    void convertCacheDirectory();
+
+    void convertBatch();
+    void convertBatchFail();
+
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    void multithreaded();
+    #endif
+
     void vulkanNoExplicitLayout();
 
     /* Explicitly forbid system-wide plugin dependencies */
@@ -254,6 +273,15 @@ const struct {
         "vulkan1.1", "1"},
 };
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+} ConvertBatchData[]{
+    {"single thread", 1},
+    {"four threads", 4},
+    {"default thread count", 0},
+};
+
 const struct {
     const char* name;
     ConverterFlags flags;
@@ -339,6 +367,7 @@ GlslangConverterTest::GlslangConverterTest() {
 
     addTests({&GlslangConverterTest::validateIncludes,
               &GlslangConverterTest::validateIncludesCallback,
+              &GlslangConverterTest::validateIncludesCache,
               &GlslangConverterTest::validateWrongInputFormat,
               &GlslangConverterTest::validateWrongInputVersion,
               &GlslangConverterTest::validateWrongOutputFormat,
@@ -360,6 +389,8 @@ GlslangConverterTest::GlslangConverterTest() {
         Containers::arraySize(ConvertData));
 
     addTests({&GlslangConverterTest::convertIncludes,
+              &GlslangConverterTest::convertStripDebugInfo,
+              &GlslangConverterTest::convertOptimizeSize,
               &GlslangConverterTest::convertPreprocessOnlyNotImplemented,
               &GlslangConverterTest::convertWrongInputFormat,
               &GlslangConverterTest::convertWrongInputVersion,
@@ -372,7 +403,18 @@ GlslangConverterTest::GlslangConverterTest() {
         Containers::arraySize(ConvertFailData));
 
     addTests({&GlslangConverterTest::convertFailWrongStage,
-              &GlslangConverterTest::convertFailFileWrongStage});
+              &GlslangConverterTest::convertFailFileWrongStage,
+
+              &GlslangConverterTest::convertMemoryCache,
+              &GlslangConverterTest::convertCacheDirectory});
+
+    addInstancedTests({&GlslangConverterTest::convertBatch,
+                       &GlslangConverterTest::convertBatchFail},
+        Containers::arraySize(ConvertBatchData));
+
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    addRepeatedTests({&GlslangConverterTest::multithreaded}, 10);
+    #endif
 
     addInstancedTests({&GlslangConverterTest::vulkanNoExplicitLayout},
         Containers::arraySize(VulkanNoExplicitLayoutData));
@@ -491,6 +533,91 @@ void GlslangConverterTest::validateIncludesCallback() {
         "Closing includes.vert\n");
 }
 
+void GlslangConverterTest::validateIncludesCache() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
+    converter->configuration().setValue("cacheIncludes", true);
+
+    const auto callback = [](const std::string& filename, InputFileCallbackPolicy policy, std::unordered_map<std::string, Containers::Array<char>>& files) -> Containers::Optional<Containers::ArrayView<const char>> {
+        auto found = files.find(filename);
+
+        if(policy == InputFileCallbackPolicy::Close) {
+            Debug{} << "Closing" << filename;
+
+            if(found != files.end()) files.erase(found);
+            return {};
+        }
+
+        Debug{} << "Loading" << filename;
+
+        if(found == files.end()) {
+            Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_DIR, filename));
+            CORRADE_VERIFY(file);
+
+            found = files.emplace(filename, *Utility::move(file)).first;
+        }
+
+        return Containers::ArrayView<const char>{found->second};
+    };
+
+    std::unordered_map<std::string, Containers::Array<char>> files;
+    converter->setInputFileCallback(callback, files);
+
+    /* Each included file is loaded just once, and closed right after as the
+       plugin keeps its own copy. Recursive and repeated includes aren't
+       propagated to the callback. The top-level file isn't cached. */
+    const char* const uncached =
+        "Loading includes.vert\n"
+        "Loading sub/directory/basics.glsl\n"
+        "Closing sub/directory/basics.glsl\n"
+        "Loading sub/directory/definitions.glsl\n"
+        "Closing sub/directory/definitions.glsl\n"
+        "Loading sub/directory/../relative.glsl\n"
+        "Closing sub/directory/../relative.glsl\n"
+        "Closing includes.vert\n";
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_COMPARE(converter->validateFile({}, "includes.vert"),
+            Containers::pair(true, Containers::String{}));
+        CORRADE_COMPARE(out.str(), uncached);
+    }
+
+    /* Next time the includes are taken from the cache, for conversion as
+       well */
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_COMPARE(converter->validateFile({}, "includes.vert"),
+            Containers::pair(true, Containers::String{}));
+        CORRADE_VERIFY(converter->convertFileToData({}, "includes.vert"));
+        CORRADE_COMPARE(out.str(),
+            "Loading includes.vert\n"
+            "Closing includes.vert\n"
+            "Loading includes.vert\n"
+            "Closing includes.vert\n");
+    }
+
+    /* Clearing the cache loads them again */
+    static_cast<GlslangConverter&>(*converter).clearIncludeCache();
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_COMPARE(converter->validateFile({}, "includes.vert"),
+            Containers::pair(true, Containers::String{}));
+        CORRADE_COMPARE(out.str(), uncached);
+    }
+
+    /* Setting a new callback clears the cache as well */
+    converter->setInputFileCallback(callback, files);
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_COMPARE(converter->validateFile({}, "includes.vert"),
+            Containers::pair(true, Containers::String{}));
+        CORRADE_COMPARE(out.str(), uncached);
+    }
+}
+
 void GlslangConverterTest::validateWrongInputFormat() {
     Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
 
@@ -805,6 +932,67 @@ void GlslangConverterTest::convertIncludes() {
         Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_OUTPUT_DIR, "includes.spv")));
 }
 
+void GlslangConverterTest::convertStripDebugInfo() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
+    converter->setDefinitions({
+        {"A_DEFINE", ""}
+    });
+    converter->setOutputFormat({}, "vulkan1.1");
+    converter->setDebugInfoLevel("1");
+
+    const Containers::Optional<Containers::Array<char>> data = Utility::Path::read(Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_DIR, "shader.vk.frag"));
+    CORRADE_VERIFY(data);
+
+    Containers::Optional<Containers::Array<char>> withDebugInfo = converter->convertDataToData(Stage::Fragment, *data);
+    CORRADE_VERIFY(withDebugInfo);
+
+    converter->configuration().setValue("stripDebugInfo", true);
+    Containers::Optional<Containers::Array<char>> stripped = converter->convertDataToData(Stage::Fragment, *data);
+    CORRADE_VERIFY(stripped);
+    CORRADE_COMPARE_AS(stripped->size(), withDebugInfo->size(),
+        TestSuite::Compare::Less);
+
+    /* The header stays, there are no debug instructions anymore, everything
+       else is consistent */
+    const Containers::ArrayView<const UnsignedInt> words = Containers::arrayCast<const UnsignedInt>(*stripped);
+    CORRADE_COMPARE_AS(words.size(), 5,
+        TestSuite::Compare::Greater);
+    CORRADE_COMPARE(words[0], 0x07230203);
+    std::size_t i = 5;
+    while(i < words.size()) {
+        CORRADE_ITERATION(i);
+        const UnsignedInt wordCount = words[i] >> 16;
+        const UnsignedInt opcode = words[i] & 0xffff;
+        CORRADE_VERIFY(wordCount);
+        for(UnsignedInt debugOpcode: {2, 3, 4, 5, 6, 7, 8, 317, 330})
+            CORRADE_VERIFY(opcode != debugOpcode);
+        i += wordCount;
+    }
+    CORRADE_COMPARE(i, words.size());
+}
+
+void GlslangConverterTest::convertOptimizeSize() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
+    converter->setDefinitions({
+        {"A_DEFINE", ""}
+    });
+
+    const Containers::Optional<Containers::Array<char>> data = Utility::Path::read(Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_DIR, "shader.vk.frag"));
+    CORRADE_VERIFY(data);
+
+    Containers::Optional<Containers::Array<char>> output = converter->convertDataToData(Stage::Fragment, *data);
+    CORRADE_VERIFY(output);
+
+    /* If glslang isn't built with the optimizer, this is the same size, so
+       the comparison can't be stricter */
+    converter->configuration().setValue("optimizeSize", true);
+    Containers::Optional<Containers::Array<char>> optimized = converter->convertDataToData(Stage::Fragment, *data);
+    CORRADE_VERIFY(optimized);
+    CORRADE_COMPARE_AS(optimized->size(), output->size(),
+        TestSuite::Compare::LessOrEqual);
+    CORRADE_COMPARE(Containers::arrayCast<const UnsignedInt>(*optimized)[0], 0x07230203);
+}
+
 void GlslangConverterTest::convertPreprocessOnlyNotImplemented() {
     Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
 
@@ -978,6 +1166,263 @@ void GlslangConverterTest::convertFailFileWrongStage() {
         "ERROR: 2 compilation errors.  No code generated.\n");
 }
 
+void GlslangConverterTest::convertMemoryCache() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
+    converter->configuration().setValue("memoryCache", true);
+    converter->setFlags(ConverterFlag::Verbose);
+    converter->setDefinitions({
+        {"A_DEFINE", ""}
+    });
+
+    const Containers::Optional<Containers::Array<char>> data = Utility::Path::read(Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_DIR, "shader.vk.frag"));
+    CORRADE_VERIFY(data);
+
+    /* The first conversion isn't cached yet */
+    Containers::Optional<Containers::Array<char>> output;
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        output = converter->convertDataToData(Stage::Fragment, *data);
+        CORRADE_VERIFY(output);
+        CORRADE_COMPARE(out.str(), "");
+    }
+
+    /* The second is, producing the same output */
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        Containers::Optional<Containers::Array<char>> cached = converter->convertDataToData(Stage::Fragment, *data);
+        CORRADE_VERIFY(cached);
+        CORRADE_COMPARE_AS(Containers::StringView{*cached},
+            Containers::StringView{*output},
+            TestSuite::Compare::String);
+        CORRADE_COMPARE(out.str(), "ShaderTools::GlslangConverter::convertDataToData(): using cached output from memory\n");
+    }
+
+    /* Different options result in a different cache key, even if they don't
+       affect the preprocessed source */
+    converter->setDefinitions({
+        {"A_DEFINE", ""},
+        {"ANOTHER_DEFINE", ""}
+    });
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(converter->convertDataToData(Stage::Fragment, *data));
+        CORRADE_COMPARE(out.str(), "");
+    }
+    converter->configuration().group("builtins")->setValue("maxLights", 16);
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(converter->convertDataToData(Stage::Fragment, *data));
+        CORRADE_COMPARE(out.str(), "");
+    }
+}
+
+void GlslangConverterTest::convertCacheDirectory() {
+    const Containers::String cacheDirectory = Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_OUTPUT_DIR, "cache");
+    if(Utility::Path::exists(cacheDirectory)) {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDirectories);
+        CORRADE_VERIFY(files);
+        for(const Containers::String& file: *files)
+            CORRADE_VERIFY(Utility::Path::remove(Utility::Path::join(cacheDirectory, file)));
+    }
+
+    const Containers::Optional<Containers::Array<char>> data = Utility::Path::read(Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_DIR, "shader.vk.frag"));
+    CORRADE_VERIFY(data);
+
+    /* The first conversion saves the output to the cache directory */
+    Containers::Optional<Containers::Array<char>> output;
+    {
+        Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
+        converter->configuration().setValue("cacheDirectory", cacheDirectory);
+        converter->setFlags(ConverterFlag::Verbose);
+        converter->setDefinitions({
+            {"A_DEFINE", ""}
+        });
+
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        output = converter->convertDataToData(Stage::Fragment, *data);
+        CORRADE_VERIFY(output);
+        CORRADE_COMPARE(out.str(), "");
+    }
+
+    Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDirectories);
+    CORRADE_VERIFY(files);
+    CORRADE_COMPARE(files->size(), 1);
+    CORRADE_VERIFY(files->front().hasSuffix(".spv"));
+
+    /* A new converter instance picks it up */
+    {
+        Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
+        converter->configuration().setValue("cacheDirectory", cacheDirectory);
+        converter->setFlags(ConverterFlag::Verbose);
+        converter->setDefinitions({
+            {"A_DEFINE", ""}
+        });
+
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        Containers::Optional<Containers::Array<char>> cached = converter->convertDataToData(Stage::Fragment, *data);
+        CORRADE_VERIFY(cached);
+        CORRADE_COMPARE_AS(Containers::StringView{*cached},
+            Containers::StringView{*output},
+            TestSuite::Compare::String);
+        CORRADE_COMPARE(out.str(), Utility::formatString("ShaderTools::GlslangConverter::convertDataToData(): using cached {}\n", Utility::Path::join(cacheDirectory, files->front())));
+    }
+}
+
+void GlslangConverterTest::convertBatch() {
+    auto&& data = ConvertBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
+    converter->configuration().setValue("threads", data.threads);
+
+    const Containers::Optional<Containers::Array<char>> source = Utility::Path::read(Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_DIR, "shader.vk.frag"));
+    CORRADE_VERIFY(source);
+
+    /* Reference output compiled the usual way */
+    converter->setDefinitions({
+        {"A_DEFINE", ""},
+        {"AN_UNDEFINE", "something awful!!"},
+        {"AN_UNDEFINE", nullptr}
+    });
+    const Containers::Optional<Containers::Array<char>> expected = converter->convertDataToData(Stage::Fragment, *source);
+    CORRADE_VERIFY(expected);
+
+    /* Per-input definitions get added after the global ones, so the
+       undefine overrides the global define */
+    converter->setDefinitions({
+        {"AN_UNDEFINE", "something awful!!"}
+    });
+    const Containers::Pair<Containers::StringView, Containers::StringView> definitions[]{
+        {"A_DEFINE", ""},
+        {"AN_UNDEFINE", nullptr}
+    };
+    Containers::Array<GlslangConverter::BatchInput> inputs{8};
+    for(std::size_t i = 0; i != inputs.size(); ++i) {
+        /* Alternate between explicit stage and a stage detected from the
+           filename. The filename gets embedded only in debug info, which
+           isn't enabled, so the output is the same. */
+        inputs[i].stage = i % 2 ? Stage::Unspecified : Stage::Fragment;
+        inputs[i].data = *source;
+        inputs[i].definitions = definitions;
+        inputs[i].filename = i % 2 ? "shader.frag"_s : ""_s;
+    }
+
+    Containers::Array<Containers::Optional<Containers::Array<char>>> out = static_cast<GlslangConverter&>(*converter).convertDataToDataBatch(inputs);
+    CORRADE_COMPARE(out.size(), inputs.size());
+    for(std::size_t i = 0; i != out.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(out[i]);
+        CORRADE_COMPARE_AS(Containers::StringView{*out[i]},
+            Containers::StringView{*expected},
+            TestSuite::Compare::String);
+    }
+}
+
+void GlslangConverterTest::convertBatchFail() {
+    auto&& data = ConvertBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
+    converter->configuration().setValue("threads", data.threads);
+
+    const Containers::Optional<Containers::Array<char>> source = Utility::Path::read(Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_DIR, "shader.vk.frag"));
+    CORRADE_VERIFY(source);
+
+    converter->setDefinitions({
+        {"A_DEFINE", ""}
+    });
+    /* We're interested in the first error only */
+    converter->configuration().setValue("cascadingErrors", false);
+
+    /* Same source as in convertFailWrongStage(), inputs compiled as a vertex
+       shader fail because there's no gl_FragCoord */
+    const GlslangConverter::BatchInput inputs[]{
+        {Stage::Fragment, *source, {}, "a.frag"},
+        {Stage::Vertex, *source, {}, "b.glsl"},
+        {Stage::Unspecified, *source, {}, "c.frag"},
+        {Stage::Unspecified, *source, {}, "d.vert"},
+    };
+
+    std::ostringstream out;
+    Containers::Array<Containers::Optional<Containers::Array<char>>> outputs;
+    {
+        Error redirectError{&out};
+        outputs = static_cast<GlslangConverter&>(*converter).convertDataToDataBatch(inputs);
+    }
+    CORRADE_COMPARE(outputs.size(), 4);
+    CORRADE_VERIFY(outputs[0]);
+    CORRADE_VERIFY(!outputs[1]);
+    CORRADE_VERIFY(outputs[2]);
+    CORRADE_VERIFY(!outputs[3]);
+
+    /* Errors are printed in order of the inputs, no matter which thread
+       finished first */
+    CORRADE_COMPARE(out.str(), /* Yes, trailing whitespace. Fuck me. */
+        "ShaderTools::GlslangConverter::convertDataToData(): compilation failed:\n"
+        "ERROR: b.glsl:35: 'gl_FragCoord' : undeclared identifier \n"
+        "ERROR: b.glsl:35: '' : compilation terminated \n"
+        "ERROR: 2 compilation errors.  No code generated.\n"
+        "ShaderTools::GlslangConverter::convertDataToData(): compilation failed:\n"
+        "ERROR: d.vert:35: 'gl_FragCoord' : undeclared identifier \n"
+        "ERROR: d.vert:35: '' : compilation terminated \n"
+        "ERROR: 2 compilation errors.  No code generated.\n");
+}
+
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+void GlslangConverterTest::multithreaded() {
+    #ifndef CORRADE_BUILD_MULTITHREADED
+    CORRADE_SKIP("CORRADE_BUILD_MULTITHREADED is not enabled.");
+    #endif
+
+    const Containers::Optional<Containers::Array<char>> source = Utility::Path::read(Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_DIR, "shader.vk.frag"));
+    CORRADE_VERIFY(source);
+
+    /* Unlike convertBatch(), which shares a single instance, each thread has
+       its own converter instance. Glslang process-wide state is set up just
+       once when the plugin is loaded, everything else should be either
+       per-instance or thread-local. */
+    Containers::Pointer<AbstractConverter> converters[4];
+    for(Containers::Pointer<AbstractConverter>& converter: converters) {
+        converter = _converterManager.instantiate("GlslangShaderConverter");
+        converter->setDefinitions({
+            {"A_DEFINE", ""}
+        });
+    }
+
+    /* Reference output compiled on the main thread */
+    const Containers::Optional<Containers::Array<char>> expected = converters[0]->convertDataToData(Stage::Fragment, *source);
+    CORRADE_VERIFY(expected);
+
+    int counters[Containers::arraySize(converters)]{};
+    {
+        auto fn = [&](AbstractConverter& converter, int& counter) {
+            for(std::size_t i = 0; i != 25; ++i) {
+                Containers::Optional<Containers::Array<char>> output = converter.convertDataToData(Stage::Fragment, *source);
+                if(output && Containers::StringView{*output} == Containers::StringView{*expected})
+                    ++counter;
+            }
+        };
+
+        std::thread threads[Containers::arraySize(converters)];
+        for(std::size_t i = 0; i != Containers::arraySize(threads); ++i)
+            threads[i] = std::thread{fn, std::ref(*converters[i]), std::ref(counters[i])};
+        for(std::thread& thread: threads)
+            thread.join();
+    }
+
+    for(std::size_t i = 0; i != Containers::arraySize(counters); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(counters[i], 25);
+    }
+}
+#endif
+
 void GlslangConverterTest::vulkanNoExplicitLayout() {
     auto&& data = VulkanNoExplicitLayoutData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -27,8 +27,11 @@
 
 #include "GltfImporter.h"
 
-#include <algorithm> /* std::stable_sort() */
+#include <algorithm> /* std::stable_sort(), std::sort(), std::binary_search() */
 #include <cctype>
+#include <cstdlib> /* std::strtoul() */
+#include <cstring> /* std::memcmp(), std::memcpy() */
+#include <thread>
 #include <unordered_map>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayTuple.h>
@@ -36,6 +39,7 @@
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Containers/Reference.h>
 #include <Corrade/Containers/StaticArray.h>
 #include <Corrade/Containers/StridedBitArrayView.h>
@@ -57,7 +61,9 @@
 #include <Magnum/Math/FunctionsBatch.h>
 #include <Magnum/Math/Matrix3.h>
 #include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/PackingBatch.h>
 #include <Magnum/Math/Quaternion.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
 #include <Magnum/Trade/AnimationData.h>
 #include <Magnum/Trade/CameraData.h>
 #include <Magnum/Trade/ImageData.h>
@@ -69,15 +75,28 @@
 #include <Magnum/Trade/TextureData.h>
 #include <MagnumPlugins/AnyImageImporter/AnyImageImporter.h>
 
+#include "Magnum/Implementation/imageImporterPool.h"
+#include "Magnum/Implementation/instrumentation.h"
+#include "Magnum/Implementation/meshConverter.h"
+#include "Magnum/Implementation/outputAllocator.h"
+#include "Magnum/Implementation/profilingZone.h"
 #include "MagnumPlugins/GltfImporter/decode.h"
 #include "MagnumPlugins/GltfImporter/Gltf.h"
 
+#ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+#include <draco/compression/decode.h>
+#endif
+
 /* Otherwise std::unique() fails to compile on MSVC 2015 and libc++ 15 (commit
    https://github.com/llvm/llvm-project/commit/c9905b8cb0139f410ce63081989a328559e11374) */
 #if defined(CORRADE_MSVC2015_COMPATIBILITY) || (defined(CORRADE_TARGET_LIBCXX) && _LIBCPP_VERSION >= 15)
 #include <Corrade/Containers/StridedArrayViewStl.h>
 #endif
 
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <atomic>
+#endif
+
 /* We'd have to endian-flip everything that comes from buffers, plus the binary
    glTF headers, etc. Too much work, hard to automatically test because the
    HW is hard to get. */
@@ -130,6 +149,13 @@ bool isBuiltinMeshAttribute(Utility::ConfigurationGroup& configuration, const Co
 
 }
 
+/* File data and tokens kept after close with cacheJsonTokens enabled */
+struct GltfImporter::JsonCache {
+    Containers::String filename;
+    Containers::Array<char> fileData;
+    Containers::Optional<Utility::Json> gltf;
+};
+
 struct GltfImporter::Document {
     /* Set only if fromFile() was used, passed to Utility::Json for nicer error
        messages and used as a base path for buffer and image opening */
@@ -140,6 +166,13 @@ struct GltfImporter::Document {
     Containers::Array<char> fileData;
     Containers::Optional<Utility::Json> gltf;
     Containers::Optional<Containers::ArrayView<const char>> binChunk;
+    /* Set if the file is a GLB that's not fully loaded yet with
+       allowPartialGlb enabled, in which case the BIN chunk may be shorter
+       than the buffer it's for */
+    bool binChunkPartial = false;
+    /* Whether the file data and tokens can be kept in the cache after close,
+       which isn't the case for externally owned data */
+    bool fileDataCacheable;
 
     /* Constant-time access to glTF data and their names. All these are checked
        to be object tokens during the initial import. Buffers, buffer views,
@@ -169,10 +202,41 @@ struct GltfImporter::Document {
        stay a NullOpt, meaning the same failure message will be printed next
        time it's accessed. */
     Containers::Array<Containers::Optional<Containers::Array<char>>> buffers;
+    /* Memory-mapped external buffer files, if the mapExternalBuffers option
+       is enabled. The corresponding entries in `buffers` are non-owning views
+       on these. */
+    #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    Containers::Array<Containers::Array<const char, Utility::Path::MapDeleter>> mappedBuffers;
+    #endif
+    /* Data of buffer views compressed with EXT_meshopt_compression, decoded
+       into storage sized and indexed the same as the fallback buffer they
+       reference. Allocated on demand, zero-initialized as not all of it may
+       get filled. */
+    Containers::Array<Containers::Optional<Containers::Array<char>>> meshoptDecodedBuffers;
+    #ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+    /* Mesh primitives compressed with KHR_draco_mesh_compression, decoded on
+       first access. Indexed the same as gltfMeshPrimitiveMap. The data
+       contain decoded vertex attributes one after another, each aligned to
+       four bytes, then copies of the primitive attributes and morph targets
+       that are stored uncompressed in regular accessors, so the whole mesh
+       is in a single allocation, followed by the index data. The attribute
+       views are paired with IDs of the accessors that describe them. */
+    struct DracoPrimitive {
+        Containers::Array<char> data;
+        Containers::ArrayView<const char> vertexData;
+        Containers::Array<Containers::Triple<UnsignedInt, Containers::StridedArrayView2D<const char>, VertexFormat>> attributes;
+        Containers::StridedArrayView2D<const char> indices;
+        VertexFormat indexFormat;
+    };
+    Containers::Array<Containers::Optional<DracoPrimitive>> dracoPrimitives;
+    #endif
     /* Parsed and validated buffer views, second element is stride (or 0 if not
-       strided), third is buffer ID. Same as with buffers, if any of these
-       failed to validate, it'll stay a NullOpt, meaning the same failure
-       message will be printed next time it's accessed. */
+       strided), third is buffer ID. For buffer views decoded from
+       EXT_meshopt_compression it's the fallback buffer ID offset by the buffer
+       count, so it doesn't clash with buffers that aren't compressed. Same as
+       with buffers, if any of these failed to validate, it'll stay a NullOpt,
+       meaning the same failure message will be printed next time it's
+       accessed. */
     Containers::Array<Containers::Optional<Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt>>> bufferViews;
     /* Parsed and validated buffer views, second element is the parsed type,
        third is buffer view ID. As the type is known, it's always a 2D view
@@ -252,6 +316,11 @@ struct GltfImporter::Document {
        STL guarantees iterator stability, i.e. the strings don't get moved
        anywhere even with SSO */
     Containers::Array<Containers::Triple<Containers::StringView, SceneFieldType, SceneFieldFlags>> sceneFieldNamesTypesFlags;
+    /* Index of the first of the three consecutive custom scene fields for
+       EXT_mesh_gpu_instancing translation, rotation and scaling in
+       sceneFieldNamesTypesFlags, or ~UnsignedInt{} if the extension isn't
+       used */
+    UnsignedInt meshGpuInstancingFieldOffset = ~UnsignedInt{};
     Containers::Array<Containers::StringView> meshAttributeNames{InPlaceInit, {
         #ifdef MAGNUM_BUILD_DEPRECATED
         "JOINTS"_s,
@@ -281,8 +350,43 @@ struct GltfImporter::Document {
        implicitly as we can't perform Y-flip directly on the data. */
     bool textureCoordinateYFlipInMaterial = false;
 
-    UnsignedInt imageImporterId = ~UnsignedInt{};
-    Containers::Optional<AnyImageImporter> imageImporter;
+    /* Opened image importers, reused if the same image is accessed again.
+       Sized according to the imageImporterCacheSize option, if all are used
+       the least recently used one is replaced. If opening an image failed,
+       the importer is not set but the ID is, meaning the failure isn't
+       attempted again until the slot gets replaced. */
+    struct ImageImporter {
+        UnsignedInt id = ~UnsignedInt{};
+        std::size_t lastUsed = 0;
+        Containers::Optional<AnyImageImporter> importer;
+        /* Set if the importer was opened from a file and the
+           imageImporterPoolSize option was non-zero at that point, in which
+           case it's put back into the shared pool once replaced */
+        Containers::String filename;
+    };
+    Containers::Array<ImageImporter> imageImporters;
+    std::size_t imageImporterUseCounter = 0;
+    /* Whether the openImagesOnOpen option was enabled on open */
+    bool openImagesOnOpen = false;
+
+    /* Textures and materials imported so far, indexed by the IDs reported to
+       the user. Allocated only if the cacheTexturesAndMaterials option is
+       enabled on open, empty otherwise. Failed imports are not cached. */
+    Containers::Array<Containers::Optional<TextureData>> textureCache;
+    Containers::Array<Containers::Optional<MaterialData>> materialCache;
+
+    /* Joint IDs and inverse bind matrices of skins imported so far, indexed
+       by skin ID. Allocated only if the zeroCopySkins option is enabled on
+       open, empty otherwise. The views point either to skinData, which is a
+       single allocation per skin, or to buffer memory in case of inverse
+       bind matrices that can be referenced directly. Failed imports are not
+       cached. */
+    Containers::Array<Containers::Optional<Containers::Pair<Containers::ArrayView<const UnsignedInt>, Containers::ArrayView<const Matrix4>>>> skins;
+    Containers::Array<Containers::Array<char>> skinData;
+
+    /* Scene converter applied to imported meshes if the meshConverter option
+       is set, instantiated on first use */
+    Containers::Pointer<AbstractSceneConverter> meshConverter;
 };
 
 Containers::Optional<Containers::Array<char>> GltfImporter::loadUri(const char* const errorPrefix, const Containers::StringView uri) {
@@ -328,6 +432,21 @@ Containers::Optional<Containers::Array<char>> GltfImporter::loadUri(const char*
 
         const Containers::String fullPath = Utility::Path::join(Utility::Path::split(*_d->filename).first(), *decodedUri);
 
+        /* If mapping is enabled, keep the mapped memory in a dedicated array
+           and return a non-owning view, same as with the file callback */
+        #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+        if(configuration().value<bool>("mapExternalBuffers")) {
+            Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> mapped = Utility::Path::mapRead(fullPath);
+            if(!mapped) {
+                Error{} << errorPrefix << "error opening" << fullPath;
+                return {};
+            }
+
+            Containers::Array<const char, Utility::Path::MapDeleter>& out = arrayAppend(_d->mappedBuffers, Utility::move(*mapped));
+            return Containers::Array<char>{const_cast<char*>(out.data()), out.size(), [](char*, std::size_t){}};
+        }
+        #endif
+
         if(Containers::Optional<Containers::Array<char>> data = Utility::Path::read(fullPath))
             return data;
 
@@ -357,6 +476,7 @@ Containers::Optional<Containers::ArrayView<const char>> GltfImporter::parseBuffe
     }
 
     Containers::ArrayView<const char> view;
+    bool partial = false;
     if(const Utility::JsonToken* gltfBufferUri = gltfBuffer.find("uri"_s)) {
         if(!_d->gltf->parseString(*gltfBufferUri)) {
             Error{} << errorPrefix << "buffer" << bufferId << "has invalid uri property";
@@ -376,13 +496,18 @@ Containers::Optional<Containers::ArrayView<const char>> GltfImporter::parseBuffe
                 Error{} << errorPrefix << "buffer" << bufferId << "has missing uri property";
                 return {};
             }
-        } else view = *_d->binChunk;
+        } else {
+            view = *_d->binChunk;
+            partial = _d->binChunkPartial;
+        }
     }
 
     /* The spec mentions that non-GLB buffer length can be greater than
        byteLength. GLB buffer chunks may also be up to 3 bytes larger than
-       byteLength because of padding. So we can't check for equality. */
-    if(view.size() < gltfBufferByteLength->asSize()) {
+       byteLength because of padding. So we can't check for equality. If the
+       GLB isn't fully loaded yet, the BIN chunk can be shorter and the range
+       of each buffer view is checked instead. */
+    if(view.size() < gltfBufferByteLength->asSize() && !partial) {
         Error{} << errorPrefix << "buffer" << bufferId << "is too short, expected"
             << gltfBufferByteLength->asSize() << "bytes but got" << view.size();
         return {};
@@ -409,10 +534,48 @@ Containers::Optional<Containers::Triple<Containers::ArrayView<const char>, Unsig
         return {};
     }
 
+    /* If the view is compressed with EXT_meshopt_compression, the buffer it
+       references is just a fallback that may not even have any data.
+       Data get decoded into a storage of the same size instead. */
+    const Utility::JsonToken* gltfMeshoptCompression = nullptr;
+    if(const Utility::JsonToken* const gltfExtensions = gltfBufferView.find("extensions"_s)) {
+        if(!_d->gltf->parseObject(*gltfExtensions)) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has invalid extensions property";
+            return {};
+        }
+        gltfMeshoptCompression = gltfExtensions->find("EXT_meshopt_compression"_s);
+    }
+
     /* Get the buffer early and continue only if that doesn't fail. This also
        checks that the buffer ID is in bounds. */
-    Containers::Optional<Containers::ArrayView<const char>> buffer = parseBuffer(errorPrefix, gltfBufferId->asUnsignedInt());
-    if(!buffer) return {};
+    Containers::Optional<Containers::ArrayView<const char>> buffer;
+    Containers::ArrayView<char> decodedBuffer;
+    if(gltfMeshoptCompression) {
+        const UnsignedInt bufferId = gltfBufferId->asUnsignedInt();
+        if(bufferId >= _d->gltfBuffers.size()) {
+            Error{} << errorPrefix << "buffer index" << bufferId << "out of range for" << _d->gltfBuffers.size() << "buffers";
+            return {};
+        }
+
+        Containers::Optional<Containers::Array<char>>& decodedStorage = _d->meshoptDecodedBuffers[bufferId];
+        if(!decodedStorage) {
+            const Utility::JsonToken& gltfBuffer = _d->gltfBuffers[bufferId];
+            const Utility::JsonToken* const gltfBufferByteLength = gltfBuffer.find("byteLength"_s);
+            if(!gltfBufferByteLength || !_d->gltf->parseSize(*gltfBufferByteLength)) {
+                Error{} << errorPrefix << "buffer" << bufferId
+                    << "has missing or invalid byteLength property";
+                return {};
+            }
+
+            decodedStorage.emplace(ValueInit, gltfBufferByteLength->asSize());
+        }
+
+        decodedBuffer = *decodedStorage;
+        buffer = Containers::ArrayView<const char>{decodedBuffer};
+    } else {
+        buffer = parseBuffer(errorPrefix, gltfBufferId->asUnsignedInt());
+        if(!buffer) return {};
+    }
 
     /* Byte offset is optional, defaulting to 0 */
     const Utility::JsonToken* const gltfByteOffset = gltfBufferView.find("byteOffset"_s);
@@ -443,57 +606,154 @@ Containers::Optional<Containers::Triple<Containers::ArrayView<const char>, Unsig
         return {};
     }
 
+    if(gltfMeshoptCompression && !decodeMeshoptBufferView(errorPrefix, bufferViewId, *gltfMeshoptCompression, decodedBuffer.slice(offset, offset + gltfByteLength->asSize())))
+        return {};
+
     /* If the buffer isn't strided, the first dimension has a zero stride and
        the second is the whole view */
     storage.emplace(
         buffer->slice(offset, offset + gltfByteLength->asSize()),
         gltfByteStride ? gltfByteStride->asUnsignedInt() : 0,
-        gltfBufferId->asUnsignedInt());
+        gltfBufferId->asUnsignedInt() + (gltfMeshoptCompression ? UnsignedInt(_d->gltfBuffers.size()) : 0));
 
     return storage;
 }
 
-Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> GltfImporter::parseAccessor(const char* const errorPrefix, const UnsignedInt accessorId) {
-    if(accessorId >= _d->gltfAccessors.size()) {
-        Error{} << errorPrefix << "accessor index" << accessorId << "out of range for" << _d->gltfAccessors.size() << "accessors";
-        return {};
+bool GltfImporter::decodeMeshoptBufferView(const char* const errorPrefix, const UnsignedInt bufferViewId, const Utility::JsonToken& gltfMeshoptCompression, const Containers::ArrayView<char> out) {
+    if(!_d->gltf->parseObject(gltfMeshoptCompression)) {
+        Error{} << errorPrefix << "buffer view" << bufferViewId << "has invalid EXT_meshopt_compression extension";
+        return false;
     }
 
-    /* Return if the buffer view is already parsed */
-    Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>>& storage = _d->accessors[accessorId];
-    if(storage) return storage;
+    const Utility::JsonToken* const gltfBufferId = gltfMeshoptCompression.find("buffer"_s);
+    if(!gltfBufferId || !_d->gltf->parseUnsignedInt(*gltfBufferId)) {
+        Error{} << errorPrefix << "buffer view" << bufferViewId << "has missing or invalid EXT_meshopt_compression buffer property";
+        return false;
+    }
 
-    const Utility::JsonToken& gltfAccessor = _d->gltfAccessors[accessorId];
+    /* Byte offset is optional, defaulting to 0 */
+    const Utility::JsonToken* const gltfByteOffset = gltfMeshoptCompression.find("byteOffset"_s);
+    if(gltfByteOffset && !_d->gltf->parseSize(*gltfByteOffset)) {
+        Error{} << errorPrefix << "buffer view" << bufferViewId << "has invalid EXT_meshopt_compression byteOffset property";
+        return false;
+    }
 
-    /** @todo Validate alignment rules, calculate correct stride in accessorView():
-        https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#data-alignment */
+    const Utility::JsonToken* const gltfByteLength = gltfMeshoptCompression.find("byteLength"_s);
+    if(!gltfByteLength || !_d->gltf->parseSize(*gltfByteLength)) {
+        Error{} << errorPrefix << "buffer view" << bufferViewId << "has missing or invalid EXT_meshopt_compression byteLength property";
+        return false;
+    }
 
-    if(gltfAccessor.find("sparse"_s)) {
-        Error{} << errorPrefix << "accessor" << accessorId << "is using sparse storage, which is unsupported";
-        return {};
+    const Utility::JsonToken* const gltfByteStride = gltfMeshoptCompression.find("byteStride"_s);
+    if(!gltfByteStride || !_d->gltf->parseUnsignedInt(*gltfByteStride)) {
+        Error{} << errorPrefix << "buffer view" << bufferViewId << "has missing or invalid EXT_meshopt_compression byteStride property";
+        return false;
     }
 
-    /* Buffer views are optional in accessors, we're supposed to fill the view
-       with zeros. Only makes sense with sparse data and we don't support
-       that, so we require the bufferViewId to be present. */
-    const Utility::JsonToken* const gltfBufferViewId = gltfAccessor.find("bufferView"_s);
-    if(!gltfBufferViewId || !_d->gltf->parseUnsignedInt(*gltfBufferViewId)) {
-        Error{} << errorPrefix << "accessor" << accessorId << "has missing or invalid bufferView property";
-        return {};
+    const Utility::JsonToken* const gltfCount = gltfMeshoptCompression.find("count"_s);
+    if(!gltfCount || !_d->gltf->parseSize(*gltfCount)) {
+        Error{} << errorPrefix << "buffer view" << bufferViewId << "has missing or invalid EXT_meshopt_compression count property";
+        return false;
     }
 
-    /* Get the buffer view early and continue only if that doesn't fail. This
-       also checks that the buffer view ID is in bounds. */
-    Containers::Optional<Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt>> bufferView = parseBufferView(errorPrefix, gltfBufferViewId->asUnsignedInt());
-    if(!bufferView) return {};
+    const Utility::JsonToken* const gltfMode = gltfMeshoptCompression.find("mode"_s);
+    if(!gltfMode || !_d->gltf->parseString(*gltfMode)) {
+        Error{} << errorPrefix << "buffer view" << bufferViewId << "has missing or invalid EXT_meshopt_compression mode property";
+        return false;
+    }
 
-    /* Byte offset is optional, defaulting to 0 */
-    const Utility::JsonToken* const gltfAccessorByteOffset = gltfAccessor.find("byteOffset"_s);
-    if(gltfAccessorByteOffset && !_d->gltf->parseSize(*gltfAccessorByteOffset)) {
-        Error{} << errorPrefix << "accessor" << accessorId << "has invalid byteOffset property";
-        return {};
+    /* Filter is optional, defaulting to NONE */
+    const Utility::JsonToken* const gltfFilter = gltfMeshoptCompression.find("filter"_s);
+    if(gltfFilter && !_d->gltf->parseString(*gltfFilter)) {
+        Error{} << errorPrefix << "buffer view" << bufferViewId << "has invalid EXT_meshopt_compression filter property";
+        return false;
+    }
+
+    const std::size_t count = gltfCount->asSize();
+    const std::size_t stride = gltfByteStride->asUnsignedInt();
+    if(count*stride > out.size()) {
+        Error{} << errorPrefix << "buffer view" << bufferViewId << "has" << out.size() << "bytes but EXT_meshopt_compression needs" << count*stride << "bytes for" << count << "elements of stride" << stride;
+        return false;
+    }
+
+    /* Unlike with the fallback buffer, the compressed data has to be there */
+    const Containers::Optional<Containers::ArrayView<const char>> buffer = parseBuffer(errorPrefix, gltfBufferId->asUnsignedInt());
+    if(!buffer) return false;
+
+    const std::size_t offset = gltfByteOffset ? gltfByteOffset->asSize() : 0;
+    const std::size_t requiredBufferSize = offset + gltfByteLength->asSize();
+    if(buffer->size() < requiredBufferSize) {
+        Error{} << errorPrefix << "buffer view" << bufferViewId << "EXT_meshopt_compression needs" << requiredBufferSize << "bytes but buffer" << gltfBufferId->asUnsignedInt() << "has only" << buffer->size();
+        return false;
     }
 
+    const Containers::ArrayView<const char> in = buffer->slice(offset, requiredBufferSize);
+    const Containers::ArrayView<char> decoded = out.prefix(count*stride);
+    const Containers::StringView mode = gltfMode->asString();
+    const Containers::StringView filter = gltfFilter ? gltfFilter->asString() : "NONE"_s;
+    if(mode == "ATTRIBUTES"_s) {
+        if(stride % 4 || stride > 256) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has unsupported EXT_meshopt_compression byteStride" << stride << "for ATTRIBUTES mode, expected a multiple of 4 not larger than 256";
+            return false;
+        }
+
+        /* Check the filter first to not need to decode anything if it's
+           wrong */
+        if(filter != "NONE"_s && filter != "OCTAHEDRAL"_s && filter != "QUATERNION"_s && filter != "EXPONENTIAL"_s) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has unrecognized EXT_meshopt_compression filter" << filter;
+            return false;
+        }
+        if((filter == "OCTAHEDRAL"_s && stride != 4 && stride != 8) ||
+           (filter == "QUATERNION"_s && stride != 8)) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has unsupported EXT_meshopt_compression byteStride" << stride << "for" << filter << "filter";
+            return false;
+        }
+
+        if(!decodeMeshoptAttributes(errorPrefix, in, decoded, count, stride))
+            return false;
+
+        if(filter == "OCTAHEDRAL"_s) {
+            if(stride == 4)
+                meshoptFilterOctahedral<Byte>(decoded);
+            else
+                meshoptFilterOctahedral<Short>(decoded);
+        } else if(filter == "QUATERNION"_s)
+            meshoptFilterQuaternion(decoded);
+        else if(filter == "EXPONENTIAL"_s)
+            meshoptFilterExponential(decoded);
+
+    } else if(mode == "TRIANGLES"_s || mode == "INDICES"_s) {
+        if(stride != 2 && stride != 4) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has unsupported EXT_meshopt_compression byteStride" << stride << "for" << mode << "mode, expected 2 or 4";
+            return false;
+        }
+        if(filter != "NONE"_s) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has unsupported EXT_meshopt_compression filter" << filter << "for" << mode;
+            return false;
+        }
+
+        if(mode == "TRIANGLES"_s) {
+            if(count % 3) {
+                Error{} << errorPrefix << "buffer view" << bufferViewId << "has EXT_meshopt_compression count" << count << "not divisible by 3 for TRIANGLES mode";
+                return false;
+            }
+
+            if(!decodeMeshoptTriangles(errorPrefix, in, decoded, count, stride))
+                return false;
+        } else if(!decodeMeshoptIndices(errorPrefix, in, decoded, count, stride))
+            return false;
+
+    } else {
+        Error{} << errorPrefix << "buffer view" << bufferViewId << "has unrecognized EXT_meshopt_compression mode" << mode;
+        return false;
+    }
+
+    return true;
+}
+
+Containers::Optional<Containers::Pair<VertexFormat, std::size_t>> GltfImporter::parseAccessorFormat(const char* const errorPrefix, const UnsignedInt accessorId) {
+    const Utility::JsonToken& gltfAccessor = _d->gltfAccessors[accessorId];
+
     const Utility::JsonToken* const gltfAccessorComponentType = gltfAccessor.find("componentType"_s);
     if(!gltfAccessorComponentType || !_d->gltf->parseUnsignedInt(*gltfAccessorComponentType)) {
         Error{} << errorPrefix << "accessor" << accessorId << "has missing or invalid componentType property";
@@ -598,6 +858,55 @@ Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const cha
     else
         format = vertexFormat(componentFormat, vectorCount, componentCount, true);
 
+    return {InPlaceInit, format, gltfAccessorCount->asSize()};
+}
+
+Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> GltfImporter::parseAccessor(const char* const errorPrefix, const UnsignedInt accessorId) {
+    if(accessorId >= _d->gltfAccessors.size()) {
+        Error{} << errorPrefix << "accessor index" << accessorId << "out of range for" << _d->gltfAccessors.size() << "accessors";
+        return {};
+    }
+
+    /* Return if the buffer view is already parsed */
+    Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>>& storage = _d->accessors[accessorId];
+    if(storage) return storage;
+
+    const Utility::JsonToken& gltfAccessor = _d->gltfAccessors[accessorId];
+
+    /** @todo Validate alignment rules, calculate correct stride in accessorView():
+        https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#data-alignment */
+
+    if(gltfAccessor.find("sparse"_s)) {
+        Error{} << errorPrefix << "accessor" << accessorId << "is using sparse storage, which is unsupported";
+        return {};
+    }
+
+    /* Buffer views are optional in accessors, we're supposed to fill the view
+       with zeros. Only makes sense with sparse data and we don't support
+       that, so we require the bufferViewId to be present. */
+    const Utility::JsonToken* const gltfBufferViewId = gltfAccessor.find("bufferView"_s);
+    if(!gltfBufferViewId || !_d->gltf->parseUnsignedInt(*gltfBufferViewId)) {
+        Error{} << errorPrefix << "accessor" << accessorId << "has missing or invalid bufferView property";
+        return {};
+    }
+
+    /* Get the buffer view early and continue only if that doesn't fail. This
+       also checks that the buffer view ID is in bounds. */
+    Containers::Optional<Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt>> bufferView = parseBufferView(errorPrefix, gltfBufferViewId->asUnsignedInt());
+    if(!bufferView) return {};
+
+    /* Byte offset is optional, defaulting to 0 */
+    const Utility::JsonToken* const gltfAccessorByteOffset = gltfAccessor.find("byteOffset"_s);
+    if(gltfAccessorByteOffset && !_d->gltf->parseSize(*gltfAccessorByteOffset)) {
+        Error{} << errorPrefix << "accessor" << accessorId << "has invalid byteOffset property";
+        return {};
+    }
+
+    const Containers::Optional<Containers::Pair<VertexFormat, std::size_t>> formatCount = parseAccessorFormat(errorPrefix, accessorId);
+    if(!formatCount) return {};
+    const VertexFormat format = formatCount->first();
+    const std::size_t count = formatCount->second();
+
     const std::size_t typeSize = vertexFormatSize(format);
     if(bufferView->second() && bufferView->second() < typeSize) {
         Error{} << errorPrefix << typeSize << Debug::nospace << "-byte type defined by accessor" << accessorId << "can't fit into buffer view" << gltfBufferViewId->asUnsignedInt() << "stride of" << bufferView->second();
@@ -606,7 +915,7 @@ Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const cha
 
     const std::size_t offset = gltfAccessorByteOffset ? gltfAccessorByteOffset->asSize() : 0;
     const std::size_t stride = bufferView->second() ? bufferView->second() : typeSize;
-    const std::size_t requiredBufferViewSize = offset + stride*(gltfAccessorCount->asSize() - 1) + typeSize;
+    const std::size_t requiredBufferViewSize = offset + stride*(count - 1) + typeSize;
     if(bufferView->first().size() < requiredBufferViewSize) {
         Error{} << errorPrefix << "accessor" << accessorId << "needs" << requiredBufferViewSize << "bytes but buffer view" << gltfBufferViewId->asUnsignedInt() << "has only" << bufferView->first().size();
         return {};
@@ -626,7 +935,7 @@ Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const cha
             remainder (once there's StridedArrayView::shift() or some such) */
         Containers::StridedArrayView2D<const char>{{bufferView->first(), bufferView->first().size() + stride},
             static_cast<const char*>(bufferView->first().data()) + offset,
-            {gltfAccessorCount->asSize(), typeSize},
+            {count, typeSize},
             {std::ptrdiff_t(stride), 1}},
         format,
         gltfBufferViewId->asUnsignedInt());
@@ -634,6 +943,380 @@ Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const cha
     return storage;
 }
 
+struct GltfImporter::SparseAccessor {
+    VertexFormat format;
+    std::size_t count;
+    /* Base values, empty if the accessor has no buffer view, in which case
+       the base values are all zeros */
+    Containers::StridedArrayView2D<const char> base;
+    /* Indices expanded to 32-bit and checked to be in bounds */
+    Containers::Array<UnsignedInt> indices;
+    Containers::StridedArrayView2D<const char> values;
+};
+
+Containers::Optional<GltfImporter::SparseAccessor> GltfImporter::parseSparseAccessor(const char* const errorPrefix, const UnsignedInt accessorId) {
+    if(accessorId >= _d->gltfAccessors.size()) {
+        Error{} << errorPrefix << "accessor index" << accessorId << "out of range for" << _d->gltfAccessors.size() << "accessors";
+        return {};
+    }
+
+    const Utility::JsonToken& gltfAccessor = _d->gltfAccessors[accessorId];
+
+    /* Forms a view on a buffer view referenced from the accessor itself or
+       from the sparse indices and values objects. The prefix is used to
+       print the property path in error messages. */
+    const auto view = [&](const Utility::JsonToken& gltfObject, const Containers::StringView propertyPrefix, const std::size_t count, const std::size_t typeSize) -> Containers::Optional<Containers::StridedArrayView2D<const char>> {
+        const Utility::JsonToken* const gltfBufferViewId = gltfObject.find("bufferView"_s);
+        if(!gltfBufferViewId || !_d->gltf->parseUnsignedInt(*gltfBufferViewId)) {
+            Error{} << errorPrefix << "accessor" << accessorId << "has missing or invalid" << propertyPrefix << Debug::nospace << "bufferView property";
+            return {};
+        }
+
+        const Containers::Optional<Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt>> bufferView = parseBufferView(errorPrefix, gltfBufferViewId->asUnsignedInt());
+        if(!bufferView) return {};
+
+        const Utility::JsonToken* const gltfByteOffset = gltfObject.find("byteOffset"_s);
+        if(gltfByteOffset && !_d->gltf->parseSize(*gltfByteOffset)) {
+            Error{} << errorPrefix << "accessor" << accessorId << "has invalid" << propertyPrefix << Debug::nospace << "byteOffset property";
+            return {};
+        }
+
+        const std::size_t offset = gltfByteOffset ? gltfByteOffset->asSize() : 0;
+        const std::size_t stride = bufferView->second() ? bufferView->second() : typeSize;
+        const std::size_t requiredBufferViewSize = offset + stride*(count - 1) + typeSize;
+        if(bufferView->second() && bufferView->second() < typeSize) {
+            Error{} << errorPrefix << typeSize << Debug::nospace << "-byte type defined by accessor" << accessorId << propertyPrefix << Debug::nospace << "bufferView can't fit into buffer view" << gltfBufferViewId->asUnsignedInt() << "stride of" << bufferView->second();
+            return {};
+        }
+        if(bufferView->first().size() < requiredBufferViewSize) {
+            Error{} << errorPrefix << "accessor" << accessorId << propertyPrefix << Debug::nospace << "bufferView needs" << requiredBufferViewSize << "bytes but buffer view" << gltfBufferViewId->asUnsignedInt() << "has only" << bufferView->first().size();
+            return {};
+        }
+
+        /* Overextending the size by a stride like in parseAccessor() */
+        return Containers::StridedArrayView2D<const char>{{bufferView->first(), bufferView->first().size() + stride},
+            static_cast<const char*>(bufferView->first().data()) + offset,
+            {count, typeSize},
+            {std::ptrdiff_t(stride), 1}};
+    };
+
+    const Containers::Optional<Containers::Pair<VertexFormat, std::size_t>> formatCount = parseAccessorFormat(errorPrefix, accessorId);
+    if(!formatCount) return {};
+
+    SparseAccessor out;
+    out.format = formatCount->first();
+    out.count = formatCount->second();
+    const std::size_t typeSize = vertexFormatSize(out.format);
+
+    /* The buffer view is optional for sparse accessors */
+    if(gltfAccessor.find("bufferView"_s)) {
+        Containers::Optional<Containers::StridedArrayView2D<const char>> base = view(gltfAccessor, ""_s, out.count, typeSize);
+        if(!base) return {};
+        out.base = *base;
+    }
+
+    const Utility::JsonToken* const gltfSparse = gltfAccessor.find("sparse"_s);
+    CORRADE_INTERNAL_ASSERT(gltfSparse);
+    if(!_d->gltf->parseObject(*gltfSparse)) {
+        Error{} << errorPrefix << "accessor" << accessorId << "has invalid sparse property";
+        return {};
+    }
+
+    /* 3.6.2.3 (Binary Data Storage § Accessors § Sparse Accessors) says
+       the count MUST be greater than or equal to 1 */
+    const Utility::JsonToken* const gltfSparseCount = gltfSparse->find("count"_s);
+    if(!gltfSparseCount || !_d->gltf->parseSize(*gltfSparseCount) || !gltfSparseCount->asSize() || gltfSparseCount->asSize() > out.count) {
+        Error{} << errorPrefix << "accessor" << accessorId << "has missing or invalid sparse.count property";
+        return {};
+    }
+    const std::size_t sparseCount = gltfSparseCount->asSize();
+
+    const Utility::JsonToken* const gltfSparseIndices = gltfSparse->find("indices"_s);
+    if(!gltfSparseIndices || !_d->gltf->parseObject(*gltfSparseIndices)) {
+        Error{} << errorPrefix << "accessor" << accessorId << "has missing or invalid sparse.indices property";
+        return {};
+    }
+    const Utility::JsonToken* const gltfSparseIndicesComponentType = gltfSparseIndices->find("componentType"_s);
+    if(!gltfSparseIndicesComponentType || !_d->gltf->parseUnsignedInt(*gltfSparseIndicesComponentType)) {
+        Error{} << errorPrefix << "accessor" << accessorId << "has missing or invalid sparse.indices.componentType property";
+        return {};
+    }
+    std::size_t indexSize;
+    switch(gltfSparseIndicesComponentType->asUnsignedInt()) {
+        case Implementation::GltfTypeUnsignedByte:
+            indexSize = 1;
+            break;
+        case Implementation::GltfTypeUnsignedShort:
+            indexSize = 2;
+            break;
+        case Implementation::GltfTypeUnsignedInt:
+            indexSize = 4;
+            break;
+        default:
+            Error{} << errorPrefix << "accessor" << accessorId << "has invalid sparse.indices.componentType" << gltfSparseIndicesComponentType->asUnsignedInt();
+            return {};
+    }
+    const Containers::Optional<Containers::StridedArrayView2D<const char>> indices = view(*gltfSparseIndices, "sparse.indices."_s, sparseCount, indexSize);
+    if(!indices) return {};
+
+    const Utility::JsonToken* const gltfSparseValues = gltfSparse->find("values"_s);
+    if(!gltfSparseValues || !_d->gltf->parseObject(*gltfSparseValues)) {
+        Error{} << errorPrefix << "accessor" << accessorId << "has missing or invalid sparse.values property";
+        return {};
+    }
+    const Containers::Optional<Containers::StridedArrayView2D<const char>> values = view(*gltfSparseValues, "sparse.values."_s, sparseCount, typeSize);
+    if(!values) return {};
+    out.values = *values;
+
+    /* Expand the indices and check they're in bounds so the consumers don't
+       need to */
+    out.indices = Containers::Array<UnsignedInt>{NoInit, sparseCount};
+    for(std::size_t i = 0; i != sparseCount; ++i) {
+        const char* const index = &(*indices)[i][0];
+        if(indexSize == 1)
+            out.indices[i] = *reinterpret_cast<const UnsignedByte*>(index);
+        else if(indexSize == 2)
+            out.indices[i] = *reinterpret_cast<const UnsignedShort*>(index);
+        else
+            out.indices[i] = *reinterpret_cast<const UnsignedInt*>(index);
+
+        if(out.indices[i] >= out.count) {
+            Error{} << errorPrefix << "sparse index" << out.indices[i] << "in accessor" << accessorId << "out of range for" << out.count << "elements";
+            return {};
+        }
+    }
+
+    return Utility::move(out);
+}
+
+#ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+namespace {
+
+/* Draco decodes quantized attributes back to their original type, which is
+   what the accessors describe. Types not representable in glTF map to an
+   invalid format and thus never match. */
+VertexFormat dracoComponentFormat(const draco::DataType type) {
+    switch(type) {
+        case draco::DT_INT8: return VertexFormat::Byte;
+        case draco::DT_UINT8: return VertexFormat::UnsignedByte;
+        case draco::DT_INT16: return VertexFormat::Short;
+        case draco::DT_UINT16: return VertexFormat::UnsignedShort;
+        case draco::DT_UINT32: return VertexFormat::UnsignedInt;
+        case draco::DT_FLOAT32: return VertexFormat::Float;
+        default: return VertexFormat{};
+    }
+}
+
+template<class T> void copyDracoIndices(const draco::Mesh& mesh, const Containers::ArrayView<char> out) {
+    const Containers::ArrayView<T> indices = Containers::arrayCast<T>(out);
+    for(UnsignedInt i = 0; i != mesh.num_faces(); ++i) {
+        const draco::Mesh::Face& face = mesh.face(draco::FaceIndex{i});
+        for(std::size_t j = 0; j != 3; ++j)
+            indices[i*3 + j] = T(face[j].value());
+    }
+}
+
+}
+
+bool GltfImporter::decodeDracoPrimitive(const UnsignedInt id, const Utility::JsonToken& gltfDracoCompression) {
+    /* Return if the primitive is already decoded */
+    Containers::Optional<Document::DracoPrimitive>& storage = _d->dracoPrimitives[id];
+    if(storage) return true;
+
+    MAGNUM_PROFILING_ZONE("GltfImporter::decodeDracoPrimitive()");
+
+    const Utility::JsonToken& gltfPrimitive = _d->gltfMeshPrimitiveMap[id].second();
+
+    if(!_d->gltf->parseObject(gltfDracoCompression)) {
+        Error{} << "Trade::GltfImporter::mesh(): invalid KHR_draco_mesh_compression extension";
+        return false;
+    }
+
+    const Utility::JsonToken* const gltfBufferViewId = gltfDracoCompression.find("bufferView"_s);
+    if(!gltfBufferViewId || !_d->gltf->parseUnsignedInt(*gltfBufferViewId)) {
+        Error{} << "Trade::GltfImporter::mesh(): missing or invalid KHR_draco_mesh_compression bufferView property";
+        return false;
+    }
+
+    const Utility::JsonToken* const gltfDracoAttributes = gltfDracoCompression.find("attributes"_s);
+    if(!gltfDracoAttributes || !_d->gltf->parseObject(*gltfDracoAttributes)) {
+        Error{} << "Trade::GltfImporter::mesh(): missing or invalid KHR_draco_mesh_compression attributes property";
+        return false;
+    }
+
+    /* The decoded faces are always a triangle list, so the primitive has to
+       reference an index accessor that describes them */
+    const Utility::JsonToken* const gltfIndices = gltfPrimitive.find("indices"_s);
+    if(!gltfIndices) {
+        Error{} << "Trade::GltfImporter::mesh(): KHR_draco_mesh_compression primitives without indices are not supported";
+        return false;
+    }
+    if(!_d->gltf->parseUnsignedInt(*gltfIndices)) {
+        Error{} << "Trade::GltfImporter::mesh(): invalid indices property";
+        return false;
+    }
+    if(gltfIndices->asUnsignedInt() >= _d->gltfAccessors.size()) {
+        Error{} << "Trade::GltfImporter::mesh(): accessor index" << gltfIndices->asUnsignedInt() << "out of range for" << _d->gltfAccessors.size() << "accessors";
+        return false;
+    }
+    const Containers::Optional<Containers::Pair<VertexFormat, std::size_t>> indexFormatCount = parseAccessorFormat("Trade::GltfImporter::mesh():", gltfIndices->asUnsignedInt());
+    if(!indexFormatCount) return false;
+    if(indexFormatCount->first() != VertexFormat::UnsignedByte &&
+       indexFormatCount->first() != VertexFormat::UnsignedShort &&
+       indexFormatCount->first() != VertexFormat::UnsignedInt) {
+        /* Since we're abusing VertexFormat for all formats, print just the
+           enum value without the prefix to avoid cofusion */
+        Error{} << "Trade::GltfImporter::mesh(): unsupported index type" << Debug::packed << indexFormatCount->first();
+        return false;
+    }
+
+    const Containers::Optional<Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt>> bufferView = parseBufferView("Trade::GltfImporter::mesh():", gltfBufferViewId->asUnsignedInt());
+    if(!bufferView) return false;
+
+    /* Decode just this primitive, not the whole buffer */
+    draco::DecoderBuffer buffer;
+    buffer.Init(bufferView->first().data(), bufferView->first().size());
+    draco::Decoder decoder;
+    draco::StatusOr<std::unique_ptr<draco::Mesh>> decoded = decoder.DecodeMeshFromBuffer(&buffer);
+    if(!decoded.ok()) {
+        Error{} << "Trade::GltfImporter::mesh(): KHR_draco_mesh_compression decoding failed:" << decoded.status().error_msg();
+        return false;
+    }
+    const std::unique_ptr<draco::Mesh> mesh = Utility::move(decoded).value();
+    const std::size_t vertexCount = mesh->num_points();
+    const std::size_t indexCount = std::size_t{mesh->num_faces()}*3;
+
+    if(indexFormatCount->second() != indexCount) {
+        Error{} << "Trade::GltfImporter::mesh(): accessor" << gltfIndices->asUnsignedInt() << "has" << indexFormatCount->second() << "elements but KHR_draco_mesh_compression decoded" << indexCount << "indices";
+        return false;
+    }
+    const std::size_t indexSize = vertexFormatSize(indexFormatCount->first());
+    if(indexSize < 4 && vertexCount > (std::size_t{1} << 8*indexSize)) {
+        Error{} << "Trade::GltfImporter::mesh(): index type" << Debug::packed << indexFormatCount->first() << "can't represent" << vertexCount << "vertices decoded from KHR_draco_mesh_compression";
+        return false;
+    }
+
+    /* Match the decoded attributes to accessors of the same name in the
+       primitive attributes, which were parsed in doOpenData() and doMesh()
+       already */
+    const Utility::JsonToken* const gltfAttributes = gltfPrimitive.find("attributes"_s);
+    Containers::Array<Containers::Triple<UnsignedInt, const draco::PointAttribute*, VertexFormat>> attributes;
+    std::size_t vertexDataSize = 0;
+    for(Utility::JsonObjectItem gltfDracoAttribute: gltfDracoAttributes->asObject()) {
+        if(!_d->gltf->parseUnsignedInt(gltfDracoAttribute.value())) {
+            Error{} << "Trade::GltfImporter::mesh(): invalid KHR_draco_mesh_compression attribute" << gltfDracoAttribute.key();
+            return false;
+        }
+
+        const Utility::JsonToken* const gltfAttribute = gltfAttributes ? gltfAttributes->find(gltfDracoAttribute.key()) : nullptr;
+        if(!gltfAttribute || !_d->gltf->parseUnsignedInt(*gltfAttribute)) {
+            Error{} << "Trade::GltfImporter::mesh(): KHR_draco_mesh_compression attribute" << gltfDracoAttribute.key() << "not found in primitive attributes";
+            return false;
+        }
+        const UnsignedInt accessorId = gltfAttribute->asUnsignedInt();
+        if(accessorId >= _d->gltfAccessors.size()) {
+            Error{} << "Trade::GltfImporter::mesh(): accessor index" << accessorId << "out of range for" << _d->gltfAccessors.size() << "accessors";
+            return false;
+        }
+
+        const Containers::Optional<Containers::Pair<VertexFormat, std::size_t>> formatCount = parseAccessorFormat("Trade::GltfImporter::mesh():", accessorId);
+        if(!formatCount) return false;
+        if(formatCount->second() != vertexCount) {
+            Error{} << "Trade::GltfImporter::mesh(): accessor" << accessorId << "has" << formatCount->second() << "elements but KHR_draco_mesh_compression decoded" << vertexCount << "vertices";
+            return false;
+        }
+
+        const draco::PointAttribute* const dracoAttribute = mesh->GetAttributeByUniqueId(gltfDracoAttribute.value().asUnsignedInt());
+        if(!dracoAttribute) {
+            Error{} << "Trade::GltfImporter::mesh(): KHR_draco_mesh_compression attribute" << gltfDracoAttribute.key() << "references unique ID" << gltfDracoAttribute.value().asUnsignedInt() << "not present in the compressed data";
+            return false;
+        }
+
+        const VertexFormat format = formatCount->first();
+        if(dracoComponentFormat(dracoAttribute->data_type()) != vertexFormatComponentFormat(format) ||
+           std::size_t(dracoAttribute->byte_stride()) != vertexFormatSize(format)) {
+            Error{} << "Trade::GltfImporter::mesh(): KHR_draco_mesh_compression attribute" << gltfDracoAttribute.key() << "with" << dracoAttribute->num_components() << "components of Draco type" << Int(dracoAttribute->data_type()) << "doesn't match" << Debug::packed << format << "of accessor" << accessorId;
+            return false;
+        }
+
+        arrayAppend(attributes, InPlaceInit, accessorId, dracoAttribute, format);
+        vertexDataSize += (vertexCount*vertexFormatSize(format) + 3) & ~std::size_t{3};
+    }
+
+    /* The extension allows the primitive to have also attributes that aren't
+       compressed, and morph targets are never compressed. Those are in
+       regular accessors, which are copied after the decoded data as a mesh
+       can't span multiple buffers. Errors are silenced here, an accessor that
+       fails to parse isn't added and doMesh() then prints the error once it
+       parses it again. Sparse accessors are handled by doMesh() directly. */
+    Containers::Array<Containers::Pair<UnsignedInt, Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>>> plainAttributes;
+    {
+        Error silenceError{nullptr};
+        const auto addPlainAttribute = [&](const Utility::JsonToken& gltfAccessorId) {
+            if(!_d->gltf->parseUnsignedInt(gltfAccessorId))
+                return;
+            const UnsignedInt accessorId = gltfAccessorId.asUnsignedInt();
+            if(accessorId < _d->gltfAccessors.size() && _d->gltfAccessors[accessorId]->find("sparse"_s))
+                return;
+            for(const Containers::Triple<UnsignedInt, const draco::PointAttribute*, VertexFormat>& attribute: attributes)
+                if(attribute.first() == accessorId) return;
+            for(const Containers::Pair<UnsignedInt, Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>>& attribute: plainAttributes)
+                if(attribute.first() == accessorId) return;
+
+            const Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> accessor = parseAccessor("Trade::GltfImporter::mesh():", accessorId);
+            if(!accessor) return;
+            arrayAppend(plainAttributes, InPlaceInit, accessorId, *accessor);
+            vertexDataSize += (accessor->first().size()[0]*accessor->first().size()[1] + 3) & ~std::size_t{3};
+        };
+        if(gltfAttributes) for(Utility::JsonObjectItem gltfAttribute: gltfAttributes->asObject())
+            addPlainAttribute(gltfAttribute.value());
+        if(const Utility::JsonToken* const gltfTargets = gltfPrimitive.find("targets"_s)) {
+            for(Utility::JsonArrayItem gltfTarget: gltfTargets->asArray())
+                for(Utility::JsonObjectItem gltfMorphAttribute: gltfTarget.value().asObject())
+                    addPlainAttribute(gltfMorphAttribute.value());
+        }
+    }
+
+    /* Copy the attributes and indices into a single allocation */
+    Document::DracoPrimitive out;
+    out.data = Containers::Array<char>{NoInit, vertexDataSize + indexCount*indexSize};
+    out.vertexData = out.data.prefix(vertexDataSize);
+    out.attributes = Containers::Array<Containers::Triple<UnsignedInt, Containers::StridedArrayView2D<const char>, VertexFormat>>{attributes.size() + plainAttributes.size()};
+    std::size_t offset = 0;
+    for(std::size_t i = 0; i != attributes.size(); ++i) {
+        const draco::PointAttribute& dracoAttribute = *attributes[i].second();
+        const std::size_t typeSize = vertexFormatSize(attributes[i].third());
+        const Containers::ArrayView<char> dst = out.data.sliceSize(offset, vertexCount*typeSize);
+        for(UnsignedInt j = 0; j != vertexCount; ++j)
+            dracoAttribute.GetValue(dracoAttribute.mapped_index(draco::PointIndex{j}), dst.data() + j*typeSize);
+
+        out.attributes[i] = {attributes[i].first(), Containers::StridedArrayView2D<const char>{dst, {vertexCount, typeSize}}, attributes[i].third()};
+        offset += (vertexCount*typeSize + 3) & ~std::size_t{3};
+    }
+    for(std::size_t i = 0; i != plainAttributes.size(); ++i) {
+        const Containers::StridedArrayView2D<const char>& src = plainAttributes[i].second().first();
+        const Containers::StridedArrayView2D<char> dst{out.data.sliceSize(offset, src.size()[0]*src.size()[1]), src.size()};
+        Utility::copy(src, dst);
+
+        out.attributes[attributes.size() + i] = {plainAttributes[i].first(), dst, plainAttributes[i].second().second()};
+        offset += (src.size()[0]*src.size()[1] + 3) & ~std::size_t{3};
+    }
+
+    const Containers::ArrayView<char> indexData = out.data.exceptPrefix(vertexDataSize);
+    if(indexSize == 1)
+        copyDracoIndices<UnsignedByte>(*mesh, indexData);
+    else if(indexSize == 2)
+        copyDracoIndices<UnsignedShort>(*mesh, indexData);
+    else
+        copyDracoIndices<UnsignedInt>(*mesh, indexData);
+    out.indices = Containers::StridedArrayView2D<const char>{indexData, {indexCount, indexSize}};
+    out.indexFormat = indexFormatCount->first();
+
+    storage = Utility::move(out);
+    return true;
+}
+#endif
+
 namespace {
 
 void fillDefaultConfiguration(Utility::ConfigurationGroup& conf) {
@@ -653,22 +1336,49 @@ GltfImporter::GltfImporter() {
     fillDefaultConfiguration(configuration());
 }
 
-GltfImporter::GltfImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
+GltfImporter::GltfImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {
+    Magnum::Implementation::imageImporterPool().addUser(this->manager());
+}
 
 GltfImporter::GltfImporter(PluginManager::Manager<AbstractImporter>& manager): AbstractImporter{manager} {
     /** @todo horrible workaround, fix this properly */
     fillDefaultConfiguration(configuration());
+    Magnum::Implementation::imageImporterPool().addUser(this->manager());
 }
 
-GltfImporter::~GltfImporter() = default;
+GltfImporter::~GltfImporter() {
+    Magnum::Implementation::imageImporterPool().removeUser(manager());
+}
+
+void GltfImporter::setOutputAllocator(char*(*const allocator)(std::size_t, void*), void* const userData) {
+    _outputAllocator = allocator;
+    _outputAllocatorUserData = userData;
+}
 
 ImporterFeatures GltfImporter::doFeatures() const { return ImporterFeature::OpenData|ImporterFeature::FileCallback; }
 
 bool GltfImporter::doIsOpened() const { return !!_d && _d->gltf; }
 
-void GltfImporter::doClose() { _d = nullptr; }
+void GltfImporter::doClose() {
+    /* Keep the file data and JSON tokens around if requested, so opening the
+       same file again doesn't need to tokenize it again */
+    if(_d && _d->gltf && _d->fileDataCacheable && configuration().value<bool>("cacheJsonTokens")) {
+        _jsonCache.reset(new JsonCache{
+            _d->filename ? Containers::String{Containers::StringView{*_d->filename}} : Containers::String{},
+            Utility::move(_d->fileData),
+            Utility::move(_d->gltf)});
+    }
+
+    /* Put image importers opened from files back to the shared pool, if
+       enabled */
+    if(_d) for(std::size_t i = 0; i != _d->imageImporters.size(); ++i)
+        releaseImageImporter(i);
+
+    _d = nullptr;
+}
 
 void GltfImporter::doOpenFile(const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenFile", filename};
     _d.reset(new Document);
     _d->filename.emplace(Containers::String::nullTerminatedGlobalView(filename));
     AbstractImporter::doOpenFile(filename);
@@ -693,8 +1403,79 @@ bool isRecognized2DTextureExtension(Containers::StringView name) {
         name == "EXT_texture_webp"_s;
 }
 
+/* Used by doOpenData() and doTexture(). Returns the first extension from the
+   space-separated preferredTextureExtensions option that's present in the
+   texture extensions object and recognized, or an empty view if there's none,
+   in which case the first recognized extension in file order is picked. */
+Containers::StringView preferredTextureExtension(const Utility::ConfigurationGroup& configuration, const Utility::JsonToken& gltfExtensions, const bool khrTextureKtx) {
+    for(const Containers::StringView name: configuration.value<Containers::StringView>("preferredTextureExtensions").splitOnWhitespaceWithoutEmptyParts()) {
+        if(!(name == "KHR_texture_ktx"_s && khrTextureKtx) && !isRecognized2DTextureExtension(name))
+            continue;
+        if(const Utility::JsonToken* const gltfExtension = gltfExtensions.find(name))
+            return gltfExtension->parent()->asString();
+    }
+
+    return {};
+}
+
+/* Used by discoverSceneExtraFields(), parseSceneExtraFields() and
+   collectSceneExtraFields() to build dot-separated names of nested extras in
+   a single scratch buffer that's reused for all nodes, instead of allocating a
+   new string for every key of every node. Puts `key` after `prefix`, which is
+   either empty and null for top-level keys or a view on the beginning of
+   `storage`, separating them with a dot, and returns a null-terminated view on
+   the result. Note that the buffer may get reallocated, making all previously
+   returned views dangling, so only the size of `prefix` is used. */
+Containers::StringView sceneExtraKey(Containers::Array<char>& storage, const Containers::StringView prefix, const Containers::StringView key) {
+    const std::size_t prefixSize = prefix.data() ? prefix.size() + 1 : 0;
+    const std::size_t size = prefixSize + key.size();
+    if(storage.size() < size + 1)
+        arrayResize(storage, NoInit, size + 1);
+    if(prefixSize) storage[prefixSize - 1] = '.';
+    std::memcpy(storage.data() + prefixSize, key.data(), key.size());
+    storage[size] = '\0';
+    return {storage.data(), size, Containers::StringViewFlag::NullTerminated};
+}
+
+/* Used by doOpenData(). Number of threads to perform open-time validation
+   on, 0 in the openThreads option means std::thread::hardware_concurrency(),
+   and there's no point in having more threads than there are chunks of
+   work. The option is missing in the configuration of the deprecated
+   CgltfImporter alias, which should stay single-threaded. The workers
+   silence their errors, which is only thread-local if Corrade is built with
+   CORRADE_BUILD_MULTITHREADED, so without it everything is done on the
+   calling thread. */
+std::size_t openThreadCount(const Utility::ConfigurationGroup& configuration, const std::size_t chunkCount) {
+    std::size_t threadCount = 1;
+    #if (!defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)) && defined(CORRADE_BUILD_MULTITHREADED)
+    if(!configuration.hasValue("openThreads")) return 1;
+    threadCount = configuration.value<UnsignedInt>("openThreads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = Math::max(Math::min(threadCount, chunkCount), std::size_t{1});
+    #else
+    static_cast<void>(configuration);
+    static_cast<void>(chunkCount);
+    #endif
+    return threadCount;
+}
+
+/* Used by doOpenData(). The calling thread is one of the workers. */
+template<class F> void runOnThreads(const F& work, const std::size_t threadCount) {
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{work};
+    work();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    static_cast<void>(threadCount);
+    work();
+    #endif
+}
+
 /* Used by doOpenData() but it's recursive and so it can't be a local lambda */
-bool discoverSceneExtraFields(Utility::Json& gltf, std::unordered_map<Containers::String, SceneField>& sceneFieldsForName, Containers::Array<Containers::Triple<Containers::StringView, SceneFieldType, SceneFieldFlags>>& sceneFieldNamesTypesFlags, const Utility::ConfigurationGroup* const customSceneFieldTypeConfiguration, UnsignedInt nodeI, const Containers::StringView key, const Utility::JsonToken& gltfExtraValue) {
+bool discoverSceneExtraFields(Utility::Json& gltf, std::unordered_map<Containers::String, SceneField>& sceneFieldsForName, Containers::Array<Containers::Triple<Containers::StringView, SceneFieldType, SceneFieldFlags>>& sceneFieldNamesTypesFlags, const Utility::ConfigurationGroup* const customSceneFieldTypeConfiguration, Containers::Array<char>& keyStorage, UnsignedInt nodeI, const Containers::StringView key, const Utility::JsonToken& gltfExtraValue) {
     /* If the value is an object, recurse into it. The field name will then be
        all object keys concatenated with dots. */
     if(gltfExtraValue.type() == Utility::JsonToken::Type::Object) {
@@ -710,8 +1491,9 @@ bool discoverSceneExtraFields(Utility::Json& gltf, std::unordered_map<Containers
         for(const Utility::JsonObjectItem gltfNestedExtra: gltfExtraValue.asObject()) {
             if(!discoverSceneExtraFields(
                 gltf, sceneFieldsForName, sceneFieldNamesTypesFlags,
-                customSceneFieldTypeConfiguration,
-                nodeI, "."_s.join({key, gltfNestedExtra.key()}), gltfNestedExtra.value())
+                customSceneFieldTypeConfiguration, keyStorage, nodeI,
+                sceneExtraKey(keyStorage, key, gltfNestedExtra.key()),
+                gltfNestedExtra.value())
             )
                 return false;
         }
@@ -747,8 +1529,11 @@ bool discoverSceneExtraFields(Utility::Json& gltf, std::unordered_map<Containers
        tokenType != Utility::JsonToken::Type::String)
         return true;
 
-    const auto inserted = sceneFieldsForName.emplace(key, sceneFieldCustom(sceneFieldNamesTypesFlags.size()));
-    if(inserted.second) {
+    /* Look up the key first through a non-owning view to avoid allocating a
+       string copy for fields that are already known, which is the most common
+       case for all but the first node */
+    if(sceneFieldsForName.find(Containers::String::nullTerminatedView(key)) == sceneFieldsForName.end()) {
+        const auto inserted = sceneFieldsForName.emplace(key, sceneFieldCustom(sceneFieldNamesTypesFlags.size()));
         /* If the field has the type specified in configuration,
            override the default */
         /** @todo use findValue() once the Configuration API is reworked,
@@ -795,12 +1580,34 @@ bool discoverSceneExtraFields(Utility::Json& gltf, std::unordered_map<Containers
 }
 
 void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     if(!_d) _d.reset(new Document);
 
+    /* If the same file was opened last time and its data were kept with
+       cacheJsonTokens, reuse them together with the already tokenized and
+       partially parsed JSON. Only the last closed file is kept, so discard
+       the cache in any case. */
+    Containers::Optional<Utility::Json> cachedGltf;
+    if(_jsonCache) {
+        if(_jsonCache->fileData.size() == data.size() &&
+           _jsonCache->filename == (_d->filename ? Containers::StringView{*_d->filename} : Containers::StringView{}) &&
+           std::memcmp(_jsonCache->fileData.data(), data.data(), data.size()) == 0)
+        {
+            _d->fileData = Utility::move(_jsonCache->fileData);
+            cachedGltf = Utility::move(_jsonCache->gltf);
+        }
+        _jsonCache = nullptr;
+    }
+
+    /* Data owned by somebody else can't be kept after the file is closed */
+    _d->fileDataCacheable = !(dataFlags & DataFlag::ExternallyOwned);
+
     /* Copy file content. Take over the existing array or copy the data if we
        can't. We need to keep the data around as JSON tokens are views onto it
        and also for the GLB binary chunk. */
-    if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
+    if(cachedGltf) {
+        /* Already taken from the cache above */
+    } else if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
         _d->fileData = Utility::move(data);
     } else {
         _d->fileData = Containers::Array<char>{NoInit, data.size()};
@@ -824,10 +1631,13 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
             Error{} << "Trade::GltfImporter::openData(): unsupported binary glTF version" << header.version;
             return;
         }
-        if(_d->fileData.size() != header.length) {
+        /* With allowPartialGlb the file can be shorter than what the header
+           says, as long as the whole JSON chunk is there */
+        if(_d->fileData.size() != header.length && !(_d->fileData.size() < header.length && configuration().value<bool>("allowPartialGlb"))) {
             Error{} << "Trade::GltfImporter::openData(): binary glTF size mismatch, expected" << header.length << "bytes but got" << _d->fileData.size();
             return;
         }
+        const bool partial = _d->fileData.size() < header.length;
         if(Containers::StringView{header.json.magic, 4} != "JSON"_s) {
             /** @todo use Debug::str (escaping non-printable characters)
                 instead of the hex once it exists */
@@ -852,6 +1662,11 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
            skip */
         const char* chunk = jsonDataEnd;
         while(chunk != _d->fileData.end()) {
+            /* If the file isn't complete yet, stop at the first incomplete
+               chunk header and keep whatever part of the BIN chunk is
+               there */
+            if(partial && chunk + sizeof(Implementation::GltfGlbChunkHeader) > _d->fileData.end())
+                break;
             if(chunk + sizeof(Implementation::GltfGlbChunkHeader) > _d->fileData.end()) {
                 Error{} << "Trade::GltfImporter::openData(): binary glTF chunk starting at" << chunk - _d->fileData.begin() << "too small, expected at least" << sizeof(Implementation::GltfGlbChunkHeader) << "bytes but got only" << _d->fileData.end() - chunk;
                 return;
@@ -860,6 +1675,13 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
             const auto& chunkHeader = *reinterpret_cast<const Implementation::GltfGlbChunkHeader*>(chunk);
             const char* const chunkDataBegin = chunk + sizeof(Implementation::GltfGlbChunkHeader);
             const char* const chunkDataEnd = chunkDataBegin + chunkHeader.length;
+            if(partial && chunkDataEnd > _d->fileData.end()) {
+                if(!_d->binChunk && Containers::StringView{chunkHeader.magic, 4} == "BIN\0"_s) {
+                    _d->binChunk = Containers::arrayView(chunkDataBegin, _d->fileData.end() - chunkDataBegin);
+                    _d->binChunkPartial = true;
+                }
+                break;
+            }
             if(chunkDataEnd > _d->fileData.end()) {
                 Error{} << "Trade::GltfImporter::openData(): binary glTF size mismatch, expected" << chunkHeader.length << "bytes for a chunk starting at" << chunk - _d->fileData.begin() << "but got only" << _d->fileData.end() - chunkDataBegin;
                 return;
@@ -875,9 +1697,16 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
                 Warning{} << "Trade::GltfImporter::openData(): ignoring chunk" << reinterpret_cast<void*>(chunkHeader.id) << "at" << chunk - _d->fileData.begin();
             chunk = chunkDataEnd;
         }
+
+        /* If the BIN chunk didn't even start yet, make it empty so buffer
+           views referencing it report the data as not present yet */
+        if(partial && !_d->binChunk) {
+            _d->binChunk = Containers::ArrayView<const char>{};
+            _d->binChunkPartial = true;
+        }
     }
 
-    Containers::Optional<Utility::Json> gltf = Utility::Json::fromString(json, _d->filename ? Containers::StringView{*_d->filename} : Containers::StringView{}, 0, jsonByteOffset);
+    Containers::Optional<Utility::Json> gltf = cachedGltf ? Utility::move(cachedGltf) : Utility::Json::fromString(json, _d->filename ? Containers::StringView{*_d->filename} : Containers::StringView{}, 0, jsonByteOffset);
     if(!gltf || !gltf->parseObject(gltf->root())) {
         Error{} << "Trade::GltfImporter::openData(): invalid JSON";
         return;
@@ -914,7 +1743,9 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
     }
 
     /* Check used extensions for any experimental feature that's off by
-       default and hint at it */
+       default and hint at it. Remember also whether EXT_mesh_gpu_instancing is
+       used, for which custom scene fields get registered below. */
+    bool meshGpuInstancingUsed = false;
     if(const Utility::JsonToken* gltfExtensionsUsed = gltf->root().find("extensionsUsed"_s)) {
         if(!gltf->parseArray(*gltfExtensionsUsed)) {
             Error{} << "Trade::GltfImporter::openData(): invalid extensionsUsed property";
@@ -929,6 +1760,8 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
 
             if(!(flags() & ImporterFlag::Quiet) && gltfExtension.value().asString() == "KHR_texture_ktx"_s && !configuration().value<bool>("experimentalKhrTextureKtx"))
                 Warning{} << "Trade::GltfImporter::openData(): used extension KHR_texture_ktx is experimental, enable experimentalKhrTextureKtx to use it";
+            if(gltfExtension.value().asString() == "EXT_mesh_gpu_instancing"_s)
+                meshGpuInstancingUsed = true;
         }
     }
 
@@ -955,8 +1788,13 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
             "KHR_texture_transform"_s,
             "GOOGLE_texture_basis"_s,
             "MSFT_texture_dds"_s,
+            "EXT_mesh_gpu_instancing"_s,
+            "EXT_meshopt_compression"_s,
             "EXT_texture_webp"_s
         });
+        #ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+        arrayAppend(supportedExtensions, "KHR_draco_mesh_compression"_s);
+        #endif
         if(configuration().value<bool>("experimentalKhrTextureKtx"))
             arrayAppend(supportedExtensions, "KHR_texture_ktx"_s);
 
@@ -1131,19 +1969,49 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
             }
         }
 
+        /* Parse children arrays of all nodes. They contain just numbers,
+           which get parsed in place in tokens that are disjoint for every
+           node, so the work can be split among multiple threads, each picking
+           the next unparsed chunk of nodes. Errors from the workers are
+           silenced and a failed parse is repeated on the calling thread below
+           to print the message in the order the serial code would. */
+        Containers::Array<Containers::StridedArrayView1D<const UnsignedInt>> nodeChildren{_d->gltfNodes.size()};
+        Containers::Array<bool> nodeChildrenInvalid{ValueInit, _d->gltfNodes.size()};
+        {
+            constexpr std::size_t NodesPerChunk = 4096;
+            const std::size_t chunkCount = (_d->gltfNodes.size() + NodesPerChunk - 1)/NodesPerChunk;
+            #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+            std::atomic<std::size_t> next{0};
+            #else
+            std::size_t next = 0;
+            #endif
+            const auto parse = [&]() {
+                Error silenceError{nullptr};
+                for(std::size_t chunk; (chunk = next++) < chunkCount; ) {
+                    for(std::size_t i = chunk*NodesPerChunk, end = Math::min(i + NodesPerChunk, _d->gltfNodes.size()); i != end; ++i) {
+                        const Utility::JsonToken* const gltfNodeChildren = _d->gltfNodes[i].first()->find("children"_s);
+                        if(!gltfNodeChildren) continue;
+
+                        if(const Containers::Optional<Containers::StridedArrayView1D<const UnsignedInt>> children = gltf->parseUnsignedIntArray(*gltfNodeChildren))
+                            nodeChildren[i] = *children;
+                        else nodeChildrenInvalid[i] = true;
+                    }
+                }
+            };
+            runOnThreads(parse, openThreadCount(configuration(), chunkCount));
+        }
+
         /* Go through the node hierarchy and mark nested children, discovering
            potential conflicting parent nodes */
         for(std::size_t i = 0; i != _d->gltfNodes.size(); ++i) {
-            const Utility::JsonToken* const gltfNodeChildren = _d->gltfNodes[i].first()->find("children"_s);
-            if(!gltfNodeChildren) continue;
-
-            const Containers::Optional<Containers::StridedArrayView1D<const UnsignedInt>> nodeChildren = gltf->parseUnsignedIntArray(*gltfNodeChildren);
-            if(!nodeChildren) {
+            if(nodeChildrenInvalid[i]) {
+                /* Parse again to print the error message */
+                gltf->parseUnsignedIntArray(*_d->gltfNodes[i].first()->find("children"_s));
                 Error{} << "Trade::GltfImporter::openData(): invalid children property of node" << i;
                 return;
             }
 
-            for(const UnsignedInt child: *nodeChildren) {
+            for(const UnsignedInt child: nodeChildren[i]) {
                 if(child >= _d->gltfNodes.size()) {
                     Error{} << "Trade::GltfImporter::openData(): child index" << child << "in node" << i << "out of range for" << _d->gltfNodes.size() << "nodes";
                     return;
@@ -1163,25 +2031,55 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
             }
         }
 
-        /* Find cycles, Tortoise and Hare */
-        for(std::size_t i = 0; i != _d->gltfNodes.size(); ++i) {
-            Int p1 = nodeParents[i];
-            Int p2 = p1 < 0 ? -1 : nodeParents[p1];
-
-            while(p1 >= 0 && p2 >= 0) {
-                if(p1 == p2) {
-                    Error{} << "Trade::GltfImporter::openData(): node tree contains cycle starting at node" << i;
-                    return;
+        /* Find cycles, Tortoise and Hare. The parent links are only read
+           here, so the nodes are again split among threads. Each thread
+           remembers the first node it found a cycle at and the lowest of
+           those is reported, same as when going through the nodes serially. */
+        {
+            constexpr std::size_t NodesPerChunk = 4096;
+            const std::size_t chunkCount = (_d->gltfNodes.size() + NodesPerChunk - 1)/NodesPerChunk;
+            const std::size_t threadCount = openThreadCount(configuration(), chunkCount);
+            #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+            std::atomic<std::size_t> next{0};
+            std::atomic<std::size_t> nextThread{0};
+            #else
+            std::size_t next = 0;
+            std::size_t nextThread = 0;
+            #endif
+            Containers::Array<std::size_t> cycleStart{DirectInit, threadCount, ~std::size_t{}};
+            const auto findCycles = [&]() {
+                std::size_t& threadCycleStart = cycleStart[nextThread++];
+                for(std::size_t chunk; (chunk = next++) < chunkCount; ) {
+                    for(std::size_t i = chunk*NodesPerChunk, end = Math::min(i + NodesPerChunk, _d->gltfNodes.size()); i != end && i < threadCycleStart; ++i) {
+                        Int p1 = nodeParents[i];
+                        Int p2 = p1 < 0 ? -1 : nodeParents[p1];
+
+                        while(p1 >= 0 && p2 >= 0) {
+                            if(p1 == p2) {
+                                threadCycleStart = i;
+                                break;
+                            }
+
+                            p1 = nodeParents[p1];
+                            p2 = nodeParents[p2] < 0 ? -1 : nodeParents[nodeParents[p2]];
+                        }
+                    }
                 }
+            };
+            runOnThreads(findCycles, threadCount);
 
-                p1 = nodeParents[p1];
-                p2 = nodeParents[p2] < 0 ? -1 : nodeParents[nodeParents[p2]];
+            const std::size_t firstCycleStart = Math::min(arrayView(cycleStart));
+            if(firstCycleStart != ~std::size_t{}) {
+                Error{} << "Trade::GltfImporter::openData(): node tree contains cycle starting at node" << firstCycleStart;
+                return;
             }
         }
     }
 
     /* Go through all nodes and collect names of extra properties for custom
-       scene fields */
+       scene fields. Nested field names are assembled in a scratch buffer
+       that's reused for all nodes. */
+    Containers::Array<char> sceneExtraKeyStorage;
     for(std::size_t i = 0; i != _d->gltfNodes.size(); ++i) {
         const Utility::JsonToken& gltfNode = _d->gltfNodes[i].first();
         const Utility::JsonToken* const gltfExtras = gltfNode.find("extras"_s);
@@ -1201,11 +2099,42 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
         /* The process is recursive so it has to be an external function */
         const Utility::ConfigurationGroup* customSceneFieldTypeConfiguration = configuration().group("customSceneFieldTypes");
         for(const Utility::JsonObjectItem gltfExtra: gltfExtras->asObject()) {
-            if(!discoverSceneExtraFields(*gltf, _d->sceneFieldsForName, _d->sceneFieldNamesTypesFlags, customSceneFieldTypeConfiguration, i, gltfExtra.key(), gltfExtra.value()))
+            if(!discoverSceneExtraFields(*gltf, _d->sceneFieldsForName, _d->sceneFieldNamesTypesFlags, customSceneFieldTypeConfiguration, sceneExtraKeyStorage, i, sceneExtraKey(sceneExtraKeyStorage, {}, gltfExtra.key()), gltfExtra.value()))
                 return;
         }
     }
 
+    /* Per-instance transformations from EXT_mesh_gpu_instancing are imported
+       as custom scene fields. Registered after the extras so if any of them
+       use the same name, the extras take precedence. */
+    if(meshGpuInstancingUsed) {
+        const Containers::Pair<Containers::StringView, SceneFieldType> meshGpuInstancingFields[]{
+            {"instanceTranslation"_s, SceneFieldType::Vector3},
+            {"instanceRotation"_s, SceneFieldType::Quaternion},
+            {"instanceScaling"_s, SceneFieldType::Vector3}
+        };
+        bool conflict = false;
+        for(const Containers::Pair<Containers::StringView, SceneFieldType>& field: meshGpuInstancingFields) {
+            if(_d->sceneFieldsForName.find(field.first()) != _d->sceneFieldsForName.end()) {
+                if(!(flags() & ImporterFlag::Quiet))
+                    Warning{} << "Trade::GltfImporter::openData(): custom scene field" << field.first() << "already used by node extras, EXT_mesh_gpu_instancing won't be imported";
+                conflict = true;
+                break;
+            }
+        }
+
+        if(!conflict) {
+            _d->meshGpuInstancingFieldOffset = _d->sceneFieldNamesTypesFlags.size();
+            for(const Containers::Pair<Containers::StringView, SceneFieldType>& field: meshGpuInstancingFields) {
+                const auto inserted = _d->sceneFieldsForName.emplace(field.first(), sceneFieldCustom(_d->sceneFieldNamesTypesFlags.size()));
+                arrayAppend(_d->sceneFieldNamesTypesFlags, InPlaceInit,
+                    inserted.first->first,
+                    field.second(),
+                    SceneFieldFlag::MultiEntry);
+            }
+        }
+    }
+
     /* Treat meshes with multiple primitives as separate meshes. Each mesh gets
        duplicated as many times as is the size of the primitives array.
        Conservatively reserve for exactly one primitive per mesh, as that's the
@@ -1360,6 +2289,14 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
         }
     }
 
+    /* Compact sparse morph targets are imported as additional mesh levels
+       with a custom attribute containing the vertex indices */
+    if(configuration().value<bool>("compactSparseMorphTargets") &&
+       _d->meshAttributesForName.emplace("SPARSE_INDEX"_s,
+            meshAttributeCustom(_d->meshAttributeNames.size())).second
+    )
+        arrayAppend(_d->meshAttributeNames, "SPARSE_INDEX"_s);
+
     /* Discover 2D array images -- if any KHR_texture_ktx texture extension
        has a layer property, given image is 2D array. Otherwise it's 2D. To
        make the logic more robust, the same image can't be referenced as both
@@ -1388,8 +2325,11 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
                         return;
                     }
 
-                    /* Pick the first extension we understand. If
-                       KHR_texture_ktx isn't the first, it won't be picked. */
+                    /* Pick the most preferred extension if any is listed
+                       in the options, otherwise the first extension we
+                       understand. If KHR_texture_ktx isn't picked, the
+                       texture isn't an array. */
+                    const Containers::StringView preferredExtension = preferredTextureExtension(configuration(), *gltfTextureExtensions, true);
                     for(const Utility::JsonObjectItem j: gltfTextureExtensions->asObject()) {
                         const Containers::StringView extensionName = j.key();
                         const bool isKhrTextureKtx = extensionName == "KHR_texture_ktx"_s;
@@ -1398,6 +2338,8 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
                            3D for all we know */
                         if(!isKhrTextureKtx && !isRecognized2DTextureExtension(extensionName))
                             continue;
+                        if(preferredExtension && extensionName != preferredExtension)
+                            continue;
 
                         if(!gltf->parseObject(j.value())) {
                             Error{} << "Trade::GltfImporter::openData(): invalid" << extensionName << "extension in texture" << i;
@@ -1518,11 +2460,121 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
 
     /* Allocate storage for parsed buffers, buffer views and accessors */
     _d->buffers = Containers::Array<Containers::Optional<Containers::Array<char>>>{_d->gltfBuffers.size()};
+    _d->meshoptDecodedBuffers = Containers::Array<Containers::Optional<Containers::Array<char>>>{_d->gltfBuffers.size()};
+    #ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+    _d->dracoPrimitives = Containers::Array<Containers::Optional<Document::DracoPrimitive>>{_d->gltfMeshPrimitiveMap.size()};
+    #endif
+    /* If all images are opened upfront, there has to be a slot for every one
+       of them */
+    _d->openImagesOnOpen = configuration().value<bool>("openImagesOnOpen") && manager();
+    _d->imageImporters = Containers::Array<Document::ImageImporter>{Math::max(configuration().value<UnsignedInt>("imageImporterCacheSize"), Math::max(_d->openImagesOnOpen ? UnsignedInt(_d->gltfImages.size()) : 0u, 1u))};
     _d->bufferViews = Containers::Array<Containers::Optional<Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt>>>{_d->gltfBufferViews.size()};
     _d->accessors = Containers::Array<Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>>>{_d->gltfAccessors.size()};
     _d->samplers = Containers::Array<Containers::Optional<Document::Sampler>>{_d->gltfSamplers.size()};
+    if(configuration().value<bool>("cacheTexturesAndMaterials")) {
+        _d->textureCache = Containers::Array<Containers::Optional<TextureData>>{_d->uniqueTextures.size()};
+        _d->materialCache = Containers::Array<Containers::Optional<MaterialData>>{_d->gltfMaterials.size()};
+    }
+    if(configuration().value<bool>("zeroCopySkins")) {
+        _d->skins = Containers::Array<Containers::Optional<Containers::Pair<Containers::ArrayView<const UnsignedInt>, Containers::ArrayView<const Matrix4>>>>{_d->gltfSkins.size()};
+        _d->skinData = Containers::Array<Containers::Array<char>>{_d->gltfSkins.size()};
+    }
+
+    /* If requested, parse all properties of mesh primitives and the accessors
+       they reference upfront so doMesh() only reads already-parsed state.
+       Errors are silenced here, failed accessors stay a NullOpt and so the
+       same error gets printed again once the particular mesh is imported. */
+    if(configuration().value<bool>("parseMeshesOnOpen")) {
+        Error silenceError{nullptr};
+        for(const Containers::Pair<std::size_t, Containers::Reference<const Utility::JsonToken>>& meshPrimitive: _d->gltfMeshPrimitiveMap) {
+            const Utility::JsonToken& gltfPrimitive = meshPrimitive.second();
+            if(const Utility::JsonToken* gltfMode = gltfPrimitive.find("mode"_s))
+                _d->gltf->parseUnsignedInt(*gltfMode);
+            if(const Utility::JsonToken* gltfIndices = gltfPrimitive.find("indices"_s)) {
+                if(_d->gltf->parseUnsignedInt(*gltfIndices))
+                    parseAccessor("Trade::GltfImporter::openData():", gltfIndices->asUnsignedInt());
+            }
+            /* Attribute and morph target objects were parsed above already */
+            if(const Utility::JsonToken* gltfAttributes = gltfPrimitive.find("attributes"_s)) {
+                for(Utility::JsonObjectItem gltfAttribute: gltfAttributes->asObject())
+                    if(_d->gltf->parseUnsignedInt(gltfAttribute.value()))
+                        parseAccessor("Trade::GltfImporter::openData():", gltfAttribute.value().asUnsignedInt());
+            }
+            /* The extensions object is looked at by doMesh() for
+               KHR_draco_mesh_compression. With Draco, also everything the
+               decoding parses, including formats of accessors that have no
+               buffer view and thus aren't parsed by parseAccessor(). The
+               decoding itself is still done on first access, writing only to
+               the slot of given primitive. */
+            if(const Utility::JsonToken* gltfExtensions = gltfPrimitive.find("extensions"_s)) {
+                #ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+                const Utility::JsonToken* const gltfDracoCompression = _d->gltf->parseObject(*gltfExtensions) ? gltfExtensions->find("KHR_draco_mesh_compression"_s) : nullptr;
+                if(gltfDracoCompression && _d->gltf->parseObject(*gltfDracoCompression)) {
+                    if(const Utility::JsonToken* gltfBufferViewId = gltfDracoCompression->find("bufferView"_s)) {
+                        if(_d->gltf->parseUnsignedInt(*gltfBufferViewId))
+                            parseBufferView("Trade::GltfImporter::openData():", gltfBufferViewId->asUnsignedInt());
+                    }
+                    if(const Utility::JsonToken* gltfDracoAttributes = gltfDracoCompression->find("attributes"_s)) {
+                        if(_d->gltf->parseObject(*gltfDracoAttributes))
+                            for(Utility::JsonObjectItem gltfDracoAttribute: gltfDracoAttributes->asObject())
+                                _d->gltf->parseUnsignedInt(gltfDracoAttribute.value());
+                    }
+                    if(const Utility::JsonToken* gltfIndices = gltfPrimitive.find("indices"_s)) {
+                        if(_d->gltf->parseUnsignedInt(*gltfIndices) && gltfIndices->asUnsignedInt() < _d->gltfAccessors.size())
+                            parseAccessorFormat("Trade::GltfImporter::openData():", gltfIndices->asUnsignedInt());
+                    }
+                    if(const Utility::JsonToken* gltfAttributes = gltfPrimitive.find("attributes"_s)) {
+                        for(Utility::JsonObjectItem gltfAttribute: gltfAttributes->asObject())
+                            if(_d->gltf->parseUnsignedInt(gltfAttribute.value()) && gltfAttribute.value().asUnsignedInt() < _d->gltfAccessors.size())
+                                parseAccessorFormat("Trade::GltfImporter::openData():", gltfAttribute.value().asUnsignedInt());
+                    }
+                }
+                #else
+                _d->gltf->parseObject(*gltfExtensions);
+                #endif
+            }
+            /* Morph targets can be sparse, for those the buffer views get
+               parsed and the result is thrown away */
+            if(const Utility::JsonToken* gltfTargets = gltfPrimitive.find("targets"_s)) {
+                for(Utility::JsonArrayItem gltfTarget: gltfTargets->asArray())
+                    for(Utility::JsonObjectItem gltfMorphAttribute: gltfTarget.value().asObject()) {
+                        if(!_d->gltf->parseUnsignedInt(gltfMorphAttribute.value()))
+                            continue;
+                        const UnsignedInt accessorId = gltfMorphAttribute.value().asUnsignedInt();
+                        if(accessorId < _d->gltfAccessors.size() && _d->gltfAccessors[accessorId]->find("sparse"_s))
+                            parseSparseAccessor("Trade::GltfImporter::openData():", accessorId);
+                        else
+                            parseAccessor("Trade::GltfImporter::openData():", accessorId);
+                    }
+            }
+        }
+    }
 
-    /* Name maps are lazy-loaded because these might not be needed every time */
+    /* Errors from opening the images are printed here, as there's no way to
+       defer them without redoing the whole process on import. Subsequent
+       import of such an image fails without printing anything, which is
+       the same as when a lazily opened image gets imported again. */
+    if(_d->openImagesOnOpen) {
+        for(std::size_t i = 0; i != _d->imagesByDimension.size(); ++i)
+            setupOrReuseImporterForImage("Trade::GltfImporter::openData():", _d->imagesByDimension[i], i < _d->image2DCount ? 2 : 3);
+    }
+
+    /* Name maps are by default lazy-loaded because these might not be needed
+       every time. If requested to build them upfront, the lookup functions
+       with an empty name will do it. */
+    if(configuration().value<bool>("buildNameMapsOnOpen")) {
+        doAnimationForName({});
+        doCameraForName({});
+        doLightForName({});
+        doSceneForName({});
+        doObjectForName({});
+        doSkin3DForName({});
+        doMeshForName({});
+        doMaterialForName({});
+        doTextureForName({});
+        doImage2DForName({});
+        doImage3DForName({});
+    }
 }
 
 UnsignedInt GltfImporter::doAnimationCount() const {
@@ -1591,6 +2643,42 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
 
     const Containers::StridedArrayView1D<Containers::Reference<const Utility::JsonToken>> gltfAnimations = stridedArrayView(_d->gltfAnimations.slice(animationBegin, animationEnd)).slice(&decltype(_d->gltfAnimations)::Type::first);
 
+    /* Subset of tracks to import. Empty node list means all nodes, a sorted
+       list is then searched for each channel. */
+    Containers::Array<UnsignedInt> targetNodes;
+    for(const Containers::StringView node: configuration().value<Containers::StringView>("animationTargetNodes").splitOnWhitespaceWithoutEmptyParts()) {
+        const Containers::String nodeString = node;
+        char* end;
+        const unsigned long nodeId = std::strtoul(nodeString.data(), &end, 10);
+        if(!std::isdigit(static_cast<unsigned char>(nodeString.front())) || end != nodeString.end()) {
+            Error{} << "Trade::GltfImporter::animation(): invalid animationTargetNodes entry" << node;
+            return {};
+        }
+        arrayAppend(targetNodes, UnsignedInt(nodeId));
+    }
+    std::sort(targetNodes.begin(), targetNodes.end());
+
+    enum: UnsignedByte {
+        AnimationTargetPathTranslation = 1 << 0,
+        AnimationTargetPathRotation = 1 << 1,
+        AnimationTargetPathScale = 1 << 2
+    };
+    UnsignedByte targetPaths = 0;
+    for(const Containers::StringView path: configuration().value<Containers::StringView>("animationTargetPaths").splitOnWhitespaceWithoutEmptyParts()) {
+        if(path == "translation"_s)
+            targetPaths |= AnimationTargetPathTranslation;
+        else if(path == "rotation"_s)
+            targetPaths |= AnimationTargetPathRotation;
+        else if(path == "scale"_s)
+            targetPaths |= AnimationTargetPathScale;
+        else {
+            Error{} << "Trade::GltfImporter::animation(): invalid animationTargetPaths entry" << path;
+            return {};
+        }
+    }
+    if(!targetPaths)
+        targetPaths = AnimationTargetPathTranslation|AnimationTargetPathRotation|AnimationTargetPathScale;
+
     /* Parsed data for samplers in each processed animation. Stored in a
        contiguous array, data for sampler `j` of animation `i` is at
        `animationSamplerData[animationSamplerDataOffsets[i] + j]`. */
@@ -1607,10 +2695,12 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
        interpolation. The time track ID is initialized to ~UnsignedInt{} and
        will be used later to check that a spline track was not used with more
        than one time track, as it needs to be postprocessed for given time
-       track. */
+       track. The offset is assigned only once it's known that the data are
+       used by any of the imported tracks. */
     struct SamplerData {
         std::size_t outputOffset;
         UnsignedInt timeTrack;
+        bool used;
     };
     std::unordered_map<UnsignedInt, SamplerData> samplerData;
     std::size_t dataSize = 0;
@@ -1664,26 +2754,22 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
 
             /** @todo handle alignment once we do more than just four-byte types */
 
-            /* If the input view is not yet present in the output data buffer,
-               add it */
+            /* If the input view is not yet known, parse and remember it */
             if(samplerData.find(gltfAnimationSamplerInput->asUnsignedInt()) == samplerData.end()) {
                 const Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> accessor = parseAccessor("Trade::GltfImporter::animation():", gltfAnimationSamplerInput->asUnsignedInt());
                 if(!accessor)
                     return {};
 
-                samplerData.emplace(gltfAnimationSamplerInput->asUnsignedInt(), SamplerData{dataSize, ~UnsignedInt{}});
-                dataSize += accessor->first().size()[0]*accessor->first().size()[1];
+                samplerData.emplace(gltfAnimationSamplerInput->asUnsignedInt(), SamplerData{~std::size_t{}, ~UnsignedInt{}, false});
             }
 
-            /* If the output view is not yet present in the output data buffer,
-               add it */
+            /* If the output view is not yet known, parse and remember it */
             if(samplerData.find(gltfAnimationSamplerOutput->asUnsignedInt()) == samplerData.end()) {
                 const Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> accessor = parseAccessor("Trade::GltfImporter::animation():", gltfAnimationSamplerOutput->asUnsignedInt());
                 if(!accessor)
                     return {};
 
-                samplerData.emplace(gltfAnimationSamplerOutput->asUnsignedInt(), SamplerData{dataSize, ~UnsignedInt{}});
-                dataSize += accessor->first().size()[0]*accessor->first().size()[1];
+                samplerData.emplace(gltfAnimationSamplerOutput->asUnsignedInt(), SamplerData{~std::size_t{}, ~UnsignedInt{}, false});
             }
 
             arrayAppend(animationSamplerData, InPlaceInit,
@@ -1698,27 +2784,18 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
        to get sampler count for animation `i` */
     animationSamplerDataOffsets[gltfAnimations.size()] = animationSamplerData.size();
 
-    /* Populate the data array */
-    /**
-     * @todo Once memory-mapped files are supported, this can all go away
-     *      except when spline tracks are present -- in that case we need to
-     *      postprocess them and can't just use the memory directly.
-     */
-    Containers::Array<char> data{dataSize};
-    for(const std::pair<const UnsignedInt, SamplerData>& view: samplerData) {
-        /* The accessor should be already parsed from above, so just retrieve
-           its view instead of going through parseAccessor() again */
-        const Containers::StridedArrayView2D<const char> src =
-            _d->accessors[view.first]->first();
-        const Containers::StridedArrayView2D<char> dst{
-            data.exceptPrefix(view.second.outputOffset), src.size()};
-        Utility::copy(src, dst);
-    }
-
     /* Calculate total track count. If merging all animations together, this is
-       the sum of all clip track counts. */
+       the sum of all clip track counts. Channels that aren't selected by the
+       animationTargetNodes / animationTargetPaths options are skipped, for
+       the rest the sampler data they use are marked so only those get
+       copied to the output. While at it, check whether the data can be
+       referenced directly -- that's possible only if none of them needs to
+       be postprocessed. */
+    bool zeroCopy = configuration().value<bool>("zeroCopyAnimations");
     std::size_t trackCount = 0;
-    for(const Utility::JsonToken& gltfAnimation: gltfAnimations) {
+    Containers::Array<bool> channelImported;
+    for(std::size_t i = 0; i != gltfAnimations.size(); ++i) {
+        const Utility::JsonToken& gltfAnimation = gltfAnimations[i];
         const Utility::JsonToken* const gltfAnimationChannels = gltfAnimation.find("channels"_s);
         if(!gltfAnimationChannels || !_d->gltf->parseArray(*gltfAnimationChannels)) {
             Error{} << "Trade::GltfImporter::animation(): missing or invalid channels property";
@@ -1737,22 +2814,6 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
                 return {};
             }
 
-            /* Skip animations without a target node. See comment below. Also,
-               we're not using the node value for anything here, so further
-               validation is done below. */
-            if(gltfAnimationChannelTarget->find("node"_s))
-                ++trackCount;
-        }
-    }
-
-    /* Import all tracks */
-    bool hadToRenormalize = false;
-    std::size_t trackId = 0;
-    Containers::Array<Trade::AnimationTrackData> tracks{trackCount};
-    for(std::size_t i = 0; i != gltfAnimations.size(); ++i) {
-        const Utility::JsonToken& gltfAnimation = gltfAnimations[i];
-        /* Channels parsed and checked above already, so can go directly here */
-        for(const Utility::JsonArrayItem gltfAnimationChannel: gltfAnimation["channels"_s].asArray()) {
             const Utility::JsonToken* const gltfSampler = gltfAnimationChannel.value().find("sampler"_s);
             if(!gltfSampler || !_d->gltf->parseUnsignedInt(*gltfSampler)) {
                 Error{} << "Trade::GltfImporter::animation(): missing or invalid channel" << gltfAnimationChannel.index() << "sampler property";
@@ -1763,18 +2824,18 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
                 Error{} << "Trade::GltfImporter::animation(): sampler index" << gltfSampler->asUnsignedInt() << "in channel" << gltfAnimationChannel.index() << "out of range for" << animationSamplerDataOffsets[i + 1] - animationSamplerDataOffset << "samplers";
                 return {};
             }
-            const AnimationSamplerData& sampler = animationSamplerData[animationSamplerDataOffset + gltfSampler->asUnsignedInt()];
 
             /* Skip animations without a target node. Consistent with
                tinygltf's behavior, currently there are no extensions for
                animating materials or anything else so there's no point in
                importing such animations. */
-            const Utility::JsonToken& gltfTarget = gltfAnimationChannel.value()["target"_s];
-            const Utility::JsonToken* gltfTargetNode = gltfTarget.find("node"_s);
+            const Utility::JsonToken* gltfTargetNode = gltfAnimationChannelTarget->find("node"_s);
             /** @todo revisit once KHR_animation2 is a thing:
                 https://github.com/KhronosGroup/glTF/pull/2033 */
-            if(!gltfTargetNode)
+            if(!gltfTargetNode) {
+                arrayAppend(channelImported, false);
                 continue;
+            }
 
             if(!_d->gltf->parseUnsignedInt(*gltfTargetNode)) {
                 Error{} << "Trade::GltfImporter::animation(): invalid channel" << gltfAnimationChannel.index() << "target node property";
@@ -1785,6 +2846,125 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
                 return {};
             }
 
+            const Utility::JsonToken* const gltfTargetPath = gltfAnimationChannelTarget->find("path"_s);
+            if(!gltfTargetPath || !_d->gltf->parseString(*gltfTargetPath)) {
+                Error{} << "Trade::GltfImporter::animation(): missing or invalid channel" << gltfAnimationChannel.index() << "target path property";
+                return {};
+            }
+
+            /* Skip tracks that aren't selected. Unknown paths are let through
+               so they fail the import below the same way as without any
+               selection. */
+            if((!targetNodes.isEmpty() && !std::binary_search(targetNodes.begin(), targetNodes.end(), gltfTargetNode->asUnsignedInt())) ||
+               (gltfTargetPath->asString() == "translation"_s && !(targetPaths & AnimationTargetPathTranslation)) ||
+               (gltfTargetPath->asString() == "rotation"_s && !(targetPaths & AnimationTargetPathRotation)) ||
+               (gltfTargetPath->asString() == "scale"_s && !(targetPaths & AnimationTargetPathScale)))
+            {
+                arrayAppend(channelImported, false);
+                continue;
+            }
+
+            arrayAppend(channelImported, true);
+            ++trackCount;
+
+            const AnimationSamplerData& sampler = animationSamplerData[animationSamplerDataOffset + gltfSampler->asUnsignedInt()];
+            samplerData.find(sampler.input)->second.used = true;
+            samplerData.find(sampler.output)->second.used = true;
+
+            /* Splines get postprocessed, so they have to be copied always.
+               Linear rotation tracks get patched only if they're not
+               normalized or don't use the shortest path already, check the
+               actual data for that. If the type doesn't match, the import
+               fails below, so don't bother. */
+            if(!zeroCopy) continue;
+            if(sampler.interpolation == Animation::Interpolation::Spline)
+                zeroCopy = false;
+            else if(gltfTargetPath->asString() == "rotation"_s) {
+                const Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>& output = *_d->accessors[sampler.output];
+                if(output.second() != VertexFormat::Vector4)
+                    continue;
+                const Containers::StridedArrayView1D<const Quaternion> values = Containers::arrayCast<1, const Quaternion>(output.first());
+                for(std::size_t j = 0; j != values.size(); ++j) {
+                    if((configuration().value<bool>("normalizeQuaternions") && !values[j].isNormalized()) ||
+                       (configuration().value<bool>("optimizeQuaternionShortestPath") && j + 1 < values.size() && Math::dot(values[j], values[j + 1]) < 0))
+                    {
+                        zeroCopy = false;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    /* Data for the imported tracks can be referenced directly only if they're
+       all in the same buffer, calculate the range spanning them */
+    Math::Range1D<std::size_t> bufferRange;
+    if(zeroCopy) {
+        UnsignedInt bufferId = ~UnsignedInt{};
+        for(const std::pair<const UnsignedInt, SamplerData>& view: samplerData) {
+            if(!view.second.used) continue;
+
+            const Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt>& bufferView = *_d->bufferViews[_d->accessors[view.first]->third()];
+            const Math::Range1D<std::size_t> range = Math::Range1D<std::size_t>::fromSize(reinterpret_cast<std::size_t>(bufferView.first().data()), bufferView.first().size());
+            if(bufferId == ~UnsignedInt{}) {
+                bufferId = bufferView.third();
+                bufferRange = range;
+            } else if(bufferView.third() != bufferId) {
+                zeroCopy = false;
+                break;
+            } else bufferRange = Math::join(bufferRange, range);
+        }
+    }
+
+    /* Otherwise populate the data array with just the data used by the
+       imported tracks. Assigning the offsets in order the samplers are
+       referenced to have a predictable layout. */
+    Containers::Array<char> data;
+    if(!zeroCopy) {
+        for(const AnimationSamplerData& sampler: animationSamplerData) {
+            for(const UnsignedInt accessorId: {sampler.input, sampler.output}) {
+                SamplerData& view = samplerData.find(accessorId)->second;
+                if(!view.used || view.outputOffset != ~std::size_t{}) continue;
+
+                view.outputOffset = dataSize;
+                const Containers::StridedArrayView2D<const char> src = _d->accessors[accessorId]->first();
+                dataSize += src.size()[0]*src.size()[1];
+            }
+        }
+
+        data = Containers::Array<char>{dataSize};
+        for(const std::pair<const UnsignedInt, SamplerData>& view: samplerData) {
+            if(!view.second.used) continue;
+
+            /* The accessor should be already parsed from above, so just
+               retrieve its view instead of going through parseAccessor()
+               again */
+            const Containers::StridedArrayView2D<const char> src =
+                _d->accessors[view.first]->first();
+            const Containers::StridedArrayView2D<char> dst{
+                data.exceptPrefix(view.second.outputOffset), src.size()};
+            Utility::copy(src, dst);
+        }
+    }
+
+    /* Import all selected tracks */
+    bool hadToRenormalize = false;
+    std::size_t trackId = 0;
+    std::size_t channelId = 0;
+    Containers::Array<Trade::AnimationTrackData> tracks{trackCount};
+    for(std::size_t i = 0; i != gltfAnimations.size(); ++i) {
+        const Utility::JsonToken& gltfAnimation = gltfAnimations[i];
+        /* Channels, their samplers, target nodes and paths parsed and checked
+           above already, so can go directly here */
+        for(const Utility::JsonArrayItem gltfAnimationChannel: gltfAnimation["channels"_s].asArray()) {
+            if(!channelImported[channelId++])
+                continue;
+
+            const AnimationSamplerData& sampler = animationSamplerData[animationSamplerDataOffsets[i] + gltfAnimationChannel.value()["sampler"_s].asUnsignedInt()];
+            const Utility::JsonToken& gltfTarget = gltfAnimationChannel.value()["target"_s];
+            const Utility::JsonToken& gltfTargetNode = gltfTarget["node"_s];
+            const Utility::JsonToken& gltfTargetPath = gltfTarget["path"_s];
+
             /* Key properties -- always float time. Again, the accessor should
                be already parsed from above, so just retrieve its view instead
                of going through parseAccessor() again. */
@@ -1796,14 +2976,6 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
                 return {};
             }
 
-            /* View on the key data */
-            const auto inputDataFound = samplerData.find(sampler.input);
-            CORRADE_INTERNAL_ASSERT(inputDataFound != samplerData.end());
-            const auto keys = Containers::arrayCast<Float>(data.sliceSize(
-                inputDataFound->second.outputOffset,
-                input.first().size()[0]*
-                input.first().size()[1]));
-
             /* Decide on value properties. Again, the accessor should be
                already parsed from above, so just retrieve its view instead of
                going through parseAccessor() again. */
@@ -1813,26 +2985,35 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
             Containers::StridedArrayView1D<const void> typeErasedValues;
             const auto outputDataFound = samplerData.find(sampler.output);
             CORRADE_INTERNAL_ASSERT(outputDataFound != samplerData.end());
-            const auto outputData = data.sliceSize(
-                outputDataFound->second.outputOffset,
-                output.first().size()[0]*
-                output.first().size()[1]);
             UnsignedInt& timeTrackUsed = outputDataFound->second.timeTrack;
 
+            /* View on the key and value data, either the accessor memory
+               directly or the copy */
+            Containers::StridedArrayView1D<const Float> keys;
+            Containers::ArrayView<char> outputData;
+            if(zeroCopy) {
+                keys = Containers::arrayCast<1, const Float>(input.first());
+            } else {
+                const auto inputDataFound = samplerData.find(sampler.input);
+                CORRADE_INTERNAL_ASSERT(inputDataFound != samplerData.end());
+                keys = Containers::arrayCast<const Float>(data.sliceSize(
+                    inputDataFound->second.outputOffset,
+                    input.first().size()[0]*
+                    input.first().size()[1]));
+                outputData = data.sliceSize(
+                    outputDataFound->second.outputOffset,
+                    output.first().size()[0]*
+                    output.first().size()[1]);
+            }
+
             const std::size_t valuesPerKey = sampler.interpolation == Animation::Interpolation::Spline ? 3 : 1;
             if(input.first().size()[0]*valuesPerKey != output.first().size()[0]) {
                 Error{} << "Trade::GltfImporter::animation(): channel" << gltfAnimationChannel.index() << "target track size doesn't match time track size, expected" << output.first().size()[0] << "but got" << input.first().size()[0]*valuesPerKey;
                 return {};
             }
 
-            const Utility::JsonToken* const gltfTargetPath = gltfTarget.find("path"_s);
-            if(!gltfTargetPath || !_d->gltf->parseString(*gltfTargetPath)) {
-                Error{} << "Trade::GltfImporter::animation(): missing or invalid channel" << gltfAnimationChannel.index() << "target path property";
-                return {};
-            }
-
             /* Translation */
-            if(gltfTargetPath->asString() == "translation"_s) {
+            if(gltfTargetPath.asString() == "translation"_s) {
                 if(output.second() != VertexFormat::Vector3) {
                     /* Since we're abusing VertexFormat for all formats, print
                        just the enum value without the prefix to avoid
@@ -1849,17 +3030,20 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
                        for every track -- postprocessSplineTrack() checks
                        that. */
                     const auto values = Containers::arrayCast<CubicHermite3D>(outputData);
-                    postprocessSplineTrack(timeTrackUsed, keys, values);
+                    postprocessSplineTrack(timeTrackUsed, keys.asContiguous(), values);
 
                     type = AnimationTrackType::CubicHermite3D;
                     typeErasedValues = values;
                 } else {
                     type = AnimationTrackType::Vector3;
-                    typeErasedValues = Containers::arrayCast<Vector3>(outputData);
+                    if(zeroCopy)
+                        typeErasedValues = Containers::arrayCast<1, const Vector3>(output.first());
+                    else
+                        typeErasedValues = Containers::arrayCast<Vector3>(outputData);
                 }
 
             /* Rotation */
-            } else if(gltfTargetPath->asString() == "rotation"_s) {
+            } else if(gltfTargetPath.asString() == "rotation"_s) {
                 /** @todo rotation can be also normalized (?!) to a vector of 8/16bit (signed?!) integers */
 
                 if(output.second() != VertexFormat::Vector4) {
@@ -1878,10 +3062,14 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
                        for every track -- postprocessSplineTrack() checks
                        that. */
                     const auto values = Containers::arrayCast<CubicHermiteQuaternion>(outputData);
-                    postprocessSplineTrack(timeTrackUsed, keys, values);
+                    postprocessSplineTrack(timeTrackUsed, keys.asContiguous(), values);
 
                     type = AnimationTrackType::CubicHermiteQuaternion;
                     typeErasedValues = values;
+                } else if(zeroCopy) {
+                    /* Checked above that the data don't need any patching */
+                    type = AnimationTrackType::Quaternion;
+                    typeErasedValues = Containers::arrayCast<1, const Quaternion>(output.first());
                 } else {
                     /* Ensure shortest path is always chosen. Not doing this
                        for spline interpolation, there it would cause war and
@@ -1912,7 +3100,7 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
                 }
 
             /* Scale */
-            } else if(gltfTargetPath->asString() == "scale"_s) {
+            } else if(gltfTargetPath.asString() == "scale"_s) {
                 if(output.second() != VertexFormat::Vector3) {
                     /* Since we're abusing VertexFormat for all formats, print
                        just the enum value without the prefix to avoid
@@ -1929,17 +3117,20 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
                        for every track -- postprocessSplineTrack() checks
                        that. */
                     const auto values = Containers::arrayCast<CubicHermite3D>(outputData);
-                    postprocessSplineTrack(timeTrackUsed, keys, values);
+                    postprocessSplineTrack(timeTrackUsed, keys.asContiguous(), values);
 
                     type = AnimationTrackType::CubicHermite3D;
                     typeErasedValues = values;
                 } else {
                     type = AnimationTrackType::Vector3;
-                    typeErasedValues = Containers::arrayCast<Vector3>(outputData);
+                    if(zeroCopy)
+                        typeErasedValues = Containers::arrayCast<1, const Vector3>(output.first());
+                    else
+                        typeErasedValues = Containers::arrayCast<Vector3>(outputData);
                 }
 
             } else {
-                Error{} << "Trade::GltfImporter::animation(): unsupported track target" << gltfTargetPath->asString();
+                Error{} << "Trade::GltfImporter::animation(): unsupported track target" << gltfTargetPath.asString();
                 return {};
             }
 
@@ -1957,7 +3148,7 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
             }
 
             tracks[trackId++] = AnimationTrackData{
-                target, gltfTargetNode->asUnsignedInt(),
+                target, gltfTargetNode.asUnsignedInt(),
                 type, resultType, keys, typeErasedValues,
                 sampler.interpolation, Animation::Extrapolation::Constant};
         }
@@ -1966,9 +3157,13 @@ Containers::Optional<AnimationData> GltfImporter::doAnimation(UnsignedInt id) {
     if(hadToRenormalize && !(flags() & ImporterFlag::Quiet))
         Warning{} << "Trade::GltfImporter::animation(): quaternions in some rotation tracks were renormalized";
 
+    const void* const importerState = configuration().value<bool>("mergeAnimationClips") ? nullptr : &*_d->gltfAnimations[id].first();
+    if(zeroCopy) return AnimationData{DataFlags{},
+        Containers::ArrayView<const void>{reinterpret_cast<const void*>(bufferRange.min()), bufferRange.size()},
+        Utility::move(tracks), importerState};
+
     return AnimationData{Utility::move(data), Utility::move(tracks),
-        configuration().value<bool>("mergeAnimationClips") ? nullptr :
-        &*_d->gltfAnimations[id].first()};
+        importerState};
 }
 
 UnsignedInt GltfImporter::doCameraCount() const {
@@ -2303,20 +3498,21 @@ Containers::String GltfImporter::doSceneName(const UnsignedInt id) {
 namespace {
 
 /* Used by doScene() but it's recursive and so it can't be a local lambda */
-void parseSceneExtraFields(Utility::Json& gltf, const ImporterFlags flags, const std::unordered_map<Containers::String, SceneField>& sceneFieldsForName, const Containers::ArrayView<const Containers::Triple<Containers::StringView, SceneFieldType, SceneFieldFlags>> sceneFieldNamesTypesFlags, const Containers::ArrayView<UnsignedInt> extraMappingOffsets, const Containers::ArrayView<UnsignedInt> extraDataOffsets, const Containers::ArrayView<UnsignedInt> extraBitOffsets, const Containers::ArrayView<UnsignedInt> extraStringOffsets, const UnsignedInt nodeI, const Containers::StringView key, const Utility::JsonToken& gltfExtraValue) {
+void parseSceneExtraFields(Utility::Json& gltf, const ImporterFlags flags, const std::unordered_map<Containers::String, SceneField>& sceneFieldsForName, const Containers::ArrayView<const Containers::Triple<Containers::StringView, SceneFieldType, SceneFieldFlags>> sceneFieldNamesTypesFlags, const Containers::ArrayView<UnsignedInt> extraMappingOffsets, const Containers::ArrayView<UnsignedInt> extraDataOffsets, const Containers::ArrayView<UnsignedInt> extraBitOffsets, const Containers::ArrayView<UnsignedInt> extraStringOffsets, Containers::Array<char>& keyStorage, const UnsignedInt nodeI, const Containers::StringView key, const Utility::JsonToken& gltfExtraValue) {
     /* If the value is an object, recurse into it. The field name will then be
        all object keys concatenated with dots. */
     if(gltfExtraValue.type() == Utility::JsonToken::Type::Object) for(const Utility::JsonObjectItem gltfNestedExtra: gltfExtraValue.asObject()) {
         parseSceneExtraFields(gltf, flags, sceneFieldsForName,
             sceneFieldNamesTypesFlags, extraMappingOffsets, extraDataOffsets,
-            extraBitOffsets, extraStringOffsets, nodeI,
-            "."_s.join({key, gltfNestedExtra.key()}), gltfNestedExtra.value());
+            extraBitOffsets, extraStringOffsets, keyStorage, nodeI,
+            sceneExtraKey(keyStorage, key, gltfNestedExtra.key()),
+            gltfNestedExtra.value());
 
     /* Scalars */
     } else if(gltfExtraValue.type() == Utility::JsonToken::Type::Bool ||
               gltfExtraValue.type() == Utility::JsonToken::Type::Number ||
               gltfExtraValue.type() == Utility::JsonToken::Type::String) {
-        const UnsignedInt customFieldId = sceneFieldCustom(sceneFieldsForName.at(key));
+        const UnsignedInt customFieldId = sceneFieldCustom(sceneFieldsForName.at(Containers::String::nullTerminatedView(key)));
         if(sceneFieldNamesTypesFlags[customFieldId].third() & SceneFieldFlag::MultiEntry) {
             if(!(flags & ImporterFlag::Quiet))
                 Warning{} << "Trade::GltfImporter::scene(): node" << nodeI << "extras" << key << "property was expected to be an array, skipping";
@@ -2385,7 +3581,7 @@ void parseSceneExtraFields(Utility::Json& gltf, const ImporterFlags flags, const
             return;
         }
 
-        const UnsignedInt customFieldId = sceneFieldCustom(sceneFieldsForName.at(key));
+        const UnsignedInt customFieldId = sceneFieldCustom(sceneFieldsForName.at(Containers::String::nullTerminatedView(key)));
         if(!(sceneFieldNamesTypesFlags[customFieldId].third() & SceneFieldFlag::MultiEntry)) {
             if(!(flags & ImporterFlag::Quiet))
                 Warning{} << "Trade::GltfImporter::scene(): node" << nodeI << "extras" << key << "property was not expected to be an array, skipping";
@@ -2438,7 +3634,7 @@ void parseSceneExtraFields(Utility::Json& gltf, const ImporterFlags flags, const
         Warning{} << "Trade::GltfImporter::scene(): node" << nodeI << "extras" << key << "property is" << gltfExtraValue.type() << Debug::nospace << ", skipping";
 }
 
-void collectSceneExtraFields(const std::unordered_map<Containers::String, SceneField>& sceneFieldsForName, const Containers::ArrayView<const Containers::Triple<Containers::StringView, SceneFieldType, SceneFieldFlags>> sceneFieldNamesTypesFlags, const Containers::ArrayView<UnsignedInt> extraMappingOffsets, const Containers::ArrayView<UnsignedInt> extraMappings, const Containers::ArrayView<UnsignedInt> extraDataOffsets, const Containers::ArrayView<UnsignedInt> extrasUnsignedInt, const Containers::ArrayView<Int> extrasInt, const Containers::ArrayView<Float> extrasFloat, const Containers::ArrayView<UnsignedInt> extraBitOffsets, const Containers::MutableBitArrayView extrasBits, const Containers::ArrayView<UnsignedInt> extraStringOffsets, const Containers::ArrayView<UnsignedInt> baseStringOffsets, const Containers::MutableStringView extrasStrings, const UnsignedInt nodeI, const Containers::StringView key, const Utility::JsonToken& gltfExtraValue) {
+void collectSceneExtraFields(const std::unordered_map<Containers::String, SceneField>& sceneFieldsForName, const Containers::ArrayView<const Containers::Triple<Containers::StringView, SceneFieldType, SceneFieldFlags>> sceneFieldNamesTypesFlags, const Containers::ArrayView<UnsignedInt> extraMappingOffsets, const Containers::ArrayView<UnsignedInt> extraMappings, const Containers::ArrayView<UnsignedInt> extraDataOffsets, const Containers::ArrayView<UnsignedInt> extrasUnsignedInt, const Containers::ArrayView<Int> extrasInt, const Containers::ArrayView<Float> extrasFloat, const Containers::ArrayView<UnsignedInt> extraBitOffsets, const Containers::MutableBitArrayView extrasBits, const Containers::ArrayView<UnsignedInt> extraStringOffsets, const Containers::ArrayView<UnsignedInt> baseStringOffsets, const Containers::MutableStringView extrasStrings, Containers::Array<char>& keyStorage, const UnsignedInt nodeI, const Containers::StringView key, const Utility::JsonToken& gltfExtraValue) {
     /* If the value is an object, recurse into it. The field name will then be
        all object keys concatenated with dots. */
     if(gltfExtraValue.type() == Utility::JsonToken::Type::Object) for(const Utility::JsonObjectItem gltfNestedExtra: gltfExtraValue.asObject()) {
@@ -2446,7 +3642,9 @@ void collectSceneExtraFields(const std::unordered_map<Containers::String, SceneF
             extraMappingOffsets, extraMappings, extraDataOffsets,
             extrasUnsignedInt, extrasInt, extrasFloat, extraBitOffsets,
             extrasBits, extraStringOffsets, baseStringOffsets, extrasStrings,
-            nodeI, "."_s.join({key, gltfNestedExtra.key()}), gltfNestedExtra.value());
+            keyStorage, nodeI,
+            sceneExtraKey(keyStorage, key, gltfNestedExtra.key()),
+            gltfNestedExtra.value());
 
     /* Arrays */
     } else if(gltfExtraValue.type() == Utility::JsonToken::Type::Array) {
@@ -2461,7 +3659,7 @@ void collectSceneExtraFields(const std::unordered_map<Containers::String, SceneF
             *arrayType == Utility::JsonToken::Type::Number ||
             *arrayType == Utility::JsonToken::Type::String);
 
-        const UnsignedInt customFieldId = sceneFieldCustom(sceneFieldsForName.at(key));
+        const UnsignedInt customFieldId = sceneFieldCustom(sceneFieldsForName.at(Containers::String::nullTerminatedView(key)));
 
         /* Now the offsets are shifted by 1, after this loop they'll be shifted
            by 0 for the final SceneFieldData population. All these are done
@@ -2509,7 +3707,7 @@ void collectSceneExtraFields(const std::unordered_map<Containers::String, SceneF
         gltfExtraValue.type() == Utility::JsonToken::Type::Number ||
         gltfExtraValue.type() == Utility::JsonToken::Type::String
     )) {
-        const UnsignedInt customFieldId = sceneFieldCustom(sceneFieldsForName.at(key));
+        const UnsignedInt customFieldId = sceneFieldCustom(sceneFieldsForName.at(Containers::String::nullTerminatedView(key)));
 
         /* Now the offsets are shifted by 1, after this loop they'll be shifted
            by 0 for the final SceneFieldData population */
@@ -2548,45 +3746,72 @@ void collectSceneExtraFields(const std::unordered_map<Containers::String, SceneF
 }
 
 Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doScene", {}, id};
+    MAGNUM_PROFILING_ZONE("GltfImporter::doScene()");
     const Utility::JsonToken& gltfScene = _d->gltfScenes[id].first();
 
+    /* All temporary per-scene data go into a single allocation, with sizes
+       known upfront. Each node has at most one parent, which is checked in
+       doOpenData() already, so a scene can't have more objects than there are
+       nodes. For the extra field offsets see below. */
+    Containers::ArrayView<UnsignedInt> objectStorage;
+    Containers::ArrayView<UnsignedInt> childrenStorage;
+    Containers::ArrayView<UnsignedInt> extraMappingOffsets;
+    Containers::ArrayView<UnsignedInt> extraDataOffsets;
+    Containers::ArrayView<UnsignedInt> extraBitOffsets;
+    Containers::ArrayView<UnsignedInt> extraStringOffsets;
+    /* Stores a copy of extraStringOffsets, see detailed comment when populated
+       below */
+    Containers::ArrayView<UnsignedInt> baseStringOffsets;
+    Containers::ArrayTuple scratchStorage{
+        {NoInit, _d->gltfNodes.size(), objectStorage},
+        {NoInit, _d->gltfNodes.size() + 2, childrenStorage},
+        {ValueInit, _d->sceneFieldNamesTypesFlags.size() + 2, extraMappingOffsets},
+        {ValueInit, _d->sceneFieldNamesTypesFlags.size() + 2, extraDataOffsets},
+        {ValueInit, _d->sceneFieldNamesTypesFlags.size() + 2, extraBitOffsets},
+        {ValueInit, _d->sceneFieldNamesTypesFlags.size() + 2, extraStringOffsets},
+        {ValueInit, _d->sceneFieldNamesTypesFlags.size(), baseStringOffsets}
+    };
+
     /* Gather all top-level nodes belonging to a scene and recursively populate
-       the children ranges. Optimistically assume the glTF has just a single
-       scene and reserve for that. */
+       the children ranges. */
     /** @todo once we have BitArrays use the objects array to mark nodes that
         are present in the scene and then create a new array from those but
         ordered so we can have OrderedMapping for parents and also all other
         fields */
-    Containers::Array<UnsignedInt> objects;
-    arrayReserve(objects, _d->gltfNodes.size());
+    std::size_t objectCount = 0;
     if(const Utility::JsonToken* const gltfSceneNodes = gltfScene.find("nodes"_s)) {
         /* Scene node array parsed in doOpenData() already, for cycle
            detection. Bounds checked there as well, so we can just directly
            copy the contents. */
         const Containers::StridedArrayView1D<const UnsignedInt> sceneNodes = gltfSceneNodes->asUnsignedIntArray();
-        Utility::copy(sceneNodes, arrayAppend(objects, NoInit, sceneNodes.size()));
+        Utility::copy(sceneNodes, objectStorage.prefix(sceneNodes.size()));
+        objectCount += sceneNodes.size();
     }
 
     /* Offset array, `children[i + 1]` to `children[i + 2]` defines a range in
        `objects` containing children of object `i`, `children[0]` to
        `children[1]` is the range of root objects with `children[0]` being
        always `0` */
-    Containers::Array<UnsignedInt> children;
-    arrayReserve(children, _d->gltfNodes.size() + 2);
-    arrayAppend(children, {0u, UnsignedInt(objects.size())});
-    for(std::size_t i = 0; i != children.size() - 1; ++i) {
-        for(std::size_t j = children[i], jMax = children[i + 1]; j != jMax; ++j) {
-            const Utility::JsonToken& gltfNode = _d->gltfNodes[objects[j]].first();
+    childrenStorage[0] = 0;
+    childrenStorage[1] = objectCount;
+    std::size_t childrenCount = 2;
+    for(std::size_t i = 0; i != childrenCount - 1; ++i) {
+        for(std::size_t j = childrenStorage[i], jMax = childrenStorage[i + 1]; j != jMax; ++j) {
+            const Utility::JsonToken& gltfNode = _d->gltfNodes[objectStorage[j]].first();
             if(const Utility::JsonToken* const gltfNodeChildren = gltfNode.find("children"_s)) {
                 /* Node children array parsed in doOpenData() already, for
                    cycle detection. Bounds checked there as well, so we can
                    just directly copy the contents. */
                 const Containers::StridedArrayView1D<const UnsignedInt> nodeChildren = gltfNodeChildren->asUnsignedIntArray();
-                Utility::copy(nodeChildren, arrayAppend(objects, NoInit, nodeChildren.size()));
+                Utility::copy(nodeChildren, objectStorage.sliceSize(objectCount, nodeChildren.size()));
+                objectCount += nodeChildren.size();
             }
-            arrayAppend(children, UnsignedInt(objects.size()));
+            childrenStorage[childrenCount++] = objectCount;
         }
     }
+    const Containers::ArrayView<const UnsignedInt> objects = objectStorage.prefix(objectCount);
+    const Containers::ArrayView<const UnsignedInt> children = childrenStorage.prefix(childrenCount);
 
     /** @todo once there's SceneData::mappingRange(), calculate also min here */
     const UnsignedInt maxObjectIndexPlusOne = objects.isEmpty() ? 0 : Math::max(objects) + 1;
@@ -2606,27 +3831,21 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
     UnsignedInt lightCount = 0;
     UnsignedInt cameraCount = 0;
     UnsignedInt skinCount = 0;
+    UnsignedInt instanceCount = 0;
+    bool hasInstanceTranslations = false;
+    bool hasInstanceRotations = false;
+    bool hasInstanceScalings = false;
     /* Separate counter for every recognized extra field. Mappings are put into
        `extraMappingOffsets`, number and string fields are put into
        `extraDataOffsets`, bit fields into `extraBitOffsets` and string data
        into `extraStringOffsets` (i.e., an element is never non-zero in both `extraDataOffsets` and `extraBitOffsets`, in case of strings it's both
        `extraDataOffsets` and `extraStringOffsets` used). These are then turned
        into offsets into `extraMappings`, `extrasUnsignedInt ` and `extrasBits`
-       arrays, for which there's two extra items at the front. */
-    Containers::ArrayView<UnsignedInt> extraMappingOffsets;
-    Containers::ArrayView<UnsignedInt> extraDataOffsets;
-    Containers::ArrayView<UnsignedInt> extraBitOffsets;
-    Containers::ArrayView<UnsignedInt> extraStringOffsets;
-    /* Stores a copy of extraStringOffsets, see detailed comment when populated
-       below */
-    Containers::ArrayView<UnsignedInt> baseStringOffsets;
-    Containers::ArrayTuple extraOffsetStorage{
-        {ValueInit, _d->sceneFieldNamesTypesFlags.size() + 2, extraMappingOffsets},
-        {ValueInit, _d->sceneFieldNamesTypesFlags.size() + 2, extraDataOffsets},
-        {ValueInit, _d->sceneFieldNamesTypesFlags.size() + 2, extraBitOffsets},
-        {ValueInit, _d->sceneFieldNamesTypesFlags.size() + 2, extraStringOffsets},
-        {ValueInit, _d->sceneFieldNamesTypesFlags.size(), baseStringOffsets}
-    };
+       arrays, for which there's two extra items at the front. The arrays are
+       allocated above. */
+    /* Dot-separated names of nested extras are assembled here, reused for all
+       nodes in both passes */
+    Containers::Array<char> extraKeyStorage;
     for(const UnsignedInt i: objects) {
         const Utility::JsonToken& gltfNode = _d->gltfNodes[i].first();
 
@@ -2734,6 +3953,71 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
 
                 ++lightCount;
             }
+
+            /* Per-instance transformations, if the extension is used and the
+               fields got registered */
+            const Utility::JsonToken* const gltfMeshGpuInstancing = gltfExtensions->find("EXT_mesh_gpu_instancing"_s);
+            if(gltfMeshGpuInstancing && _d->meshGpuInstancingFieldOffset != ~UnsignedInt{}) {
+                if(!_d->gltf->parseObject(*gltfMeshGpuInstancing)) {
+                    Error{} << "Trade::GltfImporter::scene(): invalid node" << i << "EXT_mesh_gpu_instancing extension";
+                    return {};
+                }
+
+                const Utility::JsonToken* const gltfAttributes = gltfMeshGpuInstancing->find("attributes"_s);
+                if(!gltfAttributes || !_d->gltf->parseObject(*gltfAttributes)) {
+                    Error{} << "Trade::GltfImporter::scene(): missing or invalid EXT_mesh_gpu_instancing attributes property of node" << i;
+                    return {};
+                }
+
+                UnsignedInt nodeInstanceCount = ~UnsignedInt{};
+                for(const Utility::JsonObjectItem gltfAttribute: gltfAttributes->asObject()) {
+                    const Containers::StringView name = gltfAttribute.key();
+                    const bool isTranslation = name == "TRANSLATION"_s;
+                    const bool isRotation = name == "ROTATION"_s;
+                    const bool isScaling = name == "SCALE"_s;
+                    /* Custom attributes, such as _ID, have no builtin
+                       equivalent */
+                    if(!isTranslation && !isRotation && !isScaling) {
+                        if(!(flags() & ImporterFlag::Quiet))
+                            Warning{} << "Trade::GltfImporter::scene(): ignoring EXT_mesh_gpu_instancing attribute" << name << "of node" << i;
+                        continue;
+                    }
+
+                    if(!_d->gltf->parseUnsignedInt(gltfAttribute.value())) {
+                        Error{} << "Trade::GltfImporter::scene(): invalid EXT_mesh_gpu_instancing attribute" << name << "of node" << i;
+                        return {};
+                    }
+
+                    const Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> accessor = parseAccessor("Trade::GltfImporter::scene():", gltfAttribute.value().asUnsignedInt());
+                    if(!accessor)
+                        return {};
+
+                    /* Since we're abusing VertexFormat for all formats, print
+                       just the enum value without the prefix to avoid
+                       cofusion */
+                    if((!isRotation && accessor->second() != VertexFormat::Vector3) ||
+                       (isRotation && accessor->second() != VertexFormat::Vector4 &&
+                                      accessor->second() != VertexFormat::Vector4bNormalized &&
+                                      accessor->second() != VertexFormat::Vector4sNormalized)) {
+                        Error{} << "Trade::GltfImporter::scene(): unsupported EXT_mesh_gpu_instancing" << name << "format" << Debug::packed << accessor->second() << "in node" << i;
+                        return {};
+                    }
+
+                    if(nodeInstanceCount == ~UnsignedInt{})
+                        nodeInstanceCount = accessor->first().size()[0];
+                    else if(accessor->first().size()[0] != nodeInstanceCount) {
+                        Error{} << "Trade::GltfImporter::scene(): mismatched EXT_mesh_gpu_instancing" << name << "count in node" << i << Debug::nospace << ", expected" << nodeInstanceCount << "but got" << accessor->first().size()[0];
+                        return {};
+                    }
+
+                    if(isTranslation) hasInstanceTranslations = true;
+                    else if(isRotation) hasInstanceRotations = true;
+                    else if(isScaling) hasInstanceScalings = true;
+                }
+
+                if(nodeInstanceCount != ~UnsignedInt{})
+                    instanceCount += nodeInstanceCount;
+            }
         }
 
         /* Extras. If it's an object, it was already parsed during initial
@@ -2741,7 +4025,7 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
         if(const Utility::JsonToken* const gltfExtras = gltfNode.find("extras"_s)) {
             /* The process is recursive so it has to be an external function */
             if(gltfExtras->type() == Utility::JsonToken::Type::Object) for(const Utility::JsonObjectItem gltfExtra: gltfExtras->asObject()) {
-                parseSceneExtraFields(*_d->gltf, flags(), _d->sceneFieldsForName, _d->sceneFieldNamesTypesFlags, extraMappingOffsets, extraDataOffsets, extraBitOffsets, extraStringOffsets, i, gltfExtra.key(), gltfExtra.value());
+                parseSceneExtraFields(*_d->gltf, flags(), _d->sceneFieldsForName, _d->sceneFieldNamesTypesFlags, extraMappingOffsets, extraDataOffsets, extraBitOffsets, extraStringOffsets, extraKeyStorage, i, sceneExtraKey(extraKeyStorage, {}, gltfExtra.key()), gltfExtra.value());
             } else if(!(flags() & ImporterFlag::Quiet))
                 Warning{} << "Trade::GltfImporter::scene(): node" << i << "extras property is" << gltfExtras->type() << Debug::nospace << ", skipping";
         }
@@ -2809,6 +4093,10 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
     Containers::ArrayView<UnsignedInt> cameras;
     Containers::ArrayView<UnsignedInt> skinObjects;
     Containers::ArrayView<UnsignedInt> skins;
+    Containers::ArrayView<UnsignedInt> instanceObjects;
+    Containers::ArrayView<Vector3> instanceTranslations;
+    Containers::ArrayView<Quaternion> instanceRotations;
+    Containers::ArrayView<Vector3> instanceScalings;
     Containers::ArrayView<UnsignedInt> extraMappings;
     Containers::MutableStringView extrasStrings;
     /* This gets later cast to extrasFloat and extrasInt */
@@ -2837,6 +4125,10 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
         {NoInit, cameraCount, cameras},
         {NoInit, skinCount, skinObjects},
         {NoInit, skinCount, skins},
+        {NoInit, instanceCount, instanceObjects},
+        {NoInit, hasInstanceTranslations ? instanceCount : 0, instanceTranslations},
+        {NoInit, hasInstanceRotations ? instanceCount : 0, instanceRotations},
+        {NoInit, hasInstanceScalings ? instanceCount : 0, instanceScalings},
         {NoInit, extraMappingCount, extraMappings},
         {NoInit, extraStringSize, extrasStrings},
         {NoInit, extraDataCount, extrasUnsignedInt},
@@ -2854,13 +4146,16 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
             parents[j] = parent == -1 ? -1 : objects[parent];
     }
 
-    /* Populate the rest */
+    /* Populate the rest. Query the configuration just once and not for every
+       node. */
+    const bool normalizeQuaternions = configuration().value<bool>("normalizeQuaternions");
     std::size_t transformationOffset = 0;
     std::size_t trsOffset = 0;
     std::size_t meshMaterialOffset = 0;
     std::size_t lightOffset = 0;
     std::size_t cameraOffset = 0;
     std::size_t skinOffset = 0;
+    std::size_t instanceOffset = 0;
     for(std::size_t i = 0; i != objects.size(); ++i) {
         const UnsignedInt nodeI = objects[i];
         const Utility::JsonToken& gltfNode = _d->gltfNodes[nodeI].first();
@@ -2892,7 +4187,7 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
 
             /* glTF also uses the XYZW order */
             Utility::copy(*rotationArray, rotation.data());
-            if(!rotation.isNormalized() && configuration().value<bool>("normalizeQuaternions")) {
+            if(!rotation.isNormalized() && normalizeQuaternions) {
                 rotation = rotation.normalized();
                 if(!(flags() & ImporterFlag::Quiet))
                     Warning{} << "Trade::GltfImporter::scene(): rotation quaternion of node" << nodeI << "was renormalized";
@@ -2994,6 +4289,54 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
                 lights[lightOffset] = (*gltfKhrLightsPunctual)["light"_s].asUnsignedInt();
                 ++lightOffset;
             }
+
+            /* Populate per-instance transformations. Parsing, type and count
+               checks done in the previous pass already, attributes that
+               aren't present are filled with identity. */
+            const Utility::JsonToken* const gltfMeshGpuInstancing = gltfExtensions->find("EXT_mesh_gpu_instancing"_s);
+            if(gltfMeshGpuInstancing && _d->meshGpuInstancingFieldOffset != ~UnsignedInt{}) {
+                std::size_t nodeInstanceCount = 0;
+                for(const Utility::JsonObjectItem gltfAttribute: (*gltfMeshGpuInstancing)["attributes"_s].asObject()) {
+                    const Containers::StringView name = gltfAttribute.key();
+                    if(name == "TRANSLATION"_s || name == "ROTATION"_s || name == "SCALE"_s) {
+                        nodeInstanceCount = _d->accessors[gltfAttribute.value().asUnsignedInt()]->first().size()[0];
+                        break;
+                    }
+                }
+
+                for(std::size_t j = 0; j != nodeInstanceCount; ++j)
+                    instanceObjects[instanceOffset + j] = nodeI;
+                if(hasInstanceTranslations)
+                    for(Vector3& j: instanceTranslations.sliceSize(instanceOffset, nodeInstanceCount))
+                        j = Vector3{};
+                if(hasInstanceRotations)
+                    for(Quaternion& j: instanceRotations.sliceSize(instanceOffset, nodeInstanceCount))
+                        j = Quaternion{};
+                if(hasInstanceScalings)
+                    for(Vector3& j: instanceScalings.sliceSize(instanceOffset, nodeInstanceCount))
+                        j = Vector3{1.0f};
+
+                for(const Utility::JsonObjectItem gltfAttribute: (*gltfMeshGpuInstancing)["attributes"_s].asObject()) {
+                    const Containers::StringView name = gltfAttribute.key();
+                    if(name == "TRANSLATION"_s) {
+                        Utility::copy(Containers::arrayCast<1, const Vector3>(_d->accessors[gltfAttribute.value().asUnsignedInt()]->first()), instanceTranslations.sliceSize(instanceOffset, nodeInstanceCount));
+                    } else if(name == "SCALE"_s) {
+                        Utility::copy(Containers::arrayCast<1, const Vector3>(_d->accessors[gltfAttribute.value().asUnsignedInt()]->first()), instanceScalings.sliceSize(instanceOffset, nodeInstanceCount));
+                    } else if(name == "ROTATION"_s) {
+                        const Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>& accessor = *_d->accessors[gltfAttribute.value().asUnsignedInt()];
+                        const Containers::StridedArrayView2D<Float> dst = Containers::arrayCast<2, Float>(Containers::stridedArrayView(instanceRotations.sliceSize(instanceOffset, nodeInstanceCount)));
+                        if(accessor.second() == VertexFormat::Vector4)
+                            Utility::copy(Containers::arrayCast<2, const Float>(accessor.first()), dst);
+                        else if(accessor.second() == VertexFormat::Vector4bNormalized)
+                            Math::unpackInto(Containers::arrayCast<2, const Byte>(accessor.first()), dst);
+                        else if(accessor.second() == VertexFormat::Vector4sNormalized)
+                            Math::unpackInto(Containers::arrayCast<2, const Short>(accessor.first()), dst);
+                        else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+                    }
+                }
+
+                instanceOffset += nodeInstanceCount;
+            }
         }
 
         /* Extras. Types were checked in the previous pass already, so just
@@ -3002,7 +4345,7 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
         if(const Utility::JsonToken* const gltfExtras = gltfNode.find("extras"_s)) {
             /* The process is recursive so it has to be an external function */
             if(gltfExtras->type() == Utility::JsonToken::Type::Object) for(const Utility::JsonObjectItem gltfExtra: gltfExtras->asObject()) {
-                collectSceneExtraFields(_d->sceneFieldsForName, _d->sceneFieldNamesTypesFlags, extraMappingOffsets, extraMappings, extraDataOffsets, extrasUnsignedInt, extrasInt, extrasFloat, extraBitOffsets, extrasBits, extraStringOffsets, baseStringOffsets, extrasStrings, nodeI, gltfExtra.key(), gltfExtra.value());
+                collectSceneExtraFields(_d->sceneFieldsForName, _d->sceneFieldNamesTypesFlags, extraMappingOffsets, extraMappings, extraDataOffsets, extrasUnsignedInt, extrasInt, extrasFloat, extraBitOffsets, extrasBits, extraStringOffsets, baseStringOffsets, extrasStrings, extraKeyStorage, nodeI, sceneExtraKey(extraKeyStorage, {}, gltfExtra.key()), gltfExtra.value());
             }
         }
     }
@@ -3013,12 +4356,16 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
         meshMaterialOffset == meshMaterialObjects.size() &&
         lightOffset == lightObjects.size() &&
         cameraOffset == cameraObjects.size() &&
-        skinOffset == skinObjects.size());
+        skinOffset == skinObjects.size() &&
+        instanceOffset == instanceObjects.size());
 
     /* Put everything together. For simplicity the imported data could always
        have all fields present, with some being empty, but this gives less
        noise for asset introspection purposes. */
     Containers::Array<SceneFieldData> fields;
+    /* Parent, importer state, up to four transformation fields, mesh,
+       material, light, camera, skin, three instance fields and all extras */
+    arrayReserve(fields, 14 + _d->sceneFieldNamesTypesFlags.size());
     arrayAppend(fields, {
         /** @todo once there's a flag to annotate implicit fields, omit the
             parent field if it's all -1s; or alternatively we could also have a
@@ -3063,6 +4410,18 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
         SceneField::Skin, skinObjects, skins
     });
 
+    /* Per-instance transformations. As there's usually many instances per
+       node, they're multi-entry fields with the same mapping. */
+    if(hasInstanceTranslations) arrayAppend(fields, SceneFieldData{
+        sceneFieldCustom(_d->meshGpuInstancingFieldOffset + 0), instanceObjects, instanceTranslations, SceneFieldFlag::MultiEntry
+    });
+    if(hasInstanceRotations) arrayAppend(fields, SceneFieldData{
+        sceneFieldCustom(_d->meshGpuInstancingFieldOffset + 1), instanceObjects, instanceRotations, SceneFieldFlag::MultiEntry
+    });
+    if(hasInstanceScalings) arrayAppend(fields, SceneFieldData{
+        sceneFieldCustom(_d->meshGpuInstancingFieldOffset + 2), instanceObjects, instanceScalings, SceneFieldFlag::MultiEntry
+    });
+
     /* Extras. At this point, `extraOffsets[i]` to `extraOffsets[i + 1]` is the
        range of data for extra field sceneFieldCustom(i). Add it if it's
        non-empty. */
@@ -3159,6 +4518,12 @@ Containers::String GltfImporter::doSkin3DName(const UnsignedInt id) {
 Containers::Optional<SkinData3D> GltfImporter::doSkin3D(const UnsignedInt id) {
     const Utility::JsonToken& gltfSkin = _d->gltfSkins[id].first();
 
+    /* If zeroCopySkins was enabled on open and the skin was imported already,
+       return views on what was imported the first time */
+    const bool zeroCopy = !_d->skins.isEmpty();
+    if(zeroCopy && _d->skins[id])
+        return SkinData3D{DataFlags{}, _d->skins[id]->first(), DataFlags{}, _d->skins[id]->second(), &gltfSkin};
+
     /* Joint IDs */
     const Utility::JsonToken* const gltfJoints = gltfSkin.find("joints"_s);
     Containers::Optional<Containers::StridedArrayView1D<const UnsignedInt>> jointsArray;
@@ -3170,19 +4535,15 @@ Containers::Optional<SkinData3D> GltfImporter::doSkin3D(const UnsignedInt id) {
         Error{} << "Trade::GltfImporter::skin3D(): skin has no joints";
         return {};
     }
-    Containers::Array<UnsignedInt> joints{NoInit, jointsArray->size()};
-    for(std::size_t i = 0; i != jointsArray->size(); ++i) {
-        const UnsignedInt joint = (*jointsArray)[i];
+    for(const UnsignedInt joint: *jointsArray) {
         if(joint >= _d->gltfNodes.size()) {
             Error{} << "Trade::GltfImporter::skin3D(): joint index" << joint << "out of range for" << _d->gltfNodes.size() << "nodes";
             return {};
         }
-
-        joints[i] = joint;
     }
 
-    /* Inverse bind matrices. If there are none, default is identities */
-    Containers::Array<Matrix4> inverseBindMatrices{ValueInit, joints.size()};
+    /* Inverse bind matrices. If there are none, default is identities. */
+    Containers::StridedArrayView1D<const Matrix4> matrices;
     if(const Utility::JsonToken* const gltfInverseBindMatrices = gltfSkin.find("inverseBindMatrices"_s)) {
         if(!_d->gltf->parseUnsignedInt(*gltfInverseBindMatrices)) {
             Error{} << "Trade::GltfImporter::skin3D(): invalid inverseBindMatrices property";
@@ -3199,22 +4560,89 @@ Containers::Optional<SkinData3D> GltfImporter::doSkin3D(const UnsignedInt id) {
             return {};
         }
 
-        Containers::StridedArrayView1D<const Matrix4> matrices = Containers::arrayCast<1, const Matrix4>(accessor->first());
-        if(matrices.size() != inverseBindMatrices.size()) {
-            Error{} << "Trade::GltfImporter::skin3D(): invalid inverse bind matrix count, expected" << inverseBindMatrices.size() << "but got" << matrices.size();
+        matrices = Containers::arrayCast<1, const Matrix4>(accessor->first());
+        if(matrices.size() != jointsArray->size()) {
+            Error{} << "Trade::GltfImporter::skin3D(): invalid inverse bind matrix count, expected" << jointsArray->size() << "but got" << matrices.size();
             return {};
         }
-
-        Utility::copy(matrices, inverseBindMatrices);
     }
 
-    return SkinData3D{Utility::move(joints), Utility::move(inverseBindMatrices), &gltfSkin};
+    if(!zeroCopy) {
+        Containers::Array<UnsignedInt> joints{NoInit, jointsArray->size()};
+        Utility::copy(*jointsArray, joints);
+        Containers::Array<Matrix4> inverseBindMatrices{ValueInit, joints.size()};
+        if(matrices.data())
+            Utility::copy(matrices, inverseBindMatrices);
+
+        return SkinData3D{Utility::move(joints), Utility::move(inverseBindMatrices), &gltfSkin};
+    }
+
+    /* Joint IDs are always copied out of the JSON tokens. Inverse bind
+       matrices are referenced directly if they're tightly packed in the
+       buffer, otherwise they're put into the same allocation right after the
+       joints, which keeps them four-byte aligned. */
+    const bool matricesDirect = matrices.data() && matrices.isContiguous();
+    Containers::Array<char>& data = _d->skinData[id];
+    data = Containers::Array<char>{NoInit, jointsArray->size()*sizeof(UnsignedInt) + (matricesDirect ? 0 : jointsArray->size()*sizeof(Matrix4))};
+    const Containers::ArrayView<UnsignedInt> joints = Containers::arrayCast<UnsignedInt>(data.prefix(jointsArray->size()*sizeof(UnsignedInt)));
+    Utility::copy(*jointsArray, joints);
+    Containers::ArrayView<const Matrix4> inverseBindMatrices;
+    if(matricesDirect)
+        inverseBindMatrices = matrices.asContiguous();
+    else {
+        const Containers::ArrayView<Matrix4> copiedMatrices = Containers::arrayCast<Matrix4>(data.exceptPrefix(joints.size()*sizeof(UnsignedInt)));
+        if(matrices.data())
+            Utility::copy(matrices, copiedMatrices);
+        else for(Matrix4& matrix: copiedMatrices)
+            matrix = Matrix4{};
+        inverseBindMatrices = copiedMatrices;
+    }
+
+    _d->skins[id].emplace(joints, inverseBindMatrices);
+    return SkinData3D{DataFlags{}, joints, DataFlags{}, inverseBindMatrices, &gltfSkin};
 }
 
 UnsignedInt GltfImporter::doMeshCount() const {
     return _d->gltfMeshPrimitiveMap.size();
 }
 
+namespace {
+
+/* Sparse morph target attributes with implicit zero base values, which are
+   imported as separate mesh levels if compactSparseMorphTargets is enabled */
+bool isCompactSparseAccessor(const Utility::JsonToken& gltfAccessor) {
+    return gltfAccessor.find("sparse"_s) && !gltfAccessor.find("bufferView"_s);
+}
+
+}
+
+Containers::Array<Containers::Triple<Containers::StringView, UnsignedInt, Int>> GltfImporter::compactSparseMorphTargetAttributes(const UnsignedInt id) {
+    Containers::Array<Containers::Triple<Containers::StringView, UnsignedInt, Int>> out;
+    if(!configuration().value<bool>("compactSparseMorphTargets"))
+        return out;
+
+    /* Morph targets array and target attribute objects parsed in doOpenData()
+       already. Invalid attributes are skipped here, the error is printed
+       when importing the base mesh. */
+    const Utility::JsonToken& gltfPrimitive = _d->gltfMeshPrimitiveMap[id].second();
+    if(const Utility::JsonToken* gltfTargets = gltfPrimitive.find("targets"_s)) {
+        for(Utility::JsonArrayItem gltfTarget: gltfTargets->asArray()) {
+            for(Utility::JsonObjectItem gltfMorphAttribute: gltfTarget.value().asObject()) {
+                if(_d->gltf->parseUnsignedInt(gltfMorphAttribute.value()) &&
+                   gltfMorphAttribute.value().asUnsignedInt() < _d->gltfAccessors.size() &&
+                   isCompactSparseAccessor(_d->gltfAccessors[gltfMorphAttribute.value().asUnsignedInt()]))
+                    arrayAppend(out, InPlaceInit, gltfMorphAttribute.key(), gltfMorphAttribute.value().asUnsignedInt(), Int(gltfTarget.index()));
+            }
+        }
+    }
+
+    return out;
+}
+
+UnsignedInt GltfImporter::doMeshLevelCount(const UnsignedInt id) {
+    return 1 + compactSparseMorphTargetAttributes(id).size();
+}
+
 Int GltfImporter::doMeshForName(const Containers::StringView name) {
     /* As we can't fail here, name strings were parsed during import already
        (with the assumption they're mostly not escaped and thus overhead-less),
@@ -3256,7 +4684,9 @@ template<class T, class F, class G> std::size_t stableSortRemoveDuplicatesToPref
 
 }
 
-Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, UnsignedInt) {
+Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, const UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMesh", {}, id};
+    MAGNUM_PROFILING_ZONE("GltfImporter::doMesh()");
     const Utility::JsonToken& gltfPrimitive = _d->gltfMeshPrimitiveMap[id].second();
 
     /* Primitive is optional, defaulting to triangles */
@@ -3294,9 +4724,13 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
         }
     }
 
-    /* Attributes */
+    /* Attributes. Additional levels contain just a single compact sparse
+       morph target attribute, imported as a point cloud. */
     Containers::Array<Containers::Triple<Containers::StringView, UnsignedInt, Int>> attributeOrder;
-    if(const Utility::JsonToken* gltfAttributes = gltfPrimitive.find("attributes"_s)) {
+    if(level) {
+        arrayAppend(attributeOrder, compactSparseMorphTargetAttributes(id)[level - 1]);
+        primitive = MeshPrimitive::Points;
+    } else if(const Utility::JsonToken* gltfAttributes = gltfPrimitive.find("attributes"_s)) {
         /* Primitive attributes object parsed in doOpenData() already, for
            custom attribute discovery, so we just use it directly. */
         for(Utility::JsonObjectItem gltfAttribute: gltfAttributes->asObject()) {
@@ -3311,6 +4745,41 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
         }
     }
 
+    /* If the plugin is built with Draco, a primitive compressed with
+       KHR_draco_mesh_compression gets decoded on first access and all its
+       attributes are then taken from the decoded data, which contain also
+       copies of the uncompressed ones, instead of the accessors. Otherwise, unless the extension is in
+       extensionsRequired, the primitive has uncompressed fallback data, which
+       get imported instead. Without a fallback the accessors have no buffer
+       views, so print a clearer message than what parseAccessor() would. */
+    #ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+    const Document::DracoPrimitive* draco = nullptr;
+    #endif
+    if(const Utility::JsonToken* gltfExtensions = level ? nullptr : gltfPrimitive.find("extensions"_s)) {
+        if(!_d->gltf->parseObject(*gltfExtensions)) {
+            Error{} << "Trade::GltfImporter::mesh(): invalid primitive extensions property";
+            return {};
+        }
+        if(const Utility::JsonToken* gltfDracoCompression = gltfExtensions->find("KHR_draco_mesh_compression"_s)) {
+            #ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+            if(primitive != MeshPrimitive::Triangles) {
+                Error{} << "Trade::GltfImporter::mesh(): KHR_draco_mesh_compression is supported only for" << MeshPrimitive::Triangles << "but got" << primitive;
+                return {};
+            }
+            if(!decodeDracoPrimitive(id, *gltfDracoCompression))
+                return {};
+            draco = &*_d->dracoPrimitives[id];
+            #else
+            for(const Containers::Triple<Containers::StringView, UnsignedInt, Int>& attribute: attributeOrder) {
+                if(attribute.second() < _d->gltfAccessors.size() && !_d->gltfAccessors[attribute.second()]->find("bufferView"_s)) {
+                    Error{} << "Trade::GltfImporter::mesh(): the plugin was built without KHR_draco_mesh_compression support and attribute" << attribute.first() << "has no uncompressed fallback";
+                    return {};
+                }
+            }
+            #endif
+        }
+    }
+
     /* 3.7.2.1 (Geometry § Meshes § Overview) says "Primitives specify one or
        more attributes", but we allow also none unless the strict option is
        enabled. Not printing a warning if the strict option is disabled as
@@ -3321,7 +4790,8 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
     }
 
     /* Morph target attributes */
-    if(const Utility::JsonToken* gltfTargets = gltfPrimitive.find("targets"_s)) {
+    const bool compactSparseMorphTargets = configuration().value<bool>("compactSparseMorphTargets");
+    if(const Utility::JsonToken* gltfTargets = level ? nullptr : gltfPrimitive.find("targets"_s)) {
         /* Morph targets array and target attribute objects parsed in
            doOpenData() already, for custom attribute discovery, so we just use
            it directly. */
@@ -3332,6 +4802,12 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
                     return {};
                 }
 
+                /* Those are imported as separate mesh levels instead */
+                if(compactSparseMorphTargets &&
+                   gltfMorphAttribute.value().asUnsignedInt() < _d->gltfAccessors.size() &&
+                   isCompactSparseAccessor(_d->gltfAccessors[gltfMorphAttribute.value().asUnsignedInt()]))
+                    continue;
+
                 arrayAppend(attributeOrder, InPlaceInit, gltfMorphAttribute.key(), gltfMorphAttribute.value().asUnsignedInt(), Int(gltfTarget.index()));
             }
         }
@@ -3352,12 +4828,17 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
        them */
     UnsignedInt bufferId = 0;
     UnsignedInt vertexCount = 0;
+    bool hasBufferRange = false;
     std::size_t attributeId = 0;
     UnsignedInt jointIdAttributeCount = 0;
     UnsignedInt weightAttributeCount = 0;
     Containers::Pair<Containers::StringView, Int> lastNumberedAttribute;
     Math::Range1D<std::size_t> bufferRange;
-    Containers::Array<MeshAttributeData> attributeData{uniqueAttributeCount};
+    /* Additional levels have also the sparse indices */
+    Containers::Array<MeshAttributeData> attributeData{uniqueAttributeCount + (level ? 1 : 0)};
+    /* Sparse morph target attributes, which aren't in the input buffer range
+       but get put after it */
+    Containers::Array<Containers::Pair<std::size_t, SparseAccessor>> sparseAttributes;
     /** @todo use suffix() once it takes suffix size and not prefix size */
     for(const Containers::Triple<Containers::StringView, UnsignedInt, Int>& attribute: attributeOrder.exceptPrefix(attributeOrder.size() - uniqueAttributeCount)) {
         /* Duplicate attribute, skip */
@@ -3391,9 +4872,30 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
             lastNumberedAttribute = {};
         }
 
-        /* Get the accessor view */
-        Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> accessor = parseAccessor("Trade::GltfImporter::mesh():", attribute.second());
-        if(!accessor) return {};
+        /* Get the accessor view. Sparse accessors are supported only for
+           morph targets, for which the accessor view is left empty. */
+        Containers::Optional<SparseAccessor> sparseAccessor;
+        Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> accessor;
+        if(morphTargetId != -1 && attribute.second() < _d->gltfAccessors.size() && _d->gltfAccessors[attribute.second()]->find("sparse"_s)) {
+            sparseAccessor = parseSparseAccessor("Trade::GltfImporter::mesh():", attribute.second());
+            if(!sparseAccessor) return {};
+            accessor.emplace(Containers::StridedArrayView2D<const char>{}, sparseAccessor->format, ~UnsignedInt{});
+        } else {
+            /* Attributes decoded from KHR_draco_mesh_compression have no
+               buffer view, which is marked with an invalid ID */
+            #ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+            if(draco) for(const Containers::Triple<UnsignedInt, Containers::StridedArrayView2D<const char>, VertexFormat>& decoded: draco->attributes) {
+                if(decoded.first() == attribute.second()) {
+                    accessor.emplace(decoded.second(), decoded.third(), ~UnsignedInt{});
+                    break;
+                }
+            }
+            #endif
+            if(!accessor) {
+                accessor = parseAccessor("Trade::GltfImporter::mesh():", attribute.second());
+                if(!accessor) return {};
+            }
+        }
 
         /* From the builtin attributes can fire either for ObjectId or for
            JointIds */
@@ -3553,36 +5055,58 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
         }
 
         /* Remember which buffer the attribute is in and the range, for
-           consecutive attribs expand the range */
-        const Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt> bufferView = *_d->bufferViews[accessor->third()];
-        if(attributeId == 0) {
-            bufferId = bufferView.third();
-            bufferRange = Math::Range1D<std::size_t>::fromSize(reinterpret_cast<std::size_t>(bufferView.first().data()), bufferView.first().size());
-            vertexCount = accessor->first().size()[0];
-        } else {
-            /* ... and probably never will be */
-            if(bufferView.third() != bufferId) {
-                Error{} << "Trade::GltfImporter::mesh(): meshes spanning multiple buffers are not supported";
-                return {};
-            }
-
-            bufferRange = Math::join(bufferRange, Math::Range1D<std::size_t>::fromSize(reinterpret_cast<std::size_t>(bufferView.first().data()), bufferView.first().size()));
+           consecutive attribs expand the range. Sparse accessors aren't
+           referenced from the input data. */
+        if(!sparseAccessor) {
+            /* Decoded KHR_draco_mesh_compression attributes are all in a
+               single allocation, treated as a buffer distinct from all
+               others */
+            #ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+            const Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt> bufferView = accessor->third() == ~UnsignedInt{} ?
+                Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt>{draco->vertexData, 0, ~UnsignedInt{}} :
+                *_d->bufferViews[accessor->third()];
+            #else
+            const Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt> bufferView = *_d->bufferViews[accessor->third()];
+            #endif
+            if(!hasBufferRange) {
+                bufferId = bufferView.third();
+                bufferRange = Math::Range1D<std::size_t>::fromSize(reinterpret_cast<std::size_t>(bufferView.first().data()), bufferView.first().size());
+                hasBufferRange = true;
+            } else {
+                /* ... and probably never will be */
+                if(bufferView.third() != bufferId) {
+                    Error{} << "Trade::GltfImporter::mesh(): meshes spanning multiple buffers are not supported";
+                    return {};
+                }
 
-            if(accessor->first().size()[0] != vertexCount) {
-                Error e;
-                e << "Trade::GltfImporter::mesh(): mismatched vertex count for attribute" << attribute.first();
-                if(morphTargetId != -1)
-                    e << "in morph target" << morphTargetId;
-                e << Debug::nospace << ", expected" << vertexCount << "but got" << accessor->first().size()[0];
-                return {};
+                bufferRange = Math::join(bufferRange, Math::Range1D<std::size_t>::fromSize(reinterpret_cast<std::size_t>(bufferView.first().data()), bufferView.first().size()));
             }
         }
 
+        /* In additional levels the vertex count is the count of sparse
+           values */
+        const std::size_t attributeVertexCount = !sparseAccessor ? accessor->first().size()[0] :
+            level ? sparseAccessor->indices.size() : sparseAccessor->count;
+        if(attributeId == 0) {
+            vertexCount = attributeVertexCount;
+        } else if(attributeVertexCount != vertexCount) {
+            Error e;
+            e << "Trade::GltfImporter::mesh(): mismatched vertex count for attribute" << attribute.first();
+            if(morphTargetId != -1)
+                e << "in morph target" << morphTargetId;
+            e << Debug::nospace << ", expected" << vertexCount << "but got" << attributeVertexCount;
+            return {};
+        }
+
         /** @todo Check that accessor stride >= vertexFormatSize(format)? */
 
         /* Fill in an attribute. Points to the input data, will be patched to
-           the output data once we know where it's allocated. */
-        attributeData[attributeId++] = MeshAttributeData{name, accessor->second(), accessor->first(), arraySize, morphTargetId};
+           the output data once we know where it's allocated. Sparse
+           attributes are offset-only, with the offset filled in below. */
+        if(sparseAccessor) {
+            arrayAppend(sparseAttributes, InPlaceInit, attributeId, Utility::move(*sparseAccessor));
+            attributeData[attributeId++] = MeshAttributeData{name, accessor->second(), 0, vertexCount, std::ptrdiff_t(vertexFormatSize(accessor->second())), arraySize, morphTargetId};
+        } else attributeData[attributeId++] = MeshAttributeData{name, accessor->second(), accessor->first(), arraySize, morphTargetId};
 
         /* For backwards compatibility insert also a custom "JOINTS" /
            "WEIGHTS" attribute which is a Vector4<T> instead of T[4] */
@@ -3593,6 +5117,23 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
         #endif
     }
 
+    /* Put sparse morph target attributes after the input data, each aligned
+       to four bytes. In the base level they're expanded to the full vertex
+       count, in additional levels there's the sparse values followed by the
+       indices. */
+    std::size_t vertexDataSize = bufferRange.size();
+    for(const Containers::Pair<std::size_t, SparseAccessor>& sparse: sparseAttributes) {
+        const MeshAttributeData& attribute = attributeData[sparse.first()];
+        vertexDataSize = (vertexDataSize + 3) & ~std::size_t{3};
+        attributeData[sparse.first()] = MeshAttributeData{attribute.name(), attribute.format(), vertexDataSize, vertexCount, attribute.stride(), attribute.arraySize(), attribute.morphTargetId()};
+        vertexDataSize += vertexCount*attribute.stride();
+    }
+    if(level) {
+        vertexDataSize = (vertexDataSize + 3) & ~std::size_t{3};
+        attributeData[attributeId++] = MeshAttributeData{_d->meshAttributesForName.at("SPARSE_INDEX"_s), VertexFormat::UnsignedInt, vertexDataSize, vertexCount, sizeof(UnsignedInt)};
+        vertexDataSize += vertexCount*sizeof(UnsignedInt);
+    }
+
     /* Verify we really filled all attributes */
     CORRADE_INTERNAL_ASSERT(attributeId == attributeData.size());
 
@@ -3623,14 +5164,66 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
         return {};
     }
 
-    /* Allocate & copy vertex data, if any */
     Containers::ArrayView<const char> inputVertexData{reinterpret_cast<const char*>(bufferRange.min()), bufferRange.size()};
-    Containers::Array<char> vertexData{NoInit, bufferRange.size()};
-    Utility::copy(inputVertexData, vertexData);
+
+    /* If zero-copy import is requested, the data can be referenced directly
+       as long as no attribute needs to be patched. All buffers are kept in
+       memory until the importer is closed, so the views stay valid until
+       then. */
+    /* The mesh converter is not applied to sparse morph target levels, and
+       neither to meshes that have them as it could reorder vertices the
+       levels refer to. If it's applied, the data have to be copied. */
+    const Containers::StringView meshConverter = configuration().value<Containers::StringView>("meshConverter");
+    const bool convertMesh = meshConverter && !level && compactSparseMorphTargetAttributes(id).isEmpty();
+
+    bool zeroCopy = configuration().value<bool>("zeroCopyMeshes") && !sparseAttributes && !level && !convertMesh;
+    if(zeroCopy && !_d->textureCoordinateYFlipInMaterial) {
+        for(const MeshAttributeData& attribute: attributeData) {
+            if(attribute.name() == MeshAttribute::TextureCoordinates && (
+                attribute.format() == VertexFormat::Vector2 ||
+                attribute.format() == VertexFormat::Vector2ubNormalized ||
+                attribute.format() == VertexFormat::Vector2usNormalized))
+            {
+                zeroCopy = false;
+                break;
+            }
+        }
+    }
+
+    /* Allocate & copy vertex data, if any and if not referencing them
+       directly */
+    Containers::Array<char> vertexData;
+    if(!zeroCopy) {
+        Containers::Optional<Containers::Array<char>> allocated = Magnum::Implementation::allocateOutput("Trade::GltfImporter::mesh():", _outputAllocator, _outputAllocatorUserData, vertexDataSize);
+        if(!allocated) return {};
+        vertexData = Utility::move(*allocated);
+        Utility::copy(inputVertexData, vertexData.prefix(inputVertexData.size()));
+    }
+
+    /* Expand the sparse attributes, or in additional levels copy the values
+       and indices as they are */
+    for(const Containers::Pair<std::size_t, SparseAccessor>& sparse: sparseAttributes) {
+        const MeshAttributeData& attribute = attributeData[sparse.first()];
+        const std::size_t typeSize = attribute.stride();
+        const Containers::StridedArrayView2D<char> dst{vertexData.sliceSize(attribute.offset(vertexData), vertexCount*typeSize), {vertexCount, typeSize}};
+        if(level) {
+            Utility::copy(sparse.second().values, dst);
+            Utility::copy(Containers::arrayView(sparse.second().indices), Containers::arrayCast<UnsignedInt>(vertexData.sliceSize(attributeData.back().offset(vertexData), vertexCount*sizeof(UnsignedInt))));
+            continue;
+        }
+
+        if(sparse.second().base.data())
+            Utility::copy(sparse.second().base, dst);
+        else
+            std::memset(dst.data(), 0, vertexCount*typeSize);
+        for(std::size_t i = 0; i != sparse.second().indices.size(); ++i)
+            Utility::copy(sparse.second().values[i], dst[sparse.second().indices[i]]);
+    }
 
     /* Convert the attributes from relative to absolute, copy them to a
-       non-growable array and do additional patching */
-    for(std::size_t i = 0; i != attributeData.size(); ++i) {
+       non-growable array and do additional patching. In the zero-copy case
+       the attributes already point to the input data. */
+    if(!zeroCopy) for(std::size_t i = 0; i != attributeData.size(); ++i) {
         /* glTF only requires buffer views to be large enough to fit the actual
            data, not to have the size large enough to fit `count*stride`
            elements. The StridedArrayView expects the latter, so we fake the
@@ -3643,7 +5236,7 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
             with offset in whole strides and then "shift" the view by the
             remainder (once there's StridedArrayView::shift() or some such) */
         Containers::StridedArrayView1D<char> data{{vertexData, vertexData.size() + attributeData[i].stride()},
-            vertexData + attributeData[i].offset(inputVertexData),
+            vertexData + (attributeData[i].isOffsetOnly() ? attributeData[i].offset(vertexData) : attributeData[i].offset(inputVertexData)),
             vertexCount, attributeData[i].stride()};
 
         attributeData[i] = MeshAttributeData{attributeData[i].name(),
@@ -3680,7 +5273,8 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
     /* Indices */
     MeshIndexData indices;
     Containers::Array<char> indexData;
-    if(const Utility::JsonToken* gltfIndices = gltfPrimitive.find("indices"_s)) {
+    Containers::ArrayView<const char> inputIndexData;
+    if(const Utility::JsonToken* gltfIndices = level ? nullptr : gltfPrimitive.find("indices"_s)) {
         if(!_d->gltf->parseUnsignedInt(*gltfIndices)) {
             Error{} << "Trade::GltfImporter::mesh(): invalid indices property";
             return {};
@@ -3688,8 +5282,15 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
         /* Bounds check is done in parseAccessor() below, no need to do it
            here again */
 
-        Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> accessor = parseAccessor("Trade::GltfImporter::mesh():", gltfIndices->asUnsignedInt());
-        if(!accessor) return {};
+        Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> accessor;
+        #ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+        if(draco)
+            accessor.emplace(draco->indices, draco->indexFormat, ~UnsignedInt{});
+        #endif
+        if(!accessor) {
+            accessor = parseAccessor("Trade::GltfImporter::mesh():", gltfIndices->asUnsignedInt());
+            if(!accessor) return {};
+        }
 
         MeshIndexType type;
         if(accessor->second() == VertexFormat::UnsignedByte)
@@ -3711,9 +5312,15 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
         }
 
         Containers::ArrayView<const char> srcContiguous = accessor->first().asContiguous();
-        indexData = Containers::Array<char>{NoInit, srcContiguous.size()};
-        Utility::copy(srcContiguous, indexData);
-        indices = MeshIndexData{type, indexData};
+        if(zeroCopy) {
+            inputIndexData = srcContiguous;
+        } else {
+            Containers::Optional<Containers::Array<char>> allocated = Magnum::Implementation::allocateOutput("Trade::GltfImporter::mesh():", _outputAllocator, _outputAllocatorUserData, srcContiguous.size());
+            if(!allocated) return {};
+            indexData = Utility::move(*allocated);
+            Utility::copy(srcContiguous, indexData);
+        }
+        indices = MeshIndexData{type, zeroCopy ? inputIndexData : Containers::ArrayView<const char>{indexData}};
     }
 
     /* If we have an index-less attribute-less mesh, glTF has no way to supply
@@ -3721,10 +5328,28 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
     if(!indices.data().size() && !attributeData.size())
         return MeshData{primitive, 0};
 
-    return MeshData{primitive,
-        Utility::move(indexData), indices,
-        Utility::move(vertexData), Utility::move(attributeData),
+    if(zeroCopy) return MeshData{primitive,
+        DataFlags{}, inputIndexData, indices,
+        DataFlags{}, inputVertexData, Utility::move(attributeData),
         vertexCount, &gltfPrimitive};
+
+    /* Memory from the output allocator isn't owned by the mesh */
+    MeshData mesh = _outputAllocator ?
+        MeshData{primitive,
+            DataFlag::Mutable, indexData, indices,
+            DataFlag::Mutable, vertexData, Utility::move(attributeData),
+            vertexCount, &gltfPrimitive} :
+        MeshData{primitive,
+            Utility::move(indexData), indices,
+            Utility::move(vertexData), Utility::move(attributeData),
+            vertexCount, &gltfPrimitive};
+
+    /* Run the mesh converter directly on the data allocated above, in both
+       cases they're mutable */
+    if(convertMesh && !Magnum::Implementation::convertMeshInPlace("Trade::GltfImporter::mesh():", manager(), flags(), _d->meshConverter, meshConverter, mesh))
+        return {};
+
+    return Utility::move(mesh);
 }
 
 MeshAttribute GltfImporter::doMeshAttributeForName(const Containers::StringView name) {
@@ -4133,7 +5758,31 @@ bool GltfImporter::materialTexture(const Utility::JsonToken& gltfTexture, Contai
     return true;
 }
 
+namespace {
+
+/* MaterialData and TextureData aren't copyable, used by doMaterial() and
+   doTexture() to return a copy of a cached instance */
+MaterialData copyMaterial(const MaterialData& material) {
+    Containers::Array<MaterialAttributeData> attributes{NoInit, material.attributeData().size()};
+    Utility::copy(material.attributeData(), attributes);
+    Containers::Array<UnsignedInt> layers{NoInit, material.layerData().size()};
+    Utility::copy(material.layerData(), layers);
+    return MaterialData{material.types(), Utility::move(attributes), Utility::move(layers), material.importerState()};
+}
+
+TextureData copyTexture(const TextureData& texture) {
+    return TextureData{texture.type(), texture.minificationFilter(), texture.magnificationFilter(), texture.mipmapFilter(), texture.wrapping(), texture.image(), texture.importerState()};
+}
+
+}
+
 Containers::Optional<MaterialData> GltfImporter::doMaterial(const UnsignedInt id) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMaterial", {}, id};
+    /* If the material was imported already and caching is enabled, return a
+       copy of it */
+    if(!_d->materialCache.isEmpty() && _d->materialCache[id])
+        return copyMaterial(*_d->materialCache[id]);
+
     const Utility::JsonToken& gltfMaterial = _d->gltfMaterials[id].first();
 
     Containers::Array<UnsignedInt> layers;
@@ -4726,7 +6375,10 @@ Containers::Optional<MaterialData> GltfImporter::doMaterial(const UnsignedInt id
        deleter */
     arrayShrink(layers);
     arrayShrink(attributes, DefaultInit);
-    return MaterialData{types, Utility::move(attributes), Utility::move(layers), &gltfMaterial};
+    MaterialData material{types, Utility::move(attributes), Utility::move(layers), &gltfMaterial};
+    if(!_d->materialCache.isEmpty())
+        _d->materialCache[id] = copyMaterial(material);
+    return Utility::move(material);
 }
 
 UnsignedInt GltfImporter::doTextureCount() const {
@@ -4751,6 +6403,11 @@ Containers::String GltfImporter::doTextureName(const UnsignedInt id) {
 }
 
 Containers::Optional<TextureData> GltfImporter::doTexture(const UnsignedInt id) {
+    /* If the texture was imported already and caching is enabled, return a
+       copy of it */
+    if(!_d->textureCache.isEmpty() && _d->textureCache[id])
+        return copyTexture(*_d->textureCache[id]);
+
     const Utility::JsonToken& gltfTexture = _d->gltfTextures[_d->uniqueTextures[id]].first();
 
     const Utility::JsonToken* gltfSource = nullptr;
@@ -4758,25 +6415,30 @@ Containers::Optional<TextureData> GltfImporter::doTexture(const UnsignedInt id)
     /* Various extensions, they override the standard image. The core glTF spec
        only allows image/jpeg and image/png and these extend for other MIME
        types. We don't really care as we delegate to AnyImageImporter and let
-       it figure out the file type based on magic, so we just pick the first
-       available image, assuming that extension order indicates a preference
-       ... */
-    /** @todo Figure out a better priority
+       it figure out the file type based on magic, so unless the application
+       told us which extensions are cheapest to load for it, we just pick the
+       first available image, assuming that extension order indicates a
+       preference ... */
+    /** @todo Figure out a better default priority
         - extensionsRequired?
-        - image importers available via manager()->aliasList()?
-        - are there even files out there with more than one extension? */
+        - image importers available via manager()->aliasList()? */
     if(const Utility::JsonToken* const gltfExtensions = gltfTexture.find("extensions"_s)) {
         if(!_d->gltf->parseObject(*gltfExtensions)) {
             Error{} << "Trade::GltfImporter::texture(): invalid extensions property";
             return {};
         }
 
-        /* Pick the first extension we understand */
+        /* Pick the most preferred extension if any is listed in the options,
+           otherwise the first extension we understand */
+        const bool khrTextureKtx = configuration().value<bool>("experimentalKhrTextureKtx");
+        const Containers::StringView preferredExtension = preferredTextureExtension(configuration(), *gltfExtensions, khrTextureKtx);
         for(const Utility::JsonObjectItem i: gltfExtensions->asObject()) {
             const Containers::StringView extensionName = i.key();
 
-            if(!(extensionName == "KHR_texture_ktx"_s && configuration().value<bool>("experimentalKhrTextureKtx")) &&
+            if(!(extensionName == "KHR_texture_ktx"_s && khrTextureKtx) &&
                !isRecognized2DTextureExtension(extensionName)) continue;
+            if(preferredExtension && extensionName != preferredExtension)
+                continue;
 
             if(!_d->gltf->parseObject(i.value())) {
                 Error{} << "Trade::GltfImporter::texture(): invalid" << extensionName << "extension";
@@ -4940,27 +6602,44 @@ Containers::Optional<TextureData> GltfImporter::doTexture(const UnsignedInt id)
         }
     }
 
-    return TextureData{type, minificationFilter, magnificationFilter,
+    TextureData texture{type, minificationFilter, magnificationFilter,
         /* In case of KHR_texture_ktx deduplication, this returns the first
            texture in the chain */
         /** @todo when we have arbirary key/value storage, store all there? */
         mipmap, wrapping, image, &gltfTexture};
+    if(!_d->textureCache.isEmpty())
+        _d->textureCache[id] = copyTexture(texture);
+    return Utility::move(texture);
 }
 
 AbstractImporter* GltfImporter::setupOrReuseImporterForImage(const char* const errorPrefix, const UnsignedInt id, const UnsignedInt expectedDimensions) {
     /* Looking for the same ID, so reuse an importer populated before. If the
        previous attempt failed, the importer is not set, so return nullptr in
        that case. Going through everything below again would not change the
-       outcome anyway, only spam the output with redundant messages. */
-    if(_d->imageImporterId == id)
-        return _d->imageImporter ? &*_d->imageImporter : nullptr;
+       outcome anyway, only spam the output with redundant messages. The cache
+       is expected to be small, so a linear search is fine. While at it,
+       remember the least recently used slot to replace in case the ID isn't
+       found. Unused slots have lastUsed set to 0 so they get picked first. */
+    Document::ImageImporter* slot = &_d->imageImporters[0];
+    for(Document::ImageImporter& i: _d->imageImporters) {
+        if(i.id == id) {
+            /* If all images were opened upfront, nothing will ever get
+               replaced, so don't update the use counter. That makes the
+               lookup not modify any state, allowing concurrent import. */
+            if(!_d->openImagesOnOpen)
+                i.lastUsed = ++_d->imageImporterUseCounter;
+            return i.importer ? &*i.importer : nullptr;
+        }
+        if(i.lastUsed < slot->lastUsed) slot = &i;
+    }
 
     /* Otherwise reset the importer and remember the new ID. If the import
        fails, the importer will stay unset, but the ID will be updated so the
        next round can again just return nullptr above instead of going through
        the doomed-to-fail process again. */
-    _d->imageImporter = Containers::NullOpt;
-    _d->imageImporterId = id;
+    releaseImageImporter(slot - _d->imageImporters.data());
+    slot->id = id;
+    slot->lastUsed = ++_d->imageImporterUseCounter;
 
     AnyImageImporter importer{*manager()};
     importer.setFlags(flags());
@@ -5016,7 +6695,7 @@ AbstractImporter* GltfImporter::setupOrReuseImporterForImage(const char* const e
 
         if(!importer.openData(imageView))
             return nullptr;
-        return &_d->imageImporter.emplace(Utility::move(importer));
+        return &slot->importer.emplace(Utility::move(importer));
     }
 
     /* Load external image */
@@ -5028,16 +6707,25 @@ AbstractImporter* GltfImporter::setupOrReuseImporterForImage(const char* const e
     const Containers::Optional<Containers::String> decodedUri = decodeUri(errorPrefix, gltfUri->asString());
     if(!decodedUri)
         return nullptr;
-    if(!importer.openFile(Utility::Path::join(_d->filename ? Utility::Path::split(*_d->filename).first() : ""_s, *decodedUri)))
+    Containers::String imageFilename = Utility::Path::join(_d->filename ? Utility::Path::split(*_d->filename).first() : ""_s, *decodedUri);
+
+    /* If there's an importer already opened for the same file in the shared
+       pool, take it from there instead of opening the file again */
+    const bool pooled = configuration().value<std::size_t>("imageImporterPoolSize") != 0;
+    Containers::Optional<AnyImageImporter> pooledImporter;
+    if(pooled)
+        pooledImporter = Magnum::Implementation::imageImporterPool().acquire(manager(), imageFilename, flags(), fileCallback(), fileCallbackUserData());
+    if(!pooledImporter && !importer.openFile(imageFilename))
         return nullptr;
+    AnyImageImporter& opened = pooledImporter ? *pooledImporter : importer;
 
     UnsignedInt expectedDimensionsImageCount;
     const char* expectedDimensionsString;
     if(expectedDimensions == 2) {
-        expectedDimensionsImageCount = importer.image2DCount();
+        expectedDimensionsImageCount = opened.image2DCount();
         expectedDimensionsString = "2D";
     } else if(expectedDimensions == 3) {
-        expectedDimensionsImageCount = importer.image3DCount();
+        expectedDimensionsImageCount = opened.image3DCount();
         expectedDimensionsString = "3D";
     } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
     if(expectedDimensionsImageCount != 1) {
@@ -5045,7 +6733,16 @@ AbstractImporter* GltfImporter::setupOrReuseImporterForImage(const char* const e
         return nullptr;
     }
 
-    return &_d->imageImporter.emplace(Utility::move(importer));
+    if(pooled) slot->filename = Utility::move(imageFilename);
+    return &slot->importer.emplace(Utility::move(opened));
+}
+
+void GltfImporter::releaseImageImporter(const std::size_t id) {
+    Document::ImageImporter& slot = _d->imageImporters[id];
+    if(slot.importer && slot.filename)
+        Magnum::Implementation::imageImporterPool().release(manager(), slot.filename, flags(), fileCallback(), fileCallbackUserData(), Utility::move(*slot.importer), configuration().value<std::size_t>("imageImporterPoolSize"));
+    slot.importer = Containers::NullOpt;
+    slot.filename = {};
 }
 
 UnsignedInt GltfImporter::doImage2DCount() const {
@@ -5081,6 +6778,7 @@ UnsignedInt GltfImporter::doImage2DLevelCount(const UnsignedInt id) {
 }
 
 Containers::Optional<ImageData2D> GltfImporter::doImage2D(const UnsignedInt id, const UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D", {}, id};
     CORRADE_ASSERT(manager(), "Trade::GltfImporter::image2D(): the plugin must be instantiated with access to plugin manager in order to load images", {});
 
     AbstractImporter* importer = setupOrReuseImporterForImage("Trade::GltfImporter::image2D():", _d->imagesByDimension[id], 2);
@@ -5125,6 +6823,7 @@ UnsignedInt GltfImporter::doImage3DLevelCount(const UnsignedInt id) {
 }
 
 Containers::Optional<ImageData3D> GltfImporter::doImage3D(const UnsignedInt id, const UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage3D", {}, id};
     CORRADE_ASSERT(manager(), "Trade::GltfImporter::image3D(): the plugin must be instantiated with access to plugin manager in order to load images", {});
 
     AbstractImporter* importer = setupOrReuseImporterForImage("Trade::GltfImporter::image3D():", _d->imagesByDimension[_d->image2DCount + id], 3);
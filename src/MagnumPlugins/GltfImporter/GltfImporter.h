@@ -117,6 +117,60 @@ the importer instance. In case of images, the files are loaded on-demand inside
 @ref InputFileCallbackPolicy::Close is emitted right after the file is fully
 read.
 
+If the @cb{.ini} mapExternalBuffers @ce
+@ref Trade-GltfImporter-configuration "configuration option" is enabled, a
+file is opened from the filesystem and no file callback is set, external
+buffers are memory-mapped instead of being read into memory, which means only
+the parts that are actually accessed get loaded from the disk. This is
+available only on platforms where @relativeref{Corrade,Utility::Path::mapRead()}
+is, on other platforms the option is ignored. Combined with the
+@cb{.ini} zeroCopyMeshes @ce option, mesh data can then reference the mapped
+memory directly. External images are not affected by this option.
+
+A binary glTF file is by default expected to be complete. With the
+@cb{.ini} allowPartialGlb @ce @ref Trade-GltfImporter-configuration "configuration option"
+enabled, a file that's shorter than its header says --- for example because
+it's still being downloaded --- is accepted as long as the whole JSON chunk is
+present. All metadata such as scene hierarchy, materials or mesh names are then
+available immediately, while @ref mesh(), @ref image2D() and other data import
+fails with an error if it references a part of the BIN chunk that isn't
+present yet. As the importer doesn't provide a way to append data to an
+already opened file, open it again once more data is available.
+
+With the @cb{.ini} cacheJsonTokens @ce @ref Trade-GltfImporter-configuration "configuration option"
+enabled, the file data and the tokenized JSON are kept around after
+@ref close(). If exactly the same file is opened again, the tokens are reused
+instead of tokenizing the JSON again, including everything parsed from them
+so far. Only the last closed file is kept. External buffers and images are not
+part of the cache and are loaded again on access. The data can't be kept if
+the file was opened with @ref DataFlag::ExternallyOwned.
+
+Textures and materials are by default parsed from the JSON again on every
+@ref texture() and @ref material() call. With the
+@cb{.ini} cacheTexturesAndMaterials @ce @ref Trade-GltfImporter-configuration "configuration option"
+enabled, the result of the first successful import is remembered and a copy of
+it is returned on subsequent calls with the same ID. Options affecting texture
+and material import are then only taken into account on the first import.
+
+Names of all data are parsed when opening the file, but the maps used by
+@ref objectForName(), @ref meshForName() and other name lookups are built only
+on the first lookup of a particular kind. Enable the
+@cb{.ini} buildNameMapsOnOpen @ce @ref Trade-GltfImporter-configuration "configuration option"
+to build all of them during @ref openData() / @ref openFile() instead, after
+which the lookups don't modify any internal state.
+
+Parsing of node children and checking the node hierarchy for cycles is done
+for all nodes when opening the file. For files with a large amount of nodes,
+setting the @cb{.ini} openThreads @ce @ref Trade-GltfImporter-configuration "configuration option"
+to a value other than @cpp 1 @ce splits the work among multiple threads. The
+outcome, including the error reported for an invalid file, is the same
+regardless of the thread count. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+application has to be linked to `pthread` on Linux for this to work. The
+option is ignored and the work done on the calling thread if Corrade isn't
+built with @ref CORRADE_BUILD_MULTITHREADED, as error output redirection
+isn't thread-local in that case.
+
 The content of the global [extensionsRequired](https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#specifying-extensions)
 array is checked against all extensions supported by the plugin. If a glTF file
 requires an unknown extension, the import will fail. This behaviour can be
@@ -190,6 +244,20 @@ importer plugins the importer delegates to.
     names for nested keys being separated with dots. Other value types,
     heterogeneous arrays and values that don't have a consistent type for given
     key across all nodes are ignored with a warning.
+-   If the [EXT_mesh_gpu_instancing](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/EXT_mesh_gpu_instancing/README.md)
+    extension is listed in `extensionsUsed`, its `TRANSLATION`, `ROTATION`
+    and `SCALE` attributes are imported as custom `instanceTranslation`
+    (@ref SceneFieldType::Vector3), `instanceRotation`
+    (@ref SceneFieldType::Quaternion) and `instanceScaling`
+    (@ref SceneFieldType::Vector3) fields, with names exposed through
+    @ref sceneFieldName() / @ref sceneFieldForName() right upon opening the
+    file. All three fields share the same object mapping, have one entry per
+    instance and are marked with @ref SceneFieldFlag::MultiEntry. Normalized
+    rotations are dequantized to floats and attributes that are missing for
+    given node are filled with an identity. The data are copied into the
+    @ref SceneData instance. Other attributes are ignored with a warning. If a
+    node `extras` property already uses one of the field names, the extension
+    isn't imported and a warning is printed.
 -   @ref SceneField::Mesh and @ref SceneField::MeshMaterial fields are always
     marked with @ref SceneFieldFlag::MultiEntry. No other builtin fields can
     have multiple entries for a single object. Node `extras` that were parsed
@@ -226,6 +294,31 @@ importer plugins the importer delegates to.
     @cpp 1 @ce and the merged animation has no name. With this option enabled,
     however, it can happen that multiple conflicting tracks affecting the same
     node are merged in the same clip, causing the animation to misbehave.
+-   The @cb{.ini} animationTargetNodes @ce and @cb{.ini} animationTargetPaths @ce
+    @ref Trade-GltfImporter-configuration "configuration options" can be used
+    to import only a subset of the tracks, for example just rotations of a few
+    skeleton joints. Data of samplers used only by the skipped tracks aren't
+    copied to the output.
+-   Animation data are by default copied out of the buffers. If the
+    @cb{.ini} zeroCopyAnimations @ce @ref Trade-GltfImporter-configuration "configuration option"
+    is enabled, the returned @ref AnimationData instead reference the buffer
+    memory directly, with @ref AnimationData::dataFlags() being empty. Such
+    data are valid only until the importer is closed. If any of the tracks
+    needs to be postprocessed, which is the case for spline tracks and linear
+    rotation tracks that get patched as described above, or if the tracks
+    span multiple buffers, the data are copied regardless.
+-   Skin joint IDs and inverse bind matrices are by default copied into newly
+    allocated arrays on every import. If the @cb{.ini} zeroCopySkins @ce
+    @ref Trade-GltfImporter-configuration "configuration option" is enabled
+    when opening a file, the returned @ref SkinData3D instead reference
+    non-owned memory with empty @ref DataFlags. Joint IDs of each skin are
+    then parsed only once into a single allocation, tightly packed inverse
+    bind matrices are referenced directly in the buffer and others are copied
+    into the same allocation. Importing the same skin again returns the same
+    views without any parsing or allocation. Such data are valid only until
+    the importer is closed. Morph target attributes are always a part of the
+    mesh vertex data and thus follow the @cb{.ini} zeroCopyMeshes @ce option
+    described in @ref Trade-GltfImporter-behavior-meshes.
 
 @subsection Trade-GltfImporter-behavior-cameras Camera import
 
@@ -316,7 +409,61 @@ importer plugins the importer delegates to.
     returned @ref Trade::MeshData::vertexCount() is set to @cpp 0 @ce
 -   Morph targets, if present, have their attributes imported with
     @ref Trade::MeshData::attributeMorphTargetId() set to index of the morph
-    target. Non-sparse buffers aren't supported for those at the moment.
+    target. Sparse accessors are supported only for morph target attributes,
+    where they're by default expanded to the full vertex count. If the
+    @cb{.ini} compactSparseMorphTargets @ce @ref Trade-GltfImporter-configuration "configuration option"
+    is enabled, sparse morph target attributes that have no base buffer view
+    are omitted from the mesh and each is instead available as an additional
+    mesh level, in the order the morph targets and their attributes are
+    listed in the file. Such level is a @ref MeshPrimitive::Points mesh
+    containing just the sparse values as the morph target attribute and a
+    custom @cb{.ini} SPARSE_INDEX @ce @ref VertexFormat::UnsignedInt
+    attribute with the vertex indices the values apply to. Its ID is
+    available through @ref meshAttributeForName().
+-   Vertex and index data are by default copied out of the buffers. If the
+    @cb{.ini} zeroCopyMeshes @ce @ref Trade-GltfImporter-configuration "configuration option"
+    is enabled, the returned @ref MeshData instead reference the buffer
+    memory directly, with both @ref MeshData::vertexDataFlags() and
+    @ref MeshData::indexDataFlags() being empty. Such data are valid only
+    until the importer is closed. If the mesh needs to be patched on import,
+    which is the case for the texture coordinate Y-flip and sparse morph
+    target attributes, the data are copied regardless.
+-   Mesh primitive properties and the buffers and accessors they reference are
+    by default parsed lazily on first access. Enabling the
+    @cb{.ini} parseMeshesOnOpen @ce @ref Trade-GltfImporter-configuration "configuration option"
+    makes the importer do all that already during @ref openData() /
+    @ref openFile(), making the subsequent @ref mesh() calls not modify any
+    internal state. Different meshes can then be imported from multiple
+    threads concurrently on a single importer instance, provided nothing
+    else is called on it at the same time. Meshes have to be referenced by
+    their IDs, as @ref meshForName() populates its lookup table lazily. The
+    guarantee doesn't hold with the
+    @ref Trade-GltfImporter-behavior-meshes-converter "mesh converter", which
+    is instantiated on first use, nor with the @cb{.ini} instrumentation @ce
+    option enabled, which adds a configuration group for each imported mesh.
+    Errors in invalid meshes are reported only once the particular mesh is
+    imported.
+-   Buffer views compressed with [EXT_meshopt_compression](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/EXT_meshopt_compression/README.md)
+    are decoded on first access, including the `OCTAHEDRAL`, `QUATERNION`
+    and `EXPONENTIAL` filters. The fallback buffer referenced by such views
+    isn't loaded at all. Decoded data stay in memory until the importer is
+    closed, so with @cb{.ini} zeroCopyMeshes @ce enabled the meshes reference
+    those.
+-   Primitives compressed with [KHR_draco_mesh_compression](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Khronos/KHR_draco_mesh_compression/README.md)
+    are decoded if the plugin is built with [Draco](https://github.com/google/draco),
+    which is an optional dependency that's used if found when building the
+    plugin. Only the primitive passed to @ref mesh() is decoded, on first
+    access, and the result stays in memory until the importer is closed, so
+    with @cb{.ini} zeroCopyMeshes @ce enabled the meshes reference it.
+    Attributes listed in the extension are taken from the decoded data, with
+    the accessors describing their type, and the decoded triangle list is
+    imported with the index type of the primitive index accessor. Only
+    @ref MeshPrimitive::Triangles with indices is supported. Attributes that
+    aren't listed in the extension and morph targets are imported from
+    regular accessors, copied next to the decoded data. Without Draco, files that don't list the
+    extension in `extensionsRequired` contain uncompressed fallback data,
+    which are imported instead, and importing a compressed primitive without
+    a fallback fails with a message saying so.
 
 By default, the mesh import silently allows certain features that aren't
 strictly valid according to the glTF specification, such as 32-bit integer
@@ -330,6 +477,48 @@ imported meshes as well. Their mapping to/from a string can be queried using
 unsupported types (such as non-normalized integer matrices) cause the import to
 fail.
 
+@subsubsection Trade-GltfImporter-behavior-meshes-output-allocator Custom output allocator
+
+Unless the @cb{.ini} zeroCopyMeshes @ce option is enabled, index and vertex
+data are copied into arrays allocated with the default array allocator and
+owned by the returned @ref MeshData. With @ref setOutputAllocator() it's
+possible to supply a custom allocator instead, for example one suballocating
+from an arena or from a persistently mapped GPU buffer, which avoids a copy
+when uploading. The allocator gets the size in bytes and the user data pointer
+and returns a pointer to memory of at least given size aligned to at least four
+bytes, or @cpp nullptr @ce on failure, in which case the import fails with an
+error. The returned mesh then only references the memory, with @ref
+DataFlag::Mutable set for both index and vertex data, and it's up to the
+application to keep it alive for as long as the mesh is used. Images are
+imported through other plugins and aren't affected by this setting.
+
+@subsubsection Trade-GltfImporter-behavior-meshes-converter Mesh conversion on import
+
+If the @cb{.ini} meshConverter @ce
+@ref Trade-GltfImporter-configuration "configuration option" is set to a name
+of a scene converter plugin supporting
+@ref SceneConverterFeature::ConvertMeshInPlace, such as
+@ref MeshOptimizerSceneConverter, each imported mesh is passed through its
+@ref AbstractSceneConverter::convertInPlace(MeshData&) "convertInPlace()"
+before being returned. The conversion operates directly on the index and
+vertex data allocated by the importer, including memory coming from a
+@ref Trade-GltfImporter-behavior-meshes-output-allocator "custom output allocator",
+so compared to running the converter on the returned mesh there's no extra
+allocation and copy. An @ref AbstractSceneConverter plugin manager has to be
+registered using
+@relativeref{Corrade,PluginManager::Manager::registerExternalManager()} for
+this to work, flags set via @ref setFlags() are propagated to the converter
+and options for it are meant to be set globally via
+@relativeref{Corrade,PluginManager::Manager::metadata()} through the scene
+converter manager. The converter instance is created on first use and kept
+until the file is closed.
+
+The @cb{.ini} zeroCopyMeshes @ce option is ignored for converted meshes, as
+the referenced buffer memory isn't mutable. Additional mesh levels created by
+the @cb{.ini} compactSparseMorphTargets @ce option and meshes that have them
+are returned unconverted, as the converter could reorder the vertices the
+levels refer to. If the conversion fails, the mesh import fails as well.
+
 @subsection Trade-GltfImporter-behavior-materials Material import
 
 -   If present, builtin [metallic/roughness](https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#metallic-roughness-material) material is imported,
@@ -458,7 +647,38 @@ following defaults have been chosen for this importer:
 </li>
 <li>If a texture contains and extension together with a fallback source, or
 multiple extensions, the image referenced by the first recognized extension
-appearing in the file will be picked, others ignored.</li>
+appearing in the file will be picked, others ignored. The application can
+override this with the @cb{.ini} preferredTextureExtensions @ce
+@ref Trade-GltfImporter-configuration "configuration option", listing the
+extensions in the order that's cheapest to load for it. For example, if the
+GPU supports BC7 natively, preferring @cb{.ini} KHR_texture_basisu @ce, which
+can be transcoded to it directly, and @cb{.ini} MSFT_texture_dds @ce over the
+core PNG or JPEG image avoids decoding the PNG and compressing it again
+altogether. The images that aren't picked are never opened.</li>
+<li>The importer opened for the most recently accessed image is kept around so
+importing its other levels doesn't open the file again. Use the
+@cb{.ini} imageImporterCacheSize @ce @ref Trade-GltfImporter-configuration "configuration option"
+to keep more of them, which avoids repeated opening when import of different
+images is interleaved.</li>
+<li>Setting the @cb{.ini} imageImporterPoolSize @ce @ref Trade-GltfImporter-configuration "configuration option"
+to a non-zero value puts importers of external image files into a pool
+shared by all @ref GltfImporter instances created from the same plugin
+manager once they're replaced in the above cache or the file is closed.
+Importing the same image file from another glTF file, or again after the
+file was closed and reopened, then takes the already opened importer from
+the pool instead of opening and parsing the image file again. The pool is
+thread-safe, each pooled importer is used by just one importer instance at
+a time. It's assumed the image files don't change while they're in the
+pool. The pool is emptied once the last @ref GltfImporter instance
+created from given plugin manager is destroyed.</li>
+<li>Enabling the @cb{.ini} openImagesOnOpen @ce @ref Trade-GltfImporter-configuration "configuration option"
+makes the importer open all images already during @ref openData() /
+@ref openFile(), printing errors for those that fail to open. The
+subsequent @ref image2D() / @ref image3D() calls and their level count
+queries then don't modify any internal state and different images can be
+imported from multiple threads concurrently on a single importer instance,
+provided nothing else is called on it at the same time and the delegated
+image importer plugins are thread-safe across instances.</li>
 </ul>
 
 @subsubsection Trade-GltfImporter-behavior-textures-array 2D array texture support
@@ -570,6 +790,19 @@ class MAGNUM_GLTFIMPORTER_EXPORT GltfImporter: public AbstractImporter {
 
         ~GltfImporter();
 
+        /**
+         * @brief Set an output allocator
+         * @m_since_latest_{plugins}
+         *
+         * If set, index and vertex data of imported meshes are allocated using
+         * @p allocator, which gets the size in bytes and @p userData. Passing
+         * @cpp nullptr @ce restores the default. The setting is kept across
+         * opened files. See @ref
+         * Trade-GltfImporter-behavior-meshes-output-allocator for more
+         * information.
+         */
+        virtual void setOutputAllocator(char*(*allocator)(std::size_t, void*), void* userData = nullptr);
+
         /**
          * @brief Importer state
          *
@@ -586,6 +819,8 @@ class MAGNUM_GLTFIMPORTER_EXPORT GltfImporter: public AbstractImporter {
 
     private:
         struct Document;
+        struct JsonCache;
+        struct SparseAccessor;
 
         MAGNUM_GLTFIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
 
@@ -629,6 +864,7 @@ class MAGNUM_GLTFIMPORTER_EXPORT GltfImporter: public AbstractImporter {
         MAGNUM_GLTFIMPORTER_LOCAL Containers::Optional<SkinData3D> doSkin3D(UnsignedInt id) override;
 
         MAGNUM_GLTFIMPORTER_LOCAL UnsignedInt doMeshCount() const override;
+        MAGNUM_GLTFIMPORTER_LOCAL UnsignedInt doMeshLevelCount(UnsignedInt id) override;
         MAGNUM_GLTFIMPORTER_LOCAL Int doMeshForName(Containers::StringView name) override;
         MAGNUM_GLTFIMPORTER_LOCAL Containers::String doMeshName(UnsignedInt id) override;
         MAGNUM_GLTFIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
@@ -646,6 +882,7 @@ class MAGNUM_GLTFIMPORTER_EXPORT GltfImporter: public AbstractImporter {
         MAGNUM_GLTFIMPORTER_LOCAL Containers::Optional<TextureData> doTexture(UnsignedInt id) override;
 
         MAGNUM_GLTFIMPORTER_LOCAL AbstractImporter* setupOrReuseImporterForImage(const char* errorPrefix, UnsignedInt id, UnsignedInt expectedDimensions);
+        MAGNUM_GLTFIMPORTER_LOCAL void releaseImageImporter(std::size_t slot);
 
         MAGNUM_GLTFIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_GLTFIMPORTER_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
@@ -662,13 +899,23 @@ class MAGNUM_GLTFIMPORTER_EXPORT GltfImporter: public AbstractImporter {
         MAGNUM_GLTFIMPORTER_LOCAL Containers::Optional<Containers::Array<char>> loadUri(const char* errorPrefix, Containers::StringView uri);
         MAGNUM_GLTFIMPORTER_LOCAL Containers::Optional<Containers::ArrayView<const char>> parseBuffer(const char* const errorPrefix, UnsignedInt id);
         MAGNUM_GLTFIMPORTER_LOCAL Containers::Optional<Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt>> parseBufferView(const char* errorPrefix, UnsignedInt bufferViewId);
+        MAGNUM_GLTFIMPORTER_LOCAL bool decodeMeshoptBufferView(const char* errorPrefix, UnsignedInt bufferViewId, const Utility::JsonToken& gltfMeshoptCompression, Containers::ArrayView<char> out);
+        MAGNUM_GLTFIMPORTER_LOCAL Containers::Optional<Containers::Pair<VertexFormat, std::size_t>> parseAccessorFormat(const char* errorPrefix, UnsignedInt accessorId);
         MAGNUM_GLTFIMPORTER_LOCAL Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> parseAccessor(const char* const errorPrefix, UnsignedInt accessorId);
+        MAGNUM_GLTFIMPORTER_LOCAL Containers::Optional<SparseAccessor> parseSparseAccessor(const char* errorPrefix, UnsignedInt accessorId);
+        #ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+        MAGNUM_GLTFIMPORTER_LOCAL bool decodeDracoPrimitive(UnsignedInt id, const Utility::JsonToken& gltfDracoCompression);
+        #endif
+        MAGNUM_GLTFIMPORTER_LOCAL Containers::Array<Containers::Triple<Containers::StringView, UnsignedInt, Int>> compactSparseMorphTargetAttributes(UnsignedInt id);
         MAGNUM_GLTFIMPORTER_LOCAL bool materialTexture(const Utility::JsonToken& gltfTexture, Containers::Array<MaterialAttributeData>& attributes, Containers::StringView attribute, Containers::StringView extraAttributePrefix, bool warningOnly = false);
         MAGNUM_GLTFIMPORTER_LOCAL bool materialTexture(const Utility::JsonToken& gltfTexture, Containers::Array<MaterialAttributeData>& attributes, Containers::StringView attribute, bool warningOnly = false);
 
         MAGNUM_GLTFIMPORTER_LOCAL const void* doImporterState() const override;
 
         Containers::Pointer<Document> _d;
+        Containers::Pointer<JsonCache> _jsonCache;
+        char*(*_outputAllocator)(std::size_t, void*){};
+        void* _outputAllocatorUserData{};
 };
 
 }}
@@ -0,0 +1,314 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <string>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/FileCallback.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MeshData.h>
+#include <Magnum/Trade/SceneData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+/* Compares GltfImporter with TinyGltfImporter on the same set of synthetic
+   files representing different content classes. CgltfImporter isn't listed
+   as it's just an alias to GltfImporter nowadays. */
+struct GltfImporterBenchmark: TestSuite::Tester {
+    explicit GltfImporterBenchmark();
+
+    void open();
+    void mesh();
+    void meshDataSize();
+    void scene();
+    void image();
+
+    void dataSizeBegin();
+    std::uint64_t dataSizeEnd();
+
+    private:
+        /* Needs to load AnyImageImporter from a system-wide location */
+        PluginManager::Manager<AbstractImporter> _manager;
+        std::string _files[4];
+        Containers::Optional<Containers::Array<char>> _image;
+        std::uint64_t _dataSize;
+};
+
+enum: std::size_t {
+    TinyFile,
+    MeshFile,
+    NodeFile,
+    TextureFile
+};
+
+constexpr UnsignedInt MeshCount = 256;
+constexpr UnsignedInt MeshVertexCount = 1024;
+constexpr UnsignedInt MeshIndexCount = 3072;
+/* Full binary tree */
+constexpr UnsignedInt NodeCount = (1 << 16) - 1;
+constexpr UnsignedInt TextureCount = 64;
+
+const struct {
+    const char* name;
+    const char* plugin;
+} ImporterData[]{
+    {"GltfImporter", "GltfImporter"},
+    {"TinyGltfImporter", "TinyGltfImporter"},
+};
+
+const struct {
+    const char* name;
+    const char* plugin;
+    std::size_t file;
+} OpenData[]{
+    {"GltfImporter, tiny", "GltfImporter", TinyFile},
+    {"GltfImporter, mesh-heavy", "GltfImporter", MeshFile},
+    {"GltfImporter, node-heavy", "GltfImporter", NodeFile},
+    {"GltfImporter, texture-heavy", "GltfImporter", TextureFile},
+    {"TinyGltfImporter, tiny", "TinyGltfImporter", TinyFile},
+    {"TinyGltfImporter, mesh-heavy", "TinyGltfImporter", MeshFile},
+    {"TinyGltfImporter, node-heavy", "TinyGltfImporter", NodeFile},
+    {"TinyGltfImporter, texture-heavy", "TinyGltfImporter", TextureFile},
+};
+
+GltfImporterBenchmark::GltfImporterBenchmark() {
+    addInstancedBenchmarks({&GltfImporterBenchmark::open}, 10,
+        Containers::arraySize(OpenData));
+
+    addInstancedBenchmarks({&GltfImporterBenchmark::mesh}, 100,
+        Containers::arraySize(ImporterData));
+
+    /* Not a peak memory use, which can't be measured portably from within
+       the process, but at least the amount of memory held by the imported
+       data */
+    addCustomInstancedBenchmarks({&GltfImporterBenchmark::meshDataSize}, 1,
+        Containers::arraySize(ImporterData),
+        &GltfImporterBenchmark::dataSizeBegin,
+        &GltfImporterBenchmark::dataSizeEnd,
+        BenchmarkUnits::Bytes);
+
+    addInstancedBenchmarks({&GltfImporterBenchmark::scene}, 10,
+        Containers::arraySize(ImporterData));
+
+    addInstancedBenchmarks({&GltfImporterBenchmark::image}, 10,
+        Containers::arraySize(ImporterData));
+
+    /* Load the plugins directly from the build tree. Otherwise they're static
+       and already loaded. It also pulls in the AnyImageImporter
+       dependency. */
+    #ifdef GLTFIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(GLTFIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef TINYGLTFIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(TINYGLTFIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    /* Reset the plugin dir after so it doesn't load anything else from the
+       filesystem. Do this also in case of static plugins (no _FILENAME
+       defined) so it doesn't attempt to load dynamic system-wide plugins. */
+    #ifndef CORRADE_PLUGINMANAGER_NO_DYNAMIC_PLUGIN_SUPPORT
+    _manager.setPluginDirectory({});
+    #endif
+    #ifdef STBIMAGEIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(STBIMAGEIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+
+    /* A single node and nothing else */
+    _files[TinyFile] = R"({"asset": {"version": "2.0"}, "scenes": [{"nodes": [0]}], "nodes": [{}]})";
+
+    /* Many meshes sharing the same buffer. Zero bytes Base64-encoded are just
+       'A's, the size is divisible by three so there's no padding. */
+    {
+        constexpr UnsignedInt BufferSize = MeshVertexCount*12 + MeshIndexCount*2;
+        static_assert(BufferSize % 3 == 0, "buffer needs padding");
+        std::string& json = _files[MeshFile];
+        json = R"({"asset": {"version": "2.0"}, "buffers": [{"byteLength": )" + std::to_string(BufferSize) + R"(, "uri": "data:application/octet-stream;base64,)" + std::string(BufferSize/3*4, 'A') + R"("}], )";
+        json += R"("bufferViews": [{"buffer": 0, "byteLength": )" + std::to_string(MeshVertexCount*12) + R"(}, {"buffer": 0, "byteOffset": )" + std::to_string(MeshVertexCount*12) + R"(, "byteLength": )" + std::to_string(MeshIndexCount*2) + R"(}], )";
+        json += R"("accessors": [{"bufferView": 0, "componentType": 5126, "count": )" + std::to_string(MeshVertexCount) + R"(, "type": "VEC3", "min": [0, 0, 0], "max": [0, 0, 0]}, {"bufferView": 1, "componentType": 5123, "count": )" + std::to_string(MeshIndexCount) + R"(, "type": "SCALAR"}], "meshes": [)";
+        for(UnsignedInt i = 0; i != MeshCount; ++i) {
+            if(i) json += ", ";
+            json += R"({"primitives": [{"attributes": {"POSITION": 0}, "indices": 1}]})";
+        }
+        json += "]}";
+    }
+
+    /* Many nodes with a TRS transformation */
+    {
+        std::string& json = _files[NodeFile];
+        json = R"({"asset": {"version": "2.0"}, "scenes": [{"nodes": [0]}], "nodes": [)";
+        for(UnsignedInt i = 0; i != NodeCount; ++i) {
+            if(i) json += ", ";
+            json += R"({"translation": [)" + std::to_string(i) + R"(, 0, 0], "rotation": [0, 0, 0, 1])";
+            if(2*i + 2 < NodeCount)
+                json += R"(, "children": [)" + std::to_string(2*i + 1) + ", " + std::to_string(2*i + 2) + "]";
+            json += "}";
+        }
+        json += "]}";
+    }
+
+    /* Many textures and images all referencing the same external file,
+       supplied through a file callback */
+    {
+        std::string& json = _files[TextureFile];
+        json = R"({"asset": {"version": "2.0"}, "images": [)";
+        for(UnsignedInt i = 0; i != TextureCount; ++i) {
+            if(i) json += ", ";
+            json += R"({"uri": "image.png"})";
+        }
+        json += R"(], "textures": [)";
+        for(UnsignedInt i = 0; i != TextureCount; ++i) {
+            if(i) json += ", ";
+            json += R"({"source": )" + std::to_string(i) + "}";
+        }
+        json += "]}";
+    }
+
+    _image = Utility::Path::read(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "image.png"));
+    CORRADE_INTERNAL_ASSERT(_image);
+}
+
+void GltfImporterBenchmark::dataSizeBegin() {
+    _dataSize = 0;
+}
+
+std::uint64_t GltfImporterBenchmark::dataSizeEnd() {
+    return _dataSize;
+}
+
+void GltfImporterBenchmark::open() {
+    auto&& data = OpenData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState(data.plugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.plugin << "plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate(data.plugin);
+    const Containers::ArrayView<const char> file{_files[data.file].data(), _files[data.file].size()};
+
+    /* External files aren't loaded on open, the callback isn't needed */
+    bool opened = true;
+    CORRADE_BENCHMARK(10) {
+        opened = importer->openData(file) && opened;
+    }
+
+    CORRADE_VERIFY(opened);
+}
+
+void GltfImporterBenchmark::mesh() {
+    auto&& data = ImporterData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState(data.plugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.plugin << "plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate(data.plugin);
+    CORRADE_VERIFY(importer->openData({_files[MeshFile].data(), _files[MeshFile].size()}));
+    CORRADE_COMPARE(importer->meshCount(), MeshCount);
+
+    /* Each iteration imports a different mesh */
+    UnsignedInt id = 0;
+    std::size_t vertexCount = 0;
+    CORRADE_BENCHMARK(100) {
+        Containers::Optional<MeshData> mesh = importer->mesh(id++ % MeshCount);
+        vertexCount += mesh ? mesh->vertexCount() : 0;
+    }
+
+    CORRADE_COMPARE(vertexCount, 100*MeshVertexCount);
+}
+
+void GltfImporterBenchmark::meshDataSize() {
+    auto&& data = ImporterData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState(data.plugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.plugin << "plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate(data.plugin);
+    CORRADE_VERIFY(importer->openData({_files[MeshFile].data(), _files[MeshFile].size()}));
+
+    CORRADE_BENCHMARK(1) {
+        Containers::Optional<MeshData> mesh = importer->mesh(0);
+        if(mesh) _dataSize += mesh->vertexData().size() + mesh->indexData().size();
+    }
+
+    CORRADE_VERIFY(_dataSize);
+}
+
+void GltfImporterBenchmark::scene() {
+    auto&& data = ImporterData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState(data.plugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.plugin << "plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate(data.plugin);
+    CORRADE_VERIFY(importer->openData({_files[NodeFile].data(), _files[NodeFile].size()}));
+
+    std::size_t objectCount = 0;
+    CORRADE_BENCHMARK(10) {
+        Containers::Optional<SceneData> scene = importer->scene(0);
+        objectCount += scene ? scene->fieldSize(SceneField::Parent) : 0;
+    }
+
+    CORRADE_COMPARE(objectCount, 10*NodeCount);
+}
+
+void GltfImporterBenchmark::image() {
+    auto&& data = ImporterData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState(data.plugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.plugin << "plugin not found, cannot test");
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate(data.plugin);
+    importer->setFileCallback([](const std::string&, InputFileCallbackPolicy, Containers::Array<char>& image) -> Containers::Optional<Containers::ArrayView<const char>> {
+        return Containers::ArrayView<const char>{image};
+    }, *_image);
+    CORRADE_VERIFY(importer->openData({_files[TextureFile].data(), _files[TextureFile].size()}));
+    CORRADE_COMPARE(importer->image2DCount(), TextureCount);
+
+    /* Each iteration imports a different image so the importer can't reuse
+       the already opened one */
+    UnsignedInt id = 0;
+    std::size_t imageCount = 0;
+    CORRADE_BENCHMARK(10) {
+        imageCount += !!importer->image2D(id++ % TextureCount);
+    }
+
+    CORRADE_COMPARE(imageCount, 10);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::GltfImporterBenchmark)
@@ -25,6 +25,7 @@
 
 #include <sstream>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo drop when Debug is stream-free */
 #include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/FormatStl.h> /** @todo drop when Debug is stream-free */
@@ -42,6 +43,19 @@ struct GltfImporterDecodeTest: TestSuite::Tester {
     void base64();
     void base64Padding();
     void base64Invalid();
+
+    void benchmarkUriNoEscapes();
+    void benchmarkUri();
+    void benchmarkBase64();
+
+    void meshoptAttributes();
+    void meshoptTriangles();
+    void meshoptIndices();
+    void meshoptInvalid();
+
+    void meshoptFilterOctahedral();
+    void meshoptFilterQuaternion();
+    void meshoptFilterExponential();
 };
 
 using namespace Containers::Literals;
@@ -124,7 +138,67 @@ const struct {
         "invalid Base64 block d2\xffy"},
     {"byte > 127 in the input padding",
         "d29yay\xff=",
-        "invalid Base64 padding bytes ay\xff"}
+        "invalid Base64 padding bytes ay\xff"},
+    {"invalid byte in a batch of four blocks",
+        "bGlnaHQgd2_yay4hbGlnaHQg",
+        "invalid Base64 block d2_y"}
+};
+
+enum class MeshoptMode {
+    Attributes,
+    Triangles,
+    Indices
+};
+
+const struct {
+    const char* name;
+    MeshoptMode mode;
+    Containers::StringView input;
+    std::size_t count;
+    const char* message;
+} MeshoptInvalidData[]{
+    {"attributes too short", MeshoptMode::Attributes,
+        "\xa0\0\0\0\0\0\0\0\0\0\0"_s, 2,
+        "meshopt attribute data too short, expected at least 33 bytes but got 11"},
+    {"attributes unsupported header", MeshoptMode::Attributes,
+        "\xa1\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"
+        "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"_s, 2,
+        "unsupported meshopt attribute data header 0xa1"},
+    {"attributes truncated", MeshoptMode::Attributes,
+        /* Raw bytes of the first byte stream eat into the tail */
+        "\xa0\x03\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"
+        "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"_s, 2,
+        "truncated meshopt attribute data"},
+    {"attributes unused bytes", MeshoptMode::Attributes,
+        "\xa0\0\0\0\0\xff\0\0\0\0\0\0\0\0\0\0\0"
+        "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"_s, 1,
+        "meshopt attribute data have 1 unused bytes"},
+    {"triangles too short", MeshoptMode::Triangles,
+        "\xe1\xfe\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"_s, 6,
+        "meshopt triangle data too short, expected at least 19 bytes but got 17"},
+    {"triangles unsupported header", MeshoptMode::Triangles,
+        "\xe2\xfe\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"_s, 3,
+        "unsupported meshopt triangle data header 0xe2"},
+    {"triangles truncated", MeshoptMode::Triangles,
+        /* The first triangle reads its code from where the table starts */
+        "\xe1\xfe\xfe\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"_s, 6,
+        "truncated meshopt triangle data"},
+    {"triangles unused bytes", MeshoptMode::Triangles,
+        "\xe1\xf0\xff\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"_s, 3,
+        "meshopt triangle data have 1 unused bytes"},
+    {"indices too short", MeshoptMode::Indices,
+        "\xd1\0\0\0\0\0"_s, 2,
+        "meshopt index data too short, expected at least 7 bytes but got 6"},
+    {"indices unsupported header", MeshoptMode::Indices,
+        "\xc1\0\0\0\0\0\0"_s, 2,
+        "unsupported meshopt index data header 0xc1"},
+    {"indices truncated", MeshoptMode::Indices,
+        /* The first index is three bytes, going into the tail */
+        "\xd1\x80\x80\0\0\0\0"_s, 2,
+        "truncated meshopt index data"},
+    {"indices unused bytes", MeshoptMode::Indices,
+        "\xd1\0\0\0\0\0\0"_s, 1,
+        "meshopt index data have 1 unused bytes"}
 };
 
 GltfImporterDecodeTest::GltfImporterDecodeTest() {
@@ -140,6 +214,21 @@ GltfImporterDecodeTest::GltfImporterDecodeTest() {
 
     addInstancedTests({&GltfImporterDecodeTest::base64Invalid},
         Containers::arraySize(Base64InvalidData));
+
+    addBenchmarks({&GltfImporterDecodeTest::benchmarkUriNoEscapes,
+                   &GltfImporterDecodeTest::benchmarkUri,
+                   &GltfImporterDecodeTest::benchmarkBase64}, 10);
+
+    addTests({&GltfImporterDecodeTest::meshoptAttributes,
+              &GltfImporterDecodeTest::meshoptTriangles,
+              &GltfImporterDecodeTest::meshoptIndices});
+
+    addInstancedTests({&GltfImporterDecodeTest::meshoptInvalid},
+        Containers::arraySize(MeshoptInvalidData));
+
+    addTests({&GltfImporterDecodeTest::meshoptFilterOctahedral,
+              &GltfImporterDecodeTest::meshoptFilterQuaternion,
+              &GltfImporterDecodeTest::meshoptFilterExponential});
 }
 
 void GltfImporterDecodeTest::uri() {
@@ -236,6 +325,161 @@ void GltfImporterDecodeTest::base64Invalid() {
     CORRADE_COMPARE(out.str(), Utility::formatString("foo(): {}\n", data.message));
 }
 
+void GltfImporterDecodeTest::benchmarkUriNoEscapes() {
+    Containers::String uri{DirectInit, 1024*1024, 'a'};
+
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(10) {
+        Containers::Optional<Containers::String> out = decodeUri("foo():", uri);
+        size += out->size();
+    }
+
+    CORRADE_COMPARE(size, 10*1024*1024);
+}
+
+void GltfImporterDecodeTest::benchmarkUri() {
+    /* An escape every 16 characters */
+    Containers::String uri{DirectInit, 1024*1024, 'a'};
+    for(std::size_t i = 0; i < uri.size(); i += 16) {
+        uri[i + 0] = '%';
+        uri[i + 1] = '2';
+        uri[i + 2] = '0';
+    }
+
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(10) {
+        Containers::Optional<Containers::String> out = decodeUri("foo():", uri);
+        size += out->size();
+    }
+
+    CORRADE_COMPARE(size, 10*(1024*1024 - 1024*1024/16*2));
+}
+
+void GltfImporterDecodeTest::benchmarkBase64() {
+    /* Base64 of "light work." without the padding repeated over and over.
+       The size is divisible by four, so there's no padding at the end. */
+    Containers::String input{NoInit, 1024*1024};
+    for(std::size_t i = 0; i != input.size(); ++i)
+        input[i] = "bGlnaHQgd29yay4"[i % 15];
+
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(10) {
+        Containers::Optional<Containers::Array<char>> out = decodeBase64("foo():", input);
+        size += out->size();
+    }
+
+    CORRADE_COMPARE(size, 10*1024*1024/4*3);
+}
+
+void GltfImporterDecodeTest::meshoptAttributes() {
+    /* Two four-byte vertices, {1, 2, 3, 4} and {3, 2, 1, 4}. The first is
+       stored in the tail, the first byte stream is 2-bit with the second value
+       a zigzag-encoded +2 escaped after the packed values, the third is raw
+       bytes with a zigzag-encoded -2, the others are all zeros. */
+    Containers::StringView input =
+        "\xa0"
+        "\x01" "\x30\x00\x00\x00" "\x04"
+        "\x00"
+        "\x03" "\x00\x03\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+        "\x00"
+        "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"
+        "\x01\x02\x03\x04"_s;
+
+    UnsignedByte out[8];
+    CORRADE_VERIFY(decodeMeshoptAttributes("foo():", input, Containers::arrayCast<char>(Containers::arrayView(out)), 2, 4));
+    CORRADE_COMPARE_AS(Containers::arrayView(out), Containers::arrayView<UnsignedByte>({
+        1, 2, 3, 4,
+        3, 2, 1, 4
+    }), TestSuite::Compare::Container);
+}
+
+void GltfImporterDecodeTest::meshoptTriangles() {
+    /* A fresh triangle with the code in the data, a fresh triangle with the
+       code from the table, a triangle reusing the last edge with a new vertex
+       and a triangle reusing the last edge with a free index */
+    Containers::StringView input =
+        "\xe1"
+        "\xfe\xf0\x00\x0f"
+        "\x00\x04"
+        "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"_s;
+
+    UnsignedShort out[12];
+    CORRADE_VERIFY(decodeMeshoptTriangles("foo():", input, Containers::arrayCast<char>(Containers::arrayView(out)), 12, 2));
+    CORRADE_COMPARE_AS(Containers::arrayView(out), Containers::arrayView<UnsignedShort>({
+        0, 1, 2,
+        3, 4, 5,
+        3, 5, 6,
+        3, 6, 2
+    }), TestSuite::Compare::Container);
+}
+
+void GltfImporterDecodeTest::meshoptIndices() {
+    /* Zigzag-encoded +5, +1 and -2 against the first baseline */
+    Containers::StringView input = "\xd1\x14\x04\x06\0\0\0\0"_s;
+
+    UnsignedInt out[3];
+    CORRADE_VERIFY(decodeMeshoptIndices("foo():", input, Containers::arrayCast<char>(Containers::arrayView(out)), 3, 4));
+    CORRADE_COMPARE_AS(Containers::arrayView(out), Containers::arrayView<UnsignedInt>({
+        5, 6, 4
+    }), TestSuite::Compare::Container);
+}
+
+void GltfImporterDecodeTest::meshoptInvalid() {
+    auto&& data = MeshoptInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    char out[16];
+    std::ostringstream outError;
+    Error redirectError{&outError};
+    if(data.mode == MeshoptMode::Attributes)
+        CORRADE_VERIFY(!decodeMeshoptAttributes("foo():", data.input, Containers::arrayView(out).prefix(data.count*4), data.count, 4));
+    else if(data.mode == MeshoptMode::Triangles)
+        CORRADE_VERIFY(!decodeMeshoptTriangles("foo():", data.input, Containers::arrayView(out).prefix(data.count*2), data.count, 2));
+    else if(data.mode == MeshoptMode::Indices)
+        CORRADE_VERIFY(!decodeMeshoptIndices("foo():", data.input, Containers::arrayView(out).prefix(data.count*2), data.count, 2));
+    else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+    CORRADE_COMPARE(outError.str(), Utility::formatString("foo(): {}\n", data.message));
+}
+
+void GltfImporterDecodeTest::meshoptFilterOctahedral() {
+    /* Positive and negative Z hemisphere, the fourth component is kept
+       untouched */
+    Byte data[]{
+        0, 0, 127, 5,
+        127, 0, 0, 7
+    };
+    meshoptFilterOctahedral<Byte>(Containers::arrayCast<char>(Containers::arrayView(data)));
+    CORRADE_COMPARE_AS(Containers::arrayView(data), Containers::arrayView<Byte>({
+        0, 0, 127, 5,
+        0, -90, -90, 7
+    }), TestSuite::Compare::Container);
+}
+
+void GltfImporterDecodeTest::meshoptFilterQuaternion() {
+    /* Identity with the largest component being W and Z, respectively */
+    Short data[]{
+        0, 0, 0, 32767,
+        0, 0, 0, 32766
+    };
+    meshoptFilterQuaternion(Containers::arrayCast<char>(Containers::arrayView(data)));
+    CORRADE_COMPARE_AS(Containers::arrayView(data), Containers::arrayView<Short>({
+        0, 0, 0, 32767,
+        0, 0, 32767, 0
+    }), TestSuite::Compare::Container);
+}
+
+void GltfImporterDecodeTest::meshoptFilterExponential() {
+    UnsignedInt data[]{
+        0xfe000003, /* 3*2^-2 */
+        0x00ffffff, /* -1*2^0 */
+        0x01000005  /* 5*2^1 */
+    };
+    meshoptFilterExponential(Containers::arrayCast<char>(Containers::arrayView(data)));
+    CORRADE_COMPARE_AS(Containers::arrayCast<Float>(Containers::arrayView(data)), Containers::arrayView({
+        0.75f, -1.0f, 10.0f
+    }), TestSuite::Compare::Container);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::GltfImporterDecodeTest)
@@ -26,6 +26,9 @@
 */
 
 #include <sstream>
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+#include <thread>
+#endif
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
@@ -52,6 +55,7 @@
 #include <Magnum/Math/CubicHermite.h>
 #include <Magnum/MeshTools/Transform.h>
 #include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
 #include <Magnum/Trade/AnimationData.h>
 #include <Magnum/Trade/CameraData.h>
 #include <Magnum/Trade/ImageData.h>
@@ -77,6 +81,8 @@
 #include <emscripten/version.h>
 #endif
 
+#include "MagnumPlugins/GltfImporter/configure.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -90,6 +96,7 @@ struct GltfImporterTest: TestSuite::Tester {
     void openIgnoreUnknownChunk();
     void openExternalDataOrder();
     void openExternalDataNoPathNoCallback();
+    void openExternalDataMapped();
     void openExternalDataTooLong();
     void openExternalDataTooShort();
     void openExternalDataInvalidUri();
@@ -102,6 +109,8 @@ struct GltfImporterTest: TestSuite::Tester {
     void animationInvalid();
     void animationInvalidBufferNotFound();
     void animationMissingTargetNode();
+    void animationTargetSubset();
+    void animationTargetSubsetInvalid();
 
     void animationSpline();
     void animationSplineSharedWithSameTimeTrack();
@@ -113,6 +122,8 @@ struct GltfImporterTest: TestSuite::Tester {
     void animationQuaternionNormalizationDisabled();
     void animationMergeEmpty();
     void animationMerge();
+    void animationZeroCopy();
+    void animationZeroCopyPatched();
 
     void camera();
     void cameraInvalid();
@@ -121,7 +132,9 @@ struct GltfImporterTest: TestSuite::Tester {
     void lightInvalid();
 
     void scene();
+    void sceneNameMapsOnOpen();
     void sceneInvalidWholeFile();
+    void sceneHierarchyThreads();
     void sceneInvalid();
     void sceneDefaultNoDefault();
     void sceneDefaultOutOfRange();
@@ -130,8 +143,11 @@ struct GltfImporterTest: TestSuite::Tester {
     void sceneTransformationQuaternionNormalizationDisabled();
     void sceneCustomFields();
     void sceneCustomFieldsInvalidConfiguration();
+    void sceneMeshGpuInstancing();
+    void sceneBenchmark();
 
     void skin();
+    void skinZeroCopy();
     void skinInvalid();
     void skinInvalidBufferNotFound();
 
@@ -140,6 +156,17 @@ struct GltfImporterTest: TestSuite::Tester {
     void meshNoIndices();
     void meshNoIndicesNoAttributes();
     void meshNoIndicesNoVerticesNoBufferUri();
+    void meshZeroCopy();
+    void meshParseOnOpen();
+    void meshParseOnOpenInvalid();
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    void meshParseOnOpenMultithreaded();
+    #endif
+    void meshMeshopt();
+    void meshMeshoptInvalid();
+    void meshDraco();
+    void meshDracoInvalid();
+    void meshDracoMixed();
     void meshColors();
     void meshSkinAttributes();
     void meshCustomAttributes();
@@ -147,6 +174,8 @@ struct GltfImporterTest: TestSuite::Tester {
     void meshDuplicateAttributes();
     void meshUnorderedAttributes();
     void meshMorphTargetAttributes();
+    void meshSparseMorphTargets();
+    void meshSparseMorphTargetsCompact();
     void meshMultiplePrimitives();
     void meshUnsignedIntVertexFormats();
     void meshUnsupportedVertexFormats();
@@ -155,6 +184,8 @@ struct GltfImporterTest: TestSuite::Tester {
     void meshInvalidWholeFile();
     void meshInvalid();
     void meshInvalidBufferNotFound();
+    void meshConverter();
+    void meshConverterNotFound();
 
     void materialPbrMetallicRoughness();
     void materialPbrSpecularGlossiness();
@@ -177,6 +208,7 @@ struct GltfImporterTest: TestSuite::Tester {
 
     void texture();
     void textureExtensions();
+    void textureExtensionsPreferred();
     void textureInvalid();
 
     void imageEmbedded();
@@ -187,6 +219,10 @@ struct GltfImporterTest: TestSuite::Tester {
     void imageInvalid();
     void imageInvalidNotFound();
     void imagePropagateImporterFlags();
+    void imageImporterCache();
+    void imageImporterPool();
+    void imageOpenOnOpen();
+    void imageOpenOnOpenInvalid();
 
     void experimentalKhrTextureKtx2D();
     void experimentalKhrTextureKtx2DArray();
@@ -209,11 +245,17 @@ struct GltfImporterTest: TestSuite::Tester {
     void versionUnsupported();
 
     void openMemory();
+    void openPartialGlb();
+    void openCacheJsonTokens();
+    void openCacheTexturesAndMaterials();
     void openTwice();
     void importTwice();
 
     /* Needs to load AnyImageImporter from a system-wide location */
     PluginManager::Manager<AbstractImporter> _manager;
+    /* Explicitly forbid system-wide plugin dependencies. Registered as an
+       external manager for the meshConverter option. */
+    PluginManager::Manager<AbstractSceneConverter> _converterManager{"nonexistent"};
 };
 
 /* The external-data.* files are packed in via a resource, filename mapping
@@ -490,6 +532,26 @@ constexpr struct {
     {"binary embedded", "-embedded.glb"}
 };
 
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+constexpr struct {
+    const char* name;
+    const char* filename;
+    UnsignedInt meshCount;
+} MeshParseOnOpenMultithreadedData[]{
+    {"single primitives", "mesh.gltf", 4},
+    {"multiple primitives", "mesh-multiple-primitives.gltf", 7},
+    /* Only the first meshes in these files are valid */
+    {"EXT_meshopt_compression", "mesh-meshopt.gltf", 2},
+    {"KHR_draco_mesh_compression", "mesh-draco.gltf",
+        #ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+        2
+        #else
+        1
+        #endif
+    },
+};
+#endif
+
 constexpr struct {
     const char* name;
     const char* message;
@@ -769,6 +831,20 @@ const struct {
     {"strict, binary", ".glb", true, "Trade::GltfImporter::mesh(): strict mode enabled, disallowing a mesh with no vertices\n"}
 };
 
+const struct {
+    const char* name;
+    const char* suffix;
+    bool textureCoordinateYFlipInMaterial;
+    DataFlags expectedDataFlags;
+} MeshZeroCopyData[]{
+    {"ascii external", ".gltf", true, {}},
+    {"ascii embedded", "-embedded.gltf", true, {}},
+    {"binary external", ".glb", true, {}},
+    {"binary embedded", "-embedded.glb", true, {}},
+    {"texture coordinate Y-flip needed, ascii", ".gltf", false, DataFlag::Owned|DataFlag::Mutable},
+    {"texture coordinate Y-flip needed, binary", ".glb", false, DataFlag::Owned|DataFlag::Mutable}
+};
+
 /** @todo remove once the compatibilitySkinningAttributes option is gone */
 const struct {
     const char* name;
@@ -1206,6 +1282,19 @@ constexpr struct {
         "Trade::GltfImporter::material(): invalid baseColorTexture KHR_texture_transform offset property\n"},
 };
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+    bool cycle;
+} SceneHierarchyThreadsData[]{
+    {"", 1, false},
+    {"4 threads", 4, false},
+    {"all threads", 0, false},
+    {"cycle", 1, true},
+    {"cycle, 4 threads", 4, true},
+    {"cycle, all threads", 0, true},
+};
+
 const struct {
     TestSuite::TestCaseDescriptionSourceLocation name;
     const char* file;
@@ -1459,6 +1548,17 @@ constexpr struct {
     {"binary buffer", "-buffer.glb"},
 };
 
+const struct {
+    const char* name;
+    UnsignedInt cacheSize;
+    std::size_t expectedOpenCount;
+} ImageImporterCacheData[]{
+    {"default", 0, 4},
+    {"single", 1, 4},
+    {"two", 2, 2},
+    {"more than images", 5, 2}
+};
+
 constexpr struct {
     const char* name;
     const char* suffix;
@@ -1610,7 +1710,8 @@ GltfImporterTest::GltfImporterTest() {
     addInstancedTests({&GltfImporterTest::openExternalDataOrder},
         Containers::arraySize(SingleFileData));
 
-    addTests({&GltfImporterTest::openExternalDataNoPathNoCallback});
+    addTests({&GltfImporterTest::openExternalDataNoPathNoCallback,
+              &GltfImporterTest::openExternalDataMapped});
 
     addInstancedTests({&GltfImporterTest::openExternalDataTooLong},
         Containers::arraySize(SingleFileData));
@@ -1636,7 +1737,9 @@ GltfImporterTest::GltfImporterTest() {
     addInstancedTests({&GltfImporterTest::animationInvalidBufferNotFound},
         Containers::arraySize(AnimationInvalidBufferNotFoundData));
 
-    addTests({&GltfImporterTest::animationMissingTargetNode});
+    addTests({&GltfImporterTest::animationMissingTargetNode,
+              &GltfImporterTest::animationTargetSubset,
+              &GltfImporterTest::animationTargetSubsetInvalid});
 
     addInstancedTests({&GltfImporterTest::animationSpline},
                       Containers::arraySize(MultiFileData));
@@ -1652,7 +1755,9 @@ GltfImporterTest::GltfImporterTest() {
 
     addTests({&GltfImporterTest::animationQuaternionNormalizationDisabled,
               &GltfImporterTest::animationMergeEmpty,
-              &GltfImporterTest::animationMerge});
+              &GltfImporterTest::animationMerge,
+              &GltfImporterTest::animationZeroCopy,
+              &GltfImporterTest::animationZeroCopyPatched});
 
     addTests({&GltfImporterTest::camera});
 
@@ -1664,11 +1769,15 @@ GltfImporterTest::GltfImporterTest() {
     addInstancedTests({&GltfImporterTest::lightInvalid},
         Containers::arraySize(LightInvalidData));
 
-    addTests({&GltfImporterTest::scene});
+    addTests({&GltfImporterTest::scene,
+              &GltfImporterTest::sceneNameMapsOnOpen});
 
     addInstancedTests({&GltfImporterTest::sceneInvalidWholeFile},
         Containers::arraySize(SceneInvalidWholeFileData));
 
+    addInstancedTests({&GltfImporterTest::sceneHierarchyThreads},
+        Containers::arraySize(SceneHierarchyThreadsData));
+
     addInstancedTests({&GltfImporterTest::sceneInvalid},
         Containers::arraySize(SceneInvalidData));
 
@@ -1686,9 +1795,16 @@ GltfImporterTest::GltfImporterTest() {
 
     addTests({&GltfImporterTest::sceneCustomFieldsInvalidConfiguration});
 
+    addInstancedTests({&GltfImporterTest::sceneMeshGpuInstancing},
+        Containers::arraySize(QuietData));
+
+    addBenchmarks({&GltfImporterTest::sceneBenchmark}, 10);
+
     addInstancedTests({&GltfImporterTest::skin},
         Containers::arraySize(MultiFileData));
 
+    addTests({&GltfImporterTest::skinZeroCopy});
+
     addInstancedTests({&GltfImporterTest::skinInvalid},
         Containers::arraySize(SkinInvalidData));
 
@@ -1708,6 +1824,24 @@ GltfImporterTest::GltfImporterTest() {
     addInstancedTests({&GltfImporterTest::meshNoIndicesNoVerticesNoBufferUri},
         Containers::arraySize(MeshNoVerticesData));
 
+    addInstancedTests({&GltfImporterTest::meshZeroCopy},
+        Containers::arraySize(MeshZeroCopyData));
+
+    addInstancedTests({&GltfImporterTest::meshParseOnOpen},
+        Containers::arraySize(MultiFileData));
+
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    addRepeatedInstancedTests({&GltfImporterTest::meshParseOnOpenMultithreaded}, 10,
+        Containers::arraySize(MeshParseOnOpenMultithreadedData));
+    #endif
+
+    addTests({&GltfImporterTest::meshParseOnOpenInvalid,
+              &GltfImporterTest::meshMeshopt,
+              &GltfImporterTest::meshMeshoptInvalid,
+              &GltfImporterTest::meshDraco,
+              &GltfImporterTest::meshDracoInvalid,
+              &GltfImporterTest::meshDracoMixed});
+
     addTests({&GltfImporterTest::meshColors});
 
     addInstancedTests({&GltfImporterTest::meshSkinAttributes},
@@ -1723,6 +1857,8 @@ GltfImporterTest::GltfImporterTest() {
         Containers::arraySize(QuietData));
 
     addTests({&GltfImporterTest::meshMorphTargetAttributes,
+              &GltfImporterTest::meshSparseMorphTargets,
+              &GltfImporterTest::meshSparseMorphTargetsCompact,
 
               &GltfImporterTest::meshMultiplePrimitives});
 
@@ -1746,6 +1882,9 @@ GltfImporterTest::GltfImporterTest() {
     addInstancedTests({&GltfImporterTest::meshInvalidBufferNotFound},
         Containers::arraySize(MeshInvalidBufferNotFoundData));
 
+    addTests({&GltfImporterTest::meshConverter,
+              &GltfImporterTest::meshConverterNotFound});
+
     addTests({&GltfImporterTest::materialPbrMetallicRoughness,
               &GltfImporterTest::materialPbrSpecularGlossiness,
               &GltfImporterTest::materialCommon,
@@ -1780,6 +1919,8 @@ GltfImporterTest::GltfImporterTest() {
     addInstancedTests({&GltfImporterTest::textureExtensions},
                       Containers::arraySize(TextureExtensionsData));
 
+    addTests({&GltfImporterTest::textureExtensionsPreferred});
+
     addInstancedTests({&GltfImporterTest::textureInvalid},
                       Containers::arraySize(TextureInvalidData));
 
@@ -1804,6 +1945,14 @@ GltfImporterTest::GltfImporterTest() {
 
     addTests({&GltfImporterTest::imagePropagateImporterFlags});
 
+    addInstancedTests({&GltfImporterTest::imageImporterCache},
+        Containers::arraySize(ImageImporterCacheData));
+
+    addTests({&GltfImporterTest::imageImporterPool});
+
+    addTests({&GltfImporterTest::imageOpenOnOpen,
+              &GltfImporterTest::imageOpenOnOpenInvalid});
+
     addTests({&GltfImporterTest::experimentalKhrTextureKtx2D,
               &GltfImporterTest::experimentalKhrTextureKtx2DArray,
               &GltfImporterTest::experimentalKhrTextureKtxPhongFallback});
@@ -1838,7 +1987,10 @@ GltfImporterTest::GltfImporterTest() {
     addInstancedTests({&GltfImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
-    addTests({&GltfImporterTest::openTwice,
+    addTests({&GltfImporterTest::openPartialGlb,
+              &GltfImporterTest::openCacheJsonTokens,
+              &GltfImporterTest::openCacheTexturesAndMaterials,
+              &GltfImporterTest::openTwice,
               &GltfImporterTest::importTwice});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
@@ -1864,6 +2016,11 @@ GltfImporterTest::GltfImporterTest() {
     #ifdef STBIMAGEIMPORTER_PLUGIN_FILENAME
     CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(STBIMAGEIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
     #endif
+
+    _manager.registerExternalManager(_converterManager);
+    #ifdef MESHOPTIMIZERSCENECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(MESHOPTIMIZERSCENECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
 }
 
 void GltfImporterTest::open() {
@@ -2058,6 +2215,32 @@ void GltfImporterTest::openExternalDataNoPathNoCallback() {
     CORRADE_COMPARE(out.str(), "Trade::GltfImporter::mesh(): external buffers can be imported only when opening files from the filesystem or if a file callback is present\n");
 }
 
+void GltfImporterTest::openExternalDataMapped() {
+    #if !defined(CORRADE_TARGET_UNIX) && (!defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_SKIP("Memory mapping not available on this platform.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("mapExternalBuffers", true);
+    /* Reference the mapped memory directly to verify it stays valid */
+    importer->configuration().setValue("zeroCopyMeshes", true);
+    importer->configuration().setValue("textureCoordinateYFlipInMaterial", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh.gltf")));
+
+    Containers::Optional<Trade::MeshData> mesh = importer->mesh("Indexed mesh");
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedByte>(),
+        Containers::arrayView<UnsignedByte>({0, 1, 2}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {1.5f, -1.0f, -0.5f},
+            {-0.5f, 2.5f, 0.75f},
+            {-2.0f, 1.0f, 0.3f}
+        }), TestSuite::Compare::Container);
+    #endif
+}
+
 void GltfImporterTest::openExternalDataTooLong() {
     auto&& data = SingleFileData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -2326,6 +2509,76 @@ void GltfImporterTest::animationMissingTargetNode() {
     CORRADE_COMPARE(animation->trackTarget(1), 0);
 }
 
+void GltfImporterTest::animationTargetSubset() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "animation.gltf")));
+
+    /* Only the rotation and scaling tracks */
+    {
+        importer->configuration().setValue("animationTargetPaths", "scale rotation");
+
+        Containers::Optional<Trade::AnimationData> animation = importer->animation("TRS animation");
+        CORRADE_VERIFY(animation);
+        /* The time track is shared by all but the rotation track, so only the
+           translation values are omitted */
+        CORRADE_COMPARE(animation->data().size(),
+            2*(sizeof(Float) + sizeof(Quaternion)) +
+            4*(sizeof(Float) + sizeof(Vector3)));
+        CORRADE_COMPARE(animation->trackCount(), 2);
+        CORRADE_COMPARE(animation->trackTargetName(0), AnimationTrackTarget::Rotation3D);
+        CORRADE_COMPARE(animation->trackTarget(0), 0);
+        CORRADE_COMPARE(animation->trackTargetName(1), AnimationTrackTarget::Scaling3D);
+        CORRADE_COMPARE(animation->trackTarget(1), 2);
+        CORRADE_COMPARE(animation->track<Quaternion>(0).at(1.875f), Quaternion::rotation(90.0_degf, Vector3::xAxis()));
+        CORRADE_COMPARE(animation->track<Vector3>(1).at(1.5f), Vector3::zScale(5.2f));
+
+    /* Only tracks of given nodes */
+    } {
+        importer->configuration().setValue("animationTargetPaths", "");
+        importer->configuration().setValue("animationTargetNodes", "2 1");
+
+        Containers::Optional<Trade::AnimationData> animation = importer->animation("TRS animation");
+        CORRADE_VERIFY(animation);
+        CORRADE_COMPARE(animation->data().size(),
+            4*(sizeof(Float) + 2*sizeof(Vector3)));
+        CORRADE_COMPARE(animation->trackCount(), 2);
+        CORRADE_COMPARE(animation->trackTargetName(0), AnimationTrackTarget::Translation3D);
+        CORRADE_COMPARE(animation->trackTarget(0), 1);
+        CORRADE_COMPARE(animation->trackTargetName(1), AnimationTrackTarget::Scaling3D);
+        CORRADE_COMPARE(animation->trackTarget(1), 2);
+        CORRADE_COMPARE(animation->track<Vector3>(0).at(1.5f), Vector3::yAxis(2.5f));
+        CORRADE_COMPARE(animation->track<Vector3>(1).at(1.5f), Vector3::zScale(5.2f));
+
+    /* Both, nothing matches */
+    } {
+        importer->configuration().setValue("animationTargetPaths", "rotation");
+
+        Containers::Optional<Trade::AnimationData> animation = importer->animation("TRS animation");
+        CORRADE_VERIFY(animation);
+        CORRADE_VERIFY(animation->data().isEmpty());
+        CORRADE_COMPARE(animation->trackCount(), 0);
+    }
+}
+
+void GltfImporterTest::animationTargetSubsetInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "animation.gltf")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    importer->configuration().setValue("animationTargetNodes", "1 2a");
+    CORRADE_VERIFY(!importer->animation("TRS animation"));
+    importer->configuration().setValue("animationTargetNodes", "-1");
+    CORRADE_VERIFY(!importer->animation("TRS animation"));
+    importer->configuration().setValue("animationTargetNodes", "");
+    importer->configuration().setValue("animationTargetPaths", "rotation weights");
+    CORRADE_VERIFY(!importer->animation("TRS animation"));
+    CORRADE_COMPARE(out.str(),
+        "Trade::GltfImporter::animation(): invalid animationTargetNodes entry 2a\n"
+        "Trade::GltfImporter::animation(): invalid animationTargetNodes entry -1\n"
+        "Trade::GltfImporter::animation(): invalid animationTargetPaths entry weights\n");
+}
+
 constexpr Float AnimationSplineTime1Keys[]{ 0.5f, 3.5f, 4.0f, 5.0f };
 
 constexpr CubicHermite3D AnimationSplineTime1TranslationData[]{
@@ -2772,6 +3025,53 @@ void GltfImporterTest::animationMerge() {
     CORRADE_VERIFY(!animation->importerState());
 }
 
+void GltfImporterTest::animationZeroCopy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("zeroCopyAnimations", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "animation.gltf")));
+
+    /* The quaternions are normalized and use the shortest path already, so
+       nothing needs to be copied */
+    Containers::Optional<Trade::AnimationData> animation = importer->animation("TRS animation");
+    CORRADE_VERIFY(animation);
+    CORRADE_COMPARE(animation->dataFlags(), DataFlags{});
+    CORRADE_COMPARE(animation->trackCount(), 3);
+    CORRADE_COMPARE(animation->track<Quaternion>(0).at(1.875f), Quaternion::rotation(90.0_degf, Vector3::xAxis()));
+    CORRADE_COMPARE(animation->track<Vector3>(1).at(1.5f), Vector3::yAxis(2.5f));
+    CORRADE_COMPARE(animation->track<Vector3>(2).at(1.5f), Vector3::zScale(5.2f));
+
+    /* The tracks reference the data view */
+    const auto begin = reinterpret_cast<const char*>(animation->data().data());
+    const auto end = begin + animation->data().size();
+    for(UnsignedInt i = 0; i != animation->trackCount(); ++i) {
+        CORRADE_ITERATION(i);
+        const auto keys = reinterpret_cast<const char*>(animation->track(i).keys().data());
+        CORRADE_VERIFY(keys >= begin && keys < end);
+    }
+}
+
+void GltfImporterTest::animationZeroCopyPatched() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("zeroCopyAnimations", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "animation.gltf")));
+
+    /* Spline tracks need to be postprocessed, so the data get copied */
+    Containers::Optional<Trade::AnimationData> animation = importer->animation("TRS animation, splines");
+    CORRADE_VERIFY(animation);
+    CORRADE_COMPARE(animation->dataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE(animation->data().size(),
+        4*(sizeof(Float) + 3*sizeof(Quaternion) + 2*3*sizeof(Vector3)));
+    CORRADE_COMPARE(animation->trackCount(), 3);
+
+    /* Selecting just the translation still needs a copy */
+    importer->configuration().setValue("animationTargetPaths", "translation");
+    animation = importer->animation("TRS animation, splines");
+    CORRADE_VERIFY(animation);
+    CORRADE_COMPARE(animation->dataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE(animation->trackCount(), 1);
+    CORRADE_COMPARE(animation->trackType(0), AnimationTrackType::CubicHermite3D);
+}
+
 void GltfImporterTest::camera() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "camera.gltf")));
@@ -3091,6 +3391,20 @@ void GltfImporterTest::scene() {
     }
 }
 
+void GltfImporterTest::sceneNameMapsOnOpen() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("buildNameMapsOnOpen", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "scene.gltf")));
+
+    /* The maps are built upfront, the lookups should behave the same as in
+       scene() */
+    CORRADE_COMPARE(importer->sceneForName("Scene"), 1);
+    CORRADE_COMPARE(importer->sceneForName("Nonexistent"), -1);
+    CORRADE_COMPARE(importer->objectForName("Light"), 4);
+    CORRADE_COMPARE(importer->objectForName("Nonexistent"), -1);
+    CORRADE_COMPARE(importer->meshForName("Nonexistent"), -1);
+}
+
 void GltfImporterTest::sceneInvalidWholeFile() {
     auto&& data = SceneInvalidWholeFileData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -3115,6 +3429,54 @@ void GltfImporterTest::sceneInvalidWholeFile() {
             TestSuite::Compare::String);
 }
 
+void GltfImporterTest::sceneHierarchyThreads() {
+    auto&& data = SceneHierarchyThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* A binary tree spanning several chunks of nodes processed by the
+       threads, optionally with a two-node cycle at the very end that isn't
+       referenced from the scene */
+    constexpr UnsignedInt NodeCount = 3*4096 + 5;
+    std::string json = R"({"asset": {"version": "2.0"}, "scenes": [{"nodes": [0]}], "nodes": [)";
+    for(UnsignedInt i = 0; i != NodeCount; ++i) {
+        if(i) json += ", ";
+        if(data.cycle && i == NodeCount - 2)
+            json += Utility::formatString(R"({{"children": [{}]}})", i + 1);
+        else if(data.cycle && i == NodeCount - 1)
+            json += Utility::formatString(R"({{"children": [{}]}})", i - 1);
+        else if(2*i + 2 < NodeCount - (data.cycle ? 2 : 0))
+            json += Utility::formatString(R"({{"children": [{}, {}]}})", 2*i + 1, 2*i + 2);
+        else if(2*i + 1 < NodeCount - (data.cycle ? 2 : 0))
+            json += Utility::formatString(R"({{"children": [{}]}})", 2*i + 1);
+        else
+            json += "{}";
+    }
+    json += "]}";
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("openThreads", data.threads);
+
+    if(data.cycle) {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->openData(Containers::arrayView(json.data(), json.size())));
+        CORRADE_COMPARE(out.str(), Utility::formatString("Trade::GltfImporter::openData(): node tree contains cycle starting at node {}\n", NodeCount - 2));
+        return;
+    }
+
+    CORRADE_VERIFY(importer->openData(Containers::arrayView(json.data(), json.size())));
+    CORRADE_COMPARE(importer->objectCount(), NodeCount);
+
+    Containers::Optional<SceneData> scene = importer->scene(0);
+    CORRADE_VERIFY(scene);
+    Containers::Array<Containers::Pair<UnsignedInt, Int>> parents = scene->parentsAsArray();
+    CORRADE_COMPARE(parents.size(), NodeCount);
+    for(const Containers::Pair<UnsignedInt, Int>& parent: parents) {
+        CORRADE_ITERATION(parent.first());
+        CORRADE_COMPARE(parent.second(), parent.first() ? Int((parent.first() - 1)/2) : -1);
+    }
+}
+
 void GltfImporterTest::sceneInvalid() {
     auto&& data = SceneInvalidData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -3855,6 +4217,95 @@ void GltfImporterTest::sceneCustomFieldsInvalidConfiguration() {
     CORRADE_COMPARE(out.str(), "Trade::GltfImporter::openData(): invalid type Vector2ui specified for custom scene field offset\n");
 }
 
+void GltfImporterTest::sceneMeshGpuInstancing() {
+    auto&& data = QuietData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->setFlags(data.flags);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "scene-mesh-gpu-instancing.gltf")));
+
+    const SceneField sceneFieldInstanceTranslation = importer->sceneFieldForName("instanceTranslation");
+    const SceneField sceneFieldInstanceRotation = importer->sceneFieldForName("instanceRotation");
+    const SceneField sceneFieldInstanceScaling = importer->sceneFieldForName("instanceScaling");
+    CORRADE_COMPARE(sceneFieldInstanceTranslation, sceneFieldCustom(0));
+    CORRADE_COMPARE(sceneFieldInstanceRotation, sceneFieldCustom(1));
+    CORRADE_COMPARE(sceneFieldInstanceScaling, sceneFieldCustom(2));
+    CORRADE_COMPARE(importer->sceneFieldName(sceneFieldCustom(1)), "instanceRotation");
+
+    Containers::Optional<SceneData> scene;
+    std::ostringstream out;
+    {
+        Warning redirectWarning{&out};
+        scene = importer->scene(0);
+    }
+    CORRADE_VERIFY(scene);
+    if(data.quiet)
+        CORRADE_COMPARE(out.str(), "");
+    else
+        CORRADE_COMPARE(out.str(), "Trade::GltfImporter::scene(): ignoring EXT_mesh_gpu_instancing attribute _ID of node 2\n");
+
+    /* All three fields share the mapping, attributes not present in a node
+       are filled with identity */
+    CORRADE_VERIFY(scene->hasField(sceneFieldInstanceTranslation));
+    CORRADE_COMPARE(scene->fieldType(sceneFieldInstanceTranslation), SceneFieldType::Vector3);
+    CORRADE_COMPARE(scene->fieldType(sceneFieldInstanceRotation), SceneFieldType::Quaternion);
+    CORRADE_COMPARE(scene->fieldType(sceneFieldInstanceScaling), SceneFieldType::Vector3);
+    CORRADE_COMPARE(scene->fieldFlags(sceneFieldInstanceTranslation), SceneFieldFlag::MultiEntry);
+    CORRADE_COMPARE_AS(scene->mapping<UnsignedInt>(sceneFieldInstanceTranslation), Containers::arrayView<UnsignedInt>({
+        0, 0, 1, 1, 1
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(scene->field<Vector3>(sceneFieldInstanceTranslation), Containers::arrayView<Vector3>({
+        {1.0f, 2.0f, 3.0f},
+        {4.0f, 5.0f, 6.0f},
+        {}, {}, {}
+    }), TestSuite::Compare::Container);
+    /* Dequantized from normalized shorts */
+    CORRADE_COMPARE_AS(scene->field<Quaternion>(sceneFieldInstanceRotation), Containers::arrayView<Quaternion>({
+        {},
+        Quaternion::rotation(180.0_degf, Vector3::xAxis()),
+        {}, {}, {}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(scene->field<Vector3>(sceneFieldInstanceScaling), Containers::arrayView<Vector3>({
+        Vector3{1.0f},
+        Vector3{1.0f},
+        Vector3{2.0f},
+        Vector3{3.0f},
+        {1.0f, 0.5f, 0.25f}
+    }), TestSuite::Compare::Container);
+}
+
+void GltfImporterTest::sceneBenchmark() {
+    /* A full binary tree of nodes with TRS properties and nested extras
+       with names too long for the small string optimization, to measure
+       how many nodes per second can be assembled into a SceneData. The file
+       is opened just once, so the JSON tokenization isn't counted. */
+    constexpr UnsignedInt NodeCount = (1 << 17) - 1;
+    std::string json = R"({"asset": {"version": "2.0"}, "scenes": [{"nodes": [0]}], "nodes": [)";
+    for(UnsignedInt i = 0; i != NodeCount; ++i) {
+        if(i) json += ", ";
+        json += R"({"translation": [)" + std::to_string(i) + R"(, 0, 0], "rotation": [0, 0, 0, 1], "extras": {"someCategoryName": {"someLongPropertyName": )" + std::to_string(i) + "}}";
+        if(2*i + 2 < NodeCount)
+            json += R"(, "children": [)" + std::to_string(2*i + 1) + ", " + std::to_string(2*i + 2) + "]";
+        json += "}";
+    }
+    json += "]}";
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openData(Containers::arrayView(json.data(), json.size())));
+
+    const SceneField sceneFieldCategory = importer->sceneFieldForName("someCategoryName.someLongPropertyName");
+    CORRADE_VERIFY(sceneFieldCategory != SceneField{});
+
+    std::size_t fieldSize = 0;
+    CORRADE_BENCHMARK(1) {
+        Containers::Optional<SceneData> scene = importer->scene(0);
+        fieldSize += scene->fieldSize(sceneFieldCategory);
+    }
+
+    CORRADE_COMPARE(fieldSize, NodeCount);
+}
+
 void GltfImporterTest::skin() {
     auto&& data = MultiFileData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -3897,6 +4348,45 @@ void GltfImporterTest::skin() {
     }
 }
 
+void GltfImporterTest::skinZeroCopy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("zeroCopySkins", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "skin.gltf")));
+
+    Containers::Optional<Trade::SkinData3D> implicit = importer->skin3D("implicit inverse bind matrices");
+    CORRADE_VERIFY(implicit);
+    CORRADE_COMPARE_AS(implicit->joints(),
+        Containers::arrayView<UnsignedInt>({1, 2}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(implicit->inverseBindMatrices(),
+        Containers::arrayView({Matrix4{}, Matrix4{}}),
+        TestSuite::Compare::Container);
+    /* The identity matrices are put right after the joint IDs */
+    CORRADE_COMPARE(static_cast<const void*>(implicit->inverseBindMatrices().data()), static_cast<const void*>(implicit->joints().end()));
+
+    Containers::Optional<Trade::SkinData3D> explicit_ = importer->skin3D("explicit inverse bind matrices");
+    CORRADE_VERIFY(explicit_);
+    CORRADE_COMPARE_AS(explicit_->joints(),
+        Containers::arrayView<UnsignedInt>({0, 2, 1}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(explicit_->inverseBindMatrices(),
+        Containers::arrayView({
+            Matrix4::rotationX(35.0_degf),
+            Matrix4::translation({2.0f, 3.0f, 4.0f}),
+            Matrix4::scaling({2.0f, 3.0f, 4.0f})
+        }), TestSuite::Compare::Container);
+    /* The matrices are tightly packed in the buffer so they're referenced
+       directly */
+    CORRADE_VERIFY(static_cast<const void*>(explicit_->inverseBindMatrices().data()) != static_cast<const void*>(explicit_->joints().end()));
+
+    /* Importing again gives back the same views */
+    Containers::Optional<Trade::SkinData3D> again = importer->skin3D("explicit inverse bind matrices");
+    CORRADE_VERIFY(again);
+    CORRADE_COMPARE(again->joints().data(), explicit_->joints().data());
+    CORRADE_COMPARE(again->inverseBindMatrices().data(), explicit_->inverseBindMatrices().data());
+    CORRADE_COMPARE(again->importerState(), explicit_->importerState());
+}
+
 void GltfImporterTest::skinInvalid() {
     auto&& data = SkinInvalidData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -4147,63 +4637,399 @@ void GltfImporterTest::meshNoIndicesNoVerticesNoBufferUri() {
     }
 }
 
-void GltfImporterTest::meshColors() {
-    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
-    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-colors.gltf")));
+void GltfImporterTest::meshZeroCopy() {
+    auto&& data = MeshZeroCopyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
 
-    CORRADE_COMPARE(importer->meshCount(), 1);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("zeroCopyMeshes", true);
+    importer->configuration().setValue("textureCoordinateYFlipInMaterial", data.textureCoordinateYFlipInMaterial);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh"_s + data.suffix)));
 
-    Containers::Optional<Trade::MeshData> mesh = importer->mesh(0);
+    Containers::Optional<Trade::MeshData> mesh = importer->mesh("Indexed mesh");
     CORRADE_VERIFY(mesh);
-    CORRADE_VERIFY(!mesh->isIndexed());
+    CORRADE_COMPARE(mesh->indexDataFlags(), data.expectedDataFlags);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), data.expectedDataFlags);
 
-    CORRADE_COMPARE(mesh->attributeCount(), 3);
-    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3);
+    /* The data should be the same regardless of whether they're copied or
+       not */
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedByte);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedByte>(),
+        Containers::arrayView<UnsignedByte>({0, 1, 2}),
+        TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(mesh->attributeCount(), 5);
     CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
         Containers::arrayView<Vector3>({
             {1.5f, -1.0f, -0.5f},
             {-0.5f, 2.5f, 0.75f},
             {-2.0f, 1.0f, 0.3f}
         }), TestSuite::Compare::Container);
-    CORRADE_COMPARE(mesh->attributeCount(MeshAttribute::Color), 2);
-    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Color, 0), VertexFormat::Vector3);
-    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Color),
-        Containers::arrayView<Vector3>({
-            {0.1f, 0.2f, 0.3f},
-            {0.4f, 0.5f, 0.6f},
-            {0.7f, 0.8f, 0.9f}
-        }), TestSuite::Compare::Container);
-    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Color, 1), VertexFormat::Vector4);
-    CORRADE_COMPARE_AS(mesh->attribute<Vector4>(MeshAttribute::Color, 1),
-        Containers::arrayView<Vector4>({
-            {0.1f, 0.2f, 0.3f, 0.4f},
-            {0.5f, 0.6f, 0.7f, 0.8f},
-            {0.9f, 1.0f, 1.1f, 1.2f}
+    CORRADE_COMPARE_AS(mesh->attribute<UnsignedShort>(MeshAttribute::ObjectId),
+        Containers::arrayView<UnsignedShort>({
+            215, 71, 133
         }), TestSuite::Compare::Container);
+
+    /* Texture coordinates are Y-flipped only if the flip isn't done in the
+       material */
+    if(data.textureCoordinateYFlipInMaterial)
+        CORRADE_COMPARE_AS(mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+            Containers::arrayView<Vector2>({
+                {0.3f, 0.0f},
+                {0.0f, 0.5f},
+                {0.3f, 0.3f}
+            }), TestSuite::Compare::Container);
+    else
+        CORRADE_COMPARE_AS(mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+            Containers::arrayView<Vector2>({
+                {0.3f, 1.0f},
+                {0.0f, 0.5f},
+                {0.3f, 0.7f}
+            }), TestSuite::Compare::Container);
 }
 
-void GltfImporterTest::meshSkinAttributes() {
-    auto&& data = MeshSkinAttributeData[testCaseInstanceId()];
+void GltfImporterTest::meshParseOnOpen() {
+    auto&& data = MultiFileData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
 
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("parseMeshesOnOpen", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh"_s + data.suffix)));
 
-    #ifdef MAGNUM_BUILD_DEPRECATED
-    if(data.compatibilitySkinningAttributes)
-        importer->configuration().setValue("compatibilitySkinningAttributes", *data.compatibilitySkinningAttributes);
+    /* Importing the same mesh twice should give the same result both times,
+       with everything parsed just once */
+    for(std::size_t i = 0; i != 2; ++i) {
+        CORRADE_ITERATION(i);
+
+        Containers::Optional<Trade::MeshData> mesh = importer->mesh("Indexed mesh");
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+        CORRADE_COMPARE_AS(mesh->indices<UnsignedByte>(),
+            Containers::arrayView<UnsignedByte>({0, 1, 2}),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE(mesh->attributeCount(), 5);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {1.5f, -1.0f, -0.5f},
+                {-0.5f, 2.5f, 0.75f},
+                {-2.0f, 1.0f, 0.3f}
+            }), TestSuite::Compare::Container);
+    }
+}
+
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+void GltfImporterTest::meshParseOnOpenMultithreaded() {
+    auto&& data = MeshParseOnOpenMultithreadedData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef CORRADE_BUILD_MULTITHREADED
+    CORRADE_SKIP("CORRADE_BUILD_MULTITHREADED is not enabled.");
     #endif
 
-    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-skin-attributes.gltf")));
+    /* Serial reference, imported lazily */
+    Containers::Pointer<AbstractImporter> reference = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(reference->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, data.filename)));
+    CORRADE_VERIFY(reference->meshCount() >= data.meshCount);
+    Containers::Array<Containers::Optional<MeshData>> expected{data.meshCount};
+    for(UnsignedInt i = 0; i != data.meshCount; ++i) {
+        expected[i] = reference->mesh(i);
+        CORRADE_VERIFY(expected[i]);
+    }
 
-    /* The backwards compatibility mapping should be available even before the
-       mesh is imported, and for robustness always regardless of whether
-       compatibilitySkinningAttributes is set. Otherwise it could happen that
-       it won't get added during file opening, but then
-       compatibilitySkinningAttributes gets flipped back on and mesh import
-       asserts because there's no entry for JOINTS / WEIGHTS in the map. */
-    const MeshAttribute jointsAttribute = importer->meshAttributeForName("JOINTS");
-    const MeshAttribute weightsAttribute = importer->meshAttributeForName("WEIGHTS");
-    #ifdef MAGNUM_BUILD_DEPRECATED
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("parseMeshesOnOpen", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, data.filename)));
+
+    /* Each thread imports a disjoint set of meshes, all from the same importer
+       instance, and by ID as meshForName() isn't safe to call concurrently */
+    constexpr UnsignedInt ThreadCount = 4;
+    Containers::Array<Containers::Optional<MeshData>> actual{data.meshCount};
+    {
+        auto fn = [&](const UnsignedInt thread) {
+            for(UnsignedInt i = thread; i < data.meshCount; i += ThreadCount)
+                actual[i] = importer->mesh(i);
+        };
+
+        std::thread threads[ThreadCount];
+        for(UnsignedInt i = 0; i != ThreadCount; ++i)
+            threads[i] = std::thread{fn, i};
+        for(std::thread& thread: threads)
+            thread.join();
+    }
+
+    for(UnsignedInt i = 0; i != data.meshCount; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(actual[i]);
+        CORRADE_COMPARE(actual[i]->primitive(), expected[i]->primitive());
+        CORRADE_COMPARE(actual[i]->isIndexed(), expected[i]->isIndexed());
+        if(expected[i]->isIndexed()) {
+            CORRADE_COMPARE(actual[i]->indexType(), expected[i]->indexType());
+            CORRADE_COMPARE_AS(actual[i]->indexData(), expected[i]->indexData(),
+                TestSuite::Compare::Container);
+        }
+        CORRADE_COMPARE(actual[i]->vertexCount(), expected[i]->vertexCount());
+        CORRADE_COMPARE(actual[i]->attributeCount(), expected[i]->attributeCount());
+        for(UnsignedInt j = 0; j != expected[i]->attributeCount(); ++j) {
+            CORRADE_ITERATION(j);
+            CORRADE_COMPARE(actual[i]->attributeName(j), expected[i]->attributeName(j));
+            CORRADE_COMPARE(actual[i]->attributeFormat(j), expected[i]->attributeFormat(j));
+            CORRADE_COMPARE(actual[i]->attributeOffset(j), expected[i]->attributeOffset(j));
+            CORRADE_COMPARE(actual[i]->attributeStride(j), expected[i]->attributeStride(j));
+        }
+        CORRADE_COMPARE_AS(actual[i]->vertexData(), expected[i]->vertexData(),
+            TestSuite::Compare::Container);
+    }
+}
+#endif
+
+void GltfImporterTest::meshParseOnOpenInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("parseMeshesOnOpen", true);
+
+    /* Opening shouldn't print anything even though there are many invalid
+       accessors */
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-invalid.gltf")));
+        CORRADE_COMPARE(out.str(), "");
+    }
+
+    /* The errors get reported only on import, consistently with the lazy
+       behavior */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh("accessor type size larger than buffer stride"));
+    CORRADE_VERIFY(!importer->mesh("sparse accessor"));
+    CORRADE_COMPARE(out.str(),
+        "Trade::GltfImporter::mesh(): 16-byte type defined by accessor 6 can't fit into buffer view 0 stride of 12\n"
+        "Trade::GltfImporter::mesh(): accessor 10 is using sparse storage, which is unsupported\n");
+}
+
+void GltfImporterTest::meshMeshopt() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-meshopt.gltf")));
+
+    /* Both meshes share the same compressed vertex buffer view, differing
+       only in how the indices are encoded. The fallback buffer has no URI,
+       if it'd be accessed the import would fail. */
+    for(const char* name: {"triangles", "indices"}) {
+        CORRADE_ITERATION(name);
+
+        Containers::Optional<Trade::MeshData> mesh = importer->mesh(name);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+
+        CORRADE_VERIFY(mesh->isIndexed());
+        CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedShort);
+        CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+            Containers::arrayView<UnsignedShort>({0, 1, 2}),
+            TestSuite::Compare::Container);
+
+        CORRADE_COMPARE(mesh->attributeCount(), 1);
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3ub);
+        CORRADE_COMPARE(mesh->attributeStride(MeshAttribute::Position), 4);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3ub>(MeshAttribute::Position),
+            Containers::arrayView<Vector3ub>({
+                {1, 2, 3}, {4, 5, 6}, {7, 8, 9}
+            }), TestSuite::Compare::Container);
+    }
+}
+
+void GltfImporterTest::meshMeshoptInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-meshopt.gltf")));
+
+    /* The decoder itself is tested in GltfImporterDecodeTest, this verifies
+       just validation of the extension properties and that decoder errors
+       are propagated */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh("invalid mode"));
+    CORRADE_VERIFY(!importer->mesh("count too large"));
+    CORRADE_VERIFY(!importer->mesh("invalid filter stride"));
+    CORRADE_VERIFY(!importer->mesh("corrupted data"));
+    CORRADE_COMPARE(out.str(),
+        "Trade::GltfImporter::mesh(): buffer view 3 has unrecognized EXT_meshopt_compression mode LINES\n"
+        "Trade::GltfImporter::mesh(): buffer view 4 has 6 bytes but EXT_meshopt_compression needs 8 bytes for 4 elements of stride 2\n"
+        "Trade::GltfImporter::mesh(): buffer view 5 has unsupported EXT_meshopt_compression byteStride 4 for QUATERNION filter\n"
+        "Trade::GltfImporter::mesh(): unsupported meshopt index data header 0xe1\n");
+}
+
+void GltfImporterTest::meshDraco() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-draco.gltf")));
+
+    /* The uncompressed fallback contains the same data as the compressed
+       buffer, so the result is the same whether it's decoded or not */
+    const char* const names[]{
+        "fallback",
+        #ifdef MAGNUM_GLTFIMPORTER_WITH_DRACO
+        /* The compressed data get used even if there's a fallback, which is
+           the only way to import a primitive without a fallback */
+        "no fallback"
+        #endif
+    };
+    for(const char* name: names) {
+        CORRADE_ITERATION(name);
+
+        Containers::Optional<Trade::MeshData> mesh = importer->mesh(name);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+        CORRADE_VERIFY(mesh->isIndexed());
+        CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedShort);
+        CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+            Containers::arrayView<UnsignedShort>({0, 1, 2, 2, 1, 3}),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE(mesh->attributeCount(), 2);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {0.0f, 0.0f, 0.0f},
+                {1.0f, 0.0f, 0.0f},
+                {0.0f, 1.0f, 0.0f},
+                {1.0f, 1.0f, 0.0f}
+            }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+            Containers::arrayView<Vector3>({
+                Vector3::zAxis(),
+                Vector3::zAxis(),
+                Vector3::zAxis(),
+                Vector3::zAxis()
+            }), TestSuite::Compare::Container);
+    }
+
+    #ifndef MAGNUM_GLTFIMPORTER_WITH_DRACO
+    /* Without Draco and without a fallback it fails with a clear message */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh("no fallback"));
+    CORRADE_COMPARE(out.str(), "Trade::GltfImporter::mesh(): the plugin was built without KHR_draco_mesh_compression support and attribute POSITION has no uncompressed fallback\n");
+    #endif
+}
+
+void GltfImporterTest::meshDracoInvalid() {
+    #ifndef MAGNUM_GLTFIMPORTER_WITH_DRACO
+    CORRADE_SKIP("GltfImporter was built without Draco support.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-draco.gltf")));
+
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->mesh("corrupted data"));
+        /* The rest of the message comes from Draco itself */
+        CORRADE_COMPARE_AS(out.str(),
+            "Trade::GltfImporter::mesh(): KHR_draco_mesh_compression decoding failed: ",
+            TestSuite::Compare::StringHasPrefix);
+    } {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->mesh("unknown unique ID"));
+        CORRADE_COMPARE(out.str(), "Trade::GltfImporter::mesh(): KHR_draco_mesh_compression attribute POSITION references unique ID 7 not present in the compressed data\n");
+    }
+    #endif
+}
+
+void GltfImporterTest::meshDracoMixed() {
+    #ifndef MAGNUM_GLTFIMPORTER_WITH_DRACO
+    CORRADE_SKIP("GltfImporter was built without Draco support.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-draco-mixed.gltf")));
+
+    /* Only the position is compressed, the normal and the morph target are
+       in regular accessors and get copied next to the decoded data */
+    Containers::Optional<Trade::MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({0, 1, 2, 2, 1, 3}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(mesh->attributeCount(), 3);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, 0.0f},
+            {1.0f, 0.0f, 0.0f},
+            {0.0f, 1.0f, 0.0f},
+            {1.0f, 1.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            Vector3::zAxis(),
+            Vector3::zAxis(),
+            Vector3::zAxis(),
+            Vector3::zAxis()
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position, 0, 0),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, 0.0f},
+            {1.0f, 0.0f, 0.0f},
+            {0.0f, 1.0f, 0.0f},
+            {1.0f, 1.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+    #endif
+}
+
+void GltfImporterTest::meshColors() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-colors.gltf")));
+
+    CORRADE_COMPARE(importer->meshCount(), 1);
+
+    Containers::Optional<Trade::MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(!mesh->isIndexed());
+
+    CORRADE_COMPARE(mesh->attributeCount(), 3);
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {1.5f, -1.0f, -0.5f},
+            {-0.5f, 2.5f, 0.75f},
+            {-2.0f, 1.0f, 0.3f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(mesh->attributeCount(MeshAttribute::Color), 2);
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Color, 0), VertexFormat::Vector3);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Color),
+        Containers::arrayView<Vector3>({
+            {0.1f, 0.2f, 0.3f},
+            {0.4f, 0.5f, 0.6f},
+            {0.7f, 0.8f, 0.9f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Color, 1), VertexFormat::Vector4);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector4>(MeshAttribute::Color, 1),
+        Containers::arrayView<Vector4>({
+            {0.1f, 0.2f, 0.3f, 0.4f},
+            {0.5f, 0.6f, 0.7f, 0.8f},
+            {0.9f, 1.0f, 1.1f, 1.2f}
+        }), TestSuite::Compare::Container);
+}
+
+void GltfImporterTest::meshSkinAttributes() {
+    auto&& data = MeshSkinAttributeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+
+    #ifdef MAGNUM_BUILD_DEPRECATED
+    if(data.compatibilitySkinningAttributes)
+        importer->configuration().setValue("compatibilitySkinningAttributes", *data.compatibilitySkinningAttributes);
+    #endif
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-skin-attributes.gltf")));
+
+    /* The backwards compatibility mapping should be available even before the
+       mesh is imported, and for robustness always regardless of whether
+       compatibilitySkinningAttributes is set. Otherwise it could happen that
+       it won't get added during file opening, but then
+       compatibilitySkinningAttributes gets flipped back on and mesh import
+       asserts because there's no entry for JOINTS / WEIGHTS in the map. */
+    const MeshAttribute jointsAttribute = importer->meshAttributeForName("JOINTS");
+    const MeshAttribute weightsAttribute = importer->meshAttributeForName("WEIGHTS");
+    #ifdef MAGNUM_BUILD_DEPRECATED
     const UnsignedInt customAttributeOffset = 2;
     CORRADE_COMPARE(jointsAttribute, meshAttributeCustom(0));
     CORRADE_COMPARE(weightsAttribute, meshAttributeCustom(1));
@@ -4621,6 +5447,94 @@ void GltfImporterTest::meshMorphTargetAttributes() {
 
 }
 
+void GltfImporterTest::meshSparseMorphTargets() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-sparse-morph-targets.gltf")));
+    CORRADE_COMPARE(importer->meshCount(), 1);
+    CORRADE_COMPARE(importer->meshLevelCount(0), 1);
+
+    Containers::Optional<Trade::MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexCount(), 4);
+    CORRADE_COMPARE(mesh->attributeCount(), 3);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position), Containers::arrayView<Vector3>({
+        {0.0f, 0.0f, 0.0f},
+        {1.0f, 0.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f},
+        {1.0f, 1.0f, 0.0f}
+    }), TestSuite::Compare::Container);
+
+    /* No base buffer view, so the values not listed are zero */
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position, 0, 0), VertexFormat::Vector3);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position, 0, 0), Containers::arrayView<Vector3>({
+        {0.0f, 0.0f, 0.0f},
+        {0.5f, 0.0f, 0.0f},
+        {0.0f, 0.0f, 0.0f},
+        {0.0f, 0.0f, 0.25f}
+    }), TestSuite::Compare::Container);
+
+    /* With a base buffer view the listed values replace the base */
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position, 0, 1), VertexFormat::Vector3);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position, 0, 1), Containers::arrayView<Vector3>({
+        {0.1f, 0.0f, 0.0f},
+        {0.2f, 0.0f, 0.0f},
+        {0.0f, 0.0f, 1.0f},
+        {0.4f, 0.0f, 0.0f}
+    }), TestSuite::Compare::Container);
+}
+
+void GltfImporterTest::meshSparseMorphTargetsCompact() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("compactSparseMorphTargets", true);
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-sparse-morph-targets.gltf")));
+    CORRADE_COMPARE(importer->meshCount(), 1);
+
+    /* Only the first morph target has no base buffer view */
+    CORRADE_COMPARE(importer->meshLevelCount(0), 2);
+
+    const MeshAttribute sparseIndex = importer->meshAttributeForName("SPARSE_INDEX");
+    CORRADE_VERIFY(isMeshAttributeCustom(sparseIndex));
+    CORRADE_COMPARE(importer->meshAttributeName(sparseIndex), "SPARSE_INDEX");
+
+    /* The base level has the first morph target omitted */
+    {
+        Containers::Optional<Trade::MeshData> mesh = importer->mesh(0);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->vertexCount(), 4);
+        CORRADE_COMPARE(mesh->attributeCount(), 2);
+        CORRADE_COMPARE(mesh->attributeCount(-1), 1);
+        CORRADE_COMPARE(mesh->attributeCount(0), 0);
+        CORRADE_COMPARE(mesh->attributeCount(1), 1);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position, 0, 1), Containers::arrayView<Vector3>({
+            {0.1f, 0.0f, 0.0f},
+            {0.2f, 0.0f, 0.0f},
+            {0.0f, 0.0f, 1.0f},
+            {0.4f, 0.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+    }
+
+    /* The additional level contains just the sparse values and indices */
+    {
+        Containers::Optional<Trade::MeshData> mesh = importer->mesh(0, 1);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Points);
+        CORRADE_VERIFY(!mesh->isIndexed());
+        CORRADE_COMPARE(mesh->vertexCount(), 2);
+        CORRADE_COMPARE(mesh->attributeCount(), 2);
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position, 0, 0), VertexFormat::Vector3);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position, 0, 0), Containers::arrayView<Vector3>({
+            {0.5f, 0.0f, 0.0f},
+            {0.0f, 0.0f, 0.25f}
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE(mesh->attributeFormat(sparseIndex), VertexFormat::UnsignedInt);
+        CORRADE_COMPARE_AS(mesh->attribute<UnsignedInt>(sparseIndex), Containers::arrayView<UnsignedInt>({
+            1, 3
+        }), TestSuite::Compare::Container);
+    }
+}
+
 void GltfImporterTest::meshMultiplePrimitives() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-multiple-primitives.gltf")));
@@ -5172,6 +6086,57 @@ void GltfImporterTest::meshInvalidBufferNotFound() {
         TestSuite::Compare::StringHasSuffix);
 }
 
+void GltfImporterTest::meshConverter() {
+    if(_converterManager.loadState("MeshOptimizerSceneConverter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("MeshOptimizerSceneConverter plugin not found, cannot test");
+
+    /* The mesh isn't interleaved, which the vertex fetch optimization needs.
+       Options for the converter are set globally through the manager. */
+    _converterManager.metadata("MeshOptimizerSceneConverter")->configuration().setValue("optimizeVertexFetch", false);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("meshConverter", "MeshOptimizerSceneConverter");
+    /* The verbose flag is propagated to the converter, which then prints
+       processing stats */
+    importer->addFlags(ImporterFlag::Verbose);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh.gltf")));
+
+    std::ostringstream out;
+    Containers::Optional<Trade::MeshData> mesh;
+    {
+        Debug redirectOutput{&out};
+        mesh = importer->mesh(0);
+    }
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->indexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE_AS(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convertInPlace(): processing stats:\n",
+        TestSuite::Compare::StringHasPrefix);
+
+    /* A single triangle, nothing to optimize there, but the vertex and index
+       counts should stay the same */
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(mesh->indexCount(), 3);
+    CORRADE_COMPARE(mesh->vertexCount(), 3);
+    CORRADE_COMPARE(mesh->attributeCount(), 5);
+}
+
+void GltfImporterTest::meshConverterNotFound() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("meshConverter", "NonexistentSceneConverter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh.gltf")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(0));
+    /* The plugin manager prints its own message before, which contains a
+       platform-specific path, so check just the suffix */
+    CORRADE_COMPARE_AS(out.str(),
+        "Trade::GltfImporter::mesh(): can't load NonexistentSceneConverter for mesh conversion\n",
+        TestSuite::Compare::StringHasSuffix);
+}
+
 void GltfImporterTest::materialPbrMetallicRoughness() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
 
@@ -6444,6 +7409,44 @@ void GltfImporterTest::textureExtensions() {
     if(data.xfail) CORRADE_COMPARE(texture->image(), data.xfailId);
 }
 
+void GltfImporterTest::textureExtensionsPreferred() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    /* Unrecognized extensions in the list are ignored */
+    importer->configuration().setValue("preferredTextureExtensions", "MAGNUM_fake_extension  KHR_texture_basisu GOOGLE_texture_basis");
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "texture-extensions.gltf")));
+
+    /* GOOGLE_texture_basis is picked even though MSFT_texture_dds is first in
+       the file */
+    {
+        Containers::Optional<Trade::TextureData> texture = importer->texture("MSFT_texture_dds and GOOGLE_texture_basis");
+        CORRADE_VERIFY(texture);
+        CORRADE_COMPARE(texture->image(), 1);
+
+    /* KHR_texture_basisu is preferred over GOOGLE_texture_basis */
+    } {
+        Containers::Optional<Trade::TextureData> texture = importer->texture("GOOGLE_texture_basis and KHR_texture_basisu");
+        CORRADE_VERIFY(texture);
+        CORRADE_COMPARE(texture->image(), 2);
+
+    /* None of the listed extensions is present, file order applies */
+    } {
+        Containers::Optional<Trade::TextureData> texture = importer->texture("MSFT_texture_dds");
+        CORRADE_VERIFY(texture);
+        CORRADE_COMPARE(texture->image(), 3);
+
+    /* The unrecognized extension is listed but isn't picked */
+    } {
+        Containers::Optional<Trade::TextureData> texture = importer->texture("unknown extension");
+        CORRADE_VERIFY(texture);
+        CORRADE_COMPARE(texture->image(), 0);
+    } {
+        Containers::Optional<Trade::TextureData> texture = importer->texture("GOOGLE_texture_basis and unknown");
+        CORRADE_VERIFY(texture);
+        CORRADE_COMPARE(texture->image(), 1);
+    }
+}
+
 void GltfImporterTest::textureInvalid() {
     auto&& data = TextureInvalidData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -6704,6 +7707,134 @@ void GltfImporterTest::imagePropagateImporterFlags() {
         "Trade::AnyImageImporter::openFile(): using PngImporter (provided by StbImageImporter)\n");
 }
 
+void GltfImporterTest::imageImporterCache() {
+    auto&& data = ImageImporterCacheData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    if(data.cacheSize)
+        importer->configuration().setValue("imageImporterCacheSize", data.cacheSize);
+    /* The verbose output is used to count how many times an image file got
+       opened */
+    importer->setFlags(ImporterFlag::Verbose);
+
+    std::ostringstream out;
+    Debug redirectOutput{&out};
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "image.gltf")));
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+
+    /* Interleaved import of the two images */
+    for(UnsignedInt i: {0, 1, 0, 1}) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(importer->image2D(i));
+    }
+
+    std::string expected;
+    for(std::size_t i = 0; i != data.expectedOpenCount; ++i)
+        expected += "Trade::AnyImageImporter::openFile(): using PngImporter (provided by StbImageImporter)\n";
+    CORRADE_COMPARE(out.str(), expected);
+}
+
+void GltfImporterTest::imageImporterPool() {
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> a = _manager.instantiate("GltfImporter");
+    Containers::Pointer<AbstractImporter> b = _manager.instantiate("GltfImporter");
+    a->configuration().setValue("imageImporterPoolSize", 1);
+    b->configuration().setValue("imageImporterPoolSize", 1);
+    /* The verbose output is used to count how many times an image file got
+       opened */
+    a->setFlags(ImporterFlag::Verbose);
+    b->setFlags(ImporterFlag::Verbose);
+
+    /* Both images reference the same file. With the default cache size of 1
+       the importer gets put to the pool when switching to the other image and
+       taken back right after, so the file is opened just once. */
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(a->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "image.gltf")));
+        for(UnsignedInt i: {0, 1, 0, 1}) {
+            CORRADE_ITERATION(i);
+            CORRADE_VERIFY(a->image2D(i));
+        }
+        a->close();
+        CORRADE_COMPARE(out.str(),
+            "Trade::AnyImageImporter::openFile(): using PngImporter (provided by StbImageImporter)\n");
+    }
+
+    /* The other instance then takes the importer put to the pool on close()
+       and doesn't open the file again */
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(b->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "image.gltf")));
+        Containers::Optional<Trade::ImageData2D> image = b->image2D(1);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), Vector2i(5, 3));
+        CORRADE_COMPARE(out.str(), "");
+    }
+}
+
+void GltfImporterTest::imageOpenOnOpen() {
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("openImagesOnOpen", true);
+    /* The verbose output is used to see when the image files get opened */
+    importer->setFlags(ImporterFlag::Verbose);
+
+    /* Both images get opened right away, even though the cache size is 1 */
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "image.gltf")));
+        CORRADE_COMPARE(out.str(),
+            "Trade::AnyImageImporter::openFile(): using PngImporter (provided by StbImageImporter)\n"
+            "Trade::AnyImageImporter::openFile(): using PngImporter (provided by StbImageImporter)\n");
+    }
+
+    /* Then they aren't opened again */
+    std::ostringstream out;
+    Debug redirectOutput{&out};
+    for(UnsignedInt i: {0, 1, 0, 1}) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(i);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), Vector2i(5, 3));
+    }
+    CORRADE_COMPARE(out.str(), "");
+}
+
+void GltfImporterTest::imageOpenOnOpenInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("openImagesOnOpen", true);
+
+    /* Opening succeeds, but prints errors for all images */
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "image-invalid-notfound.gltf")));
+        /* There's an error from Path::read() before */
+        CORRADE_COMPARE_AS(out.str(),
+            "\nTrade::GltfImporter::openData(): error opening /nonexistent.bin\n",
+            TestSuite::Compare::StringHasSuffix);
+    }
+
+    /* The failure is cached, so import fails without printing anything
+       again */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D("uri not found"));
+    CORRADE_VERIFY(!importer->image2D("buffer not found"));
+    CORRADE_COMPARE(out.str(), "");
+}
+
 void GltfImporterTest::experimentalKhrTextureKtx2D() {
     if(_manager.loadState("KtxImporter") == PluginManager::LoadState::NotFound)
         CORRADE_SKIP("KtxImporter plugin not found, cannot test");
@@ -7356,6 +8487,148 @@ void GltfImporterTest::openMemory() {
     CORRADE_COMPARE(cam->far(), 100.0f);
 }
 
+void GltfImporterTest::openPartialGlb() {
+    /* Two meshes, each referencing one float in the BIN chunk */
+    std::string json = R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":8}],"bufferViews":[{"buffer":0,"byteLength":4},{"buffer":0,"byteOffset":4,"byteLength":4}],"accessors":[{"bufferView":0,"componentType":5126,"count":1,"type":"SCALAR"},{"bufferView":1,"componentType":5126,"count":1,"type":"SCALAR"}],"meshes":[{"name":"first","primitives":[{"attributes":{"_A":0}}]},{"name":"second","primitives":[{"attributes":{"_A":1}}]}]})";
+    json.resize((json.size() + 3)/4*4, ' ');
+    const Float bin[]{1.5f, 2.5f};
+
+    std::string file;
+    const auto appendUnsignedInt = [&file](UnsignedInt value) {
+        file.append(reinterpret_cast<const char*>(&value), 4);
+    };
+    file.append("glTF");
+    appendUnsignedInt(2);
+    appendUnsignedInt(12 + 8 + json.size() + 8 + sizeof(bin));
+    appendUnsignedInt(json.size());
+    file.append("JSON");
+    file.append(json);
+    appendUnsignedInt(sizeof(bin));
+    file.append("BIN\0", 4);
+    file.append(reinterpret_cast<const char*>(bin), sizeof(bin));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("allowPartialGlb", true);
+
+    /* The complete file works as usual */
+    {
+        CORRADE_VERIFY(importer->openData(Containers::arrayView(file.data(), file.size())));
+        Containers::Optional<MeshData> first = importer->mesh("first");
+        Containers::Optional<MeshData> second = importer->mesh("second");
+        CORRADE_VERIFY(first);
+        CORRADE_VERIFY(second);
+        CORRADE_COMPARE(first->attribute<Float>(0)[0], 1.5f);
+        CORRADE_COMPARE(second->attribute<Float>(0)[0], 2.5f);
+
+    /* Part of the BIN chunk missing, only the first mesh can be imported */
+    } {
+        CORRADE_VERIFY(importer->openData(Containers::arrayView(file.data(), file.size() - 2)));
+        CORRADE_COMPARE(importer->meshCount(), 2);
+        CORRADE_COMPARE(importer->meshName(1), "second");
+
+        Containers::Optional<MeshData> first = importer->mesh("first");
+        CORRADE_VERIFY(first);
+        CORRADE_COMPARE(first->attribute<Float>(0)[0], 1.5f);
+
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->mesh("second"));
+        CORRADE_COMPARE(out.str(), "Trade::GltfImporter::mesh(): buffer view 1 needs 8 bytes but buffer 0 has only 6\n");
+
+    /* BIN chunk header incomplete, no mesh can be imported */
+    } {
+        CORRADE_VERIFY(importer->openData(Containers::arrayView(file.data(), 12 + 8 + json.size() + 3)));
+        CORRADE_COMPARE(importer->meshCount(), 2);
+
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->mesh("first"));
+        CORRADE_COMPARE(out.str(), "Trade::GltfImporter::mesh(): buffer view 0 needs 4 bytes but buffer 0 has only 0\n");
+
+    /* The JSON chunk has to be complete */
+    } {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->openData(Containers::arrayView(file.data(), 12 + 8 + json.size() - 1)));
+        CORRADE_COMPARE(out.str(), Utility::formatString("Trade::GltfImporter::openData(): binary glTF size mismatch, expected {} bytes for a JSON chunk but got only {}\n", json.size(), json.size() - 1));
+    }
+}
+
+void GltfImporterTest::openCacheJsonTokens() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("cacheJsonTokens", true);
+
+    /* The camera type gets parsed only when the camera is imported */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "camera.gltf")));
+    const Utility::JsonToken* type = &static_cast<const Utility::Json*>(importer->importerState())->root()["cameras"_s][0]["type"_s];
+    CORRADE_VERIFY(!type->isParsed());
+    CORRADE_VERIFY(importer->camera(0));
+    CORRADE_VERIFY(type->isParsed());
+
+    /* Opening the same file again reuses the tokens, including their parsed
+       state */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "camera.gltf")));
+    const Utility::JsonToken* typeCached = &static_cast<const Utility::Json*>(importer->importerState())->root()["cameras"_s][0]["type"_s];
+    CORRADE_COMPARE(typeCached, type);
+    CORRADE_VERIFY(typeCached->isParsed());
+    CORRADE_VERIFY(importer->camera(0));
+
+    /* Opening a different file in between discards the cache */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "empty.gltf")));
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "camera.gltf")));
+    CORRADE_VERIFY(!static_cast<const Utility::Json*>(importer->importerState())->root()["cameras"_s][0]["type"_s].isParsed());
+
+    /* Without the option nothing is kept */
+    importer->configuration().setValue("cacheJsonTokens", false);
+    CORRADE_VERIFY(importer->camera(0));
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "camera.gltf")));
+    CORRADE_VERIFY(!static_cast<const Utility::Json*>(importer->importerState())->root()["cameras"_s][0]["type"_s].isParsed());
+}
+
+void GltfImporterTest::openCacheTexturesAndMaterials() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("cacheTexturesAndMaterials", true);
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "material-phong-fallback.gltf")));
+
+    Containers::Optional<MaterialData> material = importer->material("metallic/roughness");
+    CORRADE_VERIFY(material);
+    CORRADE_COMPARE(material->types(), MaterialType::PbrMetallicRoughness|MaterialType::Phong);
+
+    /* Options affecting the import are ignored for an already cached
+       material, the returned copy is the same as the first time */
+    importer->configuration().setValue("phongMaterialFallback", false);
+    Containers::Optional<MaterialData> materialCached = importer->material("metallic/roughness");
+    CORRADE_VERIFY(materialCached);
+    CORRADE_COMPARE(materialCached->types(), MaterialType::PbrMetallicRoughness|MaterialType::Phong);
+    CORRADE_COMPARE(materialCached->importerState(), material->importerState());
+    CORRADE_COMPARE_AS(*materialCached, *material, DebugTools::CompareMaterial);
+
+    /* But they're taken into account for materials not imported yet */
+    Containers::Optional<MaterialData> materialAnother = importer->material("specular/glossiness");
+    CORRADE_VERIFY(materialAnother);
+    CORRADE_COMPARE(materialAnother->types(), MaterialType::PbrSpecularGlossiness);
+
+    Containers::Optional<TextureData> texture = importer->texture(0);
+    CORRADE_VERIFY(texture);
+    Containers::Optional<TextureData> textureCached = importer->texture(0);
+    CORRADE_VERIFY(textureCached);
+    CORRADE_COMPARE(textureCached->type(), texture->type());
+    CORRADE_COMPARE(textureCached->minificationFilter(), texture->minificationFilter());
+    CORRADE_COMPARE(textureCached->magnificationFilter(), texture->magnificationFilter());
+    CORRADE_COMPARE(textureCached->mipmapFilter(), texture->mipmapFilter());
+    CORRADE_COMPARE(textureCached->wrapping(), texture->wrapping());
+    CORRADE_COMPARE(textureCached->image(), texture->image());
+    CORRADE_COMPARE(textureCached->importerState(), texture->importerState());
+
+    /* The cache is discarded on close, without the option nothing is kept */
+    importer->configuration().setValue("cacheTexturesAndMaterials", false);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "material-phong-fallback.gltf")));
+    Containers::Optional<MaterialData> materialUncached = importer->material("metallic/roughness");
+    CORRADE_VERIFY(materialUncached);
+    CORRADE_COMPARE(materialUncached->types(), MaterialType::PbrMetallicRoughness);
+}
+
 void GltfImporterTest::openTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
 
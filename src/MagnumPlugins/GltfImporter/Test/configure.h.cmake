@@ -28,5 +28,7 @@
 #cmakedefine BASISIMPORTER_PLUGIN_FILENAME "${BASISIMPORTER_PLUGIN_FILENAME}"
 #cmakedefine DDSIMPORTER_PLUGIN_FILENAME "${DDSIMPORTER_PLUGIN_FILENAME}"
 #cmakedefine KTXIMPORTER_PLUGIN_FILENAME "${KTXIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine MESHOPTIMIZERSCENECONVERTER_PLUGIN_FILENAME "${MESHOPTIMIZERSCENECONVERTER_PLUGIN_FILENAME}"
 #cmakedefine STBIMAGEIMPORTER_PLUGIN_FILENAME "${STBIMAGEIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine TINYGLTFIMPORTER_PLUGIN_FILENAME "${TINYGLTFIMPORTER_PLUGIN_FILENAME}"
 #define GLTFIMPORTER_TEST_DIR "${GLTFIMPORTER_TEST_DIR}"
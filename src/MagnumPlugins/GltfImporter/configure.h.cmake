@@ -25,3 +25,5 @@
 */
 
 #cmakedefine MAGNUM_GLTFIMPORTER_BUILD_STATIC
+#cmakedefine MAGNUM_GLTFIMPORTER_WITH_DRACO
+#cmakedefine MAGNUM_GLTFIMPORTER_WITH_TRACY_ZONES
@@ -25,11 +25,15 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cmath>
+#include <cstring>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/String.h>
+#include <Corrade/Utility/Assert.h>
 #include <Corrade/Utility/Macros.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
 
 namespace Magnum { namespace Trade { namespace {
 
@@ -39,34 +43,43 @@ namespace Magnum { namespace Trade { namespace {
 /* Decode percent-encoded characters in URIs:
    https://datatracker.ietf.org/doc/html/rfc3986#section-2.1 */
 Containers::Optional<Containers::String> decodeUri(const char* const errorPrefix, Containers::StringView uri) {
+    /* Most URIs have no escapes at all, copy them directly in that case */
+    const char* escape = uri.find('%').data();
+    if(!escape) return Containers::String{uri};
+
     const std::size_t size = uri.size();
     Containers::String out{NoInit, size};
     std::size_t iOut = 0;
-    for(std::size_t i = 0; i != size; ++i) {
-        char c = uri[i];
-        /** @todo profile and speed up with find('%') */
-        if(c == '%') {
-            if(i + 2 >= size) {
-                Error{} << errorPrefix << "invalid URI escape sequence" << uri.slice(i, size);
-                return {};
-            }
+    std::size_t i = 0;
+    for(;;) {
+        /* Copy everything until the next escape sequence in a single go, or
+           until the end if there's no more */
+        const std::size_t next = escape ? escape - uri.data() : size;
+        std::memcpy(out.data() + iOut, uri.data() + i, next - i);
+        iOut += next - i;
+        i = next;
+        if(!escape) break;
 
-            c = 0;
-            for(const char j: {uri[i + 1], uri[i + 2]}) {
-                c <<= 4;
-                if(j >= '0' && j <= '9') c |= j - '0';
-                else if(j >= 'A' && j <= 'F') c |= 10 + j - 'A';
-                else if(j >= 'a' && j <= 'f') c |= 10 + j - 'a';
-                else {
-                    Error{} << errorPrefix << "invalid URI escape sequence" << uri.slice(i, i + 3);
-                    return {};
-                }
-            }
+        if(i + 2 >= size) {
+            Error{} << errorPrefix << "invalid URI escape sequence" << uri.slice(i, size);
+            return {};
+        }
 
-            i += 2;
+        char c = 0;
+        for(const char j: {uri[i + 1], uri[i + 2]}) {
+            c <<= 4;
+            if(j >= '0' && j <= '9') c |= j - '0';
+            else if(j >= 'A' && j <= 'F') c |= 10 + j - 'A';
+            else if(j >= 'a' && j <= 'f') c |= 10 + j - 'a';
+            else {
+                Error{} << errorPrefix << "invalid URI escape sequence" << uri.slice(i, i + 3);
+                return {};
+            }
         }
 
         out[iOut++] = c;
+        i += 3;
+        escape = uri.exceptPrefix(i).find('%').data();
     }
 
     out[iOut] = '\0';
@@ -149,8 +162,31 @@ Containers::Optional<Containers::Array<char>> decodeBase64(const char* const err
     Containers::Array<char> data{NoInit, sizeFullBlocks*3/4 + pad1 + pad2};
     UnsignedByte* out = reinterpret_cast<UnsignedByte*>(data.data());
 
+    /* Decode in batches of four blocks with a single validity check for the
+       whole batch, which makes the loop significantly less branchy. The
+       output is written even if invalid, which is fine as it gets discarded
+       in that case. If a batch is invalid or there's less than four blocks
+       left, continue with the per-block loop below, which finds the
+       offending block. */
+    std::size_t i = 0;
     std::size_t iOut = 0;
-    for(std::size_t i = 0; i != sizeFullBlocks; i += 4, iOut += 3) {
+    for(; i + 16 <= sizeFullBlocks; i += 16, iOut += 12) {
+        UnsignedInt invalid = 0;
+        for(std::size_t j = 0; j != 4; ++j) {
+            const UnsignedInt n =
+                UnsignedInt(Base64Values[in[i + j*4 + 0]]) << 18 |
+                UnsignedInt(Base64Values[in[i + j*4 + 1]]) << 12 |
+                UnsignedInt(Base64Values[in[i + j*4 + 2]]) <<  6 |
+                UnsignedInt(Base64Values[in[i + j*4 + 3]]) <<  0;
+            invalid |= n;
+            out[iOut + j*3 + 0] =  n >> 16;
+            out[iOut + j*3 + 1] = (n >>  8) & 0xff;
+            out[iOut + j*3 + 2] = (n >>  0) & 0xff;
+        }
+        if CORRADE_UNLIKELY(invalid & 0xff000000u) break;
+    }
+
+    for(; i != sizeFullBlocks; i += 4, iOut += 3) {
         const UnsignedInt n =
             UnsignedInt(Base64Values[in[i + 0]]) << 18 |
             UnsignedInt(Base64Values[in[i + 1]]) << 12 |
@@ -194,6 +230,389 @@ Containers::Optional<Containers::Array<char>> decodeBase64(const char* const err
     return Containers::optional(Utility::move(data));
 }
 
+/* Decoders for the EXT_meshopt_compression bitstream, as specified in
+   https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/EXT_meshopt_compression/README.md#appendix-a-bitstream
+   and closely following the reference implementation in meshoptimizer. Each
+   buffer view is decoded just once, so the code is kept simple and scalar
+   instead of pulling in the whole library just for this. */
+
+inline UnsignedByte meshoptUnzigzag8(const UnsignedByte v) {
+    return -(v & 1) ^ (v >> 1);
+}
+
+/* Returns a pointer after the consumed data or nullptr if there's not enough
+   data. The size is expected to be a multiple of 16. */
+const UnsignedByte* decodeMeshoptBytes(const UnsignedByte* data, const UnsignedByte* const end, UnsignedByte* const out, const std::size_t size) {
+    /* Each group of 16 bytes has a two-bit mode in the header */
+    const std::size_t headerSize = (size/16 + 3)/4;
+    if(std::size_t(end - data) < headerSize) return nullptr;
+    const UnsignedByte* const header = data;
+    data += headerSize;
+
+    for(std::size_t i = 0; i < size; i += 16) {
+        /* The largest group is 8 bytes of 4-bit values + 16 bytes of
+           sentinel-escaped values, the stream tail guarantees there's always
+           at least that many bytes for a valid input */
+        if(std::size_t(end - data) < 24) return nullptr;
+
+        const std::size_t group = i/16;
+        const UnsignedInt mode = (header[group/4] >> ((group % 4)*2)) & 3;
+        UnsignedByte* const groupOut = out + i;
+
+        /* All zeros */
+        if(mode == 0) {
+            for(std::size_t j = 0; j != 16; ++j) groupOut[j] = 0;
+
+        /* Raw bytes */
+        } else if(mode == 3) {
+            for(std::size_t j = 0; j != 16; ++j) groupOut[j] = data[j];
+            data += 16;
+
+        /* 2- or 4-bit values, highest bits first, with the all-ones value
+           meaning the actual byte is stored after the packed values */
+        } else {
+            const UnsignedInt bits = 1 << mode;
+            const UnsignedInt valuesPerByte = 8/bits;
+            const UnsignedInt sentinel = (1 << bits) - 1;
+            const UnsignedByte* extra = data + bits*2;
+            for(std::size_t j = 0; j != 16; ++j) {
+                const UnsignedInt value = (data[j/valuesPerByte] >> (8 - bits - (j % valuesPerByte)*bits)) & sentinel;
+                groupOut[j] = value == sentinel ? *extra++ : value;
+            }
+            data = extra;
+        }
+    }
+
+    return data;
+}
+
+/* Decodes the ATTRIBUTES mode. The output is expected to have
+   count*stride bytes, with stride being at most 256. */
+bool decodeMeshoptAttributes(const char* const errorPrefix, const Containers::ArrayView<const char> in, const Containers::ArrayView<char> out, const std::size_t count, const std::size_t stride) {
+    CORRADE_INTERNAL_ASSERT(stride && stride <= 256 && out.size() == count*stride);
+
+    /* The first vertex is stored in a tail padded to at least 32 bytes */
+    const std::size_t tailSize = Math::max(stride, std::size_t{32});
+    if(in.size() < 1 + tailSize) {
+        Error{} << errorPrefix << "meshopt attribute data too short, expected at least" << 1 + tailSize << "bytes but got" << in.size();
+        return false;
+    }
+
+    const UnsignedByte* data = reinterpret_cast<const UnsignedByte*>(in.data());
+    const UnsignedByte* const end = data + in.size();
+    if(data[0] != 0xa0) {
+        Error{} << errorPrefix << "unsupported meshopt attribute data header" << reinterpret_cast<void*>(std::size_t(data[0]));
+        return false;
+    }
+    ++data;
+
+    UnsignedByte last[256];
+    for(std::size_t k = 0; k != stride; ++k)
+        last[k] = end[k - stride];
+
+    /* Vertices are processed in blocks, each byte of a block encoded as a
+       separate delta stream from the same byte in the previous vertex */
+    const std::size_t blockSize = Math::min((8192/stride) & ~std::size_t{15}, std::size_t{256});
+    UnsignedByte deltas[256];
+    UnsignedByte* const output = reinterpret_cast<UnsignedByte*>(out.data());
+    for(std::size_t offset = 0; offset < count; offset += blockSize) {
+        const std::size_t blockCount = Math::min(blockSize, count - offset);
+        const std::size_t blockCountAligned = (blockCount + 15) & ~std::size_t{15};
+        UnsignedByte* const block = output + offset*stride;
+        for(std::size_t k = 0; k != stride; ++k) {
+            if(!(data = decodeMeshoptBytes(data, end, deltas, blockCountAligned))) {
+                Error{} << errorPrefix << "truncated meshopt attribute data";
+                return false;
+            }
+
+            UnsignedByte value = last[k];
+            for(std::size_t i = 0; i != blockCount; ++i) {
+                value += meshoptUnzigzag8(deltas[i]);
+                block[i*stride + k] = value;
+            }
+            last[k] = value;
+        }
+    }
+
+    if(std::size_t(end - data) < tailSize) {
+        Error{} << errorPrefix << "truncated meshopt attribute data";
+        return false;
+    }
+    if(std::size_t(end - data) != tailSize) {
+        Error{} << errorPrefix << "meshopt attribute data have" << end - data - tailSize << "unused bytes";
+        return false;
+    }
+
+    return true;
+}
+
+inline UnsignedInt decodeMeshoptVByte(const UnsignedByte*& data) {
+    const UnsignedByte lead = *data++;
+    if(lead < 128) return lead;
+
+    /* Up to four more bytes, seven bits each, lowest group first */
+    UnsignedInt result = lead & 127;
+    for(UnsignedInt shift = 7; shift != 35; shift += 7) {
+        const UnsignedByte group = *data++;
+        result |= UnsignedInt(group & 127) << shift;
+        if(group < 128) break;
+    }
+
+    return result;
+}
+
+inline UnsignedInt decodeMeshoptIndex(const UnsignedByte*& data, const UnsignedInt last) {
+    const UnsignedInt v = decodeMeshoptVByte(data);
+    return last + ((v >> 1) ^ -Int(v & 1));
+}
+
+template<class T> void writeMeshoptTriangle(const Containers::ArrayView<char> out, const std::size_t i, const UnsignedInt a, const UnsignedInt b, const UnsignedInt c) {
+    T* const triangle = reinterpret_cast<T*>(out.data()) + i;
+    triangle[0] = a;
+    triangle[1] = b;
+    triangle[2] = c;
+}
+
+/* Decodes the TRIANGLES mode. The output is expected to have count*indexSize
+   bytes, with count being a multiple of 3 and indexSize either 2 or 4. */
+bool decodeMeshoptTriangles(const char* const errorPrefix, const Containers::ArrayView<const char> in, const Containers::ArrayView<char> out, const std::size_t count, const std::size_t indexSize) {
+    CORRADE_INTERNAL_ASSERT(count % 3 == 0 && (indexSize == 2 || indexSize == 4) && out.size() == count*indexSize);
+
+    /* A header byte, a code byte per triangle and a 16-byte lookup table at
+       the end, which also guarantees that reading data for a single triangle
+       never goes over the end */
+    if(in.size() < 1 + count/3 + 16) {
+        Error{} << errorPrefix << "meshopt triangle data too short, expected at least" << 1 + count/3 + 16 << "bytes but got" << in.size();
+        return false;
+    }
+
+    const UnsignedByte* const begin = reinterpret_cast<const UnsignedByte*>(in.data());
+    if((begin[0] & 0xf0) != 0xe0 || (begin[0] & 0x0f) > 1) {
+        Error{} << errorPrefix << "unsupported meshopt triangle data header" << reinterpret_cast<void*>(std::size_t(begin[0]));
+        return false;
+    }
+
+    /* Version 1 reserves two of the vertex codes for last ± 1 */
+    const UnsignedInt fecMax = (begin[0] & 0x0f) >= 1 ? 13 : 15;
+
+    UnsignedInt edgeFifo[16][2];
+    UnsignedInt vertexFifo[16];
+    for(std::size_t i = 0; i != 16; ++i) {
+        edgeFifo[i][0] = edgeFifo[i][1] = ~UnsignedInt{};
+        vertexFifo[i] = ~UnsignedInt{};
+    }
+    std::size_t edgeFifoOffset = 0;
+    std::size_t vertexFifoOffset = 0;
+    const auto pushEdge = [&](const UnsignedInt a, const UnsignedInt b) {
+        edgeFifo[edgeFifoOffset][0] = a;
+        edgeFifo[edgeFifoOffset][1] = b;
+        edgeFifoOffset = (edgeFifoOffset + 1) & 15;
+    };
+    const auto pushVertex = [&](const UnsignedInt v, const bool condition) {
+        vertexFifo[vertexFifoOffset] = v;
+        vertexFifoOffset = (vertexFifoOffset + condition) & 15;
+    };
+
+    UnsignedInt next = 0;
+    UnsignedInt last = 0;
+    const UnsignedByte* code = begin + 1;
+    const UnsignedByte* data = code + count/3;
+    const UnsignedByte* const dataSafeEnd = begin + in.size() - 16;
+    const UnsignedByte* const codeauxTable = dataSafeEnd;
+
+    for(std::size_t i = 0; i < count; i += 3) {
+        /* A triangle reads at most 16 bytes of data, which is what the tail
+           table gives us if we're not past its start */
+        if(data > dataSafeEnd) {
+            Error{} << errorPrefix << "truncated meshopt triangle data";
+            return false;
+        }
+
+        const UnsignedByte codetri = *code++;
+        UnsignedInt a, b, c;
+
+        /* Reusing an edge from the FIFO */
+        if(codetri < 0xf0) {
+            const UnsignedInt fe = codetri >> 4;
+            a = edgeFifo[(edgeFifoOffset - 1 - fe) & 15][0];
+            b = edgeFifo[(edgeFifoOffset - 1 - fe) & 15][1];
+
+            const UnsignedInt fec = codetri & 15;
+            if(fec < fecMax) {
+                const UnsignedInt cf = vertexFifo[(vertexFifoOffset - 1 - fec) & 15];
+                c = fec == 0 ? next : cf;
+                next += fec == 0;
+                pushVertex(c, fec == 0);
+            } else {
+                c = fec != 15 ? last + (fec - (fec ^ 3)) : decodeMeshoptIndex(data, last);
+                last = c;
+                pushVertex(c, true);
+            }
+
+            pushEdge(c, b);
+            pushEdge(a, c);
+
+        /* Fresh triangle, with vertex codes from the lookup table or in the
+           data */
+        } else {
+            const bool fromTable = codetri < 0xfe;
+            const UnsignedByte codeaux = fromTable ? codeauxTable[codetri & 15] : *data++;
+            const UnsignedInt fea = codetri == 0xff ? 15 : 0;
+            const UnsignedInt feb = codeaux >> 4;
+            const UnsignedInt fec = codeaux & 15;
+
+            /* A zero codeaux outside of the table restarts the vertex
+               sequence */
+            if(!fromTable && codeaux == 0) next = 0;
+
+            a = fea == 0 ? next++ : 0;
+            b = feb == 0 ? next++ : vertexFifo[(vertexFifoOffset - feb) & 15];
+            c = fec == 0 ? next++ : vertexFifo[(vertexFifoOffset - fec) & 15];
+
+            /* Free indices are delta-encoded against the last one. The table
+               never contains 15, so this is only for the full byte path. */
+            const bool freeB = !fromTable && feb == 15;
+            const bool freeC = !fromTable && fec == 15;
+            if(fea == 15) last = a = decodeMeshoptIndex(data, last);
+            if(freeB) last = b = decodeMeshoptIndex(data, last);
+            if(freeC) last = c = decodeMeshoptIndex(data, last);
+
+            pushVertex(a, true);
+            pushVertex(b, feb == 0 || freeB);
+            pushVertex(c, fec == 0 || freeC);
+
+            pushEdge(b, a);
+            pushEdge(c, b);
+            pushEdge(a, c);
+        }
+
+        if(indexSize == 2)
+            writeMeshoptTriangle<UnsignedShort>(out, i, a, b, c);
+        else
+            writeMeshoptTriangle<UnsignedInt>(out, i, a, b, c);
+    }
+
+    if(data != dataSafeEnd) {
+        Error{} << errorPrefix << "meshopt triangle data have" << dataSafeEnd - data << "unused bytes";
+        return false;
+    }
+
+    return true;
+}
+
+/* Decodes the INDICES mode. The output is expected to have count*indexSize
+   bytes, with indexSize being either 2 or 4. */
+bool decodeMeshoptIndices(const char* const errorPrefix, const Containers::ArrayView<const char> in, const Containers::ArrayView<char> out, const std::size_t count, const std::size_t indexSize) {
+    CORRADE_INTERNAL_ASSERT((indexSize == 2 || indexSize == 4) && out.size() == count*indexSize);
+
+    /* A header byte, at least a byte per index and a 4-byte tail that makes
+       it possible to read a whole index without bounds checks */
+    if(in.size() < 1 + count + 4) {
+        Error{} << errorPrefix << "meshopt index data too short, expected at least" << 1 + count + 4 << "bytes but got" << in.size();
+        return false;
+    }
+
+    const UnsignedByte* const begin = reinterpret_cast<const UnsignedByte*>(in.data());
+    if((begin[0] & 0xf0) != 0xd0 || (begin[0] & 0x0f) > 1) {
+        Error{} << errorPrefix << "unsupported meshopt index data header" << reinterpret_cast<void*>(std::size_t(begin[0]));
+        return false;
+    }
+
+    const UnsignedByte* data = begin + 1;
+    const UnsignedByte* const dataSafeEnd = begin + in.size() - 4;
+
+    /* Two separate baselines, with the lowest bit of each value selecting
+       which one the delta is against */
+    UnsignedInt last[2]{};
+    for(std::size_t i = 0; i != count; ++i) {
+        if(data >= dataSafeEnd) {
+            Error{} << errorPrefix << "truncated meshopt index data";
+            return false;
+        }
+
+        UnsignedInt v = decodeMeshoptVByte(data);
+        const UnsignedInt current = v & 1;
+        v >>= 1;
+        const UnsignedInt index = last[current] += (v >> 1) ^ -Int(v & 1);
+
+        if(indexSize == 2)
+            reinterpret_cast<UnsignedShort*>(out.data())[i] = index;
+        else
+            reinterpret_cast<UnsignedInt*>(out.data())[i] = index;
+    }
+
+    if(data != dataSafeEnd) {
+        Error{} << errorPrefix << "meshopt index data have" << dataSafeEnd - data << "unused bytes";
+        return false;
+    }
+
+    return true;
+}
+
+/* Filters applied in-place on decoded ATTRIBUTES data. The octahedral one
+   operates on four 8- or 16-bit components, the quaternion one on four
+   16-bit components and the exponential one on 32-bit values. */
+template<class T> void meshoptFilterOctahedral(const Containers::ArrayView<char> data) {
+    constexpr Float max = Float((1 << (sizeof(T)*8 - 1)) - 1);
+    T* const values = reinterpret_cast<T*>(data.data());
+    for(std::size_t i = 0, count = data.size()/(4*sizeof(T)); i != count; ++i) {
+        T* const v = values + i*4;
+        Float x = v[0];
+        Float y = v[1];
+        const Float z = Float(v[2]) - std::abs(x) - std::abs(y);
+
+        /* Fixup for the negative z hemisphere */
+        const Float t = Math::min(z, 0.0f);
+        x -= x >= 0.0f ? -t : t;
+        y -= y >= 0.0f ? -t : t;
+
+        const Float s = max/std::sqrt(x*x + y*y + z*z);
+        v[0] = T(Int(x*s + (x >= 0.0f ? 0.5f : -0.5f)));
+        v[1] = T(Int(y*s + (y >= 0.0f ? 0.5f : -0.5f)));
+        v[2] = T(Int(z*s + (z >= 0.0f ? 0.5f : -0.5f)));
+    }
+}
+
+void meshoptFilterQuaternion(const Containers::ArrayView<char> data) {
+    /* 1/sqrt(2), the largest possible value of the three smaller components */
+    constexpr Float scale = 0.70710678f;
+    Short* const values = reinterpret_cast<Short*>(data.data());
+    for(std::size_t i = 0, count = data.size()/8; i != count; ++i) {
+        Short* const v = values + i*4;
+
+        /* The lowest two bits of the last component is the index of the
+           largest component that got dropped, the rest is the scale */
+        const Float sf = v[3] | 3;
+        const Float ss = scale/sf;
+        const Float x = v[0]*ss;
+        const Float y = v[1]*ss;
+        const Float z = v[2]*ss;
+        const Float w = std::sqrt(Math::max(0.0f, 1.0f - x*x - y*y - z*z));
+
+        const Int qc = v[3] & 3;
+        const Short xf = Short(Int(x*32767.0f + (x >= 0.0f ? 0.5f : -0.5f)));
+        const Short yf = Short(Int(y*32767.0f + (y >= 0.0f ? 0.5f : -0.5f)));
+        const Short zf = Short(Int(z*32767.0f + (z >= 0.0f ? 0.5f : -0.5f)));
+        const Short wf = Short(Int(w*32767.0f + 0.5f));
+        v[(qc + 1) & 3] = xf;
+        v[(qc + 2) & 3] = yf;
+        v[(qc + 3) & 3] = zf;
+        v[(qc + 0) & 3] = wf;
+    }
+}
+
+void meshoptFilterExponential(const Containers::ArrayView<char> data) {
+    UnsignedInt* const values = reinterpret_cast<UnsignedInt*>(data.data());
+    for(std::size_t i = 0, count = data.size()/4; i != count; ++i) {
+        /* Signed 8-bit exponent in the top bits, signed 24-bit mantissa in
+           the rest */
+        const Int e = Int(values[i]) >> 24;
+        const Int m = Int(values[i] << 8) >> 8;
+        const Float value = std::ldexp(Float(m), e);
+        std::memcpy(values + i, &value, 4);
+    }
+}
+
 }}}
 
 #endif
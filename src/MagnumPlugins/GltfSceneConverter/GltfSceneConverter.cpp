@@ -27,6 +27,8 @@
 
 #include <cctype> /* std::isupper() */
 #include <algorithm> /* std::sort() */
+#include <atomic>
+#include <thread>
 #include <unordered_map>
 #include <Corrade/Containers/ArrayTuple.h>
 #include <Corrade/Containers/ArrayViewStl.h> /** @todo drop once Configuration is STL-free */
@@ -36,10 +38,12 @@
 #include <Corrade/Containers/Iterable.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Containers/Triple.h>
 #include <Corrade/Containers/ScopeGuard.h>
 #include <Corrade/Containers/StridedBitArrayView.h>
 #include <Corrade/Containers/StringIterable.h>
+#include <Corrade/Containers/StringStlHash.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Format.h>
@@ -63,7 +67,9 @@
 #include <Magnum/Trade/SceneData.h>
 
 #include "Magnum/Implementation/formatPluginsVersion.h"
+#include "Magnum/Implementation/instrumentation.h"
 #include "MagnumPlugins/GltfImporter/Gltf.h"
+#include "MagnumPlugins/GltfSceneConverter/encode.h"
 
 /* We'd have to endian-flip everything that goes into buffers, plus the binary
    glTF headers, etc. Too much work, hard to automatically test because the
@@ -79,12 +85,15 @@ namespace {
 /* Each value here needs a corresponding entry in extensionStrings inside
    doEndData(). Values sorted by name. */
 enum class GltfExtension {
-    KhrMaterialsClearCoat = 1 << 0,
-    KhrMaterialsUnlit = 1 << 1,
-    KhrMeshQuantization = 1 << 2,
-    KhrTextureBasisu = 1 << 3,
-    KhrTextureKtx = 1 << 4,
-    KhrTextureTransform = 1 << 5,
+    ExtMeshGpuInstancing = 1 << 0,
+    ExtMeshoptCompression = 1 << 1,
+    ExtTextureWebp = 1 << 2,
+    KhrMaterialsClearCoat = 1 << 3,
+    KhrMaterialsUnlit = 1 << 4,
+    KhrMeshQuantization = 1 << 5,
+    KhrTextureBasisu = 1 << 6,
+    KhrTextureKtx = 1 << 7,
+    KhrTextureTransform = 1 << 8,
 };
 typedef Containers::EnumSet<GltfExtension> GltfExtensions;
 #ifdef CORRADE_TARGET_CLANG
@@ -96,11 +105,22 @@ CORRADE_ENUMSET_OPERATORS(GltfExtensions)
 #pragma clang diagnostic pop
 #endif
 
+/* A bundled 2D image whose encoding was deferred in order to be done in
+   parallel with other images. Contains a copy of the input image, as the
+   original isn't guaranteed to stay in scope after add() returns. */
+struct PendingImage {
+    UnsignedInt id;
+    Containers::String name;
+    Containers::Pointer<AbstractImageConverter> converter;
+    ImageData2D image;
+};
+
 struct MeshProperties {
     Containers::Optional<UnsignedInt> gltfMode;
     /* Unfortunately we can't have a StringView here because the name can be
-       composed out of a base and numeric suffix */
-    Containers::Array<Containers::Pair<Containers::String, UnsignedInt>> gltfAttributes;
+       composed out of a base and numeric suffix. The last item is a morph
+       target ID or -1 for base attributes. */
+    Containers::Array<Containers::Triple<Containers::String, UnsignedInt, Int>> gltfAttributes;
     Containers::Optional<UnsignedInt> gltfIndices;
     Containers::String gltfName;
 };
@@ -175,6 +195,12 @@ struct GltfSceneConverter::State {
        `textureIdOffsets[i] == i` for all `i`. */
     Containers::Array<UnsignedInt> textureIdOffsets{InPlaceInit, {0}};
 
+    /* Bundled 2D images that got added with imageThreads different from 1,
+       encoded all together in encodePendingImages() once an image that can't
+       be deferred is added or the conversion ends. Their glTF image IDs are
+       right after the images already present in gltfImages. */
+    Containers::Array<PendingImage> pendingImages;
+
     Utility::JsonWriter gltfBuffers;
     Utility::JsonWriter gltfBufferViews;
     Utility::JsonWriter gltfAccessors;
@@ -187,9 +213,113 @@ struct GltfSceneConverter::State {
 
     Int defaultScene = -1;
 
+    /* Contents of the binary buffer. If the streamBuffers option is enabled
+       when converting to a file, `buffer` stays empty and the data get
+       appended directly to a file at `streamedBufferFilename` instead. In
+       both cases `bufferSize` is the total buffer size so far. */
     Containers::Array<char> buffer;
+    Containers::String streamedBufferFilename;
+    std::size_t bufferSize = 0;
+    /* Size of the second buffer, which has no data and only serves as a
+       fallback referenced by buffer views compressed with
+       EXT_meshopt_compression */
+    std::size_t meshoptFallbackBufferSize = 0;
+
+    /* Pads the buffer with zeros to given alignment and appends data to it.
+       Returns offset of the data in the buffer or NullOpt if writing to the
+       streamed buffer file failed, in which case an error was already
+       printed. */
+    Containers::Optional<std::size_t> appendToBuffer(Containers::ArrayView<const char> data, std::size_t alignment = 1);
+
+    /* Unique data in the buffer for the deduplicateData option. Key is a hash
+       of the data, value is offset and size in the buffer. As the contents
+       are compared to verify a match, it's not used when streaming. */
+    std::unordered_multimap<std::size_t, Containers::Pair<std::size_t, std::size_t>> uniqueBufferData;
+    /* Buffer views of bundled images for the deduplicateData option. Key is
+       the offset in the buffer, value is the buffer view index. */
+    std::unordered_map<std::size_t, UnsignedInt> uniqueImageBufferViews;
+    /* External image files for the deduplicateData option. Key is a hash of
+       the file contents, value the filename. */
+    std::unordered_multimap<std::size_t, Containers::String> uniqueExternalImages;
+
+    /* Like appendToBuffer(), but if the same data with a compatible alignment
+       is already in the buffer, returns its offset instead of appending
+       again. Data aren't deduplicated when streaming. */
+    Containers::Optional<std::size_t> appendToBufferDeduplicated(Containers::ArrayView<const char> data, std::size_t alignment = 1);
 };
 
+Containers::Optional<std::size_t> GltfSceneConverter::State::appendToBuffer(const Containers::ArrayView<const char> data, const std::size_t alignment) {
+    const std::size_t padding = alignment*((bufferSize + alignment - 1)/alignment) - bufferSize;
+    CORRADE_INTERNAL_ASSERT(padding <= 3);
+    const char zeros[3]{};
+
+    if(streamedBufferFilename) {
+        if((padding && !Utility::Path::append(streamedBufferFilename, Containers::arrayView(zeros).prefix(padding))) ||
+           (!data.isEmpty() && !Utility::Path::append(streamedBufferFilename, data))) {
+            Error{} << "Trade::GltfSceneConverter::add(): can't write to" << streamedBufferFilename;
+            return {};
+        }
+    } else {
+        arrayAppend(buffer, Containers::arrayView(zeros).prefix(padding));
+        arrayAppend(buffer, data);
+    }
+
+    const std::size_t offset = bufferSize + padding;
+    bufferSize = offset + data.size();
+    return offset;
+}
+
+Containers::Optional<std::size_t> GltfSceneConverter::State::appendToBufferDeduplicated(const Containers::ArrayView<const char> data, const std::size_t alignment) {
+    if(streamedBufferFilename || data.isEmpty())
+        return appendToBuffer(data, alignment);
+
+    /* Compare the actual contents to not be affected by hash collisions */
+    const std::size_t hash = std::hash<Containers::StringView>{}(Containers::StringView{data.data(), data.size()});
+    const auto found = uniqueBufferData.equal_range(hash);
+    for(auto it = found.first; it != found.second; ++it) {
+        const std::size_t offset = it->second.first();
+        if(offset % alignment == 0 && it->second.second() == data.size() &&
+           Containers::StringView{buffer.sliceSize(offset, data.size())} == Containers::StringView{data.data(), data.size()})
+            return offset;
+    }
+
+    const Containers::Optional<std::size_t> offset = appendToBuffer(data, alignment);
+    CORRADE_INTERNAL_ASSERT(offset);
+    uniqueBufferData.emplace(hash, Containers::pair(*offset, data.size()));
+    return offset;
+}
+
+namespace {
+
+/* Writes the buffer, byteOffset and byteLength properties of a buffer view
+   compressed with EXT_meshopt_compression, with the uncompressed data placed
+   at a four-byte-aligned offset into the fallback buffer, enlarging
+   `fallbackSize` */
+void writeMeshoptBufferView(Utility::JsonWriter& json, std::size_t& fallbackSize, const std::size_t byteLength) {
+    const std::size_t byteOffset = 4*((fallbackSize + 3)/4);
+    fallbackSize = byteOffset + byteLength;
+    json.writeKey("buffer"_s).write(1)
+        .writeKey("byteOffset"_s).write(byteOffset)
+        .writeKey("byteLength"_s).write(byteLength);
+}
+
+/* Writes the EXT_meshopt_compression buffer view extension object
+   referencing compressed data in the main buffer */
+void writeMeshoptBufferViewExtension(Utility::JsonWriter& json, const std::size_t byteOffset, const std::size_t byteLength, const std::size_t byteStride, const std::size_t count, const Containers::StringView mode) {
+    json.writeKey("extensions"_s);
+    const Containers::ScopeGuard gltfExtensions = json.beginObjectScope();
+    json.writeKey("EXT_meshopt_compression"_s);
+    const Containers::ScopeGuard gltfMeshoptCompression = json.beginObjectScope();
+    json.writeKey("buffer"_s).write(0)
+        .writeKey("byteOffset"_s).write(byteOffset)
+        .writeKey("byteLength"_s).write(byteLength)
+        .writeKey("byteStride"_s).write(byteStride)
+        .writeKey("count"_s).write(count)
+        .writeKey("mode"_s).write(mode);
+}
+
+}
+
 using namespace Containers::Literals;
 using namespace Math::Literals;
 
@@ -224,6 +354,22 @@ bool GltfSceneConverter::doBeginFile(const Containers::StringView filename) {
         _state->binary = Utility::String::lowercase(Utility::Path::splitExtension(filename).second()) != ".gltf"_s;
     } else _state->binary = configuration().value<bool>("binary");
 
+    /* If streaming buffers, a text glTF gets them written directly into the
+       external buffer file. For a binary glTF the BIN chunk has to come
+       after the JSON, which is known only at the very end, so the data go to
+       a temporary file that's then appended to the output in doEndFile().
+       Truncate the file in case it exists already. */
+    if(configuration().value<bool>("streamBuffers")) {
+        _state->streamedBufferFilename = _state->binary ?
+            filename + ".bin.tmp"_s :
+            Utility::Path::splitExtension(filename).first() + ".bin"_s;
+        if(!Utility::Path::write(_state->streamedBufferFilename, Containers::ArrayView<const void>{})) {
+            Error{} << "Trade::GltfSceneConverter::beginFile(): can't write to" << _state->streamedBufferFilename;
+            _state = {};
+            return false;
+        }
+    }
+
     return AbstractSceneConverter::doBeginFile(filename);
 }
 
@@ -267,6 +413,11 @@ bool GltfSceneConverter::doBeginData() {
 }
 
 Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doEndData"};
+    /* Encode and write images that are still waiting for it */
+    if(!encodePendingImages("Trade::GltfSceneConverter::endData():"))
+        return {};
+
     Utility::JsonWriter json{_state->jsonOptions, _state->jsonIndentation};
     json.beginObject();
 
@@ -323,6 +474,9 @@ Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
            the loop */
         GltfExtensions usedExtensions = _state->usedExtensions|_state->requiredExtensions;
         const Containers::Pair<GltfExtension, Containers::StringView> extensionStrings[]{
+            {GltfExtension::ExtMeshGpuInstancing, "EXT_mesh_gpu_instancing"_s},
+            {GltfExtension::ExtMeshoptCompression, "EXT_meshopt_compression"_s},
+            {GltfExtension::ExtTextureWebp, "EXT_texture_webp"_s},
             {GltfExtension::KhrMaterialsClearCoat, "KHR_materials_clearcoat"_s},
             {GltfExtension::KhrMaterialsUnlit, "KHR_materials_unlit"_s},
             {GltfExtension::KhrMeshQuantization, "KHR_mesh_quantization"_s},
@@ -354,31 +508,57 @@ Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
 
     /* Wrap up the buffer if it's non-empty or if there are any (empty) buffer
        views referencing it */
-    if(!_state->buffer.isEmpty() || !_state->gltfBufferViews.isEmpty()) {
+    if(_state->bufferSize || !_state->gltfBufferViews.isEmpty()) {
         json.writeKey("buffers"_s);
         const Containers::ScopeGuard gltfBuffers = json.beginArrayScope();
-        const Containers::ScopeGuard gltfBuffer = json.beginObjectScope();
-
-        /* If not writing a binary glTF and the buffer is non-empty, save the
-           buffer to an external file and reference it. In a binary glTF the
-           buffer is just one with an implicit location. */
-        if(!_state->binary && !_state->buffer.isEmpty()) {
-            if(!_state->filename) {
-                Error{} << "Trade::GltfSceneConverter::endData(): can only write a glTF with external buffers if converting to a file";
-                return {};
+        {
+            const Containers::ScopeGuard gltfBuffer = json.beginObjectScope();
+
+            /* If not writing a binary glTF and the buffer is non-empty, save
+               the buffer to an external file and reference it. In a binary
+               glTF the buffer is just one with an implicit location. */
+            if(!_state->binary && _state->bufferSize) {
+                if(!_state->filename) {
+                    Error{} << "Trade::GltfSceneConverter::endData(): can only write a glTF with external buffers if converting to a file";
+                    return {};
+                }
+
+                /* If the buffer was streamed, it's already in the file */
+                Containers::String bufferFilename = Utility::Path::splitExtension(*_state->filename).first() + ".bin"_s;
+                if(!_state->streamedBufferFilename)
+                    Utility::Path::write(bufferFilename, _state->buffer);
+                /** @todo configurable buffer name? or a path prefix if ending
+                    with /? or an extension alone if .. what, exactly? */
+
+                /* Writing just the filename as the two files are expected to
+                   be next to each other */
+                json.writeKey("uri"_s).write(Utility::Path::split(bufferFilename).second());
             }
 
-            Containers::String bufferFilename = Utility::Path::splitExtension(*_state->filename).first() + ".bin"_s;
-            Utility::Path::write(bufferFilename, _state->buffer);
-            /** @todo configurable buffer name? or a path prefix if ending with /?
-                or an extension alone if .. what, exactly? */
+            json.writeKey("byteLength"_s).write(_state->bufferSize);
+        }
 
-            /* Writing just the filename as the two files are expected to be
-               next to each other */
-            json.writeKey("uri"_s).write(Utility::Path::split(bufferFilename).second());
+        /* Fallback buffer for views compressed with EXT_meshopt_compression.
+           It has no data, which is why the extension is required. */
+        if(_state->meshoptFallbackBufferSize) {
+            const Containers::ScopeGuard gltfBuffer = json.beginObjectScope();
+            json.writeKey("byteLength"_s).write(_state->meshoptFallbackBufferSize);
+            json.writeKey("extensions"_s);
+            const Containers::ScopeGuard gltfExtensions = json.beginObjectScope();
+            json.writeKey("EXT_meshopt_compression"_s);
+            const Containers::ScopeGuard gltfMeshoptCompression = json.beginObjectScope();
+            json.writeKey("fallback"_s).write(true);
         }
+    }
 
-        json.writeKey("byteLength"_s).write(_state->buffer.size());
+    /* A streamed text glTF buffer file is complete at this point. If nothing
+       was written into it, remove it to have the same output as without
+       streaming. Clearing the name so doAbort() doesn't treat it as a
+       leftover. */
+    if(!_state->binary && _state->streamedBufferFilename) {
+        if(!_state->bufferSize)
+            Utility::Path::remove(_state->streamedBufferFilename);
+        _state->streamedBufferFilename = {};
     }
 
     /* Buffer views, accessors, ... If there are any, the array is left open --
@@ -409,11 +589,31 @@ Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
                     json.writeKey("indices"_s).write(*mesh.gltfIndices);
 
                 /* Attributes */
-                if(!mesh.gltfAttributes.isEmpty()) {
+                Int morphTargetCount = 0;
+                bool hasBaseAttributes = false;
+                for(const Containers::Triple<Containers::String, UnsignedInt, Int>& gltfAttribute: mesh.gltfAttributes) {
+                    morphTargetCount = Math::max(morphTargetCount, gltfAttribute.third() + 1);
+                    if(gltfAttribute.third() == -1)
+                        hasBaseAttributes = true;
+                }
+                if(hasBaseAttributes) {
                     json.writeKey("attributes"_s);
                     const Containers::ScopeGuard gltfAttributes = json.beginObjectScope();
-                    for(const Containers::Pair<Containers::String, UnsignedInt>& gltfAttribute: mesh.gltfAttributes)
-                        json.writeKey(gltfAttribute.first()).write(gltfAttribute.second());
+                    for(const Containers::Triple<Containers::String, UnsignedInt, Int>& gltfAttribute: mesh.gltfAttributes)
+                        if(gltfAttribute.third() == -1)
+                            json.writeKey(gltfAttribute.first()).write(gltfAttribute.second());
+                }
+
+                /* Morph targets, if any */
+                if(morphTargetCount) {
+                    json.writeKey("targets"_s);
+                    const Containers::ScopeGuard gltfTargets = json.beginArrayScope();
+                    for(Int i = 0; i != morphTargetCount; ++i) {
+                        const Containers::ScopeGuard gltfTarget = json.beginObjectScope();
+                        for(const Containers::Triple<Containers::String, UnsignedInt, Int>& gltfAttribute: mesh.gltfAttributes)
+                            if(gltfAttribute.third() == i)
+                                json.writeKey(gltfAttribute.first()).write(gltfAttribute.second());
+                    }
                 }
 
                 /* Mode */
@@ -506,16 +706,19 @@ Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
     Containers::Array<char> out;
     if(_state->binary) {
         jsonChunkPadding = 4*((json.size() + 3)/4) - json.size();
-        binChunkPadding = 4*((_state->buffer.size() + 3)/4) - _state->buffer.size();
+        binChunkPadding = 4*((_state->bufferSize + 3)/4) - _state->bufferSize;
         CORRADE_INTERNAL_ASSERT(jsonChunkPadding <= 3 && binChunkPadding <= 3);
 
         const std::size_t totalSize = 12 + /* file header */
             /* JSON chunk + header + padding */
             8 + json.size() + jsonChunkPadding +
             /* BIN chunk + header + padding */
-            (_state->buffer.isEmpty() ? 0 :
-                8 + _state->buffer.size() + binChunkPadding);
-        Containers::arrayReserve<ArrayAllocator>(out, totalSize);
+            (!_state->bufferSize ? 0 :
+                8 + _state->bufferSize + binChunkPadding);
+        /* If the buffer is streamed, doEndFile() appends it together with the
+           padding, reserve only for what's written here */
+        Containers::arrayReserve<ArrayAllocator>(out, _state->streamedBufferFilename ?
+            totalSize - (_state->bufferSize + binChunkPadding) : totalSize);
 
         /* glTF header */
         Containers::arrayAppend<ArrayAllocator>(out,
@@ -551,16 +754,20 @@ Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
             i = ' ';
 
         /* Add the buffer as a second BIN chunk. The size includes padding
-           again, this time the padding has to be zeros. */
-        if(!_state->buffer.isEmpty()) {
+           again, this time the padding has to be zeros. If the buffer is
+           streamed, only the chunk header is written here and doEndFile()
+           appends the rest. */
+        if(_state->bufferSize) {
             Containers::arrayAppend<ArrayAllocator>(out,
-                CharCaster{UnsignedInt(_state->buffer.size() + binChunkPadding)}.data);
+                CharCaster{UnsignedInt(_state->bufferSize + binChunkPadding)}.data);
             Containers::arrayAppend<ArrayAllocator>(out,
                 "BIN\0"_s);
-            Containers::arrayAppend<ArrayAllocator>(out,
-                _state->buffer);
-            for(char& i: Containers::arrayAppend<ArrayAllocator>(out, NoInit, binChunkPadding))
-                i = '\0';
+            if(!_state->streamedBufferFilename) {
+                Containers::arrayAppend<ArrayAllocator>(out,
+                    _state->buffer);
+                for(char& i: Containers::arrayAppend<ArrayAllocator>(out, NoInit, binChunkPadding))
+                    i = '\0';
+            }
         }
     }
 
@@ -568,7 +775,53 @@ Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
     return Containers::optional(Utility::move(out));
 }
 
+bool GltfSceneConverter::doEndFile(const Containers::StringView filename) {
+    /* If not streaming a binary glTF, the default implementation calling
+       doEndData() and writing its output is enough. A streamed text glTF has
+       the buffer file already complete. */
+    if(!_state->binary || !_state->streamedBufferFilename)
+        return AbstractSceneConverter::doEndFile(filename);
+
+    /* Write the header, JSON and BIN chunk header */
+    const Containers::Optional<Containers::Array<char>> out = doEndData();
+    if(!out)
+        return false;
+    if(!Utility::Path::write(filename, *out)) {
+        Error{} << "Trade::GltfSceneConverter::endFile(): can't write to" << filename;
+        return false;
+    }
+
+    /* Append the streamed buffer and padding after. Map the file where
+       possible to avoid having to read all of it into memory. */
+    if(_state->bufferSize) {
+        #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+        const Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> buffer = Utility::Path::mapRead(_state->streamedBufferFilename);
+        #else
+        const Containers::Optional<Containers::Array<char>> buffer = Utility::Path::read(_state->streamedBufferFilename);
+        #endif
+        if(!buffer || buffer->size() != _state->bufferSize) {
+            Error{} << "Trade::GltfSceneConverter::endFile(): can't read back" << _state->streamedBufferFilename;
+            return false;
+        }
+
+        const char zeros[3]{};
+        const std::size_t binChunkPadding = 4*((_state->bufferSize + 3)/4) - _state->bufferSize;
+        if(!Utility::Path::append(filename, *buffer) ||
+           !Utility::Path::append(filename, Containers::arrayView(zeros).prefix(binChunkPadding))) {
+            Error{} << "Trade::GltfSceneConverter::endFile(): can't write to" << filename;
+            return false;
+        }
+    }
+
+    Utility::Path::remove(_state->streamedBufferFilename);
+    _state->streamedBufferFilename = {};
+    return true;
+}
+
 void GltfSceneConverter::doAbort() {
+    /* Remove a partially streamed buffer, if any */
+    if(_state && _state->streamedBufferFilename && Utility::Path::exists(_state->streamedBufferFilename))
+        Utility::Path::remove(_state->streamedBufferFilename);
     _state = {};
 }
 
@@ -587,6 +840,7 @@ void GltfSceneConverter::doSetSceneFieldName(const SceneField field, const Conta
 }
 
 bool GltfSceneConverter::doAdd(const UnsignedInt id, const SceneData& scene, const Containers::StringView name) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doAdd", {}, id};
     if(!scene.is3D()) {
         Error{} << "Trade::GltfSceneConverter::add(): expected a 3D scene";
         return {};
@@ -1059,6 +1313,237 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const SceneData& scene, con
             stringOffset == customStringFieldCount);
     }
 
+    /* If requested, find sibling objects that have just a single mesh
+       assignment, a TRS transformation and no children, name or custom
+       fields, and turn each set of those referencing the same mesh and
+       material into a single node with EXT_mesh_gpu_instancing. The first
+       object of each set becomes the instancing node, `instancedObjects`
+       marks the others, which are then not written at all. */
+    Containers::BitArray instancedObjects{ValueInit, std::size_t(scene.mappingBound())};
+    Containers::Array<UnsignedInt> instances;
+    struct InstancingNode {
+        /* First object of the set */
+        UnsignedInt object;
+        /* Range in `instances` containing all objects of the set */
+        UnsignedInt instanceBegin, instanceEnd;
+        /* Accessor IDs for translations, rotations and scalings, -1 if all
+           of them are default */
+        Int accessors[3];
+    };
+    Containers::Array<InstancingNode> instancingNodes;
+    /* Index into `instancingNodes` for each object, -1 if it's not an
+       instancing node */
+    Containers::Array<Int> objectInstancingNodes;
+    /* Inverse of outputMapping, to get from child node IDs back to objects */
+    Containers::Array<UnsignedInt> nodeObjects;
+    if(configuration().value<bool>("gpuInstancing") && parentFieldSize) {
+        nodeObjects = Containers::Array<UnsignedInt>{NoInit, parentFieldSize};
+        objectInstancingNodes = Containers::Array<Int>{DirectInit, std::size_t(scene.mappingBound()), -1};
+        for(std::size_t i = 0; i != scene.mappingBound(); ++i)
+            if(hasParent[i]) nodeObjects[outputMapping[i]] = i;
+
+        const auto meshMaterialForInstancing = [&](const UnsignedInt object) -> Containers::Optional<Containers::Pair<UnsignedInt, Int>> {
+            if(childOffsets[object + 1] != childOffsets[object] ||
+               (_state->objectNames.size() > object && _state->objectNames[object]))
+                return {};
+
+            Containers::Optional<Containers::Pair<UnsignedInt, Int>> meshMaterial;
+            for(std::size_t i = objectFieldOffsets[object], iMax = objectFieldOffsets[object + 1]; i != iMax; ++i) {
+                const SceneField fieldName = scene.fieldName(fieldIds[i]);
+                if(fieldName == SceneField::Mesh) {
+                    if(meshMaterial)
+                        return {};
+                    meshMaterial = meshesMaterials[fieldOffsets[i]];
+                } else if(fieldName == SceneField::Transformation) {
+                    /* Only TRS can be put into the instance attributes, the
+                       matrix is ignored if TRS is present */
+                    if(!hasTrs[object] && transformations[fieldOffsets[i]] != Matrix4{})
+                        return {};
+                } else if(isSceneFieldCustom(fieldName))
+                    return {};
+            }
+
+            return meshMaterial;
+        };
+
+        /* Go through children of each object, and the root objects, which are
+           at the front, and find sets of instanceable objects */
+        Containers::Array<Containers::Triple<UnsignedInt, Int, UnsignedInt>> candidates;
+        for(std::size_t parent = 0; parent != scene.mappingBound() + 1; ++parent) {
+            const Containers::ArrayView<const UnsignedInt> siblings = parent == 0 ?
+                children.prefix(childOffsets[0]) :
+                children.slice(childOffsets[parent - 1], childOffsets[parent]);
+            if(siblings.size() < 2)
+                continue;
+
+            /** @todo arrayClear(), *finally* */
+            arrayResize(candidates, 0);
+            for(const UnsignedInt node: siblings) {
+                const UnsignedInt object = nodeObjects[node];
+                if(const Containers::Optional<Containers::Pair<UnsignedInt, Int>> meshMaterial = meshMaterialForInstancing(object))
+                    arrayAppend(candidates, InPlaceInit, meshMaterial->first(), meshMaterial->second(), object);
+            }
+
+            /* Sort by the mesh and material, and then by the object so the
+               lowest object ID becomes the instancing node */
+            std::sort(candidates.begin(), candidates.end(), [](const Containers::Triple<UnsignedInt, Int, UnsignedInt>& a, const Containers::Triple<UnsignedInt, Int, UnsignedInt>& b) {
+                return
+                    a.first() < b.first() ||
+                    (a.first() == b.first() && (a.second() < b.second() ||
+                    (a.second() == b.second() && a.third() < b.third())));
+            });
+
+            for(std::size_t i = 0; i != candidates.size(); ) {
+                std::size_t end = i + 1;
+                while(end != candidates.size() &&
+                      candidates[end].first() == candidates[i].first() &&
+                      candidates[end].second() == candidates[i].second())
+                    ++end;
+
+                if(end - i >= 2) {
+                    objectInstancingNodes[candidates[i].third()] = instancingNodes.size();
+                    arrayAppend(instancingNodes, InstancingNode{candidates[i].third(), UnsignedInt(instances.size()), 0, {-1, -1, -1}});
+                    for(std::size_t j = i; j != end; ++j) {
+                        arrayAppend(instances, candidates[j].third());
+                        if(j != i) instancedObjects.set(candidates[j].third());
+                    }
+                    instancingNodes.back().instanceEnd = instances.size();
+                }
+
+                i = end;
+            }
+        }
+    }
+
+    /* Write instance transformations to the buffer and accessors referencing
+       them, remove the instanced objects from the child lists */
+    if(!instancingNodes.isEmpty()) {
+        /* Instance TRS for all objects that are referenced */
+        Containers::Array<Vector3> instanceTranslations{ValueInit, instances.size()};
+        Containers::Array<Quaternion> instanceRotations{DirectInit, instances.size(), Math::IdentityInit};
+        Containers::Array<Vector3> instanceScalings{DirectInit, instances.size(), 1.0f};
+        for(std::size_t i = 0; i != instances.size(); ++i) {
+            const UnsignedInt object = instances[i];
+            for(std::size_t j = objectFieldOffsets[object], jMax = objectFieldOffsets[object + 1]; j != jMax; ++j) {
+                const SceneField fieldName = scene.fieldName(fieldIds[j]);
+                if(fieldName == SceneField::Translation)
+                    instanceTranslations[i] = translations[fieldOffsets[j]];
+                else if(fieldName == SceneField::Rotation)
+                    instanceRotations[i] = rotations[fieldOffsets[j]];
+                else if(fieldName == SceneField::Scaling)
+                    instanceScalings[i] = scalings[fieldOffsets[j]];
+            }
+        }
+
+        /* Data for all nodes are written first so a failure in writing a
+           streamed buffer doesn't leave the JSON partially written.
+           Attributes that have all values default are not written. */
+        Containers::Array<std::size_t> offsets{NoInit, instancingNodes.size()*3};
+        for(std::size_t i = 0; i != instancingNodes.size(); ++i) {
+            const std::size_t begin = instancingNodes[i].instanceBegin;
+            const std::size_t end = instancingNodes[i].instanceEnd;
+            const Containers::ArrayView<const Vector3> nodeTranslations = instanceTranslations.slice(begin, end);
+            const Containers::ArrayView<const Quaternion> nodeRotations = instanceRotations.slice(begin, end);
+            const Containers::ArrayView<const Vector3> nodeScalings = instanceScalings.slice(begin, end);
+            const Containers::ArrayView<const char> data[]{
+                Containers::arrayCast<const char>(nodeTranslations),
+                Containers::arrayCast<const char>(nodeRotations),
+                Containers::arrayCast<const char>(nodeScalings)
+            };
+            bool used[]{
+                std::find_if(nodeTranslations.begin(), nodeTranslations.end(), [](const Vector3& a) { return a != Vector3{}; }) != nodeTranslations.end(),
+                std::find_if(nodeRotations.begin(), nodeRotations.end(), [](const Quaternion& a) { return a != Quaternion{}; }) != nodeRotations.end(),
+                std::find_if(nodeScalings.begin(), nodeScalings.end(), [](const Vector3& a) { return a != Vector3{1.0f}; }) != nodeScalings.end()
+            };
+            /* The extension needs at least one attribute, write translations
+               if all instances are at the origin */
+            if(!used[0] && !used[1] && !used[2])
+                used[0] = true;
+            for(std::size_t j = 0; j != 3; ++j) {
+                if(!used[j]) {
+                    offsets[i*3 + j] = ~std::size_t{};
+                    continue;
+                }
+
+                const Containers::Optional<std::size_t> offset = _state->appendToBuffer(data[j], 4);
+                if(!offset)
+                    return {};
+                offsets[i*3 + j] = *offset;
+            }
+        }
+
+        if(_state->gltfBufferViews.isEmpty())
+            _state->gltfBufferViews.beginArray();
+        if(_state->gltfAccessors.isEmpty())
+            _state->gltfAccessors.beginArray();
+
+        const Containers::StringView accessorTypes[]{
+            "VEC3"_s, "VEC4"_s, "VEC3"_s
+        };
+        const Containers::StringView accessorNames[]{
+            "translations"_s, "rotations"_s, "scalings"_s
+        };
+        const std::size_t elementSizes[]{
+            sizeof(Vector3), sizeof(Quaternion), sizeof(Vector3)
+        };
+        for(std::size_t i = 0; i != instancingNodes.size(); ++i) {
+            const std::size_t count = instancingNodes[i].instanceEnd - instancingNodes[i].instanceBegin;
+            for(std::size_t j = 0; j != 3; ++j) {
+                if(offsets[i*3 + j] == ~std::size_t{})
+                    continue;
+
+                const std::size_t gltfBufferViewIndex = _state->gltfBufferViews.currentArraySize();
+                {
+                    const Containers::ScopeGuard gltfBufferView = _state->gltfBufferViews.beginObjectScope();
+                    _state->gltfBufferViews
+                        .writeKey("buffer"_s).write(0)
+                        .writeKey("byteOffset"_s).write(offsets[i*3 + j])
+                        .writeKey("byteLength"_s).write(count*elementSizes[j]);
+                    if(configuration().value<bool>("accessorNames"))
+                        _state->gltfBufferViews.writeKey("name"_s).write(Utility::format(
+                            "object {0} instance {1}", instancingNodes[i].object, accessorNames[j]));
+                }
+
+                instancingNodes[i].accessors[j] = _state->gltfAccessors.currentArraySize();
+                const Containers::ScopeGuard gltfAccessor = _state->gltfAccessors.beginObjectScope();
+                _state->gltfAccessors
+                    .writeKey("bufferView"_s).write(gltfBufferViewIndex)
+                    .writeKey("componentType"_s).write(Implementation::GltfTypeFloat)
+                    .writeKey("count"_s).write(count)
+                    .writeKey("type"_s).write(accessorTypes[j]);
+                if(configuration().value<bool>("accessorNames"))
+                    _state->gltfAccessors.writeKey("name"_s).write(Utility::format(
+                        "object {0} instance {1}", instancingNodes[i].object, accessorNames[j]));
+            }
+        }
+
+        /* Recalculate the output mapping without the instanced objects and
+           compact the child lists to not reference them anymore. Again,
+           `children[childOffsets[i]]` to `children[childOffsets[i + 1]]`
+           contains children of object `i`, `children[0]` until
+           `childOffsets[0]` contains root objects. */
+        UnsignedInt outputMappingOffset = 0;
+        for(std::size_t i = 0; i != scene.mappingBound(); ++i) {
+            if(!hasParent[i] || instancedObjects[i]) continue;
+            outputMapping[i] = outputMappingOffset++;
+        }
+        std::size_t childOffset = 0;
+        std::size_t previousChildOffset = 0;
+        for(std::size_t i = 0; i != scene.mappingBound() + 1; ++i) {
+            const std::size_t nextChildOffset = childOffsets[i];
+            for(std::size_t j = previousChildOffset; j != nextChildOffset; ++j) {
+                const UnsignedInt object = nodeObjects[children[j]];
+                if(!instancedObjects[object])
+                    children[childOffset++] = outputMapping[object];
+            }
+            childOffsets[i] = childOffset;
+            previousChildOffset = nextChildOffset;
+        }
+        childOffsets[scene.mappingBound() + 1] = childOffset;
+
+        _state->usedExtensions |= GltfExtension::ExtMeshGpuInstancing;
+    }
+
     /* Go object by object and consume the fields, populating the glTF node
        array. The output is currently restricted to a single scene, so the
        glTF nodes array should still be empty at this point. Otherwise we'd
@@ -1077,6 +1562,12 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const SceneData& scene, con
             continue;
         }
 
+        /* Objects merged into an instancing node are not exported on their
+           own */
+        if(instancedObjects[object])
+            continue;
+        const Int instancingNode = objectInstancingNodes.isEmpty() ? -1 : objectInstancingNodes[object];
+
         if(_state->gltfNodes.isEmpty())
             gltfNodes = _state->gltfNodes.beginArrayScope();
         const Containers::ScopeGuard gltfNode = _state->gltfNodes.beginObjectScope();
@@ -1188,6 +1679,15 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const SceneData& scene, con
                 continue;
             } else CORRADE_INTERNAL_ASSERT(!extrasOpen);
 
+            /* Transformation of an instancing node is in the instance
+               attributes */
+            if(instancingNode != -1 && (
+               fieldName == SceneField::Transformation ||
+               fieldName == SceneField::Translation ||
+               fieldName == SceneField::Rotation ||
+               fieldName == SceneField::Scaling))
+                continue;
+
             if(fieldName == SceneField::Transformation) {
                 /* § 5.25 (Node) says a node can have either a matrix or a TRS,
                    which doesn't really make it clear if both are allowed. But
@@ -1281,6 +1781,21 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const SceneData& scene, con
 
         if(extrasOpen) _state->gltfNodes.endObject();
 
+        if(instancingNode != -1) {
+            const InstancingNode& node = instancingNodes[instancingNode];
+            const Containers::StringView attributeNames[]{
+                "TRANSLATION"_s, "ROTATION"_s, "SCALE"_s
+            };
+            _state->gltfNodes.writeKey("extensions"_s).beginObject()
+                .writeKey("EXT_mesh_gpu_instancing"_s).beginObject()
+                    .writeKey("attributes"_s).beginObject();
+            for(std::size_t i = 0; i != 3; ++i) {
+                if(node.accessors[i] != -1)
+                    _state->gltfNodes.writeKey(attributeNames[i]).write(node.accessors[i]);
+            }
+            _state->gltfNodes.endObject().endObject().endObject();
+        }
+
         if(_state->objectNames.size() > object && _state->objectNames[object])
             _state->gltfNodes.writeKey("name"_s).write(_state->objectNames[object]);
     }
@@ -1312,7 +1827,281 @@ void GltfSceneConverter::doSetMeshAttributeName(const MeshAttribute attribute, C
     arrayAppend(_state->customMeshAttributes, InPlaceInit, attribute, Containers::String::nullTerminatedGlobalView(name));
 }
 
-bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const Containers::StringView name) {
+namespace {
+
+/* Output format of an attribute quantized to given bit count, together with
+   the range the scaled values have to fit into. Scale is 1 for positions,
+   which are quantized to non-normalized integers as there's no way to
+   supply a dequantization transform with the mesh alone, and the maximum
+   integer value for the others, which are normalized. */
+struct QuantizedFormat {
+    VertexFormat format;
+    Float scale, min, max;
+};
+
+Containers::Optional<QuantizedFormat> quantizedFormat(const MeshAttribute name, const VertexFormat format, const UnsignedInt bits) {
+    if(name == MeshAttribute::Position && format == VertexFormat::Vector3)
+        return bits == 8 ?
+            QuantizedFormat{VertexFormat::Vector3b, 1.0f, -128.0f, 127.0f} :
+            QuantizedFormat{VertexFormat::Vector3s, 1.0f, -32768.0f, 32767.0f};
+    if(name == MeshAttribute::Normal && format == VertexFormat::Vector3)
+        return bits == 8 ?
+            QuantizedFormat{VertexFormat::Vector3bNormalized, 127.0f, -127.0f, 127.0f} :
+            QuantizedFormat{VertexFormat::Vector3sNormalized, 32767.0f, -32767.0f, 32767.0f};
+    if(name == MeshAttribute::Tangent && format == VertexFormat::Vector4)
+        return bits == 8 ?
+            QuantizedFormat{VertexFormat::Vector4bNormalized, 127.0f, -127.0f, 127.0f} :
+            QuantizedFormat{VertexFormat::Vector4sNormalized, 32767.0f, -32767.0f, 32767.0f};
+    /* Unsigned so the Y flip can be done in the mesh data */
+    if(name == MeshAttribute::TextureCoordinates && format == VertexFormat::Vector2)
+        return bits == 8 ?
+            QuantizedFormat{VertexFormat::Vector2ubNormalized, 255.0f, 0.0f, 255.0f} :
+            QuantizedFormat{VertexFormat::Vector2usNormalized, 65535.0f, 0.0f, 65535.0f};
+    return {};
+}
+
+/* Returns whether all values fit into the quantized range with an error not
+   larger than `maxError` */
+bool canQuantize(const Containers::StridedArrayView2D<const Float>& values, const QuantizedFormat& quantized, const Float maxError) {
+    for(const Containers::StridedArrayView1D<const Float> vertex: values) {
+        for(const Float value: vertex) {
+            const Float scaled = Math::round(value*quantized.scale);
+            if(!(scaled >= quantized.min && scaled <= quantized.max) ||
+               Math::abs(scaled/quantized.scale - value) > maxError)
+                return false;
+        }
+    }
+    return true;
+}
+
+template<class T> void quantizeInto(const Containers::StridedArrayView2D<const Float>& src, const Containers::StridedArrayView2D<T>& dst, const Float scale) {
+    for(std::size_t i = 0; i != src.size()[0]; ++i)
+        for(std::size_t j = 0; j != src.size()[1]; ++j)
+            dst[i][j] = T(Math::round(src[i][j]*scale));
+}
+
+/* Copies vertex data of the mesh into a new interleaved layout with each
+   attribute aligned to four bytes, as glTF requires for vertex attributes.
+   If `positionsSeparate` is set, positions are put into a dedicated
+   interleaved stream before the other attributes. Attributes for which
+   `formats` differ from the original are quantized from floats, as decided
+   by quantizedFormat(). Attributes for which `sparse` is set are put into
+   a stream at the very end so the data preceding them can be written
+   without them. Index data are referenced without a copy. Returns NullOpt
+   if the mesh has no vertex data or its layout can't be determined due to
+   implementation-specific vertex formats, in which case the original mesh
+   is meant to be used. */
+Containers::Optional<MeshData> relayoutVertexData(const MeshData& mesh, const bool positionsSeparate, const Containers::ArrayView<const VertexFormat> formats, const Containers::ArrayView<const bool> sparse) {
+    CORRADE_INTERNAL_ASSERT(formats.size() == mesh.attributeCount() && sparse.size() == mesh.attributeCount());
+    if(!mesh.vertexCount() || !mesh.attributeCount())
+        return {};
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i)
+        if(isVertexFormatImplementationSpecific(mesh.attributeFormat(i)))
+            return {};
+
+    /* Calculate offsets of all attributes in their stream, each stream
+       followed by padding to make the next stream begin aligned. The first
+       stream has positions if they're separate, all attributes
+       otherwise, the third stream has the sparse attributes. */
+    Containers::Array<std::size_t> offsets{NoInit, mesh.attributeCount()};
+    Containers::Array<UnsignedByte> streams{NoInit, mesh.attributeCount()};
+    std::size_t strides[3]{};
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        if(sparse[i])
+            streams[i] = 2;
+        else if(!positionsSeparate || mesh.attributeName(i) == MeshAttribute::Position)
+            streams[i] = 0;
+        else
+            streams[i] = 1;
+        std::size_t& stride = strides[streams[i]];
+        offsets[i] = stride;
+        stride += 4*((vertexFormatSize(formats[i])*Math::max(mesh.attributeArraySize(i), UnsignedShort{1}) + 3)/4);
+    }
+
+    /* Zero-initialized so the padding is deterministic */
+    const std::size_t streamOffsets[]{
+        0,
+        mesh.vertexCount()*strides[0],
+        mesh.vertexCount()*(strides[0] + strides[1])
+    };
+    Containers::Array<char> vertexData{ValueInit, streamOffsets[2] + mesh.vertexCount()*strides[2]};
+    Containers::Array<MeshAttributeData> attributes{mesh.attributeCount()};
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        const std::size_t stride = strides[streams[i]];
+        char* const dstData = vertexData + streamOffsets[streams[i]] + offsets[i];
+        if(formats[i] == mesh.attributeFormat(i)) {
+            const Containers::StridedArrayView2D<const char> src = mesh.attribute(i);
+            Utility::copy(src, Containers::StridedArrayView2D<char>{vertexData,
+                dstData, src.size(), {std::ptrdiff_t(stride), 1}});
+        } else {
+            /* All quantized attributes are from floats to 8- or 16-bit
+               integers, which is all that quantizedFormat() produces */
+            const Containers::StridedArrayView2D<const Float> src = mesh.attribute<Float[]>(i);
+            const Containers::Size2D size{mesh.vertexCount(), vertexFormatComponentCount(formats[i])};
+            const VertexFormat componentFormat = vertexFormatComponentFormat(formats[i]);
+            const Float scale = isVertexFormatNormalized(formats[i]) ?
+                quantizedFormat(mesh.attributeName(i), mesh.attributeFormat(i), vertexFormatSize(componentFormat)*8)->scale : 1.0f;
+            if(componentFormat == VertexFormat::Byte)
+                quantizeInto(src, Containers::StridedArrayView2D<Byte>{vertexData, reinterpret_cast<Byte*>(dstData), size, {std::ptrdiff_t(stride), 1}}, scale);
+            else if(componentFormat == VertexFormat::Short)
+                quantizeInto(src, Containers::StridedArrayView2D<Short>{vertexData, reinterpret_cast<Short*>(dstData), size, {std::ptrdiff_t(stride), 2}}, scale);
+            else if(componentFormat == VertexFormat::UnsignedByte)
+                quantizeInto(src, Containers::StridedArrayView2D<UnsignedByte>{vertexData, reinterpret_cast<UnsignedByte*>(dstData), size, {std::ptrdiff_t(stride), 1}}, scale);
+            else if(componentFormat == VertexFormat::UnsignedShort)
+                quantizeInto(src, Containers::StridedArrayView2D<UnsignedShort>{vertexData, reinterpret_cast<UnsignedShort*>(dstData), size, {std::ptrdiff_t(stride), 2}}, scale);
+            else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        }
+
+        attributes[i] = MeshAttributeData{mesh.attributeName(i),
+            formats[i],
+            Containers::StridedArrayView1D<const void>{vertexData, dstData, mesh.vertexCount(), std::ptrdiff_t(stride)},
+            mesh.attributeArraySize(i), mesh.attributeMorphTargetId(i)};
+    }
+
+    Containers::ArrayView<const char> indexData;
+    MeshIndexData indices;
+    if(mesh.isIndexed()) {
+        indexData = mesh.indexData();
+        indices = MeshIndexData{mesh.indices()};
+    }
+
+    return MeshData{mesh.primitive(),
+        {}, indexData, indices,
+        Utility::move(vertexData), Utility::move(attributes),
+        mesh.vertexCount()};
+}
+
+/* Returns indices of elements that have at least one non-zero byte */
+Containers::Array<UnsignedInt> nonZeroElements(const Containers::StridedArrayView2D<const char>& data) {
+    Containers::Array<UnsignedInt> out;
+    for(std::size_t i = 0; i != data.size()[0]; ++i) {
+        for(const char c: data[i]) if(c) {
+            arrayAppend(out, UnsignedInt(i));
+            break;
+        }
+    }
+    return out;
+}
+
+/* Y-flips texture coordinates. Morph target texture coordinates are deltas,
+   for which the Y coordinate gets negated instead. */
+void flipTextureCoordinates(const Containers::StridedArrayView1D<char>& data, const VertexFormat format, const bool morphTarget) {
+    if(format == VertexFormat::Vector2) {
+        /* Subtracting from zero instead of negating to not turn zeros into
+           -0.0f, which would no longer be all-zero bytes */
+        for(auto& c: Containers::arrayCast<Vector2>(data))
+            c.y() = (morphTarget ? 0.0f : 1.0f) - c.y();
+    } else if(format == VertexFormat::Vector2ubNormalized) {
+        CORRADE_INTERNAL_ASSERT(!morphTarget);
+        for(auto& c: Containers::arrayCast<Vector2ub>(data))
+            c.y() = 255 - c.y();
+    } else if(format == VertexFormat::Vector2usNormalized) {
+        CORRADE_INTERNAL_ASSERT(!morphTarget);
+        for(auto& c: Containers::arrayCast<Vector2us>(data))
+            c.y() = 65535 - c.y();
+    }
+    /* Other formats are not possible to flip, and thus have to be flipped in
+       the material instead. This was already checked in doAdd(), failing if
+       textureCoordinateYFlipInMaterial isn't set for those formats, so it
+       should never get here. */
+    else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+}
+
+bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& inputMesh, const Containers::StringView name) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doAdd", {}, id};
+    const Containers::StringView vertexLayout = configuration().value<Containers::StringView>("vertexLayout");
+    if(vertexLayout && vertexLayout != "interleaved"_s && vertexLayout != "positionsSeparate"_s) {
+        Error{} << "Trade::GltfSceneConverter::add(): expected vertexLayout to be empty, interleaved or positionsSeparate but got" << vertexLayout;
+        return {};
+    }
+
+    /* Decide on quantized formats for attributes, if requested */
+    Containers::Array<VertexFormat> formats{NoInit, inputMesh.attributeCount()};
+    bool quantize = false;
+    {
+        const Containers::Pair<MeshAttribute, Containers::StringView> quantizationOptions[]{
+            {MeshAttribute::Position, "quantizePositions"_s},
+            {MeshAttribute::Normal, "quantizeNormals"_s},
+            {MeshAttribute::Tangent, "quantizeTangents"_s},
+            {MeshAttribute::TextureCoordinates, "quantizeTextureCoordinates"_s},
+        };
+        UnsignedInt quantizationBits[Containers::arraySize(quantizationOptions)];
+        for(std::size_t i = 0; i != Containers::arraySize(quantizationOptions); ++i) {
+            quantizationBits[i] = configuration().value<UnsignedInt>(quantizationOptions[i].second());
+            if(quantizationBits[i] != 0 && quantizationBits[i] != 8 && quantizationBits[i] != 16) {
+                Error{} << "Trade::GltfSceneConverter::add(): expected" << quantizationOptions[i].second() << "to be 0, 8 or 16 but got" << quantizationBits[i];
+                return {};
+            }
+        }
+
+        const Float maxError = configuration().value<Float>("quantizationMaxError");
+        for(UnsignedInt i = 0; i != inputMesh.attributeCount(); ++i) {
+            formats[i] = inputMesh.attributeFormat(i);
+
+            /* Array attributes are never among the quantized builtins */
+            const MeshAttribute attributeName = inputMesh.attributeName(i);
+            if(inputMesh.attributeArraySize(i))
+                continue;
+
+            for(std::size_t j = 0; j != Containers::arraySize(quantizationOptions); ++j) {
+                if(quantizationOptions[j].first() != attributeName || !quantizationBits[j])
+                    continue;
+
+                const Containers::Optional<QuantizedFormat> quantized = quantizedFormat(attributeName, formats[i], quantizationBits[j]);
+                if(!quantized)
+                    break;
+
+                if(!canQuantize(inputMesh.attribute<Float[]>(i), *quantized, maxError)) {
+                    if(!(flags() & SceneConverterFlag::Quiet))
+                        Warning{} << "Trade::GltfSceneConverter::add(): values of" << attributeName << "attribute" << i << "don't fit into" << quantized->format << "with a maximum error of" << maxError << Debug::nospace << ", saving unquantized";
+                    break;
+                }
+
+                formats[i] = quantized->format;
+                quantize = true;
+                break;
+            }
+        }
+    }
+
+    /* Decide which morph target attributes are saved as sparse accessors, if
+       requested. Only the count of non-zero elements matters, quantization
+       keeps zeros as zeros. */
+    const Float sparseMorphTargetThreshold = configuration().value<Float>("sparseMorphTargetThreshold");
+    Containers::Array<bool> sparseAttributes{ValueInit, inputMesh.attributeCount()};
+    bool sparse = false;
+    if(sparseMorphTargetThreshold > 0.0f && inputMesh.vertexCount()) {
+        for(UnsignedInt i = 0; i != inputMesh.attributeCount(); ++i) {
+            if(inputMesh.attributeMorphTargetId(i) == -1 ||
+               inputMesh.attributeArraySize(i) ||
+               isVertexFormatImplementationSpecific(inputMesh.attributeFormat(i)))
+                continue;
+
+            if(nonZeroElements(inputMesh.attribute(i)).size() <= sparseMorphTargetThreshold*inputMesh.vertexCount()) {
+                sparseAttributes[i] = true;
+                sparse = true;
+            }
+        }
+    }
+
+    /* If requested or if anything gets quantized or saved as sparse, copy the
+       vertex data into an interleaved aligned layout first, the rest then
+       operates on the copy. Sparse attributes are put at the end, the data
+       before are then the dense vertex data. */
+    Containers::Optional<MeshData> relaidMesh;
+    if(vertexLayout || quantize || sparse)
+        relaidMesh = relayoutVertexData(inputMesh, vertexLayout == "positionsSeparate"_s, formats, sparseAttributes);
+    const MeshData& mesh = relaidMesh ? *relaidMesh : inputMesh;
+    std::size_t denseVertexDataSize = mesh.vertexData().size();
+    if(!relaidMesh) {
+        for(bool& i: sparseAttributes) i = false;
+    } else for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        if(sparseAttributes[i])
+            denseVertexDataSize = Math::min(denseVertexDataSize, mesh.attributeOffset(i));
+    }
+
     /* Check and convert mesh primitive */
     /** @todo check primitive count according to the spec */
     Int gltfMode;
@@ -1537,6 +2326,15 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const
                 return {};
             }
 
+            /* Morph target texture coordinates are deltas, which can be
+               Y-flipped only if they're signed */
+            if(mesh.attributeMorphTargetId(i) != -1 &&
+               format != VertexFormat::Vector2 &&
+               !configuration().value<bool>("textureCoordinateYFlipInMaterial")) {
+                Error{} << "Trade::GltfSceneConverter::add(): morph target texture coordinates in" << format << "can't be Y-flipped, enable textureCoordinateYFlipInMaterial for the whole file instead";
+                return {};
+            }
+
         /* Colors are either three- or four-component */
         } else if(attributeName == MeshAttribute::Color) {
             gltfAttributeName = Containers::String::nullTerminatedGlobalView("COLOR"_s);
@@ -1796,9 +2594,13 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const
     };
 
     /* Sort attributes by their offset to group them into (strided) buffer
-       views.  */
+       views. Sparse attributes get their own buffer views later, so they're
+       skipped. */
+    std::size_t denseAttributeCount = 0;
     for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i)
-        attributesSortedByOffset[i] = {mesh.attributeOffset(i), i};
+        if(!sparseAttributes[i])
+            attributesSortedByOffset[denseAttributeCount++] = {mesh.attributeOffset(i), i};
+    attributesSortedByOffset = attributesSortedByOffset.prefix(denseAttributeCount);
     std::sort(attributesSortedByOffset.begin(), attributesSortedByOffset.end(), [](const Containers::Pair<std::size_t, std::size_t> a, const Containers::Pair<std::size_t, std::size_t> b) {
         return
             a.first() < b.first() ||
@@ -1841,7 +2643,7 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const
        offset earlier. If that's still not enough (for example if there's both
        an initial and final padding, in which case MeshData doesn't require the
        final padding to be included in the data) pad the buffer. */
-    const std::size_t vertexDataSize = mesh.vertexData().size();
+    const std::size_t vertexDataSize = denseVertexDataSize;
     std::size_t vertexBufferPadding = 0;
     for(Containers::Pair<std::size_t, std::size_t>& bufferView: bufferViews.prefix(bufferViewOffset)) {
         /* If the view fits into the vertex buffer, nothing to adjust */
@@ -1879,6 +2681,24 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const
             _state->gltfAccessors.beginArray();
     }
 
+    /* Compress the index and vertex data with EXT_meshopt_compression if
+       requested. It's not possible for 8-bit indices, vertex buffer views
+       with unsupported strides are left uncompressed below. */
+    const bool meshoptCompression = configuration().value<bool>("meshoptCompression");
+    const bool meshoptIndices = meshoptCompression && mesh.isIndexed() && mesh.indexCount() && mesh.indexType() != MeshIndexType::UnsignedByte;
+    const bool meshoptVertices = meshoptCompression && mesh.vertexCount();
+    /* Set to true if anything actually got compressed */
+    bool meshoptUsed = false;
+
+    /* Write byte-identical data only once if requested. Not done when
+       streaming, as the data aren't kept in memory for comparison. */
+    const bool deduplicateData = configuration().value<bool>("deduplicateData") && !_state->streamedBufferFilename;
+    const auto appendToBuffer = [this, deduplicateData](const Containers::ArrayView<const char> data, const std::size_t alignment) {
+        return deduplicateData ?
+            _state->appendToBufferDeduplicated(data, alignment) :
+            _state->appendToBuffer(data, alignment);
+    };
+
     CORRADE_INTERNAL_ASSERT(_state->meshes.size() == id);
     MeshProperties& meshProperties = arrayAppend(_state->meshes, InPlaceInit);
     {
@@ -1887,35 +2707,40 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const
             /* § 3.6.2.4 requires that "the offset of an accessor [...] MUST be
                a multiple of the size of the accessor’s component type". The
                byteOffset could be something else for example if there's
-               (unaligned) image data preceding it. */
-            {
-                const std::size_t indexTypeSize = meshIndexTypeSize(mesh.indexType());
-                const std::size_t padding = indexTypeSize*((_state->buffer.size() + indexTypeSize - 1)/indexTypeSize) - _state->buffer.size();
-                CORRADE_INTERNAL_ASSERT(padding <= 3);
-                /** @todo any better API for this? Utility::fill()? this is
-                    silly */
-                for(char& i: arrayAppend(_state->buffer, NoInit, padding))
-                    i = '\0';
-            }
-
-            /* Using indices() instead of indexData() to discard arbitrary
-               padding before and after */
+               (unaligned) image data preceding it. Using indices() instead of
+               indexData() to discard arbitrary padding before and after. */
             /** @todo or put the whole thing there, consistently with
                 vertexData()? */
-            const Containers::ArrayView<char> indexData = arrayAppend(_state->buffer, mesh.indices().asContiguous());
+            const std::size_t indexTypeSize = meshIndexTypeSize(mesh.indexType());
+            const Containers::ArrayView<const char> indexData = mesh.indices().asContiguous();
+            /* Compressed data only need to be aligned to four bytes */
+            const Containers::Array<char> meshoptIndexData = meshoptIndices ?
+                encodeMeshoptIndices(indexData, mesh.indexCount(), indexTypeSize) : nullptr;
+            const Containers::Optional<std::size_t> indexDataOffset = meshoptIndices ?
+                appendToBuffer(meshoptIndexData, 4) :
+                appendToBuffer(indexData, indexTypeSize);
+            if(!indexDataOffset)
+                return {};
 
             const std::size_t gltfBufferViewIndex = _state->gltfBufferViews.currentArraySize();
             const Containers::ScopeGuard gltfBufferView = _state->gltfBufferViews.beginObjectScope();
-            _state->gltfBufferViews
+            if(meshoptIndices)
+                writeMeshoptBufferView(_state->gltfBufferViews, _state->meshoptFallbackBufferSize, indexData.size());
+            else _state->gltfBufferViews
                 .writeKey("buffer"_s).write(0)
                 /** @todo could be omitted if zero, is that useful for anything? */
-                .writeKey("byteOffset"_s).write(indexData - _state->buffer)
-                .writeKey("byteLength"_s).write(indexData.size())
+                .writeKey("byteOffset"_s).write(*indexDataOffset)
+                .writeKey("byteLength"_s).write(indexData.size());
+            _state->gltfBufferViews
                 .writeKey("target"_s).write(Implementation::GltfTargetHintElementArray);
             if(configuration().value<bool>("accessorNames"))
                 _state->gltfBufferViews.writeKey("name"_s).write(Utility::format(
                     name ? "mesh {0} ({1}) indices" : "mesh {0} indices",
                     id, name));
+            if(meshoptIndices) {
+                writeMeshoptBufferViewExtension(_state->gltfBufferViews, *indexDataOffset, meshoptIndexData.size(), indexTypeSize, mesh.indexCount(), "INDICES"_s);
+                meshoptUsed = true;
+            }
 
             const std::size_t gltfAccessorIndex = _state->gltfAccessors.currentArraySize();
             const Containers::ScopeGuard gltfAccessor = _state->gltfAccessors.beginObjectScope();
@@ -1933,28 +2758,59 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const
             meshProperties.gltfIndices = gltfAccessorIndex;
         }
 
-        /* § 3.6.2.4 requires that "For performance and compatibility reasons,
-           [...] accessor.byteOffset and bufferView.byteStride MUST be
-           multiples of 4". The byteOffset could be something else for example
-           if there's (unaligned) image data preceding it, or an odd number of
-           8- or 16-bit indices. Pad the buffer appropriately. */
-        /** @todo enforce also 4-byte-aligned stride */
-        {
-            const std::size_t padding = 4*((_state->buffer.size() + 3)/4) - _state->buffer.size();
-            CORRADE_INTERNAL_ASSERT(padding <= 3);
-            /** @todo any better API for this? Utility::fill()? this is silly */
-            for(char& i: arrayAppend(_state->buffer, NoInit, padding))
-                i = '\0';
-        }
-
         /* Vertex data, plus any padding after. The view needs to include also
-           the padding so it can get sliced to strided views without asserts. */
-        Containers::ArrayView<char> vertexData = arrayAppend(_state->buffer, NoInit, mesh.vertexData().size() + vertexBufferPadding);
-        Utility::copy(mesh.vertexData(), vertexData.prefix(mesh.vertexData().size()));
+           the padding so it can get sliced to strided views without asserts.
+           If the buffer is streamed, the data get compressed or deduplicated,
+           they're put into a temporary array instead and written once texture
+           coordinates are flipped below. */
+        Containers::Array<char> vertexDataStorage;
+        Containers::ArrayView<char> vertexData;
+        Containers::Optional<std::size_t> vertexDataOffset;
+        if(_state->streamedBufferFilename || meshoptVertices || deduplicateData) {
+            vertexDataStorage = Containers::Array<char>{NoInit, vertexDataSize + vertexBufferPadding};
+            vertexData = vertexDataStorage;
+        } else {
+            /* § 3.6.2.4 requires that "For performance and compatibility
+               reasons, [...] accessor.byteOffset and bufferView.byteStride
+               MUST be multiples of 4". The byteOffset could be something else
+               for example if there's (unaligned) image data preceding it, or
+               an odd number of 8- or 16-bit indices. Pad the buffer
+               appropriately. */
+            /** @todo enforce also 4-byte-aligned stride */
+            vertexDataOffset = _state->appendToBuffer({}, 4);
+            CORRADE_INTERNAL_ASSERT(vertexDataOffset);
+            vertexData = arrayAppend(_state->buffer, NoInit, vertexDataSize + vertexBufferPadding);
+            _state->bufferSize += vertexData.size();
+        }
+        Utility::copy(mesh.vertexData().prefix(vertexDataSize), vertexData.prefix(vertexDataSize));
         /** @todo any better API for this? Utility::fill()? this is silly */
-        for(char& i: vertexData.exceptPrefix(mesh.vertexData().size()))
+        for(char& i: vertexData.exceptPrefix(vertexDataSize))
             i = '\0';
 
+        /* Flip texture coordinates unless they're meant to be flipped in the
+           material. Sparse attributes aren't in the dense vertex data, they
+           get flipped when written below. */
+        const bool flipTextureCoordinatesInData = !configuration().value<bool>("textureCoordinateYFlipInMaterial");
+        if(flipTextureCoordinatesInData) for(const GltfAttribute& gltfAttribute: gltfAttributes) {
+            if(mesh.attributeName(gltfAttribute.originalId) != MeshAttribute::TextureCoordinates || sparseAttributes[gltfAttribute.originalId])
+                continue;
+
+            CORRADE_INTERNAL_ASSERT(gltfAttribute.offset == 0);
+            flipTextureCoordinates(Containers::StridedArrayView1D<char>{vertexData,
+                vertexData + mesh.attributeOffset(gltfAttribute.originalId),
+                mesh.vertexCount(), mesh.attributeStride(gltfAttribute.originalId)},
+                mesh.attributeFormat(gltfAttribute.originalId),
+                mesh.attributeMorphTargetId(gltfAttribute.originalId) != -1);
+        }
+
+        /* Write the vertex data from the temporary array if not compressing.
+           Compressed data are written for each buffer view below. */
+        if(vertexDataStorage && !meshoptVertices) {
+            vertexDataOffset = appendToBuffer(vertexDataStorage, 4);
+            if(!vertexDataOffset)
+                return {};
+        }
+
         /* Remember the base buffer view index to which `bufferViewAssignments`
            are relative to. If there are no buffer views, the buffer view
            array might not even be opened yet. There are also no attributes in
@@ -1965,16 +2821,40 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const
 
         /* Write buffer views (minOffset, maxOffset, stride) */
         for(const Containers::Pair<std::size_t, std::size_t> bufferView: bufferViews.prefix(bufferViewOffset)) {
+            /* With compression enabled, each buffer view gets its data
+               written separately, compressed if the stride allows. The
+               ATTRIBUTES mode needs it to be a multiple of 4 and at most
+               256. */
+            const Containers::ArrayView<const char> bufferViewData = vertexData.sliceSize(bufferView.first(), mesh.vertexCount()*bufferView.second());
+            const bool meshoptBufferView = meshoptVertices && bufferView.second() % 4 == 0 && bufferView.second() <= 256;
+            const Containers::Array<char> meshoptBufferViewData = meshoptBufferView ?
+                encodeMeshoptAttributes(bufferViewData, mesh.vertexCount(), bufferView.second()) : nullptr;
+            std::size_t gltfByteOffset;
+            if(meshoptBufferView) {
+                const Containers::Optional<std::size_t> offset = appendToBuffer(meshoptBufferViewData, 4);
+                if(!offset)
+                    return {};
+                gltfByteOffset = *offset;
+            } else if(meshoptVertices) {
+                const Containers::Optional<std::size_t> offset = appendToBuffer(bufferViewData, 4);
+                if(!offset)
+                    return {};
+                gltfByteOffset = *offset;
+            } else gltfByteOffset = *vertexDataOffset + bufferView.first();
+
             const Containers::ScopeGuard gltfBufferView = _state->gltfBufferViews.beginObjectScope();
 
-            _state->gltfBufferViews
+            if(meshoptBufferView)
+                writeMeshoptBufferView(_state->gltfBufferViews, _state->meshoptFallbackBufferSize, bufferViewData.size());
+            else _state->gltfBufferViews
                 .writeKey("buffer"_s).write(0)
                 /* Byte offset could be omitted if zero but since that
                    happens only for the very first view in a buffer and we
                    have always at most one buffer, the minimal savings are
                    not worth the inconsistency */
-                .writeKey("byteOffset"_s).write(vertexData - _state->buffer + bufferView.first())
-                .writeKey("byteLength"_s).write(mesh.vertexCount()*bufferView.second())
+                .writeKey("byteOffset"_s).write(gltfByteOffset)
+                .writeKey("byteLength"_s).write(bufferViewData.size());
+            _state->gltfBufferViews
                 /* Byte stride could be omitted if there would be just one
                    tightly packed accessor (in which case it'd be implicitly
                    treated as tightly packed, same as in GL). Tracking count of
@@ -2000,44 +2880,106 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const
                 _state->gltfBufferViews.writeKey("name"_s).write(Utility::format(
                     name ? "mesh {0} ({1}) vertices" : "mesh {0} vertices",
                     id, name));
+            if(meshoptBufferView) {
+                writeMeshoptBufferViewExtension(_state->gltfBufferViews, gltfByteOffset, meshoptBufferViewData.size(), bufferView.second(), mesh.vertexCount(), "ATTRIBUTES"_s);
+                meshoptUsed = true;
+            }
         }
 
         /* Attribute views and accessors */
         for(const GltfAttribute& gltfAttribute: gltfAttributes) {
             const MeshAttribute attributeName = mesh.attributeName(gltfAttribute.originalId);
             const VertexFormat format = mesh.attributeFormat(gltfAttribute.originalId);
+            const Int morphTargetId = mesh.attributeMorphTargetId(gltfAttribute.originalId);
+
+            /* For a sparse attribute write just the non-zero elements
+               together with their indices into dedicated buffer views. The
+               spec requires at least one element, so if everything is zero
+               the first element is written. */
+            Containers::Array<UnsignedInt> sparseIndices;
+            Int gltfSparseIndexType{};
+            std::size_t gltfSparseIndicesBufferViewIndex{}, gltfSparseValuesBufferViewIndex{};
+            if(sparseAttributes[gltfAttribute.originalId]) {
+                const Containers::StridedArrayView2D<const char> src = mesh.attribute(gltfAttribute.originalId);
+                sparseIndices = nonZeroElements(src);
+                if(sparseIndices.isEmpty())
+                    arrayAppend(sparseIndices, 0u);
+
+                /* Smallest index type that can represent all vertex IDs */
+                std::size_t sparseIndexSize;
+                if(mesh.vertexCount() <= 256) {
+                    gltfSparseIndexType = Implementation::GltfTypeUnsignedByte;
+                    sparseIndexSize = 1;
+                } else if(mesh.vertexCount() <= 65536) {
+                    gltfSparseIndexType = Implementation::GltfTypeUnsignedShort;
+                    sparseIndexSize = 2;
+                } else {
+                    gltfSparseIndexType = Implementation::GltfTypeUnsignedInt;
+                    sparseIndexSize = 4;
+                }
+                Containers::Array<char> sparseIndexData{NoInit, sparseIndices.size()*sparseIndexSize};
+                for(std::size_t i = 0; i != sparseIndices.size(); ++i) {
+                    if(sparseIndexSize == 1)
+                        reinterpret_cast<UnsignedByte*>(sparseIndexData.data())[i] = sparseIndices[i];
+                    else if(sparseIndexSize == 2)
+                        reinterpret_cast<UnsignedShort*>(sparseIndexData.data())[i] = sparseIndices[i];
+                    else
+                        reinterpret_cast<UnsignedInt*>(sparseIndexData.data())[i] = sparseIndices[i];
+                }
 
-            /* Flip texture coordinates unless they're meant to be flipped in
-               the material */
-            if(attributeName == MeshAttribute::TextureCoordinates && !configuration().value<bool>("textureCoordinateYFlipInMaterial")) {
-                CORRADE_INTERNAL_ASSERT(gltfAttribute.offset == 0);
-                Containers::StridedArrayView1D<char> data{vertexData,
-                    vertexData + mesh.attributeOffset(gltfAttribute.originalId),
-                    mesh.vertexCount(), mesh.attributeStride(gltfAttribute.originalId)};
-                if(format == VertexFormat::Vector2)
-                    for(auto& c: Containers::arrayCast<Vector2>(data))
-                        c.y() = 1.0f - c.y();
-                else if(format == VertexFormat::Vector2ubNormalized)
-                    for(auto& c: Containers::arrayCast<Vector2ub>(data))
-                        c.y() = 255 - c.y();
-                else if(format == VertexFormat::Vector2usNormalized)
-                    for(auto& c: Containers::arrayCast<Vector2us>(data))
-                        c.y() = 65535 - c.y();
-                /* Other formats are not possible to flip, and thus have to be
-                   flipped in the material instead. This was already checked
-                   at the top, failing if textureCoordinateYFlipInMaterial
-                   isn't set for those formats, so it should never get here. */
-                else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+                const std::size_t elementSize = src.size()[1];
+                Containers::Array<char> sparseValueData{NoInit, sparseIndices.size()*elementSize};
+                for(std::size_t i = 0; i != sparseIndices.size(); ++i)
+                    Utility::copy(src[sparseIndices[i]], sparseValueData.sliceSize(i*elementSize, elementSize));
+                if(flipTextureCoordinatesInData && attributeName == MeshAttribute::TextureCoordinates)
+                    flipTextureCoordinates(Containers::StridedArrayView1D<char>{sparseValueData, sparseValueData.data(), sparseIndices.size(), std::ptrdiff_t(elementSize)}, format, true);
+
+                const Containers::Optional<std::size_t> sparseIndexDataOffset = appendToBuffer(sparseIndexData, sparseIndexSize);
+                if(!sparseIndexDataOffset)
+                    return {};
+                const Containers::Optional<std::size_t> sparseValueDataOffset = appendToBuffer(sparseValueData, 4);
+                if(!sparseValueDataOffset)
+                    return {};
+
+                /* Neither of the views is a vertex buffer, so no target */
+                gltfSparseIndicesBufferViewIndex = _state->gltfBufferViews.currentArraySize();
+                {
+                    const Containers::ScopeGuard gltfBufferView = _state->gltfBufferViews.beginObjectScope();
+                    _state->gltfBufferViews
+                        .writeKey("buffer"_s).write(0)
+                        .writeKey("byteOffset"_s).write(*sparseIndexDataOffset)
+                        .writeKey("byteLength"_s).write(sparseIndexData.size());
+                    if(configuration().value<bool>("accessorNames"))
+                        _state->gltfBufferViews.writeKey("name"_s).write(Utility::format(
+                            name ? "mesh {0} ({1}) {2} sparse indices" : "mesh {0} {2} sparse indices",
+                            id, name, gltfAttribute.name));
+                }
+                gltfSparseValuesBufferViewIndex = _state->gltfBufferViews.currentArraySize();
+                {
+                    const Containers::ScopeGuard gltfBufferView = _state->gltfBufferViews.beginObjectScope();
+                    _state->gltfBufferViews
+                        .writeKey("buffer"_s).write(0)
+                        .writeKey("byteOffset"_s).write(*sparseValueDataOffset)
+                        .writeKey("byteLength"_s).write(sparseValueData.size());
+                    if(configuration().value<bool>("accessorNames"))
+                        _state->gltfBufferViews.writeKey("name"_s).write(Utility::format(
+                            name ? "mesh {0} ({1}) {2} sparse values" : "mesh {0} {2} sparse values",
+                            id, name, gltfAttribute.name));
+                }
             }
 
             const UnsignedInt gltfAccessorIndex = _state->gltfAccessors.currentArraySize();
             const Containers::ScopeGuard gltfAccessor = _state->gltfAccessors.beginObjectScope();
-            _state->gltfAccessors
-                .writeKey("bufferView"_s).write(gltfBaseBufferViewIndex + bufferViewAssignments[gltfAttribute.originalId]);
-            /* Write byteOffset only if non-zero. Compared to byteStride in the
-               buffer view above, this is easy to do, so why not. */
-            if(const std::size_t gltfByteOffset = mesh.attributeOffset(gltfAttribute.originalId) + gltfAttribute.offset - bufferViews[bufferViewAssignments[gltfAttribute.originalId]].first())
-                _state->gltfAccessors.writeKey("byteOffset"_s).write(gltfByteOffset);
+            /* Sparse accessors have no bufferView, which makes them
+               implicitly zero-initialized */
+            if(!sparseAttributes[gltfAttribute.originalId]) {
+                _state->gltfAccessors
+                    .writeKey("bufferView"_s).write(gltfBaseBufferViewIndex + bufferViewAssignments[gltfAttribute.originalId]);
+                /* Write byteOffset only if non-zero. Compared to byteStride in
+                   the buffer view above, this is easy to do, so why not. */
+                if(const std::size_t gltfByteOffset = mesh.attributeOffset(gltfAttribute.originalId) + gltfAttribute.offset - bufferViews[bufferViewAssignments[gltfAttribute.originalId]].first())
+                    _state->gltfAccessors.writeKey("byteOffset"_s).write(gltfByteOffset);
+            }
             _state->gltfAccessors
                 .writeKey("componentType"_s).write(gltfAttribute.accessorComponentType);
             if(isVertexFormatNormalized(format))
@@ -2089,18 +3031,37 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const
                     .writeKey("max"_s).writeArray(Vector3d{minmax.second()}.data());
             }
 
+            if(sparseAttributes[gltfAttribute.originalId]) {
+                _state->gltfAccessors.writeKey("sparse"_s);
+                const Containers::ScopeGuard gltfSparse = _state->gltfAccessors.beginObjectScope();
+                _state->gltfAccessors
+                    .writeKey("count"_s).write(sparseIndices.size())
+                    .writeKey("indices"_s).beginObject()
+                        .writeKey("bufferView"_s).write(gltfSparseIndicesBufferViewIndex)
+                        .writeKey("componentType"_s).write(gltfSparseIndexType)
+                    .endObject()
+                    .writeKey("values"_s).beginObject()
+                        .writeKey("bufferView"_s).write(gltfSparseValuesBufferViewIndex)
+                    .endObject();
+            }
+
             if(configuration().value<bool>("accessorNames"))
                 _state->gltfAccessors.writeKey("name"_s).write(Utility::format(
                     name ? "mesh {0} ({1}) {2}" : "mesh {0} {2}",
                     id, name, gltfAttribute.name));
 
-            arrayAppend(meshProperties.gltfAttributes, InPlaceInit, gltfAttribute.name, gltfAccessorIndex);
+            arrayAppend(meshProperties.gltfAttributes, InPlaceInit, gltfAttribute.name, gltfAccessorIndex, morphTargetId);
         }
 
         /* Triangles are a default */
         if(gltfMode != 4) meshProperties.gltfMode = gltfMode;
     }
 
+    /* No uncompressed fallback data are written, so the extension is
+       required */
+    if(meshoptUsed)
+        _state->requiredExtensions |= GltfExtension::ExtMeshoptCompression;
+
     if(name) meshProperties.gltfName = name;
 
     return true;
@@ -2160,7 +3121,8 @@ struct MaskedMaterial {
 
 }
 
-bool GltfSceneConverter::doAdd(UnsignedInt, const MaterialData& material, const Containers::StringView name) {
+bool GltfSceneConverter::doAdd(const UnsignedInt id, const MaterialData& material, const Containers::StringView name) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doAdd", {}, id};
     /* Check that all referenced textures are in bounds. Because enumerating
        all potentially used textures would be very prone to accidentally
        missing some, it goes through all attributes and matches ones that end
@@ -3035,7 +3997,8 @@ bool GltfSceneConverter::doAdd(UnsignedInt, const MaterialData& material, const
     return true;
 }
 
-bool GltfSceneConverter::doAdd(CORRADE_UNUSED const UnsignedInt id, const TextureData& texture, const Containers::StringView name) {
+bool GltfSceneConverter::doAdd(const UnsignedInt id, const TextureData& texture, const Containers::StringView name) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doAdd", {}, id};
     GltfExtension textureExtension;
     UnsignedInt gltfImageId;
     if(texture.type() == TextureType::Texture2D) {
@@ -3219,6 +4182,9 @@ bool GltfSceneConverter::doAdd(CORRADE_UNUSED const UnsignedInt id, const Textur
 
             Containers::StringView textureExtensionString;
             switch(textureExtension) {
+                case GltfExtension::ExtTextureWebp:
+                    textureExtensionString = "EXT_texture_webp"_s;
+                    break;
                 case GltfExtension::KhrTextureBasisu:
                     textureExtensionString = "KHR_texture_basisu"_s;
                     break;
@@ -3228,6 +4194,8 @@ bool GltfSceneConverter::doAdd(CORRADE_UNUSED const UnsignedInt id, const Textur
                     textureExtensionString = "KHR_texture_ktx"_s;
                     break;
                 /* LCOV_EXCL_START */
+                case GltfExtension::ExtMeshGpuInstancing:
+                case GltfExtension::ExtMeshoptCompression:
                 case GltfExtension::KhrMaterialsUnlit:
                 case GltfExtension::KhrMaterialsClearCoat:
                 case GltfExtension::KhrMeshQuantization:
@@ -3303,12 +4271,62 @@ Containers::Pointer<AbstractImageConverter> loadAndInstantiateImageConverter(Plu
     return imageConverter;
 }
 
+ImageData2D copyImage(const ImageData2D& image) {
+    Containers::Array<char> data{NoInit, image.data().size()};
+    Utility::copy(image.data(), data);
+    if(image.isCompressed())
+        return ImageData2D{image.compressedStorage(), image.compressedFormat(), image.size(), Utility::move(data), image.flags()};
+    return ImageData2D{image.storage(), image.format(), image.formatExtra(), image.pixelSize(), image.size(), Utility::move(data), image.flags()};
+}
+
+}
+
+bool GltfSceneConverter::encodePendingImages(const char* const messagePrefix) {
+    if(_state->pendingImages.isEmpty())
+        return true;
+
+    /* Each pending image has its own converter instance, so the workers don't
+       need any synchronization except for picking the next image */
+    Containers::Array<Containers::Optional<Containers::Array<char>>> encoded{_state->pendingImages.size()};
+    std::atomic<std::size_t> next{0};
+    const auto encode = [&]() {
+        for(std::size_t i; (i = next++) < _state->pendingImages.size(); )
+            encoded[i] = _state->pendingImages[i].converter->convertToData(_state->pendingImages[i].image);
+    };
+
+    /* The calling thread is one of the workers. Threads are unavailable on
+       Emscripten without pthreads, encode serially there. */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    std::size_t threadCount = configuration().value<UnsignedInt>("imageThreads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    Containers::Array<std::thread> threads{Math::min(threadCount, _state->pendingImages.size()) - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{encode};
+    encode();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    encode();
+    #endif
+
+    /* Write the results in the order the images were added. If any of them
+       fails, the output is incomplete and the conversion should be aborted. */
+    Containers::Array<PendingImage> pendingImages = Utility::move(_state->pendingImages);
+    for(std::size_t i = 0; i != pendingImages.size(); ++i) {
+        const PendingImage& image = pendingImages[i];
+        if(!encoded[i]) {
+            Error{} << messagePrefix << "can't convert image" << image.id;
+            return false;
+        }
+
+        if(!writeImage(image.id, image.name, image.converter->mimeType(), *encoded[i], {}))
+            return false;
+    }
+
+    return true;
 }
 
 template<UnsignedInt dimensions> bool GltfSceneConverter::convertAndWriteImage(const UnsignedInt id, const Containers::StringView name, AbstractImageConverter& imageConverter, const ImageData<dimensions>& image, bool bundleImages) {
-    /* Only one of these two is filled */
-    Containers::ArrayView<char> imageData;
-    Containers::String imageFilename;
     if(bundleImages) {
         const Containers::Optional<Containers::Array<char>> out = imageConverter.convertToData(image);
         if(!out) {
@@ -3316,28 +4334,72 @@ template<UnsignedInt dimensions> bool GltfSceneConverter::convertAndWriteImage(c
             return {};
         }
 
-        imageData = arrayAppend(_state->buffer, *out);
-    } else {
-        /* All existing image converters that return a MIME type return an
-           extension as well, so we can (currently) get away with an assert.
-           Might need to be revisited eventually. */
-        const Containers::String extension = imageConverter.extension();
-        CORRADE_INTERNAL_ASSERT(extension);
-
-        if(!_state->filename) {
-            Error{} << "Trade::GltfSceneConverter::add(): can only write a glTF with external images if converting to a file";
+        return writeImage(id, name, imageConverter.mimeType(), *out, {});
+    }
+
+    /* All existing image converters that return a MIME type return an
+       extension as well, so we can (currently) get away with an assert.
+       Might need to be revisited eventually. */
+    const Containers::String extension = imageConverter.extension();
+    CORRADE_INTERNAL_ASSERT(extension);
+
+    if(!_state->filename) {
+        Error{} << "Trade::GltfSceneConverter::add(): can only write a glTF with external images if converting to a file";
+        return {};
+    }
+
+    const Containers::String imageFilename = Utility::format("{}.{}.{}",
+        Utility::Path::splitExtension(*_state->filename).first(),
+        id,
+        extension);
+
+    /* If deduplicating, convert to data first and reference an existing
+       file if it has the same contents */
+    if(configuration().value<bool>("deduplicateData")) {
+        const Containers::Optional<Containers::Array<char>> out = imageConverter.convertToData(image);
+        if(!out) {
+            Error{} << "Trade::GltfSceneConverter::add(): can't convert an image file";
             return {};
         }
 
-        imageFilename = Utility::format("{}.{}.{}",
-            Utility::Path::splitExtension(*_state->filename).first(),
-            id,
-            extension);
+        /* Compare the actual contents to not be affected by hash collisions */
+        const Containers::StringView data{*out};
+        const std::size_t hash = std::hash<Containers::StringView>{}(data);
+        const auto found = _state->uniqueExternalImages.equal_range(hash);
+        for(auto it = found.first; it != found.second; ++it) {
+            const Containers::Optional<Containers::String> existing = Utility::Path::readString(it->second);
+            if(existing && *existing == data)
+                return writeImage(id, name, {}, {}, it->second);
+        }
 
-        if(!imageConverter.convertToFile(image, imageFilename)) {
+        if(!Utility::Path::write(imageFilename, *out)) {
             Error{} << "Trade::GltfSceneConverter::add(): can't convert an image file";
             return {};
         }
+
+        _state->uniqueExternalImages.emplace(hash, imageFilename);
+
+    } else if(!imageConverter.convertToFile(image, imageFilename)) {
+        Error{} << "Trade::GltfSceneConverter::add(): can't convert an image file";
+        return {};
+    }
+
+    return writeImage(id, name, {}, {}, imageFilename);
+}
+
+bool GltfSceneConverter::writeImage(const UnsignedInt id, const Containers::StringView name, const Containers::StringView mimeType, const Containers::ArrayView<const char> bundledData, const Containers::StringView externalFilename) {
+    /* If not saved to an external file, the image is bundled. If
+       deduplicating and the same data are already in the buffer, the buffer
+       view is reused as well. Not done when streaming, as the data aren't
+       kept in memory for comparison. */
+    const bool deduplicateData = configuration().value<bool>("deduplicateData") && !_state->streamedBufferFilename;
+    Containers::Optional<std::size_t> imageDataOffset;
+    if(!externalFilename) {
+        imageDataOffset = deduplicateData ?
+            _state->appendToBufferDeduplicated(bundledData) :
+            _state->appendToBuffer(bundledData);
+        if(!imageDataOffset)
+            return {};
     }
 
     /* At this point we're sure nothing will fail so we can start writing the
@@ -3351,26 +4413,37 @@ template<UnsignedInt dimensions> bool GltfSceneConverter::convertAndWriteImage(c
     const Containers::ScopeGuard gltfImage = _state->gltfImages.beginObjectScope();
 
     /* Bundled image, needs a buffer view and a MIME type */
-    if(bundleImages) {
+    if(!externalFilename) {
         /* The caller should have already checked the MIME type is not empty */
-        const Containers::String mimeType = imageConverter.mimeType();
         CORRADE_INTERNAL_ASSERT(mimeType);
 
         /* If this is a first buffer view, open the buffer view array */
         if(_state->gltfBufferViews.isEmpty())
             _state->gltfBufferViews.beginArray();
 
-        /* Reference the image data from a buffer view */
-        const std::size_t gltfBufferViewIndex = _state->gltfBufferViews.currentArraySize();
-        const Containers::ScopeGuard gltfBufferView = _state->gltfBufferViews.beginObjectScope();
-        _state->gltfBufferViews
-            .writeKey("buffer"_s).write(0)
-            /** @todo could be omitted if zero, is that useful for anything? */
-            .writeKey("byteOffset"_s).write(imageData - _state->buffer)
-            .writeKey("byteLength"_s).write(imageData.size());
-        if(configuration().value<bool>("accessorNames"))
-            _state->gltfBufferViews.writeKey("name"_s).write(Utility::format(
-                name ? "image {0} ({1})" : "image {0}", id, name));
+        /* Reference the image data from a buffer view, reusing an existing
+           one if the data got deduplicated. As the deduplicated data have to
+           match exactly, the offset alone is enough to identify them. */
+        const bool deduplicateBufferView = deduplicateData && !bundledData.isEmpty();
+        const auto found = deduplicateBufferView ? _state->uniqueImageBufferViews.find(*imageDataOffset) : _state->uniqueImageBufferViews.end();
+        UnsignedInt gltfBufferViewIndex;
+        if(found != _state->uniqueImageBufferViews.end())
+            gltfBufferViewIndex = found->second;
+        else {
+            gltfBufferViewIndex = _state->gltfBufferViews.currentArraySize();
+            const Containers::ScopeGuard gltfBufferView = _state->gltfBufferViews.beginObjectScope();
+            _state->gltfBufferViews
+                .writeKey("buffer"_s).write(0)
+                /** @todo could be omitted if zero, is that useful for
+                    anything? */
+                .writeKey("byteOffset"_s).write(*imageDataOffset)
+                .writeKey("byteLength"_s).write(bundledData.size());
+            if(configuration().value<bool>("accessorNames"))
+                _state->gltfBufferViews.writeKey("name"_s).write(Utility::format(
+                    name ? "image {0} ({1})" : "image {0}", id, name));
+            if(deduplicateBufferView)
+                _state->uniqueImageBufferViews.emplace(*imageDataOffset, gltfBufferViewIndex);
+        }
 
         /* Reference the buffer view from the image */
         _state->gltfImages
@@ -3382,7 +4455,7 @@ template<UnsignedInt dimensions> bool GltfSceneConverter::convertAndWriteImage(c
         /* Reference the file from the image. Writing just the filename as the
            two files are expected to be next to each other. */
         _state->gltfImages
-            .writeKey("uri"_s).write(Utility::Path::split(imageFilename).second());
+            .writeKey("uri"_s).write(Utility::Path::split(externalFilename).second());
     }
 
     if(name)
@@ -3392,6 +4465,7 @@ template<UnsignedInt dimensions> bool GltfSceneConverter::convertAndWriteImage(c
 }
 
 bool GltfSceneConverter::doAdd(const UnsignedInt id, const ImageData2D& image, const Containers::StringView name) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doAdd", {}, id};
     /** @todo does it make sense to check for ImageFlag2D::Array here? glTF
         doesn't really care I think, and the image converters will warn on
         their own if that metadata is about to get lost */
@@ -3403,6 +4477,14 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const ImageData2D& image, c
         configuration().value<Containers::StringView>("bundleImages") ?
         configuration().value<bool>("bundleImages") : _state->binary;
 
+    /* Bundled images can have their encoding deferred to be done on
+       multiple threads. Otherwise, if there are any deferred images, encode
+       and write them first so the images stay in the order they were added
+       in. */
+    const bool deferEncoding = bundleImages && configuration().value<UnsignedInt>("imageThreads") != 1;
+    if(!deferEncoding && !encodePendingImages("Trade::GltfSceneConverter::add():"))
+        return {};
+
     /* Decide on features we need */
     ImageConverterFeatures expectedFeatures;
     if(image.isCompressed())
@@ -3432,11 +4514,13 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const ImageData2D& image, c
     /** @todo some more robust way to detect if Basis-encoded KTX image is
         produced? waiting until the image is produced and then parsing the
         header is insanely complicated :( */
+    } else if(mimeType == "image/webp"_s) {
+        extension = GltfExtension::ExtTextureWebp;
     } else if(mimeType == "image/ktx2"_s && imageConverterPluginName == "BasisKtxImageConverter"_s) {
         extension = GltfExtension::KhrTextureBasisu;
     } else if(mimeType == "image/ktx2"_s && configuration().value<bool>("experimentalKhrTextureKtx")) {
         extension = GltfExtension::KhrTextureKtx;
-    /** @todo EXT_texture_webp and MSFT_texture_dds, once we have converters */
+    /** @todo MSFT_texture_dds, once we have a converter */
     } else {
         if(!mimeType) {
             Error{} << "Trade::GltfSceneConverter::add():" << imageConverterPluginName << "doesn't specify any MIME type, can't save an image";
@@ -3456,12 +4540,15 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const ImageData2D& image, c
     }
 
     const UnsignedInt gltfImageId = image2DCount() + image3DCount();
-    CORRADE_INTERNAL_ASSERT(gltfImageId == (_state->gltfImages.isEmpty() ? 0 : _state->gltfImages.currentArraySize()));
+    CORRADE_INTERNAL_ASSERT(gltfImageId == (_state->gltfImages.isEmpty() ? 0 : _state->gltfImages.currentArraySize()) + _state->pendingImages.size());
 
     /* If the image writing fails due to an error, don't add any extensions
        -- otherwise we'd blow up on the asserts below when adding the next
-       image */
-    if(!convertAndWriteImage(id, name, *imageConverter, image, bundleImages))
+       image. A deferred image is assumed to succeed, a failure gets reported
+       only once it's encoded. */
+    if(deferEncoding)
+        arrayAppend(_state->pendingImages, PendingImage{id, Containers::String::nullTerminatedGlobalView(name), Utility::move(imageConverter), copyImage(image)});
+    else if(!convertAndWriteImage(id, name, *imageConverter, image, bundleImages))
         return false;
 
     CORRADE_INTERNAL_ASSERT(_state->image2DIdsTextureExtensions.size() == id);
@@ -3476,6 +4563,7 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const ImageData2D& image, c
 }
 
 bool GltfSceneConverter::doAdd(const UnsignedInt id, const ImageData3D& image, const Containers::StringView name) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doAdd", {}, id};
     /* If not set, 3D image conversion isn't even advertised */
     CORRADE_INTERNAL_ASSERT(configuration().value<bool>("experimentalKhrTextureKtx"));
 
@@ -3526,6 +4614,11 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const ImageData3D& image, c
         return {};
     }
 
+    /* 3D images are never deferred, encode and write any pending 2D images
+       first so the images stay in the order they were added in */
+    if(!encodePendingImages("Trade::GltfSceneConverter::add():"))
+        return {};
+
     const UnsignedInt gltfImageId = image2DCount() + image3DCount();
     CORRADE_INTERNAL_ASSERT(gltfImageId == (_state->gltfImages.isEmpty() ? 0 : _state->gltfImages.currentArraySize()));
 
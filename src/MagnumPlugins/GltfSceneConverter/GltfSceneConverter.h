@@ -111,12 +111,65 @@ conversion warnings to be suppressed. Both @ref SceneConverterFlag::Quiet and
 @ref ImageConverterFlags and propagated to image converter plugins the
 converter delegates to.
 
+By default, mesh and bundled image data are accumulated in memory and written
+to the output when the conversion ends. If converting to a file, enabling the
+@cb{.ini} streamBuffers @ce
+@ref Trade-GltfSceneConverter-configuration "configuration option" makes the
+data written out right as they're added, with only the JSON kept in memory.
+For a `*.gltf` file they go directly to the external `*.bin` file, for a
+`*.glb` file they go to a temporary `*.glb.bin.tmp` file next to the output,
+which is appended after the JSON chunk at the end and then removed. The output
+is the same in both cases.
+
+Enabling the @cb{.ini} deduplicateData @ce
+@ref Trade-GltfSceneConverter-configuration "configuration option" makes
+byte-identical mesh index and vertex data and bundled image data written to
+the buffer only once, with buffer views of subsequent occurrences pointing to
+the existing data. Bundled images with identical encoded data share the buffer
+view as well and external images with identical file contents reference the
+same file. The data are compared byte-by-byte, a hash match alone isn't
+treated as a duplicate. As the buffer contents aren't kept in memory when
+@cb{.ini} streamBuffers @ce is enabled, buffer data aren't deduplicated in that
+case. Mesh accessors and glTF image entries aren't shared, as each added mesh
+and image keeps its own ID.
+
 @subsection Trade-GltfSceneConverter-behavior-meshes Mesh export
 
 -   The @ref MeshData is exported with its exact binary layout. Only padding
     before and after an index view is omitted, the vertex buffer is saved
     verbatim into the glTF buffer. The vertex buffer may get padded with zeros
     at the end to satisfy glTF buffer bounds requirements.
+-   If the @cb{.ini} vertexLayout @ce
+    @ref Trade-GltfSceneConverter-configuration "configuration option" is set
+    to @cb{.ini} interleaved @ce, vertex data are instead copied into a single
+    interleaved buffer view with each attribute aligned to four bytes, so the
+    whole vertex buffer can be uploaded with a single copy. With
+    @cb{.ini} positionsSeparate @ce, positions are put into a dedicated buffer
+    view first, for example for a depth prepass, and remaining attributes are
+    interleaved in a second buffer view after. Attributes keep their order in
+    both cases, meshes with @ref isVertexFormatImplementationSpecific() "implementation-specific vertex formats"
+    are left untouched.
+-   The @cb{.ini} quantizePositions @ce, @cb{.ini} quantizeNormals @ce,
+    @cb{.ini} quantizeTangents @ce and
+    @cb{.ini} quantizeTextureCoordinates @ce
+    @ref Trade-GltfSceneConverter-configuration "configuration options" can
+    be set to @cb{.ini} 8 @ce or @cb{.ini} 16 @ce to quantize
+    @ref VertexFormat::Vector3 positions and normals,
+    @relativeref{VertexFormat,Vector4} tangents and
+    @relativeref{VertexFormat,Vector2} texture coordinates to corresponding
+    8- or 16-bit types, which are then exported with
+    [KHR_mesh_quantization](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Khronos/KHR_mesh_quantization/README.md).
+    Normals and tangents become signed normalized and texture coordinates
+    unsigned normalized, so only texture coordinates in the @f$ [0, 1] @f$
+    range can be quantized. As the dequantization transformation would have
+    to be applied to every node referencing the mesh and also affect node
+    children, positions are quantized to non-normalized integers without any
+    transformation, so they can be quantized only if they're close enough to
+    whole numbers. If quantizing an attribute would cause an error larger than
+    @cb{.ini} quantizationMaxError @ce for any component, it's saved
+    unquantized and a warning is printed. If anything is quantized, the vertex
+    data are saved in the @cb{.ini} interleaved @ce layout unless
+    @cb{.ini} vertexLayout @ce specifies otherwise.
 -   @ref MeshPrimitive::Points, @relativeref{MeshPrimitive,Lines},
     @relativeref{MeshPrimitive,LineLoop},
     @relativeref{MeshPrimitive,LineStrip},
@@ -129,6 +182,20 @@ converter delegates to.
     @ref MeshIndexType::UnsignedByte is supported but discouraged.
     Implementation-specific index types and non-contiguous index arrays can't
     be exported.
+-   If the @cb{.ini} meshoptCompression @ce
+    @ref Trade-GltfSceneConverter-configuration "configuration option" is
+    enabled, index and vertex buffer views are compressed with
+    [EXT_meshopt_compression](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/EXT_meshopt_compression/README.md),
+    which is then added to required extensions as no uncompressed fallback
+    data are written. Only the generic `ATTRIBUTES` and `INDICES` modes
+    without filters are used, there's no `TRIANGLES` mode encoding. Indices
+    of @ref MeshIndexType::UnsignedByte and vertex buffer views with stride
+    that isn't a multiple of four or is larger than 256 bytes aren't
+    compressed. Each vertex buffer view is then stored separately in the
+    buffer instead of the vertex buffer being saved verbatim. Quantized
+    attributes are exported with
+    [KHR_mesh_quantization](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Khronos/KHR_mesh_quantization/README.md)
+    same as without compression.
 -   While glTF has a requirement that vertex / index count corresponds to the
     actual primitive type, the exporter doesn't check that at the moment.
     Attribute-less meshes and meshes with zero vertices are not allowed by the
@@ -242,6 +309,20 @@ converter delegates to.
     each occurence. Second and following occurences of other attributes are
     prefixed with an underscore if not already and suffixed with `_1`, `_2`,
     ..., so e.g. a second position attribute becomes `_POSITION_1`.
+-   Attributes with @ref MeshData::attributeMorphTargetId() other than
+    @cpp -1 @ce are exported into the `targets` array, one item for each morph
+    target ID. Texture coordinate morph targets are deltas, so unless the
+    @cb{.ini} textureCoordinateYFlipInMaterial @ce
+    @ref Trade-GltfSceneConverter-configuration "configuration option" is
+    enabled, their Y coordinate is negated and only
+    @ref VertexFormat::Vector2 is supported.
+-   If the @cb{.ini} sparseMorphTargetThreshold @ce
+    @ref Trade-GltfSceneConverter-configuration "configuration option" is
+    non-zero, morph target attributes in which the fraction of non-zero
+    elements is at most the threshold are exported as sparse accessors
+    without a buffer view, containing just the non-zero elements and their
+    indices. The vertex data are then saved in the interleaved layout unless
+    @cb{.ini} vertexLayout @ce specifies otherwise.
 -   Mesh name, if passed, is saved into the file. Additionally the buffer views
     and accessors referenced by it will be annotated with mesh ID and name if
     the @cb{.ini} accessorNames @ce @ref Trade-GltfSceneConverter-configuration "configuration option"
@@ -278,13 +359,26 @@ converter delegates to.
     overriden using the @cb{.ini} bundleImages @ce
     @ref Trade-GltfSceneConverter-configuration "configuration option" on a
     per-image basis.
+-   If the @cb{.ini} imageThreads @ce
+    @ref Trade-GltfSceneConverter-configuration "configuration option" is set
+    to a value other than @cpp 1 @ce, bundled 2D images are not encoded right
+    away in @ref add() but copied and encoded together on multiple threads
+    once an external or a 3D image is added or the conversion ends, with each
+    image having its own image converter instance. The output still has the
+    images in the order they were added, but bundled image data may end up
+    placed after mesh data added later. Encoding errors are then reported only
+    once the encoding happens, failing the operation that triggered it. Same
+    as with @ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter",
+    the application has to be linked to `pthread` on Linux for this to work.
 -   Core glTF supports only JPEG and PNG file formats. Basis-encoded KTX2 files
     can be saved with the [KHR_texture_basisu](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Khronos/KHR_texture_basisu/README.md) extension by
-    setting @cb{.ini} imageConverter=BasisKtxImageConverter @ce. The
+    setting @cb{.ini} imageConverter=BasisKtxImageConverter @ce, WebP files
+    with the [EXT_texture_webp](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/EXT_texture_webp/README.md)
+    extension by setting @cb{.ini} imageConverter=WebPImageConverter @ce. The
+    extension is marked as required, no PNG or JPEG fallback is written. The
     [MSFT_texture_dds](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/MSFT_texture_dds/README.md)
-    and [EXT_texture_webp](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/EXT_texture_webp/README.md)
-    extensions are not exported because there's currently no image converter
-    capable of saving DDS and WebP files. Other formats (such as TGA,
+    extension is not exported because there's currently no image converter
+    capable of saving DDS files. Other formats (such as TGA,
     OpenEXR...) are not supported by the spec but @ref GltfImporter supports
     them and they can be exported if the @cb{.ini} strict
     @ce @ref Trade-GltfSceneConverter-configuration "configuration option"
@@ -489,6 +583,18 @@ the plugin supports also 3D images and 2D array textures using a proposed
     are ignored with a warning
 -   At the moment, only a single scene can be exported. Default scene index is
     however only written if @ref setDefaultScene() is called.
+-   If the @cb{.ini} gpuInstancing @ce
+    @ref Trade-GltfSceneConverter-configuration "configuration option" is
+    enabled, sibling objects with exactly one @ref SceneField::Mesh entry
+    referencing the same mesh and material and without any children, name or
+    custom fields are saved as a single node with
+    [EXT_mesh_gpu_instancing](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/EXT_mesh_gpu_instancing/README.md). The
+    node takes the place of the object with the lowest ID, translation,
+    rotation and scaling of each object become @cpp TRANSLATION @ce,
+    @cpp ROTATION @ce and @cpp SCALE @ce instance attributes, with attributes
+    that are identity for all instances omitted. Objects with a
+    @ref SceneField::Transformation that isn't identity and isn't accompanied
+    by TRS fields are exported as regular nodes.
 
 @section Trade-GltfSceneConverter-configuration Plugin-specific config
 
@@ -512,6 +618,7 @@ class MAGNUM_GLTFSCENECONVERTER_EXPORT GltfSceneConverter: public AbstractSceneC
         MAGNUM_GLTFSCENECONVERTER_LOCAL bool doBeginFile(Containers::StringView filename) override;
         MAGNUM_GLTFSCENECONVERTER_LOCAL bool doBeginData() override;
         MAGNUM_GLTFSCENECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doEndData() override;
+        MAGNUM_GLTFSCENECONVERTER_LOCAL bool doEndFile(Containers::StringView filename) override;
         MAGNUM_GLTFSCENECONVERTER_LOCAL void doAbort() override;
 
         MAGNUM_GLTFSCENECONVERTER_LOCAL void doSetDefaultScene(UnsignedInt id) override;
@@ -527,6 +634,8 @@ class MAGNUM_GLTFSCENECONVERTER_EXPORT GltfSceneConverter: public AbstractSceneC
         MAGNUM_GLTFSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const TextureData& texture, Containers::StringView name) override;
 
         template<UnsignedInt dimensions> MAGNUM_GLTFSCENECONVERTER_LOCAL bool convertAndWriteImage(UnsignedInt id, Containers::StringView name, AbstractImageConverter& imageConverter, const ImageData<dimensions>& image, bool bundleImages);
+        MAGNUM_GLTFSCENECONVERTER_LOCAL bool writeImage(UnsignedInt id, Containers::StringView name, Containers::StringView mimeType, Containers::ArrayView<const char> bundledData, Containers::StringView externalFilename);
+        MAGNUM_GLTFSCENECONVERTER_LOCAL bool encodePendingImages(const char* messagePrefix);
         MAGNUM_GLTFSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const ImageData2D& image, Containers::StringView name) override;
         MAGNUM_GLTFSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const ImageData3D& image, Containers::StringView name) override;
 
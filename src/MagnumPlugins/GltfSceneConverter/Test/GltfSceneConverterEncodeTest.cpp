@@ -0,0 +1,157 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+
+#include "MagnumPlugins/GltfSceneConverter/encode.h"
+#include "MagnumPlugins/GltfImporter/decode.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct GltfSceneConverterEncodeTest: TestSuite::Tester {
+    explicit GltfSceneConverterEncodeTest();
+
+    void meshoptAttributes();
+    void meshoptAttributesRoundtrip();
+    void meshoptIndices();
+    void meshoptIndicesRoundtrip();
+};
+
+using namespace Containers::Literals;
+
+const struct {
+    const char* name;
+    std::size_t count, stride;
+} MeshoptAttributesRoundtripData[]{
+    {"single vertex", 1, 4},
+    {"partial group", 7, 12},
+    {"multiple blocks", 1000, 20},
+    {"multiple blocks, large stride", 300, 64},
+    {"max stride", 33, 256},
+};
+
+const struct {
+    const char* name;
+    std::size_t indexSize;
+} MeshoptIndicesRoundtripData[]{
+    {"16-bit", 2},
+    {"32-bit", 4},
+};
+
+GltfSceneConverterEncodeTest::GltfSceneConverterEncodeTest() {
+    addTests({&GltfSceneConverterEncodeTest::meshoptAttributes});
+
+    addInstancedTests({&GltfSceneConverterEncodeTest::meshoptAttributesRoundtrip},
+        Containers::arraySize(MeshoptAttributesRoundtripData));
+
+    addTests({&GltfSceneConverterEncodeTest::meshoptIndices});
+
+    addInstancedTests({&GltfSceneConverterEncodeTest::meshoptIndicesRoundtrip},
+        Containers::arraySize(MeshoptIndicesRoundtripData));
+}
+
+void GltfSceneConverterEncodeTest::meshoptAttributes() {
+    /* Two four-byte vertices, {1, 2, 3, 4} and {3, 2, 1, 4}, same as in
+       GltfImporterDecodeTest::meshoptAttributes(). The first and third byte
+       stream are 2-bit with the zigzag-encoded +2 and -2 escaped after the
+       packed values, the others are all zeros, the first vertex is in the
+       tail. */
+    const UnsignedByte data[]{
+        1, 2, 3, 4,
+        3, 2, 1, 4
+    };
+    Containers::Array<char> out = encodeMeshoptAttributes(Containers::arrayCast<const char>(Containers::arrayView(data)), 2, 4);
+    CORRADE_COMPARE_AS(Containers::StringView{out},
+        "\xa0"
+        "\x01" "\x30\x00\x00\x00" "\x04"
+        "\x00"
+        "\x01" "\x30\x00\x00\x00" "\x03"
+        "\x00"
+        "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"
+        "\x01\x02\x03\x04"_s,
+        TestSuite::Compare::Container);
+}
+
+void GltfSceneConverterEncodeTest::meshoptAttributesRoundtrip() {
+    auto&& data = MeshoptAttributesRoundtripData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Mixture of slowly changing bytes that compress well and pseudorandom
+       bytes that need the raw encoding */
+    Containers::Array<char> input{NoInit, data.count*data.stride};
+    UnsignedInt seed = 1;
+    for(std::size_t i = 0; i != data.count; ++i) {
+        for(std::size_t j = 0; j != data.stride; ++j) {
+            seed = seed*1103515245 + 12345;
+            input[i*data.stride + j] = j % 4 == 3 ? char(seed >> 16) : char(i/(j + 1));
+        }
+    }
+
+    Containers::Array<char> encoded = encodeMeshoptAttributes(input, data.count, data.stride);
+    CORRADE_COMPARE(encoded[0], '\xa0');
+
+    Containers::Array<char> out{NoInit, input.size()};
+    CORRADE_VERIFY(decodeMeshoptAttributes("foo():", encoded, out, data.count, data.stride));
+    CORRADE_COMPARE_AS(out, input, TestSuite::Compare::Container);
+}
+
+void GltfSceneConverterEncodeTest::meshoptIndices() {
+    /* Zigzag-encoded +5, +1 and -2 against the first baseline, same as in
+       GltfImporterDecodeTest::meshoptIndices() */
+    const UnsignedInt data[]{5, 6, 4};
+    Containers::Array<char> out = encodeMeshoptIndices(Containers::arrayCast<const char>(Containers::arrayView(data)), 3, 4);
+    CORRADE_COMPARE_AS(Containers::StringView{out},
+        "\xd1\x14\x04\x06\0\0\0\0"_s,
+        TestSuite::Compare::Container);
+}
+
+void GltfSceneConverterEncodeTest::meshoptIndicesRoundtrip() {
+    auto&& data = MeshoptIndicesRoundtripData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* A strip-like sequence with occasional large jumps, which exercise
+       both baselines and multi-byte values */
+    const std::size_t count = 600;
+    Containers::Array<char> input{NoInit, count*data.indexSize};
+    for(std::size_t i = 0; i != count; ++i) {
+        const UnsignedInt index = i % 50 == 0 ? 60000 - i : i/3 + i % 3;
+        if(data.indexSize == 2)
+            reinterpret_cast<UnsignedShort*>(input.data())[i] = index;
+        else
+            reinterpret_cast<UnsignedInt*>(input.data())[i] = index*3;
+    }
+
+    Containers::Array<char> encoded = encodeMeshoptIndices(input, count, data.indexSize);
+
+    Containers::Array<char> out{NoInit, input.size()};
+    CORRADE_VERIFY(decodeMeshoptIndices("foo():", encoded, out, count, data.indexSize));
+    CORRADE_COMPARE_AS(out, input, TestSuite::Compare::Container);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::GltfSceneConverterEncodeTest)
@@ -84,6 +84,13 @@ struct GltfSceneConverterTest: TestSuite::Tester {
     void addMeshBufferViewsInterleavedPaddingBegin();
     void addMeshBufferViewsInterleavedPaddingBeginEnd();
     void addMeshBufferViewsMixed();
+    void addMeshMeshoptCompression();
+    void addMeshVertexLayout();
+    void addMeshVertexLayoutInvalid();
+    void addMeshQuantize();
+    void addMeshQuantizeMaxErrorExceeded();
+    void addMeshQuantizeInvalid();
+    void addMeshMorphTargets();
     void addMeshNoAttributes();
     void addMeshNoIndices();
     void addMeshNoIndicesNoAttributes();
@@ -108,6 +115,7 @@ struct GltfSceneConverterTest: TestSuite::Tester {
     void addImagePropagateConfigurationUnknown();
     void addImagePropagateConfigurationGroup();
     void addImageMultiple();
+    void addImageMultipleThreads();
     /* Multiple 2D + 3D images tested in addMaterial2DArrayTextures() */
     void addImageNoConverterManager();
     void addImageExternalToData();
@@ -136,12 +144,19 @@ struct GltfSceneConverterTest: TestSuite::Tester {
     void addSceneCustomFields();
     void addSceneNoParentField();
     void addSceneMultiple();
+    void addSceneGpuInstancing();
     void addSceneInvalid();
 
     void usedRequiredExtensionsAddedAlready();
 
     void toDataButExternalBuffer();
 
+    void streamBuffers();
+    void streamBuffersAbort();
+
+    void deduplicateDataMeshes();
+    void deduplicateDataImages();
+
     /* Needs to load TgaImageConverter from a system-wide location */
     PluginManager::Manager<AbstractImageConverter> _imageConverterManager;
     /* Explicitly forbid system-wide plugin dependencies */
@@ -196,6 +211,39 @@ const struct {
     {"verbose", SceneConverterFlag::Verbose, true}
 };
 
+const struct {
+    const char* name;
+    const char* vertexLayout;
+    bool interleaved;
+    std::size_t positionStride, otherStride;
+} AddMeshVertexLayoutData[]{
+    {"interleaved", "interleaved", true, 28, 28},
+    {"positions separate", "positionsSeparate", false, 12, 16},
+};
+
+const struct {
+    const char* name;
+    UnsignedInt bits;
+    VertexFormat positionFormat, normalFormat, tangentFormat, textureCoordinateFormat;
+} AddMeshQuantizeData[]{
+    {"8-bit", 8, VertexFormat::Vector3b, VertexFormat::Vector3bNormalized,
+        VertexFormat::Vector4bNormalized, VertexFormat::Vector2ubNormalized},
+    {"16-bit", 16, VertexFormat::Vector3s, VertexFormat::Vector3sNormalized,
+        VertexFormat::Vector4sNormalized, VertexFormat::Vector2usNormalized},
+};
+
+const struct {
+    const char* name;
+    Float sparseThreshold;
+    Containers::StringView vertexLayout;
+    bool sparse;
+} AddMeshMorphTargetsData[]{
+    {"", 0.0f, "", false},
+    {"sparse", 0.5f, "", true},
+    {"sparse, positions separate", 0.5f, "positionsSeparate", true},
+    {"sparse, threshold too low", 0.2f, "", false},
+};
+
 const struct {
     const char* name;
     bool binary;
@@ -716,6 +764,9 @@ const struct {
     {"TGA", "TgaImageConverter",
         {}, {}, false,
         "texture-tga.gltf"},
+    {"WebP", "WebPImageConverter",
+        {}, {}, {},
+        "texture-webp.gltf"},
 };
 
 const struct {
@@ -2005,7 +2056,24 @@ GltfSceneConverterTest::GltfSceneConverterTest() {
     addInstancedTests({&GltfSceneConverterTest::addMeshBufferViewsInterleavedPaddingBeginEnd},
         Containers::arraySize(VerboseData));
 
-    addTests({&GltfSceneConverterTest::addMeshBufferViewsMixed});
+    addTests({&GltfSceneConverterTest::addMeshBufferViewsMixed,
+              &GltfSceneConverterTest::addMeshMeshoptCompression});
+
+    addInstancedTests({&GltfSceneConverterTest::addMeshVertexLayout},
+        Containers::arraySize(AddMeshVertexLayoutData));
+
+    addTests({&GltfSceneConverterTest::addMeshVertexLayoutInvalid});
+
+    addInstancedTests({&GltfSceneConverterTest::addMeshQuantize},
+        Containers::arraySize(AddMeshQuantizeData));
+
+    addInstancedTests({&GltfSceneConverterTest::addMeshQuantizeMaxErrorExceeded},
+        Containers::arraySize(QuietData));
+
+    addTests({&GltfSceneConverterTest::addMeshQuantizeInvalid});
+
+    addInstancedTests({&GltfSceneConverterTest::addMeshMorphTargets},
+        Containers::arraySize(AddMeshMorphTargetsData));
 
     addInstancedTests({&GltfSceneConverterTest::addMeshNoAttributes},
         Containers::arraySize(QuietData));
@@ -2060,6 +2128,7 @@ GltfSceneConverterTest::GltfSceneConverterTest() {
         Containers::arraySize(QuietData));
 
     addTests({&GltfSceneConverterTest::addImageMultiple,
+              &GltfSceneConverterTest::addImageMultipleThreads,
               &GltfSceneConverterTest::addImageNoConverterManager,
               &GltfSceneConverterTest::addImageExternalToData});
 
@@ -2117,7 +2186,8 @@ GltfSceneConverterTest::GltfSceneConverterTest() {
         &GltfSceneConverterTest::addSceneNoParentField},
         Containers::arraySize(QuietData));
 
-    addTests({&GltfSceneConverterTest::addSceneMultiple});
+    addTests({&GltfSceneConverterTest::addSceneMultiple,
+              &GltfSceneConverterTest::addSceneGpuInstancing});
 
     addInstancedTests({&GltfSceneConverterTest::addSceneInvalid},
         Containers::arraySize(AddSceneInvalidData));
@@ -2126,6 +2196,14 @@ GltfSceneConverterTest::GltfSceneConverterTest() {
 
               &GltfSceneConverterTest::toDataButExternalBuffer});
 
+    addInstancedTests({&GltfSceneConverterTest::streamBuffers},
+        Containers::arraySize(FileVariantData));
+
+    addTests({&GltfSceneConverterTest::streamBuffersAbort,
+
+              &GltfSceneConverterTest::deduplicateDataMeshes,
+              &GltfSceneConverterTest::deduplicateDataImages});
+
     _converterManager.registerExternalManager(_imageConverterManager);
 
     /* Load the importer plugin directly from the build tree. Otherwise it's
@@ -2170,6 +2248,9 @@ GltfSceneConverterTest::GltfSceneConverterTest() {
     #ifdef STBIMAGEIMPORTER_PLUGIN_FILENAME
     CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(STBIMAGEIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
     #endif
+    #ifdef WEBPIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_imageConverterManager.load(WEBPIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
 
     /* Try to load Magnum's own TgaImageConverter plugin, if it exists. Do it
        after StbImageConverter so if TgaImageConverter is aliased to it, it
@@ -2826,6 +2907,359 @@ void GltfSceneConverterTest::addMeshBufferViewsMixed() {
         TestSuite::Compare::Container);
 }
 
+void GltfSceneConverterTest::addMeshMeshoptCompression() {
+    /* Interleaved positions and normals with a stride that's a multiple of
+       four, which get compressed, and colors with a three-byte stride that
+       stay uncompressed. Enough vertices to span more than one block. */
+    struct Vertex {
+        Vector3 position;
+        Vector3 normal;
+    };
+    struct Vertices {
+        Vertex interleaved[300];
+        Color3ub colors[300];
+    } vertices;
+    for(std::size_t i = 0; i != 300; ++i) {
+        vertices.interleaved[i].position = {Float(i), Float(i % 7), -Float(i)};
+        vertices.interleaved[i].normal = Vector3::zAxis(i % 2 ? 1.0f : -1.0f);
+        vertices.colors[i] = {UnsignedByte(i), UnsignedByte(255 - i % 256), 127};
+    }
+    UnsignedShort indices[900];
+    for(std::size_t i = 0; i != 900; ++i)
+        indices[i] = i/3 + i % 3;
+
+    auto interleaved = Containers::stridedArrayView(vertices.interleaved);
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, Containers::arrayView(&vertices, 1), {
+            MeshAttributeData{MeshAttribute::Position,
+                interleaved.slice(&Vertex::position)},
+            MeshAttributeData{MeshAttribute::Normal,
+                interleaved.slice(&Vertex::normal)},
+            MeshAttributeData{MeshAttribute::Color,
+                VertexFormat::Vector3ubNormalized,
+                Containers::arrayView(vertices.colors)}
+        }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("meshoptCompression", true);
+
+    const Containers::String filename = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "mesh-meshopt-compression.gltf");
+    CORRADE_VERIFY(converter->beginFile(filename));
+    CORRADE_VERIFY(converter->add(mesh));
+    CORRADE_VERIFY(converter->endFile());
+
+    /* The extension is required as there's no uncompressed fallback */
+    const Containers::Optional<Containers::String> gltf = Utility::Path::readString(filename);
+    CORRADE_VERIFY(gltf);
+    CORRADE_VERIFY(gltf->contains("\"extensionsRequired\": [\n    \"EXT_meshopt_compression\""));
+    CORRADE_VERIFY(gltf->contains("\"mode\": \"ATTRIBUTES\""));
+    CORRADE_VERIFY(gltf->contains("\"mode\": \"INDICES\""));
+    CORRADE_VERIFY(gltf->contains("\"fallback\": true"));
+
+    /* The buffer is smaller than the uncompressed data would be */
+    const Containers::Optional<Containers::Array<char>> bin = Utility::Path::read(Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "mesh-meshopt-compression.bin"));
+    CORRADE_VERIFY(bin);
+    CORRADE_COMPARE_AS(bin->size(), sizeof(vertices) + sizeof(indices),
+        TestSuite::Compare::Less);
+
+    if(_importerManager.loadState("GltfImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("GltfImporter plugin not found, cannot test a roundtrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(filename));
+
+    CORRADE_COMPARE(importer->meshCount(), 1);
+    Containers::Optional<MeshData> imported = importer->mesh(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE_AS(imported->indices<UnsignedShort>(),
+        Containers::arrayView(indices),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Position),
+        interleaved.slice(&Vertex::position),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Normal),
+        interleaved.slice(&Vertex::normal),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(imported->attributeFormat(MeshAttribute::Color), VertexFormat::Vector3ubNormalized);
+    CORRADE_COMPARE_AS(imported->attribute<Color3ub>(MeshAttribute::Color),
+        Containers::arrayView(vertices.colors),
+        TestSuite::Compare::Container);
+}
+
+void GltfSceneConverterTest::addMeshVertexLayout() {
+    auto&& data = AddMeshVertexLayoutData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Non-interleaved input, with a three-byte color that gets padded to four
+       bytes */
+    const struct Vertices {
+        Vector3 positions[3];
+        Color3ub colors[3];
+        Vector3 normals[3];
+    } vertices[]{{
+        {{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}, {7.0f, 8.0f, 9.0f}},
+        {0x112233_rgb, 0x445566_rgb, 0x778899_rgb},
+        {Vector3::xAxis(), Vector3::yAxis(), Vector3::zAxis()}
+    }};
+    MeshData mesh{MeshPrimitive::Triangles, {}, vertices, {
+        MeshAttributeData{MeshAttribute::Position,
+            Containers::arrayView(vertices->positions)},
+        MeshAttributeData{MeshAttribute::Color,
+            VertexFormat::Vector3ubNormalized,
+            Containers::arrayView(vertices->colors)},
+        MeshAttributeData{MeshAttribute::Normal,
+            Containers::arrayView(vertices->normals)},
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("vertexLayout", data.vertexLayout);
+
+    const Containers::String filename = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "mesh-vertex-layout.glb");
+    CORRADE_VERIFY(converter->beginFile(filename));
+    CORRADE_VERIFY(converter->add(mesh));
+    CORRADE_VERIFY(converter->endFile());
+
+    if(_importerManager.loadState("GltfImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("GltfImporter plugin not found, cannot test a roundtrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(filename));
+
+    Containers::Optional<MeshData> imported = importer->mesh(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->attributeStride(MeshAttribute::Position), data.positionStride);
+    CORRADE_COMPARE(imported->attributeStride(MeshAttribute::Color), data.otherStride);
+    CORRADE_COMPARE(imported->attributeStride(MeshAttribute::Normal), data.otherStride);
+    /* The color is right after positions if interleaved and the normal
+       after it, padded to four bytes */
+    if(data.interleaved)
+        CORRADE_COMPARE(imported->attributeOffset(MeshAttribute::Color), imported->attributeOffset(MeshAttribute::Position) + 12);
+    CORRADE_COMPARE(imported->attributeOffset(MeshAttribute::Normal), imported->attributeOffset(MeshAttribute::Color) + 4);
+    CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView(vertices->positions),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->attribute<Color3ub>(MeshAttribute::Color),
+        Containers::arrayView(vertices->colors),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView(vertices->normals),
+        TestSuite::Compare::Container);
+}
+
+void GltfSceneConverterTest::addMeshVertexLayoutInvalid() {
+    const Vector3 positions[1]{};
+    MeshData mesh{MeshPrimitive::Points, {}, positions, {
+        MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("vertexLayout", "tiled");
+
+    CORRADE_VERIFY(converter->beginData());
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(mesh));
+    CORRADE_COMPARE(out.str(), "Trade::GltfSceneConverter::add(): expected vertexLayout to be empty, interleaved or positionsSeparate but got tiled\n");
+}
+
+void GltfSceneConverterTest::addMeshQuantize() {
+    auto&& data = AddMeshQuantizeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Values chosen to be exactly representable in all quantized types */
+    const struct Vertex {
+        Vector3 position;
+        Vector3 normal;
+        Vector4 tangent;
+        Vector2 textureCoordinates;
+    } vertices[]{
+        {{1.0f, -2.0f, 3.0f}, Vector3::xAxis(), {0.0f, 1.0f, 0.0f, 1.0f}, {0.0f, 0.2f}},
+        {{-4.0f, 5.0f, 6.0f}, -Vector3::zAxis(), {1.0f, 0.0f, 0.0f, -1.0f}, {1.0f, 0.6f}},
+    };
+    auto view = Containers::stridedArrayView(vertices);
+    MeshData mesh{MeshPrimitive::Lines, {}, vertices, {
+        MeshAttributeData{MeshAttribute::Position, view.slice(&Vertex::position)},
+        MeshAttributeData{MeshAttribute::Normal, view.slice(&Vertex::normal)},
+        MeshAttributeData{MeshAttribute::Tangent, view.slice(&Vertex::tangent)},
+        MeshAttributeData{MeshAttribute::TextureCoordinates, view.slice(&Vertex::textureCoordinates)},
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("quantizePositions", data.bits);
+    converter->configuration().setValue("quantizeNormals", data.bits);
+    converter->configuration().setValue("quantizeTangents", data.bits);
+    converter->configuration().setValue("quantizeTextureCoordinates", data.bits);
+
+    const Containers::String filename = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "mesh-quantize.gltf");
+    CORRADE_VERIFY(converter->beginFile(filename));
+    CORRADE_VERIFY(converter->add(mesh));
+    CORRADE_VERIFY(converter->endFile());
+
+    const Containers::Optional<Containers::String> gltf = Utility::Path::readString(filename);
+    CORRADE_VERIFY(gltf);
+    CORRADE_VERIFY(gltf->contains("\"extensionsRequired\": [\n    \"KHR_mesh_quantization\""));
+
+    if(_importerManager.loadState("GltfImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("GltfImporter plugin not found, cannot test a roundtrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(filename));
+
+    Containers::Optional<MeshData> imported = importer->mesh(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->attributeFormat(MeshAttribute::Position), data.positionFormat);
+    CORRADE_COMPARE(imported->attributeFormat(MeshAttribute::Normal), data.normalFormat);
+    CORRADE_COMPARE(imported->attributeFormat(MeshAttribute::Tangent), data.tangentFormat);
+    CORRADE_COMPARE(imported->attributeFormat(MeshAttribute::TextureCoordinates), data.textureCoordinateFormat);
+    CORRADE_COMPARE_AS(imported->positions3DAsArray(),
+        view.slice(&Vertex::position),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->normalsAsArray(),
+        view.slice(&Vertex::normal),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->tangentsAsArray(),
+        Containers::arrayView<Vector3>({{0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->bitangentSignsAsArray(),
+        Containers::arrayView({1.0f, -1.0f}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->textureCoordinates2DAsArray(),
+        view.slice(&Vertex::textureCoordinates),
+        TestSuite::Compare::Container);
+}
+
+void GltfSceneConverterTest::addMeshQuantizeMaxErrorExceeded() {
+    auto&& data = QuietData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* The second position isn't close enough to a whole number, the texture
+       coordinates are outside of the unsigned normalized range */
+    const struct Vertex {
+        Vector3 position;
+        Vector2 textureCoordinates;
+    } vertices[]{
+        {{1.0f, 2.0f, 3.0f}, {0.0f, 1.0f}},
+        {{4.0f, 5.5f, 6.0f}, {-0.5f, 1.0f}},
+    };
+    auto view = Containers::stridedArrayView(vertices);
+    MeshData mesh{MeshPrimitive::Lines, {}, vertices, {
+        MeshAttributeData{MeshAttribute::Position, view.slice(&Vertex::position)},
+        MeshAttributeData{MeshAttribute::TextureCoordinates, view.slice(&Vertex::textureCoordinates)},
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->addFlags(data.flags);
+    converter->configuration().setValue("quantizePositions", 16);
+    converter->configuration().setValue("quantizeTextureCoordinates", 8);
+
+    CORRADE_VERIFY(converter->beginData());
+
+    std::ostringstream out;
+    {
+        Warning redirectWarning{&out};
+        CORRADE_VERIFY(converter->add(mesh));
+    }
+    if(data.quiet)
+        CORRADE_COMPARE(out.str(), "");
+    else CORRADE_COMPARE(out.str(),
+        "Trade::GltfSceneConverter::add(): values of Trade::MeshAttribute::Position attribute 0 don't fit into VertexFormat::Vector3s with a maximum error of 0.005, saving unquantized\n"
+        "Trade::GltfSceneConverter::add(): values of Trade::MeshAttribute::TextureCoordinates attribute 1 don't fit into VertexFormat::Vector2ubNormalized with a maximum error of 0.005, saving unquantized\n");
+
+    /* Nothing got quantized, so no extension is needed */
+    Containers::Optional<Containers::Array<char>> gltf = converter->endData();
+    CORRADE_VERIFY(gltf);
+    CORRADE_VERIFY(!Containers::StringView{*gltf}.contains("KHR_mesh_quantization"));
+}
+
+void GltfSceneConverterTest::addMeshQuantizeInvalid() {
+    const Vector3 positions[1]{};
+    MeshData mesh{MeshPrimitive::Points, {}, positions, {
+        MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("quantizeNormals", 12);
+
+    CORRADE_VERIFY(converter->beginData());
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(mesh));
+    CORRADE_COMPARE(out.str(), "Trade::GltfSceneConverter::add(): expected quantizeNormals to be 0, 8 or 16 but got 12\n");
+}
+
+void GltfSceneConverterTest::addMeshMorphTargets() {
+    auto&& data = AddMeshMorphTargetsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* First morph target has just one non-zero element in each attribute,
+       the second has all non-zero */
+    const struct Vertex {
+        Vector3 position;
+        Vector2 textureCoordinates;
+        Vector3 positionTarget0;
+        Vector2 textureCoordinatesTarget0;
+        Vector3 positionTarget1;
+    } vertices[]{
+        {{1.0f, 2.0f, 3.0f}, {0.0f, 0.25f}, {}, {}, {0.5f, 0.0f, 0.0f}},
+        {{4.0f, 5.0f, 6.0f}, {0.5f, 0.5f}, {}, {0.0f, 0.25f}, {0.0f, 0.5f, 0.0f}},
+        {{7.0f, 8.0f, 9.0f}, {1.0f, 0.75f}, {0.0f, 0.0f, -1.0f}, {}, {0.0f, 0.0f, 0.5f}},
+        {{0.0f, 1.0f, 2.0f}, {0.5f, 1.0f}, {}, {}, {0.5f, 0.5f, 0.0f}},
+    };
+    auto view = Containers::stridedArrayView(vertices);
+    MeshData mesh{MeshPrimitive::Points, {}, vertices, {
+        MeshAttributeData{MeshAttribute::Position, view.slice(&Vertex::position)},
+        MeshAttributeData{MeshAttribute::TextureCoordinates, view.slice(&Vertex::textureCoordinates)},
+        MeshAttributeData{MeshAttribute::Position, view.slice(&Vertex::positionTarget0), 0},
+        MeshAttributeData{MeshAttribute::TextureCoordinates, view.slice(&Vertex::textureCoordinatesTarget0), 0},
+        MeshAttributeData{MeshAttribute::Position, view.slice(&Vertex::positionTarget1), 1},
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("sparseMorphTargetThreshold", data.sparseThreshold);
+    converter->configuration().setValue("vertexLayout", data.vertexLayout);
+
+    const Containers::String filename = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "mesh-morph-targets.gltf");
+    CORRADE_VERIFY(converter->beginFile(filename));
+    CORRADE_VERIFY(converter->add(mesh));
+    CORRADE_VERIFY(converter->endFile());
+
+    const Containers::Optional<Containers::String> gltf = Utility::Path::readString(filename);
+    CORRADE_VERIFY(gltf);
+    CORRADE_VERIFY(gltf->contains("\"targets\": ["));
+    CORRADE_COMPARE(gltf->contains("\"sparse\": {"), data.sparse);
+
+    if(_importerManager.loadState("GltfImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("GltfImporter plugin not found, cannot test a roundtrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(filename));
+
+    Containers::Optional<MeshData> imported = importer->mesh(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->attributeCount(MeshAttribute::Position, 0), 1);
+    CORRADE_COMPARE(imported->attributeCount(MeshAttribute::TextureCoordinates, 0), 1);
+    CORRADE_COMPARE(imported->attributeCount(MeshAttribute::Position, 1), 1);
+    CORRADE_COMPARE_AS(imported->positions3DAsArray(),
+        view.slice(&Vertex::position),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->textureCoordinates2DAsArray(),
+        view.slice(&Vertex::textureCoordinates),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->positions3DAsArray(0, 0),
+        view.slice(&Vertex::positionTarget0),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->textureCoordinates2DAsArray(0, 0),
+        view.slice(&Vertex::textureCoordinatesTarget0),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->positions3DAsArray(0, 1),
+        view.slice(&Vertex::positionTarget1),
+        TestSuite::Compare::Container);
+}
+
 void GltfSceneConverterTest::addMeshNoAttributes() {
     auto&& data = QuietData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -4194,6 +4628,57 @@ void GltfSceneConverterTest::addImageMultiple() {
     CORRADE_COMPARE(imported2->pixels<Color3ub>()[0][0], 0xff6632_rgb);
 }
 
+void GltfSceneConverterTest::addImageMultipleThreads() {
+    if(_imageConverterManager.loadState("PngImageConverter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImageConverter plugin not found, cannot test");
+    if(_imageConverterManager.loadState("JpegImageConverter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("JpegImageConverter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("imageThreads", 3);
+
+    /* Same as addImageMultiple(), but with the bundled images encoded on
+       multiple threads. Saving into a subdirectory to have the same file
+       names referenced from the JSON. */
+    const Containers::String directory = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "image-multiple-threads");
+    CORRADE_VERIFY(Utility::Path::make(directory));
+    Containers::String filename = Utility::Path::join(directory, "image-multiple.gltf");
+    CORRADE_VERIFY(converter->beginFile(filename));
+
+    /* First image bundled as JPEG, deferred */
+    Color4ub imageData0[]{0xff3366_rgb};
+    converter->configuration().setValue("bundleImages", true);
+    converter->configuration().setValue("imageConverter", "JpegImageConverter");
+    CORRADE_VERIFY(converter->add(ImageView2D{PixelFormat::RGB8Unorm, {1, 1}, imageData0}));
+
+    /* Second image external as PNG, encodes the first one before being
+       written */
+    Color4ub imageData1[]{0x66ff3399_rgba};
+    converter->configuration().setValue("bundleImages", false);
+    converter->configuration().setValue("imageConverter", "PngImageConverter");
+    CORRADE_VERIFY(converter->add(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, imageData1}));
+
+    /* Third image again bundled as JPEG, deferred until the end. Overwriting
+       the input data after to verify the converter made a copy. */
+    Color4ub imageData2[]{0xff6633_rgb};
+    converter->configuration().setValue("bundleImages", true);
+    converter->configuration().setValue("imageConverter", "JpegImageConverter");
+    CORRADE_VERIFY(converter->add(ImageView2D{PixelFormat::RGB8Unorm, {1, 1}, imageData2}));
+    imageData2[0] = {};
+
+    /* The output should be the same as without threads */
+    CORRADE_VERIFY(converter->endFile());
+    CORRADE_COMPARE_AS(filename,
+        Utility::Path::join(GLTFSCENECONVERTER_TEST_DIR, "image-multiple.gltf"),
+        TestSuite::Compare::File);
+    CORRADE_COMPARE_AS(Utility::Path::join(directory, "image-multiple.bin"),
+        Utility::Path::join(GLTFSCENECONVERTER_TEST_DIR, "image-multiple.bin"),
+        TestSuite::Compare::File);
+    CORRADE_COMPARE_AS(Utility::Path::join(directory, "image-multiple.1.png"),
+        Utility::Path::join(GLTFSCENECONVERTER_TEST_DIR, "image-multiple.1.png"),
+        TestSuite::Compare::File);
+}
+
 void GltfSceneConverterTest::addImageNoConverterManager() {
     /* Create a new manager that doesn't have the image converter manager
        registered; load the plugin directly from the build tree. Otherwise it's
@@ -6071,6 +6556,100 @@ void GltfSceneConverterTest::addSceneMultiple() {
         TestSuite::Compare::File);
 }
 
+void GltfSceneConverterTest::addSceneGpuInstancing() {
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("gpuInstancing", true);
+
+    const Containers::String filename = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "scene-gpu-instancing.gltf");
+    CORRADE_VERIFY(converter->beginFile(filename));
+
+    /* Add two empty meshes to not have to bother with buffers. Not valid glTF
+       but accepted with strict=false (which gets reset back after) */
+    {
+        converter->configuration().setValue("strict", false);
+        Warning silenceWarning{nullptr};
+        CORRADE_VERIFY(converter->add(MeshData{MeshPrimitive::Points, 0}));
+        CORRADE_VERIFY(converter->add(MeshData{MeshPrimitive::Lines, 0}));
+        converter->configuration().setValue("strict", true);
+    }
+
+    /* - Objects 1, 3 and 6 are children of object 0 with mesh 0 and get
+         turned into a single instancing node at the place of object 1
+       - Object 2 is a child of object 0 as well but references mesh 1, so
+         it stays
+       - Objects 5 and 7 are roots referencing mesh 0 but object 7 has a
+         child, so both stay
+       - Object 4 is the only child of object 7 and has a name, so it stays
+         as well */
+    converter->setObjectName(4, "Named");
+    const struct Scene {
+        Containers::Pair<UnsignedInt, Int> parents[8];
+        Containers::Pair<UnsignedInt, Vector3> translations[4];
+        Containers::Pair<UnsignedInt, UnsignedInt> meshes[7];
+    } sceneData[]{{
+        {{0, -1}, {1, 0}, {2, 0}, {3, 0}, {4, 7}, {5, -1}, {6, 0}, {7, -1}},
+        {{1, {1.0f, 2.0f, 3.0f}},
+         {3, {4.0f, 5.0f, 6.0f}},
+         {4, {7.0f, 8.0f, 9.0f}},
+         {7, {0.0f, 0.0f, 1.0f}}},
+        {{1, 0}, {2, 1}, {3, 0}, {4, 0}, {5, 0}, {6, 0}, {7, 0}}
+    }};
+    SceneData scene{SceneMappingType::UnsignedInt, 8, {}, sceneData, {
+        SceneFieldData{SceneField::Parent,
+            Containers::stridedArrayView(sceneData->parents).slice(&Containers::Pair<UnsignedInt, Int>::first),
+            Containers::stridedArrayView(sceneData->parents).slice(&Containers::Pair<UnsignedInt, Int>::second)},
+        SceneFieldData{SceneField::Translation,
+            Containers::stridedArrayView(sceneData->translations).slice(&Containers::Pair<UnsignedInt, Vector3>::first),
+            Containers::stridedArrayView(sceneData->translations).slice(&Containers::Pair<UnsignedInt, Vector3>::second)},
+        SceneFieldData{SceneField::Mesh,
+            Containers::stridedArrayView(sceneData->meshes).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+            Containers::stridedArrayView(sceneData->meshes).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second)},
+    }};
+    CORRADE_VERIFY(converter->add(scene));
+    CORRADE_VERIFY(converter->endFile());
+
+    const Containers::Optional<Containers::String> gltf = Utility::Path::readString(filename);
+    CORRADE_VERIFY(gltf);
+    CORRADE_VERIFY(gltf->contains("\"extensionsUsed\": [\n    \"EXT_mesh_gpu_instancing\""));
+    CORRADE_VERIFY(gltf->contains("\"TRANSLATION\": 0"));
+    /* Rotation and scaling are identity for all instances */
+    CORRADE_VERIFY(!gltf->contains("\"ROTATION\""));
+    CORRADE_VERIFY(!gltf->contains("\"SCALE\""));
+
+    if(_importerManager.loadState("GltfImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("GltfImporter plugin not found, cannot test a roundtrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(filename));
+
+    /* Objects 3 and 6 are merged into object 1, which is now node 1 */
+    CORRADE_COMPARE(importer->objectCount(), 6);
+    CORRADE_COMPARE(importer->objectName(3), "Named");
+
+    Containers::Optional<SceneData> imported = importer->scene(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE_AS(imported->parentsAsArray(), (Containers::arrayView<Containers::Pair<UnsignedInt, Int>>({
+        {0, -1}, {1, 0}, {2, 0}, {3, 5}, {4, -1}, {5, -1}
+    })), TestSuite::Compare::Container);
+    /* The instancing node has no translation on its own */
+    CORRADE_COMPARE_AS(imported->translationsRotationsScalings3DAsArray(), (Containers::arrayView<Containers::Pair<UnsignedInt, Containers::Triple<Vector3, Quaternion, Vector3>>>({
+        {3, {{7.0f, 8.0f, 9.0f}, {}, Vector3{1.0f}}},
+        {5, {{0.0f, 0.0f, 1.0f}, {}, Vector3{1.0f}}},
+    })), TestSuite::Compare::Container);
+
+    const SceneField instanceTranslation = importer->sceneFieldForName("instanceTranslation");
+    CORRADE_VERIFY(imported->hasField(instanceTranslation));
+    CORRADE_COMPARE_AS(imported->mapping<UnsignedInt>(instanceTranslation), Containers::arrayView<UnsignedInt>({
+        1, 1, 1
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->field<Vector3>(instanceTranslation), Containers::arrayView<Vector3>({
+        {1.0f, 2.0f, 3.0f},
+        {4.0f, 5.0f, 6.0f},
+        {}
+    }), TestSuite::Compare::Container);
+    CORRADE_VERIFY(!imported->hasField(importer->sceneFieldForName("instanceRotation")));
+}
+
 void GltfSceneConverterTest::addSceneInvalid() {
     auto&& data = AddSceneInvalidData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -6174,6 +6753,217 @@ void GltfSceneConverterTest::toDataButExternalBuffer() {
     CORRADE_COMPARE(out.str(), "Trade::GltfSceneConverter::endData(): can only write a glTF with external buffers if converting to a file\n");
 }
 
+void GltfSceneConverterTest::streamBuffers() {
+    auto&& data = FileVariantData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Odd-sized index buffers to verify both alignment paddings get streamed
+       as well, texture coordinates to verify the Y-flip happens before the
+       vertex data get written */
+    const UnsignedByte indicesA[]{0, 1, 2, 0, 1};
+    const struct Vertex {
+        Vector3 position;
+        Vector2 textureCoordinates;
+    } vertices[]{
+        {{1.0f, 2.0f, 3.0f}, {0.25f, 0.75f}},
+        {{4.0f, 5.0f, 6.0f}, {0.5f, 1.0f}},
+        {{7.0f, 8.0f, 9.0f}, {1.0f, 0.0f}},
+    };
+    const Containers::StridedArrayView1D<const Vertex> verticesView = vertices;
+    MeshData a{MeshPrimitive::LineLoop,
+        {}, indicesA, MeshIndexData{indicesA},
+        {}, vertices, {
+            MeshAttributeData{MeshAttribute::Position, verticesView.slice(&Vertex::position)},
+            MeshAttributeData{MeshAttribute::TextureCoordinates, verticesView.slice(&Vertex::textureCoordinates)}
+        }};
+    const UnsignedShort indicesB[]{2, 1, 0};
+    MeshData b{MeshPrimitive::LineStrip,
+        {}, indicesB, MeshIndexData{indicesB},
+        {}, vertices, {
+            MeshAttributeData{MeshAttribute::Position, verticesView.slice(&Vertex::position)}
+        }};
+
+    /* Convert the same data once without and once with streaming into
+       different directories, which should result in the same files */
+    const Containers::String referenceDirectory = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "stream-buffers-reference");
+    const Containers::String directory = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "stream-buffers");
+    CORRADE_VERIFY(Utility::Path::make(referenceDirectory));
+    CORRADE_VERIFY(Utility::Path::make(directory));
+    for(const bool stream: {false, true}) {
+        CORRADE_ITERATION(stream);
+
+        Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+        converter->configuration().setValue("streamBuffers", stream);
+
+        const Containers::String filename = Utility::Path::join(stream ? directory : referenceDirectory, "mesh" + data.suffix);
+        CORRADE_VERIFY(converter->beginFile(filename));
+        CORRADE_VERIFY(converter->add(a));
+        CORRADE_VERIFY(converter->add(b));
+        CORRADE_VERIFY(converter->endFile());
+
+        /* The temporary file for a binary glTF is removed after */
+        CORRADE_VERIFY(!Utility::Path::exists(filename + ".bin.tmp"_s));
+    }
+
+    CORRADE_COMPARE_AS(Utility::Path::join(directory, "mesh" + data.suffix),
+        Utility::Path::join(referenceDirectory, "mesh" + data.suffix),
+        TestSuite::Compare::File);
+    if(!data.binary) CORRADE_COMPARE_AS(
+        Utility::Path::join(directory, "mesh.bin"),
+        Utility::Path::join(referenceDirectory, "mesh.bin"),
+        TestSuite::Compare::File);
+}
+
+void GltfSceneConverterTest::streamBuffersAbort() {
+    const Vector3 positions[1]{};
+    MeshData mesh{MeshPrimitive::LineLoop, {}, positions, {
+        MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("streamBuffers", true);
+
+    const Containers::String filename = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "stream-buffers-abort.glb");
+    if(Utility::Path::exists(filename))
+        CORRADE_VERIFY(Utility::Path::remove(filename));
+
+    CORRADE_VERIFY(converter->beginFile(filename));
+    CORRADE_VERIFY(converter->add(mesh));
+    CORRADE_VERIFY(Utility::Path::exists(filename + ".bin.tmp"_s));
+
+    /* Aborting removes the partially written buffer and doesn't produce any
+       output */
+    converter->abort();
+    CORRADE_VERIFY(!Utility::Path::exists(filename + ".bin.tmp"_s));
+    CORRADE_VERIFY(!Utility::Path::exists(filename));
+}
+
+void GltfSceneConverterTest::deduplicateDataMeshes() {
+    const UnsignedShort indices[]{0, 1, 2, 2, 1, 0};
+    const Vector3 positionsA[]{
+        {1.0f, 2.0f, 3.0f},
+        {4.0f, 5.0f, 6.0f},
+        {7.0f, 8.0f, 9.0f}
+    };
+    const Vector3 positionsB[]{
+        {1.0f, 2.0f, 3.0f},
+        {4.0f, 5.0f, 6.0f},
+        {7.0f, 8.0f, 0.0f}
+    };
+    MeshData meshA{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, positionsA, {
+            MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positionsA)}
+        }};
+    /* Same index data as A but different positions */
+    MeshData meshB{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, positionsB, {
+            MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positionsB)}
+        }};
+
+    /* Reference output without deduplication, to compare the size with */
+    const Containers::String referenceFilename = Utility::Path::join({GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "deduplicate-data-reference", "mesh.glb"});
+    const Containers::String filename = Utility::Path::join({GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "deduplicate-data", "mesh.glb"});
+    CORRADE_VERIFY(Utility::Path::make(Utility::Path::path(referenceFilename)));
+    CORRADE_VERIFY(Utility::Path::make(Utility::Path::path(filename)));
+    for(bool deduplicate: {false, true}) {
+        Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+        converter->configuration().setValue("deduplicateData", deduplicate);
+
+        CORRADE_VERIFY(converter->beginFile(deduplicate ? filename : referenceFilename));
+        CORRADE_VERIFY(converter->add(meshA));
+        CORRADE_VERIFY(converter->add(meshA));
+        CORRADE_VERIFY(converter->add(meshB));
+        CORRADE_VERIFY(converter->endFile());
+    }
+
+    /* The index data are written just once, the vertex data twice. Size of
+       the JSON differs only in the buffer view offsets and buffer size, which
+       is negligible. */
+    const Containers::Optional<std::size_t> referenceSize = Utility::Path::size(referenceFilename);
+    const Containers::Optional<std::size_t> size = Utility::Path::size(filename);
+    CORRADE_VERIFY(referenceSize);
+    CORRADE_VERIFY(size);
+    CORRADE_COMPARE_AS(*size, *referenceSize - 2*sizeof(indices) - sizeof(positionsA) + 16,
+        TestSuite::Compare::LessOrEqual);
+
+    if(_importerManager.loadState("GltfImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("GltfImporter plugin not found, cannot test a roundtrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_COMPARE(importer->meshCount(), 3);
+
+    for(UnsignedInt i: {0, 1, 2}) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<MeshData> imported = importer->mesh(i);
+        CORRADE_VERIFY(imported);
+        CORRADE_COMPARE_AS(imported->indices<UnsignedShort>(),
+            Containers::arrayView(indices),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView(i == 2 ? positionsB : positionsA),
+            TestSuite::Compare::Container);
+    }
+}
+
+void GltfSceneConverterTest::deduplicateDataImages() {
+    if(_imageConverterManager.loadState("PngImageConverter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImageConverter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("deduplicateData", true);
+    converter->configuration().setValue("imageConverter", "PngImageConverter");
+
+    const Containers::String filename = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "deduplicate-data-images.gltf");
+    const Containers::String duplicateImageFilename = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "deduplicate-data-images.3.png");
+    if(Utility::Path::exists(duplicateImageFilename))
+        CORRADE_VERIFY(Utility::Path::remove(duplicateImageFilename));
+
+    CORRADE_VERIFY(converter->beginFile(filename));
+
+    /* Two identical bundled images, then two identical external ones */
+    Color4ub imageData[]{0x66ff3399_rgba};
+    converter->configuration().setValue("bundleImages", true);
+    CORRADE_VERIFY(converter->add(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, imageData}));
+    CORRADE_VERIFY(converter->add(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, imageData}));
+    converter->configuration().setValue("bundleImages", false);
+    CORRADE_VERIFY(converter->add(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, imageData}));
+    CORRADE_VERIFY(converter->add(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, imageData}));
+
+    CORRADE_VERIFY(converter->endFile());
+
+    /* The bundled images share a buffer view, the external ones a file */
+    const Containers::Optional<Containers::String> gltf = Utility::Path::readString(filename);
+    CORRADE_VERIFY(gltf);
+    const Containers::StringView bufferView = gltf->find("\"bufferView\": 0");
+    CORRADE_VERIFY(bufferView);
+    CORRADE_VERIFY(gltf->suffix(bufferView.end()).contains("\"bufferView\": 0"));
+    CORRADE_VERIFY(!gltf->contains("\"bufferView\": 1"));
+    const Containers::StringView uri = gltf->find("\"uri\": \"deduplicate-data-images.2.png\"");
+    CORRADE_VERIFY(uri);
+    CORRADE_VERIFY(gltf->suffix(uri.end()).contains("\"uri\": \"deduplicate-data-images.2.png\""));
+    CORRADE_VERIFY(!Utility::Path::exists(duplicateImageFilename));
+
+    if(_importerManager.loadState("GltfImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("GltfImporter plugin not found, cannot test a roundtrip");
+    if(_importerManager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test a roundtrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_COMPARE(importer->image2DCount(), 4);
+
+    for(UnsignedInt i: {0, 1, 2, 3}) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<ImageData2D> imported = importer->image2D(i);
+        CORRADE_VERIFY(imported);
+        CORRADE_COMPARE(imported->size(), (Vector2i{1}));
+        CORRADE_COMPARE(imported->pixels<Color4ub>()[0][0], 0x66ff3399_rgba);
+    }
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::GltfSceneConverterTest)
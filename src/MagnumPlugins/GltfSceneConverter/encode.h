@@ -0,0 +1,197 @@
+#ifndef Magnum_Trade_encode_h
+#define Magnum_Trade_encode_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
+
+namespace Magnum { namespace Trade { namespace {
+
+/* Used only by GltfSceneConverter, but put into a dedicated header for easier
+   testing */
+
+/* Encoders for the EXT_meshopt_compression bitstream, as specified in
+   https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/EXT_meshopt_compression/README.md#appendix-a-bitstream
+   and producing data that the decoders in GltfImporter/decode.h accept.
+   Compared to the reference implementation in meshoptimizer they only
+   implement the generic ATTRIBUTES and INDICES modes and don't try the more
+   elaborate heuristics, trading compression ratio for simplicity. */
+
+inline UnsignedByte meshoptZigzag8(const UnsignedByte v) {
+    return (v << 1) ^ -(v >> 7);
+}
+
+/* Encodes `size` bytes, which is expected to be a multiple of 16, picking the
+   smallest of the four group encodings for each group of 16 */
+void encodeMeshoptBytes(Containers::Array<char>& out, const UnsignedByte* const data, const std::size_t size) {
+    /* Each group of 16 bytes has a two-bit mode in the header, filled in as
+       the groups get encoded */
+    const std::size_t headerOffset = out.size();
+    for(char& i: arrayAppend(out, NoInit, (size/16 + 3)/4))
+        i = 0;
+
+    for(std::size_t i = 0; i < size; i += 16) {
+        const UnsignedByte* const group = data + i;
+
+        /* Size of the 2- and 4-bit encoding is the packed values plus all
+           bytes that don't fit and have to be stored after */
+        std::size_t size2 = 4, size4 = 8;
+        bool allZero = true;
+        for(std::size_t j = 0; j != 16; ++j) {
+            if(group[j] >= 3) ++size2;
+            if(group[j] >= 15) ++size4;
+            if(group[j]) allZero = false;
+        }
+
+        UnsignedInt mode;
+        if(allZero) mode = 0;
+        else if(size2 <= size4 && size2 < 16) mode = 1;
+        else if(size4 < 16) mode = 2;
+        else mode = 3;
+        out[headerOffset + i/64] |= mode << (((i/16) % 4)*2);
+
+        /* All zeros, nothing to write */
+        if(mode == 0) continue;
+
+        /* Raw bytes */
+        if(mode == 3) {
+            arrayAppend(out, Containers::arrayCast<const char>(Containers::arrayView(group, 16)));
+            continue;
+        }
+
+        /* 2- or 4-bit values, highest bits first, with the all-ones value
+           meaning the actual byte is stored after the packed values */
+        const UnsignedInt bits = 1 << mode;
+        const UnsignedInt valuesPerByte = 8/bits;
+        const UnsignedInt sentinel = (1 << bits) - 1;
+        char* const packed = arrayAppend(out, NoInit, bits*2).data();
+        for(std::size_t j = 0; j != bits*2; ++j)
+            packed[j] = 0;
+        for(std::size_t j = 0; j != 16; ++j) {
+            const UnsignedInt value = Math::min(UnsignedInt(group[j]), sentinel);
+            packed[j/valuesPerByte] |= value << (8 - bits - (j % valuesPerByte)*bits);
+        }
+        for(std::size_t j = 0; j != 16; ++j)
+            if(group[j] >= sentinel) arrayAppend(out, char(group[j]));
+    }
+}
+
+/* Encodes `count` vertices of `stride` bytes in the ATTRIBUTES mode. The
+   stride is expected to be a multiple of 4 and at most 256, the count
+   non-zero. */
+Containers::Array<char> encodeMeshoptAttributes(const Containers::ArrayView<const char> in, const std::size_t count, const std::size_t stride) {
+    CORRADE_INTERNAL_ASSERT(count && stride && stride % 4 == 0 && stride <= 256 && in.size() == count*stride);
+
+    const UnsignedByte* const input = reinterpret_cast<const UnsignedByte*>(in.data());
+    Containers::Array<char> out;
+    arrayReserve(out, 1 + in.size() + in.size()/8 + 32);
+    arrayAppend(out, char(0xa0));
+
+    /* The first vertex is a baseline for the deltas */
+    UnsignedByte last[256];
+    for(std::size_t k = 0; k != stride; ++k)
+        last[k] = input[k];
+
+    /* Vertices are processed in blocks, each byte of a block encoded as a
+       separate delta stream from the same byte in the previous vertex */
+    const std::size_t blockSize = Math::min((8192/stride) & ~std::size_t{15}, std::size_t{256});
+    UnsignedByte deltas[256];
+    for(std::size_t offset = 0; offset < count; offset += blockSize) {
+        const std::size_t blockCount = Math::min(blockSize, count - offset);
+        const std::size_t blockCountAligned = (blockCount + 15) & ~std::size_t{15};
+        const UnsignedByte* const block = input + offset*stride;
+        for(std::size_t k = 0; k != stride; ++k) {
+            UnsignedByte value = last[k];
+            for(std::size_t i = 0; i != blockCount; ++i) {
+                deltas[i] = meshoptZigzag8(block[i*stride + k] - value);
+                value = block[i*stride + k];
+            }
+            for(std::size_t i = blockCount; i != blockCountAligned; ++i)
+                deltas[i] = 0;
+            last[k] = value;
+
+            encodeMeshoptBytes(out, deltas, blockCountAligned);
+        }
+    }
+
+    /* Tail with the first vertex, padded at the front to at least 32 bytes */
+    for(char& i: arrayAppend(out, NoInit, Math::max(stride, std::size_t{32}) - stride))
+        i = 0;
+    arrayAppend(out, in.prefix(stride));
+
+    return out;
+}
+
+inline void encodeMeshoptVByte(Containers::Array<char>& out, UnsignedInt v) {
+    /* Seven bits per byte, lowest group first, the highest bit denoting that
+       more bytes follow */
+    while(v >= 128) {
+        arrayAppend(out, char((v & 127) | 128));
+        v >>= 7;
+    }
+    arrayAppend(out, char(v));
+}
+
+/* Encodes `count` indices of `indexSize` bytes in the INDICES mode, with
+   indexSize being either 2 or 4 */
+Containers::Array<char> encodeMeshoptIndices(const Containers::ArrayView<const char> in, const std::size_t count, const std::size_t indexSize) {
+    CORRADE_INTERNAL_ASSERT((indexSize == 2 || indexSize == 4) && in.size() == count*indexSize);
+
+    Containers::Array<char> out;
+    arrayReserve(out, 1 + 2*count + 4);
+    arrayAppend(out, char(0xd1));
+
+    /* Two separate baselines, with the lowest bit of each value selecting
+       which one the delta is against. Picking the one with a smaller
+       difference. */
+    UnsignedInt last[2]{};
+    for(std::size_t i = 0; i != count; ++i) {
+        const UnsignedInt index = indexSize == 2 ?
+            UnsignedInt(reinterpret_cast<const UnsignedShort*>(in.data())[i]) :
+            reinterpret_cast<const UnsignedInt*>(in.data())[i];
+
+        const Int delta0 = Int(index - last[0]);
+        const Int delta1 = Int(index - last[1]);
+        const UnsignedInt current = Math::abs(delta1) < Math::abs(delta0) ? 1 : 0;
+        const Int delta = current ? delta1 : delta0;
+        const UnsignedInt zigzag = (UnsignedInt(delta) << 1) ^ UnsignedInt(delta >> 31);
+        encodeMeshoptVByte(out, (zigzag << 1) | current);
+        last[current] = index;
+    }
+
+    /* Tail that makes it possible to read a whole index without bounds checks
+       in the decoder */
+    for(char& i: arrayAppend(out, NoInit, 4))
+        i = 0;
+
+    return out;
+}
+
+}}}
+
+#endif
@@ -25,33 +25,200 @@
 
 #include "HarfBuzzFont.h"
 
-#include <hb-ft.h>
+#include <cstring>
+#include <mutex>
+#include <hb.h>
+#include <hb-ot.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringIterable.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/PluginManager/AbstractManager.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
 
 namespace Magnum { namespace Text {
 
 namespace {
 
+/* Glyph IDs, offsets and advances of a shaped text, in font units. Shaping
+   doesn't depend on the size the text is laid out at, so these can be reused
+   for any layout of the same text. */
+struct ShapedGlyph {
+    UnsignedInt id;
+    Vector2 offset;
+    Vector2 advance;
+};
+
 class HarfBuzzLayouter: public AbstractLayouter {
     public:
-        explicit HarfBuzzLayouter(const AbstractGlyphCache& cache, Float fontSize, Float textSize, hb_buffer_t* buffer, hb_glyph_info_t* glyphInfo, hb_glyph_position_t* glyphPositions, UnsignedInt glyphCount);
-
-        ~HarfBuzzLayouter();
+        explicit HarfBuzzLayouter(const AbstractGlyphCache& cache, Float fontSize, Float textSize, Containers::Array<ShapedGlyph>&& glyphs);
 
     private:
         std::tuple<Range2D, Range2D, Vector2> doRenderGlyph(UnsignedInt i) override;
 
         const AbstractGlyphCache& cache;
         const Float fontSize, textSize;
-        hb_buffer_t* const buffer;
-        hb_glyph_info_t* const glyphInfo;
-        hb_glyph_position_t* const glyphPositions;
+        const Containers::Array<ShapedGlyph> glyphs;
+};
+
+/* HarfBuzz faces shared by all HarfBuzzFont instances that opened the same
+   font data, regardless of the size. The face owns a copy of the data and
+   caches parsed tables and shape plans, each instance then only has its own
+   scaled hb_font_t on top. The user count is tracked here and not through
+   HarfBuzz reference counting so a face can't get picked up from the list
+   while it's being destroyed on another thread. */
+struct SharedFace {
+    hb_blob_t* blob;
+    hb_face_t* face;
+    std::size_t users;
+};
+
+struct SharedFaces {
+    std::mutex mutex;
+    Containers::Array<SharedFace> faces;
 };
 
+SharedFaces& sharedFaces() {
+    static SharedFaces faces;
+    return faces;
+}
+
+hb_face_t* acquireFace(const Containers::ArrayView<const char> data) {
+    SharedFaces& shared = sharedFaces();
+    std::lock_guard<std::mutex> lock{shared.mutex};
+
+    /* The count of distinct fonts opened at the same time is expected to be
+       small, so a linear search is fine. Comparing the data is done only for
+       data of the same size, and is still way cheaper than parsing the font
+       again. */
+    for(SharedFace& i: shared.faces) {
+        unsigned int size;
+        const char* const faceData = hb_blob_get_data(i.blob, &size);
+        if(size == data.size() && std::memcmp(faceData, data.data(), size) == 0) {
+            ++i.users;
+            return i.face;
+        }
+    }
+
+    hb_blob_t* const blob = hb_blob_create(data.data(), data.size(), HB_MEMORY_MODE_DUPLICATE, nullptr, nullptr);
+    /** @todo ability to specify different font in TTC collection, in sync
+        with FreeTypeFont */
+    hb_face_t* const face = hb_face_create(blob, 0);
+    hb_face_make_immutable(face);
+    arrayAppend(shared.faces, SharedFace{blob, face, 1});
+    return face;
 }
 
-HarfBuzzFont::HarfBuzzFont(): hbFont(nullptr) {}
+void releaseFace(hb_face_t* const face) {
+    SharedFaces& shared = sharedFaces();
+    std::lock_guard<std::mutex> lock{shared.mutex};
+
+    for(std::size_t i = 0; i != shared.faces.size(); ++i) {
+        SharedFace& sharedFace = shared.faces[i];
+        if(sharedFace.face != face) continue;
+
+        if(--sharedFace.users == 0) {
+            hb_face_destroy(sharedFace.face);
+            hb_blob_destroy(sharedFace.blob);
+            arrayRemoveUnordered(shared.faces, i);
+        }
+        return;
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+}
+
+/* Shaping state shared by layout() and shape(). A single HarfBuzz buffer is
+   reused for all shaping. */
+struct HarfBuzzFont::Shaper {
+    explicit Shaper(hb_font_t* font, std::size_t cacheSize): font{font}, buffer{hb_buffer_create()}, cache{cacheSize} {}
+
+    ~Shaper() { hb_buffer_destroy(buffer); }
+
+    /* The returned view is valid until the next call */
+    Containers::ArrayView<const ShapedGlyph> shape(Containers::StringView text);
+
+    hb_font_t* font;
+    hb_buffer_t* buffer;
+
+    /* Shaped text in the cache. Unused slots have lastUsed set to 0. */
+    struct CachedText {
+        Containers::String text;
+        std::size_t lastUsed = 0;
+        Containers::Array<ShapedGlyph> glyphs;
+    };
+    Containers::Array<CachedText> cache;
+    std::size_t cacheUseCounter = 0;
+
+    /* Shaped glyphs if the cache is disabled. Only ever grows, so shaping
+       many texts doesn't allocate for each. */
+    Containers::Array<ShapedGlyph> glyphs;
+};
+
+Containers::ArrayView<const ShapedGlyph> HarfBuzzFont::Shaper::shape(const Containers::StringView text) {
+    /* If the text was shaped before, reuse it. The cache is expected to be
+       small, so a linear search is fine. While at it, remember the least
+       recently used slot to replace in case the text isn't found. Unused
+       slots have lastUsed set to 0 so they get picked first. */
+    CachedText* slot = nullptr;
+    for(CachedText& i: cache) {
+        if(i.lastUsed && i.text == text) {
+            i.lastUsed = ++cacheUseCounter;
+            return i.glyphs;
+        }
+        if(!slot || i.lastUsed < slot->lastUsed) slot = &i;
+    }
+
+    /* Prepare HarfBuzz buffer. Clearing the contents resets also the segment
+       properties, so they need to be set again every time. */
+    hb_buffer_clear_contents(buffer);
+    hb_buffer_set_direction(buffer, HB_DIRECTION_LTR);
+    hb_buffer_set_script(buffer, HB_SCRIPT_LATIN);
+    hb_buffer_set_language(buffer, hb_language_from_string("en", 2));
+
+    /* Layout the text */
+    hb_buffer_add_utf8(buffer, text.data(), text.size(), 0, -1);
+    hb_shape(font, buffer, nullptr, 0);
+
+    UnsignedInt glyphCount;
+    const hb_glyph_info_t* const glyphInfo = hb_buffer_get_glyph_infos(buffer, &glyphCount);
+    const hb_glyph_position_t* const glyphPositions = hb_buffer_get_glyph_positions(buffer, &glyphCount);
+
+    /* Copy the output out of the buffer so it can be reused for the next
+       text, either to the cache, if enabled, or to the scratch array */
+    Containers::ArrayView<ShapedGlyph> out;
+    if(slot) {
+        slot->text = text;
+        slot->lastUsed = ++cacheUseCounter;
+        if(slot->glyphs.size() != glyphCount)
+            slot->glyphs = Containers::Array<ShapedGlyph>{NoInit, glyphCount};
+        out = slot->glyphs;
+    } else {
+        if(glyphs.size() < glyphCount)
+            glyphs = Containers::Array<ShapedGlyph>{NoInit, glyphCount};
+        out = glyphs.prefix(glyphCount);
+    }
+    for(std::size_t i = 0; i != glyphCount; ++i) {
+        out[i].id = glyphInfo[i].codepoint;
+        out[i].offset = Vector2(glyphPositions[i].x_offset,
+                                glyphPositions[i].y_offset)/64.0f;
+        out[i].advance = Vector2(glyphPositions[i].x_advance,
+                                 glyphPositions[i].y_advance)/64.0f;
+    }
+
+    return out;
+}
+
+HarfBuzzFont::HarfBuzzFont(): hbFont(nullptr) {
+    /* Without a plugin manager there's no configuration file to take the
+       defaults from */
+    configuration().setValue("shapeCacheSize", 0);
+}
 
 HarfBuzzFont::HarfBuzzFont(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): FreeTypeFont{manager, plugin}, hbFont(nullptr) {}
 
@@ -68,66 +235,96 @@ auto HarfBuzzFont::doOpenData(const Containers::ArrayView<const char> data, cons
     /* Open FreeType font */
     auto ret = FreeTypeFont::doOpenData(data, size);
 
-    /* Create Harfbuzz font */
-    if(FreeTypeFont::doIsOpened()) hbFont = hb_ft_font_create(ftFont, nullptr);
+    /* Create Harfbuzz font on a face shared with other instances that opened
+       the same data, scaled to the size. The scale is in the same 26.6 fixed
+       point units FreeType uses, shaped positions are then converted from
+       those. */
+    if(FreeTypeFont::doIsOpened()) {
+        hbFont = hb_font_create(acquireFace(data));
+        /* Newer HarfBuzz versions use these by default, older have no font
+           functions set at all */
+        hb_ot_font_set_funcs(hbFont);
+        const int scale = size*64;
+        hb_font_set_scale(hbFont, scale, scale);
+        hb_font_set_ppem(hbFont, UnsignedInt(size), UnsignedInt(size));
+        hb_font_make_immutable(hbFont);
+        _shaper.emplace(hbFont, configuration().value<UnsignedInt>("shapeCacheSize"));
+    }
 
     return ret;
 }
 
 void HarfBuzzFont::doClose() {
-    hb_font_destroy(hbFont);
+    _shaper = nullptr;
+    if(hbFont) {
+        /* The font holds a reference to the face, so destroy it first for
+           releaseFace() to destroy the face once it's the last user */
+        hb_face_t* const face = hb_font_get_face(hbFont);
+        hb_font_destroy(hbFont);
+        releaseFace(face);
+    }
     hbFont = nullptr;
     FreeTypeFont::doClose();
 }
 
 Containers::Pointer<AbstractLayouter> HarfBuzzFont::doLayout(const AbstractGlyphCache& cache, const Float size, const std::string& text) {
-    /* Prepare HarfBuzz buffer */
-    hb_buffer_t* const buffer = hb_buffer_create();
-    hb_buffer_set_direction(buffer, HB_DIRECTION_LTR);
-    hb_buffer_set_script(buffer, HB_SCRIPT_LATIN);
-    hb_buffer_set_language(buffer, hb_language_from_string("en", 2));
-
-    /* Layout the text */
-    hb_buffer_add_utf8(buffer, text.data(), text.size(), 0, -1);
-    hb_shape(hbFont, buffer, nullptr, 0);
+    const Containers::ArrayView<const ShapedGlyph> shaped = _shaper->shape(text);
 
-    UnsignedInt glyphCount;
-    hb_glyph_info_t* const glyphInfo = hb_buffer_get_glyph_infos(buffer, &glyphCount);
-    hb_glyph_position_t* const glyphPositions = hb_buffer_get_glyph_positions(buffer, &glyphCount);
+    /* The shaped glyphs are owned by the shaper, copy them for the layouter */
+    Containers::Array<ShapedGlyph> glyphs{NoInit, shaped.size()};
+    Utility::copy(shaped, glyphs);
+    return Containers::pointer(new HarfBuzzLayouter(cache, this->size(), size, Utility::move(glyphs)));
+}
 
-    return Containers::pointer(new HarfBuzzLayouter(cache, this->size(), size, buffer, glyphInfo, glyphPositions, glyphCount));
+std::size_t HarfBuzzFont::shape(const Containers::StringIterable& texts, const Containers::StridedArrayView1D<UnsignedInt>& glyphIds, const Containers::StridedArrayView1D<Vector2>& glyphOffsets, const Containers::StridedArrayView1D<Vector2>& glyphAdvances, const Containers::ArrayView<UnsignedInt>& textGlyphOffsets) {
+    CORRADE_ASSERT(isOpened(),
+        "Text::HarfBuzzFont::shape(): no font opened", {});
+    CORRADE_ASSERT(glyphOffsets.size() == glyphIds.size() && glyphAdvances.size() == glyphIds.size(),
+        "Text::HarfBuzzFont::shape(): expected glyph offset and advance views to have" << glyphIds.size() << "elements but got" << glyphOffsets.size() << "and" << glyphAdvances.size(), {});
+    CORRADE_ASSERT(textGlyphOffsets.size() == texts.size() + 1,
+        "Text::HarfBuzzFont::shape(): expected text glyph offset view to have" << texts.size() + 1 << "elements but got" << textGlyphOffsets.size(), {});
+
+    /* Put the glyphs of all texts one after another, stop if a text doesn't
+       fit anymore */
+    std::size_t offset = 0;
+    textGlyphOffsets[0] = 0;
+    for(std::size_t i = 0; i != texts.size(); ++i) {
+        const Containers::ArrayView<const ShapedGlyph> shaped = _shaper->shape(texts[i]);
+        if(offset + shaped.size() > glyphIds.size()) return i;
+
+        for(std::size_t j = 0; j != shaped.size(); ++j) {
+            glyphIds[offset + j] = shaped[j].id;
+            glyphOffsets[offset + j] = shaped[j].offset;
+            glyphAdvances[offset + j] = shaped[j].advance;
+        }
+
+        offset += shaped.size();
+        textGlyphOffsets[i + 1] = offset;
+    }
+
+    return texts.size();
 }
 
 namespace {
 
-HarfBuzzLayouter::HarfBuzzLayouter(const AbstractGlyphCache& cache, const Float fontSize, const Float textSize, hb_buffer_t* const buffer, hb_glyph_info_t* const glyphInfo, hb_glyph_position_t* const glyphPositions, const UnsignedInt glyphCount): AbstractLayouter(glyphCount), cache(cache), fontSize(fontSize), textSize(textSize), buffer(buffer), glyphInfo(glyphInfo), glyphPositions(glyphPositions) {}
-
-HarfBuzzLayouter::~HarfBuzzLayouter() {
-    /* Destroy HarfBuzz buffer */
-    hb_buffer_destroy(buffer);
-}
+HarfBuzzLayouter::HarfBuzzLayouter(const AbstractGlyphCache& cache, const Float fontSize, const Float textSize, Containers::Array<ShapedGlyph>&& glyphs): AbstractLayouter(glyphs.size()), cache(cache), fontSize(fontSize), textSize(textSize), glyphs(Utility::move(glyphs)) {}
 
 std::tuple<Range2D, Range2D, Vector2> HarfBuzzLayouter::doRenderGlyph(const UnsignedInt i) {
     /* Position of the texture in the resulting glyph, texture coordinates */
     Vector2i position;
     Range2Di rectangle;
-    std::tie(position, rectangle) = cache[glyphInfo[i].codepoint];
+    std::tie(position, rectangle) = cache[glyphs[i].id];
 
     /* Normalized texture coordinates */
     const auto textureCoordinates = Range2D(rectangle).scaled(1.0f/Vector2(cache.textureSize()));
 
-    /* Glyph offset in normalized coordinates */
-    const Vector2 offset = Vector2(glyphPositions[i].x_offset,
-                                   glyphPositions[i].y_offset)/64.0f;
-
     /* Quad rectangle, computed from glyph offset and texture rectangle,
        denormalized to requested text size */
     const auto quadRectangle = Range2D(Range2Di::fromSize(position, rectangle.size()))
-        .translated(offset).scaled(Vector2(textSize/fontSize));
+        .translated(glyphs[i].offset).scaled(Vector2(textSize/fontSize));
 
     /* Glyph advance, denormalized to requested text size */
-    const Vector2 advance = Vector2(glyphPositions[i].x_advance,
-                                    glyphPositions[i].y_advance)*(textSize/(64.0f*fontSize));
+    const Vector2 advance = glyphs[i].advance*(textSize/fontSize);
 
     return std::make_tuple(quadRectangle, textureCoordinates, advance);
 }
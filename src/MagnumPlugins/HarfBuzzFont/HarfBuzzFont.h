@@ -118,6 +118,38 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::HarfBuzzFont)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Text-HarfBuzzFont-behavior Behavior and limitations
+
+A single HarfBuzz buffer is reused for shaping in all @ref layout() and
+@ref shape() calls. The @ref shape() API additionally shapes many texts at
+once into caller-provided views, without allocating an
+@ref AbstractLayouter for each.
+Setting the @cb{.ini} shapeCacheSize @ce @ref Text-HarfBuzzFont-configuration "configuration option"
+to a non-zero value additionally keeps the given count of most recently
+shaped texts, so laying out the same text again, at any size, doesn't need
+to shape it again. The text is currently always shaped as left-to-right
+Latin text in English, so the text itself is the only cache key.
+
+Instances that open the same font data, at any size, share a single
+HarfBuzz face with the font tables and shape plans, each instance then has
+just its own font object scaled to its size. The sharing is process-wide and
+the face is freed when the last instance using it is closed. The HarfBuzz
+font uses HarfBuzz' own OpenType font functions, so glyph advances and
+offsets used for shaping are unhinted.
+
+Glyph cache filling is implemented in @ref FreeTypeFont, see its
+@ref Text-FreeTypeFont-behavior "behavior documentation" for details.
+
+@section Text-HarfBuzzFont-configuration Plugin-specific configuration
+
+It's possible to tune various options through @ref configuration(). See below
+for all options and their default values:
+
+@snippet MagnumPlugins/HarfBuzzFont/HarfBuzzFont.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_HARFBUZZFONT_EXPORT HarfBuzzFont: public FreeTypeFont {
     public:
@@ -145,6 +177,42 @@ class MAGNUM_HARFBUZZFONT_EXPORT HarfBuzzFont: public FreeTypeFont {
 
         ~HarfBuzzFont();
 
+        /**
+         * @brief Shape multiple texts at once
+         * @param[in] texts             Texts to shape
+         * @param[out] glyphIds         Where to put glyph IDs
+         * @param[out] glyphOffsets     Where to put glyph offsets relative to
+         *      the cursor position
+         * @param[out] glyphAdvances    Where to put glyph advances
+         * @param[out] textGlyphOffsets Where to put offset of the first glyph
+         *      of each text. Expected to have a size of @cpp texts.size() + 1 @ce,
+         *      the last item is the total glyph count.
+         * @return Count of texts that were shaped
+         *
+         * Shapes the texts one after another into consecutive ranges of
+         * @p glyphIds, @p glyphOffsets and @p glyphAdvances, which are
+         * expected to have the same size. Glyphs of text @cpp i @ce are in
+         * the range given by @cpp textGlyphOffsets[i] @ce and
+         * @cpp textGlyphOffsets[i + 1] @ce. Offsets and advances are in
+         * pixels at the font @ref size(), scale them by the ratio of the
+         * desired text size and the font size to get the same values as
+         * @ref layout() does.
+         *
+         * Compared to @ref layout() no @ref AbstractLayouter is allocated
+         * for each text, and the same HarfBuzz buffer and shaped text cache,
+         * if enabled, are used. If the glyph views don't have enough space
+         * for all glyphs of a particular text, shaping stops there and the
+         * count of texts shaped until then is returned. Only the first
+         * @cpp return + 1 @ce items of @p textGlyphOffsets are written in
+         * that case. Expects that a font is opened.
+         *
+         * The function is virtual so it can be called on a plugin instance
+         * loaded through a plugin manager without linking to the plugin
+         * library, after casting the @ref AbstractFont pointer to
+         * @ref HarfBuzzFont.
+         */
+        virtual std::size_t shape(const Containers::StringIterable& texts, const Containers::StridedArrayView1D<UnsignedInt>& glyphIds, const Containers::StridedArrayView1D<Vector2>& glyphOffsets, const Containers::StridedArrayView1D<Vector2>& glyphAdvances, const Containers::ArrayView<UnsignedInt>& textGlyphOffsets);
+
     private:
         MAGNUM_HARFBUZZFONT_LOCAL FontFeatures doFeatures() const override;
         MAGNUM_HARFBUZZFONT_LOCAL bool doIsOpened() const override;
@@ -152,7 +220,10 @@ class MAGNUM_HARFBUZZFONT_EXPORT HarfBuzzFont: public FreeTypeFont {
         MAGNUM_HARFBUZZFONT_LOCAL void doClose() override;
         MAGNUM_HARFBUZZFONT_LOCAL Containers::Pointer<AbstractLayouter> doLayout(const AbstractGlyphCache& cache, Float size, const std::string& text) override;
 
+        struct Shaper;
+
         hb_font_t* hbFont;
+        Containers::Pointer<Shaper> _shaper;
 };
 
 }}
@@ -23,13 +23,22 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <sstream>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringIterable.h>
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/PluginManager/Manager.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Magnum/Text/AbstractFont.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
 #include <hb.h>
 
+#include "MagnumPlugins/HarfBuzzFont/HarfBuzzFont.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Text { namespace Test { namespace {
@@ -38,13 +47,27 @@ struct HarfBuzzFontTest: TestSuite::Tester {
     explicit HarfBuzzFontTest();
 
     void layout();
+    void layoutShapeCache();
+
+    void shape();
+    void shapeNotEnoughSpace();
+    void shapeInvalidSize();
+
+    void sharedFace();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractFont> _manager{"nonexistent"};
 };
 
 HarfBuzzFontTest::HarfBuzzFontTest() {
-    addTests({&HarfBuzzFontTest::layout});
+    addTests({&HarfBuzzFontTest::layout,
+              &HarfBuzzFontTest::layoutShapeCache,
+
+              &HarfBuzzFontTest::shape,
+              &HarfBuzzFontTest::shapeNotEnoughSpace,
+              &HarfBuzzFontTest::shapeInvalidSize,
+
+              &HarfBuzzFontTest::sharedFace});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -110,6 +133,181 @@ void HarfBuzzFontTest::layout() {
     CORRADE_COMPARE(cursorPosition, Vector2(0.260742f, 0.0f));
 }
 
+void HarfBuzzFontTest::layoutShapeCache() {
+    Containers::Pointer<AbstractFont> reference = _manager.instantiate("HarfBuzzFont");
+    CORRADE_VERIFY(reference->openFile(TTF_FILE, 16.0f));
+
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("HarfBuzzFont");
+    font->configuration().setValue("shapeCacheSize", 2);
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    struct: AbstractGlyphCache {
+        using AbstractGlyphCache::AbstractGlyphCache;
+
+        GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{Vector2i{256}};
+    cache.insert(font->glyphId(U'W'), {25, 34}, {{0, 8}, {16, 128}});
+    cache.insert(font->glyphId(U'e'), {25, 12}, {{16, 4}, {64, 32}});
+
+    /* Repeated texts, texts at different sizes and texts that got evicted
+       from the cache should all give the same output as without the cache */
+    const struct {
+        const char* text;
+        Float size;
+    } layouts[]{
+        {"Wave", 0.5f},
+        {"Wave", 0.5f},
+        {"Wave", 2.0f},
+        {"eW", 1.0f},
+        {"We", 1.0f},
+        {"Wave", 0.5f},
+        {"", 1.0f},
+        {"We", 1.0f},
+    };
+    for(std::size_t i = 0; i != Containers::arraySize(layouts); ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Pointer<AbstractLayouter> expected = reference->layout(cache, layouts[i].size, layouts[i].text);
+        Containers::Pointer<AbstractLayouter> actual = font->layout(cache, layouts[i].size, layouts[i].text);
+        CORRADE_VERIFY(expected);
+        CORRADE_VERIFY(actual);
+        CORRADE_COMPARE(actual->glyphCount(), expected->glyphCount());
+
+        for(UnsignedInt j = 0; j != actual->glyphCount(); ++j) {
+            CORRADE_ITERATION(j);
+            Vector2 expectedCursorPosition, actualCursorPosition;
+            Range2D expectedRectangle, actualRectangle;
+            Range2D expectedPosition, actualPosition, expectedTextureCoordinates, actualTextureCoordinates;
+            std::tie(expectedPosition, expectedTextureCoordinates) = expected->renderGlyph(j, expectedCursorPosition, expectedRectangle);
+            std::tie(actualPosition, actualTextureCoordinates) = actual->renderGlyph(j, actualCursorPosition, actualRectangle);
+            CORRADE_COMPARE(actualPosition, expectedPosition);
+            CORRADE_COMPARE(actualTextureCoordinates, expectedTextureCoordinates);
+            CORRADE_COMPARE(actualCursorPosition, expectedCursorPosition);
+        }
+    }
+}
+
+void HarfBuzzFontTest::shape() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("HarfBuzzFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    UnsignedInt glyphIds[8];
+    Vector2 glyphOffsets[8];
+    Vector2 glyphAdvances[8];
+    UnsignedInt textGlyphOffsets[4];
+    CORRADE_COMPARE(static_cast<HarfBuzzFont&>(*font).shape({"Wave", "", "eW"}, glyphIds, glyphOffsets, glyphAdvances, textGlyphOffsets), 3);
+    CORRADE_COMPARE_AS(Containers::arrayView(textGlyphOffsets),
+        Containers::arrayView<UnsignedInt>({0, 4, 4, 6}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(Containers::arrayView(glyphIds).prefix(6),
+        Containers::arrayView({
+            font->glyphId(U'W'),
+            font->glyphId(U'a'),
+            font->glyphId(U'v'),
+            font->glyphId(U'e'),
+            font->glyphId(U'e'),
+            font->glyphId(U'W')
+        }), TestSuite::Compare::Container);
+
+    /* Advances should match what layout() gives, scaled by the ratio of the
+       text and font size */
+    struct: AbstractGlyphCache {
+        using AbstractGlyphCache::AbstractGlyphCache;
+
+        GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{Vector2i{256}};
+    Containers::Pointer<AbstractLayouter> layouter = font->layout(cache, 16.0f, "Wave");
+    for(UnsignedInt i = 0; i != 4; ++i) {
+        CORRADE_ITERATION(i);
+        Vector2 cursorPosition;
+        Range2D rectangle;
+        layouter->renderGlyph(i, cursorPosition, rectangle);
+        CORRADE_COMPARE(glyphAdvances[i], cursorPosition);
+        CORRADE_COMPARE(glyphOffsets[i], Vector2{});
+    }
+}
+
+void HarfBuzzFontTest::shapeNotEnoughSpace() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("HarfBuzzFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    /* The second text doesn't fit anymore, so only the first is shaped */
+    UnsignedInt glyphIds[5];
+    Vector2 glyphOffsets[5];
+    Vector2 glyphAdvances[5];
+    UnsignedInt textGlyphOffsets[4]{};
+    CORRADE_COMPARE(static_cast<HarfBuzzFont&>(*font).shape({"Wave", "eW", "W"}, glyphIds, glyphOffsets, glyphAdvances, textGlyphOffsets), 1);
+    CORRADE_COMPARE(textGlyphOffsets[0], 0);
+    CORRADE_COMPARE(textGlyphOffsets[1], 4);
+}
+
+void HarfBuzzFontTest::shapeInvalidSize() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("HarfBuzzFont");
+    HarfBuzzFont& harfBuzzFont = static_cast<HarfBuzzFont&>(*font);
+
+    UnsignedInt glyphIds[4];
+    Vector2 glyphOffsets[4];
+    Vector2 glyphOffsetsInvalid[3];
+    Vector2 glyphAdvances[4];
+    UnsignedInt textGlyphOffsets[3];
+    UnsignedInt textGlyphOffsetsInvalid[2];
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    harfBuzzFont.shape({"W", "e"}, glyphIds, glyphOffsets, glyphAdvances, textGlyphOffsets);
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+    harfBuzzFont.shape({"W", "e"}, glyphIds, glyphOffsetsInvalid, glyphAdvances, textGlyphOffsets);
+    harfBuzzFont.shape({"W", "e"}, glyphIds, glyphOffsets, glyphAdvances, textGlyphOffsetsInvalid);
+    CORRADE_COMPARE(out.str(),
+        "Text::HarfBuzzFont::shape(): no font opened\n"
+        "Text::HarfBuzzFont::shape(): expected glyph offset and advance views to have 4 elements but got 3 and 4\n"
+        "Text::HarfBuzzFont::shape(): expected text glyph offset view to have 3 elements but got 2\n");
+}
+
+void HarfBuzzFontTest::sharedFace() {
+    /* Fonts opened from the same file at different sizes share the HarfBuzz
+       face, but each has its own scale */
+    Containers::Pointer<AbstractFont> small = _manager.instantiate("HarfBuzzFont");
+    Containers::Pointer<AbstractFont> large = _manager.instantiate("HarfBuzzFont");
+    Containers::Pointer<AbstractFont> smallAgain = _manager.instantiate("HarfBuzzFont");
+    CORRADE_VERIFY(small->openFile(TTF_FILE, 16.0f));
+    CORRADE_VERIFY(large->openFile(TTF_FILE, 32.0f));
+
+    UnsignedInt glyphIds[4];
+    Vector2 glyphOffsets[4];
+    Vector2 smallAdvances[4], largeAdvances[4], smallAgainAdvances[4];
+    UnsignedInt textGlyphOffsets[2];
+    CORRADE_COMPARE(static_cast<HarfBuzzFont&>(*small).shape({"Wave"}, glyphIds, glyphOffsets, smallAdvances, textGlyphOffsets), 1);
+    CORRADE_COMPARE(static_cast<HarfBuzzFont&>(*large).shape({"Wave"}, glyphIds, glyphOffsets, largeAdvances, textGlyphOffsets), 1);
+    for(std::size_t i = 0; i != 4; ++i) {
+        CORRADE_ITERATION(i);
+        /* Both are rounded to 1/64 of a pixel */
+        CORRADE_COMPARE_WITH(largeAdvances[i].x(), smallAdvances[i].x()*2.0f,
+            TestSuite::Compare::around(1.0f/32.0f));
+        CORRADE_COMPARE(largeAdvances[i].y(), 0.0f);
+    }
+
+    /* Closing one of the fonts doesn't affect the others, and opening the
+       same file again gives the same output */
+    small->close();
+    CORRADE_VERIFY(smallAgain->openFile(TTF_FILE, 16.0f));
+    CORRADE_COMPARE(static_cast<HarfBuzzFont&>(*smallAgain).shape({"Wave"}, glyphIds, glyphOffsets, smallAgainAdvances, textGlyphOffsets), 1);
+    CORRADE_COMPARE_AS(Containers::arrayView(smallAgainAdvances),
+        Containers::arrayView(smallAdvances),
+        TestSuite::Compare::Container);
+
+    large->close();
+    smallAgain->close();
+    CORRADE_VERIFY(small->openFile(TTF_FILE, 16.0f));
+    CORRADE_COMPARE(static_cast<HarfBuzzFont&>(*small).shape({"Wave"}, glyphIds, glyphOffsets, smallAgainAdvances, textGlyphOffsets), 1);
+    CORRADE_COMPARE_AS(Containers::arrayView(smallAgainAdvances),
+        Containers::arrayView(smallAdvances),
+        TestSuite::Compare::Container);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Text::Test::HarfBuzzFontTest)
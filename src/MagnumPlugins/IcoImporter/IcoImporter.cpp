@@ -26,13 +26,17 @@
 
 #include "IcoImporter.h"
 
+#include <cstring>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/Endianness.h>
+#include <Magnum/Math/Vector2.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
 namespace Magnum { namespace Trade {
 
 namespace {
@@ -64,9 +68,12 @@ struct IconDirEntry {
 }
 
 struct IcoImporter::State {
-    Containers::Pointer<Trade::AbstractImporter> pngImporter;
     Containers::Array<char> data;
     Containers::Array<Containers::ArrayView<const char>> levels;
+    Containers::Array<Vector2i> levelSizes;
+    /* Level currently opened in the PNG importer, to avoid opening it again
+       if the same level is imported multiple times */
+    UnsignedInt openedLevel = ~UnsignedInt{};
 };
 
 IcoImporter::IcoImporter() = default;
@@ -79,7 +86,13 @@ ImporterFeatures IcoImporter::doFeatures() const { return ImporterFeature::OpenD
 
 bool IcoImporter::doIsOpened() const { return !!_state; }
 
-void IcoImporter::doClose() { _state = nullptr; }
+void IcoImporter::doClose() {
+    /* The PNG importer references the data, close it first. It's kept around
+       so opening thousands of files doesn't load and instantiate it again for
+       every one of them */
+    if(_pngImporter) _pngImporter->close();
+    _state = nullptr;
+}
 
 namespace {
     constexpr const char PngHeader[] {
@@ -88,6 +101,7 @@ namespace {
 }
 
 void IcoImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     if(data.size() < sizeof(IconDir)) {
         Error{} << "Trade::IcoImporter::openData(): file header too short, expected at least" << sizeof(IconDir) << "bytes but got" << data.size();
         return;
@@ -98,6 +112,7 @@ void IcoImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
 
     Containers::Pointer<State> state{InPlaceInit};
     state->levels = Containers::Array<Containers::ArrayView<const char>>{header.imageCount};
+    state->levelSizes = Containers::Array<Vector2i>{NoInit, header.imageCount};
 
     /* Take over the existing array or copy the data if we can't */
     if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
@@ -127,37 +142,71 @@ void IcoImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
             return;
         }
 
-        state->levels[i] = state->data.slice(iconDirEntry.imageDataOffset, iconDirEntry.imageDataOffset + iconDirEntry.imageDataSize);
+        const Containers::ArrayView<const char> level = state->data.slice(iconDirEntry.imageDataOffset, iconDirEntry.imageDataOffset + iconDirEntry.imageDataSize);
+        state->levels[i] = level;
+
+        /* Remember the level size so it can be queried without decoding. The
+           directory entry can express sizes only up to 256, so for embedded
+           PNGs take it from the IHDR chunk, which is always first, if it's
+           there. Width and height of 0 in the entry mean 256. */
+        if(level.size() >= 24 && std::memcmp(level.data(), PngHeader, sizeof(PngHeader)) == 0 && std::memcmp(level.data() + 12, "IHDR", 4) == 0) {
+            UnsignedInt ihdr[2];
+            std::memcpy(ihdr, level.data() + 16, sizeof(ihdr));
+            Utility::Endianness::bigEndianInPlace(ihdr[0], ihdr[1]);
+            state->levelSizes[i] = {Int(ihdr[0]), Int(ihdr[1])};
+        } else state->levelSizes[i] = {
+            iconDirEntry.imageWidth ? iconDirEntry.imageWidth : 256,
+            iconDirEntry.imageHeight ? iconDirEntry.imageHeight : 256
+        };
     }
 
     /* All good, save the state */
     _state = Utility::move(state);
 }
 
+Vector2i IcoImporter::image2DLevelSize(const UnsignedInt level) const {
+    CORRADE_ASSERT(_state,
+        "Trade::IcoImporter::image2DLevelSize(): no file opened", {});
+    CORRADE_ASSERT(level < _state->levelSizes.size(),
+        "Trade::IcoImporter::image2DLevelSize(): level" << level << "out of range for" << _state->levelSizes.size() << "entries", {});
+    return _state->levelSizes[level];
+}
+
 UnsignedInt IcoImporter::doImage2DCount() const { return 1; }
 
 UnsignedInt IcoImporter::doImage2DLevelCount(UnsignedInt) { return _state->levels.size(); }
 
 Containers::Optional<ImageData2D> IcoImporter::doImage2D(UnsignedInt, UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D"};
     if(_state->levels[level].size() < sizeof(PngHeader) || std::memcmp(_state->levels[level].data(), PngHeader, sizeof(PngHeader)) != 0) {
         Error{} << "Trade::IcoImporter::image2D(): only files with embedded PNGs are supported";
         return Containers::NullOpt;
     }
 
     /* just delegate actual image importing */
-    if(!_state->pngImporter && !(_state->pngImporter = manager()->loadAndInstantiate("PngImporter"))) {
+    if(!_pngImporter && !(_pngImporter = manager()->loadAndInstantiate("PngImporter"))) {
         Error{} << "Trade::IcoImporter::image2D(): PngImporter is not available";
         return Containers::NullOpt;
     }
 
-    /* Note: this is uncovered by the tests because neither StbImageImporter
-       nor PngImporter / DevIlImageImporter do any checks apart that could be
-       triggered here. In the best case openData() checks PNG header, but that
-       we do above already, so it can't be hit again here. */
-    if(!_state->pngImporter->openData(_state->levels[level]))
-        return Containers::NullOpt;
+    /* The level data are owned by us for as long as the file is opened, so
+       there's no need for the PNG importer to make a copy. If the same level
+       is imported again, it's still opened from the last time. */
+    if(_state->openedLevel != level || !_pngImporter->isOpened()) {
+        _state->openedLevel = ~UnsignedInt{};
+
+        /* Note: this is uncovered by the tests because neither
+           StbImageImporter nor PngImporter / DevIlImageImporter do any checks
+           apart that could be triggered here. In the best case openData()
+           checks PNG header, but that we do above already, so it can't be hit
+           again here. */
+        if(!_pngImporter->openMemory(_state->levels[level]))
+            return Containers::NullOpt;
+
+        _state->openedLevel = level;
+    }
 
-    return _state->pngImporter->image2D(0);
+    return _pngImporter->image2D(0);
 }
 
 }}
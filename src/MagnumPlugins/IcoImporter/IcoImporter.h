@@ -109,6 +109,29 @@ Currently, only embedded PNGs are supported --- for them it will delegate
 loading to any plugin that provides `PngImporter`; for images that are BMPs,
 @ref image2D() will fail. You can use @ref DevIlImageImporter in that case
 instead, but please @ref Trade-DevIlImageImporter-behavior-ico "be aware of its limitations".
+
+The images are decoded only when requested through @ref image2D(), opening
+the file only parses the icon directory. The delegated `PngImporter` is
+instantiated on first use and then kept across all levels and opened files
+for the lifetime of the importer. Size of each level can be queried without
+decoding through @ref image2DLevelSize(), which is useful for example when
+picking just the largest icon out of many files:
+
+@code{.cpp}
+Trade::IcoImporter importer{manager, "IcoImporter"};
+if(!importer.openFile("favicon.ico"))
+    return;
+
+UnsignedInt largest = 0;
+for(UnsignedInt i = 1; i != importer.image2DLevelCount(0); ++i)
+    if(importer.image2DLevelSize(i).product() > importer.image2DLevelSize(largest).product())
+        largest = i;
+
+Containers::Optional<Trade::ImageData2D> image = importer.image2D(0, largest);
+@endcode
+
+Note that this is a plugin-specific API and thus available only if the plugin
+is linked and used directly, not through the @ref AbstractImporter interface.
 */
 class MAGNUM_ICOIMPORTER_EXPORT IcoImporter: public AbstractImporter {
     public:
@@ -120,6 +143,17 @@ class MAGNUM_ICOIMPORTER_EXPORT IcoImporter: public AbstractImporter {
 
         ~IcoImporter();
 
+        /**
+         * @brief Image level size
+         * @m_since_latest_{plugins}
+         *
+         * Returns size of given level in the opened file, without decoding
+         * it. For embedded PNGs the size is taken from the PNG header, for
+         * other images from the icon directory entry. Expects that a file is
+         * opened and @p level is less than @ref image2DLevelCount().
+         */
+        Vector2i image2DLevelSize(UnsignedInt level) const;
+
     private:
         MAGNUM_ICOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_ICOIMPORTER_LOCAL bool doIsOpened() const override;
@@ -132,6 +166,9 @@ class MAGNUM_ICOIMPORTER_EXPORT IcoImporter: public AbstractImporter {
 
         struct State;
         Containers::Pointer<State> _state;
+        /* Declared after the state so it gets destroyed first, as it
+           references the state data */
+        Containers::Pointer<AbstractImporter> _pngImporter;
 };
 
 }}
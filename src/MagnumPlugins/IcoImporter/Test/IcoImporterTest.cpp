@@ -42,6 +42,10 @@
 
 #include "configure.h"
 
+#ifndef ICOIMPORTER_PLUGIN_FILENAME
+#include "MagnumPlugins/IcoImporter/IcoImporter.h"
+#endif
+
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
 struct IcoImporterTest: TestSuite::Tester {
@@ -57,6 +61,10 @@ struct IcoImporterTest: TestSuite::Tester {
     void openMemory();
     void openTwice();
     void importTwice();
+    void importLevelsInterleaved();
+    void importDifferentFiles();
+
+    void levelSize();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
@@ -105,7 +113,11 @@ IcoImporterTest::IcoImporterTest() {
         Containers::arraySize(OpenMemoryData));
 
     addTests({&IcoImporterTest::openTwice,
-              &IcoImporterTest::importTwice});
+              &IcoImporterTest::importTwice,
+              &IcoImporterTest::importLevelsInterleaved,
+              &IcoImporterTest::importDifferentFiles,
+
+              &IcoImporterTest::levelSize});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -278,6 +290,74 @@ void IcoImporterTest::importTwice() {
     }
 }
 
+void IcoImporterTest::importLevelsInterleaved() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("IcoImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ICOIMPORTER_TEST_DIR, "pngs.ico")));
+
+    /* The delegated importer has the last imported level opened, verify
+       that switching back and forth picks the right one each time */
+    const Vector2i sizes[]{{16, 8}, {256, 256}, {32, 64}};
+    for(UnsignedInt level: {2, 0, 0, 2, 1}) {
+        CORRADE_ITERATION(level);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, level);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), sizes[level]);
+    }
+}
+
+void IcoImporterTest::importDifferentFiles() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("IcoImporter");
+
+    /* The delegated importer is kept across files, verify it doesn't import
+       stale data from the previous file if the level index is the same */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ICOIMPORTER_TEST_DIR, "pngs.ico")));
+    {
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 1);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), (Vector2i{256}));
+        CORRADE_COMPARE(image->pixels<Color3ub>()[0][0], 0x0000ff_rgb);
+    }
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ICOIMPORTER_TEST_DIR, "bmp+png.ico")));
+    {
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 1);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), (Vector2i{256}));
+        CORRADE_COMPARE(image->pixels<Color3ub>()[0][0], 0x0000ff_rgb);
+    }
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ICOIMPORTER_TEST_DIR, "pngs.ico")));
+    {
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 1);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), (Vector2i{256}));
+        CORRADE_COMPARE(image->pixels<Color3ub>()[0][0], 0x0000ff_rgb);
+    }
+}
+
+void IcoImporterTest::levelSize() {
+    #ifdef ICOIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    IcoImporter importer{_manager, "IcoImporter"};
+
+    /* Level sizes are available without ever touching the PNG importer, so
+       this doesn't need it to be present */
+    CORRADE_VERIFY(importer.openFile(Utility::Path::join(ICOIMPORTER_TEST_DIR, "pngs.ico")));
+    CORRADE_COMPARE(importer.image2DLevelCount(0), 3);
+    CORRADE_COMPARE(importer.image2DLevelSize(0), (Vector2i{16, 8}));
+    CORRADE_COMPARE(importer.image2DLevelSize(1), Vector2i{256});
+    CORRADE_COMPARE(importer.image2DLevelSize(2), (Vector2i{32, 64}));
+
+    /* The BMP size is taken from the directory entry, the 256x256 PNG is
+       stored as 0 there */
+    CORRADE_VERIFY(importer.openFile(Utility::Path::join(ICOIMPORTER_TEST_DIR, "bmp+png.ico")));
+    CORRADE_COMPARE(importer.image2DLevelCount(0), 2);
+    CORRADE_COMPARE(importer.image2DLevelSize(0), (Vector2i{16, 8}));
+    CORRADE_COMPARE(importer.image2DLevelSize(1), Vector2i{256});
+    #endif
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::IcoImporterTest)
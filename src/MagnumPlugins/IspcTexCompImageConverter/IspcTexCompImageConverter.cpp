@@ -0,0 +1,257 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "IspcTexCompImageConverter.h"
+
+#include <cstring>
+#include <thread>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "Magnum/Implementation/instrumentation.h"
+
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <atomic>
+#endif
+
+#include <ispc_texcomp.h>
+
+namespace Magnum { namespace Trade {
+
+IspcTexCompImageConverter::IspcTexCompImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImageConverter{manager, plugin} {}
+
+ImageConverterFeatures IspcTexCompImageConverter::doFeatures() const {
+    return ImageConverterFeature::Convert2D|ImageConverterFeature::Convert3D;
+}
+
+namespace {
+
+const struct {
+    const char* name;
+    void(*opaque)(bc7_enc_settings*);
+    void(*alpha)(bc7_enc_settings*);
+} Bc7Profiles[]{
+    {"ultrafast", GetProfile_ultrafast, GetProfile_alpha_ultrafast},
+    {"veryfast", GetProfile_veryfast, GetProfile_alpha_veryfast},
+    {"fast", GetProfile_fast, GetProfile_alpha_fast},
+    {"basic", GetProfile_basic, GetProfile_alpha_basic},
+    {"slow", GetProfile_slow, GetProfile_alpha_slow},
+};
+
+const struct {
+    const char* name;
+    void(*profile)(bc6h_enc_settings*);
+} Bc6hProfiles[]{
+    {"veryfast", GetProfile_bc6h_veryfast},
+    {"fast", GetProfile_bc6h_fast},
+    {"basic", GetProfile_bc6h_basic},
+    {"slow", GetProfile_bc6h_slow},
+    {"veryslow", GetProfile_bc6h_veryslow},
+};
+
+Containers::Optional<ImageData3D> convertInternal(const ImageView3D& image, Utility::ConfigurationGroup& configuration) {
+    /* Decide on the output format */
+    CompressedPixelFormat outputFormat;
+    switch(image.format()) {
+        case PixelFormat::RGB8Unorm:
+        case PixelFormat::RGBA8Unorm:
+            outputFormat = CompressedPixelFormat::Bc7RGBAUnorm;
+            break;
+        case PixelFormat::RGB8Srgb:
+        case PixelFormat::RGBA8Srgb:
+            outputFormat = CompressedPixelFormat::Bc7RGBASrgb;
+            break;
+        case PixelFormat::RGB16F:
+        case PixelFormat::RGBA16F:
+            outputFormat = CompressedPixelFormat::Bc6hRGBUfloat;
+            break;
+        default:
+            Error{} << "Trade::IspcTexCompImageConverter::convert(): unsupported format" << image.format();
+            return {};
+    }
+    const bool bc6h = outputFormat == CompressedPixelFormat::Bc6hRGBUfloat;
+    const UnsignedInt inputChannelCount = pixelFormatChannelCount(image.format());
+
+    /* Pick the quality profile. Only one of the settings is used, both are
+       zero-initialized to avoid maybe-uninitialized warnings. */
+    const Containers::StringView quality = configuration.value<Containers::StringView>("quality");
+    bc7_enc_settings bc7Settings{};
+    bc6h_enc_settings bc6hSettings{};
+    bool found = false;
+    if(bc6h) {
+        for(const auto& profile: Bc6hProfiles) {
+            if(quality != profile.name) continue;
+            profile.profile(&bc6hSettings);
+            found = true;
+            break;
+        }
+    } else {
+        /* If the alpha option is set, override the default. Input channel
+           count stays the same, of course. */
+        bool alpha = inputChannelCount == 4;
+        if(configuration.value<Containers::StringView>("alpha"))
+            alpha = configuration.value<bool>("alpha");
+
+        for(const auto& profile: Bc7Profiles) {
+            if(quality != profile.name) continue;
+            (alpha ? profile.alpha : profile.opaque)(&bc7Settings);
+            found = true;
+            break;
+        }
+    }
+    if(!found) {
+        Error{} << "Trade::IspcTexCompImageConverter::convert(): unsupported quality preset" << quality << "for" << outputFormat;
+        return {};
+    }
+
+    if(!(image.size().xy() % 4).isZero()) {
+        Error{} << "Trade::IspcTexCompImageConverter::convert(): expected size to be divisible by 4, got" << image.size().xy();
+        return {};
+    }
+
+    const Containers::StridedArrayView4D<const char> input = image.pixels();
+
+    /* Both BC6H and BC7 have 128-bit blocks, i.e. one byte per pixel */
+    /** @todo use blocks() once the compressed image APIs are done */
+    Containers::Array<char> outputData{NoInit, std::size_t(image.size().product())};
+
+    /* The library expects four-channel input, with 8-bit channels for BC7 and
+       half-float channels for BC6H */
+    const std::size_t channelSize = bc6h ? 2 : 1;
+    const std::size_t rgbaPixelSize = channelSize*4;
+
+    /* Each row of blocks is independent, so the rows can be compressed on
+       multiple threads, each picking the next uncompressed one */
+    const std::size_t width = input.size()[2];
+    const std::size_t blockRowsPerLayer = input.size()[1]/4;
+    const std::size_t blockRowCount = input.size()[0]*blockRowsPerLayer;
+    const std::size_t blockRowSize = width/4*16;
+    std::size_t threadCount = 1;
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    threadCount = configuration.value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = Math::max(Math::min(threadCount, blockRowCount), std::size_t{1});
+    std::atomic<std::size_t> next{0};
+    #else
+    std::size_t next = 0;
+    #endif
+    const auto compress = [&]() {
+        /* The library takes the settings through a mutable pointer, give each
+           thread its own copy */
+        bc7_enc_settings threadBc7Settings = bc7Settings;
+        bc6h_enc_settings threadBc6hSettings = bc6hSettings;
+
+        /* Four-channel input is passed to the library directly. Three-channel
+           input gets expanded to a row of RGBA blocks, with alpha set to 255
+           or to 1.0 in half-floats. */
+        Containers::Array<char> expanded;
+        if(inputChannelCount == 3) {
+            expanded = Containers::Array<char>{NoInit, 4*width*rgbaPixelSize};
+            const UnsignedShort halfOne = 0x3c00;
+            for(std::size_t i = 0; i != expanded.size(); i += rgbaPixelSize) {
+                if(bc6h)
+                    std::memcpy(expanded.data() + i + 3*channelSize, &halfOne, 2);
+                else
+                    expanded[i + 3] = '\xff';
+            }
+        }
+
+        for(std::size_t i; (i = next++) < blockRowCount; ) {
+            const std::size_t z = i/blockRowsPerLayer;
+            const std::size_t y = i % blockRowsPerLayer;
+            const Containers::StridedArrayView3D<const char> inputLayer = input[z];
+
+            rgba_surface surface;
+            surface.width = width;
+            surface.height = 4;
+            if(inputChannelCount == 4) {
+                /* The API isn't const-correct, but it doesn't write to the
+                   input */
+                surface.ptr = reinterpret_cast<uint8_t*>(const_cast<char*>(&inputLayer[4*y][0][0]));
+                surface.stride = inputLayer.stride()[0];
+            } else {
+                for(std::size_t row = 0; row != 4; ++row) {
+                    for(std::size_t x = 0; x != width; ++x)
+                        std::memcpy(expanded.data() + (row*width + x)*rgbaPixelSize, &inputLayer[4*y + row][x][0], 3*channelSize);
+                }
+                surface.ptr = reinterpret_cast<uint8_t*>(expanded.data());
+                surface.stride = width*rgbaPixelSize;
+            }
+
+            uint8_t* const output = reinterpret_cast<uint8_t*>(outputData.data() + i*blockRowSize);
+            if(bc6h)
+                CompressBlocksBC6H(&surface, output, &threadBc6hSettings);
+            else
+                CompressBlocksBC7(&surface, output, &threadBc7Settings);
+        }
+    };
+
+    /* The calling thread is one of the workers */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{compress};
+    compress();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    compress();
+    #endif
+
+    return ImageData3D{outputFormat, image.size(), Utility::move(outputData), image.flags()};
+}
+
+}
+
+Containers::Optional<ImageData2D> IspcTexCompImageConverter::doConvert(const ImageView2D& image) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvert"};
+    if(image.flags() & ImageFlag2D::Array) {
+        Error{} << "Trade::IspcTexCompImageConverter::convert(): 1D array images are not supported";
+        return {};
+    }
+
+    Containers::Optional<ImageData3D> out = convertInternal(image, configuration());
+    if(!out) return {};
+
+    CORRADE_INTERNAL_ASSERT(out->size().z() == 1);
+    const Vector2i size = out->size().xy();
+    return ImageData2D{out->compressedFormat(), size, out->release(), image.flags()};
+}
+
+Containers::Optional<ImageData3D> IspcTexCompImageConverter::doConvert(const ImageView3D& image) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvert"};
+    return convertInternal(image, configuration());
+}
+
+}}
+
+CORRADE_PLUGIN_REGISTER(IspcTexCompImageConverter, Magnum::Trade::IspcTexCompImageConverter,
+    MAGNUM_TRADE_ABSTRACTIMAGECONVERTER_PLUGIN_INTERFACE)
@@ -0,0 +1,387 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/DebugTools/CompareImage.h>
+#include <Magnum/Math/Half.h>
+#include <Magnum/Math/Vector4.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct IspcTexCompImageConverterTest: TestSuite::Tester {
+    explicit IspcTexCompImageConverterTest();
+
+    void unsupportedFormat();
+    void unsupportedSize();
+    void unsupportedQuality();
+    void emptyImage();
+    void array1D();
+
+    void bc7();
+    void bc6h();
+    void threeDimensions();
+    void threads();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
+    PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
+};
+
+const struct {
+    const char* name;
+    PixelFormat format;
+    const char* quality;
+    const char* message;
+} UnsupportedQualityData[] {
+    {"BC7, BC6H-only preset", PixelFormat::RGBA8Unorm, "veryslow",
+        "unsupported quality preset veryslow for CompressedPixelFormat::Bc7RGBAUnorm"},
+    {"BC6H, BC7-only preset", PixelFormat::RGBA16F, "ultrafast",
+        "unsupported quality preset ultrafast for CompressedPixelFormat::Bc6hRGBUfloat"},
+    {"unknown preset", PixelFormat::RGB8Srgb, "best",
+        "unsupported quality preset best for CompressedPixelFormat::Bc7RGBASrgb"},
+};
+
+const struct {
+    const char* name;
+    Int channelCount;
+    Containers::Optional<bool> alpha;
+    const char* quality;
+    Containers::Optional<PixelFormat> overrideInputFormat;
+    ImageFlags2D flags;
+    CompressedPixelFormat expectedFormat;
+    Float maxThreshold, meanThreshold;
+} Bc7Data[] {
+    {"RGBA", 4, {}, nullptr, {}, {},
+        CompressedPixelFormat::Bc7RGBAUnorm, 40.0f, 1.5f},
+    {"RGBA, sRGB", 4, {}, nullptr, PixelFormat::RGBA8Srgb, {},
+        CompressedPixelFormat::Bc7RGBASrgb, 40.0f, 1.5f},
+    {"RGBA, alpha disabled", 4, false, nullptr, {}, {},
+        CompressedPixelFormat::Bc7RGBAUnorm, 40.0f, 1.5f},
+    {"RGBA, ultrafast", 4, {}, "ultrafast", {}, {},
+        CompressedPixelFormat::Bc7RGBAUnorm, 64.0f, 2.5f},
+    {"RGBA, slow", 4, {}, "slow", {}, {},
+        CompressedPixelFormat::Bc7RGBAUnorm, 40.0f, 1.5f},
+    {"RGB", 3, {}, nullptr, {}, {},
+        CompressedPixelFormat::Bc7RGBAUnorm, 40.0f, 1.5f},
+    {"RGB, sRGB", 3, {}, nullptr, PixelFormat::RGB8Srgb, {},
+        CompressedPixelFormat::Bc7RGBASrgb, 40.0f, 1.5f},
+    {"RGB, alpha enabled", 3, true, nullptr, {}, {},
+        CompressedPixelFormat::Bc7RGBAUnorm, 40.0f, 1.5f},
+    {"flag passthrough", 4, {}, nullptr, PixelFormat::RGBA8Unorm, ImageFlag2D(0xdea0),
+        CompressedPixelFormat::Bc7RGBAUnorm, 40.0f, 1.5f},
+};
+
+const struct {
+    const char* name;
+    Int channelCount;
+    const char* quality;
+} Bc6hData[] {
+    {"RGBA", 4, nullptr},
+    {"RGBA, veryfast", 4, "veryfast"},
+    {"RGBA, veryslow", 4, "veryslow"},
+    {"RGB", 3, nullptr},
+};
+
+const struct {
+    const char* name;
+    Int channelCount;
+    UnsignedInt threads;
+    bool threeDimensions;
+} ThreadsData[] {
+    {"RGBA, two threads", 4, 2, false},
+    {"RGB, all threads", 3, 0, false},
+    {"RGB, more threads than block rows", 3, 64, false},
+    {"RGB, 3D, five threads", 3, 5, true},
+};
+
+IspcTexCompImageConverterTest::IspcTexCompImageConverterTest() {
+    addTests({&IspcTexCompImageConverterTest::unsupportedFormat,
+              &IspcTexCompImageConverterTest::unsupportedSize});
+
+    addInstancedTests({&IspcTexCompImageConverterTest::unsupportedQuality},
+        Containers::arraySize(UnsupportedQualityData));
+
+    addTests({&IspcTexCompImageConverterTest::emptyImage,
+              &IspcTexCompImageConverterTest::array1D});
+
+    addInstancedTests({&IspcTexCompImageConverterTest::bc7},
+        Containers::arraySize(Bc7Data));
+
+    addInstancedTests({&IspcTexCompImageConverterTest::bc6h},
+        Containers::arraySize(Bc6hData));
+
+    addTests({&IspcTexCompImageConverterTest::threeDimensions});
+
+    addInstancedTests({&IspcTexCompImageConverterTest::threads},
+        Containers::arraySize(ThreadsData));
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef ISPCTEXCOMPIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(ISPCTEXCOMPIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    /* The BcDecImageConverter and StbImageImporter are optional */
+    #ifdef BCDECIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(BCDECIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef STBIMAGEIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(STBIMAGEIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void IspcTexCompImageConverterTest::unsupportedFormat() {
+    ImageView2D image{PixelFormat::RG8Unorm, {}, nullptr};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!_converterManager.instantiate("IspcTexCompImageConverter")->convert(image));
+    CORRADE_COMPARE(out.str(), "Trade::IspcTexCompImageConverter::convert(): unsupported format PixelFormat::RG8Unorm\n");
+}
+
+void IspcTexCompImageConverterTest::unsupportedSize() {
+    ImageView2D image{PixelFormat::RGBA8Unorm, {15, 17}};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!_converterManager.instantiate("IspcTexCompImageConverter")->convert(image));
+    CORRADE_COMPARE(out.str(), "Trade::IspcTexCompImageConverter::convert(): expected size to be divisible by 4, got Vector(15, 17)\n");
+}
+
+void IspcTexCompImageConverterTest::unsupportedQuality() {
+    auto&& data = UnsupportedQualityData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    ImageView2D image{data.format, {4, 4}};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("IspcTexCompImageConverter");
+    converter->configuration().setValue("quality", data.quality);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(image));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::IspcTexCompImageConverter::convert(): {}\n", data.message));
+}
+
+void IspcTexCompImageConverterTest::emptyImage() {
+    ImageView2D image{PixelFormat::RGBA8Unorm, {}, nullptr};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("IspcTexCompImageConverter");
+    Containers::Optional<Trade::ImageData2D> out = converter->convert(image);
+    CORRADE_VERIFY(out);
+    CORRADE_VERIFY(out->isCompressed());
+    CORRADE_COMPARE(out->size(), Vector2i{});
+    CORRADE_COMPARE(out->compressedFormat(), CompressedPixelFormat::Bc7RGBAUnorm);
+}
+
+void IspcTexCompImageConverterTest::array1D() {
+    ImageView2D image{PixelFormat::RGBA8Unorm, {4, 4}, ImageFlag2D::Array};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!_converterManager.instantiate("IspcTexCompImageConverter")->convert(image));
+    CORRADE_COMPARE(out.str(), "Trade::IspcTexCompImageConverter::convert(): 1D array images are not supported\n");
+}
+
+void IspcTexCompImageConverterTest::bc7() {
+    auto&& data = Bc7Data[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StbImageImporter");
+    importer->configuration().setValue("forceChannelCount", data.channelCount);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ISPCTEXCOMPIMAGECONVERTER_TEST_DIR, "ship.jpg")));
+    Containers::Optional<Trade::ImageData2D> uncompressed = importer->image2D(0);
+    CORRADE_VERIFY(uncompressed);
+    CORRADE_COMPARE(pixelFormatChannelCount(uncompressed->format()), data.channelCount);
+    CORRADE_COMPARE(uncompressed->size(), (Vector2i{160, 96}));
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("IspcTexCompImageConverter");
+    if(data.alpha)
+        converter->configuration().setValue("alpha", *data.alpha);
+    if(data.quality)
+        converter->configuration().setValue("quality", data.quality);
+
+    Containers::Optional<Trade::ImageData2D> compressed;
+    if(data.overrideInputFormat) {
+        compressed = converter->convert(ImageView2D{*data.overrideInputFormat, uncompressed->size(), uncompressed->data(), data.flags});
+    } else compressed = converter->convert(*uncompressed);
+    CORRADE_VERIFY(compressed);
+    CORRADE_VERIFY(compressed->isCompressed());
+    CORRADE_COMPARE(compressed->flags(), data.flags);
+    CORRADE_COMPARE(compressed->compressedFormat(), data.expectedFormat);
+    CORRADE_COMPARE(compressed->size(), (Vector2i{160, 96}));
+    /* The data should be exactly the size of 4x4 128-bit blocks */
+    /** @todo drop this and let the ImageData constructor take care of this? */
+    CORRADE_COMPARE(compressed->data().size(), 160*96);
+
+    /* The exact output depends on the library version and the ISPC target,
+       so verify the contents by decoding them back */
+    if(_converterManager.loadState("BcDecImageConverter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BcDecImageConverter plugin not found, cannot verify the contents");
+
+    Containers::Optional<Trade::ImageData2D> decompressed = _converterManager.instantiate("BcDecImageConverter")->convert(*compressed);
+    CORRADE_VERIFY(decompressed);
+    CORRADE_COMPARE(decompressed->size(), (Vector2i{160, 96}));
+
+    /* The output is always RGBA, so compare against a four-channel import.
+       For three-channel input the alpha is expected to be 255, which is what a
+       JPEG expanded to four channels has as well. Not caring about sRGB in the
+       comparison. */
+    importer->configuration().setValue("forceChannelCount", 4);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ISPCTEXCOMPIMAGECONVERTER_TEST_DIR, "ship.jpg")));
+    Containers::Optional<Trade::ImageData2D> expected = importer->image2D(0);
+    CORRADE_VERIFY(expected);
+    CORRADE_COMPARE_WITH(
+        (ImageView2D{PixelFormat::RGBA8Unorm, decompressed->size(), decompressed->data()}),
+        *expected,
+        (DebugTools::CompareImage{data.maxThreshold, data.meanThreshold}));
+}
+
+void IspcTexCompImageConverterTest::bc6h() {
+    auto&& data = Bc6hData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* A smooth HDR gradient going above 1.0 */
+    Vector4h rgba[16*8];
+    Vector3h rgb[16*8];
+    for(Int y = 0; y != 8; ++y) {
+        for(Int x = 0; x != 16; ++x) {
+            const Vector3 color{x*0.25f, y*0.5f, (x + y)*0.125f};
+            rgba[y*16 + x] = Vector4h{Vector4{color, 1.0f}};
+            rgb[y*16 + x] = Vector3h{color};
+        }
+    }
+    const ImageView2D image = data.channelCount == 4 ?
+        ImageView2D{PixelFormat::RGBA16F, {16, 8}, rgba} :
+        ImageView2D{PixelFormat::RGB16F, {16, 8}, rgb};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("IspcTexCompImageConverter");
+    if(data.quality)
+        converter->configuration().setValue("quality", data.quality);
+
+    Containers::Optional<Trade::ImageData2D> compressed = converter->convert(image);
+    CORRADE_VERIFY(compressed);
+    CORRADE_VERIFY(compressed->isCompressed());
+    CORRADE_COMPARE(compressed->compressedFormat(), CompressedPixelFormat::Bc6hRGBUfloat);
+    CORRADE_COMPARE(compressed->size(), (Vector2i{16, 8}));
+    CORRADE_COMPARE(compressed->data().size(), 16*8);
+
+    if(_converterManager.loadState("BcDecImageConverter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BcDecImageConverter plugin not found, cannot verify the contents");
+
+    Containers::Optional<Trade::ImageData2D> decompressed = _converterManager.instantiate("BcDecImageConverter")->convert(*compressed);
+    CORRADE_VERIFY(decompressed);
+    CORRADE_COMPARE(decompressed->format(), PixelFormat::RGB16F);
+    CORRADE_COMPARE_WITH(*decompressed,
+        (ImageView2D{PixelFormat::RGB16F, {16, 8}, rgb}),
+        (DebugTools::CompareImage{0.125f, 0.03f}));
+}
+
+void IspcTexCompImageConverterTest::threeDimensions() {
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StbImageImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ISPCTEXCOMPIMAGECONVERTER_TEST_DIR, "ship.jpg")));
+    Containers::Optional<Trade::ImageData2D> uncompressed = importer->image2D(0);
+    CORRADE_VERIFY(uncompressed);
+    CORRADE_COMPARE(uncompressed->format(), PixelFormat::RGB8Unorm);
+    CORRADE_COMPARE(uncompressed->size(), (Vector2i{160, 96}));
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("IspcTexCompImageConverter");
+    Containers::Optional<Trade::ImageData2D> compressed2D = converter->convert(*uncompressed);
+    CORRADE_VERIFY(compressed2D);
+
+    /* Be lazy and just cut up the input 2D image to three horizontal slices,
+       forming a 3D input. Set also an array flag to verify it's passed
+       through unchanged. */
+    ImageView3D uncompressed3D{uncompressed->format(), {160, 32, 3}, uncompressed->data(), ImageFlag3D::Array|ImageFlag3D(0xdea0)};
+
+    Containers::Optional<Trade::ImageData3D> compressed = converter->convert(uncompressed3D);
+    CORRADE_VERIFY(compressed);
+    CORRADE_VERIFY(compressed->isCompressed());
+    CORRADE_COMPARE(compressed->flags(), ImageFlag3D::Array|ImageFlag3D(0xdea0));
+    CORRADE_COMPARE(compressed->compressedFormat(), CompressedPixelFormat::Bc7RGBAUnorm);
+    CORRADE_COMPARE(compressed->size(), (Vector3i{160, 32, 3}));
+
+    /* The output data should be exactly the same as for a 2D case, as it's
+       just the same input but in a different shape */
+    CORRADE_COMPARE_AS(compressed->data(),
+        compressed2D->data(),
+        TestSuite::Compare::Container);
+}
+
+void IspcTexCompImageConverterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StbImageImporter");
+    importer->configuration().setValue("forceChannelCount", data.channelCount);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ISPCTEXCOMPIMAGECONVERTER_TEST_DIR, "ship.jpg")));
+    Containers::Optional<Trade::ImageData2D> uncompressed = importer->image2D(0);
+    CORRADE_VERIFY(uncompressed);
+
+    /* The 3D variant is cut into slices like in threeDimensions(), with the
+       rows distributed across the slices */
+    const ImageView3D input = data.threeDimensions ?
+        ImageView3D{uncompressed->format(), {160, 32, 3}, uncompressed->data(), ImageFlag3D::Array} :
+        ImageView3D{ImageView2D{*uncompressed}};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("IspcTexCompImageConverter");
+    Containers::Optional<Trade::ImageData3D> expected = converter->convert(input);
+    CORRADE_VERIFY(expected);
+
+    /* The output should be the same regardless of the thread count */
+    converter->configuration().setValue("threads", data.threads);
+    Containers::Optional<Trade::ImageData3D> compressed = converter->convert(input);
+    CORRADE_VERIFY(compressed);
+    CORRADE_COMPARE_AS(compressed->data(),
+        expected->data(),
+        TestSuite::Compare::Container);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::IspcTexCompImageConverterTest)
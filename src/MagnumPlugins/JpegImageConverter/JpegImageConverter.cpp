@@ -28,11 +28,16 @@
 #include <csetjmp>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
+
+#include "Magnum/Implementation/instrumentation.h"
 
 #ifdef CORRADE_TARGET_WINDOWS
 /* On Windows we need to circumvent conflicting definition of INT32 in
@@ -58,6 +63,37 @@ namespace Magnum { namespace Trade {
 
 using namespace Containers::Literals;
 
+/* Created on first conversion and kept alive for the whole plugin lifetime,
+   so subsequent conversions don't need to allocate and set up the libJPEG
+   state again */
+struct JpegImageConverter::State {
+    jpeg_compress_struct info;
+    bool created = false;
+
+    /* Fugly error handling stuff */
+    /** @todo Get rid of this crap */
+    struct ErrorManager {
+        jpeg_error_mgr jpegErrorManager;
+        std::jmp_buf setjmpBuffer;
+        char message[JMSG_LENGTH_MAX]{};
+    } errorManager;
+
+    struct DestinationManager {
+        jpeg_destination_mgr jpegDestinationManager;
+        /* Growable output used by doConvertToData(), keeping its capacity
+           across conversions */
+        Containers::Array<char> output;
+        /* Caller-provided output used by convertToDataInto(). If it gets
+           exhausted, the rest is written into the scratch buffer just to
+           know how much was needed in total. */
+        Containers::ArrayView<char> external;
+        bool useExternal;
+        bool inScratch;
+        std::size_t overflowSize;
+        char scratch[4096];
+    } destinationManager;
+};
+
 JpegImageConverter::JpegImageConverter() {
     /** @todo horrible workaround, fix this properly */
     configuration().setValue("jpegQuality", 0.8f);
@@ -65,6 +101,11 @@ JpegImageConverter::JpegImageConverter() {
 
 JpegImageConverter::JpegImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImageConverter(manager, Utility::move(plugin)) {}
 
+JpegImageConverter::~JpegImageConverter() {
+    if(_state && _state->created)
+        jpeg_destroy_compress(&_state->info);
+}
+
 ImageConverterFeatures JpegImageConverter::doFeatures() const { return ImageConverterFeature::Convert2DToData; }
 
 Containers::String JpegImageConverter::doExtension() const { return "jpg"_s; }
@@ -73,10 +114,10 @@ Containers::String JpegImageConverter::doMimeType() const {
     return "image/jpeg"_s;
 }
 
-Containers::Optional<Containers::Array<char>> JpegImageConverter::doConvertToData(const ImageView2D& image) {
+Containers::Optional<std::size_t> JpegImageConverter::convertInternal(const ImageView2D& image, const char* const prefix, Containers::ArrayView<char>* const into) {
     /* Warn about lost metadata */
     if(image.flags() & ImageFlag2D::Array && !(flags() & ImageConverterFlag::Quiet)) {
-        Warning{} << "Trade::JpegImageConverter::convertToData(): 1D array images are unrepresentable in JPEG, saving as a regular 2D image";
+        Warning{} << prefix << "1D array images are unrepresentable in JPEG, saving as a regular 2D image";
     }
 
     static_assert(BITS_IN_JSAMPLE == 8, "Only 8-bit JPEG is supported");
@@ -97,74 +138,114 @@ Containers::Optional<Containers::Array<char>> JpegImageConverter::doConvertToDat
             components = 4;
             colorSpace = JCS_EXT_RGBX;
             if(!(flags() & ImageConverterFlag::Quiet))
-                Warning{} << "Trade::JpegImageConverter::convertToData(): ignoring alpha channel";
+                Warning{} << prefix << "ignoring alpha channel";
             break;
             #else
-            Error{} << "Trade::JpegImageConverter::convertToData(): RGBA input (with alpha ignored) requires libjpeg-turbo";
+            Error{} << prefix << "RGBA input (with alpha ignored) requires libjpeg-turbo";
             return {};
             #endif
         default:
-            Error() << "Trade::JpegImageConverter::convertToData(): unsupported pixel format" << image.format();
+            Error() << prefix << "unsupported pixel format" << image.format();
             return {};
     }
 
-    /* Initialize structures. Needs to be before the setjmp crap in order to
-       avoid leaks on error. */
-    jpeg_compress_struct info;
-    struct DestinationManager {
-        jpeg_destination_mgr jpegDestinationManager;
-        Containers::Array<char> output;
-    } destinationManager;
+    if(!_state)
+        _state.emplace();
+    jpeg_compress_struct& info = _state->info;
+    State::DestinationManager& destinationManager = _state->destinationManager;
+    State::ErrorManager& errorManager = _state->errorManager;
 
-    Containers::Array<JSAMPROW> rows;
-    Containers::Array<char> data;
+    destinationManager.useExternal = into;
+    destinationManager.inScratch = false;
+    destinationManager.overflowSize = 0;
+    if(into) destinationManager.external = *into;
 
-    /* Fugly error handling stuff */
-    /** @todo Get rid of this crap */
-    struct ErrorManager {
-        jpeg_error_mgr jpegErrorManager;
-        std::jmp_buf setjmpBuffer;
-        char message[JMSG_LENGTH_MAX]{};
-    } errorManager;
-    info.err = jpeg_std_error(&errorManager.jpegErrorManager);
-    errorManager.jpegErrorManager.error_exit = [](j_common_ptr info) {
-        auto& errorManager = *reinterpret_cast<ErrorManager*>(info->err);
-        info->err->format_message(info, errorManager.message);
-        std::longjmp(errorManager.setjmpBuffer, 1);
-    };
+    /* The error manager has to be set up before creating the compression
+       structure, as that can fail as well. On failure the structure is only
+       aborted, not destroyed, to be reusable for the next conversion. */
     if(setjmp(errorManager.setjmpBuffer)) {
-        Error{} << "Trade::JpegImageConverter::convertToData(): error:" << errorManager.message;
-        jpeg_destroy_compress(&info);
+        Error{} << prefix << "error:" << errorManager.message;
+        if(_state->created)
+            jpeg_abort_compress(&info);
+        else
+            jpeg_destroy_compress(&info);
         return {};
     }
 
-    /* Create the compression structure */
-    jpeg_create_compress(&info);
-    info.dest = reinterpret_cast<jpeg_destination_mgr*>(&destinationManager);
-    info.dest->init_destination = [](j_compress_ptr info) {
-        auto& destinationManager = *reinterpret_cast<DestinationManager*>(info->dest);
-        /* It crashes if the buffer has zero free space */
-        arrayAppend(destinationManager.output, NoInit, 1);
-        info->dest->next_output_byte = reinterpret_cast<JSAMPLE*>(destinationManager.output.data());
-        info->dest->free_in_buffer = destinationManager.output.size()/sizeof(JSAMPLE);
-    };
-    info.dest->term_destination = [](j_compress_ptr info) {
-        auto& destinationManager = *reinterpret_cast<DestinationManager*>(info->dest);
-        arrayRemoveSuffix(destinationManager.output, info->dest->free_in_buffer);
-    };
-    info.dest->empty_output_buffer = [](j_compress_ptr info) -> boolean {
-        auto& destinationManager = *reinterpret_cast<DestinationManager*>(info->dest);
-        const std::size_t oldSize = destinationManager.output.size();
-        /* Double capacity each time it is exceeded */
-        /** @todo have some arrayGrow() which figures out the grown size on its
-            own */
-        arrayAppend(destinationManager.output, NoInit, oldSize);
-        info->dest->next_output_byte = reinterpret_cast<JSAMPLE*>(&destinationManager.output[0] + oldSize);
-        info->dest->free_in_buffer = (destinationManager.output.size() - oldSize)/sizeof(JSAMPLE);
-        return boolean(true);
-    };
-
-    /* Fill the info structure */
+    /* Create the compression structure, if not already */
+    if(!_state->created) {
+        info.err = jpeg_std_error(&errorManager.jpegErrorManager);
+        errorManager.jpegErrorManager.error_exit = [](j_common_ptr info) {
+            auto& errorManager = *reinterpret_cast<State::ErrorManager*>(info->err);
+            info->err->format_message(info, errorManager.message);
+            std::longjmp(errorManager.setjmpBuffer, 1);
+        };
+
+        jpeg_create_compress(&info);
+        _state->created = true;
+
+        info.dest = reinterpret_cast<jpeg_destination_mgr*>(&destinationManager);
+        info.dest->init_destination = [](j_compress_ptr info) {
+            auto& destinationManager = *reinterpret_cast<State::DestinationManager*>(info->dest);
+            /* It crashes if the buffer has zero free space, so if the
+               external buffer is empty, go directly to the scratch buffer */
+            if(destinationManager.useExternal) {
+                if(destinationManager.external.isEmpty()) {
+                    destinationManager.inScratch = true;
+                    info->dest->next_output_byte = reinterpret_cast<JSAMPLE*>(destinationManager.scratch);
+                    info->dest->free_in_buffer = sizeof(destinationManager.scratch)/sizeof(JSAMPLE);
+                } else {
+                    info->dest->next_output_byte = reinterpret_cast<JSAMPLE*>(destinationManager.external.data());
+                    info->dest->free_in_buffer = destinationManager.external.size()/sizeof(JSAMPLE);
+                }
+                return;
+            }
+
+            /* Use the whole capacity left from the previous conversion */
+            arrayResize(destinationManager.output, NoInit, Math::max(arrayCapacity(destinationManager.output), std::size_t{1}));
+            info->dest->next_output_byte = reinterpret_cast<JSAMPLE*>(destinationManager.output.data());
+            info->dest->free_in_buffer = destinationManager.output.size()/sizeof(JSAMPLE);
+        };
+        info.dest->term_destination = [](j_compress_ptr info) {
+            auto& destinationManager = *reinterpret_cast<State::DestinationManager*>(info->dest);
+            if(destinationManager.useExternal) {
+                /* If an overflow happened, the external buffer was written
+                   fully and the rest went to the scratch buffer */
+                if(destinationManager.inScratch)
+                    destinationManager.overflowSize += sizeof(destinationManager.scratch) - info->dest->free_in_buffer;
+                else
+                    destinationManager.external = destinationManager.external.prefix(destinationManager.external.size() - info->dest->free_in_buffer);
+                return;
+            }
+
+            arrayRemoveSuffix(destinationManager.output, info->dest->free_in_buffer);
+        };
+        info.dest->empty_output_buffer = [](j_compress_ptr info) -> boolean {
+            auto& destinationManager = *reinterpret_cast<State::DestinationManager*>(info->dest);
+            /* If the external buffer is exhausted, continue into the scratch
+               buffer, overwriting it each time, just to count the bytes */
+            if(destinationManager.useExternal) {
+                if(destinationManager.inScratch)
+                    destinationManager.overflowSize += sizeof(destinationManager.scratch);
+                else destinationManager.inScratch = true;
+                info->dest->next_output_byte = reinterpret_cast<JSAMPLE*>(destinationManager.scratch);
+                info->dest->free_in_buffer = sizeof(destinationManager.scratch)/sizeof(JSAMPLE);
+                return boolean(true);
+            }
+
+            const std::size_t oldSize = destinationManager.output.size();
+            /* Double capacity each time it is exceeded */
+            /** @todo have some arrayGrow() which figures out the grown size on
+                its own */
+            arrayAppend(destinationManager.output, NoInit, oldSize);
+            info->dest->next_output_byte = reinterpret_cast<JSAMPLE*>(&destinationManager.output[0] + oldSize);
+            info->dest->free_in_buffer = (destinationManager.output.size() - oldSize)/sizeof(JSAMPLE);
+            return boolean(true);
+        };
+    }
+
+    /* Fill the info structure. The defaults have to be set again each time as
+       they depend on the color space. */
     info.image_width = image.size().x();
     info.image_height = image.size().y();
     info.input_components = components;
@@ -189,15 +270,43 @@ Containers::Optional<Containers::Array<char>> JpegImageConverter::doConvertToDat
         jpeg_write_scanlines(&info, &row, 1);
     }
 
+    /* Finishing the compression puts the structure back to a state where it
+       can be used for another image */
     jpeg_finish_compress(&info);
-    jpeg_destroy_compress(&info);
 
-    /* Convert the growable array back to a non-growable with the default
-       deleter so we can return it */
-    arrayShrink(destinationManager.output);
+    if(into) {
+        /* libJPEG calls empty_output_buffer() as soon as the buffer is full,
+           so switching to the scratch buffer alone doesn't mean the output
+           didn't fit */
+        if(destinationManager.overflowSize) {
+            Error{} << prefix << "expected at least" << destinationManager.external.size() + destinationManager.overflowSize << "bytes for the output but got" << destinationManager.external.size();
+            return {};
+        }
+
+        return destinationManager.external.size();
+    }
+
+    return destinationManager.output.size();
+}
+
+Containers::Optional<Containers::Array<char>> JpegImageConverter::doConvertToData(const ImageView2D& image) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
+    const Containers::Optional<std::size_t> size = convertInternal(image, "Trade::JpegImageConverter::convertToData():", nullptr);
+    if(!size)
+        return {};
+
+    /* Copy the output to an array with the default deleter so we can return
+       it, keeping the growable array with its capacity for the next
+       conversion */
+    Containers::Array<char> out{NoInit, *size};
+    Utility::copy(_state->destinationManager.output, out);
 
     /* GCC 4.8 needs extra help here */
-    return Containers::optional(Utility::move(destinationManager.output));
+    return Containers::optional(Utility::move(out));
+}
+
+Containers::Optional<std::size_t> JpegImageConverter::convertToDataInto(const ImageView2D& image, Containers::ArrayView<char> data) {
+    return convertInternal(image, "Trade::JpegImageConverter::convertToDataInto():", &data);
 }
 
 }}
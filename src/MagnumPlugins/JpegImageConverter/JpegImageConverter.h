@@ -29,6 +29,7 @@
  * @brief Class @ref Magnum::Trade::JpegImageConverter
  */
 
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractImageConverter.h>
 
 #include "MagnumPlugins/JpegImageConverter/configure.h"
@@ -139,6 +140,31 @@ implementations:
 -   [MozJPEG](https://github.com/mozilla/mozjpeg), optimized for quality/size
     ratio, though generally much slower than libjpeg-turbo
 
+@subsection Trade-JpegImageConverter-behavior-reuse Converting many images
+
+The libJPEG compressor state is created on the first conversion and reused
+for all subsequent conversions done with the same plugin instance, which
+avoids allocating and setting it up again for every image, for example when
+encoding video frames. Similarly, the memory used for the output is kept
+between conversions and only copied to the returned array, so once it grows
+large enough, no more reallocations happen.
+
+If you instantiate this class directly, either without a plugin manager or with
+the plugin linked statically, you can use @ref convertToDataInto() to encode
+directly into memory you provide and avoid the allocation and copy of the
+returned array as well. If the memory isn't large enough, the conversion fails
+with a message containing the required size.
+
+@code{.cpp}
+Trade::JpegImageConverter converter;
+Containers::Array<char> output{NoInit, 1024*1024};
+for(const ImageView2D& frame: frames) {
+    Containers::Optional<std::size_t> size = converter.convertToDataInto(frame, output);
+    if(!size) break;
+    write(output.prefix(*size));
+}
+@endcode
+
 @subsection Trade-JpegImageConverter-behavior-arithmetic-coding Arithmetic JPEG encoding
 
 Libjpeg has a switch to enable [arithmetic coding](https://en.wikipedia.org/wiki/Arithmetic_coding)
@@ -162,12 +188,35 @@ class MAGNUM_JPEGIMAGECONVERTER_EXPORT JpegImageConverter: public AbstractImageC
         /** @brief Plugin manager constructor */
         explicit JpegImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
+        ~JpegImageConverter();
+
+        /**
+         * @brief Convert an image into a caller-provided memory
+         * @m_since_latest
+         *
+         * Like @ref convertToData(), but instead of allocating a new array,
+         * the output is written into @p data. On success returns the number of
+         * bytes written to the front of @p data. If @p data is too small,
+         * prints a message containing the required size to
+         * @relativeref{Magnum,Error} and returns
+         * @relativeref{Corrade,Containers::NullOpt}, with contents of @p data
+         * being unspecified. See @ref Trade-JpegImageConverter-behavior-reuse
+         * for more information.
+         */
+        Containers::Optional<std::size_t> convertToDataInto(const ImageView2D& image, Containers::ArrayView<char> data);
+
     private:
+        struct State;
+
+        MAGNUM_JPEGIMAGECONVERTER_LOCAL Containers::Optional<std::size_t> convertInternal(const ImageView2D& image, const char* prefix, Containers::ArrayView<char>* into);
+
         MAGNUM_JPEGIMAGECONVERTER_LOCAL ImageConverterFeatures doFeatures() const override;
         MAGNUM_JPEGIMAGECONVERTER_LOCAL Containers::String doExtension() const override;
         MAGNUM_JPEGIMAGECONVERTER_LOCAL Containers::String doMimeType() const override;
 
         MAGNUM_JPEGIMAGECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(const ImageView2D& image) override;
+
+        Containers::Pointer<State> _state;
 };
 
 }}
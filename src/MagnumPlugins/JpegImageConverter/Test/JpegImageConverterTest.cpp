@@ -41,6 +41,10 @@
 
 #include "configure.h"
 
+#ifndef JPEGIMAGECONVERTER_PLUGIN_FILENAME
+#include "MagnumPlugins/JpegImageConverter/JpegImageConverter.h"
+#endif
+
 /* jpeglib.h is needed to query if RGBA output is supported (JCS_EXTENSIONS).
    See JpegImageConverter.cpp for details why the define below is needed. */
 #ifdef CORRADE_TARGET_WINDOWS
@@ -66,6 +70,10 @@ struct JpegImageConverterTest: TestSuite::Tester {
 
     void unsupportedMetadata();
 
+    void reuse();
+    void convertToDataInto();
+    void convertToDataIntoTooSmall();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
     PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
@@ -108,6 +116,10 @@ JpegImageConverterTest::JpegImageConverterTest() {
     addInstancedTests({&JpegImageConverterTest::unsupportedMetadata},
         Containers::arraySize(UnsupportedMetadataData));
 
+    addTests({&JpegImageConverterTest::reuse,
+              &JpegImageConverterTest::convertToDataInto,
+              &JpegImageConverterTest::convertToDataIntoTooSmall});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef JPEGIMAGECONVERTER_PLUGIN_FILENAME
@@ -422,6 +434,94 @@ void JpegImageConverterTest::unsupportedMetadata() {
         CORRADE_COMPARE(out.str(), Utility::formatString("Trade::JpegImageConverter::convertToData(): {}\n", data.message));
 }
 
+void JpegImageConverterTest::reuse() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("JpegImageConverter");
+
+    /* Reference output from fresh instances */
+    Containers::Optional<Containers::Array<char>> expectedRgb = _converterManager.instantiate("JpegImageConverter")->convertToData(OriginalRgb);
+    Containers::Optional<Containers::Array<char>> expectedGrayscale = _converterManager.instantiate("JpegImageConverter")->convertToData(OriginalGrayscale);
+    CORRADE_VERIFY(expectedRgb);
+    CORRADE_VERIFY(expectedGrayscale);
+
+    /* Converting several different images with the same instance should
+       give the same results as with fresh instances */
+    Containers::Optional<Containers::Array<char>> rgb = converter->convertToData(OriginalRgb);
+    CORRADE_VERIFY(rgb);
+    CORRADE_COMPARE_AS(*rgb, *expectedRgb,
+        TestSuite::Compare::Container);
+
+    Containers::Optional<Containers::Array<char>> grayscale = converter->convertToData(OriginalGrayscale);
+    CORRADE_VERIFY(grayscale);
+    CORRADE_COMPARE_AS(*grayscale, *expectedGrayscale,
+        TestSuite::Compare::Container);
+
+    /* A failed conversion shouldn't leave the compressor in a broken state.
+       Same as in conversionError(). */
+    {
+        const char data[1]{};
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::R8Unorm, {16*1024*1024, 1}, {data, 16*1024*1024}}));
+        CORRADE_COMPARE(out.str(), "Trade::JpegImageConverter::convertToData(): error: Maximum supported image dimension is 65500 pixels\n");
+    }
+
+    Containers::Optional<Containers::Array<char>> rgbAgain = converter->convertToData(OriginalRgb);
+    CORRADE_VERIFY(rgbAgain);
+    CORRADE_COMPARE_AS(*rgbAgain, *expectedRgb,
+        TestSuite::Compare::Container);
+}
+
+void JpegImageConverterTest::convertToDataInto() {
+    #ifdef JPEGIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    Containers::Optional<Containers::Array<char>> expected = _converterManager.instantiate("JpegImageConverter")->convertToData(OriginalRgb);
+    CORRADE_VERIFY(expected);
+
+    Containers::Pointer<JpegImageConverter> converter{static_cast<JpegImageConverter*>(_converterManager.instantiate("JpegImageConverter").release())};
+
+    /* Do it twice to verify the output isn't affected by the previous
+       conversion */
+    char output[16384];
+    for(std::size_t i = 0; i != 2; ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<std::size_t> size = converter->convertToDataInto(OriginalRgb, output);
+        CORRADE_VERIFY(size);
+        CORRADE_COMPARE_AS(Containers::arrayView(output).prefix(*size),
+            Containers::arrayView(*expected),
+            TestSuite::Compare::Container);
+    }
+    #endif
+}
+
+void JpegImageConverterTest::convertToDataIntoTooSmall() {
+    #ifdef JPEGIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    Containers::Optional<Containers::Array<char>> expected = _converterManager.instantiate("JpegImageConverter")->convertToData(OriginalRgb);
+    CORRADE_VERIFY(expected);
+
+    Containers::Pointer<JpegImageConverter> converter{static_cast<JpegImageConverter*>(_converterManager.instantiate("JpegImageConverter").release())};
+
+    Containers::Array<char> output{NoInit, expected->size() - 1};
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!converter->convertToDataInto(OriginalRgb, output));
+        CORRADE_COMPARE(out.str(), Utility::formatString("Trade::JpegImageConverter::convertToDataInto(): expected at least {} bytes for the output but got {}\n", expected->size(), expected->size() - 1));
+    }
+
+    /* With the reported size it should pass */
+    output = Containers::Array<char>{NoInit, expected->size()};
+    Containers::Optional<std::size_t> size = converter->convertToDataInto(OriginalRgb, output);
+    CORRADE_VERIFY(size);
+    CORRADE_COMPARE(*size, expected->size());
+    CORRADE_COMPARE_AS(output,
+        Containers::arrayView(*expected),
+        TestSuite::Compare::Container);
+    #endif
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::JpegImageConverterTest)
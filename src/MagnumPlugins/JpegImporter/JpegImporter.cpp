@@ -27,11 +27,20 @@
 
 #include <csetjmp>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector4.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/asyncImageImport.h"
+#include "Magnum/Implementation/instrumentation.h"
+
 #ifdef CORRADE_TARGET_WINDOWS
 /* On Windows we need to circumvent conflicting definition of INT32 in
    <windows.h> (included from OpenGL headers). Problem with libjpeg-tubo only,
@@ -54,19 +63,58 @@
 
 namespace Magnum { namespace Trade {
 
+namespace {
+
+/* Fugly error handling stuff */
+/** @todo Get rid of this crap */
+struct ErrorManager {
+    jpeg_error_mgr jpegErrorManager;
+    std::jmp_buf setjmpBuffer;
+    char message[JMSG_LENGTH_MAX]{};
+};
+
+void errorExit(j_common_ptr info) {
+    auto& errorManager = *reinterpret_cast<ErrorManager*>(info->err);
+    info->err->format_message(info, errorManager.message);
+    std::longjmp(errorManager.setjmpBuffer, 1);
+}
+
+}
+
+struct JpegImporter::Planes {
+    /* Decoded Y, Cb and Cr planes, each reset once returned from
+       doImage2D() */
+    Containers::Optional<ImageData2D> planes[3];
+};
+
 JpegImporter::JpegImporter() = default;
 
 JpegImporter::JpegImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
 
-JpegImporter::~JpegImporter() = default;
+struct JpegImporter::AsyncState: Magnum::Implementation::AsyncImageImport {};
+
+JpegImporter::~JpegImporter() {
+    if(_async) _async->wait();
+}
+
+bool JpegImporter::image2DAsync(const UnsignedInt id, const UnsignedInt level, void(*const executor)(void(*)(void*), void*, void*), void(*const callback)(UnsignedInt, UnsignedInt, Containers::Optional<ImageData2D>&&, void*), void* const userData) {
+    if(!_async) _async.emplace();
+    return _async->schedule("Trade::JpegImporter::image2DAsync():", *this, id, level, executor, callback, userData);
+}
 
 ImporterFeatures JpegImporter::doFeatures() const { return ImporterFeature::OpenData; }
 
 bool JpegImporter::doIsOpened() const { return _in; }
 
-void JpegImporter::doClose() { _in = nullptr; }
+void JpegImporter::doClose() {
+    /* In-flight asynchronous imports reference the file, wait for them */
+    if(_async) _async->wait();
+    _in = nullptr;
+    _planes = nullptr;
+}
 
 void JpegImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     /* Because here we're copying the data and using the _in to check if file
        is opened, having them nullptr would mean openData() would fail without
        any error message. It's not possible to do this check on the importer
@@ -86,28 +134,75 @@ void JpegImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
         _in = Containers::Array<char>{NoInit, data.size()};
         Utility::copy(data, _in);
     }
+
+    /* If raw YCbCr planes are requested, the image count depends on the color
+       space of the file, so the header has to be read already here */
+    if(configuration().value<bool>("ycbcrPlanes")) {
+        jpeg_decompress_struct file;
+        ErrorManager errorManager;
+        file.err = jpeg_std_error(&errorManager.jpegErrorManager);
+        errorManager.jpegErrorManager.error_exit = errorExit;
+        if(setjmp(errorManager.setjmpBuffer)) {
+            Error{} << "Trade::JpegImporter::openData(): error:" << errorManager.message;
+            jpeg_destroy_decompress(&file);
+            _in = nullptr;
+            return;
+        }
+
+        jpeg_create_decompress(&file);
+        jpeg_mem_src(&file, reinterpret_cast<unsigned char*>(_in.begin()), _in.size());
+        jpeg_read_header(&file, boolean(true));
+        if(file.jpeg_color_space == JCS_YCbCr && file.num_components == 3)
+            _planes.emplace();
+        jpeg_destroy_decompress(&file);
+    }
 }
 
-UnsignedInt JpegImporter::doImage2DCount() const { return 1; }
+UnsignedInt JpegImporter::doImage2DCount() const { return _planes ? 3 : 1; }
+
+Containers::Optional<ImageData2D> JpegImporter::doImage2D(const UnsignedInt id, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D"};
+    const UnsignedInt downscale = configuration().value<UnsignedInt>("downscale");
+    if(downscale != 1 && downscale != 2 && downscale != 4 && downscale != 8) {
+        Error{} << "Trade::JpegImporter::image2D(): expected downscale to be 1, 2, 4 or 8 but got" << configuration().value<Containers::StringView>("downscale");
+        return {};
+    }
+
+    J_DCT_METHOD dctMethod;
+    const Containers::StringView dctMethodString = configuration().value<Containers::StringView>("dctMethod");
+    if(dctMethodString == "integer")
+        dctMethod = JDCT_ISLOW;
+    else if(dctMethodString == "fast")
+        dctMethod = JDCT_IFAST;
+    else if(dctMethodString == "float")
+        dctMethod = JDCT_FLOAT;
+    else {
+        Error{} << "Trade::JpegImporter::image2D(): expected dctMethod to be integer, fast or float but got" << dctMethodString;
+        return {};
+    }
+
+    if(_planes) {
+        /* Return a plane decoded by a previous call if there's any */
+        if(_planes->planes[id]) {
+            Containers::Optional<ImageData2D> out = Utility::move(_planes->planes[id]);
+            _planes->planes[id] = Containers::NullOpt;
+            return out;
+        }
+
+        const Vector4i region = configuration().value<Vector4i>("region");
+        if(region.z() || region.w()) {
+            Error{} << "Trade::JpegImporter::image2D(): region decoding can't be combined with ycbcrPlanes";
+            return {};
+        }
+    }
 
-Containers::Optional<ImageData2D> JpegImporter::doImage2D(UnsignedInt, UnsignedInt) {
     /* Initialize structures */
     jpeg_decompress_struct file;
     Containers::Array<char> data;
 
-    /* Fugly error handling stuff */
-    /** @todo Get rid of this crap */
-    struct ErrorManager {
-        jpeg_error_mgr jpegErrorManager;
-        std::jmp_buf setjmpBuffer;
-        char message[JMSG_LENGTH_MAX]{};
-    } errorManager;
+    ErrorManager errorManager;
     file.err = jpeg_std_error(&errorManager.jpegErrorManager);
-    errorManager.jpegErrorManager.error_exit = [](j_common_ptr info) {
-        auto& errorManager = *reinterpret_cast<ErrorManager*>(info->err);
-        info->err->format_message(info, errorManager.message);
-        std::longjmp(errorManager.setjmpBuffer, 1);
-    };
+    errorManager.jpegErrorManager.error_exit = errorExit;
     if(setjmp(errorManager.setjmpBuffer)) {
         Error() << "Trade::JpegImporter::image2D(): error:" << errorManager.message;
         jpeg_destroy_decompress(&file);
@@ -124,10 +219,97 @@ Containers::Optional<ImageData2D> JpegImporter::doImage2D(UnsignedInt, UnsignedI
        'boolean' for 2nd argument" (boolean is an enum instead of a typedef to
        int there) so doing the conversion implicitly. */
     jpeg_read_header(&file, boolean(true));
+
+    /* Scaled inverse DCT, the output size is calculated from this in
+       jpeg_start_decompress() */
+    file.scale_num = 1;
+    file.scale_denom = downscale;
+    file.dct_method = dctMethod;
+    file.do_fancy_upsampling = boolean(configuration().value<bool>("fancyUpsampling"));
+
+    /* Raw YCbCr planes. The file was checked to be three-component YCbCr in
+       doOpenData() already. */
+    if(_planes) {
+        file.raw_data_out = boolean(true);
+        jpeg_start_decompress(&file);
+
+        /* Each call to jpeg_read_raw_data() decodes one iMCU row, which is
+           v_samp_factor block rows of each component. Decode directly into
+           buffers padded to whole blocks and copy the actual planes out of
+           them after. */
+        #if JPEG_LIB_VERSION >= 70
+        const UnsignedInt iMcuHeight = file.max_v_samp_factor*file.min_DCT_v_scaled_size;
+        #else
+        const UnsignedInt iMcuHeight = file.max_v_samp_factor*file.min_DCT_scaled_size;
+        #endif
+        Containers::Array<char> paddedPlanes[3];
+        std::size_t paddedWidths[3];
+        UnsignedInt iMcuPlaneHeights[3];
+        Containers::Array<JSAMPROW> rows[3];
+        JSAMPARRAY planeRows[3];
+        for(std::size_t i = 0; i != 3; ++i) {
+            const jpeg_component_info& component = file.comp_info[i];
+            #if JPEG_LIB_VERSION >= 70
+            const UnsignedInt blockWidth = component.DCT_h_scaled_size;
+            const UnsignedInt blockHeight = component.DCT_v_scaled_size;
+            #else
+            const UnsignedInt blockWidth = component.DCT_scaled_size;
+            const UnsignedInt blockHeight = component.DCT_scaled_size;
+            #endif
+            paddedWidths[i] = component.width_in_blocks*blockWidth;
+            iMcuPlaneHeights[i] = component.v_samp_factor*blockHeight;
+            paddedPlanes[i] = Containers::Array<char>{NoInit, paddedWidths[i]*iMcuPlaneHeights[i]*file.total_iMCU_rows};
+            rows[i] = Containers::Array<JSAMPROW>{NoInit, iMcuPlaneHeights[i]};
+            planeRows[i] = rows[i];
+        }
+
+        for(UnsignedInt iMcuRow = 0; iMcuRow != file.total_iMCU_rows; ++iMcuRow) {
+            for(std::size_t i = 0; i != 3; ++i)
+                for(UnsignedInt y = 0; y != iMcuPlaneHeights[i]; ++y)
+                    rows[i][y] = reinterpret_cast<JSAMPROW>(paddedPlanes[i].data() + (iMcuRow*iMcuPlaneHeights[i] + y)*paddedWidths[i]);
+            jpeg_read_raw_data(&file, planeRows, iMcuHeight);
+        }
+
+        /* Copy the planes out, flipping them to Y up and aligning rows to
+           four bytes */
+        for(std::size_t i = 0; i != 3; ++i) {
+            const jpeg_component_info& component = file.comp_info[i];
+            const Vector2i size(component.downsampled_width, component.downsampled_height);
+            const std::size_t stride = ((size.x() + 3)/4)*4;
+            Containers::Array<char> planeData{ValueInit, stride*size.y()};
+            Utility::copy(
+                Containers::StridedArrayView2D<const char>{paddedPlanes[i], {std::size_t(size.y()), std::size_t(size.x())}, {std::ptrdiff_t(paddedWidths[i]), 1}}.flipped<0>(),
+                Containers::StridedArrayView2D<char>{planeData, {std::size_t(size.y()), std::size_t(size.x())}, {std::ptrdiff_t(stride), 1}});
+            _planes->planes[i] = Trade::ImageData2D{PixelFormat::R8Unorm, size, Utility::move(planeData)};
+        }
+
+        jpeg_finish_decompress(&file);
+        jpeg_destroy_decompress(&file);
+
+        Containers::Optional<ImageData2D> out = Utility::move(_planes->planes[id]);
+        _planes->planes[id] = Containers::NullOpt;
+        return out;
+    }
+
     jpeg_start_decompress(&file);
 
-    /* Image size and type */
-    const Vector2i size(file.output_width, file.output_height);
+    /* Image size, or a subset of it if a region is requested. The region is
+       specified with Y up, as everything else, so the top row in the file is
+       the last region row. */
+    const Vector2i fullSize(file.output_width, file.output_height);
+    const Vector4i region = configuration().value<Vector4i>("region");
+    Vector2i offset;
+    Vector2i size = fullSize;
+    if(region.z() || region.w()) {
+        if((region < Vector4i{0}).any() || region.x() + region.z() > fullSize.x() || region.y() + region.w() > fullSize.y() || !region.z() || !region.w()) {
+            Error{} << "Trade::JpegImporter::image2D(): region" << Debug::packed << region << "out of range for a" << Debug::packed << fullSize << "image";
+            jpeg_destroy_decompress(&file);
+            return {};
+        }
+
+        offset = region.xy();
+        size = Vector2i{region.z(), region.w()};
+    }
     static_assert(BITS_IN_JSAMPLE == 8, "Only 8-bit JPEG is supported");
 
     /* Image format */
@@ -154,13 +336,54 @@ Containers::Optional<ImageData2D> JpegImporter::doImage2D(UnsignedInt, UnsignedI
     data = Containers::Array<char>{stride*std::size_t(size.y())};
 
     /* Read image row by row */
-    while(file.output_scanline < file.output_height) {
-        JSAMPROW row = reinterpret_cast<JSAMPROW>(data.data() + (size.y() - file.output_scanline - 1)*stride);
-        jpeg_read_scanlines(&file, &row, 1);
+    if(size == fullSize) {
+        while(file.output_scanline < file.output_height) {
+            JSAMPROW row = reinterpret_cast<JSAMPROW>(data.data() + (size.y() - file.output_scanline - 1)*stride);
+            jpeg_read_scanlines(&file, &row, 1);
+        }
+
+    /* Read just the region. With libjpeg-turbo, columns outside of the
+       region get skipped during decoding, however the horizontal range can
+       only start at an iMCU boundary, so it may be larger than requested,
+       and rows above the region are skipped without the inverse DCT and
+       color conversion. With vanilla libjpeg everything is decoded and the
+       region copied from it. */
+    } else {
+        const std::size_t pixelSize = file.out_color_components*BITS_IN_JSAMPLE/8;
+        const UnsignedInt top = fullSize.y() - offset.y() - size.y();
+        JDIMENSION cropOffset = offset.x();
+        JDIMENSION cropWidth = size.x();
+        /* LIBJPEG_TURBO_VERSION_NUMBER is defined since 1.5, which is
+           also when cropping and skipping got added */
+        #ifdef LIBJPEG_TURBO_VERSION_NUMBER
+        if(size.x() != fullSize.x())
+            jpeg_crop_scanline(&file, &cropOffset, &cropWidth);
+        else cropOffset = 0;
+        if(top)
+            jpeg_skip_scanlines(&file, top);
+        #else
+        cropOffset = 0;
+        cropWidth = fullSize.x();
+        #endif
+
+        Containers::Array<char> scanline{NoInit, cropWidth*pixelSize};
+        JSAMPROW scanlinePointer = reinterpret_cast<JSAMPROW>(scanline.data());
+        const std::size_t regionOffset = (offset.x() - cropOffset)*pixelSize;
+        while(file.output_scanline < top + size.y()) {
+            const UnsignedInt y = file.output_scanline;
+            jpeg_read_scanlines(&file, &scanlinePointer, 1);
+            if(y < top) continue;
+            Utility::copy(scanline.sliceSize(regionOffset, size.x()*pixelSize),
+                data.sliceSize((size.y() - (y - top) - 1)*stride, size.x()*pixelSize));
+        }
     }
 
-    /* Cleanup */
-    jpeg_finish_decompress(&file);
+    /* Cleanup. Finishing the decompression is an error if not all scanlines
+       were read, which is the case if a region was decoded. */
+    if(file.output_scanline == file.output_height)
+        jpeg_finish_decompress(&file);
+    else
+        jpeg_abort_decompress(&file);
     jpeg_destroy_decompress(&file);
 
     /* Always using the default 4-byte alignment */
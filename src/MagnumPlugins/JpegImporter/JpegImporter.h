@@ -30,6 +30,7 @@
  */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "MagnumPlugins/JpegImporter/configure.h"
@@ -111,11 +112,109 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::JpegImporter)
 See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 @ref file-formats for more information.
 
+@section Trade-JpegImporter-behavior Behavior and limitations
+
+@subsection Trade-JpegImporter-behavior-downscale Downscaled decoding
+
+Setting the @cb{.ini} downscale @ce @ref Trade-JpegImporter-configuration "configuration option"
+to @cb{.ini} 2 @ce, @cb{.ini} 4 @ce or @cb{.ini} 8 @ce makes libJPEG decode
+the image at half, quarter or eighth of the size, with the size rounded up.
+The downscaling is done directly in the inverse DCT, which is significantly
+cheaper than decoding the full image and downscaling it afterwards, useful for
+example for generating thumbnails or lower mip levels:
+
+@code{.cpp}
+importer->configuration().setValue("downscale", 4);
+Containers::Optional<Trade::ImageData2D> thumbnail = importer->image2D(0);
+@endcode
+
+@subsection Trade-JpegImporter-behavior-speed Decoding speed and quality
+
+The @cb{.ini} dctMethod @ce and @cb{.ini} fancyUpsampling @ce
+@ref Trade-JpegImporter-configuration "configuration options" expose the
+libJPEG tradeoffs between decoding speed and quality. Setting
+@cb{.ini} dctMethod=fast @ce and @cb{.ini} fancyUpsampling=false @ce gives the
+fastest decoding at the cost of slightly less accurate output.
+
+@subsection Trade-JpegImporter-behavior-region Region decoding
+
+The @cb{.ini} region @ce option makes the importer decode only a rectangle of
+the image, specified with the offset from the bottom left corner, as with any
+other image in Magnum, and the size, in the downscaled coordinates if
+@cb{.ini} downscale @ce is set. With libjpeg-turbo 1.5 and newer, rows above
+the region are skipped without the inverse DCT and color conversion and
+columns outside of it aren't decoded at all, except for a few columns to the
+left to align the decoded range to a whole MCU. Rows below the region don't
+need to be decoded at all. With other libJPEG implementations the whole image
+down to the bottom edge of the region is decoded and the region copied out of
+it, saving only the memory for the output.
+
+@subsection Trade-JpegImporter-behavior-ycbcr-planes Raw YCbCr planes
+
+If the @cb{.ini} ycbcrPlanes @ce @ref Trade-JpegImporter-configuration "configuration option"
+is enabled when opening a three-component YCbCr file, @ref image2DCount()
+reports three images instead of one, containing the Y, Cb and Cr plane,
+respectively, each in @ref PixelFormat::R8Unorm. The planes are read with
+libJPEG raw data output, skipping the color conversion and chroma upsampling
+entirely, and keep the subsampling of the file --- for a common 4:2:0 file
+the Cb and Cr planes are half the size of the Y plane in both dimensions,
+which makes the total data size half of an RGB import. The planes can be then
+uploaded to separate textures and converted to RGB in a shader using the
+full-range BT.601 formulas from JFIF:
+
+@f[
+    egin{array}{rcl}
+        R & = & Y + 1.402 (C_r - 0.5) \
+        G & = & Y - 0.344136 (C_b - 0.5) - 0.714136 (C_r - 0.5) \
+        B & = & Y + 1.772 (C_b - 0.5)
+    \end{array}
+@f]
+
+All three planes are decoded together on the first access to any of them and
+each plane is then returned from the decoded data just once, so importing all
+three in any order doesn't decode the file repeatedly. The
+@cb{.ini} downscale @ce and @cb{.ini} dctMethod @ce options are applied to
+all planes. Note that with @cb{.ini} downscale @ce, libJPEG scales the chroma
+planes less than the luma plane if the subsampling allows, so for example a
+4:2:0 file downscaled by 2 results in all three planes having the same size.
+The @cb{.ini} fancyUpsampling @ce option has no effect and the
+@cb{.ini} region @ce option isn't supported in this mode. Grayscale files and
+files in other color spaces are imported as a single image the same way as
+with the option disabled.
+
+@subsection Trade-JpegImporter-behavior-async Asynchronous import
+
+The @ref image2DAsync() function schedules an import of given 2D image level
+on an executor supplied by the application and calls a callback with the
+result once done, so for example a render thread doesn't need to block on
+decoding. The executor gets a job function, a pointer to pass to it and the
+user data pointer, and is expected to call the job exactly once, either
+directly or from any other thread. The job imports the image using
+@ref image2D() and then calls the callback on the same thread, with
+@relativeref{Corrade,Containers::NullOpt} if the import failed.
+
+Asynchronous imports on a single importer instance are executed one after
+another and only one import of a particular image and level can be in flight
+at a time. While any of them are in flight, the importer shouldn't be used
+from other threads except for calling @ref image2DAsync() again. Calling
+@ref close(), opening another file or destroying the importer waits until all
+of them finish.
+
 @section Trade-JpegImporter-implementations libJPEG implementations
 
 While some systems (such as macOS) still ship only with the vanilla libJPEG,
 you can get a much better decoding performance by using
 [libjpeg-turbo](https://libjpeg-turbo.org/).
+
+@section Trade-JpegImporter-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/JpegImporter/JpegImporter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_JPEGIMPORTER_EXPORT JpegImporter: public AbstractImporter {
     public:
@@ -127,6 +226,25 @@ class MAGNUM_JPEGIMPORTER_EXPORT JpegImporter: public AbstractImporter {
 
         ~JpegImporter();
 
+        /**
+         * @brief Import a 2D image asynchronously
+         * @param id        Image ID, from range [0, @ref image2DCount())
+         * @param level     Mip level, from range
+         *      [0, @ref image2DLevelCount())
+         * @param executor  Function running the import job
+         * @param callback  Function called with the imported image
+         * @param userData  User data passed to @p executor and @p callback
+         * @return Whether the import was scheduled
+         * @m_since_latest_{plugins}
+         *
+         * If no file is opened, @p id or @p level is out of range or the
+         * same image and level is already being imported, prints a message
+         * to @relativeref{Magnum,Error} and returns @cpp false @ce without
+         * calling @p executor. See @ref Trade-JpegImporter-behavior-async
+         * for more information.
+         */
+        virtual bool image2DAsync(UnsignedInt id, UnsignedInt level, void(*executor)(void(*)(void*), void*, void*), void(*callback)(UnsignedInt, UnsignedInt, Containers::Optional<ImageData2D>&&, void*), void* userData = nullptr);
+
     private:
         MAGNUM_JPEGIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_JPEGIMPORTER_LOCAL bool doIsOpened() const override;
@@ -137,6 +255,10 @@ class MAGNUM_JPEGIMPORTER_EXPORT JpegImporter: public AbstractImporter {
         MAGNUM_JPEGIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
 
         Containers::Array<char> _in;
+        struct Planes;
+        Containers::Pointer<Planes> _planes;
+        struct AsyncState;
+        Containers::Pointer<AsyncState> _async;
 };
 
 }}
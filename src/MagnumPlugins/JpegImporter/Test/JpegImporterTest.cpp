@@ -26,12 +26,20 @@
 #include <sstream>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector4.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
@@ -48,6 +56,20 @@ struct JpegImporterTest: TestSuite::Tester {
     void gray();
     void rgb();
 
+    void downscale();
+    void downscaleInvalid();
+
+    void dctMethodUpsampling();
+    void dctMethodInvalid();
+
+    void region();
+    void regionInvalid();
+
+    void ycbcrPlanes();
+    void ycbcrPlanesGray();
+    void ycbcrPlanesRegion();
+    void ycbcrPlanesInvalid();
+
     void openMemory();
     void openTwice();
     void importTwice();
@@ -72,6 +94,68 @@ const struct {
     }},
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+    UnsignedInt downscale;
+    PixelFormat format;
+    Vector2i size;
+} DownscaleData[]{
+    {"gray, 2x", "gray.jpg", 2, PixelFormat::R8Unorm, {2, 1}},
+    {"RGB, 2x", "rgb.jpg", 2, PixelFormat::RGB8Unorm, {2, 1}},
+    {"RGB, 4x", "rgb.jpg", 4, PixelFormat::RGB8Unorm, {1, 1}},
+    {"RGB, 8x", "rgb.jpg", 8, PixelFormat::RGB8Unorm, {1, 1}},
+};
+
+const struct {
+    const char* name;
+    const char* dctMethod;
+    bool fancyUpsampling;
+} DctMethodUpsamplingData[]{
+    {"fast", "fast", true},
+    {"float", "float", true},
+    {"no fancy upsampling", "integer", false},
+};
+
+const struct {
+    const char* name;
+    const char* filename;
+    Vector4i region;
+} RegionData[]{
+    {"gray, offset", "gray.jpg", {1, 0, 2, 1}},
+    {"gray, whole width", "gray.jpg", {0, 1, 3, 1}},
+    {"gray, single pixel", "gray.jpg", {2, 1, 1, 1}},
+    {"RGB", "rgb.jpg", {1, 1, 2, 1}},
+};
+
+const struct {
+    const char* name;
+    const char* region;
+    const char* message;
+} RegionInvalidData[]{
+    {"negative offset", "-1 0 1 1",
+        "region {-1, 0, 1, 1} out of range for a {3, 2} image"},
+    {"too wide", "1 0 3 1",
+        "region {1, 0, 3, 1} out of range for a {3, 2} image"},
+    {"too tall", "0 1 1 2",
+        "region {0, 1, 1, 2} out of range for a {3, 2} image"},
+    {"zero width", "0 0 0 1",
+        "region {0, 0, 0, 1} out of range for a {3, 2} image"},
+};
+
+const struct {
+    const char* name;
+    const char* filename;
+    UnsignedInt downscale;
+    Vector2i lumaSize, chromaSize;
+} YCbCrPlanesData[]{
+    {"4:4:4", "rgb.jpg", 1, {3, 2}, {3, 2}},
+    {"4:2:0", "rgb-420.jpg", 1, {6, 4}, {3, 2}},
+    /* libJPEG scales the chroma up in the inverse DCT if it can, so the
+       planes end up having the same size here */
+    {"4:2:0, downscale 2", "rgb-420.jpg", 2, {3, 2}, {3, 2}},
+};
+
 JpegImporterTest::JpegImporterTest() {
     addTests({&JpegImporterTest::empty,
               &JpegImporterTest::invalid,
@@ -79,6 +163,29 @@ JpegImporterTest::JpegImporterTest() {
               &JpegImporterTest::gray,
               &JpegImporterTest::rgb});
 
+    addInstancedTests({&JpegImporterTest::downscale},
+        Containers::arraySize(DownscaleData));
+
+    addTests({&JpegImporterTest::downscaleInvalid});
+
+    addInstancedTests({&JpegImporterTest::dctMethodUpsampling},
+        Containers::arraySize(DctMethodUpsamplingData));
+
+    addTests({&JpegImporterTest::dctMethodInvalid});
+
+    addInstancedTests({&JpegImporterTest::region},
+        Containers::arraySize(RegionData));
+
+    addInstancedTests({&JpegImporterTest::regionInvalid},
+        Containers::arraySize(RegionInvalidData));
+
+    addInstancedTests({&JpegImporterTest::ycbcrPlanes},
+        Containers::arraySize(YCbCrPlanesData));
+
+    addTests({&JpegImporterTest::ycbcrPlanesGray,
+              &JpegImporterTest::ycbcrPlanesRegion,
+              &JpegImporterTest::ycbcrPlanesInvalid});
+
     addInstancedTests({&JpegImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
@@ -170,6 +277,214 @@ void JpegImporterTest::rgb() {
     }), TestSuite::Compare::Container);
 }
 
+void JpegImporterTest::downscale() {
+    auto&& data = DownscaleData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    CORRADE_COMPARE(importer->configuration().value<UnsignedInt>("downscale"), 1);
+    importer->configuration().setValue("downscale", data.downscale);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, data.filename)));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->flags(), ImageFlags2D{});
+    CORRADE_COMPARE(image->size(), data.size);
+    CORRADE_COMPARE(image->format(), data.format);
+    /* The contents are a blurry mix of the original pixels, not comparing
+       those */
+}
+
+void JpegImporterTest::downscaleInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue("downscale", 3);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, "gray.jpg")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(0));
+    CORRADE_COMPARE(out.str(), "Trade::JpegImporter::image2D(): expected downscale to be 1, 2, 4 or 8 but got 3\n");
+}
+
+void JpegImporterTest::dctMethodUpsampling() {
+    auto&& data = DctMethodUpsamplingData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    CORRADE_COMPARE(importer->configuration().value<Containers::StringView>("dctMethod"), "integer");
+    CORRADE_VERIFY(importer->configuration().value<bool>("fancyUpsampling"));
+    importer->configuration().setValue("dctMethod", data.dctMethod);
+    importer->configuration().setValue("fancyUpsampling", data.fancyUpsampling);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, "rgb.jpg")));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB8Unorm);
+
+    /* The output may differ slightly from the default, so compare just the
+       first pixel with a large enough delta. Not using CompareImage as that
+       would need a dependency on DebugTools. */
+    const Containers::StridedArrayView2D<const Color3ub> pixels = image->pixels<Color3ub>();
+    const Color3ub expected{0xca, 0xfe, 0x76};
+    for(std::size_t i = 0; i != 3; ++i)
+        CORRADE_COMPARE_WITH(Int(pixels[0][0][i]), Int(expected[i]), TestSuite::Compare::around(8));
+}
+
+void JpegImporterTest::dctMethodInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue("dctMethod", "slow");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, "gray.jpg")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(0));
+    CORRADE_COMPARE(out.str(), "Trade::JpegImporter::image2D(): expected dctMethod to be integer, fast or float but got slow\n");
+}
+
+void JpegImporterTest::region() {
+    auto&& data = RegionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Decode the whole image as a reference */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    CORRADE_COMPARE(importer->configuration().value<Containers::StringView>("region"), "");
+    /* Chroma upsampling may produce slightly different results at region
+       edges, disable it to have the output match exactly */
+    importer->configuration().setValue("fancyUpsampling", false);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, data.filename)));
+    Containers::Optional<Trade::ImageData2D> expected = importer->image2D(0);
+    CORRADE_VERIFY(expected);
+
+    importer->configuration().setValue("region", data.region);
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), (Vector2i{data.region.z(), data.region.w()}));
+    CORRADE_COMPARE(image->format(), expected->format());
+
+    const Containers::StridedArrayView3D<const char> expectedPixels = expected->pixels().sliceSize(
+        {std::size_t(data.region.y()), std::size_t(data.region.x()), 0},
+        {std::size_t(data.region.w()), std::size_t(data.region.z()), expected->pixelSize()});
+    for(std::size_t y = 0; y != std::size_t(data.region.w()); ++y) {
+        CORRADE_ITERATION(y);
+        for(std::size_t x = 0; x != std::size_t(data.region.z()); ++x) {
+            CORRADE_ITERATION(x);
+            CORRADE_COMPARE_AS(image->pixels()[y][x],
+                expectedPixels[y][x],
+                TestSuite::Compare::Container);
+        }
+    }
+}
+
+void JpegImporterTest::regionInvalid() {
+    auto&& data = RegionInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue("region", data.region);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, "gray.jpg")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(0));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::JpegImporter::image2D(): {}\n", data.message));
+}
+
+void JpegImporterTest::ycbcrPlanes() {
+    auto&& data = YCbCrPlanesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Decode the RGB image as a reference */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue("downscale", data.downscale);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, data.filename)));
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+    Containers::Optional<Trade::ImageData2D> rgb = importer->image2D(0);
+    CORRADE_VERIFY(rgb);
+    CORRADE_COMPARE(rgb->size(), data.lumaSize);
+
+    /* The option is taken into account only when opening */
+    CORRADE_COMPARE(importer->configuration().value<bool>("ycbcrPlanes"), false);
+    importer->configuration().setValue("ycbcrPlanes", true);
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, data.filename)));
+    CORRADE_COMPARE(importer->image2DCount(), 3);
+
+    /* Import the chroma planes first to verify the order doesn't matter */
+    Containers::Optional<Trade::ImageData2D> cr = importer->image2D(2);
+    Containers::Optional<Trade::ImageData2D> y = importer->image2D(0);
+    Containers::Optional<Trade::ImageData2D> cb = importer->image2D(1);
+    CORRADE_VERIFY(y);
+    CORRADE_VERIFY(cb);
+    CORRADE_VERIFY(cr);
+    CORRADE_COMPARE(y->format(), PixelFormat::R8Unorm);
+    CORRADE_COMPARE(cb->format(), PixelFormat::R8Unorm);
+    CORRADE_COMPARE(cr->format(), PixelFormat::R8Unorm);
+    CORRADE_COMPARE(y->size(), data.lumaSize);
+    CORRADE_COMPARE(cb->size(), data.chromaSize);
+    CORRADE_COMPARE(cr->size(), data.chromaSize);
+
+    /* The luma is what the RGB output converts back to, modulo rounding */
+    const Containers::StridedArrayView2D<const Color3ub> rgbPixels = rgb->pixels<Color3ub>();
+    const Containers::StridedArrayView2D<const UnsignedByte> yPixels = y->pixels<UnsignedByte>();
+    for(std::size_t i = 0; i != std::size_t(data.lumaSize.y()); ++i) {
+        CORRADE_ITERATION(i);
+        for(std::size_t j = 0; j != std::size_t(data.lumaSize.x()); ++j) {
+            CORRADE_ITERATION(j);
+            const Color3ub pixel = rgbPixels[i][j];
+            CORRADE_COMPARE_WITH(Int(yPixels[i][j]),
+                Int(Math::round(0.299f*pixel.r() + 0.587f*pixel.g() + 0.114f*pixel.b())),
+                TestSuite::Compare::around(3));
+        }
+    }
+
+    /* Importing a plane again decodes the file again */
+    Containers::Optional<Trade::ImageData2D> cb2 = importer->image2D(1);
+    CORRADE_VERIFY(cb2);
+    CORRADE_COMPARE_AS(cb2->data(), cb->data(),
+        TestSuite::Compare::Container);
+}
+
+void JpegImporterTest::ycbcrPlanesGray() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue("ycbcrPlanes", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, "gray.jpg")));
+
+    /* Imported the same as without the option */
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::R8Unorm);
+}
+
+void JpegImporterTest::ycbcrPlanesRegion() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue("ycbcrPlanes", true);
+    importer->configuration().setValue("region", Vector4i{0, 0, 1, 1});
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, "rgb.jpg")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(1));
+    CORRADE_COMPARE(out.str(), "Trade::JpegImporter::image2D(): region decoding can't be combined with ycbcrPlanes\n");
+}
+
+void JpegImporterTest::ycbcrPlanesInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue("ycbcrPlanes", true);
+
+    #ifdef CORRADE_TARGET_CLANG_CL
+    CORRADE_SKIP("Clang-cl crashes on invalid files, see the invalid() test.");
+    #endif
+
+    /* The header is parsed on opening in this case, so it fails there */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openData("invalid"));
+    CORRADE_COMPARE(out.str(), "Trade::JpegImporter::openData(): error: Not a JPEG file: starts with 0x69 0x6e\n");
+}
+
 void JpegImporterTest::openMemory() {
     /* same as gray() except that it uses openData() & openMemory() instead of
        openFile() to test data copying on import */
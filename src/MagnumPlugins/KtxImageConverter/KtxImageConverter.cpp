@@ -27,6 +27,10 @@
 #include "KtxImageConverter.h"
 
 #include <string>
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <atomic>
+#include <thread>
+#endif
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
@@ -37,14 +41,20 @@
 #include <Corrade/Utility/Endianness.h>
 #include <Corrade/Utility/EndiannessBatch.h>
 #include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Vector3.h>
 
 #include "Magnum/Implementation/formatPluginsVersion.h"
+#include "Magnum/Implementation/instrumentation.h"
 #include "MagnumPlugins/KtxImporter/KtxHeader.h"
 
+#ifdef MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD
+#include <zstd.h>
+#endif
+
 namespace Magnum { namespace Trade {
 
 namespace {
@@ -683,6 +693,34 @@ void endianSwap(Containers::ArrayView<char> data, UnsignedInt typeSize) {
     CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 }
 
+template<UnsignedInt dimensions> bool appendPixels(const BasicImageView<dimensions>& image, std::size_t, UnsignedInt typeSize, const Containers::StringView filename) {
+    /* Copy, endian-swap and write one slice of the outermost dimension at a
+       time, or the whole image for 1D, to avoid having the whole level in
+       memory */
+    const Containers::StridedArrayView<dimensions + 1, const char> srcPixels = image.pixels();
+    const std::size_t step = dimensions == 1 ? srcPixels.size()[0] : 1;
+    std::size_t sliceSize = step;
+    for(std::size_t i = 1; i != dimensions + 1; ++i)
+        sliceSize *= srcPixels.size()[i];
+
+    Containers::Array<char> slice{NoInit, sliceSize};
+    for(std::size_t i = 0; i < srcPixels.size()[0]; i += step) {
+        const Containers::StridedArrayView<dimensions + 1, const char> src = srcPixels.slice(i, i + step);
+        Utility::copy(src, Containers::StridedArrayView<dimensions + 1, char>{slice, src.size()});
+        endianSwap(slice, typeSize);
+        if(!Utility::Path::append(filename, slice))
+            return false;
+    }
+
+    return true;
+}
+
+template<UnsignedInt dimensions> bool appendPixels(const BasicCompressedImageView<dimensions>& image, std::size_t size, UnsignedInt, const Containers::StringView filename) {
+    /** @todo Support CompressedPixelStorage::skip */
+    CORRADE_ASSERT(image.storage() == CompressedPixelStorage{}, "Trade::KtxImageConverter::convertToFile(): non-default compressed storage is not supported", {});
+    return Utility::Path::append(filename, image.data().prefix(size));
+}
+
 using namespace Containers::Literals;
 
 /* Having this inside convertLevels() leads to errors with GCC 4.8 ("cannot
@@ -696,7 +734,10 @@ constexpr Containers::StringView DefaultDirections[3]{
 /* Using a template template parameter to deduce the image dimensions while
    matching both ImageView and CompressedImageView. Matching on the ImageView
    typedefs doesn't work, so we need the extra parameter of BasicImageView. */
-template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Containers::Optional<Containers::Array<char>> convertLevels(Containers::ArrayView<const View<dimensions, const char>> imageLevels, const Utility::ConfigurationGroup& configuration, const ImageConverterFlags converterFlags) {
+/* If filename is non-null, the file is written directly and an empty array is
+   returned on success. Only the header, level index and metadata are
+   assembled in memory in that case, level data are streamed to the file. */
+template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Containers::Optional<Containers::Array<char>> convertLevels(Containers::ArrayView<const View<dimensions, const char>> imageLevels, const Utility::ConfigurationGroup& configuration, const ImageConverterFlags converterFlags, const Containers::StringView* const filename = nullptr) {
     const auto format = imageLevels.front().format();
     if(isFormatImplementationSpecific(format)) {
         Error{} << "Trade::KtxImageConverter::convertToData(): implementation-specific formats are not supported";
@@ -709,7 +750,30 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
         return {};
     }
 
-    const Containers::Array<char> dataFormatDescriptor = fillDataFormatDescriptor(format, vkFormat.second());
+    Implementation::SuperCompressionScheme supercompressionScheme;
+    const auto supercompression = configuration.value<Containers::StringView>("supercompression");
+    if(supercompression.isEmpty())
+        supercompressionScheme = Implementation::SuperCompressionScheme::None;
+    else if(supercompression == "zstd"_s) {
+        #ifdef MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD
+        supercompressionScheme = Implementation::SuperCompressionScheme::Zstandard;
+        #else
+        Error{} << "Trade::KtxImageConverter::convertToData(): the plugin was built without Zstandard supercompression support";
+        return {};
+        #endif
+    } else {
+        Error{} << "Trade::KtxImageConverter::convertToData(): unknown supercompression scheme" << supercompression;
+        return {};
+    }
+
+    Containers::Array<char> dataFormatDescriptor = fillDataFormatDescriptor(format, vkFormat.second());
+
+    /* The bytesPlane fields have to be zero for supercompressed data, as the
+       planes no longer have any fixed size */
+    if(supercompressionScheme != Implementation::SuperCompressionScheme::None) {
+        auto& dfdHeader = *reinterpret_cast<Implementation::KdfBasicBlockHeader*>(dataFormatDescriptor.data() + sizeof(UnsignedInt));
+        for(UnsignedByte& i: dfdHeader.bytesPlane) i = 0;
+    }
 
     /* Fill key/value data. Values can be any byte-string but we only write
        constant text strings. Keys must be sorted alphabetically.
@@ -830,6 +894,12 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
     const Vector3i unitSize = formatUnitSize(format);
     const UnsignedInt unitDataSize = formatUnitDataSize(format);
 
+    /* Offset needs to be aligned to the least common multiple of the
+       texel/block size and 4, and additionally to levelAlignment if set, so
+       the levels can be used directly from a memory-mapped file. Not needed
+       with supercompression. */
+    const std::size_t alignment = leastCommonMultiple(leastCommonMultiple(unitDataSize, 4), Math::max(configuration.value<UnsignedInt>("levelAlignment"), 1u));
+
     for(UnsignedInt i = 0; i != levelIndex.size(); ++i) {
         /* Mip levels are required to be stored from smallest to largest for
            efficient streaming */
@@ -844,22 +914,88 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
             return {};
         }
 
-        /* Offset needs to be aligned to the least common multiple of the
-           texel/block size and 4. Not needed with supercompression. */
-        const std::size_t alignment = leastCommonMultiple(unitDataSize, 4);
-        levelOffset = (levelOffset + alignment - 1)/alignment*alignment;
-
         const Vector3i unitCount = (Vector3i::pad(mipSize, 1) + unitSize - Vector3i{1})/unitSize;
         const std::size_t levelSize = unitDataSize*unitCount.product();
 
-        levelIndex[mip].byteOffset = levelOffset;
         levelIndex[mip].byteLength = levelSize;
         levelIndex[mip].uncompressedByteLength = levelSize;
 
+        /* With supercompression, offsets get calculated only once the
+           compressed sizes are known */
+        if(supercompressionScheme != Implementation::SuperCompressionScheme::None)
+            continue;
+
+        levelOffset = (levelOffset + alignment - 1)/alignment*alignment;
+
+        levelIndex[mip].byteOffset = levelOffset;
+
         levelOffset += levelSize;
     }
 
-    const std::size_t dataSize = levelOffset;
+    /* Supercompress the levels. They're independent, so they can be
+       compressed on multiple threads, each working on whole levels. */
+    Containers::Array<Containers::Array<char>> supercompressedLevels;
+    #ifdef MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD
+    if(supercompressionScheme == Implementation::SuperCompressionScheme::Zstandard) {
+        const Int zstdLevel = configuration.value<Int>("zstdLevel");
+        supercompressedLevels = Containers::Array<Containers::Array<char>>{numMipmaps};
+        Containers::Array<std::size_t> results{ValueInit, numMipmaps};
+
+        std::size_t threadCount = 1;
+        #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+        threadCount = configuration.value<UnsignedInt>("threads");
+        if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+        threadCount = Math::min(threadCount, std::size_t(numMipmaps));
+        std::atomic<UnsignedInt> next{0};
+        #else
+        UnsignedInt next = 0;
+        #endif
+        const auto compress = [&]() {
+            /* Largest levels first so the smallest ones fill in the gaps at
+               the end */
+            for(UnsignedInt mip; (mip = next++) < numMipmaps; ) {
+                Containers::Array<char> pixels{NoInit, std::size_t(levelIndex[mip].uncompressedByteLength)};
+                copyPixels(imageLevels[mip], pixels);
+                endianSwap(pixels, formatTypeSize(format));
+
+                Containers::Array<char>& compressed = supercompressedLevels[mip];
+                compressed = Containers::Array<char>{NoInit, ZSTD_compressBound(pixels.size())};
+                results[mip] = ZSTD_compress(compressed.data(), compressed.size(), pixels.data(), pixels.size(), zstdLevel);
+            }
+        };
+
+        /* The calling thread is one of the workers */
+        #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+        Containers::Array<std::thread> threads{threadCount - 1};
+        for(std::thread& thread: threads)
+            thread = std::thread{compress};
+        compress();
+        for(std::thread& thread: threads)
+            thread.join();
+        #else
+        compress();
+        #endif
+
+        for(UnsignedInt mip = 0; mip != numMipmaps; ++mip) {
+            if(ZSTD_isError(results[mip])) {
+                Error{} << "Trade::KtxImageConverter::convertToData(): Zstandard compression of level" << mip << "failed:" << ZSTD_getErrorName(results[mip]);
+                return {};
+            }
+        }
+
+        /* Same order as above, smallest level first, no alignment */
+        for(UnsignedInt i = 0; i != levelIndex.size(); ++i) {
+            const UnsignedInt mip = levelIndex.size() - 1 - i;
+            levelIndex[mip].byteOffset = levelOffset;
+            levelIndex[mip].byteLength = results[mip];
+            levelOffset += results[mip];
+        }
+    }
+    #endif
+
+    /* When writing to a file, the data array ends where the first level data
+       start, including padding */
+    const std::size_t dataSize = filename ? std::size_t(levelIndex.back().byteOffset) : levelOffset;
     Containers::Array<char> data{ValueInit, dataSize};
 
     std::size_t offset = 0;
@@ -889,22 +1025,27 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
         header.faceCount = 1;
     }
     header.levelCount = levelIndex.size();
-    header.supercompressionScheme = Implementation::SuperCompressionScheme::None;
+    header.supercompressionScheme = supercompressionScheme;
 
-    for(UnsignedInt i = 0; i != levelIndex.size(); ++i) {
+    if(!filename) for(UnsignedInt i = 0; i != levelIndex.size(); ++i) {
         const Implementation::KtxLevel& level = levelIndex[i];
-        const auto& image = imageLevels[i];
         const auto pixels = data.sliceSize(level.byteOffset, level.byteLength);
-        copyPixels(image, pixels);
-
-        endianSwap(pixels, header.typeSize);
+        if(supercompressionScheme != Implementation::SuperCompressionScheme::None) {
+            Utility::copy(supercompressedLevels[i].prefix(level.byteLength), pixels);
+        } else {
+            copyPixels(imageLevels[i], pixels);
+            endianSwap(pixels, header.typeSize);
+        }
+    }
 
+    /* Endian-swap the copy in the output, the original is needed for
+       streaming the level data to a file below */
+    const auto levelIndexOut = Containers::arrayCast<Implementation::KtxLevel>(data.sliceSize(offset, levelIndexSize));
+    Utility::copy(levelIndex, levelIndexOut);
+    for(Implementation::KtxLevel& level: levelIndexOut)
         Utility::Endianness::littleEndianInPlace(
             level.byteOffset, level.byteLength,
             level.uncompressedByteLength);
-    }
-
-    Utility::copy(Containers::arrayCast<const char>(levelIndex), data.sliceSize(offset, levelIndexSize));
     offset += levelIndexSize;
 
     header.dfdByteOffset = offset;
@@ -930,7 +1071,37 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
         header.kvdByteOffset, header.kvdByteLength);
 
     /* GCC 4.8 needs extra help here */
-    return Containers::optional(Utility::move(data));
+    if(!filename)
+        return Containers::optional(Utility::move(data));
+
+    /* Write everything up to the first level, then the levels in the order
+       they're stored in the file with padding in between if needed */
+    if(!Utility::Path::write(*filename, data)) {
+        Error{} << "Trade::KtxImageConverter::convertToFile(): cannot write to file" << *filename;
+        return {};
+    }
+    std::size_t fileOffset = data.size();
+    /* The padding is always less than the alignment */
+    const Containers::Array<char> zeros{ValueInit, alignment};
+    for(UnsignedInt i = 0; i != levelIndex.size(); ++i) {
+        const UnsignedInt mip = levelIndex.size() - 1 - i;
+        const Implementation::KtxLevel& level = levelIndex[mip];
+
+        CORRADE_INTERNAL_ASSERT(level.byteOffset >= fileOffset && level.byteOffset - fileOffset < zeros.size());
+        const std::size_t padding = level.byteOffset - fileOffset;
+        if((padding && !Utility::Path::append(*filename, zeros.prefix(padding))) ||
+           !(supercompressionScheme != Implementation::SuperCompressionScheme::None ?
+                Utility::Path::append(*filename, supercompressedLevels[mip].prefix(level.byteLength)) :
+                appendPixels(imageLevels[mip], level.byteLength, formatTypeSize(format), *filename)))
+        {
+            Error{} << "Trade::KtxImageConverter::convertToFile(): cannot write to file" << *filename;
+            return {};
+        }
+
+        fileOffset = level.byteOffset + level.byteLength;
+    }
+
+    return Containers::optional(Containers::Array<char>{});
 }
 
 }
@@ -954,29 +1125,65 @@ Containers::String KtxImageConverter::doMimeType() const {
 }
 
 Containers::Optional<Containers::Array<char>> KtxImageConverter::doConvertToData(Containers::ArrayView<const ImageView1D> imageLevels) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
     return convertLevels(imageLevels, configuration(), flags());
 }
 
 Containers::Optional<Containers::Array<char>> KtxImageConverter::doConvertToData(Containers::ArrayView<const ImageView2D> imageLevels) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
     return convertLevels(imageLevels, configuration(), flags());
 }
 
 Containers::Optional<Containers::Array<char>> KtxImageConverter::doConvertToData(Containers::ArrayView<const ImageView3D> imageLevels) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
     return convertLevels(imageLevels, configuration(), flags());
 }
 
 Containers::Optional<Containers::Array<char>> KtxImageConverter::doConvertToData(Containers::ArrayView<const CompressedImageView1D> imageLevels) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
     return convertLevels(imageLevels, configuration(), flags());
 }
 
 Containers::Optional<Containers::Array<char>> KtxImageConverter::doConvertToData(Containers::ArrayView<const CompressedImageView2D> imageLevels) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
     return convertLevels(imageLevels, configuration(), flags());
 }
 
 Containers::Optional<Containers::Array<char>> KtxImageConverter::doConvertToData(Containers::ArrayView<const CompressedImageView3D> imageLevels) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
     return convertLevels(imageLevels, configuration(), flags());
 }
 
+bool KtxImageConverter::doConvertToFile(Containers::ArrayView<const ImageView1D> imageLevels, const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToFile", filename};
+    return bool(convertLevels(imageLevels, configuration(), flags(), &filename));
+}
+
+bool KtxImageConverter::doConvertToFile(Containers::ArrayView<const ImageView2D> imageLevels, const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToFile", filename};
+    return bool(convertLevels(imageLevels, configuration(), flags(), &filename));
+}
+
+bool KtxImageConverter::doConvertToFile(Containers::ArrayView<const ImageView3D> imageLevels, const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToFile", filename};
+    return bool(convertLevels(imageLevels, configuration(), flags(), &filename));
+}
+
+bool KtxImageConverter::doConvertToFile(Containers::ArrayView<const CompressedImageView1D> imageLevels, const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToFile", filename};
+    return bool(convertLevels(imageLevels, configuration(), flags(), &filename));
+}
+
+bool KtxImageConverter::doConvertToFile(Containers::ArrayView<const CompressedImageView2D> imageLevels, const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToFile", filename};
+    return bool(convertLevels(imageLevels, configuration(), flags(), &filename));
+}
+
+bool KtxImageConverter::doConvertToFile(Containers::ArrayView<const CompressedImageView3D> imageLevels, const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToFile", filename};
+    return bool(convertLevels(imageLevels, configuration(), flags(), &filename));
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(KtxImageConverter, Magnum::Trade::KtxImageConverter,
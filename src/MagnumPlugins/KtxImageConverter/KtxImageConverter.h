@@ -129,11 +129,65 @@ and depth divided by two, rounded down. Array and cube map images differ in
 that they don't shrink along the last dimension. Incomplete mip chains are
 supported.
 
+@subsection Trade-KtxImageConverter-behavior-streaming Writing to files
+
+When using @ref convertToFile(), only the header, level index and metadata are
+assembled in memory. Level data are then written directly to the file in the
+order they're stored in it, smallest level first, with uncompressed images
+copied one slice of the outermost dimension at a time. This means converting
+for example a large 3D texture doesn't need a second copy of it in memory. The
+exception are @ref Trade-KtxImageConverter-behavior-supercompression "supercompressed files",
+where the compressed data of all levels are kept in memory until they're
+written.
+
 @subsection Trade-KtxImageConverter-behavior-supercompression Supercompression
 
-Saving files with [supercompression](https://github.khronos.org/KTX-Specification/#supercompressionSchemes)
-is not supported. You can however use @ref BasisImageConverter to create
-Basis-supercompressed KTX2 files.
+If the plugin is built with the [zstd](https://github.com/facebook/zstd)
+library, which is an optional dependency used if found when building the
+plugin, level data can be saved with Zstandard [supercompression](https://github.khronos.org/KTX-Specification/#supercompressionSchemes)
+by setting the @cb{.ini} supercompression @ce
+@ref Trade-KtxImageConverter-configuration "configuration option" to
+@cb{.ini} zstd @ce. The compression level is controlled with the
+@cb{.ini} zstdLevel @ce option. Such files can be imported with
+@ref KtxImporter if it's built with Zstandard support as well. Other schemes
+such as ZLIB aren't supported for writing, you can however use
+@ref BasisImageConverter to create Basis-supercompressed KTX2 files.
+
+Each level is compressed independently. Setting the @cb{.ini} threads @ce
+option to a value other than @cpp 1 @ce compresses the levels on multiple
+threads, with the smallest levels filling in while the largest ones are still
+being compressed. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+application has to be linked to `pthread` on Linux for this to work.
+
+@subsection Trade-KtxImageConverter-behavior-gpu-ready GPU-ready files
+
+Files written with the default @cb{.ini} orientation @ce and without
+supercompression need no pixel processing when imported with
+@ref KtxImporter on little-endian platforms, as the levels are stored in the
+orientation and channel order used by Magnum, smallest level first. For
+content that needs transcoding to a platform-specific format, such as Basis
+Universal files, transcode with @ref BasisImporter set to the desired target
+format first and save the result with this plugin, producing one file per
+target platform. Setting the @cb{.ini} levelAlignment @ce
+@ref Trade-KtxImageConverter-configuration "configuration option" to the page
+size then makes each level start at a page boundary. With the
+@cb{.ini} mapFile @ce and @cb{.ini} zeroCopy @ce options enabled in
+@ref KtxImporter, importing a level is then only a matter of returning a view
+on the memory-mapped file, see @ref Trade-KtxImporter-behavior-zero-copy for
+more information.
+
+@code{.cpp}
+converter->configuration().setValue("levelAlignment", 4096);
+converter->convertToFile(levels, "texture.bc7.ktx2");
+
+// at runtime
+
+importer->configuration().setValue("mapFile", true);
+importer->configuration().setValue("zeroCopy", true);
+importer->openFile("texture.bc7.ktx2");
+Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, level);
+@endcode
 
 @section Trade-KtxImageConverter-configuration Plugin-specific configuration
 
@@ -162,6 +216,14 @@ class MAGNUM_KTXIMAGECONVERTER_EXPORT KtxImageConverter: public AbstractImageCon
         MAGNUM_KTXIMAGECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(Containers::ArrayView<const CompressedImageView1D> imageLevels) override;
         MAGNUM_KTXIMAGECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(Containers::ArrayView<const CompressedImageView2D> imageLevels) override;
         MAGNUM_KTXIMAGECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(Containers::ArrayView<const CompressedImageView3D> imageLevels) override;
+
+        MAGNUM_KTXIMAGECONVERTER_LOCAL bool doConvertToFile(Containers::ArrayView<const ImageView1D> imageLevels, Containers::StringView filename) override;
+        MAGNUM_KTXIMAGECONVERTER_LOCAL bool doConvertToFile(Containers::ArrayView<const ImageView2D> imageLevels, Containers::StringView filename) override;
+        MAGNUM_KTXIMAGECONVERTER_LOCAL bool doConvertToFile(Containers::ArrayView<const ImageView3D> imageLevels, Containers::StringView filename) override;
+
+        MAGNUM_KTXIMAGECONVERTER_LOCAL bool doConvertToFile(Containers::ArrayView<const CompressedImageView1D> imageLevels, Containers::StringView filename) override;
+        MAGNUM_KTXIMAGECONVERTER_LOCAL bool doConvertToFile(Containers::ArrayView<const CompressedImageView2D> imageLevels, Containers::StringView filename) override;
+        MAGNUM_KTXIMAGECONVERTER_LOCAL bool doConvertToFile(Containers::ArrayView<const CompressedImageView3D> imageLevels, Containers::StringView filename) override;
 };
 
 }}
@@ -30,9 +30,12 @@
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/PluginManager/PluginMetadata.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/File.h>
+#include <Corrade/TestSuite/Compare/FileToString.h>
 #include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
 #include <Corrade/Utility/Algorithms.h>
@@ -52,6 +55,7 @@
 #include <Magnum/Trade/ImageData.h>
 
 #include "MagnumPlugins/KtxImporter/KtxHeader.h"
+#include "MagnumPlugins/KtxImageConverter/configure.h"
 
 #include "configure.h"
 
@@ -105,6 +109,9 @@ struct KtxImageConverterTest: TestSuite::Tester {
 
     void convertFormats();
 
+    void convertToFile();
+    void convertToFileCompressed();
+
     void pvrtcRgb();
 
     void configurationOrientation();
@@ -120,6 +127,10 @@ struct KtxImageConverterTest: TestSuite::Tester {
 
     void configurationEmpty();
     void configurationSorted();
+    void configurationLevelAlignment();
+
+    void supercompression();
+    void supercompressionUnknown();
 
     void convertTwice();
 
@@ -363,6 +374,15 @@ Containers::String readKeyValueData(Containers::ArrayView<const char> fileData)
     return data;
 }
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+} SupercompressionData[]{
+    {"", 1},
+    {"multithreaded", 3},
+    {"all threads", 0},
+};
+
 KtxImageConverterTest::KtxImageConverterTest() {
     addTests({&KtxImageConverterTest::supportedFormat,
               &KtxImageConverterTest::supportedCompressedFormat,
@@ -411,6 +431,9 @@ KtxImageConverterTest::KtxImageConverterTest() {
               &KtxImageConverterTest::convert3DCompressed,
               &KtxImageConverterTest::convert3DCompressedMipmaps});
 
+    addTests({&KtxImageConverterTest::convertToFile,
+              &KtxImageConverterTest::convertToFileCompressed});
+
     addInstancedTests({&KtxImageConverterTest::convertFormats},
         Containers::arraySize(ConvertFormatsData));
 
@@ -440,6 +463,12 @@ KtxImageConverterTest::KtxImageConverterTest() {
         Containers::arraySize(QuietData));
 
     addTests({&KtxImageConverterTest::configurationSorted,
+              &KtxImageConverterTest::configurationLevelAlignment});
+
+    addInstancedTests({&KtxImageConverterTest::supercompression},
+        Containers::arraySize(SupercompressionData));
+
+    addTests({&KtxImageConverterTest::supercompressionUnknown,
 
               &KtxImageConverterTest::convertTwice});
 
@@ -453,6 +482,9 @@ KtxImageConverterTest::KtxImageConverterTest() {
     CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(KTXIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
     #endif
 
+    /* Create the output directory if it doesn't exist yet */
+    CORRADE_INTERNAL_ASSERT_OUTPUT(Utility::Path::make(KTXIMAGECONVERTER_TEST_OUTPUT_DIR));
+
     /* Extract VkFormat and DFD content from merged DFD file */
     dfdData = *CORRADE_INTERNAL_ASSERT_EXPRESSION(Utility::Path::read(Utility::Path::join(KTXIMAGECONVERTER_TEST_DIR, "dfd-data.bin")));
     CORRADE_INTERNAL_ASSERT(!dfdData.isEmpty());
@@ -1173,6 +1205,56 @@ void KtxImageConverterTest::convert3DCompressedMipmaps() {
         TestSuite::Compare::StringToFile);
 }
 
+void KtxImageConverterTest::convertToFile() {
+    /* Same as convert3DMipmaps(), but streaming the data to a file. The file
+       has padding between levels as the RGB8 levels need a 12-byte
+       alignment. */
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
+    converter->configuration().setValue("orientation", "rdi");
+
+    const Vector3i size{4, 3, 3};
+    const auto mip0 = Containers::arrayCast<const Color3ub>(Containers::arrayView(PatternRgbData));
+    const Color3ub mip1[2]{0xffffff_rgb, 0x007f7f_rgb};
+    const Color3ub mip2[1]{0x000000_rgb};
+
+    PixelStorage storage;
+    storage.setAlignment(1);
+    const ImageView3D inputImages[3]{
+        ImageView3D{storage, PixelFormat::RGB8Srgb, Math::max(size >> 0, 1), mip0},
+        ImageView3D{storage, PixelFormat::RGB8Srgb, Math::max(size >> 1, 1), mip1},
+        ImageView3D{storage, PixelFormat::RGB8Srgb, Math::max(size >> 2, 1), mip2}
+    };
+
+    Containers::String filename = Utility::Path::join(KTXIMAGECONVERTER_TEST_OUTPUT_DIR, "3d-mipmaps.ktx2");
+    if(Utility::Path::exists(filename))
+        CORRADE_VERIFY(Utility::Path::remove(filename));
+
+    CORRADE_VERIFY(converter->convertToFile(inputImages, filename));
+    CORRADE_COMPARE_AS(filename,
+        Utility::Path::join(KTXIMPORTER_TEST_DIR, "3d-mipmaps.ktx2"),
+        TestSuite::Compare::File);
+}
+
+void KtxImageConverterTest::convertToFileCompressed() {
+    /* Same as convert3DCompressed(), but streaming the data to a file */
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
+    converter->configuration().setValue("orientation", "rdi");
+    converter->configuration().setValue("generator", WriterPVRTexTool);
+
+    Containers::Optional<Containers::Array<char>> blockData = Utility::Path::read(Utility::Path::join(KTXIMPORTER_TEST_DIR, "3d-compressed-etc2rgb8.bin"));
+    CORRADE_VERIFY(blockData);
+    const CompressedImageView3D inputImage{CompressedPixelFormat::Etc2RGB8Srgb, {9, 10, 3}, *blockData};
+
+    Containers::String filename = Utility::Path::join(KTXIMAGECONVERTER_TEST_OUTPUT_DIR, "3d-compressed-etc2rgb8.ktx2");
+    if(Utility::Path::exists(filename))
+        CORRADE_VERIFY(Utility::Path::remove(filename));
+
+    CORRADE_VERIFY(converter->convertToFile(inputImage, filename));
+    CORRADE_COMPARE_AS(filename,
+        Utility::Path::join(KTXIMPORTER_TEST_DIR, "3d-compressed-etc2rgb8.ktx2"),
+        TestSuite::Compare::File);
+}
+
 void KtxImageConverterTest::convertFormats() {
     auto&& data = ConvertFormatsData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -1441,6 +1523,139 @@ void KtxImageConverterTest::configurationSorted() {
     CORRADE_VERIFY(swizzleOffset.begin() < writerOffset.begin());
 }
 
+void KtxImageConverterTest::configurationLevelAlignment() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
+    converter->configuration().setValue("levelAlignment", 4096);
+
+    const Color3ub mip0[4*2]{};
+    const Color3ub mip1[2*1]{};
+    const Color3ub mip2[1*1]{};
+
+    PixelStorage storage;
+    storage.setAlignment(1);
+    const ImageView2D inputImages[3]{
+        ImageView2D{storage, PixelFormat::RGB8Unorm, {4, 2}, mip0},
+        ImageView2D{storage, PixelFormat::RGB8Unorm, {2, 1}, mip1},
+        ImageView2D{storage, PixelFormat::RGB8Unorm, {1, 1}, mip2}
+    };
+
+    Containers::Optional<Containers::Array<char>> output = converter->convertToData(inputImages);
+    CORRADE_VERIFY(output);
+
+    /* Streaming to a file should give the same result */
+    Containers::String filename = Utility::Path::join(KTXIMAGECONVERTER_TEST_OUTPUT_DIR, "level-alignment.ktx2");
+    CORRADE_VERIFY(converter->convertToFile(inputImages, filename));
+    CORRADE_COMPARE_AS(filename, Containers::StringView{*output}, TestSuite::Compare::FileToString);
+
+    /* Levels are stored smallest first, each aligned to a multiple of both
+       the page size and the 3-byte pixel size, i.e. 12288 bytes */
+    const auto levels = Containers::arrayCast<const Implementation::KtxLevel>(output->sliceSize(sizeof(Implementation::KtxHeader), 3*sizeof(Implementation::KtxLevel)));
+    CORRADE_COMPARE(Utility::Endianness::littleEndian(levels[2].byteOffset), 12288);
+    CORRADE_COMPARE(Utility::Endianness::littleEndian(levels[1].byteOffset), 2*12288);
+    CORRADE_COMPARE(Utility::Endianness::littleEndian(levels[0].byteOffset), 3*12288);
+    CORRADE_COMPARE(output->size(), 3*12288 + 4*2*3);
+
+    if(_importerManager.loadState("KtxImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("KtxImporter plugin not found, cannot test");
+
+    /* The default orientation needs no flip, so the images can be imported
+       as views */
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("KtxImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(importer->openMemory(*output));
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 3);
+    for(UnsignedInt i = 0; i != 3; ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, i);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+        CORRADE_COMPARE(image->size(), inputImages[i].size());
+        CORRADE_COMPARE(image->data().data(), static_cast<const void*>(output->data() + Utility::Endianness::littleEndian(levels[i].byteOffset)));
+    }
+}
+
+void KtxImageConverterTest::supercompression() {
+    auto&& data = SupercompressionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD
+    CORRADE_SKIP("KtxImageConverter was built without Zstandard support.");
+    #else
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
+    converter->configuration().setValue("supercompression", "zstd");
+    converter->configuration().setValue("threads", data.threads);
+
+    constexpr Vector2i size{4, 3};
+    const auto mip0 = Containers::arrayCast<const Color3ub>(Containers::arrayView(
+        PatternRgbData[Containers::arraySize(PatternRgbData) - 1]));
+    const Color3ub mip1[2]{0xffffff_rgb, 0x007f7f_rgb};
+    const Color3ub mip2[1]{0x000000_rgb};
+
+    PixelStorage storage;
+    storage.setAlignment(1);
+    const ImageView2D inputImages[3]{
+        ImageView2D{storage, PixelFormat::RGB8Srgb, Math::max(size >> 0, 1), mip0},
+        ImageView2D{storage, PixelFormat::RGB8Srgb, Math::max(size >> 1, 1), mip1},
+        ImageView2D{storage, PixelFormat::RGB8Srgb, Math::max(size >> 2, 1), mip2}
+    };
+
+    Containers::Optional<Containers::Array<char>> output = converter->convertToData(inputImages);
+    CORRADE_VERIFY(output);
+
+    /* Streaming to a file should give the same result */
+    Containers::String filename = Utility::Path::join(KTXIMAGECONVERTER_TEST_OUTPUT_DIR, "supercompressed.ktx2");
+    CORRADE_VERIFY(converter->convertToFile(inputImages, filename));
+    CORRADE_COMPARE_AS(filename, Containers::StringView{*output}, TestSuite::Compare::FileToString);
+
+    const Implementation::KtxHeader& header = *reinterpret_cast<const Implementation::KtxHeader*>(output->data());
+    CORRADE_COMPARE(Utility::Endianness::littleEndian(header.supercompressionScheme), Implementation::SuperCompressionScheme::Zstandard);
+
+    /* Uncompressed lengths are preserved, levels are stored smallest first
+       with no padding */
+    const auto levels = Containers::arrayCast<const Implementation::KtxLevel>(output->sliceSize(sizeof(Implementation::KtxHeader), 3*sizeof(Implementation::KtxLevel)));
+    CORRADE_COMPARE(Utility::Endianness::littleEndian(levels[0].uncompressedByteLength), 4*3*3);
+    CORRADE_COMPARE(Utility::Endianness::littleEndian(levels[1].uncompressedByteLength), 2*1*3);
+    CORRADE_COMPARE(Utility::Endianness::littleEndian(levels[2].uncompressedByteLength), 1*1*3);
+    CORRADE_COMPARE(Utility::Endianness::littleEndian(levels[1].byteOffset),
+        Utility::Endianness::littleEndian(levels[2].byteOffset) +
+        Utility::Endianness::littleEndian(levels[2].byteLength));
+    CORRADE_COMPARE(Utility::Endianness::littleEndian(levels[0].byteOffset),
+        Utility::Endianness::littleEndian(levels[1].byteOffset) +
+        Utility::Endianness::littleEndian(levels[1].byteLength));
+    CORRADE_COMPARE(Utility::Endianness::littleEndian(levels[0].byteOffset) +
+        Utility::Endianness::littleEndian(levels[0].byteLength), output->size());
+
+    if(_importerManager.loadState("KtxImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("KtxImporter plugin not found, cannot test");
+
+    /* KtxImporter finds Zstd the same way, so if the converter has it, the
+       importer has it too */
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("KtxImporter");
+    importer->configuration().setValue("assumeOrientation", "ru");
+    CORRADE_VERIFY(importer->openData(*output));
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 3);
+    for(UnsignedInt i = 0; i != 3; ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, i);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), inputImages[i].size());
+        CORRADE_COMPARE_AS(image->pixels<Color3ub>(), inputImages[i].pixels<Color3ub>(), TestSuite::Compare::Container);
+    }
+    #endif
+}
+
+void KtxImageConverterTest::supercompressionUnknown() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
+    converter->configuration().setValue("supercompression", "lzma");
+
+    const UnsignedByte bytes[4]{};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, bytes}));
+    CORRADE_COMPARE(out.str(), "Trade::KtxImageConverter::convertToData(): unknown supercompression scheme lzma\n");
+}
+
 void KtxImageConverterTest::convertTwice() {
     Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
 
@@ -28,3 +28,4 @@
 #cmakedefine KTXIMPORTER_PLUGIN_FILENAME "${KTXIMPORTER_PLUGIN_FILENAME}"
 #define KTXIMPORTER_TEST_DIR "${KTXIMPORTER_TEST_DIR}"
 #define KTXIMAGECONVERTER_TEST_DIR "${KTXIMAGECONVERTER_TEST_DIR}"
+#define KTXIMAGECONVERTER_TEST_OUTPUT_DIR "${KTXIMAGECONVERTER_TEST_OUTPUT_DIR}"
@@ -32,6 +32,7 @@
 #include <Corrade/Containers/StaticArray.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringIterable.h>
+#include <Corrade/Containers/StringStl.h> /** @todo remove once file callbacks are <string>-free */
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/PluginManager/PluginMetadata.h>
 #include <Corrade/Utility/Algorithms.h>
@@ -40,6 +41,7 @@
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once PluginMetadata is <string>-free */
 #include <Corrade/Utility/Endianness.h>
 #include <Corrade/Utility/EndiannessBatch.h>
+#include <Corrade/Utility/Path.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/BitVector.h>
 #include <Magnum/Math/ColorBatch.h>
@@ -48,12 +50,24 @@
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/Math/Vector4.h>
 #include <Magnum/Trade/ImageData.h>
+#include "Magnum/Implementation/asyncImageImport.h"
+#include "Magnum/Implementation/instrumentation.h"
+#include "Magnum/Implementation/mapFile.h"
+#include "Magnum/Implementation/outputAllocator.h"
+#include "Magnum/Implementation/profilingZone.h"
 #include "MagnumPlugins/KtxImporter/KtxHeader.h"
 
 #ifdef MAGNUM_BUILD_DEPRECATED
 #include <Magnum/Trade/TextureData.h>
 #endif
 
+#ifdef MAGNUM_KTXIMPORTER_WITH_ZSTD
+#include <zstd.h>
+#endif
+#ifdef MAGNUM_KTXIMPORTER_WITH_ZLIB
+#include <zlib.h>
+#endif
+
 namespace Magnum { namespace Trade {
 
 namespace {
@@ -262,11 +276,31 @@ Containers::Optional<Format> decodeFormat(Implementation::VkFormat vkFormat) {
 struct KtxImporter::File {
     struct LevelData {
         Vector3i size;
-        Containers::ArrayView<char> data;
+        /* Relative to the start of the (decompressed) mip level data, as 3D
+           array images are multiple images stored in a single mip level */
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    struct Level {
+        /* View on the input data. For supercompressed files it's the
+           compressed data, decompressed on first access in doImage() */
+        Containers::ArrayView<const char> data;
+        std::size_t uncompressedLength;
+        Containers::Array<char> decompressed;
     };
 
     Containers::Array<char> in;
 
+    /* Memory-mapped input file, if the mapFile option was enabled. The `in`
+       array is a non-owning view on it in that case. */
+    #ifdef MAGNUM_IMPLEMENTATION_MAP_FILE
+    Magnum::Implementation::MappedFile mapped;
+    #endif
+
+    Implementation::SuperCompressionScheme supercompressionScheme;
+    Containers::Array<Level> levels;
+
     /* Dimensions of the source image (1-3) */
     UnsignedByte numDimensions;
     /* Dimensions of the imported image data, including extra dimensions for
@@ -286,9 +320,23 @@ struct KtxImporter::File {
 
 KtxImporter::KtxImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
 
-KtxImporter::~KtxImporter() = default;
+struct KtxImporter::AsyncState: Magnum::Implementation::AsyncImageImport {};
+
+KtxImporter::~KtxImporter() {
+    if(_async) _async->wait();
+}
+
+bool KtxImporter::image2DAsync(const UnsignedInt id, const UnsignedInt level, void(*const executor)(void(*)(void*), void*, void*), void(*const callback)(UnsignedInt, UnsignedInt, Containers::Optional<ImageData2D>&&, void*), void* const userData) {
+    if(!_async) _async.emplace();
+    return _async->schedule("Trade::KtxImporter::image2DAsync():", *this, id, level, executor, callback, userData);
+}
+
+void KtxImporter::setOutputAllocator(char*(*const allocator)(std::size_t, void*), void* const userData) {
+    _outputAllocator = allocator;
+    _outputAllocatorUserData = userData;
+}
 
-ImporterFeatures KtxImporter::doFeatures() const { return ImporterFeature::OpenData; }
+ImporterFeatures KtxImporter::doFeatures() const { return ImporterFeature::OpenData|ImporterFeature::FileCallback; }
 
 bool KtxImporter::doIsOpened() const {
     /* Only one of these can be populated at a time */
@@ -297,11 +345,50 @@ bool KtxImporter::doIsOpened() const {
 }
 
 void KtxImporter::doClose() {
+    /* In-flight asynchronous imports reference the file, wait for them */
+    if(_async) _async->wait();
     _f = nullptr;
     _basisImporter = nullptr;
 }
 
+void KtxImporter::doOpenFile(const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenFile", filename};
+    /* The file is kept referenced for the whole time it's opened, load it
+       permanently and reference the returned view instead of copying it.
+       If the callback returns a memory-mapped file, only the header, level
+       index and metadata are paged in on open, and the levels only when
+       they're actually imported. */
+    if(fileCallback()) {
+        const Containers::Optional<Containers::ArrayView<const char>> view = fileCallback()(filename, InputFileCallbackPolicy::LoadPermanent, fileCallbackUserData());
+        if(!view) {
+            Error{} << "Trade::KtxImporter::openFile(): cannot open file" << filename;
+            return;
+        }
+
+        doOpenData(Containers::Array<char>{const_cast<char*>(view->data()), view->size(), [](char*, std::size_t){}}, DataFlag::ExternallyOwned);
+        return;
+    }
+
+    /* Same as above, but with the file mapped by us */
+    #ifdef MAGNUM_IMPLEMENTATION_MAP_FILE
+    if(configuration().value<bool>("mapFile")) {
+        Containers::Optional<Magnum::Implementation::MappedFile> mapped = Magnum::Implementation::openMappedFile("Trade::KtxImporter::openFile():", filename, [this](Containers::Array<char>&& data, const DataFlags dataFlags) {
+            doOpenData(Utility::move(data), dataFlags);
+        });
+
+        /* Keep the mapping alive for as long as the file is opened. If the
+           file was forwarded to BasisImporter, it made its own copy and the
+           mapping can be dropped right away. */
+        if(mapped && _f) _f->mapped = Utility::move(*mapped);
+        return;
+    }
+    #endif
+
+    AbstractImporter::doOpenFile(filename);
+}
+
 void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     /* Check if the file is long enough for the header */
     if(data.size() < sizeof(Implementation::KtxHeader)) {
         Error{} << "Trade::KtxImporter::openData(): file too short, expected"
@@ -499,11 +586,26 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
         return;
     }
 
-    /** @todo Support supercompression */
-    if(header.supercompressionScheme != Implementation::SuperCompressionScheme::None) {
-        Error{} << "Trade::KtxImporter::openData(): supercompression is currently not supported";
+    /* BasisLZ is handled above, Zstandard and ZLIB only if the plugin is
+       built with the corresponding library */
+    if(header.supercompressionScheme == Implementation::SuperCompressionScheme::BasisLZ) {
+        Error{} << "Trade::KtxImporter::openData(): BasisLZ supercompression is supported only for Basis Universal images";
+        return;
+    } else if(header.supercompressionScheme == Implementation::SuperCompressionScheme::Zstandard) {
+        #ifndef MAGNUM_KTXIMPORTER_WITH_ZSTD
+        Error{} << "Trade::KtxImporter::openData(): the plugin was built without Zstandard supercompression support";
+        return;
+        #endif
+    } else if(header.supercompressionScheme == Implementation::SuperCompressionScheme::ZLIB) {
+        #ifndef MAGNUM_KTXIMPORTER_WITH_ZLIB
+        Error{} << "Trade::KtxImporter::openData(): the plugin was built without ZLIB supercompression support";
+        return;
+        #endif
+    } else if(header.supercompressionScheme != Implementation::SuperCompressionScheme::None) {
+        Error{} << "Trade::KtxImporter::openData(): unknown supercompression scheme" << UnsignedInt(header.supercompressionScheme);
         return;
     }
+    f->supercompressionScheme = header.supercompressionScheme;
 
     /* typeSize is the size of the format's underlying type, not the texel
        size, e.g. 2 for RG16F. For any sane format it should be a
@@ -555,7 +657,7 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
        smallest. Each mipmap contains tightly packed images ordered by
        layers, faces/slices, rows, columns. */
     const std::size_t levelIndexSize = numMipmaps*sizeof(Implementation::KtxLevel);
-    const auto levelIndex = Containers::arrayCast<Implementation::KtxLevel>(
+    const auto levelIndex = Containers::arrayCast<const Implementation::KtxLevel>(
         f->in.sliceSize(sizeof(Implementation::KtxHeader), levelIndexSize));
 
     /* Extract image data views. Only one image with extra dimensions for array
@@ -566,10 +668,12 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
     f->imageData = Containers::Array<Containers::Array<File::LevelData>>{numImages};
     for(UnsignedInt image = 0; image != numImages; ++image)
         f->imageData[image] = Containers::Array<File::LevelData>{numMipmaps};
+    f->levels = Containers::Array<File::Level>{numMipmaps};
 
     Vector3i mipSize{size};
     for(UnsignedInt i = 0; i != numMipmaps; ++i) {
-        auto& level = levelIndex[i];
+        /* Copy so externally owned memory isn't modified on big-endian */
+        Implementation::KtxLevel level = levelIndex[i];
         Utility::Endianness::littleEndianInPlace(level.byteOffset,
             level.byteLength, level.uncompressedByteLength);
 
@@ -607,16 +711,25 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
             imageLength = levelSize.product()*f->pixelFormat.size;
         const std::size_t totalLength = imageLength*numImages;
 
-        if(level.byteLength < totalLength) {
-            Error{} << "Trade::KtxImporter::openData(): level data too short, "
-                "expected at least" << totalLength << "bytes but got" << level.byteLength;
+        /* For supercompressed data we can only check the uncompressed size
+           here, whether the data actually decompress to it is checked in
+           doImage() */
+        if(header.supercompressionScheme == Implementation::SuperCompressionScheme::None) {
+            if(level.byteLength < totalLength) {
+                Error{} << "Trade::KtxImporter::openData(): level data too short, "
+                    "expected at least" << totalLength << "bytes but got" << level.byteLength;
+                return;
+            }
+        } else if(level.uncompressedByteLength < totalLength) {
+            Error{} << "Trade::KtxImporter::openData(): uncompressed level data too short, "
+                "expected at least" << totalLength << "bytes but got" << level.uncompressedByteLength;
             return;
         }
 
-        for(UnsignedInt image = 0; image != numImages; ++image) {
-            const std::size_t offset = level.byteOffset + image*imageLength;
-            f->imageData[image][i] = {levelSize, f->in.sliceSize(offset, imageLength)};
-        }
+        f->levels[i].data = f->in.sliceSize(level.byteOffset, level.byteLength);
+        f->levels[i].uncompressedLength = level.uncompressedByteLength;
+        for(UnsignedInt image = 0; image != numImages; ++image)
+            f->imageData[image][i] = {levelSize, image*imageLength, imageLength};
 
         /* Halve each dimension, rounding down */
         mipSize = Math::max(mipSize >> 1, 1);
@@ -857,10 +970,113 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
     _f = Utility::move(f);
 }
 
-template<UnsignedInt dimensions> ImageData<dimensions> KtxImporter::doImage(const char* messagePrefix, UnsignedInt id, UnsignedInt level) {
+template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> KtxImporter::doImage(const char* messagePrefix, UnsignedInt id, UnsignedInt level) {
+    MAGNUM_PROFILING_ZONE("KtxImporter level loading");
     const File::LevelData& levelData = _f->imageData[id][level];
-    const auto size = Math::Vector<dimensions, Int>::pad(levelData.size);
-    Containers::Array<char> data{NoInit, levelData.data.size()};
+
+    /* Decompress the whole mip level if it's supercompressed and wasn't
+       accessed yet. It's kept around as 3D array images have all layers in a
+       single level and it's likely that more than one will be imported. */
+    File::Level& levelInfo = _f->levels[level];
+    Containers::ArrayView<const char> levelView = levelInfo.data;
+    if(_f->supercompressionScheme != Implementation::SuperCompressionScheme::None) {
+        if(!levelInfo.decompressed) {
+            MAGNUM_PROFILING_ZONE("KtxImporter level decompression");
+            Containers::Array<char> decompressed{NoInit, levelInfo.uncompressedLength};
+            #ifdef MAGNUM_KTXIMPORTER_WITH_ZSTD
+            if(_f->supercompressionScheme == Implementation::SuperCompressionScheme::Zstandard) {
+                const std::size_t result = ZSTD_decompress(decompressed.data(), decompressed.size(), levelInfo.data.data(), levelInfo.data.size());
+                if(ZSTD_isError(result)) {
+                    Error{} << messagePrefix << "Zstandard decompression failed:" << ZSTD_getErrorName(result);
+                    return {};
+                }
+                if(result != decompressed.size()) {
+                    Error{} << messagePrefix << "expected" << decompressed.size() << "bytes of decompressed level data but got" << result;
+                    return {};
+                }
+            } else
+            #endif
+            #ifdef MAGNUM_KTXIMPORTER_WITH_ZLIB
+            if(_f->supercompressionScheme == Implementation::SuperCompressionScheme::ZLIB) {
+                uLongf result = decompressed.size();
+                const int error = uncompress(reinterpret_cast<Bytef*>(decompressed.data()), &result, reinterpret_cast<const Bytef*>(levelInfo.data.data()), levelInfo.data.size());
+                if(error != Z_OK) {
+                    Error{} << messagePrefix << "ZLIB decompression failed with error" << error;
+                    return {};
+                }
+                if(result != decompressed.size()) {
+                    Error{} << messagePrefix << "expected" << decompressed.size() << "bytes of decompressed level data but got" << result;
+                    return {};
+                }
+            } else
+            #endif
+            {
+                /* Other schemes are rejected in doOpenData() */
+                CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+            }
+
+            levelInfo.decompressed = Utility::move(decompressed);
+        }
+
+        levelView = levelInfo.decompressed;
+    }
+
+    Containers::ArrayView<const char> imageView = levelView.sliceSize(levelData.offset, levelData.length);
+
+    /* If just a single array layer or cube map face is requested, take only
+       its data and import it as a single-layer array image. Layers and faces
+       are the last dimension, so each is a contiguous range. */
+    Vector3i levelSize = levelData.size;
+    ImageFlags3D imageFlags = _f->imageFlags;
+    if(const Containers::StringView layer = configuration().value<Containers::StringView>("layer")) {
+        if(_f->numDimensions == _f->numDataDimensions) {
+            Error{} << messagePrefix << "the layer option can be used only with 1D and 2D array and cube map images";
+            return {};
+        }
+
+        /* Block-compressed 1D arrays have multiple layers in a single
+           block, which can't be separated */
+        if(_f->pixelFormat.isCompressed && _f->pixelFormat.blockSize[_f->numDimensions] != 1) {
+            Error{} << messagePrefix << "the layer option can't be used with" << _f->pixelFormat.compressed << "1D array images";
+            return {};
+        }
+
+        const UnsignedInt sliceCount = levelSize[_f->numDimensions];
+        const UnsignedInt slice = configuration().value<UnsignedInt>("layer");
+        if(slice >= sliceCount) {
+            Error{} << messagePrefix << "layer" << layer << "out of range for" << sliceCount << "layers";
+            return {};
+        }
+
+        const std::size_t sliceLength = imageView.size()/sliceCount;
+        imageView = imageView.sliceSize(slice*sliceLength, sliceLength);
+        levelSize[_f->numDimensions] = 1;
+        if(imageFlags & ImageFlag3D::CubeMap)
+            imageFlags = (imageFlags & ~ImageFlag3D::CubeMap)|ImageFlag3D::Array;
+    }
+
+    const auto size = Math::Vector<dimensions, Int>::pad(levelSize);
+
+    /* If no pixel processing is needed, return a view on the input data if
+       requested */
+    if(configuration().value<bool>("zeroCopy") && !_f->flip.any() &&
+       _f->pixelFormat.swizzle == SwizzleType::None
+       #ifdef CORRADE_TARGET_BIG_ENDIAN
+       && _f->pixelFormat.typeSize == 1
+       #endif
+    ) {
+        if(_f->pixelFormat.isCompressed)
+            return ImageData<dimensions>{_f->pixelFormat.compressed, size, DataFlags{}, imageView, ImageFlag<dimensions>(UnsignedShort(imageFlags))};
+
+        PixelStorage storage;
+        if((levelSize.x()*_f->pixelFormat.size)%4 != 0)
+            storage.setAlignment(1);
+        return ImageData<dimensions>{storage, _f->pixelFormat.uncompressed, size, DataFlags{}, imageView, ImageFlag<dimensions>(UnsignedShort(imageFlags))};
+    }
+
+    Containers::Optional<Containers::Array<char>> allocated = Magnum::Implementation::allocateOutput(messagePrefix, _outputAllocator, _outputAllocatorUserData, imageView.size());
+    if(!allocated) return {};
+    Containers::Array<char> data = Utility::move(*allocated);
 
     /* Block-compressed images don't have any flipping, swizzling or endian
        swapping performed on them. Special-casing this mainly to avoid having
@@ -871,11 +1087,11 @@ template<UnsignedInt dimensions> ImageData<dimensions> KtxImporter::doImage(cons
         CORRADE_INTERNAL_ASSERT(_f->pixelFormat.swizzle == SwizzleType::None);
         CORRADE_INTERNAL_ASSERT(_f->pixelFormat.typeSize == 1);
 
-        Utility::copy(levelData.data, data);
+        Utility::copy(imageView, data);
         /** @todo clean this up once blocks() is a thing */
         const CompressedPixelFormat format = _f->pixelFormat.compressed;
         const Vector3i blockSize = compressedPixelFormatBlockSize(format);
-        const Vector3i sizeInBlocks = (levelData.size + blockSize - Vector3i{1})/blockSize;
+        const Vector3i sizeInBlocks = (levelSize + blockSize - Vector3i{1})/blockSize;
         const UnsignedInt blockDataSize = compressedPixelFormatBlockDataSize(format);
         const Containers::StridedArrayView4D<char> blocks{data, {
             std::size_t(sizeInBlocks.z()),
@@ -885,8 +1101,8 @@ template<UnsignedInt dimensions> ImageData<dimensions> KtxImporter::doImage(cons
         }};
 
         if(_f->flip[1]) {
-            if(!(flags() & ImporterFlag::Quiet) && levelData.size.y() % blockSize.y() != 0)
-                Warning{} << messagePrefix << "Y-flipping a compressed image that's not whole blocks, the result will be shifted by" << (blockSize.y() - (levelData.size.y() % blockSize.y())) << "pixels";
+            if(!(flags() & ImporterFlag::Quiet) && levelSize.y() % blockSize.y() != 0)
+                Warning{} << messagePrefix << "Y-flipping a compressed image that's not whole blocks, the result will be shifted by" << (blockSize.y() - (levelSize.y() % blockSize.y())) << "pixels";
 
             if(format == CompressedPixelFormat::Bc1RGBAUnorm ||
                format == CompressedPixelFormat::Bc1RGBASrgb)
@@ -910,17 +1126,20 @@ template<UnsignedInt dimensions> ImageData<dimensions> KtxImporter::doImage(cons
         if(_f->flip[2])
             Utility::flipInPlace<0>(blocks);
 
-        return ImageData<dimensions>{_f->pixelFormat.compressed, size, Utility::move(data), ImageFlag<dimensions>(UnsignedShort(_f->imageFlags))};
+        /* Memory from the output allocator isn't owned by the image */
+        if(_outputAllocator)
+            return ImageData<dimensions>{_f->pixelFormat.compressed, size, DataFlag::Mutable, data, ImageFlag<dimensions>(UnsignedShort(imageFlags))};
+        return ImageData<dimensions>{_f->pixelFormat.compressed, size, Utility::move(data), ImageFlag<dimensions>(UnsignedShort(imageFlags))};
     }
 
     /* Uncompressed image */
 
     /* Copy image data, flipping along axes if necessary. Assuming src is
        tightly packed, stride gets calculated implicitly. */
-    Containers::StridedArrayView4D<const char> src{levelData.data, {
-        std::size_t(levelData.size.z()),
-        std::size_t(levelData.size.y()),
-        std::size_t(levelData.size.x()),
+    Containers::StridedArrayView4D<const char> src{imageView, {
+        std::size_t(levelSize.z()),
+        std::size_t(levelSize.y()),
+        std::size_t(levelSize.x()),
         _f->pixelFormat.size
     }};
     Containers::StridedArrayView4D<char> dst{data, src.size()};
@@ -939,13 +1158,15 @@ template<UnsignedInt dimensions> ImageData<dimensions> KtxImporter::doImage(cons
 
     /* Adjust pixel storage if row size is not four byte aligned */
     PixelStorage storage;
-    if((levelData.size.x()*_f->pixelFormat.size)%4 != 0)
+    if((levelSize.x()*_f->pixelFormat.size)%4 != 0)
         storage.setAlignment(1);
 
     /** @todo the DFD block has KHR_DF_FLAG_ALPHA_PREMULTIPLIED, pass it
         through ImageFlags once such flag exists:
         https://github.khronos.org/KTX-Specification/#_providing_additional_information */
-    return ImageData<dimensions>{storage, _f->pixelFormat.uncompressed, size, Utility::move(data), ImageFlag<dimensions>(UnsignedShort(_f->imageFlags))};
+    if(_outputAllocator)
+        return ImageData<dimensions>{storage, _f->pixelFormat.uncompressed, size, DataFlag::Mutable, data, ImageFlag<dimensions>(UnsignedShort(imageFlags))};
+    return ImageData<dimensions>{storage, _f->pixelFormat.uncompressed, size, Utility::move(data), ImageFlag<dimensions>(UnsignedShort(imageFlags))};
 }
 
 UnsignedInt KtxImporter::doImage1DCount() const {
@@ -967,6 +1188,7 @@ UnsignedInt KtxImporter::doImage1DLevelCount(UnsignedInt id)  {
 }
 
 Containers::Optional<ImageData1D> KtxImporter::doImage1D(UnsignedInt id, UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage1D", {}, id};
     if(_basisImporter)
         /* Basis has no 1D image support (and BasisImporter doesn't expose any
            1D image interface), so this will never be called */
@@ -992,6 +1214,7 @@ UnsignedInt KtxImporter::doImage2DLevelCount(UnsignedInt id) {
 }
 
 Containers::Optional<ImageData2D> KtxImporter::doImage2D(UnsignedInt id, UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D", {}, id};
     if(_basisImporter)
         return _basisImporter->image2D(id, level);
     else
@@ -1015,6 +1238,7 @@ UnsignedInt KtxImporter::doImage3DLevelCount(UnsignedInt id) {
 }
 
 Containers::Optional<ImageData3D> KtxImporter::doImage3D(UnsignedInt id, const UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage3D", {}, id};
     if(_basisImporter)
         return _basisImporter->image3D(id, level);
     else
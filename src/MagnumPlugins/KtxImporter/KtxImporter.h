@@ -140,6 +140,56 @@ The importer recognizes @ref ImporterFlag::Verbose, printing additional info
 when the flag is enabled. @ref ImporterFlag::Quiet is recognized as well and
 causes all import warnings to be suppressed.
 
+@subsection Trade-KtxImporter-behavior-zero-copy Zero-copy import
+
+By default, image data are copied out of the file on every @ref image1D() /
+@ref image2D() / @ref image3D() call. If the @cb{.ini} zeroCopy @ce
+@ref Trade-KtxImporter-configuration "configuration option" is enabled and the
+image doesn't need to be flipped, swizzled or endian-swapped, the returned
+@ref ImageData is instead a non-owning view on the data passed to
+@ref openData() or @ref openMemory(), or on the decompressed level for
+@ref Trade-KtxImporter-behavior-supercompression "supercompressed files", with
+empty @ref ImageData::dataFlags(). Such view is valid only until the importer
+is closed or another file is opened. As @ref openData() copies the data
+unless their ownership is transferred and @ref openFile() reads the whole file
+into memory, the
+combination of @ref openMemory() with a memory-mapped file such as from
+@relativeref{Corrade,Utility::Path::mapRead()} avoids any copy of the pixel
+data whatsoever:
+
+@code{.cpp}
+Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> mapped = Utility::Path::mapRead("texture.ktx2");
+
+importer->configuration().setValue("zeroCopy", true);
+if(!mapped || !importer->openMemory(*mapped))
+    Fatal{} << "Can't open the file";
+
+Containers::Optional<Trade::ImageData3D> image = importer->image3D(0);
+// upload image->data() to the GPU, then close the importer and unmap
+@endcode
+
+@subsection Trade-KtxImporter-behavior-file-callbacks File callbacks and on-demand level loading
+
+The plugin supports @ref ImporterFeature::OpenData and
+@ref ImporterFeature::FileCallback features. As the file data are referenced
+for the whole time the file is opened, file callbacks are called with
+@ref InputFileCallbackPolicy::LoadPermanent and the returned view is used
+directly without making a copy. Resources returned from file callbacks can only
+be safely freed after closing the importer instance.
+
+The file loading callback is expected to return the whole file. If it returns
+a view on a memory-mapped file, only the header, level index and metadata get
+loaded from the disk on open and individual levels only once they're actually
+imported, which allows for example a texture streamer to import the smallest
+levels first and fetch the base level only when needed. If the
+@cb{.ini} mapFile @ce @ref Trade-KtxImporter-configuration "configuration option"
+is enabled, a file is opened from the filesystem and no file callback is set,
+the file is memory-mapped by the plugin itself with
+@relativeref{Corrade,Utility::Path::mapRead()}. This is available only on
+platforms where memory-mapping is supported. In both cases, combining it with
+the @cb{.ini} zeroCopy @ce option described above avoids copying the
+level data as well.
+
 @subsection Trade-KtxImporter-behavior-types Image types
 
 All image types supported by KTX2 are imported, including 1D, 2D, cube maps,
@@ -160,6 +210,27 @@ differently --- because there is no `ImageData4D`, each layer is imported as a
 separate @ref ImageData3D, with @ref image3DCount() determining the number of
 layers.
 
+@subsection Trade-KtxImporter-behavior-layer Single layer import
+
+By default, each level of an array or cube map image is imported with all its
+layers and faces. Setting the @cb{.ini} layer @ce
+@ref Trade-KtxImporter-configuration "configuration option" to a particular
+index makes @ref image2D() / @ref image3D() import just given 1D array layer,
+2D array layer or cube map face, with faces of cube map arrays counted together
+with layers, i.e. the index being @cpp 6*layer + face @ce. The result is a
+single-layer image with @ref ImageFlag2D::Array / @ref ImageFlag3D::Array set,
+as a single cube map face isn't a cube map anymore. As the layer is a
+contiguous range of the level data, it can be imported without a copy with
+the @cb{.ini} zeroCopy @ce option, and with a memory-mapped file only the
+pages of given layer get loaded from the disk. Supercompressed levels are
+still decompressed as a whole.
+
+As 3D array layers are exposed as separate images already, the option isn't
+supported for those. It isn't supported for block-compressed 1D arrays either,
+as their blocks span multiple layers. Basis-encoded files are passed to
+@ref BasisImporter, which doesn't recognize this option. An index out of range
+makes the import fail.
+
 @subsection Trade-KtxImporter-behavior-multilevel Multilevel images
 
 Files with multiple mip levels are imported with the largest level first, with
@@ -204,10 +275,49 @@ Calls to the @ref image1DCount() / @ref image2DCount() / @ref image3DCount(),
 
 @subsection Trade-KtxImporter-behavior-supercompression Supercompression
 
-Importing files with [supercompression](https://www.khronos.org/registry/KTX/specs/2.0/ktxspec_v2.html#supercompressionSchemes)
-is not supported. When @ref Trade-KtxImporter-behavior-basis "forwarding Basis Universal compressed files",
-some supercompression schemes like BasisLZ and Zstandard can be handled by
-@ref BasisImporter.
+Files with Zstandard and ZLIB [supercompression](https://www.khronos.org/registry/KTX/specs/2.0/ktxspec_v2.html#supercompressionSchemes)
+can be imported if the plugin is built with the [zstd](https://github.com/facebook/zstd)
+and [zlib](https://zlib.net/) libraries, respectively. Both are optional
+dependencies that are used if found when building the plugin. Each mip level is
+decompressed lazily on the first @ref image1D() / @ref image2D() /
+@ref image3D() call with given level and kept until the file is closed, as all
+layers of a 3D array image share a single level. Opening a file with a scheme
+the plugin wasn't built with fails with an error. When
+@ref Trade-KtxImporter-behavior-basis "forwarding Basis Universal compressed files",
+BasisLZ and Zstandard supercompression is handled by @ref BasisImporter.
+
+@subsection Trade-KtxImporter-behavior-output-allocator Custom output allocator
+
+By default, imported image data are allocated with the default array allocator
+and owned by the returned @ref ImageData. With @ref setOutputAllocator() it's
+possible to supply a custom allocator instead, for example one suballocating
+from an arena or from a persistently mapped GPU staging buffer, which avoids a
+copy when uploading. The allocator gets the size in bytes and the user data
+pointer and returns a pointer to memory of at least given size aligned to at
+least four bytes, or @cpp nullptr @ce on failure, in which case the import
+fails with an error. The returned image then only references the memory, with
+@ref DataFlag::Mutable set, and it's up to the application to keep it alive for
+as long as the image is used. Images that don't need any processing and are
+imported as views with @cb{.ini} zeroCopy @ce enabled don't use the allocator,
+and neither do files forwarded to @ref BasisImporter.
+
+@subsection Trade-KtxImporter-behavior-async Asynchronous import
+
+The @ref image2DAsync() function schedules an import of given 2D image level
+on an executor supplied by the application and calls a callback with the
+result once done, so for example a render thread doesn't need to block on
+decoding. The executor gets a job function, a pointer to pass to it and the
+user data pointer, and is expected to call the job exactly once, either
+directly or from any other thread. The job imports the image using
+@ref image2D() and then calls the callback on the same thread, with
+@relativeref{Corrade,Containers::NullOpt} if the import failed.
+
+Asynchronous imports on a single importer instance are executed one after
+another and only one import of a particular image and level can be in flight
+at a time. While any of them are in flight, the importer shouldn't be used
+from other threads except for calling @ref image2DAsync() again. Calling
+@ref close(), opening another file or destroying the importer waits until all
+of them finish.
 
 @section Trade-KtxImporter-configuration Plugin-specific configuration
 
@@ -227,13 +337,45 @@ class MAGNUM_KTXIMPORTER_EXPORT KtxImporter: public AbstractImporter {
 
         ~KtxImporter();
 
+        /**
+         * @brief Import a 2D image asynchronously
+         * @param id        Image ID, from range [0, @ref image2DCount())
+         * @param level     Mip level, from range
+         *      [0, @ref image2DLevelCount())
+         * @param executor  Function running the import job
+         * @param callback  Function called with the imported image
+         * @param userData  User data passed to @p executor and @p callback
+         * @return Whether the import was scheduled
+         * @m_since_latest_{plugins}
+         *
+         * If no file is opened, @p id or @p level is out of range or the
+         * same image and level is already being imported, prints a message
+         * to @relativeref{Magnum,Error} and returns @cpp false @ce without
+         * calling @p executor. See @ref Trade-KtxImporter-behavior-async
+         * for more information.
+         */
+        virtual bool image2DAsync(UnsignedInt id, UnsignedInt level, void(*executor)(void(*)(void*), void*, void*), void(*callback)(UnsignedInt, UnsignedInt, Containers::Optional<ImageData2D>&&, void*), void* userData = nullptr);
+
+        /**
+         * @brief Set an output allocator
+         * @m_since_latest_{plugins}
+         *
+         * If set, imported image data are allocated using @p allocator, which
+         * gets the size in bytes and @p userData. Passing @cpp nullptr @ce
+         * restores the default. The setting is kept across opened files. See
+         * @ref Trade-KtxImporter-behavior-output-allocator for more
+         * information.
+         */
+        virtual void setOutputAllocator(char*(*allocator)(std::size_t, void*), void* userData = nullptr);
+
     private:
         MAGNUM_KTXIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_KTXIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_KTXIMPORTER_LOCAL void doClose() override;
+        MAGNUM_KTXIMPORTER_LOCAL void doOpenFile(Containers::StringView filename) override;
         MAGNUM_KTXIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
 
-        template<UnsignedInt dimensions> MAGNUM_KTXIMPORTER_LOCAL ImageData<dimensions> doImage(const char* messagePrefix, UnsignedInt id, UnsignedInt level);
+        template<UnsignedInt dimensions> MAGNUM_KTXIMPORTER_LOCAL Containers::Optional<ImageData<dimensions>> doImage(const char* messagePrefix, UnsignedInt id, UnsignedInt level);
 
         MAGNUM_KTXIMPORTER_LOCAL UnsignedInt doImage1DCount() const override;
         MAGNUM_KTXIMPORTER_LOCAL UnsignedInt doImage1DLevelCount(UnsignedInt id) override;
@@ -255,6 +397,10 @@ class MAGNUM_KTXIMPORTER_EXPORT KtxImporter: public AbstractImporter {
         struct File;
         Containers::Pointer<File> _f;
         Containers::Pointer<AbstractImporter> _basisImporter;
+        char*(*_outputAllocator)(std::size_t, void*){};
+        void* _outputAllocatorUserData{};
+        struct AsyncState;
+        Containers::Pointer<AsyncState> _async;
 };
 
 }}
@@ -60,6 +60,7 @@
 #endif
 
 #include "MagnumPlugins/KtxImporter/KtxHeader.h"
+#include "MagnumPlugins/KtxImporter/configure.h"
 
 #include "configure.h"
 
@@ -109,6 +110,9 @@ struct KtxImporterTest: TestSuite::Tester {
     void image3DCompressed();
     void image3DCompressedMipmaps();
 
+    void supercompression();
+    void supercompressionInvalid();
+
     void forwardBasis();
     void forwardBasisFormat();
     void forwardBasisInvalid();
@@ -130,6 +134,17 @@ struct KtxImporterTest: TestSuite::Tester {
     void swizzleCompressed();
 
     void openMemory();
+    void zeroCopy();
+    void zeroCopyFlipped();
+
+    void layer();
+    void layerNotArray();
+    void layerOutOfRange();
+
+    void fileCallback();
+    void fileCallbackNotFound();
+    void mapFile();
+
     void openTwice();
     void openNormalAfterBasis();
     void importTwice();
@@ -259,9 +274,12 @@ const struct {
     {"compressed type size", "2d-compressed-etc2.ktx2", {},
         offsetof(Implementation::KtxHeader, typeSize), 4,
         "invalid type size for compressed format, expected 1 but got 4"},
-    {"supercompression", "2d-rgb.ktx2", {},
+    {"BasisLZ supercompression", "2d-rgb.ktx2", {},
         offsetof(Implementation::KtxHeader, supercompressionScheme), 1,
-        "supercompression is currently not supported"},
+        "BasisLZ supercompression is supported only for Basis Universal images"},
+    {"unknown supercompression", "2d-rgb.ktx2", {},
+        offsetof(Implementation::KtxHeader, supercompressionScheme), 4,
+        "unknown supercompression scheme 4"},
     {"3d depth", "3d.ktx2", {},
         offsetof(Implementation::KtxHeader, vkFormat), VK_FORMAT_D32_SFLOAT,
         "3D images can't have depth/stencil format"},
@@ -281,6 +299,36 @@ const struct {
         "level data too short, expected at least 216 bytes but got 108"}
 };
 
+const struct {
+    const char* name;
+    const char* file;
+    const char* uncompressedFile;
+    Implementation::SuperCompressionScheme scheme;
+} SupercompressionData[]{
+    {"2D mipmaps, Zstandard", "2d-mipmaps-zstd.ktx2", "2d-mipmaps.ktx2",
+        Implementation::SuperCompressionScheme::Zstandard},
+    {"2D mipmaps, ZLIB", "2d-mipmaps-zlib.ktx2", "2d-mipmaps.ktx2",
+        Implementation::SuperCompressionScheme::ZLIB},
+    {"3D layers, Zstandard", "3d-layers-zstd.ktx2", "3d-layers.ktx2",
+        Implementation::SuperCompressionScheme::Zstandard},
+    {"3D layers, ZLIB", "3d-layers-zlib.ktx2", "3d-layers.ktx2",
+        Implementation::SuperCompressionScheme::ZLIB},
+};
+
+const struct {
+    const char* name;
+    const char* file;
+    Implementation::SuperCompressionScheme scheme;
+    const char* message;
+} SupercompressionInvalidData[]{
+    {"Zstandard", "2d-mipmaps-zstd.ktx2",
+        Implementation::SuperCompressionScheme::Zstandard,
+        "Trade::KtxImporter::image2D(): Zstandard decompression failed: "},
+    {"ZLIB", "2d-mipmaps-zlib.ktx2",
+        Implementation::SuperCompressionScheme::ZLIB,
+        "Trade::KtxImporter::image2D(): ZLIB decompression failed with error -3\n"},
+};
+
 #ifdef MAGNUM_BUILD_DEPRECATED
 const struct {
     const char* name;
@@ -661,6 +709,22 @@ const struct {
         nullptr, Containers::arrayCast<const char>(PatternRgba2DData)}
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+    const char* assumeOrientation;
+    UnsignedInt layer;
+    bool zeroCopy;
+    ImageFlags3D expectedFlags;
+} LayerData[]{
+    {"1D array", "1d-layers.ktx2", nullptr, 2, false, ImageFlag3D::Array},
+    {"2D array, mips", "2d-mipmaps-and-layers.ktx2", nullptr, 1, false, ImageFlag3D::Array},
+    {"2D array, compressed", "2d-compressed-layers.ktx2", nullptr, 1, false, ImageFlag3D::Array},
+    {"cube map face, mips", "cubemap-mipmaps.ktx2", nullptr, 3, false, ImageFlag3D::Array},
+    {"cube map array face", "cubemap-layers.ktx2", nullptr, 7, false, ImageFlag3D::Array},
+    {"cube map face, zero copy", "cubemap-mipmaps.ktx2", "ru", 5, true, ImageFlag3D::Array},
+};
+
 /* Shared among all plugins that implement data copying optimizations */
 const struct {
     const char* name;
@@ -768,6 +832,12 @@ KtxImporterTest::KtxImporterTest() {
 
     addTests({&KtxImporterTest::image3DCompressedMipmaps});
 
+    addInstancedTests({&KtxImporterTest::supercompression},
+        Containers::arraySize(SupercompressionData));
+
+    addInstancedTests({&KtxImporterTest::supercompressionInvalid},
+        Containers::arraySize(SupercompressionInvalidData));
+
     addInstancedTests({&KtxImporterTest::forwardBasis},
         Containers::arraySize(ForwardBasisData));
 
@@ -820,7 +890,20 @@ KtxImporterTest::KtxImporterTest() {
     addInstancedTests({&KtxImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
-    addTests({&KtxImporterTest::openTwice,
+    addTests({&KtxImporterTest::zeroCopy,
+              &KtxImporterTest::zeroCopyFlipped});
+
+    addInstancedTests({&KtxImporterTest::layer},
+        Containers::arraySize(LayerData));
+
+    addTests({&KtxImporterTest::layerNotArray,
+              &KtxImporterTest::layerOutOfRange,
+
+              &KtxImporterTest::fileCallback,
+              &KtxImporterTest::fileCallbackNotFound,
+              &KtxImporterTest::mapFile,
+
+              &KtxImporterTest::openTwice,
               &KtxImporterTest::openNormalAfterBasis,
               &KtxImporterTest::importTwice});
 
@@ -1900,6 +1983,105 @@ void KtxImporterTest::image3DCompressedMipmaps() {
     }
 }
 
+void KtxImporterTest::supercompression() {
+    auto&& data = SupercompressionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef MAGNUM_KTXIMPORTER_WITH_ZSTD
+    if(data.scheme == Implementation::SuperCompressionScheme::Zstandard)
+        CORRADE_SKIP("KtxImporter was built without Zstandard support.");
+    #endif
+    #ifndef MAGNUM_KTXIMPORTER_WITH_ZLIB
+    if(data.scheme == Implementation::SuperCompressionScheme::ZLIB)
+        CORRADE_SKIP("KtxImporter was built without ZLIB support.");
+    #endif
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    Containers::Pointer<AbstractImporter> expectedImporter = _manager.instantiate("KtxImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.file)));
+    CORRADE_VERIFY(expectedImporter->openFile(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.uncompressedFile)));
+
+    /* The supercompressed files are made from the uncompressed ones by
+       supercompress.py, so everything should be exactly the same */
+    CORRADE_COMPARE(importer->image2DCount(), expectedImporter->image2DCount());
+    for(UnsignedInt i = 0; i != expectedImporter->image2DCount(); ++i) {
+        CORRADE_COMPARE(importer->image2DLevelCount(i), expectedImporter->image2DLevelCount(i));
+        for(UnsignedInt j = 0; j != expectedImporter->image2DLevelCount(i); ++j) {
+            CORRADE_ITERATION(i, j);
+
+            Containers::Optional<Trade::ImageData2D> image = importer->image2D(i, j);
+            Containers::Optional<Trade::ImageData2D> expected = expectedImporter->image2D(i, j);
+            CORRADE_VERIFY(image);
+            CORRADE_VERIFY(expected);
+            CORRADE_COMPARE(image->format(), expected->format());
+            CORRADE_COMPARE(image->size(), expected->size());
+            CORRADE_COMPARE(image->flags(), expected->flags());
+            CORRADE_COMPARE_AS(image->data(), expected->data(), TestSuite::Compare::Container);
+        }
+    }
+
+    CORRADE_COMPARE(importer->image3DCount(), expectedImporter->image3DCount());
+    for(UnsignedInt i = 0; i != expectedImporter->image3DCount(); ++i) {
+        CORRADE_COMPARE(importer->image3DLevelCount(i), expectedImporter->image3DLevelCount(i));
+        for(UnsignedInt j = 0; j != expectedImporter->image3DLevelCount(i); ++j) {
+            CORRADE_ITERATION(i, j);
+
+            Containers::Optional<Trade::ImageData3D> image = importer->image3D(i, j);
+            Containers::Optional<Trade::ImageData3D> expected = expectedImporter->image3D(i, j);
+            CORRADE_VERIFY(image);
+            CORRADE_VERIFY(expected);
+            CORRADE_COMPARE(image->format(), expected->format());
+            CORRADE_COMPARE(image->size(), expected->size());
+            CORRADE_COMPARE(image->flags(), expected->flags());
+            CORRADE_COMPARE_AS(image->data(), expected->data(), TestSuite::Compare::Container);
+        }
+    }
+}
+
+void KtxImporterTest::supercompressionInvalid() {
+    auto&& data = SupercompressionInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef MAGNUM_KTXIMPORTER_WITH_ZSTD
+    if(data.scheme == Implementation::SuperCompressionScheme::Zstandard)
+        CORRADE_SKIP("KtxImporter was built without Zstandard support.");
+    #endif
+    #ifndef MAGNUM_KTXIMPORTER_WITH_ZLIB
+    if(data.scheme == Implementation::SuperCompressionScheme::ZLIB)
+        CORRADE_SKIP("KtxImporter was built without ZLIB support.");
+    #endif
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+
+    Containers::Optional<Containers::Array<char>> fileData = Utility::Path::read(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.file));
+    CORRADE_VERIFY(fileData);
+
+    /* Corrupt the header of the first level data, it's only discovered once
+       the level is decompressed */
+    const Implementation::KtxLevel& level = *reinterpret_cast<const Implementation::KtxLevel*>(fileData->data() + sizeof(Implementation::KtxHeader));
+    const std::size_t offset = Utility::Endianness::littleEndian(level.byteOffset);
+    CORRADE_COMPARE_AS(offset + 4, fileData->size(), TestSuite::Compare::Less);
+    for(std::size_t i = 0; i != 4; ++i)
+        (*fileData)[offset + i] = '\xff';
+
+    CORRADE_VERIFY(importer->openData(*fileData));
+
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->image2D(0, 0));
+    }
+    /* The Zstandard error string depends on the library version, check just
+       the prefix */
+    if(Containers::StringView{data.message}.hasSuffix('\n'))
+        CORRADE_COMPARE(out.str(), data.message);
+    else
+        CORRADE_COMPARE_AS(out.str(), data.message, TestSuite::Compare::StringHasPrefix);
+
+    /* Other levels are unaffected */
+    CORRADE_VERIFY(importer->image2D(0, 1));
+}
+
 void KtxImporterTest::forwardBasis() {
     auto&& data = ForwardBasisData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -2551,6 +2733,224 @@ void KtxImporterTest::openMemory() {
     CORRADE_COMPARE_AS(image->data(), Containers::arrayCast<const char>(PatternRgba2DData), TestSuite::Compare::Container);
 }
 
+void KtxImporterTest::zeroCopy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    Containers::Pointer<AbstractImporter> expectedImporter = _manager.instantiate("KtxImporter");
+    /* The file is Y down, assume Y up to not need any flipping */
+    importer->configuration().setValue("assumeOrientation", "ru");
+    importer->configuration().setValue("zeroCopy", true);
+    expectedImporter->configuration().setValue("assumeOrientation", "ru");
+
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(KTXIMPORTER_TEST_DIR, "2d-mipmaps.ktx2"));
+    CORRADE_VERIFY(memory);
+    CORRADE_VERIFY(importer->openMemory(*memory));
+    CORRADE_VERIFY(expectedImporter->openMemory(*memory));
+
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 3);
+    for(UnsignedInt i = 0; i != importer->image2DLevelCount(0); ++i) {
+        CORRADE_ITERATION(i);
+
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, i);
+        Containers::Optional<Trade::ImageData2D> expected = expectedImporter->image2D(0, i);
+        CORRADE_VERIFY(image);
+        CORRADE_VERIFY(expected);
+
+        /* The data points directly into the passed memory */
+        CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+        CORRADE_VERIFY(image->data().data() >= memory->data());
+        CORRADE_VERIFY(image->data().data() + image->data().size() <= memory->end());
+
+        CORRADE_COMPARE(image->format(), expected->format());
+        CORRADE_COMPARE(image->size(), expected->size());
+        CORRADE_COMPARE(image->storage().alignment(), expected->storage().alignment());
+        CORRADE_COMPARE_AS(image->data(), expected->data(), TestSuite::Compare::Container);
+    }
+}
+
+void KtxImporterTest::zeroCopyFlipped() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    importer->configuration().setValue("zeroCopy", true);
+
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(KTXIMPORTER_TEST_DIR, "2d-rgba.ktx2"));
+    CORRADE_VERIFY(memory);
+    CORRADE_VERIFY(importer->openMemory(*memory));
+
+    /* The file needs to be Y-flipped, so it's copied anyway */
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->dataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayCast<const char>(PatternRgba2DData), TestSuite::Compare::Container);
+}
+
+void KtxImporterTest::layer() {
+    auto&& data = LayerData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    Containers::Pointer<AbstractImporter> expectedImporter = _manager.instantiate("KtxImporter");
+    /* Orientation warnings aren't interesting here */
+    importer->addFlags(ImporterFlag::Quiet);
+    expectedImporter->addFlags(ImporterFlag::Quiet);
+    if(data.assumeOrientation) {
+        importer->configuration().setValue("assumeOrientation", data.assumeOrientation);
+        expectedImporter->configuration().setValue("assumeOrientation", data.assumeOrientation);
+    }
+    importer->configuration().setValue("layer", data.layer);
+    importer->configuration().setValue("zeroCopy", data.zeroCopy);
+
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.filename));
+    CORRADE_VERIFY(memory);
+    CORRADE_VERIFY(importer->openMemory(*memory));
+    CORRADE_VERIFY(expectedImporter->openMemory(*memory));
+
+    /* 1D arrays are imported as 2D images, everything else as 3D */
+    const bool is3D = importer->image3DCount();
+    const UnsignedInt levelCount = is3D ? importer->image3DLevelCount(0) : importer->image2DLevelCount(0);
+    for(UnsignedInt i = 0; i != levelCount; ++i) {
+        CORRADE_ITERATION(i);
+
+        DataFlags dataFlags;
+        Containers::ArrayView<const char> imageData, expectedData;
+        Containers::Optional<ImageData2D> image2D, expected2D;
+        Containers::Optional<ImageData3D> image3D, expected3D;
+        if(is3D) {
+            image3D = importer->image3D(0, i);
+            expected3D = expectedImporter->image3D(0, i);
+            CORRADE_VERIFY(image3D);
+            CORRADE_VERIFY(expected3D);
+            CORRADE_COMPARE(image3D->flags(), data.expectedFlags);
+            CORRADE_COMPARE(image3D->size(), (Vector3i{expected3D->size().xy(), 1}));
+            dataFlags = image3D->dataFlags();
+            imageData = image3D->data();
+            expectedData = expected3D->data();
+        } else {
+            image2D = importer->image2D(0, i);
+            expected2D = expectedImporter->image2D(0, i);
+            CORRADE_VERIFY(image2D);
+            CORRADE_VERIFY(expected2D);
+            CORRADE_COMPARE(image2D->flags(), ImageFlag2D(UnsignedShort(data.expectedFlags)));
+            CORRADE_COMPARE(image2D->size(), (Vector2i{expected2D->size().x(), 1}));
+            dataFlags = image2D->dataFlags();
+            imageData = image2D->data();
+            expectedData = expected2D->data();
+        }
+
+        if(data.zeroCopy) {
+            /* The data points directly into the passed memory */
+            CORRADE_COMPARE(dataFlags, DataFlags{});
+            CORRADE_VERIFY(imageData.data() >= memory->data());
+            CORRADE_VERIFY(imageData.data() + imageData.size() <= memory->end());
+        } else {
+            CORRADE_COMPARE(dataFlags, DataFlag::Owned|DataFlag::Mutable);
+        }
+
+        /* The layers are tightly packed in the full image, so the layer is
+           just a subrange of its data */
+        CORRADE_COMPARE_AS(imageData, expectedData.sliceSize(data.layer*imageData.size(), imageData.size()), TestSuite::Compare::Container);
+    }
+}
+
+void KtxImporterTest::layerNotArray() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    importer->configuration().setValue("layer", 0);
+    /* 3D array layers are exposed as separate images, not as a dimension */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(KTXIMPORTER_TEST_DIR, "3d-layers.ktx2")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image3D(0));
+    CORRADE_COMPARE(out.str(), "Trade::KtxImporter::image3D(): the layer option can be used only with 1D and 2D array and cube map images\n");
+}
+
+void KtxImporterTest::layerOutOfRange() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    importer->configuration().setValue("layer", 6);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(KTXIMPORTER_TEST_DIR, "cubemap.ktx2")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image3D(0));
+    CORRADE_COMPARE(out.str(), "Trade::KtxImporter::image3D(): layer 6 out of range for 6 layers\n");
+}
+
+void KtxImporterTest::fileCallback() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    CORRADE_VERIFY(importer->features() & ImporterFeature::FileCallback);
+    importer->configuration().setValue("assumeOrientation", "ru");
+    importer->configuration().setValue("zeroCopy", true);
+
+    struct CallbackData {
+        Containers::Optional<Containers::Array<char>> data;
+        std::string filename;
+        std::size_t count;
+        InputFileCallbackPolicy policy;
+    } callbackData{Utility::Path::read(Utility::Path::join(KTXIMPORTER_TEST_DIR, "2d-mipmaps.ktx2")), {}, 0, InputFileCallbackPolicy::Close};
+    CORRADE_VERIFY(callbackData.data);
+
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy policy, CallbackData& callbackData)
+            -> Containers::Optional<Containers::ArrayView<const char>>
+        {
+            callbackData.filename = filename;
+            ++callbackData.count;
+            callbackData.policy = policy;
+            return Containers::arrayView(*callbackData.data);
+        }, callbackData);
+
+    CORRADE_VERIFY(importer->openFile("some/path/2d-mipmaps.ktx2"));
+
+    /* The file is loaded permanently and never closed */
+    CORRADE_COMPARE(callbackData.filename, "some/path/2d-mipmaps.ktx2");
+    CORRADE_COMPARE(callbackData.count, 1);
+    CORRADE_COMPARE(callbackData.policy, InputFileCallbackPolicy::LoadPermanent);
+
+    /* The data is referenced directly, without any copy */
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 2);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+    CORRADE_VERIFY(image->data().data() >= callbackData.data->data());
+    CORRADE_VERIFY(image->data().data() + image->data().size() <= callbackData.data->end());
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayView<char>({0, 0, 0}), TestSuite::Compare::Container);
+
+    importer->close();
+    CORRADE_COMPARE(callbackData.count, 1);
+}
+
+void KtxImporterTest::fileCallbackNotFound() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    importer->setFileCallback([](const std::string&, InputFileCallbackPolicy, void*)
+        -> Containers::Optional<Containers::ArrayView<const char>> { return {}; });
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openFile("some-file.ktx2"));
+    CORRADE_COMPARE(out.str(), "Trade::KtxImporter::openFile(): cannot open file some-file.ktx2\n");
+}
+
+void KtxImporterTest::mapFile() {
+    #if !defined(CORRADE_TARGET_UNIX) && (!defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_SKIP("Memory mapping not available on this platform.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    Containers::Pointer<AbstractImporter> expectedImporter = _manager.instantiate("KtxImporter");
+    importer->configuration().setValue("mapFile", true);
+    /* Reference the mapped memory directly to verify it stays valid */
+    importer->configuration().setValue("zeroCopy", true);
+    importer->configuration().setValue("assumeOrientation", "ruo");
+    expectedImporter->configuration().setValue("assumeOrientation", "ruo");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(KTXIMPORTER_TEST_DIR, "3d-layers.ktx2")));
+    CORRADE_VERIFY(expectedImporter->openFile(Utility::Path::join(KTXIMPORTER_TEST_DIR, "3d-layers.ktx2")));
+
+    CORRADE_COMPARE(importer->image3DCount(), 2);
+    Containers::Optional<Trade::ImageData3D> image = importer->image3D(1);
+    Containers::Optional<Trade::ImageData3D> expected = expectedImporter->image3D(1);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(expected);
+    CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+    CORRADE_COMPARE(image->size(), (Vector3i{4, 3, 3}));
+    CORRADE_COMPARE_AS(image->data(), expected->data(), TestSuite::Compare::Container);
+    #endif
+}
+
 void KtxImporterTest::openTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
 
@@ -155,3 +155,9 @@ magnum-imageconverter ../../DdsImporter/Test/dxt1-3d.dds -D3 -i assumeYUpZBackwa
 # Reusing AstcImporter test files same as above, just with a different
 # overriden orientation
 magnum-imageconverter ../../AstcImporter/Test/3x3x3.astc -D3 -i assumeYUpZBackward -c orientation=ruo,generator= 3d-compressed-astc3d-ruo.ktx2
+
+# Zstandard and ZLIB supercompressed variants of existing files
+./supercompress.py zstd 2d-mipmaps.ktx2 2d-mipmaps-zstd.ktx2
+./supercompress.py zlib 2d-mipmaps.ktx2 2d-mipmaps-zlib.ktx2
+./supercompress.py zstd 3d-layers.ktx2 3d-layers-zstd.ktx2
+./supercompress.py zlib 3d-layers.ktx2 3d-layers-zlib.ktx2
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+# Supercompresses level data of an existing KTX2 file with Zstandard or ZLIB.
+# The Khronos tools can do Zstandard with `ktxsc --zcmp` but not ZLIB, and
+# they don't support all image types used by the tests, so doing it here. The
+# header, level index, DFD, KVD and SGD is kept as-is, only the
+# supercompression scheme and level index entries are patched. Needs the
+# `zstd` command-line tool for Zstandard.
+#
+#   ./supercompress.py zstd 2d-mipmaps.ktx2 2d-mipmaps-zstd.ktx2
+
+import struct
+import subprocess
+import sys
+import zlib
+
+scheme, input, output = sys.argv[1:]
+
+data = open(input, 'rb').read()
+
+supercompression_scheme, = struct.unpack_from('<I', data, 44)
+assert supercompression_scheme == 0
+level_count = max(struct.unpack_from('<I', data, 40)[0], 1)
+levels = [struct.unpack_from('<QQQ', data, 80 + 24*i) for i in range(level_count)]
+
+# Everything before the first level data stays the same
+prefix_size = min(offset for offset, _, _ in levels)
+out = bytearray(data[:prefix_size])
+
+if scheme == 'zstd':
+    struct.pack_into('<I', out, 44, 2)
+elif scheme == 'zlib':
+    struct.pack_into('<I', out, 44, 3)
+else: assert False
+
+# Keep the original order of level data in the file, which is usually the
+# smallest level first
+for i in sorted(range(level_count), key=lambda i: levels[i][0]):
+    offset, length, uncompressed_length = levels[i]
+    assert length == uncompressed_length
+    uncompressed = data[offset:offset + length]
+    if scheme == 'zstd':
+        compressed = subprocess.run(['zstd', '-q', '-c', '-19'], input=uncompressed, stdout=subprocess.PIPE, check=True).stdout
+    else:
+        compressed = zlib.compress(uncompressed, 9)
+
+    struct.pack_into('<QQQ', out, 80 + 24*i, len(out), len(compressed), uncompressed_length)
+    out += compressed
+
+open(output, 'wb').write(out)
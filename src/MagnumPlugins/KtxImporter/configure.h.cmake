@@ -25,3 +25,6 @@
 */
 
 #cmakedefine MAGNUM_KTXIMPORTER_BUILD_STATIC
+#cmakedefine MAGNUM_KTXIMPORTER_WITH_ZSTD
+#cmakedefine MAGNUM_KTXIMPORTER_WITH_ZLIB
+#cmakedefine MAGNUM_KTXIMPORTER_WITH_TRACY_ZONES
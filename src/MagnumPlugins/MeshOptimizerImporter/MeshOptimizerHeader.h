@@ -0,0 +1,73 @@
+#ifndef Magnum_Trade_MeshOptimizerHeader_h
+#define Magnum_Trade_MeshOptimizerHeader_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Magnum/Magnum.h>
+
+/* Used by both MeshOptimizerImporter and MeshOptimizerSceneConverter, which is
+   why it isn't directly inside MeshOptimizerImporter.cpp. OTOH it doesn't need
+   to be exposed publicly, which is why it has no docblocks. */
+
+namespace Magnum { namespace Trade { namespace Implementation {
+
+/* The file consists of MeshOptimizerHeader, followed by attributeCount
+   MeshOptimizerAttribute entries, followed by indexDataSize bytes of data
+   produced by meshopt_encodeIndexBuffer() and vertexDataSize bytes of data
+   produced by meshopt_encodeVertexBuffer(). All values are in the native
+   endianness. */
+
+constexpr char MeshOptimizerMagic[4]{'M', 'O', 'P', 'T'};
+constexpr UnsignedInt MeshOptimizerVersion = 1;
+
+struct MeshOptimizerHeader {
+    char magic[4];              /* MeshOptimizerMagic */
+    UnsignedInt version;        /* MeshOptimizerVersion */
+    UnsignedInt primitive;      /* MeshPrimitive */
+    UnsignedInt indexType;      /* MeshIndexType, 0 if not indexed */
+    UnsignedInt indexCount;
+    UnsignedInt vertexCount;
+    /* Always a multiple of 4 and at most 256, as required by
+       meshopt_encodeVertexBuffer() */
+    UnsignedInt vertexStride;
+    UnsignedInt attributeCount;
+    UnsignedInt indexDataSize;
+    UnsignedInt vertexDataSize;
+};
+
+static_assert(sizeof(MeshOptimizerHeader) == 40, "Improper size of MeshOptimizerHeader struct");
+
+struct MeshOptimizerAttribute {
+    UnsignedInt name;           /* MeshAttribute */
+    UnsignedInt format;         /* VertexFormat */
+    UnsignedInt offset;
+    UnsignedInt arraySize;
+};
+
+static_assert(sizeof(MeshOptimizerAttribute) == 16, "Improper size of MeshOptimizerAttribute struct");
+
+}}}
+
+#endif
@@ -0,0 +1,200 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "MeshOptimizerImporter.h"
+
+#include <cstring>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Trade/MeshData.h>
+#include <meshoptimizer.h>
+
+#include "Magnum/Implementation/instrumentation.h"
+#include "Magnum/Implementation/meshAttributeValidity.h"
+#include "MagnumPlugins/MeshOptimizerImporter/MeshOptimizerHeader.h"
+
+namespace Magnum { namespace Trade {
+
+MeshOptimizerImporter::MeshOptimizerImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
+
+MeshOptimizerImporter::~MeshOptimizerImporter() = default;
+
+ImporterFeatures MeshOptimizerImporter::doFeatures() const { return ImporterFeature::OpenData; }
+
+bool MeshOptimizerImporter::doIsOpened() const { return !!_in; }
+
+void MeshOptimizerImporter::doClose() { _in = Containers::NullOpt; }
+
+void MeshOptimizerImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
+    if(data.size() < sizeof(Implementation::MeshOptimizerHeader)) {
+        Error{} << "Trade::MeshOptimizerImporter::openData(): file too short, expected at least" << sizeof(Implementation::MeshOptimizerHeader) << "bytes but got" << data.size();
+        return;
+    }
+
+    /* The data may not be aligned, copy the header out */
+    Implementation::MeshOptimizerHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if(std::memcmp(header.magic, Implementation::MeshOptimizerMagic, sizeof(header.magic)) != 0) {
+        Error{} << "Trade::MeshOptimizerImporter::openData(): invalid file signature" << Containers::StringView{header.magic, sizeof(header.magic)};
+        return;
+    }
+
+    if(header.version != Implementation::MeshOptimizerVersion) {
+        Error{} << "Trade::MeshOptimizerImporter::openData(): unsupported version" << header.version;
+        return;
+    }
+
+    if(!header.primitive || isMeshPrimitiveImplementationSpecific(MeshPrimitive(header.primitive))) {
+        Error{} << "Trade::MeshOptimizerImporter::openData(): invalid primitive" << header.primitive;
+        return;
+    }
+
+    /* meshopt_decodeIndexBuffer() works only with triangle lists */
+    if(header.indexType && (header.indexType > UnsignedInt(MeshIndexType::UnsignedInt) || MeshPrimitive(header.primitive) != MeshPrimitive::Triangles || header.indexCount % 3 != 0)) {
+        Error{} << "Trade::MeshOptimizerImporter::openData(): invalid index type" << header.indexType << "or count" << header.indexCount << "for" << MeshPrimitive(header.primitive);
+        return;
+    }
+
+    if(header.vertexStride % 4 != 0 || header.vertexStride > 256 || (header.attributeCount && !header.vertexStride)) {
+        Error{} << "Trade::MeshOptimizerImporter::openData(): invalid vertex stride" << header.vertexStride;
+        return;
+    }
+
+    const std::size_t expectedSize = sizeof(Implementation::MeshOptimizerHeader) + std::size_t{header.attributeCount}*sizeof(Implementation::MeshOptimizerAttribute) + header.indexDataSize + header.vertexDataSize;
+    if(data.size() != expectedSize) {
+        Error{} << "Trade::MeshOptimizerImporter::openData(): file size doesn't match the header, expected" << expectedSize << "bytes but got" << data.size();
+        return;
+    }
+
+    for(UnsignedInt i = 0; i != header.attributeCount; ++i) {
+        Implementation::MeshOptimizerAttribute attribute;
+        std::memcpy(&attribute, data.data() + sizeof(Implementation::MeshOptimizerHeader) + i*sizeof(Implementation::MeshOptimizerAttribute), sizeof(attribute));
+
+        const VertexFormat format = VertexFormat(attribute.format);
+        if(!Magnum::Implementation::isVertexFormatValid(attribute.format) || isVertexFormatImplementationSpecific(format) || attribute.arraySize > 0xffff) {
+            Error{} << "Trade::MeshOptimizerImporter::openData(): invalid format" << attribute.format << "or array size" << attribute.arraySize << "of attribute" << i;
+            return;
+        }
+
+        if(!Magnum::Implementation::isMeshAttributeValid(attribute.name)) {
+            Error{} << "Trade::MeshOptimizerImporter::openData(): invalid name" << attribute.name << "of attribute" << i;
+            return;
+        }
+
+        /* MeshAttributeData would assert on these in doMesh() */
+        const MeshAttribute name = MeshAttribute(attribute.name);
+        if(!Implementation::isVertexFormatCompatibleWithAttribute(name, format)) {
+            Error{} << "Trade::MeshOptimizerImporter::openData():" << format << "is not a valid format for" << name;
+            return;
+        }
+        if(attribute.arraySize && !Implementation::isAttributeArrayAllowed(name)) {
+            Error{} << "Trade::MeshOptimizerImporter::openData():" << name << "can't be an array attribute";
+            return;
+        }
+
+        const std::size_t attributeEnd = attribute.offset + vertexFormatSize(format)*Math::max(attribute.arraySize, 1u);
+        if(attributeEnd > header.vertexStride) {
+            Error{} << "Trade::MeshOptimizerImporter::openData(): attribute" << i << "spans" << attributeEnd << "bytes but the vertex stride is" << header.vertexStride;
+            return;
+        }
+    }
+
+    /* Take over the existing array or copy the data if we can't */
+    if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
+        _in = Utility::move(data);
+    } else {
+        _in = Containers::Array<char>{NoInit, data.size()};
+        Utility::copy(data, *_in);
+    }
+}
+
+UnsignedInt MeshOptimizerImporter::doMeshCount() const { return 1; }
+
+Containers::Optional<MeshData> MeshOptimizerImporter::doMesh(UnsignedInt, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMesh"};
+    Implementation::MeshOptimizerHeader header;
+    std::memcpy(&header, _in->data(), sizeof(header));
+    const std::size_t attributeTableOffset = sizeof(Implementation::MeshOptimizerHeader);
+    const std::size_t indexDataOffset = attributeTableOffset + header.attributeCount*sizeof(Implementation::MeshOptimizerAttribute);
+    const std::size_t vertexDataOffset = indexDataOffset + header.indexDataSize;
+
+    /* Decode the index data. There's no 8-bit variant of the codec so 8-bit
+       indices are decoded as 16-bit and narrowed after. */
+    Containers::Array<char> indexData;
+    if(header.indexType) {
+        const MeshIndexType indexType = MeshIndexType(header.indexType);
+        const std::size_t decodedIndexSize = indexType == MeshIndexType::UnsignedInt ? 4 : 2;
+        indexData = Containers::Array<char>{NoInit, header.indexCount*decodedIndexSize};
+        if(meshopt_decodeIndexBuffer(indexData.data(), header.indexCount, decodedIndexSize, reinterpret_cast<const unsigned char*>(_in->data() + indexDataOffset), header.indexDataSize) != 0) {
+            Error{} << "Trade::MeshOptimizerImporter::mesh(): invalid index data";
+            return {};
+        }
+
+        if(indexType == MeshIndexType::UnsignedByte) {
+            const Containers::ArrayView<const UnsignedShort> decoded = Containers::arrayCast<const UnsignedShort>(indexData);
+            Containers::Array<char> narrowed{NoInit, header.indexCount};
+            for(std::size_t i = 0; i != decoded.size(); ++i)
+                narrowed[i] = UnsignedByte(decoded[i]);
+            indexData = Utility::move(narrowed);
+        }
+    }
+
+    /* Decode the vertex data */
+    Containers::Array<char> vertexData{NoInit, std::size_t{header.vertexCount}*header.vertexStride};
+    if(header.vertexStride && meshopt_decodeVertexBuffer(vertexData.data(), header.vertexCount, header.vertexStride, reinterpret_cast<const unsigned char*>(_in->data() + vertexDataOffset), header.vertexDataSize) != 0) {
+        Error{} << "Trade::MeshOptimizerImporter::mesh(): invalid vertex data";
+        return {};
+    }
+
+    /* Attributes are all interleaved in the decoded data, described by the
+       attribute table */
+    Containers::Array<MeshAttributeData> attributeData{header.attributeCount};
+    for(UnsignedInt i = 0; i != header.attributeCount; ++i) {
+        Implementation::MeshOptimizerAttribute attribute;
+        std::memcpy(&attribute, _in->data() + attributeTableOffset + i*sizeof(Implementation::MeshOptimizerAttribute), sizeof(attribute));
+        attributeData[i] = MeshAttributeData{MeshAttribute(attribute.name), VertexFormat(attribute.format), attribute.offset, header.vertexCount, header.vertexStride, UnsignedShort(attribute.arraySize)};
+    }
+
+    if(!header.indexType)
+        return MeshData{MeshPrimitive(header.primitive),
+            Utility::move(vertexData), Utility::move(attributeData),
+            header.vertexCount};
+
+    const MeshIndexData indices{MeshIndexType(header.indexType), indexData};
+    return MeshData{MeshPrimitive(header.primitive),
+        Utility::move(indexData), indices,
+        Utility::move(vertexData), Utility::move(attributeData),
+        header.vertexCount};
+}
+
+}}
+
+CORRADE_PLUGIN_REGISTER(MeshOptimizerImporter, Magnum::Trade::MeshOptimizerImporter,
+    MAGNUM_TRADE_ABSTRACTIMPORTER_PLUGIN_INTERFACE)
@@ -0,0 +1,151 @@
+#ifndef Magnum_Trade_MeshOptimizerImporter_h
+#define Magnum_Trade_MeshOptimizerImporter_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Trade::MeshOptimizerImporter
+ * @m_since_latest_{plugins}
+ */
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Array.h>
+#include <Magnum/Trade/AbstractImporter.h>
+
+#include "MagnumPlugins/MeshOptimizerImporter/configure.h"
+
+#ifndef DOXYGEN_GENERATING_OUTPUT
+#ifndef MAGNUM_MESHOPTIMIZERIMPORTER_BUILD_STATIC
+    #ifdef MeshOptimizerImporter_EXPORTS
+        #define MAGNUM_MESHOPTIMIZERIMPORTER_EXPORT CORRADE_VISIBILITY_EXPORT
+    #else
+        #define MAGNUM_MESHOPTIMIZERIMPORTER_EXPORT CORRADE_VISIBILITY_IMPORT
+    #endif
+#else
+    #define MAGNUM_MESHOPTIMIZERIMPORTER_EXPORT CORRADE_VISIBILITY_STATIC
+#endif
+#define MAGNUM_MESHOPTIMIZERIMPORTER_LOCAL CORRADE_VISIBILITY_LOCAL
+#else
+#define MAGNUM_MESHOPTIMIZERIMPORTER_EXPORT
+#define MAGNUM_MESHOPTIMIZERIMPORTER_LOCAL
+#endif
+
+namespace Magnum { namespace Trade {
+
+/**
+@brief MeshOptimizer importer plugin
+@m_since_latest_{plugins}
+
+Decodes meshes compressed with the
+[meshoptimizer](https://github.com/zeux/meshoptimizer) vertex and index buffer
+codecs, as produced by @ref MeshOptimizerSceneConverter::convertToData().
+
+@m_class{m-block m-success}
+
+@thirdparty This plugin makes use of the
+    [meshoptimizer](https://github.com/zeux/meshoptimizer) library by Arseny
+    Kapoulkine, released under @m_class{m-label m-success} **MIT**
+    ([license text](https://github.com/zeux/meshoptimizer/blob/master/LICENSE.md),
+    [choosealicense.com](https://choosealicense.com/licenses/mit/)).
+
+@section Trade-MeshOptimizerImporter-usage Usage
+
+@m_class{m-note m-success}
+
+@par
+    This class is a plugin that's meant to be dynamically loaded and used
+    through the base @ref AbstractImporter interface. See its documentation for
+    introduction and usage examples.
+
+This plugin depends on the @ref Trade library and is built if
+`MAGNUM_WITH_MESHOPTIMIZERIMPORTER` is enabled when building Magnum Plugins. To
+use as a dynamic plugin, load @cpp "MeshOptimizerImporter" @ce via
+@ref Corrade::PluginManager::Manager.
+
+Additionally, if you're using Magnum as a CMake subproject, bundle the
+[magnum-plugins repository](https://github.com/mosra/magnum-plugins) and
+[meshoptimizer](https://github.com/zeux/meshoptimizer) repositories and do the
+following. If you want to use system-installed meshoptimizer, omit the first
+part and point `CMAKE_PREFIX_PATH` to its installation dir if necessary.
+
+@code{.cmake}
+set(CMAKE_POSITION_INDEPENDENT_CODE ON) # needed if building dynamic plugins
+add_subdirectory(meshoptimizer EXCLUDE_FROM_ALL)
+
+set(MAGNUM_WITH_MESHOPTIMIZERIMPORTER ON CACHE BOOL "" FORCE)
+add_subdirectory(magnum-plugins EXCLUDE_FROM_ALL)
+
+# So the dynamically loaded plugin gets built implicitly
+add_dependencies(your-app MagnumPlugins::MeshOptimizerImporter)
+@endcode
+
+To use as a static plugin or as a dependency of another plugin with CMake, put
+[FindMagnumPlugins.cmake](https://github.com/mosra/magnum-plugins/blob/master/modules/FindMagnumPlugins.cmake)
+into your `modules/` directory, request the `MeshOptimizerImporter` component
+of the `MagnumPlugins` package and link to the
+`MagnumPlugins::MeshOptimizerImporter` target:
+
+@code{.cmake}
+find_package(MagnumPlugins REQUIRED MeshOptimizerImporter)
+
+# ...
+target_link_libraries(your-app PRIVATE MagnumPlugins::MeshOptimizerImporter)
+@endcode
+
+See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
+information.
+
+@section Trade-MeshOptimizerImporter-behavior Behavior and limitations
+
+The file contains a single mesh, which is imported with the primitive, index
+type and attribute layout recorded by
+@ref MeshOptimizerSceneConverter::convertToData(). The vertex data are
+interleaved with a stride padded to a multiple of four bytes. The header is
+validated already when opening the file, the data are decoded on every
+@ref mesh() call. The file stores all values in the native endianness of the
+machine that produced it.
+*/
+class MAGNUM_MESHOPTIMIZERIMPORTER_EXPORT MeshOptimizerImporter: public AbstractImporter {
+    public:
+        /** @brief Plugin manager constructor */
+        explicit MeshOptimizerImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
+
+        ~MeshOptimizerImporter();
+
+    private:
+        MAGNUM_MESHOPTIMIZERIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
+        MAGNUM_MESHOPTIMIZERIMPORTER_LOCAL bool doIsOpened() const override;
+        MAGNUM_MESHOPTIMIZERIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
+        MAGNUM_MESHOPTIMIZERIMPORTER_LOCAL void doClose() override;
+
+        MAGNUM_MESHOPTIMIZERIMPORTER_LOCAL UnsignedInt doMeshCount() const override;
+        MAGNUM_MESHOPTIMIZERIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
+
+        Containers::Optional<Containers::Array<char>> _in;
+};
+
+}}
+
+#endif
@@ -0,0 +1,379 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/MeshTools/CompressIndices.h>
+#include <Magnum/Primitives/UVSphere.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
+#include <Magnum/Trade/MeshData.h>
+
+#include "MagnumPlugins/MeshOptimizerImporter/MeshOptimizerHeader.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct MeshOptimizerImporterTest: TestSuite::Tester {
+    explicit MeshOptimizerImporterTest();
+
+    void invalid();
+    void empty();
+
+    template<class T> void roundtrip();
+    void roundtripNoAttributes();
+    void invalidIndexData();
+    void invalidVertexData();
+
+    void openTwice();
+    void importTwice();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+    PluginManager::Manager<AbstractSceneConverter> _converterManager{"nonexistent"};
+};
+
+/* A valid file with no vertices, no indices and either no attributes or
+   position attributes with no format, which gets modified in the invalid()
+   test */
+Containers::Array<char> emptyFile(std::size_t attributeCount = 0) {
+    Containers::Array<char> out{ValueInit, sizeof(Implementation::MeshOptimizerHeader) + attributeCount*sizeof(Implementation::MeshOptimizerAttribute)};
+    Implementation::MeshOptimizerHeader& header = *reinterpret_cast<Implementation::MeshOptimizerHeader*>(out.data());
+    Utility::copy(Containers::arrayView(Implementation::MeshOptimizerMagic), Containers::arrayView(header.magic));
+    header.version = Implementation::MeshOptimizerVersion;
+    header.primitive = UnsignedInt(MeshPrimitive::Points);
+    header.attributeCount = attributeCount;
+    header.vertexStride = attributeCount ? 16 : 0;
+    Implementation::MeshOptimizerAttribute* attributes = reinterpret_cast<Implementation::MeshOptimizerAttribute*>(out.data() + sizeof(Implementation::MeshOptimizerHeader));
+    for(std::size_t i = 0; i != attributeCount; ++i)
+        attributes[i].name = UnsignedInt(MeshAttribute::Position);
+    return out;
+}
+
+const struct {
+    const char* name;
+    std::size_t attributeCount;
+    std::size_t size;
+    void(*modify)(Implementation::MeshOptimizerHeader&, Implementation::MeshOptimizerAttribute*);
+    const char* message;
+} InvalidData[]{
+    {"too short", 0, sizeof(Implementation::MeshOptimizerHeader) - 1,
+        [](Implementation::MeshOptimizerHeader&, Implementation::MeshOptimizerAttribute*) {},
+        "file too short, expected at least 40 bytes but got 39"},
+    {"invalid signature", 0, 0,
+        [](Implementation::MeshOptimizerHeader& header, Implementation::MeshOptimizerAttribute*) {
+            header.magic[3] = 'M';
+        }, "invalid file signature MOPM"},
+    {"unsupported version", 0, 0,
+        [](Implementation::MeshOptimizerHeader& header, Implementation::MeshOptimizerAttribute*) {
+            header.version = 2;
+        }, "unsupported version 2"},
+    {"invalid primitive", 0, 0,
+        [](Implementation::MeshOptimizerHeader& header, Implementation::MeshOptimizerAttribute*) {
+            header.primitive = 0;
+        }, "invalid primitive 0"},
+    {"invalid index type", 0, 0,
+        [](Implementation::MeshOptimizerHeader& header, Implementation::MeshOptimizerAttribute*) {
+            header.primitive = UnsignedInt(MeshPrimitive::Triangles);
+            header.indexType = 4;
+        }, "invalid index type 4 or count 0 for MeshPrimitive::Triangles"},
+    {"index count not divisible by 3", 0, 0,
+        [](Implementation::MeshOptimizerHeader& header, Implementation::MeshOptimizerAttribute*) {
+            header.primitive = UnsignedInt(MeshPrimitive::Triangles);
+            header.indexType = UnsignedInt(MeshIndexType::UnsignedShort);
+            header.indexCount = 4;
+        }, "invalid index type 2 or count 4 for MeshPrimitive::Triangles"},
+    {"indexed non-triangle mesh", 0, 0,
+        [](Implementation::MeshOptimizerHeader& header, Implementation::MeshOptimizerAttribute*) {
+            header.indexType = UnsignedInt(MeshIndexType::UnsignedShort);
+        }, "invalid index type 2 or count 0 for MeshPrimitive::Points"},
+    {"vertex stride not a multiple of four", 0, 0,
+        [](Implementation::MeshOptimizerHeader& header, Implementation::MeshOptimizerAttribute*) {
+            header.vertexStride = 6;
+        }, "invalid vertex stride 6"},
+    {"vertex stride too large", 0, 0,
+        [](Implementation::MeshOptimizerHeader& header, Implementation::MeshOptimizerAttribute*) {
+            header.vertexStride = 260;
+        }, "invalid vertex stride 260"},
+    {"zero vertex stride with attributes", 1, 0,
+        [](Implementation::MeshOptimizerHeader& header, Implementation::MeshOptimizerAttribute* attributes) {
+            header.vertexStride = 0;
+            attributes[0].format = UnsignedInt(VertexFormat::Vector3);
+        }, "invalid vertex stride 0"},
+    {"size mismatch", 0, sizeof(Implementation::MeshOptimizerHeader) + 1,
+        [](Implementation::MeshOptimizerHeader&, Implementation::MeshOptimizerAttribute*) {},
+        "file size doesn't match the header, expected 40 bytes but got 41"},
+    {"invalid attribute format", 1, 0,
+        [](Implementation::MeshOptimizerHeader&, Implementation::MeshOptimizerAttribute* attributes) {
+            attributes[0].format = 0;
+        }, "invalid format 0 or array size 0 of attribute 0"},
+    {"attribute format out of range", 1, 0,
+        [](Implementation::MeshOptimizerHeader&, Implementation::MeshOptimizerAttribute* attributes) {
+            attributes[0].format = 0xdead;
+        }, "invalid format 57005 or array size 0 of attribute 0"},
+    {"implementation-specific attribute format", 1, 0,
+        [](Implementation::MeshOptimizerHeader&, Implementation::MeshOptimizerAttribute* attributes) {
+            attributes[0].format = UnsignedInt(vertexFormatWrap(0xcaca));
+        }, "invalid format 2147535562 or array size 0 of attribute 0"},
+    {"attribute array too large", 1, 0,
+        [](Implementation::MeshOptimizerHeader&, Implementation::MeshOptimizerAttribute* attributes) {
+            attributes[0].format = UnsignedInt(VertexFormat::Float);
+            attributes[0].arraySize = 65536;
+        }, "invalid format 1 or array size 65536 of attribute 0"},
+    {"invalid attribute name", 1, 0,
+        [](Implementation::MeshOptimizerHeader&, Implementation::MeshOptimizerAttribute* attributes) {
+            attributes[0].name = 0x7fff;
+            attributes[0].format = UnsignedInt(VertexFormat::Vector3);
+        }, "invalid name 32767 of attribute 0"},
+    {"attribute format not compatible", 1, 0,
+        [](Implementation::MeshOptimizerHeader&, Implementation::MeshOptimizerAttribute* attributes) {
+            attributes[0].format = UnsignedInt(VertexFormat::UnsignedInt);
+        }, "VertexFormat::UnsignedInt is not a valid format for Trade::MeshAttribute::Position"},
+    {"builtin array attribute", 1, 0,
+        [](Implementation::MeshOptimizerHeader&, Implementation::MeshOptimizerAttribute* attributes) {
+            attributes[0].format = UnsignedInt(VertexFormat::Vector3);
+            attributes[0].arraySize = 2;
+        }, "Trade::MeshAttribute::Position can't be an array attribute"},
+    {"attribute out of bounds", 1, 0,
+        [](Implementation::MeshOptimizerHeader&, Implementation::MeshOptimizerAttribute* attributes) {
+            attributes[0].format = UnsignedInt(VertexFormat::Vector3);
+            attributes[0].offset = 8;
+        }, "attribute 0 spans 20 bytes but the vertex stride is 16"},
+};
+
+MeshOptimizerImporterTest::MeshOptimizerImporterTest() {
+    addInstancedTests({&MeshOptimizerImporterTest::invalid},
+        Containers::arraySize(InvalidData));
+
+    addTests({&MeshOptimizerImporterTest::empty,
+
+              &MeshOptimizerImporterTest::roundtrip<UnsignedByte>,
+              &MeshOptimizerImporterTest::roundtrip<UnsignedShort>,
+              &MeshOptimizerImporterTest::roundtrip<UnsignedInt>,
+              &MeshOptimizerImporterTest::roundtripNoAttributes,
+              &MeshOptimizerImporterTest::invalidIndexData,
+              &MeshOptimizerImporterTest::invalidVertexData,
+
+              &MeshOptimizerImporterTest::openTwice,
+              &MeshOptimizerImporterTest::importTwice});
+
+    /* Load the plugins directly from the build tree. Otherwise they're static
+       and already loaded. */
+    #ifdef MESHOPTIMIZERIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(MESHOPTIMIZERIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef MESHOPTIMIZERSCENECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(MESHOPTIMIZERSCENECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void MeshOptimizerImporterTest::invalid() {
+    auto&& data = InvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("MeshOptimizerImporter");
+
+    Containers::Array<char> file = emptyFile(data.attributeCount);
+    data.modify(*reinterpret_cast<Implementation::MeshOptimizerHeader*>(file.data()), reinterpret_cast<Implementation::MeshOptimizerAttribute*>(file.data() + sizeof(Implementation::MeshOptimizerHeader)));
+
+    /* Size override, either truncating or padding the file */
+    Containers::Array<char> sized{ValueInit, data.size ? data.size : file.size()};
+    Utility::copy(file.prefix(Math::min(file.size(), sized.size())), sized.prefix(Math::min(file.size(), sized.size())));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openData(sized));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::MeshOptimizerImporter::openData(): {}\n", data.message));
+}
+
+void MeshOptimizerImporterTest::empty() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("MeshOptimizerImporter");
+
+    CORRADE_VERIFY(importer->openData(emptyFile()));
+    CORRADE_COMPARE(importer->meshCount(), 1);
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Points);
+    CORRADE_VERIFY(!mesh->isIndexed());
+    CORRADE_COMPARE(mesh->vertexCount(), 0);
+    CORRADE_COMPARE(mesh->attributeCount(), 0);
+}
+
+template<class T> void MeshOptimizerImporterTest::roundtrip() {
+    setTestCaseTemplateName(Math::TypeTraits<T>::name());
+
+    if(!(_converterManager.load("MeshOptimizerSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("MeshOptimizerSceneConverter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("MeshOptimizerSceneConverter");
+
+    MeshData sphere = MeshTools::compressIndices(Primitives::uvSphereSolid(4, 6, Primitives::UVSphereFlag::TextureCoordinates), Implementation::meshIndexTypeFor<T>());
+
+    /* The encoding runs the same processing as convert(), so that's what the
+       decoded mesh should match */
+    Containers::Optional<MeshData> converted = converter->convert(sphere);
+    CORRADE_VERIFY(converted);
+    Containers::Optional<Containers::Array<char>> data = converter->convertToData(sphere);
+    CORRADE_VERIFY(data);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("MeshOptimizerImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE(mesh->indexType(), Implementation::meshIndexTypeFor<T>());
+    CORRADE_COMPARE_AS(mesh->indices<T>(),
+        converted->indices<T>(),
+        TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(mesh->vertexCount(), converted->vertexCount());
+    CORRADE_COMPARE(mesh->attributeCount(), 3);
+    CORRADE_COMPARE(mesh->attributeStride(0), 32);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        converted->attribute<Vector3>(MeshAttribute::Position),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        converted->attribute<Vector3>(MeshAttribute::Normal),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+        converted->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+        TestSuite::Compare::Container);
+}
+
+void MeshOptimizerImporterTest::roundtripNoAttributes() {
+    if(!(_converterManager.load("MeshOptimizerSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("MeshOptimizerSceneConverter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("MeshOptimizerSceneConverter");
+    /* This one needs positions */
+    converter->configuration().setValue("optimizeOverdraw", false);
+
+    const UnsignedShort indices[]{0, 1, 2, 2, 1, 3};
+    MeshData input{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices}, 4};
+
+    Containers::Optional<MeshData> converted = converter->convert(input);
+    CORRADE_VERIFY(converted);
+    Containers::Optional<Containers::Array<char>> data = converter->convertToData(input);
+    CORRADE_VERIFY(data);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("MeshOptimizerImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexCount(), 4);
+    CORRADE_COMPARE(mesh->attributeCount(), 0);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+        converted->indices<UnsignedShort>(),
+        TestSuite::Compare::Container);
+}
+
+void MeshOptimizerImporterTest::invalidIndexData() {
+    if(!(_converterManager.load("MeshOptimizerSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("MeshOptimizerSceneConverter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("MeshOptimizerSceneConverter");
+    Containers::Optional<Containers::Array<char>> data = converter->convertToData(Primitives::uvSphereSolid(4, 6));
+    CORRADE_VERIFY(data);
+
+    /* Corrupt the first byte of the encoded index data, which is the codec
+       header */
+    const auto& header = *reinterpret_cast<const Implementation::MeshOptimizerHeader*>(data->data());
+    (*data)[sizeof(Implementation::MeshOptimizerHeader) + header.attributeCount*sizeof(Implementation::MeshOptimizerAttribute)] = 0;
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("MeshOptimizerImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(0));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerImporter::mesh(): invalid index data\n");
+}
+
+void MeshOptimizerImporterTest::invalidVertexData() {
+    if(!(_converterManager.load("MeshOptimizerSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("MeshOptimizerSceneConverter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("MeshOptimizerSceneConverter");
+    Containers::Optional<Containers::Array<char>> data = converter->convertToData(Primitives::uvSphereSolid(4, 6));
+    CORRADE_VERIFY(data);
+
+    /* Corrupt the first byte of the encoded vertex data, which is the codec
+       header */
+    const auto& header = *reinterpret_cast<const Implementation::MeshOptimizerHeader*>(data->data());
+    (*data)[data->size() - header.vertexDataSize] = 0;
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("MeshOptimizerImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(0));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerImporter::mesh(): invalid vertex data\n");
+}
+
+void MeshOptimizerImporterTest::openTwice() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("MeshOptimizerImporter");
+
+    CORRADE_VERIFY(importer->openData(emptyFile()));
+    CORRADE_VERIFY(importer->openData(emptyFile()));
+
+    /* Shouldn't crash, leak or anything */
+}
+
+void MeshOptimizerImporterTest::importTwice() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("MeshOptimizerImporter");
+    CORRADE_VERIFY(importer->openData(emptyFile()));
+
+    /* Verify that everything is working the same way on second use */
+    {
+        Containers::Optional<MeshData> mesh = importer->mesh(0);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->vertexCount(), 0);
+    } {
+        Containers::Optional<MeshData> mesh = importer->mesh(0);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->vertexCount(), 0);
+    }
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::MeshOptimizerImporterTest)
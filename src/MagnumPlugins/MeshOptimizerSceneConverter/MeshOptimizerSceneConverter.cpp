@@ -25,28 +25,51 @@
 
 #include "MeshOptimizerSceneConverter.h"
 
+#include <atomic>
+#include <cstdlib> /* std::strtof() */
+#include <sstream>
+#include <thread>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Iterable.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/PackingBatch.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/MeshTools/Combine.h>
+#include <Magnum/MeshTools/CompressIndices.h>
 #include <Magnum/MeshTools/Copy.h>
 #include <Magnum/MeshTools/Duplicate.h>
 #include <Magnum/MeshTools/GenerateIndices.h>
 #include <Magnum/MeshTools/Interleave.h>
+#include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ArrayAllocator.h>
 #include <Magnum/Trade/MeshData.h>
 #include <meshoptimizer.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+#include "Magnum/Implementation/profilingZone.h"
+#include "MagnumPlugins/MeshOptimizerImporter/MeshOptimizerHeader.h"
+
 namespace Magnum { namespace Trade {
 
+using namespace Containers::Literals;
+
 MeshOptimizerSceneConverter::MeshOptimizerSceneConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractSceneConverter{manager, plugin} {}
 
 MeshOptimizerSceneConverter::~MeshOptimizerSceneConverter() = default;
 
 SceneConverterFeatures MeshOptimizerSceneConverter::doFeatures() const {
-    return SceneConverterFeature::ConvertMeshInPlace|SceneConverterFeature::ConvertMesh;
+    return SceneConverterFeature::ConvertMeshInPlace|
+           SceneConverterFeature::ConvertMesh|
+           SceneConverterFeature::ConvertMeshToData|
+           SceneConverterFeature::ConvertMultiple|
+           SceneConverterFeature::AddMeshes;
 }
 
 namespace {
@@ -58,22 +81,24 @@ template<class T> void analyze(const MeshData& mesh, const Utility::Configuratio
     if(positions) overdrawStats = meshopt_analyzeOverdraw(indices.data(), mesh.indexCount(), static_cast<const float*>(positions.data()), mesh.vertexCount(), positions.stride());
 }
 
-void analyze(const MeshData& mesh, const Utility::ConfigurationGroup& configuration, const Containers::StridedArrayView1D<const Vector3> positions, Containers::Optional<UnsignedInt>& vertexSize, meshopt_VertexCacheStatistics& vertexCacheStats, meshopt_VertexFetchStatistics& vertexFetchStats, meshopt_OverdrawStatistics& overdrawStats) {
-    /* Calculate vertex size out of all attributes. If any attribute is
-       implementation-specific, do nothing (warning will be printed by the
-       caller) */
-    if(!vertexSize) {
-        vertexSize = 0;
-        for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
-            VertexFormat format = mesh.attributeFormat(i);
-            const UnsignedInt arraySize = mesh.attributeArraySize(i);
-            if(isVertexFormatImplementationSpecific(format)) {
-                vertexSize = 0;
-                break;
-            }
-            *vertexSize += vertexFormatSize(format)*(arraySize ? arraySize : 1);
-        }
+/* Calculates vertex size out of all attributes. If any attribute is
+   implementation-specific, returns 0 (warning will be printed by the
+   caller) */
+UnsignedInt attributeVertexSize(const MeshData& mesh) {
+    UnsignedInt vertexSize = 0;
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        VertexFormat format = mesh.attributeFormat(i);
+        const UnsignedInt arraySize = mesh.attributeArraySize(i);
+        if(isVertexFormatImplementationSpecific(format))
+            return 0;
+        vertexSize += vertexFormatSize(format)*(arraySize ? arraySize : 1);
     }
+    return vertexSize;
+}
+
+void analyze(const MeshData& mesh, const Utility::ConfigurationGroup& configuration, const Containers::StridedArrayView1D<const Vector3> positions, Containers::Optional<UnsignedInt>& vertexSize, meshopt_VertexCacheStatistics& vertexCacheStats, meshopt_VertexFetchStatistics& vertexFetchStats, meshopt_OverdrawStatistics& overdrawStats) {
+    if(!vertexSize)
+        vertexSize = attributeVertexSize(mesh);
 
     if(mesh.indexType() == MeshIndexType::UnsignedInt)
         analyze<UnsignedInt>(mesh, configuration, *vertexSize, positions, vertexCacheStats, vertexFetchStats, overdrawStats);
@@ -84,7 +109,37 @@ void analyze(const MeshData& mesh, const Utility::ConfigurationGroup& configurat
     else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 }
 
-void analyzePost(const char* prefix, const MeshData& mesh, const Utility::ConfigurationGroup& configuration, const SceneConverterFlags flags, const Containers::StridedArrayView1D<const Vector3> positions, Containers::Optional<UnsignedInt>& vertexSize, meshopt_VertexCacheStatistics& vertexCacheStatsBefore, meshopt_VertexFetchStatistics& vertexFetchStatsBefore, meshopt_OverdrawStatistics& overdrawStatsBefore) {
+/* Whether the before & after stats need to be calculated, either for
+   verbose output or for the stats configuration group */
+bool needsStats(const SceneConverterFlags flags, const Utility::ConfigurationGroup& configuration) {
+    return flags & SceneConverterFlag::Verbose || configuration.value<bool>("writeStats");
+}
+
+/* Replaces the stats configuration group with a new empty one */
+Utility::ConfigurationGroup& resetStats(Utility::ConfigurationGroup& configuration) {
+    configuration.removeAllGroups("stats");
+    return *configuration.addGroup("stats");
+}
+
+void writeStats(Utility::ConfigurationGroup& group, const meshopt_VertexCacheStatistics& vertexCacheStats, const meshopt_VertexFetchStatistics* const vertexFetchStats, const meshopt_OverdrawStatistics* const overdrawStats) {
+    group.setValue("verticesTransformed", vertexCacheStats.vertices_transformed);
+    group.setValue("warpsExecuted", vertexCacheStats.warps_executed);
+    group.setValue("acmr", vertexCacheStats.acmr);
+    group.setValue("atvr", vertexCacheStats.atvr);
+    if(vertexFetchStats) {
+        group.setValue("bytesFetched", vertexFetchStats->bytes_fetched);
+        group.setValue("overfetch", vertexFetchStats->overfetch);
+    }
+    if(overdrawStats) {
+        group.setValue("pixelsShaded", overdrawStats->pixels_shaded);
+        group.setValue("pixelsCovered", overdrawStats->pixels_covered);
+        group.setValue("overdraw", overdrawStats->overdraw);
+    }
+}
+
+/* Prints the before & after stats if verbose output is enabled and writes
+   them into `stats` if it's not null */
+void analyzePost(const char* prefix, const MeshData& mesh, const Utility::ConfigurationGroup& configuration, const SceneConverterFlags flags, const Containers::StridedArrayView1D<const Vector3> positions, Containers::Optional<UnsignedInt>& vertexSize, meshopt_VertexCacheStatistics& vertexCacheStatsBefore, meshopt_VertexFetchStatistics& vertexFetchStatsBefore, meshopt_OverdrawStatistics& overdrawStatsBefore, Utility::ConfigurationGroup* const stats) {
     /* If vertex size is zero, it means there was an implementation-specific
        vertex format somewhere. Print a warning about that. */
     CORRADE_INTERNAL_ASSERT(vertexSize);
@@ -102,6 +157,14 @@ void analyzePost(const char* prefix, const MeshData& mesh, const Utility::Config
     meshopt_OverdrawStatistics overdrawStats;
     analyze(mesh, configuration, positions, vertexSize, vertexCacheStats, vertexFetchStats, overdrawStats);
 
+    if(stats) {
+        writeStats(*stats->addGroup("before"), vertexCacheStatsBefore, *vertexSize ? &vertexFetchStatsBefore : nullptr, positions ? &overdrawStatsBefore : nullptr);
+        writeStats(*stats->addGroup("after"), vertexCacheStats, *vertexSize ? &vertexFetchStats : nullptr, positions ? &overdrawStats : nullptr);
+    }
+
+    if(!(flags & SceneConverterFlag::Verbose))
+        return;
+
     Debug{} << prefix << "processing stats:";
     Debug{} << "  vertex cache:\n   "
         << vertexCacheStatsBefore.vertices_transformed << "->"
@@ -137,6 +200,147 @@ void populatePositions(const MeshData& mesh, Containers::Array<Vector3>& positio
     }
 }
 
+/* Creates attributes with the same layout as in the interleaved `mesh`, but
+   pointing to `vertexData` that starts at the first interleaved byte and
+   contains `vertexCount` vertices */
+Containers::Array<MeshAttributeData> interleavedAttributes(const MeshData& mesh, const Containers::ArrayView<const char> vertexData, const UnsignedInt vertexCount) {
+    const Containers::StridedArrayView2D<const char> interleavedData = MeshTools::interleavedData(mesh);
+    const std::size_t begin = interleavedData.data() - static_cast<const char*>(mesh.vertexData().data());
+    Containers::Array<MeshAttributeData> attributes{mesh.attributeCount()};
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i)
+        attributes[i] = MeshAttributeData{mesh.attributeName(i),
+            mesh.attributeFormat(i),
+            Containers::StridedArrayView1D<const void>{vertexData, vertexData + mesh.attributeOffset(i) - begin, vertexCount, interleavedData.stride()[0]},
+            mesh.attributeArraySize(i), mesh.attributeMorphTargetId(i)};
+    return attributes;
+}
+
+/* Parses the quantize* options into component formats, VertexFormat{} if
+   given quantization is disabled */
+bool parseQuantization(const char* prefix, const Utility::ConfigurationGroup& configuration, VertexFormat& normalFormat, VertexFormat& textureCoordinateFormat, VertexFormat& positionFormat) {
+    const Containers::StringView normals = configuration.value<Containers::StringView>("quantizeNormals");
+    if(normals.isEmpty())
+        normalFormat = {};
+    else if(normals == "snorm8"_s)
+        normalFormat = VertexFormat::Byte;
+    else if(normals == "snorm16"_s)
+        normalFormat = VertexFormat::Short;
+    else {
+        Error{} << prefix << "expected quantizeNormals to be empty, snorm8 or snorm16 but got" << normals;
+        return false;
+    }
+
+    const Containers::StringView textureCoordinates = configuration.value<Containers::StringView>("quantizeTextureCoordinates");
+    if(textureCoordinates.isEmpty())
+        textureCoordinateFormat = {};
+    else if(textureCoordinates == "unorm16"_s)
+        textureCoordinateFormat = VertexFormat::UnsignedShort;
+    else {
+        Error{} << prefix << "expected quantizeTextureCoordinates to be empty or unorm16 but got" << textureCoordinates;
+        return false;
+    }
+
+    const Containers::StringView positions = configuration.value<Containers::StringView>("quantizePositions");
+    if(positions.isEmpty())
+        positionFormat = {};
+    else if(positions == "half"_s)
+        positionFormat = VertexFormat::Half;
+    else {
+        Error{} << prefix << "expected quantizePositions to be empty or half but got" << positions;
+        return false;
+    }
+
+    return true;
+}
+
+/* Copies the mesh into a new interleaved layout with each attribute aligned
+   to four bytes, quantizing floating-point normals, tangents, bitangents,
+   texture coordinates and positions to given component formats. Attributes
+   that aren't floating-point or are arrays are copied unchanged. Index data
+   are taken over from the original mesh. */
+MeshData quantize(const char* prefix, MeshData& mesh, const SceneConverterFlags flags, const VertexFormat normalFormat, const VertexFormat textureCoordinateFormat, const VertexFormat positionFormat) {
+    Containers::Array<VertexFormat> formats{NoInit, mesh.attributeCount()};
+    Containers::Array<std::size_t> offsets{NoInit, mesh.attributeCount()};
+    std::size_t stride = 0;
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        const MeshAttribute name = mesh.attributeName(i);
+        const VertexFormat format = mesh.attributeFormat(i);
+        formats[i] = format;
+        if(vertexFormatComponentFormat(format) == VertexFormat::Float && !mesh.attributeArraySize(i)) {
+            const UnsignedInt componentCount = vertexFormatComponentCount(format);
+            if(normalFormat != VertexFormat{} && (name == MeshAttribute::Normal || name == MeshAttribute::Tangent || name == MeshAttribute::Bitangent))
+                formats[i] = vertexFormat(normalFormat, componentCount, true);
+            else if(textureCoordinateFormat != VertexFormat{} && name == MeshAttribute::TextureCoordinates) {
+                /* Unsigned normalized formats can represent only the [0, 1]
+                   range, leave the attribute as-is otherwise */
+                const Containers::StridedArrayView2D<const Float> src = mesh.attribute<Float[]>(i);
+                bool inRange = true;
+                for(Containers::StridedArrayView1D<const Float> vertex: src)
+                    for(const Float component: vertex)
+                        if(!(component >= 0.0f && component <= 1.0f))
+                            inRange = false;
+                if(inRange)
+                    formats[i] = vertexFormat(textureCoordinateFormat, componentCount, true);
+                else if(!(flags & SceneConverterFlag::Quiet))
+                    Warning{} << prefix << "texture coordinates in attribute" << i << "are outside of the [0, 1] range, not quantizing";
+            } else if(positionFormat != VertexFormat{} && name == MeshAttribute::Position)
+                formats[i] = vertexFormat(positionFormat, componentCount, false);
+        }
+
+        offsets[i] = stride;
+        stride += 4*((vertexFormatSize(formats[i])*Math::max(mesh.attributeArraySize(i), UnsignedShort{1}) + 3)/4);
+    }
+
+    /* Zero-initialized so the padding is deterministic */
+    Containers::Array<char> vertexData{ValueInit, mesh.vertexCount()*stride};
+    Containers::Array<MeshAttributeData> attributes{mesh.attributeCount()};
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        char* const dstData = vertexData + offsets[i];
+        if(formats[i] == mesh.attributeFormat(i)) {
+            const Containers::StridedArrayView2D<const char> src = mesh.attribute(i);
+            Utility::copy(src, Containers::StridedArrayView2D<char>{vertexData,
+                dstData, src.size(), {std::ptrdiff_t(stride), 1}});
+        } else {
+            const Containers::StridedArrayView2D<const Float> src = mesh.attribute<Float[]>(i);
+            const Containers::Size2D size{mesh.vertexCount(), vertexFormatComponentCount(formats[i])};
+            const VertexFormat componentFormat = vertexFormatComponentFormat(formats[i]);
+            if(componentFormat == VertexFormat::Byte)
+                Math::packInto(src, Containers::StridedArrayView2D<Byte>{vertexData, reinterpret_cast<Byte*>(dstData), size, {std::ptrdiff_t(stride), 1}});
+            else if(componentFormat == VertexFormat::Short)
+                Math::packInto(src, Containers::StridedArrayView2D<Short>{vertexData, reinterpret_cast<Short*>(dstData), size, {std::ptrdiff_t(stride), 2}});
+            else if(componentFormat == VertexFormat::UnsignedShort)
+                Math::packInto(src, Containers::StridedArrayView2D<UnsignedShort>{vertexData, reinterpret_cast<UnsignedShort*>(dstData), size, {std::ptrdiff_t(stride), 2}});
+            else if(componentFormat == VertexFormat::Half)
+                Math::packHalfInto(src, Containers::StridedArrayView2D<UnsignedShort>{vertexData, reinterpret_cast<UnsignedShort*>(dstData), size, {std::ptrdiff_t(stride), 2}});
+            else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        }
+
+        attributes[i] = MeshAttributeData{mesh.attributeName(i),
+            formats[i],
+            Containers::StridedArrayView1D<const void>{vertexData, dstData, mesh.vertexCount(), std::ptrdiff_t(stride)},
+            mesh.attributeArraySize(i), mesh.attributeMorphTargetId(i)};
+    }
+
+    const MeshIndexData indices{mesh.indices()};
+    return MeshData{mesh.primitive(),
+        mesh.releaseIndexData(), indices,
+        Utility::move(vertexData), Utility::move(attributes),
+        mesh.vertexCount()};
+}
+
+template<class T> void optimizeVertexCache(const Containers::ArrayView<T> indices, const UnsignedInt vertexCount, const bool strip) {
+    #if MESHOPTIMIZER_VERSION >= 150
+    if(strip)
+        meshopt_optimizeVertexCacheStrip(indices.data(), indices.data(), indices.size(), vertexCount);
+    else
+    #else
+    static_cast<void>(strip);
+    #endif
+    {
+        meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertexCount);
+    }
+}
+
 bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConverterFlags flags, const Utility::ConfigurationGroup& configuration, Containers::Array<Vector3>& positionStorage, Containers::StridedArrayView1D<const Vector3>& positions, Containers::Optional<UnsignedInt>& vertexSize,  meshopt_VertexCacheStatistics& vertexCacheStatsBefore, meshopt_VertexFetchStatistics& vertexFetchStatsBefore, meshopt_OverdrawStatistics& overdrawStatsBefore) {
     /* Only doConvert() can handle triangle strips etc, in-place only triangles */
     if(mesh.primitive() != MeshPrimitive::Triangles) {
@@ -150,10 +354,16 @@ bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConve
         return false;
     }
 
+    /* Quantization is rejected by doConvertInPlace() already, so this is
+       only reached from convert() and other non-in-place operations */
+    VertexFormat normalFormat, textureCoordinateFormat, positionFormat;
+    if(!parseQuantization(prefix, configuration, normalFormat, textureCoordinateFormat, positionFormat))
+        return false;
+
     /* If we need it, get the position attribute, unpack if packed. It's used
-       by the verbose stats also but in that case the processing shouldn't fail
-       if there are no positions -- so check the hasAttribute() earlier. */
-    if((flags & SceneConverterFlag::Verbose && mesh.hasAttribute(MeshAttribute::Position)) ||
+       by the stats also but in that case the processing shouldn't fail if
+       there are no positions -- so check the hasAttribute() earlier. */
+    if((needsStats(flags, configuration) && mesh.hasAttribute(MeshAttribute::Position)) ||
        configuration.value<bool>("optimizeOverdraw") ||
        configuration.value<bool>("simplify") ||
        configuration.value<bool>("simplifySloppy"))
@@ -166,28 +376,30 @@ bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConve
         populatePositions(mesh, positionStorage, positions);
     }
 
-    /* Save "before" stats if verbose output is requested. No messages as those
-       will be printed only at the end if the processing passes. */
-    if(flags & SceneConverterFlag::Verbose) {
+    /* Save "before" stats if verbose output or the stats are requested. No
+       messages as those will be printed only at the end if the processing
+       passes. */
+    if(needsStats(flags, configuration)) {
         analyze(mesh, configuration, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore);
     }
 
-    /* Vertex cache optimization. Goes first. */
+    /* Vertex cache optimization. Goes first. If the mesh gets converted to
+       a triangle strip at the end, the order is optimized for that. */
     if(configuration.value<bool>("optimizeVertexCache")) {
-        if(mesh.indexType() == MeshIndexType::UnsignedInt) {
-            Containers::ArrayView<UnsignedInt> indices = mesh.mutableIndices<UnsignedInt>().asContiguous();
-            meshopt_optimizeVertexCache(indices.data(), indices.data(), mesh.indexCount(), mesh.vertexCount());
-        } else if(mesh.indexType() == MeshIndexType::UnsignedShort) {
-            Containers::ArrayView<UnsignedShort> indices = mesh.mutableIndices<UnsignedShort>().asContiguous();
-            meshopt_optimizeVertexCache(indices.data(), indices.data(), mesh.indexCount(), mesh.vertexCount());
-        } else if(mesh.indexType() == MeshIndexType::UnsignedByte) {
-            Containers::ArrayView<UnsignedByte> indices = mesh.mutableIndices<UnsignedByte>().asContiguous();
-            meshopt_optimizeVertexCache(indices.data(), indices.data(), mesh.indexCount(), mesh.vertexCount());
-        } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        MAGNUM_PROFILING_ZONE("MeshOptimizerSceneConverter optimizeVertexCache");
+        const bool strip = configuration.value<bool>("stripify");
+        if(mesh.indexType() == MeshIndexType::UnsignedInt)
+            optimizeVertexCache(mesh.mutableIndices<UnsignedInt>().asContiguous(), mesh.vertexCount(), strip);
+        else if(mesh.indexType() == MeshIndexType::UnsignedShort)
+            optimizeVertexCache(mesh.mutableIndices<UnsignedShort>().asContiguous(), mesh.vertexCount(), strip);
+        else if(mesh.indexType() == MeshIndexType::UnsignedByte)
+            optimizeVertexCache(mesh.mutableIndices<UnsignedByte>().asContiguous(), mesh.vertexCount(), strip);
+        else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
     }
 
     /* Overdraw optimization. Goes after vertex cache optimization. */
     if(configuration.value<bool>("optimizeOverdraw")) {
+        MAGNUM_PROFILING_ZONE("MeshOptimizerSceneConverter optimizeOverdraw");
         const Float optimizeOverdrawThreshold = configuration.value<Float>("optimizeOverdrawThreshold");
 
         if(mesh.indexType() == MeshIndexType::UnsignedInt) {
@@ -202,34 +414,174 @@ bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConve
         } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
     }
 
+    /* Quantization. Goes after overdraw optimization, which needs the
+       original positions, and before vertex fetch optimization, which then
+       operates on the smaller vertex data. All attributes are checked
+       upfront as the new layout can't be calculated for
+       implementation-specific formats. */
+    if(normalFormat != VertexFormat{} || textureCoordinateFormat != VertexFormat{} || positionFormat != VertexFormat{}) {
+        MAGNUM_PROFILING_ZONE("MeshOptimizerSceneConverter quantization");
+        for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+            if(isVertexFormatImplementationSpecific(mesh.attributeFormat(i))) {
+                Error{} << prefix << "can't quantize a mesh with an implementation-specific vertex format" << reinterpret_cast<void*>(vertexFormatUnwrap(mesh.attributeFormat(i)));
+                return false;
+            }
+        }
+
+        mesh = quantize(prefix, mesh, flags, normalFormat, textureCoordinateFormat, positionFormat);
+
+        /* The positions may be pointing to the original vertex data, and the
+           vertex size used for the after stats is now different */
+        if(positions)
+            populatePositions(mesh, positionStorage, positions);
+        if(vertexSize)
+            vertexSize = attributeVertexSize(mesh);
+    }
+
     /* Vertex fetch optimization. Goes after overdraw optimization. Reorders
        the vertex buffer for better memory locality, so if we have no
        attributes it's of no use (also meshoptimizer asserts in that case).
        Skipping silently instead of failing hard, as an attribute-less mesh
        always *is* optimized for vertex fetch, so there's nothing wrong. */
     if(configuration.value<bool>("optimizeVertexFetch") && mesh.attributeCount()) {
+        MAGNUM_PROFILING_ZONE("MeshOptimizerSceneConverter optimizeVertexFetch");
         /* This assumes the mesh is interleaved. doConvert() already ensures
            that, doConvertInPlace() has a runtime check */
-        Containers::StridedArrayView2D<char> interleavedData = MeshTools::interleavedMutableData(mesh);
+        const Containers::StridedArrayView2D<const char> interleavedData = MeshTools::interleavedData(mesh);
+        const UnsignedInt stride = interleavedData.stride()[0];
+
+        /* If the vertex data isn't mutable, it's a view on the convert()
+           input, see convertInternal(). Optimize into a new allocation in
+           that case, otherwise in-place. */
+        Containers::Array<char> vertexData;
+        char* output;
+        if(mesh.vertexDataFlags() & DataFlag::Mutable)
+            output = MeshTools::interleavedMutableData(mesh).data();
+        else {
+            vertexData = Containers::Array<char>{NoInit, std::size_t(mesh.vertexCount())*stride};
+            output = vertexData.data();
+        }
 
         if(mesh.indexType() == MeshIndexType::UnsignedInt) {
             Containers::ArrayView<UnsignedInt> indices = mesh.mutableIndices<UnsignedInt>().asContiguous();
-            meshopt_optimizeVertexFetch(interleavedData.data(), indices.data(), mesh.indexCount(), interleavedData.data(), mesh.vertexCount(), interleavedData.stride()[0]);
+            meshopt_optimizeVertexFetch(output, indices.data(), mesh.indexCount(), interleavedData.data(), mesh.vertexCount(), stride);
         } else if(mesh.indexType() == MeshIndexType::UnsignedShort) {
             Containers::ArrayView<UnsignedShort> indices = mesh.mutableIndices<UnsignedShort>().asContiguous();
-            meshopt_optimizeVertexFetch(interleavedData.data(), indices.data(), mesh.indexCount(), interleavedData.data(), mesh.vertexCount(), interleavedData.stride()[0]);
+            meshopt_optimizeVertexFetch(output, indices.data(), mesh.indexCount(), interleavedData.data(), mesh.vertexCount(), stride);
         } else if(mesh.indexType() == MeshIndexType::UnsignedByte) {
             Containers::ArrayView<UnsignedByte> indices = mesh.mutableIndices<UnsignedByte>().asContiguous();
-            meshopt_optimizeVertexFetch(interleavedData.data(), indices.data(), mesh.indexCount(), interleavedData.data(), mesh.vertexCount(), interleavedData.stride()[0]);
+            meshopt_optimizeVertexFetch(output, indices.data(), mesh.indexCount(), interleavedData.data(), mesh.vertexCount(), stride);
         } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+        /* Put the new vertex data together with the same layout, relative
+           to the first interleaved byte. The positions, if any, are pointing
+           to the original data in a different order now, fetch them again. */
+        if(vertexData) {
+            Containers::Array<MeshAttributeData> attributes = interleavedAttributes(mesh, vertexData, mesh.vertexCount());
+            const MeshIndexData indices{mesh.indices()};
+            const UnsignedInt vertexCount = mesh.vertexCount();
+            mesh = MeshData{mesh.primitive(),
+                mesh.releaseIndexData(), indices,
+                Utility::move(vertexData), Utility::move(attributes),
+                vertexCount};
+
+            if(positions)
+                populatePositions(mesh, positionStorage, positions);
+        }
+
+        /* If the positions are an unpacked copy, they're now in a different
+           order than the vertex data */
+        else if(positions && positions.data() == positionStorage.data())
+            populatePositions(mesh, positionStorage, positions);
     }
 
     return true;
 }
 
+#if MESHOPTIMIZER_VERSION >= 170
+/* Builds meshlets out of an indexed triangle mesh, returning them as a
+   MeshPrimitive::Meshlets mesh with one "vertex" per meshlet. The vertex and
+   triangle arrays have a fixed size, with unused items being zero. */
+MeshData buildMeshlets(const MeshData& mesh, const Containers::StridedArrayView1D<const Vector3>& positions, const UnsignedInt maxVertices, const UnsignedInt maxTriangles, const Float coneWeight) {
+    MAGNUM_PROFILING_ZONE("MeshOptimizerSceneConverter meshlets");
+
+    /* Again no overloads for smaller index types in meshoptimizer */
+    Containers::Array<UnsignedInt> indicesStorage;
+    Containers::ArrayView<const UnsignedInt> indices;
+    if(mesh.indexType() == MeshIndexType::UnsignedInt)
+        indices = mesh.indices<UnsignedInt>().asContiguous();
+    else {
+        indicesStorage = mesh.indicesAsArray();
+        indices = indicesStorage;
+    }
+
+    const std::size_t maxMeshletCount = meshopt_buildMeshletsBound(indices.size(), maxVertices, maxTriangles);
+    Containers::Array<meshopt_Meshlet> meshlets{NoInit, maxMeshletCount};
+    Containers::Array<UnsignedInt> meshletVertices{NoInit, maxMeshletCount*maxVertices};
+    Containers::Array<UnsignedByte> meshletTriangles{NoInit, maxMeshletCount*maxTriangles*3};
+    const std::size_t meshletCount = meshopt_buildMeshlets(meshlets.data(), meshletVertices.data(), meshletTriangles.data(), indices.data(), indices.size(), static_cast<const Float*>(positions.data()), mesh.vertexCount(), positions.stride(), maxVertices, maxTriangles, coneWeight);
+
+    /* Layout of a single meshlet, with the triangle array padded to four
+       bytes to have the remaining attributes aligned */
+    const std::size_t verticesOffset = 0;
+    const std::size_t trianglesOffset = verticesOffset + maxVertices*sizeof(UnsignedInt);
+    const std::size_t vertexCountOffset = trianglesOffset + (maxTriangles*3 + 3)/4*4;
+    const std::size_t triangleCountOffset = vertexCountOffset + sizeof(UnsignedInt);
+    const std::size_t centerOffset = triangleCountOffset + sizeof(UnsignedInt);
+    const std::size_t radiusOffset = centerOffset + sizeof(Vector3);
+    const std::size_t coneApexOffset = radiusOffset + sizeof(Float);
+    const std::size_t coneAxisOffset = coneApexOffset + sizeof(Vector3);
+    const std::size_t coneCutoffOffset = coneAxisOffset + sizeof(Vector3);
+    const std::size_t stride = coneCutoffOffset + sizeof(Float);
+
+    Containers::Array<char> vertexData{ValueInit, meshletCount*stride};
+    const Containers::StridedArrayView2D<UnsignedInt> outVertices{vertexData, reinterpret_cast<UnsignedInt*>(vertexData.data() + verticesOffset), {meshletCount, maxVertices}, {std::ptrdiff_t(stride), sizeof(UnsignedInt)}};
+    const Containers::StridedArrayView2D<Vector3ub> outTriangles{vertexData, reinterpret_cast<Vector3ub*>(vertexData.data() + trianglesOffset), {meshletCount, maxTriangles}, {std::ptrdiff_t(stride), sizeof(Vector3ub)}};
+    const Containers::StridedArrayView1D<UnsignedInt> outVertexCounts{vertexData, reinterpret_cast<UnsignedInt*>(vertexData.data() + vertexCountOffset), meshletCount, std::ptrdiff_t(stride)};
+    const Containers::StridedArrayView1D<UnsignedInt> outTriangleCounts{vertexData, reinterpret_cast<UnsignedInt*>(vertexData.data() + triangleCountOffset), meshletCount, std::ptrdiff_t(stride)};
+    const Containers::StridedArrayView1D<Vector3> outCenters{vertexData, reinterpret_cast<Vector3*>(vertexData.data() + centerOffset), meshletCount, std::ptrdiff_t(stride)};
+    const Containers::StridedArrayView1D<Float> outRadii{vertexData, reinterpret_cast<Float*>(vertexData.data() + radiusOffset), meshletCount, std::ptrdiff_t(stride)};
+    const Containers::StridedArrayView1D<Vector3> outConeApices{vertexData, reinterpret_cast<Vector3*>(vertexData.data() + coneApexOffset), meshletCount, std::ptrdiff_t(stride)};
+    const Containers::StridedArrayView1D<Vector3> outConeAxes{vertexData, reinterpret_cast<Vector3*>(vertexData.data() + coneAxisOffset), meshletCount, std::ptrdiff_t(stride)};
+    const Containers::StridedArrayView1D<Float> outConeCutoffs{vertexData, reinterpret_cast<Float*>(vertexData.data() + coneCutoffOffset), meshletCount, std::ptrdiff_t(stride)};
+
+    for(std::size_t i = 0; i != meshletCount; ++i) {
+        const meshopt_Meshlet& meshlet = meshlets[i];
+        const Containers::ArrayView<const UnsignedInt> vertices = meshletVertices.sliceSize(meshlet.vertex_offset, meshlet.vertex_count);
+        const Containers::ArrayView<const UnsignedByte> triangles = meshletTriangles.sliceSize(meshlet.triangle_offset, meshlet.triangle_count*3);
+        Utility::copy(vertices, outVertices[i].prefix(meshlet.vertex_count));
+        Utility::copy(Containers::arrayCast<const Vector3ub>(triangles), outTriangles[i].prefix(meshlet.triangle_count));
+        outVertexCounts[i] = meshlet.vertex_count;
+        outTriangleCounts[i] = meshlet.triangle_count;
+
+        const meshopt_Bounds bounds = meshopt_computeMeshletBounds(vertices.data(), triangles.data(), meshlet.triangle_count, static_cast<const Float*>(positions.data()), mesh.vertexCount(), positions.stride());
+        outCenters[i] = Vector3::from(bounds.center);
+        outRadii[i] = bounds.radius;
+        outConeApices[i] = Vector3::from(bounds.cone_apex);
+        outConeAxes[i] = Vector3::from(bounds.cone_axis);
+        outConeCutoffs[i] = bounds.cone_cutoff;
+    }
+
+    Containers::Array<MeshAttributeData> attributeData{InPlaceInit, {
+        MeshAttributeData{meshAttributeCustom(0), outVertices},
+        MeshAttributeData{meshAttributeCustom(1), outTriangles},
+        MeshAttributeData{meshAttributeCustom(2), outVertexCounts},
+        MeshAttributeData{meshAttributeCustom(3), outTriangleCounts},
+        MeshAttributeData{meshAttributeCustom(4), outCenters},
+        MeshAttributeData{meshAttributeCustom(5), outRadii},
+        MeshAttributeData{meshAttributeCustom(6), outConeApices},
+        MeshAttributeData{meshAttributeCustom(7), outConeAxes},
+        MeshAttributeData{meshAttributeCustom(8), outConeCutoffs},
+    }};
+
+    return MeshData{MeshPrimitive::Meshlets, Utility::move(vertexData), Utility::move(attributeData), UnsignedInt(meshletCount)};
+}
+#endif
+
 }
 
 bool MeshOptimizerSceneConverter::doConvertInPlace(MeshData& mesh) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertInPlace"};
     if((configuration().value<bool>("optimizeVertexCache") ||
         configuration().value<bool>("optimizeOverdraw") ||
         configuration().value<bool>("optimizeVertexFetch")) &&
@@ -258,6 +610,24 @@ bool MeshOptimizerSceneConverter::doConvertInPlace(MeshData& mesh) {
         return false;
     }
 
+    if(configuration().value<bool>("meshlets")) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): meshlet generation can't be performed in-place, use convert() instead";
+        return false;
+    }
+
+    if(configuration().value<bool>("stripify")) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): triangle strip generation can't be performed in-place, use convert() instead";
+        return false;
+    }
+
+    if(!configuration().value<Containers::StringView>("quantizeNormals").isEmpty() ||
+       !configuration().value<Containers::StringView>("quantizeTextureCoordinates").isEmpty() ||
+       !configuration().value<Containers::StringView>("quantizePositions").isEmpty())
+    {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): vertex quantization can't be performed in-place, use convert() instead";
+        return false;
+    }
+
     /* Errors for non-indexed meshes and implementation-specific index buffers
        are printed directly in convertInPlaceInternal() */
     if(mesh.isIndexed()) {
@@ -278,29 +648,453 @@ bool MeshOptimizerSceneConverter::doConvertInPlace(MeshData& mesh) {
     Containers::Array<Vector3> positionStorage;
     Containers::StridedArrayView1D<const Vector3> positions;
     Containers::Optional<UnsignedInt> vertexSize;
+    Utility::ConfigurationGroup* const stats = configuration().value<bool>("writeStats") ? &resetStats(configuration()) : nullptr;
     if(!convertInPlaceInternal("Trade::MeshOptimizerSceneConverter::convertInPlace():", mesh, flags(), configuration(), positionStorage, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore))
         return false;
 
-    if(flags() & SceneConverterFlag::Verbose)
-        analyzePost("Trade::MeshOptimizerSceneConverter::convertInPlace():", mesh, configuration(), flags(), positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore);
+    if(needsStats(flags(), configuration()))
+        analyzePost("Trade::MeshOptimizerSceneConverter::convertInPlace():", mesh, configuration(), flags(), positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore, stats);
 
     return true;
 }
 
-Containers::Optional<MeshData> MeshOptimizerSceneConverter::doConvert(const MeshData& mesh) {
+namespace {
+
+/* Simplifies given processed mesh, returning a copy with a subset of the
+   original vertices and a reduced index buffer */
+Containers::Optional<MeshData> simplify(const char* prefix, const MeshData& mesh, const Utility::ConfigurationGroup& configuration, const Containers::StridedArrayView1D<const Vector3>& positions, const Float targetIndexCountThreshold, const Float targetError) {
+    MAGNUM_PROFILING_ZONE("MeshOptimizerSceneConverter simplification");
+
+    const UnsignedInt targetIndexCount = mesh.indexCount()*targetIndexCountThreshold;
+
+    /* In this case meshoptimizer doesn't provide overloads, so let's do this
+       on our side instead */
+    Containers::Array<UnsignedInt> inputIndicesStorage;
+    Containers::ArrayView<const UnsignedInt> inputIndices;
+    if(mesh.indexType() == MeshIndexType::UnsignedInt)
+        inputIndices = mesh.indices<UnsignedInt>().asContiguous();
+    else {
+        inputIndicesStorage = mesh.indicesAsArray();
+        inputIndices = inputIndicesStorage;
+    }
+
+    Containers::Array<UnsignedInt> outputIndices;
+    Containers::arrayResize<Trade::ArrayAllocator>(outputIndices, NoInit, mesh.indexCount());
+
+    UnsignedInt vertexCount;
+    if(configuration.value<bool>("simplifySloppy")) {
+        /* The nullptr at the end is not needed but without it GCC's
+           -Wzero-as-null-pointer-constant fires due to the default argument
+           being `= 0`. WHAT THE FUCK, how is this warning useful?! Why
+           everything today feels like hastily patched together by
+           incompetent idiots?! */
+        vertexCount = meshopt_simplifySloppy(
+            outputIndices.data(),
+            inputIndices.data(),
+            mesh.indexCount(),
+            static_cast<const Float*>(positions.data()),
+            mesh.vertexCount(),
+            positions.stride(),
+            targetIndexCount
+            #if MESHOPTIMIZER_VERSION >= 160
+            , targetError, nullptr
+            #endif
+        );
+    } else {
+        vertexCount = meshopt_simplify(
+            outputIndices.data(),
+            inputIndices.data(),
+            mesh.indexCount(),
+            static_cast<const Float*>(positions.data()),
+            mesh.vertexCount(),
+            positions.stride(),
+            targetIndexCount,
+            targetError
+            #if MESHOPTIMIZER_VERSION >= 180
+            , configuration.value<bool>("simplifyLockBorder") ? meshopt_SimplifyLockBorder : 0
+            #endif
+            #if MESHOPTIMIZER_VERSION >= 160
+            , nullptr
+            #endif
+        );
+    }
+
+    if(!vertexCount && configuration.value<bool>("simplifyFailEmpty")) {
+        Error{} << prefix << "simplification resulted in an empty mesh";
+        return {};
+    }
+
+    Containers::arrayResize<Trade::ArrayAllocator>(outputIndices, vertexCount);
+
+    /* Take the original mesh vertex data with the reduced index buffer and
+       call combineIndexedAttributes() to throw away the unused vertices. The
+       vertex data are only referenced as the input may get simplified again
+       for another LOD level. */
+    /** @todo provide a way to use the new vertices with the original vertex
+        buffer for LODs */
+    MeshIndexData indices{outputIndices};
+    const MeshData simplified{mesh.primitive(),
+        Containers::arrayAllocatorCast<char, Trade::ArrayAllocator>(Utility::move(outputIndices)), indices,
+        {}, mesh.vertexData(), meshAttributeDataNonOwningArray(mesh.attributeData())};
+    return MeshTools::combineIndexedAttributes({simplified});
+}
+
+/* Creates a position-only mesh with an index buffer referencing just the
+   first vertex of each unique position, for use in depth prepass and shadow
+   rendering */
+MeshData generateShadowMesh(const char* prefix, const MeshData& mesh, const SceneConverterFlags flags) {
+    MAGNUM_PROFILING_ZONE("MeshOptimizerSceneConverter shadow mesh");
+
+    Containers::Array<UnsignedInt> inputIndicesStorage;
+    Containers::ArrayView<const UnsignedInt> inputIndices;
+    if(mesh.indexType() == MeshIndexType::UnsignedInt)
+        inputIndices = mesh.indices<UnsignedInt>().asContiguous();
+    else {
+        inputIndicesStorage = mesh.indicesAsArray();
+        inputIndices = inputIndicesStorage;
+    }
+
+    /* Positions are compared bytewise in their original format */
+    const VertexFormat positionFormat = mesh.attributeFormat(MeshAttribute::Position);
+    const std::size_t positionOffset = mesh.attributeOffset(MeshAttribute::Position);
+    const UnsignedInt positionSize = vertexFormatSize(positionFormat);
+    const UnsignedInt positionStride = mesh.attributeStride(MeshAttribute::Position);
+
+    Containers::Array<UnsignedInt> outputIndices;
+    Containers::arrayResize<Trade::ArrayAllocator>(outputIndices, NoInit, mesh.indexCount());
+    meshopt_generateShadowIndexBuffer(outputIndices.data(), inputIndices.data(), mesh.indexCount(), mesh.vertexData().data() + positionOffset, mesh.vertexCount(), positionSize, positionStride);
+
+    /* Take just the positions with the new index buffer and call
+       combineIndexedAttributes() to throw away the unreferenced vertices,
+       same as in simplify() */
+    MeshIndexData indices{outputIndices};
+    const MeshData shadow{mesh.primitive(),
+        Containers::arrayAllocatorCast<char, Trade::ArrayAllocator>(Utility::move(outputIndices)), indices,
+        {}, mesh.vertexData(), {
+            MeshAttributeData{MeshAttribute::Position, positionFormat,
+                Containers::StridedArrayView1D<const void>{mesh.vertexData(), mesh.vertexData().data() + positionOffset, mesh.vertexCount(), positionStride}}
+        }};
+    MeshData out = MeshTools::combineIndexedAttributes({shadow});
+
+    if(flags & SceneConverterFlag::Verbose) {
+        const Containers::Array<UnsignedInt> outIndices = out.indicesAsArray();
+        const meshopt_VertexFetchStatistics before = meshopt_analyzeVertexFetch(inputIndices.data(), mesh.indexCount(), mesh.vertexCount(), positionSize);
+        const meshopt_VertexFetchStatistics after = meshopt_analyzeVertexFetch(outIndices.data(), out.indexCount(), out.vertexCount(), positionSize);
+        Debug{} << prefix << "shadow mesh has" << out.vertexCount() << "out of" << mesh.vertexCount() << "vertices, with" << before.bytes_fetched << "->" << after.bytes_fetched << "position bytes fetched";
+    }
+
+    return out;
+}
+
+/* Splits an indexed triangle mesh into parts of at most 65535 vertices, each
+   with 16-bit indices. The 65536th index is left unused for primitive
+   restart. Triangles are taken in the order of the index buffer, so the parts
+   are spatially coherent and preserve the vertex cache ordering, and the
+   vertices are put into each part in the order of first use, preserving the
+   vertex fetch ordering as well. */
+Containers::Array<MeshData> splitMesh(const MeshData& mesh) {
+    constexpr UnsignedInt MaxVertexCount = 65535;
+    const Containers::Array<UnsignedInt> indices = mesh.indicesAsArray();
+    const Containers::StridedArrayView2D<const char> interleavedData = MeshTools::interleavedData(mesh);
+    const std::size_t stride = interleavedData.stride()[0];
+
+    /* Index of each original vertex in the current part, or ~UnsignedInt{} if
+       not used in it yet */
+    Containers::Array<UnsignedInt> remap{DirectInit, mesh.vertexCount(), ~UnsignedInt{}};
+    Containers::Array<UnsignedInt> partVertices;
+    Containers::Array<UnsignedShort> partIndices;
+    Containers::Array<MeshData> parts;
+    const auto flush = [&]() {
+        Containers::Array<char> indexData{NoInit, partIndices.size()*sizeof(UnsignedShort)};
+        Utility::copy(Containers::arrayCast<const char>(partIndices), indexData);
+        const MeshIndexData partIndexData{Containers::arrayCast<const UnsignedShort>(indexData)};
+
+        /* Zero-initialized so the padding is deterministic */
+        Containers::Array<char> vertexData{ValueInit, partVertices.size()*stride};
+        for(std::size_t i = 0; i != partVertices.size(); ++i) {
+            Utility::copy(interleavedData[partVertices[i]], Containers::StridedArrayView1D<char>{vertexData.sliceSize(i*stride, interleavedData.size()[1])});
+            remap[partVertices[i]] = ~UnsignedInt{};
+        }
+
+        Containers::Array<MeshAttributeData> attributes = interleavedAttributes(mesh, vertexData, partVertices.size());
+        arrayAppend(parts, MeshData{mesh.primitive(),
+            Utility::move(indexData), partIndexData,
+            Utility::move(vertexData), Utility::move(attributes),
+            UnsignedInt(partVertices.size())});
+
+        arrayClear(partVertices);
+        arrayClear(partIndices);
+    };
+
+    for(std::size_t i = 0; i + 3 <= indices.size(); i += 3) {
+        /* Start a new part if the triangle could overflow the current one.
+           A vertex repeated in the triangle is counted twice, which is fine
+           for an upper bound. */
+        std::size_t newVertexCount = 0;
+        for(std::size_t j = 0; j != 3; ++j)
+            if(remap[indices[i + j]] == ~UnsignedInt{}) ++newVertexCount;
+        if(partVertices.size() + newVertexCount > MaxVertexCount)
+            flush();
+
+        for(std::size_t j = 0; j != 3; ++j) {
+            const UnsignedInt vertex = indices[i + j];
+            if(remap[vertex] == ~UnsignedInt{}) {
+                remap[vertex] = partVertices.size();
+                arrayAppend(partVertices, vertex);
+            }
+            arrayAppend(partIndices, UnsignedShort(remap[vertex]));
+        }
+    }
+
+    if(!partIndices.isEmpty())
+        flush();
+
+    return parts;
+}
+
+/* Converts an indexed triangle mesh to a triangle strip. Strips are
+   separated with a restart index, which is the maximum value of the index
+   type, or with degenerate triangles if `restart` isn't set or the index
+   type can't represent the restart index without clashing with vertex IDs.
+   If the strip wouldn't have less indices than the original, the original is
+   returned. */
+MeshData stripifyMesh(const char* prefix, MeshData&& mesh, const SceneConverterFlags flags, const bool restart) {
+    MAGNUM_PROFILING_ZONE("MeshOptimizerSceneConverter stripify");
+
+    const Containers::Array<UnsignedInt> indices = mesh.indicesAsArray();
+    const UnsignedInt maxIndex = ~UnsignedInt{} >> (32 - meshIndexTypeSize(mesh.indexType())*8);
+    const UnsignedInt restartIndex = restart && mesh.vertexCount() <= maxIndex ? maxIndex : 0;
+
+    Containers::Array<UnsignedInt> strip{NoInit, meshopt_stripifyBound(indices.size())};
+    const std::size_t stripSize = meshopt_stripify(strip.data(), indices.data(), indices.size(), mesh.vertexCount(), restartIndex);
+
+    if(stripSize >= indices.size()) {
+        if(flags & SceneConverterFlag::Verbose)
+            Debug{} << prefix << "triangle strip would have" << stripSize << "indices out of" << indices.size() << Debug::nospace << ", keeping a triangle list";
+        return Utility::move(mesh);
+    }
+
+    if(flags & SceneConverterFlag::Verbose)
+        Debug{} << prefix << "converted" << indices.size() << "triangle list indices to" << stripSize << "triangle strip indices";
+
+    /* Keep the original index type, the restart index fits into it */
+    const MeshIndexType indexType = mesh.indexType();
+    Containers::Array<char> indexData{NoInit, stripSize*meshIndexTypeSize(indexType)};
+    if(indexType == MeshIndexType::UnsignedInt)
+        Utility::copy(strip.prefix(stripSize), Containers::arrayCast<UnsignedInt>(indexData));
+    else if(indexType == MeshIndexType::UnsignedShort) {
+        const Containers::ArrayView<UnsignedShort> out = Containers::arrayCast<UnsignedShort>(indexData);
+        for(std::size_t i = 0; i != stripSize; ++i)
+            out[i] = strip[i];
+    } else if(indexType == MeshIndexType::UnsignedByte) {
+        const Containers::ArrayView<UnsignedByte> out = Containers::arrayCast<UnsignedByte>(indexData);
+        for(std::size_t i = 0; i != stripSize; ++i)
+            out[i] = strip[i];
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+    const MeshIndexData stripIndices{indexType, indexData};
+    const UnsignedInt vertexCount = mesh.vertexCount();
+    return MeshData{MeshPrimitive::TriangleStrip,
+        Utility::move(indexData), stripIndices,
+        mesh.releaseVertexData(), mesh.releaseAttributeData(),
+        vertexCount};
+}
+
+template<class T> void remapIndices(const Containers::StridedArrayView1D<T>& indices, const Containers::ArrayView<const UnsignedInt> remap) {
+    for(T& i: indices) i = T(remap[i]);
+}
+
+/* Reorders vertices of an interleaved point cloud, or triangles of an
+   interleaved non-indexed triangle mesh, for better spatial locality. Index
+   buffer of an indexed point cloud is remapped to the new vertex order,
+   triangle meshes stay non-indexed. */
+MeshData spatialSortVertices(MeshData& mesh, const Containers::StridedArrayView1D<const Vector3>& positions) {
+    MAGNUM_PROFILING_ZONE("MeshOptimizerSceneConverter spatialSort");
+
+    /* Original vertex ID for each vertex in the output */
+    Containers::Array<UnsignedInt> order{NoInit, mesh.vertexCount()};
+    if(mesh.primitive() == MeshPrimitive::Points) {
+        /* The remap table maps the original vertices to the new ones */
+        Containers::Array<UnsignedInt> remap{NoInit, mesh.vertexCount()};
+        meshopt_spatialSortRemap(remap.data(), static_cast<const Float*>(positions.data()), mesh.vertexCount(), positions.stride());
+        for(UnsignedInt i = 0; i != mesh.vertexCount(); ++i)
+            order[remap[i]] = i;
+
+        if(mesh.isIndexed()) {
+            if(mesh.indexType() == MeshIndexType::UnsignedInt)
+                remapIndices(mesh.mutableIndices<UnsignedInt>(), remap);
+            else if(mesh.indexType() == MeshIndexType::UnsignedShort)
+                remapIndices(mesh.mutableIndices<UnsignedShort>(), remap);
+            else if(mesh.indexType() == MeshIndexType::UnsignedByte)
+                remapIndices(mesh.mutableIndices<UnsignedByte>(), remap);
+            else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        }
+    } else {
+        CORRADE_INTERNAL_ASSERT(mesh.primitive() == MeshPrimitive::Triangles && !mesh.isIndexed());
+
+        /* Sort a trivial index buffer, the result is then directly the order
+           of the vertices. Vertices of an incomplete last triangle, if any,
+           are kept at the end. */
+        const UnsignedInt triangleVertexCount = mesh.vertexCount()/3*3;
+        for(UnsignedInt i = 0; i != mesh.vertexCount(); ++i)
+            order[i] = i;
+        Containers::Array<UnsignedInt> indices{NoInit, triangleVertexCount};
+        Utility::copy(order.prefix(triangleVertexCount), indices);
+        meshopt_spatialSortTriangles(order.data(), indices.data(), triangleVertexCount, static_cast<const Float*>(positions.data()), mesh.vertexCount(), positions.stride());
+    }
+
+    const Containers::StridedArrayView2D<const char> interleavedData = MeshTools::interleavedData(mesh);
+    const std::size_t stride = interleavedData.stride()[0];
+    /* Zero-initialized so the padding is deterministic */
+    Containers::Array<char> vertexData{ValueInit, mesh.vertexCount()*stride};
+    for(UnsignedInt i = 0; i != mesh.vertexCount(); ++i)
+        Utility::copy(interleavedData[order[i]], Containers::StridedArrayView1D<char>{vertexData.sliceSize(i*stride, interleavedData.size()[1])});
+
+    Containers::Array<MeshAttributeData> attributes = interleavedAttributes(mesh, vertexData, mesh.vertexCount());
+    const UnsignedInt vertexCount = mesh.vertexCount();
+    if(!mesh.isIndexed())
+        return MeshData{mesh.primitive(),
+            Utility::move(vertexData), Utility::move(attributes),
+            vertexCount};
+
+    const MeshIndexData indices{mesh.indices()};
+    return MeshData{mesh.primitive(),
+        mesh.releaseIndexData(), indices,
+        Utility::move(vertexData), Utility::move(attributes),
+        vertexCount};
+}
+
+/* Shared between convert() and add(). Returns the processed mesh and then
+   one additional level for each item in `lodThresholds`, simplified from the
+   processed mesh with the corresponding item in `lodErrors`. If shadowMesh
+   is enabled, a position-only shadow mesh is the last level. The stats of
+   the processed mesh are written into `stats` if it's not null. */
+Containers::Optional<Containers::Array<MeshData>> convertInternal(const char* prefix, const MeshData& mesh, const SceneConverterFlags flags, const Utility::ConfigurationGroup& configuration, const Containers::ArrayView<const Float> lodThresholds, const Containers::ArrayView<const Float> lodErrors, Utility::ConfigurationGroup* const stats) {
+    CORRADE_INTERNAL_ASSERT(lodThresholds.size() == lodErrors.size());
+
     /* If the mesh is indexed with an implementation-specific index type,
        interleave() won't be able to turn its index buffer into a contiguous
        one. So fail early if that's the case. The mesh doesn't necessarily have
        to be indexed though -- it could be e.g. a triangle strip which we turn
        into an indexed mesh right after. */
     if(mesh.isIndexed() && isMeshIndexTypeImplementationSpecific(mesh.indexType())) {
-        Error{} << "Trade::MeshOptimizerSceneConverter::convert(): can't perform any operation on an implementation-specific index type" << reinterpret_cast<void*>(meshIndexTypeUnwrap(mesh.indexType()));
+        Error{} << prefix << "can't perform any operation on an implementation-specific index type" << reinterpret_cast<void*>(meshIndexTypeUnwrap(mesh.indexType()));
+        return {};
+    }
+
+    /* Check meshlet options early to not do all the processing only to fail
+       at the end */
+    const bool meshlets = configuration.value<bool>("meshlets");
+    #if MESHOPTIMIZER_VERSION >= 170
+    const UnsignedInt meshletMaxVertices = configuration.value<UnsignedInt>("meshletMaxVertices");
+    const UnsignedInt meshletMaxTriangles = configuration.value<UnsignedInt>("meshletMaxTriangles");
+    #endif
+    if(meshlets) {
+        #if MESHOPTIMIZER_VERSION < 170
+        Error{} << prefix << "meshlet generation requires meshoptimizer 0.17 or newer";
+        return {};
+        #else
+        if(meshletMaxVertices < 3 || meshletMaxVertices > 255 ||
+           meshletMaxTriangles < 4 || meshletMaxTriangles > 512 ||
+           meshletMaxTriangles % 4 != 0)
+        {
+            Error{} << prefix << "expected meshletMaxVertices to be between 3 and 255 and meshletMaxTriangles to be a multiple of 4 between 4 and 512, got" << meshletMaxVertices << "and" << meshletMaxTriangles;
+            return {};
+        }
+
+        if(!mesh.hasAttribute(MeshAttribute::Position)) {
+            Error{} << prefix << "meshlet generation requires the mesh to have positions";
+            return {};
+        }
+        #endif
+    }
+
+    /* LODs need positions as well, check early too */
+    if(!lodThresholds.isEmpty() && !mesh.hasAttribute(MeshAttribute::Position)) {
+        Error{} << prefix << "LOD generation requires the mesh to have positions";
+        return {};
+    }
+
+    /* Splitting produces multiple meshes, each with just a single level */
+    const bool splitLargeMeshes = configuration.value<bool>("splitLargeMeshes");
+    if(splitLargeMeshes && (!lodThresholds.isEmpty() || configuration.value<bool>("shadowMesh") || meshlets)) {
+        Error{} << prefix << "splitLargeMeshes can't be combined with lodThresholds, shadowMesh or meshlets";
         return {};
     }
 
-    /* Make the mesh interleaved (with a contiguous index array) and owned
-       first */
-    MeshData out = MeshTools::copy(MeshTools::interleave(mesh));
+    /* And the shadow mesh, which additionally needs to know their size */
+    const bool shadowMesh = configuration.value<bool>("shadowMesh");
+    if(shadowMesh) {
+        if(!mesh.hasAttribute(MeshAttribute::Position)) {
+            Error{} << prefix << "shadow mesh generation requires the mesh to have positions";
+            return {};
+        }
+
+        const VertexFormat positionFormat = mesh.attributeFormat(MeshAttribute::Position);
+        if(isVertexFormatImplementationSpecific(positionFormat)) {
+            Error{} << prefix << "can't generate a shadow mesh with an implementation-specific position format" << reinterpret_cast<void*>(vertexFormatUnwrap(positionFormat));
+            return {};
+        }
+    }
+
+    /* Strips can't be made out of meshlets */
+    const bool stripify = configuration.value<bool>("stripify");
+    if(stripify && meshlets) {
+        Error{} << prefix << "stripify can't be combined with meshlets";
+        return {};
+    }
+
+    /* Point clouds and non-indexed triangle meshes have no index buffer for
+       the operations below to work on, they can be only spatially sorted */
+    const bool spatialSort = configuration.value<bool>("spatialSort") &&
+        (mesh.primitive() == MeshPrimitive::Points ||
+        (mesh.primitive() == MeshPrimitive::Triangles && !mesh.isIndexed()));
+    if(spatialSort) {
+        if(!mesh.hasAttribute(MeshAttribute::Position)) {
+            Error{} << prefix << "spatial sorting requires the mesh to have positions";
+            return {};
+        }
+
+        if(!lodThresholds.isEmpty() || shadowMesh || meshlets || splitLargeMeshes) {
+            Error{} << prefix << "spatial sorting of point clouds and non-indexed meshes can't be combined with lodThresholds, shadowMesh, meshlets or splitLargeMeshes";
+            return {};
+        }
+    }
+
+    /* If the mesh is an already interleaved indexed triangle mesh and vertex
+       fetch optimization is going to reorder its vertices, copy just the
+       index data and reference the vertex data. The vertex fetch
+       optimization in convertInPlaceInternal() then writes directly into a
+       new allocation instead of the vertices being copied first and then
+       optimized in-place through another temporary copy. Quantization makes
+       a new vertex buffer on its own, and the negative stride and bounds
+       checks ensure the whole stride of each vertex can be read. */
+    Containers::Optional<MeshData> referenced;
+    if(mesh.primitive() == MeshPrimitive::Triangles && mesh.isIndexed() &&
+       mesh.attributeCount() && MeshTools::isInterleaved(mesh) &&
+       configuration.value<bool>("optimizeVertexFetch") &&
+       configuration.value<Containers::StringView>("quantizeNormals").isEmpty() &&
+       configuration.value<Containers::StringView>("quantizeTextureCoordinates").isEmpty() &&
+       configuration.value<Containers::StringView>("quantizePositions").isEmpty())
+    {
+        const Containers::StridedArrayView2D<const char> interleavedData = MeshTools::interleavedData(mesh);
+        const std::size_t begin = interleavedData.data() - static_cast<const char*>(mesh.vertexData().data());
+        if(interleavedData.stride()[0] > 0 && begin + std::size_t(mesh.vertexCount())*interleavedData.stride()[0] <= mesh.vertexData().size()) {
+            const Containers::StridedArrayView2D<const char> indices = mesh.indices();
+            Containers::Array<char> indexData{NoInit, indices.size()[0]*indices.size()[1]};
+            const Containers::StridedArrayView2D<char> outputIndices{indexData, indices.size()};
+            Utility::copy(indices, outputIndices);
+            const MeshIndexData outputIndexData{mesh.indexType(), indexData};
+            referenced = MeshData{mesh.primitive(),
+                Utility::move(indexData), outputIndexData,
+                {}, mesh.vertexData(), meshAttributeDataNonOwningArray(mesh.attributeData()),
+                mesh.vertexCount()};
+        }
+    }
+
+    /* Otherwise make the mesh interleaved (with a contiguous index array) and
+       owned first */
+    MeshData out = referenced ? *Utility::move(referenced) : MeshTools::copy(MeshTools::interleave(mesh));
     CORRADE_INTERNAL_ASSERT(MeshTools::isInterleaved(out));
     CORRADE_INTERNAL_ASSERT(!out.isIndexed() || out.indices().isContiguous());
 
@@ -314,98 +1108,505 @@ Containers::Optional<MeshData> MeshOptimizerSceneConverter::doConvert(const Mesh
     meshopt_OverdrawStatistics overdrawStatsBefore;
     Containers::Array<Vector3> positionStorage;
     Containers::StridedArrayView1D<const Vector3> positions;
+
+    /* Spatial sorting is the only operation done on point clouds and
+       non-indexed meshes, so return right after */
+    if(spatialSort) {
+        populatePositions(out, positionStorage, positions);
+        Containers::Array<MeshData> levels;
+        arrayAppend(levels, spatialSortVertices(out, positions));
+        /* GCC 4.8 needs an explicit conversion, otherwise it tries to copy
+           the thing and fails */
+        return Containers::optional(Utility::move(levels));
+    }
     Containers::Optional<UnsignedInt> vertexSize;
-    if(!convertInPlaceInternal("Trade::MeshOptimizerSceneConverter::convert():", out, flags(), configuration(), positionStorage, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore))
-        return Containers::NullOpt;
+    if(!convertInPlaceInternal(prefix, out, flags, configuration, positionStorage, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore))
+        return {};
 
-    if(configuration().value<bool>("simplify") ||
-       configuration().value<bool>("simplifySloppy"))
-    {
-        const UnsignedInt targetIndexCount = out.indexCount()*configuration().value<Float>("simplifyTargetIndexCountThreshold");
-        const Float targetError = configuration().value<Float>("simplifyTargetError");
+    /* The preprocessing above is done just once for all LOD levels, each
+       level is then simplified from the processed mesh */
+    Containers::Array<MeshData> levels;
+    arrayReserve(levels, lodThresholds.size() + 1);
+    if(!lodThresholds.isEmpty()) {
+        /* Positions are populated by convertInPlaceInternal() only if
+           needed */
+        if(!positions)
+            populatePositions(out, positionStorage, positions);
 
-        /* In this case meshoptimizer doesn't provide overloads, so let's do
-           this on our side instead */
-        Containers::Array<UnsignedInt> inputIndicesStorage;
-        Containers::ArrayView<const UnsignedInt> inputIndices;
-        if(out.indexType() == MeshIndexType::UnsignedInt)
-            inputIndices = out.indices<UnsignedInt>().asContiguous();
-        else {
-            inputIndicesStorage = out.indicesAsArray();
-            inputIndices = inputIndicesStorage;
+        /* Put a placeholder for the first level */
+        arrayAppend(levels, MeshData{MeshPrimitive::Triangles, 0});
+        for(std::size_t i = 0; i != lodThresholds.size(); ++i) {
+            Containers::Optional<MeshData> level = simplify(prefix, out, configuration, positions, lodThresholds[i], lodErrors[i]);
+            if(!level)
+                return {};
+            arrayAppend(levels, *Utility::move(level));
         }
+    }
 
-        Containers::Array<UnsignedInt> outputIndices;
-        Containers::arrayResize<Trade::ArrayAllocator>(outputIndices, NoInit, mesh.indexCount());
-
-        UnsignedInt vertexCount;
-        if(configuration().value<bool>("simplifySloppy")) {
-            /* The nullptr at the end is not needed but without it GCC's
-               -Wzero-as-null-pointer-constant fires due to the default
-               argument being `= 0`. WHAT THE FUCK, how is this warning
-               useful?! Why everything today feels like hastily patched
-               together by incompetent idiots?! */
-            vertexCount = meshopt_simplifySloppy(
-                outputIndices.data(),
-                inputIndices.data(),
-                out.indexCount(),
-                static_cast<const Float*>(positions.data()),
-                out.vertexCount(),
-                positions.stride(),
-                targetIndexCount
-                #if MESHOPTIMIZER_VERSION >= 160
-                , targetError, nullptr
-                #endif
-            );
-        } else {
-            vertexCount = meshopt_simplify(
-                outputIndices.data(),
-                inputIndices.data(),
-                out.indexCount(),
-                static_cast<const Float*>(positions.data()),
-                out.vertexCount(),
-                positions.stride(),
-                targetIndexCount,
-                targetError
-                #if MESHOPTIMIZER_VERSION >= 180
-                , configuration().value<bool>("simplifyLockBorder") ? meshopt_SimplifyLockBorder : 0
-                #endif
-                #if MESHOPTIMIZER_VERSION >= 160
-                , nullptr
-                #endif
-            );
-        }
+    if(configuration.value<bool>("simplify") ||
+       configuration.value<bool>("simplifySloppy"))
+    {
+        Containers::Optional<MeshData> simplified = simplify(prefix, out, configuration, positions, configuration.value<Float>("simplifyTargetIndexCountThreshold"), configuration.value<Float>("simplifyTargetError"));
+        if(!simplified)
+            return {};
+        out = *Utility::move(simplified);
+
+        /* If we're calculating stats after, repopulate the positions to
+           avoid using a now-gone array */
+        if(needsStats(flags, configuration))
+            populatePositions(out, positionStorage, positions);
+    }
+
+    /* Print or save before & after stats if requested */
+    if(needsStats(flags, configuration))
+        analyzePost(prefix, out, configuration, flags, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore, stats);
+
+    /* The shadow mesh is made from the final processed mesh, but it doesn't
+       get converted to meshlets below */
+    Containers::Optional<MeshData> shadow;
+    if(shadowMesh)
+        shadow = generateShadowMesh(prefix, out, flags);
+
+    if(levels.isEmpty())
+        arrayAppend(levels, Utility::move(out));
+    else
+        levels[0] = Utility::move(out);
+
+    /* Meshlet generation goes last, operating on the final optimized and
+       simplified vertex and index data */
+    #if MESHOPTIMIZER_VERSION >= 170
+    if(meshlets) for(MeshData& level: levels) {
+        /* Positions may not be populated at this point or be left from
+           before simplification, fetch them again */
+        populatePositions(level, positionStorage, positions);
+        level = buildMeshlets(level, positions, meshletMaxVertices, meshletMaxTriangles, configuration.value<Float>("meshletConeWeight"));
+    }
+    #endif
+
+    /* The shadow mesh goes last, after all LOD levels */
+    if(shadow)
+        arrayAppend(levels, *Utility::move(shadow));
+
+    /* If splitting, the mesh is either split into parts that each fit into
+       16-bit indices, or its indices are made 16-bit if they're wider. The
+       parts are returned in place of the levels and appendMesh() then adds
+       each as a separate mesh. */
+    if(splitLargeMeshes) {
+        CORRADE_INTERNAL_ASSERT(levels.size() == 1);
+        if(levels[0].vertexCount() > 65535)
+            levels = splitMesh(levels[0]);
+        else if(levels[0].indexType() == MeshIndexType::UnsignedInt)
+            levels[0] = MeshTools::compressIndices(Utility::move(levels[0]), MeshIndexType::UnsignedShort);
+    }
+
+    /* Conversion to triangle strips goes after everything else, as all
+       other operations need triangle lists. Split parts never use the
+       largest 16-bit index, so it's free for the restart index. */
+    if(stripify) for(MeshData& level: levels)
+        level = stripifyMesh(prefix, Utility::move(level), flags, configuration.value<bool>("stripifyRestart"));
+
+    /* GCC 4.8 needs an explicit conversion, otherwise it tries to copy the
+       thing and fails */
+    return Containers::optional(Utility::move(levels));
+}
+
+}
+
+Containers::Optional<MeshData> MeshOptimizerSceneConverter::doConvert(const MeshData& mesh) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvert"};
+    if(!configuration().value<Containers::StringView>("lodThresholds").isEmpty()) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convert(): LOD generation can't be performed with a single-mesh conversion, use begin(), add() and end() instead";
+        return {};
+    }
+
+    if(configuration().value<bool>("shadowMesh")) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convert(): shadow mesh generation can't be performed with a single-mesh conversion, use begin(), add() and end() instead";
+        return {};
+    }
+
+    if(configuration().value<bool>("splitLargeMeshes")) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convert(): mesh splitting can't be performed with a single-mesh conversion, use begin(), add() and end() instead";
+        return {};
+    }
+
+    Containers::Optional<Containers::Array<MeshData>> levels = convertInternal("Trade::MeshOptimizerSceneConverter::convert():", mesh, flags(), configuration(), {}, {}, configuration().value<bool>("writeStats") ? &resetStats(configuration()) : nullptr);
+    if(!levels)
+        return {};
+
+    CORRADE_INTERNAL_ASSERT(levels->size() == 1);
+    /* GCC 4.8 needs an explicit conversion, otherwise it tries to copy the
+       thing and fails */
+    return Containers::optional(Utility::move((*levels)[0]));
+}
+
+Containers::Optional<Containers::Array<char>> MeshOptimizerSceneConverter::doConvertToData(const MeshData& mesh) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
+    if(!configuration().value<Containers::StringView>("lodThresholds").isEmpty()) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertToData(): LOD generation can't be performed with a single-mesh conversion, use begin(), add() and end() instead";
+        return {};
+    }
+
+    if(configuration().value<bool>("shadowMesh")) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertToData(): shadow mesh generation can't be performed with a single-mesh conversion, use begin(), add() and end() instead";
+        return {};
+    }
+
+    if(configuration().value<bool>("splitLargeMeshes")) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertToData(): mesh splitting can't be performed with a single-mesh conversion, use begin(), add() and end() instead";
+        return {};
+    }
+
+    if(configuration().value<bool>("meshlets")) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertToData(): meshlet generation can't be combined with encoding to data, use convert() instead";
+        return {};
+    }
+
+    /* The encoded format has only indexed triangle meshes */
+    if(configuration().value<bool>("stripify")) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertToData(): triangle strips can't be encoded to data, use convert() instead";
+        return {};
+    }
+    if(configuration().value<bool>("spatialSort") &&
+       (mesh.primitive() == MeshPrimitive::Points ||
+       (mesh.primitive() == MeshPrimitive::Triangles && !mesh.isIndexed())))
+    {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertToData(): spatially sorted point clouds and non-indexed meshes can't be encoded to data, use convert() instead";
+        return {};
+    }
 
-        if(!vertexCount && configuration().value<bool>("simplifyFailEmpty")) {
-            Error{} << "Trade::MeshOptimizerSceneConverter::convert(): simplification resulted in an empty mesh";
+    /* Implementation-specific vertex formats have unknown size so they can't
+       be described in the attribute table. Check early to not do all the
+       processing only to fail at the end. */
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        const VertexFormat format = mesh.attributeFormat(i);
+        if(isVertexFormatImplementationSpecific(format)) {
+            Error{} << "Trade::MeshOptimizerSceneConverter::convertToData(): can't encode attribute" << i << "with an implementation-specific vertex format" << reinterpret_cast<void*>(vertexFormatUnwrap(format));
             return {};
         }
+    }
 
-        Containers::arrayResize<Trade::ArrayAllocator>(outputIndices, vertexCount);
-
-        /* Take the original mesh vertex data with the reduced index buffer and
-           call combineIndexedAttributes() to throw away the unused vertices */
-        /** @todo provide a way to use the new vertices with the original
-            vertex buffer for LODs */
-        MeshIndexData indices{outputIndices};
-        out = Trade::MeshData{out.primitive(),
-            Containers::arrayAllocatorCast<char, Trade::ArrayAllocator>(Utility::move(outputIndices)), indices,
-            out.releaseVertexData(), out.releaseAttributeData()};
-        out = MeshTools::combineIndexedAttributes({out});
-
-        /* If we're printing stats after, repopulate the positions to avoid
-           using a now-gone array */
-        if(flags() & SceneConverterFlag::Verbose)
-            populatePositions(out, positionStorage, positions);
+    Containers::Optional<Containers::Array<MeshData>> levels = convertInternal("Trade::MeshOptimizerSceneConverter::convertToData():", mesh, flags(), configuration(), {}, {}, configuration().value<bool>("writeStats") ? &resetStats(configuration()) : nullptr);
+    if(!levels)
+        return {};
+
+    CORRADE_INTERNAL_ASSERT(levels->size() == 1);
+    const MeshData& out = (*levels)[0];
+    CORRADE_INTERNAL_ASSERT(out.primitive() == MeshPrimitive::Triangles && out.isIndexed());
+
+    /* The mesh is interleaved but the attributes don't necessarily start at
+       the beginning of the stride or span all of it. Calculate the range
+       actually used, meshopt_encodeVertexBuffer() then needs it padded to a
+       multiple of four bytes. */
+    std::size_t attributeBegin = ~std::size_t{};
+    std::size_t attributeEnd = 0;
+    for(UnsignedInt i = 0; i != out.attributeCount(); ++i) {
+        const std::size_t offset = out.attributeOffset(i);
+        attributeBegin = Math::min(attributeBegin, offset);
+        attributeEnd = Math::max(attributeEnd, offset + vertexFormatSize(out.attributeFormat(i))*Math::max(out.attributeArraySize(i), UnsignedShort{1}));
+    }
+    const std::size_t vertexSize = out.attributeCount() ? attributeEnd - attributeBegin : 0;
+    const std::size_t vertexStride = (vertexSize + 3) & ~std::size_t{3};
+    if(vertexStride > 256) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertToData(): expected vertex size to be at most 256 bytes, got" << vertexSize;
+        return {};
     }
 
-    /* Print before & after stats if verbose output is requested */
+    /* Encode the index buffer. There's no 8-bit variant so 8-bit indices get
+       expanded, the original type is recorded in the header. */
+    Containers::Array<unsigned char> indexData{NoInit, meshopt_encodeIndexBufferBound(out.indexCount(), out.vertexCount())};
+    std::size_t indexDataSize;
+    if(out.indexType() == MeshIndexType::UnsignedInt)
+        indexDataSize = meshopt_encodeIndexBuffer(indexData.data(), indexData.size(), out.indices<UnsignedInt>().asContiguous().data(), out.indexCount());
+    else if(out.indexType() == MeshIndexType::UnsignedShort)
+        indexDataSize = meshopt_encodeIndexBuffer(indexData.data(), indexData.size(), out.indices<UnsignedShort>().asContiguous().data(), out.indexCount());
+    else if(out.indexType() == MeshIndexType::UnsignedByte)
+        indexDataSize = meshopt_encodeIndexBuffer(indexData.data(), indexData.size(), out.indicesAsArray().data(), out.indexCount());
+    else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+    /* Copy the used vertex range to a tightly packed array with the padded
+       stride and encode it. An attribute-less mesh has no vertex data to
+       encode, just the vertex count. */
+    Containers::Array<unsigned char> vertexData;
+    std::size_t vertexDataSize = 0;
+    if(vertexStride) {
+        Containers::Array<char> vertices{ValueInit, out.vertexCount()*vertexStride};
+        Utility::copy(
+            Containers::StridedArrayView2D<const char>{out.vertexData(), out.vertexData().data() + attributeBegin, {out.vertexCount(), vertexSize}, {std::ptrdiff_t(out.attributeStride(0)), 1}},
+            Containers::StridedArrayView2D<char>{vertices, {out.vertexCount(), vertexSize}, {std::ptrdiff_t(vertexStride), 1}});
+
+        vertexData = Containers::Array<unsigned char>{NoInit, meshopt_encodeVertexBufferBound(out.vertexCount(), vertexStride)};
+        vertexDataSize = meshopt_encodeVertexBuffer(vertexData.data(), vertexData.size(), vertices.data(), out.vertexCount(), vertexStride);
+    }
+    CORRADE_INTERNAL_ASSERT(indexDataSize && (!vertexStride || vertexDataSize));
+
+    /* Put it all together */
+    const std::size_t attributeTableOffset = sizeof(Implementation::MeshOptimizerHeader);
+    const std::size_t indexDataOffset = attributeTableOffset + out.attributeCount()*sizeof(Implementation::MeshOptimizerAttribute);
+    const std::size_t vertexDataOffset = indexDataOffset + indexDataSize;
+    Containers::Array<char> data{ValueInit, vertexDataOffset + vertexDataSize};
+
+    Implementation::MeshOptimizerHeader& header = *reinterpret_cast<Implementation::MeshOptimizerHeader*>(data.data());
+    Utility::copy(Containers::arrayView(Implementation::MeshOptimizerMagic), Containers::arrayView(header.magic));
+    header.version = Implementation::MeshOptimizerVersion;
+    header.primitive = UnsignedInt(out.primitive());
+    header.indexType = UnsignedInt(out.indexType());
+    header.indexCount = out.indexCount();
+    header.vertexCount = out.vertexCount();
+    header.vertexStride = vertexStride;
+    header.attributeCount = out.attributeCount();
+    header.indexDataSize = indexDataSize;
+    header.vertexDataSize = vertexDataSize;
+
+    const Containers::ArrayView<Implementation::MeshOptimizerAttribute> attributes = Containers::arrayCast<Implementation::MeshOptimizerAttribute>(data.sliceSize(attributeTableOffset, out.attributeCount()*sizeof(Implementation::MeshOptimizerAttribute)));
+    for(UnsignedInt i = 0; i != out.attributeCount(); ++i) {
+        attributes[i].name = UnsignedInt(out.attributeName(i));
+        attributes[i].format = UnsignedInt(out.attributeFormat(i));
+        attributes[i].offset = out.attributeOffset(i) - attributeBegin;
+        attributes[i].arraySize = out.attributeArraySize(i);
+    }
+
+    Utility::copy(Containers::arrayCast<const char>(indexData.prefix(indexDataSize)), data.sliceSize(indexDataOffset, indexDataSize));
+    Utility::copy(Containers::arrayCast<const char>(vertexData.prefix(vertexDataSize)), data.sliceSize(vertexDataOffset, vertexDataSize));
+
     if(flags() & SceneConverterFlag::Verbose)
-        analyzePost("Trade::MeshOptimizerSceneConverter::convert():", out, configuration(), flags(), positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore);
+        Debug{} << "Trade::MeshOptimizerSceneConverter::convertToData(): encoded" << out.indexData().size() << "bytes of index data to" << indexDataSize << "and" << out.vertexCount()*vertexStride << "bytes of vertex data to" << vertexDataSize;
 
     /* GCC 4.8 needs an explicit conversion, otherwise it tries to copy the
        thing and fails */
-    return Containers::optional(Utility::move(out));
+    return Containers::optional(Utility::move(data));
+}
+
+namespace {
+
+/* Parses a whitespace-separated list of non-negative floats */
+bool parseFloatList(const char* prefix, const Utility::ConfigurationGroup& configuration, const Containers::StringView option, Containers::Array<Float>& out) {
+    for(const Containers::StringView i: configuration.value<Containers::StringView>(option).splitOnWhitespaceWithoutEmptyParts()) {
+        /* std::strtof() needs a null-terminated string */
+        const Containers::String value = i;
+        char* end;
+        const Float parsed = std::strtof(value.data(), &end);
+        if(end != value.end() || !(parsed >= 0.0f)) {
+            Error{} << prefix << "invalid" << option << "value" << value;
+            return false;
+        }
+        arrayAppend(out, parsed);
+    }
+
+    return true;
+}
+
+/* Importer returned from end(), serving the converted meshes and their LOD
+   levels */
+class MeshImporter: public AbstractImporter {
+    public:
+        explicit MeshImporter(Containers::Array<Containers::Array<MeshData>>&& meshes, Containers::Array<Containers::String>&& names): _meshes{Utility::move(meshes)}, _names{Utility::move(names)} {}
+
+    private:
+        ImporterFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        void doClose() override { _opened = false; }
+
+        UnsignedInt doMeshCount() const override { return _meshes.size(); }
+        UnsignedInt doMeshLevelCount(UnsignedInt id) override { return _meshes[id].size(); }
+        Containers::String doMeshName(UnsignedInt id) override { return _names[id]; }
+        Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override {
+            return MeshTools::copy(_meshes[id][level]);
+        }
+
+        Containers::Array<Containers::Array<MeshData>> _meshes;
+        Containers::Array<Containers::String> _names;
+        bool _opened = true;
+};
+
+/* Mesh queued by add() for processing on multiple threads. The
+   configuration is copied as well, as it can be different for each add(). */
+struct PendingMesh {
+    MeshData mesh;
+    Utility::ConfigurationGroup configuration;
+    Containers::Array<Float> lodThresholds;
+    Containers::Array<Float> lodErrors;
+    Containers::String name;
+    /* Filled by the worker thread if writeStats is enabled */
+    Utility::ConfigurationGroup stats;
+};
+
+}
+
+struct MeshOptimizerSceneConverter::State {
+    Containers::Array<Containers::Array<MeshData>> meshes;
+    Containers::Array<Containers::String> names;
+    Containers::Array<PendingMesh> pendingMeshes;
+    /* Set if processing of any pending mesh failed. The output would have
+       meshes missing or their IDs shifted, so all subsequent add() and end()
+       calls fail. */
+    bool failed = false;
+
+    /* If splitLargeMeshes was enabled, convertInternal() returns split parts
+       instead of levels and each is added as a separate mesh */
+    void appendMesh(Containers::Array<MeshData>&& levels, const Containers::StringView name, const bool split) {
+        if(!split) {
+            arrayAppend(meshes, Utility::move(levels));
+            arrayAppend(names, Containers::String{name});
+            return;
+        }
+
+        for(MeshData& part: levels) {
+            Containers::Array<MeshData> level;
+            arrayAppend(level, Utility::move(part));
+            arrayAppend(meshes, Utility::move(level));
+            arrayAppend(names, Containers::String{name});
+        }
+    }
+};
+
+bool MeshOptimizerSceneConverter::doBegin() {
+    _state.emplace();
+    return true;
+}
+
+bool MeshOptimizerSceneConverter::processPendingMeshes(const char* const messagePrefix) {
+    if(_state->pendingMeshes.isEmpty())
+        return true;
+
+    /* Each worker redirects its output into per-mesh streams, which are then
+       printed on the calling thread in the order the meshes were added. The
+       redirection is thread-local as long as Corrade is built with
+       CORRADE_BUILD_MULTITHREADED, which is the default. */
+    struct Output {
+        std::ostringstream debug, warning, error;
+    };
+    const SceneConverterFlags flags = this->flags();
+    Containers::Array<Containers::Optional<Containers::Array<MeshData>>> processed{_state->pendingMeshes.size()};
+    Containers::Array<Output> outputs{_state->pendingMeshes.size()};
+    std::atomic<std::size_t> next{0};
+    const auto process = [&]() {
+        for(std::size_t i; (i = next++) < _state->pendingMeshes.size(); ) {
+            PendingMesh& mesh = _state->pendingMeshes[i];
+            Debug redirectDebug{&outputs[i].debug};
+            Warning redirectWarning{&outputs[i].warning};
+            Error redirectError{&outputs[i].error};
+            processed[i] = convertInternal("Trade::MeshOptimizerSceneConverter::add():", mesh.mesh, flags, mesh.configuration, mesh.lodThresholds, mesh.lodErrors, mesh.configuration.value<bool>("writeStats") ? &mesh.stats : nullptr);
+        }
+    };
+
+    /* The calling thread is one of the workers. Threads are unavailable on
+       Emscripten without pthreads, process serially there. */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    std::size_t threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    Containers::Array<std::thread> threads{Math::min(threadCount, _state->pendingMeshes.size()) - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{process};
+    process();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    process();
+    #endif
+
+    /* Print the output and save the results in the order the meshes were
+       added. All pending meshes are processed even if some of them fail, to
+       have the errors reported for all of them. */
+    Containers::Array<PendingMesh> pendingMeshes = Utility::move(_state->pendingMeshes);
+    for(std::size_t i = 0; i != pendingMeshes.size(); ++i) {
+        const std::string debug = outputs[i].debug.str();
+        const std::string warning = outputs[i].warning.str();
+        const std::string error = outputs[i].error.str();
+        if(!debug.empty())
+            Debug{Debug::Flag::NoNewlineAtTheEnd} << Containers::StringView{debug.data(), debug.size()};
+        if(!warning.empty())
+            Warning{Warning::Flag::NoNewlineAtTheEnd} << Containers::StringView{warning.data(), warning.size()};
+        if(!error.empty())
+            Error{Error::Flag::NoNewlineAtTheEnd} << Containers::StringView{error.data(), error.size()};
+
+        if(!processed[i]) {
+            _state->failed = true;
+            continue;
+        }
+
+        /* Same as with serial processing, the stats group contains the stats
+           of the last added mesh that had them enabled */
+        if(pendingMeshes[i].configuration.value<bool>("writeStats")) {
+            configuration().removeAllGroups("stats");
+            configuration().addGroup("stats", new Utility::ConfigurationGroup{pendingMeshes[i].stats});
+        }
+
+        _state->appendMesh(*Utility::move(processed[i]), pendingMeshes[i].name, pendingMeshes[i].configuration.value<bool>("splitLargeMeshes"));
+    }
+
+    if(_state->failed) {
+        Error{} << messagePrefix << "processing of a queued mesh failed";
+        return false;
+    }
+
+    return true;
+}
+
+bool MeshOptimizerSceneConverter::doAdd(UnsignedInt, const MeshData& mesh, const Containers::StringView name) {
+    if(_state->failed) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::add(): processing of a previously added mesh failed";
+        return false;
+    }
+
+    Containers::Array<Float> lodThresholds;
+    Containers::Array<Float> lodErrors;
+    if(!parseFloatList("Trade::MeshOptimizerSceneConverter::add():", configuration(), "lodThresholds", lodThresholds) ||
+       !parseFloatList("Trade::MeshOptimizerSceneConverter::add():", configuration(), "lodTargetErrors", lodErrors))
+        return false;
+
+    /* If no errors are specified, use simplifyTargetError for all */
+    if(lodErrors.isEmpty()) {
+        const Float targetError = configuration().value<Float>("simplifyTargetError");
+        for(std::size_t i = 0; i != lodThresholds.size(); ++i)
+            arrayAppend(lodErrors, targetError);
+    } else if(lodErrors.size() != lodThresholds.size()) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::add(): expected either no or" << lodThresholds.size() << "lodTargetErrors values but got" << lodErrors.size();
+        return false;
+    }
+
+    /* If processing on multiple threads, queue a copy of the mesh and process
+       the queue once it's full */
+    if(configuration().value<UnsignedInt>("threads") != 1) {
+        arrayAppend(_state->pendingMeshes, PendingMesh{MeshTools::copy(mesh), configuration(), Utility::move(lodThresholds), Utility::move(lodErrors), Containers::String{name}, {}});
+
+        const UnsignedInt maxPendingMeshes = configuration().value<UnsignedInt>("maxPendingMeshes");
+        if(maxPendingMeshes && _state->pendingMeshes.size() >= maxPendingMeshes)
+            return processPendingMeshes("Trade::MeshOptimizerSceneConverter::add():");
+        return true;
+    }
+
+    /* Otherwise process right away, but the previously queued meshes have to
+       go first to preserve the order */
+    if(!processPendingMeshes("Trade::MeshOptimizerSceneConverter::add():"))
+        return false;
+
+    Containers::Optional<Containers::Array<MeshData>> levels = convertInternal("Trade::MeshOptimizerSceneConverter::add():", mesh, flags(), configuration(), lodThresholds, lodErrors, configuration().value<bool>("writeStats") ? &resetStats(configuration()) : nullptr);
+    if(!levels)
+        return false;
+
+    _state->appendMesh(*Utility::move(levels), name, configuration().value<bool>("splitLargeMeshes"));
+    return true;
+}
+
+Containers::Pointer<AbstractImporter> MeshOptimizerSceneConverter::doEnd() {
+    if(_state->failed) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::end(): processing of a previously added mesh failed";
+        _state = nullptr;
+        return {};
+    }
+
+    if(!processPendingMeshes("Trade::MeshOptimizerSceneConverter::end():")) {
+        _state = nullptr;
+        return {};
+    }
+
+    Containers::Pointer<AbstractImporter> out{new MeshImporter{Utility::move(_state->meshes), Utility::move(_state->names)}};
+    _state = nullptr;
+    return out;
+}
+
+void MeshOptimizerSceneConverter::doAbort() {
+    _state = nullptr;
 }
 
 }}
@@ -30,6 +30,7 @@
  * @m_since_{plugins,2020,06}
  */
 
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractSceneConverter.h>
 
 #include "MagnumPlugins/MeshOptimizerSceneConverter/configure.h"
@@ -133,7 +134,13 @@ case of @cb{.ini} optimizeVertexFetch @ce, also mutable vertex data.
 Alternatively, the operation can be performed using @ref convert(const MeshData&),
 which accepts also triangle strips and fans or non-contiguous index buffers of
 non-implementation-specific index types, returning always an indexed triangle
-mesh without requiring the input to be mutable.
+mesh without requiring the input to be mutable. If the input is an already
+interleaved indexed triangle mesh and @cb{.ini} optimizeVertexFetch @ce is
+enabled, only the index data are copied and the optimized vertex data are
+written directly into the output, avoiding an intermediate copy. To avoid
+allocating new data altogether, for example for meshes imported with
+zero-copy options from mutable memory, use
+@ref convertInPlace(MeshData&) instead.
 
 The output has the same index type as input and all attributes are preserved,
 including custom attributes and attributes with implementation-specific vertex
@@ -147,6 +154,64 @@ from meshoptimizer's [efficiency analyzers](https://github.com/zeux/meshoptimize
 before and after the operation. @ref SceneConverterFlag::Quiet is recognized as
 well and causes all conversion warnings to be suppressed.
 
+If the @cb{.ini} writeStats @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+is enabled, the same statistics are saved into a @cb{.ini} [stats] @ce
+subgroup of the configuration after each operation, making them possible to
+query programmatically, for example to track mesh efficiency in a continuous
+integration setup:
+
+@snippet MeshOptimizerSceneConverter.cpp stats
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-quantization Vertex quantization
+
+Setting the @cb{.ini} quantizeNormals @ce,
+@cb{.ini} quantizeTextureCoordinates @ce or @cb{.ini} quantizePositions @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration options"
+makes @ref convert(const MeshData&) store the corresponding floating-point
+attributes in smaller types, reducing the vertex fetch bandwidth:
+
+-   @ref MeshAttribute::Normal, @ref MeshAttribute::Tangent and
+    @ref MeshAttribute::Bitangent can be quantized to normalized 8-bit or
+    16-bit signed integers with @cb{.ini} snorm8 @ce or
+    @cb{.ini} snorm16 @ce, for example @ref VertexFormat::Vector3bNormalized
+-   @ref MeshAttribute::TextureCoordinates can be quantized to
+    @ref VertexFormat::Vector2usNormalized with @cb{.ini} unorm16 @ce, but
+    only if all coordinates are in the @f$ [0, 1] @f$ range. A warning is
+    printed and the attribute is kept as-is otherwise.
+-   @ref MeshAttribute::Position can be converted to half-floats, for example
+    @ref VertexFormat::Vector3h, with @cb{.ini} half @ce. Unlike
+    normalized integers, this doesn't need any dequantization transformation.
+
+The quantization is done after overdraw optimization and before vertex fetch
+optimization, and each attribute in the new layout is aligned to four bytes.
+Array attributes and attributes that aren't floating-point are copied
+unchanged, implementation-specific vertex formats aren't supported. When
+@ref SceneConverterFlag::Verbose is enabled, the vertex fetch statistics
+reflect the reduced vertex size. The quantization can't be performed with
+@ref convertInPlace(MeshData&).
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-spatial-sort Spatial sorting of point clouds and non-indexed meshes
+
+The above optimizations all operate on an index buffer, and thus
+@ref MeshPrimitive::Points and non-indexed @ref MeshPrimitive::Triangles
+meshes, such as point clouds imported from PLY files, are rejected by
+default. Enabling the @cb{.ini} spatialSort @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+makes @ref convert(const MeshData&) and @ref add(const MeshData&, Containers::StringView)
+reorder such meshes [for spatial locality](https://github.com/zeux/meshoptimizer#point-cloud-compression)
+instead, improving GPU cache efficiency and compressibility of the vertex
+data. Point cloud vertices are sorted with `meshopt_spatialSortRemap()` and
+if the point cloud is indexed, its index buffer is remapped to the new order.
+Whole triangles of non-indexed triangle meshes are sorted with
+`meshopt_spatialSortTriangles()` and the output stays non-indexed. The mesh
+is required to have positions, all attributes are preserved and the output
+has an interleaved layout. No other operation is performed on such meshes,
+the spatial sorting thus can't be combined with LOD, shadow mesh or meshlet
+generation, splitting or encoding with @ref convertToData(const MeshData&).
+Indexed triangle meshes are unaffected by the option.
+
+
 @subsection Trade-MeshOptimizerSceneConverter-behavior-simplification Mesh simplification
 
 By default the plugin performs only the above non-destructive operations.
@@ -169,6 +234,165 @@ degenerate triangles. By default a mesh with zero vertices is returned in that
 case, enable the @cb{.ini} simplifyFailEmpty @ce option to make the process
 fail in that case instead.
 
+@subsection Trade-MeshOptimizerSceneConverter-behavior-meshlets Meshlet generation
+
+With the @cb{.ini} meshlets @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+enabled, @ref convert(const MeshData&) splits the mesh into
+[meshlets](https://github.com/zeux/meshoptimizer#mesh-shading) of at most
+@cb{.ini} meshletMaxVertices @ce vertices and @cb{.ini} meshletMaxTriangles @ce
+triangles, suitable for mesh shaders and GPU-driven cluster culling. This is
+done after all other operations and requires the mesh to have a position
+attribute and meshoptimizer 0.17 or newer.
+
+The output is a @ref MeshPrimitive::Meshlets mesh with each "vertex" being one
+meshlet, described by the following custom attributes. The vertex and triangle
+arrays have a fixed size given by the configuration options, with unused items
+being zero.
+
+-   @cpp meshAttributeCustom(0) @ce, @ref VertexFormat::UnsignedInt array of
+    @cb{.ini} meshletMaxVertices @ce items --- indices of meshlet vertices in
+    the mesh that would be returned by the same conversion with
+    @cb{.ini} meshlets @ce disabled
+-   @cpp meshAttributeCustom(1) @ce, @ref VertexFormat::Vector3ub array of
+    @cb{.ini} meshletMaxTriangles @ce items --- meshlet triangles, indexing
+    the meshlet vertex array
+-   @cpp meshAttributeCustom(2) @ce, @ref VertexFormat::UnsignedInt ---
+    meshlet vertex count
+-   @cpp meshAttributeCustom(3) @ce, @ref VertexFormat::UnsignedInt ---
+    meshlet triangle count
+-   @cpp meshAttributeCustom(4) @ce, @ref VertexFormat::Vector3 --- bounding
+    sphere center
+-   @cpp meshAttributeCustom(5) @ce, @ref VertexFormat::Float --- bounding
+    sphere radius
+-   @cpp meshAttributeCustom(6) @ce, @ref VertexFormat::Vector3 --- normal
+    cone apex
+-   @cpp meshAttributeCustom(7) @ce, @ref VertexFormat::Vector3 --- normal
+    cone axis
+-   @cpp meshAttributeCustom(8) @ce, @ref VertexFormat::Float --- normal cone
+    cutoff, a meshlet can be culled if
+    @f$ \boldsymbol{d} \cdot \boldsymbol{a} \ge c @f$, where
+    @f$ \boldsymbol{d} @f$ is the normalized direction from the camera to the
+    cone apex, @f$ \boldsymbol{a} @f$ the cone axis and @f$ c @f$ the cutoff
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-lods LOD chain generation
+
+Multiple meshes can be processed at once using @ref begin(),
+@ref add(const MeshData&, Containers::StringView) and @ref end(), which
+performs the same operations as @ref convert(const MeshData&) on each mesh and
+returns an importer instance with all of them. If the
+@cb{.ini} lodThresholds @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+contains a list of target index count thresholds, each added mesh
+additionally gets one mesh level for each of them, accessible through the
+@p level parameter of @ref AbstractImporter::mesh(). The levels are
+simplified from the processed mesh, so the interleaving and optimizations are
+done only once for the whole chain, and @cb{.ini} lodTargetErrors @ce can
+specify a target error for each, with @cb{.ini} simplifyTargetError @ce used
+for all if empty. The @cb{.ini} simplifySloppy @ce,
+@cb{.ini} simplifyLockBorder @ce and @cb{.ini} simplifyFailEmpty @ce options
+affect the LOD levels as well, while @cb{.ini} simplify @ce applies only to
+the first level. If @cb{.ini} meshlets @ce are enabled, each level gets
+converted to meshlets. A non-empty @cb{.ini} lodThresholds @ce option makes
+@ref convert(const MeshData&) fail, as it can return only a single mesh.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-shadow Shadow mesh generation
+
+If the @cb{.ini} shadowMesh @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+is enabled, each mesh passed to
+@ref add(const MeshData&, Containers::StringView) additionally gets a mesh
+level after all LOD levels, containing just the
+@ref MeshAttribute::Position attribute in its original format. It's generated
+using [meshopt_generateShadowIndexBuffer()](https://github.com/zeux/meshoptimizer#shadow-indexing)
+from the processed mesh, so vertices that differ only in other attributes,
+such as normals or texture coordinates on hard edges and seams, are merged
+and vertices that are no longer referenced are removed. Such a mesh is
+suitable for depth prepass and shadow rendering, where it results in less
+vertex fetch and vertex shader invocations. With
+@ref SceneConverterFlag::Verbose enabled, the vertex count reduction and the
+amount of fetched position data is printed. The mesh isn't converted to
+meshlets even if @cb{.ini} meshlets @ce are enabled. Same as with
+@cb{.ini} lodThresholds @ce, an enabled @cb{.ini} shadowMesh @ce option makes
+@ref convert(const MeshData&) and @ref convertToData(const MeshData&) fail.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-split Splitting for 16-bit indices
+
+If the @cb{.ini} splitLargeMeshes @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+is enabled, meshes passed to
+@ref add(const MeshData&, Containers::StringView) that have more than 65535
+vertices after processing are split into multiple meshes in the output, each
+with @ref MeshIndexType::UnsignedShort indices. The index value 65535 is left
+unused in order to be usable for primitive restart. Triangles are distributed
+to the parts in the order of the processed index buffer, so the parts are
+spatially coherent and retain the vertex cache and vertex fetch ordering.
+Meshes that fit and have @ref MeshIndexType::UnsignedInt indices get their
+indices converted to @ref MeshIndexType::UnsignedShort. All parts have the
+same name as the original mesh and are placed in the output importer in
+order, which means the mesh IDs in the output no longer correspond to the
+order in which the meshes were added. The option can't be combined with
+@cb{.ini} lodThresholds @ce, @cb{.ini} shadowMesh @ce or
+@cb{.ini} meshlets @ce, and makes @ref convert(const MeshData&) and
+@ref convertToData(const MeshData&) fail.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-stripify Triangle strip output
+
+If the @cb{.ini} stripify @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+is enabled, the processed meshes, including LOD levels, shadow meshes and
+split parts, are converted to @ref MeshPrimitive::TriangleStrip using
+[meshopt_stripify()](https://github.com/zeux/meshoptimizer#triangle-strip-conversion)
+as the very last step. The index type is preserved and individual strips are
+separated with a primitive restart index, which is the maximum value
+representable by the index type, for example @cpp 65535 @ce for
+@ref MeshIndexType::UnsignedShort. If @cb{.ini} stripifyRestart @ce is
+disabled or the maximum value would clash with a vertex ID, degenerate
+triangles are used instead. A mesh is converted only if the strip has less
+indices than the triangle list, which is then also printed with
+@ref SceneConverterFlag::Verbose. The vertex cache optimization then uses
+[meshopt_optimizeVertexCacheStrip()](https://github.com/zeux/meshoptimizer#triangle-strip-conversion)
+instead, which results in shorter strips, if meshoptimizer 0.15 or newer is
+used. The before & after statistics are calculated on the triangle list. The
+option can't be combined with @cb{.ini} meshlets @ce, and makes
+@ref convertInPlace(MeshData&) and @ref convertToData(const MeshData&) fail.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-threads Processing on multiple threads
+
+If the @cb{.ini} threads @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+is set to a value other than @cpp 1 @ce, meshes passed to
+@ref add(const MeshData&, Containers::StringView) are not processed right
+away but copied, together with the configuration at the time of the call, and
+processed together on multiple threads once @cb{.ini} maxPendingMeshes @ce of
+them are queued or the conversion ends. The limit bounds the memory used by
+the queued copies, setting it to @cpp 0 @ce makes everything processed only
+in @ref end(). The result is the same as when processing serially, with the
+meshes in the order they were added and the error, warning and verbose output
+of each printed in that order as well. Processing errors are however reported
+only once the queue is processed, failing the operation that triggered it as
+well as all following ones until the conversion ends. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+application has to be linked to `pthread` on Linux for this to work. The
+@ref convert(const MeshData&) and @ref convertToData(const MeshData&)
+operations are always done on the calling thread.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-encoding Vertex and index buffer compression
+
+@ref convertToData(const MeshData&) performs the same operations as
+@ref convert(const MeshData&) and then compresses the result using
+meshoptimizer's [vertex and index buffer codecs](https://github.com/zeux/meshoptimizer#vertexindex-buffer-compression).
+The output is a small header with the primitive, index type, counts and a
+table describing the name, format, offset and array size of each attribute,
+followed by the encoded index and vertex data. It can be imported back with
+the @ref MeshOptimizerImporter plugin.
+
+The encoded vertex stride is the range actually occupied by the attributes,
+padded to a multiple of four bytes, and it can't be larger than 256 bytes.
+Attributes with implementation-specific vertex formats can't be described by
+the attribute table and thus aren't supported. The @cb{.ini} meshlets @ce and
+@cb{.ini} lodThresholds @ce options can't be used together with encoding.
+
 @section Trade-MeshOptimizerSceneConverter-configuration Plugin-specific configuration
 
 It's possible to tune various output options through @ref configuration(). See
@@ -191,6 +415,17 @@ class MAGNUM_MESHOPTIMIZERSCENECONVERTER_EXPORT MeshOptimizerSceneConverter: pub
 
         MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL bool doConvertInPlace(MeshData& mesh) override;
         MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL Containers::Optional<MeshData> doConvert(const MeshData& mesh) override;
+        MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(const MeshData& mesh) override;
+
+        MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL bool doBegin() override;
+        MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const MeshData& mesh, Containers::StringView name) override;
+        MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL Containers::Pointer<AbstractImporter> doEnd() override;
+        MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL void doAbort() override;
+
+        MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL bool processPendingMeshes(const char* messagePrefix);
+
+        struct State;
+        Containers::Pointer<State> _state;
 };
 
 }}
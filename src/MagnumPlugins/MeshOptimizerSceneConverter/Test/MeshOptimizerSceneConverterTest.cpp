@@ -24,13 +24,21 @@
 */
 
 #include <sstream>
+#include <algorithm> /* std::sort(), std::find() */
+#include <cstdio> /* std::sscanf() */
+#include <tuple> /* std::make_tuple() */
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Compare/String.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/MeshTools/CompressIndices.h>
 #include <Magnum/MeshTools/GenerateIndices.h>
@@ -40,9 +48,12 @@
 #include <Magnum/Primitives/Plane.h>
 #include <Magnum/Primitives/Square.h>
 #include <Magnum/Primitives/UVSphere.h>
+#include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/AbstractSceneConverter.h>
 #include <Magnum/Trade/MeshData.h>
 
+#include "MagnumPlugins/MeshOptimizerImporter/MeshOptimizerHeader.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -72,10 +83,14 @@ struct MeshOptimizerSceneConverterTest: TestSuite::Tester {
 
     template<class T> void verbose();
     void verboseCustomAttribute();
+    void stats();
+    void statsNoPositions();
+    void statsMultiple();
     void verboseImplementationSpecificAttribute();
 
     /* Those test the copy-making function */
     void copy();
+    void copyInterleavedNonOwned();
     void copyTriangleStrip2DPositions();
     void copyTriangleFanIndexed();
     template<class T> void copyNonContiguousIndexBuffer();
@@ -89,6 +104,59 @@ struct MeshOptimizerSceneConverterTest: TestSuite::Tester {
     void simplifyVerbose();
     void simplifyEmpty();
 
+    void convertMultiple();
+    void lods();
+    void lodsSingleConversion();
+    void lodsInvalidValue();
+    void lodsTargetErrorCountMismatch();
+    void lodsNoPositions();
+
+    void shadowMeshSingleConversion();
+    void shadowMeshNoPositions();
+    void shadowMesh();
+    void shadowMeshLods();
+    void shadowMeshVerbose();
+
+    void splitSingleConversion();
+    void splitInvalidCombination();
+    void split();
+    void splitFits();
+
+    void threads();
+    void threadsFailed();
+    void threadsFailedQueueFull();
+
+    void meshletsInPlace();
+    void meshletsNoPositions();
+    void meshletsInvalidLimits();
+    template<class T> void meshlets();
+
+    void quantizeInPlace();
+    void quantizeInvalidOption();
+    void quantizeImplementationSpecificVertexFormat();
+    void quantize();
+    void quantizeTextureCoordinatesOutOfRange();
+    void quantizeVerbose();
+
+    void spatialSortNoPositions();
+    void spatialSortInvalidCombination();
+    void spatialSortPoints();
+    void spatialSortPointsIndexed();
+    void spatialSortTriangles();
+
+    void stripifyInPlace();
+    void stripifyMeshlets();
+    template<class T> void stripify();
+    void stripifyNotShorter();
+
+    void encodeLods();
+    void encodeMeshlets();
+    void encodeSpatialSort();
+    void encodeStripify();
+    void encodeImplementationSpecificVertexFormat();
+    template<class T> void encode();
+    void encodeNoAttributes();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractSceneConverter> _manager{"nonexistent"};
 };
@@ -128,6 +196,78 @@ const struct {
     {"empty input, failEmpty", {}, 0, 1.0e-2f, nullptr},
 };
 
+const struct {
+    const char* name;
+    UnsignedInt maxVertices, maxTriangles;
+} MeshletsInvalidLimitsData[]{
+    {"too few vertices", 2, 124},
+    {"too many vertices", 256, 124},
+    {"too few triangles", 64, 0},
+    {"too many triangles", 64, 516},
+    {"triangles not a multiple of 4", 64, 126},
+};
+
+const struct {
+    const char* name;
+    const char* option;
+    const char* message;
+} QuantizeInvalidOptionData[]{
+    {"normals", "quantizeNormals",
+        "expected quantizeNormals to be empty, snorm8 or snorm16 but got octahedral"},
+    {"texture coordinates", "quantizeTextureCoordinates",
+        "expected quantizeTextureCoordinates to be empty or unorm16 but got octahedral"},
+    {"positions", "quantizePositions",
+        "expected quantizePositions to be empty or half but got octahedral"},
+};
+
+const struct {
+    const char* name;
+    const char* normals;
+    VertexFormat expectedNormalFormat;
+    Float normalDelta;
+} QuantizeData[]{
+    {"snorm8 normals", "snorm8", VertexFormat::Vector3bNormalized, 1.0f/127.0f},
+    {"snorm16 normals", "snorm16", VertexFormat::Vector3sNormalized, 1.0f/32767.0f},
+};
+
+const struct {
+    const char* name;
+    const char* option;
+    const char* value;
+} SplitInvalidCombinationData[]{
+    {"LODs", "lodThresholds", "0.5"},
+    {"shadow mesh", "shadowMesh", "true"},
+    {"meshlets", "meshlets", "true"},
+};
+
+const struct {
+    const char* name;
+    const char* option;
+    const char* value;
+} SpatialSortInvalidCombinationData[]{
+    {"LODs", "lodThresholds", "0.5"},
+    {"shadow mesh", "shadowMesh", "true"},
+    {"splitting", "splitLargeMeshes", "true"},
+};
+
+const struct {
+    const char* name;
+    bool restart;
+} StripifyData[]{
+    {"restart index", true},
+    {"degenerate triangles", false},
+};
+
+const struct {
+    const char* name;
+    UnsignedInt threads, maxPendingMeshes;
+} ThreadsData[]{
+    {"two threads", 2, 32},
+    {"hardware concurrency", 0, 32},
+    {"queue limit", 3, 2},
+    {"no queue limit", 3, 0},
+};
+
 MeshOptimizerSceneConverterTest::MeshOptimizerSceneConverterTest() {
     addTests({
         &MeshOptimizerSceneConverterTest::notTriangles,
@@ -158,7 +298,10 @@ MeshOptimizerSceneConverterTest::MeshOptimizerSceneConverterTest() {
         &MeshOptimizerSceneConverterTest::verbose<UnsignedByte>,
         &MeshOptimizerSceneConverterTest::verbose<UnsignedShort>,
         &MeshOptimizerSceneConverterTest::verbose<UnsignedInt>,
-        &MeshOptimizerSceneConverterTest::verboseCustomAttribute});
+        &MeshOptimizerSceneConverterTest::verboseCustomAttribute,
+        &MeshOptimizerSceneConverterTest::stats,
+        &MeshOptimizerSceneConverterTest::statsNoPositions,
+        &MeshOptimizerSceneConverterTest::statsMultiple});
 
     addInstancedTests({&MeshOptimizerSceneConverterTest::verboseImplementationSpecificAttribute},
         Containers::arraySize(QuietVerboseData));
@@ -169,6 +312,7 @@ MeshOptimizerSceneConverterTest::MeshOptimizerSceneConverterTest() {
         &MeshOptimizerSceneConverterTest::inPlaceOptimizeEmpty<UnsignedInt>,
 
         &MeshOptimizerSceneConverterTest::copy,
+        &MeshOptimizerSceneConverterTest::copyInterleavedNonOwned,
         &MeshOptimizerSceneConverterTest::copyTriangleStrip2DPositions,
         &MeshOptimizerSceneConverterTest::copyTriangleFanIndexed,
         &MeshOptimizerSceneConverterTest::copyNonContiguousIndexBuffer<UnsignedByte>,
@@ -194,6 +338,86 @@ MeshOptimizerSceneConverterTest::MeshOptimizerSceneConverterTest() {
     addInstancedTests({&MeshOptimizerSceneConverterTest::simplifyEmpty},
         Containers::arraySize(SimplifyEmptyData));
 
+    addTests({&MeshOptimizerSceneConverterTest::convertMultiple,
+              &MeshOptimizerSceneConverterTest::lods,
+              &MeshOptimizerSceneConverterTest::lodsSingleConversion,
+              &MeshOptimizerSceneConverterTest::lodsInvalidValue,
+              &MeshOptimizerSceneConverterTest::lodsTargetErrorCountMismatch,
+              &MeshOptimizerSceneConverterTest::lodsNoPositions});
+
+    addTests({&MeshOptimizerSceneConverterTest::shadowMeshSingleConversion,
+              &MeshOptimizerSceneConverterTest::shadowMeshNoPositions,
+              &MeshOptimizerSceneConverterTest::shadowMesh,
+              &MeshOptimizerSceneConverterTest::shadowMeshLods,
+              &MeshOptimizerSceneConverterTest::shadowMeshVerbose});
+
+    addTests({&MeshOptimizerSceneConverterTest::splitSingleConversion});
+
+    addInstancedTests({&MeshOptimizerSceneConverterTest::splitInvalidCombination},
+        Containers::arraySize(SplitInvalidCombinationData));
+
+    addTests({&MeshOptimizerSceneConverterTest::split,
+              &MeshOptimizerSceneConverterTest::splitFits});
+
+    addInstancedTests({&MeshOptimizerSceneConverterTest::threads},
+        Containers::arraySize(ThreadsData));
+
+    addTests({&MeshOptimizerSceneConverterTest::threadsFailed,
+              &MeshOptimizerSceneConverterTest::threadsFailedQueueFull});
+
+    addTests({&MeshOptimizerSceneConverterTest::meshletsInPlace,
+              &MeshOptimizerSceneConverterTest::meshletsNoPositions});
+
+    addInstancedTests({&MeshOptimizerSceneConverterTest::meshletsInvalidLimits},
+        Containers::arraySize(MeshletsInvalidLimitsData));
+
+    addTests({&MeshOptimizerSceneConverterTest::meshlets<UnsignedByte>,
+              &MeshOptimizerSceneConverterTest::meshlets<UnsignedShort>,
+              &MeshOptimizerSceneConverterTest::meshlets<UnsignedInt>});
+
+    addTests({&MeshOptimizerSceneConverterTest::quantizeInPlace});
+
+    addInstancedTests({&MeshOptimizerSceneConverterTest::quantizeInvalidOption},
+        Containers::arraySize(QuantizeInvalidOptionData));
+
+    addTests({&MeshOptimizerSceneConverterTest::quantizeImplementationSpecificVertexFormat});
+
+    addInstancedTests({&MeshOptimizerSceneConverterTest::quantize},
+        Containers::arraySize(QuantizeData));
+
+    addTests({&MeshOptimizerSceneConverterTest::quantizeTextureCoordinatesOutOfRange,
+              &MeshOptimizerSceneConverterTest::quantizeVerbose});
+
+    addTests({&MeshOptimizerSceneConverterTest::spatialSortNoPositions});
+
+    addInstancedTests({&MeshOptimizerSceneConverterTest::spatialSortInvalidCombination},
+        Containers::arraySize(SpatialSortInvalidCombinationData));
+
+    addTests({&MeshOptimizerSceneConverterTest::spatialSortPoints,
+              &MeshOptimizerSceneConverterTest::spatialSortPointsIndexed,
+              &MeshOptimizerSceneConverterTest::spatialSortTriangles});
+
+    addTests({&MeshOptimizerSceneConverterTest::stripifyInPlace,
+              &MeshOptimizerSceneConverterTest::stripifyMeshlets});
+
+    addInstancedTests<MeshOptimizerSceneConverterTest>({
+        &MeshOptimizerSceneConverterTest::stripify<UnsignedByte>,
+        &MeshOptimizerSceneConverterTest::stripify<UnsignedShort>,
+        &MeshOptimizerSceneConverterTest::stripify<UnsignedInt>},
+        Containers::arraySize(StripifyData));
+
+    addTests({&MeshOptimizerSceneConverterTest::stripifyNotShorter});
+
+    addTests({&MeshOptimizerSceneConverterTest::encodeLods,
+              &MeshOptimizerSceneConverterTest::encodeMeshlets,
+              &MeshOptimizerSceneConverterTest::encodeSpatialSort,
+              &MeshOptimizerSceneConverterTest::encodeStripify,
+              &MeshOptimizerSceneConverterTest::encodeImplementationSpecificVertexFormat,
+              &MeshOptimizerSceneConverterTest::encode<UnsignedByte>,
+              &MeshOptimizerSceneConverterTest::encode<UnsignedShort>,
+              &MeshOptimizerSceneConverterTest::encode<UnsignedInt>,
+              &MeshOptimizerSceneConverterTest::encodeNoAttributes});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef MESHOPTIMIZERSCENECONVERTER_PLUGIN_FILENAME
@@ -734,6 +958,124 @@ void MeshOptimizerSceneConverterTest::verboseImplementationSpecificAttribute() {
             TestSuite::Compare::String);
 }
 
+void MeshOptimizerSceneConverterTest::stats() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("writeStats", true);
+
+    /* Same as in verbose() */
+    MeshData icosphere = Primitives::icosphereSolid(6);
+
+    /* Stats are calculated but nothing is printed */
+    std::ostringstream out;
+    {
+        Debug redirectDebug{&out};
+        CORRADE_VERIFY(converter->convert(icosphere));
+    }
+    CORRADE_COMPARE(out.str(), "");
+
+    const Utility::ConfigurationGroup* stats = converter->configuration().group("stats");
+    CORRADE_VERIFY(stats);
+    const Utility::ConfigurationGroup* before = stats->group("before");
+    const Utility::ConfigurationGroup* after = stats->group("after");
+    CORRADE_VERIFY(before);
+    CORRADE_VERIFY(after);
+
+    /* Same values as printed in verbose() */
+    CORRADE_COMPARE(before->value<UnsignedInt>("verticesTransformed"), 165120);
+    CORRADE_COMPARE(after->value<UnsignedInt>("verticesTransformed"), 58521);
+    CORRADE_COMPARE(before->value<UnsignedInt>("warpsExecuted"), 1);
+    CORRADE_COMPARE(after->value<UnsignedInt>("warpsExecuted"), 1);
+    CORRADE_COMPARE(after->value<Float>("acmr"), 0.714368f);
+    CORRADE_COMPARE(before->value<Float>("atvr"), 4.03105f);
+    CORRADE_COMPARE(after->value<Float>("atvr"), 1.42867f);
+    CORRADE_COMPARE(before->value<UnsignedInt>("bytesFetched"), 3891008);
+    CORRADE_COMPARE(after->value<UnsignedInt>("bytesFetched"), 1582144);
+    CORRADE_COMPARE(before->value<Float>("overfetch"), 3.95794f);
+    CORRADE_COMPARE(after->value<Float>("overfetch"), 1.60936f);
+    CORRADE_COMPARE(before->value<UnsignedInt>("pixelsShaded"), 308753);
+    CORRADE_COMPARE(after->value<UnsignedInt>("pixelsShaded"), 308750);
+    CORRADE_COMPARE(before->value<UnsignedInt>("pixelsCovered"), 308748);
+    CORRADE_COMPARE(after->value<UnsignedInt>("pixelsCovered"), 308748);
+    CORRADE_COMPARE(before->value<Float>("overdraw"), 1.00002f);
+    CORRADE_COMPARE(after->value<Float>("overdraw"), 1.00001f);
+
+    /* A failed operation leaves the group empty */
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!converter->convert(MeshData{MeshPrimitive::Lines, 2}));
+    }
+    stats = converter->configuration().group("stats");
+    CORRADE_VERIFY(stats);
+    CORRADE_VERIFY(!stats->hasGroups());
+    CORRADE_VERIFY(!stats->hasValues());
+
+    /* In-place conversion fills it as well, replacing the previous contents
+       instead of adding another group */
+    CORRADE_VERIFY(converter->convertInPlace(icosphere));
+    CORRADE_COMPARE(converter->configuration().groupCount("stats"), 1);
+    stats = converter->configuration().group("stats");
+    CORRADE_COMPARE(stats->groupCount(), 2);
+    CORRADE_VERIFY(stats->group("after"));
+    CORRADE_COMPARE(stats->group("after")->value<UnsignedInt>("verticesTransformed"), 58521);
+}
+
+void MeshOptimizerSceneConverterTest::statsNoPositions() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("writeStats", true);
+    converter->configuration().setValue("optimizeOverdraw", false);
+
+    /* Without positions there are no overdraw stats and with an
+       implementation-specific format no vertex fetch stats. Testing
+       in-place as interleave() inside convert() can't handle
+       implementation-specific formats, see
+       verboseImplementationSpecificAttribute(). */
+    UnsignedByte indexData[]{0, 1, 2, 2, 1, 3};
+    UnsignedInt vertexData[4]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        DataFlag::Mutable, indexData, MeshIndexData{indexData},
+        DataFlag::Mutable, vertexData, {
+            MeshAttributeData{meshAttributeCustom(1), vertexFormatWrap(0xcaca), Containers::arrayView(vertexData)}
+        }};
+
+    std::ostringstream out;
+    {
+        Warning redirectWarning{&out};
+        CORRADE_VERIFY(converter->convertInPlace(mesh));
+    }
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convertInPlace(): can't analyze vertex fetch for VertexFormat::ImplementationSpecific(0xcaca)\n");
+
+    const Utility::ConfigurationGroup* after = converter->configuration().group("stats")->group("after");
+    CORRADE_VERIFY(after);
+    CORRADE_VERIFY(after->hasValue("acmr"));
+    CORRADE_VERIFY(!after->hasValue("bytesFetched"));
+    CORRADE_VERIFY(!after->hasValue("overdraw"));
+}
+
+void MeshOptimizerSceneConverterTest::statsMultiple() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("writeStats", true);
+
+    CORRADE_VERIFY(converter->begin());
+    CORRADE_VERIFY(converter->add(Primitives::icosphereSolid(6)));
+
+    /* After each add() the group contains stats of the added mesh */
+    const Utility::ConfigurationGroup* after = converter->configuration().group("stats")->group("after");
+    CORRADE_VERIFY(after);
+    CORRADE_COMPARE(after->value<UnsignedInt>("verticesTransformed"), 58521);
+
+    /* With multiple threads it's filled once the queue is processed, with
+       stats of the last mesh */
+    converter->configuration().setValue("threads", 2);
+    CORRADE_VERIFY(converter->add(Primitives::icosphereSolid(1)));
+    CORRADE_VERIFY(converter->add(Primitives::icosphereSolid(6)));
+    CORRADE_VERIFY(converter->end());
+    after = converter->configuration().group("stats")->group("after");
+    CORRADE_VERIFY(after);
+    CORRADE_COMPARE(after->value<UnsignedInt>("verticesTransformed"), 58521);
+    CORRADE_COMPARE(converter->configuration().groupCount("stats"), 1);
+}
+
 template<class T> void MeshOptimizerSceneConverterTest::inPlaceOptimizeEmpty() {
     setTestCaseTemplateName(Math::TypeTraits<T>::name());
 
@@ -810,6 +1152,76 @@ void MeshOptimizerSceneConverterTest::copy() {
         TestSuite::Compare::Container);
 }
 
+void MeshOptimizerSceneConverterTest::copyInterleavedNonOwned() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    /* The icosphere is interleaved already, so only the index data get
+       copied and the vertex fetch optimization writes directly to the output.
+       Make it an immutable view to verify the original isn't touched. */
+    MeshData original = MeshTools::compressIndices(Primitives::icosphereSolid(1));
+    CORRADE_VERIFY(MeshTools::isInterleaved(original));
+    Containers::Array<char> originalIndexData{NoInit, original.indexData().size()};
+    Containers::Array<char> originalVertexData{NoInit, original.vertexData().size()};
+    Utility::copy(original.indexData(), originalIndexData);
+    Utility::copy(original.vertexData(), originalVertexData);
+    MeshData view{original.primitive(),
+        {}, original.indexData(), MeshIndexData{original.indices()},
+        {}, original.vertexData(), meshAttributeDataNonOwningArray(original.attributeData()),
+        original.vertexCount()};
+
+    /* Verbose output to verify the positions are correctly fetched for the
+       after stats */
+    std::ostringstream out;
+    Containers::Optional<MeshData> optimized;
+    {
+        Debug redirectOutput{&out};
+        converter->addFlags(SceneConverterFlag::Verbose);
+        optimized = converter->convert(view);
+    }
+    CORRADE_VERIFY(optimized);
+    CORRADE_COMPARE(optimized->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE(optimized->vertexCount(), original.vertexCount());
+    CORRADE_COMPARE(optimized->attributeCount(), original.attributeCount());
+    CORRADE_COMPARE(optimized->indexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE(optimized->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE(optimized->vertexData().size(), original.vertexData().size());
+    CORRADE_VERIFY(MeshTools::isInterleaved(*optimized));
+
+    /* Same as in copy() */
+    CORRADE_COMPARE_AS(optimized->indices<UnsignedShort>().prefix(16),
+        Containers::arrayView<UnsignedShort>({
+            0, 1, 2, 2, 1, 3, 3, 1, 4, 2, 3, 5, 6, 3, 4, 3
+        }), TestSuite::Compare::Container);
+    const Vector3 positionsOrNormals[]{
+        {1.0f, 0.0f, 0.0f},
+        {0.809017f, 0.5f, -0.309017f},
+        {0.809017f, 0.5f, 0.309017f},
+        {0.525731f, 0.850651f, 0.0f}
+    };
+    CORRADE_COMPARE_AS(optimized->attribute<Vector3>(MeshAttribute::Position).prefix(4),
+        Containers::arrayView(positionsOrNormals),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(optimized->attribute<Vector3>(MeshAttribute::Normal).prefix(4),
+        Containers::arrayView(positionsOrNormals),
+        TestSuite::Compare::Container);
+
+    /* The after stats are calculated from the reordered positions, so the
+       overdraw should be the same or better */
+    const std::string str = out.str();
+    const std::size_t overdraw = str.find("    overdraw ");
+    CORRADE_VERIFY(overdraw != std::string::npos);
+    Float before, after;
+    CORRADE_COMPARE(std::sscanf(str.data() + overdraw, "    overdraw %f -> %f", &before, &after), 2);
+    CORRADE_COMPARE_AS(after, before,
+        TestSuite::Compare::LessOrEqual);
+
+    /* The input is left untouched */
+    CORRADE_COMPARE_AS(original.indexData(), originalIndexData,
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(original.vertexData(), originalVertexData,
+        TestSuite::Compare::Container);
+}
+
 void MeshOptimizerSceneConverterTest::copyTriangleStrip2DPositions() {
     Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
 
@@ -1248,6 +1660,1240 @@ void MeshOptimizerSceneConverterTest::simplifyEmpty() {
     }
 }
 
+void MeshOptimizerSceneConverterTest::convertMultiple() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    MeshData sphere = Primitives::uvSphereSolid(4, 6);
+    MeshData plane = MeshTools::generateIndices(Primitives::planeSolid());
+
+    CORRADE_VERIFY(converter->begin());
+    CORRADE_VERIFY(converter->add(sphere, "Sphere"));
+    CORRADE_VERIFY(converter->add(plane));
+    Containers::Pointer<AbstractImporter> importer = converter->end();
+    CORRADE_VERIFY(importer);
+    CORRADE_COMPARE(importer->meshCount(), 2);
+    CORRADE_COMPARE(importer->meshName(0), "Sphere");
+    CORRADE_COMPARE(importer->meshName(1), "");
+
+    /* Without LODs specified there's just one level, equivalent to convert() */
+    CORRADE_COMPARE(importer->meshLevelCount(0), 1);
+    CORRADE_COMPARE(importer->meshLevelCount(1), 1);
+
+    Containers::Optional<MeshData> converted = converter->convert(sphere);
+    CORRADE_VERIFY(converted);
+    Containers::Optional<MeshData> imported = importer->mesh(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE_AS(imported->indicesAsArray(),
+        converted->indicesAsArray(),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Position),
+        converted->attribute<Vector3>(MeshAttribute::Position),
+        TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::lods() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("lodThresholds", "0.5 0.25");
+    /* The default 1.0e-2 is too little for this */
+    converter->configuration().setValue("lodTargetErrors", "0.25 0.5");
+
+    MeshData sphere = Primitives::uvSphereSolid(4, 6, Primitives::UVSphereFlag::TextureCoordinates);
+    CORRADE_COMPARE(sphere.indexCount(), 108);
+
+    CORRADE_VERIFY(converter->begin());
+    CORRADE_VERIFY(converter->add(sphere));
+    Containers::Pointer<AbstractImporter> importer = converter->end();
+    CORRADE_VERIFY(importer);
+    CORRADE_COMPARE(importer->meshCount(), 1);
+    CORRADE_COMPARE(importer->meshLevelCount(0), 3);
+
+    Containers::Optional<MeshData> level0 = importer->mesh(0, 0);
+    Containers::Optional<MeshData> level1 = importer->mesh(0, 1);
+    Containers::Optional<MeshData> level2 = importer->mesh(0, 2);
+    CORRADE_VERIFY(level0);
+    CORRADE_VERIFY(level1);
+    CORRADE_VERIFY(level2);
+
+    /* The first level is unchanged, the others get progressively smaller */
+    CORRADE_COMPARE(level0->indexCount(), 108);
+    CORRADE_COMPARE(level0->vertexCount(), 23);
+    CORRADE_COMPARE_AS(level1->indexCount(), 54u,
+        TestSuite::Compare::LessOrEqual);
+    CORRADE_COMPARE_AS(level2->indexCount(), level1->indexCount(),
+        TestSuite::Compare::LessOrEqual);
+    CORRADE_COMPARE_AS(level1->vertexCount(), level0->vertexCount(),
+        TestSuite::Compare::Less);
+    CORRADE_COMPARE_AS(level2->vertexCount(), level1->vertexCount(),
+        TestSuite::Compare::LessOrEqual);
+
+    /* All attributes are preserved in all levels */
+    CORRADE_COMPARE(level1->attributeCount(), sphere.attributeCount());
+    CORRADE_COMPARE(level2->attributeCount(), sphere.attributeCount());
+    CORRADE_VERIFY(level2->hasAttribute(MeshAttribute::TextureCoordinates));
+}
+
+void MeshOptimizerSceneConverterTest::lodsSingleConversion() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("lodThresholds", "0.5");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(Primitives::uvSphereSolid(4, 6)));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convert(): LOD generation can't be performed with a single-mesh conversion, use begin(), add() and end() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::lodsInvalidValue() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("lodThresholds", "0.5 0.2f5");
+
+    CORRADE_VERIFY(converter->begin());
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(Primitives::uvSphereSolid(4, 6)));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::add(): invalid lodThresholds value 0.2f5\n");
+}
+
+void MeshOptimizerSceneConverterTest::lodsTargetErrorCountMismatch() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("lodThresholds", "0.5 0.25 0.125");
+    converter->configuration().setValue("lodTargetErrors", "0.25 0.5");
+
+    CORRADE_VERIFY(converter->begin());
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(Primitives::uvSphereSolid(4, 6)));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::add(): expected either no or 3 lodTargetErrors values but got 2\n");
+}
+
+void MeshOptimizerSceneConverterTest::lodsNoPositions() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("lodThresholds", "0.5");
+
+    const UnsignedByte indexData[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 1};
+
+    CORRADE_VERIFY(converter->begin());
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(mesh));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::add(): LOD generation requires the mesh to have positions\n");
+}
+
+void MeshOptimizerSceneConverterTest::shadowMeshSingleConversion() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("shadowMesh", true);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(Primitives::uvSphereSolid(4, 6)));
+    CORRADE_VERIFY(!converter->convertToData(Primitives::uvSphereSolid(4, 6)));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convert(): shadow mesh generation can't be performed with a single-mesh conversion, use begin(), add() and end() instead\n"
+        "Trade::MeshOptimizerSceneConverter::convertToData(): shadow mesh generation can't be performed with a single-mesh conversion, use begin(), add() and end() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::shadowMeshNoPositions() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("shadowMesh", true);
+
+    const UnsignedByte indexData[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 1};
+
+    CORRADE_VERIFY(converter->begin());
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(mesh));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::add(): shadow mesh generation requires the mesh to have positions\n");
+}
+
+void MeshOptimizerSceneConverterTest::shadowMesh() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("shadowMesh", true);
+
+    /* Each ring has the position duplicated on the texture coordinate seam */
+    MeshData sphere = Primitives::uvSphereSolid(4, 6, Primitives::UVSphereFlag::TextureCoordinates);
+    CORRADE_COMPARE(sphere.vertexCount(), 23);
+
+    CORRADE_VERIFY(converter->begin());
+    CORRADE_VERIFY(converter->add(sphere));
+    Containers::Pointer<AbstractImporter> importer = converter->end();
+    CORRADE_VERIFY(importer);
+    CORRADE_COMPARE(importer->meshCount(), 1);
+    CORRADE_COMPARE(importer->meshLevelCount(0), 2);
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0, 0);
+    Containers::Optional<MeshData> shadow = importer->mesh(0, 1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(shadow);
+
+    /* The regular mesh is the same as without the option */
+    CORRADE_COMPARE(mesh->vertexCount(), 23);
+    CORRADE_COMPARE(mesh->attributeCount(), sphere.attributeCount());
+
+    /* The shadow mesh has just positions, in the original format, and only
+       the unique ones. A 4x6 sphere has 6 vertices in each of the 3 rings
+       and the two poles. */
+    CORRADE_COMPARE(shadow->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(shadow->attributeCount(), 1);
+    CORRADE_COMPARE(shadow->attributeName(0), MeshAttribute::Position);
+    CORRADE_COMPARE(shadow->attributeFormat(0), VertexFormat::Vector3);
+    CORRADE_COMPARE(shadow->vertexCount(), 6*3 + 2);
+    CORRADE_COMPARE(shadow->indexCount(), mesh->indexCount());
+
+    /* The triangles reference the same positions as the regular mesh */
+    const Containers::Array<UnsignedInt> indices = mesh->indicesAsArray();
+    const Containers::Array<UnsignedInt> shadowIndices = shadow->indicesAsArray();
+    const Containers::Array<Vector3> positions = mesh->positions3DAsArray();
+    const Containers::Array<Vector3> shadowPositions = shadow->positions3DAsArray();
+    for(std::size_t i = 0; i != indices.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(shadowPositions[shadowIndices[i]], positions[indices[i]]);
+    }
+}
+
+void MeshOptimizerSceneConverterTest::shadowMeshLods() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("shadowMesh", true);
+    converter->configuration().setValue("lodThresholds", "0.5 0.25");
+    /* The default 1.0e-2 is too little for this */
+    converter->configuration().setValue("lodTargetErrors", "0.25 0.5");
+
+    MeshData sphere = Primitives::uvSphereSolid(4, 6, Primitives::UVSphereFlag::TextureCoordinates);
+
+    CORRADE_VERIFY(converter->begin());
+    CORRADE_VERIFY(converter->add(sphere));
+    Containers::Pointer<AbstractImporter> importer = converter->end();
+    CORRADE_VERIFY(importer);
+    CORRADE_COMPARE(importer->meshLevelCount(0), 4);
+
+    /* The shadow mesh is after all LODs and made from the first level */
+    Containers::Optional<MeshData> shadow = importer->mesh(0, 3);
+    CORRADE_VERIFY(shadow);
+    CORRADE_COMPARE(shadow->attributeCount(), 1);
+    CORRADE_COMPARE(shadow->indexCount(), 108);
+    CORRADE_COMPARE(shadow->vertexCount(), 6*3 + 2);
+}
+
+void MeshOptimizerSceneConverterTest::shadowMeshVerbose() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("shadowMesh", true);
+    /* Disable everything else to have just the shadow mesh output */
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+
+    CORRADE_VERIFY(converter->begin());
+
+    std::ostringstream out;
+    {
+        Debug redirectOutput{&out};
+        converter->addFlags(SceneConverterFlag::Verbose);
+        CORRADE_VERIFY(converter->add(Primitives::uvSphereSolid(4, 6, Primitives::UVSphereFlag::TextureCoordinates)));
+    }
+    CORRADE_VERIFY(converter->end());
+
+    /* Pick the shadow mesh line among the processing stats */
+    const std::string str = out.str();
+    const std::size_t found = str.find("Trade::MeshOptimizerSceneConverter::add(): shadow mesh has ");
+    CORRADE_VERIFY(found != std::string::npos);
+    UnsignedInt vertexCount, originalVertexCount, bytesBefore, bytesAfter;
+    CORRADE_COMPARE(std::sscanf(str.data() + found, "Trade::MeshOptimizerSceneConverter::add(): shadow mesh has %u out of %u vertices, with %u -> %u position bytes fetched", &vertexCount, &originalVertexCount, &bytesBefore, &bytesAfter), 4);
+    CORRADE_COMPARE(vertexCount, 6*3 + 2);
+    CORRADE_COMPARE(originalVertexCount, 23);
+    CORRADE_COMPARE_AS(bytesAfter, bytesBefore,
+        TestSuite::Compare::Less);
+}
+
+void MeshOptimizerSceneConverterTest::splitSingleConversion() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("splitLargeMeshes", true);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(Primitives::uvSphereSolid(4, 6)));
+    CORRADE_VERIFY(!converter->convertToData(Primitives::uvSphereSolid(4, 6)));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convert(): mesh splitting can't be performed with a single-mesh conversion, use begin(), add() and end() instead\n"
+        "Trade::MeshOptimizerSceneConverter::convertToData(): mesh splitting can't be performed with a single-mesh conversion, use begin(), add() and end() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::splitInvalidCombination() {
+    auto&& data = SplitInvalidCombinationData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("splitLargeMeshes", true);
+    converter->configuration().setValue(data.option, data.value);
+
+    CORRADE_VERIFY(converter->begin());
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(Primitives::uvSphereSolid(4, 6)));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::add(): splitLargeMeshes can't be combined with lodThresholds, shadowMesh or meshlets\n");
+}
+
+void MeshOptimizerSceneConverterTest::split() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("splitLargeMeshes", true);
+
+    MeshData icosphere = Primitives::icosphereSolid(7);
+    CORRADE_COMPARE(icosphere.indexType(), MeshIndexType::UnsignedInt);
+    CORRADE_COMPARE_AS(icosphere.vertexCount(), 65535,
+        TestSuite::Compare::Greater);
+
+    /* Process the mesh without splitting for comparison, the split parts
+       should have the same triangles in the same order */
+    Containers::Optional<MeshData> optimized;
+    {
+        Containers::Pointer<AbstractSceneConverter> referenceConverter = _manager.instantiate("MeshOptimizerSceneConverter");
+        optimized = referenceConverter->convert(icosphere);
+    }
+    CORRADE_VERIFY(optimized);
+    const Containers::Array<UnsignedInt> expectedIndices = optimized->indicesAsArray();
+    const Containers::Array<Vector3> expectedPositions = optimized->positions3DAsArray();
+    const Containers::Array<Vector3> expectedNormals = optimized->normalsAsArray();
+
+    CORRADE_VERIFY(converter->begin());
+    CORRADE_VERIFY(converter->add(icosphere, "Sphere"));
+    Containers::Pointer<AbstractImporter> importer = converter->end();
+    CORRADE_VERIFY(importer);
+    CORRADE_COMPARE_AS(importer->meshCount(), 1,
+        TestSuite::Compare::Greater);
+
+    std::size_t offset = 0;
+    for(UnsignedInt i = 0; i != importer->meshCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(importer->meshName(i), "Sphere");
+        CORRADE_COMPARE(importer->meshLevelCount(i), 1);
+
+        Containers::Optional<MeshData> part = importer->mesh(i);
+        CORRADE_VERIFY(part);
+        CORRADE_COMPARE(part->primitive(), MeshPrimitive::Triangles);
+        CORRADE_COMPARE(part->indexType(), MeshIndexType::UnsignedShort);
+        CORRADE_COMPARE_AS(part->vertexCount(), 65535,
+            TestSuite::Compare::LessOrEqual);
+        CORRADE_COMPARE(part->attributeCount(), icosphere.attributeCount());
+        CORRADE_VERIFY(MeshTools::isInterleaved(*part));
+
+        /* All vertices are referenced, none is left unused or duplicated in
+           a different order */
+        const Containers::ArrayView<const UnsignedShort> indices = part->indices<UnsignedShort>().asContiguous();
+        UnsignedInt maxIndex = 0;
+        for(UnsignedShort index: indices)
+            maxIndex = Math::max(maxIndex, UnsignedInt(index));
+        CORRADE_COMPARE(maxIndex + 1, part->vertexCount());
+
+        /* The triangles are the same as in the unsplit mesh */
+        const Containers::Array<Vector3> positions = part->positions3DAsArray();
+        const Containers::Array<Vector3> normals = part->normalsAsArray();
+        for(std::size_t j = 0; j != indices.size(); ++j) {
+            if(positions[indices[j]] != expectedPositions[expectedIndices[offset + j]] ||
+               normals[indices[j]] != expectedNormals[expectedIndices[offset + j]]) {
+                CORRADE_ITERATION(j);
+                CORRADE_COMPARE(positions[indices[j]], expectedPositions[expectedIndices[offset + j]]);
+                CORRADE_COMPARE(normals[indices[j]], expectedNormals[expectedIndices[offset + j]]);
+            }
+        }
+        offset += indices.size();
+    }
+    CORRADE_COMPARE(offset, expectedIndices.size());
+}
+
+void MeshOptimizerSceneConverterTest::splitFits() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("splitLargeMeshes", true);
+
+    /* A mesh that fits gets just its index type changed */
+    MeshData icosphere = Primitives::icosphereSolid(1);
+    CORRADE_COMPARE(icosphere.indexType(), MeshIndexType::UnsignedInt);
+    /* An 8-bit index type is left as-is */
+    MeshData plane = MeshTools::compressIndices(MeshTools::generateIndices(Primitives::planeSolid()));
+    CORRADE_COMPARE(plane.indexType(), MeshIndexType::UnsignedByte);
+
+    CORRADE_VERIFY(converter->begin());
+    CORRADE_VERIFY(converter->add(icosphere));
+    CORRADE_VERIFY(converter->add(plane));
+    Containers::Pointer<AbstractImporter> importer = converter->end();
+    CORRADE_VERIFY(importer);
+    CORRADE_COMPARE(importer->meshCount(), 2);
+
+    Containers::Optional<MeshData> mesh0 = importer->mesh(0);
+    Containers::Optional<MeshData> mesh1 = importer->mesh(1);
+    CORRADE_VERIFY(mesh0);
+    CORRADE_VERIFY(mesh1);
+    CORRADE_COMPARE(mesh0->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE(mesh0->indexCount(), icosphere.indexCount());
+    CORRADE_COMPARE(mesh0->vertexCount(), icosphere.vertexCount());
+    CORRADE_COMPARE(mesh1->indexType(), MeshIndexType::UnsignedByte);
+}
+
+void MeshOptimizerSceneConverterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> serialConverter = _manager.instantiate("MeshOptimizerSceneConverter");
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("threads", data.threads);
+    converter->configuration().setValue("maxPendingMeshes", data.maxPendingMeshes);
+
+    MeshData meshes[]{
+        Primitives::uvSphereSolid(4, 6),
+        MeshTools::generateIndices(Primitives::planeSolid()),
+        Primitives::icosphereSolid(2),
+        Primitives::uvSphereSolid(8, 12, Primitives::UVSphereFlag::TextureCoordinates),
+        Primitives::icosphereSolid(1),
+    };
+
+    CORRADE_VERIFY(serialConverter->begin());
+    CORRADE_VERIFY(converter->begin());
+    for(std::size_t i = 0; i != Containers::arraySize(meshes); ++i) {
+        /* Every other mesh gets a LOD chain to verify the configuration is
+           taken from the time of add() and not of the processing */
+        const char* lodThresholds = i % 2 ? "0.5" : "";
+        serialConverter->configuration().setValue("lodThresholds", lodThresholds);
+        converter->configuration().setValue("lodThresholds", lodThresholds);
+        CORRADE_VERIFY(serialConverter->add(meshes[i], Utility::format("mesh {}", i)));
+        CORRADE_VERIFY(converter->add(meshes[i], Utility::format("mesh {}", i)));
+    }
+    Containers::Pointer<AbstractImporter> serialImporter = serialConverter->end();
+    Containers::Pointer<AbstractImporter> importer = converter->end();
+    CORRADE_VERIFY(serialImporter);
+    CORRADE_VERIFY(importer);
+
+    /* The output should be the same as with serial processing */
+    CORRADE_COMPARE(importer->meshCount(), Containers::arraySize(meshes));
+    for(UnsignedInt i = 0; i != importer->meshCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(importer->meshName(i), serialImporter->meshName(i));
+        CORRADE_COMPARE(importer->meshLevelCount(i), i % 2 ? 2 : 1);
+        CORRADE_COMPARE(importer->meshLevelCount(i), serialImporter->meshLevelCount(i));
+        for(UnsignedInt level = 0; level != importer->meshLevelCount(i); ++level) {
+            CORRADE_ITERATION(level);
+            Containers::Optional<MeshData> expected = serialImporter->mesh(i, level);
+            Containers::Optional<MeshData> actual = importer->mesh(i, level);
+            CORRADE_VERIFY(expected);
+            CORRADE_VERIFY(actual);
+            CORRADE_COMPARE_AS(actual->indicesAsArray(),
+                expected->indicesAsArray(),
+                TestSuite::Compare::Container);
+            CORRADE_COMPARE_AS(actual->positions3DAsArray(),
+                expected->positions3DAsArray(),
+                TestSuite::Compare::Container);
+        }
+    }
+}
+
+void MeshOptimizerSceneConverterTest::threadsFailed() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("threads", 2);
+    converter->configuration().setValue("maxPendingMeshes", 0);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("lodThresholds", "0.5");
+
+    /* Same as in lodsNoPositions() */
+    const UnsignedByte indexData[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 1};
+
+    CORRADE_VERIFY(converter->begin());
+
+    /* The failure is detected only once the queue gets processed */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(converter->add(Primitives::icosphereSolid(1)));
+    CORRADE_VERIFY(converter->add(mesh));
+    CORRADE_VERIFY(converter->add(mesh));
+    CORRADE_VERIFY(converter->add(Primitives::icosphereSolid(1)));
+    CORRADE_COMPARE(out.str(), "");
+    CORRADE_VERIFY(!converter->end());
+    /* The error is printed for each failed mesh */
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::add(): LOD generation requires the mesh to have positions\n"
+        "Trade::MeshOptimizerSceneConverter::add(): LOD generation requires the mesh to have positions\n"
+        "Trade::MeshOptimizerSceneConverter::end(): processing of a queued mesh failed\n");
+}
+
+void MeshOptimizerSceneConverterTest::threadsFailedQueueFull() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("threads", 2);
+    converter->configuration().setValue("maxPendingMeshes", 2);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("lodThresholds", "0.5");
+
+    /* Same as in lodsNoPositions() */
+    const UnsignedByte indexData[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 1};
+
+    CORRADE_VERIFY(converter->begin());
+
+    /* The second add() fills the queue, processing it and failing. All
+       following operations then fail as well. */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(converter->add(mesh));
+    CORRADE_VERIFY(!converter->add(Primitives::icosphereSolid(1)));
+    CORRADE_VERIFY(!converter->add(Primitives::icosphereSolid(1)));
+    CORRADE_VERIFY(!converter->end());
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::add(): LOD generation requires the mesh to have positions\n"
+        "Trade::MeshOptimizerSceneConverter::add(): processing of a queued mesh failed\n"
+        "Trade::MeshOptimizerSceneConverter::add(): processing of a previously added mesh failed\n"
+        "Trade::MeshOptimizerSceneConverter::end(): processing of a previously added mesh failed\n");
+}
+
+void MeshOptimizerSceneConverterTest::meshletsInPlace() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("meshlets", true);
+
+    MeshData icosphere = Primitives::icosphereSolid(1);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertInPlace(icosphere));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convertInPlace(): meshlet generation can't be performed in-place, use convert() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::meshletsNoPositions() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("meshlets", true);
+
+    const UnsignedByte indexData[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 1};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(mesh));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convert(): meshlet generation requires the mesh to have positions\n");
+}
+
+void MeshOptimizerSceneConverterTest::meshletsInvalidLimits() {
+    auto&& data = MeshletsInvalidLimitsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("meshlets", true);
+    converter->configuration().setValue("meshletMaxVertices", data.maxVertices);
+    converter->configuration().setValue("meshletMaxTriangles", data.maxTriangles);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(Primitives::icosphereSolid(1)));
+    CORRADE_COMPARE(out.str(), Utility::formatString(
+        "Trade::MeshOptimizerSceneConverter::convert(): expected meshletMaxVertices to be between 3 and 255 and meshletMaxTriangles to be a multiple of 4 between 4 and 512, got {} and {}\n", data.maxVertices, data.maxTriangles));
+}
+
+template<class T> void MeshOptimizerSceneConverterTest::meshlets() {
+    setTestCaseTemplateName(Math::TypeTraits<T>::name());
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("meshletMaxVertices", 16);
+    converter->configuration().setValue("meshletMaxTriangles", 8);
+
+    MeshData icosphere = MeshTools::compressIndices(
+        Primitives::icosphereSolid(1),
+        Implementation::meshIndexTypeFor<T>());
+    CORRADE_COMPARE(icosphere.indexCount(), 240);
+
+    /* The same conversion without meshlets, which the meshlets reference */
+    Containers::Optional<MeshData> optimized = converter->convert(icosphere);
+    CORRADE_VERIFY(optimized);
+    const Containers::Array<UnsignedInt> optimizedIndices = optimized->indicesAsArray();
+
+    converter->configuration().setValue("meshlets", true);
+    Containers::Optional<MeshData> meshlets = converter->convert(icosphere);
+    CORRADE_VERIFY(meshlets);
+    CORRADE_COMPARE(meshlets->primitive(), MeshPrimitive::Meshlets);
+    CORRADE_VERIFY(!meshlets->isIndexed());
+    CORRADE_COMPARE(meshlets->attributeCount(), 9);
+    /* 80 triangles, at most 8 triangles per meshlet */
+    CORRADE_COMPARE_AS(meshlets->vertexCount(), 10u,
+        TestSuite::Compare::GreaterOrEqual);
+
+    CORRADE_COMPARE(meshlets->attributeFormat(meshAttributeCustom(0)), VertexFormat::UnsignedInt);
+    CORRADE_COMPARE(meshlets->attributeArraySize(meshAttributeCustom(0)), 16);
+    CORRADE_COMPARE(meshlets->attributeFormat(meshAttributeCustom(1)), VertexFormat::Vector3ub);
+    CORRADE_COMPARE(meshlets->attributeArraySize(meshAttributeCustom(1)), 8);
+    const Containers::StridedArrayView2D<const UnsignedInt> vertices = meshlets->attribute<UnsignedInt[]>(meshAttributeCustom(0));
+    const Containers::StridedArrayView2D<const Vector3ub> triangles = meshlets->attribute<Vector3ub[]>(meshAttributeCustom(1));
+    const Containers::StridedArrayView1D<const UnsignedInt> vertexCounts = meshlets->attribute<UnsignedInt>(meshAttributeCustom(2));
+    const Containers::StridedArrayView1D<const UnsignedInt> triangleCounts = meshlets->attribute<UnsignedInt>(meshAttributeCustom(3));
+    const Containers::StridedArrayView1D<const Vector3> centers = meshlets->attribute<Vector3>(meshAttributeCustom(4));
+    const Containers::StridedArrayView1D<const Float> radii = meshlets->attribute<Float>(meshAttributeCustom(5));
+    CORRADE_COMPARE(meshlets->attributeFormat(meshAttributeCustom(6)), VertexFormat::Vector3);
+    CORRADE_COMPARE(meshlets->attributeFormat(meshAttributeCustom(7)), VertexFormat::Vector3);
+    CORRADE_COMPARE(meshlets->attributeFormat(meshAttributeCustom(8)), VertexFormat::Float);
+
+    /* Reconstructing the triangles from meshlets should give back the
+       original index buffer, triangle by triangle */
+    Containers::Array<UnsignedInt> reconstructed;
+    for(std::size_t i = 0; i != meshlets->vertexCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE_AS(vertexCounts[i], 16u,
+            TestSuite::Compare::LessOrEqual);
+        CORRADE_COMPARE_AS(triangleCounts[i], 8u,
+            TestSuite::Compare::LessOrEqual);
+        CORRADE_COMPARE_AS(radii[i], 0.0f,
+            TestSuite::Compare::Greater);
+        for(std::size_t j = 0; j != triangleCounts[i]; ++j) {
+            for(std::size_t k = 0; k != 3; ++k) {
+                const UnsignedByte index = triangles[i][j][k];
+                CORRADE_COMPARE_AS(UnsignedInt(index), vertexCounts[i],
+                    TestSuite::Compare::Less);
+                arrayAppend(reconstructed, vertices[i][index]);
+            }
+        }
+
+        /* The vertices should be all within the bounding sphere */
+        for(std::size_t j = 0; j != vertexCounts[i]; ++j)
+            CORRADE_COMPARE_AS((optimized->attribute<Vector3>(MeshAttribute::Position)[vertices[i][j]] - centers[i]).length(), radii[i] + 1.0e-5f,
+                TestSuite::Compare::LessOrEqual);
+    }
+    CORRADE_COMPARE(reconstructed.size(), optimizedIndices.size());
+
+    /* Meshlets may reorder triangles but not their contents, so compare
+       sorted triangle sets with the first index rotated to the smallest */
+    const auto canonicalize = [](Containers::ArrayView<UnsignedInt> indices) {
+        Containers::ArrayView<Vector3ui> triangles = Containers::arrayCast<Vector3ui>(indices);
+        for(Vector3ui& triangle: triangles) {
+            while(triangle[0] > triangle[1] || triangle[0] > triangle[2])
+                triangle = {triangle[1], triangle[2], triangle[0]};
+        }
+        std::sort(triangles.begin(), triangles.end(), [](const Vector3ui& a, const Vector3ui& b) {
+            return a[0] < b[0] || (a[0] == b[0] && (a[1] < b[1] || (a[1] == b[1] && a[2] < b[2])));
+        });
+    };
+    Containers::Array<UnsignedInt> expected{NoInit, optimizedIndices.size()};
+    Utility::copy(optimizedIndices, expected);
+    canonicalize(expected);
+    canonicalize(reconstructed);
+    CORRADE_COMPARE_AS(reconstructed, expected,
+        TestSuite::Compare::Container);
+}
+
+
+void MeshOptimizerSceneConverterTest::quantizeInPlace() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("quantizePositions", "half");
+
+    MeshData icosphere = Primitives::icosphereSolid(1);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertInPlace(icosphere));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::convertInPlace(): vertex quantization can't be performed in-place, use convert() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::quantizeInvalidOption() {
+    auto&& data = QuantizeInvalidOptionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue(data.option, "octahedral");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(Primitives::icosphereSolid(1)));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::MeshOptimizerSceneConverter::convert(): {}\n", data.message));
+}
+
+void MeshOptimizerSceneConverterTest::quantizeImplementationSpecificVertexFormat() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("quantizePositions", "half");
+
+    const UnsignedInt indices[]{0, 1, 2};
+    const Vector3 positions[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)},
+            MeshAttributeData{meshAttributeCustom(1), vertexFormatWrap(0xcaca), Containers::arrayView(positions)}
+        }};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(mesh));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::convert(): can't quantize a mesh with an implementation-specific vertex format 0xcaca\n");
+}
+
+void MeshOptimizerSceneConverterTest::quantize() {
+    auto&& data = QuantizeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    MeshData sphere = Primitives::uvSphereSolid(4, 6, Primitives::UVSphereFlag::TextureCoordinates);
+
+    /* Reference conversion without quantization. The quantization is done
+       after vertex cache and overdraw optimization and vertex fetch
+       optimization depends only on the index buffer, so the vertex order
+       is the same. */
+    Containers::Optional<MeshData> reference = converter->convert(sphere);
+    CORRADE_VERIFY(reference);
+
+    converter->configuration().setValue("quantizeNormals", data.normals);
+    converter->configuration().setValue("quantizeTextureCoordinates", "unorm16");
+    converter->configuration().setValue("quantizePositions", "half");
+    Containers::Optional<MeshData> quantized = converter->convert(sphere);
+    CORRADE_VERIFY(quantized);
+    CORRADE_COMPARE(quantized->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3h);
+    CORRADE_COMPARE(quantized->attributeFormat(MeshAttribute::Normal), data.expectedNormalFormat);
+    CORRADE_COMPARE(quantized->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2usNormalized);
+
+    /* All attributes are aligned to four bytes */
+    CORRADE_COMPARE(quantized->attributeOffset(MeshAttribute::Position), 0);
+    CORRADE_COMPARE(quantized->attributeOffset(MeshAttribute::Normal), 8);
+    CORRADE_COMPARE(quantized->attributeOffset(MeshAttribute::TextureCoordinates), data.expectedNormalFormat == VertexFormat::Vector3bNormalized ? 12 : 16);
+    CORRADE_COMPARE_AS(quantized->attributeStride(0), reference->attributeStride(0),
+        TestSuite::Compare::Less);
+
+    CORRADE_COMPARE_AS(quantized->indicesAsArray(),
+        reference->indicesAsArray(),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(quantized->vertexCount(), reference->vertexCount());
+    const Containers::Array<Vector3> positions = quantized->positions3DAsArray();
+    const Containers::Array<Vector3> normals = quantized->normalsAsArray();
+    const Containers::Array<Vector2> textureCoordinates = quantized->textureCoordinates2DAsArray();
+    const Containers::StridedArrayView1D<const Vector3> expectedPositions = reference->attribute<Vector3>(MeshAttribute::Position);
+    const Containers::StridedArrayView1D<const Vector3> expectedNormals = reference->attribute<Vector3>(MeshAttribute::Normal);
+    const Containers::StridedArrayView1D<const Vector2> expectedTextureCoordinates = reference->attribute<Vector2>(MeshAttribute::TextureCoordinates);
+    for(std::size_t i = 0; i != quantized->vertexCount(); ++i) {
+        CORRADE_ITERATION(i);
+        /* Half-floats have 11 bits of mantissa, the sphere is in the
+           [-1, 1] range */
+        CORRADE_COMPARE_AS(Math::abs(positions[i] - expectedPositions[i]).max(), 1.0f/1024.0f,
+            TestSuite::Compare::LessOrEqual);
+        CORRADE_COMPARE_AS(Math::abs(normals[i] - expectedNormals[i]).max(), data.normalDelta,
+            TestSuite::Compare::LessOrEqual);
+        CORRADE_COMPARE_AS(Math::abs(textureCoordinates[i] - expectedTextureCoordinates[i]).max(), 1.0f/65535.0f,
+            TestSuite::Compare::LessOrEqual);
+    }
+}
+
+void MeshOptimizerSceneConverterTest::quantizeTextureCoordinatesOutOfRange() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("quantizeTextureCoordinates", "unorm16");
+
+    const UnsignedInt indices[]{0, 1, 2};
+    const struct Vertex {
+        Vector3 position;
+        Vector2 textureCoordinates;
+    } vertices[]{
+        {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}},
+        {{1.0f, 0.0f, 0.0f}, {1.5f, 0.0f}},
+        {{0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}},
+    };
+    const auto view = Containers::stridedArrayView(vertices);
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, vertices, {
+            MeshAttributeData{MeshAttribute::Position, view.slice(&Vertex::position)},
+            MeshAttributeData{MeshAttribute::TextureCoordinates, view.slice(&Vertex::textureCoordinates)}
+        }};
+
+    std::ostringstream out;
+    Containers::Optional<MeshData> quantized;
+    {
+        Warning redirectWarning{&out};
+        quantized = converter->convert(mesh);
+    }
+    CORRADE_VERIFY(quantized);
+    CORRADE_COMPARE(quantized->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2);
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::convert(): texture coordinates in attribute 1 are outside of the [0, 1] range, not quantizing\n");
+
+    /* With the Quiet flag the warning is suppressed */
+    converter->addFlags(SceneConverterFlag::Quiet);
+    out.str({});
+    {
+        Warning redirectWarning{&out};
+        CORRADE_VERIFY(converter->convert(mesh));
+    }
+    CORRADE_COMPARE(out.str(), "");
+}
+
+void MeshOptimizerSceneConverterTest::quantizeVerbose() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->setFlags(SceneConverterFlag::Verbose);
+    converter->configuration().setValue("quantizeNormals", "snorm8");
+    converter->configuration().setValue("quantizePositions", "half");
+
+    std::ostringstream out;
+    Containers::Optional<MeshData> quantized;
+    {
+        Debug redirectOutput{&out};
+        quantized = converter->convert(Primitives::icosphereSolid(1));
+    }
+    CORRADE_VERIFY(quantized);
+    CORRADE_COMPARE(quantized->attributeStride(0), 12);
+
+    /* The vertex fetch stats should reflect the vertex size going down from
+       24 to 9 bytes (the padding isn't counted) */
+    const std::string output = out.str();
+    const std::size_t bytesFetched = output.find(" bytes fetched\n");
+    CORRADE_VERIFY(bytesFetched != std::string::npos);
+    UnsignedInt before, after;
+    CORRADE_COMPARE(std::sscanf(output.data() + output.rfind('\n', bytesFetched) + 1, "%u -> %u", &before, &after), 2);
+    CORRADE_COMPARE_AS(after, before,
+        TestSuite::Compare::Less);
+}
+
+/* Alternates between two clusters far apart, so the spatial sort has to
+   reorder the points. Object ID is the original vertex index to verify the
+   attributes stayed together. */
+const struct SpatialSortVertex {
+    Vector3 position;
+    UnsignedInt objectId;
+} SpatialSortVertices[]{
+    {{0.0f, 0.0f, 0.0f}, 0},
+    {{100.0f, 0.0f, 0.0f}, 1},
+    {{0.0f, 1.0f, 0.0f}, 2},
+    {{100.0f, 1.0f, 0.0f}, 3},
+    {{1.0f, 0.0f, 0.0f}, 4},
+    {{101.0f, 0.0f, 0.0f}, 5},
+    {{1.0f, 1.0f, 0.0f}, 6},
+    {{101.0f, 1.0f, 0.0f}, 7},
+    {{0.0f, 0.0f, 1.0f}, 8},
+    {{100.0f, 0.0f, 1.0f}, 9},
+    {{0.0f, 1.0f, 1.0f}, 10},
+    {{100.0f, 1.0f, 1.0f}, 11},
+};
+
+void MeshOptimizerSceneConverterTest::spatialSortNoPositions() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+
+    const UnsignedInt objectIds[3]{};
+    MeshData mesh{MeshPrimitive::Points, {}, objectIds, {
+        MeshAttributeData{MeshAttribute::ObjectId, Containers::arrayView(objectIds)}
+    }};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(mesh));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::convert(): spatial sorting requires the mesh to have positions\n");
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortInvalidCombination() {
+    auto&& data = SpatialSortInvalidCombinationData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+    converter->configuration().setValue(data.option, data.value);
+
+    Containers::StridedArrayView1D<const SpatialSortVertex> vertices = SpatialSortVertices;
+    MeshData mesh{MeshPrimitive::Points, {}, SpatialSortVertices, {
+        MeshAttributeData{MeshAttribute::Position, vertices.slice(&SpatialSortVertex::position)}
+    }};
+
+    CORRADE_VERIFY(converter->begin());
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(mesh));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::add(): spatial sorting of point clouds and non-indexed meshes can't be combined with lodThresholds, shadowMesh, meshlets or splitLargeMeshes\n");
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortPoints() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+
+    Containers::StridedArrayView1D<const SpatialSortVertex> vertices = SpatialSortVertices;
+    MeshData mesh{MeshPrimitive::Points, {}, SpatialSortVertices, {
+        MeshAttributeData{MeshAttribute::Position, vertices.slice(&SpatialSortVertex::position)},
+        MeshAttributeData{MeshAttribute::ObjectId, vertices.slice(&SpatialSortVertex::objectId)}
+    }};
+
+    Containers::Optional<MeshData> sorted = converter->convert(mesh);
+    CORRADE_VERIFY(sorted);
+    CORRADE_COMPARE(sorted->primitive(), MeshPrimitive::Points);
+    CORRADE_VERIFY(!sorted->isIndexed());
+    CORRADE_COMPARE(sorted->vertexCount(), mesh.vertexCount());
+
+    /* Each original vertex is present exactly once, with the attributes
+       staying together */
+    const Containers::Array<Vector3> positions = sorted->positions3DAsArray();
+    const Containers::Array<UnsignedInt> objectIds = sorted->objectIdsAsArray();
+    Containers::Array<UnsignedInt> sortedObjectIds{NoInit, objectIds.size()};
+    Utility::copy(objectIds, sortedObjectIds);
+    std::sort(sortedObjectIds.begin(), sortedObjectIds.end());
+    CORRADE_COMPARE_AS(sortedObjectIds,
+        vertices.slice(&SpatialSortVertex::objectId),
+        TestSuite::Compare::Container);
+    for(std::size_t i = 0; i != objectIds.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(positions[i], vertices[objectIds[i]].position);
+    }
+
+    /* The two clusters are no longer interleaved, so there's exactly one
+       transition between them */
+    std::size_t transitions = 0;
+    for(std::size_t i = 1; i != positions.size(); ++i)
+        if((positions[i].x() > 50.0f) != (positions[i - 1].x() > 50.0f))
+            ++transitions;
+    CORRADE_COMPARE(transitions, 1);
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortPointsIndexed() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+
+    const UnsignedShort indices[]{11, 3, 4, 4, 0, 7};
+    Containers::StridedArrayView1D<const SpatialSortVertex> vertices = SpatialSortVertices;
+    MeshData mesh{MeshPrimitive::Points,
+        {}, indices, MeshIndexData{indices},
+        {}, SpatialSortVertices, {
+            MeshAttributeData{MeshAttribute::Position, vertices.slice(&SpatialSortVertex::position)},
+            MeshAttributeData{MeshAttribute::ObjectId, vertices.slice(&SpatialSortVertex::objectId)}
+        }};
+
+    Containers::Optional<MeshData> sorted = converter->convert(mesh);
+    CORRADE_VERIFY(sorted);
+    CORRADE_VERIFY(sorted->isIndexed());
+    CORRADE_COMPARE(sorted->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE(sorted->indexCount(), Containers::arraySize(indices));
+    CORRADE_COMPARE(sorted->vertexCount(), mesh.vertexCount());
+
+    /* The indices are remapped to reference the same vertices as before */
+    const Containers::Array<UnsignedInt> sortedIndices = sorted->indicesAsArray();
+    const Containers::Array<UnsignedInt> objectIds = sorted->objectIdsAsArray();
+    for(std::size_t i = 0; i != sortedIndices.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(objectIds[sortedIndices[i]], indices[i]);
+    }
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortTriangles() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+
+    /* Each three consecutive vertices form a triangle */
+    Containers::StridedArrayView1D<const SpatialSortVertex> vertices = SpatialSortVertices;
+    MeshData mesh{MeshPrimitive::Triangles, {}, SpatialSortVertices, {
+        MeshAttributeData{MeshAttribute::Position, vertices.slice(&SpatialSortVertex::position)},
+        MeshAttributeData{MeshAttribute::ObjectId, vertices.slice(&SpatialSortVertex::objectId)}
+    }};
+
+    Containers::Optional<MeshData> sorted = converter->convert(mesh);
+    CORRADE_VERIFY(sorted);
+    CORRADE_COMPARE(sorted->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(!sorted->isIndexed());
+    CORRADE_COMPARE(sorted->vertexCount(), mesh.vertexCount());
+
+    /* Whole triangles are reordered, vertices inside them are kept in the
+       same order */
+    const Containers::Array<Vector3> positions = sorted->positions3DAsArray();
+    const Containers::Array<UnsignedInt> objectIds = sorted->objectIdsAsArray();
+    Containers::Array<UnsignedInt> sortedObjectIds{NoInit, objectIds.size()};
+    Utility::copy(objectIds, sortedObjectIds);
+    std::sort(sortedObjectIds.begin(), sortedObjectIds.end());
+    CORRADE_COMPARE_AS(sortedObjectIds,
+        vertices.slice(&SpatialSortVertex::objectId),
+        TestSuite::Compare::Container);
+    for(std::size_t i = 0; i != objectIds.size(); i += 3) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(objectIds[i] % 3, 0);
+        CORRADE_COMPARE(objectIds[i + 1], objectIds[i] + 1);
+        CORRADE_COMPARE(objectIds[i + 2], objectIds[i] + 2);
+        CORRADE_COMPARE(positions[i], vertices[objectIds[i]].position);
+    }
+}
+
+void MeshOptimizerSceneConverterTest::stripifyInPlace() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("stripify", true);
+
+    MeshData icosphere = Primitives::icosphereSolid(1);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertInPlace(icosphere));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::convertInPlace(): triangle strip generation can't be performed in-place, use convert() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::stripifyMeshlets() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("stripify", true);
+    converter->configuration().setValue("meshlets", true);
+
+    #if MESHOPTIMIZER_VERSION < 170
+    CORRADE_SKIP("Meshlet generation requires meshoptimizer 0.17 or newer.");
+    #endif
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(Primitives::icosphereSolid(1)));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::convert(): stripify can't be combined with meshlets\n");
+}
+
+/* Turns a triangle strip into a list of triangles, each rotated to have the
+   smallest index first to preserve the winding, and sorted */
+Containers::Array<Vector3ui> stripTriangles(const Containers::ArrayView<const UnsignedInt> strip, const UnsignedInt restartIndex) {
+    Containers::Array<Vector3ui> triangles;
+    std::size_t stripBegin = 0;
+    for(std::size_t i = 0; i != strip.size(); ++i) {
+        if(strip[i] == restartIndex) {
+            stripBegin = i + 1;
+            continue;
+        }
+        if(i < stripBegin + 2)
+            continue;
+
+        Vector3ui triangle{strip[i - 2], strip[i - 1], strip[i]};
+        if((i - stripBegin) % 2)
+            std::swap(triangle[1], triangle[2]);
+        /* Skip degenerate triangles */
+        if(triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2])
+            continue;
+        while(triangle[0] > triangle[1] || triangle[0] > triangle[2])
+            triangle = {triangle[1], triangle[2], triangle[0]};
+        arrayAppend(triangles, triangle);
+    }
+
+    std::sort(triangles.begin(), triangles.end(), [](const Vector3ui& a, const Vector3ui& b) {
+        return std::make_tuple(a[0], a[1], a[2]) < std::make_tuple(b[0], b[1], b[2]);
+    });
+    return triangles;
+}
+
+template<class T> void MeshOptimizerSceneConverterTest::stripify() {
+    auto&& data = StripifyData[testCaseInstanceId()];
+    setTestCaseTemplateName(Math::TypeTraits<T>::name());
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    /* Few enough vertices to fit into 8-bit indices with the maximum value
+       still available for the restart index */
+    MeshData sphere = MeshTools::compressIndices(Primitives::uvSphereSolid(8, 16), Implementation::meshIndexTypeFor<T>());
+    CORRADE_COMPARE_AS(sphere.vertexCount(), 255,
+        TestSuite::Compare::Less);
+
+    /* Reference triangle list to compare against. Vertex cache optimization
+       for strips orders the triangles differently, which would then result
+       in a different vertex order after vertex fetch optimization, so it's
+       disabled for both. */
+    converter->configuration().setValue("optimizeVertexCache", false);
+    Containers::Optional<MeshData> list = converter->convert(sphere);
+    CORRADE_VERIFY(list);
+    CORRADE_COMPARE(list->primitive(), MeshPrimitive::Triangles);
+
+    converter->configuration().setValue("stripify", true);
+    converter->configuration().setValue("stripifyRestart", data.restart);
+    Containers::Optional<MeshData> strip = converter->convert(sphere);
+    CORRADE_VERIFY(strip);
+    CORRADE_COMPARE(strip->primitive(), MeshPrimitive::TriangleStrip);
+    CORRADE_COMPARE(strip->indexType(), Implementation::meshIndexTypeFor<T>());
+    CORRADE_COMPARE_AS(strip->indexCount(), list->indexCount(),
+        TestSuite::Compare::Less);
+    CORRADE_COMPARE(strip->vertexCount(), list->vertexCount());
+
+    const Containers::Array<UnsignedInt> stripIndices = strip->indicesAsArray();
+    const UnsignedInt restartIndex = T(~T{});
+    const bool hasRestart = std::find(stripIndices.begin(), stripIndices.end(), restartIndex) != stripIndices.end();
+    CORRADE_COMPARE(hasRestart, data.restart);
+
+    /* The strip describes the same triangles with the same winding */
+    const Containers::Array<UnsignedInt> listIndices = list->indicesAsArray();
+    Containers::Array<Vector3ui> expected;
+    for(std::size_t i = 0; i != listIndices.size(); i += 3) {
+        Vector3ui triangle{listIndices[i], listIndices[i + 1], listIndices[i + 2]};
+        while(triangle[0] > triangle[1] || triangle[0] > triangle[2])
+            triangle = {triangle[1], triangle[2], triangle[0]};
+        arrayAppend(expected, triangle);
+    }
+    std::sort(expected.begin(), expected.end(), [](const Vector3ui& a, const Vector3ui& b) {
+        return std::make_tuple(a[0], a[1], a[2]) < std::make_tuple(b[0], b[1], b[2]);
+    });
+    CORRADE_COMPARE_AS(stripTriangles(stripIndices, restartIndex),
+        expected,
+        TestSuite::Compare::Container);
+
+    /* The vertex data are the same */
+    CORRADE_COMPARE_AS(strip->positions3DAsArray(),
+        list->positions3DAsArray(),
+        TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::stripifyNotShorter() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("stripify", true);
+    converter->setFlags(SceneConverterFlag::Verbose);
+
+    /* A single triangle is three indices both as a list and as a strip */
+    const UnsignedInt indices[]{0, 1, 2};
+    const Vector3 positions[]{{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}
+        }};
+
+    std::ostringstream out;
+    Containers::Optional<MeshData> converted;
+    {
+        Debug redirectOutput{&out};
+        converted = converter->convert(mesh);
+    }
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(converted->indexCount(), 3);
+    CORRADE_COMPARE_AS(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convert(): triangle strip would have 3 indices out of 3, keeping a triangle list\n",
+        TestSuite::Compare::StringHasSuffix);
+}
+
+void MeshOptimizerSceneConverterTest::encodeLods() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("lodThresholds", "0.5");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(Primitives::icosphereSolid(1)));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::convertToData(): LOD generation can't be performed with a single-mesh conversion, use begin(), add() and end() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::encodeMeshlets() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("meshlets", true);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(Primitives::icosphereSolid(1)));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::convertToData(): meshlet generation can't be combined with encoding to data, use convert() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::encodeSpatialSort() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+
+    Containers::StridedArrayView1D<const SpatialSortVertex> vertices = SpatialSortVertices;
+    MeshData mesh{MeshPrimitive::Points, {}, SpatialSortVertices, {
+        MeshAttributeData{MeshAttribute::Position, vertices.slice(&SpatialSortVertex::position)}
+    }};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(mesh));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::convertToData(): spatially sorted point clouds and non-indexed meshes can't be encoded to data, use convert() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::encodeStripify() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("stripify", true);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(Primitives::icosphereSolid(1)));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::convertToData(): triangle strips can't be encoded to data, use convert() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::encodeImplementationSpecificVertexFormat() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    const UnsignedInt indices[]{0, 1, 2};
+    const Vector3 positions[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)},
+            MeshAttributeData{meshAttributeCustom(1), vertexFormatWrap(0xcaca), Containers::arrayView(positions)}
+        }};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(mesh));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::convertToData(): can't encode attribute 1 with an implementation-specific vertex format 0xcaca\n");
+}
+
+template<class T> void MeshOptimizerSceneConverterTest::encode() {
+    setTestCaseTemplateName(Math::TypeTraits<T>::name());
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    /* Positions, normals and texture coordinates plus a custom Vector2ub
+       attribute, giving a 34-byte vertex that has to be padded to 36 */
+    MeshData sphere = MeshTools::compressIndices(Primitives::uvSphereSolid(4, 6, Primitives::UVSphereFlag::TextureCoordinates), Implementation::meshIndexTypeFor<T>());
+    Containers::Array<Vector2ub> colors{ValueInit, sphere.vertexCount()};
+    for(std::size_t i = 0; i != colors.size(); ++i)
+        colors[i] = {UnsignedByte(i), UnsignedByte(255 - i)};
+    MeshData mesh = MeshTools::interleave(sphere, {
+        MeshAttributeData{meshAttributeCustom(3), Containers::arrayView(colors)}
+    });
+    CORRADE_COMPARE(mesh.attributeStride(0), 34);
+
+    Containers::Optional<Containers::Array<char>> data = converter->convertToData(mesh);
+    CORRADE_VERIFY(data);
+    CORRADE_COMPARE_AS(data->size(), sizeof(Implementation::MeshOptimizerHeader) + 4*sizeof(Implementation::MeshOptimizerAttribute),
+        TestSuite::Compare::Greater);
+
+    const auto& header = *reinterpret_cast<const Implementation::MeshOptimizerHeader*>(data->data());
+    CORRADE_COMPARE((Containers::StringView{header.magic, 4}), "MOPT");
+    CORRADE_COMPARE(header.version, 1);
+    CORRADE_COMPARE(MeshPrimitive(header.primitive), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(MeshIndexType(header.indexType), Implementation::meshIndexTypeFor<T>());
+    CORRADE_COMPARE(header.indexCount, mesh.indexCount());
+    CORRADE_COMPARE(header.vertexCount, mesh.vertexCount());
+    CORRADE_COMPARE(header.vertexStride, 36);
+    CORRADE_COMPARE(header.attributeCount, 4);
+    CORRADE_COMPARE(data->size(), sizeof(Implementation::MeshOptimizerHeader) + 4*sizeof(Implementation::MeshOptimizerAttribute) + header.indexDataSize + header.vertexDataSize);
+
+    const auto attributes = Containers::arrayCast<const Implementation::MeshOptimizerAttribute>(data->sliceSize(sizeof(Implementation::MeshOptimizerHeader), 4*sizeof(Implementation::MeshOptimizerAttribute)));
+    CORRADE_COMPARE(MeshAttribute(attributes[0].name), MeshAttribute::Position);
+    CORRADE_COMPARE(VertexFormat(attributes[0].format), VertexFormat::Vector3);
+    CORRADE_COMPARE(attributes[0].offset, 0);
+    CORRADE_COMPARE(MeshAttribute(attributes[3].name), meshAttributeCustom(3));
+    CORRADE_COMPARE(VertexFormat(attributes[3].format), VertexFormat::Vector2ub);
+    CORRADE_COMPARE(attributes[3].offset, 32);
+    CORRADE_COMPARE(attributes[3].arraySize, 0);
+}
+
+void MeshOptimizerSceneConverterTest::encodeNoAttributes() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    /* These need positions */
+    converter->configuration().setValue("optimizeOverdraw", false);
+
+    const UnsignedShort indices[]{0, 1, 2, 2, 1, 3};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices}, 4};
+    CORRADE_COMPARE(mesh.attributeCount(), 0);
+
+    Containers::Optional<Containers::Array<char>> data = converter->convertToData(mesh);
+    CORRADE_VERIFY(data);
+
+    const auto& header = *reinterpret_cast<const Implementation::MeshOptimizerHeader*>(data->data());
+    CORRADE_COMPARE(header.indexCount, 6);
+    CORRADE_COMPARE(header.vertexCount, 4);
+    CORRADE_COMPARE(header.vertexStride, 0);
+    CORRADE_COMPARE(header.attributeCount, 0);
+    CORRADE_COMPARE(header.vertexDataSize, 0);
+    CORRADE_COMPARE(data->size(), sizeof(Implementation::MeshOptimizerHeader) + header.indexDataSize);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::MeshOptimizerSceneConverterTest)
@@ -24,3 +24,4 @@
 */
 
 #cmakedefine MAGNUM_MESHOPTIMIZERSCENECONVERTER_BUILD_STATIC
+#cmakedefine MAGNUM_MESHOPTIMIZERSCENECONVERTER_WITH_TRACY_ZONES
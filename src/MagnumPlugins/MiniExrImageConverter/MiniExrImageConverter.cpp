@@ -25,13 +25,17 @@
 
 #include "MiniExrImageConverter.h"
 
-#include <cstdlib> /* std::free() */
+#include <thread>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/String.h>
-#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
+
+#include "Magnum/Implementation/instrumentation.h"
 
 #ifdef CORRADE_TARGET_CLANG
 #pragma GCC diagnostic push
@@ -62,6 +66,7 @@ Containers::String MiniExrImageConverter::doMimeType() const {
 }
 
 Containers::Optional<Containers::Array<char>> MiniExrImageConverter::doConvertToData(const ImageView2D& image) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
     /* Warn about lost metadata */
     if((image.flags() & ImageFlag2D::Array) && !(flags() & ImageConverterFlag::Quiet)) {
         Warning{} << "Trade::MiniExrImageConverter::convertToData(): 1D array images are unrepresentable in OpenEXR, saving as a regular 2D image";
@@ -76,26 +81,44 @@ Containers::Optional<Containers::Array<char>> MiniExrImageConverter::doConvertTo
             return {};
     }
 
-    /* Copy image pixels to a tightly-packed array with rows flipped.
-       Unfortunately there's no way to specify arbitrary strides, for Y
-       flipping there's stbi_flip_vertically_on_write() but since we have to
-       do a copy anyway we can flip during that as well. */
-    Containers::Array<char> flippedPackedData{NoInit, image.pixelSize()*image.size().product()};
-    Utility::copy(image.pixels().flipped<0>(), Containers::StridedArrayView3D<char>{flippedPackedData, {
-        std::size_t(image.size().y()),
-        std::size_t(image.size().x()),
-        image.pixelSize(),
-    }});
-
-    std::size_t size;
-    unsigned char* const data = miniexr_write(image.size().x(), image.size().y(), components, flippedPackedData, &size);
-    CORRADE_INTERNAL_ASSERT(data);
-
-    /* miniexr uses malloc to allocate and since we can't use custom deleters,
-       copy the result into a new-allocated array instead */
-    Containers::Array<char> fileData{NoInit, size};
-    Utility::copy(Containers::arrayView(reinterpret_cast<const char*>(data), size), fileData);
-    std::free(data);
+    /* The half-float data are written directly from the input view with rows
+       flipped, avoiding an intermediate tightly-packed copy, and into a
+       new-allocated array, avoiding a copy of the malloc()'d output from
+       miniexr_write(). The channels are still expected to be tightly packed
+       in each pixel, which is always the case for RGB16F / RGBA16F. */
+    const Containers::StridedArrayView3D<const char> pixels = image.pixels().flipped<0>();
+    CORRADE_INTERNAL_ASSERT(pixels.isContiguous<2>());
+    const unsigned width = image.size().x();
+    const unsigned height = image.size().y();
+    Containers::Array<char> fileData{NoInit, miniexr_size(width, height)};
+    unsigned char* const out = reinterpret_cast<unsigned char*>(fileData.data());
+    miniexr_write_header(width, height, out);
+
+    /* Each scanline is independent, so they can be written on multiple
+       threads, each working on a contiguous block of rows */
+    std::size_t threadCount = 1;
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = Math::max(Math::min(threadCount, std::size_t(height)), std::size_t{1});
+    #endif
+    const auto write = [&](const std::size_t i) {
+        miniexr_write_scanlines(width, height,
+            height*i/threadCount, height*(i + 1)/threadCount,
+            pixels.data(), pixels.stride()[1], pixels.stride()[0], out);
+    };
+
+    /* The calling thread is one of the workers */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::size_t i = 0; i != threads.size(); ++i)
+        threads[i] = std::thread{write, i + 1};
+    write(0);
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    write(0);
+    #endif
 
     /* GCC 4.8 needs extra help here */
     return Containers::optional(Utility::move(fileData));
@@ -116,6 +116,15 @@ See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 @section Trade-MiniExrImageConverter-behavior Behavior and limitations
 
 The output is always uncompressed, only half-float RGB and RGBA is supported.
+Alpha channel, if present, is ignored. The half-float data are written
+directly from the input image without any intermediate conversion or copy,
+and arbitrary pixel and row strides of the input are supported.
+
+Each scanline is written independently. Setting the @cb{.ini} threads @ce
+option to a value other than @cpp 1 @ce splits the image into contiguous
+blocks of rows that are written on multiple threads. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+application has to be linked to `pthread` on Linux for this to work.
 
 The OpenEXR file format doesn't have a way to distinguish between 2D and 1D
 array images. If an image has @ref ImageFlag2D::Array set, a warning is printed
@@ -126,6 +135,16 @@ As OpenEXR doesn't have a registered MIME type, @ref mimeType() returns
 
 The plugin recognizes @ref ImageConverterFlag::Quiet, which will cause all
 conversion warnings to be suppressed.
+
+@section Trade-MiniExrImageConverter-configuration Plugin-specific configuration
+
+It's possible to tune various options through @ref configuration(). See below
+for all options and their default values:
+
+@snippet MagnumPlugins/MiniExrImageConverter/MiniExrImageConverter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_MINIEXRIMAGECONVERTER_EXPORT MiniExrImageConverter: public AbstractImageConverter {
     public:
@@ -29,6 +29,7 @@
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/Path.h>
@@ -48,6 +49,7 @@ struct MiniExrImageConverterTest: TestSuite::Tester {
 
     void rgb();
     void rgba();
+    void threads();
 
     void unsupportedMetadata();
 
@@ -67,12 +69,26 @@ const struct {
         nullptr},
 };
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+} ThreadsData[]{
+    {"single thread", 1},
+    {"two threads", 2},
+    {"as many threads as rows", 3},
+    {"more threads than rows", 7},
+    {"hardware concurrency", 0},
+};
+
 MiniExrImageConverterTest::MiniExrImageConverterTest() {
     addTests({&MiniExrImageConverterTest::wrongFormat,
 
               &MiniExrImageConverterTest::rgb,
               &MiniExrImageConverterTest::rgba});
 
+    addInstancedTests({&MiniExrImageConverterTest::threads},
+        Containers::arraySize(ThreadsData));
+
     addInstancedTests({&MiniExrImageConverterTest::unsupportedMetadata},
         Containers::arraySize(UnsupportedMetadataData));
 
@@ -136,6 +152,22 @@ void MiniExrImageConverterTest::rgba() {
         TestSuite::Compare::StringToFile);
 }
 
+void MiniExrImageConverterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("MiniExrImageConverter");
+    converter->configuration().setValue("threads", data.threads);
+
+    /* The output should be the same regardless of the thread count. On
+       Emscripten without threads, the option is ignored. */
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(Rgb);
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE_AS(Containers::StringView{*out},
+        Utility::Path::join(MINIEXRIMAGECONVERTER_TEST_DIR, "image.exr"),
+        TestSuite::Compare::StringToFile);
+}
+
 void MiniExrImageConverterTest::unsupportedMetadata() {
     auto&& data = UnsupportedMetadataData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
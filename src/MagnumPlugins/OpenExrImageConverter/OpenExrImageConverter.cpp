@@ -26,6 +26,9 @@
 #include "OpenExrImageConverter.h"
 
 #include <thread> /* std::thread::hardware_concurrency(), sigh */
+#ifdef CORRADE_BUILD_MULTITHREADED
+#include <mutex>
+#endif
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/StridedArrayView.h>
@@ -37,6 +40,8 @@
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/ConfigurationValue.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
 /* OpenEXR as a CMake subproject adds the OpenEXR/ directory to include path
    but not the parent directory, so we can't #include <OpenEXR/blah>. This
    can't really be fixed from outside, so unfortunately we have to do the same
@@ -54,6 +59,13 @@ using namespace Containers::Literals;
 
 namespace {
 
+#ifdef CORRADE_BUILD_MULTITHREADED
+std::mutex& globalThreadPoolMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+#endif
+
 /* Unlike IStream, this does not have an example snippet in the PDF so I just
    hope I'm not doing something extremely silly. */
 class MemoryOStream: public Imf::OStream {
@@ -102,7 +114,7 @@ Containers::String OpenExrImageConverter::doMimeType() const {
 
 namespace {
 
-Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utility::ConfigurationGroup& configuration, const ImageConverterFlags flags, const PixelFormat format, const ImageFlags3D imageFlags, const Int levelCount, void(*const preparePixelsForLevel)(Int, const Containers::StridedArrayView3D<char>&, void*), const Containers::StridedArrayView3D<char>& pixels, void* const state) try {
+Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utility::ConfigurationGroup& configuration, const ImageConverterFlags flags, const PixelFormat format, const ImageFlags3D imageFlags, const Int levelCount, Containers::StridedArrayView3D<const char>(*const pixelsForLevel)(Int, void*), void* const state) try {
     /* Figure out type and channel count */
     Imf::PixelType type;
     std::size_t channelCount;
@@ -181,13 +193,26 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
         compression = Imf::DWAA_COMPRESSION;
     else if(compressionString == "dwab"_s)
         compression = Imf::DWAB_COMPRESSION;
+    /* High-throughput JPEG 2000, lossless, available since 3.4 */
+    #if OPENEXR_VERSION_MAJOR*10000 + OPENEXR_VERSION_MINOR*100 + OPENEXR_VERSION_PATCH >= 30400
+    else if(compressionString == "htj2k256"_s)
+        compression = Imf::HTJ2K256_COMPRESSION;
+    else if(compressionString == "htj2k32"_s)
+        compression = Imf::HTJ2K32_COMPRESSION;
+    #endif
     /* LCOV_EXCL_STOP */
     else {
-        Error{} << "Trade::OpenExrImageConverter::convertToData(): unknown compression" << compressionString << Debug::nospace << ", allowed values are rle, zip, zips, piz, pxr24, b44, b44a, dwaa, dwab or empty for uncompressed output";
+        Error{} << "Trade::OpenExrImageConverter::convertToData(): unknown compression" << compressionString << Debug::nospace << ", allowed values are rle, zip, zips, piz, pxr24, b44, b44a, dwaa, dwab"
+            #if OPENEXR_VERSION_MAJOR*10000 + OPENEXR_VERSION_MINOR*100 + OPENEXR_VERSION_PATCH >= 30400
+            << Debug::nospace << ", htj2k256, htj2k32"
+            #endif
+            << "or empty for uncompressed output";
         return {};
     }
 
-    /* Data window */
+    /* Data window, taken from the first level. The pixels are assumed to be
+       ready only after pixelsForLevel() is called for given level. */
+    const Containers::StridedArrayView3D<const char> pixels = pixelsForLevel(0, state);
     const Vector2i imageSize{Int(pixels.size()[1]), Int(pixels.size()[0])};
     const Vector2i dataOffsetMin = configuration.value<Vector2i>("dataOffset");
     const Vector2i dataOffsetMax = dataOffsetMin + imageSize - Vector2i{1};
@@ -252,7 +277,8 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
         2, /* HALF */
         4  /* FLOAT */
     };
-    Imf::FrameBuffer framebuffer;
+    std::string channelNames[Containers::arraySize(ChannelOptions)];
+    bool hasChannels = false;
     for(std::size_t i = 0; i != channelCount; ++i) {
         std::string name = configuration.value(ChannelOptions[i]);
         if(name.empty()) continue;
@@ -264,29 +290,18 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
            accidentally supply the same channel twice, it'll get ignored ... or
            maybe it overwrites the previous one. Not sure. Neither behavior
            seems desirable, so let's fail on that. */
-        if(framebuffer.findSlice(name)) {
+        for(std::size_t j = 0; j != i; ++j) if(channelNames[j] == name) {
             Error{} << "Trade::OpenExrImageConverter::convertToData(): duplicate mapping for channel" << name;
             return {};
         }
 
         header.channels().insert(name, Imf::Channel{type});
-        framebuffer.insert(name, Imf::Slice{
-            type,
-            const_cast<char*>(static_cast<const char*>(pixels.data()))
-                /* For some strange reason I have to supply a pointer to the
-                   first pixel ever, not the first pixel inside the data
-                   window */
-                - dataOffsetMin.y()*std::size_t(pixels.stride()[0])
-                - dataOffsetMin.x()*std::size_t(pixels.stride()[1])
-                /* And an offset to this channel, as they're interleaved */
-                + i*ChannelSizes[type],
-            std::size_t(pixels.stride()[1]),
-            std::size_t(pixels.stride()[0])
-        });
+        channelNames[i] = Utility::move(name);
+        hasChannels = true;
     }
 
     /* There should be at least one channel written */
-    if(framebuffer.begin() == framebuffer.end()) {
+    if(!hasChannels) {
         Error{} << "Trade::OpenExrImageConverter::convertToData(): no channels assigned in plugin configuration";
         return {};
     }
@@ -299,12 +314,56 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
         if(flags & ImageConverterFlag::Verbose)
             Debug{} << "Trade::OpenExrImageConverter::convertToData(): autodetected hardware concurrency to" << threadCount << "threads";
     }
-    if(Imf::globalThreadCount() < threadCount - 1) {
-        if(flags & ImageConverterFlag::Verbose)
-            Debug{} << "Trade::OpenExrImageConverter::convertToData(): increasing global OpenEXR thread pool from" << Imf::globalThreadCount() << "to" << threadCount - 1 << "extra worker threads";
-        Imf::setGlobalThreadCount(threadCount - 1);
+    {
+        /* The check and the resize has to be done atomically, otherwise two
+           converters running concurrently could both decide to resize the
+           pool, with the smaller size winning */
+        #ifdef CORRADE_BUILD_MULTITHREADED
+        std::lock_guard<std::mutex> lock{globalThreadPoolMutex()};
+        #endif
+        if(Imf::globalThreadCount() < threadCount - 1) {
+            if(!configuration.value<bool>("resizeGlobalThreadPool")) {
+                if(flags & ImageConverterFlag::Verbose)
+                    Debug{} << "Trade::OpenExrImageConverter::convertToData(): not resizing the global OpenEXR thread pool, which has" << Imf::globalThreadCount() << "extra worker threads";
+            } else {
+                if(flags & ImageConverterFlag::Verbose)
+                    Debug{} << "Trade::OpenExrImageConverter::convertToData(): increasing global OpenEXR thread pool from" << Imf::globalThreadCount() << "to" << threadCount - 1 << "extra worker threads";
+                Imf::setGlobalThreadCount(threadCount - 1);
+            }
+        }
     }
 
+    /* Each level can be a view with a different base pointer and strides, so
+       the framebuffer is set up for each separately */
+    const auto framebufferForPixels = [&](const Containers::StridedArrayView3D<const char>& levelPixels) {
+        Imf::FrameBuffer framebuffer;
+        for(std::size_t i = 0; i != channelCount; ++i) {
+            if(channelNames[i].empty()) continue;
+
+            framebuffer.insert(channelNames[i], Imf::Slice{
+                type,
+                const_cast<char*>(static_cast<const char*>(levelPixels.data()))
+                    /* For some strange reason I have to supply a pointer to
+                       the first pixel ever, not the first pixel inside the
+                       data window */
+                    - dataOffsetMin.y()*levelPixels.stride()[0]
+                    - dataOffsetMin.x()*levelPixels.stride()[1]
+                    /* And an offset to this channel, as they're
+                       interleaved */
+                    + i*ChannelSizes[type],
+                std::size_t(levelPixels.stride()[1]),
+                /* The row stride is negative for Y-flipped views. OpenEXR
+                   takes an unsigned value but uses it only to calculate row
+                   pointers, so the wraparound gives the right address. The
+                   same doesn't work for the pixel stride, as the copy loop
+                   inside compares the row start and end pointers, but that
+                   one is never negative here. */
+                std::size_t(levelPixels.stride()[0])
+            });
+        }
+        return framebuffer;
+    };
+
     /* Play it safe and destruct everything before we touch the array */
     Containers::Array<char> data;
     {
@@ -314,11 +373,7 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
            wasn't forced to be tiled. */
         if(levelCount == 1 && !configuration.value<bool>("forceTiledOutput")) {
             Imf::OutputFile file{stream, header, threadCount - 1};
-            file.setFrameBuffer(framebuffer);
-
-            /* For consistency, the pixels are assumed to be ready only after
-               the prepareLevel() is called also in the single-level case */
-            preparePixelsForLevel(0, pixels, state);
+            file.setFrameBuffer(framebufferForPixels(pixels));
             file.writePixels(imageSize.y());
 
         /* Tiled output */
@@ -335,7 +390,6 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
                 Imf::ROUND_DOWN}); /** @todo configurable? can't use a >> 1 then */
 
             Imf::TiledOutputFile file{stream, header, threadCount - 1};
-            file.setFrameBuffer(framebuffer);
 
             /* There doesn't seem to be a way to set level count, it's
                implicitly from the base size and rounding mode. For sanity
@@ -350,7 +404,7 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
                levels are each 2x smaller with ROUND_DOWN, the callers are
                checking for that to prevent garbled output. */
             for(Int level = 0; level != levelCount; ++level) {
-                preparePixelsForLevel(level, pixels, state);
+                file.setFrameBuffer(framebufferForPixels(level ? pixelsForLevel(level, state) : pixels));
                 file.writeTiles(0, file.numXTiles(level) - 1, 0, file.numYTiles(level) - 1, level);
             }
         }
@@ -374,6 +428,7 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
 }
 
 Containers::Optional<Containers::Array<char>> OpenExrImageConverter::doConvertToData(const Containers::ArrayView<const ImageView2D> imageLevels) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
     /* Warn about lost metadata */
     if((imageLevels[0].flags() & ImageFlag2D::Array) && !(flags() & ImageConverterFlag::Quiet)) {
         Warning{} << "Trade::OpenExrImageConverter::convertToData(): 1D array images are unrepresentable in OpenEXR, saving as a regular 2D image";
@@ -405,38 +460,25 @@ Containers::Optional<Containers::Array<char>> OpenExrImageConverter::doConvertTo
         }
     }
 
-    /* According to my tests, Y flip could be done during image writing the
-       same as when reading by supplying `std::size_t(-rowStride)`, as
-       described in OpenExrImporter::doImage2D(). However, again, although it
-       requires allocating a copy to perform the manual flip, I think it's the
-       saner approach after all. */
+    /* The Y flip is done by OpenEXR itself, by passing it a view with a
+       negative row stride, the same as when reading as described in
+       OpenExrImporter::doImage2D(). This avoids an intermediate copy of each
+       level and works with arbitrary row padding and other pixel storage
+       parameters as well. */
     struct State {
         Containers::ArrayView<const ImageView2D> imageLevels;
-        Containers::Array<char> flippedData;
-    } state{
-        imageLevels,
-        Containers::Array<char>{NoInit, std::size_t(imageLevels[0].size().product()*imageLevels[0].pixelSize())},
-    };
-    const Containers::StridedArrayView3D<char> flippedPixels{state.flippedData, {
-        std::size_t(imageLevels[0].size().y()),
-        std::size_t(imageLevels[0].size().x()),
-        /* pixels() returns a zero stride if the view is empty, do that here as
-           well to avoid hitting an assert inside copy() */
-        /** @todo why?! figure out and fix */
-        imageLevels[0].size().isZero() ? 0 : imageLevels[0].pixelSize()
-    }};
+    } state{imageLevels};
     /* Future-proofing and passing image flags even in case of 2D where
        currently nothing is taken into account. But e.g. Premultiplied might,
        eventually. */
-    return convertToDataInternal(configuration(), flags(), imageLevels[0].format(), ImageFlag3D(UnsignedShort(imageLevels[0].flags())), imageLevels.size(), [](Int level, const Containers::StridedArrayView3D<char>& flippedPixels, void* const data) {
-        State& state = *reinterpret_cast<State*>(data);
-        const Containers::StridedArrayView3D<const char> pixels = state.imageLevels[level].pixels();
-        const Containers::StridedArrayView3D<char> flippedPixelsForLevel = flippedPixels.prefix(pixels.size());
-        Utility::copy(pixels.flipped<0>(), flippedPixelsForLevel);
-    }, flippedPixels, &state);
+    return convertToDataInternal(configuration(), flags(), imageLevels[0].format(), ImageFlag3D(UnsignedShort(imageLevels[0].flags())), imageLevels.size(), [](Int level, void* const data) {
+        const State& state = *reinterpret_cast<const State*>(data);
+        return state.imageLevels[level].pixels().flipped<0>();
+    }, &state);
 }
 
 Containers::Optional<Containers::Array<char>> OpenExrImageConverter::doConvertToData(const Containers::ArrayView<const ImageView3D> imageLevels) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
     /* Only cube map saving is supported right now, no deep data. If the
        CubeMap flag is present, it also means the images are square and have
        six faces, so we don't need to test that here again. */
@@ -507,16 +549,20 @@ Containers::Optional<Containers::Array<char>> OpenExrImageConverter::doConvertTo
         imageLevels,
         Containers::Array<char>{NoInit, std::size_t(imageLevels[0].size().product()*imageLevels[0].pixelSize())}
     };
-    /* A 2D framebuffer for OpenEXR. From this we have to recreate a 3D view
-       every time to access particular layers. Can't create a 3D view upfront
-       and slice it because it has to be contiguous in Y. */
-    Containers::StridedArrayView3D<char> flippedPixelsFlattened{state.flippedData, {
-        std::size_t(imageLevels[0].size().z()*imageLevels[0].size().y()),
-        std::size_t(imageLevels[0].size().x()),
-        imageLevels[0].pixelSize()
-    }};
-    return convertToDataInternal(configuration(), flags(), imageLevels[0].format(), imageLevels[0].flags(), imageLevels.size(), [](const Int level, const Containers::StridedArrayView3D<char>& flippedPixelsFlattened, void* const data) {
+    return convertToDataInternal(configuration(), flags(), imageLevels[0].format(), imageLevels[0].flags(), imageLevels.size(), [](const Int level, void* const data) -> Containers::StridedArrayView3D<const char> {
         State& state = *reinterpret_cast<State*>(data);
+
+        /* A 2D framebuffer for OpenEXR. From this we have to recreate a 3D
+           view every time to access particular layers. Can't create a 3D view
+           upfront and slice it because it has to be contiguous in Y. All
+           levels use the row stride of the first level, the same base
+           pointer thus works for all of them. */
+        const Containers::StridedArrayView3D<char> flippedPixelsFlattened{state.flippedData, {
+            std::size_t(state.imageLevels[0].size().z()*state.imageLevels[0].size().y()),
+            std::size_t(state.imageLevels[0].size().x()),
+            state.imageLevels[0].pixelSize()
+        }};
+
         const Containers::StridedArrayView4D<const char> pixels = state.imageLevels[level].pixels();
         const Containers::StridedArrayView4D<char> flippedPixelsForLevel{
             state.flippedData,
@@ -532,7 +578,13 @@ Containers::Optional<Containers::Array<char>> OpenExrImageConverter::doConvertTo
         Utility::copy(pixels[3].flipped<0>(), flippedPixelsForLevel[3]);
         Utility::copy(pixels[4].flipped<1>(), flippedPixelsForLevel[4]);
         Utility::copy(pixels[5].flipped<1>(), flippedPixelsForLevel[5]);
-    }, flippedPixelsFlattened, &state);
+
+        return flippedPixelsFlattened.prefix({
+            pixels.size()[0]*pixels.size()[1],
+            pixels.size()[2],
+            pixels.size()[3]
+        });
+    }, &state);
 }
 
 }}
@@ -132,6 +132,11 @@ As OpenEXR doesn't have a registered MIME type, @ref mimeType() returns
 The plugin recognizes @ref ImageConverterFlag::Quiet, which will cause all
 conversion warnings to be suppressed.
 
+2D images are passed to OpenEXR directly, including the Y flip and arbitrary
+@ref PixelStorage parameters such as row padding or a row length larger than
+the image width, so there's no intermediate copy made. Cube maps are copied
+to a temporary buffer first in order to perform per-face X and Y flips.
+
 @subsection Trade-OpenExrImageConverter-behavior-channel-mapping Channel mapping
 
 Images with @ref PixelFormat::R16F / @relativeref{PixelFormat,RG16F} /
@@ -187,6 +192,18 @@ the @cb{.ini} tileSize @ce @ref Trade-OpenExrImporter-configuration "configurati
 Single-level images are implicitly written as scanline files, you can override
 that with the @cpp forceTiledOutput @ce option.
 
+With the @cb{.ini} threads @ce option set to more than @cpp 1 @ce, all tiles of
+a level are compressed in parallel, including all six faces of a cube map,
+which are stored together in a single level. The levels are then written one
+after another, as OpenEXR can compress only one level at a time. Because each
+level is four times smaller than the previous one, the first level takes the
+majority of the time anyway.
+
+The @cb{.ini} compression @ce option affects both the encoding speed and the
+output size. The `OpenExrImageConverterBenchmark` in the test suite measures
+encoding speed of a mip chain for all compression types and prints the
+resulting file sizes, run it to pick one for your data.
+
 @section Trade-OpenExrImageConverter-configuration Plugin-specific configuration
 
 It's possible to tune various options mainly for channel mapping through
@@ -211,6 +228,17 @@ find_package(Threads REQUIRED)
 target_link_libraries(your-application PRIVATE Threads::Threads)
 @endcode
 
+OpenEXR has a single global thread pool that's shared by all files and both
+@ref OpenExrImporter and @ref OpenExrImageConverter. By default it's grown to
+fit the @cb{.ini} threads @ce option. When converting many files concurrently from
+your own threads, it's better to size the pool just once in the application
+with @cpp Imf::setGlobalThreadCount() @ce and disable the
+@cb{.ini} resizeGlobalThreadPool @ce option. The @cb{.ini} threads @ce option
+then only limits how many parts of each file are processed in parallel in the
+shared pool, which avoids oversubscription. In builds with
+@ref CORRADE_BUILD_MULTITHREADED enabled, resizing the pool is synchronized
+across concurrently used plugin instances.
+
 */
 class MAGNUM_OPENEXRIMAGECONVERTER_EXPORT OpenExrImageConverter: public AbstractImageConverter {
     public:
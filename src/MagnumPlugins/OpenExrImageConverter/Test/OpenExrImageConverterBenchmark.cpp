@@ -0,0 +1,132 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Half.h>
+#include <Magnum/Math/Vector4.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+
+/* OpenEXR as a CMake subproject adds the OpenEXR/ directory to include path
+   but not the parent directory, so we can't #include <OpenEXR/blah>. This
+   can't really be fixed from outside, so unfortunately we have to do the same
+   in case of an external OpenEXR. */
+#include <OpenEXRConfig.h> /* for version-dependent checks */
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+/* Measures encoding speed of a full mip chain with different compression
+   types, printing the resulting file size for each. The image is generated in
+   memory as there's no point in bloating the repository with megabytes of
+   data. */
+struct OpenExrImageConverterBenchmark: TestSuite::Tester {
+    explicit OpenExrImageConverterBenchmark();
+
+    void convert();
+
+    private:
+        /* Explicitly forbid system-wide plugin dependencies */
+        PluginManager::Manager<AbstractImageConverter> _manager{"nonexistent"};
+        Containers::Array<Containers::Array<Vector4h>> _levelData;
+        Containers::Array<ImageView2D> _levels;
+};
+
+constexpr Int ImageSize = 1024;
+
+const struct {
+    const char* name;
+    const char* compression;
+    Int threads;
+} ConvertData[]{
+    {"uncompressed", "", 1},
+    {"rle", "rle", 1},
+    {"zips", "zips", 1},
+    {"zip", "zip", 1},
+    {"zip, all threads", "zip", 0},
+    {"piz", "piz", 1},
+    {"piz, all threads", "piz", 0},
+    {"dwaa", "dwaa", 1},
+    #if OPENEXR_VERSION_MAJOR*10000 + OPENEXR_VERSION_MINOR*100 + OPENEXR_VERSION_PATCH >= 30400
+    {"htj2k32", "htj2k32", 1},
+    {"htj2k32, all threads", "htj2k32", 0},
+    {"htj2k256", "htj2k256", 1},
+    #endif
+};
+
+OpenExrImageConverterBenchmark::OpenExrImageConverterBenchmark() {
+    addInstancedBenchmarks({&OpenExrImageConverterBenchmark::convert}, 5,
+        Containers::arraySize(ConvertData));
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef OPENEXRIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(OPENEXRIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+
+    /* A smooth gradient with some high-frequency detail, to not make it too
+       easy for the compressors. Each level is generated separately as the
+       content doesn't really matter. */
+    for(Int size = ImageSize; size; size >>= 1) {
+        Containers::Array<Vector4h> data{NoInit, std::size_t(size*size)};
+        for(Int y = 0; y != size; ++y) for(Int x = 0; x != size; ++x) {
+            const Float detail = Math::sin(Rad(Float(x*y % 97)))*0.05f;
+            data[y*size + x] = Vector4h{Vector4{Float(x)/size + detail, Float(y)/size, 1.0f - Float(x + y)/(2*size), 1.0f}};
+        }
+        arrayAppend(_levels, InPlaceInit, PixelFormat::RGBA16F, Vector2i{size}, Containers::arrayView(data));
+        arrayAppend(_levelData, Utility::move(data));
+    }
+}
+
+void OpenExrImageConverterBenchmark::convert() {
+    auto&& data = ConvertData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("OpenExrImageConverter");
+    converter->configuration().setValue("compression", data.compression);
+    converter->configuration().setValue("threads", data.threads);
+
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        Containers::Optional<Containers::Array<char>> out = converter->convertToData(_levels);
+        size = out ? out->size() : 0;
+    }
+
+    CORRADE_VERIFY(size);
+    CORRADE_INFO("Output size:" << size << "bytes," << Float(size)*100.0f/(ImageSize*ImageSize*8*4/3) << Debug::nospace << "% of uncompressed");
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::OpenExrImageConverterBenchmark)
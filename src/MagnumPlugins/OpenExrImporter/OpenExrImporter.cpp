@@ -25,7 +25,11 @@
 
 #include "OpenExrImporter.h"
 
+#include <cstring>
 #include <thread> /* std::thread::hardware_concurrency(), sigh */
+#ifdef CORRADE_BUILD_MULTITHREADED
+#include <mutex>
+#endif
 #include <Corrade/Containers/BitArray.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
@@ -33,9 +37,13 @@
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Configuration is <string>-free */
+#include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Half.h>
 #include <Magnum/Trade/ImageData.h>
 #include <Magnum/PixelFormat.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
 /* OpenEXR as a CMake subproject adds the OpenEXR/ directory to include path
    but not the parent directory, so we can't #include <OpenEXR/blah>. This
    can't really be fixed from outside, so unfortunately we have to do the same
@@ -57,6 +65,13 @@ using namespace Containers::Literals;
 
 namespace {
 
+#ifdef CORRADE_BUILD_MULTITHREADED
+std::mutex& globalThreadPoolMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+#endif
+
 /* Basically a copy of MemoryMappedIStream in ReadingAndWritingImageFiles.pdf,
    except it's working directly on our array view. */
 class MemoryIStream: public Imf::IStream {
@@ -134,6 +149,7 @@ bool OpenExrImporter::doIsOpened() const { return !!_state; }
 void OpenExrImporter::doClose() { _state = nullptr; }
 
 void OpenExrImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     /* Take over the existing array or copy the data if we can't */
     Containers::Array<char> dataCopy;
     if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
@@ -154,10 +170,23 @@ void OpenExrImporter::doOpenData(Containers::Array<char>&& data, const DataFlags
         if(flags() & ImporterFlag::Verbose)
             Debug{} << "Trade::OpenExrImporter::openData(): autodetected hardware concurrency to" << threadCount << "threads";
     }
-    if(Imf::globalThreadCount() < threadCount - 1) {
-        if(flags() & ImporterFlag::Verbose)
-            Debug{} << "Trade::OpenExrImporter::openData(): increasing global OpenEXR thread pool from" << Imf::globalThreadCount() << "to" << threadCount - 1 << "extra worker threads";
-        Imf::setGlobalThreadCount(threadCount - 1);
+    {
+        /* The check and the resize has to be done atomically, otherwise two
+           importers opening files concurrently could both decide to resize
+           the pool, with the smaller size winning */
+        #ifdef CORRADE_BUILD_MULTITHREADED
+        std::lock_guard<std::mutex> lock{globalThreadPoolMutex()};
+        #endif
+        if(Imf::globalThreadCount() < threadCount - 1) {
+            if(!configuration().value<bool>("resizeGlobalThreadPool")) {
+                if(flags() & ImporterFlag::Verbose)
+                    Debug{} << "Trade::OpenExrImporter::openData(): not resizing the global OpenEXR thread pool, which has" << Imf::globalThreadCount() << "extra worker threads";
+            } else {
+                if(flags() & ImporterFlag::Verbose)
+                    Debug{} << "Trade::OpenExrImporter::openData(): increasing global OpenEXR thread pool from" << Imf::globalThreadCount() << "to" << threadCount - 1 << "extra worker threads";
+                Imf::setGlobalThreadCount(threadCount - 1);
+            }
+        }
     }
 
     /* Open the file. There's two kinds of files, scanline and tiled. Tiled
@@ -293,8 +322,9 @@ void OpenExrImporter::doOpenData(Containers::Array<char>&& data, const DataFlags
 
 namespace {
 
-/* level = -1 means file is InputFile, non-negative value is TiledInputFile */
-Containers::Optional<ImageData2D> imageInternal(const Utility::ConfigurationGroup& configuration, Imf::GenericInputFile& file, const Int level, const char* const messagePrefix, const ImporterFlags flags) try {
+/* level = -1 means file is InputFile, non-negative value is TiledInputFile.
+   The region and tile options are applied only if allowRegion is set. */
+Containers::Optional<ImageData2D> imageInternal(const Utility::ConfigurationGroup& configuration, Imf::GenericInputFile& file, const Int level, const bool allowRegion, const char* const messagePrefix, const ImporterFlags flags) try {
     const Imf::Header* header;
     Imath::Box2i dataWindow;
     if(level == -1) {
@@ -305,8 +335,73 @@ Containers::Optional<ImageData2D> imageInternal(const Utility::ConfigurationGrou
         header = &actual.header();
         dataWindow = actual.dataWindowForLevel(level);
     }
-    const Vector2i size{dataWindow.max.x - dataWindow.min.x + 1,
-                        dataWindow.max.y - dataWindow.min.y + 1};
+    const Vector2i fullSize{dataWindow.max.x - dataWindow.min.x + 1,
+                            dataWindow.max.y - dataWindow.min.y + 1};
+
+    /* Part of the data window that gets imported, in the file coordinate
+       system, i.e. with Y down */
+    Imath::Box2i window = dataWindow;
+    if(allowRegion) {
+        const Containers::StringView tileString = configuration.value<Containers::StringView>("tile");
+        const Vector4i region = configuration.value<Vector4i>("region");
+        if(tileString && (region.z() || region.w())) {
+            Error{} << messagePrefix << "the region and tile options can't be both set";
+            return {};
+        }
+
+        if(tileString) {
+            if(level == -1) {
+                Error{} << messagePrefix << "the tile option can be used only with tiled files";
+                return {};
+            }
+
+            auto& actual = static_cast<Imf::TiledInputFile&>(file);
+            const Vector2i tile = configuration.value<Vector2i>("tile");
+            const Vector2i tileCount{actual.numXTiles(level), actual.numYTiles(level)};
+            if((tile < Vector2i{0}).any() || (tile >= tileCount).any()) {
+                Error{} << messagePrefix << "tile" << Debug::packed << tile << "out of range for" << Debug::packed << tileCount << "tiles in level" << level;
+                return {};
+            }
+
+            window = actual.dataWindowForTile(tile.x(), tile.y(), level);
+
+        } else if(region.z() || region.w()) {
+            if((region < Vector4i{0}).any() || !region.z() || !region.w() || region.x() + region.z() > fullSize.x() || region.y() + region.w() > fullSize.y()) {
+                Error{} << messagePrefix << "region" << Debug::packed << region << "out of range for a" << Debug::packed << fullSize << "image";
+                return {};
+            }
+
+            /* The region is Y up, the file is Y down */
+            window.min.x = dataWindow.min.x + region.x();
+            window.max.x = window.min.x + region.z() - 1;
+            window.max.y = dataWindow.max.y - region.y();
+            window.min.y = window.max.y - region.w() + 1;
+        }
+    }
+
+    /* Part of the data window that gets decoded. Scanline files can be read
+       only by whole rows and tiled files only by whole tiles, so it may be
+       larger than the imported window. Only tiles that intersect the window
+       get decoded. */
+    Imath::Box2i readWindow = window;
+    Vector2i minTile, maxTile;
+    if(level == -1) {
+        readWindow.min.x = dataWindow.min.x;
+        readWindow.max.x = dataWindow.max.x;
+    } else {
+        auto& actual = static_cast<Imf::TiledInputFile&>(file);
+        const Vector2i tileSize{Int(actual.tileXSize()), Int(actual.tileYSize())};
+        minTile = Vector2i{window.min.x - dataWindow.min.x,
+                           window.min.y - dataWindow.min.y}/tileSize;
+        maxTile = Vector2i{window.max.x - dataWindow.min.x,
+                           window.max.y - dataWindow.min.y}/tileSize;
+        readWindow.min = actual.dataWindowForTile(minTile.x(), minTile.y(), level).min;
+        readWindow.max = actual.dataWindowForTile(maxTile.x(), maxTile.y(), level).max;
+    }
+    const Vector2i size{window.max.x - window.min.x + 1,
+                        window.max.y - window.min.y + 1};
+    const Vector2i readSize{readWindow.max.x - readWindow.min.x + 1,
+                            readWindow.max.y - readWindow.min.y + 1};
 
     /* Figure out channel mapping */
     const Imf::ChannelList& channels = header->channels();
@@ -463,36 +558,59 @@ Containers::Optional<ImageData2D> imageInternal(const Utility::ConfigurationGrou
     const std::size_t channelSize = ChannelSizes[*type];
     const std::size_t pixelSize = channelCount*channelSize;
     const std::size_t rowStride = 4*((size.x()*pixelSize + 3)/4);
+    const std::size_t readRowStride = 4*((readSize.x()*pixelSize + 3)/4);
 
-    /* Output array. If we have unassigned RGBA channels, zero-init them (the
-       depth channel is always assigned). OTOH we don't care about the padding,
-       that can stay random. */
-    Containers::Array<char> out;
-    if((mapping[0].empty() ||
-        mapping[1].empty() ||
-        mapping[2].empty() ||
-        mapping[3].empty()) && !isDepth)
-    {
-        out = Containers::Array<char>{ValueInit, std::size_t{rowStride*size.y()}};
-    } else {
-        out = Containers::Array<char>{NoInit, std::size_t{rowStride*size.y()}};
-    }
+    /* Output array. It's filled by OpenEXR only for channels that are
+       present in the file, the rest is filled here below. OTOH we don't care
+       about the padding, that can stay random. */
+    Containers::Array<char> out{NoInit, std::size_t{readRowStride*readSize.y()}};
 
     Imf::FrameBuffer framebuffer;
     constexpr const char* FillOptions[] {
         "rFill", "gFill", "bFill", "aFill"
     };
+    /* Pixel with fill values for channels that aren't in the file and zeros
+       for unassigned channels. The depth channel is always present. */
+    char fillPixel[16]{};
+    bool needsFill = false;
     for(std::size_t i = 0; i != channelCount; ++i) {
-        if(mapping[i].empty()) continue;
+        if(mapping[i].empty()) {
+            needsFill = true;
+            continue;
+        }
 
         /* OpenEXR uses a std::map inside the Imf::FrameBuffer, but doesn't
            actually do any error checking on top, which means if we
            accidentally supply the same channel twice, it'll get ignored ... or
            maybe it overwrite the previous one. Not sure. Neither behavior
-           seems desirable, so let's fail on that. */
-        if(framebuffer.findSlice(mapping[i])) {
-            Error{} << messagePrefix << "duplicate mapping for channel" << mapping[i];
-            return {};
+           seems desirable, so let's fail on that. The check is done on the
+           names and not on the framebuffer, as the channels missing in the
+           file don't get added there. */
+        for(std::size_t j = 0; j != i; ++j) {
+            if(mapping[j] == mapping[i]) {
+                Error{} << messagePrefix << "duplicate mapping for channel" << mapping[i];
+                return {};
+            }
+        }
+
+        /* OpenEXR would fill channels that aren't in the file pixel by pixel
+           as it decodes each line or tile. Instead, their fill value is put
+           into the whole output at once below. */
+        if(!channels.findChannel(mapping[i])) {
+            const Double fill = configuration.value<Double>(FillOptions[i]);
+            char* const fillChannel = fillPixel + i*channelSize;
+            if(*type == Imf::HALF) {
+                const Half value{Float(fill)};
+                std::memcpy(fillChannel, &value, sizeof(value));
+            } else if(*type == Imf::FLOAT) {
+                const Float value(fill);
+                std::memcpy(fillChannel, &value, sizeof(value));
+            } else if(*type == Imf::UINT) {
+                const UnsignedInt value(fill);
+                std::memcpy(fillChannel, &value, sizeof(value));
+            } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+            needsFill = true;
+            continue;
         }
 
         framebuffer.insert(mapping[i], Imf::Slice{
@@ -501,28 +619,55 @@ Containers::Optional<ImageData2D> imageInternal(const Utility::ConfigurationGrou
                 /* For some strange reason I have to supply a pointer to the
                    first pixel ever, not the first pixel inside the data
                    window */
-                - dataWindow.min.y*rowStride
-                - dataWindow.min.x*pixelSize
+                - readWindow.min.y*readRowStride
+                - readWindow.min.x*pixelSize
                 /* And an offset to this channel, as they're interleaved */
                 + i*channelSize,
             pixelSize,
-            rowStride,
+            readRowStride,
             1, 1,
             configuration.value<Double>(FillOptions[i])
         });
     }
 
+    /* Put the fill pixel into the first row and then copy the row to all
+       others, letting the memcpy() do the broadcast using whatever SIMD is
+       available. The channels that are in the file get overwritten by OpenEXR
+       afterwards. */
+    if(needsFill && readSize.y()) {
+        for(std::size_t x = 0; x != std::size_t(readSize.x()); ++x)
+            std::memcpy(out.data() + x*pixelSize, fillPixel, pixelSize);
+        for(std::size_t y = 1; y != std::size_t(readSize.y()); ++y)
+            std::memcpy(out.data() + y*readRowStride, out.data(), readSize.x()*pixelSize);
+    }
+
     /* Sanity check, implied from the fact that the mappings are not empty */
     CORRADE_INTERNAL_ASSERT(framebuffer.begin() != framebuffer.end());
 
     if(level == -1) {
         auto& actual = static_cast<Imf::InputFile&>(file);
         actual.setFrameBuffer(framebuffer);
-        actual.readPixels(dataWindow.min.y, dataWindow.max.y);
+        actual.readPixels(readWindow.min.y, readWindow.max.y);
     } else {
         auto& actual = static_cast<Imf::TiledInputFile&>(file);
         actual.setFrameBuffer(framebuffer);
-        actual.readTiles(0, actual.numXTiles(level) - 1, 0, actual.numYTiles(level) - 1, level);
+        actual.readTiles(minTile.x(), maxTile.x(), minTile.y(), maxTile.y(), level);
+    }
+
+    /* If more was decoded than requested, copy the imported window out */
+    if(readSize != size) {
+        Containers::Array<char> windowOut{NoInit, std::size_t{rowStride*size.y()}};
+        const Containers::StridedArrayView2D<const char> src{out,
+            {std::size_t(readSize.y()), readRowStride}};
+        const std::size_t windowMinX = (window.min.x - readWindow.min.x)*pixelSize;
+        const std::size_t windowMinY = window.min.y - readWindow.min.y;
+        Utility::copy(
+            src.slice({windowMinY, windowMinX},
+                      {windowMinY + size.y(), windowMinX + size.x()*pixelSize}),
+            Containers::StridedArrayView2D<char>{windowOut,
+                {std::size_t(size.y()), rowStride}}.slice({0, 0},
+                {std::size_t(size.y()), size.x()*pixelSize}));
+        out = Utility::move(windowOut);
     }
 
     return Trade::ImageData2D{format, size, Utility::move(out)};
@@ -548,11 +693,12 @@ UnsignedInt OpenExrImporter::doImage2DLevelCount(UnsignedInt) {
 }
 
 Containers::Optional<ImageData2D> OpenExrImporter::doImage2D(UnsignedInt, const UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D"};
     Containers::Optional<ImageData2D> image;
     if(_state->file) {
-        image = imageInternal(configuration(), *_state->file, -1, "Trade::OpenExrImporter::image2D():", flags());
+        image = imageInternal(configuration(), *_state->file, -1, true, "Trade::OpenExrImporter::image2D():", flags());
     } else {
-        image = imageInternal(configuration(), *_state->tiledFile, level, "Trade::OpenExrImporter::image2D():", flags());
+        image = imageInternal(configuration(), *_state->tiledFile, level, true, "Trade::OpenExrImporter::image2D():", flags());
     }
 
     /* Let's stop here for a bit and contemplate on all the missed
@@ -607,11 +753,12 @@ UnsignedInt OpenExrImporter::doImage3DLevelCount(UnsignedInt) {
 }
 
 Containers::Optional<ImageData3D> OpenExrImporter::doImage3D(UnsignedInt, const UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage3D"};
     Containers::Optional<ImageData2D> image2D;
     if(_state->file) {
-        image2D = imageInternal(configuration(), *_state->file, -1, "Trade::OpenExrImporter::image3D():", flags());
+        image2D = imageInternal(configuration(), *_state->file, -1, false, "Trade::OpenExrImporter::image3D():", flags());
     } else {
-        image2D = imageInternal(configuration(), *_state->tiledFile, level, "Trade::OpenExrImporter::image3D():", flags());
+        image2D = imageInternal(configuration(), *_state->tiledFile, level, false, "Trade::OpenExrImporter::image3D():", flags());
     }
     if(!image2D) return {};
 
@@ -212,6 +212,17 @@ Images containing `R`, `G`, `B` or `A` channels are imported as
 @relativeref{PixelFormat,RGB32UI} / @relativeref{PixelFormat,RGBA32UI}, all
 channels are expected to have the same type.
 
+The channel data are imported in their original type without any conversion.
+In particular, there's no intermediate expansion to 32-bit floats for
+half-float images, meaning the @relativeref{PixelFormat,RGBA16F} etc. output
+can be uploaded directly to a GPU texture of a matching format. Use the
+@cb{.ini} forceChannelType @ce @ref Trade-OpenExrImporter-configuration "configuration option"
+if a conversion to a different type is desired. Channels that are mapped but
+not present in the file, such as alpha when forcing four channels on an RGB
+image, are filled with the corresponding @cb{.ini} rFill @ce,
+@cb{.ini} gFill @ce, @cb{.ini} bFill @ce or @cb{.ini} aFill @ce value in a
+single pass over the output before the actual decoding.
+
 If neither of the color channels is present and a a `Z` channel is present
 instead, the image is imported as @ref PixelFormat::Depth32F, expecting the
 channel to be of a float type.
@@ -253,6 +264,17 @@ enabled.
 [Ripmap](https://en.wikipedia.org/wiki/Anisotropic_filtering#An_improvement_on_isotropic_MIP_mapping)
 files are imported as a single-level image right now.
 
+@subsection Trade-OpenExrImporter-behavior-region Region and tile import
+
+A subset of a 2D image can be imported by setting the @cb{.ini} region @ce
+@ref Trade-OpenExrImporter-configuration "configuration option" to an offset
+and size relative to the bottom left corner of the data window. For scanline
+files only the rows containing the region get decoded, for tiled files only
+the tiles intersecting the region. Alternatively, the @cb{.ini} tile @ce
+option imports exactly one tile of given level. The tile indices are counted
+from the top left corner, same as in the file. Both options are ignored for
+cube maps.
+
 @subsection Trade-OpenExrImporter-behavior-cubemap Cube and lat/lon environment maps
 
 A lat/long environment map is imported as a 2D image without any indication of
@@ -290,6 +312,18 @@ find_package(Threads REQUIRED)
 target_link_libraries(your-application PRIVATE Threads::Threads)
 @endcode
 
+OpenEXR has a single global thread pool that's shared by all files and both
+@ref OpenExrImporter and @ref OpenExrImageConverter. By default it's grown to
+fit the @cb{.ini} threads @ce option. When importing many files concurrently from
+your own threads, it's better to size the pool just once in the application
+with @cpp Imf::setGlobalThreadCount() @ce and disable the
+@cb{.ini} resizeGlobalThreadPool @ce option. The @cb{.ini} threads @ce option
+then only limits how many parts of each file are processed in parallel in the
+shared pool, which avoids oversubscription. In builds with
+@ref CORRADE_BUILD_MULTITHREADED enabled, resizing the pool is synchronized
+across concurrently used plugin instances and separate importer instances can
+be used from different threads at the same time.
+
 */
 class MAGNUM_OPENEXRIMPORTER_EXPORT OpenExrImporter: public AbstractImporter {
     public:
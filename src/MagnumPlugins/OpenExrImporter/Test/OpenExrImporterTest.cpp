@@ -24,7 +24,7 @@
 */
 
 #include <sstream>
-#include <thread> /* std::thread::hardware_concurrency(), sigh */
+#include <thread>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/PluginManager/Manager.h>
@@ -36,6 +36,7 @@
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/ConfigurationValue.h>
 #include <Magnum/Math/Half.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
@@ -60,6 +61,7 @@ struct OpenExrImporterTest: TestSuite::Tester {
     void cubeMap();
 
     void forceChannelCountMore();
+    void forceChannelCountMoreHalf();
     void forceChannelCountLess();
     void forceChannelCountWrong();
     void forceChannelTypeFloat();
@@ -82,12 +84,21 @@ struct OpenExrImporterTest: TestSuite::Tester {
     void levelsCubeMap();
     void levelsCubeMapIncomplete();
 
+    void region();
+    void regionScanline();
+    void tile();
+    void regionTileInvalid();
+
     void threads();
 
     void openMemory();
     void openTwice();
     void importTwice();
 
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    void multithreaded();
+    #endif
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -137,6 +148,35 @@ const struct {
     {"custom tile size", "levels2D-tile1x1.exr"}
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+} RegionScanlineData[]{
+    {"", "rgb16f.exr"},
+    {"custom data/display window", "rgb16f-custom-windows.exr"},
+};
+
+const struct {
+    const char* name;
+    const char* filename;
+    const char* region;
+    const char* tile;
+    const char* message;
+} RegionTileInvalidData[]{
+    {"region out of range", "levels2D.exr", "1 0 5 1", nullptr,
+        "region {1, 0, 5, 1} out of range for a {5, 3} image"},
+    {"region with zero height", "levels2D.exr", "0 0 1 0", nullptr,
+        "region {0, 0, 1, 0} out of range for a {5, 3} image"},
+    {"negative region", "levels2D.exr", "-1 0 1 1", nullptr,
+        "region {-1, 0, 1, 1} out of range for a {5, 3} image"},
+    {"tile out of range", "levels2D-tile1x1.exr", nullptr, "5 0",
+        "tile {5, 0} out of range for {5, 3} tiles in level 0"},
+    {"tile in a scanline file", "rgb16f.exr", nullptr, "0 0",
+        "the tile option can be used only with tiled files"},
+    {"both region and tile", "levels2D-tile1x1.exr", "0 0 1 1", "0 0",
+        "the region and tile options can't be both set"},
+};
+
 const struct {
     const char* name;
     const char* filename;
@@ -175,21 +215,28 @@ const struct {
 const struct {
     const char* name;
     Int threads;
+    bool resizeGlobalThreadPool;
     bool verbose;
     const char* message;
 } ThreadsData[]{
-    {"default", 1, true,
+    {"default", 1, true, true,
+        ""},
+    /* Has to be before the others as it relies on the global pool being
+       empty */
+    {"two, global pool not resized, verbose", 2, false, true,
+        "Trade::OpenExrImporter::openData(): not resizing the global OpenEXR thread pool, which has 0 extra worker threads\n"},
+    {"two, global pool not resized, quiet", 2, false, false,
         ""},
-    {"two, verbose", 2, true,
+    {"two, verbose", 2, true, true,
         "Trade::OpenExrImporter::openData(): increasing global OpenEXR thread pool from 0 to 1 extra worker threads\n"},
-    {"three, quiet", 3, false,
+    {"three, quiet", 3, true, false,
         ""},
     /* This gets skipped if the detected thread count is not more than 3 as the
        second message won't get printed then */
-    {"all, verbose", 0, true,
+    {"all, verbose", 0, true, true,
         "Trade::OpenExrImporter::openData(): autodetected hardware concurrency to {} threads\n"
         "Trade::OpenExrImporter::openData(): increasing global OpenEXR thread pool from 2 to {} extra worker threads\n"},
-    {"all, quiet", 0, false,
+    {"all, quiet", 0, true, false,
         ""}
 };
 
@@ -226,6 +273,7 @@ OpenExrImporterTest::OpenExrImporterTest() {
         Containers::arraySize(CubeMapData));
 
     addTests({&OpenExrImporterTest::forceChannelCountMore,
+              &OpenExrImporterTest::forceChannelCountMoreHalf,
               &OpenExrImporterTest::forceChannelCountLess,
               &OpenExrImporterTest::forceChannelCountWrong});
 
@@ -257,6 +305,17 @@ OpenExrImporterTest::OpenExrImporterTest() {
     addInstancedTests({&OpenExrImporterTest::levelsCubeMapIncomplete},
         Containers::arraySize(IncompletelCubeMapData));
 
+    addInstancedTests({&OpenExrImporterTest::region},
+        Containers::arraySize(Levels2DData));
+
+    addInstancedTests({&OpenExrImporterTest::regionScanline},
+        Containers::arraySize(RegionScanlineData));
+
+    addTests({&OpenExrImporterTest::tile});
+
+    addInstancedTests({&OpenExrImporterTest::regionTileInvalid},
+        Containers::arraySize(RegionTileInvalidData));
+
     /* Could be addInstancedBenchmarks() to verify there's a difference but
        this would mean the test case gets skipped when CORRADE_NO_BENCHMARKS is
        enabled for a faster build. OTOH the improvement on a 5x3 image would be
@@ -272,6 +331,12 @@ OpenExrImporterTest::OpenExrImporterTest() {
     addTests({&OpenExrImporterTest::openTwice,
               &OpenExrImporterTest::importTwice});
 
+    /* Done last as it resizes the global thread pool, which the threads()
+       test case relies on being empty */
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    addRepeatedTests({&OpenExrImporterTest::multithreaded}, 10);
+    #endif
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef OPENEXRIMPORTER_PLUGIN_FILENAME
@@ -462,6 +527,26 @@ void OpenExrImporterTest::forceChannelCountMore() {
     }), TestSuite::Compare::Container);
 }
 
+void OpenExrImporterTest::forceChannelCountMoreHalf() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenExrImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(OPENEXRIMPORTER_TEST_DIR, "rgb16f.exr")));
+
+    /* The data should stay half-float and the missing alpha filled with a
+       custom value */
+    importer->configuration().setValue("forceChannelCount", 4);
+    importer->configuration().setValue("aFill", 0.5);
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->flags(), ImageFlags2D{});
+    CORRADE_COMPARE(image->size(), Vector2i(1, 3));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA16F);
+    CORRADE_COMPARE_AS(Containers::arrayCast<const Half>(image->data()), Containers::arrayView<Half>({
+        0.0_h, 1.0_h, 2.0_h, 0.5_h,
+        3.0_h, 4.0_h, 5.0_h, 0.5_h,
+        6.0_h, 7.0_h, 8.0_h, 0.5_h
+    }), TestSuite::Compare::Container);
+}
+
 void OpenExrImporterTest::forceChannelCountLess() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenExrImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Path::join(OPENEXRIMPORTER_TEST_DIR, "rgba32f.exr")));
@@ -1049,6 +1134,130 @@ void OpenExrImporterTest::levelsCubeMapIncomplete() {
     }
 }
 
+void OpenExrImporterTest::region() {
+    auto&& data = Levels2DData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenExrImporter");
+    /* Y up, so it's the top two rows of the image, without the first and last
+       column */
+    importer->configuration().setValue("region", Vector4i{1, 1, 3, 2});
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(OPENEXRIMPORTER_TEST_DIR, data.filename)));
+
+    {
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 0);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), (Vector2i{3, 2}));
+        CORRADE_COMPARE(image->format(), PixelFormat::R16F);
+
+        /* Data should be aligned to 4 bytes, clear padding to a zero value for
+           predictable output. */
+        CORRADE_COMPARE(image->data().size(), 2*8);
+        Containers::ArrayView<char> imageData = image->mutableData();
+        imageData[0*8 + 6] = imageData[0*8 + 7] =
+            imageData[1*8 + 6] = imageData[1*8 + 7] = 0;
+
+        /* Same as the corresponding part of levels2D() */
+        CORRADE_COMPARE_AS(Containers::arrayCast<const Half>(image->data()), Containers::arrayView<Half>({
+             6.0_h,  7.0_h,  8.0_h, {},
+            11.0_h, 12.0_h, 13.0_h, {}
+        }), TestSuite::Compare::Container);
+    }
+
+    /* The region is applied to all levels the same */
+    importer->configuration().setValue("region", Vector4i{1, 0, 1, 1});
+    {
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 1);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), (Vector2i{1, 1}));
+        CORRADE_COMPARE(image->format(), PixelFormat::R16F);
+
+        Containers::ArrayView<char> imageData = image->mutableData();
+        CORRADE_COMPARE(imageData.size(), 4);
+        imageData[2] = imageData[3] = 0;
+        CORRADE_COMPARE_AS(Containers::arrayCast<const Half>(image->data()), Containers::arrayView<Half>({
+            2.5_h, {}
+        }), TestSuite::Compare::Container);
+    }
+}
+
+void OpenExrImporterTest::regionScanline() {
+    auto&& data = RegionScanlineData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenExrImporter");
+    importer->configuration().setValue("region", Vector4i{0, 1, 1, 2});
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(OPENEXRIMPORTER_TEST_DIR, data.filename)));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), (Vector2i{1, 2}));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB16F);
+
+    /* Data should be aligned to 4 bytes, clear padding to a zero value for
+       predictable output. */
+    CORRADE_COMPARE(image->data().size(), 2*8);
+    Containers::ArrayView<char> imageData = image->mutableData();
+    imageData[0*8 + 6] = imageData[0*8 + 7] =
+        imageData[1*8 + 6] = imageData[1*8 + 7] = 0;
+
+    /* Same as the last two rows in rgb16f() */
+    CORRADE_COMPARE_AS(Containers::arrayCast<const Half>(image->data()), Containers::arrayView<Half>({
+        3.0_h, 4.0_h, 5.0_h, {},
+        6.0_h, 7.0_h, 8.0_h, {}
+    }), TestSuite::Compare::Container);
+}
+
+void OpenExrImporterTest::tile() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenExrImporter");
+    /* Tiles are counted from the top left, so this is the second pixel in the
+       last row of the Y-up image */
+    importer->configuration().setValue("tile", Vector2i{1, 0});
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(OPENEXRIMPORTER_TEST_DIR, "levels2D-tile1x1.exr")));
+
+    {
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 0);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), (Vector2i{1, 1}));
+        CORRADE_COMPARE(image->format(), PixelFormat::R16F);
+
+        Containers::ArrayView<char> imageData = image->mutableData();
+        CORRADE_COMPARE(imageData.size(), 4);
+        imageData[2] = imageData[3] = 0;
+        CORRADE_COMPARE_AS(Containers::arrayCast<const Half>(image->data()), Containers::arrayView<Half>({
+            11.0_h, {}
+        }), TestSuite::Compare::Container);
+    } {
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 1);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), (Vector2i{1, 1}));
+
+        Containers::ArrayView<char> imageData = image->mutableData();
+        CORRADE_COMPARE(imageData.size(), 4);
+        imageData[2] = imageData[3] = 0;
+        CORRADE_COMPARE_AS(Containers::arrayCast<const Half>(image->data()), Containers::arrayView<Half>({
+            2.5_h, {}
+        }), TestSuite::Compare::Container);
+    }
+}
+
+void OpenExrImporterTest::regionTileInvalid() {
+    auto&& data = RegionTileInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenExrImporter");
+    if(data.region)
+        importer->configuration().setValue("region", data.region);
+    if(data.tile)
+        importer->configuration().setValue("tile", data.tile);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(OPENEXRIMPORTER_TEST_DIR, data.filename)));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(0));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::OpenExrImporter::image2D(): {}\n", data.message));
+}
+
 void OpenExrImporterTest::threads() {
     auto&& data = ThreadsData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -1066,6 +1275,8 @@ void OpenExrImporterTest::threads() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenExrImporter");
     if(data.threads != 1)
         importer->configuration().setValue("threads", data.threads);
+    if(!data.resizeGlobalThreadPool)
+        importer->configuration().setValue("resizeGlobalThreadPool", false);
     if(data.verbose)
         importer->addFlags(ImporterFlag::Verbose);
 
@@ -1149,6 +1360,58 @@ void OpenExrImporterTest::importTwice() {
     }
 }
 
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+void OpenExrImporterTest::multithreaded() {
+    #ifndef CORRADE_BUILD_MULTITHREADED
+    CORRADE_SKIP("CORRADE_BUILD_MULTITHREADED is not enabled.");
+    #endif
+
+    #ifdef CORRADE_TARGET_MINGW
+    CORRADE_SKIP("Running this test causes a freeze on exit on MinGW. Or something like that. Needs investigation.");
+    #endif
+
+    /* Each importer has a different thread count, so they all race to resize
+       the global OpenEXR thread pool while others are already decoding in it.
+       The pool resize is serialized by the plugin, the rest should be
+       per-instance state. */
+    Containers::Pointer<AbstractImporter> importers[4];
+    for(std::size_t i = 0; i != Containers::arraySize(importers); ++i) {
+        importers[i] = _manager.instantiate("OpenExrImporter");
+        importers[i]->configuration().setValue("threads", UnsignedInt(i + 1));
+    }
+
+    int counters[Containers::arraySize(importers)]{};
+    {
+        auto fn = [](AbstractImporter& importer, int& counter) {
+            for(std::size_t i = 0; i != 25; ++i) {
+                if(!importer.openFile(Utility::Path::join(OPENEXRIMPORTER_TEST_DIR, "rgb16f.exr")))
+                    continue;
+                Containers::Optional<Trade::ImageData2D> image = importer.image2D(0);
+                if(!image || image->size() != Vector2i{1, 3} || image->format() != PixelFormat::RGB16F)
+                    continue;
+
+                /* Same data as in rgb16f(), padding is ignored */
+                Containers::ArrayView<const Half> data = Containers::arrayCast<const Half>(image->data());
+                if(data[0] == 0.0_h && data[1] == 1.0_h && data[2] == 2.0_h &&
+                   data[8] == 6.0_h && data[9] == 7.0_h && data[10] == 8.0_h)
+                    ++counter;
+            }
+        };
+
+        std::thread threads[Containers::arraySize(importers)];
+        for(std::size_t i = 0; i != Containers::arraySize(threads); ++i)
+            threads[i] = std::thread{fn, std::ref(*importers[i]), std::ref(counters[i])};
+        for(std::thread& thread: threads)
+            thread.join();
+    }
+
+    for(std::size_t i = 0; i != Containers::arraySize(counters); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(counters[i], 25);
+    }
+}
+#endif
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::OpenExrImporterTest)
@@ -27,8 +27,13 @@
 #include "OpenGexImporter.h"
 
 #include <algorithm> /* std::find() */
+#include <cstring>
 #include <limits>
 #include <unordered_map>
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <atomic>
+#include <thread>
+#endif
 #include <Corrade/Containers/ArrayTuple.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/GrowableArray.h>
@@ -36,9 +41,12 @@
 #include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringStl.h> /** @todo remove once OpenDdl is <string>-free */
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once OpenDdl is <string>-free */
+#include <Corrade/Utility/MurmurHash2.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/Mesh.h>
+#include <Magnum/VertexFormat.h>
 #include <Magnum/Math/Matrix4.h>
 #include <Magnum/Math/Quaternion.h>
 #include <Magnum/Trade/CameraData.h>
@@ -50,6 +58,8 @@
 #include <Magnum/Trade/TextureData.h>
 #include <MagnumPlugins/AnyImageImporter/AnyImageImporter.h>
 
+#include "Magnum/Implementation/imageImporterPool.h"
+#include "Magnum/Implementation/instrumentation.h"
 #include "Magnum/OpenDdl/Document.h"
 #include "Magnum/OpenDdl/Property.h"
 #include "Magnum/OpenDdl/Structure.h"
@@ -58,9 +68,22 @@
 
 namespace Magnum { namespace Trade {
 
+using namespace Containers::Literals;
 using namespace Magnum::Math::Literals;
 
 struct OpenGexImporter::Document {
+    /* File data, kept only if mesh data are parsed lazily */
+    Containers::Array<char> data;
+
+    /* Cache file path if the cache is enabled and the cache file contents if
+       the document was loaded from it, as the document references them */
+    Containers::Optional<Containers::String> cacheFilename;
+    Containers::Array<char> cache;
+
+    /* Set at the end of doOpenData(), to discard a document created in
+       doOpenFile() if the file couldn't be read */
+    bool opened = false;
+
     /* Clang-CL otherwise complains that Document has no implicit constructor */
     OpenDdl::Document document{};
 
@@ -85,8 +108,16 @@ struct OpenGexImporter::Document {
     std::unordered_map<std::string, UnsignedInt> imagesForName;
     std::vector<std::string> images;
 
+    /* Meshes extracted on opening if preloadMeshes is enabled, each is moved
+       out on the first import */
+    Containers::Array<Containers::Optional<MeshData>> preloadedMeshes;
+
     UnsignedInt imageImporterId = ~UnsignedInt{};
     Containers::Optional<AnyImageImporter> imageImporter;
+    /* Set if the imageImporterPoolSize option was non-zero when the image
+       importer was opened, in which case it's put back into the shared pool
+       once replaced */
+    Containers::String imageImporterFilename;
 };
 
 namespace {
@@ -106,11 +137,17 @@ UnsignedInt structureId(const std::vector<OpenDdl::Structure>& structures, OpenD
 
 OpenGexImporter::OpenGexImporter() = default;
 
-OpenGexImporter::OpenGexImporter(PluginManager::Manager<AbstractImporter>& manager): AbstractImporter(manager) {}
+OpenGexImporter::OpenGexImporter(PluginManager::Manager<AbstractImporter>& manager): AbstractImporter(manager) {
+    Magnum::Implementation::imageImporterPool().addUser(this->manager());
+}
 
-OpenGexImporter::OpenGexImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter(manager, plugin) {}
+OpenGexImporter::OpenGexImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter(manager, plugin) {
+    Magnum::Implementation::imageImporterPool().addUser(this->manager());
+}
 
-OpenGexImporter::~OpenGexImporter() = default;
+OpenGexImporter::~OpenGexImporter() {
+    Magnum::Implementation::imageImporterPool().removeUser(manager());
+}
 
 ImporterFeatures OpenGexImporter::doFeatures() const { return ImporterFeature::OpenData|ImporterFeature::FileCallback; }
 
@@ -128,16 +165,97 @@ void gatherNodes(OpenDdl::Structure node, std::vector<OpenDdl::Structure>& nodes
         gatherNodes(childNode, nodes, nodesForName);
 }
 
+/* Prepended to the serialized document in the cache file, size is a
+   multiple of 8 to keep the document aligned */
+struct CacheHeader {
+    UnsignedLong dataSize;
+    UnsignedLong dataHash;
+};
+
+UnsignedLong cacheDataHash(const Containers::ArrayView<const char> data) {
+    const Utility::MurmurHash2::Digest digest = Utility::MurmurHash2{}(data.data(), data.size());
+    UnsignedLong hash{};
+    std::memcpy(&hash, digest.byteArray(), Utility::MurmurHash2::DigestSize);
+    return hash;
 }
 
-void OpenGexImporter::doOpenData(Containers::Array<char>&& data, DataFlags) {
-    Containers::Pointer<Document> d{InPlaceInit};
+}
+
+void OpenGexImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
+    /* Take over the document created in doOpenFile(), if any */
+    Containers::Pointer<Document> d = std::move(_d);
+    if(!d) d.emplace();
+
+    /* If the cache is enabled, try to load the document from it. It's used
+       only if it was created from exactly the same data. Errors from a cache
+       made by an incompatible version are silenced, the cache gets simply
+       recreated in that case. */
+    bool cached = false;
+    UnsignedLong dataHash{};
+    if(d->cacheFilename) {
+        dataHash = cacheDataHash(data);
+
+        Containers::Optional<Containers::Array<char>> cache;
+        if(Utility::Path::exists(*d->cacheFilename))
+            cache = Utility::Path::read(*d->cacheFilename);
+        if(cache && cache->size() >= sizeof(CacheHeader)) {
+            CacheHeader header;
+            std::memcpy(&header, cache->data(), sizeof(CacheHeader));
+            if(header.dataSize == data.size() && header.dataHash == dataHash) {
+                Error redirectError{nullptr};
+                cached = d->document.deserialize(cache->exceptPrefix(sizeof(CacheHeader)), OpenGex::structures, OpenGex::properties);
+            }
+        }
+
+        if(cached)
+            d->cache = *std::move(cache);
+        else if(flags() & ImporterFlag::Verbose)
+            Debug{} << "Trade::OpenGexImporter::openData(): cache file" << *d->cacheFilename << "missing or outdated, parsing the file";
+    }
+
+    /* If mesh data are parsed lazily, the file data need to stay around until
+       all meshes are parsed. Take over the existing array or copy the data
+       if we can't. With a cache enabled the whole document is parsed in order
+       to serialize it, so the option has no effect there. */
+    Containers::ArrayView<const char> parseData = data;
+    if(configuration().value<bool>("lazyMeshes") && !d->cacheFilename) {
+        if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
+            d->data = std::move(data);
+        } else {
+            d->data = Containers::Array<char>{NoInit, data.size()};
+            Utility::copy(data, d->data);
+        }
 
-    /* Parse the document */
-    if(!d->document.parse(data, OpenGex::structures, OpenGex::properties)) return;
+        parseData = d->data;
+        d->document.setLazyStructures({OpenGex::VertexArray, OpenGex::IndexArray});
+    }
 
-    /* Validate the document */
-    if(!d->document.validate(OpenGex::rootStructures, OpenGex::structureInfo)) return;
+    /* Parse and validate the document, unless it was loaded from the cache,
+       which contains only documents that were validated already */
+    if(!cached) {
+        if(!d->document.parse(parseData, OpenGex::structures, OpenGex::properties, configuration().value<UnsignedInt>("threads"))) return;
+
+        if(!d->document.validate(OpenGex::rootStructures, OpenGex::structureInfo)) return;
+
+        /* Save the cache. Failure to do so isn't fatal, the document was
+           parsed successfully. */
+        if(d->cacheFilename) {
+            const Containers::Array<char> serialized = d->document.serialize();
+            Containers::Array<char> cache{NoInit, sizeof(CacheHeader) + serialized.size()};
+            const CacheHeader header{data.size(), dataHash};
+            std::memcpy(cache.data(), &header, sizeof(CacheHeader));
+            Utility::copy(serialized, cache.exceptPrefix(sizeof(CacheHeader)));
+
+            bool written;
+            {
+                Error redirectError{nullptr};
+                written = Utility::Path::write(*d->cacheFilename, cache);
+            }
+            if(!written)
+                Warning{} << "Trade::OpenGexImporter::openData(): can't write cache file" << *d->cacheFilename;
+        }
+    }
 
     /* Metrics */
     for(const OpenDdl::Structure metric: d->document.childrenOf(OpenGex::Metric)) {
@@ -226,19 +344,81 @@ void OpenGexImporter::doOpenData(Containers::Array<char>&& data, DataFlags) {
     for(const OpenDdl::Structure node: d->document.childrenOf(OpenGex::Node, OpenGex::BoneNode, OpenGex::GeometryNode, OpenGex::CameraNode, OpenGex::LightNode))
         gatherNodes(node, d->nodes, d->nodesForName);
 
+    /* Extract all meshes upfront if requested. The document isn't modified
+       during the extraction, so it can be done in parallel. Meshes that fail
+       to be extracted are left empty and extracted again on import, which
+       prints the error on the calling thread. */
+    if(configuration().value<bool>("preloadMeshes")) {
+        const bool zeroCopy = configuration().value<bool>("zeroCopy");
+        bool parsed;
+        {
+            Error redirectError{nullptr};
+            parsed = d->document.parseLazyData();
+        }
+        if(parsed) {
+            d->preloadedMeshes = Containers::Array<Containers::Optional<MeshData>>{d->meshes.size()};
+
+            std::size_t threadCount = configuration().value<UnsignedInt>("threads");
+            #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+            if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+            std::atomic<std::size_t> next{0};
+            #else
+            std::size_t next = 0;
+            #endif
+            const Document& document = *d;
+            const auto process = [&]() {
+                Error redirectError{nullptr};
+                for(std::size_t i; (i = next++) < document.meshes.size(); )
+                    d->preloadedMeshes[i] = extractMesh(document, i, zeroCopy);
+            };
+
+            /* The calling thread is one of the workers */
+            #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+            Containers::Array<std::thread> threads{Math::max(Math::min(threadCount, d->meshes.size()), std::size_t{1}) - 1};
+            for(std::thread& thread: threads)
+                thread = std::thread{process};
+            process();
+            for(std::thread& thread: threads)
+                thread.join();
+            #else
+            static_cast<void>(threadCount);
+            process();
+            #endif
+        }
+    }
+
     /* Everything okay, save the instance */
+    d->opened = true;
     _d = std::move(d);
 }
 
 void OpenGexImporter::doOpenFile(const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenFile", filename};
+    /* If the cache is enabled, remember where it is for doOpenData() */
+    if(configuration().value<bool>("cache")) {
+        _d.emplace();
+        _d->cacheFilename.emplace(filename + ".cache"_s);
+    }
+
     /* Make doOpenData() do the thing */
     AbstractImporter::doOpenFile(filename);
 
+    /* If the file couldn't be read, doOpenData() wasn't called and the
+       document created above is still there, discard it */
+    if(_d && !_d->opened) {
+        _d = nullptr;
+        return;
+    }
+
     /* If succeeded, save file path for later */
     if(_d) _d->filePath.emplace(Utility::Path::split(filename).first());
 }
 
-void OpenGexImporter::doClose() { _d = nullptr; }
+void OpenGexImporter::doClose() {
+    /* Put the image importer back to the shared pool, if enabled */
+    if(_d) releaseImageImporter();
+    _d = nullptr;
+}
 
 Int OpenGexImporter::doDefaultScene() const { return 0; }
 
@@ -269,6 +449,7 @@ namespace {
 }
 
 Containers::Optional<SceneData> OpenGexImporter::doScene(UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doScene"};
     /* Count how many objects have meshes, lights and camera assignments.
        Materials have to use the same object mapping as meshes, so only check
        if there's any material assignment at all -- if not, then we won't need
@@ -667,8 +848,66 @@ UnsignedInt OpenGexImporter::doMeshCount() const {
     return _d->meshes.size();
 }
 
+namespace {
+
+bool meshIndices(const OpenDdl::Structure indexArrayData, const MeshPrimitive primitive, const std::size_t indexArraySubArraySize, MeshIndexData& indices, Containers::ArrayView<const char>& indexData) {
+    if(indexArrayData.subArraySize() != indexArraySubArraySize) {
+        Error() << "Trade::OpenGexImporter::mesh(): invalid index array subarray size" << indexArrayData.subArraySize() << "for" << primitive;
+        return false;
+    }
+
+    switch(indexArrayData.type()) {
+        case OpenDdl::Type::UnsignedByte:
+            indexData = Containers::arrayCast<const char>(indexArrayData.asArray<UnsignedByte>());
+            indices = MeshIndexData{MeshIndexType::UnsignedByte, indexData};
+            return true;
+        case OpenDdl::Type::UnsignedShort:
+            indexData = Containers::arrayCast<const char>(indexArrayData.asArray<UnsignedShort>());
+            indices = MeshIndexData{MeshIndexType::UnsignedShort, indexData};
+            return true;
+        case OpenDdl::Type::UnsignedInt:
+            indexData = Containers::arrayCast<const char>(indexArrayData.asArray<UnsignedInt>());
+            indices = MeshIndexData{MeshIndexType::UnsignedInt, indexData};
+            return true;
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        case OpenDdl::Type::UnsignedLong:
+            Error() << "Trade::OpenGexImporter::mesh(): 64bit indices are not supported";
+            return false;
+        #endif
+
+        default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+}
+
+}
+
 Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, UnsignedInt) {
-    const OpenDdl::Structure& mesh = _d->meshes[id].firstChildOf(OpenGex::Mesh);
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMesh", {}, id};
+
+    /* If the mesh was extracted on opening already, return it. Importing the
+       same mesh again extracts it anew. */
+    if(id < _d->preloadedMeshes.size() && _d->preloadedMeshes[id]) {
+        Containers::Optional<MeshData> out = std::move(_d->preloadedMeshes[id]);
+        _d->preloadedMeshes[id] = Containers::NullOpt;
+        return out;
+    }
+
+    /* With lazyMeshes enabled, parse the vertex and index data now. Views
+       returned with zeroCopy would get invalidated by parsing data of other
+       meshes later, so in that case everything is parsed at once. If
+       lazyMeshes isn't enabled, there's nothing to parse and this is a
+       no-op. */
+    const bool zeroCopy = configuration().value<bool>("zeroCopy");
+    if(!(zeroCopy ? _d->document.parseLazyData() : _d->document.parseLazyData(_d->meshes[id].firstChildOf(OpenGex::Mesh)))) {
+        Error{} << "Trade::OpenGexImporter::mesh(): can't parse mesh data";
+        return Containers::NullOpt;
+    }
+
+    return extractMesh(*_d, id, zeroCopy);
+}
+
+Containers::Optional<MeshData> OpenGexImporter::extractMesh(const Document& d, const UnsignedInt id, const bool zeroCopy) {
+    const OpenDdl::Structure& mesh = d.meshes[id].firstChildOf(OpenGex::Mesh);
 
     /* Primitive type, triangles by default */
     std::size_t indexArraySubArraySize = 3;
@@ -694,10 +933,12 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
         }
     }
 
-    /* Gather all attributes. Position is optional as well. */
+    /* Gather all attributes. Position is optional as well. The data can be
+       referenced directly if they don't need any conversion. */
     std::size_t attributeCount = 0;
     std::ptrdiff_t stride = 0;
     UnsignedInt vertexCount = 0;
+    bool referenceData = zeroCopy;
     for(const OpenDdl::Structure vertexArray: mesh.childrenOf(OpenGex::VertexArray)) {
         /* Skip unsupported ones */
         auto&& attrib = vertexArray.propertyOf(OpenGex::attrib).as<std::string>();
@@ -722,6 +963,8 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
             }
 
             stride += sizeof(Vector3);
+            if(d.distanceMultiplier != 1.0f || !d.yUp)
+                referenceData = false;
 
         } else if(attrib == "normal") {
             if(vertexArrayData.subArraySize() != 3) {
@@ -730,6 +973,8 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
             }
 
             stride += sizeof(Vector3);
+            if(!d.yUp)
+                referenceData = false;
 
         } else if(attrib == "texcoord") {
             if(vertexArrayData.subArraySize() != 2) {
@@ -753,6 +998,55 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
         ++attributeCount;
     }
 
+    /* All float data are in a single array in the document, so the vertex
+       data view is the range spanning all attributes */
+    if(referenceData && vertexCount) {
+        Containers::Array<MeshAttributeData> attributeData{attributeCount};
+        std::size_t attributeIndex = 0;
+        const Float* vertexDataBegin = nullptr;
+        const Float* vertexDataEnd = nullptr;
+        for(const OpenDdl::Structure vertexArray: mesh.childrenOf(OpenGex::VertexArray)) {
+            auto&& attrib = vertexArray.propertyOf(OpenGex::attrib).as<std::string>();
+            MeshAttribute name;
+            VertexFormat format;
+            if(attrib == "position") {
+                name = MeshAttribute::Position;
+                format = VertexFormat::Vector3;
+            } else if(attrib == "normal") {
+                name = MeshAttribute::Normal;
+                format = VertexFormat::Vector3;
+            } else if(attrib == "texcoord") {
+                name = MeshAttribute::TextureCoordinates;
+                format = VertexFormat::Vector2;
+
+            /* Some other thing that wasn't handled above, ignore */
+            } else continue;
+
+            const Containers::ArrayView<const Float> values = vertexArray.firstChild().asArray<Float>();
+            attributeData[attributeIndex++] = MeshAttributeData{name, format,
+                Containers::StridedArrayView1D<const void>{values, values.data(), vertexCount, std::ptrdiff_t(vertexFormatSize(format))}};
+            if(!vertexDataBegin || values.begin() < vertexDataBegin)
+                vertexDataBegin = values.begin();
+            if(!vertexDataEnd || values.end() > vertexDataEnd)
+                vertexDataEnd = values.end();
+        }
+
+        CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
+
+        /* Mesh indices */
+        MeshIndexData indices;
+        Containers::ArrayView<const char> indexData;
+        if(const Containers::Optional<OpenDdl::Structure> indexArray = mesh.findFirstChildOf(OpenGex::IndexArray)) {
+            if(!meshIndices(indexArray->firstChild(), primitive, indexArraySubArraySize, indices, indexData))
+                return Containers::NullOpt;
+        }
+
+        return MeshData{primitive,
+            DataFlags{}, indexData, indices,
+            DataFlags{}, Containers::arrayView(reinterpret_cast<const char*>(vertexDataBegin), reinterpret_cast<const char*>(vertexDataEnd) - reinterpret_cast<const char*>(vertexDataBegin)),
+            std::move(attributeData), vertexCount};
+    }
+
     /* Allocate vertex data, fill attributes */
     Containers::Array<char> vertexData{NoInit, std::size_t(stride)*vertexCount};
     Containers::Array<MeshAttributeData> attributeData{attributeCount};
@@ -770,8 +1064,8 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
                 reinterpret_cast<Vector3*>(vertexData + attributeOffset),
                 vertexCount, stride};
             Utility::copy(Containers::arrayCast<const Vector3>(vertexArrayData.asArray<Float>()), positions);
-            for(auto& i: positions) i *= _d->distanceMultiplier;
-            if(!_d->yUp) for(auto& i: positions) i = fixVectorZUp(i);
+            for(auto& i: positions) i *= d.distanceMultiplier;
+            if(!d.yUp) for(auto& i: positions) i = fixVectorZUp(i);
 
             attributeData[attributeIndex++] = MeshAttributeData{
                 MeshAttribute::Position, positions};
@@ -783,7 +1077,7 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
                 reinterpret_cast<Vector3*>(vertexData + attributeOffset),
                 vertexCount, stride};
             Utility::copy(Containers::arrayCast<const Vector3>(vertexArrayData.asArray<Float>()), normals);
-            if(!_d->yUp) for(auto& i: normals) i = fixVectorZUp(i);
+            if(!d.yUp) for(auto& i: normals) i = fixVectorZUp(i);
 
             attributeData[attributeIndex++] = MeshAttributeData{
                 MeshAttribute::Normal, normals};
@@ -808,50 +1102,17 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
     CORRADE_INTERNAL_ASSERT(attributeOffset == std::size_t(stride));
     CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
 
-    /* Mesh indices */
+    /* Mesh indices, copied */
     MeshIndexData indices;
     Containers::Array<char> indexData;
     if(const Containers::Optional<OpenDdl::Structure> indexArray = mesh.findFirstChildOf(OpenGex::IndexArray)) {
-        const OpenDdl::Structure indexArrayData = indexArray->firstChild();
-
-        if(indexArrayData.subArraySize() != indexArraySubArraySize) {
-            Error() << "Trade::OpenGexImporter::mesh(): invalid index array subarray size" << indexArrayData.subArraySize() << "for" << primitive;
+        Containers::ArrayView<const char> indexDataView;
+        if(!meshIndices(indexArray->firstChild(), primitive, indexArraySubArraySize, indices, indexDataView))
             return Containers::NullOpt;
-        }
 
-        switch(indexArrayData.type()) {
-            case OpenDdl::Type::UnsignedByte: {
-                Containers::ArrayView<const UnsignedByte> src =
-                    indexArrayData.asArray<UnsignedByte>();
-                indexData = Containers::Array<char>{src.size()};
-                auto indexData8 = Containers::arrayCast<UnsignedByte>(indexData);
-                Utility::copy(src, indexData8);
-                indices = MeshIndexData{indexData8};
-            } break;
-            case OpenDdl::Type::UnsignedShort: {
-                Containers::ArrayView<const UnsignedShort> src =
-                    indexArrayData.asArray<UnsignedShort>();
-                indexData = Containers::Array<char>{src.size()*2};
-                auto indexData16 = Containers::arrayCast<UnsignedShort>(indexData);
-                Utility::copy(src, indexData16);
-                indices = MeshIndexData{indexData16};
-            } break;
-            case OpenDdl::Type::UnsignedInt: {
-                Containers::ArrayView<const UnsignedInt> src =
-                    indexArrayData.asArray<UnsignedInt>();
-                indexData = Containers::Array<char>{src.size()*4};
-                auto indexData32 = Containers::arrayCast<UnsignedInt>(indexData);
-                Utility::copy(src, indexData32);
-                indices = MeshIndexData{indexData32};
-            } break;
-            #ifndef CORRADE_TARGET_EMSCRIPTEN
-            case OpenDdl::Type::UnsignedLong:
-                Error() << "Trade::OpenGexImporter::mesh(): 64bit indices are not supported";
-                return Containers::NullOpt;
-            #endif
-
-            default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-        }
+        indexData = Containers::Array<char>{NoInit, indexDataView.size()};
+        Utility::copy(indexDataView, indexData);
+        indices = MeshIndexData{indices.type(), indexData};
     }
 
     return MeshData{primitive,
@@ -872,6 +1133,7 @@ Containers::String OpenGexImporter::doMaterialName(const UnsignedInt id) {
 }
 
 Containers::Optional<MaterialData> OpenGexImporter::doMaterial(const UnsignedInt id) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMaterial", {}, id};
     const OpenDdl::Structure& material = _d->materials[id];
 
     Containers::Array<MaterialAttributeData> attributes;
@@ -941,7 +1203,7 @@ AbstractImporter* OpenGexImporter::setupOrReuseImporterForImage(const UnsignedIn
        fails, the importer will stay unset, but the ID will be updated so the
        next round can again just return nullptr above instead of going through
        the doomed-to-fail process again. */
-    _d->imageImporter = Containers::NullOpt;
+    releaseImageImporter();
     _d->imageImporterId = id;
 
     if(!_d->filePath && !fileCallback()) {
@@ -953,16 +1215,32 @@ AbstractImporter* OpenGexImporter::setupOrReuseImporterForImage(const UnsignedIn
     importer.setFlags(flags());
     if(fileCallback()) importer.setFileCallback(fileCallback(), fileCallbackUserData());
 
-    const Containers::String imageFile = Utility::Path::join(_d->filePath ? *_d->filePath : "", _d->images[id]);
-    if(!importer.openFile(imageFile))
+    Containers::String imageFile = Utility::Path::join(_d->filePath ? *_d->filePath : "", _d->images[id]);
+
+    /* If there's an importer already opened for the same file in the shared
+       pool, take it from there instead of opening the file again */
+    const bool pooled = configuration().value<std::size_t>("imageImporterPoolSize") != 0;
+    Containers::Optional<AnyImageImporter> pooledImporter;
+    if(pooled)
+        pooledImporter = Magnum::Implementation::imageImporterPool().acquire(manager(), imageFile, flags(), fileCallback(), fileCallbackUserData());
+    if(!pooledImporter && !importer.openFile(imageFile))
         return nullptr;
+    AnyImageImporter& opened = pooledImporter ? *pooledImporter : importer;
 
-    if(importer.image2DCount() != 1) {
-        Error{} << errorPrefix << "expected exactly one 2D image in an image file but got" << importer.image2DCount();
+    if(opened.image2DCount() != 1) {
+        Error{} << errorPrefix << "expected exactly one 2D image in an image file but got" << opened.image2DCount();
         return nullptr;
     }
 
-    return &_d->imageImporter.emplace(std::move(importer));
+    if(pooled) _d->imageImporterFilename = std::move(imageFile);
+    return &_d->imageImporter.emplace(std::move(opened));
+}
+
+void OpenGexImporter::releaseImageImporter() {
+    if(_d->imageImporter && _d->imageImporterFilename)
+        Magnum::Implementation::imageImporterPool().release(manager(), _d->imageImporterFilename, flags(), fileCallback(), fileCallbackUserData(), std::move(*_d->imageImporter), configuration().value<std::size_t>("imageImporterPoolSize"));
+    _d->imageImporter = Containers::NullOpt;
+    _d->imageImporterFilename = {};
 }
 
 UnsignedInt OpenGexImporter::doImage2DLevelCount(const UnsignedInt id) {
@@ -977,6 +1255,7 @@ UnsignedInt OpenGexImporter::doImage2DLevelCount(const UnsignedInt id) {
 }
 
 Containers::Optional<ImageData2D> OpenGexImporter::doImage2D(const UnsignedInt id, const UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D", {}, id};
     CORRADE_ASSERT(manager(), "Trade::OpenGexImporter::image2D(): the plugin must be instantiated with access to plugin manager in order to open image files", {});
 
     AbstractImporter* importer = setupOrReuseImporterForImage(id, "Trade::OpenGexImporter::image2D():");
@@ -199,6 +199,38 @@ delegates to.
 The imported mesh always has at least one vertex attribute, but positions are
 not required to be present. Indices are optional as well.
 
+With the @cb{.ini} lazyMeshes @ce @ref Trade-OpenGexImporter-configuration "configuration option"
+enabled, data lists of `VertexArray` and `IndexArray` structures are only
+skipped when opening the file, and parsed only once given mesh is imported,
+using @ref OpenDdl::Document::setLazyStructures() and
+@ref OpenDdl::Document::parseLazyData(). With the @cb{.ini} zeroCopy @ce
+option enabled, the returned mesh has @ref MeshData::indexDataFlags() and
+@ref MeshData::vertexDataFlags() empty and references the parsed document
+directly instead of copying the data, as long as positions and normals don't
+need to be converted from a Z up axis and positions don't need to be scaled
+by the distance metric. Meshes that need a conversion are always copied.
+
+With the @cb{.ini} preloadMeshes @ce option enabled, all meshes are extracted
+already in @ref openData() / @ref openFile(), on as many threads as set by the
+@cb{.ini} threads @ce option, since the parsed document isn't modified
+anymore at that point. The first @ref mesh() call for given mesh then returns
+the extracted data directly, calling it again extracts the mesh anew. If
+@cb{.ini} lazyMeshes @ce is enabled as well, data of all meshes are parsed
+before the extraction. Errors in meshes that failed to be extracted are
+reported only once given mesh is imported.
+
+@subsection Trade-OpenGexImporter-behavior-cache Document cache
+
+With the @cb{.ini} cache @ce @ref Trade-OpenGexImporter-configuration "configuration option"
+enabled, @ref openFile() saves the parsed document using
+@ref OpenDdl::Document::serialize() into a file with a `.cache` suffix next to
+the opened file. Next time the same file is opened, the document is loaded from
+there with @ref OpenDdl::Document::deserialize() instead of being parsed again.
+The cache is used only if the size and a hash of the file contents match, the
+file is otherwise parsed and the cache recreated. The data are still read in
+full in order to calculate the hash. The cache format is platform-specific,
+see @ref OpenDdl::Document::serialize() for details.
+
 @subsection Trade-OpenGexImporter-behavior-materials Material import
 
 -   Alpha mode is always @ref MaterialAlphaMode::Opaque and alpha mask always
@@ -220,6 +252,19 @@ not required to be present. Indices are optional as well.
 -   If multiple textures have the same image filename string, given image is
     present in the image list only once. Note that only a simple string
     comparison is used without any path normalization.
+-   The importer opened for the most recently accessed image is kept around
+    so importing its other levels doesn't open the file again. Setting the
+    @cb{.ini} imageImporterPoolSize @ce @ref Trade-OpenGexImporter-configuration "configuration option"
+    to a non-zero value puts it into a pool shared by all
+    @ref OpenGexImporter instances created from the same plugin manager once
+    another image is accessed or the file is closed. Importing the same image
+    file from another OpenGEX file, or again after the file was closed and
+    reopened, then takes the already opened importer from the pool instead of
+    opening the image file again. The pool is thread-safe, each pooled
+    importer is used by just one importer instance at a time. It's assumed
+    the image files don't change while they're in the pool. The pool is
+    emptied once the last @ref OpenGexImporter instance created from given
+    plugin manager is destroyed.
 
 @subsection Trade-OpenGexImporter-state Access to internal importer state
 
@@ -242,6 +287,22 @@ importer-specific data accessors:
         an @ref OpenGex::Node, @ref OpenGex::BoneNode,
         @ref OpenGex::GeometryNode, @ref OpenGex::CameraNode or
         @ref OpenGex::LightNode structure
+
+@section Trade-OpenGexImporter-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/OpenGexImporter/OpenGexImporter.conf configuration_
+
+The @cb{.ini} threads @ce option is passed to
+@ref OpenDdl::Document::parse(Containers::ArrayView<const char>, std::initializer_list<CharacterLiteral>, std::initializer_list<CharacterLiteral>, UnsignedInt),
+see its documentation for details. Note that in order to use multiple threads,
+the application has to link to a threading library, such as `Threads::Threads`
+in CMake.
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_OPENGEXIMPORTER_EXPORT OpenGexImporter: public AbstractImporter {
     public:
@@ -302,6 +363,9 @@ class MAGNUM_OPENGEXIMPORTER_EXPORT OpenGexImporter: public AbstractImporter {
 
         MAGNUM_OPENGEXIMPORTER_LOCAL UnsignedInt doMeshCount() const override;
         MAGNUM_OPENGEXIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
+        /* Static so it can be called on the document from multiple threads
+           in doOpenData() before it's saved into _d */
+        MAGNUM_OPENGEXIMPORTER_LOCAL static Containers::Optional<MeshData> extractMesh(const Document& d, UnsignedInt id, bool zeroCopy);
 
         MAGNUM_OPENGEXIMPORTER_LOCAL UnsignedInt doMaterialCount() const override;
         MAGNUM_OPENGEXIMPORTER_LOCAL Int doMaterialForName(Containers::StringView name) override;
@@ -312,6 +376,7 @@ class MAGNUM_OPENGEXIMPORTER_EXPORT OpenGexImporter: public AbstractImporter {
         MAGNUM_OPENGEXIMPORTER_LOCAL Containers::Optional<TextureData> doTexture(UnsignedInt id) override;
 
         MAGNUM_OPENGEXIMPORTER_LOCAL AbstractImporter* setupOrReuseImporterForImage(UnsignedInt id, const char* errorPrefix);
+        MAGNUM_OPENGEXIMPORTER_LOCAL void releaseImageImporter();
 
         MAGNUM_OPENGEXIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_OPENGEXIMPORTER_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
@@ -33,6 +33,7 @@
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Compare/String.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
@@ -60,6 +61,7 @@
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
+using namespace Containers::Literals;
 using namespace Magnum::Math::Literals;
 
 struct OpenGexImporterTest: TestSuite::Tester {
@@ -93,6 +95,15 @@ struct OpenGexImporterTest: TestSuite::Tester {
     void mesh();
     void meshIndexed();
     void meshMetrics();
+    void meshThreads();
+    void meshLazy();
+    void meshLazyParseError();
+    void meshZeroCopy();
+    void meshZeroCopyConverted();
+    void meshPreload();
+    void meshPreloadError();
+
+    void cache();
 
     void meshInvalidPrimitive();
     void meshUnsupportedSize();
@@ -147,6 +158,18 @@ const struct {
     {"translation object only", "unsupported object-only transformation in node 1"},
 };
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+    bool lazyMeshes;
+    bool zeroCopy;
+} MeshPreloadData[]{
+    {"", 1, false, false},
+    {"4 threads", 4, false, false},
+    {"lazy meshes, 4 threads", 4, true, false},
+    {"lazy meshes, zero copy", 1, true, true},
+};
+
 OpenGexImporterTest::OpenGexImporterTest() {
     addTests({&OpenGexImporterTest::open,
               &OpenGexImporterTest::openParseError,
@@ -177,6 +200,18 @@ OpenGexImporterTest::OpenGexImporterTest() {
               &OpenGexImporterTest::mesh,
               &OpenGexImporterTest::meshIndexed,
               &OpenGexImporterTest::meshMetrics,
+              &OpenGexImporterTest::meshThreads,
+              &OpenGexImporterTest::meshLazy,
+              &OpenGexImporterTest::meshLazyParseError,
+              &OpenGexImporterTest::meshZeroCopy,
+              &OpenGexImporterTest::meshZeroCopyConverted});
+
+    addInstancedTests({&OpenGexImporterTest::meshPreload},
+        Containers::arraySize(MeshPreloadData));
+
+    addTests({&OpenGexImporterTest::meshPreloadError,
+
+              &OpenGexImporterTest::cache,
 
               &OpenGexImporterTest::meshInvalidPrimitive,
               &OpenGexImporterTest::meshUnsupportedSize,
@@ -827,6 +862,272 @@ void OpenGexImporterTest::meshMetrics() {
         }), TestSuite::Compare::Container);
 }
 
+void OpenGexImporterTest::meshThreads() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    /* The file has several top-level structures, so they get parsed on
+       multiple threads */
+    importer->configuration().setValue("threads", 4);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex")));
+    CORRADE_COMPARE(importer->meshCount(), 3);
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::TriangleStrip);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 1.0f, 3.0f}, {-1.0f, 2.0f, 2.0f}, {3.0f, 3.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+
+    Containers::Optional<MeshData> meshIndexed = importer->mesh(1);
+    CORRADE_VERIFY(meshIndexed);
+    CORRADE_VERIFY(meshIndexed->isIndexed());
+}
+
+void OpenGexImporterTest::meshLazy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("lazyMeshes", true);
+
+    /* Opening a non-owned view, so the data get copied internally */
+    Containers::Optional<Containers::Array<char>> data = Utility::Path::read(Utility::Path::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex"));
+    CORRADE_VERIFY(data);
+    CORRADE_VERIFY(importer->openData(*data));
+    *data = {};
+
+    /* The data lists aren't parsed yet */
+    const OpenDdl::Document& document = *static_cast<const OpenDdl::Document*>(importer->importerState());
+    const OpenDdl::Structure vertexArray = document.firstChildOf(OpenGex::GeometryObject).firstChildOf(OpenGex::Mesh).firstChildOf(OpenGex::VertexArray);
+    CORRADE_COMPARE(vertexArray.firstChild().subArraySize(), 3);
+    CORRADE_COMPARE(vertexArray.firstChild().arraySize(), 0);
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::TriangleStrip);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 1.0f, 3.0f}, {-1.0f, 2.0f, 2.0f}, {3.0f, 3.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(vertexArray.firstChild().arraySize(), 9);
+
+    /* Importing again doesn't parse the data again */
+    CORRADE_VERIFY(importer->mesh(0));
+
+    Containers::Optional<MeshData> meshIndexed = importer->mesh(1);
+    CORRADE_VERIFY(meshIndexed);
+    CORRADE_VERIFY(meshIndexed->isIndexed());
+    CORRADE_COMPARE_AS(meshIndexed->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({
+            2, 0, 1, 1, 2, 3
+        }), TestSuite::Compare::Container);
+}
+
+void OpenGexImporterTest::meshLazyParseError() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("lazyMeshes", true);
+
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = OpenDdl::CharacterLiteral{R"oddl(
+GeometryObject {
+    Mesh {
+        VertexArray (attrib = "position") { float[3] {
+            {0.0, 1.0, 3.0}, {-1.0, 2.0 2.0}
+        }}
+    }
+}
+    )oddl"};
+    /* The broken data list is only skipped when opening */
+    CORRADE_VERIFY(importer->openData(s));
+    CORRADE_COMPARE(importer->meshCount(), 1);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(0));
+    CORRADE_COMPARE(out.str(),
+        "OpenDdl::Document::parseLazyData(): expected , character on line 5\n"
+        "Trade::OpenGexImporter::mesh(): can't parse mesh data\n");
+}
+
+void OpenGexImporterTest::meshZeroCopy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    /* The file has Y up and no distance metric, so no conversion is needed */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex")));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->vertexCount(), 3);
+    CORRADE_COMPARE(mesh->attributeCount(), 4);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 1.0f, 3.0f}, {-1.0f, 2.0f, 2.0f}, {3.0f, 3.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {0.0f, 1.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates, 1),
+        Containers::arrayView<Vector2>({
+            {0.5f, 1.0f}, {1.0f, 0.5f}, {0.5f, 0.5f}
+        }), TestSuite::Compare::Container);
+
+    /* Works together with lazy parsing as well */
+    importer->configuration().setValue("lazyMeshes", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex")));
+
+    Containers::Optional<MeshData> meshIndexed = importer->mesh(1);
+    CORRADE_VERIFY(meshIndexed);
+    CORRADE_COMPARE(meshIndexed->indexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(meshIndexed->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE_AS(meshIndexed->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({
+            2, 0, 1, 1, 2, 3
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(meshIndexed->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 1.0f, 3.0f}, {-1.0f, 2.0f, 2.0f}, {3.0f, 3.0f, 1.0f}, {5.0f, 7.0f, 0.5f}
+        }), TestSuite::Compare::Container);
+
+    /* Importing another mesh doesn't invalidate the views as everything got
+       parsed on the first import */
+    CORRADE_VERIFY(importer->mesh(0));
+    CORRADE_COMPARE_AS(meshIndexed->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 1.0f, 3.0f}, {-1.0f, 2.0f, 2.0f}, {3.0f, 3.0f, 1.0f}, {5.0f, 7.0f, 0.5f}
+        }), TestSuite::Compare::Container);
+}
+
+void OpenGexImporterTest::meshPreload() {
+    auto&& data = MeshPreloadData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("preloadMeshes", true);
+    importer->configuration().setValue("threads", data.threads);
+    importer->configuration().setValue("lazyMeshes", data.lazyMeshes);
+    importer->configuration().setValue("zeroCopy", data.zeroCopy);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex")));
+    CORRADE_COMPARE(importer->meshCount(), 3);
+
+    /* With lazy meshes, all data got parsed on opening already */
+    if(data.lazyMeshes) {
+        const OpenDdl::Document& document = *static_cast<const OpenDdl::Document*>(importer->importerState());
+        const OpenDdl::Structure vertexArray = document.firstChildOf(OpenGex::GeometryObject).firstChildOf(OpenGex::Mesh).firstChildOf(OpenGex::VertexArray);
+        CORRADE_COMPARE(vertexArray.firstChild().arraySize(), 9);
+    }
+
+    /* The first import returns the preloaded mesh, the second extracts it
+       again, both should be the same */
+    for(const char* iteration: {"preloaded", "extracted again"}) {
+        CORRADE_ITERATION(iteration);
+
+        Containers::Optional<MeshData> mesh = importer->mesh(0);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::TriangleStrip);
+        CORRADE_COMPARE(mesh->vertexDataFlags(), data.zeroCopy ? DataFlags{} : DataFlag::Owned|DataFlag::Mutable);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {0.0f, 1.0f, 3.0f}, {-1.0f, 2.0f, 2.0f}, {3.0f, 3.0f, 1.0f}
+            }), TestSuite::Compare::Container);
+
+        Containers::Optional<MeshData> meshIndexed = importer->mesh(1);
+        CORRADE_VERIFY(meshIndexed);
+        CORRADE_COMPARE_AS(meshIndexed->indices<UnsignedShort>(),
+            Containers::arrayView<UnsignedShort>({
+                2, 0, 1, 1, 2, 3
+            }), TestSuite::Compare::Container);
+    }
+}
+
+void OpenGexImporterTest::meshPreloadError() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("preloadMeshes", true);
+    importer->configuration().setValue("threads", 4);
+
+    /* Errors in the meshes aren't printed during opening */
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(OPENGEXIMPORTER_TEST_DIR, "mesh-invalid.ogex")));
+    }
+    CORRADE_COMPARE(importer->meshCount(), 6);
+    CORRADE_COMPARE(out.str(), "");
+
+    /* But only when importing the mesh */
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->mesh(0));
+    }
+    CORRADE_COMPARE(out.str(), "Trade::OpenGexImporter::mesh(): unsupported primitive quads\n");
+}
+
+void OpenGexImporterTest::cache() {
+    const Containers::String filename = Utility::Path::join(OPENGEXIMPORTER_TEST_OUTPUT_DIR, "cache.ogex");
+    const Containers::String cacheFilename = filename + ".cache";
+    CORRADE_VERIFY(Utility::Path::make(OPENGEXIMPORTER_TEST_OUTPUT_DIR));
+    if(Utility::Path::exists(cacheFilename))
+        CORRADE_VERIFY(Utility::Path::remove(cacheFilename));
+    Containers::Optional<Containers::Array<char>> data = Utility::Path::read(Utility::Path::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex"));
+    CORRADE_VERIFY(data);
+    CORRADE_VERIFY(Utility::Path::write(filename, *data));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("cache", true);
+
+    /* First open creates the cache */
+    CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_VERIFY(Utility::Path::exists(cacheFilename));
+    importer->close();
+
+    /* Second open loads from the cache, verbose output says nothing */
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        importer->setFlags(ImporterFlag::Verbose);
+        CORRADE_VERIFY(importer->openFile(filename));
+        importer->setFlags({});
+        CORRADE_COMPARE(out.str(), "");
+    }
+    CORRADE_COMPARE(importer->meshCount(), 2);
+    Containers::Optional<MeshData> mesh = importer->mesh(1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({
+            2, 0, 1, 1, 2, 3
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 1.0f, 3.0f}, {-1.0f, 2.0f, 2.0f}, {3.0f, 3.0f, 1.0f}, {5.0f, 7.0f, 0.5f}
+        }), TestSuite::Compare::Container);
+
+    /* Changing the file makes the cache outdated, it gets recreated */
+    CORRADE_VERIFY(Utility::Path::append(filename, "\n// changed\n"_s));
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        importer->setFlags(ImporterFlag::Verbose);
+        CORRADE_VERIFY(importer->openFile(filename));
+        importer->setFlags({});
+        CORRADE_COMPARE(out.str(), Utility::formatString(
+            "Trade::OpenGexImporter::openData(): cache file {} missing or outdated, parsing the file\n", cacheFilename));
+    }
+    CORRADE_COMPARE(importer->meshCount(), 2);
+
+    /* Opening a nonexistent file doesn't leave the importer opened */
+    CORRADE_VERIFY(!importer->openFile(Utility::Path::join(OPENGEXIMPORTER_TEST_OUTPUT_DIR, "nonexistent.ogex")));
+    CORRADE_VERIFY(!importer->isOpened());
+}
+
+void OpenGexImporterTest::meshZeroCopyConverted() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    /* The file has Z up, so the data have to be copied */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(OPENGEXIMPORTER_TEST_DIR, "mesh-metrics.ogex")));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+}
+
 void OpenGexImporterTest::meshInvalidPrimitive() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Path::join(OPENGEXIMPORTER_TEST_DIR, "mesh-invalid.ogex")));
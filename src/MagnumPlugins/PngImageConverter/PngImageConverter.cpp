@@ -36,17 +36,269 @@
     New versions don't have that anymore: https://github.com/glennrp/libpng/commit/6c2e919c7eb736d230581a4c925fa67bd901fcf8
 */
 #include <csetjmp>
+#include <cstring>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Endianness.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
+
+#include "Magnum/Implementation/instrumentation.h"
+#include "MagnumPlugins/PngImporter/PngBands.h"
 
 namespace Magnum { namespace Trade {
 
 using namespace Containers::Literals;
 
+namespace {
+
+/* Bits correspond to PNG filter types, the index of a bit is the filter type
+   byte written to the data */
+constexpr UnsignedByte FilterNone = 1 << 0;
+constexpr UnsignedByte FilterSub = 1 << 1;
+constexpr UnsignedByte FilterUp = 1 << 2;
+constexpr UnsignedByte FilterAverage = 1 << 3;
+constexpr UnsignedByte FilterPaeth = 1 << 4;
+constexpr UnsignedByte FilterAll = FilterNone|FilterSub|FilterUp|FilterAverage|FilterPaeth;
+
+/* Filters a single row, writing the filter type followed by the filtered
+   bytes to the output. The previous row is nullptr for the first row of the
+   image. */
+void filterRow(const UnsignedByte filter, const UnsignedByte* const row, const UnsignedByte* const previous, const std::size_t size, const std::size_t pixelSize, UnsignedByte* const out) {
+    out[0] = filter;
+    UnsignedByte* const filtered = out + 1;
+    switch(filter) {
+        case 0: /* None */
+            std::memcpy(filtered, row, size);
+            return;
+        case 1: /* Sub */
+            for(std::size_t i = 0; i != Math::min(pixelSize, size); ++i)
+                filtered[i] = row[i];
+            for(std::size_t i = pixelSize; i < size; ++i)
+                filtered[i] = row[i] - row[i - pixelSize];
+            return;
+        case 2: /* Up */
+            if(previous) for(std::size_t i = 0; i != size; ++i)
+                filtered[i] = row[i] - previous[i];
+            else std::memcpy(filtered, row, size);
+            return;
+        case 3: /* Average */
+            for(std::size_t i = 0; i != size; ++i)
+                filtered[i] = row[i] - ((i >= pixelSize ? row[i - pixelSize] : 0) + (previous ? previous[i] : 0))/2;
+            return;
+        case 4: /* Paeth */
+            for(std::size_t i = 0; i != size; ++i)
+                filtered[i] = row[i] - Implementation::pngPaeth(
+                    i >= pixelSize ? row[i - pixelSize] : 0,
+                    previous ? previous[i] : 0,
+                    i >= pixelSize && previous ? previous[i - pixelSize] : 0);
+            return;
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+/* Same heuristic as libpng uses for adaptive filtering, picking the filter
+   with the smallest sum of absolute values of the output interpreted as
+   signed */
+std::size_t filterCost(const UnsignedByte* const filtered, const std::size_t size) {
+    std::size_t sum = 0;
+    for(std::size_t i = 0; i != size; ++i)
+        sum += Math::abs(Int(Byte(filtered[i])));
+    return sum;
+}
+
+void writeUnsignedInt(char* const out, const UnsignedInt value) {
+    const UnsignedInt bigEndian = Utility::Endianness::bigEndian(value);
+    std::memcpy(out, &bigEndian, 4);
+}
+
+void writeChunk(Containers::Array<char>& out, const char* const type, const Containers::ArrayView<const char> data) {
+    char* const chunk = arrayAppend(out, NoInit, 12 + data.size()).data();
+    writeUnsignedInt(chunk, data.size());
+    std::memcpy(chunk + 4, type, 4);
+    Utility::copy(data, Containers::arrayView(chunk + 8, data.size()));
+    writeUnsignedInt(chunk + 8 + data.size(), crc32(0, reinterpret_cast<const Bytef*>(chunk + 4), data.size() + 4));
+}
+
+/* Writes the whole file without libpng, with each band of rows compressed
+   independently, terminated with a full flush and its position recorded in
+   a mgRS chunk, as described in PngImporter/PngBands.h. The first row of
+   each band is filtered only with None or Sub so the bands can be unfiltered
+   independently as well. */
+Containers::Array<char> convertBands(const Containers::StridedArrayView3D<const char>& pixels, const Int bitDepth, const Int colorType, const Int level, const Int strategy, const UnsignedByte filters, std::size_t rowsPerBand, UnsignedInt threadCount) {
+    const std::size_t height = pixels.size()[0];
+    const std::size_t pixelSize = pixels.size()[2];
+    const std::size_t rowSize = pixels.size()[1]*pixelSize;
+    const std::size_t filteredRowSize = rowSize + 1;
+
+    /* By default aim for roughly 128 kB of uncompressed data in a band, which
+       is what pigz uses as well -- large enough for the dictionary reset to
+       not have a significant impact on the compression ratio */
+    if(!rowsPerBand)
+        rowsPerBand = Math::max(std::size_t{1}, 128*1024/filteredRowSize);
+    rowsPerBand = Math::min(rowsPerBand, height);
+    const std::size_t bandCount = (height + rowsPerBand - 1)/rowsPerBand;
+
+    #ifndef CORRADE_TARGET_BIG_ENDIAN
+    const bool swap16 = bitDepth == 16;
+    #else
+    const bool swap16 = false;
+    #endif
+
+    Containers::Array<Containers::Array<char>> compressed{bandCount};
+    Containers::Array<std::size_t> compressedSizes{NoInit, bandCount};
+    Containers::Array<UnsignedInt> checksums{NoInit, bandCount};
+
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = Math::min(threadCount, UnsignedInt(bandCount));
+    std::atomic<std::size_t> next{0};
+    #else
+    std::size_t next = 0;
+    #endif
+    const auto compress = [&]() {
+        /* Scratch memory for the whole filtered band, two consecutive input
+           rows if they need to be byte-swapped and a filter candidate */
+        Containers::Array<UnsignedByte> filtered{NoInit, rowsPerBand*filteredRowSize};
+        Containers::Array<UnsignedByte> swapped{NoInit, swap16 ? 2*rowSize : 0};
+        Containers::Array<UnsignedByte> candidate{NoInit, filteredRowSize};
+        const auto row = [&](const std::size_t y) {
+            const UnsignedByte* const data = static_cast<const UnsignedByte*>(pixels[y].data());
+            if(!swap16) return data;
+            UnsignedByte* const out = swapped + (y % 2)*rowSize;
+            for(std::size_t i = 0; i + 1 < rowSize; i += 2) {
+                out[i] = data[i + 1];
+                out[i + 1] = data[i];
+            }
+            return const_cast<const UnsignedByte*>(out);
+        };
+
+        for(std::size_t band; (band = next++) < bandCount; ) {
+            const std::size_t begin = band*rowsPerBand;
+            const std::size_t end = Math::min(begin + rowsPerBand, height);
+
+            const UnsignedByte* previous = begin ? row(begin - 1) : nullptr;
+            for(std::size_t y = begin; y != end; ++y) {
+                const UnsignedByte* const current = row(y);
+                UnsignedByte* const out = filtered + (y - begin)*filteredRowSize;
+
+                /* The first row of a band can't depend on the previous band,
+                   fall back to Sub if nothing else is allowed */
+                UnsignedByte allowed = filters;
+                if(y == begin && y) {
+                    allowed &= FilterNone|FilterSub;
+                    if(!allowed) allowed = FilterSub;
+                }
+
+                /* If there's just one filter, use it directly, otherwise pick
+                   the one with the smallest cost */
+                if(!(allowed & (allowed - 1))) {
+                    UnsignedByte filter = 0;
+                    while(!(allowed & (1 << filter))) ++filter;
+                    filterRow(filter, current, previous, rowSize, pixelSize, out);
+                } else {
+                    std::size_t bestCost = ~std::size_t{};
+                    for(UnsignedByte filter = 0; filter != 5; ++filter) {
+                        if(!(allowed & (1 << filter))) continue;
+                        filterRow(filter, current, previous, rowSize, pixelSize, candidate);
+                        const std::size_t cost = filterCost(candidate + 1, rowSize);
+                        if(cost < bestCost) {
+                            bestCost = cost;
+                            std::memcpy(out, candidate, filteredRowSize);
+                        }
+                    }
+                }
+
+                previous = current;
+            }
+
+            /* Raw deflate, the zlib header and checksum are added for the
+               whole stream at the end */
+            const std::size_t size = (end - begin)*filteredRowSize;
+            z_stream stream{};
+            CORRADE_INTERNAL_ASSERT_OUTPUT(deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, strategy) == Z_OK);
+            /* The bound doesn't include the empty stored block emitted by the
+               full flush */
+            Containers::Array<char>& out = compressed[band];
+            out = Containers::Array<char>{NoInit, deflateBound(&stream, size) + 16};
+            stream.next_in = filtered;
+            stream.avail_in = size;
+            stream.next_out = reinterpret_cast<Bytef*>(out.data());
+            stream.avail_out = out.size();
+            const bool last = band + 1 == bandCount;
+            CORRADE_INTERNAL_ASSERT_OUTPUT(deflate(&stream, last ? Z_FINISH : Z_FULL_FLUSH) == (last ? Z_STREAM_END : Z_OK));
+            CORRADE_INTERNAL_ASSERT(!stream.avail_in && stream.avail_out);
+            compressedSizes[band] = out.size() - stream.avail_out;
+            deflateEnd(&stream);
+
+            checksums[band] = adler32(adler32(0, nullptr, 0), filtered, size);
+        }
+    };
+
+    /* The calling thread is one of the workers */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{compress};
+    compress();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    compress();
+    #endif
+
+    /* Assemble the zlib stream. The header level flag is just informative,
+       it doesn't affect decompression in any way. */
+    Containers::Array<char> stream;
+    const UnsignedByte cmf = 0x78; /* deflate, 32 kB window */
+    UnsignedByte flg = (level == 0 || level == 1 ? 0 :
+                        level >= 2 && level <= 5 ? 1 :
+                        level == 6 || level == -1 ? 2 : 3) << 6;
+    flg += 31 - (cmf*256 + flg) % 31;
+    arrayAppend(stream, {char(cmf), char(flg)});
+
+    Containers::Array<char> bands{NoInit, 4 + 4*bandCount};
+    writeUnsignedInt(bands, rowsPerBand);
+    UnsignedInt checksum = adler32(0, nullptr, 0);
+    for(std::size_t i = 0; i != bandCount; ++i) {
+        writeUnsignedInt(bands + 4 + 4*i, stream.size());
+        arrayAppend(stream, compressed[i].prefix(compressedSizes[i]));
+        const std::size_t begin = i*rowsPerBand;
+        const std::size_t end = Math::min(begin + rowsPerBand, height);
+        checksum = adler32_combine(checksum, checksums[i], (end - begin)*filteredRowSize);
+    }
+    writeUnsignedInt(arrayAppend(stream, NoInit, 4).data(), checksum);
+
+    /* A file with just a single band doesn't need any band info */
+    Containers::Array<char> out;
+    arrayAppend(out, Containers::arrayView("\x89PNG\r\n\x1a\n", 8));
+    char header[13];
+    writeUnsignedInt(header + 0, pixels.size()[1]);
+    writeUnsignedInt(header + 4, height);
+    header[8] = bitDepth;
+    header[9] = colorType;
+    header[10] = header[11] = header[12] = 0;
+    writeChunk(out, "IHDR", header);
+    if(bandCount > 1)
+        writeChunk(out, "mgRS", bands);
+    for(std::size_t offset = 0; offset < stream.size(); offset += 0x7fffffff)
+        writeChunk(out, "IDAT", stream.sliceSize(offset, Math::min(stream.size() - offset, std::size_t{0x7fffffff})));
+    writeChunk(out, "IEND", nullptr);
+
+    /* Convert the growable array back to a non-growable with the default
+       deleter so we can return it */
+    arrayShrink(out);
+    return out;
+}
+
+}
+
 PngImageConverter::PngImageConverter() = default;
 
 PngImageConverter::PngImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImageConverter{manager, plugin} {}
@@ -60,6 +312,7 @@ Containers::String PngImageConverter::doMimeType() const {
 }
 
 Containers::Optional<Containers::Array<char>> PngImageConverter::doConvertToData(const ImageView2D& image) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
     /* Warn about lost metadata */
     if((image.flags() & ImageFlag2D::Array) && !(flags() & ImageConverterFlag::Quiet)) {
         Warning{} << "Trade::PngImageConverter::convertToData(): 1D array images are unrepresentable in PNG, saving as a regular 2D image";
@@ -107,6 +360,63 @@ Containers::Optional<Containers::Array<char>> PngImageConverter::doConvertToData
             return {};
     }
 
+    const Int level = configuration().value<Int>("compressionLevel");
+    if(level < -1 || level > 9) {
+        Error{} << "Trade::PngImageConverter::convertToData(): expected compressionLevel to be -1 or between 0 and 9 but got" << configuration().value<Containers::StringView>("compressionLevel");
+        return {};
+    }
+
+    /* Empty strategy is decided based on the filter below, same as libpng
+       does */
+    Int strategy = -1;
+    const auto strategyString = configuration().value<Containers::StringView>("compressionStrategy");
+    if(strategyString == "default"_s)
+        strategy = Z_DEFAULT_STRATEGY;
+    else if(strategyString == "filtered"_s)
+        strategy = Z_FILTERED;
+    else if(strategyString == "huffman"_s)
+        strategy = Z_HUFFMAN_ONLY;
+    else if(strategyString == "rle"_s)
+        strategy = Z_RLE;
+    else if(strategyString == "fixed"_s)
+        strategy = Z_FIXED;
+    else if(!strategyString.isEmpty()) {
+        Error{} << "Trade::PngImageConverter::convertToData(): unknown compression strategy" << strategyString;
+        return {};
+    }
+
+    UnsignedByte filters;
+    const auto filter = configuration().value<Containers::StringView>("filter");
+    if(filter == "none"_s)
+        filters = FilterNone;
+    else if(filter == "sub"_s)
+        filters = FilterSub;
+    else if(filter == "up"_s)
+        filters = FilterUp;
+    else if(filter == "average"_s)
+        filters = FilterAverage;
+    else if(filter == "paeth"_s)
+        filters = FilterPaeth;
+    else if(filter == "adaptive"_s)
+        filters = FilterAll;
+    else {
+        Error{} << "Trade::PngImageConverter::convertToData(): unknown filter" << filter;
+        return {};
+    }
+
+    /* Write rows in reverse order. While the rows may have some padding after,
+       the actual pixels in the row should be contiguous so it should be safe
+       to pass a pointer to the first byte of each. */
+    const Containers::StridedArrayView3D<const char> pixelsFlipped = image.pixels().flipped<0>();
+    CORRADE_INTERNAL_ASSERT(pixelsFlipped.isContiguous<1>());
+
+    /* Compress bands of rows in parallel if desired */
+    const UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(threadCount != 1) {
+        /* GCC 4.8 needs extra help here */
+        return Containers::optional(convertBands(pixelsFlipped, bitDepth, colorType, level, strategy == -1 ? (filters == FilterNone ? Z_DEFAULT_STRATEGY : Z_FILTERED) : strategy, filters, configuration().value<UnsignedInt>("rowsPerBand"), threadCount));
+    }
+
     png_structp file = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
     /** @todo this will assert if the PNG major/minor version doesn't match,
         with "libpng warning: Application built with libpng-1.7.0 but running
@@ -145,6 +455,18 @@ Containers::Optional<Containers::Array<char>> PngImageConverter::doConvertToData
         arrayAppend(output, {reinterpret_cast<const char*>(data), length});
     }, [](png_structp){});
 
+    /* Set compression options. All of them default to what libpng would use
+       on its own, so the output is the same as without calling these. */
+    png_set_compression_level(file, level == -1 ? Z_DEFAULT_COMPRESSION : level);
+    if(strategy != -1)
+        png_set_compression_strategy(file, strategy);
+    png_set_filter(file, PNG_FILTER_TYPE_BASE,
+        (filters & FilterNone ? PNG_FILTER_NONE : 0)|
+        (filters & FilterSub ? PNG_FILTER_SUB : 0)|
+        (filters & FilterUp ? PNG_FILTER_UP : 0)|
+        (filters & FilterAverage ? PNG_FILTER_AVG : 0)|
+        (filters & FilterPaeth ? PNG_FILTER_PAETH : 0));
+
     /* Write header */
     png_set_IHDR(file, info, image.size().x(), image.size().y(),
         bitDepth, colorType, PNG_INTERLACE_NONE,
@@ -158,11 +480,7 @@ Containers::Optional<Containers::Array<char>> PngImageConverter::doConvertToData
         #endif
     } else CORRADE_INTERNAL_ASSERT(bitDepth == 8);
 
-    /* Write rows in reverse order. While the rows may have some padding after,
-       the actual pixels in the row should be contiguous so it should be safe
-       to pass a pointer to the first byte of each. */
-    const Containers::StridedArrayView3D<const char> pixelsFlipped = image.pixels().flipped<0>();
-    CORRADE_INTERNAL_ASSERT(pixelsFlipped.isContiguous<1>());
+    /* Write rows in reverse order */
     for(Int y = 0; y != image.size().y(); ++y)
         png_write_row(file, static_cast<unsigned char*>(const_cast<void*>(pixelsFlipped[y].data())));
 
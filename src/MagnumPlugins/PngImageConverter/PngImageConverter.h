@@ -122,6 +122,43 @@ the file is saved as a regular 2D image.
 The plugin recognizes @ref ImageConverterFlag::Quiet, which will cause all
 conversion warnings, coming either from the plugin or libpng itself, to be
 suppressed.
+
+@subsection Trade-PngImageConverter-behavior-compression Compression options
+
+The zlib compression level, strategy and row filter can be changed with the
+@cb{.ini} compressionLevel @ce, @cb{.ini} compressionStrategy @ce and
+@cb{.ini} filter @ce @ref Trade-PngImageConverter-configuration "configuration options".
+The defaults match what libpng uses. For fast saving, such as when capturing
+screenshots of a running application, a low compression level together with
+the @cb{.ini} sub @ce or @cb{.ini} none @ce filter is a good tradeoff.
+
+@subsection Trade-PngImageConverter-behavior-parallel Parallel compression
+
+If the @cb{.ini} threads @ce option is set to a value other than
+@cb{.ini} 1 @ce, the image is split into bands of rows, which are then
+filtered and compressed independently on multiple threads. Each band except
+for the last ends with a zlib full flush, which makes the output slightly
+larger but still a valid PNG file. The band offsets are recorded in a private
+`mgRS` chunk, allowing @ref Trade-PngImporter-behavior-parallel "PngImporter"
+and @ref Trade-SpngImporter-behavior-parallel "SpngImporter" to decompress the
+bands in parallel as well. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+application has to be linked to `pthread` on Linux for this to work.
+
+In this mode the file is written without libpng, the output thus isn't
+byte-for-byte equivalent to the serial output, and the first row of each band
+is always filtered with either None or Sub, in order to make unfiltering of
+the bands independent.
+
+@section Trade-PngImageConverter-configuration Plugin-specific configuration
+
+It's possible to tune various output options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/PngImageConverter/PngImageConverter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_PNGIMAGECONVERTER_EXPORT PngImageConverter: public AbstractImageConverter {
     public:
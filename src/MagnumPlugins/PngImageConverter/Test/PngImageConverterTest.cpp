@@ -27,12 +27,15 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/Path.h>
+#include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/DebugTools/CompareImage.h>
@@ -44,6 +47,8 @@
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
+using namespace Containers::Literals;
+
 struct PngImageConverterTest: TestSuite::Tester {
     explicit PngImageConverterTest();
 
@@ -58,6 +63,11 @@ struct PngImageConverterTest: TestSuite::Tester {
 
     void unsupportedMetadata();
 
+    void compressionOptions();
+    void invalidConfiguration();
+
+    void bands();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
     PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
@@ -84,6 +94,53 @@ const struct {
         nullptr},
 };
 
+const struct {
+    const char* name;
+    Int level;
+    const char* strategy;
+    const char* filter;
+} CompressionOptionsData[]{
+    {"no compression", 0, "", "adaptive"},
+    {"fastest, no filtering", 1, "", "none"},
+    {"best, Huffman only", 9, "huffman", "paeth"},
+    {"RLE, sub filter", -1, "rle", "sub"},
+    {"fixed, up filter", 3, "fixed", "up"},
+    {"filtered, average filter", 6, "filtered", "average"},
+};
+
+const struct {
+    const char* name;
+    const char* option;
+    const char* value;
+    const char* message;
+} InvalidConfigurationData[]{
+    {"compression level too small", "compressionLevel", "-2",
+        "expected compressionLevel to be -1 or between 0 and 9 but got -2"},
+    {"compression level too large", "compressionLevel", "10",
+        "expected compressionLevel to be -1 or between 0 and 9 but got 10"},
+    {"unknown strategy", "compressionStrategy", "huffmann",
+        "unknown compression strategy huffmann"},
+    {"unknown filter", "filter", "all",
+        "unknown filter all"},
+};
+
+const struct {
+    const char* name;
+    PixelFormat format;
+    Vector2i size;
+    UnsignedInt threads;
+    UnsignedInt rowsPerBand;
+    const char* filter;
+    UnsignedInt bandCount;
+} BandsData[]{
+    {"RGB, 2 threads, 3 rows per band", PixelFormat::RGB8Unorm, {7, 13}, 2, 3, "adaptive", 5},
+    {"RGB, all threads, 1 row per band", PixelFormat::RGB8Unorm, {7, 13}, 0, 1, "adaptive", 13},
+    {"RGB, 2 threads, single band", PixelFormat::RGB8Unorm, {7, 13}, 2, 0, "adaptive", 1},
+    {"RGBA16, 3 threads, 2 rows per band", PixelFormat::RGBA16Unorm, {5, 9}, 3, 2, "adaptive", 5},
+    {"gray + alpha, 2 threads, paeth filter", PixelFormat::RG8Unorm, {6, 8}, 2, 3, "paeth", 3},
+    {"gray16, 2 threads, up filter", PixelFormat::R16Unorm, {3, 4}, 2, 1, "up", 4},
+};
+
 PngImageConverterTest::PngImageConverterTest() {
     addTests({&PngImageConverterTest::wrongFormat});
 
@@ -99,6 +156,15 @@ PngImageConverterTest::PngImageConverterTest() {
     addInstancedTests({&PngImageConverterTest::unsupportedMetadata},
         Containers::arraySize(UnsupportedMetadataData));
 
+    addInstancedTests({&PngImageConverterTest::compressionOptions},
+        Containers::arraySize(CompressionOptionsData));
+
+    addInstancedTests({&PngImageConverterTest::invalidConfiguration},
+        Containers::arraySize(InvalidConfigurationData));
+
+    addInstancedTests({&PngImageConverterTest::bands},
+        Containers::arraySize(BandsData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef PNGIMAGECONVERTER_PLUGIN_FILENAME
@@ -321,6 +387,92 @@ void PngImageConverterTest::unsupportedMetadata() {
         CORRADE_COMPARE(out.str(), Utility::formatString("Trade::PngImageConverter::convertToData(): {}\n", data.message));
 }
 
+void PngImageConverterTest::compressionOptions() {
+    auto&& data = CompressionOptionsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("PngImageConverter");
+    converter->configuration().setValue("compressionLevel", data.level);
+    converter->configuration().setValue("compressionStrategy", data.strategy);
+    converter->configuration().setValue("filter", data.filter);
+
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(OriginalRgb);
+    CORRADE_VERIFY(out);
+
+    if(_importerManager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("PngImporter");
+    CORRADE_VERIFY(importer->openData(*out));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE_AS(*converted, ConvertedRgb,
+        DebugTools::CompareImage);
+}
+
+void PngImageConverterTest::invalidConfiguration() {
+    auto&& data = InvalidConfigurationData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("PngImageConverter");
+    converter->configuration().setValue(data.option, data.value);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(OriginalRgb));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::PngImageConverter::convertToData(): {}\n", data.message));
+}
+
+void PngImageConverterTest::bands() {
+    auto&& data = BandsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Some pattern that doesn't compress to nothing, in an image with four
+       byte row padding */
+    Image2D image{data.format, data.size, Containers::Array<char>{NoInit, std::size_t(4*((data.size.x()*pixelFormatSize(data.format) + 3)/4)*data.size.y())}};
+    for(std::size_t i = 0; i != image.data().size(); ++i)
+        image.data()[i] = (i*7 + (i/5)*31 + i*i*3) & 0xff;
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("PngImageConverter");
+    converter->configuration().setValue("threads", data.threads);
+    converter->configuration().setValue("rowsPerBand", data.rowsPerBand);
+    converter->configuration().setValue("filter", data.filter);
+
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(image);
+    CORRADE_VERIFY(out);
+
+    /* A single band doesn't need the chunk */
+    const Containers::StringView outString{out->data(), out->size()};
+    CORRADE_COMPARE(!!outString.find("mgRS"_s), data.bandCount > 1);
+
+    if(_importerManager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    /* The file should be decodable by libpng as any other PNG */
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("PngImporter");
+    CORRADE_VERIFY(importer->openData(*out));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE_AS(*converted, image,
+        DebugTools::CompareImage);
+
+    /* And also in parallel, if there's more than one band */
+    if(data.bandCount == 1)
+        return;
+
+    importer->configuration().setValue("threads", 2);
+    importer->addFlags(ImporterFlag::Verbose);
+    std::ostringstream verbose;
+    {
+        Debug redirectOutput{&verbose};
+        converted = importer->image2D(0);
+    }
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(verbose.str(), Utility::formatString("Trade::PngImporter::image2D(): decoded {} row bands in parallel\n", data.bandCount));
+    CORRADE_COMPARE_AS(*converted, image,
+        DebugTools::CompareImage);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::PngImageConverterTest)
@@ -0,0 +1,287 @@
+#ifndef Magnum_Trade_PngBands_h
+#define Magnum_Trade_PngBands_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
+#include <zlib.h>
+
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <atomic>
+#include <thread>
+#endif
+
+/* Used by PngImporter, SpngImporter and PngImageConverter, which is why it
+   isn't directly inside PngImporter.cpp. OTOH it doesn't need to be exposed
+   publicly, which is why it has no docblocks.
+
+   A PNG file can describe its image data as a sequence of bands of rows that
+   can be decompressed and unfiltered independently, which allows them to be
+   decoded on multiple threads. The description is stored in a private
+   ancillary chunk called mgRS (lowercase first letter = ancillary, lowercase
+   second = private, uppercase fourth = unsafe to copy, as it's tied to the
+   image data):
+
+    -   32-bit big-endian count of rows in each band, except for the last band,
+        which can be shorter
+    -   for each band, 32-bit big-endian offset of its compressed data in the
+        zlib stream formed by concatenation of all IDAT chunks
+
+   The deflate data of each band except the last has to end with a full flush
+   (i.e., an empty stored block with the compression dictionary reset), so a
+   band can be decompressed without any knowledge of the preceding data. The
+   first band starts right after the two-byte zlib header and the last ends
+   with the final deflate block, followed by the Adler-32 checksum of the
+   whole stream.
+
+   Additionally, to make unfiltering of different bands independent, the
+   first row of each band should use the None or Sub filter. It's not a hard
+   requirement however, bands that don't satisfy it get unfiltered after the
+   band before them, without any parallelism. Any decoder not aware of this
+   chunk can decode the file as usual, as the data is a valid zlib stream. */
+
+namespace Magnum { namespace Trade { namespace Implementation {
+
+struct PngBands {
+    /* Concatenated IDAT chunk contents */
+    Containers::Array<char> stream;
+    UnsignedInt rowsPerBand;
+    Containers::Array<UnsignedInt> offsets;
+};
+
+inline UnsignedInt pngReadUnsignedInt(const char* const data) {
+    UnsignedInt value;
+    std::memcpy(&value, data, 4);
+    return Utility::Endianness::bigEndian(value);
+}
+
+/* Returns true if the file has a valid mgRS chunk consistent with the image
+   height, filling the output with the stream and band info. Returns false
+   if there's no such chunk or anything is off, in which case the file should
+   be decoded the usual way. Chunk CRCs are checked only for the IDAT and
+   mgRS chunks, everything else is expected to be checked by the PNG library
+   decoding the file header. */
+inline bool pngFindBands(const Containers::ArrayView<const char> file, const UnsignedInt height, PngBands& out) {
+    /* Skip the signature, which is checked by the PNG library already */
+    if(file.size() < 8) return false;
+    std::size_t pos = 8;
+    Containers::ArrayView<const char> bands;
+    Containers::Array<char> stream;
+    while(pos + 12 <= file.size()) {
+        const std::size_t size = pngReadUnsignedInt(file.data() + pos);
+        if(file.size() - pos - 12 < size) return false;
+
+        const char* const type = file.data() + pos + 4;
+        const Containers::ArrayView<const char> data = file.sliceSize(pos + 8, size);
+        const bool isData = std::memcmp(type, "IDAT", 4) == 0;
+        if(isData || std::memcmp(type, "mgRS", 4) == 0) {
+            /* The CRC includes the chunk type */
+            const UnsignedInt crc = crc32(0, reinterpret_cast<const Bytef*>(file.data() + pos + 4), size + 4);
+            if(crc != pngReadUnsignedInt(file.data() + pos + 8 + size))
+                return false;
+
+            if(isData) arrayAppend(stream, data);
+            else bands = data;
+        } else if(std::memcmp(type, "IEND", 4) == 0) break;
+
+        pos += size + 12;
+    }
+
+    if(!bands.data() || bands.size() < 4) return false;
+
+    const UnsignedInt rowsPerBand = pngReadUnsignedInt(bands.data());
+    if(!rowsPerBand) return false;
+    const std::size_t bandCount = (std::size_t(height) + rowsPerBand - 1)/rowsPerBand;
+    if(!bandCount || bands.size() != 4 + 4*bandCount) return false;
+
+    Containers::Array<UnsignedInt> offsets{NoInit, bandCount};
+    for(std::size_t i = 0; i != bandCount; ++i) {
+        offsets[i] = pngReadUnsignedInt(bands.data() + 4 + 4*i);
+        if((i ? offsets[i] <= offsets[i - 1] : offsets[i] < 2) || offsets[i] >= stream.size())
+            return false;
+    }
+
+    out.stream = Utility::move(stream);
+    out.rowsPerBand = rowsPerBand;
+    out.offsets = Utility::move(offsets);
+    return true;
+}
+
+inline UnsignedByte pngPaeth(const Int a, const Int b, const Int c) {
+    const Int p = a + b - c;
+    const Int pa = Math::abs(p - a);
+    const Int pb = Math::abs(p - b);
+    const Int pc = Math::abs(p - c);
+    if(pa <= pb && pa <= pc) return a;
+    if(pb <= pc) return b;
+    return c;
+}
+
+/* Unfilters a single row in place. The previous row is expected to be
+   already unfiltered, or nullptr for the first row of the image. Returns
+   false on an invalid filter type. */
+inline bool pngUnfilterRow(const UnsignedByte filter, UnsignedByte* const row, const UnsignedByte* const previous, const std::size_t size, const std::size_t pixelSize) {
+    switch(filter) {
+        case 0: /* None */
+            return true;
+        case 1: /* Sub */
+            for(std::size_t i = pixelSize; i < size; ++i)
+                row[i] += row[i - pixelSize];
+            return true;
+        case 2: /* Up */
+            if(previous) for(std::size_t i = 0; i != size; ++i)
+                row[i] += previous[i];
+            return true;
+        case 3: /* Average */
+            for(std::size_t i = 0; i != size; ++i)
+                row[i] += ((i >= pixelSize ? row[i - pixelSize] : 0) + (previous ? previous[i] : 0))/2;
+            return true;
+        case 4: /* Paeth */
+            for(std::size_t i = 0; i != size; ++i)
+                row[i] += pngPaeth(
+                    i >= pixelSize ? row[i - pixelSize] : 0,
+                    previous ? previous[i] : 0,
+                    i >= pixelSize && previous ? previous[i - pixelSize] : 0);
+            return true;
+    }
+
+    return false;
+}
+
+/* Decodes the bands into the output, optionally byte-swapping 16-bit
+   channels from big endian to little endian on the way. The output view is
+   expected to have the image height in the first dimension and the row size
+   in the second, with rows in any order and spacing, i.e. flipped for a Y-up
+   output. Returns false on a decompression or unfiltering failure, in which
+   case the output contents are unspecified and the file should be decoded
+   the usual way. */
+inline bool pngDecodeBands(const PngBands& bands, const std::size_t pixelSize, const bool swap16, const Containers::StridedArrayView2D<char>& out, UnsignedInt threadCount) {
+    const std::size_t height = out.size()[0];
+    const std::size_t rowSize = out.size()[1];
+    const std::size_t filteredRowSize = rowSize + 1;
+    const std::size_t bandCount = bands.offsets.size();
+
+    /* Decompressed data including the filter byte at the start of each row.
+       Rows get unfiltered in place and then copied to the output. */
+    Containers::Array<UnsignedByte> filtered{NoInit, filteredRowSize*height};
+
+    /* 0 if the band wasn't processed yet, 1 if decompressed but needs to be
+       unfiltered after the previous band, 2 if done, 3 on failure */
+    Containers::Array<UnsignedByte> states{ValueInit, bandCount};
+
+    const auto unfilterCopy = [&](const std::size_t band) {
+        const std::size_t begin = band*bands.rowsPerBand;
+        const std::size_t end = Math::min(begin + bands.rowsPerBand, height);
+        for(std::size_t i = begin; i != end; ++i) {
+            UnsignedByte* const row = filtered + i*filteredRowSize;
+            if(!pngUnfilterRow(row[0], row + 1, i ? row - rowSize : nullptr, rowSize, pixelSize))
+                return false;
+
+            char* const dst = static_cast<char*>(out[i].data());
+            std::memcpy(dst, row + 1, rowSize);
+            if(swap16) for(std::size_t j = 0; j + 1 < rowSize; j += 2) {
+                const char tmp = dst[j];
+                dst[j] = dst[j + 1];
+                dst[j + 1] = tmp;
+            }
+        }
+        return true;
+    };
+
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = Math::min(threadCount, UnsignedInt(bandCount));
+    std::atomic<std::size_t> next{0};
+    #else
+    std::size_t next = 0;
+    #endif
+    const auto decode = [&]() {
+        for(std::size_t band; (band = next++) < bandCount; ) {
+            const std::size_t begin = band*bands.rowsPerBand;
+            const std::size_t end = Math::min(begin + bands.rowsPerBand, height);
+            const std::size_t inputEnd = band + 1 == bandCount ? bands.stream.size() : bands.offsets[band + 1];
+
+            /* Raw deflate without the zlib header and checksum, as each band
+               is just a range in the middle of the stream */
+            z_stream stream{};
+            if(inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+                states[band] = 3;
+                continue;
+            }
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(bands.stream.data() + bands.offsets[band]));
+            stream.avail_in = inputEnd - bands.offsets[band];
+            stream.next_out = filtered + begin*filteredRowSize;
+            stream.avail_out = (end - begin)*filteredRowSize;
+            const int result = inflate(&stream, Z_SYNC_FLUSH);
+            inflateEnd(&stream);
+
+            /* The band has to decompress to exactly its rows. The last band
+               ends with a final block, the others just run out of input. */
+            if(stream.avail_out || (band + 1 == bandCount ? result != Z_STREAM_END : result != Z_OK && result != Z_BUF_ERROR)) {
+                states[band] = 3;
+                continue;
+            }
+
+            /* If the first row doesn't depend on the previous band, unfilter
+               right away, otherwise postpone */
+            const UnsignedByte filter = filtered[begin*filteredRowSize];
+            if(!band || filter == 0 || filter == 1)
+                states[band] = unfilterCopy(band) ? 2 : 3;
+            else
+                states[band] = 1;
+        }
+    };
+
+    /* The calling thread is one of the workers */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{decode};
+    decode();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    decode();
+    #endif
+
+    /* Unfilter the postponed bands in order, now that all bands before are
+       unfiltered */
+    for(std::size_t band = 0; band != bandCount; ++band) {
+        if(states[band] == 3) return false;
+        if(states[band] == 1 && !unfilterCopy(band)) return false;
+    }
+
+    return true;
+}
+
+}}}
+
+#endif
@@ -25,7 +25,7 @@
 
 #include "PngImporter.h"
 
-#include <cstring> /* std::strcmp(), std::memcpy() */
+#include <cstring> /* std::strcmp(), std::memcpy(), std::memset() */
 #include <png.h>
 /*
     The <csetjmp> header has to be included *after* png.h, otherwise older
@@ -46,21 +46,45 @@
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/asyncImageImport.h"
+#include "Magnum/Implementation/instrumentation.h"
+#include "Magnum/Implementation/outputAllocator.h"
+#include "MagnumPlugins/PngImporter/PngBands.h"
+
 namespace Magnum { namespace Trade {
 
 PngImporter::PngImporter() = default;
 
 PngImporter::PngImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
 
-PngImporter::~PngImporter() = default;
+struct PngImporter::AsyncState: Magnum::Implementation::AsyncImageImport {};
+
+PngImporter::~PngImporter() {
+    if(_async) _async->wait();
+}
+
+bool PngImporter::image2DAsync(const UnsignedInt id, const UnsignedInt level, void(*const executor)(void(*)(void*), void*, void*), void(*const callback)(UnsignedInt, UnsignedInt, Containers::Optional<ImageData2D>&&, void*), void* const userData) {
+    if(!_async) _async.emplace();
+    return _async->schedule("Trade::PngImporter::image2DAsync():", *this, id, level, executor, callback, userData);
+}
+
+void PngImporter::setOutputAllocator(char*(*const allocator)(std::size_t, void*), void* const userData) {
+    _outputAllocator = allocator;
+    _outputAllocatorUserData = userData;
+}
 
 ImporterFeatures PngImporter::doFeatures() const { return ImporterFeature::OpenData; }
 
 bool PngImporter::doIsOpened() const { return _in; }
 
-void PngImporter::doClose() { _in = nullptr; }
+void PngImporter::doClose() {
+    /* In-flight asynchronous imports reference the file, wait for them */
+    if(_async) _async->wait();
+    _in = nullptr;
+}
 
 void PngImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     /* Because here we're copying the data and using the _in to check if file
        is opened, having them nullptr would mean openData() would fail without
        any error message. It's not possible to do this check on the importer
@@ -85,6 +109,7 @@ void PngImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
 UnsignedInt PngImporter::doImage2DCount() const { return 1; }
 
 Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D"};
     /* Structures for reading the file */
     png_structp file = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
     /** @todo this will assert if the PNG major/minor version doesn't match,
@@ -102,7 +127,6 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
     Containers::ScopeGuard pngStateGuard{&pngState, [](PngState* state) {
         png_destroy_read_struct(&state->file, &state->info, nullptr);
     }};
-    Containers::Array<png_bytep> rows;
     Containers::Array<char> data;
 
     /* Error handling routine. Since we're replacing the png_default_error()
@@ -145,6 +169,11 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
     png_uint_32 channels = png_get_channels(file, info);
     png_uint_32 colorType = png_get_color_type(file, info);
 
+    /* Parallel decoding of row bands is possible only if the data don't need
+       any conversion, checked again after all conversions are set up below */
+    const png_uint_32 originalBits = bits;
+    const png_uint_32 originalColorType = colorType;
+
     /* Check image format, convert if necessary */
     switch(colorType) {
         /* Types that can be used without conversion */
@@ -232,21 +261,67 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
         or do detection based on what tool exported the image? such as blender
         producing premultiplied PNGs https://developer.blender.org/T24764 */
 
-    /* Initialize data array, align rows to four bytes */
+    /* Initialize data array, align rows to four bytes. The data is fully
+       overwritten by libpng except for the row padding, so instead of zeroing
+       the whole allocation only the padding is cleared. */
     CORRADE_INTERNAL_ASSERT(bits >= 8);
-    const std::size_t stride = ((size.x()*channels*bits/8 + 3)/4)*4;
-    data = Containers::Array<char>{stride*std::size_t(size.y())};
+    const std::size_t rowSize = size.x()*channels*bits/8;
+    const std::size_t stride = ((rowSize + 3)/4)*4;
+    {
+        Containers::Optional<Containers::Array<char>> allocated = Magnum::Implementation::allocateOutput("Trade::PngImporter::image2D():", _outputAllocator, _outputAllocatorUserData, stride*std::size_t(size.y()));
+        if(!allocated) return Containers::NullOpt;
+        data = Utility::move(*allocated);
+    }
+    if(stride != rowSize) for(Int i = 0; i != size.y(); ++i)
+        std::memset(data.data() + i*stride + rowSize, 0, stride - rowSize);
 
     /* Endianness correction for 16 bit depth */
     #ifndef CORRADE_TARGET_BIG_ENDIAN
     if(bits == 16) png_set_swap(file);
     #endif
 
-    /* Read image row by row */
-    rows = Containers::Array<png_bytep>{std::size_t(size.y())};
-    for(Int i = 0; i != size.y(); ++i)
-        rows[i] = reinterpret_cast<unsigned char*>(data.data()) + (size.y() - i - 1)*stride;
-    png_read_image(file, rows);
+    /* If the file describes independently compressed row bands, attempt to
+       decode them in parallel. Rows are again written bottom-up. */
+    bool decoded = false;
+    const UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(threadCount != 1 &&
+       bits == originalBits && colorType == originalColorType &&
+       !png_get_valid(file, info, PNG_INFO_tRNS) &&
+       png_get_interlace_type(file, info) == PNG_INTERLACE_NONE)
+    {
+        Implementation::PngBands bands;
+        if(Implementation::pngFindBands(_in, size.y(), bands)) {
+            const Containers::StridedArrayView2D<char> rows{data,
+                data.data() + (size.y() - 1)*stride,
+                {std::size_t(size.y()), rowSize},
+                {-std::ptrdiff_t(stride), 1}};
+            if(Implementation::pngDecodeBands(bands, channels*bits/8,
+                #ifndef CORRADE_TARGET_BIG_ENDIAN
+                bits == 16,
+                #else
+                false,
+                #endif
+                rows, threadCount))
+            {
+                if(flags() & ImporterFlag::Verbose)
+                    Debug{} << "Trade::PngImporter::image2D(): decoded" << bands.offsets.size() << "row bands in parallel";
+                decoded = true;
+            } else if(!(flags() & ImporterFlag::Quiet))
+                Warning{} << "Trade::PngImporter::image2D(): parallel decoding of row bands failed, falling back to serial decoding";
+        }
+    }
+
+    /* Read the image row by row directly into the output, bottom-up. Compared
+       to png_read_image() this doesn't need a temporary array of row pointers
+       allocated for every image. Interlaced images need multiple passes over
+       all rows, with each pass combining new pixels into the already decoded
+       data. */
+    if(!decoded) {
+        const Int passCount = png_set_interlace_handling(file);
+        for(Int pass = 0; pass != passCount; ++pass)
+            for(Int i = 0; i != size.y(); ++i)
+                png_read_row(file, reinterpret_cast<png_bytep>(data.data()) + (size.y() - i - 1)*stride, nullptr);
+    }
 
     /* 8-bit images */
     PixelFormat format;
@@ -275,7 +350,10 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
        Only 1, 2, 4, 8 or 16 bits per channel, we expand the 1/2/4 to 8 above */
     } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 
-    /* Always using the default 4-byte alignment */
+    /* Always using the default 4-byte alignment. Memory from the output
+       allocator isn't owned by the image. */
+    if(_outputAllocator)
+        return Trade::ImageData2D{format, size, DataFlag::Mutable, data};
     return Trade::ImageData2D{format, size, Utility::move(data)};
 }
 
@@ -30,6 +30,7 @@
  */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "MagnumPlugins/PngImporter/configure.h"
@@ -138,6 +139,59 @@ which has the support.
 The test for this plugin contains a file that can be used for verifying CgBI
 support.
 
+@subsection Trade-PngImporter-behavior-parallel Parallel decoding
+
+A regular PNG file is a single zlib stream where each row can depend on the
+previous one, so it can be decoded only serially. If a file however contains a
+private `mgRS` chunk, which describes the image as a sequence of row bands with
+each band compressed into an independently decodable part of the zlib stream,
+the bands get decompressed and unfiltered in parallel when the
+@cb{.ini} threads @ce @ref Trade-PngImporter-configuration "configuration option"
+is set to a value other than @cb{.ini} 1 @ce. Such files are produced for
+example by @ref Trade-PngImageConverter-behavior-parallel "PngImageConverter"
+with multithreaded compression enabled and are still valid PNGs that any other
+decoder can read as usual. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+application has to be linked to `pthread` on Linux for this to work.
+
+Parallel decoding is done only for non-interlaced 8- and 16-bit grayscale,
+grayscale + alpha, RGB and RGBA images that don't need any conversion ---
+palette images, images with a transparency mask, images with less than 8 bits
+per channel and a @cb{.ini} forceBitDepth @ce different from the file bit
+depth are always decoded serially. If the chunk doesn't match the image data,
+a warning is printed and the file is decoded serially.
+
+@subsection Trade-PngImporter-behavior-output-allocator Custom output allocator
+
+By default, imported image data are allocated with the default array allocator
+and owned by the returned @ref ImageData. With @ref setOutputAllocator() it's
+possible to supply a custom allocator instead, for example one suballocating
+from an arena or from a persistently mapped GPU staging buffer, which avoids a
+copy when uploading. The allocator gets the size in bytes and the user data
+pointer and returns a pointer to memory of at least given size aligned to at
+least four bytes, or @cpp nullptr @ce on failure, in which case the import
+fails with an error. The returned image then only references the memory, with
+@ref DataFlag::Mutable set, and it's up to the application to keep it alive for
+as long as the image is used.
+
+@subsection Trade-PngImporter-behavior-async Asynchronous import
+
+The @ref image2DAsync() function schedules an import of given 2D image level
+on an executor supplied by the application and calls a callback with the
+result once done, so for example a render thread doesn't need to block on
+decoding. The executor gets a job function, a pointer to pass to it and the
+user data pointer, and is expected to call the job exactly once, either
+directly or from any other thread. The job imports the image using
+@ref image2D() and then calls the callback on the same thread, with
+@relativeref{Corrade,Containers::NullOpt} if the import failed.
+
+Asynchronous imports on a single importer instance are executed one after
+another and only one import of a particular image and level can be in flight
+at a time. While any of them are in flight, the importer shouldn't be used
+from other threads except for calling @ref image2DAsync() again. Calling
+@ref close(), opening another file or destroying the importer waits until all
+of them finish.
+
 @section Trade-PngImporter-configuration Plugin-specific configuration
 
 For some formats, it's possible to tune various output options through
@@ -158,6 +212,37 @@ class MAGNUM_PNGIMPORTER_EXPORT PngImporter: public AbstractImporter {
 
         ~PngImporter();
 
+        /**
+         * @brief Import a 2D image asynchronously
+         * @param id        Image ID, from range [0, @ref image2DCount())
+         * @param level     Mip level, from range
+         *      [0, @ref image2DLevelCount())
+         * @param executor  Function running the import job
+         * @param callback  Function called with the imported image
+         * @param userData  User data passed to @p executor and @p callback
+         * @return Whether the import was scheduled
+         * @m_since_latest_{plugins}
+         *
+         * If no file is opened, @p id or @p level is out of range or the
+         * same image and level is already being imported, prints a message
+         * to @relativeref{Magnum,Error} and returns @cpp false @ce without
+         * calling @p executor. See @ref Trade-PngImporter-behavior-async
+         * for more information.
+         */
+        virtual bool image2DAsync(UnsignedInt id, UnsignedInt level, void(*executor)(void(*)(void*), void*, void*), void(*callback)(UnsignedInt, UnsignedInt, Containers::Optional<ImageData2D>&&, void*), void* userData = nullptr);
+
+        /**
+         * @brief Set an output allocator
+         * @m_since_latest_{plugins}
+         *
+         * If set, imported image data are allocated using @p allocator, which
+         * gets the size in bytes and @p userData. Passing @cpp nullptr @ce
+         * restores the default. The setting is kept across opened files. See
+         * @ref Trade-PngImporter-behavior-output-allocator for more
+         * information.
+         */
+        virtual void setOutputAllocator(char*(*allocator)(std::size_t, void*), void* userData = nullptr);
+
     private:
         MAGNUM_PNGIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_PNGIMPORTER_LOCAL bool doIsOpened() const override;
@@ -168,6 +253,10 @@ class MAGNUM_PNGIMPORTER_EXPORT PngImporter: public AbstractImporter {
         MAGNUM_PNGIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
 
         Containers::Array<char> _in;
+        char*(*_outputAllocator)(std::size_t, void*){};
+        void* _outputAllocatorUserData{};
+        struct AsyncState;
+        Containers::Pointer<AsyncState> _async;
 };
 
 }}
@@ -24,7 +24,9 @@
 */
 
 #include <sstream>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
@@ -41,6 +43,8 @@
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/PngImporter/PngImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -63,10 +67,17 @@ struct PngImporterTest: TestSuite::Tester {
     void forceBitDepth16();
     void forceBitDepthInvalid();
 
+    void bands();
+    void bandsCorrupted();
+
     void openMemory();
     void openTwice();
     void importTwice();
 
+    void image2DAsync();
+    void outputAllocator();
+    void outputAllocatorFailed();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -146,6 +157,8 @@ constexpr struct {
     {"RGB", "rgb.png"},
     /* convert rgb.png -define png:exclude-chunks=date png8:palette.png */
     {"palette", "rgb-palette.png"},
+    /* rgb.png re-encoded with Adam7 interlacing and no filtering */
+    {"interlaced", "rgb-interlaced.png"},
 };
 
 constexpr struct {
@@ -241,6 +254,21 @@ const struct {
     }}, false, nullptr}
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+    UnsignedInt threads;
+    PixelFormat format;
+    UnsignedInt bandCount;
+} BandsData[]{
+    /* All generated with bands.py */
+    {"RGB, 2 threads", "rgb-bands.png", 2, PixelFormat::RGB8Unorm, 4},
+    {"RGB, all threads", "rgb-bands.png", 0, PixelFormat::RGB8Unorm, 4},
+    {"RGB, more threads than bands", "rgb-bands.png", 16, PixelFormat::RGB8Unorm, 4},
+    {"RGBA16, 2 threads", "rgba16-bands.png", 2, PixelFormat::RGBA16Unorm, 3},
+    {"gray + alpha, all threads", "ga-bands.png", 0, PixelFormat::RG8Unorm, 2},
+};
+
 /* Shared among all plugins that implement data copying optimizations */
 const struct {
     const char* name;
@@ -288,11 +316,20 @@ PngImporterTest::PngImporterTest() {
 
     addTests({&PngImporterTest::forceBitDepthInvalid});
 
+    addInstancedTests({&PngImporterTest::bands},
+        Containers::arraySize(BandsData));
+
+    addTests({&PngImporterTest::bandsCorrupted});
+
     addInstancedTests({&PngImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
     addTests({&PngImporterTest::openTwice,
-              &PngImporterTest::importTwice});
+              &PngImporterTest::importTwice,
+
+              &PngImporterTest::image2DAsync,
+              &PngImporterTest::outputAllocator,
+              &PngImporterTest::outputAllocatorFailed});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -557,6 +594,58 @@ void PngImporterTest::forceBitDepthInvalid() {
     CORRADE_COMPARE(out.str(), "Trade::PngImporter::image2D(): expected forceBitDepth to be 0, 8 or 16 but got 4\n");
 }
 
+void PngImporterTest::bands() {
+    auto&& data = BandsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Serial decoding of the same file is the ground truth */
+    Containers::Pointer<AbstractImporter> serialImporter = _manager.instantiate("PngImporter");
+    CORRADE_COMPARE(serialImporter->configuration().value<UnsignedInt>("threads"), 1);
+    CORRADE_VERIFY(serialImporter->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, data.filename)));
+    Containers::Optional<Trade::ImageData2D> expected = serialImporter->image2D(0);
+    CORRADE_VERIFY(expected);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    importer->configuration().setValue("threads", data.threads);
+    importer->addFlags(ImporterFlag::Verbose);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, data.filename)));
+
+    std::ostringstream out;
+    Containers::Optional<Trade::ImageData2D> image;
+    {
+        Debug redirectOutput{&out};
+        Warning redirectWarning{&out};
+        image = importer->image2D(0);
+    }
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::PngImporter::image2D(): decoded {} row bands in parallel\n", data.bandCount));
+    CORRADE_COMPARE(image->format(), data.format);
+    CORRADE_COMPARE_AS(*image, *expected, DebugTools::CompareImage);
+}
+
+void PngImporterTest::bandsCorrupted() {
+    Containers::Pointer<AbstractImporter> serialImporter = _manager.instantiate("PngImporter");
+    CORRADE_VERIFY(serialImporter->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, "rgb-bands.png")));
+    Containers::Optional<Trade::ImageData2D> expected = serialImporter->image2D(0);
+    CORRADE_VERIFY(expected);
+
+    /* The second band offset is off by one, the zlib stream itself is
+       valid */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    importer->configuration().setValue("threads", 2);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, "rgb-bands-corrupted.png")));
+
+    std::ostringstream out;
+    Containers::Optional<Trade::ImageData2D> image;
+    {
+        Warning redirectWarning{&out};
+        image = importer->image2D(0);
+    }
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(out.str(), "Trade::PngImporter::image2D(): parallel decoding of row bands failed, falling back to serial decoding\n");
+    CORRADE_COMPARE_AS(*image, *expected, DebugTools::CompareImage);
+}
+
 void PngImporterTest::openMemory() {
     /* Same as gray16() except that it uses openData() & openMemory() instead
        of openFile() to test data copying on import */
@@ -607,6 +696,117 @@ void PngImporterTest::importTwice() {
     }
 }
 
+
+void PngImporterTest::image2DAsync() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, "gray.png")));
+
+    struct State {
+        Containers::Array<Containers::Pair<void(*)(void*), void*>> jobs;
+        Containers::Optional<ImageData2D> image;
+        UnsignedInt called = 0;
+    } state;
+
+    /* The jobs are deferred so the in-flight state can be checked */
+    auto executor = [](void(*job)(void*), void* jobData, void* userData) {
+        arrayAppend(static_cast<State*>(userData)->jobs, InPlaceInit, job, jobData);
+    };
+    auto callback = [](UnsignedInt, UnsignedInt, Containers::Optional<ImageData2D>&& image, void* userData) {
+        State& state = *static_cast<State*>(userData);
+        state.image = Utility::move(image);
+        ++state.called;
+    };
+
+    PngImporter& png = static_cast<PngImporter&>(*importer);
+    CORRADE_VERIFY(png.image2DAsync(0, 0, executor, callback, &state));
+    CORRADE_COMPARE(state.jobs.size(), 1);
+    CORRADE_COMPARE(state.called, 0);
+
+    /* The same image can't be scheduled again until the first import
+       finishes, invalid IDs and levels are rejected right away */
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!png.image2DAsync(0, 0, executor, callback, &state));
+        CORRADE_VERIFY(!png.image2DAsync(1, 0, executor, callback, &state));
+        CORRADE_VERIFY(!png.image2DAsync(0, 1, executor, callback, &state));
+        CORRADE_COMPARE(out.str(),
+            "Trade::PngImporter::image2DAsync(): image 0 level 0 is already being imported\n"
+            "Trade::PngImporter::image2DAsync(): index 1 out of range for 1 entries\n"
+            "Trade::PngImporter::image2DAsync(): level 1 out of range for 1 entries\n");
+    }
+    CORRADE_COMPARE(state.jobs.size(), 1);
+
+    state.jobs[0].first()(state.jobs[0].second());
+    CORRADE_COMPARE(state.called, 1);
+    CORRADE_VERIFY(state.image);
+    CORRADE_COMPARE(state.image->size(), (Vector2i{3, 2}));
+    CORRADE_COMPARE(state.image->format(), PixelFormat::R8Unorm);
+
+    /* Once finished, it can be scheduled again, this time executed directly */
+    CORRADE_VERIFY(png.image2DAsync(0, 0, [](void(*job)(void*), void* jobData, void*) {
+        job(jobData);
+    }, callback, &state));
+    CORRADE_COMPARE(state.called, 2);
+    CORRADE_VERIFY(state.image);
+
+    /* Closing with nothing in flight doesn't block */
+    importer->close();
+    CORRADE_VERIFY(!importer->isOpened());
+}
+
+
+void PngImporterTest::outputAllocator() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+
+    /* The gray.png image is 3x2 with rows padded to four bytes */
+    struct Arena {
+        char data[16];
+        std::size_t offset = 0;
+    } arena;
+    static_cast<PngImporter&>(*importer).setOutputAllocator([](std::size_t size, void* userData) -> char* {
+        Arena& arena = *static_cast<Arena*>(userData);
+        if(arena.offset + size > sizeof(arena.data)) return nullptr;
+        char* const out = arena.data + arena.offset;
+        arena.offset += size;
+        return out;
+    }, &arena);
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, "gray.png")));
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->dataFlags(), DataFlag::Mutable);
+    CORRADE_COMPARE(image->data().data(), static_cast<const void*>(arena.data));
+    CORRADE_COMPARE(arena.offset, 8);
+    CORRADE_COMPARE(image->size(), (Vector2i{3, 2}));
+    CORRADE_COMPARE(image->format(), PixelFormat::R8Unorm);
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayView<char>({
+        '\xff', '\x88', '\x00', 0,
+        '\x88', '\x00', '\xff', 0
+    }), TestSuite::Compare::Container);
+
+    /* Resetting it goes back to owned allocations */
+    static_cast<PngImporter&>(*importer).setOutputAllocator(nullptr);
+    image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->dataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE(arena.offset, 8);
+}
+
+void PngImporterTest::outputAllocatorFailed() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    static_cast<PngImporter&>(*importer).setOutputAllocator([](std::size_t, void*) -> char* {
+        return nullptr;
+    });
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, "gray.png")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(0));
+    CORRADE_COMPARE(out.str(), "Trade::PngImporter::image2D(): output allocator failed to allocate 8 bytes\n");
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::PngImporterTest)
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+
+# Generates PNG files with independently compressed row bands described by a
+# private mgRS chunk, as documented in PngBands.h. Each band except the last
+# is terminated with a full flush. The first row of some bands intentionally
+# uses a filter depending on the previous row to test the serial unfiltering
+# fallback. Regenerate with
+#
+#   ./bands.py
+
+import struct
+import zlib
+
+def chunk(type, data):
+    return struct.pack('>I', len(data)) + type + data + struct.pack('>I', zlib.crc32(type + data))
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc: return a
+    if pb <= pc: return b
+    return c
+
+def filter(type, row, previous, pixel_size):
+    out = bytearray([type])
+    for i in range(len(row)):
+        a = row[i - pixel_size] if i >= pixel_size else 0
+        b = previous[i] if previous else 0
+        c = previous[i - pixel_size] if previous and i >= pixel_size else 0
+        predictor = [0, a, b, (a + b)//2, paeth(a, b, c)][type]
+        out.append((row[i] - predictor) & 0xff)
+    return out
+
+def generate(output, width, height, bit_depth, color_type, channels, rows_per_band, filters, corrupt=False):
+    pixel_size = channels*bit_depth//8
+    rows = [bytes((x*7 + y*31 + x*y*3) & 0xff for x in range(width*pixel_size)) for y in range(height)]
+
+    compressor = zlib.compressobj(9, zlib.DEFLATED, 15)
+    stream = bytearray()
+    offsets = []
+    for begin in range(0, height, rows_per_band):
+        data = bytearray()
+        for y in range(begin, min(begin + rows_per_band, height)):
+            data += filter(filters[y], rows[y], rows[y - 1] if y else None, pixel_size)
+        stream += compressor.compress(bytes(data))
+        if begin + rows_per_band < height:
+            stream += compressor.flush(zlib.Z_FULL_FLUSH)
+        else:
+            stream += compressor.flush(zlib.Z_FINISH)
+        offsets += [len(stream)]
+    # The first band starts after the two-byte zlib header, each following
+    # band where the previous ended
+    offsets = [2] + offsets[:-1]
+    if corrupt: offsets[1] += 1
+
+    out = b'\x89PNG\r\n\x1a\n'
+    out += chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, bit_depth, color_type, 0, 0, 0))
+    out += chunk(b'mgRS', struct.pack('>I', rows_per_band) + b''.join(struct.pack('>I', i) for i in offsets))
+    # Split the stream into more IDAT chunks to test their concatenation
+    split = len(stream)//2
+    out += chunk(b'IDAT', bytes(stream[:split]))
+    out += chunk(b'IDAT', bytes(stream[split:]))
+    out += chunk(b'IEND', b'')
+    open(output, 'wb').write(out)
+
+# Band 1 starts with Up and band 3 with Paeth, so they have to wait for the
+# previous band. Band 2 starts with Sub, band 0 with Paeth against a zero row.
+generate('rgb-bands.png', 5, 7, 8, 2, 3, 2, [4, 3, 2, 1, 1, 2, 4])
+generate('rgba16-bands.png', 3, 5, 16, 6, 4, 2, [1, 4, 0, 3, 1])
+generate('ga-bands.png', 4, 6, 8, 4, 2, 3, [2, 4, 3, 0, 1, 2])
+generate('rgb-bands-corrupted.png', 5, 7, 8, 2, 3, 2, [4, 3, 2, 1, 1, 2, 4], corrupt=True)
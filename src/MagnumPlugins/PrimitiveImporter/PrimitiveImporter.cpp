@@ -27,8 +27,12 @@
 
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Move.h>
 #include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/MeshTools/Copy.h>
 #include <Magnum/Primitives/Axis.h>
 #include <Magnum/Primitives/Capsule.h>
 #include <Magnum/Primitives/Circle.h>
@@ -46,24 +50,12 @@
 #include <Magnum/Trade/MeshData.h>
 #include <Magnum/Trade/SceneData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
 namespace Magnum { namespace Trade {
 
 using namespace Containers::Literals;
 
-PrimitiveImporter::PrimitiveImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
-
-PrimitiveImporter::~PrimitiveImporter() = default;
-
-ImporterFeatures PrimitiveImporter::doFeatures() const { return ImporterFeature::OpenData; }
-
-bool PrimitiveImporter::doIsOpened() const { return _opened; }
-
-void PrimitiveImporter::doClose() { _opened = false; }
-
-void PrimitiveImporter::doOpenData(Containers::Array<char>&&, DataFlags) {
-    _opened = true;
-}
-
 namespace {
 
 constexpr Containers::StringView Names[]{
@@ -118,6 +110,52 @@ constexpr Containers::StringView Names[]{
     /* 35 */ "uvSphereWireframe"_s
 };
 
+/* The gradient*Horizontal and gradient*Vertical variants share the
+   configuration group with the generic gradient */
+Containers::StringView configurationGroupName(const UnsignedInt id) {
+    if(Names[id].hasPrefix("gradient2D"_s)) return "gradient2D"_s;
+    if(Names[id].hasPrefix("gradient3D"_s)) return "gradient3D"_s;
+    return Names[id];
+}
+
+/* All values in the configuration group the primitive is generated from,
+   used to detect whether a cached mesh is still up-to-date */
+Containers::String configurationKey(const Utility::ConfigurationGroup& configuration, const UnsignedInt id) {
+    const Utility::ConfigurationGroup* const group = configuration.group(configurationGroupName(id));
+    if(!group) return {};
+
+    Containers::String key;
+    for(const Containers::Pair<Containers::StringView, Containers::StringView> value: group->values())
+        key = key + value.first() + "="_s + value.second() + "\n"_s;
+    return key;
+}
+
+}
+
+struct PrimitiveImporter::State {
+    Containers::Optional<MeshData> meshes[Containers::arraySize(Names)];
+    Containers::String meshConfigurations[Containers::arraySize(Names)];
+};
+
+PrimitiveImporter::PrimitiveImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin}, _state{InPlaceInit} {}
+
+PrimitiveImporter::~PrimitiveImporter() = default;
+
+ImporterFeatures PrimitiveImporter::doFeatures() const { return ImporterFeature::OpenData; }
+
+bool PrimitiveImporter::doIsOpened() const { return _opened; }
+
+/* The mesh cache is deliberately kept, the primitives don't depend on the
+   opened data in any way */
+void PrimitiveImporter::doClose() { _opened = false; }
+
+void PrimitiveImporter::doOpenData(Containers::Array<char>&&, DataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
+    _opened = true;
+}
+
+namespace {
+
 constexpr Vector2 translation2DForIndex(UnsignedInt id) {
     /** @todo use constexpr vector multiplication here once C++14 is used */
     return {3.0f*(-1.5f + Float(id % 4)), 3.0f*(-1.0f + Float(id / 4))};
@@ -237,6 +275,7 @@ Int PrimitiveImporter::doDefaultScene() const { return 1; }
 UnsignedInt PrimitiveImporter::doSceneCount() const { return 2; }
 
 Containers::Optional<SceneData> PrimitiveImporter::doScene(const UnsignedInt id) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doScene", {}, id};
     if(id == 0) return SceneData{SceneMappingType::UnsignedInt,
         Containers::arraySize(Names),
         DataFlag::Global, Scene2D, sceneFieldDataNonOwningArray(SceneFields2D)};
@@ -280,7 +319,26 @@ Containers::String PrimitiveImporter::doMeshName(const UnsignedInt id) {
     return Names[id];
 }
 
-Containers::Optional<MeshData> PrimitiveImporter::doMesh(UnsignedInt id, UnsignedInt) {
+Containers::Optional<MeshData> PrimitiveImporter::doMesh(const UnsignedInt id, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMesh", {}, id};
+    if(!configuration().value<bool>("cache")) {
+        /* Free whatever was cached before, if the option got disabled */
+        _state->meshes[id] = Containers::NullOpt;
+        return generateMesh(id);
+    }
+
+    /* Regenerate the mesh if it's not cached yet or if the options it was
+       generated with changed since */
+    Containers::String meshConfiguration = configurationKey(configuration(), id);
+    if(!_state->meshes[id] || _state->meshConfigurations[id] != meshConfiguration) {
+        _state->meshes[id] = generateMesh(id);
+        _state->meshConfigurations[id] = Utility::move(meshConfiguration);
+    }
+
+    return MeshTools::copy(*_state->meshes[id]);
+}
+
+Containers::Optional<MeshData> PrimitiveImporter::generateMesh(const UnsignedInt id) {
     if(Names[id] == "axis2D"_s)
         return Primitives::axis2D();
 
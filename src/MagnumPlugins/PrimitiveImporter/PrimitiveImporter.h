@@ -30,6 +30,7 @@
  * @m_since_{plugins,2020,06}
  */
 
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "MagnumPlugins/PrimitiveImporter/configure.h"
@@ -128,6 +129,20 @@ Both objects and meshes can be accessed through name of the respective function
 in the @ref Primitives namespace (so e.g. loading a `uvSphereSolid` mesh will
 give you @ref Primitives::uvSphereSolid()).
 
+@subsection Trade-PrimitiveImporter-behavior-cache Mesh caching
+
+By default, each @ref mesh() call generates the primitive from scratch. If the
+@cb{.ini} cache @ce @ref Trade-PrimitiveImporter-configuration "configuration option"
+is enabled, the generated mesh is kept inside the importer and subsequent
+@ref mesh() calls return just a copy of it, made with @ref MeshTools::copy().
+The cache is kept across @ref close() and @ref openData() calls as the
+primitives don't depend on the opened data. A mesh is regenerated if any
+option in its configuration group changes, so e.g. changing the
+@cb{.ini} subdivisions @ce of @cb{.ini} [icosphereSolid] @ce affects the next
+import of `icosphereSolid` without having to clear anything explicitly.
+Disabling the option again frees the cached data on the next import of given
+mesh.
+
 @section Trade-PrimitiveImporter-configuration Plugin-specific configuration
 
 By default the primitives are created with the same options that were used to
@@ -171,6 +186,10 @@ class MAGNUM_PRIMITIVEIMPORTER_EXPORT PrimitiveImporter: public AbstractImporter
         MAGNUM_PRIMITIVEIMPORTER_LOCAL Containers::String doMeshName(UnsignedInt id) override;
         MAGNUM_PRIMITIVEIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
 
+        MAGNUM_PRIMITIVEIMPORTER_LOCAL Containers::Optional<MeshData> generateMesh(UnsignedInt id);
+
+        struct State;
+        Containers::Pointer<State> _state;
         bool _opened = false;
 };
 
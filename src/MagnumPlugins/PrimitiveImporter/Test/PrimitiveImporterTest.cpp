@@ -23,13 +23,17 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/Math/Color.h>
 #include <Magnum/Math/Matrix3.h>
 #include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Vector3.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/MeshData.h>
 #include <Magnum/Trade/SceneData.h>
@@ -43,6 +47,7 @@ struct PrimitiveImporterTest: TestSuite::Tester {
 
     void test();
     void mesh();
+    void meshCache();
 
     void scene2D();
     void scene3D();
@@ -113,7 +118,9 @@ PrimitiveImporterTest::PrimitiveImporterTest() {
     addInstancedTests({&PrimitiveImporterTest::mesh},
         Containers::arraySize(Data));
 
-    addTests({&PrimitiveImporterTest::scene2D,
+    addTests({&PrimitiveImporterTest::meshCache,
+
+              &PrimitiveImporterTest::scene2D,
               &PrimitiveImporterTest::scene3D});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
@@ -160,6 +167,67 @@ void PrimitiveImporterTest::mesh() {
     } else CORRADE_VERIFY(!mesh->isIndexed());
 }
 
+void PrimitiveImporterTest::meshCache() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PrimitiveImporter");
+    importer->configuration().setValue("cache", true);
+    CORRADE_VERIFY(importer->openData({}));
+
+    Containers::Optional<Trade::MeshData> a = importer->mesh("icosphereSolid");
+    CORRADE_VERIFY(a);
+    CORRADE_COMPARE(a->vertexCount(), 42);
+    CORRADE_COMPARE(a->indexCount(), 240);
+    CORRADE_COMPARE(a->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+
+    /* Modifying the returned copy doesn't affect the cached data */
+    const Vector3 position = a->positions3DAsArray()[0];
+    a->mutableAttribute<Vector3>(MeshAttribute::Position)[0] = {};
+
+    /* Stays cached across close and reopen as well */
+    importer->close();
+    CORRADE_VERIFY(importer->openData({}));
+
+    Containers::Optional<Trade::MeshData> b = importer->mesh("icosphereSolid");
+    CORRADE_VERIFY(b);
+    CORRADE_COMPARE(b->vertexCount(), 42);
+    CORRADE_COMPARE(b->positions3DAsArray()[0], position);
+    CORRADE_VERIFY(b->vertexData().data() != a->vertexData().data());
+
+    /* Changing the configuration regenerates the mesh */
+    importer->configuration().group("icosphereSolid")->setValue("subdivisions", 2);
+    Containers::Optional<Trade::MeshData> c = importer->mesh("icosphereSolid");
+    CORRADE_VERIFY(c);
+    CORRADE_COMPARE(c->vertexCount(), 162);
+    CORRADE_COMPARE(c->indexCount(), 960);
+
+    /* Variants sharing a configuration group are tracked too */
+    Containers::Optional<Trade::MeshData> gradientA = importer->mesh("gradient2DHorizontal");
+    CORRADE_VERIFY(gradientA);
+    importer->configuration().group("gradient2D")->setValue("colorA", Color4{1.0f, 0.0f, 0.0f, 1.0f});
+    Containers::Optional<Trade::MeshData> gradientB = importer->mesh("gradient2DHorizontal");
+    CORRADE_VERIFY(gradientB);
+    Containers::Array<Color4> colorsA = gradientA->colorsAsArray();
+    Containers::Array<Color4> colorsB = gradientB->colorsAsArray();
+    CORRADE_COMPARE(colorsB.size(), colorsA.size());
+    std::size_t changed = 0;
+    for(std::size_t i = 0; i != colorsB.size(); ++i) {
+        if(colorsB[i] == colorsA[i]) continue;
+        CORRADE_COMPARE(colorsB[i], (Color4{1.0f, 0.0f, 0.0f, 1.0f}));
+        ++changed;
+    }
+    CORRADE_COMPARE(changed, 2);
+
+    /* Meshes without any options are cached as well */
+    Containers::Optional<Trade::MeshData> cube = importer->mesh("cubeSolid");
+    CORRADE_VERIFY(cube);
+    CORRADE_COMPARE(cube->vertexCount(), 24);
+
+    /* Disabling the cache still gives back the same data */
+    importer->configuration().setValue("cache", false);
+    Containers::Optional<Trade::MeshData> d = importer->mesh("icosphereSolid");
+    CORRADE_VERIFY(d);
+    CORRADE_COMPARE(d->vertexCount(), 162);
+}
+
 void PrimitiveImporterTest::scene2D() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PrimitiveImporter");
 
@@ -0,0 +1,211 @@
+#ifndef Magnum_Trade_ScenePackHeader_h
+#define Magnum_Trade_ScenePackHeader_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Trade/SceneData.h>
+
+/* Used by both ScenePackImporter and ScenePackSceneConverter, which is why it
+   isn't directly inside ScenePackImporter.cpp. OTOH it doesn't need to be
+   exposed publicly, which is why it has no docblocks. */
+
+namespace Magnum { namespace Trade { namespace Implementation {
+
+/* The file consists of ScenePackHeader, followed by chunkCount ScenePackChunk
+   entries, followed by a table of null-terminated chunk names and then the
+   chunk data, each chunk starting at an offset aligned to ScenePackAlignment
+   bytes. All offsets in ScenePackChunk are from the start of the file, all
+   offsets inside the chunks are from the start of given chunk. The data are
+   stored in exactly the layout the Trade::*Data classes reference them in,
+   in the native endianness, so the importer only validates the ranges and
+   returns views on the file. */
+
+constexpr char ScenePackMagic[8]{'M', 'G', 'N', 'S', 'P', 'A', 'C', 'K'};
+constexpr UnsignedInt ScenePackVersion = 1;
+constexpr std::size_t ScenePackAlignment = 16;
+
+enum class ScenePackChunkType: UnsignedInt {
+    Scene = 1,
+    Mesh,
+    Material,
+    Texture,
+    Image2D,
+    Image3D
+};
+
+constexpr UnsignedInt ScenePackChunkTypeCount = 6;
+
+struct ScenePackHeader {
+    char magic[8];              /* ScenePackMagic */
+    UnsignedInt version;        /* ScenePackVersion */
+    /* sizeof(MaterialAttributeData), as material attributes are stored in
+       their in-memory representation */
+    UnsignedInt materialAttributeSize;
+    UnsignedInt chunkCount;
+    Int defaultScene;           /* -1 if there's no default scene */
+};
+
+static_assert(sizeof(ScenePackHeader) == 24, "Improper size of ScenePackHeader struct");
+
+struct ScenePackChunk {
+    UnsignedInt type;           /* ScenePackChunkType */
+    UnsignedInt nameSize;       /* without the null terminator */
+    UnsignedLong nameOffset;
+    UnsignedLong offset;        /* aligned to ScenePackAlignment */
+    UnsignedLong size;
+};
+
+static_assert(sizeof(ScenePackChunk) == 32, "Improper size of ScenePackChunk struct");
+
+/* A scene chunk is ScenePackScene, followed by fieldCount ScenePackSceneField
+   entries and the SceneData::data() contents at dataOffset */
+struct ScenePackScene {
+    UnsignedInt mappingType;    /* SceneMappingType */
+    UnsignedInt fieldCount;
+    UnsignedLong mappingBound;
+    UnsignedLong dataOffset;
+    UnsignedLong dataSize;
+};
+
+static_assert(sizeof(ScenePackScene) == 32, "Improper size of ScenePackScene struct");
+
+struct ScenePackSceneField {
+    UnsignedInt name;           /* SceneField */
+    UnsignedInt type;           /* SceneFieldType */
+    UnsignedLong size;
+    /* Offsets relative to dataOffset of the scene */
+    UnsignedLong mappingOffset;
+    Long mappingStride;
+    UnsignedLong fieldOffset;
+    Long fieldStride;
+    UnsignedShort fieldArraySize;
+    UnsignedShort flags;        /* SceneFieldFlags without OffsetOnly */
+    UnsignedInt reserved;
+};
+
+static_assert(sizeof(ScenePackSceneField) == 56, "Improper size of ScenePackSceneField struct");
+
+/* Bit and string fields would need the bit / string data stored alongside,
+   pointers make no sense in a file. Such fields are rejected by both the
+   converter and the importer. */
+inline bool isScenePackFieldTypeSupported(const SceneFieldType type) {
+    switch(type) {
+        case SceneFieldType::Bit:
+        case SceneFieldType::StringOffset8:
+        case SceneFieldType::StringOffset16:
+        case SceneFieldType::StringOffset32:
+        case SceneFieldType::StringOffset64:
+        case SceneFieldType::StringRange8:
+        case SceneFieldType::StringRange16:
+        case SceneFieldType::StringRange32:
+        case SceneFieldType::StringRange64:
+        case SceneFieldType::StringRangeNullTerminated8:
+        case SceneFieldType::StringRangeNullTerminated16:
+        case SceneFieldType::StringRangeNullTerminated32:
+        case SceneFieldType::StringRangeNullTerminated64:
+        case SceneFieldType::Pointer:
+        case SceneFieldType::MutablePointer:
+            return false;
+        default:
+            return true;
+    }
+}
+
+/* A mesh chunk is ScenePackMesh, followed by attributeCount
+   ScenePackMeshAttribute entries and the MeshData::indexData() and
+   vertexData() contents at indexDataOffset and vertexDataOffset */
+struct ScenePackMesh {
+    UnsignedInt primitive;      /* MeshPrimitive */
+    UnsignedInt indexType;      /* MeshIndexType, 0 if not indexed */
+    UnsignedInt indexCount;
+    Int indexStride;
+    UnsignedLong indexOffset;   /* relative to indexDataOffset */
+    UnsignedInt vertexCount;
+    UnsignedInt attributeCount;
+    UnsignedLong indexDataOffset;
+    UnsignedLong indexDataSize;
+    UnsignedLong vertexDataOffset;
+    UnsignedLong vertexDataSize;
+};
+
+static_assert(sizeof(ScenePackMesh) == 64, "Improper size of ScenePackMesh struct");
+
+struct ScenePackMeshAttribute {
+    UnsignedInt name;           /* MeshAttribute */
+    UnsignedInt format;         /* VertexFormat */
+    UnsignedLong offset;        /* relative to vertexDataOffset */
+    Int stride;
+    UnsignedShort arraySize;
+    Short morphTargetId;        /* -1 if not a morph target */
+};
+
+static_assert(sizeof(ScenePackMeshAttribute) == 24, "Improper size of ScenePackMeshAttribute struct");
+
+/* A material chunk is ScenePackMaterial, followed by layerCount UnsignedInt
+   layer end offsets, padded to ScenePackAlignment, and attributeCount
+   MaterialAttributeData entries. The layer offsets are empty if the material
+   has just the base layer. */
+struct ScenePackMaterial {
+    UnsignedInt types;          /* MaterialTypes */
+    UnsignedInt layerCount;
+    UnsignedInt attributeCount;
+    UnsignedInt reserved;
+};
+
+static_assert(sizeof(ScenePackMaterial) == 16, "Improper size of ScenePackMaterial struct");
+
+struct ScenePackTexture {
+    UnsignedInt type;           /* TextureType */
+    UnsignedInt minificationFilter; /* SamplerFilter */
+    UnsignedInt magnificationFilter; /* SamplerFilter */
+    UnsignedInt mipmapFilter;   /* SamplerMipmap */
+    UnsignedInt wrapping[3];    /* SamplerWrapping */
+    UnsignedInt image;
+};
+
+static_assert(sizeof(ScenePackTexture) == 32, "Improper size of ScenePackTexture struct");
+
+/* An image chunk is ScenePackImage, followed by the pixel data at
+   dataOffset. Uncompressed pixel data have rows padded to alignment,
+   compressed data are stored with the default CompressedPixelStorage. */
+struct ScenePackImage {
+    UnsignedInt compressed;     /* 0 or 1 */
+    UnsignedInt format;         /* PixelFormat or CompressedPixelFormat */
+    UnsignedInt formatExtra;    /* 0 for compressed images */
+    UnsignedInt pixelSize;      /* 0 for compressed images */
+    UnsignedInt flags;          /* ImageFlags2D or ImageFlags3D */
+    UnsignedInt alignment;      /* PixelStorage::alignment(), 1 or 4 */
+    Int size[3];                /* size[2] is 1 for 2D images */
+    UnsignedInt reserved;
+    UnsignedLong dataOffset;
+    UnsignedLong dataSize;
+};
+
+static_assert(sizeof(ScenePackImage) == 56, "Improper size of ScenePackImage struct");
+
+}}}
+
+#endif
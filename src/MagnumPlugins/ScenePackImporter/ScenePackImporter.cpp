@@ -0,0 +1,732 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "ScenePackImporter.h"
+
+#include <cstring>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MaterialData.h>
+#include <Magnum/Trade/MeshData.h>
+#include <Magnum/Trade/SceneData.h>
+#include <Magnum/Trade/TextureData.h>
+
+#include "Magnum/Implementation/instrumentation.h"
+#include "Magnum/Implementation/mapFile.h"
+#include "Magnum/Implementation/meshAttributeValidity.h"
+#include "MagnumPlugins/ScenePackImporter/ScenePackHeader.h"
+
+namespace Magnum { namespace Trade {
+
+using Implementation::ScenePackChunkType;
+
+struct ScenePackImporter::State {
+    /* Memory-mapped input file, if the mapFile option was enabled. The `data`
+       is a non-owning view on it in that case. */
+    #ifdef MAGNUM_IMPLEMENTATION_MAP_FILE
+    Magnum::Implementation::MappedFile mapped;
+    #endif
+    Containers::Array<char> data;
+    Containers::ArrayView<const Implementation::ScenePackChunk> chunks;
+    /* Indices into `chunks` for each ScenePackChunkType */
+    Containers::Array<UnsignedInt> chunksForType[Implementation::ScenePackChunkTypeCount];
+    Int defaultScene;
+
+    Containers::ArrayView<const UnsignedInt> chunksFor(ScenePackChunkType type) const {
+        return chunksForType[UnsignedInt(type) - 1];
+    }
+
+    /* Chunk offset, size and name were validated in doOpenData() already */
+    Containers::ArrayView<const char> chunk(ScenePackChunkType type, UnsignedInt id) const {
+        const Implementation::ScenePackChunk& chunk = chunks[chunksFor(type)[id]];
+        return data.sliceSize(std::size_t(chunk.offset), std::size_t(chunk.size));
+    }
+
+    Containers::StringView name(ScenePackChunkType type, UnsignedInt id) const {
+        const Implementation::ScenePackChunk& chunk = chunks[chunksFor(type)[id]];
+        return {data.data() + chunk.nameOffset, chunk.nameSize, Containers::StringViewFlag::NullTerminated};
+    }
+
+    Int forName(ScenePackChunkType type, Containers::StringView name) const {
+        for(std::size_t i = 0, max = chunksFor(type).size(); i != max; ++i)
+            if(this->name(type, i) == name) return Int(i);
+        return -1;
+    }
+};
+
+namespace {
+
+/* Checks that `size` items of `itemSize` bytes, `stride` bytes apart and the
+   first starting at `offset` are all inside `dataSize` bytes. Item size can
+   be 0 for implementation-specific formats, in which case just the item
+   starts are checked. Size and stride come from the file, so the distance
+   between the first and last item is bounded by the data size before
+   calculating it to avoid an overflow. */
+bool isStridedRangeInside(const std::size_t dataSize, const UnsignedLong offset, const std::size_t size, const Long stride, const std::size_t itemSize) {
+    if(!size) return true;
+    if(offset > dataSize) return false;
+
+    const UnsignedLong absStride = stride < 0 ? UnsignedLong(-(stride + 1)) + 1 : UnsignedLong(stride);
+    if(absStride && size - 1 > dataSize/absStride) return false;
+
+    const Long span = Long(size - 1)*stride;
+    return Long(offset) + Math::min(span, Long{0}) >= 0 &&
+        Long(offset) + Math::max(span, Long{0}) + Long(itemSize) <= Long(dataSize);
+}
+
+bool isRangeInside(const std::size_t dataSize, const UnsignedLong offset, const UnsignedLong size) {
+    return offset <= dataSize && size <= dataSize - offset;
+}
+
+/* Enum values coming from the file are passed to Magnum APIs that assert on
+   invalid values, so they have to be range-checked first.
+   @todo These need to be extended when new values are added to the enums.
+    Ideally Magnum itself should provide some kind of a "format count"
+    constant. */
+constexpr SceneFieldType LastSceneFieldType = SceneFieldType::StringRangeNullTerminated64;
+constexpr MaterialAttributeType LastMaterialAttributeType = MaterialAttributeType::Buffer;
+constexpr PixelFormat LastPixelFormat = PixelFormat::Depth32FStencil8UI;
+constexpr CompressedPixelFormat LastCompressedPixelFormat = CompressedPixelFormat::PvrtcRGBA4bppSrgb;
+
+bool isSceneFieldValid(const SceneField name) {
+    switch(name) {
+        case SceneField::Parent:
+        case SceneField::Transformation:
+        case SceneField::Translation:
+        case SceneField::Rotation:
+        case SceneField::Scaling:
+        case SceneField::Mesh:
+        case SceneField::MeshMaterial:
+        case SceneField::Light:
+        case SceneField::Camera:
+        case SceneField::Skin:
+        case SceneField::ImporterState:
+        case SceneField::Custom:
+            return true;
+    }
+
+    return isSceneFieldCustom(name);
+}
+
+/* Fields that SceneData expects to share the object mapping have the same
+   non-zero group */
+UnsignedInt sharedMappingGroup(const SceneField name) {
+    switch(name) {
+        case SceneField::Translation:
+        case SceneField::Rotation:
+        case SceneField::Scaling:
+            return 1;
+        case SceneField::Mesh:
+        case SceneField::MeshMaterial:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> importImage(const char* const messagePrefix, const Containers::ArrayView<const char> chunk) {
+    if(chunk.size() < sizeof(Implementation::ScenePackImage)) {
+        Error{} << messagePrefix << "expected at least" << sizeof(Implementation::ScenePackImage) << "bytes but got" << chunk.size();
+        return {};
+    }
+
+    const auto& header = *reinterpret_cast<const Implementation::ScenePackImage*>(chunk.data());
+    if(!isRangeInside(chunk.size(), header.dataOffset, header.dataSize)) {
+        Error{} << messagePrefix << "image data of" << header.dataSize << "bytes at offset" << header.dataOffset << "out of range for" << chunk.size() << "bytes";
+        return {};
+    }
+
+    const Vector3i size = Vector3i::from(header.size);
+    if(size.min() < 0 || (dimensions == 2 && size.z() != 1)) {
+        Error{} << messagePrefix << "invalid image size" << size;
+        return {};
+    }
+
+    /* Cube maps have to be square and have whole sets of faces */
+    const ImageFlags<dimensions> flags = ImageFlag<dimensions>(header.flags);
+    const UnsignedInt knownFlags = dimensions == 2 ? UnsignedInt(ImageFlag2D::Array) : UnsignedInt(ImageFlag3D::Array|ImageFlag3D::CubeMap);
+    if((header.flags & ~knownFlags) || (dimensions == 3 && (header.flags & UnsignedInt(ImageFlag3D::CubeMap)) && (size.x() != size.y() || size.z() % 6 || (!(header.flags & UnsignedInt(ImageFlag3D::Array)) && size.z() != 6)))) {
+        Error{} << messagePrefix << "invalid flags" << flags << "for an image of size" << size;
+        return {};
+    }
+
+    const Containers::ArrayView<const char> data = chunk.sliceSize(std::size_t(header.dataOffset), std::size_t(header.dataSize));
+    const VectorTypeFor<dimensions, Int> imageSize = Math::Vector<dimensions, Int>::pad(size);
+    if(header.compressed) {
+        /* Size of implementation-specific formats is unknown, for those the
+           data size can't be checked */
+        const CompressedPixelFormat format = CompressedPixelFormat(header.format);
+        if(isCompressedPixelFormatImplementationSpecific(format))
+            return ImageData<dimensions>{format, imageSize, DataFlags{}, data, flags};
+
+        if(!header.format || header.format > UnsignedInt(LastCompressedPixelFormat) || (dimensions == 2 && compressedPixelFormatBlockSize(format).z() != 1)) {
+            Error{} << messagePrefix << "invalid compressed format" << format;
+            return {};
+        }
+
+        const Vector3i blockSize = compressedPixelFormatBlockSize(format);
+        const std::size_t expectedDataSize = std::size_t(((size + blockSize - Vector3i{1})/blockSize).product())*compressedPixelFormatBlockDataSize(format);
+        if(data.size() < expectedDataSize) {
+            Error{} << messagePrefix << "expected at least" << expectedDataSize << "bytes of compressed data but got" << data.size();
+            return {};
+        }
+
+        return ImageData<dimensions>{format, imageSize, DataFlags{}, data, flags};
+    }
+
+    /* Size of implementation-specific formats is stored in pixelSize, for
+       the generic ones it has to match */
+    const PixelFormat format = PixelFormat(header.format);
+    if(!header.format || !header.pixelSize || header.pixelSize > 256 || (header.alignment != 1 && header.alignment != 2 && header.alignment != 4 && header.alignment != 8) || (!isPixelFormatImplementationSpecific(format) && (header.format > UnsignedInt(LastPixelFormat) || header.pixelSize != pixelFormatSize(format)))) {
+        Error{} << messagePrefix << "invalid format" << format << Debug::nospace << ", pixel size" << header.pixelSize << "or alignment" << header.alignment;
+        return {};
+    }
+
+    const std::size_t rowSize = std::size_t(size.x())*header.pixelSize;
+    const std::size_t paddedRowSize = (rowSize + header.alignment - 1)/header.alignment*header.alignment;
+    const std::size_t expectedDataSize = paddedRowSize*size.y()*size.z();
+    if(data.size() < expectedDataSize) {
+        Error{} << messagePrefix << "expected at least" << expectedDataSize << "bytes of pixel data but got" << data.size();
+        return {};
+    }
+
+    return ImageData<dimensions>{PixelStorage{}.setAlignment(header.alignment), format, header.formatExtra, header.pixelSize, imageSize, DataFlags{}, data, flags};
+}
+
+}
+
+ScenePackImporter::ScenePackImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
+
+ScenePackImporter::~ScenePackImporter() = default;
+
+ImporterFeatures ScenePackImporter::doFeatures() const { return ImporterFeature::OpenData; }
+
+bool ScenePackImporter::doIsOpened() const { return !!_state; }
+
+void ScenePackImporter::doClose() { _state = nullptr; }
+
+void ScenePackImporter::doOpenFile(const Containers::StringView filename) {
+    #ifdef MAGNUM_IMPLEMENTATION_MAP_FILE
+    if(configuration().value<bool>("mapFile")) {
+        Containers::Optional<Magnum::Implementation::MappedFile> mapped = Magnum::Implementation::openMappedFile("Trade::ScenePackImporter::openFile():", filename, [this](Containers::Array<char>&& data, const DataFlags dataFlags) {
+            doOpenData(Utility::move(data), dataFlags);
+        });
+
+        /* Keep the mapping alive for as long as the file is opened */
+        if(mapped && _state) _state->mapped = Utility::move(*mapped);
+        return;
+    }
+    #endif
+
+    AbstractImporter::doOpenFile(filename);
+}
+
+void ScenePackImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
+    if(data.size() < sizeof(Implementation::ScenePackHeader)) {
+        Error{} << "Trade::ScenePackImporter::openData(): file too short, expected at least" << sizeof(Implementation::ScenePackHeader) << "bytes but got" << data.size();
+        return;
+    }
+
+    /* The data may not be aligned, copy the header out */
+    Implementation::ScenePackHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if(std::memcmp(header.magic, Implementation::ScenePackMagic, sizeof(header.magic)) != 0) {
+        Error{} << "Trade::ScenePackImporter::openData(): invalid file signature" << Containers::StringView{header.magic, sizeof(header.magic)};
+        return;
+    }
+
+    if(header.version != Implementation::ScenePackVersion) {
+        Error{} << "Trade::ScenePackImporter::openData(): unsupported version" << header.version;
+        return;
+    }
+
+    if(header.materialAttributeSize != sizeof(MaterialAttributeData)) {
+        Error{} << "Trade::ScenePackImporter::openData(): file produced with" << header.materialAttributeSize << "byte material attributes but the platform has" << sizeof(MaterialAttributeData);
+        return;
+    }
+
+    const std::size_t chunkTableEnd = sizeof(Implementation::ScenePackHeader) + std::size_t{header.chunkCount}*sizeof(Implementation::ScenePackChunk);
+    if(data.size() < chunkTableEnd) {
+        Error{} << "Trade::ScenePackImporter::openData(): file too short, expected at least" << chunkTableEnd << "bytes for" << header.chunkCount << "chunks but got" << data.size();
+        return;
+    }
+
+    /* Everything is accessed in place, so take over the existing array only
+       if it's suitably aligned. 8 bytes is the largest alignment of any type
+       stored in the file. Copy the data otherwise. */
+    Containers::Pointer<State> state{InPlaceInit};
+    if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned) && reinterpret_cast<std::uintptr_t>(data.data()) % 8 == 0) {
+        state->data = Utility::move(data);
+    } else {
+        state->data = Containers::Array<char>{NoInit, data.size()};
+        Utility::copy(data, state->data);
+    }
+
+    state->chunks = Containers::arrayCast<const Implementation::ScenePackChunk>(state->data.slice(sizeof(Implementation::ScenePackHeader), chunkTableEnd));
+    UnsignedInt chunkCounts[Implementation::ScenePackChunkTypeCount]{};
+    for(std::size_t i = 0; i != state->chunks.size(); ++i) {
+        const Implementation::ScenePackChunk& chunk = state->chunks[i];
+        if(!chunk.type || chunk.type > Implementation::ScenePackChunkTypeCount) {
+            Error{} << "Trade::ScenePackImporter::openData(): invalid type" << chunk.type << "of chunk" << i;
+            return;
+        }
+
+        if(chunk.offset % Implementation::ScenePackAlignment || chunk.offset < chunkTableEnd || !isRangeInside(state->data.size(), chunk.offset, chunk.size)) {
+            Error{} << "Trade::ScenePackImporter::openData(): chunk" << i << "of" << chunk.size << "bytes at offset" << chunk.offset << "is misaligned or out of range for" << state->data.size() << "bytes";
+            return;
+        }
+
+        if(!isRangeInside(state->data.size(), chunk.nameOffset, chunk.nameSize + 1) || state->data[chunk.nameOffset + chunk.nameSize] != '\0') {
+            Error{} << "Trade::ScenePackImporter::openData(): name of chunk" << i << "out of range or not null-terminated";
+            return;
+        }
+
+        ++chunkCounts[chunk.type - 1];
+    }
+
+    for(UnsignedInt i = 0; i != Implementation::ScenePackChunkTypeCount; ++i) {
+        state->chunksForType[i] = Containers::Array<UnsignedInt>{NoInit, chunkCounts[i]};
+        chunkCounts[i] = 0;
+    }
+    for(std::size_t i = 0; i != state->chunks.size(); ++i) {
+        const UnsignedInt type = state->chunks[i].type - 1;
+        state->chunksForType[type][chunkCounts[type]++] = i;
+    }
+
+    const std::size_t sceneCount = state->chunksFor(ScenePackChunkType::Scene).size();
+    if(header.defaultScene < -1 || (header.defaultScene != -1 && std::size_t(header.defaultScene) >= sceneCount)) {
+        Error{} << "Trade::ScenePackImporter::openData(): default scene" << header.defaultScene << "out of range for" << sceneCount << "scenes";
+        return;
+    }
+    state->defaultScene = header.defaultScene;
+
+    _state = Utility::move(state);
+}
+
+Int ScenePackImporter::doDefaultScene() const { return _state->defaultScene; }
+
+UnsignedInt ScenePackImporter::doSceneCount() const {
+    return _state->chunksFor(ScenePackChunkType::Scene).size();
+}
+
+Int ScenePackImporter::doSceneForName(const Containers::StringView name) {
+    return _state->forName(ScenePackChunkType::Scene, name);
+}
+
+Containers::String ScenePackImporter::doSceneName(const UnsignedInt id) {
+    return _state->name(ScenePackChunkType::Scene, id);
+}
+
+Containers::Optional<SceneData> ScenePackImporter::doScene(const UnsignedInt id) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doScene"};
+    const Containers::ArrayView<const char> chunk = _state->chunk(ScenePackChunkType::Scene, id);
+    if(chunk.size() < sizeof(Implementation::ScenePackScene)) {
+        Error{} << "Trade::ScenePackImporter::scene(): expected at least" << sizeof(Implementation::ScenePackScene) << "bytes but got" << chunk.size();
+        return {};
+    }
+
+    const auto& header = *reinterpret_cast<const Implementation::ScenePackScene*>(chunk.data());
+    const std::size_t fieldTableEnd = sizeof(Implementation::ScenePackScene) + std::size_t{header.fieldCount}*sizeof(Implementation::ScenePackSceneField);
+    if(chunk.size() < fieldTableEnd) {
+        Error{} << "Trade::ScenePackImporter::scene(): expected at least" << fieldTableEnd << "bytes for" << header.fieldCount << "fields but got" << chunk.size();
+        return {};
+    }
+
+    if(!isRangeInside(chunk.size(), header.dataOffset, header.dataSize)) {
+        Error{} << "Trade::ScenePackImporter::scene(): scene data of" << header.dataSize << "bytes at offset" << header.dataOffset << "out of range for" << chunk.size() << "bytes";
+        return {};
+    }
+
+    if(!header.mappingType || header.mappingType > UnsignedInt(SceneMappingType::UnsignedLong)) {
+        Error{} << "Trade::ScenePackImporter::scene(): invalid mapping type" << header.mappingType;
+        return {};
+    }
+
+    const SceneMappingType mappingType = SceneMappingType(header.mappingType);
+    const UnsignedInt mappingTypeSize = sceneMappingTypeSize(mappingType);
+    if(mappingTypeSize < 8 && header.mappingBound > (UnsignedLong{1} << 8*mappingTypeSize)) {
+        Error{} << "Trade::ScenePackImporter::scene():" << mappingType << "is too small for" << header.mappingBound << "objects";
+        return {};
+    }
+
+    const Containers::ArrayView<const Implementation::ScenePackSceneField> fieldTable = Containers::arrayCast<const Implementation::ScenePackSceneField>(chunk.slice(sizeof(Implementation::ScenePackScene), fieldTableEnd));
+    Containers::Array<SceneFieldData> fields{std::size_t{header.fieldCount}};
+    for(std::size_t i = 0; i != fieldTable.size(); ++i) {
+        const Implementation::ScenePackSceneField& field = fieldTable[i];
+        const SceneField name = SceneField(field.name);
+        const SceneFieldType type = SceneFieldType(field.type);
+        if(!field.type || field.type > UnsignedInt(LastSceneFieldType) || !Implementation::isScenePackFieldTypeSupported(type)) {
+            Error{} << "Trade::ScenePackImporter::scene(): invalid type" << type << "of field" << i;
+            return {};
+        }
+
+        if(!field.name || !isSceneFieldValid(name)) {
+            Error{} << "Trade::ScenePackImporter::scene(): invalid name" << field.name << "of field" << i;
+            return {};
+        }
+
+        /* SceneFieldData would assert on all of these */
+        if(!Trade::Implementation::isSceneFieldTypeCompatibleWithField(name, type)) {
+            Error{} << "Trade::ScenePackImporter::scene():" << type << "is not a valid type for" << name;
+            return {};
+        }
+        if(field.fieldArraySize && !Trade::Implementation::isSceneFieldArrayAllowed(name)) {
+            Error{} << "Trade::ScenePackImporter::scene():" << name << "can't be an array field";
+            return {};
+        }
+        if(field.flags & ~UnsignedShort(UnsignedByte(SceneFieldFlag::ImplicitMapping|SceneFieldFlag::MultiEntry))) {
+            Error{} << "Trade::ScenePackImporter::scene(): invalid flags" << SceneFieldFlags{SceneFieldFlag(field.flags)} << "of field" << i;
+            return {};
+        }
+
+        if(field.mappingStride < -32768 || field.mappingStride > 32767 ||
+           field.fieldStride < -32768 || field.fieldStride > 32767) {
+            Error{} << "Trade::ScenePackImporter::scene(): mapping stride" << field.mappingStride << "or field stride" << field.fieldStride << "of field" << i << "doesn't fit into 16 bits";
+            return {};
+        }
+
+        const std::size_t fieldSize = sceneFieldTypeSize(type)*Math::max(field.fieldArraySize, UnsignedShort{1});
+        if(!isStridedRangeInside(header.dataSize, field.mappingOffset, field.size, field.mappingStride, mappingTypeSize) ||
+           !isStridedRangeInside(header.dataSize, field.fieldOffset, field.size, field.fieldStride, fieldSize)) {
+            Error{} << "Trade::ScenePackImporter::scene(): field" << i << "out of range for" << header.dataSize << "bytes of scene data";
+            return {};
+        }
+
+        fields[i] = SceneFieldData{name, std::size_t(field.size), mappingType, std::size_t(field.mappingOffset), std::ptrdiff_t(field.mappingStride), type, std::size_t(field.fieldOffset), std::ptrdiff_t(field.fieldStride), field.fieldArraySize, SceneFieldFlag(field.flags)};
+    }
+
+    /* SceneData expects the fields to be unique and the TRS and mesh / material
+       fields to share the object mapping */
+    for(std::size_t i = 0; i != fieldTable.size(); ++i) {
+        const Implementation::ScenePackSceneField& a = fieldTable[i];
+        for(std::size_t j = 0; j != i; ++j) {
+            const Implementation::ScenePackSceneField& b = fieldTable[j];
+            if(a.name == b.name) {
+                Error{} << "Trade::ScenePackImporter::scene(): duplicate field" << SceneField(a.name);
+                return {};
+            }
+
+            const UnsignedInt mappingGroup = sharedMappingGroup(SceneField(a.name));
+            if(mappingGroup && mappingGroup == sharedMappingGroup(SceneField(b.name)) && (a.size != b.size || a.mappingOffset != b.mappingOffset || a.mappingStride != b.mappingStride)) {
+                Error{} << "Trade::ScenePackImporter::scene():" << SceneField(a.name) << "mapping data is different from" << SceneField(b.name) << "mapping data";
+                return {};
+            }
+        }
+    }
+
+    return SceneData{mappingType, header.mappingBound, DataFlags{}, chunk.sliceSize(std::size_t(header.dataOffset), std::size_t(header.dataSize)), Utility::move(fields)};
+}
+
+UnsignedInt ScenePackImporter::doMeshCount() const {
+    return _state->chunksFor(ScenePackChunkType::Mesh).size();
+}
+
+Int ScenePackImporter::doMeshForName(const Containers::StringView name) {
+    return _state->forName(ScenePackChunkType::Mesh, name);
+}
+
+Containers::String ScenePackImporter::doMeshName(const UnsignedInt id) {
+    return _state->name(ScenePackChunkType::Mesh, id);
+}
+
+Containers::Optional<MeshData> ScenePackImporter::doMesh(const UnsignedInt id, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMesh"};
+    const Containers::ArrayView<const char> chunk = _state->chunk(ScenePackChunkType::Mesh, id);
+    if(chunk.size() < sizeof(Implementation::ScenePackMesh)) {
+        Error{} << "Trade::ScenePackImporter::mesh(): expected at least" << sizeof(Implementation::ScenePackMesh) << "bytes but got" << chunk.size();
+        return {};
+    }
+
+    const auto& header = *reinterpret_cast<const Implementation::ScenePackMesh*>(chunk.data());
+    const std::size_t attributeTableEnd = sizeof(Implementation::ScenePackMesh) + std::size_t{header.attributeCount}*sizeof(Implementation::ScenePackMeshAttribute);
+    if(chunk.size() < attributeTableEnd) {
+        Error{} << "Trade::ScenePackImporter::mesh(): expected at least" << attributeTableEnd << "bytes for" << header.attributeCount << "attributes but got" << chunk.size();
+        return {};
+    }
+
+    if(!isRangeInside(chunk.size(), header.indexDataOffset, header.indexDataSize) ||
+       !isRangeInside(chunk.size(), header.vertexDataOffset, header.vertexDataSize)) {
+        Error{} << "Trade::ScenePackImporter::mesh(): index or vertex data out of range for" << chunk.size() << "bytes";
+        return {};
+    }
+
+    if(!header.primitive) {
+        Error{} << "Trade::ScenePackImporter::mesh(): invalid primitive" << header.primitive;
+        return {};
+    }
+
+    /* MeshIndexData would assert on this */
+    if(header.indexType && (header.indexStride < -32768 || header.indexStride > 32767)) {
+        Error{} << "Trade::ScenePackImporter::mesh(): index stride" << header.indexStride << "doesn't fit into 16 bits";
+        return {};
+    }
+
+    if(header.indexType && (header.indexType > UnsignedInt(MeshIndexType::UnsignedInt) || !isStridedRangeInside(header.indexDataSize, header.indexOffset, header.indexCount, header.indexStride, meshIndexTypeSize(MeshIndexType(header.indexType))))) {
+        Error{} << "Trade::ScenePackImporter::mesh(): invalid index type" << header.indexType << "or indices out of range for" << header.indexDataSize << "bytes of index data";
+        return {};
+    }
+
+    const Containers::ArrayView<const Implementation::ScenePackMeshAttribute> attributeTable = Containers::arrayCast<const Implementation::ScenePackMeshAttribute>(chunk.slice(sizeof(Implementation::ScenePackMesh), attributeTableEnd));
+    Containers::Array<MeshAttributeData> attributes{std::size_t{header.attributeCount}};
+    for(std::size_t i = 0; i != attributeTable.size(); ++i) {
+        const Implementation::ScenePackMeshAttribute& attribute = attributeTable[i];
+        const MeshAttribute name = MeshAttribute(attribute.name);
+        const VertexFormat format = VertexFormat(attribute.format);
+        if(!Magnum::Implementation::isVertexFormatValid(attribute.format)) {
+            Error{} << "Trade::ScenePackImporter::mesh(): invalid format" << format << "of attribute" << i;
+            return {};
+        }
+
+        if(!Magnum::Implementation::isMeshAttributeValid(attribute.name)) {
+            Error{} << "Trade::ScenePackImporter::mesh(): invalid name" << attribute.name << "of attribute" << i;
+            return {};
+        }
+
+        /* MeshAttributeData would assert on all of these */
+        if(!Trade::Implementation::isVertexFormatCompatibleWithAttribute(name, format)) {
+            Error{} << "Trade::ScenePackImporter::mesh():" << format << "is not a valid format for" << name;
+            return {};
+        }
+        if(attribute.arraySize && (!Trade::Implementation::isAttributeArrayAllowed(name) || isVertexFormatImplementationSpecific(format))) {
+            Error{} << "Trade::ScenePackImporter::mesh():" << name << "of format" << format << "can't be an array attribute";
+            return {};
+        }
+        if(attribute.morphTargetId < -1 || attribute.morphTargetId > 127 || (attribute.morphTargetId != -1 && !Trade::Implementation::isMorphTargetAllowed(name))) {
+            Error{} << "Trade::ScenePackImporter::mesh(): invalid morph target ID" << attribute.morphTargetId << "for" << name;
+            return {};
+        }
+        if(attribute.stride < -32768 || attribute.stride > 32767) {
+            Error{} << "Trade::ScenePackImporter::mesh(): stride" << attribute.stride << "of attribute" << i << "doesn't fit into 16 bits";
+            return {};
+        }
+
+        /* Size of implementation-specific formats is unknown, check just the
+           attribute starts for those */
+        const std::size_t attributeSize = isVertexFormatImplementationSpecific(format) ? 0 : vertexFormatSize(format)*Math::max(attribute.arraySize, UnsignedShort{1});
+        if(!isStridedRangeInside(header.vertexDataSize, attribute.offset, header.vertexCount, attribute.stride, attributeSize)) {
+            Error{} << "Trade::ScenePackImporter::mesh(): attribute" << i << "out of range for" << header.vertexDataSize << "bytes of vertex data";
+            return {};
+        }
+
+        attributes[i] = MeshAttributeData{name, format, std::size_t(attribute.offset), header.vertexCount, attribute.stride, attribute.arraySize, attribute.morphTargetId};
+    }
+
+    const Containers::ArrayView<const char> vertexData = chunk.sliceSize(std::size_t(header.vertexDataOffset), std::size_t(header.vertexDataSize));
+    if(!header.indexType)
+        return MeshData{MeshPrimitive(header.primitive),
+            DataFlags{}, vertexData, Utility::move(attributes),
+            header.vertexCount};
+
+    const Containers::ArrayView<const char> indexData = chunk.sliceSize(std::size_t(header.indexDataOffset), std::size_t(header.indexDataSize));
+    const MeshIndexData indices{MeshIndexType(header.indexType), Containers::StridedArrayView1D<const void>{indexData, indexData.data() + header.indexOffset, header.indexCount, header.indexStride}};
+    return MeshData{MeshPrimitive(header.primitive),
+        DataFlags{}, indexData, indices,
+        DataFlags{}, vertexData, Utility::move(attributes),
+        header.vertexCount};
+}
+
+UnsignedInt ScenePackImporter::doMaterialCount() const {
+    return _state->chunksFor(ScenePackChunkType::Material).size();
+}
+
+Int ScenePackImporter::doMaterialForName(const Containers::StringView name) {
+    return _state->forName(ScenePackChunkType::Material, name);
+}
+
+Containers::String ScenePackImporter::doMaterialName(const UnsignedInt id) {
+    return _state->name(ScenePackChunkType::Material, id);
+}
+
+Containers::Optional<MaterialData> ScenePackImporter::doMaterial(const UnsignedInt id) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMaterial"};
+    const Containers::ArrayView<const char> chunk = _state->chunk(ScenePackChunkType::Material, id);
+    if(chunk.size() < sizeof(Implementation::ScenePackMaterial)) {
+        Error{} << "Trade::ScenePackImporter::material(): expected at least" << sizeof(Implementation::ScenePackMaterial) << "bytes but got" << chunk.size();
+        return {};
+    }
+
+    const auto& header = *reinterpret_cast<const Implementation::ScenePackMaterial*>(chunk.data());
+    const std::size_t layerOffsetsEnd = sizeof(Implementation::ScenePackMaterial) + std::size_t{header.layerCount}*sizeof(UnsignedInt);
+    const std::size_t attributesOffset = (layerOffsetsEnd + Implementation::ScenePackAlignment - 1)/Implementation::ScenePackAlignment*Implementation::ScenePackAlignment;
+    const std::size_t attributesEnd = attributesOffset + std::size_t{header.attributeCount}*sizeof(MaterialAttributeData);
+    if(chunk.size() < attributesEnd) {
+        Error{} << "Trade::ScenePackImporter::material(): expected at least" << attributesEnd << "bytes for" << header.layerCount << "layers and" << header.attributeCount << "attributes but got" << chunk.size();
+        return {};
+    }
+
+    const Containers::ArrayView<const UnsignedInt> layerOffsets = Containers::arrayCast<const UnsignedInt>(chunk.slice(sizeof(Implementation::ScenePackMaterial), layerOffsetsEnd));
+    const Containers::ArrayView<const MaterialAttributeData> attributes = Containers::arrayCast<const MaterialAttributeData>(chunk.slice(attributesOffset, attributesEnd));
+
+    /* Attribute type is in the first byte, followed by a non-empty
+       null-terminated name. Pointer attributes can't be stored in a file. */
+    for(std::size_t i = 0; i != attributes.size(); ++i) {
+        const char* const attribute = reinterpret_cast<const char*>(attributes.data() + i);
+        const UnsignedByte typeValue = attribute[0];
+        const MaterialAttributeType type = MaterialAttributeType(typeValue);
+        if(!typeValue || typeValue > UnsignedByte(LastMaterialAttributeType) || type == MaterialAttributeType::Pointer || type == MaterialAttributeType::MutablePointer || !attribute[1] || !std::memchr(attribute + 1, '\0', sizeof(MaterialAttributeData) - 1)) {
+            Error{} << "Trade::ScenePackImporter::material(): invalid attribute" << i;
+            return {};
+        }
+    }
+
+    /* MaterialData expects the non-owned attributes to be sorted */
+    UnsignedInt layerBegin = 0;
+    for(std::size_t i = 0; i != Math::max(layerOffsets.size(), std::size_t{1}); ++i) {
+        const UnsignedInt layerEnd = layerOffsets.isEmpty() ? header.attributeCount : layerOffsets[i];
+        if(layerEnd < layerBegin || layerEnd > header.attributeCount || (i + 1 == layerOffsets.size() && layerEnd != header.attributeCount)) {
+            Error{} << "Trade::ScenePackImporter::material(): invalid offset" << layerEnd << "of layer" << i << "for" << header.attributeCount << "attributes";
+            return {};
+        }
+
+        for(UnsignedInt j = layerBegin + 1; j < layerEnd; ++j) {
+            if(!(attributes[j - 1].name() < attributes[j].name())) {
+                Error{} << "Trade::ScenePackImporter::material(): attributes of layer" << i << "are not sorted";
+                return {};
+            }
+        }
+
+        layerBegin = layerEnd;
+    }
+
+    return MaterialData{MaterialType(header.types), DataFlags{}, attributes, DataFlags{}, layerOffsets};
+}
+
+UnsignedInt ScenePackImporter::doTextureCount() const {
+    return _state->chunksFor(ScenePackChunkType::Texture).size();
+}
+
+Int ScenePackImporter::doTextureForName(const Containers::StringView name) {
+    return _state->forName(ScenePackChunkType::Texture, name);
+}
+
+Containers::String ScenePackImporter::doTextureName(const UnsignedInt id) {
+    return _state->name(ScenePackChunkType::Texture, id);
+}
+
+Containers::Optional<TextureData> ScenePackImporter::doTexture(const UnsignedInt id) {
+    const Containers::ArrayView<const char> chunk = _state->chunk(ScenePackChunkType::Texture, id);
+    if(chunk.size() < sizeof(Implementation::ScenePackTexture)) {
+        Error{} << "Trade::ScenePackImporter::texture(): expected at least" << sizeof(Implementation::ScenePackTexture) << "bytes but got" << chunk.size();
+        return {};
+    }
+
+    const auto& texture = *reinterpret_cast<const Implementation::ScenePackTexture*>(chunk.data());
+    if(texture.minificationFilter > UnsignedInt(SamplerFilter::Linear) ||
+       texture.magnificationFilter > UnsignedInt(SamplerFilter::Linear) ||
+       texture.mipmapFilter > UnsignedInt(SamplerMipmap::Linear) ||
+       texture.wrapping[0] > UnsignedInt(SamplerWrapping::MirrorClampToEdge) ||
+       texture.wrapping[1] > UnsignedInt(SamplerWrapping::MirrorClampToEdge) ||
+       texture.wrapping[2] > UnsignedInt(SamplerWrapping::MirrorClampToEdge)) {
+        Error{} << "Trade::ScenePackImporter::texture(): invalid filter, mipmap or wrapping mode";
+        return {};
+    }
+
+    /* There are no 1D images in the file, so 1D textures can never reference
+       a valid image */
+    UnsignedInt imageCount;
+    switch(TextureType(texture.type)) {
+        case TextureType::Texture1D:
+            imageCount = 0;
+            break;
+        case TextureType::Texture1DArray:
+        case TextureType::Texture2D:
+            imageCount = doImage2DCount();
+            break;
+        case TextureType::Texture2DArray:
+        case TextureType::Texture3D:
+        case TextureType::CubeMap:
+        case TextureType::CubeMapArray:
+            imageCount = doImage3DCount();
+            break;
+        default:
+            Error{} << "Trade::ScenePackImporter::texture(): invalid type" << texture.type;
+            return {};
+    }
+
+    if(texture.image >= imageCount) {
+        Error{} << "Trade::ScenePackImporter::texture(): image" << texture.image << "out of range for" << imageCount << "images of" << TextureType(texture.type);
+        return {};
+    }
+
+    return TextureData{TextureType(texture.type),
+        SamplerFilter(texture.minificationFilter),
+        SamplerFilter(texture.magnificationFilter),
+        SamplerMipmap(texture.mipmapFilter),
+        {SamplerWrapping(texture.wrapping[0]),
+         SamplerWrapping(texture.wrapping[1]),
+         SamplerWrapping(texture.wrapping[2])},
+        texture.image};
+}
+
+UnsignedInt ScenePackImporter::doImage2DCount() const {
+    return _state->chunksFor(ScenePackChunkType::Image2D).size();
+}
+
+Int ScenePackImporter::doImage2DForName(const Containers::StringView name) {
+    return _state->forName(ScenePackChunkType::Image2D, name);
+}
+
+Containers::String ScenePackImporter::doImage2DName(const UnsignedInt id) {
+    return _state->name(ScenePackChunkType::Image2D, id);
+}
+
+Containers::Optional<ImageData2D> ScenePackImporter::doImage2D(const UnsignedInt id, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D"};
+    return importImage<2>("Trade::ScenePackImporter::image2D():", _state->chunk(ScenePackChunkType::Image2D, id));
+}
+
+UnsignedInt ScenePackImporter::doImage3DCount() const {
+    return _state->chunksFor(ScenePackChunkType::Image3D).size();
+}
+
+Int ScenePackImporter::doImage3DForName(const Containers::StringView name) {
+    return _state->forName(ScenePackChunkType::Image3D, name);
+}
+
+Containers::String ScenePackImporter::doImage3DName(const UnsignedInt id) {
+    return _state->name(ScenePackChunkType::Image3D, id);
+}
+
+Containers::Optional<ImageData3D> ScenePackImporter::doImage3D(const UnsignedInt id, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage3D"};
+    return importImage<3>("Trade::ScenePackImporter::image3D():", _state->chunk(ScenePackChunkType::Image3D, id));
+}
+
+}}
+
+CORRADE_PLUGIN_REGISTER(ScenePackImporter, Magnum::Trade::ScenePackImporter,
+    MAGNUM_TRADE_ABSTRACTIMPORTER_PLUGIN_INTERFACE)
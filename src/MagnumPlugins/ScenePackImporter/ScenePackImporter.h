@@ -0,0 +1,208 @@
+#ifndef Magnum_Trade_ScenePackImporter_h
+#define Magnum_Trade_ScenePackImporter_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Trade::ScenePackImporter
+ * @m_since_latest_{plugins}
+ */
+
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/Trade/AbstractImporter.h>
+
+#include "MagnumPlugins/ScenePackImporter/configure.h"
+
+#ifndef DOXYGEN_GENERATING_OUTPUT
+#ifndef MAGNUM_SCENEPACKIMPORTER_BUILD_STATIC
+    #ifdef ScenePackImporter_EXPORTS
+        #define MAGNUM_SCENEPACKIMPORTER_EXPORT CORRADE_VISIBILITY_EXPORT
+    #else
+        #define MAGNUM_SCENEPACKIMPORTER_EXPORT CORRADE_VISIBILITY_IMPORT
+    #endif
+#else
+    #define MAGNUM_SCENEPACKIMPORTER_EXPORT CORRADE_VISIBILITY_STATIC
+#endif
+#define MAGNUM_SCENEPACKIMPORTER_LOCAL CORRADE_VISIBILITY_LOCAL
+#else
+#define MAGNUM_SCENEPACKIMPORTER_EXPORT
+#define MAGNUM_SCENEPACKIMPORTER_LOCAL
+#endif
+
+namespace Magnum { namespace Trade {
+
+/**
+@brief Scene pack importer plugin
+@m_since_latest_{plugins}
+
+Imports scene packs produced by @ref ScenePackSceneConverter. A scene pack
+stores scenes, meshes, materials, textures and images in exactly the memory
+layout of @ref SceneData, @ref MeshData, @ref MaterialData, @ref TextureData
+and @ref ImageData, together with a table of offsets. Opening a file only
+validates the header and the offset table, and all data are then returned as
+views on the file with no parsing or copying involved. It's meant to be used as
+a fast-loading cache for assets produced from formats such as glTF.
+
+@section Trade-ScenePackImporter-usage Usage
+
+@m_class{m-note m-success}
+
+@par
+    This class is a plugin that's meant to be dynamically loaded and used
+    through the base @ref AbstractImporter interface. See its documentation for
+    introduction and usage examples.
+
+This plugin depends on the @ref Trade library and is built if
+`MAGNUM_WITH_SCENEPACKIMPORTER` is enabled when building Magnum Plugins. To
+use as a dynamic plugin, load @cpp "ScenePackImporter" @ce via
+@ref Corrade::PluginManager::Manager.
+
+Additionally, if you're using Magnum as a CMake subproject, bundle the
+[magnum-plugins repository](https://github.com/mosra/magnum-plugins) and do
+the following:
+
+@code{.cmake}
+set(MAGNUM_WITH_SCENEPACKIMPORTER ON CACHE BOOL "" FORCE)
+add_subdirectory(magnum-plugins EXCLUDE_FROM_ALL)
+
+# So the dynamically loaded plugin gets built implicitly
+add_dependencies(your-app MagnumPlugins::ScenePackImporter)
+@endcode
+
+To use as a static plugin or as a dependency of another plugin with CMake, put
+[FindMagnumPlugins.cmake](https://github.com/mosra/magnum-plugins/blob/master/modules/FindMagnumPlugins.cmake)
+into your `modules/` directory, request the `ScenePackImporter` component of
+the `MagnumPlugins` package and link to the `MagnumPlugins::ScenePackImporter`
+target:
+
+@code{.cmake}
+find_package(MagnumPlugins REQUIRED ScenePackImporter)
+
+# ...
+target_link_libraries(your-app PRIVATE MagnumPlugins::ScenePackImporter)
+@endcode
+
+See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
+information.
+
+@section Trade-ScenePackImporter-behavior Behavior and limitations
+
+The file stores all values in the native endianness and with the
+@ref MaterialAttributeData layout of the machine that produced it. A file
+produced on a platform with a different layout fails to open. Opening only
+checks the header and that all chunks are inside the file, the data ranges of
+a particular scene, mesh, material, texture or image are checked when it's
+imported. The import also validates all enum values, field type and vertex
+format compatibility, texture image references and all other constraints the
+@ref SceneData, @ref MeshData, @ref MaterialData and @ref ImageData
+constructors would assert on, so a corrupted or malicious file results in an
+error instead of an assertion. The data themselves, such as mesh or material
+references in a scene or the index buffer contents, aren't checked.
+
+Scene, mesh, material, texture, 2D and 3D image names are imported. Object
+names, custom scene field, mesh attribute and material layer names, cameras,
+lights, skins and animations are not stored in the format.
+
+@subsection Trade-ScenePackImporter-behavior-zero-copy Zero-copy import
+
+All returned data are non-owning views on the opened file, with
+@ref DataFlags being empty, and are valid only until the importer is closed
+or another file is opened. The time it takes to import a mesh, scene,
+material or image thus doesn't depend on the size of its data.
+
+If the file is opened with @ref openMemory(), the memory is used directly
+without making a copy, otherwise the data are copied on open. If the
+@cb{.ini} mapFile @ce @ref Trade-ScenePackImporter-configuration "configuration option"
+is enabled, which it is by default, a file is opened from the filesystem and
+no file callback is set, the file is memory-mapped with
+@relativeref{Corrade,Utility::Path::mapRead()} and only the parts that are
+actually accessed get loaded from the disk. This is available only on
+platforms where memory-mapping is supported. As all data are accessed in
+place, memory passed to @ref openMemory() has to be aligned to at least 8
+bytes, otherwise it's copied as well.
+
+@section Trade-ScenePackImporter-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration().
+See below for all options and their default values:
+
+@snippet MagnumPlugins/ScenePackImporter/ScenePackImporter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
+*/
+class MAGNUM_SCENEPACKIMPORTER_EXPORT ScenePackImporter: public AbstractImporter {
+    public:
+        /** @brief Plugin manager constructor */
+        explicit ScenePackImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
+
+        ~ScenePackImporter();
+
+    private:
+        struct State;
+
+        MAGNUM_SCENEPACKIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL bool doIsOpened() const override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL void doOpenFile(Containers::StringView filename) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL void doClose() override;
+
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Int doDefaultScene() const override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL UnsignedInt doSceneCount() const override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Int doSceneForName(Containers::StringView name) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Containers::String doSceneName(UnsignedInt id) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Containers::Optional<SceneData> doScene(UnsignedInt id) override;
+
+        MAGNUM_SCENEPACKIMPORTER_LOCAL UnsignedInt doMeshCount() const override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Int doMeshForName(Containers::StringView name) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Containers::String doMeshName(UnsignedInt id) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
+
+        MAGNUM_SCENEPACKIMPORTER_LOCAL UnsignedInt doMaterialCount() const override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Int doMaterialForName(Containers::StringView name) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Containers::String doMaterialName(UnsignedInt id) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Containers::Optional<MaterialData> doMaterial(UnsignedInt id) override;
+
+        MAGNUM_SCENEPACKIMPORTER_LOCAL UnsignedInt doTextureCount() const override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Int doTextureForName(Containers::StringView name) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Containers::String doTextureName(UnsignedInt id) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Containers::Optional<TextureData> doTexture(UnsignedInt id) override;
+
+        MAGNUM_SCENEPACKIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Int doImage2DForName(Containers::StringView name) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Containers::String doImage2DName(UnsignedInt id) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
+
+        MAGNUM_SCENEPACKIMPORTER_LOCAL UnsignedInt doImage3DCount() const override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Int doImage3DForName(Containers::StringView name) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Containers::String doImage3DName(UnsignedInt id) override;
+        MAGNUM_SCENEPACKIMPORTER_LOCAL Containers::Optional<ImageData3D> doImage3D(UnsignedInt id, UnsignedInt level) override;
+
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
@@ -0,0 +1,1007 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/Path.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MaterialData.h>
+#include <Magnum/Trade/MeshData.h>
+#include <Magnum/Trade/SceneData.h>
+#include <Magnum/Trade/TextureData.h>
+
+#include "MagnumPlugins/ScenePackImporter/ScenePackHeader.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct ScenePackImporterTest: TestSuite::Tester {
+    explicit ScenePackImporterTest();
+
+    void invalid();
+    void empty();
+
+    void roundtripScene();
+    void roundtripMesh();
+    void roundtripMaterial();
+    void roundtripTexture();
+    void roundtripImage2D();
+    void roundtripImage3DCompressed();
+    void names();
+
+    void openMemoryZeroCopy();
+    void openFile();
+
+    void invalidScene();
+    void invalidMesh();
+    void invalidMaterial();
+    void invalidTexture();
+    void invalidImage();
+
+    void openTwice();
+    void importTwice();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+    PluginManager::Manager<AbstractSceneConverter> _converterManager{"nonexistent"};
+};
+
+/* A valid file with either no chunks or a single empty texture chunk with an
+   empty name, which gets modified in the invalid() test. The chunk table ends
+   at 56 bytes, the name is at 56 and the chunk data at 64. */
+Containers::Array<char> emptyFile(std::size_t chunkCount = 0) {
+    Containers::Array<char> out{ValueInit, chunkCount ? 64 : sizeof(Implementation::ScenePackHeader)};
+    Implementation::ScenePackHeader& header = *reinterpret_cast<Implementation::ScenePackHeader*>(out.data());
+    Utility::copy(Containers::arrayView(Implementation::ScenePackMagic), Containers::arrayView(header.magic));
+    header.version = Implementation::ScenePackVersion;
+    header.materialAttributeSize = sizeof(MaterialAttributeData);
+    header.chunkCount = chunkCount;
+    header.defaultScene = -1;
+    if(chunkCount) {
+        Implementation::ScenePackChunk& chunk = *reinterpret_cast<Implementation::ScenePackChunk*>(out.data() + sizeof(Implementation::ScenePackHeader));
+        chunk.type = UnsignedInt(Implementation::ScenePackChunkType::Texture);
+        chunk.nameOffset = 56;
+        chunk.offset = 64;
+    }
+    return out;
+}
+
+const struct {
+    const char* name;
+    std::size_t chunkCount;
+    std::size_t size;
+    void(*modify)(Implementation::ScenePackHeader&, Implementation::ScenePackChunk*);
+    const char* message;
+} InvalidData[]{
+    {"too short", 0, sizeof(Implementation::ScenePackHeader) - 1,
+        [](Implementation::ScenePackHeader&, Implementation::ScenePackChunk*) {},
+        "file too short, expected at least 24 bytes but got 23"},
+    {"invalid signature", 0, 0,
+        [](Implementation::ScenePackHeader& header, Implementation::ScenePackChunk*) {
+            header.magic[7] = 'C';
+        }, "invalid file signature MGNSPACC"},
+    {"unsupported version", 0, 0,
+        [](Implementation::ScenePackHeader& header, Implementation::ScenePackChunk*) {
+            header.version = 2;
+        }, "unsupported version 2"},
+    {"material attribute size mismatch", 0, 0,
+        [](Implementation::ScenePackHeader& header, Implementation::ScenePackChunk*) {
+            header.materialAttributeSize = 32;
+        }, "file produced with 32 byte material attributes but the platform has 64"},
+    {"chunk table too short", 1, 0,
+        [](Implementation::ScenePackHeader& header, Implementation::ScenePackChunk*) {
+            header.chunkCount = 2;
+        }, "file too short, expected at least 88 bytes for 2 chunks but got 64"},
+    {"invalid chunk type", 1, 0,
+        [](Implementation::ScenePackHeader&, Implementation::ScenePackChunk* chunks) {
+            chunks[0].type = 7;
+        }, "invalid type 7 of chunk 0"},
+    {"chunk out of range", 1, 0,
+        [](Implementation::ScenePackHeader&, Implementation::ScenePackChunk* chunks) {
+            chunks[0].size = 1;
+        }, "chunk 0 of 1 bytes at offset 64 is misaligned or out of range for 64 bytes"},
+    {"chunk misaligned", 1, 0,
+        [](Implementation::ScenePackHeader&, Implementation::ScenePackChunk* chunks) {
+            chunks[0].offset = 56;
+        }, "chunk 0 of 0 bytes at offset 56 is misaligned or out of range for 64 bytes"},
+    {"chunk overlapping the chunk table", 1, 0,
+        [](Implementation::ScenePackHeader&, Implementation::ScenePackChunk* chunks) {
+            chunks[0].offset = 48;
+        }, "chunk 0 of 0 bytes at offset 48 is misaligned or out of range for 64 bytes"},
+    {"name out of range", 1, 0,
+        [](Implementation::ScenePackHeader&, Implementation::ScenePackChunk* chunks) {
+            chunks[0].nameSize = 8;
+        }, "name of chunk 0 out of range or not null-terminated"},
+    {"default scene out of range", 1, 0,
+        [](Implementation::ScenePackHeader& header, Implementation::ScenePackChunk*) {
+            header.defaultScene = 0;
+        }, "default scene 0 out of range for 0 scenes"},
+    {"negative default scene", 0, 0,
+        [](Implementation::ScenePackHeader& header, Implementation::ScenePackChunk*) {
+            header.defaultScene = -2;
+        }, "default scene -2 out of range for 0 scenes"},
+};
+
+const struct {
+    const char* name;
+    void(*modify)(Implementation::ScenePackScene&, Implementation::ScenePackSceneField*);
+    const char* message;
+} InvalidSceneData[]{
+    {"invalid mapping type",
+        [](Implementation::ScenePackScene& scene, Implementation::ScenePackSceneField*) {
+            scene.mappingType = 5;
+        }, "invalid mapping type 5"},
+    {"mapping type too small",
+        [](Implementation::ScenePackScene& scene, Implementation::ScenePackSceneField*) {
+            scene.mappingType = UnsignedInt(SceneMappingType::UnsignedByte);
+            scene.mappingBound = 257;
+        }, "Trade::SceneMappingType::UnsignedByte is too small for 257 objects"},
+    {"invalid field type",
+        [](Implementation::ScenePackScene&, Implementation::ScenePackSceneField* fields) {
+            fields[1].type = 0xdead;
+        }, "invalid type Trade::SceneFieldType(0xdead) of field 1"},
+    {"unsupported field type",
+        [](Implementation::ScenePackScene&, Implementation::ScenePackSceneField* fields) {
+            fields[1].type = UnsignedInt(SceneFieldType::StringOffset32);
+        }, "invalid type Trade::SceneFieldType::StringOffset32 of field 1"},
+    {"invalid field name",
+        [](Implementation::ScenePackScene&, Implementation::ScenePackSceneField* fields) {
+            fields[0].name = 0x7fff;
+        }, "invalid name 32767 of field 0"},
+    {"field type not compatible",
+        [](Implementation::ScenePackScene&, Implementation::ScenePackSceneField* fields) {
+            fields[1].type = UnsignedInt(SceneFieldType::Float);
+        }, "Trade::SceneFieldType::Float is not a valid type for Trade::SceneField::Mesh"},
+    {"builtin array field",
+        [](Implementation::ScenePackScene&, Implementation::ScenePackSceneField* fields) {
+            fields[0].fieldArraySize = 2;
+        }, "Trade::SceneField::Parent can't be an array field"},
+    {"invalid field flags",
+        [](Implementation::ScenePackScene&, Implementation::ScenePackSceneField* fields) {
+            fields[0].flags = 0x80;
+        }, "invalid flags Trade::SceneFieldFlag(0x80) of field 0"},
+    {"field out of range",
+        [](Implementation::ScenePackScene&, Implementation::ScenePackSceneField* fields) {
+            fields[2].fieldOffset = 40;
+        }, "field 2 out of range for 48 bytes of scene data"},
+    {"mapping stride too large",
+        [](Implementation::ScenePackScene&, Implementation::ScenePackSceneField* fields) {
+            fields[1].mappingStride = 32768;
+        }, "mapping stride 32768 or field stride 16 of field 1 doesn't fit into 16 bits"},
+    {"field stride too large",
+        [](Implementation::ScenePackScene&, Implementation::ScenePackSceneField* fields) {
+            fields[1].fieldStride = -32769;
+        }, "mapping stride 16 or field stride -32769 of field 1 doesn't fit into 16 bits"},
+    {"field size overflowing",
+        [](Implementation::ScenePackScene&, Implementation::ScenePackSceneField* fields) {
+            /* (size - 1)*stride would wrap around to 16, which fits */
+            fields[1].size = 0x1000000000000002ull;
+        }, "field 1 out of range for 48 bytes of scene data"},
+    {"duplicate field",
+        [](Implementation::ScenePackScene&, Implementation::ScenePackSceneField* fields) {
+            fields[1].name = UnsignedInt(SceneField::MeshMaterial);
+            fields[1].type = UnsignedInt(SceneFieldType::Int);
+        }, "duplicate field Trade::SceneField::MeshMaterial"},
+    {"mesh and material mapping not shared",
+        [](Implementation::ScenePackScene&, Implementation::ScenePackSceneField* fields) {
+            fields[2].size = 2;
+        }, "Trade::SceneField::MeshMaterial mapping data is different from Trade::SceneField::Mesh mapping data"},
+};
+
+const struct {
+    const char* name;
+    void(*modify)(Implementation::ScenePackMesh&, Implementation::ScenePackMeshAttribute&);
+    const char* message;
+} InvalidMeshData[]{
+    {"invalid format",
+        [](Implementation::ScenePackMesh&, Implementation::ScenePackMeshAttribute& attribute) {
+            attribute.format = 0xdead;
+        }, "invalid format VertexFormat(0xdead) of attribute 0"},
+    {"invalid name",
+        [](Implementation::ScenePackMesh&, Implementation::ScenePackMeshAttribute& attribute) {
+            attribute.name = 0x7fff;
+        }, "invalid name 32767 of attribute 0"},
+    {"format not compatible",
+        [](Implementation::ScenePackMesh&, Implementation::ScenePackMeshAttribute& attribute) {
+            attribute.format = UnsignedInt(VertexFormat::UnsignedInt);
+        }, "VertexFormat::UnsignedInt is not a valid format for Trade::MeshAttribute::Position"},
+    {"builtin array attribute",
+        [](Implementation::ScenePackMesh&, Implementation::ScenePackMeshAttribute& attribute) {
+            attribute.arraySize = 2;
+        }, "Trade::MeshAttribute::Position of format VertexFormat::Vector3 can't be an array attribute"},
+    {"morph target ID out of range",
+        [](Implementation::ScenePackMesh&, Implementation::ScenePackMeshAttribute& attribute) {
+            attribute.morphTargetId = 128;
+        }, "invalid morph target ID 128 for Trade::MeshAttribute::Position"},
+    {"morph target not allowed",
+        [](Implementation::ScenePackMesh&, Implementation::ScenePackMeshAttribute& attribute) {
+            attribute.name = UnsignedInt(MeshAttribute::ObjectId);
+            attribute.format = UnsignedInt(VertexFormat::UnsignedInt);
+            attribute.morphTargetId = 0;
+        }, "invalid morph target ID 0 for Trade::MeshAttribute::ObjectId"},
+    {"stride too large",
+        [](Implementation::ScenePackMesh&, Implementation::ScenePackMeshAttribute& attribute) {
+            attribute.stride = 32768;
+        }, "stride 32768 of attribute 0 doesn't fit into 16 bits"},
+    {"attribute out of range",
+        [](Implementation::ScenePackMesh&, Implementation::ScenePackMeshAttribute& attribute) {
+            attribute.offset = 4;
+        }, "attribute 0 out of range for 24 bytes of vertex data"},
+    {"index stride too large",
+        [](Implementation::ScenePackMesh& mesh, Implementation::ScenePackMeshAttribute&) {
+            mesh.indexStride = -32769;
+        }, "index stride -32769 doesn't fit into 16 bits"},
+    {"indices out of range",
+        [](Implementation::ScenePackMesh& mesh, Implementation::ScenePackMeshAttribute&) {
+            mesh.indexCount = 3;
+        }, "invalid index type 2 or indices out of range for 4 bytes of index data"},
+};
+
+const struct {
+    const char* name;
+    void(*modify)(MaterialAttributeData*);
+    const char* message;
+} InvalidMaterialData[]{
+    {"invalid attribute type",
+        [](MaterialAttributeData* attributes) {
+            reinterpret_cast<char*>(attributes + 1)[0] = char(0xfe);
+        }, "invalid attribute 1"},
+    {"pointer attribute",
+        [](MaterialAttributeData* attributes) {
+            reinterpret_cast<char*>(attributes + 1)[0] = char(MaterialAttributeType::Pointer);
+        }, "invalid attribute 1"},
+    {"empty attribute name",
+        [](MaterialAttributeData* attributes) {
+            reinterpret_cast<char*>(attributes)[1] = '\0';
+        }, "invalid attribute 0"},
+    {"unsorted attributes",
+        [](MaterialAttributeData* attributes) {
+            const MaterialAttributeData first = attributes[0];
+            attributes[0] = attributes[1];
+            attributes[1] = first;
+        }, "attributes of layer 0 are not sorted"},
+};
+
+const struct {
+    const char* name;
+    void(*modify)(Implementation::ScenePackTexture&);
+    const char* message;
+} InvalidTextureData[]{
+    {"invalid type",
+        [](Implementation::ScenePackTexture& texture) {
+            texture.type = 0xdead;
+        }, "invalid type 57005"},
+    {"invalid filter",
+        [](Implementation::ScenePackTexture& texture) {
+            texture.magnificationFilter = 0xdead;
+        }, "invalid filter, mipmap or wrapping mode"},
+    {"invalid mipmap",
+        [](Implementation::ScenePackTexture& texture) {
+            texture.mipmapFilter = 0xdead;
+        }, "invalid filter, mipmap or wrapping mode"},
+    {"invalid wrapping",
+        [](Implementation::ScenePackTexture& texture) {
+            texture.wrapping[2] = 0xdead;
+        }, "invalid filter, mipmap or wrapping mode"},
+    {"image out of range",
+        [](Implementation::ScenePackTexture& texture) {
+            texture.image = 1;
+        }, "image 1 out of range for 1 images of Trade::TextureType::Texture2D"},
+    {"1D texture",
+        [](Implementation::ScenePackTexture& texture) {
+            texture.type = UnsignedInt(TextureType::Texture1D);
+        }, "image 0 out of range for 0 images of Trade::TextureType::Texture1D"},
+    {"3D texture referencing a 2D image",
+        [](Implementation::ScenePackTexture& texture) {
+            texture.type = UnsignedInt(TextureType::Texture3D);
+        }, "image 0 out of range for 0 images of Trade::TextureType::Texture3D"},
+};
+
+const struct {
+    const char* name;
+    bool compressed;
+    void(*modify)(Implementation::ScenePackImage&);
+    const char* message;
+} InvalidImageData[]{
+    {"invalid format", false,
+        [](Implementation::ScenePackImage& image) {
+            image.format = 0xdead;
+        }, "invalid format PixelFormat(0xdead), pixel size 3 or alignment 1"},
+    {"pixel size not matching the format", false,
+        [](Implementation::ScenePackImage& image) {
+            image.pixelSize = 4;
+        }, "invalid format PixelFormat::RGB8Unorm, pixel size 4 or alignment 1"},
+    {"invalid flags", false,
+        [](Implementation::ScenePackImage& image) {
+            image.flags = 0x10;
+        }, "invalid flags ImageFlag2D(0x10) for an image of size Vector(3, 2, 1)"},
+    {"invalid compressed format", true,
+        [](Implementation::ScenePackImage& image) {
+            image.format = 0xdead;
+        }, "invalid compressed format CompressedPixelFormat(0xdead)"},
+    {"3D compressed format in a 2D image", true,
+        [](Implementation::ScenePackImage& image) {
+            image.format = UnsignedInt(CompressedPixelFormat::Astc3x3x3RGBAUnorm);
+        }, "invalid compressed format CompressedPixelFormat::Astc3x3x3RGBAUnorm"},
+    {"compressed data too short", true,
+        [](Implementation::ScenePackImage& image) {
+            image.size[0] = 8;
+        }, "expected at least 16 bytes of compressed data but got 8"},
+};
+
+ScenePackImporterTest::ScenePackImporterTest() {
+    addInstancedTests({&ScenePackImporterTest::invalid},
+        Containers::arraySize(InvalidData));
+
+    addTests({&ScenePackImporterTest::empty,
+
+              &ScenePackImporterTest::roundtripScene,
+              &ScenePackImporterTest::roundtripMesh,
+              &ScenePackImporterTest::roundtripMaterial,
+              &ScenePackImporterTest::roundtripTexture,
+              &ScenePackImporterTest::roundtripImage2D,
+              &ScenePackImporterTest::roundtripImage3DCompressed,
+              &ScenePackImporterTest::names,
+
+              &ScenePackImporterTest::openMemoryZeroCopy,
+              &ScenePackImporterTest::openFile});
+
+    addInstancedTests({&ScenePackImporterTest::invalidScene},
+        Containers::arraySize(InvalidSceneData));
+
+    addInstancedTests({&ScenePackImporterTest::invalidMesh},
+        Containers::arraySize(InvalidMeshData));
+
+    addInstancedTests({&ScenePackImporterTest::invalidMaterial},
+        Containers::arraySize(InvalidMaterialData));
+
+    addInstancedTests({&ScenePackImporterTest::invalidTexture},
+        Containers::arraySize(InvalidTextureData));
+
+    addInstancedTests({&ScenePackImporterTest::invalidImage},
+        Containers::arraySize(InvalidImageData));
+
+    addTests({&ScenePackImporterTest::openTwice,
+              &ScenePackImporterTest::importTwice});
+
+    /* Load the plugins directly from the build tree. Otherwise they're static
+       and already loaded. */
+    #ifdef SCENEPACKIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(SCENEPACKIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef SCENEPACKSCENECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(SCENEPACKSCENECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+
+    /* Create the output directory if it doesn't exist yet */
+    CORRADE_INTERNAL_ASSERT_OUTPUT(Utility::Path::make(SCENEPACKIMPORTER_TEST_OUTPUT_DIR));
+}
+
+void ScenePackImporterTest::invalid() {
+    auto&& data = InvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+
+    Containers::Array<char> file = emptyFile(data.chunkCount);
+    data.modify(*reinterpret_cast<Implementation::ScenePackHeader*>(file.data()), reinterpret_cast<Implementation::ScenePackChunk*>(file.data() + sizeof(Implementation::ScenePackHeader)));
+
+    /* Size override, truncating the file */
+    Containers::Array<char> sized{ValueInit, data.size ? data.size : file.size()};
+    Utility::copy(file.prefix(Math::min(file.size(), sized.size())), sized.prefix(Math::min(file.size(), sized.size())));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openData(sized));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::ScenePackImporter::openData(): {}\n", data.message));
+}
+
+void ScenePackImporterTest::empty() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+
+    CORRADE_VERIFY(importer->openData(emptyFile()));
+    CORRADE_COMPARE(importer->defaultScene(), -1);
+    CORRADE_COMPARE(importer->sceneCount(), 0);
+    CORRADE_COMPARE(importer->meshCount(), 0);
+    CORRADE_COMPARE(importer->materialCount(), 0);
+    CORRADE_COMPARE(importer->textureCount(), 0);
+    CORRADE_COMPARE(importer->image2DCount(), 0);
+    CORRADE_COMPARE(importer->image3DCount(), 0);
+}
+
+void ScenePackImporterTest::roundtripScene() {
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    const struct Field {
+        UnsignedInt object;
+        Int parent;
+        UnsignedInt mesh;
+        Int meshMaterial;
+    } fields[]{
+        {0, -1, 1, 0},
+        {2, 0, 0, -1},
+        {1, 2, 1, 1}
+    };
+    Containers::StridedArrayView1D<const Field> view = fields;
+
+    SceneData scene{SceneMappingType::UnsignedInt, 5, {}, fields, {
+        SceneFieldData{SceneField::Parent, view.slice(&Field::object), view.slice(&Field::parent)},
+        SceneFieldData{SceneField::Mesh, view.slice(&Field::object), view.slice(&Field::mesh)},
+        SceneFieldData{SceneField::MeshMaterial, view.slice(&Field::object), view.slice(&Field::meshMaterial)},
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(scene));
+    converter->setDefaultScene(0);
+    Containers::Optional<Containers::Array<char>> data = converter->endData();
+    CORRADE_VERIFY(data);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+    CORRADE_COMPARE(importer->sceneCount(), 1);
+    CORRADE_COMPARE(importer->defaultScene(), 0);
+
+    Containers::Optional<SceneData> imported = importer->scene(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->dataFlags(), DataFlags{});
+    CORRADE_COMPARE(imported->mappingType(), SceneMappingType::UnsignedInt);
+    CORRADE_COMPARE(imported->mappingBound(), 5);
+    CORRADE_COMPARE(imported->fieldCount(), 3);
+    CORRADE_COMPARE(imported->data().size(), sizeof(fields));
+
+    /* The fields are interleaved in the original, which is preserved */
+    CORRADE_COMPARE(imported->fieldName(1), SceneField::Mesh);
+    CORRADE_COMPARE(imported->fieldType(1), SceneFieldType::UnsignedInt);
+    CORRADE_COMPARE(imported->field(1).stride()[0], std::ptrdiff_t(sizeof(Field)));
+    CORRADE_COMPARE_AS(imported->mapping<UnsignedInt>(SceneField::Parent),
+        Containers::arrayView<UnsignedInt>({0, 2, 1}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->field<Int>(SceneField::Parent),
+        Containers::arrayView<Int>({-1, 0, 2}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->field<UnsignedInt>(SceneField::Mesh),
+        Containers::arrayView<UnsignedInt>({1, 0, 1}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->field<Int>(SceneField::MeshMaterial),
+        Containers::arrayView<Int>({0, -1, 1}),
+        TestSuite::Compare::Container);
+}
+
+void ScenePackImporterTest::roundtripMesh() {
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    /* Indices with a stride, interleaved attributes and a morph target */
+    const struct Index {
+        UnsignedShort index;
+        UnsignedShort padding;
+    } indices[]{
+        {2, 0xffff}, {0, 0xffff}, {1, 0xffff}
+    };
+    const struct Vertex {
+        Vector3 position;
+        Vector2 textureCoordinates;
+        Vector3 morphedPosition;
+    } vertices[]{
+        {{1.0f, 2.0f, 3.0f}, {0.0f, 1.0f}, {1.5f, 2.5f, 3.5f}},
+        {{4.0f, 5.0f, 6.0f}, {1.0f, 0.0f}, {4.5f, 5.5f, 6.5f}},
+        {{7.0f, 8.0f, 9.0f}, {0.5f, 0.5f}, {7.5f, 8.5f, 9.5f}}
+    };
+    Containers::StridedArrayView1D<const Vertex> view = vertices;
+
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{Containers::stridedArrayView(indices).slice(&Index::index)},
+        {}, vertices, {
+            MeshAttributeData{MeshAttribute::Position, view.slice(&Vertex::position)},
+            MeshAttributeData{MeshAttribute::TextureCoordinates, view.slice(&Vertex::textureCoordinates)},
+            MeshAttributeData{MeshAttribute::Position, view.slice(&Vertex::morphedPosition), 0},
+        }};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(mesh));
+    Containers::Optional<Containers::Array<char>> data = converter->endData();
+    CORRADE_VERIFY(data);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+    CORRADE_COMPARE(importer->meshCount(), 1);
+
+    Containers::Optional<MeshData> imported = importer->mesh(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(imported->indexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(imported->vertexDataFlags(), DataFlags{});
+
+    CORRADE_VERIFY(imported->isIndexed());
+    CORRADE_COMPARE(imported->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE(imported->indexStride(), 4);
+    CORRADE_COMPARE_AS(imported->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({2, 0, 1}),
+        TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(imported->vertexCount(), 3);
+    CORRADE_COMPARE(imported->attributeCount(), 3);
+    CORRADE_COMPARE(imported->attributeStride(0), 32);
+    CORRADE_COMPARE(imported->attributeMorphTargetId(2), 0);
+    CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}, {7.0f, 8.0f, 9.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+        Containers::arrayView<Vector2>({
+            {0.0f, 1.0f}, {1.0f, 0.0f}, {0.5f, 0.5f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Position, 0, 0),
+        Containers::arrayView<Vector3>({
+            {1.5f, 2.5f, 3.5f}, {4.5f, 5.5f, 6.5f}, {7.5f, 8.5f, 9.5f}
+        }), TestSuite::Compare::Container);
+}
+
+void ScenePackImporterTest::roundtripMaterial() {
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    MaterialData material{MaterialType::PbrMetallicRoughness|MaterialType::PbrClearCoat, {
+        {MaterialAttribute::BaseColor, Color4{0.2f, 0.4f, 0.6f, 0.8f}},
+        {MaterialAttribute::Metalness, 0.25f},
+        {"customString", Containers::StringView{"hello"}},
+        {MaterialLayer::ClearCoat},
+        {MaterialAttribute::LayerFactor, 0.5f},
+    }, {3, 5}};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(material));
+    Containers::Optional<Containers::Array<char>> data = converter->endData();
+    CORRADE_VERIFY(data);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+    CORRADE_COMPARE(importer->materialCount(), 1);
+
+    Containers::Optional<MaterialData> imported = importer->material(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->attributeDataFlags(), DataFlags{});
+    CORRADE_COMPARE(imported->layerDataFlags(), DataFlags{});
+    CORRADE_COMPARE(imported->types(), MaterialType::PbrMetallicRoughness|MaterialType::PbrClearCoat);
+    CORRADE_COMPARE(imported->layerCount(), 2);
+    CORRADE_COMPARE(imported->attributeCount(0), 3);
+    CORRADE_COMPARE(imported->attribute<Color4>(MaterialAttribute::BaseColor), (Color4{0.2f, 0.4f, 0.6f, 0.8f}));
+    CORRADE_COMPARE(imported->attribute<Float>(MaterialAttribute::Metalness), 0.25f);
+    CORRADE_COMPARE(imported->attribute<Containers::StringView>("customString"), "hello");
+    CORRADE_COMPARE(imported->layerName(1), "ClearCoat");
+    CORRADE_COMPARE(imported->attribute<Float>(1, MaterialAttribute::LayerFactor), 0.5f);
+}
+
+void ScenePackImporterTest::roundtripTexture() {
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    /* The importer checks that the referenced image exists */
+    const char pixels[4]{};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(ImageData2D{PixelFormat::RGBA8Unorm, {1, 1}, {}, pixels}));
+    CORRADE_VERIFY(converter->add(ImageData2D{PixelFormat::RGBA8Unorm, {1, 1}, {}, pixels}));
+    CORRADE_VERIFY(converter->add(TextureData{TextureType::Texture2D,
+        SamplerFilter::Nearest, SamplerFilter::Linear, SamplerMipmap::Base,
+        {SamplerWrapping::Repeat, SamplerWrapping::ClampToEdge, SamplerWrapping::MirroredRepeat},
+        1}));
+    Containers::Optional<Containers::Array<char>> data = converter->endData();
+    CORRADE_VERIFY(data);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+    CORRADE_COMPARE(importer->textureCount(), 1);
+
+    Containers::Optional<TextureData> imported = importer->texture(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->type(), TextureType::Texture2D);
+    CORRADE_COMPARE(imported->minificationFilter(), SamplerFilter::Nearest);
+    CORRADE_COMPARE(imported->magnificationFilter(), SamplerFilter::Linear);
+    CORRADE_COMPARE(imported->mipmapFilter(), SamplerMipmap::Base);
+    CORRADE_COMPARE(imported->wrapping(), (Math::Vector3<SamplerWrapping>{SamplerWrapping::Repeat, SamplerWrapping::ClampToEdge, SamplerWrapping::MirroredRepeat}));
+    CORRADE_COMPARE(imported->image(), 1);
+}
+
+void ScenePackImporterTest::roundtripImage2D() {
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    /* Rows padded to four bytes in the input, written tightly packed */
+    const char pixels[]{
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 0, 0,
+        10, 11, 12, 13, 14, 15, 16, 17, 18, 0, 0, 0
+    };
+    ImageData2D image{PixelFormat::RGB8Unorm, {3, 2}, {}, pixels, ImageFlag2D::Array};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(image));
+    Containers::Optional<Containers::Array<char>> data = converter->endData();
+    CORRADE_VERIFY(data);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+
+    Containers::Optional<ImageData2D> imported = importer->image2D(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_VERIFY(!imported->isCompressed());
+    CORRADE_COMPARE(imported->dataFlags(), DataFlags{});
+    CORRADE_COMPARE(imported->format(), PixelFormat::RGB8Unorm);
+    CORRADE_COMPARE(imported->size(), (Vector2i{3, 2}));
+    CORRADE_COMPARE(imported->flags(), ImageFlag2D::Array);
+    CORRADE_COMPARE(imported->storage().alignment(), 1);
+    CORRADE_COMPARE_AS(imported->data(), Containers::arrayView<char>({
+        1, 2, 3, 4, 5, 6, 7, 8, 9,
+        10, 11, 12, 13, 14, 15, 16, 17, 18
+    }), TestSuite::Compare::Container);
+}
+
+void ScenePackImporterTest::roundtripImage3DCompressed() {
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    const char blocks[]{
+        1, 2, 3, 4, 5, 6, 7, 8,
+        9, 10, 11, 12, 13, 14, 15, 16
+    };
+    ImageData3D image{CompressedPixelFormat::Bc1RGBAUnorm, {4, 4, 2}, {}, blocks, ImageFlag3D::Array};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(image));
+    Containers::Optional<Containers::Array<char>> data = converter->endData();
+    CORRADE_VERIFY(data);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+    CORRADE_COMPARE(importer->image3DCount(), 1);
+
+    Containers::Optional<ImageData3D> imported = importer->image3D(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_VERIFY(imported->isCompressed());
+    CORRADE_COMPARE(imported->dataFlags(), DataFlags{});
+    CORRADE_COMPARE(imported->compressedFormat(), CompressedPixelFormat::Bc1RGBAUnorm);
+    CORRADE_COMPARE(imported->size(), (Vector3i{4, 4, 2}));
+    CORRADE_COMPARE(imported->flags(), ImageFlag3D::Array);
+    CORRADE_COMPARE_AS(imported->data(), Containers::arrayView(blocks),
+        TestSuite::Compare::Container);
+}
+
+void ScenePackImporterTest::names() {
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    const Vector3 positions[]{{1.0f, 2.0f, 3.0f}};
+    MeshData mesh{MeshPrimitive::Points, {}, positions, {
+        MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(mesh, "first"));
+    CORRADE_VERIFY(converter->add(MaterialData{{}, {}}, "a material"));
+    CORRADE_VERIFY(converter->add(mesh));
+    CORRADE_VERIFY(converter->add(mesh, "third"));
+    Containers::Optional<Containers::Array<char>> data = converter->endData();
+    CORRADE_VERIFY(data);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+    CORRADE_COMPARE(importer->meshCount(), 3);
+    CORRADE_COMPARE(importer->materialCount(), 1);
+    CORRADE_COMPARE(importer->meshName(0), "first");
+    CORRADE_COMPARE(importer->meshName(1), "");
+    CORRADE_COMPARE(importer->meshName(2), "third");
+    CORRADE_COMPARE(importer->materialName(0), "a material");
+    CORRADE_COMPARE(importer->meshForName("third"), 2);
+    CORRADE_COMPARE(importer->meshForName("a material"), -1);
+    CORRADE_COMPARE(importer->materialForName("a material"), 0);
+}
+
+void ScenePackImporterTest::openMemoryZeroCopy() {
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    const Vector3 positions[]{{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}};
+    MeshData mesh{MeshPrimitive::Lines, {}, positions, {
+        MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(mesh));
+    Containers::Optional<Containers::Array<char>> data = converter->endData();
+    CORRADE_VERIFY(data);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+    CORRADE_VERIFY(importer->openMemory(*data));
+
+    /* The vertex data should be a view directly on the passed memory */
+    Containers::Optional<MeshData> imported = importer->mesh(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->vertexDataFlags(), DataFlags{});
+    CORRADE_VERIFY(imported->vertexData().data() >= data->data());
+    CORRADE_VERIFY(imported->vertexData().end() <= data->end());
+    CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView(positions),
+        TestSuite::Compare::Container);
+}
+
+void ScenePackImporterTest::openFile() {
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    const Vector3 positions[]{{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}};
+    MeshData mesh{MeshPrimitive::Lines, {}, positions, {
+        MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}
+    }};
+
+    const Containers::String filename = Utility::Path::join(SCENEPACKIMPORTER_TEST_OUTPUT_DIR, "mesh.pack");
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginFile(filename));
+    CORRADE_VERIFY(converter->add(mesh));
+    CORRADE_VERIFY(converter->endFile());
+
+    /* Both with the file mapped and read into memory */
+    for(bool mapFile: {true, false}) {
+        CORRADE_ITERATION(mapFile);
+
+        Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+        importer->configuration().setValue("mapFile", mapFile);
+        CORRADE_VERIFY(importer->openFile(filename));
+
+        Containers::Optional<MeshData> imported = importer->mesh(0);
+        CORRADE_VERIFY(imported);
+        CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView(positions),
+            TestSuite::Compare::Container);
+    }
+}
+
+void ScenePackImporterTest::invalidScene() {
+    auto&& data = InvalidSceneData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    const struct Field {
+        UnsignedInt object;
+        Int parent;
+        UnsignedInt mesh;
+        Int meshMaterial;
+    } fields[]{
+        {0, -1, 1, 0},
+        {2, 0, 0, -1},
+        {1, 2, 1, 1}
+    };
+    Containers::StridedArrayView1D<const Field> view = fields;
+
+    SceneData scene{SceneMappingType::UnsignedInt, 3, {}, fields, {
+        SceneFieldData{SceneField::Parent, view.slice(&Field::object), view.slice(&Field::parent)},
+        SceneFieldData{SceneField::Mesh, view.slice(&Field::object), view.slice(&Field::mesh)},
+        SceneFieldData{SceneField::MeshMaterial, view.slice(&Field::object), view.slice(&Field::meshMaterial)},
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(scene));
+    Containers::Optional<Containers::Array<char>> file = converter->endData();
+    CORRADE_VERIFY(file);
+
+    const auto& chunk = *reinterpret_cast<const Implementation::ScenePackChunk*>(file->data() + sizeof(Implementation::ScenePackHeader));
+    data.modify(
+        *reinterpret_cast<Implementation::ScenePackScene*>(file->data() + chunk.offset),
+        reinterpret_cast<Implementation::ScenePackSceneField*>(file->data() + chunk.offset + sizeof(Implementation::ScenePackScene)));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+    CORRADE_VERIFY(importer->openData(*file));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->scene(0));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::ScenePackImporter::scene(): {}\n", data.message));
+}
+
+void ScenePackImporterTest::invalidMesh() {
+    auto&& data = InvalidMeshData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    const UnsignedShort indices[]{1, 0};
+    const Vector3 positions[]{{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}};
+    MeshData mesh{MeshPrimitive::Lines,
+        {}, indices, MeshIndexData{indices},
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}
+        }};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(mesh));
+    Containers::Optional<Containers::Array<char>> file = converter->endData();
+    CORRADE_VERIFY(file);
+
+    const auto& chunk = *reinterpret_cast<const Implementation::ScenePackChunk*>(file->data() + sizeof(Implementation::ScenePackHeader));
+    data.modify(
+        *reinterpret_cast<Implementation::ScenePackMesh*>(file->data() + chunk.offset),
+        *reinterpret_cast<Implementation::ScenePackMeshAttribute*>(file->data() + chunk.offset + sizeof(Implementation::ScenePackMesh)));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+    CORRADE_VERIFY(importer->openData(*file));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(0));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::ScenePackImporter::mesh(): {}\n", data.message));
+}
+
+void ScenePackImporterTest::invalidMaterial() {
+    auto&& data = InvalidMaterialData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    MaterialData material{{}, {
+        {MaterialAttribute::BaseColor, Color4{0.2f, 0.4f, 0.6f, 0.8f}},
+        {MaterialAttribute::Metalness, 0.25f},
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(material));
+    Containers::Optional<Containers::Array<char>> file = converter->endData();
+    CORRADE_VERIFY(file);
+
+    /* There are no layer offsets, so the attributes are right after the
+       ScenePackMaterial header */
+    const auto& chunk = *reinterpret_cast<const Implementation::ScenePackChunk*>(file->data() + sizeof(Implementation::ScenePackHeader));
+    data.modify(reinterpret_cast<MaterialAttributeData*>(file->data() + chunk.offset + sizeof(Implementation::ScenePackMaterial)));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+    CORRADE_VERIFY(importer->openData(*file));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->material(0));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::ScenePackImporter::material(): {}\n", data.message));
+}
+
+void ScenePackImporterTest::invalidTexture() {
+    auto&& data = InvalidTextureData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    const char pixels[4]{};
+
+    /* The texture is added first so it's the first chunk */
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(TextureData{TextureType::Texture2D,
+        SamplerFilter::Nearest, SamplerFilter::Linear, SamplerMipmap::Base,
+        SamplerWrapping::Repeat, 0}));
+    CORRADE_VERIFY(converter->add(ImageData2D{PixelFormat::RGBA8Unorm, {1, 1}, {}, pixels}));
+    Containers::Optional<Containers::Array<char>> file = converter->endData();
+    CORRADE_VERIFY(file);
+
+    const auto& chunk = *reinterpret_cast<const Implementation::ScenePackChunk*>(file->data() + sizeof(Implementation::ScenePackHeader));
+    data.modify(*reinterpret_cast<Implementation::ScenePackTexture*>(file->data() + chunk.offset));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+    CORRADE_VERIFY(importer->openData(*file));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->texture(0));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::ScenePackImporter::texture(): {}\n", data.message));
+}
+
+void ScenePackImporterTest::invalidImage() {
+    auto&& data = InvalidImageData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!(_converterManager.load("ScenePackSceneConverter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("ScenePackSceneConverter plugin not found, cannot test");
+
+    const char pixels[24]{};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+    if(data.compressed)
+        CORRADE_VERIFY(converter->add(ImageData2D{CompressedPixelFormat::Bc1RGBAUnorm, {4, 4}, {}, Containers::arrayView(pixels).prefix(8)}));
+    else
+        CORRADE_VERIFY(converter->add(ImageData2D{PixelStorage{}.setAlignment(1), PixelFormat::RGB8Unorm, {3, 2}, {}, Containers::arrayView(pixels).prefix(18)}));
+    Containers::Optional<Containers::Array<char>> file = converter->endData();
+    CORRADE_VERIFY(file);
+
+    const auto& chunk = *reinterpret_cast<const Implementation::ScenePackChunk*>(file->data() + sizeof(Implementation::ScenePackHeader));
+    data.modify(*reinterpret_cast<Implementation::ScenePackImage*>(file->data() + chunk.offset));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+    CORRADE_VERIFY(importer->openData(*file));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(0));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::ScenePackImporter::image2D(): {}\n", data.message));
+}
+
+void ScenePackImporterTest::openTwice() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+
+    CORRADE_VERIFY(importer->openData(emptyFile(1)));
+    CORRADE_VERIFY(importer->openData(emptyFile(1)));
+
+    /* Shouldn't crash, leak or anything */
+}
+
+void ScenePackImporterTest::importTwice() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("ScenePackImporter");
+
+    /* The empty texture chunk is too short to be imported, verify that the
+       failure is the same on second use */
+    CORRADE_VERIFY(importer->openData(emptyFile(1)));
+    CORRADE_COMPARE(importer->textureCount(), 1);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->texture(0));
+    CORRADE_VERIFY(!importer->texture(0));
+    CORRADE_COMPARE(out.str(),
+        "Trade::ScenePackImporter::texture(): expected at least 32 bytes but got 0\n"
+        "Trade::ScenePackImporter::texture(): expected at least 32 bytes but got 0\n");
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::ScenePackImporterTest)
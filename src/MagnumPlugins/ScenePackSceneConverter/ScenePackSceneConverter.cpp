@@ -0,0 +1,370 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "ScenePackSceneConverter.h"
+
+#include <cstring>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MaterialData.h>
+#include <Magnum/Trade/MeshData.h>
+#include <Magnum/Trade/SceneData.h>
+#include <Magnum/Trade/TextureData.h>
+
+#include "Magnum/Implementation/instrumentation.h"
+#include "MagnumPlugins/ScenePackImporter/ScenePackHeader.h"
+
+namespace Magnum { namespace Trade {
+
+using Implementation::ScenePackChunkType;
+
+struct ScenePackSceneConverter::State {
+    struct Chunk {
+        ScenePackChunkType type;
+        Containers::String name;
+        Containers::Array<char> data;
+    };
+
+    /* The added data are packed right away, as the originals aren't
+       guaranteed to stay in scope after add() returns */
+    Containers::Array<Chunk> chunks;
+    Int defaultScene = -1;
+};
+
+namespace {
+
+std::size_t alignOffset(const std::size_t offset) {
+    return (offset + Implementation::ScenePackAlignment - 1)/Implementation::ScenePackAlignment*Implementation::ScenePackAlignment;
+}
+
+/* The output isn't guaranteed to be suitably aligned for the structures, so
+   they're assembled on stack and copied */
+template<class T> void write(const Containers::ArrayView<char> out, const std::size_t offset, const T& value) {
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> packImage(const ImageData<dimensions>& image) {
+    Implementation::ScenePackImage header{};
+    header.flags = UnsignedShort(image.flags());
+    const Vector3i size = Math::Vector<3, Int>::pad(image.size(), 1);
+    Utility::copy(Containers::arrayView(size.data(), 3), header.size);
+
+    if(image.isCompressed()) {
+        const CompressedPixelStorage storage = image.compressedStorage();
+        if(storage.rowLength() || storage.imageHeight() || storage.skip() != Vector3i{}) {
+            Error{} << "Trade::ScenePackSceneConverter::add(): compressed images with non-default pixel storage are not supported";
+            return {};
+        }
+
+        header.compressed = 1;
+        header.format = UnsignedInt(image.compressedFormat());
+        header.dataOffset = alignOffset(sizeof(Implementation::ScenePackImage));
+        header.dataSize = image.data().size();
+
+        Containers::Array<char> out{ValueInit, std::size_t(header.dataOffset + header.dataSize)};
+        write(out, 0, header);
+        Utility::copy(image.data(), out.sliceSize(std::size_t(header.dataOffset), std::size_t(header.dataSize)));
+        /* GCC 4.8 and Clang 3.8 need extra help here */
+        return Containers::optional(Utility::move(out));
+    }
+
+    /* Pick the row alignment that makes the data tightly packed */
+    const std::size_t rowSize = std::size_t(size.x())*image.pixelSize();
+    header.format = UnsignedInt(image.format());
+    header.formatExtra = image.formatExtra();
+    header.pixelSize = image.pixelSize();
+    header.alignment = rowSize % 4 == 0 ? 4 : 1;
+    header.dataOffset = alignOffset(sizeof(Implementation::ScenePackImage));
+    header.dataSize = rowSize*size.y()*size.z();
+
+    Containers::Array<char> out{ValueInit, std::size_t(header.dataOffset + header.dataSize)};
+    write(out, 0, header);
+    const ImageView<dimensions, char> view{PixelStorage{}.setAlignment(header.alignment), image.format(), image.formatExtra(), image.pixelSize(), image.size(), out.sliceSize(std::size_t(header.dataOffset), std::size_t(header.dataSize))};
+    Utility::copy(image.pixels(), view.pixels());
+    /* GCC 4.8 and Clang 3.8 need extra help here */
+    return Containers::optional(Utility::move(out));
+}
+
+}
+
+ScenePackSceneConverter::ScenePackSceneConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractSceneConverter{manager, plugin} {}
+
+ScenePackSceneConverter::~ScenePackSceneConverter() = default;
+
+SceneConverterFeatures ScenePackSceneConverter::doFeatures() const {
+    return SceneConverterFeature::ConvertMultipleToData|
+           SceneConverterFeature::AddScenes|
+           SceneConverterFeature::AddMeshes|
+           SceneConverterFeature::AddMaterials|
+           SceneConverterFeature::AddTextures|
+           SceneConverterFeature::AddImages2D|
+           SceneConverterFeature::AddImages3D|
+           SceneConverterFeature::AddCompressedImages2D|
+           SceneConverterFeature::AddCompressedImages3D;
+}
+
+bool ScenePackSceneConverter::doBeginData() {
+    _state.emplace();
+    return true;
+}
+
+void ScenePackSceneConverter::doAbort() { _state = {}; }
+
+void ScenePackSceneConverter::doSetDefaultScene(const UnsignedInt id) {
+    _state->defaultScene = id;
+}
+
+Containers::Optional<Containers::Array<char>> ScenePackSceneConverter::doEndData() {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doEndData"};
+    const Containers::ArrayView<const State::Chunk> chunks = _state->chunks;
+
+    /* The header and the chunk table is followed by null-terminated names and
+       then the aligned chunk data */
+    const std::size_t chunkTableOffset = sizeof(Implementation::ScenePackHeader);
+    std::size_t size = chunkTableOffset + chunks.size()*sizeof(Implementation::ScenePackChunk);
+    for(const State::Chunk& chunk: chunks)
+        size += chunk.name.size() + 1;
+    for(const State::Chunk& chunk: chunks)
+        size = alignOffset(size) + chunk.data.size();
+
+    Containers::Array<char> out{ValueInit, size};
+
+    Implementation::ScenePackHeader header{};
+    Utility::copy(Implementation::ScenePackMagic, header.magic);
+    header.version = Implementation::ScenePackVersion;
+    header.materialAttributeSize = sizeof(MaterialAttributeData);
+    header.chunkCount = chunks.size();
+    header.defaultScene = _state->defaultScene;
+    write(out, 0, header);
+
+    std::size_t nameOffset = chunkTableOffset + chunks.size()*sizeof(Implementation::ScenePackChunk);
+    std::size_t dataOffset = nameOffset;
+    for(const State::Chunk& chunk: chunks)
+        dataOffset += chunk.name.size() + 1;
+    for(std::size_t i = 0; i != chunks.size(); ++i) {
+        const State::Chunk& chunk = chunks[i];
+        dataOffset = alignOffset(dataOffset);
+
+        Implementation::ScenePackChunk entry{};
+        entry.type = UnsignedInt(chunk.type);
+        entry.nameSize = chunk.name.size();
+        entry.nameOffset = nameOffset;
+        entry.offset = dataOffset;
+        entry.size = chunk.data.size();
+        write(out, chunkTableOffset + i*sizeof(Implementation::ScenePackChunk), entry);
+
+        std::memcpy(out.data() + nameOffset, chunk.name.data(), chunk.name.size());
+        Utility::copy(chunk.data, out.sliceSize(dataOffset, chunk.data.size()));
+        nameOffset += chunk.name.size() + 1;
+        dataOffset += chunk.data.size();
+    }
+
+    /* GCC 4.8 and Clang 3.8 need extra help here */
+    return Containers::optional(Utility::move(out));
+}
+
+bool ScenePackSceneConverter::doAdd(UnsignedInt, const SceneData& scene, const Containers::StringView name) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doAdd"};
+    const Containers::ArrayView<const char> data = scene.data();
+    const char* const dataBegin = data.data();
+    const char* const dataEnd = data.end();
+
+    Containers::Array<Implementation::ScenePackSceneField> fields;
+    for(UnsignedInt i = 0; i != scene.fieldCount(); ++i) {
+        const SceneFieldType type = scene.fieldType(i);
+        if(!Implementation::isScenePackFieldTypeSupported(type)) {
+            if(!(flags() & SceneConverterFlag::Quiet))
+                Warning{} << "Trade::ScenePackSceneConverter::add(): skipping field" << scene.fieldName(i) << "of unsupported type" << type;
+            continue;
+        }
+
+        /* Offset-only fields and views of zero-sized fields may not point
+           anywhere meaningful, the data pointers are only taken if there are
+           actual items */
+        Implementation::ScenePackSceneField field{};
+        field.name = UnsignedInt(scene.fieldName(i));
+        field.type = UnsignedInt(type);
+        field.size = scene.fieldSize(i);
+        field.fieldArraySize = scene.fieldArraySize(i);
+        field.flags = UnsignedByte(scene.fieldFlags(i) & ~SceneFieldFlag::OffsetOnly);
+        if(field.size) {
+            const Containers::StridedArrayView2D<const char> mapping = scene.mapping(i);
+            const Containers::StridedArrayView2D<const char> fieldData = scene.field(i);
+            const char* const mappingBegin = static_cast<const char*>(mapping.data());
+            const char* const fieldBegin = static_cast<const char*>(fieldData.data());
+            if(mappingBegin < dataBegin || mappingBegin > dataEnd ||
+               fieldBegin < dataBegin || fieldBegin > dataEnd) {
+                Error{} << "Trade::ScenePackSceneConverter::add(): data of field" << scene.fieldName(i) << "are not contained in the scene data";
+                return false;
+            }
+
+            field.mappingOffset = mappingBegin - dataBegin;
+            field.mappingStride = mapping.stride()[0];
+            field.fieldOffset = fieldBegin - dataBegin;
+            field.fieldStride = fieldData.stride()[0];
+        }
+
+        arrayAppend(fields, field);
+    }
+
+    Implementation::ScenePackScene header{};
+    header.mappingType = UnsignedInt(scene.mappingType());
+    header.fieldCount = fields.size();
+    header.mappingBound = scene.mappingBound();
+    header.dataOffset = alignOffset(sizeof(Implementation::ScenePackScene) + fields.size()*sizeof(Implementation::ScenePackSceneField));
+    header.dataSize = data.size();
+
+    Containers::Array<char> out{ValueInit, std::size_t(header.dataOffset + header.dataSize)};
+    write(out, 0, header);
+    Utility::copy(Containers::arrayCast<const char>(fields), out.sliceSize(sizeof(Implementation::ScenePackScene), fields.size()*sizeof(Implementation::ScenePackSceneField)));
+    Utility::copy(data, out.sliceSize(std::size_t(header.dataOffset), data.size()));
+
+    arrayAppend(_state->chunks, State::Chunk{ScenePackChunkType::Scene, name, Utility::move(out)});
+    return true;
+}
+
+bool ScenePackSceneConverter::doAdd(UnsignedInt, const MeshData& mesh, const Containers::StringView name) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doAdd"};
+    Implementation::ScenePackMesh header{};
+    header.primitive = UnsignedInt(mesh.primitive());
+    if(mesh.isIndexed()) {
+        if(isMeshIndexTypeImplementationSpecific(mesh.indexType())) {
+            Error{} << "Trade::ScenePackSceneConverter::add(): implementation-specific index type" << Debug::hex << meshIndexTypeUnwrap(mesh.indexType()) << "is not supported";
+            return false;
+        }
+
+        header.indexType = UnsignedInt(mesh.indexType());
+        header.indexCount = mesh.indexCount();
+        header.indexStride = mesh.indexStride();
+        header.indexOffset = mesh.indexOffset();
+    }
+    header.vertexCount = mesh.vertexCount();
+    header.attributeCount = mesh.attributeCount();
+
+    const Containers::ArrayView<const char> indexData = mesh.indexData();
+    const Containers::ArrayView<const char> vertexData = mesh.vertexData();
+    const std::size_t attributeTableOffset = sizeof(Implementation::ScenePackMesh);
+    header.indexDataOffset = alignOffset(attributeTableOffset + mesh.attributeCount()*sizeof(Implementation::ScenePackMeshAttribute));
+    header.indexDataSize = indexData.size();
+    header.vertexDataOffset = alignOffset(header.indexDataOffset + indexData.size());
+    header.vertexDataSize = vertexData.size();
+
+    Containers::Array<char> out{ValueInit, std::size_t(header.vertexDataOffset + header.vertexDataSize)};
+    write(out, 0, header);
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        Implementation::ScenePackMeshAttribute attribute{};
+        attribute.name = UnsignedInt(mesh.attributeName(i));
+        attribute.format = UnsignedInt(mesh.attributeFormat(i));
+        attribute.offset = mesh.attributeOffset(i);
+        attribute.stride = mesh.attributeStride(i);
+        attribute.arraySize = mesh.attributeArraySize(i);
+        attribute.morphTargetId = mesh.attributeMorphTargetId(i);
+        write(out, attributeTableOffset + i*sizeof(Implementation::ScenePackMeshAttribute), attribute);
+    }
+    Utility::copy(indexData, out.sliceSize(std::size_t(header.indexDataOffset), indexData.size()));
+    Utility::copy(vertexData, out.sliceSize(std::size_t(header.vertexDataOffset), vertexData.size()));
+
+    arrayAppend(_state->chunks, State::Chunk{ScenePackChunkType::Mesh, name, Utility::move(out)});
+    return true;
+}
+
+bool ScenePackSceneConverter::doAdd(UnsignedInt, const MaterialData& material, const Containers::StringView name) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doAdd"};
+    const Containers::ArrayView<const MaterialAttributeData> attributes = material.attributeData();
+    const Containers::ArrayView<const UnsignedInt> layerOffsets = material.layerData();
+    for(const MaterialAttributeData& attribute: attributes) {
+        if(attribute.type() == MaterialAttributeType::Pointer ||
+           attribute.type() == MaterialAttributeType::MutablePointer) {
+            Error{} << "Trade::ScenePackSceneConverter::add(): material attribute" << attribute.name() << "of type" << attribute.type() << "can't be stored";
+            return false;
+        }
+    }
+
+    Implementation::ScenePackMaterial header{};
+    header.types = UnsignedInt(material.types());
+    header.layerCount = layerOffsets.size();
+    header.attributeCount = attributes.size();
+
+    const std::size_t layerOffsetsOffset = sizeof(Implementation::ScenePackMaterial);
+    const std::size_t attributesOffset = alignOffset(layerOffsetsOffset + layerOffsets.size()*sizeof(UnsignedInt));
+    Containers::Array<char> out{ValueInit, attributesOffset + attributes.size()*sizeof(MaterialAttributeData)};
+    write(out, 0, header);
+    Utility::copy(Containers::arrayCast<const char>(layerOffsets), out.sliceSize(layerOffsetsOffset, layerOffsets.size()*sizeof(UnsignedInt)));
+    Utility::copy(Containers::arrayCast<const char>(attributes), out.sliceSize(attributesOffset, attributes.size()*sizeof(MaterialAttributeData)));
+
+    arrayAppend(_state->chunks, State::Chunk{ScenePackChunkType::Material, name, Utility::move(out)});
+    return true;
+}
+
+bool ScenePackSceneConverter::doAdd(UnsignedInt, const TextureData& texture, const Containers::StringView name) {
+    Implementation::ScenePackTexture packed{};
+    packed.type = UnsignedInt(texture.type());
+    packed.minificationFilter = UnsignedInt(texture.minificationFilter());
+    packed.magnificationFilter = UnsignedInt(texture.magnificationFilter());
+    packed.mipmapFilter = UnsignedInt(texture.mipmapFilter());
+    for(std::size_t i = 0; i != 3; ++i)
+        packed.wrapping[i] = UnsignedInt(texture.wrapping()[i]);
+    packed.image = texture.image();
+
+    Containers::Array<char> out{ValueInit, sizeof(Implementation::ScenePackTexture)};
+    write(out, 0, packed);
+
+    arrayAppend(_state->chunks, State::Chunk{ScenePackChunkType::Texture, name, Utility::move(out)});
+    return true;
+}
+
+bool ScenePackSceneConverter::doAdd(UnsignedInt, const ImageData2D& image, const Containers::StringView name) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doAdd"};
+    Containers::Optional<Containers::Array<char>> out = packImage(image);
+    if(!out) return false;
+
+    arrayAppend(_state->chunks, State::Chunk{ScenePackChunkType::Image2D, name, Utility::move(*out)});
+    return true;
+}
+
+bool ScenePackSceneConverter::doAdd(UnsignedInt, const ImageData3D& image, const Containers::StringView name) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doAdd"};
+    Containers::Optional<Containers::Array<char>> out = packImage(image);
+    if(!out) return false;
+
+    arrayAppend(_state->chunks, State::Chunk{ScenePackChunkType::Image3D, name, Utility::move(*out)});
+    return true;
+}
+
+}}
+
+CORRADE_PLUGIN_REGISTER(ScenePackSceneConverter, Magnum::Trade::ScenePackSceneConverter,
+    MAGNUM_TRADE_ABSTRACTSCENECONVERTER_PLUGIN_INTERFACE)
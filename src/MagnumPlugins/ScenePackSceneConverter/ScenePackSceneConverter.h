@@ -0,0 +1,170 @@
+#ifndef Magnum_Trade_ScenePackSceneConverter_h
+#define Magnum_Trade_ScenePackSceneConverter_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Trade::ScenePackSceneConverter
+ * @m_since_latest_{plugins}
+ */
+
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
+
+#include "MagnumPlugins/ScenePackSceneConverter/configure.h"
+
+#ifndef DOXYGEN_GENERATING_OUTPUT
+#ifndef MAGNUM_SCENEPACKSCENECONVERTER_BUILD_STATIC
+    #ifdef ScenePackSceneConverter_EXPORTS
+        #define MAGNUM_SCENEPACKSCENECONVERTER_EXPORT CORRADE_VISIBILITY_EXPORT
+    #else
+        #define MAGNUM_SCENEPACKSCENECONVERTER_EXPORT CORRADE_VISIBILITY_IMPORT
+    #endif
+#else
+    #define MAGNUM_SCENEPACKSCENECONVERTER_EXPORT CORRADE_VISIBILITY_STATIC
+#endif
+#define MAGNUM_SCENEPACKSCENECONVERTER_LOCAL CORRADE_VISIBILITY_LOCAL
+#else
+#define MAGNUM_SCENEPACKSCENECONVERTER_EXPORT
+#define MAGNUM_SCENEPACKSCENECONVERTER_LOCAL
+#endif
+
+namespace Magnum { namespace Trade {
+
+/**
+@brief Scene pack converter plugin
+@m_since_latest_{plugins}
+
+Writes scenes, meshes, materials, textures and images into a scene pack, which
+stores them in exactly the memory layout of @ref SceneData, @ref MeshData,
+@ref MaterialData, @ref TextureData and @ref ImageData together with a table
+of offsets. Use @ref ScenePackImporter to import the files, which then only
+returns views on the file contents without any parsing. The intended use is
+converting assets from formats such as glTF once into a cache that's then
+loaded instantly, for example with the following:
+
+@code{.sh}
+magnum-sceneconverter scene.gltf scene.pack --converter ScenePackSceneConverter
+@endcode
+
+@section Trade-ScenePackSceneConverter-usage Usage
+
+@m_class{m-note m-success}
+
+@par
+    This class is a plugin that's meant to be dynamically loaded and used
+    through the base @ref AbstractSceneConverter interface. See its
+    documentation for introduction and usage examples.
+
+This plugin depends on the @ref Trade library and is built if
+`MAGNUM_WITH_SCENEPACKSCENECONVERTER` is enabled when building Magnum Plugins.
+To use as a dynamic plugin, load @cpp "ScenePackSceneConverter" @ce via
+@ref Corrade::PluginManager::Manager.
+
+Additionally, if you're using Magnum as a CMake subproject, bundle the
+[magnum-plugins repository](https://github.com/mosra/magnum-plugins) and do
+the following:
+
+@code{.cmake}
+set(MAGNUM_WITH_SCENEPACKSCENECONVERTER ON CACHE BOOL "" FORCE)
+add_subdirectory(magnum-plugins EXCLUDE_FROM_ALL)
+
+# So the dynamically loaded plugin gets built implicitly
+add_dependencies(your-app MagnumPlugins::ScenePackSceneConverter)
+@endcode
+
+To use as a static plugin or as a dependency of another plugin with CMake, put
+[FindMagnumPlugins.cmake](https://github.com/mosra/magnum-plugins/blob/master/modules/FindMagnumPlugins.cmake)
+into your `modules/` directory, request the `ScenePackSceneConverter`
+component of the `MagnumPlugins` package and link to the
+`MagnumPlugins::ScenePackSceneConverter` target:
+
+@code{.cmake}
+find_package(MagnumPlugins REQUIRED ScenePackSceneConverter)
+
+# ...
+target_link_libraries(your-app PRIVATE MagnumPlugins::ScenePackSceneConverter)
+@endcode
+
+See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
+information.
+
+@section Trade-ScenePackSceneConverter-behavior Behavior and limitations
+
+The plugin supports @ref SceneConverterFeature::ConvertMultipleToData, which
+means it also allows writing to a file. Scenes, meshes, materials, textures
+and both uncompressed and compressed 2D and 3D images can be added, together
+with their names and a default scene. All data are copied verbatim, preserving
+their layout including interleaving, strides and padding. The file stores all
+values in the native endianness and with the @ref MaterialAttributeData layout
+of the current platform, so it's meant to be used as a platform-specific
+cache and not for distribution.
+
+Object names, custom scene field, mesh attribute and material layer names,
+cameras, lights, skins, animations and mesh levels are not supported.
+Custom scene fields and mesh attributes are stored with just their numeric
+value.
+
+Scene fields of @ref SceneFieldType::Bit, string and pointer types are
+skipped with a warning. Materials containing
+@ref MaterialAttributeType::Pointer or
+@relativeref{MaterialAttributeType,MutablePointer} attributes, meshes with
+implementation-specific index types and scenes with field data not contained
+in @ref SceneData::data() fail to be converted.
+
+Uncompressed images are written with rows aligned to four bytes if the row
+size is a multiple of four and tightly packed otherwise, regardless of the
+@ref PixelStorage of the input. Compressed images with non-default
+@ref CompressedPixelStorage are not supported.
+*/
+class MAGNUM_SCENEPACKSCENECONVERTER_EXPORT ScenePackSceneConverter: public AbstractSceneConverter {
+    public:
+        /** @brief Plugin manager constructor */
+        explicit ScenePackSceneConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
+
+        ~ScenePackSceneConverter();
+
+    private:
+        struct State;
+
+        MAGNUM_SCENEPACKSCENECONVERTER_LOCAL SceneConverterFeatures doFeatures() const override;
+        MAGNUM_SCENEPACKSCENECONVERTER_LOCAL bool doBeginData() override;
+        MAGNUM_SCENEPACKSCENECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doEndData() override;
+        MAGNUM_SCENEPACKSCENECONVERTER_LOCAL void doAbort() override;
+
+        MAGNUM_SCENEPACKSCENECONVERTER_LOCAL void doSetDefaultScene(UnsignedInt id) override;
+        MAGNUM_SCENEPACKSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const SceneData& scene, Containers::StringView name) override;
+        MAGNUM_SCENEPACKSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const MeshData& mesh, Containers::StringView name) override;
+        MAGNUM_SCENEPACKSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const MaterialData& material, Containers::StringView name) override;
+        MAGNUM_SCENEPACKSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const TextureData& texture, Containers::StringView name) override;
+        MAGNUM_SCENEPACKSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const ImageData2D& image, Containers::StringView name) override;
+        MAGNUM_SCENEPACKSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const ImageData3D& image, Containers::StringView name) override;
+
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
@@ -0,0 +1,190 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MaterialData.h>
+#include <Magnum/Trade/MeshData.h>
+#include <Magnum/Trade/SceneData.h>
+
+#include "MagnumPlugins/ScenePackImporter/ScenePackHeader.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct ScenePackSceneConverterTest: TestSuite::Tester {
+    explicit ScenePackSceneConverterTest();
+
+    void empty();
+
+    void sceneUnsupportedField();
+    void meshImplementationSpecificIndexType();
+    void materialPointerAttribute();
+    void imageCompressedNonDefaultStorage();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractSceneConverter> _manager{"nonexistent"};
+};
+
+const struct {
+    const char* name;
+    SceneConverterFlags flags;
+    bool quiet;
+} QuietData[]{
+    {"", {}, false},
+    {"quiet", SceneConverterFlag::Quiet, true}
+};
+
+ScenePackSceneConverterTest::ScenePackSceneConverterTest() {
+    addTests({&ScenePackSceneConverterTest::empty});
+
+    addInstancedTests({&ScenePackSceneConverterTest::sceneUnsupportedField},
+        Containers::arraySize(QuietData));
+
+    addTests({&ScenePackSceneConverterTest::meshImplementationSpecificIndexType,
+              &ScenePackSceneConverterTest::materialPointerAttribute,
+              &ScenePackSceneConverterTest::imageCompressedNonDefaultStorage});
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef SCENEPACKSCENECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(SCENEPACKSCENECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void ScenePackSceneConverterTest::empty() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("ScenePackSceneConverter");
+
+    CORRADE_VERIFY(converter->beginData());
+    Containers::Optional<Containers::Array<char>> data = converter->endData();
+    CORRADE_VERIFY(data);
+    CORRADE_COMPARE(data->size(), sizeof(Implementation::ScenePackHeader));
+
+    const auto& header = *reinterpret_cast<const Implementation::ScenePackHeader*>(data->data());
+    CORRADE_COMPARE((Containers::StringView{header.magic, sizeof(header.magic)}), "MGNSPACK");
+    CORRADE_COMPARE(header.version, Implementation::ScenePackVersion);
+    CORRADE_COMPARE(header.materialAttributeSize, sizeof(MaterialAttributeData));
+    CORRADE_COMPARE(header.chunkCount, 0);
+    CORRADE_COMPARE(header.defaultScene, -1);
+}
+
+void ScenePackSceneConverterTest::sceneUnsupportedField() {
+    auto&& data = QuietData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const struct Field {
+        UnsignedInt object;
+        Int parent;
+        const void* pointer;
+    } fields[]{
+        {0, -1, nullptr},
+        {1, 0, nullptr}
+    };
+    Containers::StridedArrayView1D<const Field> view = fields;
+
+    SceneData scene{SceneMappingType::UnsignedInt, 2, {}, fields, {
+        SceneFieldData{SceneField::Parent, view.slice(&Field::object), view.slice(&Field::parent)},
+        SceneFieldData{sceneFieldCustom(3), view.slice(&Field::object), view.slice(&Field::pointer)},
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("ScenePackSceneConverter");
+    converter->setFlags(data.flags);
+    CORRADE_VERIFY(converter->beginData());
+
+    std::ostringstream out;
+    {
+        Warning redirectWarning{&out};
+        CORRADE_VERIFY(converter->add(scene));
+    }
+    Containers::Optional<Containers::Array<char>> file = converter->endData();
+    CORRADE_VERIFY(file);
+
+    /* Only the parent field is written */
+    const auto& chunk = *reinterpret_cast<const Implementation::ScenePackChunk*>(file->data() + sizeof(Implementation::ScenePackHeader));
+    const auto& header = *reinterpret_cast<const Implementation::ScenePackScene*>(file->data() + chunk.offset);
+    CORRADE_COMPARE(header.fieldCount, 1);
+
+    if(data.quiet)
+        CORRADE_COMPARE(out.str(), "");
+    else
+        CORRADE_COMPARE(out.str(), "Trade::ScenePackSceneConverter::add(): skipping field Trade::SceneField::Custom(3) of unsupported type Trade::SceneFieldType::Pointer\n");
+}
+
+void ScenePackSceneConverterTest::meshImplementationSpecificIndexType() {
+    const char indices[6]{};
+    MeshData mesh{MeshPrimitive::Points,
+        {}, indices, MeshIndexData{meshIndexTypeWrap(0xcaca), Containers::StridedArrayView1D<const void>{indices, 3, 2}},
+        1};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(mesh));
+    CORRADE_COMPARE(out.str(), "Trade::ScenePackSceneConverter::add(): implementation-specific index type 0xcaca is not supported\n");
+}
+
+void ScenePackSceneConverterTest::materialPointerAttribute() {
+    const Float value{};
+    MaterialData material{{}, {
+        {"pointer", &value}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(material));
+    CORRADE_COMPARE(out.str(), "Trade::ScenePackSceneConverter::add(): material attribute pointer of type Trade::MaterialAttributeType::Pointer can't be stored\n");
+}
+
+void ScenePackSceneConverterTest::imageCompressedNonDefaultStorage() {
+    const char data[16]{};
+    ImageData2D image{CompressedPixelStorage{}.setSkip({0, 4, 0}), CompressedPixelFormat::Bc1RGBAUnorm, {4, 4}, {}, data};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("ScenePackSceneConverter");
+    CORRADE_VERIFY(converter->beginData());
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(image));
+    CORRADE_COMPARE(out.str(), "Trade::ScenePackSceneConverter::add(): compressed images with non-default pixel storage are not supported\n");
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::ScenePackSceneConverterTest)
@@ -25,13 +25,22 @@
 
 #include "SpirvToolsConverter.h"
 
-#include <Corrade/Containers/Array.h>
+#include <cstdlib>
+#include <sstream>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Sha1.h>
+#include <Magnum/Math/Functions.h>
 
 #include "spirv-tools/libspirv.h"
 /* Unfortunately the C optimizer interface is so minimal that it's useless. No
@@ -39,10 +48,26 @@
 #include "spirv-tools/optimizer.hpp"
 #include "MagnumPlugins/SpirvToolsShaderConverter/configureInternal.h"
 
+#if defined(CORRADE_BUILD_MULTITHREADED) && (!defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__))
+#include <atomic>
+#endif
+
 namespace Magnum { namespace ShaderTools {
 
 using namespace Containers::Literals;
 
+namespace {
+
+/* Hashes of modules that passed validation, if the validationCache option is
+   enabled. The mutex is there as convertDataToDataBatch() may access it from
+   multiple threads. */
+struct ValidationCache {
+    std::unordered_set<std::string> hashes;
+    std::mutex mutex;
+};
+
+}
+
 struct SpirvToolsConverter::State {
     /* Initialized in the constructor */
     Format inputFormat, outputFormat;
@@ -51,9 +76,30 @@ struct SpirvToolsConverter::State {
     Containers::String inputFilename, outputFilename;
 
     Containers::String optimizationLevel;
+
+    /* Optimizers with passes registered for optimizerEnv and
+       optimizerLevel, reused across conversions. One for each thread used
+       by convertDataToDataBatch(), as an optimizer can't run on multiple
+       threads at the same time. Recreated when the level or the environment
+       changes. */
+    spv_target_env optimizerEnv;
+    Containers::String optimizerLevel;
+    Containers::Array<Containers::Pointer<spvtools::Optimizer>> optimizers;
+
+    /* Parsed time report from the last conversion, if optimizerTimeReport
+       is enabled */
+    Containers::Array<OptimizerPassTime> optimizerTimeReport;
+
+    /* Statistics from the last conversion, if optimizationStatistics is
+       enabled */
+    Containers::Array<OptimizationStatistics> optimizationStatistics;
+
+    ValidationCache validationCache;
 };
 
 SpirvToolsConverter::SpirvToolsConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractConverter{manager, plugin}, _state{InPlaceInit} {
+    _state->optimizerEnv = SPV_ENV_VULKAN_1_0;
+
     /* If the plugin was loaded through some of the aliases, set implicit
        input/output formats */
     if(plugin == "SpirvAssemblyToSpirvShaderConverter") {
@@ -96,6 +142,18 @@ void SpirvToolsConverter::doSetOutputFormat(const Format format, const Container
     _state->outputVersion = Containers::String::nullTerminatedGlobalView(version);
 }
 
+Containers::ArrayView<const SpirvToolsConverter::OptimizerPassTime> SpirvToolsConverter::optimizerTimeReport() const {
+    return _state->optimizerTimeReport;
+}
+
+void SpirvToolsConverter::clearValidationCache() {
+    _state->validationCache.hashes.clear();
+}
+
+Containers::ArrayView<const SpirvToolsConverter::OptimizationStatistics> SpirvToolsConverter::optimizationStatistics() const {
+    return _state->optimizationStatistics;
+}
+
 void SpirvToolsConverter::doSetOptimizationLevel(const Containers::StringView level) {
     _state->optimizationLevel = Containers::String::nullTerminatedGlobalView(level);
 }
@@ -208,6 +266,378 @@ void setValidationOptions(spv_validator_options& options, const Utility::Configu
     #endif
 }
 
+/* Key for the validation cache, a SHA-1 of the target environment, all
+   options used by setValidationOptions() and the module binary */
+std::string validationCacheKey(const spv_target_env env, const Utility::ConfigurationGroup& configuration, const spv_binary binary) {
+    Utility::Sha1 sha1;
+    const Containers::String envString = Utility::format("{}\n", Int(env));
+    sha1 << Containers::ArrayView<const char>{envString.data(), envString.size()};
+    for(const char* name: {
+        "maxStructMembers",
+        "maxStructDepth",
+        "maxLocalVariables",
+        "maxGlobalVariables",
+        "maxSwitchBranches",
+        "maxFunctionArgs",
+        "maxControlFlowNestingDepth",
+        "maxAccessChainIndices",
+        "maxIdBound",
+        "relaxLogicalPointer",
+        "relaxBlockLayout",
+        "uniformBufferStandardLayout",
+        "scalarBlockLayout",
+        "skipBlockLayout",
+        "relaxStructStore",
+        "beforeHlslLegalization"
+    }) {
+        const Containers::String option = Utility::format("{}={}\n", name, configuration.value<Containers::StringView>(name));
+        sha1 << Containers::ArrayView<const char>{option.data(), option.size()};
+    }
+    sha1 << Containers::ArrayView<const char>{reinterpret_cast<const char*>(binary->code), binary->wordCount*4};
+    return sha1.digest().hexString();
+}
+
+bool isValidated(ValidationCache* const cache, const std::string& key) {
+    if(!cache) return false;
+    std::lock_guard<std::mutex> lock{cache->mutex};
+    return cache->hashes.find(key) != cache->hashes.end();
+}
+
+void markValidated(ValidationCache* const cache, std::string&& key) {
+    if(!cache) return;
+    std::lock_guard<std::mutex> lock{cache->mutex};
+    cache->hashes.insert(Utility::move(key));
+}
+
+/* Prints optimizer messages using our own APIs, to whatever Debug, Warning
+   and Error output is current on the thread that runs the optimizer */
+void printOptimizerMessage(spv_message_level_t level, const char* file, const spv_position_t& position, const char* message) {
+    std::ostream* output{};
+    const char* prefix{};
+    switch(level) {
+        /* LCOV_EXCL_START */
+        case SPV_MSG_FATAL:
+            output = Error::output();
+            prefix = "fatal optimization error:";
+            break;
+        case SPV_MSG_INTERNAL_ERROR:
+            output = Error::output();
+            prefix = "internal optimization error:";
+            break;
+        case SPV_MSG_ERROR:
+            output = Error::output();
+            prefix = "optimization error:";
+            break;
+        case SPV_MSG_WARNING:
+            output = Warning::output();
+            prefix = "optimization warning:";
+            break;
+        case SPV_MSG_INFO:
+            output = Debug::output();
+            prefix = "optimization info";
+            break;
+        case SPV_MSG_DEBUG:
+            output = Debug::output();
+            prefix = "optimization debug info";
+            break;
+        /* LCOV_EXCL_STOP */
+    }
+    /* output can be nullptr in case Debug/Warning/Error is silenced */
+    CORRADE_INTERNAL_ASSERT(prefix);
+
+    Debug out{output};
+    out << "ShaderTools::SpirvToolsConverter::convertDataToData():" << prefix << Debug::newline;
+    spv_diagnostic_t diag{position, const_cast<char*>(message), false};
+    printDiagnostic(out, file, &diag);
+}
+
+/* Creates an optimizer with passes for given level, which is expected to be
+   already checked for validity. As the message consumer prints to whatever
+   output is current on the calling thread, the instance can be reused
+   across conversions. */
+Containers::Pointer<spvtools::Optimizer> createOptimizer(const spv_target_env env, const Containers::StringView level) {
+    Containers::Pointer<spvtools::Optimizer> optimizer{InPlaceInit, env};
+    if(level == "1"_s)
+        optimizer->RegisterPerformancePasses();
+    else if(level == "s"_s)
+        optimizer->RegisterSizePasses();
+    else if(level == "fast"_s) {
+        /* Just a cheap cleanup, without any of the expensive inlining,
+           scalar replacement or load/store elimination passes */
+        optimizer->RegisterPass(spvtools::CreateEliminateDeadFunctionsPass())
+                  .RegisterPass(spvtools::CreateDeadBranchElimPass())
+                  .RegisterPass(spvtools::CreateAggressiveDCEPass())
+                  .RegisterPass(spvtools::CreateRemoveDuplicatesPass())
+                  .RegisterPass(spvtools::CreateCompactIdsPass());
+    } else if(level == "legalizeHlsl"_s)
+        optimizer->RegisterLegalizationPasses();
+    else if(level == "legalizeHlsl1"_s)
+        optimizer->RegisterLegalizationPasses()
+                  .RegisterPerformancePasses();
+    else if(level == "legalizeHlslS"_s)
+        optimizer->RegisterLegalizationPasses()
+                  .RegisterSizePasses();
+    else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+    optimizer->SetMessageConsumer(printOptimizerMessage);
+
+    return optimizer;
+}
+
+/* Parses the table printed by Optimizer::SetTimeReport(). Each pass is on a
+   separate line with its name followed by CPU, wall, user and system time
+   and RSS and page fault delta, the header and anything else that doesn't
+   have six numbers after the name is skipped. */
+void parseTimeReport(const Containers::StringView report, Containers::Array<SpirvToolsConverter::OptimizerPassTime>& out) {
+    for(const Containers::StringView line: report.splitWithoutEmptyParts('\n')) {
+        const Containers::Array<Containers::StringView> columns = line.splitOnWhitespaceWithoutEmptyParts();
+        if(columns.size() != 7) continue;
+
+        Double values[6];
+        bool valid = true;
+        for(std::size_t i = 0; i != 6; ++i) {
+            /* strtod() needs a null-terminated string */
+            const Containers::String column = columns[i + 1];
+            char* end;
+            values[i] = std::strtod(column.data(), &end);
+            if(end != column.end()) {
+                valid = false;
+                break;
+            }
+        }
+        if(!valid) continue;
+
+        arrayAppend(out, InPlaceInit, columns[0], values[0], values[1], values[2], values[3], Long(values[4]), Long(values[5]));
+    }
+}
+
+/* Counts instructions in a SPIR-V binary. The high 16 bits of the first word
+   of each instruction is its word count, the first five words are the
+   header. Stops at a zero word count to not loop forever on invalid input,
+   but that should be caught by the optimizer validation already. */
+UnsignedInt instructionCount(const spv_binary binary) {
+    UnsignedInt count = 0;
+    for(std::size_t i = 5; i < binary->wordCount; ++count) {
+        const UnsignedInt wordCount = binary->code[i] >> 16;
+        if(!wordCount) break;
+        i += wordCount;
+    }
+    return count;
+}
+
+/* Interface between neighboring stages when converting a pipeline in
+   convertPipelineDataToData(). Null next* pointers for the last stage, null
+   live* pointers for the first stage. */
+struct StageInterface {
+    /* Input locations and built-ins read by the next stage */
+    std::unordered_set<std::uint32_t>* nextLiveLocations;
+    std::unordered_set<std::uint32_t>* nextLiveBuiltins;
+    /* Filled with input locations and built-ins read by this stage */
+    std::unordered_set<std::uint32_t>* liveLocations;
+    std::unordered_set<std::uint32_t>* liveBuiltins;
+};
+
+/* The actual conversion of a single input, shared by doConvertDataToData(),
+   convertDataToDataBatch() and convertPipelineDataToData(). If optimizer is
+   null, no optimization is done. */
+Containers::Optional<Containers::Array<char>> convertData(const Utility::ConfigurationGroup& configuration, const Format inputFormat, const Format outputFormat, const spv_target_env env, spvtools::Optimizer* const optimizer, std::ostream* const timeReport, SpirvToolsConverter::OptimizationStatistics* const statistics, ValidationCache* const validationCache, StageInterface* const interface, const ConverterFlags flags, const Containers::StringView inputFilename, const Containers::StringView outputFilename, const Containers::ArrayView<const char> data) {
+    const spv_context context = spvContextCreate(env);
+    Containers::ScopeGuard contextDestroy{context, spvContextDestroy};
+
+    /** @todo make this work on big-endian */
+
+    spv_binary_t binaryStorage;
+    spv_binary binary{};
+    Containers::ScopeGuard binaryDestroy{NoCreate};
+    if(!readData(context, configuration, inputFormat, inputFilename, "ShaderTools::SpirvToolsConverter::convertDataToData():", binaryStorage, binary, binaryDestroy, data, 0))
+        return {};
+
+    /* Run the optimizer, if desired. What the hell, is the output a vector
+       again?! Is everyone mad or */
+    std::vector<UnsignedInt> interfaceOutputStorage;
+    std::vector<UnsignedInt> optimizerOutputStorage;
+    #if SPIRVTOOLS_VERSION >= 202204
+    const bool eliminateDeadOutputs = interface && interface->nextLiveLocations;
+    #else
+    constexpr bool eliminateDeadOutputs = false;
+    #endif
+    if(optimizer || eliminateDeadOutputs) {
+        if(statistics) {
+            statistics->inputInstructionCount = instructionCount(binary);
+            statistics->inputSize = binary->wordCount*4;
+        }
+
+        /* Validator options and limits. Same as in doValidateData(). */
+        spv_validator_options validatorOptions = spvValidatorOptionsCreate();
+        Containers::ScopeGuard validatorOptionsDestroy{validatorOptions, spvValidatorOptionsDestroy};
+        setValidationOptions(validatorOptions, configuration);
+
+        /* Optimizer options */
+        spv_optimizer_options optimizerOptions = spvOptimizerOptionsCreate();
+        Containers::ScopeGuard optimizerOptionsDestroy{optimizerOptions, spvOptimizerOptionsDestroy};
+        /* Skip the validation if this exact module was already validated
+           with the same options */
+        bool validate = configuration.value<bool>("validateBeforeOptimization");
+        std::string validationKey;
+        if(validate && validationCache) {
+            validationKey = validationCacheKey(env, configuration, binary);
+            if(isValidated(validationCache, validationKey)) {
+                if(flags & ConverterFlag::Verbose)
+                    Debug{} << "ShaderTools::SpirvToolsConverter::convertDataToData(): module already validated, skipping validation before optimization";
+                validate = false;
+                validationKey = {};
+            }
+        }
+        spvOptimizerOptionsSetRunValidator(optimizerOptions, validate);
+        spvOptimizerOptionsSetValidatorOptions(optimizerOptions,
+            validatorOptions);
+        spvOptimizerOptionsSetMaxIdBound(optimizerOptions,
+            configuration.value<UnsignedInt>("maxIdBound"));
+        #if SPIRVTOOLS_VERSION >= 201904
+        spvOptimizerOptionsSetPreserveBindings(optimizerOptions,
+            configuration.value<UnsignedInt>("preserveBindings"));
+        spvOptimizerOptionsSetPreserveSpecConstants(optimizerOptions,
+            configuration.value<UnsignedInt>("preserveSpecializationConstants"));
+        #endif
+
+        /* When converting a pipeline, remove stores to outputs that the next
+           stage doesn't read and all code that was only calculating them.
+           That makes descriptors used only for those calculations unused as
+           well, which then get removed by the dead code elimination unless
+           preserveBindings is enabled. The validation, if enabled, is done
+           only here in that case. */
+        #if SPIRVTOOLS_VERSION >= 202204
+        if(eliminateDeadOutputs) {
+            spvtools::Optimizer interfaceOptimizer{env};
+            interfaceOptimizer.SetMessageConsumer(printOptimizerMessage);
+            interfaceOptimizer
+                .RegisterPass(spvtools::CreateEliminateDeadOutputStoresPass(interface->nextLiveLocations, interface->nextLiveBuiltins))
+                .RegisterPass(spvtools::CreateAggressiveDCEPass());
+            if(!interfaceOptimizer.Run(binary->code, binary->wordCount, &interfaceOutputStorage, optimizerOptions))
+                return {};
+
+            /* Reference the vector guts in the binary for the rest of the
+               code, in the same way as done for the optimizer below */
+            binaryDestroy = Containers::ScopeGuard{NoCreate};
+            binary = &binaryStorage;
+            binary->code = interfaceOutputStorage.data();
+            binary->wordCount = interfaceOutputStorage.size();
+            spvOptimizerOptionsSetRunValidator(optimizerOptions, false);
+        }
+        #endif
+
+        /* If the optimizer fails, exit. The message is printed by the message
+           consumer set in createOptimizer(). */
+        if(optimizer) {
+            #if SPIRVTOOLS_VERSION >= 201903
+            optimizer->SetValidateAfterAll(configuration.value<bool>("validateAfterEachOptimization"));
+            #endif
+            optimizer->SetTimeReport(timeReport);
+
+            if(!optimizer->Run(binary->code, binary->wordCount, &optimizerOutputStorage, optimizerOptions))
+                return {};
+
+            /* Reference the vector guts in the binary again for the rest of
+               the code. Replace the old scope guard with an empty one, which
+               will also trigger the original deleter, if it was when
+               disassembing. */
+            binaryDestroy = Containers::ScopeGuard{NoCreate};
+            binary = &binaryStorage;
+            binary->code = optimizerOutputStorage.data();
+            binary->wordCount = optimizerOutputStorage.size();
+        }
+
+        /* The optimizer fails if validation fails, so if it succeeded, the
+           input was valid */
+        if(!validationKey.empty())
+            markValidated(validationCache, Utility::move(validationKey));
+
+        if(statistics) {
+            statistics->outputInstructionCount = instructionCount(binary);
+            statistics->outputSize = binary->wordCount*4;
+            Debug{} << "ShaderTools::SpirvToolsConverter::convertDataToData(): optimized from" << statistics->inputInstructionCount << "to" << statistics->outputInstructionCount << "instructions," << statistics->inputSize << "to" << statistics->outputSize << "bytes";
+        }
+    }
+
+    /* When converting a pipeline, gather inputs of this stage that are
+       actually read after all optimizations for use by the previous stage.
+       It's just an analysis, so the output is thrown away and there's no
+       need to validate again. */
+    #if SPIRVTOOLS_VERSION >= 202204
+    if(interface && interface->liveLocations) {
+        spvtools::Optimizer analyzer{env};
+        analyzer.SetMessageConsumer(printOptimizerMessage);
+        analyzer.RegisterPass(spvtools::CreateAnalyzeLiveInputPass(interface->liveLocations, interface->liveBuiltins));
+
+        spv_optimizer_options analyzerOptions = spvOptimizerOptionsCreate();
+        Containers::ScopeGuard analyzerOptionsDestroy{analyzerOptions, spvOptimizerOptionsDestroy};
+        spvOptimizerOptionsSetRunValidator(analyzerOptions, false);
+
+        std::vector<UnsignedInt> analyzerOutput;
+        if(!analyzer.Run(binary->code, binary->wordCount, &analyzerOutput, analyzerOptions))
+            return {};
+    }
+    #endif
+
+    /* Disassemble, if desired, or if the output filename ends with *.spvasm */
+    Containers::Array<char> out;
+    if(outputFormat == Format::SpirvAssembly || (outputFormat == Format::Unspecified && outputFilename.hasSuffix(".spvasm"_s))) {
+        /* There's SPV_BINARY_TO_TEXT_OPTION_NONE which has a non-zero value
+           but isn't used anywhere. Looks like another variant of the same
+           brainfart. */
+        Int options = 0;
+        /* SPV_BINARY_TO_TEXT_OPTION_PRINT not exposed, we always want data */
+        /** @todo put Color into flags? so magnum-shaderconverter can use
+            --color auto and such */
+        if(configuration.value<bool>("color"))
+            options |= SPV_BINARY_TO_TEXT_OPTION_COLOR;
+        if(configuration.value<bool>("indent"))
+            options |= SPV_BINARY_TO_TEXT_OPTION_INDENT;
+        if(configuration.value<bool>("byteOffset"))
+            options |= SPV_BINARY_TO_TEXT_OPTION_SHOW_BYTE_OFFSET;
+        /* no-headers=false would be a hard-to-parse double negative, flip
+           that (also it would mean `magnum-shaderconverter -fno-no-headers`,
+           which looks extra stupid) */
+        if(!configuration.value<bool>("header"))
+            options |= SPV_BINARY_TO_TEXT_OPTION_NO_HEADER;
+        if(configuration.value<bool>("friendlyNames"))
+            options |= SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES;
+        /** @todo SPV_BINARY_TO_TEXT_OPTION_COMMENT, since
+            https://github.com/KhronosGroup/SPIRV-Tools/pull/3847, not in the
+            2020.6 release yet -- also, expose through setDebugInfoLevel()? */
+
+        spv_text text{};
+        spv_diagnostic diagnostic;
+        const spv_result_t error = spvBinaryToText(context, binary->code, binary->wordCount, options, &text, &diagnostic);
+        Containers::ScopeGuard textDestroy{text, spvTextDestroy};
+        Containers::ScopeGuard diagnosticDestroy{diagnostic, spvDiagnosticDestroy};
+        if(error) {
+            Error e;
+            e << "ShaderTools::SpirvToolsConverter::convertDataToData(): disassembly failed:";
+            printDiagnostic(e, inputFilename, diagnostic);
+            return {};
+        }
+
+        /* Copy the text to the output. We can't take ownership of that array
+           because it *might* have a different deleter (in reality it uses a
+           plain delete[], but I don't want to depend on such an implementation
+           detail, this is not a perf-critical code path). */
+        out = Containers::Array<char>{NoInit, text->length};
+        Utility::copy(Containers::arrayView(text->str, text->length), out);
+
+    /* Otherwise simply copy the binary to the output. We can't take ownership
+       of the array here either because in addition to the case above the
+       binary could also point right at the input `data`. */
+    } else {
+        Containers::ArrayView<const char> in(reinterpret_cast<const char*>(binary->code), 4*binary->wordCount);
+        out = Containers::Array<char>{NoInit, in.size()};
+        Utility::copy(in, out);
+    }
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(out));
+}
+
 }
 
 Containers::Pair<bool, Containers::String> SpirvToolsConverter::doValidateFile(const Stage stage, const Containers::StringView filename) {
@@ -266,6 +696,18 @@ Containers::Pair<bool, Containers::String> SpirvToolsConverter::doValidateData(S
     ))
         return {};
 
+    /* If this exact module was already validated with the same options,
+       there's nothing to do */
+    std::string validationKey;
+    if(configuration().value<bool>("validationCache")) {
+        validationKey = validationCacheKey(env, configuration(), binary);
+        if(isValidated(&_state->validationCache, validationKey)) {
+            if(flags() & ConverterFlag::Verbose)
+                Debug{} << "ShaderTools::SpirvToolsConverter::validateData(): module already validated, skipping";
+            return {true, {}};
+        }
+    }
+
     /* Validator options and limits */
     spv_validator_options options = spvValidatorOptionsCreate();
     Containers::ScopeGuard optionsDestroy{options, spvValidatorOptionsDestroy};
@@ -288,6 +730,8 @@ Containers::Pair<bool, Containers::String> SpirvToolsConverter::doValidateData(S
     }
 
     CORRADE_INTERNAL_ASSERT(!diagnostic);
+    if(!validationKey.empty())
+        markValidated(&_state->validationCache, Utility::move(validationKey));
     return {true, {}};
 }
 
@@ -314,22 +758,43 @@ Containers::Optional<Containers::Array<char>> SpirvToolsConverter::doConvertData
     _state->inputFilename = {};
     _state->outputFilename = {};
 
+    Containers::Array<Containers::Optional<Containers::Array<char>>> out = convertInternal(Containers::arrayView(&data, 1), inputFilename, outputFilename, false);
+    return Utility::move(out[0]);
+}
+
+Containers::Array<Containers::Optional<Containers::Array<char>>> SpirvToolsConverter::convertDataToDataBatch(const Containers::ArrayView<const Containers::ArrayView<const char>> inputs) {
+    return convertInternal(inputs, {}, {}, false);
+}
+
+Containers::Array<Containers::Optional<Containers::Array<char>>> SpirvToolsConverter::convertPipelineDataToData(const Containers::ArrayView<const Containers::ArrayView<const char>> stages) {
+    #if SPIRVTOOLS_VERSION >= 202204
+    return convertInternal(stages, {}, {}, true);
+    #else
+    Error{} << "ShaderTools::SpirvToolsConverter::convertPipelineDataToData(): cross-stage optimization requires SPIRV-Tools 2022.4 or newer";
+    return Containers::Array<Containers::Optional<Containers::Array<char>>>{stages.size()};
+    #endif
+}
+
+Containers::Array<Containers::Optional<Containers::Array<char>>> SpirvToolsConverter::convertInternal(const Containers::ArrayView<const Containers::ArrayView<const char>> inputs, const Containers::StringView inputFilename, const Containers::StringView outputFilename, const bool pipeline) {
+    /* On failure, all outputs are left empty */
+    Containers::Array<Containers::Optional<Containers::Array<char>>> out{inputs.size()};
+
     if(_state->inputFormat != Format::Unspecified &&
        _state->inputFormat != Format::Spirv &&
        _state->inputFormat != Format::SpirvAssembly) {
         Error{} << "ShaderTools::SpirvToolsConverter::convertDataToData(): input format should be Spirv, SpirvAssembly or Unspecified but got" << _state->inputFormat;
-        return {};
+        return out;
     }
     if(!_state->inputVersion.isEmpty()) {
         Error{} << "ShaderTools::SpirvToolsConverter::convertDataToData(): input format version should be empty but got" << _state->inputVersion;
-        return {};
+        return out;
     }
 
     if(_state->outputFormat != Format::Unspecified &&
        _state->outputFormat != Format::Spirv &&
        _state->outputFormat != Format::SpirvAssembly) {
         Error{} << "ShaderTools::SpirvToolsConverter::convertDataToData(): output format should be Spirv, SpirvAssembly or Unspecified but got" << _state->outputFormat;
-        return {};
+        return out;
     }
 
     /* Target environment, default to Vulkan 1.0. */
@@ -337,174 +802,154 @@ Containers::Optional<Containers::Array<char>> SpirvToolsConverter::doConvertData
     if(!_state->outputVersion.isEmpty()) {
         if(!spvParseTargetEnv(_state->outputVersion.data(), &env)) {
             Error{} << "ShaderTools::SpirvToolsConverter::convertDataToData(): unrecognized output format version" << _state->outputVersion;
-            return {};
+            return out;
         }
     }
 
-    const spv_context context = spvContextCreate(env);
-    Containers::ScopeGuard contextDestroy{context, spvContextDestroy};
-
-    /** @todo make this work on big-endian */
-
-    spv_binary_t binaryStorage;
-    spv_binary binary{};
-    Containers::ScopeGuard binaryDestroy{NoCreate};
-    if(!readData(context, configuration(), _state->inputFormat, inputFilename, "ShaderTools::SpirvToolsConverter::convertDataToData():", binaryStorage, binary, binaryDestroy, data, 0))
-        return {};
+    /* Optimization level */
+    const bool optimize = !_state->optimizationLevel.isEmpty() && _state->optimizationLevel != "0"_s;
+    if(optimize &&
+       _state->optimizationLevel != "1"_s &&
+       _state->optimizationLevel != "s"_s &&
+       _state->optimizationLevel != "fast"_s &&
+       _state->optimizationLevel != "legalizeHlsl"_s &&
+       _state->optimizationLevel != "legalizeHlsl1"_s &&
+       _state->optimizationLevel != "legalizeHlslS"_s) {
+        Error{} << "ShaderTools::SpirvToolsConverter::convertDataToData(): optimization level should be 0, 1, s, fast, legalizeHlsl, legalizeHlsl1, legalizeHlslS or empty but got" << _state->optimizationLevel;
+        return out;
+    }
 
-    /* Run the optimizer, if desired. What the hell, is the output a vector
-       again?! Is everyone mad or */
-    std::vector<UnsignedInt> optimizerOutputStorage;
-    if(!_state->optimizationLevel.isEmpty() && _state->optimizationLevel != "0"_s) {
-        spvtools::Optimizer optimizer{env};
-        if(_state->optimizationLevel == "1"_s)
-            optimizer.RegisterPerformancePasses();
-        else if(_state->optimizationLevel == "s"_s)
-            optimizer.RegisterSizePasses();
-        else if(_state->optimizationLevel == "legalizeHlsl"_s)
-            optimizer.RegisterLegalizationPasses();
-        else {
-            Error{} << "ShaderTools::SpirvToolsConverter::convertDataToData(): optimization level should be 0, 1, s, legalizeHlsl or empty but got" << _state->optimizationLevel;
-            return {};
+    /* Debug output redirection is thread-local only if Corrade is built with
+       CORRADE_BUILD_MULTITHREADED, and without threads available there's
+       nothing to parallelize on anyway */
+    std::size_t threadCount = 1;
+    #if defined(CORRADE_BUILD_MULTITHREADED) && (!defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__))
+    threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = Math::max(Math::min(threadCount, inputs.size()), std::size_t{1});
+    #endif
+    /* Pipeline stages depend on each other, so they're converted serially */
+    if(pipeline) threadCount = 1;
+
+    /* Reuse the optimizers from previous conversions if they were set up for
+       the same level and environment, create new ones otherwise. Creating
+       them upfront and not lazily in the workers, as the pass registration
+       isn't free either. */
+    if(optimize) {
+        if(_state->optimizerEnv != env || _state->optimizerLevel != _state->optimizationLevel) {
+            _state->optimizers = {};
+            _state->optimizerEnv = env;
+            _state->optimizerLevel = _state->optimizationLevel;
         }
+        if(_state->optimizers.size() < threadCount)
+            arrayResize(_state->optimizers, threadCount);
+        for(std::size_t i = 0; i != threadCount; ++i)
+            if(!_state->optimizers[i])
+                _state->optimizers[i] = createOptimizer(env, _state->optimizationLevel);
+    }
 
-        /* Print using our own APIs */
-        optimizer.SetMessageConsumer([](spv_message_level_t level, const char* file, const spv_position_t& position, const char* message) {
-            std::ostream* output{};
-            const char* prefix{};
-            switch(level) {
-                /* LCOV_EXCL_START */
-                case SPV_MSG_FATAL:
-                    output = Error::output();
-                    prefix = "fatal optimization error:";
-                    break;
-                case SPV_MSG_INTERNAL_ERROR:
-                    output = Error::output();
-                    prefix = "internal optimization error:";
-                    break;
-                case SPV_MSG_ERROR:
-                    output = Error::output();
-                    prefix = "optimization error:";
-                    break;
-                case SPV_MSG_WARNING:
-                    output = Warning::output();
-                    prefix = "optimization warning:";
-                    break;
-                case SPV_MSG_INFO:
-                    output = Debug::output();
-                    prefix = "optimization info";
-                    break;
-                case SPV_MSG_DEBUG:
-                    output = Debug::output();
-                    prefix = "optimization debug info";
-                    break;
-                /* LCOV_EXCL_STOP */
+    ValidationCache* const validationCache = configuration().value<bool>("validationCache") ? &_state->validationCache : nullptr;
+
+    /* The time report is printed to the output and additionally saved for
+       optimizerTimeReport() */
+    const bool timeReport = optimize && configuration().value<bool>("optimizerTimeReport");
+    _state->optimizerTimeReport = {};
+
+    /* Instruction counts and sizes before and after, if desired. Each worker
+       writes only to the item corresponding to the input it converts. */
+    if(optimize && configuration().value<bool>("optimizationStatistics"))
+        _state->optimizationStatistics = Containers::Array<OptimizationStatistics>{ValueInit, inputs.size()};
+    else
+        _state->optimizationStatistics = {};
+
+    /* Each input is independent, so they can be converted on multiple
+       threads, each with its own optimizer instance and picking the next
+       unprocessed input. With more than one thread, messages are captured and
+       printed afterwards, in order, to not have the output from multiple
+       threads interleaved and so it goes to wherever the output is redirected
+       on the calling thread. */
+    /* Stages of a pipeline are converted from the last to the first, each
+       eliminating outputs not read by the stage after it */
+    Containers::Array<std::unordered_set<std::uint32_t>> liveLocations;
+    Containers::Array<std::unordered_set<std::uint32_t>> liveBuiltins;
+    Containers::Array<StageInterface> interfaces;
+    if(pipeline) {
+        liveLocations = Containers::Array<std::unordered_set<std::uint32_t>>{inputs.size()};
+        liveBuiltins = Containers::Array<std::unordered_set<std::uint32_t>>{inputs.size()};
+        interfaces = Containers::Array<StageInterface>{ValueInit, inputs.size()};
+        for(std::size_t i = 0; i != inputs.size(); ++i) {
+            if(i + 1 != inputs.size()) {
+                interfaces[i].nextLiveLocations = &liveLocations[i + 1];
+                interfaces[i].nextLiveBuiltins = &liveBuiltins[i + 1];
             }
-            /* output can be nullptr in case Debug/Warning/Error is silenced */
-            CORRADE_INTERNAL_ASSERT(prefix);
-
-            Debug out{output};
-            out << "ShaderTools::SpirvToolsConverter::convertDataToData():" << prefix << Debug::newline;
-            spv_diagnostic_t diag{position, const_cast<char*>(message), false};
-            printDiagnostic(out, file, &diag);
-        });
-
-        /* Validator options and limits. Same as in doValidateData(). */
-        spv_validator_options validatorOptions = spvValidatorOptionsCreate();
-        Containers::ScopeGuard validatorOptionsDestroy{validatorOptions, spvValidatorOptionsDestroy};
-        setValidationOptions(validatorOptions, configuration());
-
-        /* Optimizer options */
-        spv_optimizer_options optimizerOptions = spvOptimizerOptionsCreate();
-        Containers::ScopeGuard optimizerOptionsDestroy{optimizerOptions, spvOptimizerOptionsDestroy};
-        spvOptimizerOptionsSetRunValidator(optimizerOptions,
-            configuration().value<bool>("validateBeforeOptimization"));
-        spvOptimizerOptionsSetValidatorOptions(optimizerOptions,
-            validatorOptions);
-        spvOptimizerOptionsSetMaxIdBound(optimizerOptions,
-            configuration().value<UnsignedInt>("maxIdBound"));
-        #if SPIRVTOOLS_VERSION >= 201904
-        spvOptimizerOptionsSetPreserveBindings(optimizerOptions,
-            configuration().value<UnsignedInt>("preserveBindings"));
-        spvOptimizerOptionsSetPreserveSpecConstants(optimizerOptions,
-            configuration().value<UnsignedInt>("preserveSpecializationConstants"));
-        #endif
-        #if SPIRVTOOLS_VERSION >= 201903
-        optimizer.SetValidateAfterAll(configuration().value<bool>("validateAfterEachOptimization"));
-        #endif
-        optimizer.SetTimeReport(configuration().value<bool>("optimizerTimeReport") ? Debug::output() : nullptr);
-
-        /* If the optimizer fails, exit. The message is printed by the message
-           consumer we set above. */
-        if(!optimizer.Run(binary->code, binary->wordCount, &optimizerOutputStorage, optimizerOptions))
-            return {};
-
-        /* Reference the vector guts in the binary again for the rest of the
-           code. Replace the old scope guard with an empty one, which will
-           also trigger the original deleter, if it was when disassembing. */
-        binaryDestroy = Containers::ScopeGuard{NoCreate};
-        binary = &binaryStorage;
-        binary->code = optimizerOutputStorage.data();
-        binary->wordCount = optimizerOutputStorage.size();
+            if(i) {
+                interfaces[i].liveLocations = &liveLocations[i];
+                interfaces[i].liveBuiltins = &liveBuiltins[i];
+            }
+        }
     }
 
-    /* Disassemble, if desired, or if the output filename ends with *.spvasm */
-    Containers::Array<char> out;
-    if(_state->outputFormat == Format::SpirvAssembly || (_state->outputFormat == Format::Unspecified && outputFilename.hasSuffix(".spvasm"_s))) {
-        /* There's SPV_BINARY_TO_TEXT_OPTION_NONE which has a non-zero value
-           but isn't used anywhere. Looks like another variant of the same
-           brainfart. */
-        Int options = 0;
-        /* SPV_BINARY_TO_TEXT_OPTION_PRINT not exposed, we always want data */
-        /** @todo put Color into flags? so magnum-shaderconverter can use
-            --color auto and such */
-        if(configuration().value<bool>("color"))
-            options |= SPV_BINARY_TO_TEXT_OPTION_COLOR;
-        if(configuration().value<bool>("indent"))
-            options |= SPV_BINARY_TO_TEXT_OPTION_INDENT;
-        if(configuration().value<bool>("byteOffset"))
-            options |= SPV_BINARY_TO_TEXT_OPTION_SHOW_BYTE_OFFSET;
-        /* no-headers=false would be a hard-to-parse double negative, flip
-           that (also it would mean `magnum-shaderconverter -fno-no-headers`,
-           which looks extra stupid) */
-        if(!configuration().value<bool>("header"))
-            options |= SPV_BINARY_TO_TEXT_OPTION_NO_HEADER;
-        if(configuration().value<bool>("friendlyNames"))
-            options |= SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES;
-        /** @todo SPV_BINARY_TO_TEXT_OPTION_COMMENT, since
-            https://github.com/KhronosGroup/SPIRV-Tools/pull/3847, not in the
-            2020.6 release yet -- also, expose through setDebugInfoLevel()? */
-
-        spv_text text{};
-        spv_diagnostic diagnostic;
-        const spv_result_t error = spvBinaryToText(context, binary->code, binary->wordCount, options, &text, &diagnostic);
-        Containers::ScopeGuard textDestroy{text, spvTextDestroy};
-        Containers::ScopeGuard diagnosticDestroy{diagnostic, spvDiagnosticDestroy};
-        if(error) {
-            Error e;
-            e << "ShaderTools::SpirvToolsConverter::convertDataToData(): disassembly failed:";
-            printDiagnostic(e, inputFilename, diagnostic);
-            return {};
+    Containers::Array<std::string> messages{inputs.size()};
+    Containers::Array<std::string> warnings{inputs.size()};
+    Containers::Array<std::string> errors{inputs.size()};
+    Containers::Array<std::string> timeReports{inputs.size()};
+    #if defined(CORRADE_BUILD_MULTITHREADED) && (!defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__))
+    std::atomic<std::size_t> next{0};
+    #else
+    std::size_t next = 0;
+    #endif
+    const auto convert = [&](const std::size_t thread) {
+        for(std::size_t j; (j = next++) < inputs.size(); ) {
+            const std::size_t i = pipeline ? inputs.size() - j - 1 : j;
+            /* If a later stage of a pipeline failed, there's nothing to
+               eliminate outputs of this stage with */
+            if(pipeline && j && !out[i + 1]) break;
+
+            std::ostringstream timeReportOut;
+            if(threadCount == 1) {
+                out[i] = convertData(configuration(), _state->inputFormat, _state->outputFormat, env, optimize ? _state->optimizers[thread].get() : nullptr, timeReport ? &timeReportOut : nullptr, _state->optimizationStatistics ? &_state->optimizationStatistics[i] : nullptr, validationCache, pipeline ? &interfaces[i] : nullptr, flags(), inputFilename, outputFilename, inputs[i]);
+            } else {
+                std::ostringstream debugOut, warningOut, errorOut;
+                {
+                    Debug redirectDebug{&debugOut};
+                    Warning redirectWarning{&warningOut};
+                    Error redirectError{&errorOut};
+                    out[i] = convertData(configuration(), _state->inputFormat, _state->outputFormat, env, optimize ? _state->optimizers[thread].get() : nullptr, timeReport ? &timeReportOut : nullptr, _state->optimizationStatistics ? &_state->optimizationStatistics[i] : nullptr, validationCache, pipeline ? &interfaces[i] : nullptr, flags(), inputFilename, outputFilename, inputs[i]);
+                }
+                messages[i] = debugOut.str();
+                warnings[i] = warningOut.str();
+                errors[i] = errorOut.str();
+            }
+            timeReports[i] = timeReportOut.str();
         }
+    };
+
+    /* The calling thread is one of the workers */
+    #if defined(CORRADE_BUILD_MULTITHREADED) && (!defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__))
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::size_t i = 0; i != threads.size(); ++i)
+        threads[i] = std::thread{convert, i + 1};
+    convert(0);
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    convert(0);
+    #endif
 
-        /* Copy the text to the output. We can't take ownership of that array
-           because it *might* have a different deleter (in reality it uses a
-           plain delete[], but I don't want to depend on such an implementation
-           detail, this is not a perf-critical code path). */
-        out = Containers::Array<char>{NoInit, text->length};
-        Utility::copy(Containers::arrayView(text->str, text->length), out);
-
-    /* Otherwise simply copy the binary to the output. We can't take ownership
-       of the array here either because in addition to the case above the
-       binary could also point right at the input `data`. */
-    } else {
-        Containers::ArrayView<const char> in(reinterpret_cast<const char*>(binary->code), 4*binary->wordCount);
-        out = Containers::Array<char>{NoInit, in.size()};
-        Utility::copy(in, out);
+    for(std::size_t i = 0; i != inputs.size(); ++i) {
+        if(!messages[i].empty())
+            Debug{Debug::Flag::NoNewlineAtTheEnd} << Containers::StringView{messages[i]};
+        if(!timeReports[i].empty()) {
+            Debug{Debug::Flag::NoNewlineAtTheEnd} << Containers::StringView{timeReports[i]};
+            parseTimeReport(timeReports[i], _state->optimizerTimeReport);
+        }
+        if(!warnings[i].empty())
+            Warning{Debug::Flag::NoNewlineAtTheEnd} << Containers::StringView{warnings[i]};
+        if(!errors[i].empty())
+            Error{Debug::Flag::NoNewlineAtTheEnd} << Containers::StringView{errors[i]};
     }
 
-    /* GCC 4.8 needs extra help here */
-    return Containers::optional(Utility::move(out));
+    return out;
 }
 
 }}
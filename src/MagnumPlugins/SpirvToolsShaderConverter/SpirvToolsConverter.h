@@ -30,6 +30,7 @@
  * @m_since_latest_{plugins}
  */
 
+#include <Corrade/Containers/String.h>
 #include <Magnum/ShaderTools/AbstractConverter.h>
 
 #include "MagnumPlugins/SpirvToolsShaderConverter/configure.h"
@@ -171,6 +172,24 @@ for details. Additional validation options can be set through the
 If the returned validation string contains a numeric identifier, it's always an
 instruction index, even in case of a SPIR-V assembly on the input.
 
+@subsection ShaderTools-SpirvToolsConverter-validation-cache Skipping repeated validation
+
+In pipelines where a SPIR-V module is first validated with @ref validateData()
+and then passed to @ref convertDataToData() with an optimization level set, or
+where the same module is processed several times, the module would be
+validated again each time. Enable the @cb{.ini} validationCache @ce
+@ref ShaderTools-SpirvToolsConverter-configuration "configuration option" to
+remember hashes of modules that passed validation --- either in
+@ref validateData() or in the validation done before optimization --- and skip
+validating them again. The key includes the module binary, the target
+environment and all validation options, so changing any of them results in the
+module being validated again. Modules that failed validation are never
+remembered. Use @ref clearValidationCache() to forget all entries.
+
+Note that the cache doesn't affect the @cb{.ini} validateAfterEachOptimization @ce
+option, and modules coming from a compiler such as @ref GlslangConverter "GlslangShaderConverter"
+aren't assumed to be valid unless they were validated by this plugin.
+
 @section ShaderTools-SpirvToolsConverter-optimization SPIR-V optimization
 
 Use @ref setOptimizationLevel() to set a level of optimizations performed
@@ -182,14 +201,69 @@ between SPIR-V binary and assembly @ref ShaderTools-SpirvToolsConverter-conversi
 -   `0` or the empty default performs no optimization
 -   `1` optimizes for performance
 -   `s` optimizes for size
+-   `fast` performs just a cheap cleanup --- elimination of dead functions,
+    branches and code, removal of duplicate declarations and ID compaction.
+    Useful for quick iteration where the full optimization takes too long.
 -   `legalizeHlsl` turns SPIR-V originating from a HLSL source to one that can
     be accepted by Vulkan
+-   `legalizeHlsl1` does the same as `legalizeHlsl` followed by optimizing
+    for performance
+-   `legalizeHlslS` does the same as `legalizeHlsl` followed by optimizing
+    for size
 
 Compared to [spirv-opt](https://github.com/KhronosGroup/SPIRV-Tools#optimizer-tool)
 it can work with assembly on both input and output as well, but there's
 currently no way to directly control particular optimizer stages, only general
 validation options specified through the @ref ShaderTools-SpirvToolsConverter-configuration "plugin-specific config".
 
+The optimizer instance with passes registered for given level is created on
+first use and then reused for subsequent conversions as long as the
+optimization level and the output format version stay the same. If the
+@cb{.ini} optimizerTimeReport @ce configuration option is enabled, time spent
+in each optimization pass is printed to the output and is also available
+through @ref optimizerTimeReport().
+
+To measure effects of particular optimization levels, enable the
+@cb{.ini} optimizationStatistics @ce configuration option. The plugin then
+prints instruction count and SPIR-V binary size before and after optimization
+of each input and makes them available through
+@ref optimizationStatistics() as well.
+
+@section ShaderTools-SpirvToolsConverter-batch Batch conversion
+
+The plugin-specific @ref convertDataToDataBatch() API takes a list of SPIR-V
+binaries or assemblies and converts them on the number of threads specified by
+the @cb{.ini} threads @ce @ref ShaderTools-SpirvToolsConverter-configuration "configuration option",
+defaulting to @ref std::thread::hardware_concurrency(). Each thread uses its
+own optimizer instance, which are reused across batches as well. All inputs
+share the same input and output format, optimization level and configuration
+options. Results are returned in the same order as the inputs. Parallel
+conversion is done only if Corrade is built with
+@ref CORRADE_BUILD_MULTITHREADED and on Emscripten only if compiled with
+`-pthread`, otherwise the inputs are converted serially.
+
+@section ShaderTools-SpirvToolsConverter-pipeline Cross-stage optimization
+
+Each stage converted with @ref convertDataToData() is optimized in isolation,
+so a vertex shader output that the fragment shader never reads is still
+calculated and written. The plugin-specific @ref convertPipelineDataToData()
+API takes all stages of a pipeline in order and converts them from the last to
+the first. After each stage is converted, the input locations and built-ins it
+actually reads are gathered, and stores to all other outputs are removed from
+the stage before it, together with the code that was only calculating them.
+That reduces the interpolator count between stages, and uniform buffers,
+textures and other descriptors used only for the removed calculations become
+unused and get stripped from the module as well, unless the
+@cb{.ini} preserveBindings @ce
+@ref ShaderTools-SpirvToolsConverter-configuration "configuration option" is
+enabled.
+
+The output elimination is done regardless of the optimization level, but a
+level set with @ref setOptimizationLevel() is then applied on top. All other
+options apply the same way as with @ref convertDataToData(). The stages are
+converted serially, as each depends on the result of the one after it. This
+functionality requires SPIRV-Tools 2022.4 or newer.
+
 @section ShaderTools-SpirvToolsConverter-format Input and output format and version
 
 By default, the converter attempts to detect a SPIR-V binary and if that fails,
@@ -271,9 +345,145 @@ to edit the configuration values.
 */
 class MAGNUM_SPIRVTOOLSSHADERCONVERTER_EXPORT SpirvToolsConverter: public AbstractConverter {
     public:
+        /**
+         * @brief Optimizer pass timing
+         *
+         * @see @ref optimizerTimeReport()
+         */
+        struct OptimizerPassTime {
+            /** @brief Pass name */
+            Containers::String name;
+
+            /** @brief CPU time in seconds */
+            Double cpuTime;
+
+            /** @brief Wall clock time in seconds */
+            Double wallTime;
+
+            /** @brief User time in seconds */
+            Double userTime;
+
+            /** @brief System time in seconds */
+            Double systemTime;
+
+            /** @brief Resident set size delta in kilobytes */
+            Long rssDelta;
+
+            /** @brief Page fault count delta */
+            Long pageFaultDelta;
+        };
+
+        /**
+         * @brief Optimization statistics
+         *
+         * @see @ref optimizationStatistics()
+         */
+        struct OptimizationStatistics {
+            /** @brief Instruction count before optimization */
+            UnsignedInt inputInstructionCount;
+
+            /** @brief Instruction count after optimization */
+            UnsignedInt outputInstructionCount;
+
+            /** @brief SPIR-V binary size in bytes before optimization */
+            std::size_t inputSize;
+
+            /** @brief SPIR-V binary size in bytes after optimization */
+            std::size_t outputSize;
+        };
+
         /** @brief Plugin manager constructor */
         explicit SpirvToolsConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
+        /**
+         * @brief Convert multiple SPIR-V modules in parallel
+         *
+         * Equivalent to calling @ref convertDataToData() for each item in
+         * @p inputs, but distributing the work across threads as described
+         * in @ref ShaderTools-SpirvToolsConverter-batch. Returns an array of
+         * the same size as @p inputs, with an empty
+         * @relativeref{Corrade,Containers::Optional} for inputs that failed
+         * to convert. Messages are printed in order of @p inputs once all of
+         * them are processed.
+         *
+         * The function is virtual in order to be callable without linking to
+         * the plugin.
+         */
+        virtual Containers::Array<Containers::Optional<Containers::Array<char>>> convertDataToDataBatch(Containers::ArrayView<const Containers::ArrayView<const char>> inputs);
+
+        /**
+         * @brief Optimizer time report from the last conversion
+         *
+         * If the @cb{.ini} optimizerTimeReport @ce
+         * @ref ShaderTools-SpirvToolsConverter-configuration "configuration option"
+         * is enabled, contains timing of each optimization pass run by the
+         * last @ref convertDataToData() or @ref convertDataToDataBatch()
+         * call, in the order the passes were executed and in order of the
+         * inputs for a batch conversion. Empty if the option isn't enabled,
+         * if no optimization was done or if SPIRV-Tools was built without
+         * timer support, which is the case on platforms other than Linux.
+         *
+         * The function is virtual in order to be callable without linking to
+         * the plugin.
+         */
+        virtual Containers::ArrayView<const OptimizerPassTime> optimizerTimeReport() const;
+
+        /**
+         * @brief Optimization statistics from the last conversion
+         *
+         * If the @cb{.ini} optimizationStatistics @ce
+         * @ref ShaderTools-SpirvToolsConverter-configuration "configuration option"
+         * is enabled, contains instruction counts and binary sizes before and
+         * after optimization for each input of the last
+         * @ref convertDataToData() or @ref convertDataToDataBatch() call. The
+         * sizes are of the SPIR-V binary even if the input or output is an
+         * assembly. Items for inputs that failed to convert before or
+         * during optimization have the output values or all values zero.
+         * Empty if the option isn't enabled or if no
+         * optimization was done.
+         *
+         * The function is virtual in order to be callable without linking to
+         * the plugin.
+         */
+        virtual Containers::ArrayView<const OptimizationStatistics> optimizationStatistics() const;
+
+        /**
+         * @brief Convert stages of a linked pipeline
+         *
+         * Equivalent to calling @ref convertDataToData() for each item in
+         * @p stages, but additionally removing outputs that aren't read by
+         * the next stage as described in
+         * @ref ShaderTools-SpirvToolsConverter-pipeline. The @p stages are
+         * expected to be in pipeline order, for example a vertex shader
+         * followed by a fragment shader, each being a separate module with a
+         * single entry point. Results are returned in the same order.
+         *
+         * If conversion of a stage fails, the stages before it aren't
+         * converted and their corresponding items are
+         * @relativeref{Corrade,Containers::NullOpt} as well. Requires
+         * SPIRV-Tools 2022.4 or newer, on older versions prints a message to
+         * @relativeref{Magnum,Error} and returns
+         * @relativeref{Corrade,Containers::NullOpt} for all stages.
+         *
+         * The function is virtual in order to be callable without linking to
+         * the plugin.
+         */
+        virtual Containers::Array<Containers::Optional<Containers::Array<char>>> convertPipelineDataToData(Containers::ArrayView<const Containers::ArrayView<const char>> stages);
+
+        /**
+         * @brief Clear the validation cache
+         *
+         * Forgets all modules remembered as valid if the
+         * @cb{.ini} validationCache @ce
+         * @ref ShaderTools-SpirvToolsConverter-configuration "configuration option"
+         * is enabled. See @ref ShaderTools-SpirvToolsConverter-validation-cache
+         * for more information.
+         *
+         * The function is virtual in order to be callable without linking to
+         * the plugin.
+         */
+        virtual void clearValidationCache();
+
     private:
         MAGNUM_SPIRVTOOLSSHADERCONVERTER_LOCAL ConverterFeatures doFeatures() const override;
         MAGNUM_SPIRVTOOLSSHADERCONVERTER_LOCAL void doSetInputFormat(Format format, Containers::StringView version) override;
@@ -286,6 +496,8 @@ class MAGNUM_SPIRVTOOLSSHADERCONVERTER_EXPORT SpirvToolsConverter: public Abstra
         MAGNUM_SPIRVTOOLSSHADERCONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertFileToData(Stage stage, Containers::StringView filename) override;
         MAGNUM_SPIRVTOOLSSHADERCONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertDataToData(Magnum::ShaderTools::Stage stage, Containers::ArrayView<const char> data) override;
 
+        MAGNUM_SPIRVTOOLSSHADERCONVERTER_LOCAL Containers::Array<Containers::Optional<Containers::Array<char>>> convertInternal(Containers::ArrayView<const Containers::ArrayView<const char>> inputs, Containers::StringView inputFilename, Containers::StringView outputFilename, bool pipeline);
+
         struct State;
         Containers::Pointer<State> _state;
 };
@@ -39,6 +39,8 @@
 #include <Corrade/Utility/Path.h>
 #include <Magnum/ShaderTools/AbstractConverter.h>
 
+#include "MagnumPlugins/SpirvToolsShaderConverter/SpirvToolsConverter.h"
+
 #include "configure.h"
 #include "MagnumPlugins/SpirvToolsShaderConverter/configureInternal.h"
 
@@ -60,6 +62,7 @@ struct SpirvToolsConverterTest: TestSuite::Tester {
     void validateFailAssemble();
     void validateFailAssembleFile();
     void validateBinarySizeNotDivisbleByFour();
+    void validateCache();
 
     void convertNoOp();
     void convertDisassemble();
@@ -81,6 +84,15 @@ struct SpirvToolsConverterTest: TestSuite::Tester {
 
     void convertOptimize();
     void convertOptimizeFail();
+    void convertOptimizeReuse();
+    void convertOptimizeTimeReport();
+    void convertOptimizeStatistics();
+
+    void convertBatch();
+    void convertBatchFail();
+
+    void convertPipeline();
+    void convertPipelineFail();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractConverter> _converterManager{"nonexistent"};
@@ -169,6 +181,27 @@ const struct {
         "triangle-shaders.spv", Format::Spirv}
 };
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+} ConvertBatchData[]{
+    {"single thread", 1},
+    {"four threads", 4},
+    {"default thread count", 0},
+};
+
+const struct {
+    const char* name;
+    const char* level;
+} OptimizeStatisticsData[]{
+    {"performance", "1"},
+    {"size", "s"},
+    {"fast", "fast"},
+    {"legalize HLSL", "legalizeHlsl"},
+    {"legalize HLSL + performance", "legalizeHlsl1"},
+    {"legalize HLSL + size", "legalizeHlslS"},
+};
+
 SpirvToolsConverterTest::SpirvToolsConverterTest() {
     addInstancedTests({&SpirvToolsConverterTest::validate,
                        &SpirvToolsConverterTest::validateFile},
@@ -187,7 +220,8 @@ SpirvToolsConverterTest::SpirvToolsConverterTest() {
 
     addTests({&SpirvToolsConverterTest::validateFailAssemble,
               &SpirvToolsConverterTest::validateFailAssembleFile,
-              &SpirvToolsConverterTest::validateBinarySizeNotDivisbleByFour});
+              &SpirvToolsConverterTest::validateBinarySizeNotDivisbleByFour,
+              &SpirvToolsConverterTest::validateCache});
 
     addTests({&SpirvToolsConverterTest::convertNoOp});
 
@@ -215,7 +249,19 @@ SpirvToolsConverterTest::SpirvToolsConverterTest() {
     addInstancedTests({&SpirvToolsConverterTest::convertOptimize},
         Containers::arraySize(OptimizeData));
 
-    addTests({&SpirvToolsConverterTest::convertOptimizeFail});
+    addTests({&SpirvToolsConverterTest::convertOptimizeFail,
+              &SpirvToolsConverterTest::convertOptimizeReuse,
+              &SpirvToolsConverterTest::convertOptimizeTimeReport});
+
+    addInstancedTests({&SpirvToolsConverterTest::convertOptimizeStatistics},
+        Containers::arraySize(OptimizeStatisticsData));
+
+    addInstancedTests({&SpirvToolsConverterTest::convertBatch,
+                       &SpirvToolsConverterTest::convertBatchFail},
+        Containers::arraySize(ConvertBatchData));
+
+    addTests({&SpirvToolsConverterTest::convertPipeline,
+              &SpirvToolsConverterTest::convertPipelineFail});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -471,6 +517,75 @@ void SpirvToolsConverterTest::validateBinarySizeNotDivisbleByFour() {
         "ShaderTools::SpirvToolsConverter::convertDataToData(): SPIR-V binary size not divisible by four: 37 bytes\n");
 }
 
+void SpirvToolsConverterTest::validateCache() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+    converter->setFlags(ConverterFlag::Verbose);
+    converter->configuration().setValue("validationCache", true);
+    converter->setOutputFormat({}, "spv1.2");
+
+    Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spv"));
+    CORRADE_VERIFY(file);
+
+    /* First validation goes through the validator */
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_COMPARE(converter->validateData({}, *file),
+            Containers::pair(true, Containers::String{}));
+        CORRADE_COMPARE(out.str(), "");
+    }
+
+    /* Second is skipped */
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_COMPARE(converter->validateData({}, *file),
+            Containers::pair(true, Containers::String{}));
+        CORRADE_COMPARE(out.str(), "ShaderTools::SpirvToolsConverter::validateData(): module already validated, skipping\n");
+    }
+
+    /* Optimizing the same module with the same target skips the validation
+       before optimization as well */
+    converter->setOutputFormat(Format::Spirv, "spv1.2");
+    converter->setOptimizationLevel("1");
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(converter->convertDataToData({}, *file));
+        CORRADE_COMPARE(out.str(), "ShaderTools::SpirvToolsConverter::convertDataToData(): module already validated, skipping validation before optimization\n");
+    }
+
+    /* A different validation option isn't a cache hit */
+    converter->configuration().setValue("maxIdBound", 4194302);
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(converter->convertDataToData({}, *file));
+        CORRADE_COMPARE(out.str(), "");
+    }
+
+    /* A different target isn't a cache hit either */
+    converter->setOutputFormat({}, "spv1.3");
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_COMPARE(converter->validateData({}, *file),
+            Containers::pair(true, Containers::String{}));
+        CORRADE_COMPARE(out.str(), "");
+    }
+
+    /* After clearing, the module is validated again */
+    static_cast<SpirvToolsConverter&>(*converter).clearValidationCache();
+    converter->setOutputFormat({}, "spv1.2");
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_COMPARE(converter->validateData({}, *file),
+            Containers::pair(true, Containers::String{}));
+        CORRADE_COMPARE(out.str(), "");
+    }
+}
+
 void SpirvToolsConverterTest::convertNoOp() {
     Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
 
@@ -667,7 +782,7 @@ void SpirvToolsConverterTest::convertWrongOptimizationLevel() {
     Error redirectError{&out};
     CORRADE_VERIFY(!converter->convertDataToData({}, {}));
     CORRADE_COMPARE(out.str(),
-        "ShaderTools::SpirvToolsConverter::convertDataToData(): optimization level should be 0, 1, s, legalizeHlsl or empty but got 2\n");
+        "ShaderTools::SpirvToolsConverter::convertDataToData(): optimization level should be 0, 1, s, fast, legalizeHlsl, legalizeHlsl1, legalizeHlslS or empty but got 2\n");
 }
 
 void SpirvToolsConverterTest::convertDisassembleExplicitFormatEmptyData() {
@@ -875,6 +990,296 @@ void SpirvToolsConverterTest::convertOptimizeFail() {
         "<data>:5: {}\n", expected));
 }
 
+void SpirvToolsConverterTest::convertOptimizeReuse() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+
+    /* Same setup as in convertOptimize() */
+    converter->configuration().setValue("friendlyNames", false);
+    converter->configuration().setValue("header", false);
+    converter->setOutputFormat(Format::Spirv, "spv1.2");
+
+    /* The optimizer gets reused for subsequent conversions, which should
+       produce the same output each time, and gets recreated when the level
+       changes */
+    for(const char* level: {"1", "1", "s", "s", "1"}) {
+        CORRADE_ITERATION(level);
+        converter->setOptimizationLevel(level);
+
+        Containers::Optional<Containers::Array<char>> out = converter->convertFileToData({},
+            Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spv"));
+        CORRADE_VERIFY(out);
+        CORRADE_COMPARE_AS(Containers::ArrayView<const char>{*out},
+            Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.spv"),
+            TestSuite::Compare::StringToFile);
+    }
+}
+
+void SpirvToolsConverterTest::convertOptimizeTimeReport() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+
+    converter->setOptimizationLevel("1");
+    converter->setOutputFormat(Format::Spirv, "spv1.2");
+    converter->configuration().setValue("optimizerTimeReport", true);
+
+    std::ostringstream out;
+    {
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(converter->convertFileToData({},
+            Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spv")));
+    }
+
+    Containers::ArrayView<const SpirvToolsConverter::OptimizerPassTime> report = static_cast<SpirvToolsConverter&>(*converter).optimizerTimeReport();
+    if(out.str().empty()) {
+        CORRADE_COMPARE(report.size(), 0);
+        CORRADE_SKIP("SPIRV-Tools built without timer support.");
+    }
+
+    /* The printed report contains all passes and they're parsed */
+    CORRADE_COMPARE_AS(report.size(), 0, TestSuite::Compare::Greater);
+    for(const SpirvToolsConverter::OptimizerPassTime& pass: report) {
+        CORRADE_ITERATION(pass.name);
+        CORRADE_VERIFY(!pass.name.isEmpty());
+        CORRADE_VERIFY(Containers::StringView{out.str()}.contains(pass.name));
+        CORRADE_COMPARE_AS(pass.cpuTime, 0.0, TestSuite::Compare::GreaterOrEqual);
+        CORRADE_COMPARE_AS(pass.wallTime, 0.0, TestSuite::Compare::GreaterOrEqual);
+    }
+
+    /* Disabling the option clears the report */
+    converter->configuration().setValue("optimizerTimeReport", false);
+    CORRADE_VERIFY(converter->convertFileToData({},
+        Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spv")));
+    CORRADE_COMPARE(static_cast<SpirvToolsConverter&>(*converter).optimizerTimeReport().size(), 0);
+}
+
+void SpirvToolsConverterTest::convertOptimizeStatistics() {
+    auto&& data = OptimizeStatisticsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+
+    converter->setOptimizationLevel(data.level);
+    converter->setOutputFormat(Format::Spirv, "spv1.2");
+    converter->configuration().setValue("optimizationStatistics", true);
+
+    Containers::Optional<Containers::Array<char>> input = Utility::Path::read(Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spv"));
+    CORRADE_VERIFY(input);
+
+    std::ostringstream out;
+    Containers::Optional<Containers::Array<char>> output;
+    {
+        Debug redirectOutput{&out};
+        output = converter->convertDataToData({}, *input);
+    }
+    CORRADE_VERIFY(output);
+
+    /* The output should be still valid */
+    CORRADE_COMPARE(converter->validateData({}, *output),
+        Containers::pair(true, Containers::String{}));
+
+    Containers::ArrayView<const SpirvToolsConverter::OptimizationStatistics> statistics = static_cast<SpirvToolsConverter&>(*converter).optimizationStatistics();
+    CORRADE_COMPARE(statistics.size(), 1);
+    CORRADE_COMPARE(statistics[0].inputSize, input->size());
+    CORRADE_COMPARE(statistics[0].outputSize, output->size());
+    CORRADE_COMPARE_AS(statistics[0].inputInstructionCount, 0, TestSuite::Compare::Greater);
+    CORRADE_COMPARE_AS(statistics[0].outputInstructionCount, 0, TestSuite::Compare::Greater);
+    /* The unoptimized input has a lot of redundant loads and stores, and
+       while legalization alone doesn't need to make the output smaller, it
+       shouldn't make it larger either */
+    CORRADE_COMPARE_AS(statistics[0].outputInstructionCount,
+        statistics[0].inputInstructionCount,
+        TestSuite::Compare::LessOrEqual);
+    CORRADE_COMPARE(out.str(), Utility::formatString(
+        "ShaderTools::SpirvToolsConverter::convertDataToData(): optimized from {} to {} instructions, {} to {} bytes\n",
+        statistics[0].inputInstructionCount,
+        statistics[0].outputInstructionCount,
+        statistics[0].inputSize,
+        statistics[0].outputSize));
+
+    /* Disabling the option clears the statistics */
+    converter->configuration().setValue("optimizationStatistics", false);
+    CORRADE_VERIFY(converter->convertDataToData({}, *input));
+    CORRADE_COMPARE(static_cast<SpirvToolsConverter&>(*converter).optimizationStatistics().size(), 0);
+}
+
+void SpirvToolsConverterTest::convertBatch() {
+    auto&& data = ConvertBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+    converter->configuration().setValue("threads", data.threads);
+
+    /* Same setup as in convertOptimize() */
+    converter->setOptimizationLevel("1");
+    converter->configuration().setValue("preserveNumericIds", true);
+    converter->configuration().setValue("friendlyNames", false);
+    converter->configuration().setValue("header", false);
+    converter->setOutputFormat(Format::Spirv, "spv1.2");
+
+    Containers::Optional<Containers::Array<char>> binary = Utility::Path::read(Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spv"));
+    Containers::Optional<Containers::Array<char>> assembly = Utility::Path::read(Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spvasm"));
+    CORRADE_VERIFY(binary);
+    CORRADE_VERIFY(assembly);
+
+    /* Alternate between a binary and an assembly input */
+    Containers::Array<Containers::ArrayView<const char>> inputs{8};
+    for(std::size_t i = 0; i != inputs.size(); ++i)
+        inputs[i] = i % 2 ? *assembly : *binary;
+
+    /* Run twice to verify the per-thread optimizers get reused correctly */
+    for(std::size_t iteration: {0, 1}) {
+        CORRADE_ITERATION(iteration);
+
+        Containers::Array<Containers::Optional<Containers::Array<char>>> out = static_cast<SpirvToolsConverter&>(*converter).convertDataToDataBatch(inputs);
+        CORRADE_COMPARE(out.size(), inputs.size());
+        for(std::size_t i = 0; i != out.size(); ++i) {
+            CORRADE_ITERATION(i);
+            CORRADE_VERIFY(out[i]);
+
+            /* Same as in convertOptimize(), patch the generator ID for
+               outputs assembled from the assembly */
+            if(Containers::arrayCast<UnsignedInt>(out[i]->prefix(5*4))[2] == 0x70000)
+                Containers::arrayCast<UnsignedInt>(out[i]->prefix(5*4))[2] = 0xdeadc0de;
+
+            CORRADE_COMPARE_AS(Containers::ArrayView<const char>{*out[i]},
+                Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.spv"),
+                TestSuite::Compare::StringToFile);
+        }
+    }
+}
+
+void SpirvToolsConverterTest::convertBatchFail() {
+    auto&& data = ConvertBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+    converter->configuration().setValue("threads", data.threads);
+    converter->setInputFormat(Format::Spirv);
+
+    Containers::Optional<Containers::Array<char>> binary = Utility::Path::read(Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spv"));
+    CORRADE_VERIFY(binary);
+
+    const Containers::ArrayView<const char> inputs[]{
+        *binary,
+        binary->prefix(3),
+        *binary,
+        binary->prefix(5)
+    };
+
+    std::ostringstream out;
+    Containers::Array<Containers::Optional<Containers::Array<char>>> outputs;
+    {
+        Error redirectError{&out};
+        outputs = static_cast<SpirvToolsConverter&>(*converter).convertDataToDataBatch(inputs);
+    }
+    CORRADE_COMPARE(outputs.size(), 4);
+    CORRADE_VERIFY(outputs[0]);
+    CORRADE_VERIFY(!outputs[1]);
+    CORRADE_VERIFY(outputs[2]);
+    CORRADE_VERIFY(!outputs[3]);
+
+    /* Errors are printed in order of the inputs, no matter which thread
+       finished first */
+    CORRADE_COMPARE(out.str(),
+        "ShaderTools::SpirvToolsConverter::convertDataToData(): SPIR-V binary size not divisible by four: 3 bytes\n"
+        "ShaderTools::SpirvToolsConverter::convertDataToData(): SPIR-V binary size not divisible by four: 5 bytes\n");
+}
+
+void SpirvToolsConverterTest::convertPipeline() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+    converter->setOutputFormat(Format::SpirvAssembly);
+
+    Containers::Optional<Containers::Array<char>> vert = Utility::Path::read(Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "pipeline.vert.spvasm"));
+    Containers::Optional<Containers::Array<char>> frag = Utility::Path::read(Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "pipeline.frag.spvasm"));
+    CORRADE_VERIFY(vert);
+    CORRADE_VERIFY(frag);
+
+    const Containers::ArrayView<const char> stages[]{*vert, *frag};
+
+    #if SPIRVTOOLS_VERSION < 202204
+    {
+        std::ostringstream out;
+        Containers::Array<Containers::Optional<Containers::Array<char>>> outputs;
+        {
+            Error redirectError{&out};
+            outputs = static_cast<SpirvToolsConverter&>(*converter).convertPipelineDataToData(stages);
+        }
+        CORRADE_COMPARE(outputs.size(), 2);
+        CORRADE_VERIFY(!outputs[0]);
+        CORRADE_VERIFY(!outputs[1]);
+        CORRADE_COMPARE(out.str(), "ShaderTools::SpirvToolsConverter::convertPipelineDataToData(): cross-stage optimization requires SPIRV-Tools 2022.4 or newer\n");
+    }
+    CORRADE_SKIP("SPIRV-Tools 2022.4+ needed for cross-stage optimization.");
+    #else
+    /* Converted separately, the vertex shader still calculates and writes
+       the normal */
+    Containers::Optional<Containers::Array<char>> vertSeparate = converter->convertDataToData({}, *vert);
+    CORRADE_VERIFY(vertSeparate);
+    CORRADE_VERIFY(Containers::StringView{*vertSeparate}.contains("OpStore %outNormal"));
+
+    Containers::Array<Containers::Optional<Containers::Array<char>>> outputs = static_cast<SpirvToolsConverter&>(*converter).convertPipelineDataToData(stages);
+    CORRADE_COMPARE(outputs.size(), 2);
+    CORRADE_VERIFY(outputs[0]);
+    CORRADE_VERIFY(outputs[1]);
+
+    /* Converted as a pipeline, the normal isn't read by the fragment shader
+       so its calculation is removed, and the uniform buffer used only for it
+       as well. The position and color stay. */
+    const Containers::StringView vertOut{*outputs[0]};
+    CORRADE_VERIFY(vertOut.contains("OpStore %gl_Position"));
+    CORRADE_VERIFY(vertOut.contains("OpStore %outColor"));
+    CORRADE_VERIFY(!vertOut.contains("OpStore %outNormal"));
+    CORRADE_VERIFY(!vertOut.contains("OpMatrixTimesVector"));
+    CORRADE_VERIFY(!vertOut.contains("%transformation"));
+
+    /* The last stage has nothing after it, so it's converted as usual */
+    Containers::Optional<Containers::Array<char>> fragSeparate = converter->convertDataToData({}, *frag);
+    CORRADE_VERIFY(fragSeparate);
+    CORRADE_COMPARE(Containers::StringView{*outputs[1]}, Containers::StringView{*fragSeparate});
+
+    /* With preserveBindings the uniform buffer is kept even though it's not
+       used anymore */
+    #if SPIRVTOOLS_VERSION >= 201904
+    converter->configuration().setValue("preserveBindings", true);
+    outputs = static_cast<SpirvToolsConverter&>(*converter).convertPipelineDataToData(stages);
+    CORRADE_COMPARE(outputs.size(), 2);
+    CORRADE_VERIFY(outputs[0]);
+    CORRADE_VERIFY(!Containers::StringView{*outputs[0]}.contains("OpStore %outNormal"));
+    CORRADE_VERIFY(Containers::StringView{*outputs[0]}.contains("%transformation"));
+    #endif
+    #endif
+}
+
+void SpirvToolsConverterTest::convertPipelineFail() {
+    #if SPIRVTOOLS_VERSION < 202204
+    CORRADE_SKIP("SPIRV-Tools 2022.4+ needed for cross-stage optimization.");
+    #else
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+    converter->setInputFormat(Format::Spirv);
+
+    Containers::Optional<Containers::Array<char>> binary = Utility::Path::read(Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spv"));
+    CORRADE_VERIFY(binary);
+
+    /* The last stage fails, so the ones before aren't converted at all */
+    const Containers::ArrayView<const char> stages[]{
+        *binary,
+        *binary,
+        binary->prefix(3)
+    };
+
+    std::ostringstream out;
+    Containers::Array<Containers::Optional<Containers::Array<char>>> outputs;
+    {
+        Error redirectError{&out};
+        outputs = static_cast<SpirvToolsConverter&>(*converter).convertPipelineDataToData(stages);
+    }
+    CORRADE_COMPARE(outputs.size(), 3);
+    CORRADE_VERIFY(!outputs[0]);
+    CORRADE_VERIFY(!outputs[1]);
+    CORRADE_VERIFY(!outputs[2]);
+    CORRADE_COMPARE(out.str(), "ShaderTools::SpirvToolsConverter::convertDataToData(): SPIR-V binary size not divisible by four: 3 bytes\n");
+    #endif
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::ShaderTools::Test::SpirvToolsConverterTest)
@@ -24,6 +24,10 @@
 */
 
 #include "spirv-tools/libspirv.h"
+#if CHECK_VERSION >= 202204
+#include <unordered_set>
+#include "spirv-tools/optimizer.hpp"
+#endif
 
 #ifndef CHECK_VERSION
 #error CHECK_VERSION not defined
@@ -36,6 +40,12 @@ int main() {
     spv_target_env env{};
     spv_operand_type_t operandType{};
 
+    #if CHECK_VERSION >= 202204
+    std::unordered_set<uint32_t> liveLocations, liveBuiltins;
+    spvtools::CreateAnalyzeLiveInputPass(&liveLocations, &liveBuiltins);
+    spvtools::CreateEliminateDeadOutputStoresPass(&liveLocations, &liveBuiltins);
+    #endif
+
     #if CHECK_VERSION >= 202007
     operandType = SPV_OPERAND_TYPE_FPDENORM_MODE;
     #endif
@@ -28,63 +28,40 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/ScopeGuard.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
+#include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+#include "MagnumPlugins/PngImporter/PngBands.h"
+
 #include "spng.h"
 
 namespace Magnum { namespace Trade {
 
-SpngImporter::SpngImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin) : AbstractImporter{manager, plugin} {}
-
-SpngImporter::~SpngImporter() = default;
-
-ImporterFeatures SpngImporter::doFeatures() const { return ImporterFeature::OpenData; }
-
-bool SpngImporter::doIsOpened() const { return !!_in; }
-
-void SpngImporter::doClose() { _in = nullptr; }
-
-void SpngImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
-    /* Because here we're copying the data and using the _in to check if file
-       is opened, having them nullptr would mean openData() would fail without
-       any error message. It's not possible to do this check on the importer
-       side, because empty file is valid in some formats (OBJ or glTF). We also
-       can't do the full import here because then doImage2D() would need to
-       copy the imported data instead anyway (and the uncompressed size is much
-       larger). This way it'll also work nicely with a future openMemory(). */
-    if(data.isEmpty()) {
-        Error{} << "Trade::SpngImporter::openData(): the file is empty";
-        return;
-    }
-
-    /* Take over the existing array or copy the data if we can't */
-    if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
-        _in = Utility::move(data);
-    } else {
-        _in = Containers::Array<char>{NoInit, data.size()};
-        Utility::copy(data, _in);
-    }
-}
-
-UnsignedInt SpngImporter::doImage2DCount() const { return 1; }
-
-Containers::Optional<ImageData2D> SpngImporter::doImage2D(UnsignedInt, UnsignedInt) {
-    /* Create a decoder context */
-    spng_ctx* const ctx = spng_ctx_new(0);
-    Containers::ScopeGuard ctxGuard{ctx, spng_ctx_free};
-    CORRADE_INTERNAL_ASSERT(ctx);
+namespace {
 
-    /* Set an input buffer. Error reporting is largely undocumented, but in the
-       source it fails only due to programmer error, not due to bad data. */
-    CORRADE_INTERNAL_ASSERT_OUTPUT(spng_set_png_buffer(ctx, _in, _in.size()) == SPNG_OK);
+struct Header {
+    spng_ihdr ihdr;
+    /* With tRNS taken into account */
+    spng_color_type colorType;
+    spng_format spngFormat;
+    PixelFormat format;
+    std::size_t pixelSize;
+    bool hasTrns;
+};
 
+/* Reads the header and decides on the output format, shared by image2D() and
+   image2DRows() */
+bool readHeader(spng_ctx* const ctx, const char* const prefix, Header& out) {
     /* Get image header */
-    spng_ihdr ihdr;
+    spng_ihdr& ihdr = out.ihdr;
     if(const int error = spng_get_ihdr(ctx, &ihdr)) {
-        Error{} << "Trade::SpngImporter::image2D(): failed to read the header:" << spng_strerror(error);
-        return {};
+        Error{} << prefix << "failed to read the header:" << spng_strerror(error);
+        return false;
     }
 
     /* If the tRNS chunk is present, patch the color type so the alpha gets
@@ -111,8 +88,8 @@ Containers::Optional<ImageData2D> SpngImporter::doImage2D(UnsignedInt, UnsignedI
                     break;
             }
         } else if(error != SPNG_ECHUNKAVAIL) {
-            Error{} << "Trade::SpngImporter::image2D(): failed to get the tRNS chunk:" << spng_strerror(error);
-            return {};
+            Error{} << prefix << "failed to get the tRNS chunk:" << spng_strerror(error);
+            return false;
         }
     }
 
@@ -199,10 +176,108 @@ Containers::Optional<ImageData2D> SpngImporter::doImage2D(UnsignedInt, UnsignedI
        enum values, nevertheless should check that they actually got written */
     CORRADE_INTERNAL_ASSERT(spngFormat && UnsignedInt(format) && pixelSize);
 
+    out.colorType = colorType;
+    out.spngFormat = spngFormat;
+    out.format = format;
+    out.pixelSize = pixelSize;
+    out.hasTrns = hasTrns;
+    return true;
+}
+
+}
+
+SpngImporter::SpngImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin) : AbstractImporter{manager, plugin} {}
+
+SpngImporter::~SpngImporter() = default;
+
+ImporterFeatures SpngImporter::doFeatures() const { return ImporterFeature::OpenData; }
+
+bool SpngImporter::doIsOpened() const { return !!_in; }
+
+void SpngImporter::doClose() { _in = nullptr; }
+
+void SpngImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
+    /* Because here we're copying the data and using the _in to check if file
+       is opened, having them nullptr would mean openData() would fail without
+       any error message. It's not possible to do this check on the importer
+       side, because empty file is valid in some formats (OBJ or glTF). We also
+       can't do the full import here because then doImage2D() would need to
+       copy the imported data instead anyway (and the uncompressed size is much
+       larger). This way it'll also work nicely with a future openMemory(). */
+    if(data.isEmpty()) {
+        Error{} << "Trade::SpngImporter::openData(): the file is empty";
+        return;
+    }
+
+    /* Take over the existing array or copy the data if we can't */
+    if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
+        _in = Utility::move(data);
+    } else {
+        _in = Containers::Array<char>{NoInit, data.size()};
+        Utility::copy(data, _in);
+    }
+}
+
+UnsignedInt SpngImporter::doImage2DCount() const { return 1; }
+
+Containers::Optional<ImageData2D> SpngImporter::doImage2D(UnsignedInt, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D"};
+    /* Create a decoder context */
+    spng_ctx* const ctx = spng_ctx_new(0);
+    Containers::ScopeGuard ctxGuard{ctx, spng_ctx_free};
+    CORRADE_INTERNAL_ASSERT(ctx);
+
+    /* Set an input buffer. Error reporting is largely undocumented, but in the
+       source it fails only due to programmer error, not due to bad data. */
+    CORRADE_INTERNAL_ASSERT_OUTPUT(spng_set_png_buffer(ctx, _in, _in.size()) == SPNG_OK);
+
+    Header header;
+    if(!readHeader(ctx, "Trade::SpngImporter::image2D():", header))
+        return {};
+    const spng_ihdr& ihdr = header.ihdr;
+    const spng_color_type colorType = header.colorType;
+    const spng_format spngFormat = header.spngFormat;
+    const PixelFormat format = header.format;
+    const std::size_t pixelSize = header.pixelSize;
+    const bool hasTrns = header.hasTrns;
+
     /* Allocate output data with rows aligned to 4 bytes */
     const std::size_t stride = 4*((pixelSize*ihdr.width + 3)/4);
     Containers::Array<char> out{NoInit, stride*ihdr.height};
 
+    /* If the file describes independently compressed row bands, attempt to
+       decode them in parallel, bottom-up. That's possible only if libspng
+       wouldn't perform any conversion, which excludes palleted images, tRNS
+       and 8-bit gray + alpha that's expanded to RGBA. The 16-bit data are
+       decoded by libspng in host endianness, so match that. */
+    const UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(threadCount != 1 && !ihdr.interlace_method && !hasTrns &&
+       (ihdr.bit_depth == 8 || ihdr.bit_depth == 16) &&
+       colorType != SPNG_COLOR_TYPE_INDEXED &&
+       !(colorType == SPNG_COLOR_TYPE_GRAYSCALE_ALPHA && ihdr.bit_depth == 8))
+    {
+        Implementation::PngBands bands;
+        if(Implementation::pngFindBands(_in, ihdr.height, bands)) {
+            const Containers::StridedArrayView2D<char> rows = Containers::StridedArrayView2D<char>{out, {ihdr.height, stride}}.flipped<0>().prefix({ihdr.height, pixelSize*ihdr.width});
+            if(Implementation::pngDecodeBands(bands, pixelSize,
+                #ifndef CORRADE_TARGET_BIG_ENDIAN
+                ihdr.bit_depth == 16,
+                #else
+                false,
+                #endif
+                rows, threadCount))
+            {
+                if(flags() & ImporterFlag::Verbose)
+                    Debug{} << "Trade::SpngImporter::image2D(): decoded" << bands.offsets.size() << "row bands in parallel";
+                return ImageData2D{format, Vector2i{Int(ihdr.width), Int(ihdr.height)}, Utility::move(out)};
+            }
+
+            if(!(flags() & ImporterFlag::Quiet))
+                Warning{} << "Trade::SpngImporter::image2D(): parallel decoding of row bands failed, falling back to serial decoding";
+        }
+    }
+
     /* Begin progressive decoding. Enable tRNS decoding always, it'll be
        ignored if no tRNS chunk was present. */
     if(const int error = spng_decode_image(ctx, nullptr, 0, spngFormat, SPNG_DECODE_TRNS|SPNG_DECODE_PROGRESSIVE)) {
@@ -242,6 +317,70 @@ Containers::Optional<ImageData2D> SpngImporter::doImage2D(UnsignedInt, UnsignedI
     return ImageData2D{format, Vector2i{Int(ihdr.width), Int(ihdr.height)}, Utility::move(out)};
 }
 
+bool SpngImporter::image2DRows(const UnsignedInt id, const UnsignedInt level, const UnsignedInt rowCount, void(*const callback)(const ImageView2D&, Int, void*), void* const userData) {
+    CORRADE_ASSERT(isOpened(),
+        "Trade::SpngImporter::image2DRows(): no file opened", {});
+    CORRADE_ASSERT(id < image2DCount(),
+        "Trade::SpngImporter::image2DRows(): index" << id << "out of range for" << image2DCount() << "entries", {});
+    CORRADE_ASSERT(level < image2DLevelCount(id),
+        "Trade::SpngImporter::image2DRows(): level" << level << "out of range for" << image2DLevelCount(id) << "entries", {});
+    CORRADE_ASSERT(rowCount,
+        "Trade::SpngImporter::image2DRows(): expected a non-zero row count", {});
+    CORRADE_ASSERT(callback,
+        "Trade::SpngImporter::image2DRows(): expected a callback", {});
+
+    /* Create a decoder context */
+    spng_ctx* const ctx = spng_ctx_new(0);
+    Containers::ScopeGuard ctxGuard{ctx, spng_ctx_free};
+    CORRADE_INTERNAL_ASSERT(ctx);
+    CORRADE_INTERNAL_ASSERT_OUTPUT(spng_set_png_buffer(ctx, _in, _in.size()) == SPNG_OK);
+
+    Header header;
+    if(!readHeader(ctx, "Trade::SpngImporter::image2DRows():", header))
+        return false;
+    const spng_ihdr& ihdr = header.ihdr;
+
+    /* Rows of interlaced images come in multiple passes, each filling just a
+       subset of pixels in a subset of rows, so they can't be streamed */
+    if(ihdr.interlace_method) {
+        Error{} << "Trade::SpngImporter::image2DRows(): interlaced images can't be decoded row by row";
+        return false;
+    }
+
+    /* Only as many rows as needed for a single callback are allocated, with
+       rows aligned to 4 bytes like in image2D() */
+    const std::size_t stride = 4*((header.pixelSize*ihdr.width + 3)/4);
+    const std::size_t height = ihdr.height;
+    const std::size_t bufferRowCount = Math::min(std::size_t(rowCount), height);
+    Containers::Array<char> out{NoInit, stride*bufferRowCount};
+
+    if(const int error = spng_decode_image(ctx, nullptr, 0, header.spngFormat, SPNG_DECODE_TRNS|SPNG_DECODE_PROGRESSIVE)) {
+        Error{} << "Trade::SpngImporter::image2DRows(): failed to start decoding:" << spng_strerror(error);
+        return false;
+    }
+
+    /* Rows come top to bottom, the rows in each batch are stored bottom-up to
+       match the Y-up convention, and the batch offset is counted from the
+       bottom of the image */
+    for(std::size_t begin = 0; begin < height; begin += bufferRowCount) {
+        const std::size_t count = Math::min(bufferRowCount, height - begin);
+        const auto rows = Containers::StridedArrayView2D<char>{out, {count, stride}}.flipped<0>();
+        for(std::size_t i = 0; i != count; ++i) {
+            const Containers::StridedArrayView1D<char> row = rows[i];
+            const int error = spng_decode_row(ctx, row.data(), row.size());
+            /* SPNG_EOI is returned for the last row, which is decoded fine */
+            if(error && !(error == SPNG_EOI && begin + i + 1 == height)) {
+                Error{} << "Trade::SpngImporter::image2DRows(): failed to decode a row:" << spng_strerror(error);
+                return false;
+            }
+        }
+
+        callback(ImageView2D{header.format, {Int(ihdr.width), Int(count)}, out.prefix(count*stride)}, height - begin - count, userData);
+    }
+
+    return true;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(SpngImporter, Magnum::Trade::SpngImporter,
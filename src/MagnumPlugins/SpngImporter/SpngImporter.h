@@ -144,6 +144,45 @@ invalid data chunks. Import of such files will succeed, but the contents will
 be incomplete. See [libpng documentation about error handling](https://libspng.org/docs/decode/#error-handling)
 for more information.
 
+@subsection Trade-SpngImporter-behavior-parallel Parallel decoding
+
+Same as @ref Trade-PngImporter-behavior-parallel "PngImporter", files
+containing a private `mgRS` chunk describing independently compressed row
+bands get decoded in parallel when the @cb{.ini} threads @ce
+@ref Trade-SpngImporter-configuration "configuration option" is set to a value
+other than @cb{.ini} 1 @ce. The application has to be linked to `pthread` on
+Linux for this to work.
+
+Parallel decoding is done only for non-interlaced 8- and 16-bit images that
+libspng wouldn't convert --- palleted images, images with a transparency mask,
+images with less than 8 bits per channel and 8-bit grayscale + alpha images are
+always decoded serially. If the chunk doesn't match the image data, a warning
+is printed and the file is decoded serially.
+
+@subsection Trade-SpngImporter-behavior-rows Decoding row by row
+
+If you instantiate this class directly, either without a plugin manager or with
+the plugin linked statically, you can use @ref image2DRows() to get the image
+delivered in batches of rows to a callback as they're decoded, without ever
+having the whole image in memory. Rows arrive from the top of the image to the
+bottom, i.e. in the order they're stored in the file, each batch being an
+@ref ImageView2D with the same format and 4-byte row alignment as
+@ref image2D() would produce, and an offset of its first row from the bottom
+of the image:
+
+@code{.cpp}
+Trade::SpngImporter importer;
+importer.openFile("huge.png");
+
+importer.image2DRows(0, 0, 64, [](const ImageView2D& rows, Int offset, void* state) {
+    static_cast<TilePyramid*>(state)->addRows(rows, offset);
+}, &pyramid);
+@endcode
+
+Interlaced images can't be decoded this way, as each pass fills only a subset
+of pixels in a subset of rows. The @ref Trade-SpngImporter-behavior-incomplete-data "caveats about incomplete data"
+apply here as well.
+
 @subsection Trade-SpngImporter-behavior-cgbi Apple CgBI PNGs
 
 CgBI is a proprietary Apple-specific extension to PNG
@@ -151,6 +190,16 @@ CgBI is a proprietary Apple-specific extension to PNG
 unfortunately libspng [doesn't plan to support it](https://github.com/randy408/libspng/issues/16).
 To import such files use either @ref StbImageImporter or
 @ref Trade-PngImporter-behavior-cgbi "PngImporter with a patched libpng".
+
+@section Trade-SpngImporter-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/SpngImporter/SpngImporter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_SPNGIMPORTER_EXPORT SpngImporter: public AbstractImporter {
     public:
@@ -159,6 +208,24 @@ class MAGNUM_SPNGIMPORTER_EXPORT SpngImporter: public AbstractImporter {
 
         ~SpngImporter();
 
+        /**
+         * @brief Decode an image row by row
+         * @m_since_latest
+         *
+         * Decodes the image in batches of @p rowCount rows, calling
+         * @p callback with each batch as soon as it's decoded, together with
+         * the Y offset of the batch from the bottom of the image and
+         * @p userData. The last batch can have less rows. The view passed to
+         * the callback is valid only during the call. Expects that a file is
+         * opened, @p id and @p level are in range, @p rowCount is non-zero
+         * and @p callback is not @cpp nullptr @ce. If the image can't be
+         * decoded, prints a message to @relativeref{Magnum,Error} and returns
+         * @cpp false @ce, possibly after the callback was already called for
+         * some batches. See @ref Trade-SpngImporter-behavior-rows for more
+         * information.
+         */
+        bool image2DRows(UnsignedInt id, UnsignedInt level, UnsignedInt rowCount, void(*callback)(const ImageView2D& rows, Int offset, void* userData), void* userData = nullptr);
+
     private:
         MAGNUM_SPNGIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_SPNGIMPORTER_LOCAL bool doIsOpened() const override;
@@ -30,16 +30,24 @@
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
+#include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/DebugTools/CompareImage.h>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
 #include "configure.h"
 
+/* The plugin-specific API can be called only if linked statically */
+#ifndef SPNGIMPORTER_PLUGIN_FILENAME
+#include "MagnumPlugins/SpngImporter/SpngImporter.h"
+#endif
+
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
 struct SpngImporterTest: TestSuite::Tester {
@@ -56,6 +64,12 @@ struct SpngImporterTest: TestSuite::Tester {
     void rgbPalette1bit();
     void rgba();
 
+    void bands();
+    void bandsCorrupted();
+
+    void rows();
+    void rowsInterlaced();
+
     void openMemory();
     void openTwice();
     void importTwice();
@@ -131,6 +145,37 @@ const struct {
     {"tRNS alpha mask", "rgba-trns.png"},
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+    UnsignedInt threads;
+    PixelFormat format;
+    const char* message;
+} BandsData[]{
+    {"RGB, 2 threads", "rgb-bands.png", 2, PixelFormat::RGB8Unorm,
+        "Trade::SpngImporter::image2D(): decoded 4 row bands in parallel\n"},
+    {"RGB, all threads", "rgb-bands.png", 0, PixelFormat::RGB8Unorm,
+        "Trade::SpngImporter::image2D(): decoded 4 row bands in parallel\n"},
+    {"RGBA16, 2 threads", "rgba16-bands.png", 2, PixelFormat::RGBA16Unorm,
+        "Trade::SpngImporter::image2D(): decoded 3 row bands in parallel\n"},
+    /* Expanded to RGBA by libspng, so it's decoded serially */
+    {"gray + alpha, 2 threads", "ga-bands.png", 2, PixelFormat::RGBA8Unorm,
+        ""},
+};
+
+const struct {
+    const char* name;
+    const char* filename;
+    UnsignedInt rowCount;
+    UnsignedInt callCount;
+} RowsData[]{
+    {"RGB, one row", "rgb-bands.png", 1, 7},
+    {"RGB, three rows", "rgb-bands.png", 3, 3},
+    {"RGB, more rows than the image has", "rgb-bands.png", 100, 1},
+    {"RGBA16, two rows", "rgba16-bands.png", 2, 3},
+    {"palette, one row", "rgb-palette.png", 1, 2},
+};
+
 /* Shared among all plugins that implement data copying optimizations */
 const struct {
     const char* name;
@@ -170,6 +215,16 @@ SpngImporterTest::SpngImporterTest() {
     addInstancedTests({&SpngImporterTest::rgba},
         Containers::arraySize(RgbaData));
 
+    addInstancedTests({&SpngImporterTest::bands},
+        Containers::arraySize(BandsData));
+
+    addTests({&SpngImporterTest::bandsCorrupted});
+
+    addInstancedTests({&SpngImporterTest::rows},
+        Containers::arraySize(RowsData));
+
+    addTests({&SpngImporterTest::rowsInterlaced});
+
     addInstancedTests({&SpngImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
@@ -396,6 +451,122 @@ void SpngImporterTest::rgba() {
     }), TestSuite::Compare::Container);
 }
 
+void SpngImporterTest::bands() {
+    auto&& data = BandsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Serial decoding of the same file is the ground truth */
+    Containers::Pointer<AbstractImporter> serialImporter = _manager.instantiate("SpngImporter");
+    CORRADE_COMPARE(serialImporter->configuration().value<UnsignedInt>("threads"), 1);
+    CORRADE_VERIFY(serialImporter->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, data.filename)));
+    Containers::Optional<Trade::ImageData2D> expected = serialImporter->image2D(0);
+    CORRADE_VERIFY(expected);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("SpngImporter");
+    importer->configuration().setValue("threads", data.threads);
+    importer->addFlags(ImporterFlag::Verbose);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, data.filename)));
+
+    std::ostringstream out;
+    Containers::Optional<Trade::ImageData2D> image;
+    {
+        Debug redirectOutput{&out};
+        Warning redirectWarning{&out};
+        image = importer->image2D(0);
+    }
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(out.str(), data.message);
+    CORRADE_COMPARE(image->format(), data.format);
+    CORRADE_COMPARE_AS(*image, *expected, DebugTools::CompareImage);
+}
+
+void SpngImporterTest::bandsCorrupted() {
+    Containers::Pointer<AbstractImporter> serialImporter = _manager.instantiate("SpngImporter");
+    CORRADE_VERIFY(serialImporter->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, "rgb-bands.png")));
+    Containers::Optional<Trade::ImageData2D> expected = serialImporter->image2D(0);
+    CORRADE_VERIFY(expected);
+
+    /* The second band offset is off by one, the zlib stream itself is
+       valid */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("SpngImporter");
+    importer->configuration().setValue("threads", 2);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, "rgb-bands-corrupted.png")));
+
+    std::ostringstream out;
+    Containers::Optional<Trade::ImageData2D> image;
+    {
+        Warning redirectWarning{&out};
+        image = importer->image2D(0);
+    }
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(out.str(), "Trade::SpngImporter::image2D(): parallel decoding of row bands failed, falling back to serial decoding\n");
+    CORRADE_COMPARE_AS(*image, *expected, DebugTools::CompareImage);
+}
+
+void SpngImporterTest::rows() {
+    auto&& data = RowsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifdef SPNGIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("SpngImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, data.filename)));
+
+    Containers::Optional<Trade::ImageData2D> expected = importer->image2D(0);
+    CORRADE_VERIFY(expected);
+
+    /* Assemble the batches back into a whole image, checking that they come
+       top to bottom */
+    struct State {
+        Trade::ImageData2D& expected;
+        Containers::Array<char> data;
+        Int nextOffset;
+        UnsignedInt callCount;
+    } state{*expected, Containers::Array<char>{ValueInit, expected->data().size()}, expected->size().y(), 0};
+    CORRADE_VERIFY(static_cast<SpngImporter&>(*importer).image2DRows(0, 0, data.rowCount, [](const ImageView2D& rows, Int offset, void* userData) {
+        State& state = *static_cast<State*>(userData);
+        CORRADE_COMPARE(rows.format(), state.expected.format());
+        CORRADE_COMPARE(rows.size().x(), state.expected.size().x());
+        CORRADE_COMPARE(offset + rows.size().y(), state.nextOffset);
+        state.nextOffset = offset;
+        ++state.callCount;
+        const Containers::StridedArrayView3D<const char> expectedPixels = state.expected.pixels();
+        const Containers::StridedArrayView3D<char> pixels{state.data, expectedPixels.size(), expectedPixels.stride()};
+        Utility::copy(rows.pixels(), pixels.sliceSize({std::size_t(offset), 0, 0}, rows.pixels().size()));
+    }, &state));
+    CORRADE_COMPARE(state.nextOffset, 0);
+    CORRADE_COMPARE(state.callCount, data.callCount);
+
+    /* The assembled data has the row padding zeroed, clear it in the
+       expected data as well */
+    const std::size_t stride = expected->pixels().stride()[0];
+    const std::size_t rowSize = expected->size().x()*expected->pixelSize();
+    for(std::size_t i = 0; i != std::size_t(expected->size().y()); ++i)
+        for(std::size_t j = rowSize; j != stride; ++j)
+            expected->mutableData()[i*stride + j] = 0;
+    CORRADE_COMPARE_AS(state.data,
+        expected->data(),
+        TestSuite::Compare::Container);
+    #endif
+}
+
+void SpngImporterTest::rowsInterlaced() {
+    #ifdef SPNGIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("SpngImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, "rgb-interlaced.png")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!static_cast<SpngImporter&>(*importer).image2DRows(0, 0, 1, [](const ImageView2D&, Int, void*) {
+        CORRADE_FAIL("This shouldn't be called.");
+    }));
+    CORRADE_COMPARE(out.str(), "Trade::SpngImporter::image2DRows(): interlaced images can't be decoded row by row\n");
+    #endif
+}
+
 void SpngImporterTest::openMemory() {
     /* Same as gray16() except that it uses openData() & openMemory() instead
        of openFile() to test data copying on import */
@@ -26,31 +26,51 @@
 
 #include "StanfordImporter.h"
 
+#include <cstdlib>
+#include <thread>
 #include <unordered_map>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once <string> is gone here */
 #include <Corrade/Utility/EndiannessBatch.h>
+#include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/String.h>
 #include <Magnum/Mesh.h>
 #include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/MeshTools/Combine.h>
-#include <Magnum/Trade/ArrayAllocator.h>
 #include <Magnum/Trade/MeshData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+#include "Magnum/Implementation/mapFile.h"
+
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <atomic>
+#endif
+
 namespace Magnum { namespace Trade {
 
 struct StanfordImporter::State {
     Containers::Array<char> data;
+
+    /* Memory-mapped input file, if the mapFile option was enabled. The `data`
+       array is a non-owning view on it in that case. */
+    #ifdef MAGNUM_IMPLEMENTATION_MAP_FILE
+    Magnum::Implementation::MappedFile mapped;
+    #endif
+
     std::size_t headerSize;
     Containers::Array<MeshAttributeData> attributeData;
     Containers::Array<MeshAttributeData> faceAttributeData;
     UnsignedInt vertexStride{}, vertexCount{}, faceIndicesOffset{}, faceSkip{}, faceCount{};
     MeshIndexType faceSizeType{}, faceIndexType{};
     bool fileFormatNeedsEndianSwapping;
+    /* Set if the file has no face element */
+    bool pointCloud;
 
     std::unordered_map<std::string, MeshAttribute> attributeNameMap;
     Containers::Array<std::string> attributeNames;
@@ -61,6 +81,10 @@ StanfordImporter::StanfordImporter() {
     configuration().setValue("perFaceToPerVertex", true);
     configuration().setValue("triangleFastPath", true);
     configuration().setValue("objectIdAttribute", "object_id");
+    configuration().setValue("zeroCopy", false);
+    configuration().setValue("mapFile", false);
+    configuration().setValue("pointCloudChunkSize", 0);
+    configuration().setValue("threads", 1);
 }
 
 StanfordImporter::StanfordImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
@@ -73,6 +97,27 @@ bool StanfordImporter::doIsOpened() const { return !!_state; }
 
 void StanfordImporter::doClose() { _state = nullptr; }
 
+void StanfordImporter::doOpenFile(const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenFile", filename};
+    /* If enabled, memory-map the file instead of reading it into memory. The
+       data are referenced for the whole time the file is opened, so with
+       zeroCopy enabled as well the vertex data are paged in from the disk
+       only once they're actually accessed. */
+    #ifdef MAGNUM_IMPLEMENTATION_MAP_FILE
+    if(configuration().value<bool>("mapFile")) {
+        Containers::Optional<Magnum::Implementation::MappedFile> mapped = Magnum::Implementation::openMappedFile("Trade::StanfordImporter::openFile():", filename, [this](Containers::Array<char>&& data, const DataFlags dataFlags) {
+            doOpenData(Utility::move(data), dataFlags);
+        });
+
+        /* Keep the mapping alive for as long as the file is opened */
+        if(mapped && _state) _state->mapped = Utility::move(*mapped);
+        return;
+    }
+    #endif
+
+    AbstractImporter::doOpenFile(filename);
+}
+
 namespace {
 
 enum class PropertyType {
@@ -151,6 +196,274 @@ std::string extractLine(Containers::ArrayView<const char>& in) {
     return {out.begin(), out.end()};
 }
 
+/* ASCII data are treated as a sequence of whitespace-separated tokens,
+   ignoring the line structure completely. That's more lenient than the spec
+   but means each element doesn't need to be matched against a line first. */
+inline bool isAsciiWhitespace(const char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline const char* skipAsciiWhitespace(const char* it, const char* const end) {
+    while(it != end && isAsciiWhitespace(*it)) ++it;
+    return it;
+}
+
+/* Returns the next token for diagnostic purposes */
+Containers::StringView asciiToken(const char* it, const char* const end) {
+    it = skipAsciiWhitespace(it, end);
+    const char* tokenEnd = it;
+    while(tokenEnd != end && !isAsciiWhitespace(*tokenEnd)) ++tokenEnd;
+    return {it, std::size_t(tokenEnd - it)};
+}
+
+/* Returns pointer after the token or nullptr if there's no token left */
+const char* skipAsciiToken(const char* it, const char* const end) {
+    it = skipAsciiWhitespace(it, end);
+    if(it == end) return nullptr;
+    while(it != end && !isAsciiWhitespace(*it)) ++it;
+    return it;
+}
+
+/* Returns pointer after the token or nullptr if the token isn't a valid
+   integer */
+const char* parseAsciiInteger(const char* it, const char* const end, Long& out) {
+    it = skipAsciiWhitespace(it, end);
+    bool negative = false;
+    if(it != end && (*it == '-' || *it == '+')) {
+        negative = *it == '-';
+        ++it;
+    }
+
+    const char* const digitsBegin = it;
+    UnsignedLong value = 0;
+    for(; it != end && *it >= '0' && *it <= '9'; ++it)
+        value = value*10 + (*it - '0');
+    if(it == digitsBegin || (it != end && !isAsciiWhitespace(*it)))
+        return nullptr;
+
+    out = negative ? -Long(value) : Long(value);
+    return it;
+}
+
+/* Exactly representable powers of ten for the fast path below */
+constexpr Double AsciiPowersOfTen[]{
+    1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9,
+    1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18,
+    1.0e19, 1.0e20, 1.0e21, 1.0e22
+};
+
+/* Returns pointer after the token or nullptr if the token isn't a valid
+   number. If the decimal mantissa fits into 53 bits and the exponent is
+   small enough, both are exactly representable as a double and a single
+   multiplication or division gives a correctly rounded result (Clinger's
+   fast path, which is also what fast_float does first). That covers
+   basically all values written by scanners and exporters, everything else
+   (long mantissas, large exponents, infinities and NaNs) goes through
+   std::strtod(). */
+const char* parseAsciiFloat(const char* it, const char* const end, Double& out) {
+    it = skipAsciiWhitespace(it, end);
+    const char* const begin = it;
+
+    bool negative = false;
+    if(it != end && (*it == '-' || *it == '+')) {
+        negative = *it == '-';
+        ++it;
+    }
+
+    UnsignedLong mantissa = 0;
+    Int exponent = 0;
+    bool anyDigits = false;
+    bool tooManyDigits = false;
+    for(; it != end && *it >= '0' && *it <= '9'; ++it) {
+        anyDigits = true;
+        if(mantissa < 100000000000000000ull)
+            mantissa = mantissa*10 + (*it - '0');
+        else tooManyDigits = true;
+    }
+    if(it != end && *it == '.') {
+        for(++it; it != end && *it >= '0' && *it <= '9'; ++it) {
+            anyDigits = true;
+            if(mantissa < 100000000000000000ull) {
+                mantissa = mantissa*10 + (*it - '0');
+                --exponent;
+            } else tooManyDigits = true;
+        }
+    }
+    if(anyDigits && it != end && (*it == 'e' || *it == 'E')) {
+        Long explicitExponent;
+        const char* const exponentEnd = parseAsciiInteger(it + 1, end, explicitExponent);
+        /* Don't let the whitespace skipping in parseAsciiInteger() accept
+           "1e 5" */
+        if(!exponentEnd || isAsciiWhitespace(it[1])) return nullptr;
+        it = exponentEnd;
+        exponent += Int(Math::clamp(explicitExponent, Long{-1000}, Long{1000}));
+    }
+
+    if(anyDigits && !tooManyDigits && (it == end || isAsciiWhitespace(*it)) &&
+       mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22) {
+        const Double value = exponent < 0 ?
+            Double(mantissa)/AsciiPowersOfTen[-exponent] :
+            Double(mantissa)*AsciiPowersOfTen[exponent];
+        out = negative ? -value : value;
+        return it;
+    }
+
+    /* Slow path. The data aren't null-terminated, so copy the token to a
+       local buffer first. Anything longer than that isn't a sane number. */
+    const Containers::StringView token = asciiToken(begin, end);
+    char buffer[64];
+    if(token.isEmpty() || token.size() >= sizeof(buffer)) return nullptr;
+    std::memcpy(buffer, token.data(), token.size());
+    buffer[token.size()] = '\0';
+    char* parsedEnd;
+    out = std::strtod(buffer, &parsedEnd);
+    if(parsedEnd != buffer + token.size()) return nullptr;
+    return token.end();
+}
+
+/* Parses a value of given type and writes its binary representation to
+   out, returning pointer after the token or nullptr on failure */
+const char* parseAsciiValue(const char* it, const char* const end, const VertexFormat format, char* const out) {
+    if(format == VertexFormat::Float || format == VertexFormat::Double) {
+        Double value;
+        if(!(it = parseAsciiFloat(it, end, value))) return nullptr;
+        if(format == VertexFormat::Float) {
+            const Float valueFloat = Float(value);
+            std::memcpy(out, &valueFloat, sizeof(Float));
+        } else std::memcpy(out, &value, sizeof(Double));
+        return it;
+    }
+
+    Long value;
+    if(!(it = parseAsciiInteger(it, end, value))) return nullptr;
+    switch(format) {
+        /* LCOV_EXCL_START */
+        #define _c(format, type) case VertexFormat::format: {           \
+                const type valueType = type(value);                     \
+                std::memcpy(out, &valueType, sizeof(type));             \
+            } break;
+        _c(UnsignedByte, UnsignedByte)
+        _c(Byte, Byte)
+        _c(UnsignedShort, UnsignedShort)
+        _c(Short, Short)
+        _c(UnsignedInt, UnsignedInt)
+        _c(Int, Int)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+
+        default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+    return it;
+}
+
+VertexFormat indexTypeFormat(const MeshIndexType type) {
+    switch(type) {
+        /* LCOV_EXCL_START */
+        case MeshIndexType::UnsignedByte: return VertexFormat::UnsignedByte;
+        case MeshIndexType::UnsignedShort: return VertexFormat::UnsignedShort;
+        case MeshIndexType::UnsignedInt: return VertexFormat::UnsignedInt;
+        /* LCOV_EXCL_STOP */
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+void endianSwapInPlace(const Containers::StridedArrayView1D<const void>& data, const VertexFormat format) {
+    const UnsignedInt formatSize =
+        vertexFormatSize(vertexFormatComponentFormat(format));
+    if(formatSize == 1) return;
+    const UnsignedInt componentCount =
+        vertexFormatComponentCount(format);
+    /** @todo some arrayConstCast? ugh */
+    const Containers::StridedArrayView1D<void> mutableData{
+        {const_cast<void*>(data.data()), ~std::size_t{}},
+        const_cast<void*>(data.data()), data.size(), data.stride()};
+    if(formatSize == 2) {
+        for(Containers::StridedArrayView1D<UnsignedShort> component: Containers::arrayCast<2, UnsignedShort>(mutableData, componentCount).transposed<0, 1>())
+            Utility::Endianness::swapInPlace(component);
+    } else if(formatSize == 4) {
+        for(Containers::StridedArrayView1D<UnsignedInt> component: Containers::arrayCast<2, UnsignedInt>(mutableData, componentCount).transposed<0, 1>())
+            Utility::Endianness::swapInPlace(component);
+    } else if(formatSize == 8) {
+        for(Containers::StridedArrayView1D<UnsignedLong> component: Containers::arrayCast<2, UnsignedLong>(mutableData, componentCount).transposed<0, 1>())
+            Utility::Endianness::swapInPlace(component);
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+/* Calls function(begin, end) for consecutive ranges of count items,
+   optionally on multiple threads, each picking the next unprocessed range.
+   The ranges are large enough for the threading overhead to not matter. */
+template<class F> void parallelForRanges(const std::size_t count, std::size_t threadCount, const F& function) {
+    constexpr std::size_t RangeSize = 65536;
+    const std::size_t rangeCount = (count + RangeSize - 1)/RangeSize;
+    threadCount = Math::max(Math::min(threadCount, rangeCount), std::size_t{1});
+
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    std::atomic<std::size_t> next{0};
+    #else
+    std::size_t next = 0;
+    #endif
+    const auto process = [&]() {
+        for(std::size_t i; (i = next++) < rangeCount; )
+            function(i*RangeSize, Math::min((i + 1)*RangeSize, count));
+    };
+
+    /* The calling thread is one of the workers */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{process};
+    process();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    static_cast<void>(threadCount);
+    process();
+    #endif
+}
+
+/* Endian-swaps all attributes in interleaved data of given count and
+   stride. The attributes are expected to be absolute, pointing into data. */
+void endianSwapInPlace(const Containers::ArrayView<const char> data, const Containers::ArrayView<const MeshAttributeData> attributes, const std::size_t count, const std::size_t stride, const std::size_t threadCount) {
+    if(attributes.isEmpty() || !count) return;
+
+    /* If all attributes have the same component size and cover the whole
+       stride, which is the case for example for all-float vertices, the data
+       can be swapped as a single contiguous array instead of going through
+       each component with a stride, which is significantly faster and
+       vectorizable */
+    const UnsignedInt componentSize = vertexFormatSize(vertexFormatComponentFormat(attributes[0].format()));
+    std::size_t attributeSizeSum = 0;
+    bool sameComponentSize = true;
+    for(const MeshAttributeData& attribute: attributes) {
+        attributeSizeSum += vertexFormatSize(attribute.format());
+        if(vertexFormatSize(vertexFormatComponentFormat(attribute.format())) != componentSize)
+            sameComponentSize = false;
+    }
+
+    /** @todo some arrayConstCast? ugh */
+    const Containers::ArrayView<char> mutableData{const_cast<char*>(data.data()), count*stride};
+    if(sameComponentSize && attributeSizeSum == stride) {
+        if(componentSize == 1) return;
+        parallelForRanges(count, threadCount, [&](const std::size_t begin, const std::size_t end) {
+            const Containers::ArrayView<char> range = mutableData.slice(begin*stride, end*stride);
+            if(componentSize == 2)
+                Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedShort>(range));
+            else if(componentSize == 4)
+                Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedInt>(range));
+            else if(componentSize == 8)
+                Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedLong>(range));
+            else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        });
+        return;
+    }
+
+    parallelForRanges(count, threadCount, [&](const std::size_t begin, const std::size_t end) {
+        for(const MeshAttributeData& attribute: attributes)
+            endianSwapInPlace(attribute.data(data).slice(begin, end), attribute.format());
+    });
+}
+
 template<std::size_t size> bool checkVectorAttributeValidity(const Math::Vector<size, VertexFormat>& formats, const Math::Vector<size, UnsignedInt>& offsets, const char* name) {
     /* Check that we have the same type for all position coordinates */
     if(formats != Math::Vector<size, VertexFormat>{formats[0]}) {
@@ -173,6 +486,7 @@ template<std::size_t size> bool checkVectorAttributeValidity(const Math::Vector<
 }
 
 void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     /* Because here we're copying the data and using the _in to check if file
        is opened, having them nullptr would mean openData() would fail without
        any error message. It's not possible to do this check on the importer
@@ -209,6 +523,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
 
     /* Parse format line */
     Containers::Optional<bool> fileFormatNeedsEndianSwapping;
+    bool ascii = false;
     {
         while(in) {
             const std::string line = extractLine(in);
@@ -235,6 +550,11 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                 } else if(tokens[1] == "binary_big_endian") {
                     fileFormatNeedsEndianSwapping = !Utility::Endianness::isBigEndian();
                     break;
+                } else if(tokens[1] == "ascii") {
+                    /* Converted to the native binary representation below */
+                    fileFormatNeedsEndianSwapping = false;
+                    ascii = true;
+                    break;
                 }
             }
 
@@ -264,6 +584,11 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
     bool perFaceNormals = false;
     bool perFaceColors = false;
     bool perFaceObjectIds = false;
+    /* Property types in order, used for parsing ASCII files */
+    Containers::Array<VertexFormat> vertexPropertyFormats;
+    Containers::Array<VertexFormat> facePropertyFormats;
+    std::size_t facePropertiesBeforeIndices = 0;
+    bool hasFaceElement = false;
     {
         std::size_t vertexComponentOffset{};
         PropertyType propertyType{};
@@ -286,6 +611,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                 } else if(tokens.size() == 3 &&tokens[1] == "face") {
                     state->faceCount = std::stoi(tokens[2]);
                     propertyType = PropertyType::Face;
+                    hasFaceElement = true;
 
                 /* Something else */
                 } else {
@@ -368,6 +694,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
 
                     /* Add size of current component to total offset */
                     vertexComponentOffset += vertexFormatSize(componentFormat);
+                    arrayAppend(vertexPropertyFormats, componentFormat);
 
                 /* Face element properties */
                 } else if(propertyType == PropertyType::Face) {
@@ -377,6 +704,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                     if(tokens.size() == 5 && tokens[1] == "list" && (tokens[4] == "vertex_indices" || tokens[4] == "vertex_index")) {
                         state->faceIndicesOffset = state->faceSkip;
                         state->faceSkip = 0;
+                        facePropertiesBeforeIndices = facePropertyFormats.size();
 
                         /* Face size type */
                         if((state->faceSizeType = parseIndexType(tokens[2])) == MeshIndexType{}) {
@@ -451,6 +779,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                         }
 
                         state->faceSkip += vertexFormatSize(componentFormat);
+                        arrayAppend(facePropertyFormats, componentFormat);
 
                     /* Fail on unknown lines */
                     } else {
@@ -478,8 +807,10 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
         state->vertexStride = vertexComponentOffset;
     }
 
-    /* Check header consistency */
-    if(state->faceSizeType == MeshIndexType{} || state->faceIndexType == MeshIndexType{}) {
+    /* Check header consistency. Files without a face element are point
+       clouds. */
+    state->pointCloud = !hasFaceElement;
+    if(!state->pointCloud && (state->faceSizeType == MeshIndexType{} || state->faceIndexType == MeshIndexType{})) {
         Error{} << "Trade::StanfordImporter::openData(): incomplete face specification";
         return;
     }
@@ -637,6 +968,116 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
             objectIdOffset, 0u, std::ptrdiff_t(state->faceIndicesOffset + state->faceSkip));
     }
 
+    /* ASCII files are converted to the native binary representation so the
+       rest of the import is shared with binary files. The size of the vertex
+       data is known from the header, for faces the list sizes are counted in
+       a first pass so the output gets allocated exactly once, and the values
+       are parsed in a second pass. */
+    if(ascii) {
+        const char* const end = in.end();
+        const std::size_t vertexDataSize = std::size_t(state->vertexStride)*state->vertexCount;
+        /* Point clouds have no faces, so these are never used for them */
+        const VertexFormat faceSizeFormat = state->pointCloud ? VertexFormat{} : indexTypeFormat(state->faceSizeType);
+        const VertexFormat faceIndexFormat = state->pointCloud ? VertexFormat{} : indexTypeFormat(state->faceIndexType);
+        const UnsignedInt faceSizeTypeSize = state->pointCloud ? 0 : meshIndexTypeSize(state->faceSizeType);
+        const UnsignedInt faceIndexTypeSize = state->pointCloud ? 0 : meshIndexTypeSize(state->faceIndexType);
+
+        /* Counting pass */
+        const char* it = in.begin();
+        for(std::size_t i = 0, max = std::size_t(state->vertexCount)*vertexPropertyFormats.size(); i != max; ++i) {
+            if(!(it = skipAsciiToken(it, end))) {
+                Error{} << "Trade::StanfordImporter::openData(): incomplete vertex data";
+                return;
+            }
+        }
+        std::size_t faceDataSize = 0;
+        for(std::size_t i = 0; i != state->faceCount; ++i) {
+            for(std::size_t j = 0; it && j != facePropertiesBeforeIndices; ++j)
+                it = skipAsciiToken(it, end);
+            if(!it || !skipAsciiToken(it, end)) {
+                Error{} << "Trade::StanfordImporter::openData(): incomplete face data";
+                return;
+            }
+
+            /* Checking the size here already, as a garbage value could make
+               the allocation size overflow */
+            Long faceSize;
+            const char* const next = parseAsciiInteger(it, end, faceSize);
+            if(!next) {
+                Error{} << "Trade::StanfordImporter::openData(): invalid ASCII face size" << asciiToken(it, end);
+                return;
+            }
+            if(faceSize < 3 || faceSize > 4) {
+                Error{} << "Trade::StanfordImporter::openData(): unsupported face size" << faceSize;
+                return;
+            }
+            it = next;
+
+            for(std::size_t j = 0, max = std::size_t(faceSize) + facePropertyFormats.size() - facePropertiesBeforeIndices; it && j != max; ++j)
+                it = skipAsciiToken(it, end);
+            if(!it) {
+                Error{} << "Trade::StanfordImporter::openData(): incomplete face data";
+                return;
+            }
+
+            faceDataSize += state->faceIndicesOffset + faceSizeTypeSize + std::size_t(faceSize)*faceIndexTypeSize + state->faceSkip;
+        }
+
+        /* Parsing pass. The counting pass verified there's enough tokens and
+           that the face sizes are valid, so only the values can fail here. */
+        Containers::Array<char> binaryData{NoInit, vertexDataSize + faceDataSize};
+        char* out = binaryData.data();
+        it = in.begin();
+        for(std::size_t i = 0; i != state->vertexCount; ++i) {
+            for(const VertexFormat format: vertexPropertyFormats) {
+                const char* const next = parseAsciiValue(it, end, format, out);
+                if(!next) {
+                    Error{} << "Trade::StanfordImporter::openData(): invalid ASCII vertex value" << asciiToken(it, end);
+                    return;
+                }
+                it = next;
+                out += vertexFormatSize(format);
+            }
+        }
+        for(std::size_t i = 0; i != state->faceCount; ++i) {
+            /* Face size and indices come after the properties before indices,
+               the face size gets read back from the converted value */
+            for(std::size_t j = 0; j != facePropertyFormats.size() + 1; ++j) {
+                if(j == facePropertiesBeforeIndices) {
+                    it = parseAsciiValue(it, end, faceSizeFormat, out);
+                    CORRADE_INTERNAL_ASSERT(it);
+                    const UnsignedInt faceSize = extractIndexValue<UnsignedInt>(out, state->faceSizeType, false);
+                    out += faceSizeTypeSize;
+                    for(std::size_t k = 0; k != faceSize; ++k) {
+                        const char* const next = parseAsciiValue(it, end, faceIndexFormat, out);
+                        if(!next) {
+                            Error{} << "Trade::StanfordImporter::openData(): invalid ASCII face index" << asciiToken(it, end);
+                            return;
+                        }
+                        it = next;
+                        out += faceIndexTypeSize;
+                    }
+                    continue;
+                }
+
+                const VertexFormat format = facePropertyFormats[j < facePropertiesBeforeIndices ? j : j - 1];
+                const char* const next = parseAsciiValue(it, end, format, out);
+                if(!next) {
+                    Error{} << "Trade::StanfordImporter::openData(): invalid ASCII face value" << asciiToken(it, end);
+                    return;
+                }
+                it = next;
+                out += vertexFormatSize(format);
+            }
+        }
+        CORRADE_INTERNAL_ASSERT(out == binaryData.end());
+
+        /* The header isn't needed anymore, replace the whole file with the
+           converted data */
+        dataCopy = Utility::move(binaryData);
+        in = dataCopy;
+    }
+
     if(in.size() < state->vertexStride*state->vertexCount) {
         Error{} << "Trade::StanfordImporter::openData(): incomplete vertex data";
         return;
@@ -649,27 +1090,100 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
     _state = Utility::move(state);
 }
 
-UnsignedInt StanfordImporter::doMeshCount() const { return 1; }
+std::size_t StanfordImporter::threadCount() {
+    std::size_t threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    return threadCount;
+}
+
+UnsignedInt StanfordImporter::doMeshCount() const {
+    /* Point clouds can be split into chunks, there's always at least one
+       mesh even if empty */
+    const UnsignedInt chunkSize = configuration().value<UnsignedInt>("pointCloudChunkSize");
+    if(_state->pointCloud && chunkSize)
+        return Math::max((_state->vertexCount + chunkSize - 1)/chunkSize, 1u);
+    return 1;
+}
 
 UnsignedInt StanfordImporter::doMeshLevelCount(UnsignedInt) {
-    return configuration().value<bool>("perFaceToPerVertex") ? 1 : 2;
+    /* Point clouds have no faces and thus no per-face attributes either */
+    return _state->pointCloud || configuration().value<bool>("perFaceToPerVertex") ? 1 : 2;
+}
+
+Containers::Optional<MeshData> StanfordImporter::pointCloudMesh(const UnsignedInt id) {
+    /* Take the whole vertex data or just given chunk */
+    const UnsignedInt chunkSize = configuration().value<UnsignedInt>("pointCloudChunkSize");
+    const UnsignedInt vertexOffset = chunkSize ? id*chunkSize : 0;
+    const UnsignedInt vertexCount = chunkSize ?
+        Math::min(chunkSize, _state->vertexCount - vertexOffset) :
+        _state->vertexCount;
+    Containers::ArrayView<const char> vertexView = _state->data
+        .exceptPrefix(_state->headerSize)
+        .sliceSize(std::size_t(vertexOffset)*_state->vertexStride,
+                   std::size_t(vertexCount)*_state->vertexStride);
+
+    /* Copy the data, unless they can be referenced directly */
+    Containers::Array<char> vertexData;
+    const bool referenceVertexData = !_state->fileFormatNeedsEndianSwapping &&
+        configuration().value<bool>("zeroCopy");
+    if(!referenceVertexData) {
+        vertexData = Containers::Array<char>{NoInit, vertexView.size()};
+        Utility::copy(vertexView, vertexData);
+        vertexView = vertexData;
+    }
+
+    /* Make the attributes absolute, with the actual vertex count */
+    Containers::Array<MeshAttributeData> attributeData{_state->attributeData.size()};
+    for(std::size_t i = 0; i != attributeData.size(); ++i) {
+        const MeshAttributeData& attribute = _state->attributeData[i];
+        attributeData[i] = MeshAttributeData{
+            attribute.name(), attribute.format(),
+            Containers::StridedArrayView1D<const void>{vertexView,
+                vertexView.data() + attribute.offset({}),
+                vertexCount, attribute.stride()}};
+    }
+
+    if(_state->fileFormatNeedsEndianSwapping)
+        endianSwapInPlace(vertexData, attributeData, vertexCount, _state->vertexStride, threadCount());
+
+    if(referenceVertexData) return MeshData{MeshPrimitive::Points,
+        DataFlags{}, vertexView, Utility::move(attributeData)};
+    return MeshData{MeshPrimitive::Points,
+        Utility::move(vertexData), Utility::move(attributeData)};
 }
 
-Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const UnsignedInt level) {
+Containers::Optional<MeshData> StanfordImporter::doMesh(const UnsignedInt id, const UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMesh", {}, id};
     /* We either have per-face in the second level or we convert them to
        per-vertex, never both */
     CORRADE_INTERNAL_ASSERT(!(level == 1 && configuration().value<bool>("perFaceToPerVertex")));
+
+    /* Point clouds are handled separately, as they're non-indexed and can be
+       split into chunks */
+    if(_state->pointCloud) return pointCloudMesh(id);
     const bool parsePerFaceAttributes = level == 1 ||
         configuration().value<bool>("perFaceToPerVertex");
 
     Containers::ArrayView<const char> in = _state->data.exceptPrefix(_state->headerSize);
 
-    /* Copy all vertex data */
+    /* Copy all vertex data, unless they don't need to be endian-swapped and
+       either a zero-copy import is requested or the per-face to per-vertex
+       conversion below makes a copy anyway, in which case the file data are
+       referenced directly */
+    const bool convertPerFaceToPerVertex = level == 0 &&
+        configuration().value<bool>("perFaceToPerVertex") &&
+        !_state->faceAttributeData.isEmpty();
+    const bool referenceVertexData = !_state->fileFormatNeedsEndianSwapping &&
+        (configuration().value<bool>("zeroCopy") || convertPerFaceToPerVertex);
     Containers::Array<char> vertexData;
+    Containers::ArrayView<const char> vertexView;
     if(level == 0) {
-        vertexData = Containers::Array<char>{NoInit,
-        _state->vertexStride*_state->vertexCount};
-        Utility::copy(in.prefix(vertexData.size()), vertexData);
+        vertexView = in.prefix(std::size_t(_state->vertexStride)*_state->vertexCount);
+        if(!referenceVertexData) {
+            vertexData = Containers::Array<char>{NoInit, vertexView.size()};
+            Utility::copy(vertexView, vertexData);
+            vertexView = vertexData;
+        }
     }
     in = in.exceptPrefix(_state->vertexStride*_state->vertexCount);
 
@@ -713,51 +1227,64 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
                 dst.exceptPrefix({0, _state->faceIndicesOffset}));
         }
 
-    /* Otherwise reserve optimistically amount for all-triangle faces, and let
-       the array grow */
-    /** @todo the size could be estimated *exactly* via the above equation
-       (assuming no stray data at EOF) */
+    /* Otherwise go through the faces first to validate them and count the
+       quads, so the output can be allocated exactly once, and then copy the
+       indices and per-face data directly to the destination */
     } else {
-        if(parsePerFaceAttributes) Containers::arrayReserve<ArrayAllocator>(faceData,
-            _state->faceCount*(_state->faceIndicesOffset + _state->faceSkip));
-        Containers::arrayReserve<ArrayAllocator>(indexData,
-            _state->faceCount*3*faceIndexTypeSize);
-        for(std::size_t i = 0; i != _state->faceCount; ++i) {
-            if(in.size() < _state->faceIndicesOffset + faceSizeTypeSize) {
-                Error() << "Trade::StanfordImporter::mesh(): incomplete index data";
-                return Containers::NullOpt;
-            }
+        const UnsignedInt faceDataSize = _state->faceIndicesOffset + _state->faceSkip;
+        {
+            Containers::ArrayView<const char> faces = in;
+            for(std::size_t i = 0; i != _state->faceCount; ++i) {
+                if(faces.size() < _state->faceIndicesOffset + faceSizeTypeSize) {
+                    Error() << "Trade::StanfordImporter::mesh(): incomplete index data";
+                    return Containers::NullOpt;
+                }
 
-            /* Copy all face attributes that are before the index */
-            const Containers::ArrayView<const char> faceDataBeforeIndices = in.prefix(_state->faceIndicesOffset);
-            in = in.exceptPrefix(_state->faceIndicesOffset);
+                const UnsignedInt faceSize = extractIndexValue<UnsignedInt>(faces.data() + _state->faceIndicesOffset, _state->faceSizeType, _state->fileFormatNeedsEndianSwapping);
+                if(faceSize < 3 || faceSize > 4) {
+                    Error() << "Trade::StanfordImporter::mesh(): unsupported face size" << faceSize;
+                    return Containers::NullOpt;
+                }
 
-            /* Get face size */
-            const Containers::ArrayView<const char> faceSizeData = in.prefix(faceSizeTypeSize);
-            in = in.exceptPrefix(faceSizeTypeSize);
-            const UnsignedInt faceSize = extractIndexValue<UnsignedInt>(faceSizeData, _state->faceSizeType, _state->fileFormatNeedsEndianSwapping);
-            if(faceSize < 3 || faceSize > 4) {
-                Error() << "Trade::StanfordImporter::mesh(): unsupported face size" << faceSize;
-                return Containers::NullOpt;
-            }
+                const std::size_t size = _state->faceIndicesOffset + faceSizeTypeSize + faceIndexTypeSize*faceSize + _state->faceSkip;
+                if(faces.size() < size) {
+                    Error() << "Trade::StanfordImporter::mesh(): incomplete face data";
+                    return Containers::NullOpt;
+                }
+                faces = faces.exceptPrefix(size);
 
-            /* Parse face indices */
-            if(in.size() < faceIndexTypeSize*faceSize + _state->faceSkip) {
-                Error() << "Trade::StanfordImporter::mesh(): incomplete face data";
-                return Containers::NullOpt;
+                if(faceSize == 4) ++triangleFaceCount;
             }
+        }
 
-            const Containers::ArrayView<const char> faceIndexData = in.prefix(faceIndexTypeSize*faceSize);
-            in = in.exceptPrefix(faceIndexTypeSize*faceSize);
-            const Containers::ArrayView<const char> faceDataAfterIndices = in.prefix(_state->faceSkip);
-            in = in.exceptPrefix(_state->faceSkip);
-
-            /* Append either the triangle or the first triangle of the quad */
-            Containers::arrayAppend<ArrayAllocator>(indexData,
-                faceIndexData.prefix(3*faceIndexTypeSize));
-            if(parsePerFaceAttributes) {
-                Containers::arrayAppend<ArrayAllocator>(faceData, faceDataBeforeIndices);
-                Containers::arrayAppend<ArrayAllocator>(faceData, faceDataAfterIndices);
+        if(level == 0) indexData = Containers::Array<char>{NoInit,
+            triangleFaceCount*3*faceIndexTypeSize};
+        if(parsePerFaceAttributes) faceData = Containers::Array<char>{NoInit,
+            triangleFaceCount*faceDataSize};
+
+        /* If there are no per-face attributes, the face data array is empty
+           and there's nothing to copy */
+        const bool copyFaceData = parsePerFaceAttributes && faceDataSize;
+        char* indexOut = indexData.data();
+        char* faceOut = faceData.data();
+        const char* faceIn = in.data();
+        for(std::size_t i = 0; i != _state->faceCount; ++i) {
+            /* Size and bounds were checked above already */
+            const char* const faceDataBeforeIndices = faceIn;
+            const UnsignedInt faceSize = extractIndexValue<UnsignedInt>(faceIn + _state->faceIndicesOffset, _state->faceSizeType, _state->fileFormatNeedsEndianSwapping);
+            const char* const faceIndexData = faceIn + _state->faceIndicesOffset + faceSizeTypeSize;
+            const char* const faceDataAfterIndices = faceIndexData + faceIndexTypeSize*faceSize;
+            faceIn = faceDataAfterIndices + _state->faceSkip;
+
+            /* Copy either the triangle or the first triangle of the quad */
+            if(level == 0) {
+                std::memcpy(indexOut, faceIndexData, 3*faceIndexTypeSize);
+                indexOut += 3*faceIndexTypeSize;
+            }
+            if(copyFaceData) {
+                std::memcpy(faceOut, faceDataBeforeIndices, _state->faceIndicesOffset);
+                std::memcpy(faceOut + _state->faceIndicesOffset, faceDataAfterIndices, _state->faceSkip);
+                faceOut += faceDataSize;
             }
             /* For a quad add the 0, 2 and 3 indices forming another triangle */
             if(faceSize == 4) {
@@ -766,19 +1293,19 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
                    | \ \ |
                    |  \ \|
                    1---2 2 */
-                Containers::arrayAppend<ArrayAllocator>(indexData,
-                    faceIndexData.slice(0*faceIndexTypeSize, 1*faceIndexTypeSize));
-                Containers::arrayAppend<ArrayAllocator>(indexData,
-                    faceIndexData.slice(2*faceIndexTypeSize, 3*faceIndexTypeSize));
-                Containers::arrayAppend<ArrayAllocator>(indexData,
-                    faceIndexData.slice(3*faceIndexTypeSize, 4*faceIndexTypeSize));
-                if(parsePerFaceAttributes) {
-                    Containers::arrayAppend<ArrayAllocator>(faceData, faceDataBeforeIndices);
-                    Containers::arrayAppend<ArrayAllocator>(faceData, faceDataAfterIndices);
+                if(level == 0) {
+                    std::memcpy(indexOut, faceIndexData, faceIndexTypeSize);
+                    std::memcpy(indexOut + faceIndexTypeSize, faceIndexData + 2*faceIndexTypeSize, 2*faceIndexTypeSize);
+                    indexOut += 3*faceIndexTypeSize;
+                }
+                if(copyFaceData) {
+                    std::memcpy(faceOut, faceOut - faceDataSize, faceDataSize);
+                    faceOut += faceDataSize;
                 }
-                ++triangleFaceCount;
             }
         }
+
+        CORRADE_INTERNAL_ASSERT(indexOut == indexData.end() && faceOut == faceData.end());
     }
 
     /* We need to copy the attribute data (also because they use a forbidden
@@ -793,7 +1320,7 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
             vertexAttributeData[i] = MeshAttributeData{
                 _state->attributeData[i].name(),
                 _state->attributeData[i].format(),
-                _state->attributeData[i].data(vertexData)};
+                _state->attributeData[i].data(vertexView)};
         }
     }
 
@@ -813,46 +1340,28 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
 
     /* Endian-swap the data, if needed */
     if(_state->fileFormatNeedsEndianSwapping) {
-        for(const auto& attributeData: {
-            Containers::arrayView(vertexAttributeData),
-            Containers::arrayView(faceAttributeData)}) {
-            for(const MeshAttributeData& attribute: attributeData) {
-                const UnsignedInt formatSize =
-                    vertexFormatSize(vertexFormatComponentFormat(attribute.format()));
-                if(formatSize == 1) continue;
-                const UnsignedInt componentCount =
-                    vertexFormatComponentCount(attribute.format());
-                const Containers::StridedArrayView1D<const void> data =
-                    attribute.data(attributeData.data() == vertexAttributeData.data() ? vertexData : faceData);
-                /** @todo some arrayConstCast? ugh */
-                const Containers::StridedArrayView1D<void> mutableData{
-                    {const_cast<void*>(data.data()), ~std::size_t{}},
-                    const_cast<void*>(data.data()), data.size(), data.stride()};
-                if(formatSize == 2) {
-                    for(Containers::StridedArrayView1D<UnsignedShort> component: Containers::arrayCast<2, UnsignedShort>(mutableData, componentCount).transposed<0, 1>())
-                        Utility::Endianness::swapInPlace(component);
-                } else if(formatSize == 4) {
-                    for(Containers::StridedArrayView1D<UnsignedInt> component: Containers::arrayCast<2, UnsignedInt>(mutableData, componentCount).transposed<0, 1>())
-                        Utility::Endianness::swapInPlace(component);
-                } else if(formatSize == 8) {
-                    for(Containers::StridedArrayView1D<UnsignedLong> component: Containers::arrayCast<2, UnsignedLong>(mutableData, componentCount).transposed<0, 1>())
-                        Utility::Endianness::swapInPlace(component);
-                } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-            }
-        }
+        const std::size_t threadCount = this->threadCount();
+        endianSwapInPlace(vertexData, vertexAttributeData, level == 0 ? _state->vertexCount : 0, _state->vertexStride, threadCount);
+        endianSwapInPlace(faceData, faceAttributeData, triangleFaceCount, _state->faceIndicesOffset + _state->faceSkip, threadCount);
 
         if(level == 0) {
-            if(faceIndexTypeSize == 2)
-                Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedShort>(indexData));
-            else if(faceIndexTypeSize == 4)
-                Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedInt>(indexData));
-            else CORRADE_INTERNAL_ASSERT(faceIndexTypeSize == 1);
+            if(faceIndexTypeSize == 2) {
+                const Containers::ArrayView<UnsignedShort> indices = Containers::arrayCast<UnsignedShort>(indexData);
+                parallelForRanges(indices.size(), threadCount, [&](const std::size_t begin, const std::size_t end) {
+                    Utility::Endianness::swapInPlace(indices.slice(begin, end));
+                });
+            } else if(faceIndexTypeSize == 4) {
+                const Containers::ArrayView<UnsignedInt> indices = Containers::arrayCast<UnsignedInt>(indexData);
+                parallelForRanges(indices.size(), threadCount, [&](const std::size_t begin, const std::size_t end) {
+                    Utility::Endianness::swapInPlace(indices.slice(begin, end));
+                });
+            } else CORRADE_INTERNAL_ASSERT(faceIndexTypeSize == 1);
         }
     }
 
     /* Turn per-face attributes into per-vertex, if desired (and if there are
        any) */
-    if(level == 0 && configuration().value<bool>("perFaceToPerVertex") && !faceAttributeData.isEmpty()) {
+    if(convertPerFaceToPerVertex) {
         if(flags() & ImporterFlag::Verbose)
             Debug{} << "Trade::StanfordImporter::mesh(): converting" << faceAttributeData.size() << "per-face attributes to per-vertex";
 
@@ -861,7 +1370,7 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
         MeshIndexData indices{_state->faceIndexType, indexData};
         MeshData perVertex{MeshPrimitive::Triangles,
             Utility::move(indexData), indices,
-            Utility::move(vertexData), Utility::move(vertexAttributeData)};
+            DataFlags{}, vertexView, Utility::move(vertexAttributeData)};
         MeshData perFace{MeshPrimitive::Faces,
             Utility::move(faceData), Utility::move(faceAttributeData), triangleFaceCount};
         return MeshTools::combineFaceAttributes(perVertex, perFace);
@@ -869,6 +1378,9 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
 
     if(level == 0) {
         MeshIndexData indices{_state->faceIndexType, indexData};
+        if(referenceVertexData) return MeshData{MeshPrimitive::Triangles,
+            Utility::move(indexData), indices,
+            DataFlags{}, vertexView, Utility::move(vertexAttributeData)};
         return MeshData{MeshPrimitive::Triangles,
             Utility::move(indexData), indices,
             Utility::move(vertexData), Utility::move(vertexAttributeData)};
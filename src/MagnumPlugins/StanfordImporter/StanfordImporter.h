@@ -57,7 +57,7 @@ namespace Magnum { namespace Trade {
 
 @m_keywords{PLY}
 
-Imports Little- and Big-Endian binary PLY (`*.ply`) files. You can use
+Imports ASCII and Little- and Big-Endian binary PLY (`*.ply`) files. You can use
 @ref StanfordSceneConverter to encode meshes into this format.
 
 @section Trade-StanfordImporter-usage Usage
@@ -108,8 +108,16 @@ In order to optimize for fast import, the importer supports a restricted subset
 of PLY features, which however shouldn't affect any real-world models.
 
 -   Both Little- and Big-Endian binary files are supported, with bytes swapped
-    to match platform endianness. ASCII files are not supported due to the
-    storage size overhead and inherent inefficiency of float literal parsing.
+    to match platform endianness.
+-   ASCII files are supported as well, converted to the binary representation
+    on opening. Values are treated as whitespace-separated tokens and line
+    breaks aren't taken into account. Face list sizes are counted in a first
+    pass so the data get allocated exactly once. Floating-point values with up
+    to 15 significant digits and a small enough exponent are parsed with a
+    fast exact path, everything else falls back to @ref std::strtod(), which
+    is locale-dependent. Compared to binary files, the import is still
+    significantly slower and the data need additional memory for the
+    conversion.
 -   Position coordinates (`x`/`y`/`z`) are expected to have the same type, be
     tightly packed in a XYZ order and be either 32-bit floats or (signed) bytes
     or shorts. Resulting position type is then
@@ -154,11 +162,25 @@ of PLY features, which however shouldn't affect any real-world models.
     unsigned (because negative values wouldn't make sense anyway).
 
 The mesh is always indexed; positions are always present, other attributes are
-optional.
+optional. Files that have no `face` element at all are treated as point clouds
+and imported as non-indexed @ref MeshPrimitive::Points, see
+@ref Trade-StanfordImporter-behavior-point-clouds below.
 
 The importer recognizes @ref ImporterFlag::Verbose, printing additional info
 when the flag is enabled.
 
+@subsection Trade-StanfordImporter-behavior-endian-swap Endian swapping
+
+Files that don't match platform endianness get their vertex data, per-face
+data and indices byte-swapped on import. If all vertex or face properties are
+of the same size, such as with all-float vertices, the data are swapped as a
+single contiguous array, otherwise each component is swapped separately.
+Setting the @cb{.ini} threads @ce
+@ref Trade-StanfordImporter-configuration "configuration option" to a value
+other than @cpp 1 @ce splits the swapping across multiple threads. Same as
+with @ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter",
+the application has to be linked to `pthread` on Linux for this to work.
+
 @subsection Trade-StanfordImporter-behavior-per-face Per-face attributes
 
 By default, if the mesh contains per-face attributes apart from indices, these
@@ -181,6 +203,59 @@ From the builtin attributes, colors, normals and object IDs can be either
 per-vertex or per-face, positions and texture coordinates are always
 per-vertex.
 
+@subsection Trade-StanfordImporter-behavior-zero-copy Zero-copy import and memory mapping
+
+By default, vertex data are copied out of the file on every @ref mesh() call.
+If the @cb{.ini} zeroCopy @ce
+@ref Trade-StanfordImporter-configuration "configuration option" is enabled
+and the file doesn't need to be endian-swapped, the returned @ref MeshData
+instead references vertex data passed to @ref openData() or @ref openMemory(),
+with empty @ref MeshData::vertexDataFlags(). Such view is valid only until the
+importer is closed or another file is opened. Index data are always copied, as
+faces need to be extracted from the interleaved face records. When per-face
+attributes are converted to per-vertex, the result is a new allocation
+regardless of this option.
+
+As @ref openData() copies the data unless their ownership is transferred and
+@ref openFile() reads the whole file into memory, enabling the
+@cb{.ini} mapFile @ce option makes @ref openFile() memory-map the file with
+@relativeref{Corrade,Utility::Path::mapRead()} instead, which together with
+@cb{.ini} zeroCopy @ce avoids any copy of the vertex data whatsoever. This is
+available only on platforms where memory-mapping is supported. ASCII files are
+always converted to a binary representation on opening, so for them the
+mapping only avoids the initial copy.
+
+@subsection Trade-StanfordImporter-behavior-point-clouds Chunked point cloud import
+
+Point clouds are by default imported as a single mesh. If the
+@cb{.ini} pointCloudChunkSize @ce
+@ref Trade-StanfordImporter-configuration "configuration option" is set to a
+non-zero value, @ref meshCount() instead reports one mesh per chunk of at most
+that many vertices, with the last chunk containing the remainder, and
+@ref mesh() imports just given chunk. Chunks are always a single level, as
+point clouds don't have any per-face attributes.
+
+Combined with the @cb{.ini} mapFile @ce and @cb{.ini} zeroCopy @ce options
+described above, each chunk is a view on the memory-mapped file that's paged
+in only when accessed, allowing files much larger than available memory to be
+processed chunk by chunk. The importer itself isn't thread-safe, but the
+returned views can be processed in parallel, or each thread can
+@ref openMemory() the same memory-mapped file in its own importer instance
+and import a disjoint set of chunks without any data being copied:
+
+@code{.cpp}
+importer->configuration().setValue("mapFile", true);
+importer->configuration().setValue("zeroCopy", true);
+importer->configuration().setValue("pointCloudChunkSize", 1000000);
+if(!importer->openFile("scan.ply"))
+    Fatal{} << "Can't open the file";
+
+for(UnsignedInt i = 0; i != importer->meshCount(); ++i) {
+    Containers::Optional<Trade::MeshData> chunk = importer->mesh(i);
+    // process chunk->positions3DAsArray() etc.
+}
+@endcode
+
 @subsection Trade-StanfordImporter-behavior-custom-attributes Custom attributes
 
 Custom and unrecognized vertex and face attributes of known types are present
@@ -213,12 +288,15 @@ class MAGNUM_STANFORDIMPORTER_EXPORT StanfordImporter: public AbstractImporter {
         MAGNUM_STANFORDIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
 
         MAGNUM_STANFORDIMPORTER_LOCAL bool doIsOpened() const override;
+        MAGNUM_STANFORDIMPORTER_LOCAL void doOpenFile(Containers::StringView filename) override;
         MAGNUM_STANFORDIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
         MAGNUM_STANFORDIMPORTER_LOCAL void doClose() override;
 
         MAGNUM_STANFORDIMPORTER_LOCAL UnsignedInt doMeshCount() const override;
         MAGNUM_STANFORDIMPORTER_LOCAL UnsignedInt doMeshLevelCount(UnsignedInt id) override;
         MAGNUM_STANFORDIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
+        MAGNUM_STANFORDIMPORTER_LOCAL Containers::Optional<MeshData> pointCloudMesh(UnsignedInt id);
+        MAGNUM_STANFORDIMPORTER_LOCAL std::size_t threadCount();
         MAGNUM_STANFORDIMPORTER_LOCAL MeshAttribute doMeshAttributeForName(const Containers::StringView name) override;
         MAGNUM_STANFORDIMPORTER_LOCAL Containers::String doMeshAttributeName(MeshAttribute name) override;
 
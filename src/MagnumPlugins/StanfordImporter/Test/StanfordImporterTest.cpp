@@ -23,15 +23,20 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cstring>
 #include <sstream>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/Endianness.h>
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/String.h>
@@ -64,6 +69,15 @@ struct StanfordImporterTest: TestSuite::Tester {
     void triangleFastPath();
     void triangleFastPathPerFaceToPerVertex();
 
+    void pointCloud();
+
+    void threads();
+
+    void zeroCopy();
+    void zeroCopyEndianSwap();
+    void zeroCopyPerFaceToPerVertex();
+    void mapFile();
+
     void openMemory();
     void openTwice();
     void importTwice();
@@ -80,7 +94,7 @@ constexpr struct {
     {"invalid-signature", "invalid file signature bla", true},
 
     {"format-invalid", "invalid format line format binary_big_endian 1.0 extradata", true},
-    {"format-unsupported", "unsupported file format ascii 1.0", true},
+    {"format-unsupported", "unsupported file format ascii 2.0", true},
     {"format-missing", "missing format line", true},
     {"format-too-late", "expected format line, got element face 1", true},
 
@@ -122,7 +136,16 @@ constexpr struct {
 
     {"objectid-unsupported-type", "unsupported object ID type VertexFormat::Float", true},
 
-    {"unsupported-face-size", "unsupported face size 5", false}
+    {"unsupported-face-size", "unsupported face size 5", false},
+
+    {"ascii-incomplete-vertex-data", "incomplete vertex data", true},
+    {"ascii-incomplete-face-data", "incomplete face data", true},
+    {"ascii-invalid-face-size", "invalid ASCII face size 3.0", true},
+    /* Unlike with binary files, this is checked during open already */
+    {"ascii-unsupported-face-size", "unsupported face size 5", true},
+    {"ascii-invalid-vertex-value", "invalid ASCII vertex value 1.0f", true},
+    {"ascii-invalid-face-index", "invalid ASCII face index 1.5", true},
+    {"ascii-invalid-face-value", "invalid ASCII face value 0x1", true}
 };
 
 constexpr struct {
@@ -192,6 +215,19 @@ constexpr struct {
         VertexFormat::Vector3s, VertexFormat::Vector3ubNormalized,
         VertexFormat{}, VertexFormat::Vector2usNormalized,
         VertexFormat{}, nullptr, 3, 0},
+    /* ASCII, all supported attributes in the canonical type, values with
+       and without exponents and various precision */
+    {"ascii-positions-colors-normals-texcoords-float-objectid-uint-indices-int",
+        MeshIndexType::UnsignedInt,
+        VertexFormat::Vector3, VertexFormat::Vector3,
+        VertexFormat::Vector3, VertexFormat::Vector2,
+        VertexFormat::UnsignedInt, nullptr, 5, 0},
+    /* ASCII, integer types */
+    {"ascii-positions-uchar-normals-char-objectid-short-indices-ushort",
+        MeshIndexType::UnsignedShort,
+        VertexFormat::Vector3ub, VertexFormat{},
+        VertexFormat::Vector3bNormalized, VertexFormat{},
+        VertexFormat::UnsignedShort, "OBJECTID", 3, 0},
     /* CR/LF instead of LF */
     {"crlf", MeshIndexType::UnsignedByte,
         VertexFormat::Vector3us, VertexFormat{},
@@ -245,6 +281,47 @@ constexpr struct {
     {"custom-components-be"}
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+    UnsignedInt chunkSize;
+    bool zeroCopy;
+    Containers::Array<UnsignedInt> expectedChunkSizes;
+    DataFlags expectedDataFlags;
+} PointCloudData[]{
+    {"", "point-cloud.ply", 0, false,
+        {InPlaceInit, {5}}, DataFlag::Owned|DataFlag::Mutable},
+    {"big-endian", "point-cloud-be.ply", 0, false,
+        {InPlaceInit, {5}}, DataFlag::Owned|DataFlag::Mutable},
+    {"chunks of 2", "point-cloud.ply", 2, false,
+        {InPlaceInit, {2, 2, 1}}, DataFlag::Owned|DataFlag::Mutable},
+    {"chunks of 2, big-endian", "point-cloud-be.ply", 2, false,
+        {InPlaceInit, {2, 2, 1}}, DataFlag::Owned|DataFlag::Mutable},
+    {"chunks of 5", "point-cloud.ply", 5, false,
+        {InPlaceInit, {5}}, DataFlag::Owned|DataFlag::Mutable},
+    {"chunks of 7", "point-cloud.ply", 7, false,
+        {InPlaceInit, {5}}, DataFlag::Owned|DataFlag::Mutable},
+    #ifndef CORRADE_TARGET_BIG_ENDIAN
+    {"chunks of 3, zero copy", "point-cloud.ply", 3, true,
+        {InPlaceInit, {3, 2}}, DataFlags{}},
+    #else
+    {"chunks of 3, zero copy", "point-cloud-be.ply", 3, true,
+        {InPlaceInit, {3, 2}}, DataFlags{}},
+    #endif
+};
+
+const struct {
+    const char* name;
+    bool customAttribute;
+    UnsignedInt threads;
+} ThreadsData[]{
+    {"all floats, single thread", false, 1},
+    {"all floats, 3 threads", false, 3},
+    {"all floats, all threads", false, 0},
+    {"mixed sizes, 3 threads", true, 3},
+    {"mixed sizes, all threads", true, 0},
+};
+
 constexpr struct {
     const char* name;
     bool enabled;
@@ -299,6 +376,17 @@ StanfordImporterTest::StanfordImporterTest() {
                        &StanfordImporterTest::triangleFastPathPerFaceToPerVertex},
         Containers::arraySize(FastTrianglePathData));
 
+    addInstancedTests({&StanfordImporterTest::pointCloud},
+        Containers::arraySize(PointCloudData));
+
+    addInstancedTests({&StanfordImporterTest::threads},
+        Containers::arraySize(ThreadsData));
+
+    addTests({&StanfordImporterTest::zeroCopy,
+              &StanfordImporterTest::zeroCopyEndianSwap,
+              &StanfordImporterTest::zeroCopyPerFaceToPerVertex,
+              &StanfordImporterTest::mapFile});
+
     addInstancedTests({&StanfordImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
@@ -1021,6 +1109,224 @@ void StanfordImporterTest::triangleFastPathPerFaceToPerVertex() {
         }), TestSuite::Compare::Container);
 }
 
+void StanfordImporterTest::pointCloud() {
+    auto&& data = PointCloudData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    /* There are no per-face attributes, so this shouldn't result in a second
+       level */
+    importer->configuration().setValue("perFaceToPerVertex", false);
+    importer->configuration().setValue("pointCloudChunkSize", data.chunkSize);
+    importer->configuration().setValue("zeroCopy", data.zeroCopy);
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STANFORDIMPORTER_TEST_DIR, data.filename)));
+    CORRADE_COMPARE(importer->meshCount(), data.expectedChunkSizes.size());
+
+    std::size_t offset = 0;
+    for(UnsignedInt i = 0; i != importer->meshCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(importer->meshLevelCount(i), 1);
+
+        Containers::Optional<Trade::MeshData> mesh = importer->mesh(i);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Points);
+        CORRADE_VERIFY(!mesh->isIndexed());
+        CORRADE_COMPARE(mesh->vertexDataFlags(), data.expectedDataFlags);
+        CORRADE_COMPARE(mesh->vertexCount(), data.expectedChunkSizes[i]);
+        CORRADE_COMPARE(mesh->attributeCount(), 2);
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3);
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Color), VertexFormat::Vector3ubNormalized);
+        CORRADE_COMPARE_AS(mesh->positions3DAsArray(),
+            Containers::arrayView(Positions).sliceSize(offset, data.expectedChunkSizes[i]),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(Containers::arrayCast<Color3>(Containers::stridedArrayView(mesh->colorsAsArray())),
+            Containers::stridedArrayView(Colors).sliceSize(offset, data.expectedChunkSizes[i]),
+            TestSuite::Compare::Container);
+
+        offset += data.expectedChunkSizes[i];
+    }
+}
+
+/* Appends a value byte-swapped, i.e. in the endianness that doesn't match the
+   platform */
+template<class T> void appendSwapped(Containers::Array<char>& out, T value) {
+    Utility::Endianness::swapInPlace(value);
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    arrayAppend(out, Containers::arrayView(bytes));
+}
+
+void StanfordImporterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Large enough to be split into several ranges, and not a multiple of the
+       range size */
+    constexpr UnsignedInt VertexCount = 150001;
+    constexpr UnsignedInt FaceCount = 70001;
+
+    Containers::Array<char> file;
+    arrayAppend(file, Containers::StringView{Utility::format(
+        "ply\n"
+        "format {} 1.0\n"
+        "element vertex {}\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n"
+        "{}"
+        "element face {}\n"
+        "property list uchar uint vertex_indices\n"
+        "end_header\n",
+        Utility::Endianness::isBigEndian() ? "binary_little_endian" : "binary_big_endian",
+        VertexCount,
+        data.customAttribute ? "property ushort quality\n" : "",
+        FaceCount)});
+    for(UnsignedInt i = 0; i != VertexCount; ++i) {
+        appendSwapped(file, Float(i));
+        appendSwapped(file, Float(i*2));
+        appendSwapped(file, Float(i*3));
+        if(data.customAttribute)
+            appendSwapped(file, UnsignedShort(i));
+    }
+    for(UnsignedInt i = 0; i != FaceCount; ++i) {
+        arrayAppend(file, char(3));
+        for(UnsignedInt j = 0; j != 3; ++j)
+            appendSwapped(file, UnsignedInt((i + j)%VertexCount));
+    }
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("threads", data.threads);
+    CORRADE_VERIFY(importer->openData(file));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexCount(), VertexCount);
+    CORRADE_COMPARE(mesh->indexCount(), FaceCount*3);
+
+    Containers::StridedArrayView1D<const Vector3> positions = mesh->attribute<Vector3>(MeshAttribute::Position);
+    Containers::StridedArrayView1D<const UnsignedInt> indices = mesh->indices<UnsignedInt>();
+    for(UnsignedInt i = 0; i != VertexCount; ++i) {
+        if(positions[i] != Vector3{Float(i), Float(i*2), Float(i*3)}) {
+            CORRADE_ITERATION(i);
+            CORRADE_COMPARE(positions[i], (Vector3{Float(i), Float(i*2), Float(i*3)}));
+        }
+    }
+    if(data.customAttribute) {
+        const MeshAttribute quality = importer->meshAttributeForName("quality");
+        CORRADE_VERIFY(quality != MeshAttribute{});
+        Containers::StridedArrayView1D<const UnsignedShort> qualities = mesh->attribute<UnsignedShort>(quality);
+        for(UnsignedInt i = 0; i != VertexCount; ++i) {
+            if(qualities[i] != UnsignedShort(i)) {
+                CORRADE_ITERATION(i);
+                CORRADE_COMPARE(qualities[i], UnsignedShort(i));
+            }
+        }
+    }
+    for(UnsignedInt i = 0; i != FaceCount*3; ++i) {
+        if(indices[i] != (i/3 + i%3)%VertexCount) {
+            CORRADE_ITERATION(i);
+            CORRADE_COMPARE(indices[i], (i/3 + i%3)%VertexCount);
+        }
+    }
+}
+
+/* The file matching platform endianness can be referenced directly, the
+   other needs to be swapped */
+#ifndef CORRADE_TARGET_BIG_ENDIAN
+constexpr const char* NativeEndianFile = "positions-colors-normals-texcoords-float-objectid-uint-indices-int.ply";
+constexpr const char* SwappedEndianFile = "positions-colors-normals-texcoords-float-objectid-uint-indices-int-be.ply";
+#else
+constexpr const char* NativeEndianFile = "positions-colors-normals-texcoords-float-objectid-uint-indices-int-be.ply";
+constexpr const char* SwappedEndianFile = "positions-colors-normals-texcoords-float-objectid-uint-indices-int.ply";
+#endif
+
+void StanfordImporterTest::zeroCopy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("perFaceToPerVertex", false);
+    importer->configuration().setValue("zeroCopy", true);
+
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(STANFORDIMPORTER_TEST_DIR, NativeEndianFile));
+    CORRADE_VERIFY(memory);
+    CORRADE_VERIFY(importer->openMemory(*memory));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+
+    /* The vertex data point directly into the passed memory, indices are
+       copied */
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+    CORRADE_VERIFY(mesh->vertexData().data() >= memory->data());
+    CORRADE_VERIFY(mesh->vertexData().data() + mesh->vertexData().size() <= memory->end());
+    CORRADE_COMPARE(mesh->indexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+
+    CORRADE_COMPARE_AS(mesh->indicesAsArray(),
+        Containers::arrayView(Indices),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView(Positions),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->objectIdsAsArray(),
+        Containers::arrayView(ObjectIds),
+        TestSuite::Compare::Container);
+}
+
+void StanfordImporterTest::zeroCopyEndianSwap() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("perFaceToPerVertex", false);
+    importer->configuration().setValue("zeroCopy", true);
+
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(STANFORDIMPORTER_TEST_DIR, SwappedEndianFile));
+    CORRADE_VERIFY(memory);
+    CORRADE_VERIFY(importer->openMemory(*memory));
+
+    /* The data need to be endian-swapped, so they're copied anyway */
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView(Positions),
+        TestSuite::Compare::Container);
+}
+
+void StanfordImporterTest::zeroCopyPerFaceToPerVertex() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("zeroCopy", true);
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STANFORDIMPORTER_TEST_DIR, "per-face-normals-objectid.ply")));
+
+    /* The conversion makes a new allocation, the option has no effect */
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE_AS(mesh->positions3DAsArray(),
+        Containers::arrayView(PositionsPerFaceToPerVertex),
+        TestSuite::Compare::Container);
+}
+
+void StanfordImporterTest::mapFile() {
+    #if !defined(CORRADE_TARGET_UNIX) && (!defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_SKIP("Memory mapping not available on this platform.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("perFaceToPerVertex", false);
+    importer->configuration().setValue("mapFile", true);
+    /* Reference the mapped memory directly to verify it stays valid */
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STANFORDIMPORTER_TEST_DIR, NativeEndianFile)));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE_AS(mesh->indicesAsArray(),
+        Containers::arrayView(Indices),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView(Positions),
+        TestSuite::Compare::Container);
+    #endif
+}
+
 void StanfordImporterTest::openMemory() {
     /* Same as (a subset of) parse() except that it uses openData() &
        openMemory() instead of openFile() to test data copying on import */
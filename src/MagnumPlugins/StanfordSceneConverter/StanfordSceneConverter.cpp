@@ -25,26 +25,290 @@
 
 #include "StanfordSceneConverter.h"
 
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/EndiannessBatch.h>
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once <string> is gone here */
+#include <Corrade/Utility/Path.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/MeshTools/Duplicate.h>
 #include <Magnum/MeshTools/GenerateIndices.h>
 #include <Magnum/Trade/MeshData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
 namespace Magnum { namespace Trade {
 
 using namespace Containers::Literals;
 
-StanfordSceneConverter::StanfordSceneConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractSceneConverter{manager, plugin} {}
+namespace {
+
+/* Size of the staging buffer used when writing to a file, and the granularity
+   in which vertex and face data are processed in general */
+constexpr std::size_t BufferSize = 4*1024*1024;
+
+/* Upper bound on the text size of a single ASCII value including the
+   separator. The longest is a double printed with %.17g, such as
+   -2.2250738585072014e-308. */
+constexpr std::size_t AsciiMaxValueSize = 25;
+
+/* Output of the conversion. When converting to data, everything is collected
+   in a single array, which is allocated upfront if the final size is known.
+   When converting to a file, the data is staged in a fixed-size buffer that
+   gets appended to the file once full, so the whole file never needs to be in
+   memory at once. */
+class Output {
+    public:
+        /* Converting to data */
+        explicit Output() = default;
+
+        /* Converting to a file */
+        explicit Output(Containers::StringView filename): _filename{filename}, _file{true}, _data{NoInit, BufferSize} {}
+
+        /* Allocates the output upfront when converting to data, no-op when
+           converting to a file */
+        void reserve(const std::size_t size) {
+            if(_file || size <= _data.size()) return;
+            grow(size);
+        }
 
-StanfordSceneConverter::~StanfordSceneConverter() = default;
+        /* Returns a view on the next `size` bytes of the output. If not all
+           of it gets written to, the unused suffix can be discarded with
+           trim(). */
+        Containers::ArrayView<char> append(const std::size_t size) {
+            if(_size + size > _data.size()) {
+                if(_file) {
+                    flush();
+                    if(size > _data.size())
+                        _data = Containers::Array<char>{NoInit, size};
+                } else grow(Math::max(2*_data.size(), _size + size));
+            }
 
-SceneConverterFeatures StanfordSceneConverter::doFeatures() const { return SceneConverterFeature::ConvertMeshToData; }
+            const Containers::ArrayView<char> out = _data.sliceSize(_size, size);
+            _size += size;
+            return out;
+        }
 
-Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertToData(const MeshData& mesh) {
+        void trim(const std::size_t size) {
+            CORRADE_INTERNAL_ASSERT(size <= _size);
+            _size -= size;
+        }
+
+        /* Writes the remaining staged data to the file. Returns false if any
+           write failed. */
+        bool finish() {
+            CORRADE_INTERNAL_ASSERT(_file);
+            flush();
+            return !_failed;
+        }
+
+        /* Returns the collected data when converting to data */
+        Containers::Array<char> release() {
+            CORRADE_INTERNAL_ASSERT(!_file);
+            if(_size == _data.size())
+                return Utility::move(_data);
+
+            Containers::Array<char> out{NoInit, _size};
+            Utility::copy(_data.prefix(_size), out);
+            return out;
+        }
+
+    private:
+        void grow(const std::size_t capacity) {
+            Containers::Array<char> data{NoInit, capacity};
+            Utility::copy(_data.prefix(_size), data.prefix(_size));
+            _data = Utility::move(data);
+        }
+
+        void flush() {
+            /* Once a write fails, don't attempt to write anything more.
+               Otherwise the first write truncates the file, subsequent
+               append to it. */
+            if(!_failed && !(_written ?
+                Utility::Path::append(_filename, _data.prefix(_size)) :
+                Utility::Path::write(_filename, _data.prefix(_size))))
+                _failed = true;
+            _written = true;
+            _size = 0;
+        }
+
+        Containers::StringView _filename;
+        bool _file{}, _written{}, _failed{};
+        Containers::Array<char> _data;
+        std::size_t _size{};
+};
+
+constexpr Double PowersOfTen[]{
+    1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9,
+    1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18,
+    1.0e19, 1.0e20, 1.0e21, 1.0e22
+};
+
+constexpr UnsignedInt IntegerPowersOfTen[]{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/* All powers of ten up to 1e22 are exactly representable in a double, so
+   this is a single correctly rounded operation */
+Double scaleByPowerOfTen(const Double value, const Int exponent) {
+    return exponent < 0 ?
+        value/PowersOfTen[-exponent] :
+        value*PowersOfTen[exponent];
+}
+
+char* formatUnsigned(char* out, UnsignedLong value) {
+    char buffer[20];
+    char* it = buffer + sizeof(buffer);
+    do {
+        *--it = char('0' + value%10);
+        value /= 10;
+    } while(value);
+    const std::size_t size = buffer + sizeof(buffer) - it;
+    std::memcpy(out, it, size);
+    return out + size;
+}
+
+char* formatInteger(char* out, const Long value) {
+    if(value < 0) {
+        *out++ = '-';
+        return formatUnsigned(out, 0ull - UnsignedLong(value));
+    }
+    return formatUnsigned(out, UnsignedLong(value));
+}
+
+/* Prints the shortest representation with 6 to 9 significant digits that
+   parses back to the same float. Unlike snprintf() it doesn't need to go
+   through locale-aware formatting and arbitrary-precision arithmetic, which
+   makes it about three times faster. Nine digits are always enough for a
+   float to roundtrip, and as the value is first converted to a double,
+   scaling it by an exactly representable power of ten introduces an error
+   way below the last printed digit. Values that are too small or too large
+   for the power table, infinities and NaNs go through snprintf(). */
+char* formatFloat(char* out, const Float value) {
+    if(std::signbit(value)) *out++ = '-';
+    const Float absolute = std::abs(value);
+    if(absolute == 0.0f) {
+        *out++ = '0';
+        return out;
+    }
+    if(!(absolute >= 1.0e-13f && absolute < 1.0e13f))
+        return out + std::snprintf(out, AsciiMaxValueSize, "%.9g", Double(absolute));
+
+    /* The exponent estimate from log10() may be off by one close to powers
+       of ten, fix it up based on the digit count */
+    Int exponent = Int(std::floor(std::log10(Double(absolute))));
+    UnsignedInt digits;
+    for(Int precision = 6; ; ++precision) {
+        for(;;) {
+            digits = UnsignedInt(scaleByPowerOfTen(absolute, precision - 1 - exponent) + 0.5);
+            if(digits >= IntegerPowersOfTen[precision]) ++exponent;
+            else if(digits < IntegerPowersOfTen[precision - 1]) --exponent;
+            else break;
+        }
+
+        if(precision == 9 || Float(scaleByPowerOfTen(digits, exponent - precision + 1)) == absolute)
+            break;
+    }
+
+    /* Print the digits, strip trailing zeros */
+    char buffer[9];
+    Int significant = Int(formatUnsigned(buffer, digits) - buffer);
+    while(significant > 1 && buffer[significant - 1] == '0')
+        --significant;
+
+    /* Scientific notation for very small and very large values, similarly to
+       what %g does */
+    if(exponent < -4 || exponent >= 9) {
+        *out++ = buffer[0];
+        if(significant > 1) {
+            *out++ = '.';
+            std::memcpy(out, buffer + 1, significant - 1);
+            out += significant - 1;
+        }
+        *out++ = 'e';
+        return formatInteger(out, exponent);
+    }
+
+    /* 0.000ddd */
+    if(exponent < 0) {
+        *out++ = '0';
+        *out++ = '.';
+        for(Int i = 0; i != -exponent - 1; ++i) *out++ = '0';
+        std::memcpy(out, buffer, significant);
+        return out + significant;
+    }
+
+    /* ddd000 */
+    if(significant <= exponent + 1) {
+        std::memcpy(out, buffer, significant);
+        out += significant;
+        for(Int i = significant; i != exponent + 1; ++i) *out++ = '0';
+        return out;
+    }
+
+    /* ddd.ddd */
+    std::memcpy(out, buffer, exponent + 1);
+    out += exponent + 1;
+    *out++ = '.';
+    std::memcpy(out, buffer + exponent + 1, significant - exponent - 1);
+    return out + significant - exponent - 1;
+}
+
+/* Doubles aren't nearly as common in PLY files, so these just try whether
+   15 digits are enough for a roundtrip and use 17 if not */
+char* formatDouble(char* out, const Double value) {
+    const int size = std::snprintf(out, AsciiMaxValueSize, "%.15g", value);
+    if(std::strtod(out, nullptr) == value || value != value)
+        return out + size;
+    return out + std::snprintf(out, AsciiMaxValueSize, "%.17g", value);
+}
+
+template<class T> T readValue(const char* const data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+char* formatValue(char* out, const char* const data, const VertexFormat format) {
+    switch(format) {
+        case VertexFormat::Float:
+            return formatFloat(out, readValue<Float>(data));
+        case VertexFormat::Double:
+            return formatDouble(out, readValue<Double>(data));
+        case VertexFormat::UnsignedByte:
+        case VertexFormat::UnsignedByteNormalized:
+            return formatUnsigned(out, readValue<UnsignedByte>(data));
+        case VertexFormat::Byte:
+        case VertexFormat::ByteNormalized:
+            return formatInteger(out, readValue<Byte>(data));
+        case VertexFormat::UnsignedShort:
+        case VertexFormat::UnsignedShortNormalized:
+            return formatUnsigned(out, readValue<UnsignedShort>(data));
+        case VertexFormat::Short:
+        case VertexFormat::ShortNormalized:
+            return formatInteger(out, readValue<Short>(data));
+        case VertexFormat::UnsignedInt:
+            return formatUnsigned(out, readValue<UnsignedInt>(data));
+        case VertexFormat::Int:
+            return formatInteger(out, readValue<Int>(data));
+        default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+}
+
+UnsignedInt readIndex(const char* const data, const std::size_t indexTypeSize) {
+    if(indexTypeSize == 4) return readValue<UnsignedInt>(data);
+    if(indexTypeSize == 2) return readValue<UnsignedShort>(data);
+    CORRADE_INTERNAL_ASSERT(indexTypeSize == 1);
+    return readValue<UnsignedByte>(data);
+}
+
+bool convertInternal(const StanfordSceneConverter& converter, const char* const messagePrefix, const MeshData& mesh, Output& output) {
     /* Convert to an indexed triangle mesh if it's a strip/fan */
     MeshData triangles{MeshPrimitive::Triangles, 0};
     if(mesh.primitive() == MeshPrimitive::TriangleStrip ||
@@ -67,15 +331,16 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
 
     /* Otherwise we're sorry */
     } else {
-        Error{} << "Trade::StanfordSceneConverter::convertToData(): expected a triangle mesh, got" << mesh.primitive();
-        return {};
+        Error{} << messagePrefix << "expected a triangle mesh, got" << mesh.primitive();
+        return false;
     }
 
-    /* Decide on endian swapping, write file signature */
+    /* Decide on ASCII output or endian swapping, write file signature */
+    const bool ascii = converter.configuration().value<bool>("ascii");
     bool endianSwapNeeded;
     std::string header = "ply\n";
     {
-        const auto endianness = configuration().value<Containers::StringView>("endianness");
+        const auto endianness = converter.configuration().value<Containers::StringView>("endianness");
         bool isBigEndian;
         if(endianness == "native"_s) {
             isBigEndian = Utility::Endianness::isBigEndian();
@@ -87,12 +352,13 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
             isBigEndian = true;
             endianSwapNeeded = !Utility::Endianness::isBigEndian();
         } else {
-            Error{} << "Trade::StanfordSceneConverter::convertToData(): invalid option endianness=" << Debug::nospace << endianness;
-            return {};
+            Error{} << messagePrefix << "invalid option endianness=" << Debug::nospace << endianness;
+            return false;
         }
-        header += isBigEndian ?
-            "format binary_big_endian 1.0\n" :
-            "format binary_little_endian 1.0\n";
+        header += ascii ? "format ascii 1.0\n" :
+            isBigEndian ?
+                "format binary_big_endian 1.0\n" :
+                "format binary_little_endian 1.0\n";
     }
 
     /* Require positions to be present -- otherwise the StanfordImporter won't
@@ -100,8 +366,8 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
        restriction could eventually be lifted, but so far I don't have a use
        case, so better be strict. */
     if(!triangles.hasAttribute(MeshAttribute::Position)) {
-        Error{} << "Trade::StanfordSceneConverter::convertToData(): the mesh has no positions";
-        return {};
+        Error{} << messagePrefix << "the mesh has no positions";
+        return false;
     }
 
     /* Write attribute header and calculate offsets for copying later.
@@ -109,6 +375,7 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
        PLY or the name is unknown will have offset kept at ~std::size_t{}. */
     Containers::Array<std::size_t> offsets{DirectInit, triangles.attributeCount(), ~std::size_t{}};
     std::size_t vertexSize = 0;
+    std::size_t vertexComponentCount = 0;
     Utility::formatInto(header, header.size(),
         "element vertex {}\n",
         triangles.vertexCount());
@@ -116,8 +383,8 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
         const MeshAttribute name = triangles.attributeName(i);
         const VertexFormat format = triangles.attributeFormat(i);
         if(isVertexFormatImplementationSpecific(format)) {
-            if(!(flags() & SceneConverterFlag::Quiet))
-                Warning{} << "Trade::StanfordSceneConverter::convertToData(): skipping attribute" << name << "with" << format;
+            if(!(converter.flags() & SceneConverterFlag::Quiet))
+                Warning{} << messagePrefix << "skipping attribute" << name << "with" << format;
             continue;
         }
 
@@ -154,16 +421,16 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
                 formatString = "int";
                 break;
             default:
-                if(!(flags() & SceneConverterFlag::Quiet))
-                    Warning{} << "Trade::StanfordSceneConverter::convertToData(): skipping attribute" << name << "with unsupported format" << format;
+                if(!(converter.flags() & SceneConverterFlag::Quiet))
+                    Warning{} << messagePrefix << "skipping attribute" << name << "with unsupported format" << format;
                 continue;
         }
 
         /* Positions */
         if(name == MeshAttribute::Position) {
             if(vertexFormatComponentCount(format) != 3) {
-                Error{} << "Trade::StanfordSceneConverter::convertToData(): two-component positions are not supported";
-                return {};
+                Error{} << messagePrefix << "two-component positions are not supported";
+                return false;
             }
 
             Utility::formatInto(header, header.size(),
@@ -200,18 +467,19 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
         } else if(name == MeshAttribute::ObjectId) {
             Utility::formatInto(header, header.size(),
                 "property {} {}\n", formatString,
-                configuration().value("objectIdAttribute"));
+                converter.configuration().value("objectIdAttribute"));
 
         /* Something else, skip */
         /** @todo add setMeshAttributeName() and enable this for custom attribs */
         } else {
-            if(!(flags() & SceneConverterFlag::Quiet))
-                Warning{} << "Trade::StanfordSceneConverter::convertToData(): skipping unsupported attribute" << name;
+            if(!(converter.flags() & SceneConverterFlag::Quiet))
+                Warning{} << messagePrefix << "skipping unsupported attribute" << name;
             continue;
         }
 
         offsets[i] = vertexSize;
         vertexSize += vertexFormatSize(format);
+        vertexComponentCount += vertexFormatComponentCount(format);
     }
 
     /* Index type */
@@ -234,130 +502,236 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
     /* Wrap up the header -- for face attributes we have just the index list */
     /** @todo once multi-mesh conversion is supported, this could accept a
         MeshAttribute::Face with per-face attribs */
+    const std::size_t faceCount = (triangles.isIndexed() ? triangles.indexCount() : triangles.vertexCount())/3;
     Utility::formatInto(header, header.size(),
         "element face {}\n"
         "property list uchar {} vertex_indices\n"
         "end_header\n",
-        triangles.isIndexed() ? triangles.indexCount()/3 : triangles.vertexCount()/3,
-        indexTypeString);
-
-    /* Vertex and index data size. For a non-indexed mesh we'll use 32-bit
-       indices for simplicity, face size is always 3 so a 1-byte type is
-       enough. */
-    const std::size_t vertexDataSize = vertexSize*triangles.vertexCount();
-    std::size_t indexTypeSize;
-    std::size_t indexDataSize;
-    if(!triangles.isIndexed()) {
-        indexTypeSize = 4;
-        indexDataSize = (1 + 3*4)*triangles.vertexCount()/3;
-    } else {
-        indexTypeSize = meshIndexTypeSize(triangles.indexType());
-        indexDataSize = (1 + 3*indexTypeSize)*triangles.indexCount()/3;
-    }
-
-    /* Allocate the data, copy header */
-    Containers::Array<char> out{NoInit, header.size() + vertexDataSize + indexDataSize};
-    /* Needs an explicit ArrayView constructor, otherwise MSVC 2015, 17 and 19
-       creates ArrayView<const void> here (wtf!) */
-    Utility::copy(Containers::ArrayView<const char>{header.data(), header.size()}, out.prefix(header.size()));
+        faceCount, indexTypeString);
+
+    /* For a non-indexed mesh we'll use 32-bit indices for simplicity, face
+       size is always 3 so a 1-byte type is enough. */
+    const std::size_t indexTypeSize = triangles.isIndexed() ?
+        meshIndexTypeSize(triangles.indexType()) : 4;
+    const std::size_t faceSize = 1 + 3*indexTypeSize;
+
+    /* If the output size is known upfront, which is the case for binary
+       files, allocate it all at once when converting to data */
+    if(!ascii)
+        output.reserve(header.size() + vertexSize*triangles.vertexCount() + faceSize*faceCount);
+
+    /* Copy the header. Needs an explicit ArrayView constructor, otherwise
+       MSVC 2015, 17 and 19 creates ArrayView<const void> here (wtf!) */
+    Utility::copy(Containers::ArrayView<const char>{header.data(), header.size()}, output.append(header.size()));
+
+    /* ASCII vertices, one line each. Space for the worst case is allocated for
+       a chunk of lines and the unused suffix trimmed afterwards. */
+    if(vertexSize && ascii) {
+        /* Gather the attributes that get written so the per-vertex loop
+           doesn't need to query them from the MeshData every time */
+        struct AsciiAttribute {
+            const char* data;
+            std::ptrdiff_t stride;
+            VertexFormat componentFormat;
+            UnsignedInt componentSize;
+            UnsignedInt componentCount;
+        };
+        Containers::Array<AsciiAttribute> attributes{ValueInit, triangles.attributeCount()};
+        std::size_t attributeCount = 0;
+        for(UnsignedInt i = 0; i != triangles.attributeCount(); ++i) {
+            if(offsets[i] == ~std::size_t{}) continue;
 
-    /* Copy the vertices */
-    Containers::ArrayView<char> vertexData = out.sliceSize(header.size(), vertexDataSize);
-    for(UnsignedInt i = 0; i != triangles.attributeCount(); ++i) {
-        if(offsets[i] == ~std::size_t{}) continue;
+            const VertexFormat format = triangles.attributeFormat(i);
+            AsciiAttribute& attribute = attributes[attributeCount++];
+            attribute.data = static_cast<const char*>(triangles.attribute(i).data());
+            attribute.stride = triangles.attributeStride(i);
+            attribute.componentFormat = vertexFormatComponentFormat(format);
+            attribute.componentSize = vertexFormatSize(attribute.componentFormat);
+            attribute.componentCount = vertexFormatComponentCount(format);
+        }
 
-        const Containers::StridedArrayView2D<const char> src = triangles.attribute(i);
-        const Containers::StridedArrayView2D<char> dst{vertexData,
-            vertexData.begin() + offsets[i],
-            src.size(), {std::ptrdiff_t(vertexSize), 1}};
-        Utility::copy(src, dst);
+        const std::size_t maxLineSize = vertexComponentCount*AsciiMaxValueSize;
+        const std::size_t chunkSize = Math::max(BufferSize/maxLineSize, std::size_t{1});
+        for(std::size_t begin = 0; begin < triangles.vertexCount(); begin += chunkSize) {
+            const std::size_t end = Math::min(begin + chunkSize, std::size_t(triangles.vertexCount()));
+            const Containers::ArrayView<char> chunk = output.append(maxLineSize*(end - begin));
+            char* out = chunk.data();
+            for(std::size_t i = begin; i != end; ++i) {
+                for(const AsciiAttribute& attribute: attributes.prefix(attributeCount)) {
+                    const char* const data = attribute.data + std::ptrdiff_t(i)*attribute.stride;
+                    for(UnsignedInt j = 0; j != attribute.componentCount; ++j) {
+                        out = formatValue(out, data + j*attribute.componentSize, attribute.componentFormat);
+                        *out++ = ' ';
+                    }
+                }
+                /* Replace the trailing space with a newline */
+                *(out - 1) = '\n';
+            }
+            output.trim(chunk.end() - out);
+        }
 
-        /* Endian swap, if needed */
-        if(endianSwapNeeded) {
-            const VertexFormat format = triangles.attributeFormat(i);
-            const UnsignedInt componentSize = vertexFormatSize(vertexFormatComponentFormat(format));
-            if(componentSize == 1) continue;
-
-            /* Can't reuse the dst array as it has no information about the
-               component layout. Build a sparse view from scratch instead. */
-            const Containers::StridedArrayView2D<char> components{vertexData,
-                vertexData.begin() + offsets[i],
-                {vertexFormatComponentCount(format),
-                 triangles.vertexCount()},
-                {std::ptrdiff_t(componentSize),
-                 std::ptrdiff_t(vertexSize)}};
-            for(Containers::StridedArrayView1D<char> component: components) {
-                if(componentSize == 8)
-                    Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedLong>(component));
-                else if(componentSize == 4)
-                    Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedInt>(component));
-                else if(componentSize == 2)
-                    Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedShort>(component));
-                else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    /* Binary vertices, interleaved in chunks */
+    } else if(vertexSize) {
+        const std::size_t chunkSize = Math::max(BufferSize/vertexSize, std::size_t{1});
+        for(std::size_t begin = 0; begin < triangles.vertexCount(); begin += chunkSize) {
+            const std::size_t count = Math::min(chunkSize, triangles.vertexCount() - begin);
+            const Containers::ArrayView<char> vertexData = output.append(vertexSize*count);
+            for(UnsignedInt i = 0; i != triangles.attributeCount(); ++i) {
+                if(offsets[i] == ~std::size_t{}) continue;
+
+                const Containers::StridedArrayView2D<const char> src = triangles.attribute(i).slice(begin, begin + count);
+                const Containers::StridedArrayView2D<char> dst{vertexData,
+                    vertexData.begin() + offsets[i],
+                    src.size(), {std::ptrdiff_t(vertexSize), 1}};
+                Utility::copy(src, dst);
+
+                /* Endian swap, if needed */
+                if(endianSwapNeeded) {
+                    const VertexFormat format = triangles.attributeFormat(i);
+                    const UnsignedInt componentSize = vertexFormatSize(vertexFormatComponentFormat(format));
+                    if(componentSize == 1) continue;
+
+                    /* Can't reuse the dst array as it has no information
+                       about the component layout. Build a sparse view from
+                       scratch instead. */
+                    const Containers::StridedArrayView2D<char> components{vertexData,
+                        vertexData.begin() + offsets[i],
+                        {vertexFormatComponentCount(format), count},
+                        {std::ptrdiff_t(componentSize),
+                         std::ptrdiff_t(vertexSize)}};
+                    for(Containers::StridedArrayView1D<char> component: components) {
+                        if(componentSize == 8)
+                            Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedLong>(component));
+                        else if(componentSize == 4)
+                            Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedInt>(component));
+                        else if(componentSize == 2)
+                            Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedShort>(component));
+                        else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+                    }
+                }
             }
         }
     }
 
-    /* Copy the indices. For a non-indexed mesh make a trivial index array. */
-    Containers::ArrayView<char> indexData = out.exceptPrefix(header.size() + vertexDataSize);
-    Containers::StridedArrayView3D<char> indices;
-    if(!triangles.isIndexed()) {
-        const Containers::StridedArrayView2D<UnsignedInt> indices32{indexData,
-            reinterpret_cast<UnsignedInt*>(indexData.begin() + 1),
-            {triangles.vertexCount()/3, 3}, {1 + 3*4, 4}};
-        for(std::size_t i = 0; i != indices32.size()[0]; ++i) {
-            Containers::StridedArrayView1D<UnsignedInt> face = indices32[i];
-            for(std::size_t j = 0; j != 3; ++j)
-                face[j] = i*3 + j;
+    /* For an indexed mesh the faces are taken from the index buffer, for a
+       non-indexed mesh a trivial index array is made */
+    const Containers::ArrayView<const char> indexBytes = triangles.isIndexed() ?
+        triangles.indices().asContiguous() : nullptr;
+
+    /* ASCII faces, one line each. Face size and three 32-bit values with
+       separators at most. */
+    if(ascii) {
+        constexpr std::size_t MaxLineSize = 2 + 3*11 + 1;
+        const std::size_t chunkSize = BufferSize/MaxLineSize;
+        for(std::size_t begin = 0; begin < faceCount; begin += chunkSize) {
+            const std::size_t end = Math::min(begin + chunkSize, faceCount);
+            const Containers::ArrayView<char> chunk = output.append(MaxLineSize*(end - begin));
+            char* out = chunk.data();
+            for(std::size_t i = begin; i != end; ++i) {
+                *out++ = '3';
+                for(std::size_t j = 0; j != 3; ++j) {
+                    *out++ = ' ';
+                    out = formatUnsigned(out, triangles.isIndexed() ?
+                        readIndex(indexBytes.data() + (i*3 + j)*indexTypeSize, indexTypeSize) :
+                        UnsignedInt(i*3 + j));
+                }
+                *out++ = '\n';
+            }
+            output.trim(chunk.end() - out);
         }
 
-        indices = Containers::arrayCast<3, char>(indices32);
-
-    /* For an indexed mesh simply copy the data */
+    /* Binary faces, in chunks */
     } else {
-        const Containers::StridedArrayView3D<const char> src{
-            triangles.indices().asContiguous(),
-            {triangles.indexCount()/3, 3, indexTypeSize},
-            {std::ptrdiff_t(3*indexTypeSize), std::ptrdiff_t(indexTypeSize), 1}};
-        indices = Containers::StridedArrayView3D<char>{indexData,
-            indexData.begin() + 1,
-            {triangles.indexCount()/3, 3, indexTypeSize},
-            {std::ptrdiff_t(1 + 3*indexTypeSize), std::ptrdiff_t(indexTypeSize), 1}};
-        Utility::copy(src, indices);
-    }
+        const std::size_t chunkSize = BufferSize/faceSize;
+        for(std::size_t begin = 0; begin < faceCount; begin += chunkSize) {
+            const std::size_t count = Math::min(chunkSize, faceCount - begin);
+            const Containers::ArrayView<char> indexData = output.append(faceSize*count);
+
+            /* Copy the indices. For a non-indexed mesh make a trivial index
+               array. */
+            Containers::StridedArrayView3D<char> indices;
+            if(!triangles.isIndexed()) {
+                const Containers::StridedArrayView2D<UnsignedInt> indices32{indexData,
+                    reinterpret_cast<UnsignedInt*>(indexData.begin() + 1),
+                    {count, 3}, {1 + 3*4, 4}};
+                for(std::size_t i = 0; i != count; ++i) {
+                    Containers::StridedArrayView1D<UnsignedInt> face = indices32[i];
+                    for(std::size_t j = 0; j != 3; ++j)
+                        face[j] = (begin + i)*3 + j;
+                }
+
+                indices = Containers::arrayCast<3, char>(indices32);
+
+            /* For an indexed mesh simply copy the data */
+            } else {
+                const Containers::StridedArrayView3D<const char> src{
+                    indexBytes.sliceSize(begin*3*indexTypeSize, count*3*indexTypeSize),
+                    {count, 3, indexTypeSize},
+                    {std::ptrdiff_t(3*indexTypeSize), std::ptrdiff_t(indexTypeSize), 1}};
+                indices = Containers::StridedArrayView3D<char>{indexData,
+                    indexData.begin() + 1,
+                    {count, 3, indexTypeSize},
+                    {std::ptrdiff_t(faceSize), std::ptrdiff_t(indexTypeSize), 1}};
+                Utility::copy(src, indices);
+            }
 
-    /* Endian-swap the indices, if needed */
-    if(endianSwapNeeded) {
-        if(indexTypeSize == 4) {
-            for(Containers::StridedArrayView1D<UnsignedInt> i: Containers::arrayCast<2, UnsignedInt>(indices).transposed<0, 1>())
-                Utility::Endianness::swapInPlace(i);
-        } else if(indexTypeSize == 2) {
-            for(Containers::StridedArrayView1D<UnsignedShort> i: Containers::arrayCast<2, UnsignedShort>(indices).transposed<0, 1>())
-                Utility::Endianness::swapInPlace(i);
-        } else CORRADE_INTERNAL_ASSERT(indexTypeSize == 1);
-    }
+            /* Endian-swap the indices, if needed */
+            if(endianSwapNeeded) {
+                if(indexTypeSize == 4) {
+                    for(Containers::StridedArrayView1D<UnsignedInt> i: Containers::arrayCast<2, UnsignedInt>(indices).transposed<0, 1>())
+                        Utility::Endianness::swapInPlace(i);
+                } else if(indexTypeSize == 2) {
+                    for(Containers::StridedArrayView1D<UnsignedShort> i: Containers::arrayCast<2, UnsignedShort>(indices).transposed<0, 1>())
+                        Utility::Endianness::swapInPlace(i);
+                } else CORRADE_INTERNAL_ASSERT(indexTypeSize == 1);
+            }
 
-    /* Fill in face sizes. That's just 3 repeated many times over */
-    {
-        constexpr UnsignedByte three[]{3};
-        Containers::StridedArrayView1D<const UnsignedByte> src = three;
-        Containers::StridedArrayView1D<UnsignedByte> dst;
-        if(!triangles.isIndexed()) {
-            src = src.broadcasted<0>(triangles.vertexCount()/3);
-            dst = Containers::StridedArrayView1D<UnsignedByte>{indexData,
-                reinterpret_cast<UnsignedByte*>(indexData.begin()),
-                triangles.vertexCount()/3, 1 + 3*4};
-        } else {
-            src = src.broadcasted<0>(triangles.indexCount()/3);
-            dst = Containers::StridedArrayView1D<UnsignedByte>{indexData,
-                reinterpret_cast<UnsignedByte*>(indexData.begin()),
-                triangles.indexCount()/3, std::ptrdiff_t(1 + 3*indexTypeSize)};
+            /* Fill in face sizes. That's just 3 repeated many times over */
+            constexpr UnsignedByte three[]{3};
+            Utility::copy(
+                Containers::StridedArrayView1D<const UnsignedByte>{three}.broadcasted<0>(count),
+                Containers::StridedArrayView1D<UnsignedByte>{indexData,
+                    reinterpret_cast<UnsignedByte*>(indexData.begin()),
+                    count, std::ptrdiff_t(faceSize)});
         }
-        Utility::copy(src, dst);
     }
 
+    return true;
+}
+
+}
+
+StanfordSceneConverter::StanfordSceneConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractSceneConverter{manager, plugin} {}
+
+StanfordSceneConverter::~StanfordSceneConverter() = default;
+
+SceneConverterFeatures StanfordSceneConverter::doFeatures() const {
+    return SceneConverterFeature::ConvertMeshToData|
+           SceneConverterFeature::ConvertMeshToFile;
+}
+
+Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertToData(const MeshData& mesh) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
+    Output output;
+    if(!convertInternal(*this, "Trade::StanfordSceneConverter::convertToData():", mesh, output))
+        return {};
+
     /* GCC 4.8 needs extra help here */
-    return Containers::optional(Utility::move(out));
+    return Containers::optional(output.release());
+}
+
+bool StanfordSceneConverter::doConvertToFile(const MeshData& mesh, const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToFile", filename};
+    Output output{filename};
+    if(!convertInternal(*this, "Trade::StanfordSceneConverter::convertToFile():", mesh, output))
+        return false;
+
+    if(!output.finish()) {
+        Error{} << "Trade::StanfordSceneConverter::convertToFile(): cannot write to file" << filename;
+        return false;
+    }
+
+    return true;
 }
 
 }}
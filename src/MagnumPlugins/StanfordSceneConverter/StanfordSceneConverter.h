@@ -58,8 +58,8 @@ namespace Magnum { namespace Trade {
 
 @m_keywords{PLY}
 
-Exports meshes to either Little- or Big-Endian binary `*.ply` files with
-triangle faces. You can use @ref StanfordImporter to import files in this
+Exports meshes to either Little- or Big-Endian binary or ASCII `*.ply` files
+with triangle faces. You can use @ref StanfordImporter to import files in this
 format.
 
 @section Trade-StanfordSceneConverter-usage Usage
@@ -106,10 +106,22 @@ See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 
 @section Trade-StanfordSceneConverter-behavior Behavior and limitations
 
-Produces binary files, ASCII export is not implemented. The data are by default
-exported in machine endian, use the @cb{.ini} endianness @ce
-@ref Trade-StanfordImporter-configuration "configuration option" to perform an
-endian swap on the output data.
+Produces binary files by default. The data are by default exported in machine
+endian, use the @cb{.ini} endianness @ce
+@ref Trade-StanfordSceneConverter-configuration "configuration option" to
+perform an endian swap on the output data. Enabling the @cb{.ini} ascii @ce
+option produces an ASCII file instead. Floats are written in the shortest form
+with 6 to 9 significant digits that reads back to the same value, without
+going through @m_class{m-doc-external} [std::snprintf()](https://en.cppreference.com/w/cpp/io/c/fprintf)
+except for very small or very large values, which makes the export
+significantly faster. Doubles are written with 15 or 17 significant digits,
+whichever is enough to preserve the value.
+
+When converting to a file with
+@relativeref{AbstractSceneConverter,convertToFile()}, the output is streamed
+to the file in pieces of a few megabytes instead of being assembled in memory
+first, so exporting large meshes doesn't need additional memory proportional
+to the file size.
 
 Exports the following attributes, custom attributes and attributes not listed
 below are skipped with a warning:
@@ -169,6 +181,7 @@ class MAGNUM_STANFORDSCENECONVERTER_EXPORT StanfordSceneConverter: public Abstra
     private:
         MAGNUM_STANFORDSCENECONVERTER_LOCAL SceneConverterFeatures doFeatures() const override;
         MAGNUM_STANFORDSCENECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(const MeshData& mesh) override;
+        MAGNUM_STANFORDSCENECONVERTER_LOCAL bool doConvertToFile(const MeshData& mesh, Containers::StringView filename) override;
 };
 
 }}
@@ -25,8 +25,11 @@
 
 #include <sstream>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/File.h>
+#include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
@@ -51,6 +54,11 @@ struct StanfordSceneConverterTest: TestSuite::Tester {
     void triangleFan();
     void indexedTriangleStrip();
     void empty();
+    void ascii();
+
+    void toFile();
+    void toFileChunked();
+    void toFileFailed();
 
     void lines();
     void positionsMissing();
@@ -92,6 +100,29 @@ struct {
     {"big endian", "big", "be"}
 };
 
+struct {
+    const char* name;
+    const char* endianness;
+    bool ascii;
+    const char* file;
+} ToFileData[] {
+    {"little endian", "little", false, "indexed-ushort-le.ply"},
+    {"big endian", "big", false, "indexed-ushort-be.ply"},
+    {"ASCII", nullptr, true, "ascii-indexed-ushort.ply"}
+};
+
+struct {
+    const char* name;
+    const char* endianness;
+    bool ascii;
+    bool indexed;
+} ToFileChunkedData[] {
+    {"binary, non-indexed", "little", false, false},
+    {"binary, indexed, big endian", "big", false, true},
+    {"ASCII, non-indexed", nullptr, true, false},
+    {"ASCII, indexed", nullptr, true, true}
+};
+
 struct {
     const char* name;
     MeshAttribute attribute;
@@ -120,6 +151,15 @@ StanfordSceneConverterTest::StanfordSceneConverterTest() {
               &StanfordSceneConverterTest::triangleFan,
               &StanfordSceneConverterTest::indexedTriangleStrip,
               &StanfordSceneConverterTest::empty,
+              &StanfordSceneConverterTest::ascii});
+
+    addInstancedTests({&StanfordSceneConverterTest::toFile},
+        Containers::arraySize(ToFileData));
+
+    addInstancedTests({&StanfordSceneConverterTest::toFileChunked},
+        Containers::arraySize(ToFileChunkedData));
+
+    addTests({&StanfordSceneConverterTest::toFileFailed,
 
               &StanfordSceneConverterTest::lines,
               &StanfordSceneConverterTest::positionsMissing,
@@ -140,6 +180,9 @@ StanfordSceneConverterTest::StanfordSceneConverterTest() {
     #ifdef STANFORDIMPORTER_PLUGIN_FILENAME
     CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(STANFORDIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
     #endif
+
+    /* Create the output directory if it doesn't exist yet */
+    CORRADE_INTERNAL_ASSERT_OUTPUT(Utility::Path::make(STANFORDSCENECONVERTER_TEST_OUTPUT_DIR));
 }
 
 /* Has to be defined out of class as MSVC 2015 doesn't understand the bitfields
@@ -512,6 +555,173 @@ void StanfordSceneConverterTest::empty() {
         TestSuite::Compare::StringToFile);
 }
 
+void StanfordSceneConverterTest::ascii() {
+    const struct Vertex {
+        Vector3 position;
+        Vector3b normal;
+        Color4ub color;
+    } vertices[] {
+        {{-1.0f, -0.1f, 0.0f}, {0, 127, -128}, {255, 51, 102, 204}},
+        {{1.5f, 3.14159265f, 1.0e-5f}, {-1, 0, 1}, {0, 0, 0, 255}},
+        {{1.0e10f, 123456.0f, -0.0f}, {12, -52, 44}, {1, 2, 3, 4}},
+        {{0.3f, -2.5f, 1024.0f}, {0, 0, 127}, {128, 64, 32, 16}}
+    };
+    const UnsignedShort indices[] { 0, 1, 2, 0, 2, 3 };
+    Containers::StridedArrayView1D<const Vertex> view = vertices;
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, vertices, {
+            MeshAttributeData{MeshAttribute::Position,
+                view.slice(&Vertex::position)},
+            MeshAttributeData{MeshAttribute::Normal,
+                VertexFormat::Vector3bNormalized,
+                view.slice(&Vertex::normal)},
+            MeshAttributeData{MeshAttribute::Color,
+                VertexFormat::Vector4ubNormalized,
+                view.slice(&Vertex::color)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("StanfordSceneConverter");
+    converter->configuration().setValue("ascii", true);
+
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(mesh);
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE_AS(Containers::StringView{*out},
+        Utility::Path::join(STANFORDSCENECONVERTER_TEST_DIR, "ascii.ply"),
+        TestSuite::Compare::StringToFile);
+
+    if(_importerManager.loadState("StanfordImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StanfordImporter plugin not found, cannot test a roundtrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StanfordImporter");
+    CORRADE_VERIFY(importer->openData(*out));
+
+    Containers::Optional<MeshData> importedMesh = importer->mesh(0);
+    CORRADE_VERIFY(importedMesh);
+
+    CORRADE_VERIFY(importedMesh->isIndexed());
+    CORRADE_COMPARE(importedMesh->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE_AS(importedMesh->indices<UnsignedShort>(),
+        Containers::arrayView(indices),
+        TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(importedMesh->attributeCount(), 3);
+    CORRADE_COMPARE_AS(importedMesh->attribute<Vector3>(MeshAttribute::Position),
+        view.slice(&Vertex::position),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(importedMesh->attributeFormat(MeshAttribute::Normal), VertexFormat::Vector3bNormalized);
+    CORRADE_COMPARE_AS(importedMesh->attribute<Vector3b>(MeshAttribute::Normal),
+        view.slice(&Vertex::normal),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(importedMesh->attributeFormat(MeshAttribute::Color), VertexFormat::Vector4ubNormalized);
+    CORRADE_COMPARE_AS(importedMesh->attribute<Color4ub>(MeshAttribute::Color),
+        view.slice(&Vertex::color),
+        TestSuite::Compare::Container);
+}
+
+void StanfordSceneConverterTest::toFile() {
+    auto&& data = ToFileData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Vector3 positions[] {
+        {-1.0f, -1.0f, 0.0f},
+        { 1.0f, -1.0f, 0.0f},
+        { 1.0f,  1.0f, 0.0f},
+        {-1.0f,  1.0f, 0.0f}
+    };
+    const UnsignedShort indices[] { 0, 1, 2, 0, 2, 3 };
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position,
+            Containers::arrayView(positions)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("StanfordSceneConverter");
+    CORRADE_VERIFY(converter->features() & SceneConverterFeature::ConvertMeshToFile);
+    if(data.endianness)
+        converter->configuration().setValue("endianness", data.endianness);
+    converter->configuration().setValue("ascii", data.ascii);
+
+    const Containers::String filename = Utility::Path::join(STANFORDSCENECONVERTER_TEST_OUTPUT_DIR, "file.ply");
+    CORRADE_VERIFY(converter->convertToFile(mesh, filename));
+    CORRADE_COMPARE_AS(filename,
+        Utility::Path::join(STANFORDSCENECONVERTER_TEST_DIR, data.file),
+        TestSuite::Compare::File);
+}
+
+void StanfordSceneConverterTest::toFileChunked() {
+    auto&& data = ToFileChunkedData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* The file is written in 4 MB pieces, 1.2M positions are over 14 MB and
+       400k faces over 5 MB with 32-bit indices, so both the vertex and the
+       face data span several pieces, and the ASCII output even more */
+    Containers::Array<Vector3> positions{NoInit, 1200000};
+    for(std::size_t i = 0; i != positions.size(); ++i)
+        positions[i] = {Float(i), Float(i%1000)*0.125f, -Float(i%7)};
+    Containers::Array<UnsignedInt> indices{NoInit, positions.size()};
+    for(std::size_t i = 0; i != indices.size(); ++i)
+        indices[i] = data.indexed ? (i*7)%positions.size() : i;
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, data.indexed ? Containers::arrayView(indices) : nullptr,
+        data.indexed ? MeshIndexData{Containers::ArrayView<const UnsignedInt>{indices}} : MeshIndexData{},
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position,
+            Containers::arrayView(positions)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("StanfordSceneConverter");
+    if(data.endianness)
+        converter->configuration().setValue("endianness", data.endianness);
+    converter->configuration().setValue("ascii", data.ascii);
+
+    /* The file output should be the same as when converting to data */
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(mesh);
+    CORRADE_VERIFY(out);
+    const Containers::String filename = Utility::Path::join(STANFORDSCENECONVERTER_TEST_OUTPUT_DIR, "chunked.ply");
+    CORRADE_VERIFY(converter->convertToFile(mesh, filename));
+    CORRADE_COMPARE_AS(Containers::StringView{*out},
+        filename,
+        TestSuite::Compare::StringToFile);
+
+    if(_importerManager.loadState("StanfordImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StanfordImporter plugin not found, cannot test a roundtrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StanfordImporter");
+    CORRADE_VERIFY(importer->openFile(filename));
+
+    Containers::Optional<MeshData> importedMesh = importer->mesh(0);
+    CORRADE_VERIFY(importedMesh);
+    CORRADE_VERIFY(importedMesh->isIndexed());
+    CORRADE_COMPARE(importedMesh->indexType(), MeshIndexType::UnsignedInt);
+    CORRADE_COMPARE_AS(importedMesh->indices<UnsignedInt>(),
+        Containers::arrayView(indices),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(importedMesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView(positions),
+        TestSuite::Compare::Container);
+}
+
+void StanfordSceneConverterTest::toFileFailed() {
+    const Vector3 positions[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position,
+            Containers::arrayView(positions)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("StanfordSceneConverter");
+
+    /* Writing to a directory fails */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToFile(mesh, STANFORDSCENECONVERTER_TEST_OUTPUT_DIR));
+    CORRADE_COMPARE_AS(out.str(),
+        Utility::formatString("Trade::StanfordSceneConverter::convertToFile(): cannot write to file {}\n", STANFORDSCENECONVERTER_TEST_OUTPUT_DIR),
+        TestSuite::Compare::StringHasSuffix);
+}
+
 void StanfordSceneConverterTest::lines() {
     Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("StanfordSceneConverter");
 
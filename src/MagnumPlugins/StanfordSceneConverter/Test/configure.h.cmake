@@ -26,3 +26,4 @@
 #cmakedefine STANFORDSCENECONVERTER_PLUGIN_FILENAME "${STANFORDSCENECONVERTER_PLUGIN_FILENAME}"
 #cmakedefine STANFORDIMPORTER_PLUGIN_FILENAME "${STANFORDIMPORTER_PLUGIN_FILENAME}"
 #define STANFORDSCENECONVERTER_TEST_DIR "${STANFORDSCENECONVERTER_TEST_DIR}"
+#define STANFORDSCENECONVERTER_TEST_OUTPUT_DIR "${STANFORDSCENECONVERTER_TEST_OUTPUT_DIR}"
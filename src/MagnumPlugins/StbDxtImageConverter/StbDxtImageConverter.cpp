@@ -25,15 +25,22 @@
 
 #include "StbDxtImageConverter.h"
 
+#include <thread>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
-#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <atomic>
+#endif
+
 #define STB_DXT_IMPLEMENTATION
 /* LOL the thing doesn't #include <string.h> on its own, wtf */
 #include <cstring>
@@ -111,32 +118,70 @@ Containers::Optional<ImageData3D> convertInternal(const ImageView3D& image, Util
          outputBlockSize}
     };
 
-    /* Prepare destination where to copy linearized input data. If the alpha is
-       missing in the input, fill it to 255. */
-    UnsignedByte inputBlockData[16*4];
-    if(inputChannelCount == 3) {
-        /* Utility::copy() would work but be a lot more painful in this case */
-        for(std::size_t i = 0; i != sizeof(inputBlockData); i += 4)
-            inputBlockData[i + 3] = 255;
-    }
-    const Containers::StridedArrayView3D<UnsignedByte> inputBlock{inputBlockData, {4, 4, inputChannelCount}, {4*4, 4, 1}};
-
-    /* Go through all blocks in the input file, linearize and compress them */
-    for(std::size_t z = 0, zMax = input.size()[0]; z != zMax; ++z) {
-        const Containers::StridedArrayView3D<const UnsignedByte> inputLayer = input[z];
-        const Containers::StridedArrayView3D<UnsignedByte> outputLayer = output[z];
-        for(std::size_t y = 0, yMax = input.size()[1]/4; y < yMax; ++y) {
-            const Containers::StridedArrayView2D<UnsignedByte> outputRow = outputLayer[y];
+    /* Pixels in image rows are always tightly packed, so the 4x4 blocks can be
+       gathered with plain memory copies instead of a strided copy */
+    CORRADE_INTERNAL_ASSERT(input.isContiguous<2>());
+
+    /* Each row of blocks is independent, so the rows can be compressed on
+       multiple threads, each picking the next uncompressed one */
+    const std::size_t blockRowsPerLayer = input.size()[1]/4;
+    const std::size_t blockRowCount = input.size()[0]*blockRowsPerLayer;
+    std::size_t threadCount = 1;
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    threadCount = configuration.value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = Math::max(Math::min(threadCount, blockRowCount), std::size_t{1});
+    std::atomic<std::size_t> next{0};
+    #else
+    std::size_t next = 0;
+    #endif
+    const auto compress = [&]() {
+        /* Prepare destination where to copy linearized input data. If the
+           alpha is missing in the input, fill it to 255. */
+        UnsignedByte inputBlockData[16*4];
+        if(inputChannelCount == 3) {
+            for(std::size_t i = 0; i != sizeof(inputBlockData); i += 4)
+                inputBlockData[i + 3] = 255;
+        }
+
+        for(std::size_t i; (i = next++) < blockRowCount; ) {
+            const std::size_t z = i/blockRowsPerLayer;
+            const std::size_t y = i % blockRowsPerLayer;
+            const Containers::StridedArrayView3D<const UnsignedByte> inputLayer = input[z];
+            const Containers::StridedArrayView2D<UnsignedByte> outputRow = output[z][y];
             for(std::size_t x = 0, xMax = input.size()[2]/4; x < xMax; ++x) {
-                /* If the alpha is missing, it'll copy only the RGB values into
-                   the destination */
-                Utility::copy(inputLayer.slice({4*y, 4*x, 0}, {4*y + 4, 4*x + 4, inputChannelCount}), inputBlock);
+                for(std::size_t row = 0; row != 4; ++row) {
+                    const UnsignedByte* const src = &inputLayer[4*y + row][4*x][0];
+                    UnsignedByte* const dst = inputBlockData + row*16;
+                    /* RGBA rows are copied as a whole, RGB rows get expanded
+                       with the alpha staying 255. Fixed-size loops that the
+                       compiler can unroll and vectorize. */
+                    if(inputChannelCount == 4)
+                        std::memcpy(dst, src, 16);
+                    else for(std::size_t pixel = 0; pixel != 4; ++pixel) {
+                        dst[pixel*4 + 0] = src[pixel*3 + 0];
+                        dst[pixel*4 + 1] = src[pixel*3 + 1];
+                        dst[pixel*4 + 2] = src[pixel*3 + 2];
+                    }
+                }
 
                 /* Compress the block */
                 stb_compress_dxt_block(&outputRow[x][0], inputBlockData, alpha, flags);
             }
         }
-    }
+    };
+
+    /* The calling thread is one of the workers */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{compress};
+    compress();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    compress();
+    #endif
 
     return ImageData3D{outputFormat, image.size(), Utility::move(outputData), image.flags()};
 }
@@ -144,6 +189,7 @@ Containers::Optional<ImageData3D> convertInternal(const ImageView3D& image, Util
 }
 
 Containers::Optional<ImageData2D> StbDxtImageConverter::doConvert(const ImageView2D& image) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvert"};
     if(image.flags() & ImageFlag2D::Array) {
         Error{} << "Trade::StbDxtImageConverter::convert(): 1D array images are not supported";
         return {};
@@ -158,6 +204,7 @@ Containers::Optional<ImageData2D> StbDxtImageConverter::doConvert(const ImageVie
 }
 
 Containers::Optional<ImageData3D> StbDxtImageConverter::doConvert(const ImageView3D& image) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvert"};
     return convertInternal(image, configuration());
 }
 
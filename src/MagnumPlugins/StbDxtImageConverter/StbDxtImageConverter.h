@@ -137,6 +137,13 @@ dimension. If your image doesn't fit this requirement, you have to pad/crop or
 resample it first. Since 3D images are compressed slice-by-slice, there's no
 restriction on the Z dimension.
 
+Each row of 4x4 blocks is compressed independently. Setting the
+@cb{.ini} threads @ce option to a value other than @cpp 1 @ce compresses the
+rows on multiple threads, across all slices of 3D images. The output is the
+same regardless of the thread count. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+application has to be linked to `pthread` on Linux for this to work.
+
 Unlike image converters dealing with uncompressed pixel formats, the image
 * *isn't* Y-flipped on export due to the nontrivial amount of work involved
 with Y-flipping block-compressed data. This is in line with importers of
@@ -50,6 +50,7 @@ struct StbDxtImageConverterTest: TestSuite::Tester {
 
     void rgba();
     void threeDimensions();
+    void threads();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
@@ -88,6 +89,19 @@ const struct {
         CompressedPixelFormat::Bc3RGBAUnorm, "ship.bc3"},
 };
 
+const struct {
+    const char* name;
+    Int channelCount;
+    UnsignedInt threads;
+    bool threeDimensions;
+    const char* expectedFile;
+} ThreadsData[] {
+    {"RGBA, two threads", 4, 2, false, "ship.bc3"},
+    {"RGB, all threads", 3, 0, false, "ship.bc1"},
+    {"RGB, more threads than block rows", 3, 64, false, "ship.bc1"},
+    {"RGB, 3D, five threads", 3, 5, true, "ship.bc1"},
+};
+
 StbDxtImageConverterTest::StbDxtImageConverterTest() {
     addTests({&StbDxtImageConverterTest::unsupportedFormat,
               &StbDxtImageConverterTest::unsupportedSize,
@@ -99,6 +113,9 @@ StbDxtImageConverterTest::StbDxtImageConverterTest() {
 
     addTests({&StbDxtImageConverterTest::threeDimensions});
 
+    addInstancedTests({&StbDxtImageConverterTest::threads},
+        Containers::arraySize(ThreadsData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef STBDXTIMAGECONVERTER_PLUGIN_FILENAME
@@ -222,6 +239,36 @@ void StbDxtImageConverterTest::threeDimensions() {
         TestSuite::Compare::StringToFile);
 }
 
+void StbDxtImageConverterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StbImageImporter");
+    importer->configuration().setValue("forceChannelCount", data.channelCount);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBDXTIMAGECONVERTER_TEST_DIR, "ship.jpg")));
+    Containers::Optional<Trade::ImageData2D> uncompressed = importer->image2D(0);
+    CORRADE_VERIFY(uncompressed);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("StbDxtImageConverter");
+    converter->configuration().setValue("threads", data.threads);
+
+    /* The output should be the same regardless of the thread count. The 3D
+       variant is cut into slices like in threeDimensions(), with the rows
+       distributed across the slices. */
+    Containers::Optional<Trade::ImageData3D> compressed = converter->convert(data.threeDimensions ?
+        ImageView3D{uncompressed->format(), {160, 32, 3}, uncompressed->data(), ImageFlag3D::Array} :
+        ImageView3D{ImageView2D{*uncompressed}});
+    CORRADE_VERIFY(compressed);
+
+    /** @todo Compare::DataToFile */
+    CORRADE_COMPARE_AS(Containers::StringView{compressed->data()},
+        Utility::Path::join(STBDXTIMAGECONVERTER_TEST_DIR, data.expectedFile),
+        TestSuite::Compare::StringToFile);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::StbDxtImageConverterTest)
@@ -29,6 +29,7 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StaticArray.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
@@ -37,6 +38,9 @@
 
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
+
+#include "Magnum/Implementation/instrumentation.h"
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #define STBI_ASSERT CORRADE_INTERNAL_ASSERT
@@ -47,6 +51,211 @@ namespace Magnum { namespace Trade {
 
 using namespace Containers::Literals;
 
+namespace {
+
+/* A minimal PNG encoder trading compression ratio for speed, used with the
+   pngFastEncoding option. Compared to stbi_write_png_to_func(), which tries
+   all five filters on every row and does lazy matching over hash chains, this
+   uses a fixed filter, a single-entry hash table with greedy matching and
+   the fixed Huffman table, i.e. the same tradeoffs as fpng or the fastest
+   zlib levels. */
+
+struct BitWriter {
+    explicit BitWriter(char* out): out{out} {}
+
+    void put(UnsignedInt bits, UnsignedInt count) {
+        buffer |= UnsignedLong(bits) << bitCount;
+        bitCount += count;
+        while(bitCount >= 8) {
+            *out++ = char(buffer);
+            buffer >>= 8;
+            bitCount -= 8;
+        }
+    }
+
+    /* Huffman codes are stored MSB first, everything else LSB first */
+    void putReversed(UnsignedInt code, UnsignedInt count) {
+        UnsignedInt reversed = 0;
+        for(UnsignedInt i = 0; i != count; ++i)
+            reversed |= ((code >> i) & 1) << (count - i - 1);
+        put(reversed, count);
+    }
+
+    void flush() {
+        if(bitCount) put(0, 8 - bitCount);
+    }
+
+    char* out;
+    UnsignedLong buffer = 0;
+    UnsignedInt bitCount = 0;
+};
+
+void putLiteralLength(BitWriter& writer, UnsignedInt symbol) {
+    if(symbol <= 143) writer.putReversed(0x30 + symbol, 8);
+    else if(symbol <= 255) writer.putReversed(0x190 + symbol - 144, 9);
+    else if(symbol <= 279) writer.putReversed(symbol - 256, 7);
+    else writer.putReversed(0xc0 + symbol - 280, 8);
+}
+
+void putMatch(BitWriter& writer, UnsignedInt length, UnsignedInt distance) {
+    /* Length code, RFC 1951 section 3.2.5 */
+    if(length <= 10) putLiteralLength(writer, 257 + length - 3);
+    else if(length == 258) putLiteralLength(writer, 285);
+    else {
+        const UnsignedInt value = length - 3;
+        const UnsignedInt log = Math::log2(value);
+        putLiteralLength(writer, 257 + 4*(log - 1) + ((value >> (log - 2)) & 3));
+        writer.put(value & ((1 << (log - 2)) - 1), log - 2);
+    }
+
+    /* Distance code, fixed 5-bit Huffman codes */
+    if(distance <= 4) writer.putReversed(distance - 1, 5);
+    else {
+        const UnsignedInt value = distance - 1;
+        const UnsignedInt log = Math::log2(value);
+        writer.putReversed(2*log + ((value >> (log - 1)) & 1), 5);
+        writer.put(value & ((1 << (log - 1)) - 1), log - 1);
+    }
+}
+
+char* writeBigEndian(char* const out, const UnsignedInt value) {
+    out[0] = char(value >> 24);
+    out[1] = char(value >> 16);
+    out[2] = char(value >> 8);
+    out[3] = char(value);
+    return out + 4;
+}
+
+/* Returns one past the end of the written zlib stream */
+char* zlibCompressFast(const Containers::ArrayView<const UnsignedByte> data, char* const out) {
+    BitWriter writer{out};
+    writer.put(0x78, 8);    /* Deflate, 32K window */
+    writer.put(0x01, 8);    /* Fastest compression level, FCHECK */
+    writer.put(1, 1);       /* BFINAL */
+    writer.put(1, 2);       /* BTYPE = fixed Huffman */
+
+    /* Single-entry hash table of last positions of each three-byte sequence,
+       with 0 meaning "nothing" and positions stored off-by-one */
+    constexpr UnsignedInt HashBits = 15;
+    Containers::Array<UnsignedInt> hashTable{ValueInit, 1 << HashBits};
+
+    const std::size_t size = data.size();
+    std::size_t i = 0;
+    while(i + 3 <= size) {
+        const UnsignedInt sequence = data[i] | data[i + 1] << 8 | data[i + 2] << 16;
+        const UnsignedInt hash = (sequence*2654435761u) >> (32 - HashBits);
+        const std::size_t candidate = hashTable[hash];
+        hashTable[hash] = UnsignedInt(i + 1);
+
+        if(candidate && i + 1 - candidate <= 32768 &&
+           data[candidate - 1] == data[i] &&
+           data[candidate] == data[i + 1] &&
+           data[candidate + 1] == data[i + 2])
+        {
+            const std::size_t maxLength = Math::min(size - i, std::size_t{258});
+            std::size_t length = 3;
+            while(length < maxLength && data[candidate - 1 + length] == data[i + length])
+                ++length;
+            putMatch(writer, UnsignedInt(length), UnsignedInt(i + 1 - candidate));
+            i += length;
+        } else putLiteralLength(writer, data[i++]);
+    }
+    for(; i < size; ++i)
+        putLiteralLength(writer, data[i]);
+    putLiteralLength(writer, 256); /* End of block */
+    writer.flush();
+
+    /* Adler-32, big-endian */
+    UnsignedInt a = 1, b = 0;
+    for(std::size_t j = 0; j < size; ) {
+        const std::size_t end = Math::min(size, j + 5552);
+        for(; j != end; ++j) {
+            a += data[j];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return writeBigEndian(writer.out, b << 16 | a);
+}
+
+UnsignedInt crc32(const char* const data, const std::size_t size) {
+    static const Containers::StaticArray<256, UnsignedInt> table = []{
+        Containers::StaticArray<256, UnsignedInt> table{ValueInit};
+        for(UnsignedInt i = 0; i != 256; ++i) {
+            UnsignedInt c = i;
+            for(std::size_t j = 0; j != 8; ++j)
+                c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        return table;
+    }();
+
+    UnsignedInt crc = ~0u;
+    for(std::size_t i = 0; i != size; ++i)
+        crc = table[(crc ^ UnsignedByte(data[i])) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+/* Writes a chunk header, expects the payload to be already written after it,
+   appends a CRC and returns one past the end of the chunk */
+char* finishChunk(char* const chunk, const char* const type, const UnsignedInt size) {
+    writeBigEndian(chunk, size);
+    Utility::copy(Containers::arrayView(type, 4), Containers::arrayView(chunk + 4, 4));
+    return writeBigEndian(chunk + 8 + size, crc32(chunk + 4, size + 4));
+}
+
+void writePngFast(Containers::Array<char>& out, const Containers::ArrayView<const char> pixels, const Vector2i& size, const Int components) {
+    /* Apply the Up filter on all rows except the first, which uses Sub. Both
+       are a plain byte-wise subtraction that the compiler can vectorize, as
+       opposed to the adaptive per-row filter selection. */
+    const std::size_t rowSize = size.x()*components;
+    Containers::Array<UnsignedByte> filtered{NoInit, (rowSize + 1)*size.y()};
+    for(std::size_t y = 0; y != std::size_t(size.y()); ++y) {
+        const UnsignedByte* const row = reinterpret_cast<const UnsignedByte*>(pixels.data()) + y*rowSize;
+        UnsignedByte* const filteredRow = filtered.data() + y*(rowSize + 1);
+        if(y == 0) {
+            filteredRow[0] = 1;
+            for(std::size_t i = 0; i != std::size_t(components); ++i)
+                filteredRow[1 + i] = row[i];
+            for(std::size_t i = components; i != rowSize; ++i)
+                filteredRow[1 + i] = row[i] - row[i - components];
+        } else {
+            filteredRow[0] = 2;
+            const UnsignedByte* const previousRow = row - rowSize;
+            for(std::size_t i = 0; i != rowSize; ++i)
+                filteredRow[1 + i] = row[i] - previousRow[i];
+        }
+    }
+
+    /* Worst case is every byte encoded as a 9-bit literal. Matches are never
+       longer than the literals they replace. */
+    const std::size_t zlibBound = 2 + (filtered.size()*9 + 7 + 3 + 7)/8 + 4;
+    const std::size_t bound = 8 + (12 + 13) + (12 + zlibBound) + 12;
+    char* const begin = arrayAppend(out, NoInit, bound).data();
+
+    constexpr const char Signature[]{'\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n'};
+    Utility::copy(Containers::arrayView(Signature), Containers::arrayView(begin, 8));
+
+    char* const header = begin + 8;
+    char* const headerData = writeBigEndian(writeBigEndian(header + 8, size.x()), size.y());
+    constexpr const char ColorTypes[]{0, 4, 2, 6};
+    headerData[0] = 8;                          /* Bit depth */
+    headerData[1] = ColorTypes[components - 1];
+    headerData[2] = 0;                          /* Deflate */
+    headerData[3] = 0;                          /* Adaptive filtering */
+    headerData[4] = 0;                          /* No interlace */
+    char* const data = finishChunk(header, "IHDR", 13);
+
+    char* const dataEnd = zlibCompressFast(filtered, data + 8);
+    char* const end = finishChunk(data, "IDAT", UnsignedInt(dataEnd - data - 8));
+
+    char* const finalEnd = finishChunk(end, "IEND", 0);
+    arrayRemoveSuffix(out, begin + bound - finalEnd);
+}
+
+}
+
 StbImageConverter::StbImageConverter(Format format): _format{format} {
     /* Passing an invalid Format enum is user error, we'll assert on that in
        the convertToData() function */
@@ -96,6 +305,7 @@ Containers::String StbImageConverter::doMimeType() const {
 }
 
 Containers::Optional<Containers::Array<char>> StbImageConverter::doConvertToData(const ImageView2D& image) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
     if(_format == Format{}) {
         Error{} << "Trade::StbImageConverter::convertToData(): cannot determine output format (plugin loaded as" << plugin() << Error::nospace << ", use one of the Stb{Bmp,Hdr,Jpeg,Png,Tga}ImageConverter aliases)";
         return {};
@@ -173,7 +383,10 @@ Containers::Optional<Containers::Array<char>> StbImageConverter::doConvertToData
     } else if(_format == Format::Hdr) {
         CORRADE_INTERNAL_ASSERT_OUTPUT(stbi_write_hdr_to_func(writeFunc, &data, image.size().x(), image.size().y(), components, reinterpret_cast<float*>(flippedPackedData.begin())));
     } else if(_format == Format::Png) {
-        CORRADE_INTERNAL_ASSERT_OUTPUT(stbi_write_png_to_func(writeFunc, &data, image.size().x(), image.size().y(), components, flippedPackedData, 0));
+        if(configuration().value<bool>("pngFastEncoding"))
+            writePngFast(data, flippedPackedData, image.size(), components);
+        else
+            CORRADE_INTERNAL_ASSERT_OUTPUT(stbi_write_png_to_func(writeFunc, &data, image.size().x(), image.size().y(), components, flippedPackedData, 0));
     } else if(_format == Format::Tga) {
         CORRADE_INTERNAL_ASSERT_OUTPUT(stbi_write_tga_to_func(writeFunc, &data, image.size().x(), image.size().y(), components, flippedPackedData));
     } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
@@ -187,6 +400,7 @@ Containers::Optional<Containers::Array<char>> StbImageConverter::doConvertToData
 }
 
 bool StbImageConverter::doConvertToFile(const ImageView2D& image, const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToFile", filename};
     /* We don't detect any double extensions yet, so we can normalize just the
        extension. In case we eventually might, it'd have to be split() instead
        to save at least by normalizing just the filename and not the path. */
@@ -204,6 +204,20 @@ implemented neither in stb_image_write nor in stb_image.
 Conversion to 16-bit PNGs is not supported. Use @ref PngImageConverter instead
 if you need to deal with 16-bit pixel formats.
 
+@subsection Trade-StbImageConverter-behavior-fast-png Fast PNG encoding
+
+The PNG encoder in `stb_image_write` picks the best of five filters for every
+row and compresses the result with lazy matching over hash chains, which is
+rather slow for large images. Enabling the @cb{.ini} pngFastEncoding @ce
+@ref Trade-StbImageConverter-configuration "configuration option" switches to
+a built-in encoder that applies the Sub filter on the first row and the Up
+filter on all others, and compresses with greedy matching using a
+single-entry hash table and the fixed Huffman table, similarly to
+[fpng](https://github.com/richgel999/fpng) or the fastest zlib compression
+levels. It's usually an order of magnitude faster, at the cost of the output
+being larger, which makes it suitable for example for saving screenshots. The
+output is a regular PNG file readable by any decoder.
+
 @subsection Trade-StbImageConverter-behavior-tga-rle RLE encoding of TGA files
 
 TGA files produced by @ref TgaImageConverter are often slightly smaller than
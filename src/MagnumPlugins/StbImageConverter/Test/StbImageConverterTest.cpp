@@ -69,6 +69,7 @@ struct StbImageConverterTest: TestSuite::Tester {
 
     void pngRgb();
     void pngGrayscale();
+    void pngFastEncoding();
 
     void tgaRgba();
 
@@ -117,6 +118,17 @@ const struct {
         nullptr},
 };
 
+const struct {
+    const char* name;
+    PixelFormat format;
+    Vector2i size;
+} PngFastEncodingData[]{
+    {"R8, single pixel", PixelFormat::R8Unorm, {1, 1}},
+    {"RG8", PixelFormat::RG8Unorm, {37, 19}},
+    {"RGB8", PixelFormat::RGB8Unorm, {256, 173}},
+    {"RGBA8", PixelFormat::RGBA8Unorm, {512, 128}},
+};
+
 StbImageConverterTest::StbImageConverterTest() {
     addTests({&StbImageConverterTest::wrongFormat,
               &StbImageConverterTest::wrongFormatHdr,
@@ -145,8 +157,12 @@ StbImageConverterTest::StbImageConverterTest() {
     addTests({&StbImageConverterTest::jpegGrayscale80Percent,
 
               &StbImageConverterTest::pngRgb,
-              &StbImageConverterTest::pngGrayscale,
+              &StbImageConverterTest::pngGrayscale});
+
+    addInstancedTests({&StbImageConverterTest::pngFastEncoding},
+        Containers::arraySize(PngFastEncodingData));
 
+    addTests({
               &StbImageConverterTest::tgaRgba});
 
     addInstancedTests({&StbImageConverterTest::convertToFile},
@@ -735,6 +751,45 @@ void StbImageConverterTest::pngGrayscale() {
         TestSuite::Compare::Container);
 }
 
+void StbImageConverterTest::pngFastEncoding() {
+    auto&& data = PngFastEncodingData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* A gradient with a noisy part to exercise both long matches and
+       literals, with a row stride that isn't four-byte aligned */
+    const std::size_t pixelSize = pixelFormatSize(data.format);
+    Containers::Array<char> pixels{NoInit, pixelSize*data.size.product()};
+    UnsignedInt seed = 1;
+    for(std::size_t y = 0; y != std::size_t(data.size.y()); ++y) {
+        for(std::size_t x = 0; x != std::size_t(data.size.x()); ++x) {
+            for(std::size_t i = 0; i != pixelSize; ++i) {
+                seed = seed*1103515245 + 12345;
+                pixels[(y*data.size.x() + x)*pixelSize + i] = char((x*3 + y*7 + i*50)/5 + (x > std::size_t(data.size.x()/2) ? seed >> 24 : 0));
+            }
+        }
+    }
+    const ImageView2D image{PixelStorage{}.setAlignment(1), data.format, data.size, pixels};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("StbPngImageConverter");
+    converter->configuration().setValue("pngFastEncoding", true);
+
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(image);
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE_AS(*out, "\x89PNG\x0d\x0a\x1a\x0a"_s,
+        TestSuite::Compare::StringHasPrefix);
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StbImageImporter");
+    CORRADE_VERIFY(importer->openData(*out));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->size(), data.size);
+    CORRADE_COMPARE(converted->format(), data.format);
+    CORRADE_COMPARE_AS(*converted, image, DebugTools::CompareImage);
+}
+
 constexpr const char OriginalRgbaData[] = {
     0, 0, 0, 0, 0, 0, 0, 0, /* Skip */
 
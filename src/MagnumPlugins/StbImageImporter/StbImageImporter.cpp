@@ -25,6 +25,7 @@
 
 #include "StbImageImporter.h"
 
+#include <cstring>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Utility/Algorithms.h>
@@ -33,6 +34,8 @@
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
 #define STBI_NO_STDIO
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_STATIC
@@ -46,7 +49,47 @@
 #define STBI_THREAD_LOCAL CORRADE_THREAD_LOCAL
 #endif
 
-/* Not defining malloc/free, because there's no equivalent for realloc in C++ */
+/* Allocating with new[] so the decoded data can be taken over by an Array
+   with a default deleter, without having to copy it. A custom deleter calling
+   stbi_image_free() would be a dangling function pointer call if the plugin
+   got unloaded sooner than the array is deleted. As there's no realloc
+   equivalent in C++, it's emulated with an allocation and a copy. */
+namespace {
+
+void* stbiMalloc(const std::size_t size) {
+    return new char[size];
+}
+
+void* stbiRealloc(void* const data, const std::size_t oldSize, const std::size_t newSize) {
+    char* const out = new char[newSize];
+    if(data) {
+        std::memcpy(out, data, oldSize < newSize ? oldSize : newSize);
+        delete[] static_cast<char*>(data);
+    }
+    return out;
+}
+
+void stbiFree(void* const data) {
+    delete[] static_cast<char*>(data);
+}
+
+}
+
+#define STBI_MALLOC(size) stbiMalloc(size)
+#define STBI_REALLOC_SIZED(data, oldSize, newSize) stbiRealloc(data, oldSize, newSize)
+/* The unsized variant is used only when appending animated GIF frames and
+   their delays, where both reallocations grow the array by exactly one item.
+   The `layers` variable is the already-incremented frame count at both call
+   sites, if stb_image changes that, this fails to compile. */
+#define STBI_REALLOC(data, newSize) stbiRealloc(data, (newSize)/layers*(layers - 1), newSize)
+#define STBI_FREE(data) stbiFree(data)
+
+/* SSE2 is enabled by stb_image itself on all x86 targets except 32-bit
+   MinGW, NEON has to be enabled explicitly */
+#ifdef CORRADE_TARGET_NEON
+#define STBI_NEON
+#endif
+
 #include "stb_image.h"
 
 namespace Magnum { namespace Trade {
@@ -78,6 +121,7 @@ void StbImageImporter::doClose() {
 }
 
 void StbImageImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     /* Because here we're copying the data and using the _in to check if file
        is opened, having them nullptr would mean openData() would fail without
        any error message. It's not possible to do this check on the importer
@@ -123,8 +167,7 @@ void StbImageImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
             _in->gifDelays = Containers::Array<int>{delays, std::size_t(size.z()),
                 [](int* data, std::size_t) { stbi_image_free(data); }};
             _in->data = Containers::Array<char>{reinterpret_cast<char*>(gifData),
-                std::size_t(size.product()*components),
-                [](char* data, std::size_t) { stbi_image_free(data); }};
+                std::size_t(size.product()*components)};
 
             /* Save size, decide on frame stride. stb_image says that for GIF
                the result is always four-channel, so take a shortcut and report
@@ -157,6 +200,7 @@ UnsignedInt StbImageImporter::doImage2DCount() const {
 }
 
 Containers::Optional<ImageData2D> StbImageImporter::doImage2D(const UnsignedInt id, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D", {}, id};
     /* This is a GIF that was loaded already during data opening. Return Nth
        image */
     if(!_in->gifSize.isZero()) {
@@ -238,12 +282,9 @@ Containers::Optional<ImageData2D> StbImageImporter::doImage2D(const UnsignedInt
         return Containers::NullOpt;
     }
 
-    /* Copy the data into array with default deleter and free the original (we
-       can't use custom deleter to avoid dangling function pointer call when
-       the plugin is unloaded sooner than the array is deleted) */
-    Containers::Array<char> imageData{std::size_t(size.product()*components*channelSize)};
-    Utility::copy(Containers::arrayView(reinterpret_cast<char*>(data), imageData.size()), imageData);
-    stbi_image_free(data);
+    /* The data are allocated with new[], so take over them directly with a
+       default deleter, for 8-bit, 16-bit and HDR images alike */
+    Containers::Array<char> imageData{reinterpret_cast<char*>(data), std::size_t(size.product()*components*channelSize)};
 
     /* Adjust pixel storage if row size is not four byte aligned */
     PixelStorage storage;
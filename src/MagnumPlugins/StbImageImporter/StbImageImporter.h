@@ -156,6 +156,19 @@ The importer is thread-safe if Corrade and Magnum is compiled with
 @ref CORRADE_BUILD_MULTITHREADED enabled. The importer recognizes
 @ref ImporterFlag::Verbose, printing additional info when the flag is enabled.
 
+@subsection Trade-StbImageImporter-behavior-performance Performance
+
+The SSE2 paths of stb_image are used on all x86 targets except 32-bit MinGW,
+where they're disabled by stb_image itself due to stack alignment issues. The
+NEON paths are enabled if @ref CORRADE_TARGET_NEON is defined. In both cases
+they accelerate only JPEG decoding, in particular the IDCT and YCbCr to RGB
+conversion. For a faster decoding of other formats, use the dedicated
+importers such as @ref PngImporter or @ref JpegImporter.
+
+The decoded data are passed to the returned @ref ImageData directly without
+any extra copy, including 16-bit and HDR images and conversions to a different
+bit depth or channel count.
+
 @subsection Trade-StbImageImporter-behavior-bmp BMP support
 
 1bpp and RLE files are not supported.
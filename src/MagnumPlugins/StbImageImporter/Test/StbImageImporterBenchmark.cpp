@@ -0,0 +1,108 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+/* Compares decoding speed of stb_image with the dedicated PNG and JPEG
+   importers on the same files. The dedicated importers are optional, the
+   cases get skipped if they're not built. */
+struct StbImageImporterBenchmark: TestSuite::Tester {
+    explicit StbImageImporterBenchmark();
+
+    void image();
+
+    private:
+        /* Explicitly forbid system-wide plugin dependencies */
+        PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+};
+
+const struct {
+    const char* name;
+    const char* plugin;
+    const char* filename;
+    Int forceBitDepth;
+} FileData[]{
+    {"PNG, StbImageImporter", "StbImageImporter", PNGIMPORTER_TEST_DIR "/rgb.png", 0},
+    {"PNG, PngImporter", "PngImporter", PNGIMPORTER_TEST_DIR "/rgb.png", 0},
+    {"PNG 16-bit, StbImageImporter", "StbImageImporter", PNGIMPORTER_TEST_DIR "/rgb16.png", 0},
+    {"PNG 16-bit, PngImporter", "PngImporter", PNGIMPORTER_TEST_DIR "/rgb16.png", 0},
+    {"PNG, StbImageImporter, expanded to 32-bit", "StbImageImporter", PNGIMPORTER_TEST_DIR "/rgb.png", 32},
+    {"JPEG, StbImageImporter", "StbImageImporter", JPEGIMPORTER_TEST_DIR "/rgb.jpg", 0},
+    {"JPEG, JpegImporter", "JpegImporter", JPEGIMPORTER_TEST_DIR "/rgb.jpg", 0},
+    {"HDR, StbImageImporter", "StbImageImporter", STBIMAGEIMPORTER_TEST_DIR "/rgb.hdr", 0},
+};
+
+StbImageImporterBenchmark::StbImageImporterBenchmark() {
+    addInstancedBenchmarks({&StbImageImporterBenchmark::image}, 10,
+        Containers::arraySize(FileData));
+
+    /* Load the plugins directly from the build tree. Otherwise they're either
+       static and already loaded or not present in the build tree */
+    #ifdef STBIMAGEIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(STBIMAGEIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef PNGIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(PNGIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef JPEGIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(JPEGIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void StbImageImporterBenchmark::image() {
+    auto&& data = FileData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState(data.plugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.plugin << "plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate(data.plugin);
+    if(data.forceBitDepth)
+        importer->configuration().setValue("forceBitDepth", data.forceBitDepth);
+    CORRADE_VERIFY(importer->openFile(data.filename));
+
+    std::size_t imported = 0;
+    CORRADE_BENCHMARK(100) {
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+        imported += image ? 1 : 0;
+    }
+
+    CORRADE_COMPARE(imported, 100);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::StbImageImporterBenchmark)
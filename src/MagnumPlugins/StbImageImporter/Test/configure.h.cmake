@@ -24,6 +24,8 @@
 */
 
 #cmakedefine STBIMAGEIMPORTER_PLUGIN_FILENAME "${STBIMAGEIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine PNGIMPORTER_PLUGIN_FILENAME "${PNGIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine JPEGIMPORTER_PLUGIN_FILENAME "${JPEGIMPORTER_PLUGIN_FILENAME}"
 #define PNGIMPORTER_TEST_DIR "${PNGIMPORTER_TEST_DIR}"
 #define JPEGIMPORTER_TEST_DIR "${JPEGIMPORTER_TEST_DIR}"
 #define STBIMAGEIMPORTER_TEST_DIR "${STBIMAGEIMPORTER_TEST_DIR}"
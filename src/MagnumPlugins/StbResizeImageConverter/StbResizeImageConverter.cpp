@@ -1,30 +1,7 @@
-/*
-    This file is part of Magnum.
-
-    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
-                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
-
-    Permission is hereby granted, free of charge, to any person obtaining a
-    copy of this software and associated documentation files (the "Software"),
-    to deal in the Software without restriction, including without limitation
-    the rights to use, copy, modify, merge, publish, distribute, sublicense,
-    and/or sell copies of the Software, and to permit persons to whom the
-    Software is furnished to do so, subject to the following conditions:
-
-    The above copyright notice and this permission notice shall be included
-    in all copies or substantial portions of the Software.
-
-    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
-    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
-    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
-    DEALINGS IN THE SOFTWARE.
-*/
-
 #include "StbResizeImageConverter.h"
 
+#include <thread>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
@@ -32,10 +9,38 @@
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <atomic>
+#endif
+
+namespace Magnum { namespace Trade { namespace {
+
+/* stb_image_resize allocates a single block of temporary memory for every
+   resized image. Instead of going through malloc() and free() for every layer
+   and level, each thread passes its own instance of this struct as the
+   allocation context, which keeps the largest block for the next call. */
+struct StbirAllocator {
+    Containers::Array<char> memory;
+};
+
+void* stbirMalloc(const std::size_t size, void* const context) {
+    Containers::Array<char>& memory = static_cast<StbirAllocator*>(context)->memory;
+    if(memory.size() < size)
+        memory = Containers::Array<char>{NoInit, size};
+    return memory.data();
+}
+
+}}}
+
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 #define STBIR_MAX_CHANNELS 4 /* 64 is the default, no need for that many */
+#define STBIR_MALLOC(size, context) Magnum::Trade::stbirMalloc(size, context)
+#define STBIR_FREE(ptr, context) (static_cast<void>(ptr), static_cast<void>(context))
 #include "stb_image_resize.h"
 
 namespace Magnum { namespace Trade {
@@ -50,103 +55,209 @@ ImageConverterFeatures StbResizeImageConverter::doFeatures() const {
 
 namespace {
 
-Containers::Optional<ImageData3D> convertInternal(const ImageView3D& image, Utility::ConfigurationGroup& configuration) {
+struct Parameters {
+    stbir_datatype type;
+    Int channelCount;
+    Int alphaChannelIndex;
+    Int flags;
+    stbir_edge edge;
+    stbir_filter filter;
+    stbir_colorspace colorspace;
+};
+
+Containers::Optional<Parameters> parseParameters(const ImageView3D& image, Utility::ConfigurationGroup& configuration, const char* const messagePrefix) {
     /* Image has to be non-empty, otherwise we hit an assertion deep in the
        algorithm. Overriding STBIR_ASSERT() would help neither making the
        failure graceful nor having a human-readable message. */
     if(!image.size().product()) {
-        Error{} << "Trade::StbResizeImageConverter::convert(): invalid input image size" << Debug::packed << image.size().xy();
-        return {};
-    }
-
-    /* Target output size. The final output size depends on wheter upscaling is
-       disabled. */
-    if(!configuration.value<Containers::StringView>("size")) {
-        Error{} << "Trade::StbResizeImageConverter::convert(): output size was not specified";
-        return {};
-    }
-    const Vector2i targetSize = configuration.value<Vector2i>("size");
-    if(!targetSize.product()) {
-        Error{} << "Trade::StbResizeImageConverter::convert(): invalid output image size" << Debug::packed << targetSize;
+        Error{} << messagePrefix << "invalid input image size" << Debug::packed << image.size().xy();
         return {};
     }
 
-    /* Actual output size depending on whether upsampling is desired or not */
-    const Vector2i size = configuration.value<bool>("upsample") ? targetSize : Vector2i{Math::min(targetSize, image.size().xy())};
+    Parameters out;
 
     /* Data type and component count. Branching on isPixelFormatDepthOrStencil()
        to avoid having a dedicated error path for depth/stencil formats. */
-    stbir_datatype type;
     switch(isPixelFormatDepthOrStencil(image.format()) ? image.format() : pixelFormatChannelFormat(image.format())) {
         case PixelFormat::R8Unorm:
         case PixelFormat::R8Srgb:
-            type = STBIR_TYPE_UINT8;
+            out.type = STBIR_TYPE_UINT8;
             break;
         case PixelFormat::R16Unorm:
-            type = STBIR_TYPE_UINT16;
+            out.type = STBIR_TYPE_UINT16;
             break;
         case PixelFormat::R32F:
-            type = STBIR_TYPE_FLOAT;
+            out.type = STBIR_TYPE_FLOAT;
             break;
         /** @todo STBIR_TYPE_UINT32 possibly for resampling depth? */
         default:
-            Error{} << "Trade::StbResizeImageConverter::convert(): unsupported format" << image.format();
+            Error{} << messagePrefix << "unsupported format" << image.format();
             return {};
     }
-    const Int channelCount = pixelFormatChannelCount(image.format());
-    const Int alphaChannelIndex = channelCount == 4 ? 3 : -1;
-    const stbir_colorspace colorspace = isPixelFormatSrgb(image.format()) ? STBIR_COLORSPACE_SRGB : STBIR_COLORSPACE_LINEAR;
+    out.channelCount = pixelFormatChannelCount(image.format());
+    out.alphaChannelIndex = out.channelCount == 4 ? 3 : -1;
+    out.colorspace = isPixelFormatSrgb(image.format()) ? STBIR_COLORSPACE_SRGB : STBIR_COLORSPACE_LINEAR;
 
     /* Flags */
-    Int flags{};
+    out.flags = 0;
     if(configuration.value<bool>("alphaPremultiplied"))
-        flags |= STBIR_FLAG_ALPHA_PREMULTIPLIED;
+        out.flags |= STBIR_FLAG_ALPHA_PREMULTIPLIED;
     if(configuration.value<bool>("alphaUsesSrgb"))
-        flags |= STBIR_FLAG_ALPHA_USES_COLORSPACE;
+        out.flags |= STBIR_FLAG_ALPHA_USES_COLORSPACE;
 
     /* Edge mode */
     const Containers::StringView edgeString = configuration.value<Containers::StringView>("edge");
-    stbir_edge edge;
     /* LCOV_EXCL_START, it makes no sense to test each and every */
     if(edgeString == "clamp"_s)
-        edge = STBIR_EDGE_CLAMP;
+        out.edge = STBIR_EDGE_CLAMP;
     else if(edgeString == "reflect"_s)
-        edge = STBIR_EDGE_REFLECT;
+        out.edge = STBIR_EDGE_REFLECT;
     else if(edgeString == "wrap"_s)
-        edge = STBIR_EDGE_WRAP;
+        out.edge = STBIR_EDGE_WRAP;
     else if(edgeString == "zero"_s)
-        edge = STBIR_EDGE_ZERO;
+        out.edge = STBIR_EDGE_ZERO;
     /* LCOV_EXCL_STOP */
     else {
-        Error{} << "Trade::StbResizeImageConverter::convert(): expected edge mode to be one of clamp, reflect, wrap or zero, got" << edgeString;
+        Error{} << messagePrefix << "expected edge mode to be one of clamp, reflect, wrap or zero, got" << edgeString;
         return {};
     }
 
     /* Filter */
     const Containers::StringView filterString = configuration.value<Containers::StringView>("filter");
-    stbir_filter filter;
     /* LCOV_EXCL_START, it makes no sense to test each and every */
     if(!filterString)
-        filter = STBIR_FILTER_DEFAULT;
+        out.filter = STBIR_FILTER_DEFAULT;
     else if(filterString == "box"_s)
-        filter = STBIR_FILTER_BOX;
+        out.filter = STBIR_FILTER_BOX;
     else if(filterString == "triangle"_s)
-        filter = STBIR_FILTER_TRIANGLE;
+        out.filter = STBIR_FILTER_TRIANGLE;
     else if(filterString == "cubicspline"_s)
-        filter = STBIR_FILTER_CUBICBSPLINE;
+        out.filter = STBIR_FILTER_CUBICBSPLINE;
     else if(filterString == "catmullrom"_s)
-        filter = STBIR_FILTER_CATMULLROM;
+        out.filter = STBIR_FILTER_CATMULLROM;
     else if(filterString == "mitchell"_s)
-        filter = STBIR_FILTER_MITCHELL;
+        out.filter = STBIR_FILTER_MITCHELL;
     /* LCOV_EXCL_STOP */
     else {
-        Error{} << "Trade::StbResizeImageConverter::convert(): expected filter to be empty or one of box, triangle, cubicpline, catmullrom or mitchell, got" << filterString;
+        Error{} << messagePrefix << "expected filter to be empty or one of box, triangle, cubicpline, catmullrom or mitchell, got" << filterString;
         return {};
     }
 
+    return out;
+}
+
+ImageData3D allocateImage(const PixelFormat format, const Vector3i& size, const ImageFlags3D flags) {
     /* Always align output rows at four bytes */
-    const std::size_t stride = 4*((size.x()*image.pixelSize() + 3)/4);
-    Trade::ImageData3D out{image.format(), {size, image.size().z()}, Containers::Array<char>{NoInit, stride*size.y()*image.size().z()}, image.flags()};
+    const std::size_t stride = 4*((size.x()*pixelFormatSize(format) + 3)/4);
+    return ImageData3D{format, size, Containers::Array<char>{NoInit, stride*size.y()*size.z()}, flags};
+}
+
+/* A single 2D slice to be resized */
+struct Job {
+    const Parameters* parameters;
+    Containers::StridedArrayView3D<const char> src;
+    Containers::StridedArrayView3D<char> dst;
+};
+
+void resize(const Containers::ArrayView<const Job> jobs, Utility::ConfigurationGroup& configuration) {
+    if(jobs.isEmpty()) return;
+
+    /* The jobs are independent, so they can be processed on multiple threads,
+       each picking the next unprocessed one. If there's more threads than
+       jobs, each job is additionally split into horizontal bands of output
+       rows so all threads have something to do. */
+    std::size_t threadCount = 1;
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    threadCount = configuration.value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    #else
+    static_cast<void>(configuration);
+    #endif
+    const std::size_t bandCount = (threadCount + jobs.size() - 1)/jobs.size();
+    const std::size_t itemCount = jobs.size()*bandCount;
+    threadCount = Math::min(threadCount, itemCount);
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    std::atomic<std::size_t> next{0};
+    #else
+    std::size_t next = 0;
+    #endif
+    const auto process = [&]() {
+        StbirAllocator allocator;
+        for(std::size_t i; (i = next++) < itemCount; ) {
+            const Job& job = jobs[i/bandCount];
+            const Parameters& parameters = *job.parameters;
+            const std::size_t band = i % bandCount;
+
+            /* Apart from wrong input (which is checked in parseParameters()), the
+               only way these functions could fail is due to a memory
+               allocation failure. Which is likely only when doing some really
+               crazy upsample, and then it'd fail already when allocating the
+               output image. */
+            if(bandCount == 1) {
+                CORRADE_INTERNAL_ASSERT_OUTPUT(stbir_resize(
+                    job.src.data(), job.src.size()[1], job.src.size()[0], job.src.stride()[0],
+                    job.dst.data(), job.dst.size()[1], job.dst.size()[0], job.dst.stride()[0],
+                    /** @todo option for separate horizontal and vertical filters */
+                    parameters.type, parameters.channelCount, parameters.alphaChannelIndex, parameters.flags, parameters.edge, parameters.edge, parameters.filter, parameters.filter, parameters.colorspace, &allocator));
+                continue;
+            }
+
+            /* A band of output rows. The input is always the whole image so
+               the filter samples neighboring rows and edges exactly as when
+               resizing the whole image at once, the band is then just shifted
+               by its first row. Bands of images with less rows than there's
+               bands can be empty. */
+            const std::size_t height = job.dst.size()[0];
+            const std::size_t begin = height*band/bandCount;
+            const std::size_t end = height*(band + 1)/bandCount;
+            if(begin == end) continue;
+            const Containers::StridedArrayView3D<char> dst = job.dst.slice(begin, end);
+            CORRADE_INTERNAL_ASSERT_OUTPUT(stbir_resize_subpixel(
+                job.src.data(), job.src.size()[1], job.src.size()[0], job.src.stride()[0],
+                dst.data(), dst.size()[1], dst.size()[0], dst.stride()[0],
+                parameters.type, parameters.channelCount, parameters.alphaChannelIndex, parameters.flags, parameters.edge, parameters.edge, parameters.filter, parameters.filter, parameters.colorspace, &allocator,
+                Float(job.dst.size()[1])/job.src.size()[1],
+                Float(height)/job.src.size()[0],
+                0.0f, Float(begin)));
+        }
+    };
+
+    /* The calling thread is one of the workers */
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{process};
+    process();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    process();
+    #endif
+}
+
+/* Validates the input and options, allocates the output and either copies
+   the input to it or appends resize jobs to the array. The jobs reference the
+   parameters, so these have to stay in scope until the jobs are processed. */
+Containers::Optional<ImageData3D> prepare(const ImageView3D& image, Utility::ConfigurationGroup& configuration, const char* const messagePrefix, Containers::Optional<Parameters>& parameters, Containers::Array<Job>& jobs) {
+    if(!(parameters = parseParameters(image, configuration, messagePrefix)))
+        return {};
+
+    /* Target output size. The final output size depends on wheter upscaling is
+       disabled. */
+    if(!configuration.value<Containers::StringView>("size")) {
+        Error{} << messagePrefix << "output size was not specified";
+        return {};
+    }
+    const Vector2i targetSize = configuration.value<Vector2i>("size");
+    if(!targetSize.product()) {
+        Error{} << messagePrefix << "invalid output image size" << Debug::packed << targetSize;
+        return {};
+    }
+
+    /* Actual output size depending on whether upsampling is desired or not */
+    const Vector2i size = configuration.value<bool>("upsample") ? targetSize : Vector2i{Math::min(targetSize, image.size().xy())};
+
+    Trade::ImageData3D out = allocateImage(image.format(), {size, image.size().z()}, image.flags());
 
     const Containers::StridedArrayView4D<const char> srcPixels = image.pixels();
     const Containers::StridedArrayView4D<char> dstPixels = out.mutablePixels();
@@ -159,18 +270,97 @@ Containers::Optional<ImageData3D> convertInternal(const ImageView3D& image, Util
         return Containers::optional(Utility::move(out));
     }
 
-    /* Apart from wrong input (which we check here), the only way this function
-       could fail is due to a memory allocation failure. Which is likely only
-       when doing some really crazy upsample, and then it'd fail already when
-       allocating the output image above. */
-    for(std::size_t z = 0, zMax = image.size().z(); z != zMax; ++z) {
-        const Containers::StridedArrayView3D<const char> srcPixelLayer = srcPixels[z];
-        const Containers::StridedArrayView3D<char> dstPixelLayer = dstPixels[z];
-        CORRADE_INTERNAL_ASSERT_OUTPUT(stbir_resize(
-            srcPixelLayer.data(), srcPixelLayer.size()[1], srcPixelLayer.size()[0], srcPixelLayer.stride()[0],
-            dstPixelLayer.data(), dstPixelLayer.size()[1], dstPixelLayer.size()[0], dstPixelLayer.stride()[0],
-            /** @todo option for separate horizontal and vertical filters */
-            type, channelCount, alphaChannelIndex, flags, edge, edge, filter, filter, colorspace, nullptr));
+    for(std::size_t z = 0, zMax = image.size().z(); z != zMax; ++z)
+        arrayAppend(jobs, InPlaceInit, &*parameters, srcPixels[z], dstPixels[z]);
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(out));
+}
+
+Containers::Optional<ImageData3D> convertInternal(const ImageView3D& image, Utility::ConfigurationGroup& configuration, const char* const messagePrefix) {
+    Containers::Optional<Parameters> parameters;
+    Containers::Array<Job> jobs;
+    Containers::Optional<ImageData3D> out = prepare(image, configuration, messagePrefix, parameters, jobs);
+    if(!out) return {};
+
+    resize(jobs, configuration);
+    return out;
+}
+
+Containers::Optional<Containers::Array<ImageData3D>> convertBatchInternal(const Containers::ArrayView<const ImageView3D> images, Utility::ConfigurationGroup& configuration, const char* const messagePrefix) {
+    /* Prepare all images first and then resize all their layers at once, so
+       they can all be processed in parallel. The parameters are allocated
+       upfront as the jobs reference them. */
+    Containers::Array<Containers::Optional<Parameters>> parameters{images.size()};
+    Containers::Array<ImageData3D> out;
+    arrayReserve(out, images.size());
+    Containers::Array<Job> jobs;
+    for(std::size_t i = 0; i != images.size(); ++i) {
+        Containers::Optional<ImageData3D> image = prepare(images[i], configuration, messagePrefix, parameters[i], jobs);
+        if(!image) return {};
+        arrayAppend(out, Utility::move(*image));
+    }
+
+    resize(jobs, configuration);
+
+    /* Convert back to a default deleter to make the result usable in plugins
+       that may get unloaded */
+    arrayShrink(out, DefaultInit);
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(out));
+}
+
+Containers::Optional<Containers::Array<ImageData3D>> convertMipChainInternal(const ImageView3D& image, Utility::ConfigurationGroup& configuration, const char* const messagePrefix) {
+    const Containers::Optional<Parameters> parameters = parseParameters(image, configuration, messagePrefix);
+    if(!parameters) return {};
+
+    /* The first level is either resized according to the size option or is a
+       copy of the input */
+    Containers::Optional<ImageData3D> first;
+    if(configuration.value<Containers::StringView>("size")) {
+        if(!(first = convertInternal(image, configuration, messagePrefix)))
+            return {};
+    } else {
+        first = allocateImage(image.format(), image.size(), image.flags());
+        Utility::copy(image.pixels(), first->mutablePixels());
+    }
+
+    /* Full chain down to 1x1, optionally limited by the levels option */
+    const Vector2i firstSize = first->size().xy();
+    UnsignedInt levelCount = Math::log2(UnsignedInt(firstSize.max())) + 1;
+    if(const UnsignedInt levels = configuration.value<UnsignedInt>("levels"))
+        levelCount = Math::min(levelCount, levels);
+
+    Containers::Array<ImageData3D> out{NoInit, levelCount};
+    new(&out[0]) ImageData3D{Utility::move(*first)};
+    for(std::size_t i = 1; i != levelCount; ++i)
+        new(&out[i]) ImageData3D{allocateImage(image.format(), {Math::max(firstSize >> Int(i), Vector2i{1}), image.size().z()}, image.flags())};
+
+    /* Each level is resampled from the previous one, which means the levels
+       have to be processed in order and only the layers can be processed in
+       parallel. Otherwise all levels are resampled from the original image,
+       which means everything can go in parallel. */
+    const std::size_t layerCount = image.size().z();
+    Containers::Array<Job> jobs{ValueInit, (levelCount - 1)*layerCount};
+    const Parameters* const levelParameters = &*parameters;
+    if(configuration.value<bool>("fromPreviousLevel")) {
+        for(std::size_t i = 1; i != levelCount; ++i) {
+            const Containers::StridedArrayView4D<const char> srcPixels = out[i - 1].pixels();
+            const Containers::StridedArrayView4D<char> dstPixels = out[i].mutablePixels();
+            const Containers::ArrayView<Job> levelJobs = jobs.sliceSize((i - 1)*layerCount, layerCount);
+            for(std::size_t z = 0; z != layerCount; ++z)
+                levelJobs[z] = Job{levelParameters, srcPixels[z], dstPixels[z]};
+            resize(levelJobs, configuration);
+        }
+    } else {
+        const Containers::StridedArrayView4D<const char> srcPixels = image.pixels();
+        for(std::size_t i = 1; i != levelCount; ++i) {
+            const Containers::StridedArrayView4D<char> dstPixels = out[i].mutablePixels();
+            for(std::size_t z = 0; z != layerCount; ++z)
+                jobs[(i - 1)*layerCount + z] = Job{levelParameters, srcPixels[z], dstPixels[z]};
+        }
+        resize(jobs, configuration);
     }
 
     /* GCC 4.8 needs extra help here */
@@ -180,6 +370,7 @@ Containers::Optional<ImageData3D> convertInternal(const ImageView3D& image, Util
 }
 
 Containers::Optional<ImageData2D> StbResizeImageConverter::doConvert(const ImageView2D& image) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvert"};
     if(image.flags() & ImageFlag2D::Array) {
         /** @todo or take only the X size instead? then it would make sense to
             provide also a non-array 1D variant */
@@ -187,7 +378,7 @@ Containers::Optional<ImageData2D> StbResizeImageConverter::doConvert(const Image
         return {};
     }
 
-    Containers::Optional<ImageData3D> out = convertInternal(image, configuration());
+    Containers::Optional<ImageData3D> out = convertInternal(image, configuration(), "Trade::StbResizeImageConverter::convert():");
     if(!out) return {};
 
     CORRADE_INTERNAL_ASSERT(out->size().z() == 1);
@@ -196,12 +387,81 @@ Containers::Optional<ImageData2D> StbResizeImageConverter::doConvert(const Image
 }
 
 Containers::Optional<ImageData3D> StbResizeImageConverter::doConvert(const ImageView3D& image) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvert"};
     if(!(image.flags() & (ImageFlag3D::Array|ImageFlag3D::CubeMap))) {
         Error{} << "Trade::StbResizeImageConverter::convert(): 3D images are not supported";
         return {};
     }
 
-    return convertInternal(image, configuration());
+    return convertInternal(image, configuration(), "Trade::StbResizeImageConverter::convert():");
+}
+
+Containers::Optional<Containers::Array<ImageData2D>> StbResizeImageConverter::convertBatch(const Containers::ArrayView<const ImageView2D> images) {
+    Containers::Array<ImageView3D> images3D;
+    arrayReserve(images3D, images.size());
+    for(const ImageView2D& image: images) {
+        if(image.flags() & ImageFlag2D::Array) {
+            Error{} << "Trade::StbResizeImageConverter::convertBatch(): 1D array images are not supported";
+            return {};
+        }
+
+        arrayAppend(images3D, image);
+    }
+
+    Containers::Optional<Containers::Array<ImageData3D>> converted = convertBatchInternal(images3D, configuration(), "Trade::StbResizeImageConverter::convertBatch():");
+    if(!converted) return {};
+
+    Containers::Array<ImageData2D> out{NoInit, converted->size()};
+    for(std::size_t i = 0; i != out.size(); ++i) {
+        ImageData3D& image = (*converted)[i];
+        CORRADE_INTERNAL_ASSERT(image.size().z() == 1);
+        const Vector2i size = image.size().xy();
+        new(&out[i]) ImageData2D{image.format(), size, image.release(), ImageFlag2D(UnsignedShort(image.flags()))};
+    }
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(out));
+}
+
+Containers::Optional<Containers::Array<ImageData3D>> StbResizeImageConverter::convertBatch(const Containers::ArrayView<const ImageView3D> images) {
+    for(const ImageView3D& image: images) {
+        if(!(image.flags() & (ImageFlag3D::Array|ImageFlag3D::CubeMap))) {
+            Error{} << "Trade::StbResizeImageConverter::convertBatch(): 3D images are not supported";
+            return {};
+        }
+    }
+
+    return convertBatchInternal(images, configuration(), "Trade::StbResizeImageConverter::convertBatch():");
+}
+
+Containers::Optional<Containers::Array<ImageData2D>> StbResizeImageConverter::convertMipChain(const ImageView2D& image) {
+    if(image.flags() & ImageFlag2D::Array) {
+        Error{} << "Trade::StbResizeImageConverter::convertMipChain(): 1D array images are not supported";
+        return {};
+    }
+
+    Containers::Optional<Containers::Array<ImageData3D>> levels = convertMipChainInternal(image, configuration(), "Trade::StbResizeImageConverter::convertMipChain():");
+    if(!levels) return {};
+
+    Containers::Array<ImageData2D> out{NoInit, levels->size()};
+    for(std::size_t i = 0; i != out.size(); ++i) {
+        ImageData3D& level = (*levels)[i];
+        CORRADE_INTERNAL_ASSERT(level.size().z() == 1);
+        const Vector2i size = level.size().xy();
+        new(&out[i]) ImageData2D{level.format(), size, level.release(), ImageFlag2D(UnsignedShort(level.flags()))};
+    }
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(out));
+}
+
+Containers::Optional<Containers::Array<ImageData3D>> StbResizeImageConverter::convertMipChain(const ImageView3D& image) {
+    if(!(image.flags() & (ImageFlag3D::Array|ImageFlag3D::CubeMap))) {
+        Error{} << "Trade::StbResizeImageConverter::convertMipChain(): 3D images are not supported";
+        return {};
+    }
+
+    return convertMipChainInternal(image, configuration(), "Trade::StbResizeImageConverter::convertMipChain():");
 }
 
 }}
@@ -127,6 +127,68 @@ and 1D array images (with @ref ImageFlag2D::Array set) are not supported, 3D
 images are expected to have either @ref ImageFlag3D::Array nor
 @ref ImageFlag3D::CubeMap set.
 
+Layers of 2D array and cube map images are resized independently. Setting the
+@cb{.ini} threads @ce @ref Trade-StbResizeImageConverter-configuration "configuration option"
+to a value other than @cpp 1 @ce resizes them on multiple threads. If there's
+more threads than layers, such as when resizing a single large 2D image, the
+output is additionally split into horizontal bands that are resized in
+parallel. Each band samples the whole input image, so the output is the same
+as with a single thread except for possible off-by-one differences coming
+from floating-point rounding. Same as with @ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter",
+the application has to be linked to `pthread` on Linux for this to work.
+
+@subsection Trade-StbResizeImageConverter-behavior-batch Batch resizing
+
+Resizing many small images, such as sprites for a texture atlas, one
+@ref convert() call at a time leaves all threads but one idle. The
+@ref convertBatch() function takes a list of images and resizes them all at
+once, sharing the @cb{.ini} threads @ce among all images and all their layers.
+The images don't need to have the same size or format:
+
+@code{.cpp}
+Containers::Pointer<Trade::AbstractImageConverter> resizer =
+    manager.instantiate("StbResizeImageConverter");
+resizer->configuration().setValue("size", Vector2i{32, 32});
+resizer->configuration().setValue("threads", 0);
+
+Containers::ArrayView<const ImageView2D> sprites = …;
+Containers::Optional<Containers::Array<Trade::ImageData2D>> resized =
+    static_cast<Trade::StbResizeImageConverter&>(*resizer).convertBatch(sprites);
+@endcode
+
+Note that this is a plugin-specific API and thus available only if the plugin
+is linked and used directly, not when loaded dynamically through a plugin
+manager.
+
+@subsection Trade-StbResizeImageConverter-behavior-mip-chain Mip chain generation
+
+The @ref convertMipChain() function generates a whole mip chain in a single
+call, with temporary resampling memory reused across all levels and layers. The
+first level is resized according to the @cb{.ini} size @ce option, or is a
+copy of the input if the option is empty. Each following level has half the
+size of the previous one, rounded down, until @cpp {1, 1} @ce is reached, or
+until the count specified in the @cb{.ini} levels @ce option is reached. The
+result can be then for example passed directly to
+@ref AbstractImageConverter::convertToFile(Containers::ArrayView<const ImageView2D>, Containers::StringView) "convertToFile()"
+of a converter supporting multi-level images:
+
+@code{.cpp}
+Containers::Pointer<Trade::AbstractImageConverter> resizer =
+    manager.instantiate("StbResizeImageConverter");
+Containers::Optional<Containers::Array<Trade::ImageData2D>> levels =
+    static_cast<Trade::StbResizeImageConverter&>(*resizer).convertMipChain(image);
+@endcode
+
+By default each level is resampled from the previous one, meaning the levels
+are processed one after another. If @cb{.ini} fromPreviousLevel @ce is
+disabled, each level is resampled from the original image instead, which is
+slower in total but avoids accumulating filtering errors and allows all levels
+to be processed in parallel with @cb{.ini} threads @ce.
+
+Note that this is a plugin-specific API and thus available only if the plugin
+is linked and used directly, not when loaded dynamically through a plugin
+manager.
+
 @section Trade-StbResizeImageConverter-configuration Plugin-specific configuration
 
 Apart from the mandatory @cb{.ini} size @ce, other options can be set through
@@ -142,6 +204,54 @@ class MAGNUM_STBRESIZEIMAGECONVERTER_EXPORT StbResizeImageConverter: public Abst
         /** @brief Plugin manager constructor */
         explicit StbResizeImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
+        /**
+         * @brief Resize a batch of 2D images
+         *
+         * Equivalent to calling @ref convert() on each image, but with all
+         * images resized in parallel if the @cb{.ini} threads @ce option is
+         * set to a value other than @cpp 1 @ce and with temporary resampling
+         * memory reused across all of them. The images can have different
+         * sizes and formats, all are resized according to the same options.
+         * Same as with @ref convert(), 1D array images are not supported. On
+         * failure prints a message to @relativeref{Magnum,Error} and returns
+         * @relativeref{Corrade,Containers::NullOpt}. See
+         * @ref Trade-StbResizeImageConverter-behavior-batch for more
+         * information.
+         */
+        Containers::Optional<Containers::Array<ImageData2D>> convertBatch(Containers::ArrayView<const ImageView2D> images);
+
+        /**
+         * @brief Resize a batch of 2D array or cube map images
+         *
+         * Like @ref convertBatch(Containers::ArrayView<const ImageView2D>),
+         * but for images with @ref ImageFlag3D::Array or
+         * @ref ImageFlag3D::CubeMap set. Layers of all images are resized in
+         * parallel.
+         */
+        Containers::Optional<Containers::Array<ImageData3D>> convertBatch(Containers::ArrayView<const ImageView3D> images);
+
+        /**
+         * @brief Generate a mip chain from a 2D image
+         *
+         * Returns all levels of the mip chain, with the first level being
+         * resized according to the @cb{.ini} size @ce option or being a copy
+         * of @p image if the option is empty. Same as with @ref convert(),
+         * 1D array images are not supported. On failure prints a message to
+         * @relativeref{Magnum,Error} and returns @relativeref{Corrade,Containers::NullOpt}.
+         * See @ref Trade-StbResizeImageConverter-behavior-mip-chain for more
+         * information.
+         */
+        Containers::Optional<Containers::Array<ImageData2D>> convertMipChain(const ImageView2D& image);
+
+        /**
+         * @brief Generate a mip chain from a 2D array or cube map image
+         *
+         * Like @ref convertMipChain(const ImageView2D&), but for images with
+         * @ref ImageFlag3D::Array or @ref ImageFlag3D::CubeMap set. All levels
+         * have the same layer count as @p image.
+         */
+        Containers::Optional<Containers::Array<ImageData3D>> convertMipChain(const ImageView3D& image);
+
     private:
         MAGNUM_STBRESIZEIMAGECONVERTER_LOCAL ImageConverterFeatures doFeatures() const override;
         MAGNUM_STBRESIZEIMAGECONVERTER_LOCAL Containers::Optional<ImageData2D> doConvert(const ImageView2D& image) override;
@@ -24,9 +24,11 @@
 */
 
 #include <sstream>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Magnum/ImageView.h>
@@ -39,6 +41,10 @@
 
 #include "configure.h"
 
+#ifndef STBRESIZEIMAGECONVERTER_PLUGIN_FILENAME
+#include "MagnumPlugins/StbResizeImageConverter/StbResizeImageConverter.h"
+#endif
+
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
 struct StbResizeImageConverterTest: TestSuite::Tester {
@@ -63,6 +69,16 @@ struct StbResizeImageConverterTest: TestSuite::Tester {
     void array2D();
 
     void upsample();
+    void threads();
+
+    void batch();
+    void batchArray();
+    void batchInvalid();
+
+    void mipChain();
+    void mipChainArray();
+    void mipChainThreeDimensions();
+    void mipChainArray1D();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
@@ -135,6 +151,47 @@ const struct {
         {0xff3366_rgb, 0xff6633_rgb, 0x66ffcc_rgb, {}}},
 };
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+    Vector2i inputSize;
+    Vector2i size;
+    Int layers;
+} ThreadsData[]{
+    {"downsample, two threads", 2, {67, 45}, {23, 21}, 1},
+    {"downsample, all threads", 0, {67, 45}, {23, 21}, 1},
+    {"downsample, more threads than rows", 32, {67, 45}, {23, 21}, 1},
+    {"upsample, three threads", 3, {23, 21}, {67, 45}, 1},
+    {"array, five threads", 5, {67, 45}, {23, 21}, 2},
+};
+
+const struct {
+    const char* name;
+    Containers::Optional<Vector2i> size;
+    Containers::Optional<UnsignedInt> levels;
+    Containers::Optional<bool> fromPreviousLevel;
+    UnsignedInt threads;
+    Vector2i expectedSizes[5];
+    UnsignedInt expectedLevelCount;
+} MipChainData[]{
+    {"", {}, {}, {}, 1,
+        {{12, 5}, {6, 2}, {3, 1}, {1, 1}}, 4},
+    {"two threads", {}, {}, {}, 2,
+        {{12, 5}, {6, 2}, {3, 1}, {1, 1}}, 4},
+    {"from original image", {}, {}, false, 1,
+        {{12, 5}, {6, 2}, {3, 1}, {1, 1}}, 4},
+    {"from original image, all threads", {}, {}, false, 0,
+        {{12, 5}, {6, 2}, {3, 1}, {1, 1}}, 4},
+    {"custom size", Vector2i{16, 16}, {}, {}, 1,
+        {{16, 16}, {8, 8}, {4, 4}, {2, 2}, {1, 1}}, 5},
+    {"custom size, from original image", Vector2i{3, 2}, {}, false, 1,
+        {{3, 2}, {1, 1}}, 2},
+    {"limited level count", {}, 2, {}, 1,
+        {{12, 5}, {6, 2}}, 2},
+    {"level count larger than a full chain", Vector2i{3, 2}, 7, {}, 1,
+        {{3, 2}, {1, 1}}, 2},
+};
+
 StbResizeImageConverterTest::StbResizeImageConverterTest() {
     addTests({&StbResizeImageConverterTest::emptySize,
               &StbResizeImageConverterTest::emptyInputImage,
@@ -158,6 +215,20 @@ StbResizeImageConverterTest::StbResizeImageConverterTest() {
     addInstancedTests({&StbResizeImageConverterTest::upsample},
         Containers::arraySize(UpsampleData));
 
+    addInstancedTests({&StbResizeImageConverterTest::threads},
+        Containers::arraySize(ThreadsData));
+
+    addTests({&StbResizeImageConverterTest::batch,
+              &StbResizeImageConverterTest::batchArray,
+              &StbResizeImageConverterTest::batchInvalid});
+
+    addInstancedTests({&StbResizeImageConverterTest::mipChain},
+        Containers::arraySize(MipChainData));
+
+    addTests({&StbResizeImageConverterTest::mipChainArray,
+              &StbResizeImageConverterTest::mipChainThreeDimensions,
+              &StbResizeImageConverterTest::mipChainArray1D});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef STBRESIZEIMAGECONVERTER_PLUGIN_FILENAME
@@ -447,6 +518,254 @@ void StbResizeImageConverterTest::upsample() {
         }), DebugTools::CompareImage);
 }
 
+void StbResizeImageConverterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Some noisy data so the filtering has something to work with */
+    Containers::Array<Color4ub> input{NoInit, std::size_t(data.inputSize.product()*data.layers)};
+    for(std::size_t i = 0; i != input.size(); ++i)
+        input[i] = Color4ub{UnsignedByte(i*37 % 251), UnsignedByte(i*11 % 241), UnsignedByte(i % 233), UnsignedByte(255 - i % 239)};
+    const ImageView3D image{PixelFormat::RGBA8Srgb, {data.inputSize, data.layers}, input, ImageFlag3D::Array};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("StbResizeImageConverter");
+    converter->configuration().setValue("size", data.size);
+    Containers::Optional<ImageData3D> expected = converter->convert(image);
+    CORRADE_VERIFY(expected);
+
+    /* With multiple threads the result should be the same as with a single
+       one, except for rare off-by-one differences due to rounding */
+    converter->configuration().setValue("threads", data.threads);
+    Containers::Optional<ImageData3D> out = converter->convert(image);
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE(out->size(), expected->size());
+    for(std::size_t i = 0; i != std::size_t(data.layers); ++i) {
+        CORRADE_ITERATION(i);
+        /** @todo 3D support in CompareImage, ugh */
+        CORRADE_COMPARE_WITH(out->pixels<Color4ub>()[i],
+            (ImageView2D{PixelFormat::RGBA8Srgb, data.size, expected->data().exceptPrefix(i*data.size.product()*4).prefix(data.size.product()*4)}),
+            (DebugTools::CompareImage{1.0f, 0.01f}));
+    }
+}
+
+void StbResizeImageConverterTest::batch() {
+    #ifdef STBRESIZEIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    StbResizeImageConverter converter{_converterManager, "StbResizeImageConverter"};
+    converter.configuration().setValue("size", (Vector2i{2, 1}));
+    converter.configuration().setValue("threads", 3);
+
+    /* Inputs from rgb8Padded(), rg16() and r32f(), the last one being the
+       target size already so it should be just copied */
+    const Color3ub inputRgb8[]{
+        0xff3366_rgb, 0xff6633_rgb, 0x66ffcc_rgb,
+        0x993366_rgb, 0x3399ff_rgb, 0xcccc99_rgb
+    };
+    const Vector2us inputRg16[]{
+        {0xffff, 0x3333}, {0xffff, 0x6666}, {0x6666, 0xffff},
+        {0x9999, 0x3333}, {0x3333, 0x9999}, {0xcccc, 0xcccc}
+    };
+    const Float inputR32f[]{0.25f, 0.75f};
+    const ImageView2D images[]{
+        {PixelStorage{}.setAlignment(1), PixelFormat::RGB8Unorm, {3, 2}, inputRgb8},
+        {PixelStorage{}.setAlignment(1), PixelFormat::RG16Unorm, {3, 2}, inputRg16, ImageFlag2D(0xdea0)},
+        {PixelFormat::R32F, {2, 1}, inputR32f},
+    };
+
+    Containers::Optional<Containers::Array<ImageData2D>> out = converter.convertBatch(images);
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE(out->size(), 3);
+
+    /* Flags should be passed through unchanged */
+    CORRADE_COMPARE((*out)[1].flags(), ImageFlag2D(0xdea0));
+
+    /* Should be the same as for each image converted separately */
+    for(std::size_t i = 0; i != Containers::arraySize(images); ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<ImageData2D> expected = converter.convert(images[i]);
+        CORRADE_VERIFY(expected);
+        CORRADE_COMPARE_AS((*out)[i], *expected, DebugTools::CompareImage);
+    }
+    #endif
+}
+
+void StbResizeImageConverterTest::batchArray() {
+    #ifdef STBRESIZEIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    StbResizeImageConverter converter{_converterManager, "StbResizeImageConverter"};
+    converter.configuration().setValue("size", (Vector2i{2, 1}));
+    converter.configuration().setValue("threads", 0);
+
+    /* Same input as array2D(), once as an array and once as a cube map with
+       the layers repeated */
+    const Color3ub input[]{
+        0xff3366_rgb, 0xff6633_rgb, 0x66ffcc_rgb,
+        0x993366_rgb, 0x3399ff_rgb, 0xcccc99_rgb,
+
+        0xcccc99_rgb, 0x3399ff_rgb, 0x993366_rgb,
+        0x66ffcc_rgb, 0xff6633_rgb, 0xff3366_rgb,
+    };
+    Color3ub inputCube[6*6];
+    for(std::size_t i = 0; i != 3; ++i)
+        Utility::copy(input, Containers::arrayView(inputCube).sliceSize(i*12, 12));
+    const Color3ub expected[]{
+        0xba4d77_rgb, 0x99c3aa_rgb,
+        0x99c3aa_rgb, 0xba4d77_rgb,
+    };
+    const ImageView3D images[]{
+        {PixelStorage{}.setAlignment(1), PixelFormat::RGB8Unorm, {3, 2, 2}, input, ImageFlag3D::Array},
+        {PixelStorage{}.setAlignment(1), PixelFormat::RGB8Unorm, {3, 2, 6}, inputCube, ImageFlag3D::CubeMap},
+    };
+
+    Containers::Optional<Containers::Array<ImageData3D>> out = converter.convertBatch(images);
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE(out->size(), 2);
+    CORRADE_COMPARE((*out)[0].flags(), ImageFlag3D::Array);
+    CORRADE_COMPARE((*out)[0].size(), (Vector3i{2, 1, 2}));
+    CORRADE_COMPARE((*out)[1].flags(), ImageFlag3D::CubeMap);
+    CORRADE_COMPARE((*out)[1].size(), (Vector3i{2, 1, 6}));
+    for(std::size_t i = 0; i != 8; ++i) {
+        CORRADE_ITERATION(i);
+        /** @todo 3D support in CompareImage, ugh */
+        CORRADE_COMPARE_AS((*out)[i < 2 ? 0 : 1].pixels<Color3ub>()[i < 2 ? i : i - 2],
+            (ImageView2D{PixelStorage{}.setAlignment(1), PixelFormat::RGB8Unorm, {2, 1}, Containers::arrayView(expected).exceptPrefix((i % 2)*2)}),
+            DebugTools::CompareImage);
+    }
+    #endif
+}
+
+void StbResizeImageConverterTest::batchInvalid() {
+    #ifdef STBRESIZEIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    StbResizeImageConverter converter{_converterManager, "StbResizeImageConverter"};
+    converter.configuration().setValue("size", (Vector2i{1, 1}));
+
+    const char data[4]{};
+    const ImageView2D images[]{
+        {PixelFormat::RGBA8Unorm, {1, 1}, data},
+        {PixelFormat::RGBA8UI, {1, 1}, data},
+    };
+    const ImageView2D images1DArray[]{
+        {PixelFormat::RGBA8Unorm, {1, 1}, data},
+        {PixelFormat::RGBA8Unorm, {1, 1}, data, ImageFlag2D::Array},
+    };
+    const ImageView3D images3D[]{
+        {PixelFormat::RGBA8Unorm, {1, 1, 1}, data, ImageFlag3D::Array},
+        {PixelFormat::RGBA8Unorm, {1, 1, 1}, data},
+    };
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter.convertBatch(images));
+    CORRADE_VERIFY(!converter.convertBatch(images1DArray));
+    CORRADE_VERIFY(!converter.convertBatch(images3D));
+    CORRADE_COMPARE(out.str(),
+        "Trade::StbResizeImageConverter::convertBatch(): unsupported format PixelFormat::RGBA8UI\n"
+        "Trade::StbResizeImageConverter::convertBatch(): 1D array images are not supported\n"
+        "Trade::StbResizeImageConverter::convertBatch(): 3D images are not supported\n");
+    #endif
+}
+
+void StbResizeImageConverterTest::mipChain() {
+    auto&& data = MipChainData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifdef STBRESIZEIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    StbResizeImageConverter converter{_converterManager, "StbResizeImageConverter"};
+    if(data.size)
+        converter.configuration().setValue("size", *data.size);
+    if(data.levels)
+        converter.configuration().setValue("levels", *data.levels);
+    if(data.fromPreviousLevel)
+        converter.configuration().setValue("fromPreviousLevel", *data.fromPreviousLevel);
+    converter.configuration().setValue("threads", data.threads);
+
+    /* A single color, so all levels should have it too, regardless of the
+       filtering and resampling source */
+    Color4ub input[12*5];
+    for(Color4ub& i: input) i = 0x3399ccff_rgba;
+
+    Containers::Optional<Containers::Array<ImageData2D>> out = converter.convertMipChain(ImageView2D{PixelFormat::RGBA8Unorm, {12, 5}, input, ImageFlag2D(0xdea0)});
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE(out->size(), data.expectedLevelCount);
+    for(std::size_t i = 0; i != out->size(); ++i) {
+        CORRADE_ITERATION(i);
+        const ImageData2D& level = (*out)[i];
+        /* Flags should be passed through unchanged to all levels */
+        CORRADE_COMPARE(level.flags(), ImageFlag2D(0xdea0));
+        CORRADE_COMPARE(level.format(), PixelFormat::RGBA8Unorm);
+        CORRADE_COMPARE(level.size(), data.expectedSizes[i]);
+        CORRADE_COMPARE_WITH(level,
+            (ImageView2D{PixelFormat::RGBA8Unorm, data.expectedSizes[i], Containers::arrayView(input).prefix(data.expectedSizes[i].product())}),
+            (DebugTools::CompareImage{1.0f, 0.5f}));
+    }
+    #endif
+}
+
+void StbResizeImageConverterTest::mipChainArray() {
+    #ifdef STBRESIZEIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    StbResizeImageConverter converter{_converterManager, "StbResizeImageConverter"};
+    /* Layers are processed in parallel, verify they don't get mixed up */
+    converter.configuration().setValue("threads", 2);
+
+    Color3ub input[3][4*4];
+    for(Color3ub& i: input[0]) i = 0xff3366_rgb;
+    for(Color3ub& i: input[1]) i = 0x3399ff_rgb;
+    for(Color3ub& i: input[2]) i = 0x66ffcc_rgb;
+
+    Containers::Optional<Containers::Array<ImageData3D>> out = converter.convertMipChain(ImageView3D{PixelStorage{}.setAlignment(1), PixelFormat::RGB8Unorm, {4, 4, 3}, input, ImageFlag3D::Array});
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE(out->size(), 3);
+    for(std::size_t i = 0; i != out->size(); ++i) {
+        CORRADE_ITERATION(i);
+        const ImageData3D& level = (*out)[i];
+        CORRADE_COMPARE(level.flags(), ImageFlag3D::Array);
+        CORRADE_COMPARE(level.size(), (Vector3i{4 >> i, 4 >> i, 3}));
+        /* Level data are four-byte aligned, so compare just the first pixel
+           of each layer */
+        for(std::size_t z = 0; z != 3; ++z) {
+            CORRADE_ITERATION(z);
+            CORRADE_COMPARE(level.pixels<Color3ub>()[z][0][0], input[z][0]);
+        }
+    }
+    #endif
+}
+
+void StbResizeImageConverterTest::mipChainThreeDimensions() {
+    #ifdef STBRESIZEIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    StbResizeImageConverter converter{_converterManager, "StbResizeImageConverter"};
+
+    char data[4]{};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter.convertMipChain(ImageView3D{PixelFormat::RGBA8Unorm, {1, 1, 1}, data}));
+    CORRADE_COMPARE(out.str(), "Trade::StbResizeImageConverter::convertMipChain(): 3D images are not supported\n");
+    #endif
+}
+
+void StbResizeImageConverterTest::mipChainArray1D() {
+    #ifdef STBRESIZEIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    StbResizeImageConverter converter{_converterManager, "StbResizeImageConverter"};
+
+    char data[4]{};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter.convertMipChain(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, data, ImageFlag2D::Array}));
+    CORRADE_COMPARE(out.str(), "Trade::StbResizeImageConverter::convertMipChain(): 1D array images are not supported\n");
+    #endif
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::StbResizeImageConverterTest)
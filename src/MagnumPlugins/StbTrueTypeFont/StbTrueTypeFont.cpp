@@ -26,14 +26,27 @@
 #include "StbTrueTypeFont.h"
 
 #include <algorithm> /* std::transform(), std::sort(), std::unique() */
+#include <thread>
+#include <Corrade/Containers/String.h>
 #include <Corrade/PluginManager/AbstractManager.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/Sha1.h>
 #include <Corrade/Utility/Unicode.h>
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
 
+#include "Magnum/Implementation/glyphCacheFile.h"
+
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <atomic>
+#endif
+
 #define STB_TRUETYPE_IMPLEMENTATION
 #define STBTT_STATIC
 #ifdef CORRADE_TARGET_MSVC
@@ -57,6 +70,11 @@ struct StbTrueTypeFont::Font {
     Containers::Array<unsigned char> data;
     stbtt_fontinfo info;
     Float scale;
+    /* Oversampling used by the last fillGlyphCache() call, glyph rectangles
+       and offsets in the cache are in oversampled pixels. The shift
+       compensates for the phase shift caused by the oversampling filter. */
+    Vector2i oversample{1};
+    Vector2 oversampleShift;
 };
 
 class StbTrueTypeFont::Layouter: public AbstractLayouter {
@@ -72,7 +90,13 @@ class StbTrueTypeFont::Layouter: public AbstractLayouter {
         const std::vector<Int> _glyphs;
 };
 
-StbTrueTypeFont::StbTrueTypeFont() = default;
+StbTrueTypeFont::StbTrueTypeFont() {
+    /* Without a plugin manager there's no configuration file to take the
+       defaults from */
+    configuration().setValue("oversampleX", 1);
+    configuration().setValue("oversampleY", 1);
+    configuration().setValue("threads", 1);
+}
 
 StbTrueTypeFont::StbTrueTypeFont(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractFont{manager, plugin} {}
 
@@ -147,48 +171,119 @@ void StbTrueTypeFont::doFillGlyphCache(AbstractGlyphCache& cache, const std::u32
     Containers::ArrayView<const int> glyphIndicesUnique{glyphIndices.begin(),
         std::size_t(std::unique(glyphIndices.begin(), glyphIndices.end()) - glyphIndices.begin())};
 
-    /* Properties of all glyphs to reserve the cache */
+    /* Oversampling, same as with stbtt_PackSetOversampling(). The glyphs are
+       rendered at a multiple of the resolution and then box-filtered, which
+       improves quality of glyphs positioned at subpixel offsets or
+       magnified. */
+    const Vector2i oversample{
+        Int(configuration().value<UnsignedInt>("oversampleX")),
+        Int(configuration().value<UnsignedInt>("oversampleY"))};
+    if(oversample.min() < 1 || oversample.max() > STBTT_MAX_OVERSAMPLE) {
+        Error{} << "Text::StbTrueTypeFont::fillGlyphCache(): expected oversampling to be between 1 and" << STBTT_MAX_OVERSAMPLE << "but got" << Debug::packed << oversample;
+        return;
+    }
+    const Vector2 scale = Vector2{oversample}*_font->scale;
+
+    /* Remember the oversampling for layouting. The shift is the same as
+       what stbtt_MakeGlyphBitmapSubpixelPrefilter() returns, with Y flipped
+       as the cache is Y up. */
+    _font->oversample = oversample;
+    _font->oversampleShift = Vector2{-Float(oversample.x() - 1), Float(oversample.y() - 1)}/(2.0f*Vector2{oversample});
+
+    /* If a cache directory is set, hash everything that affects the glyph
+       cache contents -- the font data and size, the glyph set, cache
+       properties and oversampling -- and reuse the cached result if it's
+       there. The thread count doesn't affect the output so it's not
+       included. */
+    const Containers::StringView cacheDirectory = configuration().value<Containers::StringView>("cacheDirectory");
+    Containers::String cacheFilename;
+    if(cacheDirectory) {
+        Utility::Sha1 sha1;
+        const auto hash = [&sha1](const Containers::StringView string) {
+            sha1 << Containers::ArrayView<const char>{string.data(), string.size()} << Containers::ArrayView<const char>{"\n", 1};
+        };
+        hash("StbTrueTypeFont");
+        sha1 << Containers::arrayCast<const char>(Containers::arrayView(_font->data));
+        hash(Utility::format("{} {} {} {} {} {} {}", size(), cache.textureSize().x(), cache.textureSize().y(), cache.padding().x(), cache.padding().y(), oversample.x(), oversample.y()));
+        sha1 << Containers::arrayCast<const char>(glyphIndicesUnique);
+        cacheFilename = Utility::Path::join(cacheDirectory, Utility::format("{}.glyphcache", sha1.digest().hexString()));
+        if(Implementation::loadGlyphCacheFile(cache, cacheFilename))
+            return;
+    }
+
+    /* Properties of all glyphs to reserve the cache. The box filter needs
+       extra oversample - 1 pixels in each direction. */
     std::vector<Vector2i> glyphSizes;
+    Containers::Array<Range2Di> glyphBoxes{NoInit, glyphIndicesUnique.size()};
     glyphSizes.reserve(glyphIndicesUnique.size());
-    for(Int c: glyphIndicesUnique) {
-        Range2Di box;
-        stbtt_GetGlyphBitmapBox(&_font->info, c, _font->scale, _font->scale, &box.min().x(), &box.min().y(), &box.max().x(), &box.max().y());
-        glyphSizes.push_back(box.size());
+    for(std::size_t i = 0; i != glyphIndicesUnique.size(); ++i) {
+        Range2Di& box = glyphBoxes[i];
+        stbtt_GetGlyphBitmapBox(&_font->info, glyphIndicesUnique[i], scale.x(), scale.y(), &box.min().x(), &box.min().y(), &box.max().x(), &box.max().y());
+        glyphSizes.push_back(box.size() + oversample - Vector2i{1});
     }
 
     /* Create texture atlas */
     /** @todo use Containers::Array for this */
     const std::vector<Range2Di> glyphPositions = cache.reserve(glyphSizes);
 
-    /* Pixmap for a single glyph. We need to flip Y, so it can't be rendered
-       directly into the texture. What a pity. */
-    Range2Di maxBox;
-    stbtt_GetFontBoundingBox(&_font->info, &maxBox.min().x(), &maxBox.min().y(), &maxBox.max().x(), &maxBox.max().y());
-    Containers::Array<UnsignedByte> glyphPixmap{NoInit,
-        std::size_t(maxBox.size().product())};
-
-    /* Render all characters to the atlas and create character map */
+    /* Render all glyphs directly to the atlas. We need to flip Y, which is
+       done by passing a negative stride and a pointer to the last row to
+       stb_truetype. Each glyph is rendered into its own rectangle of the
+       pixmap, so the glyphs can be rendered on multiple threads, each
+       picking the next unrendered one. The pixmap has to be zero-filled as
+       the box filter reads the extra pixels around the rendered glyph. */
     Containers::Array<char> pixmap{ValueInit, std::size_t(cache.textureSize().product())};
+    const Int textureWidth = cache.textureSize().x();
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    std::atomic<std::size_t> next{0};
+    #else
+    std::size_t next = 0;
+    #endif
+    const auto render = [&]() {
+        for(std::size_t i; (i = next++) < glyphPositions.size(); ) {
+            if(!glyphSizes[i].product()) continue;
+            unsigned char* const out = reinterpret_cast<unsigned char*>(pixmap.data()) + (glyphPositions[i].bottom() + glyphSizes[i].y() - 1)*textureWidth + glyphPositions[i].left();
+            float subX, subY;
+            stbtt_MakeGlyphBitmapSubpixelPrefilter(&_font->info, out, glyphSizes[i].x(), glyphSizes[i].y(), -textureWidth, scale.x(), scale.y(), 0.0f, 0.0f, oversample.x(), oversample.y(), &subX, &subY, glyphIndicesUnique[i]);
+        }
+    };
+
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    std::size_t threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = Math::max(Math::min(threadCount, glyphPositions.size()), std::size_t{1});
+
+    /* The calling thread is one of the workers. The font info is only read
+       during rendering, so it can be shared by all threads. */
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{render};
+    render();
+    for(std::thread& thread: threads)
+        thread.join();
+    #else
+    render();
+    #endif
+
+    /* Create character map. The offset is the bottom left corner of the
+       rendered bitmap including the extra pixels for the box filter. The
+       glyph properties are remembered for saving to the cache directory. */
+    Containers::Array<Implementation::GlyphCacheFileGlyph> cachedGlyphs{NoInit, cacheDirectory ? glyphPositions.size() : 0};
     for(std::size_t i = 0; i != glyphPositions.size(); ++i) {
-        /* Render glyph */
-        Range2Di box;
-        stbtt_GetGlyphBitmapBox(&_font->info, glyphIndices[i], _font->scale, _font->scale, &box.min().x(), &box.min().y(), &box.max().x(), &box.max().y());
-        stbtt_MakeGlyphBitmap(&_font->info, glyphPixmap, maxBox.sizeX(), maxBox.sizeY(), maxBox.sizeX(), _font->scale, _font->scale, glyphIndices[i]);
-
-        /* Copy rendered bitmap to texture image */
-        for(Int yin = 0, yout = glyphPositions[i].bottom(), ymax = glyphSizes[i].y(); yin != ymax; ++yin, ++yout)
-            for(Int xin = 0, xout = glyphPositions[i].left(), xmax = glyphSizes[i].x(); xin != xmax; ++xin, ++xout)
-                pixmap[yout*cache.textureSize().x() + xout] = glyphPixmap[(glyphSizes[i].y() - yin - 1)*maxBox.sizeX() + xin];
-
-        /* Insert glyph parameters into cache */
-        cache.insert(glyphIndices[i],
-            Vector2i(box.min().x(), -box.max().y()),
-                     glyphPositions[i]);
+        const Vector2i glyphOffset{glyphBoxes[i].min().x(), -glyphBoxes[i].max().y() - oversample.y() + 1};
+        cache.insert(glyphIndicesUnique[i], glyphOffset, glyphPositions[i]);
+        if(cacheDirectory)
+            cachedGlyphs[i] = {UnsignedInt(glyphIndicesUnique[i]), glyphOffset, glyphPositions[i]};
     }
 
     /* Set cache image */
     Image2D image(PixelFormat::R8Unorm, cache.textureSize(), Utility::move(pixmap));
     cache.setImage({}, image);
+
+    /* Failing to save to the cache isn't fatal, the glyph cache is filled
+       already */
+    if(cacheDirectory && !Implementation::saveGlyphCacheFile(cacheDirectory, cacheFilename, cachedGlyphs, {{}, cache.textureSize()}, image.data()))
+        Warning{} << "Text::StbTrueTypeFont::fillGlyphCache(): can't save the glyph cache to cache directory" << cacheDirectory;
 }
 
 Containers::Pointer<AbstractLayouter> StbTrueTypeFont::doLayout(const AbstractGlyphCache& cache, const Float size, const std::string& text) {
@@ -215,9 +310,9 @@ std::tuple<Range2D, Range2D, Vector2> StbTrueTypeFont::Layouter::doRenderGlyph(c
     /* Normalized texture coordinates */
     const auto textureCoordinates = Range2D(rectangle).scaled(1.0f/Vector2(_cache.textureSize()));
 
-    /* Quad rectangle, computed from texture rectangle, denormalized to
-       requested text size */
-    const auto quadRectangle = Range2D(Range2Di::fromSize(position, rectangle.size())).scaled(Vector2(_textSize/_fontSize));
+    /* Quad rectangle, computed from texture rectangle, scaled down from
+       oversampled pixels, denormalized to requested text size */
+    const auto quadRectangle = Range2D(Range2Di::fromSize(position, rectangle.size())).scaled(1.0f/Vector2{_font.oversample}).translated(_font.oversampleShift).scaled(Vector2(_textSize/_fontSize));
 
     /* Glyph advance, denormalized to requested text size */
     Vector2i advance;
@@ -123,6 +123,45 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::StbTrueTypeFont)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Text-StbTrueTypeFont-behavior Behavior and limitations
+
+Setting the @cb{.ini} oversampleX @ce and @cb{.ini} oversampleY @ce
+@ref Text-StbTrueTypeFont-configuration "configuration options" renders the
+glyphs at a multiple of the resolution and box-filters them, equivalently to
+@cpp stbtt_PackSetOversampling() @ce. Glyph rectangles in the glyph cache are
+then larger by the oversampling factor, @ref layout() scales them back and
+compensates for the subpixel shift caused by the filter. A layouter uses the
+oversampling of the last @ref fillGlyphCache() call, so the glyph cache
+should be filled by the same font instance it's used with.
+
+Glyphs are rendered directly into the glyph cache image, independently of
+each other. Setting the @cb{.ini} threads @ce option to a value other than
+@cpp 1 @ce renders them on multiple threads. The output is the same
+regardless of the thread count. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+application has to be linked to `pthread` on Linux for this to work.
+
+If the @cb{.ini} cacheDirectory @ce option is set, the glyph cache contents
+filled by @ref fillGlyphCache() are saved to given directory, named after a
+SHA-1 hash of the font data, font size, the set of glyphs, glyph cache
+texture size and padding and the oversampling options. A subsequent
+@ref fillGlyphCache() call with the same input fills the glyph cache
+directly from the saved file without rasterizing anything. The glyph cache
+has to be empty in both cases, same as is required by
+@ref AbstractGlyphCache::reserve(). The files are meant to be read only by
+the same build of the plugin, the cache is never cleaned up by the plugin
+and a failure to write to it only prints a warning.
+
+@section Text-StbTrueTypeFont-configuration Plugin-specific configuration
+
+It's possible to tune various options through @ref configuration(). See below
+for all options and their default values:
+
+@snippet MagnumPlugins/StbTrueTypeFont/StbTrueTypeFont.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_STBTRUETYPEFONT_EXPORT StbTrueTypeFont: public AbstractFont {
     public:
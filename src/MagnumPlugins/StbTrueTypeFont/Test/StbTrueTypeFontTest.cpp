@@ -24,10 +24,22 @@
 */
 
 #include <sstream>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/PluginManager/Manager.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/Path.h>
+#include <Magnum/Image.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/Text/AbstractFont.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
 
@@ -44,11 +56,25 @@ struct StbTrueTypeFontTest: TestSuite::Tester {
     void properties();
     void layout();
     void fillGlyphCache();
+    void fillGlyphCacheThreads();
+    void fillGlyphCacheOversample();
+    void fillGlyphCacheInvalidOversample();
+    void fillGlyphCacheCacheDirectory();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractFont> _manager{"nonexistent"};
 };
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+} FillGlyphCacheThreadsData[]{
+    {"2 threads", 2},
+    {"5 threads", 5},
+    {"all threads", 0},
+    {"more threads than glyphs", 100}
+};
+
 StbTrueTypeFontTest::StbTrueTypeFontTest() {
     addTests({&StbTrueTypeFontTest::empty,
               &StbTrueTypeFontTest::invalid,
@@ -57,6 +83,13 @@ StbTrueTypeFontTest::StbTrueTypeFontTest() {
               &StbTrueTypeFontTest::layout,
               &StbTrueTypeFontTest::fillGlyphCache});
 
+    addInstancedTests({&StbTrueTypeFontTest::fillGlyphCacheThreads},
+        Containers::arraySize(FillGlyphCacheThreadsData));
+
+    addTests({&StbTrueTypeFontTest::fillGlyphCacheOversample,
+              &StbTrueTypeFontTest::fillGlyphCacheInvalidOversample,
+              &StbTrueTypeFontTest::fillGlyphCacheCacheDirectory});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef STBTRUETYPEFONT_PLUGIN_FILENAME
@@ -113,6 +146,19 @@ struct DummyGlyphCache: AbstractGlyphCache {
     void doSetImage(const Vector2i&, const ImageView2D&) override {}
 };
 
+struct ImageGlyphCache: AbstractGlyphCache {
+    using AbstractGlyphCache::AbstractGlyphCache;
+
+    GlyphCacheFeatures doFeatures() const override { return {}; }
+    void doSetImage(const Vector2i&, const ImageView2D& image) override {
+        Containers::Array<char> data{NoInit, image.data().size()};
+        Utility::copy(image.data(), data);
+        this->image = Image2D{image.storage(), image.format(), image.size(), Utility::move(data)};
+    }
+
+    Image2D image{PixelFormat::R8Unorm};
+};
+
 void StbTrueTypeFontTest::layout() {
     Containers::Pointer<AbstractFont> font = _manager.instantiate("StbTrueTypeFont");
     CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
@@ -192,6 +238,147 @@ void StbTrueTypeFontTest::fillGlyphCache() {
     /** @todo properly test contents */
 }
 
+void StbTrueTypeFontTest::fillGlyphCacheThreads() {
+    auto&& data = FillGlyphCacheThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("StbTrueTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    /* Fill a cache on a single thread for a reference */
+    ImageGlyphCache expected{Vector2i{256}};
+    font->fillGlyphCache(expected, "abcdefghijklmnopqrstuvwxyz");
+
+    font->configuration().setValue("threads", data.threads);
+    ImageGlyphCache actual{Vector2i{256}};
+    font->fillGlyphCache(actual, "abcdefghijklmnopqrstuvwxyz");
+
+    /* The output should be the same regardless of the thread count */
+    CORRADE_COMPARE(actual.glyphCount(), expected.glyphCount());
+    for(const char c: Containers::StringView{"abcdefghijklmnopqrstuvwxyz"}) {
+        CORRADE_ITERATION(c);
+        const UnsignedInt glyph = font->glyphId(c);
+        CORRADE_COMPARE(actual[glyph].first, expected[glyph].first);
+        CORRADE_COMPARE(actual[glyph].second, expected[glyph].second);
+    }
+    CORRADE_COMPARE_AS(actual.image.data(), expected.image.data(),
+        TestSuite::Compare::Container);
+}
+
+void StbTrueTypeFontTest::fillGlyphCacheOversample() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("StbTrueTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    DummyGlyphCache normal{Vector2i{256}};
+    font->fillGlyphCache(normal, "W");
+    const UnsignedInt glyph = font->glyphId(U'W');
+    const Range2Di normalRectangle = normal[glyph].second;
+    Range2D normalQuad, quad, rectangle, textureCoordinates;
+    Vector2 cursorPosition;
+    std::tie(normalQuad, textureCoordinates) = font->layout(normal, 16.0f, "W")->renderGlyph(0, cursorPosition, rectangle);
+
+    font->configuration().setValue("oversampleX", 3);
+    font->configuration().setValue("oversampleY", 2);
+    DummyGlyphCache oversampled{Vector2i{256}};
+    font->fillGlyphCache(oversampled, "W");
+    const Range2Di oversampledRectangle = oversampled[glyph].second;
+    std::tie(quad, textureCoordinates) = font->layout(oversampled, 16.0f, "W")->renderGlyph(0, cursorPosition, rectangle);
+
+    /* The glyph takes proportionally more space in the cache, plus the extra
+       pixels for the filter */
+    CORRADE_COMPARE_AS(Math::abs(oversampledRectangle.sizeX() - normalRectangle.sizeX()*3 - 2), 3,
+        TestSuite::Compare::LessOrEqual);
+    CORRADE_COMPARE_AS(Math::abs(oversampledRectangle.sizeY() - normalRectangle.sizeY()*2 - 1), 2,
+        TestSuite::Compare::LessOrEqual);
+
+    /* But the laid out quad is roughly the same, it only has the extra
+       filter pixels and differs in rounding */
+    CORRADE_COMPARE_AS(Math::abs(quad.size() - normalQuad.size()).max(), 1.5f,
+        TestSuite::Compare::LessOrEqual);
+    CORRADE_COMPARE_AS(Math::abs(quad.min() - normalQuad.min()).max(), 1.5f,
+        TestSuite::Compare::LessOrEqual);
+}
+
+void StbTrueTypeFontTest::fillGlyphCacheInvalidOversample() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("StbTrueTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    font->configuration().setValue("oversampleX", 0);
+    font->configuration().setValue("oversampleY", 9);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    DummyGlyphCache cache{Vector2i{256}};
+    font->fillGlyphCache(cache, "W");
+    CORRADE_COMPARE(out.str(), "Text::StbTrueTypeFont::fillGlyphCache(): expected oversampling to be between 1 and 8 but got {0, 9}\n");
+}
+
+void StbTrueTypeFontTest::fillGlyphCacheCacheDirectory() {
+    const Containers::String cacheDirectory = Utility::Path::join(STBTRUETYPEFONT_TEST_OUTPUT_DIR, "cache");
+    if(Utility::Path::exists(cacheDirectory)) {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot);
+        CORRADE_VERIFY(files);
+        for(const Containers::String& file: *files)
+            CORRADE_VERIFY(Utility::Path::remove(Utility::Path::join(cacheDirectory, file)));
+    }
+
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("StbTrueTypeFont");
+    font->configuration().setValue("cacheDirectory", cacheDirectory);
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    /* First fill creates the cache directory and saves a file there */
+    ImageGlyphCache expected{Vector2i{256}};
+    font->fillGlyphCache(expected, "abcdefghijklmnopqrstuvwxyz");
+    Containers::String filename;
+    {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot);
+        CORRADE_VERIFY(files);
+        CORRADE_COMPARE(files->size(), 1);
+        CORRADE_VERIFY(files->front().hasSuffix(".glyphcache"));
+        filename = Utility::Path::join(cacheDirectory, files->front());
+    }
+
+    /* Second fill produces the same output from the saved file */
+    ImageGlyphCache actual{Vector2i{256}};
+    font->fillGlyphCache(actual, "abcdefghijklmnopqrstuvwxyz");
+    CORRADE_COMPARE(actual.glyphCount(), expected.glyphCount());
+    for(const char c: Containers::StringView{"abcdefghijklmnopqrstuvwxyz"}) {
+        CORRADE_ITERATION(c);
+        const UnsignedInt glyph = font->glyphId(c);
+        CORRADE_COMPARE(actual[glyph].first, expected[glyph].first);
+        CORRADE_COMPARE(actual[glyph].second, expected[glyph].second);
+    }
+    CORRADE_COMPARE(actual.image.size(), expected.image.size());
+    CORRADE_COMPARE_AS(actual.image.data(), expected.image.data(),
+        TestSuite::Compare::Container);
+
+    /* To verify it's really taken from the file and not rasterized again,
+       modify the last pixel in the file */
+    Containers::Optional<Containers::Array<char>> file = Utility::Path::read(filename);
+    CORRADE_VERIFY(file);
+    file->back() = ~file->back();
+    CORRADE_VERIFY(Utility::Path::write(filename, *file));
+    ImageGlyphCache modified{Vector2i{256}};
+    font->fillGlyphCache(modified, "abcdefghijklmnopqrstuvwxyz");
+    CORRADE_COMPARE(modified.image.data().back(), char(~expected.image.data().back()));
+
+    /* Changing the thread count doesn't affect the output, so it's still a
+       cache hit. A different glyph set or a rendering option isn't. */
+    font->configuration().setValue("threads", 2);
+    ImageGlyphCache threads{Vector2i{256}};
+    font->fillGlyphCache(threads, "abcdefghijklmnopqrstuvwxyz");
+    ImageGlyphCache differentGlyphs{Vector2i{256}};
+    font->fillGlyphCache(differentGlyphs, "abc");
+    font->configuration().setValue("oversampleX", 2);
+    ImageGlyphCache differentOptions{Vector2i{256}};
+    font->fillGlyphCache(differentOptions, "abc");
+    {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot);
+        CORRADE_VERIFY(files);
+        CORRADE_COMPARE(files->size(), 3);
+    }
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Text::Test::StbTrueTypeFontTest)
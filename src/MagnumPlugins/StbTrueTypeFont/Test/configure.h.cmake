@@ -25,3 +25,4 @@
 
 #cmakedefine STBTRUETYPEFONT_PLUGIN_FILENAME "${STBTRUETYPEFONT_PLUGIN_FILENAME}"
 #define TTF_FILE "${TTF_FILE}"
+#define STBTRUETYPEFONT_TEST_OUTPUT_DIR "${STBTRUETYPEFONT_TEST_OUTPUT_DIR}"
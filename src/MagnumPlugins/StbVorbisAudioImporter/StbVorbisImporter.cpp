@@ -27,11 +27,16 @@
 
 #include "StbVorbisImporter.h"
 
+#include <cstdint>
 #include <cstdlib> /* std::free() */
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/ScopeGuard.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/Endianness.h>
+#include <Magnum/Math/Functions.h>
 
 /* GCC 12 and 13 in Release warns about some clearly bogus "maybe
    uninitialized" variables inside stb_vorbis. I DON'T CARE, THE FILE IS PULLED
@@ -48,15 +53,86 @@
 
 namespace Magnum { namespace Audio {
 
+namespace {
+
+Containers::Optional<BufferFormat> formatForChannelCount(const Int numChannels) {
+    /** @todo Floating-point formats */
+    if(numChannels == 1)
+        return BufferFormat::Mono16;
+    else if(numChannels == 2)
+        return BufferFormat::Stereo16;
+    else if(numChannels == 4)
+        return BufferFormat::Quad16;
+    else if(numChannels == 6)
+        return BufferFormat::Surround51Channel16;
+    else if(numChannels == 7)
+        return BufferFormat::Surround61Channel16;
+    else if(numChannels == 8)
+        return BufferFormat::Surround71Channel16;
+
+    Error() << "Audio::StbVorbisImporter::openData(): unsupported channel count"
+            << numChannels << "with" << 16 << "bits per sample";
+    return {};
+}
+
+}
+
+struct StbVorbisImporter::State {
+    explicit State(Containers::Array<char>&& data): data{Utility::move(data)} {}
+
+    ~State() { if(handle) stb_vorbis_close(handle); }
+
+    /* The decoder references the data, so it has to be kept for the whole
+       decoder lifetime */
+    Containers::Array<char> data;
+    stb_vorbis* handle{};
+    UnsignedLong frameCount;
+    /* stb_vorbis can't seek past the last sample, so seeking to the end is
+       tracked separately */
+    bool atEnd = false;
+};
+
 StbVorbisImporter::StbVorbisImporter() = default;
 
 StbVorbisImporter::StbVorbisImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
 
+StbVorbisImporter::~StbVorbisImporter() = default;
+
 ImporterFeatures StbVorbisImporter::doFeatures() const { return ImporterFeature::OpenData; }
 
-bool StbVorbisImporter::doIsOpened() const { return _data; }
+bool StbVorbisImporter::doIsOpened() const { return _data || _state; }
 
 void StbVorbisImporter::doOpenData(Containers::ArrayView<const char> data) {
+    /* In the streaming mode the data is decoded from directly, so it has to
+       be copied first. Only the headers are parsed and the stream length
+       queried, nothing is decoded. */
+    if(configuration().value<bool>("streaming")) {
+        Containers::Array<char> dataCopy{NoInit, data.size()};
+        Utility::copy(data, dataCopy);
+        Containers::Pointer<State> state{InPlaceInit, Utility::move(dataCopy)};
+
+        int error;
+        state->handle = stb_vorbis_open_memory(reinterpret_cast<const UnsignedByte*>(state->data.data()), state->data.size(), &error, nullptr);
+        if(!state->handle) {
+            if(error == VORBIS_outofmem)
+                Error() << "Audio::StbVorbisImporter::openData(): out of memory";
+            else
+                Error() << "Audio::StbVorbisImporter::openData(): the file signature is invalid";
+            return;
+        }
+
+        const stb_vorbis_info info = stb_vorbis_get_info(state->handle);
+        const Containers::Optional<BufferFormat> format = formatForChannelCount(info.channels);
+        if(!format) return;
+
+        state->frameCount = stb_vorbis_stream_length_in_samples(state->handle);
+        _frequency = info.sample_rate;
+        _format = *format;
+        _channelCount = info.channels;
+        _state = Utility::move(state);
+        return;
+    }
+
     Int numChannels, frequency;
     Short* decodedData = nullptr;
 
@@ -73,42 +149,101 @@ void StbVorbisImporter::doOpenData(Containers::ArrayView<const char> data) {
 
     Containers::Array<char> tempData{reinterpret_cast<char*>(decodedData), size_t(samples*numChannels*2),
         [](char* data, size_t) { std::free(data); }};
-    _frequency = frequency;
 
-    /** @todo Floating-point formats */
-    if(numChannels == 1)
-        _format = BufferFormat::Mono16;
-    else if(numChannels == 2)
-        _format = BufferFormat::Stereo16;
-    else if(numChannels == 4)
-        _format = BufferFormat::Quad16;
-    else if(numChannels == 6)
-        _format = BufferFormat::Surround51Channel16;
-    else if(numChannels == 7)
-        _format = BufferFormat::Surround61Channel16;
-    else if(numChannels == 8)
-        _format = BufferFormat::Surround71Channel16;
-    else {
-        Error() << "Audio::StbVorbisImporter::openData(): unsupported channel count"
-                << numChannels << "with" << 16 << "bits per sample";
-        return;
-    }
+    const Containers::Optional<BufferFormat> format = formatForChannelCount(numChannels);
+    if(!format) return;
 
+    _frequency = frequency;
+    _format = *format;
+    _channelCount = numChannels;
     _data = Utility::move(tempData);
 }
 
-void StbVorbisImporter::doClose() { _data = nullptr; }
+void StbVorbisImporter::doClose() {
+    _data = nullptr;
+    _state = nullptr;
+}
 
 BufferFormat StbVorbisImporter::doFormat() const { return _format; }
 
 UnsignedInt StbVorbisImporter::doFrequency() const { return _frequency; }
 
 Containers::Array<char> StbVorbisImporter::doData() {
+    /* In the streaming mode decode everything using a new decoder on the
+       same data, to not affect the position of read() */
+    if(_state) {
+        stb_vorbis* const handle = stb_vorbis_open_memory(reinterpret_cast<const UnsignedByte*>(_state->data.data()), _state->data.size(), nullptr, nullptr);
+        CORRADE_INTERNAL_ASSERT(handle);
+        Containers::ScopeGuard handleClose{handle, stb_vorbis_close};
+
+        const std::size_t sampleCount = _state->frameCount*_channelCount;
+        Containers::Array<char> out{NoInit, sampleCount*sizeof(Short)};
+        const std::size_t frames = stb_vorbis_get_samples_short_interleaved(handle, _channelCount, reinterpret_cast<Short*>(out.data()), sampleCount);
+        CORRADE_INTERNAL_ASSERT(frames == _state->frameCount);
+        return out;
+    }
+
     Containers::Array<char> copy{NoInit, _data.size()};
     Utility::copy(_data, copy);
     return copy;
 }
 
+UnsignedLong StbVorbisImporter::frameCount() const {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::StbVorbisImporter::frameCount(): no file opened", {});
+    return _state ? _state->frameCount : _data.size()/(_channelCount*sizeof(Short));
+}
+
+std::size_t StbVorbisImporter::read(const Containers::ArrayView<char>& data) {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::StbVorbisImporter::read(): no file opened", {});
+    CORRADE_ASSERT(_state,
+        "Audio::StbVorbisImporter::read(): the file wasn't opened with streaming enabled", {});
+    const std::size_t frameSize = _channelCount*sizeof(Short);
+    CORRADE_ASSERT(data.size() % frameSize == 0,
+        "Audio::StbVorbisImporter::read(): expected size to be a multiple of" << frameSize << "bytes but got" << data.size(), {});
+    CORRADE_ASSERT(reinterpret_cast<std::uintptr_t>(data.data()) % alignof(Short) == 0,
+        "Audio::StbVorbisImporter::read(): expected the data to be aligned to" << alignof(Short) << "bytes", {});
+
+    if(_state->atEnd) return 0;
+
+    /* The sample count is passed as an int, so decode in chunks that fit */
+    const std::size_t maxSampleCount = (0x7fffffff/_channelCount)*_channelCount;
+    Containers::ArrayView<Short> samples = Containers::arrayCast<Short>(data);
+    std::size_t frames = 0;
+    while(!samples.isEmpty()) {
+        const std::size_t sampleCount = Math::min(samples.size(), maxSampleCount);
+        const std::size_t decoded = stb_vorbis_get_samples_short_interleaved(_state->handle, _channelCount, samples.data(), sampleCount);
+        frames += decoded;
+        if(decoded*_channelCount != sampleCount) break;
+        samples = samples.exceptPrefix(sampleCount);
+    }
+
+    return frames;
+}
+
+bool StbVorbisImporter::seek(const UnsignedLong frame) {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::StbVorbisImporter::seek(): no file opened", {});
+    CORRADE_ASSERT(_state,
+        "Audio::StbVorbisImporter::seek(): the file wasn't opened with streaming enabled", {});
+    CORRADE_ASSERT(frame <= _state->frameCount,
+        "Audio::StbVorbisImporter::seek(): frame" << frame << "out of range for" << _state->frameCount << "frames", {});
+
+    if(frame == _state->frameCount) {
+        _state->atEnd = true;
+        return true;
+    }
+
+    if(!stb_vorbis_seek(_state->handle, frame)) {
+        Error{} << "Audio::StbVorbisImporter::seek(): can't seek to frame" << frame;
+        return false;
+    }
+
+    _state->atEnd = false;
+    return true;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(StbVorbisAudioImporter, Magnum::Audio::StbVorbisImporter,
@@ -32,6 +32,7 @@
  */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
 #include "MagnumPlugins/StbVorbisAudioImporter/configure.h"
@@ -122,6 +123,37 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::StbVorbisAudioImporter)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Audio-StbVorbisImporter-behavior Behavior and limitations
+
+By default the whole file is decoded on @ref openData() and @ref data()
+returns a copy of the decoded samples.
+
+@subsection Audio-StbVorbisImporter-behavior-streaming Streaming decoding
+
+If the @cb{.ini} streaming @ce
+@ref Audio-StbVorbisImporter-configuration "configuration option" is
+enabled, @ref openData() keeps a copy of the file data and only parses the
+headers and queries the stream length, without decoding anything. Samples are
+then decoded on demand with @ref read() into a caller-provided buffer, which
+can be reused for each call, making it possible to play back long music
+tracks without having the whole decoded PCM in memory. @ref seek() jumps to an
+arbitrary position using the Ogg page granule positions. Same as with
+@ref Audio-DrMp3Importer-behavior-streaming "DrMp3AudioImporter", the
+@ref frameCount(), @ref read() and @ref seek() APIs are virtual, so they can
+be called without linking to the plugin. @ref data() works in the streaming
+mode as well, decoding the whole file without affecting the @ref read()
+position.
+
+@section Audio-StbVorbisImporter-configuration Plugin-specific configuration
+
+It's possible to tune various options through @ref configuration(). See below
+for all options and their default values:
+
+@snippet MagnumPlugins/StbVorbisAudioImporter/StbVorbisImporter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_STBVORBISAUDIOIMPORTER_EXPORT StbVorbisImporter: public AbstractImporter {
     public:
@@ -131,7 +163,50 @@ class MAGNUM_STBVORBISAUDIOIMPORTER_EXPORT StbVorbisImporter: public AbstractImp
         /** @brief Plugin manager constructor */
         explicit StbVorbisImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
+        ~StbVorbisImporter();
+
+        /**
+         * @brief Frame count
+         * @m_since_latest_{plugins}
+         *
+         * Count of samples in each channel. Expects that a file is opened.
+         * Available regardless of whether the @cb{.ini} streaming @ce
+         * option is enabled.
+         */
+        virtual UnsignedLong frameCount() const;
+
+        /**
+         * @brief Decode next frames
+         * @return Count of frames decoded
+         * @m_since_latest_{plugins}
+         *
+         * Decodes as many frames from the current position as fit into
+         * @p data and advances the position by them. Returns less frames
+         * than fit at the end of the stream and @cpp 0 @ce once the end is
+         * reached. Expects that a file is opened with the
+         * @cb{.ini} streaming @ce option enabled and that @p data is aligned
+         * for @relativeref{Magnum,Short} and its size is a multiple of the
+         * frame size, which is the channel count multiplied by
+         * @cpp 2 @ce. See @ref Audio-StbVorbisImporter-behavior-streaming
+         * for more information.
+         */
+        virtual std::size_t read(const Containers::ArrayView<char>& data);
+
+        /**
+         * @brief Seek to given frame
+         * @m_since_latest_{plugins}
+         *
+         * Sets the position from which @ref read() decodes next. Expects
+         * that a file is opened with the @cb{.ini} streaming @ce option
+         * enabled and that @p frame is not larger than @ref frameCount(). If
+         * seeking fails, prints a message to @relativeref{Magnum,Error} and
+         * returns @cpp false @ce.
+         */
+        virtual bool seek(UnsignedLong frame);
+
     private:
+        struct State;
+
         MAGNUM_STBVORBISAUDIOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_STBVORBISAUDIOIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_STBVORBISAUDIOIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
@@ -142,8 +217,10 @@ class MAGNUM_STBVORBISAUDIOIMPORTER_EXPORT StbVorbisImporter: public AbstractImp
         MAGNUM_STBVORBISAUDIOIMPORTER_LOCAL Containers::Array<char> doData() override;
 
         Containers::Array<char> _data;
+        Containers::Pointer<State> _state;
         BufferFormat _format;
         UnsignedInt _frequency;
+        UnsignedInt _channelCount;
 };
 
 }}
@@ -30,10 +30,13 @@
 #include <Corrade/Containers/StringStl.h> /** @todo remove when AbstractImporter is <string>-free */
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
+#include "MagnumPlugins/StbVorbisAudioImporter/StbVorbisImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Audio { namespace Test { namespace {
@@ -50,6 +53,12 @@ struct StbVorbisImporterTest: TestSuite::Tester {
     void mono16();
     void stereo8();
 
+    void streaming();
+    void streamingZeroSamples();
+    void streamingSeek();
+    void streamingNotEnabled();
+    void streamingInvalidSize();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -62,7 +71,13 @@ StbVorbisImporterTest::StbVorbisImporterTest() {
               &StbVorbisImporterTest::zeroSamples,
 
               &StbVorbisImporterTest::mono16,
-              &StbVorbisImporterTest::stereo8});
+              &StbVorbisImporterTest::stereo8,
+
+              &StbVorbisImporterTest::streaming,
+              &StbVorbisImporterTest::streamingZeroSamples,
+              &StbVorbisImporterTest::streamingSeek,
+              &StbVorbisImporterTest::streamingNotEnabled,
+              &StbVorbisImporterTest::streamingInvalidSize});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -134,6 +149,125 @@ void StbVorbisImporterTest::stereo8() {
         }), TestSuite::Compare::Container);
 }
 
+void StbVorbisImporterTest::streaming() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBVORBISAUDIOIMPORTER_TEST_DIR, "stereo8.ogg")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Stereo16);
+    CORRADE_COMPARE(importer->frequency(), 96000);
+
+    StbVorbisImporter& vorbisImporter = static_cast<StbVorbisImporter&>(*importer);
+    CORRADE_COMPARE(vorbisImporter.frameCount(), 1);
+
+    /* The same buffer is reused for every read, the first call fills it
+       partially and the second returns 0 */
+    Short chunk[4*2];
+    CORRADE_COMPARE(vorbisImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 1);
+    CORRADE_COMPARE_AS(Containers::arrayCast<const char>(Containers::arrayView(chunk)).prefix(4),
+        Containers::arrayView<char>({
+            '\x3e', '\x19', '\x1d', '\x17'
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(vorbisImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 0);
+
+    /* data() decodes the whole file again, independently of the read
+       position */
+    CORRADE_COMPARE_AS(importer->data(),
+        Containers::arrayView<char>({
+            '\x3e', '\x19', '\x1d', '\x17'
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(vorbisImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 0);
+}
+
+void StbVorbisImporterTest::streamingZeroSamples() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBVORBISAUDIOIMPORTER_TEST_DIR, "zeroSamples.ogg")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Mono16);
+    CORRADE_COMPARE(importer->frequency(), 96000);
+
+    StbVorbisImporter& vorbisImporter = static_cast<StbVorbisImporter&>(*importer);
+    CORRADE_COMPARE(vorbisImporter.frameCount(), 0);
+
+    Short chunk[16];
+    CORRADE_COMPARE(vorbisImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 0);
+    CORRADE_VERIFY(importer->data().isEmpty());
+}
+
+void StbVorbisImporterTest::streamingSeek() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBVORBISAUDIOIMPORTER_TEST_DIR, "mono16.ogg")));
+
+    StbVorbisImporter& vorbisImporter = static_cast<StbVorbisImporter&>(*importer);
+    CORRADE_COMPARE(vorbisImporter.frameCount(), 2);
+
+    Short chunk[16];
+    CORRADE_VERIFY(vorbisImporter.seek(1));
+    CORRADE_COMPARE(vorbisImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 1);
+    CORRADE_COMPARE_AS(Containers::arrayCast<const char>(Containers::arrayView(chunk)).prefix(2),
+        Containers::arrayView<char>({
+            '\x2b', '\x0a'
+        }), TestSuite::Compare::Container);
+
+    /* Seeking back works as well */
+    CORRADE_VERIFY(vorbisImporter.seek(0));
+    CORRADE_COMPARE(vorbisImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 2);
+    CORRADE_COMPARE_AS(Containers::arrayCast<const char>(Containers::arrayView(chunk)).prefix(4),
+        Containers::arrayView<char>({
+            '\xcd', '\x0a', '\x2b', '\x0a'
+        }), TestSuite::Compare::Container);
+
+    /* Seeking to the end makes read() return nothing, seeking back from
+       there works again */
+    CORRADE_VERIFY(vorbisImporter.seek(vorbisImporter.frameCount()));
+    CORRADE_COMPARE(vorbisImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 0);
+    CORRADE_VERIFY(vorbisImporter.seek(1));
+    CORRADE_COMPARE(vorbisImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk))), 1);
+}
+
+void StbVorbisImporterTest::streamingNotEnabled() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    StbVorbisImporter& vorbisImporter = static_cast<StbVorbisImporter&>(*importer);
+
+    Short chunk[16];
+    std::ostringstream out;
+    Error redirectError{&out};
+    vorbisImporter.frameCount();
+    vorbisImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk)));
+    vorbisImporter.seek(0);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBVORBISAUDIOIMPORTER_TEST_DIR, "mono16.ogg")));
+    vorbisImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk)));
+    vorbisImporter.seek(0);
+    CORRADE_COMPARE(out.str(),
+        "Audio::StbVorbisImporter::frameCount(): no file opened\n"
+        "Audio::StbVorbisImporter::read(): no file opened\n"
+        "Audio::StbVorbisImporter::seek(): no file opened\n"
+        "Audio::StbVorbisImporter::read(): the file wasn't opened with streaming enabled\n"
+        "Audio::StbVorbisImporter::seek(): the file wasn't opened with streaming enabled\n");
+}
+
+void StbVorbisImporterTest::streamingInvalidSize() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBVORBISAUDIOIMPORTER_TEST_DIR, "stereo8.ogg")));
+    StbVorbisImporter& vorbisImporter = static_cast<StbVorbisImporter&>(*importer);
+
+    Short chunk[4];
+    std::ostringstream out;
+    Error redirectError{&out};
+    vorbisImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk)).prefix(6));
+    vorbisImporter.read(Containers::arrayCast<char>(Containers::arrayView(chunk)).sliceSize(1, 4));
+    vorbisImporter.seek(2);
+    CORRADE_COMPARE(out.str(),
+        "Audio::StbVorbisImporter::read(): expected size to be a multiple of 4 bytes but got 6\n"
+        "Audio::StbVorbisImporter::read(): expected the data to be aligned to 2 bytes\n"
+        "Audio::StbVorbisImporter::seek(): frame 2 out of range for 1 frames\n");
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Audio::Test::StbVorbisImporterTest)
@@ -25,8 +25,11 @@
 
 #include "StlImporter.h"
 
+#include <cstdlib>
 #include <cstring>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
@@ -34,10 +37,22 @@
 #include <Corrade/Utility/EndiannessBatch.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Vector3.h>
+#include <Magnum/MeshTools/RemoveDuplicates.h>
 #include <Magnum/Trade/MeshData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+#include "Magnum/Implementation/mapFile.h"
+
 namespace Magnum { namespace Trade {
 
+/* Memory-mapped input file, if the mapFile option was enabled. The `_in`
+   array is a non-owning view on it in that case. */
+struct StlImporter::Mapping {
+    #ifdef MAGNUM_IMPLEMENTATION_MAP_FILE
+    Magnum::Implementation::MappedFile file;
+    #endif
+};
+
 StlImporter::StlImporter() = default;
 
 StlImporter::StlImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
@@ -48,15 +63,249 @@ ImporterFeatures StlImporter::doFeatures() const { return ImporterFeature::OpenD
 
 bool StlImporter::doIsOpened() const { return !!_in; }
 
-void StlImporter::doClose() { _in = Containers::NullOpt; }
+void StlImporter::doClose() {
+    _in = Containers::NullOpt;
+    _mapping = nullptr;
+    _zeroCopyLayout = false;
+}
+
+void StlImporter::doOpenFile(const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenFile", filename};
+    /* If enabled, memory-map the file instead of reading it into memory */
+    #ifdef MAGNUM_IMPLEMENTATION_MAP_FILE
+    if(configuration().value<bool>("mapFile")) {
+        Containers::Optional<Magnum::Implementation::MappedFile> mapped = Magnum::Implementation::openMappedFile("Trade::StlImporter::openFile():", filename, [this](Containers::Array<char>&& data, const DataFlags dataFlags) {
+            doOpenData(Utility::move(data), dataFlags);
+        });
+
+        /* Keep the mapping alive for as long as the file is opened, but only
+           if doOpenData() references it. ASCII files and files rearranged for
+           zeroCopy got copied and the mapping can be dropped right away. */
+        if(mapped && _in && _in->data() == mapped->data()) {
+            _mapping.emplace();
+            _mapping->file = Utility::move(*mapped);
+        }
+        return;
+    }
+    #endif
+
+    AbstractImporter::doOpenFile(filename);
+}
 
 namespace {
+    using namespace Containers::Literals;
+
     /* In the input file, the triangle is represented by 12 floats (3D normal
        followed by three 3D vertices) and 2 extra bytes. */
     constexpr std::ptrdiff_t InputTriangleStride = 12*4 + 2;
+
+    constexpr Double PowersOfTen[]{
+        1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9,
+        1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17,
+        1.0e18, 1.0e19, 1.0e20, 1.0e21, 1.0e22
+    };
+
+    bool isWhitespace(const char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    /* Returns the next whitespace-delimited token and advances past it. The
+       token is empty at the end of the file. */
+    Containers::StringView nextToken(const char*& it, const char* const end) {
+        while(it != end && isWhitespace(*it)) ++it;
+        const char* const begin = it;
+        while(it != end && !isWhitespace(*it)) ++it;
+        return {begin, std::size_t(it - begin)};
+    }
+
+    void skipLine(const char*& it, const char* const end) {
+        while(it != end && *it != '\n') ++it;
+    }
+
+    /* If the mantissa fits into 53 bits and the exponent is small enough, the
+       conversion is a single correctly rounded multiplication or division by
+       an exactly representable power of ten. That covers basically all STL
+       exporters, everything else goes through std::strtod(). */
+    bool parseFloat(const Containers::StringView token, Float& out) {
+        const char* it = token.begin();
+        const char* const end = token.end();
+
+        bool negative = false;
+        if(it != end && (*it == '-' || *it == '+')) {
+            negative = *it == '-';
+            ++it;
+        }
+
+        UnsignedLong mantissa = 0;
+        Int exponent = 0;
+        bool anyDigits = false;
+        bool fastPath = true;
+        for(; it != end && *it >= '0' && *it <= '9'; ++it) {
+            anyDigits = true;
+            if(mantissa < 100000000000000000ull)
+                mantissa = mantissa*10 + (*it - '0');
+            else fastPath = false;
+        }
+        if(it != end && *it == '.') {
+            for(++it; it != end && *it >= '0' && *it <= '9'; ++it) {
+                anyDigits = true;
+                if(mantissa < 100000000000000000ull) {
+                    mantissa = mantissa*10 + (*it - '0');
+                    --exponent;
+                } else fastPath = false;
+            }
+        }
+        if(anyDigits && it != end && (*it == 'e' || *it == 'E')) {
+            ++it;
+            bool negativeExponent = false;
+            if(it != end && (*it == '-' || *it == '+')) {
+                negativeExponent = *it == '-';
+                ++it;
+            }
+            Int explicitExponent = 0;
+            bool anyExponentDigits = false;
+            for(; it != end && *it >= '0' && *it <= '9'; ++it) {
+                anyExponentDigits = true;
+                if(explicitExponent < 1000)
+                    explicitExponent = explicitExponent*10 + (*it - '0');
+            }
+            if(!anyExponentDigits) return false;
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+
+        if(fastPath && anyDigits && it == end && mantissa <= (1ull << 53) &&
+           exponent >= -22 && exponent <= 22) {
+            const Double value = exponent < 0 ?
+                Double(mantissa)/PowersOfTen[-exponent] :
+                Double(mantissa)*PowersOfTen[exponent];
+            out = Float(negative ? -value : value);
+            return true;
+        }
+
+        /* Slow path. The data aren't null-terminated, so copy the token to a
+           local buffer first. Anything longer than that isn't a sane
+           number. */
+        char buffer[64];
+        if(token.size() >= sizeof(buffer)) return false;
+        std::memcpy(buffer, token.data(), token.size());
+        buffer[token.size()] = '\0';
+        char* parsedEnd;
+        out = Float(std::strtod(buffer, &parsedEnd));
+        return parsedEnd == buffer + token.size();
+    }
+
+    bool expectToken(const char*& it, const char* const end, const Containers::StringView expected) {
+        const Containers::StringView token = nextToken(it, end);
+        if(token == expected) return true;
+
+        if(token.isEmpty())
+            Error{} << "Trade::StlImporter::openData(): expected" << expected << "but got end of file";
+        else
+            Error{} << "Trade::StlImporter::openData(): expected" << expected << "but got" << token;
+        return false;
+    }
+
+    bool parseVector(const char*& it, const char* const end, char* const out) {
+        for(std::size_t i = 0; i != 3; ++i) {
+            const Containers::StringView token = nextToken(it, end);
+            Float value;
+            if(!parseFloat(token, value)) {
+                if(token.isEmpty())
+                    Error{} << "Trade::StlImporter::openData(): expected a float but got end of file";
+                else
+                    Error{} << "Trade::StlImporter::openData(): invalid float literal" << token;
+                return false;
+            }
+
+            /* Stored the same way as in a binary file */
+            Utility::Endianness::littleEndianInPlace(value);
+            std::memcpy(out + 4*i, &value, 4);
+        }
+
+        return true;
+    }
+
+    /* Converts an ASCII file to the same layout as a binary file has, so the
+       import itself doesn't need to care */
+    Containers::Optional<Containers::Array<char>> parseAscii(const Containers::ArrayView<const char> data) {
+        Containers::Array<char> out;
+        /* A facet takes at least ~100 bytes as text, so this is not
+           allocating too much */
+        arrayReserve(out, 84 + data.size()/2);
+        arrayAppend(out, ValueInit, 84);
+
+        const char* it = data.begin();
+        const char* const end = data.end();
+        UnsignedInt triangleCount = 0;
+        for(;;) {
+            const Containers::StringView token = nextToken(it, end);
+            if(token.isEmpty()) break;
+
+            /* The solid name is the rest of the line. A file can have more
+               than one solid, all of them are imported as a single mesh. */
+            if(token == "solid"_s || token == "endsolid"_s) {
+                skipLine(it, end);
+                continue;
+            }
+
+            if(token != "facet"_s) {
+                Error{} << "Trade::StlImporter::openData(): expected facet or endsolid but got" << token;
+                return {};
+            }
+
+            const Containers::ArrayView<char> triangle = arrayAppend(out, NoInit, InputTriangleStride);
+            if(!expectToken(it, end, "normal"_s) ||
+               !parseVector(it, end, triangle.data()) ||
+               !expectToken(it, end, "outer"_s) ||
+               !expectToken(it, end, "loop"_s))
+                return {};
+            for(std::size_t i = 0; i != 3; ++i)
+                if(!expectToken(it, end, "vertex"_s) ||
+                   !parseVector(it, end, triangle.data() + 12 + 12*i))
+                    return {};
+            if(!expectToken(it, end, "endloop"_s) ||
+               !expectToken(it, end, "endfacet"_s))
+                return {};
+
+            /* The attribute byte count, unused */
+            triangle[48] = triangle[49] = 0;
+            ++triangleCount;
+        }
+
+        Utility::Endianness::littleEndianInPlace(triangleCount);
+        std::memcpy(out.data() + 80, &triangleCount, 4);
+
+        /* GCC 4.8 needs extra help here */
+        return Containers::optional(Utility::move(out));
+    }
+
+    /* Rearranges the triangle records after the header in place to have all
+       positions first, followed by all normals, both in native endianness.
+       The positions end up overwriting most of the normals, so those have to
+       be copied away first. */
+    void rearrangeForZeroCopy(const Containers::ArrayView<char> data) {
+        const std::size_t triangleCount = (data.size() - 84)/InputTriangleStride;
+        char* const triangles = data.data() + 84;
+
+        Containers::Array<Vector3> normals{NoInit, triangleCount};
+        Utility::copy(Containers::StridedArrayView1D<const Vector3>{data,
+            reinterpret_cast<const Vector3*>(triangles),
+            triangleCount, InputTriangleStride}, normals);
+
+        /* The destination is always before the source, so this never
+           overwrites positions that weren't moved yet */
+        for(std::size_t i = 0; i != triangleCount; ++i)
+            std::memmove(triangles + 3*sizeof(Vector3)*i,
+                triangles + InputTriangleStride*i + sizeof(Vector3),
+                3*sizeof(Vector3));
+        Utility::copy(normals, Containers::arrayCast<Vector3>(data.sliceSize(84 + 3*sizeof(Vector3)*triangleCount, sizeof(Vector3)*triangleCount)));
+
+        Utility::Endianness::littleEndianInPlace(Containers::arrayCast<Float>(data.sliceSize(84, 4*sizeof(Vector3)*triangleCount)));
+    }
 }
 
 void StlImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     /* At this point we can't even check if it's an ASCII or binary file, bail
        out */
     if(data.size() < 5) {
@@ -64,8 +313,18 @@ void StlImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
         return;
     }
 
-    if(std::memcmp(data, "solid", 5) == 0) {
-        Error{} << "Trade::StlImporter::openData(): ASCII STL files are not supported, sorry";
+    /* Binary files can start with "solid" as well, as the 80-byte header
+       isn't checked by anything. Treat the file as ASCII only if the size
+       doesn't match the binary triangle count. */
+    const bool zeroCopy = configuration().value<bool>("zeroCopy");
+    if(std::memcmp(data, "solid", 5) == 0 && (data.size() < 84 ||
+       data.size() != 84 + InputTriangleStride*std::size_t(Utility::Endianness::littleEndian(*reinterpret_cast<const UnsignedInt*>(data + 80)))))
+    {
+        _in = parseAscii(data);
+        if(_in && zeroCopy) {
+            rearrangeForZeroCopy(*_in);
+            _zeroCopyLayout = true;
+        }
         return;
     }
 
@@ -81,13 +340,20 @@ void StlImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
         return;
     }
 
-    /* Take over the existing array or copy the data if we can't */
-    if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
+    /* Take over the existing array or copy the data if we can't. With
+       zeroCopy the data get rearranged in place, which can't be done on
+       memory we don't own, so it's copied in that case as well. */
+    if(dataFlags & DataFlag::Owned || (dataFlags & DataFlag::ExternallyOwned && !zeroCopy)) {
         _in = Utility::move(data);
     } else {
         _in = Containers::Array<char>{NoInit, data.size()};
         Utility::copy(data, *_in);
     }
+
+    if(zeroCopy) {
+        rearrangeForZeroCopy(*_in);
+        _zeroCopyLayout = true;
+    }
 }
 
 UnsignedInt StlImporter::doMeshCount() const { return 1; }
@@ -97,6 +363,7 @@ UnsignedInt StlImporter::doMeshLevelCount(UnsignedInt) {
 }
 
 Containers::Optional<MeshData> StlImporter::doMesh(UnsignedInt, UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMesh"};
     /* We either have per-face in the second level or we convert them to
        per-vertex, never both */
     const bool perFaceToPerVertex = configuration().value<bool>("perFaceToPerVertex");
@@ -104,14 +371,54 @@ Containers::Optional<MeshData> StlImporter::doMesh(UnsignedInt, UnsignedInt leve
 
     Containers::ArrayView<const char> in = _in->exceptPrefix(84);
 
-    /* Make 2D views on input normals and positions */
+    /* Make 2D views on input normals and positions, either in the original
+       triangle records or in the layout rearranged for zero-copy import */
     const std::size_t triangleCount = in.size()/InputTriangleStride;
-    Containers::StridedArrayView2D<const Vector3> inputNormals{in,
-        reinterpret_cast<const Vector3*>(in.data() + 0),
-        {triangleCount, 1}, {InputTriangleStride, 0}};
-    Containers::StridedArrayView2D<const Vector3> inputPositions{in,
-        reinterpret_cast<const Vector3*>(in.data() + sizeof(Vector3)),
-        {triangleCount, 3}, {InputTriangleStride, sizeof(Vector3)}};
+    Containers::StridedArrayView2D<const Vector3> inputNormals;
+    Containers::StridedArrayView2D<const Vector3> inputPositions;
+    if(_zeroCopyLayout) {
+        inputNormals = Containers::StridedArrayView2D<const Vector3>{in,
+            reinterpret_cast<const Vector3*>(in.data() + 3*sizeof(Vector3)*triangleCount),
+            {triangleCount, 1}, {sizeof(Vector3), 0}};
+        inputPositions = Containers::StridedArrayView2D<const Vector3>{in,
+            reinterpret_cast<const Vector3*>(in.data()),
+            {triangleCount, 3}, {3*sizeof(Vector3), sizeof(Vector3)}};
+    } else {
+        inputNormals = Containers::StridedArrayView2D<const Vector3>{in,
+            reinterpret_cast<const Vector3*>(in.data() + 0),
+            {triangleCount, 1}, {InputTriangleStride, 0}};
+        inputPositions = Containers::StridedArrayView2D<const Vector3>{in,
+            reinterpret_cast<const Vector3*>(in.data() + sizeof(Vector3)),
+            {triangleCount, 3}, {InputTriangleStride, sizeof(Vector3)}};
+    }
+
+    /* If the data were rearranged for zero-copy import and the normals don't
+       need to be duplicated for each vertex, both levels are just views on
+       the data */
+    if(_zeroCopyLayout && !perFaceToPerVertex) {
+        Containers::ArrayView<const char> vertexData;
+        MeshAttributeData attribute;
+        if(level == 0) {
+            vertexData = in.prefix(3*sizeof(Vector3)*triangleCount);
+            attribute = MeshAttributeData{MeshAttribute::Position,
+                Containers::arrayCast<const Vector3>(vertexData)};
+        } else {
+            vertexData = in.sliceSize(3*sizeof(Vector3)*triangleCount, sizeof(Vector3)*triangleCount);
+            attribute = MeshAttributeData{MeshAttribute::Normal,
+                Containers::arrayCast<const Vector3>(vertexData)};
+        }
+
+        MeshData mesh{level == 0 ? MeshPrimitive::Triangles : MeshPrimitive::Faces,
+            {}, vertexData, Containers::Array<MeshAttributeData>{InPlaceInit, {attribute}}};
+
+        /* Deduplication makes a copy, so zero-copy import doesn't make much
+           sense in combination with it, but handle it anyway */
+        if(level == 0 && configuration().value<bool>("generateIndices"))
+            mesh = MeshTools::removeDuplicates(mesh);
+
+        /* GCC 4.8 needs extra help here */
+        return Containers::optional(Utility::move(mesh));
+    }
 
     /* Decide on output vertex stride and attribute count */
     std::size_t vertexCount;
@@ -143,8 +450,9 @@ Containers::Optional<MeshData> StlImporter::doMesh(UnsignedInt, UnsignedInt leve
 
         /* Endian conversion. This is needed only on Big-Endian systems, but
            it's enabled always to minimize a risk of accidental breakage when
-           we can't test. */
-        for(Containers::StridedArrayView1D<Float> component:
+           we can't test. Data rearranged for zero-copy import are in native
+           endianness already. */
+        if(!_zeroCopyLayout) for(Containers::StridedArrayView1D<Float> component:
             Containers::arrayCast<2, Float>(positions).transposed<0, 1>())
                 Utility::Endianness::littleEndianInPlace(component);
 
@@ -167,8 +475,9 @@ Containers::Optional<MeshData> StlImporter::doMesh(UnsignedInt, UnsignedInt leve
 
         /* Endian conversion. This is needed only on Big-Endian systems, but
            it's enabled always to minimize a risk of accidental breakage when
-           we can't test. */
-        for(Containers::StridedArrayView1D<Float> component:
+           we can't test. Data rearranged for zero-copy import are in native
+           endianness already. */
+        if(!_zeroCopyLayout) for(Containers::StridedArrayView1D<Float> component:
             Containers::arrayCast<2, Float>(normals).transposed<0, 1>())
                 Utility::Endianness::littleEndianInPlace(component);
 
@@ -179,8 +488,16 @@ Containers::Optional<MeshData> StlImporter::doMesh(UnsignedInt, UnsignedInt leve
     CORRADE_INTERNAL_ASSERT(offset == std::size_t(outputVertexStride));
     CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
 
-    return MeshData{level == 0 ? MeshPrimitive::Triangles : MeshPrimitive::Faces,
+    MeshData mesh{level == 0 ? MeshPrimitive::Triangles : MeshPrimitive::Faces,
         Utility::move(vertexData), Utility::move(attributeData)};
+
+    /* Deduplicate the data into an indexed mesh if desired. Per-face normals
+       in the second level can't be indexed. */
+    if(level == 0 && configuration().value<bool>("generateIndices"))
+        mesh = MeshTools::removeDuplicates(mesh);
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(mesh));
 }
 
 }}
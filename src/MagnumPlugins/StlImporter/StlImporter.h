@@ -32,6 +32,7 @@
 
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "MagnumPlugins/StlImporter/configure.h"
@@ -58,7 +59,7 @@ namespace Magnum { namespace Trade {
 @brief STL importer plugin
 @m_since_{plugins,2020,06}
 
-Imports normal and vertex information from binary
+Imports normal and vertex information from binary and ASCII
 [Stereolitography STL](https://en.wikipedia.org/wiki/STL_(file_format))
 (`*.stl`) files.
 
@@ -106,17 +107,63 @@ See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 
 @section Trade-StlImporter-behavior Behavior and limitations
 
-The file is always imported as a non-indexed triangle mesh with per-face
+The file is by default imported as a non-indexed triangle mesh with per-face
 normals (i.e., same normal for all vertices in the triangle). Both positions
 and normals are imported as @ref VertexFormat::Vector3. Using the
-@cb{.ini} perFaceToPerVertex @ce @ref Trade-StanfordImporter-configuration "configuration option"
+@cb{.ini} perFaceToPerVertex @ce @ref Trade-StlImporter-configuration "configuration option"
 it's possible to import per-face normals separately without duplicating them
 for each vertex --- useful for example when you want to deduplicate the
 positions and generate smooth normals from these.
 
-Similarly to @ref StanfordImporter, ASCII files are not supported, only binary.
-The [non-standard extensions for vertex colors](https://en.wikipedia.org/wiki/STL_(file_format)#Color_in_binary_STL)
-are also not supported due to a lack of generally available files for testing.
+Enabling the @cb{.ini} generateIndices @ce option deduplicates the vertices
+using @ref MeshTools::removeDuplicates(const Trade::MeshData&), producing an
+indexed mesh with @ref MeshIndexType::UnsignedInt indices. As only bitwise
+equal vertices are merged, in combination with
+@cb{.ini} perFaceToPerVertex @ce the deduplication is effective only for
+triangles with the same normal. With @cb{.ini} perFaceToPerVertex @ce
+disabled, the positions are deduplicated alone, which for typical CAD meshes
+reduces the vertex count about six times. The per-face normals in the second
+mesh level stay non-indexed.
+
+A file is treated as ASCII if it starts with `solid` and its size doesn't
+match the triangle count of a binary file, as binary files may start with
+`solid` as well. ASCII files are converted to the binary representation on
+opening, multiple `solid` blocks in a single file are all imported into a
+single mesh. The [non-standard extensions for vertex colors](https://en.wikipedia.org/wiki/STL_(file_format)#Color_in_binary_STL)
+are not supported due to a lack of generally available files for testing.
+
+@subsection Trade-StlImporter-behavior-zero-copy Zero-copy import
+
+A binary STL file stores each triangle as a 50-byte record with the normal
+and three positions, so consecutive positions aren't separated by a
+uniform stride, and it's not possible to make a view on them directly.
+Enabling the @cb{.ini} zeroCopy @ce option instead rearranges the data
+in place on opening to have all positions first, followed by all normals.
+With @cb{.ini} perFaceToPerVertex @ce disabled, both mesh levels are then
+returned as views on the importer-owned memory, with empty
+@relativeref{Trade::MeshData,vertexDataFlags()}, so importing a large file
+doesn't need a second copy of the data. The views are valid only as long as
+the file stays opened. The rearrangement needs a temporary copy of just the
+normals, which is a quarter of the file size.
+
+If the file is opened with @relativeref{AbstractImporter,openMemory()} or
+memory-mapped with the @cb{.ini} mapFile @ce option described below, the
+memory isn't owned by the importer and can't be modified, so it gets
+copied first. With @cb{.ini} perFaceToPerVertex @ce enabled, the normals have
+to be duplicated for each vertex and so the level 0 mesh is copied as usual.
+The option has to be set before opening the file.
+
+@subsection Trade-StlImporter-behavior-memory-mapping Memory-mapped import
+
+As @ref openData() copies the data unless their ownership is transferred and
+@ref openFile() reads the whole file into memory, enabling the
+@cb{.ini} mapFile @ce option makes @ref openFile() memory-map the file with
+@relativeref{Corrade,Utility::Path::mapRead()} instead. A binary file is then
+parsed directly from the mapped memory, which is referenced for as long as the
+file stays opened, and the triangle data are paged in from the disk only when
+a mesh is imported. ASCII files and files opened with @cb{.ini} zeroCopy @ce
+enabled are copied on opening as usual. This is available only on platforms
+where memory-mapping is supported.
 
 @section Trade-StlImporter-configuration Plugin-specific configuration
 
@@ -142,6 +189,7 @@ class MAGNUM_STLIMPORTER_EXPORT StlImporter: public AbstractImporter {
         MAGNUM_STLIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
 
         MAGNUM_STLIMPORTER_LOCAL bool doIsOpened() const override;
+        MAGNUM_STLIMPORTER_LOCAL void doOpenFile(Containers::StringView filename) override;
         MAGNUM_STLIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
         MAGNUM_STLIMPORTER_LOCAL void doClose() override;
 
@@ -149,7 +197,11 @@ class MAGNUM_STLIMPORTER_EXPORT StlImporter: public AbstractImporter {
         MAGNUM_STLIMPORTER_LOCAL UnsignedInt doMeshLevelCount(UnsignedInt id) override;
         MAGNUM_STLIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
 
+        struct Mapping;
+
         Containers::Optional<Containers::Array<char>> _in;
+        Containers::Pointer<Mapping> _mapping;
+        bool _zeroCopyLayout{};
 };
 
 }}
@@ -23,11 +23,13 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cstring>
 #include <sstream>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
@@ -45,15 +47,22 @@ struct StlImporterTest: TestSuite::Tester {
     explicit StlImporterTest();
 
     void invalid();
-    void ascii();
+    void invalidAscii();
     void almostAsciiButNotActually();
+    void binaryStartingWithSolid();
     void emptyBinary();
-    void binary();
+    void emptyAscii();
+    void parse();
+    void generateIndices();
+    void zeroCopy();
+    void mapFile();
 
     void openMemory();
     void openTwice();
     void importTwice();
 
+    void instrumentation();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -101,6 +110,32 @@ const struct {
 
 const struct {
     const char* name;
+    const char* data;
+    const char* message;
+} InvalidAsciiData[] {
+    {"unexpected keyword", "solid a\nfacet normal 0 0 1\nouter loop\nvertices",
+        "expected vertex but got vertices"},
+    {"truncated facet", "solid a\nfacet normal 0 0 1\nouter loop\n",
+        "expected vertex but got end of file"},
+    {"truncated after a facet",
+        "solid a\nfacet normal 0 0 1\nouter loop\nvertex 0 0 0\nvertex 1 0 0\nvertex 0 1 0\nendloop\nendfacet\nfacet",
+        "expected normal but got end of file"},
+    {"garbage after a facet",
+        "solid a\nfacet normal 0 0 1\nouter loop\nvertex 0 0 0\nvertex 1 0 0\nvertex 0 1 0\nendloop\nendfacet\nvertex 0 0 0",
+        "expected facet or endsolid but got vertex"},
+    {"missing loop", "solid a\nfacet normal 0 0 1\nouter\nvertex 0 0 0",
+        "expected loop but got vertex"},
+    {"invalid float", "solid a\nfacet normal 0 0.5x 1\n",
+        "invalid float literal 0.5x"},
+    {"invalid exponent", "solid a\nfacet normal 0 1e 1\n",
+        "invalid float literal 1e"},
+    {"missing float", "solid a\nfacet normal 0 0",
+        "expected a float but got end of file"}
+};
+
+const struct {
+    const char* name;
+    const char* filename;
     bool perFaceToPerVertex;
     UnsignedInt level;
     UnsignedInt levelCount;
@@ -108,14 +143,65 @@ const struct {
     UnsignedInt vertexCount;
     UnsignedInt attributeCount;
     bool positions, normals;
-} BinaryData[] {
-    {"", true, 0, 1, MeshPrimitive::Triangles, 6, 2, true, true},
-    {"per-face normals, level 0",
+} ParseData[] {
+    {"binary", "binary.stl",
+        true, 0, 1, MeshPrimitive::Triangles, 6, 2, true, true},
+    {"binary, per-face normals, level 0", "binary.stl",
+        false, 0, 2, MeshPrimitive::Triangles, 6, 1, true, false},
+    {"binary, per-face normals, level 1", "binary.stl",
+        false, 1, 2, MeshPrimitive::Faces, 2, 1, false, false},
+    {"ASCII", "ascii.stl",
+        true, 0, 1, MeshPrimitive::Triangles, 6, 2, true, true},
+    {"ASCII, per-face normals, level 0", "ascii.stl",
         false, 0, 2, MeshPrimitive::Triangles, 6, 1, true, false},
-    {"per-face normals, level 1",
+    {"ASCII, per-face normals, level 1", "ascii.stl",
         false, 1, 2, MeshPrimitive::Faces, 2, 1, false, false}
 };
 
+/* Two triangles of a quad with identical normals, sharing an edge, plus a
+   third triangle sharing one edge with the second but with a different
+   normal */
+constexpr const char GenerateIndicesAsciiData[] =
+    "solid quad\n"
+    "facet normal 0 0 1\n"
+    "outer loop\n"
+    "vertex 0 0 0\nvertex 1 0 0\nvertex 1 1 0\n"
+    "endloop\n"
+    "endfacet\n"
+    "facet normal 0 0 1\n"
+    "outer loop\n"
+    "vertex 0 0 0\nvertex 1 1 0\nvertex 0 1 0\n"
+    "endloop\n"
+    "endfacet\n"
+    "facet normal 0 1 0\n"
+    "outer loop\n"
+    "vertex 0 1 0\nvertex 1 1 0\nvertex 1 1 1\n"
+    "endloop\n"
+    "endfacet\n"
+    "endsolid quad\n";
+
+const struct {
+    const char* name;
+    bool perFaceToPerVertex;
+    UnsignedInt vertexCount;
+    UnsignedInt attributeCount;
+} GenerateIndicesData[] {
+    {"", true, 7, 2},
+    {"per-face normals", false, 5, 1}
+};
+
+const struct {
+    const char* name;
+    const char* filename;
+    bool perFaceToPerVertex;
+    bool openMemory;
+} ZeroCopyData[] {
+    {"binary", "binary.stl", false, false},
+    {"binary, openMemory()", "binary.stl", false, true},
+    {"binary, per-vertex normals", "binary.stl", true, false},
+    {"ASCII", "ascii.stl", false, false},
+};
+
 /* Shared among all plugins that implement data copying optimizations */
 const struct {
     const char* name;
@@ -136,18 +222,32 @@ StlImporterTest::StlImporterTest() {
     addInstancedTests({&StlImporterTest::invalid},
         Containers::arraySize(InvalidData));
 
-    addTests({&StlImporterTest::ascii,
-              &StlImporterTest::almostAsciiButNotActually,
-              &StlImporterTest::emptyBinary});
+    addInstancedTests({&StlImporterTest::invalidAscii},
+        Containers::arraySize(InvalidAsciiData));
+
+    addTests({&StlImporterTest::almostAsciiButNotActually,
+              &StlImporterTest::binaryStartingWithSolid,
+              &StlImporterTest::emptyBinary,
+              &StlImporterTest::emptyAscii});
+
+    addInstancedTests({&StlImporterTest::parse},
+        Containers::arraySize(ParseData));
+
+    addInstancedTests({&StlImporterTest::generateIndices},
+        Containers::arraySize(GenerateIndicesData));
 
-    addInstancedTests({&StlImporterTest::binary},
-        Containers::arraySize(BinaryData));
+    addInstancedTests({&StlImporterTest::zeroCopy},
+        Containers::arraySize(ZeroCopyData));
+
+    addTests({&StlImporterTest::mapFile});
 
     addInstancedTests({&StlImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
     addTests({&StlImporterTest::openTwice,
-              &StlImporterTest::importTwice});
+              &StlImporterTest::importTwice,
+
+              &StlImporterTest::instrumentation});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -169,13 +269,17 @@ void StlImporterTest::invalid() {
         Utility::formatString("Trade::StlImporter::openData(): {}\n", data.message));
 }
 
-void StlImporterTest::ascii() {
+void StlImporterTest::invalidAscii() {
+    auto&& data = InvalidAsciiData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
 
     std::ostringstream out;
     Error redirectError{&out};
-    CORRADE_VERIFY(!importer->openFile(Utility::Path::join(STLIMPORTER_TEST_DIR, "ascii.stl")));
-    CORRADE_COMPARE(out.str(), "Trade::StlImporter::openData(): ASCII STL files are not supported, sorry\n");
+    CORRADE_VERIFY(!importer->openData({data.data, std::strlen(data.data)}));
+    CORRADE_COMPARE(out.str(),
+        Utility::formatString("Trade::StlImporter::openData(): {}\n", data.message));
 }
 
 void StlImporterTest::almostAsciiButNotActually() {
@@ -202,6 +306,35 @@ void StlImporterTest::almostAsciiButNotActually() {
     CORRADE_COMPARE(mesh->attributeCount(), 2);
 }
 
+void StlImporterTest::binaryStartingWithSolid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+
+    constexpr const char data[]{
+        /* 80-byte header, starting exactly like an ascii file, but the file
+           size matches the triangle count so it should be imported as
+           binary */
+        's', 'o', 'l', 'i', 'd', ' ', 'x', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+
+        1, 0, 0, 0, /* One triangle */
+
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    };
+
+    CORRADE_VERIFY(importer->openData(data));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(!mesh->isIndexed());
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(mesh->vertexCount(), 3);
+    CORRADE_COMPARE(mesh->attributeCount(), 2);
+}
+
 void StlImporterTest::emptyBinary() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
 
@@ -225,8 +358,21 @@ void StlImporterTest::emptyBinary() {
     CORRADE_COMPARE(mesh->attributeCount(), 2);
 }
 
-void StlImporterTest::binary() {
-    auto&& data = BinaryData[testCaseInstanceId()];
+void StlImporterTest::emptyAscii() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+
+    CORRADE_VERIFY(importer->openData(Containers::arrayView("solid empty\nendsolid empty\n").exceptSuffix(1)));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(!mesh->isIndexed());
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(mesh->vertexCount(), 0);
+    CORRADE_COMPARE(mesh->attributeCount(), 2);
+}
+
+void StlImporterTest::parse() {
+    auto&& data = ParseData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
 
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
@@ -235,7 +381,7 @@ void StlImporterTest::binary() {
     if(!data.perFaceToPerVertex)
         importer->configuration().setValue("perFaceToPerVertex", data.perFaceToPerVertex);
 
-    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STLIMPORTER_TEST_DIR, "binary.stl")));
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STLIMPORTER_TEST_DIR, data.filename)));
 
     CORRADE_COMPARE(importer->meshCount(), 1);
     CORRADE_COMPARE(importer->meshLevelCount(0), data.levelCount);
@@ -283,8 +429,160 @@ void StlImporterTest::binary() {
     } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
 }
 
+void StlImporterTest::generateIndices() {
+    auto&& data = GenerateIndicesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+    importer->configuration().setValue("generateIndices", true);
+    importer->configuration().setValue("perFaceToPerVertex", data.perFaceToPerVertex);
+    CORRADE_VERIFY(importer->openData(Containers::arrayView(GenerateIndicesAsciiData).exceptSuffix(1)));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedInt);
+    CORRADE_COMPARE(mesh->indexCount(), 9);
+    CORRADE_COMPARE(mesh->vertexCount(), data.vertexCount);
+    CORRADE_COMPARE(mesh->attributeCount(), data.attributeCount);
+
+    /* The deduplicated mesh should reference the same positions as the
+       original triangle soup */
+    Containers::Array<Vector3> positions = mesh->positions3DAsArray();
+    Containers::Array<UnsignedInt> indices = mesh->indicesAsArray();
+    Containers::Array<Vector3> expanded{NoInit, indices.size()};
+    for(std::size_t i = 0; i != indices.size(); ++i)
+        expanded[i] = positions[indices[i]];
+    CORRADE_COMPARE_AS(Containers::arrayView(expanded), Containers::arrayView<Vector3>({
+        {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f},
+        {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 1.0f}
+    }), TestSuite::Compare::Container);
+
+    /* The per-face normals stay non-indexed */
+    if(!data.perFaceToPerVertex) {
+        Containers::Optional<MeshData> faces = importer->mesh(0, 1);
+        CORRADE_VERIFY(faces);
+        CORRADE_COMPARE(faces->primitive(), MeshPrimitive::Faces);
+        CORRADE_VERIFY(!faces->isIndexed());
+        CORRADE_COMPARE(faces->vertexCount(), 3);
+    }
+}
+
+void StlImporterTest::zeroCopy() {
+    auto&& data = ZeroCopyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    importer->configuration().setValue("perFaceToPerVertex", data.perFaceToPerVertex);
+
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(STLIMPORTER_TEST_DIR, data.filename));
+    CORRADE_VERIFY(memory);
+    Containers::Array<char> original{NoInit, memory->size()};
+    Utility::copy(*memory, original);
+    if(data.openMemory)
+        CORRADE_VERIFY(importer->openMemory(*memory));
+    else
+        CORRADE_VERIFY(importer->openData(*memory));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(!mesh->isIndexed());
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {1.0f, 2.0f, 3.0f},
+            {4.0f, 5.0f, 6.0f},
+            {7.0f, 8.0f, 9.0f},
+
+            {1.1f, 2.1f, 3.1f},
+            {4.1f, 5.1f, 6.1f},
+            {7.1f, 8.1f, 9.1f}
+        }), TestSuite::Compare::Container);
+
+    /* The memory passed to openMemory() isn't modified, the importer works
+       on a copy */
+    if(data.openMemory)
+        CORRADE_COMPARE_AS(Containers::arrayView(*memory),
+            Containers::arrayView(original),
+            TestSuite::Compare::Container);
+
+    /* With per-vertex normals the data have to be copied */
+    if(data.perFaceToPerVertex) {
+        CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+        CORRADE_COMPARE(mesh->attributeCount(), 2);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+            Containers::arrayView<Vector3>({
+                {0.1f, 0.2f, 0.3f},
+                {0.1f, 0.2f, 0.3f},
+                {0.1f, 0.2f, 0.3f},
+
+                {0.4f, 0.5f, 0.6f},
+                {0.4f, 0.5f, 0.6f},
+                {0.4f, 0.5f, 0.6f}
+            }), TestSuite::Compare::Container);
+        return;
+    }
+
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->attributeCount(), 1);
+    CORRADE_COMPARE(mesh->attributeStride(MeshAttribute::Position), sizeof(Vector3));
+
+    Containers::Optional<MeshData> faces = importer->mesh(0, 1);
+    CORRADE_VERIFY(faces);
+    CORRADE_COMPARE(faces->primitive(), MeshPrimitive::Faces);
+    CORRADE_COMPARE(faces->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE_AS(faces->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {0.1f, 0.2f, 0.3f},
+            {0.4f, 0.5f, 0.6f}
+        }), TestSuite::Compare::Container);
+
+    /* Both levels reference the same importer-owned memory */
+    CORRADE_COMPARE(static_cast<const char*>(faces->vertexData().data()),
+        static_cast<const char*>(mesh->vertexData().data()) + mesh->vertexData().size());
+}
+
+void StlImporterTest::mapFile() {
+    #if !defined(CORRADE_TARGET_UNIX) && (!defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_SKIP("Memory mapping not available on this platform.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+    importer->configuration().setValue("mapFile", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STLIMPORTER_TEST_DIR, "binary.stl")));
+
+    /* The mesh data are read from the mapping on import, which has to stay
+       alive for that */
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {1.0f, 2.0f, 3.0f},
+            {4.0f, 5.0f, 6.0f},
+            {7.0f, 8.0f, 9.0f},
+
+            {1.1f, 2.1f, 3.1f},
+            {4.1f, 5.1f, 6.1f},
+            {7.1f, 8.1f, 9.1f}
+        }), TestSuite::Compare::Container);
+
+    /* With zeroCopy the data get copied to be rearranged, the importer
+       shouldn't reference the mapping afterwards */
+    importer->configuration().setValue("zeroCopy", true);
+    importer->configuration().setValue("perFaceToPerVertex", false);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STLIMPORTER_TEST_DIR, "binary.stl")));
+    mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->vertexCount(), 6);
+    CORRADE_COMPARE(mesh->attribute<Vector3>(MeshAttribute::Position)[4], (Vector3{4.1f, 5.1f, 6.1f}));
+    #endif
+}
+
 void StlImporterTest::openMemory() {
-    /* Same as (a subset of) binary() except that it uses openData() &
+    /* Same as (a subset of) parse() except that it uses openData() &
        openMemory() instead of openFile() to test data copying on import */
 
     auto&& data = OpenMemoryData[testCaseInstanceId()];
@@ -335,6 +633,40 @@ void StlImporterTest::importTwice() {
     }
 }
 
+void StlImporterTest::instrumentation() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+
+    /* Disabled by default, nothing recorded */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STLIMPORTER_TEST_DIR, "binary.stl")));
+    CORRADE_VERIFY(importer->mesh(0));
+    CORRADE_VERIFY(!importer->configuration().group("instrumentationRecords"));
+
+    importer->configuration().setValue("instrumentation", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STLIMPORTER_TEST_DIR, "binary.stl")));
+    CORRADE_VERIFY(importer->mesh(0));
+
+    /* The file is opened through doOpenData(), so there's no filename */
+    Utility::ConfigurationGroup* records = importer->configuration().group("instrumentationRecords");
+    CORRADE_VERIFY(records);
+    CORRADE_COMPARE(records->groupCount("call"), 2);
+    CORRADE_COMPARE(records->group("call", 0)->value("function"), "doOpenData");
+    CORRADE_VERIFY(!records->group("call", 0)->hasValue("filename"));
+    CORRADE_VERIFY(!records->group("call", 0)->hasValue("id"));
+    CORRADE_COMPARE(records->group("call", 1)->value("function"), "doMesh");
+    for(UnsignedInt i: {0, 1}) {
+        Utility::ConfigurationGroup* call = records->group("call", i);
+        CORRADE_ITERATION(call->value("function"));
+        CORRADE_VERIFY(call->hasValue("wallTime"));
+        CORRADE_VERIFY(call->hasValue("cpuTime"));
+        CORRADE_COMPARE_AS(call->value<Double>("wallTime"), 0.0,
+            TestSuite::Compare::GreaterOrEqual);
+        /* Allocation counts are recorded only if the application provides
+           magnumPluginsInstrumentationAllocations(), which this test
+           doesn't */
+        CORRADE_VERIFY(!call->hasValue("allocationCount"));
+    }
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::StlImporterTest)
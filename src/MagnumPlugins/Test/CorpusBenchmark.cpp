@@ -0,0 +1,374 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MaterialData.h>
+#include <Magnum/Trade/MeshData.h>
+#include <Magnum/Trade/SceneData.h>
+
+#include "configure.h"
+
+/* Counts heap allocations done through operator new. On platforms where the
+   replacement propagates to shared libraries (i.e., not Windows) it includes
+   allocations done by dynamic plugins as well. Allocations done directly with
+   malloc(), such as inside third-party C libraries, aren't counted. */
+namespace {
+    std::atomic<std::size_t> allocationCount{0};
+    std::atomic<std::size_t> allocatedBytes{0};
+}
+
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    allocatedBytes += size;
+    if(void* const out = std::malloc(size ? size : 1))
+        return out;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+/* Benchmarks importing and converting files from an external corpus with all
+   plugins that are built. Each case is run three times, measuring time (wall
+   clock by default, CPU time or cycles with --benchmark cpu-time or
+   cpu-cycles), number of allocations and allocated bytes. Files or data a
+   plugin can't handle are filtered out before the measurement. */
+struct CorpusBenchmark: TestSuite::Tester {
+    explicit CorpusBenchmark();
+
+    void importer();
+    void imageConverter();
+    void sceneConverter();
+
+    void allocationCountBegin();
+    std::uint64_t allocationCountEnd();
+    void allocatedBytesBegin();
+    std::uint64_t allocatedBytesEnd();
+
+    private:
+        /* Loads images and meshes from the corpus with the first importer
+           that can open given file, used as an input for the converters.
+           Done lazily and only once. */
+        void loadCorpusData();
+
+        /* Explicitly forbid system-wide plugin dependencies */
+        PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
+        PluginManager::Manager<AbstractImageConverter> _imageConverterManager{"nonexistent"};
+        PluginManager::Manager<AbstractSceneConverter> _sceneConverterManager{"nonexistent"};
+
+        Containers::Array<Containers::String> _files;
+        bool _corpusDataLoaded = false;
+        Containers::Array<ImageData2D> _images;
+        Containers::Array<MeshData> _meshes;
+
+        std::size_t _allocationCount, _allocatedBytes;
+};
+
+/* The lists are generated by CMake and contain just the plugins that are
+   built, the last item is an empty sentinel */
+const struct PluginData {
+    const char* name;
+    const char* filename;
+} ImporterData[]{
+    CORPUSBENCHMARK_IMPORTERS
+    {}
+}, ImageConverterData[]{
+    CORPUSBENCHMARK_IMAGECONVERTERS
+    {}
+}, SceneConverterData[]{
+    CORPUSBENCHMARK_SCENECONVERTERS
+    {}
+};
+
+CorpusBenchmark::CorpusBenchmark(): TestSuite::Tester{TesterConfiguration{}.setSkippedArgumentPrefixes({"corpus"})} {
+    Utility::Arguments args{"corpus"};
+    args.addOption("dir", CORPUSBENCHMARK_CORPUS_DIR).setHelp("dir", "directory with files to benchmark on", "PATH")
+        .parse(arguments().first(), arguments().second());
+
+    for(void(CorpusBenchmark::*benchmark)(): {
+        &CorpusBenchmark::importer,
+        &CorpusBenchmark::imageConverter,
+        &CorpusBenchmark::sceneConverter
+    }) {
+        const std::size_t instanceCount =
+            benchmark == &CorpusBenchmark::importer ? Containers::arraySize(ImporterData) - 1 :
+            benchmark == &CorpusBenchmark::imageConverter ? Containers::arraySize(ImageConverterData) - 1 :
+            Containers::arraySize(SceneConverterData) - 1;
+
+        addInstancedBenchmarks({benchmark}, 5, instanceCount);
+
+        addCustomInstancedBenchmarks({benchmark}, 1, instanceCount,
+            &CorpusBenchmark::allocationCountBegin,
+            &CorpusBenchmark::allocationCountEnd,
+            BenchmarkUnits::Count);
+
+        addCustomInstancedBenchmarks({benchmark}, 1, instanceCount,
+            &CorpusBenchmark::allocatedBytesBegin,
+            &CorpusBenchmark::allocatedBytesEnd,
+            BenchmarkUnits::Bytes);
+    }
+
+    /* Load the plugins directly from the build tree. Otherwise they're
+       static and already loaded. Some plugins may fail to load because of
+       missing dependencies, those are skipped in the benchmark. */
+    for(const PluginData& data: ImporterData)
+        if(data.filename) _importerManager.load(data.filename);
+    for(const PluginData& data: ImageConverterData)
+        if(data.filename) _imageConverterManager.load(data.filename);
+    for(const PluginData& data: SceneConverterData)
+        if(data.filename) _sceneConverterManager.load(data.filename);
+
+    const Containers::String dir = args.value<Containers::String>("dir");
+    if(!dir.isEmpty()) {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(dir, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot|Utility::Path::ListFlag::SortAscending);
+        if(files) for(const Containers::String& file: *files)
+            arrayAppend(_files, Utility::Path::join(dir, file));
+    }
+}
+
+void CorpusBenchmark::allocationCountBegin() {
+    _allocationCount = allocationCount;
+}
+
+std::uint64_t CorpusBenchmark::allocationCountEnd() {
+    return allocationCount - _allocationCount;
+}
+
+void CorpusBenchmark::allocatedBytesBegin() {
+    _allocatedBytes = allocatedBytes;
+}
+
+std::uint64_t CorpusBenchmark::allocatedBytesEnd() {
+    return allocatedBytes - _allocatedBytes;
+}
+
+/* Imports everything the importer can import, returning the count of
+   successfully imported items */
+std::size_t importAll(AbstractImporter& importer) {
+    std::size_t count = 0;
+    for(UnsignedInt i = 0; i != importer.image1DCount(); ++i)
+        count += !!importer.image1D(i);
+    for(UnsignedInt i = 0; i != importer.image2DCount(); ++i)
+        count += !!importer.image2D(i);
+    for(UnsignedInt i = 0; i != importer.image3DCount(); ++i)
+        count += !!importer.image3D(i);
+    for(UnsignedInt i = 0; i != importer.meshCount(); ++i)
+        count += !!importer.mesh(i);
+    for(UnsignedInt i = 0; i != importer.materialCount(); ++i)
+        count += !!importer.material(i);
+    for(UnsignedInt i = 0; i != importer.sceneCount(); ++i)
+        count += !!importer.scene(i);
+    return count;
+}
+
+void CorpusBenchmark::loadCorpusData() {
+    if(_corpusDataLoaded) return;
+    _corpusDataLoaded = true;
+
+    Error silenceError{nullptr};
+    Warning silenceWarning{nullptr};
+    for(const Containers::String& file: _files) {
+        for(const PluginData& data: ImporterData) {
+            if(!data.name || !(_importerManager.load(data.name) & PluginManager::LoadState::Loaded))
+                continue;
+
+            Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate(data.name);
+            if(!importer->openFile(file))
+                continue;
+
+            for(UnsignedInt i = 0; i != importer->image2DCount(); ++i)
+                if(Containers::Optional<ImageData2D> image = importer->image2D(i))
+                    arrayAppend(_images, *Utility::move(image));
+            for(UnsignedInt i = 0; i != importer->meshCount(); ++i)
+                if(Containers::Optional<MeshData> mesh = importer->mesh(i))
+                    arrayAppend(_meshes, *Utility::move(mesh));
+            break;
+        }
+    }
+}
+
+void CorpusBenchmark::importer() {
+    auto&& data = ImporterData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_files.isEmpty())
+        CORRADE_SKIP("No corpus files found, specify a directory with --corpus-dir.");
+    if(!(_importerManager.load(data.name) & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP(data.name << "plugin can't be loaded, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate(data.name);
+
+    /* Pick only files the plugin can open */
+    Containers::Array<Containers::StringView> files;
+    {
+        Error silenceError{nullptr};
+        Warning silenceWarning{nullptr};
+        for(const Containers::String& file: _files)
+            if(importer->openFile(file))
+                arrayAppend(files, file);
+    }
+    if(files.isEmpty())
+        CORRADE_SKIP("No corpus files that" << data.name << "can open.");
+
+    std::size_t imported = 0;
+    CORRADE_BENCHMARK(1) {
+        Error silenceError{nullptr};
+        Warning silenceWarning{nullptr};
+        for(const Containers::StringView file: files) {
+            if(!importer->openFile(file)) continue;
+            imported += importAll(*importer);
+            importer->close();
+        }
+    }
+
+    CORRADE_VERIFY(imported);
+}
+
+/* Converts the image with an API the converter supports, returns false on
+   failure */
+bool convertImage(AbstractImageConverter& converter, const ImageData2D& image) {
+    const ImageConverterFeatures features = converter.features();
+    if(features & (image.isCompressed() ? ImageConverterFeature::ConvertCompressed2DToData : ImageConverterFeature::Convert2DToData))
+        return !!converter.convertToData(image);
+    if(features & (image.isCompressed() ? ImageConverterFeature::ConvertCompressed2D : ImageConverterFeature::Convert2D))
+        return !!converter.convert(image);
+    return false;
+}
+
+void CorpusBenchmark::imageConverter() {
+    auto&& data = ImageConverterData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_files.isEmpty())
+        CORRADE_SKIP("No corpus files found, specify a directory with --corpus-dir.");
+    if(!(_imageConverterManager.load(data.name) & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP(data.name << "plugin can't be loaded, cannot test");
+
+    loadCorpusData();
+    Containers::Pointer<AbstractImageConverter> converter = _imageConverterManager.instantiate(data.name);
+
+    /* Pick only images the plugin can convert */
+    Containers::Array<const ImageData2D*> images;
+    {
+        Error silenceError{nullptr};
+        Warning silenceWarning{nullptr};
+        for(const ImageData2D& image: _images)
+            if(convertImage(*converter, image))
+                arrayAppend(images, &image);
+    }
+    if(images.isEmpty())
+        CORRADE_SKIP("No corpus images that" << data.name << "can convert.");
+
+    std::size_t converted = 0;
+    CORRADE_BENCHMARK(1) {
+        for(const ImageData2D* image: images)
+            converted += convertImage(*converter, *image);
+    }
+
+    CORRADE_COMPARE(converted, images.size());
+}
+
+/* Converts the mesh with an API the converter supports, returns false on
+   failure */
+bool convertMesh(AbstractSceneConverter& converter, const MeshData& mesh) {
+    const SceneConverterFeatures features = converter.features();
+    if(features & (SceneConverterFeature::ConvertMeshToData|SceneConverterFeature::ConvertMultipleToData))
+        return !!converter.convertToData(mesh);
+    if(features & SceneConverterFeature::ConvertMesh)
+        return !!converter.convert(mesh);
+    return false;
+}
+
+void CorpusBenchmark::sceneConverter() {
+    auto&& data = SceneConverterData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_files.isEmpty())
+        CORRADE_SKIP("No corpus files found, specify a directory with --corpus-dir.");
+    if(!(_sceneConverterManager.load(data.name) & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP(data.name << "plugin can't be loaded, cannot test");
+
+    loadCorpusData();
+    Containers::Pointer<AbstractSceneConverter> converter = _sceneConverterManager.instantiate(data.name);
+
+    /* Pick only meshes the plugin can convert */
+    Containers::Array<const MeshData*> meshes;
+    {
+        Error silenceError{nullptr};
+        Warning silenceWarning{nullptr};
+        for(const MeshData& mesh: _meshes)
+            if(convertMesh(*converter, mesh))
+                arrayAppend(meshes, &mesh);
+    }
+    if(meshes.isEmpty())
+        CORRADE_SKIP("No corpus meshes that" << data.name << "can convert.");
+
+    std::size_t converted = 0;
+    CORRADE_BENCHMARK(1) {
+        for(const MeshData* mesh: meshes)
+            converted += convertMesh(*converter, *mesh);
+    }
+
+    CORRADE_COMPARE(converted, meshes.size());
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::CorpusBenchmark)
@@ -63,6 +63,8 @@
 #include <Magnum/Trade/TextureData.h>
 #include <MagnumPlugins/AnyImageImporter/AnyImageImporter.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
 #define TINYGLTF_IMPLEMENTATION
 /* Opt out of tinygltf stb_image dependency */
 #define TINYGLTF_NO_STB_IMAGE
@@ -276,6 +278,7 @@ bool TinyGltfImporter::doIsOpened() const { return !!_d && _d->open; }
 void TinyGltfImporter::doClose() { _d = nullptr; }
 
 void TinyGltfImporter::doOpenFile(const Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenFile", filename};
     _d.reset(new Document);
     /* Since the slice won't be null terminated, nullTerminatedGlobalView()
        won't help anything here */
@@ -284,6 +287,7 @@ void TinyGltfImporter::doOpenFile(const Containers::StringView filename) {
 }
 
 void TinyGltfImporter::doOpenData(Containers::Array<char>&& data, DataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     tinygltf::TinyGLTF loader;
     std::string err;
 
@@ -998,6 +1002,7 @@ Containers::String TinyGltfImporter::doSceneName(const UnsignedInt id) {
 }
 
 Containers::Optional<SceneData> TinyGltfImporter::doScene(UnsignedInt id) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doScene", {}, id};
     const tinygltf::Scene& scene = _d->model.scenes[id];
 
     /* Gather all top-level nodes belonging to a scene and recursively populate
@@ -1446,6 +1451,7 @@ Containers::String TinyGltfImporter::doMeshName(const UnsignedInt id) {
 }
 
 Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMesh", {}, id};
     const tinygltf::Mesh& mesh = _d->model.meshes[_d->meshMap[id].first];
     const tinygltf::Primitive& primitive = mesh.primitives[_d->meshMap[id].second];
 
@@ -1969,6 +1975,7 @@ bool TinyGltfImporter::materialTexture(const char* name, const UnsignedInt textu
 }
 
 Containers::Optional<MaterialData> TinyGltfImporter::doMaterial(const UnsignedInt id) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMaterial", {}, id};
     const tinygltf::Material& material = _d->model.materials[id];
 
     Containers::Array<UnsignedInt> layers;
@@ -2619,6 +2626,7 @@ UnsignedInt TinyGltfImporter::doImage2DLevelCount(const UnsignedInt id) {
 }
 
 Containers::Optional<ImageData2D> TinyGltfImporter::doImage2D(const UnsignedInt id, const UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D", {}, id};
     CORRADE_ASSERT(manager(), "Trade::TinyGltfImporter::image2D(): the plugin must be instantiated with access to plugin manager in order to load images", {});
 
     AbstractImporter* importer = setupOrReuseImporterForImage(id, "Trade::TinyGltfImporter::image2D():");
@@ -365,6 +365,11 @@ fail.
 support anything else</li>
 <li>Z coordinate of @ref Trade::TextureData::wrapping() is always
 @ref SamplerWrapping::Repeat, as glTF doesn't support 3D textures</li>
+<li>Images aren't decoded or read from external files when opening the file,
+only embedded data URIs get Base64-decoded. The actual decoding is done
+through @ref AnyImageImporter in @ref image2D() and as such, opening files
+with many textures isn't slowed down when only meshes or scenes are
+imported.</li>
 <li>
 @m_class{m-nopadb}
 
@@ -94,10 +94,17 @@ struct UfbxImporterTest: TestSuite::Tester {
     void fileCallbackNotFound();
     void fileCallbackEmpty();
     void fileCallbackEmptyVerbose();
+    void fileCallbackClose();
+    void readBufferSize();
 
     void scene();
+    void sceneNodeFilter();
+    void sceneNodeFilterNoMatch();
     void mesh();
     void meshPointLine();
+    void meshThreads();
+    void meshWeldTolerance();
+    void meshCache();
     void camera();
     void cameraName();
     void cameraOrientation();
@@ -158,6 +165,7 @@ struct UfbxImporterTest: TestSuite::Tester {
     void multiWarningData();
 
     void animationInterpolation();
+    void animationReduceKeyframes();
     void animationRotationPivot();
     void animationPreRotation();
     void animationVisibility();
@@ -227,6 +235,39 @@ const struct {
     {-999, true},
 };
 
+/* geometric-transform.fbx has Box001 with Box002 as a child, each having an
+   unnamed geometric transform helper child with a mesh */
+const UnsignedInt SceneNodeFilterAllObjects[]{0, 1, 2, 3};
+const Int SceneNodeFilterAllParents[]{-1, 0, 0, 2};
+const UnsignedInt SceneNodeFilterAllMeshObjects[]{1, 3};
+const UnsignedInt SceneNodeFilterBox002Objects[]{0, 2, 3};
+const Int SceneNodeFilterBox002Parents[]{-1, 0, 2};
+const UnsignedInt SceneNodeFilterBox002MeshObjects[]{3};
+
+const struct {
+    const char* name;
+    const char* filter;
+    Containers::ArrayView<const UnsignedInt> objects;
+    Containers::ArrayView<const Int> parents;
+    Containers::ArrayView<const UnsignedInt> meshObjects;
+} SceneNodeFilterData[]{
+    {"parent node", "Box001",
+        SceneNodeFilterAllObjects, SceneNodeFilterAllParents,
+        SceneNodeFilterAllMeshObjects},
+    {"child node", "Box002",
+        SceneNodeFilterBox002Objects, SceneNodeFilterBox002Parents,
+        SceneNodeFilterBox002MeshObjects},
+    {"question mark wildcard", "Box00?",
+        SceneNodeFilterAllObjects, SceneNodeFilterAllParents,
+        SceneNodeFilterAllMeshObjects},
+    {"star wildcard", "*2",
+        SceneNodeFilterBox002Objects, SceneNodeFilterBox002Parents,
+        SceneNodeFilterBox002MeshObjects},
+    {"multiple entries, one not matching", "  Nonexistent *x*2  Box002 ",
+        SceneNodeFilterBox002Objects, SceneNodeFilterBox002Parents,
+        SceneNodeFilterBox002MeshObjects},
+};
+
 constexpr struct {
     bool resampleRotation;
 } ResampleRotationData[]{
@@ -268,14 +309,25 @@ UfbxImporterTest::UfbxImporterTest() {
               &UfbxImporterTest::fileCallbackNotFound,
               &UfbxImporterTest::fileCallbackEmpty,
               &UfbxImporterTest::fileCallbackEmptyVerbose,
+              &UfbxImporterTest::fileCallbackClose,
+              &UfbxImporterTest::readBufferSize,
 
               &UfbxImporterTest::scene});
 
+    addInstancedTests({&UfbxImporterTest::sceneNodeFilter},
+        Containers::arraySize(SceneNodeFilterData));
+
+    addTests({&UfbxImporterTest::sceneNodeFilterNoMatch});
+
     addInstancedTests({&UfbxImporterTest::mesh,
                        &UfbxImporterTest::meshPointLine},
         Containers::arraySize(MeshGenerateIndicesData));
 
-    addTests({&UfbxImporterTest::camera,
+    addTests({&UfbxImporterTest::meshThreads,
+              &UfbxImporterTest::meshWeldTolerance,
+              &UfbxImporterTest::meshCache,
+
+              &UfbxImporterTest::camera,
               &UfbxImporterTest::cameraName,
               &UfbxImporterTest::cameraOrientation,
               &UfbxImporterTest::light,
@@ -342,7 +394,8 @@ UfbxImporterTest::UfbxImporterTest() {
                        &UfbxImporterTest::multiWarningData},
         Containers::arraySize(QuietData));
 
-    addTests({&UfbxImporterTest::animationInterpolation});
+    addTests({&UfbxImporterTest::animationInterpolation,
+              &UfbxImporterTest::animationReduceKeyframes});
 
     addInstancedTests({&UfbxImporterTest::animationRotationPivot,
                        &UfbxImporterTest::animationPreRotation},
@@ -557,6 +610,49 @@ void UfbxImporterTest::fileCallbackEmptyVerbose() {
     #endif
 }
 
+void UfbxImporterTest::fileCallbackClose() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("UfbxImporter");
+
+    struct {
+        FileCallbackFiles files;
+        std::unordered_map<std::string, Int> openCount;
+        UnsignedInt closeCount = 0;
+    } state;
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy policy, void* userData) {
+        auto& state = *static_cast<decltype(&state)>(userData);
+        if(policy == InputFileCallbackPolicy::Close) {
+            --state.openCount[filename];
+            ++state.closeCount;
+            return Containers::Optional<Containers::ArrayView<const char>>{};
+        }
+        ++state.openCount[filename];
+        return fileCallbackFunc(filename, policy, &state.files);
+    }, &state);
+
+    /* Both the main file and the material library get closed once ufbx is
+       done with them, at the latest when the import finishes */
+    CORRADE_VERIFY(importer->openFile("cube.obj"));
+    CORRADE_COMPARE(importer->materialCount(), 1);
+    CORRADE_COMPARE(state.closeCount, 2);
+    CORRADE_COMPARE(state.openCount.size(), 2);
+    CORRADE_COMPARE(state.openCount["cube.obj"], 0);
+    CORRADE_COMPARE(state.openCount["cube.mtl"], 0);
+}
+
+void UfbxImporterTest::readBufferSize() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("UfbxImporter");
+
+    /* A tiny buffer makes ufbx refill it many times during the load */
+    importer->configuration().setValue("readBufferSize", 16);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(UFBXIMPORTER_TEST_DIR, "blender-default.fbx")));
+    CORRADE_COMPARE(importer->objectCount(), 3);
+    CORRADE_COMPARE(importer->meshCount(), 1);
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+}
+
 void UfbxImporterTest::scene() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("UfbxImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Path::join(UFBXIMPORTER_TEST_DIR, "blender-default.fbx")));
@@ -633,6 +729,60 @@ void UfbxImporterTest::scene() {
     }
 }
 
+void UfbxImporterTest::sceneNodeFilter() {
+    auto&& data = SceneNodeFilterData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("UfbxImporter");
+    importer->configuration().setValue("nodeFilter", data.filter);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(UFBXIMPORTER_TEST_DIR, "geometric-transform.fbx")));
+
+    /* Object IDs stay the same regardless of the filter */
+    CORRADE_COMPARE(importer->objectCount(), 4);
+    CORRADE_COMPARE(importer->objectName(2), "Box002");
+
+    Containers::Optional<SceneData> scene = importer->scene(0);
+    CORRADE_VERIFY(scene);
+    CORRADE_COMPARE(scene->mappingBound(), 4);
+    CORRADE_COMPARE(scene->fieldFlags(SceneField::Parent), SceneFieldFlag::OrderedMapping);
+    CORRADE_COMPARE_AS(scene->mapping<UnsignedInt>(SceneField::Parent),
+        data.objects,
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(scene->field<Int>(SceneField::Parent),
+        data.parents,
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(scene->mapping<UnsignedInt>(SceneField::Translation),
+        data.objects,
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(scene->mapping<UnsignedInt>(SceneField::Mesh),
+        data.meshObjects,
+        TestSuite::Compare::Container);
+
+    Containers::Optional<Containers::Triple<Vector3, Quaternion, Vector3>> trs = scene->translationRotationScaling3DFor(2);
+    CORRADE_VERIFY(trs);
+    CORRADE_COMPARE(trs->first(), (Vector3{0.0f, 0.0f, 20.0f}));
+}
+
+void UfbxImporterTest::sceneNodeFilterNoMatch() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("UfbxImporter");
+    importer->configuration().setValue("nodeFilter", "Nonexistent Box00");
+
+    std::ostringstream out;
+    {
+        Warning redirectWarning{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(UFBXIMPORTER_TEST_DIR, "geometric-transform.fbx")));
+    }
+    CORRADE_COMPARE(out.str(), "Trade::UfbxImporter::openFile(): no nodes match the nodeFilter option\n");
+
+    CORRADE_COMPARE(importer->objectCount(), 4);
+
+    Containers::Optional<SceneData> scene = importer->scene(0);
+    CORRADE_VERIFY(scene);
+    CORRADE_COMPARE(scene->mappingBound(), 4);
+    CORRADE_COMPARE(scene->fieldSize(SceneField::Parent), 0);
+    CORRADE_VERIFY(!scene->hasField(SceneField::Mesh));
+}
+
 void UfbxImporterTest::mesh() {
     auto&& data = MeshGenerateIndicesData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -816,6 +966,97 @@ void UfbxImporterTest::meshPointLine() {
     }), TestSuite::Compare::Container);
 }
 
+void UfbxImporterTest::meshThreads() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("UfbxImporter");
+    importer->configuration().setValue("generateIndices", false);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(UFBXIMPORTER_TEST_DIR, "blender-default.fbx")));
+    CORRADE_COMPARE(importer->meshCount(), 1);
+
+    Containers::Optional<MeshData> expected = importer->mesh(0);
+    CORRADE_VERIFY(expected);
+
+    /* The cube has six quads, so they get split between four threads
+       unevenly, the output should be the same regardless */
+    importer->configuration().setValue("threads", 4);
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexCount(), 36);
+    CORRADE_COMPARE(mesh->attributeCount(), expected->attributeCount());
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        expected->attribute<Vector3>(MeshAttribute::Position),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        expected->attribute<Vector3>(MeshAttribute::Normal),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+        expected->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+        TestSuite::Compare::Container);
+}
+
+void UfbxImporterTest::meshWeldTolerance() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("UfbxImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(UFBXIMPORTER_TEST_DIR, "blender-default.fbx")));
+
+    /* Each cube face has its own normals, so only vertices within a face are
+       deduplicated by default */
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->indexCount(), 36);
+    CORRADE_COMPARE(mesh->vertexCount(), 24);
+
+    /* With a large enough tolerance also vertices with different normals and
+       texture coordinates get welded */
+    importer->configuration().setValue("weldTolerance", 100.0);
+    Containers::Optional<MeshData> welded = importer->mesh(0);
+    CORRADE_VERIFY(welded);
+    CORRADE_COMPARE(welded->indexCount(), 36);
+    CORRADE_COMPARE_AS(welded->vertexCount(), 24u,
+        TestSuite::Compare::Less);
+
+    /* The tolerance has no effect if indices aren't generated */
+    importer->configuration().setValue("generateIndices", false);
+    Containers::Optional<MeshData> nonIndexed = importer->mesh(0);
+    CORRADE_VERIFY(nonIndexed);
+    CORRADE_VERIFY(!nonIndexed->isIndexed());
+    CORRADE_COMPARE(nonIndexed->vertexCount(), 36);
+}
+
+void UfbxImporterTest::meshCache() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("UfbxImporter");
+    importer->configuration().setValue("cacheMeshes", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(UFBXIMPORTER_TEST_DIR, "blender-default.fbx")));
+
+    Containers::Optional<MeshData> a = importer->mesh(0);
+    Containers::Optional<MeshData> b = importer->mesh(0);
+    CORRADE_VERIFY(a);
+    CORRADE_VERIFY(b);
+
+    /* Each import returns its own owned copy of the cached mesh */
+    CORRADE_VERIFY(a->vertexData().data() != b->vertexData().data());
+    CORRADE_COMPARE(a->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE(b->vertexCount(), a->vertexCount());
+    CORRADE_COMPARE_AS(b->attribute<Vector3>(MeshAttribute::Position),
+        a->attribute<Vector3>(MeshAttribute::Position),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(b->indices<UnsignedInt>(),
+        a->indices<UnsignedInt>(),
+        TestSuite::Compare::Container);
+
+    /* Changing a mesh-related option makes the mesh converted again */
+    importer->configuration().setValue("generateIndices", false);
+    Containers::Optional<MeshData> c = importer->mesh(0);
+    CORRADE_VERIFY(c);
+    CORRADE_VERIFY(!c->isIndexed());
+    CORRADE_COMPARE(c->vertexCount(), 36);
+
+    /* Disabling the cache converts it again as well */
+    importer->configuration().setValue("cacheMeshes", false);
+    importer->configuration().setValue("generateIndices", true);
+    Containers::Optional<MeshData> d = importer->mesh(0);
+    CORRADE_VERIFY(d);
+    CORRADE_VERIFY(d->isIndexed());
+}
+
 void UfbxImporterTest::camera() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("UfbxImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Path::join(UFBXIMPORTER_TEST_DIR, "cameras.fbx")));
@@ -2806,6 +3047,48 @@ void UfbxImporterTest::animationInterpolation() {
     }), TestSuite::Compare::Container);
 }
 
+void UfbxImporterTest::animationReduceKeyframes() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("UfbxImporter");
+    importer->configuration().setValue("animateFullTransform", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(UFBXIMPORTER_TEST_DIR, "animation-interpolation.fbx")));
+    Containers::Optional<AnimationData> original = importer->animation(0);
+    CORRADE_VERIFY(original);
+
+    importer->configuration().setValue("reduceKeyframes", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(UFBXIMPORTER_TEST_DIR, "animation-interpolation.fbx")));
+    Containers::Optional<AnimationData> reduced = importer->animation(0);
+    CORRADE_VERIFY(reduced);
+
+    CORRADE_COMPARE(reduced->trackCount(), original->trackCount());
+    CORRADE_COMPARE(reduced->duration(), original->duration());
+    CORRADE_COMPARE_AS(reduced->data().size(), original->data().size(),
+        TestSuite::Compare::Less);
+
+    /* The translation track has linear and constant sections that can be
+       reduced, but every original keyframe is still reproduced within the
+       tolerance */
+    auto originalTranslation = trackByTarget<Vector3>(*original, 0, AnimationTrackTarget::Translation3D);
+    auto reducedTranslation = trackByTarget<Vector3>(*reduced, 0, AnimationTrackTarget::Translation3D);
+    CORRADE_COMPARE_AS(reducedTranslation.size(), originalTranslation.size(),
+        TestSuite::Compare::Less);
+    CORRADE_COMPARE(reducedTranslation.keys().front(), originalTranslation.keys().front());
+    CORRADE_COMPARE(reducedTranslation.keys().back(), originalTranslation.keys().back());
+    for(std::size_t i = 0; i != originalTranslation.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE_AS((reducedTranslation.at(originalTranslation.keys()[i]) - originalTranslation.values()[i]).length(), 0.0001f + 1.0e-5f,
+            TestSuite::Compare::LessOrEqual);
+    }
+
+    /* Rotation and scaling aren't animated, so they're reduced to a single
+       keyframe */
+    auto reducedRotation = trackByTarget<Quaternion>(*reduced, 0, AnimationTrackTarget::Rotation3D);
+    CORRADE_COMPARE(reducedRotation.size(), 1);
+    CORRADE_COMPARE(reducedRotation.values()[0], Quaternion{});
+    auto reducedScaling = trackByTarget<Vector3>(*reduced, 0, AnimationTrackTarget::Scaling3D);
+    CORRADE_COMPARE(reducedScaling.size(), 1);
+    CORRADE_COMPARE(reducedScaling.values()[0], Vector3{1.0f});
+}
+
 void UfbxImporterTest::animationRotationPivot() {
     auto&& data = ResampleRotationData[testCaseInstanceId()];
     setTestCaseDescription(Utility::format("resampleRotation={}", data.resampleRotation ? "true" : "false"));
@@ -28,6 +28,9 @@
 
 #include <algorithm>
 #include <unordered_map>
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#include <thread>
+#endif
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayTuple.h>
 #include <Corrade/Containers/BitArray.h>
@@ -45,6 +48,7 @@
 #include <Magnum/Math/RectangularMatrix.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/Math/Quaternion.h>
+#include <Magnum/MeshTools/Copy.h>
 #include <Magnum/MeshTools/RemoveDuplicates.h>
 #include <Magnum/Trade/AnimationData.h>
 #include <Magnum/Trade/CameraData.h>
@@ -57,6 +61,9 @@
 #include <Magnum/Trade/TextureData.h>
 #include <MagnumPlugins/AnyImageImporter/AnyImageImporter.h>
 
+#include "Magnum/Implementation/imageImporterPool.h"
+#include "Magnum/Implementation/instrumentation.h"
+
 #define UFBX_NO_INDEX_GENERATION
 #define UFBX_NO_GEOMETRY_CACHE
 #define UFBX_NO_TESSELLATION
@@ -180,6 +187,29 @@ constexpr Containers::StringView sceneFieldNames[]{
     "geometryScaling"_s,
 };
 
+/* Matches a name against a pattern with * matching any sequence of characters
+   and ? a single character. Backtracks only to the last *, which is enough
+   for a linear-ish match in the common cases. */
+bool matchesPattern(const Containers::StringView name, const Containers::StringView pattern) {
+    std::size_t n = 0, p = 0;
+    std::size_t starPattern = ~std::size_t{}, starName = 0;
+    while(n < name.size()) {
+        if(p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++n;
+            ++p;
+        } else if(p < pattern.size() && pattern[p] == '*') {
+            starPattern = p++;
+            starName = n;
+        } else if(starPattern != ~std::size_t{}) {
+            p = starPattern + 1;
+            n = ++starName;
+        } else return false;
+    }
+
+    while(p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+
 bool getLoadOptsFromConfiguration(ufbx_load_opts& opts, Utility::ConfigurationGroup& conf, const char* errorPrefix) {
     const Long maxTemporaryMemory = conf.value<Long>("maxTemporaryMemory");
     const Long maxResultMemory = conf.value<Long>("maxResultMemory");
@@ -197,6 +227,7 @@ bool getLoadOptsFromConfiguration(ufbx_load_opts& opts, Utility::ConfigurationGr
     opts.ignore_all_content = conf.value<bool>("ignoreAllContent");
     opts.ignore_missing_external_files = true;
     opts.clean_skin_weights = true;
+    opts.read_buffer_size = conf.value<std::size_t>("readBufferSize");
 
     /* Substitute zero maximum memory to one, so that if the user computes the
        maximum memory and ends up with zero it doesn't result in unlimited */
@@ -271,25 +302,49 @@ struct FileOpener {
            compile time */
         CORRADE_INTERNAL_ASSERT(info->type != UFBX_OPEN_FILE_GEOMETRY_CACHE);
 
-        /* If we don't have a callback just defer to ufbx file loading */
+        /* If we don't have a callback just defer to ufbx file loading, which
+           streams the file in chunks of ufbx_load_opts::read_buffer_size */
         if(!_callback) return ufbx_open_file(stream, path, path_len);
 
-        std::string file{path, path_len};
-        const Containers::Optional<Containers::ArrayView<const char>> data = _callback(file, InputFileCallbackPolicy::LoadTemporary, _userData);
+        Containers::Pointer<OpenedFile> file{InPlaceInit, this, std::string{path, path_len}};
+        const Containers::Optional<Containers::ArrayView<const char>> data = _callback(file->filename, InputFileCallbackPolicy::LoadTemporary, _userData);
         if(!data) return false;
 
         ufbx_open_memory_opts opts{};
         opts.allocator.allocator = info->temp_allocator;
 
         /* We don't need to copy the file data as it's guaranteed to live for
-           the duration of the load function we are currently executing */
+           the duration of the load function we are currently executing. Once
+           ufbx is done reading the file, the callback is told to close it so
+           the data don't have to stay around until the whole load is done. */
         opts.no_copy = true;
+        opts.close_cb.fn = [](void* userData, void*, std::size_t) {
+            const OpenedFile& file = *static_cast<OpenedFile*>(userData);
+            file.opener->_callback(file.filename, InputFileCallbackPolicy::Close, file.opener->_userData);
+        };
+        opts.close_cb.user = file.get();
+
+        if(!ufbx_open_memory(stream, data->data(), data->size(), &opts, nullptr)) {
+            _callback(file->filename, InputFileCallbackPolicy::Close, _userData);
+            return false;
+        }
 
-        return ufbx_open_memory(stream, data->data(), data->size(), &opts, nullptr);
+        /* The close callback may get called only after this function exits,
+           keep the filename around until the end of the load */
+        arrayAppend(_files, Utility::move(file));
+        return true;
     }
 
+    struct OpenedFile {
+        explicit OpenedFile(FileOpener* opener, std::string&& filename): opener{opener}, filename{Utility::move(filename)} {}
+
+        FileOpener* opener;
+        std::string filename;
+    };
+
     Containers::Optional<Containers::ArrayView<const char>> (*_callback)(const std::string&, InputFileCallbackPolicy, void*);
     void* _userData;
+    Containers::Array<Containers::Pointer<OpenedFile>> _files;
 };
 
 struct MeshChunk {
@@ -324,11 +379,20 @@ struct UfbxImporter::State {
     /* Mapping from ufbx_scene::meshes[] -> State::meshChunks[] */
     Containers::Array<MeshChunkMapping> meshChunkMapping;
 
+    /* Converted meshes if cacheMeshes is enabled, together with the values
+       of mesh-related options they were converted with */
+    Containers::Array<Containers::Optional<MeshData>> meshes;
+    Containers::Array<std::string> meshConfigurations;
+
     /* Offset subtracted from ufbx IDs to UfbxImporter::object() IDs, usually
        one as the root node is excluded */
     UnsignedInt nodeIdOffset = 0;
     UnsignedInt objectCount = 0;
 
+    /* Nodes selected by the nodeFilter option, indexed by ufbx_node::typed_id.
+       Empty if all nodes are imported. */
+    Containers::BitArray selectedNodes;
+
     /* true if loaded from openFile(), false from openData() */
     bool fromFile = false;
 
@@ -344,6 +408,10 @@ struct UfbxImporter::State {
     /* Cached AnyImageImporter for image2D() and image2DLevelCount */
     UnsignedInt imageImporterId = ~UnsignedInt{};
     Containers::Optional<AnyImageImporter> imageImporter;
+    /* Set if the image importer was opened from a file and the
+       imageImporterPoolSize option was non-zero at that point, in which case
+       it's put back into the shared pool once replaced */
+    Containers::String imageImporterFilename;
 
     /* If true preserve the implicit root node */
     bool preserveRootNode = false;
@@ -351,17 +419,26 @@ struct UfbxImporter::State {
     bool animationLayers = false;
 };
 
-UfbxImporter::UfbxImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
+UfbxImporter::UfbxImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {
+    Magnum::Implementation::imageImporterPool().addUser(this->manager());
+}
 
-UfbxImporter::~UfbxImporter() = default;
+UfbxImporter::~UfbxImporter() {
+    Magnum::Implementation::imageImporterPool().removeUser(manager());
+}
 
 ImporterFeatures UfbxImporter::doFeatures() const { return ImporterFeature::OpenData|ImporterFeature::FileCallback; }
 
 bool UfbxImporter::doIsOpened() const { return !!_state; }
 
-void UfbxImporter::doClose() { _state = nullptr; }
+void UfbxImporter::doClose() {
+    /* Put the image importer back to the shared pool, if enabled */
+    if(_state) releaseImageImporter();
+    _state = nullptr;
+}
 
 void UfbxImporter::doOpenData(Containers::Array<char>&& data, const DataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     ufbx_load_opts opts{};
     if(!getLoadOptsFromConfiguration(opts, configuration(), "Trade::UfbxImporter::openData():"))
         return;
@@ -380,6 +457,7 @@ void UfbxImporter::doOpenData(Containers::Array<char>&& data, const DataFlags) {
 }
 
 void UfbxImporter::doOpenFile(Containers::StringView filename) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenFile", filename};
     ufbx_load_opts opts{};
     if(!getLoadOptsFromConfiguration(opts, configuration(), "Trade::UfbxImporter::openFile():"))
         return;
@@ -452,6 +530,35 @@ void UfbxImporter::openInternal(void* opaqueScene, const void* opaqueOpts, bool
         ++_state->nodeIdOffset;
     }
 
+    /* Select nodes matching the filter, all their children and parents. The
+       whole file is parsed by ufbx regardless, but the unselected parts don't
+       get converted to the scene or animations. */
+    const Containers::Array<Containers::StringView> nodeFilter = configuration().value<Containers::StringView>("nodeFilter").splitOnWhitespaceWithoutEmptyParts();
+    if(!nodeFilter.isEmpty()) {
+        Containers::BitArray matchingNodes{ValueInit, scene->nodes.count};
+        for(const ufbx_node* node: scene->nodes) {
+            for(const Containers::StringView pattern: nodeFilter) {
+                if(matchesPattern(node->name, pattern)) {
+                    matchingNodes.set(node->typed_id);
+                    break;
+                }
+            }
+        }
+
+        _state->selectedNodes = Containers::BitArray{ValueInit, scene->nodes.count};
+        for(const ufbx_node* node: scene->nodes) {
+            for(const ufbx_node* parent = node; parent; parent = parent->parent) {
+                if(!matchingNodes[parent->typed_id]) continue;
+                for(const ufbx_node* selected = node; selected && !_state->selectedNodes[selected->typed_id]; selected = selected->parent)
+                    _state->selectedNodes.set(selected->typed_id);
+                break;
+            }
+        }
+
+        if(!(flags() & ImporterFlag::Quiet) && _state->selectedNodes.count() == 0)
+            Warning{} << (fromFile ? "Trade::UfbxImporter::openFile():" : "Trade::UfbxImporter::openData():") << "no nodes match the nodeFilter option";
+    }
+
     /* Filter out textures that don't have any file associated with them. */
     arrayResize(_state->textureRemap, scene->textures.count, -1);
     for(const ufbx_texture* texture: scene->textures) {
@@ -504,44 +611,47 @@ UnsignedInt UfbxImporter::doSceneCount() const {
 }
 
 Containers::Optional<SceneData> UfbxImporter::doScene(UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doScene"};
     const ufbx_scene* scene = _state->scene.get();
 
     const bool retainGeometryTransforms = configuration().value("geometryTransformHandling") == "preserve";
 
-    const UnsignedInt nodeCount = _state->objectCount;
     const UnsignedInt nodeIdOffset = _state->nodeIdOffset;
-    const UnsignedInt geometryTransformCount = retainGeometryTransforms ? nodeCount : 0;
+    const Containers::BitArrayView selectedNodes = _state->selectedNodes;
+    const auto isImported = [&](const ufbx_node* node) {
+        return (_state->preserveRootNode || !node->is_root) &&
+               (selectedNodes.isEmpty() || selectedNodes[node->typed_id]);
+    };
 
+    UnsignedInt nodeCount = 0;
     UnsignedInt meshCount = 0;
     UnsignedInt skinCount = 0;
     UnsignedInt cameraCount = 0;
     UnsignedInt lightCount = 0;
 
-    /* We need to bind each chunk of a mesh to each node that refers to it */
-    for(const ufbx_mesh* mesh: scene->meshes) {
-        UnsignedInt instanceCount = UnsignedInt(mesh->instances.count);
-        UnsignedInt chunkCount = _state->meshChunkMapping[mesh->typed_id].count;
-        meshCount += instanceCount * chunkCount;
-    }
-
-    /* Skins are bound to meshes in FBX but nodes here, so count each node
+    /* We need to bind each chunk of a mesh to each node that refers to it.
+       Skins are bound to meshes in FBX but nodes here, so count each node
        that contains at least a single skin. */
     for(const ufbx_node* node: scene->nodes) {
+        if(!isImported(node)) continue;
+
+        ++nodeCount;
+        bool hasSkin = false;
         for(const ufbx_element* attrib: node->all_attribs) {
             if(const ufbx_mesh* mesh = ufbx_as_mesh(attrib)) {
-                if(mesh->skin_deformers.count > 0) {
-                    ++skinCount;
-                    break;
-                }
+                meshCount += _state->meshChunkMapping[mesh->typed_id].count;
+                if(mesh->skin_deformers.count > 0)
+                    hasSkin = true;
+            } else if(ufbx_as_light(attrib)) {
+                ++lightCount;
+            } else if(ufbx_as_camera(attrib)) {
+                ++cameraCount;
             }
         }
+        if(hasSkin) ++skinCount;
     }
 
-    /* Collect instanced camera/light counts */
-    for(const ufbx_light* light: scene->lights)
-        lightCount += UnsignedInt(light->instances.count);
-    for(const ufbx_camera* camera: scene->cameras)
-        cameraCount += UnsignedInt(camera->instances.count);
+    const UnsignedInt geometryTransformCount = retainGeometryTransforms ? nodeCount : 0;
 
     /* Allocate the output array. */
     Containers::ArrayView<UnsignedInt> nodeObjects;
@@ -585,34 +695,39 @@ Containers::Optional<SceneData> UfbxImporter::doScene(UnsignedInt) {
         {NoInit, skinCount, skins},
     };
 
+    UnsignedInt nodeOffset = 0;
     UnsignedInt meshMaterialOffset = 0;
     UnsignedInt skinOffset = 0;
     UnsignedInt lightOffset = 0;
     UnsignedInt cameraOffset = 0;
 
     for(const ufbx_node* node: scene->nodes) {
-        if(!_state->preserveRootNode && node->is_root) continue;
+        if(!isImported(node)) continue;
 
+        /* Parents of selected nodes are always selected as well, so the
+           parent reference is never dangling */
         UnsignedInt nodeId = node->typed_id - nodeIdOffset;
-        nodeObjects[nodeId] = nodeId;
+        nodeObjects[nodeOffset] = nodeId;
         if(node->parent && (_state->preserveRootNode || !node->parent->is_root)) {
-            parents[nodeId] = Int(node->parent->typed_id - nodeIdOffset);
+            parents[nodeOffset] = Int(node->parent->typed_id - nodeIdOffset);
         } else {
-            parents[nodeId] = -1;
+            parents[nodeOffset] = -1;
         }
 
-        translations[nodeId] = Vector3d(node->local_transform.translation);
-        rotations[nodeId] = Quaterniond(node->local_transform.rotation);
-        scalings[nodeId] = Vector3d(node->local_transform.scale);
-        visibilities.set(nodeId, node->visible);
-        geometryTransformHelpers.set(nodeId, node->is_geometry_transform_helper);
+        translations[nodeOffset] = Vector3d(node->local_transform.translation);
+        rotations[nodeOffset] = Quaterniond(node->local_transform.rotation);
+        scalings[nodeOffset] = Vector3d(node->local_transform.scale);
+        visibilities.set(nodeOffset, node->visible);
+        geometryTransformHelpers.set(nodeOffset, node->is_geometry_transform_helper);
 
         if(retainGeometryTransforms) {
-            geometryTranslations[nodeId] = Vector3d(node->geometry_transform.translation);
-            geometryRotations[nodeId] = Quaterniond(node->geometry_transform.rotation);
-            geometryScalings[nodeId] = Vector3d(node->geometry_transform.scale);
+            geometryTranslations[nodeOffset] = Vector3d(node->geometry_transform.translation);
+            geometryRotations[nodeOffset] = Quaterniond(node->geometry_transform.rotation);
+            geometryScalings[nodeOffset] = Vector3d(node->geometry_transform.scale);
         }
 
+        ++nodeOffset;
+
         for(const ufbx_element* element: node->all_attribs) {
             if(const ufbx_mesh* mesh = ufbx_as_mesh(element)) {
                 UnsignedInt materialIndex = 0;
@@ -663,6 +778,7 @@ Containers::Optional<SceneData> UfbxImporter::doScene(UnsignedInt) {
         }
     }
 
+    CORRADE_INTERNAL_ASSERT(nodeOffset == nodeObjects.size());
     CORRADE_INTERNAL_ASSERT(meshMaterialOffset == meshMaterialObjects.size());
     CORRADE_INTERNAL_ASSERT(lightOffset == lightObjects.size());
     CORRADE_INTERNAL_ASSERT(cameraOffset == cameraObjects.size());
@@ -673,17 +789,20 @@ Containers::Optional<SceneData> UfbxImporter::doScene(UnsignedInt) {
        for asset introspection purposes. */
     Containers::Array<SceneFieldData> fields;
 
-    /* Parent, TRS and Visibility all share the implicit object mapping */
+    /* Parent, TRS and Visibility all share the same object mapping, which is
+       implicit unless only a subset of nodes is imported */
+    const SceneFieldFlag nodeMappingFlag = selectedNodes.isEmpty() ?
+        SceneFieldFlag::ImplicitMapping : SceneFieldFlag::OrderedMapping;
     arrayAppend(fields, {
         /** @todo once there's a flag to annotate implicit fields, omit the
             parent field if it's all -1s; or alternatively we could also have a
             stride of 0 for this case */
-        SceneFieldData{SceneField::Parent, nodeObjects, parents, SceneFieldFlag::ImplicitMapping},
-        SceneFieldData{SceneField::Translation, nodeObjects, translations, SceneFieldFlag::ImplicitMapping},
-        SceneFieldData{SceneField::Rotation, nodeObjects, rotations, SceneFieldFlag::ImplicitMapping},
-        SceneFieldData{SceneField::Scaling, nodeObjects, scalings, SceneFieldFlag::ImplicitMapping},
-        SceneFieldData{SceneFieldVisibility, nodeObjects, visibilities, SceneFieldFlag::ImplicitMapping},
-        SceneFieldData{SceneFieldGeometryTransformHelper, nodeObjects, geometryTransformHelpers, SceneFieldFlag::ImplicitMapping},
+        SceneFieldData{SceneField::Parent, nodeObjects, parents, nodeMappingFlag},
+        SceneFieldData{SceneField::Translation, nodeObjects, translations, nodeMappingFlag},
+        SceneFieldData{SceneField::Rotation, nodeObjects, rotations, nodeMappingFlag},
+        SceneFieldData{SceneField::Scaling, nodeObjects, scalings, nodeMappingFlag},
+        SceneFieldData{SceneFieldVisibility, nodeObjects, visibilities, nodeMappingFlag},
+        SceneFieldData{SceneFieldGeometryTransformHelper, nodeObjects, geometryTransformHelpers, nodeMappingFlag},
     });
 
     /* Geometry transforms if user wants to preserve them */
@@ -691,9 +810,9 @@ Containers::Optional<SceneData> UfbxImporter::doScene(UnsignedInt) {
         /** @todo once there's a flag to annotate implicit fields, omit the
             parent field if it's all -1s; or alternatively we could also have a
             stride of 0 for this case */
-        SceneFieldData{SceneFieldGeometryTranslation, nodeObjects, geometryTranslations, SceneFieldFlag::ImplicitMapping},
-        SceneFieldData{SceneFieldGeometryRotation, nodeObjects, geometryRotations, SceneFieldFlag::ImplicitMapping},
-        SceneFieldData{SceneFieldGeometryScaling, nodeObjects, geometryScalings, SceneFieldFlag::ImplicitMapping},
+        SceneFieldData{SceneFieldGeometryTranslation, nodeObjects, geometryTranslations, nodeMappingFlag},
+        SceneFieldData{SceneFieldGeometryRotation, nodeObjects, geometryRotations, nodeMappingFlag},
+        SceneFieldData{SceneFieldGeometryScaling, nodeObjects, geometryScalings, nodeMappingFlag},
     });
 
     /* All other fields have the mapping ordered (they get filed as we iterate
@@ -716,7 +835,7 @@ Containers::Optional<SceneData> UfbxImporter::doScene(UnsignedInt) {
        pointer issues when unloading the plugin */
     arrayShrink(fields, DefaultInit);
 
-    return SceneData{SceneMappingType::UnsignedInt, nodeCount, Utility::move(data), Utility::move(fields)};
+    return SceneData{SceneMappingType::UnsignedInt, _state->objectCount, Utility::move(data), Utility::move(fields)};
 }
 
 SceneField UfbxImporter::doSceneFieldForName(Containers::StringView name) {
@@ -851,11 +970,53 @@ inline UnsignedInt unboundedIfNegative(Int value) {
     return value >= 0 ? UnsignedInt(value) : ~UnsignedInt{};
 }
 
+/* Values of all options affecting convertMesh(), used to detect whether a
+   cached mesh is still up-to-date */
+std::string meshConfigurationKey(const Utility::ConfigurationGroup& configuration) {
+    std::string key;
+    for(const char* name: {"maxUvSets", "maxTangentSets", "maxColorSets", "maxJointWeights", "generateIndices", "weldTolerance"}) {
+        key += name;
+        key += '=';
+        key += configuration.value(name);
+        key += '\n';
+    }
+    return key;
+}
+
 }
 
 Containers::Optional<MeshData> UfbxImporter::doMesh(UnsignedInt id, UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMesh", {}, id};
     if(level != 0) return {};
 
+    if(!configuration().value<bool>("cacheMeshes")) {
+        /* Free whatever was cached before, if the option got disabled */
+        if(!_state->meshes.isEmpty()) {
+            _state->meshes = {};
+            _state->meshConfigurations = {};
+        }
+
+        /* GCC 4.8 needs extra help here */
+        return Containers::optional(convertMesh(id));
+    }
+
+    if(_state->meshes.isEmpty()) {
+        _state->meshes = Containers::Array<Containers::Optional<MeshData>>{_state->meshChunks.size()};
+        _state->meshConfigurations = Containers::Array<std::string>{_state->meshChunks.size()};
+    }
+
+    /* Convert the mesh if it's not cached yet or if the options it was
+       converted with changed since */
+    std::string meshConfiguration = meshConfigurationKey(configuration());
+    if(!_state->meshes[id] || _state->meshConfigurations[id] != meshConfiguration) {
+        _state->meshes[id] = convertMesh(id);
+        _state->meshConfigurations[id] = Utility::move(meshConfiguration);
+    }
+
+    return MeshTools::copy(*_state->meshes[id]);
+}
+
+MeshData UfbxImporter::convertMesh(const UnsignedInt id) {
     const MeshChunk chunk = _state->meshChunks[id];
     const ufbx_mesh* mesh = _state->scene->meshes[chunk.meshId];
     const ufbx_mesh_material mat = mesh->materials[chunk.meshMaterialIndex];
@@ -1031,82 +1192,143 @@ Containers::Optional<MeshData> UfbxImporter::doMesh(UnsignedInt id, UnsignedInt
     CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
     CORRADE_INTERNAL_ASSERT(attributeOffset == stride);
 
-    UnsignedInt dstIx = 0;
-    for(UnsignedInt faceIndex: mat.face_indices) {
-        const ufbx_face face = mesh->faces[faceIndex];
+    /* Converts faces in given range of ufbx_mesh_material::face_indices[],
+       writing to the output starting at given vertex. Each invocation needs
+       its own scratch space for triangulating the faces. */
+    const auto convertFaces = [&](const std::size_t faceBegin, const std::size_t faceEnd, UnsignedInt dstIx, const Containers::ArrayView<UnsignedInt> faceIndices) {
+        for(std::size_t faceIndexIndex = faceBegin; faceIndexIndex != faceEnd; ++faceIndexIndex) {
+            const ufbx_face face = mesh->faces[mat.face_indices[faceIndexIndex]];
 
-        UnsignedInt numIndices = 0;
+            UnsignedInt numIndices = 0;
 
-        switch(chunk.primitive) {
-            case MeshPrimitive::Points:
-                numIndices = face.num_indices == 1 ? 1u : 0u;
-                primitiveIndices[0] = face.index_begin;
-                break;
-            case MeshPrimitive::Lines:
-                numIndices = face.num_indices == 2 ? 2u : 0u;
-                primitiveIndices[0] = face.index_begin + 0;
-                primitiveIndices[1] = face.index_begin + 1;
-                break;
-            case MeshPrimitive::Triangles:
-                numIndices = ufbx_triangulate_face(primitiveIndices.data(), primitiveIndices.size(), mesh, face) * 3;
-                break;
-            default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-        }
+            switch(chunk.primitive) {
+                case MeshPrimitive::Points:
+                    numIndices = face.num_indices == 1 ? 1u : 0u;
+                    faceIndices[0] = face.index_begin;
+                    break;
+                case MeshPrimitive::Lines:
+                    numIndices = face.num_indices == 2 ? 2u : 0u;
+                    faceIndices[0] = face.index_begin + 0;
+                    faceIndices[1] = face.index_begin + 1;
+                    break;
+                case MeshPrimitive::Triangles:
+                    numIndices = ufbx_triangulate_face(faceIndices.data(), faceIndices.size(), mesh, face) * 3;
+                    break;
+                default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+            }
 
-        for(UnsignedInt i = 0; i < numIndices; i++) {
-            const UnsignedInt srcIx = primitiveIndices[i];
-
-            positions[dstIx] = Vector3(mesh->vertex_position[srcIx]);
-
-            if(mesh->vertex_normal.exists)
-                normals[dstIx] = Vector3(mesh->vertex_normal[srcIx]);
-            for(UnsignedInt set = 0; set < uvSetCount; ++set)
-                uvSets[set][dstIx] = Vector2(mesh->uv_sets[set].vertex_uv[srcIx]);
-            for(UnsignedInt set = 0; set < tangentSetCount; ++set)
-                tangentSets[set][dstIx] = Vector3(mesh->uv_sets[set].vertex_tangent[srcIx]);
-            for(UnsignedInt set = 0; set < bitangentSetCount; ++set)
-                bitangentSets[set][dstIx] = Vector3(mesh->uv_sets[set].vertex_bitangent[srcIx]);
-            for(UnsignedInt set = 0; set < colorSetCount; ++set)
-                colorSets[set][dstIx] = Color4(mesh->color_sets[set].vertex_color[srcIx]);
-
-            if(jointWeightCount > 0) {
-                ufbx_skin_vertex vertex = skin->vertices[mesh->vertex_indices[srcIx]];
-                UnsignedInt weightCount = Utility::min(vertex.num_weights, jointWeightCount);
-                Float totalWeight = 0.0f;
-
-                /* We can simply take the first N weights from the skin as they
-                   are sorted in descending order by ufbx. */
-                for(UnsignedInt j = 0; j < weightCount; ++j) {
-                    ufbx_skin_weight weight = skin->weights[vertex.weight_begin + j];
-                    jointIds[dstIx][j] = weight.cluster_index;
-                    weights[dstIx][j] = Float(weight.weight);
-                    totalWeight += Float(weight.weight);
-                }
-                for(UnsignedInt j = weightCount; j < jointWeightCount; ++j) {
-                    jointIds[dstIx][j] = 0;
-                    weights[dstIx][j] = 0.0f;
-                }
-                if(totalWeight > 0.0f) {
+            for(UnsignedInt i = 0; i < numIndices; i++) {
+                const UnsignedInt srcIx = faceIndices[i];
+
+                positions[dstIx] = Vector3(mesh->vertex_position[srcIx]);
+
+                if(mesh->vertex_normal.exists)
+                    normals[dstIx] = Vector3(mesh->vertex_normal[srcIx]);
+                for(UnsignedInt set = 0; set < uvSetCount; ++set)
+                    uvSets[set][dstIx] = Vector2(mesh->uv_sets[set].vertex_uv[srcIx]);
+                for(UnsignedInt set = 0; set < tangentSetCount; ++set)
+                    tangentSets[set][dstIx] = Vector3(mesh->uv_sets[set].vertex_tangent[srcIx]);
+                for(UnsignedInt set = 0; set < bitangentSetCount; ++set)
+                    bitangentSets[set][dstIx] = Vector3(mesh->uv_sets[set].vertex_bitangent[srcIx]);
+                for(UnsignedInt set = 0; set < colorSetCount; ++set)
+                    colorSets[set][dstIx] = Color4(mesh->color_sets[set].vertex_color[srcIx]);
+
+                if(jointWeightCount > 0) {
+                    ufbx_skin_vertex vertex = skin->vertices[mesh->vertex_indices[srcIx]];
+                    UnsignedInt weightCount = Utility::min(vertex.num_weights, jointWeightCount);
+                    Float totalWeight = 0.0f;
+
+                    /* We can simply take the first N weights from the skin as they
+                       are sorted in descending order by ufbx. */
                     for(UnsignedInt j = 0; j < weightCount; ++j) {
-                        weights[dstIx][j] /= totalWeight;
+                        ufbx_skin_weight weight = skin->weights[vertex.weight_begin + j];
+                        jointIds[dstIx][j] = weight.cluster_index;
+                        weights[dstIx][j] = Float(weight.weight);
+                        totalWeight += Float(weight.weight);
+                    }
+                    for(UnsignedInt j = weightCount; j < jointWeightCount; ++j) {
+                        jointIds[dstIx][j] = 0;
+                        weights[dstIx][j] = 0.0f;
+                    }
+                    if(totalWeight > 0.0f) {
+                        for(UnsignedInt j = 0; j < weightCount; ++j) {
+                            weights[dstIx][j] /= totalWeight;
+                        }
                     }
                 }
+
+                dstIx++;
             }
+        }
+    };
 
-            dstIx++;
+    /* The faces are independent, so with multiple threads the face list is
+       split into contiguous ranges, with the output offset of each range
+       calculated upfront from vertex counts of the faces */
+    const std::size_t faceCount = mat.face_indices.count;
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+    if(!threadCount)
+        threadCount = Utility::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = UnsignedInt(Utility::min(std::size_t{threadCount}, faceCount));
+    #else
+    threadCount = 1;
+    #endif
+    if(threadCount <= 1) {
+        convertFaces(0, faceCount, 0, primitiveIndices);
+    } else {
+        #if !defined(CORRADE_TARGET_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+        Containers::Array<std::size_t> faceBegins{NoInit, threadCount + 1};
+        Containers::Array<UnsignedInt> dstBegins{NoInit, threadCount};
+        UnsignedInt dstIx = 0;
+        for(UnsignedInt i = 0; i != threadCount; ++i) {
+            faceBegins[i] = faceCount*i/threadCount;
+            faceBegins[i + 1] = faceCount*(i + 1)/threadCount;
+            dstBegins[i] = dstIx;
+            for(std::size_t j = faceBegins[i]; j != faceBegins[i + 1]; ++j) {
+                const UnsignedInt numIndices = mesh->faces[mat.face_indices[j]].num_indices;
+                switch(chunk.primitive) {
+                    case MeshPrimitive::Points:
+                        dstIx += numIndices == 1 ? 1 : 0;
+                        break;
+                    case MeshPrimitive::Lines:
+                        dstIx += numIndices == 2 ? 2 : 0;
+                        break;
+                    case MeshPrimitive::Triangles:
+                        dstIx += numIndices >= 3 ? (numIndices - 2)*3 : 0;
+                        break;
+                    default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+                }
+            }
         }
+        CORRADE_INTERNAL_ASSERT(dstIx == indexCount);
+
+        /* The calling thread processes the first range */
+        Containers::Array<UnsignedInt> threadPrimitiveIndices{NoInit, primitiveIndices.size()*(threadCount - 1)};
+        Containers::Array<std::thread> threads{threadCount - 1};
+        for(UnsignedInt i = 0; i != threads.size(); ++i)
+            threads[i] = std::thread{convertFaces, faceBegins[i + 1], faceBegins[i + 2], dstBegins[i + 1], threadPrimitiveIndices.sliceSize(i*primitiveIndices.size(), primitiveIndices.size())};
+        convertFaces(faceBegins[0], faceBegins[1], dstBegins[0], primitiveIndices);
+        for(std::thread& thread: threads)
+            thread.join();
+        #endif
     }
 
     MeshData meshData{chunk.primitive,
         Utility::move(vertexData), Utility::move(attributeData),
         UnsignedInt(indexCount)};
 
-    /* Deduplicate the data into an indexed mesh if desired */
-    if(configuration().value<bool>("generateIndices"))
-        meshData = MeshTools::removeDuplicates(meshData);
+    /* Deduplicate the data into an indexed mesh if desired, optionally
+       welding also vertices that are close enough */
+    if(configuration().value<bool>("generateIndices")) {
+        const Double weldTolerance = configuration().value<Double>("weldTolerance");
+        if(weldTolerance > 0.0)
+            meshData = MeshTools::removeDuplicatesFuzzy(meshData, Float(weldTolerance), weldTolerance);
+        else
+            meshData = MeshTools::removeDuplicates(meshData);
+    }
 
-    /* GCC 4.8 needs extra help here */
-    return Containers::optional(Utility::move(meshData));
+    return meshData;
 }
 
 UnsignedInt UfbxImporter::doMaterialCount() const {
@@ -1170,6 +1392,7 @@ inline bool isMapUsed(const ufbx_material_map& map) {
 }
 
 Containers::Optional<MaterialData> UfbxImporter::doMaterial(UnsignedInt id) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doMaterial", {}, id};
     const ufbx_material* material = _state->scene->materials[id];
 
     const bool preserveMaterialFactors = configuration().value<bool>("preserveMaterialFactors");
@@ -1451,13 +1674,15 @@ AbstractImporter* UfbxImporter::setupOrReuseImporterForImage(UnsignedInt id, con
        fails, the importer will stay unset, but the ID will be updated so the
        next round can again just return nullptr above instead of going through
        the doomed-to-fail process again. */
-    _state->imageImporter = Containers::NullOpt;
+    releaseImageImporter();
     _state->imageImporterId = id;
 
     AnyImageImporter importer{*manager()};
     importer.setFlags(flags());
     if(fileCallback()) importer.setFileCallback(fileCallback(), fileCallbackUserData());
 
+    Containers::Optional<AnyImageImporter> pooledImporter;
+    Containers::String pooledFilename;
     if(file.content.size > 0) {
         auto textureData = Containers::ArrayView<const char>(reinterpret_cast<const char*>(file.content.data), file.content.size);
         if(!importer.openData(textureData))
@@ -1469,16 +1694,33 @@ AbstractImporter* UfbxImporter::setupOrReuseImporterForImage(UnsignedInt id, con
         }
 
         ufbx_string filename = file.filename.length > 0 ? file.filename : file.absolute_filename;
-        if(!importer.openFile(filename))
+
+        /* If there's an importer already opened for the same file in the
+           shared pool, take it from there instead of opening the file
+           again */
+        if(configuration().value<std::size_t>("imageImporterPoolSize")) {
+            pooledFilename = Containers::String{filename};
+            pooledImporter = Magnum::Implementation::imageImporterPool().acquire(manager(), pooledFilename, flags(), fileCallback(), fileCallbackUserData());
+        }
+        if(!pooledImporter && !importer.openFile(filename))
             return nullptr;
     }
+    AnyImageImporter& opened = pooledImporter ? *pooledImporter : importer;
 
-    if(importer.image2DCount() != 1) {
-        Error{} << errorPrefix << "expected exactly one 2D image in an image file but got" << importer.image2DCount();
+    if(opened.image2DCount() != 1) {
+        Error{} << errorPrefix << "expected exactly one 2D image in an image file but got" << opened.image2DCount();
         return nullptr;
     }
 
-    return &_state->imageImporter.emplace(Utility::move(importer));
+    _state->imageImporterFilename = Utility::move(pooledFilename);
+    return &_state->imageImporter.emplace(Utility::move(opened));
+}
+
+void UfbxImporter::releaseImageImporter() {
+    if(_state->imageImporter && _state->imageImporterFilename)
+        Magnum::Implementation::imageImporterPool().release(manager(), _state->imageImporterFilename, flags(), fileCallback(), fileCallbackUserData(), Utility::move(*_state->imageImporter), configuration().value<std::size_t>("imageImporterPoolSize"));
+    _state->imageImporter = Containers::NullOpt;
+    _state->imageImporterFilename = {};
 }
 
 UnsignedInt UfbxImporter::doImage2DCount() const {
@@ -1497,6 +1739,7 @@ UnsignedInt UfbxImporter::doImage2DLevelCount(UnsignedInt id) {
 }
 
 Containers::Optional<ImageData2D> UfbxImporter::doImage2D(UnsignedInt id, UnsignedInt level) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D", {}, id};
     CORRADE_ASSERT(manager(), "Trade::UfbxImporter::image2D(): the plugin must be instantiated with access to plugin manager in order to open image files", {});
 
     AbstractImporter* importer = setupOrReuseImporterForImage(id, "Trade::UfbxImporter::image2D():");
@@ -1675,6 +1918,64 @@ struct AnimTrack {
 
 constexpr AnimationTrackTarget AnimationTrackTargetVisibility = animationTrackTargetCustom(0);
 
+/* Value comparison and interpolation matching what AnimationData uses for
+   Animation::Interpolation::Linear, bool tracks are interpolated with
+   Math::select() */
+template<class T> inline bool keyframeWithin(const T& a, const T& b, const Float tolerance) {
+    return (a - b).length() <= tolerance;
+}
+template<> inline bool keyframeWithin(const bool& a, const bool& b, Float) {
+    return a == b;
+}
+template<class T> inline T keyframeInterpolate(const T& a, const T& b, const Float t) {
+    return Math::lerp(a, b, t);
+}
+template<> inline bool keyframeInterpolate(const bool& a, const bool& b, const Float t) {
+    return Math::select(a, b, t);
+}
+
+/* Removes keyframes that can be reconstructed by interpolating the
+   surrounding keyframes within given tolerance, compacting the remaining
+   ones to the front. Constant tracks are reduced to a single keyframe.
+   Returns the new keyframe count. */
+template<class T> std::size_t reduceKeyframes(const Containers::ArrayView<Float> times, const Containers::StridedArrayView1D<T>& values, const Float tolerance) {
+    const std::size_t count = times.size();
+    if(count < 2) return count;
+
+    bool constant = true;
+    for(std::size_t i = 1; i != count && constant; ++i)
+        constant = keyframeWithin(values[i], values[0], tolerance);
+    if(constant) return 1;
+
+    /* Greedily drop a keyframe if all keyframes dropped since the last kept
+       one, including itself, are reproduced by interpolating between the last
+       kept keyframe and the next one. The kept keyframes are compacted to the
+       front, the last one being at out - 1. Slots after keptOriginal are
+       never overwritten before they're checked as out <= keptOriginal + 1. */
+    std::size_t out = 1;
+    std::size_t keptOriginal = 0;
+    for(std::size_t i = 1; i + 1 < count; ++i) {
+        const Float keptTime = times[out - 1];
+        const T kept = values[out - 1];
+        const Float duration = times[i + 1] - keptTime;
+
+        bool redundant = duration > 0.0f;
+        for(std::size_t j = keptOriginal + 1; j <= i && redundant; ++j)
+            redundant = keyframeWithin(keyframeInterpolate(kept, T(values[i + 1]), (times[j] - keptTime)/duration), T(values[j]), tolerance);
+
+        if(!redundant) {
+            times[out] = times[i];
+            values[out] = values[i];
+            keptOriginal = i;
+            ++out;
+        }
+    }
+
+    times[out] = times[count - 1];
+    values[out] = values[count - 1];
+    return out + 1;
+}
+
 constexpr Containers::StringView animationTrackTargetNames[]{
     "visibility"_s,
 };
@@ -1703,12 +2004,16 @@ Containers::Optional<AnimationData> UfbxImporter::doAnimation(UnsignedInt id) {
     const Double minimumSampleRate = configuration().value<Double>("minimumSampleRate");
     const Double constantInterpolationDuration = configuration().value<Double>("constantInterpolationDuration");
     const bool animateFullTransform = configuration().value<bool>("animateFullTransform");
+    const bool reduceKeyframesEnabled = configuration().value<bool>("reduceKeyframes");
+    const Float keyframeTolerance = configuration().value<Float>("keyframeTolerance");
 
     for(const ufbx_anim_layer* layer: layers) {
         for(const ufbx_anim_prop& prop: layer->anim_props) {
             if(prop.element->type != UFBX_ELEMENT_NODE) continue;
             ufbx_node* node = reinterpret_cast<ufbx_node*>(prop.element);
             if(node->is_root) continue;
+            /* Skip tracks of nodes not selected by the nodeFilter option */
+            if(!_state->selectedNodes.isEmpty() && !_state->selectedNodes[node->typed_id]) continue;
             Containers::StringView name(prop.prop_name);
 
             if(animateFullTransform && (name == UFBX_Lcl_Translation || name == UFBX_Lcl_Rotation || name == UFBX_Lcl_Scaling)) {
@@ -1891,6 +2196,60 @@ Containers::Optional<AnimationData> UfbxImporter::doAnimation(UnsignedInt id) {
         }
     }
 
+    /* Drop redundant keyframes from the baked tracks and copy the rest to a
+       tightly-sized allocation */
+    if(reduceKeyframesEnabled) {
+        Containers::Array<std::size_t> reducedCounts{NoInit, animTracks.size()};
+        for(std::size_t i = 0; i != animTracks.size(); ++i) {
+            const AnimTrack& track = animTracks[i];
+            switch(track.target) {
+                case AnimationTrackTarget::Translation3D:
+                case AnimationTrackTarget::Scaling3D:
+                    reducedCounts[i] = reduceKeyframes(track.times, Containers::arrayCast<1, Vector3>(track.values), keyframeTolerance);
+                    break;
+                case AnimationTrackTarget::Rotation3D:
+                    reducedCounts[i] = reduceKeyframes(track.times, Containers::arrayCast<1, Quaternion>(track.values), keyframeTolerance);
+                    break;
+                #ifdef CORRADE_TARGET_MSVC
+                #pragma warning(push)
+                /* case '32768' is not a valid value for switch of enum
+                'Magnum::Trade::AnimationTrackTarget' */
+                #pragma warning(disable: 4063)
+                #endif
+                case AnimationTrackTargetVisibility:
+                    reducedCounts[i] = reduceKeyframes(track.times, Containers::arrayCast<1, bool>(track.values), keyframeTolerance);
+                    break;
+                #ifdef CORRADE_TARGET_MSVC
+                #pragma warning(pop)
+                #endif
+                default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+            }
+        }
+
+        /* Again reserving upfront as references to the views are stored in
+           reducedDataItems */
+        Containers::Array<AnimTrack> reducedTracks;
+        arrayReserve(reducedTracks, animTracks.size());
+        Containers::Array<Containers::ArrayTuple::Item> reducedDataItems;
+        arrayReserve(reducedDataItems, animTracks.size()*2);
+        for(std::size_t i = 0; i != animTracks.size(); ++i) {
+            AnimTrack& reducedTrack = arrayAppend(reducedTracks, animTracks[i]);
+            arrayAppend(reducedDataItems, {
+                {NoInit, reducedCounts[i], reducedTrack.times},
+                {NoInit, reducedCounts[i], animationTrackTypeSize(reducedTrack.type), animationTrackTypeAlignment(reducedTrack.type), reducedTrack.values}
+            });
+        }
+
+        Containers::Array<char> reducedData = Containers::ArrayTuple{reducedDataItems};
+        for(std::size_t i = 0; i != animTracks.size(); ++i) {
+            Utility::copy(animTracks[i].times.prefix(reducedCounts[i]), reducedTracks[i].times);
+            Utility::copy(animTracks[i].values.prefix(reducedCounts[i]), reducedTracks[i].values);
+        }
+
+        data = Utility::move(reducedData);
+        animTracks = Utility::move(reducedTracks);
+    }
+
     for(std::size_t i = 0; i < animTracks.size(); ++i) {
         const AnimTrack& animTrack = animTracks[i];
 
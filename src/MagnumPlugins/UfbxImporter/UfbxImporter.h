@@ -124,12 +124,20 @@ See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 The plugin supports @ref ImporterFeature::OpenData and
 @relativeref{ImporterFeature,FileCallback} features. Immediate dependencies are
 loaded during the initial import meaning the callback is called with
-@ref InputFileCallbackPolicy::LoadTemporary. In case of images, the files are
-loaded on-demand inside @ref image2D() calls with
+@ref InputFileCallbackPolicy::LoadTemporary and
+@ref InputFileCallbackPolicy::Close is emitted as soon as `ufbx` finishes
+reading given file, which may be before the import is done. The data returned
+from the callback are read directly without being copied. In case of images,
+the files are loaded on-demand inside @ref image2D() calls with
 @ref InputFileCallbackPolicy::LoadTemporary and
 @ref InputFileCallbackPolicy::Close is emitted right after the file is fully
 read.
 
+Files opened from the filesystem without a file callback are streamed by
+`ufbx` in chunks of a size controlled by the @cb{.ini} readBufferSize @ce
+@ref Trade-UfbxImporter-configuration "configuration option", without being
+read into memory in full.
+
 The importer recognizes @ref ImporterFlag::Verbose if built in debug mode
 (@ref CORRADE_IS_DEBUG_BUILD defined or @cpp NDEBUG @ce not defined). The
 verbose logging prints detailed `ufbx`-internal callstacks on load failure that
@@ -160,7 +168,8 @@ delegates to.
     @ref SceneFieldType::Vector3d) and importer-specific flags
     @cpp "visibility" @ce and @cpp "geometricTransformHelper" @ce (both of type
     @ref SceneFieldType::Bit). These five fields share the same object mapping
-    with @ref SceneFieldFlag::ImplicitMapping set.
+    with @ref SceneFieldFlag::ImplicitMapping set, unless the
+    @cb{.ini} nodeFilter @ce option is used, see below.
 -   Scene field @cpp "visibility" @ce specifies whether objects should be
     visible in some application-defined manner.
 -   Scene field @cpp "geometryTransformHelper" @ce is set on synthetic nodes
@@ -186,6 +195,20 @@ delegates to.
 -   The node transformations are expressed in a file dependent units and axes.
     @ref UfbxImporter supports normalizing them to a consistent space, see
     @ref Trade-UfbxImporter-processing-unit-normalization for further details.
+-   The @cb{.ini} nodeFilter @ce @ref Trade-UfbxImporter-configuration "configuration option"
+    restricts the scene to nodes with given names. It's a space-separated
+    list where each entry can contain @cb{.ini} * @ce and @cb{.ini} ? @ce
+    wildcards. Matching nodes are imported together with all their children
+    and all their parents, the rest is left out of the scene and their
+    animation tracks are skipped in @ref animation(). Object IDs and
+    @ref objectCount() stay the same as without the filter, the node fields
+    have @ref SceneFieldFlag::OrderedMapping instead of
+    @relativeref{SceneFieldFlag,ImplicitMapping} in that case. Meshes are
+    converted lazily on @ref mesh() so only the ones actually used cost
+    conversion time, however `ufbx` has no way to skip parsing of unselected
+    content, so the file is still parsed and kept in memory in whole. Use the
+    @cb{.ini} ignoreGeometry @ce, @cb{.ini} ignoreAnimation @ce and other
+    options to skip content globally.
 
 @subsection Trade-UfbxImporter-behavior-materials Material import
 
@@ -237,6 +260,21 @@ delegates to.
     (@ref MeshPrimitive::Points and @relativeref{MeshPrimitive,Lines})
 -   Faces with more than three vertices are triangulated and represented as
     @ref MeshPrimitive::Triangles.
+-   Triangulation and index generation is done only once given mesh is
+    imported, opening a file only splits the meshes by material and primitive
+    type. With the @cb{.ini} generateIndices @ce
+    @ref Trade-UfbxImporter-configuration "configuration option" enabled,
+    vertices are welded using @ref MeshTools::removeDuplicates(const MeshData&),
+    or with @ref MeshTools::removeDuplicatesFuzzy(const MeshData&, Float, Double)
+    if @cb{.ini} weldTolerance @ce is set to a positive value. With the
+    @cb{.ini} cacheMeshes @ce option enabled, the converted meshes are kept
+    in the importer and repeated imports return just a copy, as long as none
+    of the mesh-related options changed in the meantime.
+-   With the @cb{.ini} threads @ce @ref Trade-UfbxImporter-configuration "configuration option"
+    set to a value other than @cpp 1 @ce, faces of an imported mesh are split
+    into contiguous ranges that are triangulated and converted in parallel.
+    The bundled `ufbx` version doesn't support a thread pool, so the file
+    parsing itself is always done on a single thread.
 
 The meshes are indexed by default unless @cb{.ini} generateIndices @ce
 @ref Trade-UfbxImporter-configuration "configuration option" is disabled.
@@ -279,6 +317,13 @@ setting any to zero disables loading any tangents etc.
     constant interpolation interval can be adjusted via the
     @cb{.ini} constantInterpolationDuration @ce
     @ref Trade-UfbxImporter-configuration "configuration option".
+-   The resampled tracks are dense, with a keyframe at every sample. Enabling
+    the @cb{.ini} reduceKeyframes @ce
+    @ref Trade-UfbxImporter-configuration "configuration option" removes
+    keyframes that can be reconstructed by interpolating their neighbors
+    within @cb{.ini} keyframeTolerance @ce and reduces tracks that don't
+    change at all to a single keyframe. The reduced tracks are stored in a
+    tightly-sized allocation.
 -   Skin deformers are supported but only the first skin deformer for a mesh is
     imported at the moment.
 
@@ -295,6 +340,19 @@ setting any to zero disables loading any tangents etc.
 -   Both external and embedded images are supported via the
     @ref AnyImageImporter plugin.
 -   Only 2D images are supported.
+-   The importer opened for the most recently accessed image is kept around
+    so importing its other levels doesn't open the file again. Setting the
+    @cb{.ini} imageImporterPoolSize @ce @ref Trade-UfbxImporter-configuration "configuration option"
+    to a non-zero value puts importers of external image files into a pool
+    shared by all @ref UfbxImporter instances created from the same plugin
+    manager once another image is accessed or the file is closed. Importing
+    the same image file from another scene file, or again after the file was
+    closed and reopened, then takes the already opened importer from the pool
+    instead of opening the image file again. The pool is thread-safe, each
+    pooled importer is used by just one importer instance at a time. It's
+    assumed the image files don't change while they're in the pool. The pool
+    is emptied once the last @ref UfbxImporter instance created from given
+    plugin manager is destroyed.
 
 @section Trade-UfbxImporter-processing Scene processing
 
@@ -453,6 +511,10 @@ below for all options and their default values:
 
 @snippet MagnumPlugins/UfbxImporter/UfbxImporter.conf configuration_
 
+Note that in order to use multiple threads with the @cb{.ini} threads @ce
+option, the application has to link to a threading library, such as
+`Threads::Threads` in CMake.
+
 See @ref plugins-configuration for more information and an example showing how
 to edit the configuration values.
 */
@@ -494,6 +556,7 @@ class MAGNUM_UFBXIMPORTER_EXPORT UfbxImporter: public AbstractImporter {
 
         MAGNUM_UFBXIMPORTER_LOCAL UnsignedInt doMeshCount() const override;
         MAGNUM_UFBXIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
+        MAGNUM_UFBXIMPORTER_LOCAL MeshData convertMesh(UnsignedInt id);
 
         MAGNUM_UFBXIMPORTER_LOCAL UnsignedInt doMaterialCount() const override;
         MAGNUM_UFBXIMPORTER_LOCAL Int doMaterialForName(Containers::StringView name) override;
@@ -506,6 +569,7 @@ class MAGNUM_UFBXIMPORTER_EXPORT UfbxImporter: public AbstractImporter {
         MAGNUM_UFBXIMPORTER_LOCAL Containers::Optional<TextureData> doTexture(UnsignedInt id) override;
 
         MAGNUM_UFBXIMPORTER_LOCAL AbstractImporter* setupOrReuseImporterForImage(UnsignedInt id, const char* errorPrefix);
+        MAGNUM_UFBXIMPORTER_LOCAL void releaseImageImporter();
 
         MAGNUM_UFBXIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_UFBXIMPORTER_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
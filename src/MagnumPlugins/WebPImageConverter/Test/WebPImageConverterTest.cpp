@@ -0,0 +1,293 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/DebugTools/CompareImage.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct WebPImageConverterTest: TestSuite::Tester {
+    explicit WebPImageConverterTest();
+
+    void wrongFormat();
+    void invalidConfiguration();
+
+    void convert();
+    void useThreads();
+
+    void unsupportedMetadata();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
+    PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
+};
+
+constexpr const char OriginalRgbData[] = {
+    /* Skip */
+    0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+
+    '\x00', '\x27', '\x48', '\x10', '\x34', '\x54',
+    '\x22', '\x46', '\x60', '\x25', '\x49', '\x63',
+    '\x21', '\x46', '\x63', '\x13', '\x3a', '\x59', 0, 0,
+
+    '\x5b', '\x87', '\xae', '\x85', '\xaf', '\xd5',
+    '\x94', '\xbd', '\xdd', '\x96', '\xbf', '\xdf',
+    '\x91', '\xbc', '\xdf', '\x72', '\x9e', '\xc1', 0, 0,
+
+    '\x3c', '\x71', '\xa7', '\x68', '\x9c', '\xce',
+    '\x8b', '\xbb', '\xe9', '\x92', '\xc3', '\xee',
+    '\x8b', '\xbe', '\xed', '\x73', '\xa7', '\xd6', 0, 0,
+
+    '\x00', '\x34', '\x70', '\x12', '\x4a', '\x83',
+    '\x35', '\x6a', '\x9e', '\x45', '\x7a', '\xac',
+    '\x34', '\x6c', '\x9f', '\x1d', '\x56', '\x8b', 0, 0
+};
+
+const ImageView2D OriginalRgb{PixelStorage{}.setSkip({0, 1, 0}),
+    PixelFormat::RGB8Unorm, {6, 4}, OriginalRgbData};
+
+constexpr const char OriginalRgbaData[] = {
+    '\x00', '\x27', '\x48', '\xff', '\x10', '\x34', '\x54', '\xff',
+    '\x22', '\x46', '\x60', '\xff', '\x25', '\x49', '\x63', '\xff',
+    '\x21', '\x46', '\x63', '\xff', '\x13', '\x3a', '\x59', '\xff',
+
+    '\x5b', '\x87', '\xae', '\x80', '\x85', '\xaf', '\xd5', '\x80',
+    '\x94', '\xbd', '\xdd', '\x80', '\x96', '\xbf', '\xdf', '\x80',
+    '\x91', '\xbc', '\xdf', '\x80', '\x72', '\x9e', '\xc1', '\x80',
+
+    '\x3c', '\x71', '\xa7', '\x40', '\x68', '\x9c', '\xce', '\x40',
+    '\x8b', '\xbb', '\xe9', '\x40', '\x92', '\xc3', '\xee', '\x40',
+    '\x8b', '\xbe', '\xed', '\x40', '\x73', '\xa7', '\xd6', '\x40',
+
+    '\x00', '\x34', '\x70', '\x20', '\x12', '\x4a', '\x83', '\x20',
+    '\x35', '\x6a', '\x9e', '\x20', '\x45', '\x7a', '\xac', '\x20',
+    '\x34', '\x6c', '\x9f', '\x20', '\x1d', '\x56', '\x8b', '\x20'
+};
+
+const ImageView2D OriginalRgba{PixelFormat::RGBA8Unorm, {6, 4}, OriginalRgbaData};
+
+const struct {
+    const char* name;
+    const char* option;
+    const char* value;
+    const char* message;
+} InvalidConfigurationData[]{
+    {"quality too small", "quality", "-0.5",
+        "expected quality to be between 0 and 100 but got -0.5"},
+    {"quality too large", "quality", "100.5",
+        "expected quality to be between 0 and 100 but got 100.5"},
+    {"method too small", "method", "-1",
+        "expected method to be between 0 and 6 but got -1"},
+    {"method too large", "method", "7",
+        "expected method to be between 0 and 6 but got 7"},
+    {"invalid preset", "preset", "photograph",
+        "expected preset to be picture, photo, drawing, icon, text or empty but got photograph"},
+};
+
+const struct {
+    const char* name;
+    const ImageView2D& image;
+    bool lossless;
+    const char* preset;
+    const char* chunk;
+} ConvertData[]{
+    {"RGB, lossy", OriginalRgb, false, nullptr, "VP8 "},
+    {"RGB, lossy, photo preset", OriginalRgb, false, "photo", "VP8 "},
+    {"RGB, lossless", OriginalRgb, true, nullptr, "VP8L"},
+    /* Alpha in a lossy file needs an extended header */
+    {"RGBA, lossy", OriginalRgba, false, nullptr, "VP8X"},
+    {"RGBA, lossless", OriginalRgba, true, nullptr, "VP8L"},
+};
+
+const struct {
+    const char* name;
+    bool lossless;
+} UseThreadsData[]{
+    {"lossy", false},
+    {"lossless", true},
+};
+
+const struct {
+    const char* name;
+    ImageConverterFlags converterFlags;
+    ImageFlags2D imageFlags;
+    const char* message;
+} UnsupportedMetadataData[]{
+    {"1D array", {}, ImageFlag2D::Array,
+        "1D array images are unrepresentable in WebP, saving as a regular 2D image"},
+    {"1D array, quiet", ImageConverterFlag::Quiet, ImageFlag2D::Array,
+        nullptr},
+};
+
+WebPImageConverterTest::WebPImageConverterTest() {
+    addTests({&WebPImageConverterTest::wrongFormat});
+
+    addInstancedTests({&WebPImageConverterTest::invalidConfiguration},
+        Containers::arraySize(InvalidConfigurationData));
+
+    addInstancedTests({&WebPImageConverterTest::convert},
+        Containers::arraySize(ConvertData));
+
+    addInstancedTests({&WebPImageConverterTest::useThreads},
+        Containers::arraySize(UseThreadsData));
+
+    addInstancedTests({&WebPImageConverterTest::unsupportedMetadata},
+        Containers::arraySize(UnsupportedMetadataData));
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef WEBPIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(WEBPIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    /* The WebPImporter is optional */
+    #ifdef WEBPIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(WEBPIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void WebPImageConverterTest::wrongFormat() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("WebPImageConverter");
+
+    const char data[4]{};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::R8Unorm, {1, 1}, data}));
+    CORRADE_COMPARE(out.str(), "Trade::WebPImageConverter::convertToData(): unsupported pixel format PixelFormat::R8Unorm\n");
+}
+
+void WebPImageConverterTest::invalidConfiguration() {
+    auto&& data = InvalidConfigurationData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("WebPImageConverter");
+    converter->configuration().setValue(data.option, data.value);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(OriginalRgb));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::WebPImageConverter::convertToData(): {}\n", data.message));
+}
+
+void WebPImageConverterTest::convert() {
+    auto&& data = ConvertData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("WebPImageConverter");
+    CORRADE_COMPARE(converter->extension(), "webp");
+    CORRADE_COMPARE(converter->mimeType(), "image/webp");
+    CORRADE_VERIFY(!converter->configuration().value<bool>("lossless"));
+    converter->configuration().setValue("lossless", data.lossless);
+    if(data.preset)
+        converter->configuration().setValue("preset", data.preset);
+    /* Otherwise the lossless RGBA output wouldn't round-trip exactly */
+    converter->configuration().setValue("exact", true);
+
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(data.image);
+    CORRADE_VERIFY(out);
+
+    /* RIFF header, file size, WEBP and then the first chunk */
+    Containers::StringView string = *out;
+    CORRADE_COMPARE_AS(string.size(), std::size_t{16}, TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE(string.prefix(4), "RIFF");
+    CORRADE_COMPARE(string.slice(8, 12), "WEBP");
+    CORRADE_COMPARE(string.slice(12, 16), data.chunk);
+
+    if(_importerManager.loadState("WebPImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("WebPImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("WebPImporter");
+    CORRADE_VERIFY(importer->openData(*out));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->size(), data.image.size());
+    CORRADE_COMPARE(converted->format(), data.image.format());
+
+    /* Lossless output should be exactly the same, lossy only roughly */
+    if(data.lossless)
+        CORRADE_COMPARE_AS(*converted, data.image, DebugTools::CompareImage);
+    else
+        CORRADE_COMPARE_WITH(*converted, data.image,
+            (DebugTools::CompareImage{64.0f, 16.0f}));
+}
+
+void WebPImageConverterTest::useThreads() {
+    auto&& data = UseThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("WebPImageConverter");
+    converter->configuration().setValue("lossless", data.lossless);
+    CORRADE_VERIFY(!converter->configuration().value<bool>("useThreads"));
+
+    Containers::Optional<Containers::Array<char>> expected = converter->convertToData(OriginalRgb);
+    CORRADE_VERIFY(expected);
+
+    /* The output should be the same as with a single thread */
+    converter->configuration().setValue("useThreads", true);
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(OriginalRgb);
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE_AS(*out, *expected,
+        TestSuite::Compare::Container);
+}
+
+void WebPImageConverterTest::unsupportedMetadata() {
+    auto&& data = UnsupportedMetadataData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("WebPImageConverter");
+    converter->addFlags(data.converterFlags);
+
+    const char imageData[4]{};
+    ImageView2D image{PixelFormat::RGB8Unorm, {1, 1}, imageData, data.imageFlags};
+
+    std::ostringstream out;
+    Warning redirectWarning{&out};
+    CORRADE_VERIFY(converter->convertToData(image));
+    if(!data.message)
+        CORRADE_COMPARE(out.str(), "");
+    else
+        CORRADE_COMPARE(out.str(), Utility::formatString("Trade::WebPImageConverter::convertToData(): {}\n", data.message));
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::WebPImageConverterTest)
@@ -0,0 +1,187 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+#include "WebPImageConverter.h"
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+
+#include "Magnum/Implementation/instrumentation.h"
+
+#include <webp/encode.h>
+
+namespace Magnum { namespace Trade {
+
+using namespace Containers::Literals;
+
+WebPImageConverter::WebPImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImageConverter{manager, plugin} {}
+
+ImageConverterFeatures WebPImageConverter::doFeatures() const { return ImageConverterFeature::Convert2DToData; }
+
+Containers::String WebPImageConverter::doExtension() const { return "webp"_s; }
+
+Containers::String WebPImageConverter::doMimeType() const {
+    return "image/webp"_s;
+}
+
+namespace {
+
+const char* encodingErrorString(const WebPEncodingError error) {
+    switch(error) {
+        /* LCOV_EXCL_START */
+        case VP8_ENC_ERROR_OUT_OF_MEMORY: return "out of memory";
+        case VP8_ENC_ERROR_BITSTREAM_OUT_OF_MEMORY: return "out of memory while flushing bits";
+        case VP8_ENC_ERROR_NULL_PARAMETER: return "a pointer parameter is null";
+        case VP8_ENC_ERROR_INVALID_CONFIGURATION: return "invalid configuration";
+        case VP8_ENC_ERROR_BAD_DIMENSION: return "bad picture dimension";
+        case VP8_ENC_ERROR_PARTITION0_OVERFLOW: return "partition is bigger than 512k";
+        case VP8_ENC_ERROR_PARTITION_OVERFLOW: return "partition is bigger than 16M";
+        case VP8_ENC_ERROR_BAD_WRITE: return "error while flushing bytes";
+        case VP8_ENC_ERROR_FILE_TOO_BIG: return "file is bigger than 4G";
+        case VP8_ENC_ERROR_USER_ABORT: return "process aborted";
+        case VP8_ENC_ERROR_LAST:
+        case VP8_ENC_OK: ;
+        /* LCOV_EXCL_STOP */
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+}
+
+Containers::Optional<Containers::Array<char>> WebPImageConverter::doConvertToData(const ImageView2D& image) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doConvertToData"};
+    /* Warn about lost metadata */
+    if(image.flags() & ImageFlag2D::Array && !(flags() & ImageConverterFlag::Quiet)) {
+        Warning{} << "Trade::WebPImageConverter::convertToData(): 1D array images are unrepresentable in WebP, saving as a regular 2D image";
+    }
+
+    bool alpha;
+    switch(image.format()) {
+        case PixelFormat::RGB8Unorm:
+            alpha = false;
+            break;
+        case PixelFormat::RGBA8Unorm:
+            alpha = true;
+            break;
+        default:
+            Error{} << "Trade::WebPImageConverter::convertToData(): unsupported pixel format" << image.format();
+            return {};
+    }
+
+    /* Encoder configuration */
+    const Float quality = configuration().value<Float>("quality");
+    if(quality < 0.0f || quality > 100.0f) {
+        Error{} << "Trade::WebPImageConverter::convertToData(): expected quality to be between 0 and 100 but got" << quality;
+        return {};
+    }
+    const Int method = configuration().value<Int>("method");
+    if(method < 0 || method > 6) {
+        Error{} << "Trade::WebPImageConverter::convertToData(): expected method to be between 0 and 6 but got" << method;
+        return {};
+    }
+
+    WebPConfig config;
+    const Containers::StringView presetString = configuration().value<Containers::StringView>("preset");
+    if(presetString) {
+        WebPPreset preset;
+        if(presetString == "picture"_s)
+            preset = WEBP_PRESET_PICTURE;
+        else if(presetString == "photo"_s)
+            preset = WEBP_PRESET_PHOTO;
+        else if(presetString == "drawing"_s)
+            preset = WEBP_PRESET_DRAWING;
+        else if(presetString == "icon"_s)
+            preset = WEBP_PRESET_ICON;
+        else if(presetString == "text"_s)
+            preset = WEBP_PRESET_TEXT;
+        else {
+            Error{} << "Trade::WebPImageConverter::convertToData(): expected preset to be picture, photo, drawing, icon, text or empty but got" << presetString;
+            return {};
+        }
+        CORRADE_INTERNAL_ASSERT_OUTPUT(WebPConfigPreset(&config, preset, quality));
+    } else CORRADE_INTERNAL_ASSERT_OUTPUT(WebPConfigInit(&config));
+
+    config.lossless = configuration().value<bool>("lossless");
+    config.quality = quality;
+    config.method = method;
+    config.exact = configuration().value<bool>("exact");
+    config.thread_level = configuration().value<bool>("useThreads");
+    CORRADE_INTERNAL_ASSERT(WebPValidateConfig(&config));
+
+    /* Picture setup. Lossless encoding works with ARGB directly, lossy
+       converts to YUV. */
+    WebPPicture picture;
+    CORRADE_INTERNAL_ASSERT_OUTPUT(WebPPictureInit(&picture));
+    picture.width = image.size().x();
+    picture.height = image.size().y();
+    picture.use_argb = config.lossless;
+
+    /* Import the pixels with Y flipped, using a negative stride. The rows
+       may have padding but the pixels in each should be contiguous. */
+    const Containers::StridedArrayView3D<const char> pixelsFlipped = image.pixels().flipped<0>();
+    CORRADE_INTERNAL_ASSERT(pixelsFlipped.isContiguous<1>());
+    const std::uint8_t* const data = static_cast<const std::uint8_t*>(pixelsFlipped.data());
+    const int stride = pixelsFlipped.stride()[0];
+    if(!(alpha ? WebPPictureImportRGBA(&picture, data, stride) : WebPPictureImportRGB(&picture, data, stride))) {
+        Error{} << "Trade::WebPImageConverter::convertToData(): error importing the image:" << encodingErrorString(picture.error_code);
+        WebPPictureFree(&picture);
+        return {};
+    }
+
+    /* Write directly into a growable array instead of using WebPMemoryWriter
+       to avoid an extra copy */
+    Containers::Array<char> out;
+    picture.custom_ptr = &out;
+    picture.writer = [](const std::uint8_t* data, std::size_t size, const WebPPicture* picture) -> int {
+        arrayAppend(*static_cast<Containers::Array<char>*>(picture->custom_ptr), Containers::arrayView(reinterpret_cast<const char*>(data), size));
+        return 1;
+    };
+
+    const bool success = WebPEncode(&config, &picture);
+    const WebPEncodingError error = picture.error_code;
+    WebPPictureFree(&picture);
+    if(!success) {
+        Error{} << "Trade::WebPImageConverter::convertToData(): encoding error:" << encodingErrorString(error);
+        return {};
+    }
+
+    /* Convert the growable array back to a non-growable with the default
+       deleter so we can return it */
+    arrayShrink(out);
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(out));
+}
+
+}}
+
+CORRADE_PLUGIN_REGISTER(WebPImageConverter, Magnum::Trade::WebPImageConverter,
+    MAGNUM_TRADE_ABSTRACTIMAGECONVERTER_PLUGIN_INTERFACE)
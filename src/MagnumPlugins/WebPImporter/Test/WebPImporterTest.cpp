@@ -26,11 +26,14 @@
 
 #include <sstream>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
@@ -42,6 +45,10 @@
 
 #include "configure.h"
 
+#ifndef WEBPIMPORTER_PLUGIN_FILENAME
+#include "MagnumPlugins/WebPImporter/WebPImporter.h"
+#endif
+
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
 struct WebPImporterTest: TestSuite::Tester {
@@ -57,6 +64,20 @@ struct WebPImporterTest: TestSuite::Tester {
     void openTwice();
     void importTwice();
 
+    void useThreads();
+    void size();
+    void sizeInvalid();
+
+    void incremental();
+    void incrementalNotFinished();
+    void incrementalInvalid();
+    void incrementalAnimated();
+
+    void animated();
+    void animatedSize();
+    void animationFrames();
+    void animationFramesStill();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -70,7 +91,6 @@ const struct {
     const char* error;
 } InvalidData[] {
     {"wrong file signature", Utility::Path::join(PNGIMPORTER_TEST_DIR, "rgb.png"), {}, "WebP image features not found: bitstream error\n"},
-    {"animated file", "animated.webp", {}, "animated WebP images aren't supported\n"},
     /* The header information of a lossless bitstream takes 25 bytes according
        to its specification: https://developers.google.com/speed/webp/docs/webp_lossless_bitstream_specification#2_riff_header.
        Hence, 24 bytes would cause an error while trying to extract the header
@@ -118,6 +138,37 @@ const struct {
     }},
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+} UseThreadsData[]{
+    {"RGB", "rgb-lossy-90.webp"},
+    {"RGBA", "rgba-lossy-90.webp"},
+};
+
+const struct {
+    const char* name;
+    const char* size;
+    Vector2i expected;
+} SizeData[]{
+    {"both sizes", "2 1", {2, 1}},
+    {"width only", "2 0", {2, 2}},
+    {"height only", "0 1", {1, 1}},
+    {"upscale", "5 4", {5, 4}},
+    {"same as original", "3 3", {3, 3}},
+};
+
+const struct {
+    const char* name;
+    const char* filename;
+    std::size_t chunkSize;
+} IncrementalData[]{
+    {"lossless, byte by byte", "rgb-lossless.webp", 1},
+    {"lossless, all at once", "rgb-lossless.webp", ~std::size_t{}},
+    {"lossy, 7-byte chunks", "rgb-lossy-90.webp", 7},
+    {"lossy with alpha, 16-byte chunks", "rgba-lossy-90.webp", 16},
+};
+
 WebPImporterTest::WebPImporterTest() {
     addTests({&WebPImporterTest::empty});
 
@@ -136,6 +187,26 @@ WebPImporterTest::WebPImporterTest() {
     addTests({&WebPImporterTest::openTwice,
               &WebPImporterTest::importTwice});
 
+    addInstancedTests({&WebPImporterTest::useThreads},
+        Containers::arraySize(UseThreadsData));
+
+    addInstancedTests({&WebPImporterTest::size},
+        Containers::arraySize(SizeData));
+
+    addTests({&WebPImporterTest::sizeInvalid});
+
+    addInstancedTests({&WebPImporterTest::incremental},
+        Containers::arraySize(IncrementalData));
+
+    addTests({&WebPImporterTest::incrementalNotFinished,
+              &WebPImporterTest::incrementalInvalid,
+              &WebPImporterTest::incrementalAnimated,
+
+              &WebPImporterTest::animated,
+              &WebPImporterTest::animatedSize,
+              &WebPImporterTest::animationFrames,
+              &WebPImporterTest::animationFramesStill});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef WEBPIMPORTER_PLUGIN_FILENAME
@@ -296,6 +367,250 @@ void WebPImporterTest::importTwice() {
     }
 }
 
+void WebPImporterTest::useThreads() {
+    auto&& data = UseThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("WebPImporter");
+    CORRADE_VERIFY(!importer->configuration().value<bool>("useThreads"));
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(WEBPIMPORTER_TEST_DIR, data.filename)));
+    Containers::Optional<Trade::ImageData2D> expected = importer->image2D(0);
+    CORRADE_VERIFY(expected);
+
+    /* Threaded decoding should give exactly the same output */
+    importer->configuration().setValue("useThreads", true);
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE_AS(*image, *expected, DebugTools::CompareImage);
+}
+
+void WebPImporterTest::size() {
+    auto&& data = SizeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("WebPImporter");
+    CORRADE_COMPARE(importer->configuration().value<Containers::StringView>("size"), "");
+    importer->configuration().setValue("size", data.size);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(WEBPIMPORTER_TEST_DIR, "rgb-lossless.webp")));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), data.expected);
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB8Unorm);
+}
+
+void WebPImporterTest::sizeInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("WebPImporter");
+    importer->configuration().setValue("size", "-1 2");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(WEBPIMPORTER_TEST_DIR, "rgb-lossless.webp")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(0));
+    CORRADE_COMPARE(out.str(), "Trade::WebPImporter::image2D(): expected size to be non-negative but got {-1, 2}\n");
+}
+
+void WebPImporterTest::incremental() {
+    #ifdef WEBPIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    auto&& data = IncrementalData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Optional<Containers::Array<char>> in = Utility::Path::read(Utility::Path::join(WEBPIMPORTER_TEST_DIR, data.filename));
+    CORRADE_VERIFY(in);
+
+    /* Reference decoded all at once */
+    Containers::Pointer<AbstractImporter> reference = _manager.instantiate("WebPImporter");
+    CORRADE_VERIFY(reference->openData(*in));
+    Containers::Optional<Trade::ImageData2D> expected = reference->image2D(0);
+    CORRADE_VERIFY(expected);
+
+    WebPImporter importer{_manager, "WebPImporter"};
+    Int previousRowCount = 0;
+    for(std::size_t offset = 0; offset < in->size(); offset += data.chunkSize) {
+        CORRADE_ITERATION(offset);
+        CORRADE_VERIFY(importer.appendIncremental(in->sliceSize(offset, Math::min(data.chunkSize, in->size() - offset))));
+
+        /* The decoded row count should never decrease */
+        Containers::Optional<ImageView2D> partial = importer.incrementalImage();
+        if(!partial) {
+            CORRADE_COMPARE(previousRowCount, 0);
+            continue;
+        }
+        CORRADE_COMPARE(partial->size().x(), expected->size().x());
+        CORRADE_COMPARE(partial->format(), expected->format());
+        CORRADE_COMPARE_AS(partial->size().y(), previousRowCount,
+            TestSuite::Compare::GreaterOrEqual);
+        previousRowCount = partial->size().y();
+    }
+
+    CORRADE_COMPARE(previousRowCount, expected->size().y());
+
+    Containers::Optional<Trade::ImageData2D> image = importer.finishIncremental();
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE_AS(*image, *expected, DebugTools::CompareImage);
+    #endif
+}
+
+void WebPImporterTest::incrementalNotFinished() {
+    #ifdef WEBPIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    Containers::Optional<Containers::Array<char>> in = Utility::Path::read(Utility::Path::join(WEBPIMPORTER_TEST_DIR, "rgb-lossless.webp"));
+    CORRADE_VERIFY(in);
+
+    /* Not enough data to know the image size, as in the "too short
+       signature" case in invalid() */
+    WebPImporter importer{_manager, "WebPImporter"};
+    CORRADE_VERIFY(importer.appendIncremental(in->prefix(24)));
+    CORRADE_VERIFY(!importer.incrementalImage());
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer.finishIncremental());
+        CORRADE_COMPARE(out.str(), "Trade::WebPImporter::finishIncremental(): image not fully decoded yet\n");
+    }
+
+    /* Appending the rest should make it pass */
+    CORRADE_VERIFY(importer.appendIncremental(in->exceptPrefix(24)));
+    Containers::Optional<Trade::ImageData2D> image = importer.finishIncremental();
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), (Vector2i{3, 3}));
+    #endif
+}
+
+void WebPImporterTest::incrementalInvalid() {
+    #ifdef WEBPIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    Containers::Optional<Containers::Array<char>> in = Utility::Path::read(Utility::Path::join(PNGIMPORTER_TEST_DIR, "rgb.png"));
+    CORRADE_VERIFY(in);
+
+    WebPImporter importer{_manager, "WebPImporter"};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer.appendIncremental(*in));
+    CORRADE_COMPARE(out.str(), "Trade::WebPImporter::appendIncremental(): WebP image features not found: bitstream error\n");
+    #endif
+}
+
+void WebPImporterTest::incrementalAnimated() {
+    #ifdef WEBPIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    Containers::Optional<Containers::Array<char>> in = Utility::Path::read(Utility::Path::join(WEBPIMPORTER_TEST_DIR, "animated.webp"));
+    CORRADE_VERIFY(in);
+
+    WebPImporter importer{_manager, "WebPImporter"};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer.appendIncremental(*in));
+    CORRADE_COMPARE(out.str(), "Trade::WebPImporter::appendIncremental(): animated WebP images aren't supported\n");
+    #endif
+}
+
+void WebPImporterTest::animated() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("WebPImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(WEBPIMPORTER_TEST_DIR, "animated.webp")));
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+
+    /* The first frame is imported, composited on the canvas, which is larger
+       than the frames themselves */
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), (Vector2i{27, 27}));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(image->data().size(), 27*27*4);
+}
+
+void WebPImporterTest::animatedSize() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("WebPImporter");
+    importer->configuration().setValue("size", "16 16");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(WEBPIMPORTER_TEST_DIR, "animated.webp")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(0));
+    CORRADE_COMPARE(out.str(), "Trade::WebPImporter::image2D(): scaled decoding of animated WebP images isn't supported\n");
+}
+
+void WebPImporterTest::animationFrames() {
+    #ifdef WEBPIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    WebPImporter importer{_manager, "WebPImporter"};
+    CORRADE_VERIFY(importer.openFile(Utility::Path::join(WEBPIMPORTER_TEST_DIR, "animated.webp")));
+    CORRADE_COMPARE(importer.animationFrameCount(), 2);
+    CORRADE_COMPARE(importer.animationLoopCount(), 0);
+
+    Containers::Optional<Trade::ImageData2D> image = importer.image2D(0);
+    CORRADE_VERIFY(image);
+
+    /* The first frame is the same as what image2D() returns */
+    {
+        Containers::Optional<Containers::Pair<ImageView2D, Int>> frame = importer.animationFrame(0);
+        CORRADE_VERIFY(frame);
+        CORRADE_COMPARE(frame->first().size(), (Vector2i{27, 27}));
+        CORRADE_COMPARE(frame->first().format(), PixelFormat::RGBA8Unorm);
+        CORRADE_COMPARE(frame->second(), 200);
+        CORRADE_COMPARE_AS(frame->first(), *image, DebugTools::CompareImage);
+    }
+
+    /* Decoding the next frame reuses the same canvas */
+    Containers::Array<char> second;
+    {
+        Containers::Optional<Containers::Pair<ImageView2D, Int>> frame = importer.animationFrame(1);
+        CORRADE_VERIFY(frame);
+        CORRADE_COMPARE(frame->first().size(), (Vector2i{27, 27}));
+        CORRADE_COMPARE(frame->second(), 400);
+        second = Containers::Array<char>{NoInit, frame->first().data().size()};
+        Utility::copy(frame->first().data(), second);
+    }
+
+    /* Going back restarts the decoding */
+    {
+        Containers::Optional<Containers::Pair<ImageView2D, Int>> frame = importer.animationFrame(0);
+        CORRADE_VERIFY(frame);
+        CORRADE_COMPARE(frame->second(), 200);
+        CORRADE_COMPARE_AS(frame->first(), *image, DebugTools::CompareImage);
+    }
+
+    /* Skipping a frame in a freshly opened file gives the same result as
+       decoding sequentially */
+    CORRADE_VERIFY(importer.openFile(Utility::Path::join(WEBPIMPORTER_TEST_DIR, "animated.webp")));
+    {
+        Containers::Optional<Containers::Pair<ImageView2D, Int>> frame = importer.animationFrame(1);
+        CORRADE_VERIFY(frame);
+        CORRADE_COMPARE(frame->second(), 400);
+        CORRADE_COMPARE_AS(frame->first().data(), second,
+            TestSuite::Compare::Container);
+    }
+    #endif
+}
+
+void WebPImporterTest::animationFramesStill() {
+    #ifdef WEBPIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only with a static plugin.");
+    #else
+    WebPImporter importer{_manager, "WebPImporter"};
+    CORRADE_VERIFY(importer.openFile(Utility::Path::join(WEBPIMPORTER_TEST_DIR, "rgba-lossless.webp")));
+    CORRADE_COMPARE(importer.animationFrameCount(), 1);
+    CORRADE_COMPARE(importer.animationLoopCount(), 0);
+
+    Containers::Optional<Trade::ImageData2D> image = importer.image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+
+    /* A still image is a single-frame animation */
+    Containers::Optional<Containers::Pair<ImageView2D, Int>> frame = importer.animationFrame(0);
+    CORRADE_VERIFY(frame);
+    CORRADE_COMPARE_AS(frame->first(), *image, DebugTools::CompareImage);
+    #endif
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::WebPImporterTest)
@@ -26,18 +26,64 @@
 
 #include "WebPImporter.h"
 
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
+#include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector2.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "Magnum/Implementation/instrumentation.h"
+
 #include <webp/types.h>
 #include <webp/decode.h>
+#include <webp/demux.h>
 #include <webp/mux_types.h>
 
 namespace Magnum { namespace Trade {
 
+struct WebPImporter::Incremental {
+    ~Incremental() {
+        if(decoder) WebPIDelete(decoder);
+    }
+
+    /* Data accumulated until there's enough to know the image size. After,
+       the data are passed directly to the decoder. */
+    Containers::Array<char> header;
+    /* The decoder references the output buffer and options from here, so
+       it has to be kept alive together with it */
+    WebPDecoderConfig config;
+    WebPIDecoder* decoder{};
+    PixelFormat format;
+    Vector2i size;
+    Containers::Array<char> data;
+    std::size_t stride;
+    Int decodedRowCount;
+    bool done;
+};
+
+struct WebPImporter::Animation {
+    ~Animation() {
+        if(decoder) WebPAnimDecoderDelete(decoder);
+    }
+
+    WebPAnimDecoder* decoder{};
+    Vector2i size;
+    /* Y-flipped copy of the canvas with the last decoded frame */
+    Containers::Array<char> frame;
+    /* Index of the frame the decoder decodes next and the end timestamp of
+       the last decoded frame */
+    UnsignedInt nextFrame;
+    Int timestamp;
+};
+
 WebPImporter::WebPImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
 
 WebPImporter::~WebPImporter() = default;
@@ -46,9 +92,13 @@ ImporterFeatures WebPImporter::doFeatures() const { return ImporterFeature::Open
 
 bool WebPImporter::doIsOpened() const { return _in; }
 
-void WebPImporter::doClose() { _in = nullptr; }
+void WebPImporter::doClose() {
+    _in = nullptr;
+    _animation = nullptr;
+}
 
 void WebPImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doOpenData"};
     /* Because here we're copying the data and using the _in to check if file
        is opened, having them nullptr would mean openData() would fail without
        any error message. It's not possible to do this check on the importer
@@ -89,56 +139,122 @@ const char* vp8StatusCodeString(const VP8StatusCode status) {
     CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 }
 
-}
-
-UnsignedInt WebPImporter::doImage2DCount() const { return 1; }
+UnsignedInt demuxFeature(const Containers::ArrayView<const char> in, const WebPFormatFeature feature) {
+    const WebPData data{reinterpret_cast<const std::uint8_t*>(in.data()), in.size()};
+    WebPDemuxer* const demuxer = WebPDemux(&data);
+    if(!demuxer)
+        return 0;
 
-Containers::Optional<ImageData2D> WebPImporter::doImage2D(UnsignedInt, UnsignedInt) {
-    /* Decoder configuration */
-    WebPDecoderConfig config;
-    CORRADE_INTERNAL_ASSERT_OUTPUT(WebPInitDecoderConfig(&config));
-    config.options.flip = true;
-
-    /* Reading the file information into config.input. This also verifies the
-       file is actually a WebP file. */
-    WebPBitstreamFeatures bitstream;
-    const VP8StatusCode status = WebPGetFeatures(reinterpret_cast<std::uint8_t*>(_in.data()), _in.size(), &bitstream);
-    if(status != VP8_STATUS_OK) {
-        Error err;
-        err << "Trade::WebPImporter::image2D(): WebP image features not found:" << vp8StatusCodeString(status);
-        return {};
-    }
+    const UnsignedInt out = WebPDemuxGetI(demuxer, feature);
+    WebPDemuxDelete(demuxer);
+    return out;
+}
 
+/* Fills the decoder configuration based on the bitstream features and plugin
+   configuration, returns the output size and allocates the output data with
+   four-byte aligned rows */
+bool configureDecoder(const char* const prefix, const Utility::ConfigurationGroup& configuration, const WebPBitstreamFeatures& bitstream, WebPDecoderConfig& config, PixelFormat& format, Vector2i& size, std::size_t& stride, Containers::Array<char>& data) {
     /* Filtering animated WebP files, they are subject to a different decoding
        process defined in demux library */
     if(bitstream.format == 0) {
-        Error{} << "Trade::WebPImporter::image2D(): animated WebP images aren't supported";
-        return {};
+        Error{} << prefix << "animated WebP images aren't supported";
+        return false;
     }
 
+    /* Scaled decoding. If just one dimension is specified, the other is
+       calculated to preserve the aspect ratio. */
+    size = {bitstream.width, bitstream.height};
+    const Vector2i scaledSize = configuration.value<Vector2i>("size");
+    if((scaledSize < Vector2i{0}).any()) {
+        Error{} << prefix << "expected size to be non-negative but got" << Debug::packed << scaledSize;
+        return false;
+    }
+    if(!scaledSize.isZero()) {
+        if(!scaledSize.x())
+            size = {Math::max(1, Int(Long(scaledSize.y())*bitstream.width/bitstream.height)), scaledSize.y()};
+        else if(!scaledSize.y())
+            size = {scaledSize.x(), Math::max(1, Int(Long(scaledSize.x())*bitstream.height/bitstream.width))};
+        else
+            size = scaledSize;
+        if(size != Vector2i{bitstream.width, bitstream.height}) {
+            config.options.use_scaling = 1;
+            config.options.scaled_width = size.x();
+            config.options.scaled_height = size.y();
+        }
+    }
+
+    config.options.use_threads = configuration.value<bool>("useThreads");
+    config.options.flip = true;
+
     /* Channel number and pixel format (always 8-bit per channel) determined by
        alpha transparency. No special handling for lossy vs lossless files. */
     Int channels = 3;
-    PixelFormat pixelFormat = PixelFormat::RGB8Unorm;
+    format = PixelFormat::RGB8Unorm;
     WEBP_CSP_MODE colourDepth = MODE_RGB;
     if(bitstream.has_alpha) {
         channels = 4;
-        pixelFormat = PixelFormat::RGBA8Unorm;
+        format = PixelFormat::RGBA8Unorm;
         colourDepth = MODE_RGBA;
     }
 
     /* Structure and configuration for decoding */
     WebPDecBuffer& outputBuffer = config.output;
-    const std::size_t stride = 4*((bitstream.width*channels + 3)/4);
-    outputBuffer.u.RGBA.size = stride*bitstream.height;
+    stride = 4*((size.x()*channels + 3)/4);
+    outputBuffer.u.RGBA.size = stride*size.y();
     outputBuffer.u.RGBA.stride = stride;
     outputBuffer.colorspace = colourDepth;
 
     /* Create external memory pointed by outputBuffer buffer */
-    Containers::Array<char> outData{NoInit, outputBuffer.u.RGBA.size};
-    outputBuffer.u.RGBA.rgba = reinterpret_cast<std::uint8_t*>(outData.data());
+    data = Containers::Array<char>{NoInit, outputBuffer.u.RGBA.size};
+    outputBuffer.u.RGBA.rgba = reinterpret_cast<std::uint8_t*>(data.data());
     outputBuffer.is_external_memory = 1;
 
+    return true;
+}
+
+}
+
+UnsignedInt WebPImporter::doImage2DCount() const { return 1; }
+
+Containers::Optional<ImageData2D> WebPImporter::doImage2D(UnsignedInt, UnsignedInt) {
+    Magnum::Implementation::InstrumentationScope instrumentation{configuration(), "doImage2D"};
+    /* Decoder configuration */
+    WebPDecoderConfig config;
+    CORRADE_INTERNAL_ASSERT_OUTPUT(WebPInitDecoderConfig(&config));
+
+    /* Reading the file information into config.input. This also verifies the
+       file is actually a WebP file. */
+    WebPBitstreamFeatures bitstream;
+    const VP8StatusCode status = WebPGetFeatures(reinterpret_cast<std::uint8_t*>(_in.data()), _in.size(), &bitstream);
+    if(status != VP8_STATUS_OK) {
+        Error err;
+        err << "Trade::WebPImporter::image2D(): WebP image features not found:" << vp8StatusCodeString(status);
+        return {};
+    }
+
+    /* Animated files go through the animation decoder, returning a copy of
+       the first frame */
+    if(bitstream.has_animation) {
+        if(!configuration().value<Vector2i>("size").isZero()) {
+            Error{} << "Trade::WebPImporter::image2D(): scaled decoding of animated WebP images isn't supported";
+            return {};
+        }
+
+        if(!decodeAnimationFrame("Trade::WebPImporter::image2D():", 0))
+            return {};
+
+        Containers::Array<char> outData{NoInit, _animation->frame.size()};
+        Utility::copy(_animation->frame, outData);
+        return Trade::ImageData2D{PixelFormat::RGBA8Unorm, _animation->size, Utility::move(outData)};
+    }
+
+    PixelFormat format;
+    Vector2i size;
+    std::size_t stride;
+    Containers::Array<char> outData;
+    if(!configureDecoder("Trade::WebPImporter::image2D():", configuration(), bitstream, config, format, size, stride, outData))
+        return {};
+
     /* Decompression of the image */
     const VP8StatusCode decodeStatus = WebPDecode(reinterpret_cast<std::uint8_t*>(_in.data()), _in.size(), &config);
     if(decodeStatus != VP8_STATUS_OK) {
@@ -147,7 +263,191 @@ Containers::Optional<ImageData2D> WebPImporter::doImage2D(UnsignedInt, UnsignedI
         return {};
     }
 
-    return Trade::ImageData2D{pixelFormat, {bitstream.width, bitstream.height}, Utility::move(outData)};
+    return Trade::ImageData2D{format, size, Utility::move(outData)};
+}
+
+bool WebPImporter::appendIncremental(const Containers::ArrayView<const void> data) {
+    /* Start a new decoding if there's none in progress or the previous one
+       finished */
+    if(!_incremental || _incremental->done) {
+        _incremental.emplace();
+        _incremental->done = false;
+        _incremental->decodedRowCount = 0;
+    }
+
+    Incremental& incremental = *_incremental;
+    Containers::ArrayView<const char> in = Containers::arrayCast<const char>(data);
+
+    /* Until the header is complete, accumulate the data */
+    if(!incremental.decoder) {
+        arrayAppend(incremental.header, in);
+
+        WebPBitstreamFeatures bitstream;
+        const VP8StatusCode status = WebPGetFeatures(reinterpret_cast<std::uint8_t*>(incremental.header.data()), incremental.header.size(), &bitstream);
+        if(status == VP8_STATUS_NOT_ENOUGH_DATA)
+            return true;
+        if(status != VP8_STATUS_OK) {
+            Error{} << "Trade::WebPImporter::appendIncremental(): WebP image features not found:" << vp8StatusCodeString(status);
+            _incremental = nullptr;
+            return false;
+        }
+
+        WebPDecoderConfig& config = incremental.config;
+        CORRADE_INTERNAL_ASSERT_OUTPUT(WebPInitDecoderConfig(&config));
+        if(!configureDecoder("Trade::WebPImporter::appendIncremental():", configuration(), bitstream, config, incremental.format, incremental.size, incremental.stride, incremental.data)) {
+            _incremental = nullptr;
+            return false;
+        }
+
+        incremental.decoder = WebPIDecode(nullptr, 0, &config);
+        if(!incremental.decoder) {
+            Error{} << "Trade::WebPImporter::appendIncremental(): can't create an incremental decoder"; /* LCOV_EXCL_LINE */
+            _incremental = nullptr; /* LCOV_EXCL_LINE */
+            return false; /* LCOV_EXCL_LINE */
+        }
+
+        /* Pass everything accumulated so far to the decoder */
+        in = incremental.header;
+    }
+
+    const VP8StatusCode status = WebPIAppend(incremental.decoder, reinterpret_cast<const std::uint8_t*>(in.data()), in.size());
+    if(status != VP8_STATUS_OK && status != VP8_STATUS_SUSPENDED) {
+        Error{} << "Trade::WebPImporter::appendIncremental(): decoding error:" << vp8StatusCodeString(status);
+        _incremental = nullptr;
+        return false;
+    }
+
+    /* The header copy isn't needed anymore */
+    incremental.header = nullptr;
+
+    int lastY = 0;
+    if(WebPIDecGetRGB(incremental.decoder, &lastY, nullptr, nullptr, nullptr))
+        incremental.decodedRowCount = lastY;
+    if(status == VP8_STATUS_OK) {
+        incremental.done = true;
+        incremental.decodedRowCount = incremental.size.y();
+        WebPIDelete(incremental.decoder);
+        incremental.decoder = nullptr;
+    }
+
+    return true;
+}
+
+Containers::Optional<ImageView2D> WebPImporter::incrementalImage() const {
+    CORRADE_ASSERT(_incremental,
+        "Trade::WebPImporter::incrementalImage(): no incremental decoding in progress", {});
+
+    /* Not enough data to know even the size yet */
+    if(!_incremental->data)
+        return {};
+
+    /* The image is decoded top to bottom and stored Y-flipped, so the decoded
+       rows are at the end of the data */
+    const std::size_t offset = (_incremental->size.y() - _incremental->decodedRowCount)*_incremental->stride;
+    return ImageView2D{_incremental->format, {_incremental->size.x(), _incremental->decodedRowCount}, _incremental->data.exceptPrefix(offset)};
+}
+
+Containers::Optional<ImageData2D> WebPImporter::finishIncremental() {
+    CORRADE_ASSERT(_incremental,
+        "Trade::WebPImporter::finishIncremental(): no incremental decoding in progress", {});
+
+    if(!_incremental->done) {
+        Error e;
+        e << "Trade::WebPImporter::finishIncremental(): image not fully decoded yet";
+        if(_incremental->data)
+            e << Debug::nospace << "," << _incremental->decodedRowCount << "out of" << _incremental->size.y() << "rows done";
+        return {};
+    }
+
+    Containers::Optional<ImageData2D> out{InPlaceInit, _incremental->format, _incremental->size, Utility::move(_incremental->data)};
+    _incremental = nullptr;
+    return out;
+}
+
+UnsignedInt WebPImporter::animationFrameCount() const {
+    CORRADE_ASSERT(_in,
+        "Trade::WebPImporter::animationFrameCount(): no file opened", {});
+
+    return demuxFeature(_in, WEBP_FF_FRAME_COUNT);
+}
+
+UnsignedInt WebPImporter::animationLoopCount() const {
+    CORRADE_ASSERT(_in,
+        "Trade::WebPImporter::animationLoopCount(): no file opened", {});
+
+    return demuxFeature(_in, WEBP_FF_LOOP_COUNT);
+}
+
+bool WebPImporter::decodeAnimationFrame(const char* const prefix, const UnsignedInt id) {
+    /* Create the decoder on first use, it allocates the whole canvas */
+    if(!_animation) {
+        WebPAnimDecoderOptions options;
+        CORRADE_INTERNAL_ASSERT_OUTPUT(WebPAnimDecoderOptionsInit(&options));
+        options.color_mode = MODE_RGBA;
+        options.use_threads = configuration().value<bool>("useThreads");
+
+        const WebPData data{reinterpret_cast<const std::uint8_t*>(_in.data()), _in.size()};
+        WebPAnimDecoder* const decoder = WebPAnimDecoderNew(&data, &options);
+        if(!decoder) {
+            Error{} << prefix << "can't create an animation decoder";
+            return false;
+        }
+
+        WebPAnimInfo info;
+        CORRADE_INTERNAL_ASSERT_OUTPUT(WebPAnimDecoderGetInfo(decoder, &info));
+
+        _animation.emplace();
+        _animation->decoder = decoder;
+        _animation->size = {Int(info.canvas_width), Int(info.canvas_height)};
+        _animation->frame = Containers::Array<char>{NoInit, std::size_t(_animation->size.product())*4};
+        _animation->nextFrame = 0;
+    }
+
+    Animation& animation = *_animation;
+
+    /* The frame is the last decoded one, nothing to do */
+    if(animation.nextFrame == id + 1)
+        return true;
+
+    /* Frames are composited on top of the previous ones, so going back means
+       decoding again from the start */
+    if(id < animation.nextFrame) {
+        WebPAnimDecoderReset(animation.decoder);
+        animation.nextFrame = 0;
+    }
+
+    std::uint8_t* canvas{};
+    while(animation.nextFrame <= id) {
+        if(!WebPAnimDecoderGetNext(animation.decoder, &canvas, &animation.timestamp)) {
+            Error{} << prefix << "decoding error in frame" << animation.nextFrame;
+            /* The decoder state is unknown after a failure, start over the
+               next time */
+            _animation = nullptr;
+            return false;
+        }
+        ++animation.nextFrame;
+    }
+
+    /* The canvas is tightly packed top to bottom, flip it. Four-byte pixels
+       are always four-byte aligned, so there's no row padding needed. */
+    const Containers::Size2D size{std::size_t(animation.size.y()), std::size_t(animation.size.x())*4};
+    Utility::copy(
+        Containers::StridedArrayView2D<const char>{Containers::arrayView(reinterpret_cast<const char*>(canvas), animation.frame.size()), size}.flipped<0>(),
+        Containers::StridedArrayView2D<char>{animation.frame, size});
+
+    return true;
+}
+
+Containers::Optional<Containers::Pair<ImageView2D, Int>> WebPImporter::animationFrame(const UnsignedInt id) {
+    CORRADE_ASSERT(_in,
+        "Trade::WebPImporter::animationFrame(): no file opened", {});
+    CORRADE_ASSERT(id < animationFrameCount(),
+        "Trade::WebPImporter::animationFrame(): index" << id << "out of range for" << animationFrameCount() << "frames", {});
+
+    if(!decodeAnimationFrame("Trade::WebPImporter::animationFrame():", id))
+        return {};
+
+    return Containers::pair(ImageView2D{PixelFormat::RGBA8Unorm, _animation->size, _animation->frame}, _animation->timestamp);
 }
 
 }}
@@ -32,6 +32,7 @@
  */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "MagnumPlugins/WebPImporter/configure.h"
@@ -121,7 +122,85 @@ is imported as either @ref PixelFormat::RGB8Unorm or
 @ref PixelFormat::RGBA8Unorm. It doesn't have a special colorspace for
 grayscale, those are encoded the same way as RGB.
 
-The importer doesn't support decoding of animated WebP files.
+For animated WebP files, @ref image2D() returns the first frame composited
+on the canvas, always in @ref PixelFormat::RGBA8Unorm. See
+@ref Trade-WebPImporter-behavior-animation below for decoding of the other
+frames.
+
+@subsection Trade-WebPImporter-behavior-threads-scaling Multi-threaded and scaled decoding
+
+With the @cb{.ini} useThreads @ce @ref Trade-WebPImporter-configuration "configuration option"
+enabled, libwebp does in-loop filtering of lossy images in a separate thread,
+if it was built with thread support. The @cb{.ini} size @ce option makes the
+image decoded directly to given size using the rescaler built into libwebp,
+which is considerably faster than decoding the full image and downscaling it
+afterwards, useful for example for thumbnails:
+
+@code{.ini}
+[configuration]
+size=128 0
+@endcode
+
+@subsection Trade-WebPImporter-behavior-incremental Incremental decoding
+
+If you instantiate this class directly, either without a plugin manager or with
+the plugin linked statically, you can use @ref appendIncremental() to decode an
+image while its data arrive, for example over a network connection. It doesn't
+need any file to be opened and is independent of it, the current
+configuration is used at the point where enough data arrived to know the image
+size. The @ref incrementalImage() returns a view on the rows decoded so far,
+which can be used for progressive display, and @ref finishIncremental() then
+returns the fully decoded image:
+
+@code{.cpp}
+Trade::WebPImporter importer{manager, "WebPImporter"};
+while(Containers::ArrayView<const char> chunk = receive()) {
+    if(!importer.appendIncremental(chunk)) break;
+    if(Containers::Optional<ImageView2D> partial = importer.incrementalImage())
+        display(*partial);
+}
+
+Containers::Optional<Trade::ImageData2D> image = importer.finishIncremental();
+@endcode
+
+@subsection Trade-WebPImporter-behavior-animation Animated files
+
+If you instantiate this class directly, either without a plugin manager or with
+the plugin linked statically, @ref animationFrameCount(),
+@ref animationLoopCount() and @ref animationFrame() provide access to frames
+of an animated WebP file. The frames are decoded with libwebp's
+`WebPAnimDecoder` one by one into a single canvas buffer that's reused for
+every frame, so playing back an animation doesn't need all its frames to be
+decoded into memory at once. Each frame is returned together with the time at
+which it ends, in milliseconds:
+
+@code{.cpp}
+Trade::WebPImporter importer{manager, "WebPImporter"};
+importer.openFile("sticker.webp");
+for(UnsignedInt i = 0; i != importer.animationFrameCount(); ++i) {
+    Containers::Optional<Containers::Pair<ImageView2D, Int>> frame =
+        importer.animationFrame(i);
+    if(!frame) break;
+    display(frame->first(), frame->second());
+}
+@endcode
+
+As each frame is composited on top of the previous ones, decoding frames
+sequentially is the fastest. Asking for an earlier frame restarts the decoding
+from the first frame and skipping frames decodes all frames in between. The
+@cb{.ini} size @ce option isn't supported for animated files, with it set
+@ref image2D() fails. Still WebP images are treated as single-frame
+animations. The @ref appendIncremental() API doesn't support animated files.
+
+@section Trade-WebPImporter-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/WebPImporter/WebPImporter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_WEBPIMPORTER_EXPORT WebPImporter: public AbstractImporter {
     public:
@@ -130,7 +209,91 @@ class MAGNUM_WEBPIMPORTER_EXPORT WebPImporter: public AbstractImporter {
 
         ~WebPImporter();
 
+        /**
+         * @brief Append data for incremental decoding
+         * @m_since_latest_{plugins}
+         *
+         * If there's no incremental decoding in progress or the previous one
+         * finished, starts a new one. Independent of the file opened with
+         * @ref openData() or @ref openFile(). Returns @cpp false @ce and
+         * prints a message to @relativeref{Magnum,Error} on a decoding
+         * error, in which case the incremental decoding is aborted. See
+         * @ref Trade-WebPImporter-behavior-incremental for more
+         * information.
+         */
+        bool appendIncremental(Containers::ArrayView<const void> data);
+
+        /**
+         * @brief Incrementally decoded image
+         * @m_since_latest_{plugins}
+         *
+         * Returns a view on the rows decoded so far, with the image height
+         * equal to the count of decoded rows. As the image is decoded from
+         * top to bottom and rows in Magnum go from bottom to top, the view
+         * grows downwards with more data appended. Returns
+         * @relativeref{Corrade,Containers::NullOpt} if not enough data
+         * arrived yet to know the image size. Expects that
+         * @ref appendIncremental() was called before. The view is valid only
+         * until the next call to @ref appendIncremental() or
+         * @ref finishIncremental().
+         */
+        Containers::Optional<ImageView2D> incrementalImage() const;
+
+        /**
+         * @brief Finish incremental decoding
+         * @m_since_latest_{plugins}
+         *
+         * Returns the fully decoded image. If not enough data arrived yet,
+         * prints a message to @relativeref{Magnum,Error} and returns
+         * @relativeref{Corrade,Containers::NullOpt}, and you can continue
+         * with @ref appendIncremental(). On success the incremental decoding
+         * state is discarded. Expects that @ref appendIncremental() was
+         * called before.
+         */
+        Containers::Optional<ImageData2D> finishIncremental();
+
+        /**
+         * @brief Animation frame count
+         * @m_since_latest_{plugins}
+         *
+         * Returns @cpp 1 @ce for still images and @cpp 0 @ce if the file
+         * can't be parsed. Expects that a file is opened. See
+         * @ref Trade-WebPImporter-behavior-animation for more information.
+         */
+        UnsignedInt animationFrameCount() const;
+
+        /**
+         * @brief Animation loop count
+         * @m_since_latest_{plugins}
+         *
+         * Returns @cpp 0 @ce for an infinitely looping animation, still
+         * images and files that can't be parsed. Expects that a file is
+         * opened.
+         */
+        UnsignedInt animationLoopCount() const;
+
+        /**
+         * @brief Decode an animation frame
+         * @m_since_latest_{plugins}
+         *
+         * Returns a view on the canvas with given frame composited on it,
+         * always in @ref PixelFormat::RGBA8Unorm, together with the frame
+         * end timestamp in milliseconds. The view is valid only until the
+         * next call to this function or until the file is closed. If
+         * decoding fails, prints a message to @relativeref{Magnum,Error} and
+         * returns @relativeref{Corrade,Containers::NullOpt}. Expects that a
+         * file is opened and @p id is less than @ref animationFrameCount().
+         * See @ref Trade-WebPImporter-behavior-animation for more
+         * information.
+         */
+        Containers::Optional<Containers::Pair<ImageView2D, Int>> animationFrame(UnsignedInt id);
+
     private:
+        struct Incremental;
+        struct Animation;
+
+        MAGNUM_WEBPIMPORTER_LOCAL bool decodeAnimationFrame(const char* prefix, UnsignedInt id);
+
         MAGNUM_WEBPIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_WEBPIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_WEBPIMPORTER_LOCAL void doClose() override;
@@ -140,6 +303,8 @@ class MAGNUM_WEBPIMPORTER_EXPORT WebPImporter: public AbstractImporter {
         MAGNUM_WEBPIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
 
         Containers::Array<char> _in;
+        Containers::Pointer<Incremental> _incremental;
+        Containers::Pointer<Animation> _animation;
 };
 
 }}
@@ -6,6 +6,9 @@
 // Testing status: "works for me".
 //
 // History:
+// 0.2-magnum Split into miniexr_write_header() and miniexr_write_scanlines()
+//      that take arbitrary source strides and can write disjoint scanline
+//      ranges in parallel.
 // 0.2 Source data can be RGB or RGBA now.
 // 0.1 Initial release.
 
@@ -17,19 +20,18 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include <assert.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
 
 #define ARRAY_SIZE(x) sizeof(x)/sizeof(x[0])
 
 
-// Writes EXR into a memory buffer.
-// Input:
-//   - (width) x (height) image,
-//   - channels=4: 8 bytes per pixel (R,G,B,A order, 16 bit float per channel; alpha ignored), or
-//   - channels=3: 6 bytes per pixel (R,G,B order, 16 bit float per channel).
-// Returns memory buffer with .EXR contents and buffer size in outSize. free() the buffer when done with it.
-unsigned char* miniexr_write (unsigned width, unsigned height, unsigned channels, const void* rgba16f, size_t* outSize)
+// Writes EXR header and the scanline offset table for a (width) x (height)
+// image into buf, which has to be at least miniexr_size() bytes large. If buf
+// is NULL, nothing is written. Returns size of the header and the offset
+// table, i.e. offset of the first scanline.
+size_t miniexr_write_header (unsigned width, unsigned height, unsigned char* buf)
 {
 	const unsigned ww = width-1;
 	const unsigned hh = height-1;
@@ -92,10 +94,8 @@ unsigned char* miniexr_write (unsigned width, unsigned height, unsigned channels
 	const size_t pixelRowSize = width * 3 * 2;
 	const size_t fullRowSize = pixelRowSize + 8;
 
-	size_t bufSize = kHeaderSize + kScanlineTableSize + height * fullRowSize;
-	unsigned char* buf = (unsigned char*)malloc (bufSize);
 	if (!buf)
-		return NULL;
+		return kHeaderSize + kScanlineTableSize;
 
 	// copy in header
 	memcpy (buf, kHeader, kHeaderSize);
@@ -116,11 +116,29 @@ unsigned char* miniexr_write (unsigned width, unsigned height, unsigned channels
 		ofs += fullRowSize;
 	}
 
-	// scanline data
-	const unsigned char* src = (const unsigned char*)rgba16f;
-	const unsigned stride = channels * 2;
-	for (unsigned y = 0; y < height; ++y)
+	return kHeaderSize + kScanlineTableSize;
+}
+
+// Size of the whole EXR file for a (width) x (height) image.
+size_t miniexr_size (unsigned width, unsigned height)
+{
+	return miniexr_write_header (width, height, NULL) + height * (width * 3 * 2 + 8);
+}
+
+// Writes scanlines [yBegin, yEnd) of a (width) x (height) image into buf
+// that's already filled by miniexr_write_header(). Source data for scanline y
+// start at (const char*)rgba16f + y*rowStride, consecutive pixels are
+// pixelStride bytes apart, each having R, G, B as consecutive 16 bit floats.
+// Disjoint scanline ranges can be written from multiple threads at once.
+void miniexr_write_scanlines (unsigned width, unsigned height, unsigned yBegin, unsigned yEnd, const void* rgba16f, ptrdiff_t pixelStride, ptrdiff_t rowStride, unsigned char* buf)
+{
+	const size_t pixelRowSize = width * 3 * 2;
+	const size_t fullRowSize = pixelRowSize + 8;
+
+	unsigned char* ptr = buf + miniexr_write_header (width, height, NULL) + yBegin * fullRowSize;
+	for (unsigned y = yBegin; y < yEnd; ++y)
 	{
+		const unsigned char* src = (const unsigned char*)rgba16f + y * rowStride;
 		// coordinate
 		*ptr++ = y & 0xFF;
 		*ptr++ = (y >> 8) & 0xFF;
@@ -138,27 +156,41 @@ unsigned char* miniexr_write (unsigned width, unsigned height, unsigned channels
 		{
 			*ptr++ = chsrc[0];
 			*ptr++ = chsrc[1];
-			chsrc += stride;
+			chsrc += pixelStride;
 		}
 		chsrc = src + 2;
 		for (unsigned x = 0; x < width; ++x)
 		{
 			*ptr++ = chsrc[0];
 			*ptr++ = chsrc[1];
-			chsrc += stride;
+			chsrc += pixelStride;
 		}
 		chsrc = src + 0;
 		for (unsigned x = 0; x < width; ++x)
 		{
 			*ptr++ = chsrc[0];
 			*ptr++ = chsrc[1];
-			chsrc += stride;
+			chsrc += pixelStride;
 		}
-
-		src += width * stride;
 	}
+}
 
-	assert (ptr == buf + bufSize);
+// Writes EXR into a memory buffer.
+// Input:
+//   - (width) x (height) image,
+//   - channels=4: 8 bytes per pixel (R,G,B,A order, 16 bit float per channel; alpha ignored), or
+//   - channels=3: 6 bytes per pixel (R,G,B order, 16 bit float per channel).
+// Returns memory buffer with .EXR contents and buffer size in outSize. free() the buffer when done with it.
+unsigned char* miniexr_write (unsigned width, unsigned height, unsigned channels, const void* rgba16f, size_t* outSize)
+{
+	size_t bufSize = miniexr_size (width, height);
+	unsigned char* buf = (unsigned char*)malloc (bufSize);
+	if (!buf)
+		return NULL;
+
+	const unsigned stride = channels * 2;
+	miniexr_write_header (width, height, buf);
+	miniexr_write_scanlines (width, height, 0, height, rgba16f, stride, width * stride, buf);
 
 	*outSize = bufSize;
 	return buf;